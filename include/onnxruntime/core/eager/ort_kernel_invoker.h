@@ -3,7 +3,12 @@
 
 #pragma once
 
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "core/common/common.h"
@@ -45,12 +50,31 @@ class ORTInvoker {
                         const std::string& domain = kOnnxDomain,
                         const int version = -1);
 
+  // Drops the cached kernels. Invocations running meanwhile keep the kernels they use.
+  void ClearKernelCache();
+
+  // Number of kernels kept for later invocations. Past it the least recently used kernel is dropped.
+  static constexpr size_t kMaxCachedKernels = 256;
+
  private:
   std::shared_ptr<IExecutionProvider> execution_provider_;
   const logging::Logger& logger_;
   // custom ops for current execution provider
   // we need the op schema to resolve the output type during invoke
   const IOnnxRuntimeOpSchemaRegistryList& custom_op_registries_;
+
+  // The kernels created by previous invocations, keyed by op, domain, version, attributes and input types.
+  // Creating one needs a resolved graph, which costs far more than running a small op. Attribute values are part
+  // of the key, so the cache is bounded to kMaxCachedKernels with the most recently used kernels first.
+  struct CachedKernel;
+  using KernelCacheList = std::list<std::pair<std::string, std::shared_ptr<const CachedKernel>>>;
+  Status GetOrCreateKernel(const std::string& op_name, const std::vector<OrtValue>& inputs, size_t output_count,
+                           const NodeAttributes* attributes, const std::string& domain, int version,
+                           std::shared_ptr<const CachedKernel>& kernel);
+
+  std::mutex kernel_cache_mutex_;
+  KernelCacheList kernel_cache_list_;
+  std::unordered_map<std::string, KernelCacheList::iterator> kernel_cache_;
 };
 
 #ifdef __GNUC__
@@ -20,16 +20,25 @@ struct OrtArenaCfg {
                   initial_chunk_size_bytes(-1),
                   max_dead_bytes_per_chunk(-1),
                   initial_growth_chunk_size_bytes(-1),
-                  max_power_of_two_extend_bytes(-1) {}
+                  max_power_of_two_extend_bytes(-1),
+                  thread_cache_max_bytes(-1),
+                  idle_shrink_interval_ms(-1),
+                  use_huge_pages(-1),
+                  cross_stream_reuse(-1) {}
   OrtArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes,
               int max_dead_bytes_per_chunk, int initial_growth_chunk_size_bytes,
-              int64_t max_power_of_two_extend_bytes)
+              int64_t max_power_of_two_extend_bytes, int64_t thread_cache_max_bytes = -1,
+              int64_t idle_shrink_interval_ms = -1, int use_huge_pages = -1, int cross_stream_reuse = -1)
       : max_mem(max_mem),
         arena_extend_strategy(arena_extend_strategy),
         initial_chunk_size_bytes(initial_chunk_size_bytes),
         max_dead_bytes_per_chunk(max_dead_bytes_per_chunk),
         initial_growth_chunk_size_bytes(initial_growth_chunk_size_bytes),
-        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes) {}
+        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes),
+        thread_cache_max_bytes(thread_cache_max_bytes),
+        idle_shrink_interval_ms(idle_shrink_interval_ms),
+        use_huge_pages(use_huge_pages),
+        cross_stream_reuse(cross_stream_reuse) {}
 
   size_t max_mem;                         // use 0 to allow ORT to choose the default
   int arena_extend_strategy;              // use -1 to allow ORT to choose the default, 0 = kNextPowerOfTwo, 1 = kSameAsRequested
@@ -37,6 +46,10 @@ struct OrtArenaCfg {
   int max_dead_bytes_per_chunk;           // use -1 to allow ORT to choose the default
   int initial_growth_chunk_size_bytes;    // use -1 to allow ORT to choose the default
   int64_t max_power_of_two_extend_bytes;  // use -1 to allow ORT to choose the default
+  int64_t thread_cache_max_bytes;         // use -1 to allow ORT to choose the default (disabled), 0 to disable
+  int64_t idle_shrink_interval_ms;        // use -1 to allow ORT to choose the default (disabled), 0 to disable
+  int use_huge_pages;                     // use -1 to allow ORT to choose the default (disabled), 0 to disable, 1 to enable
+  int cross_stream_reuse;                 // use -1 to allow ORT to choose the default (disabled), 0 to disable, 1 to enable
 };
 
 namespace onnxruntime {
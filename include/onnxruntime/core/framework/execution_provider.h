@@ -289,6 +289,12 @@ class IExecutionProvider {
   virtual common::Status Compile(const std::vector<FusedNodeAndGraph>& fused_nodes_and_graphs,
                                  std::vector<NodeComputeInfo>& node_compute_funcs);
 
+  /**
+  Does the EP support concurrent calls to Compile, each with a single fused node. If so the partitions assigned to
+  the EP are compiled in parallel on the intra-op thread pool during session initialization.
+  */
+  virtual bool ConcurrentCompileSupported() const { return false; }
+
 #endif
 
   void SetLogger(const logging::Logger* logger) {
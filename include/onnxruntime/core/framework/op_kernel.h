@@ -38,7 +38,8 @@ std::unique_ptr<OpKernelInfo> CopyOpKernelInfo(const OpKernelInfo& info);
 
 class OpKernel {
  public:
-  using DoneCallback = std::function<void()>;
+  // Called by an async kernel once its computation completed, with the status of the computation.
+  using DoneCallback = std::function<void(Status)>;
 
   explicit OpKernel(const OpKernelInfo& info) : op_kernel_info_(CopyOpKernelInfo(info)) {}
   virtual ~OpKernel() = default;
@@ -53,6 +54,11 @@ class OpKernel {
     return false;
   }
 
+  // Kernels waiting on something other than the CPU, like a remote call, a device or the disk, can return true from
+  // IsAsync() and implement ComputeAsync(). It starts the computation and returns without waiting for it. If it
+  // returns OK, it must call done exactly once, on any thread, after the outputs are written, and must not use the
+  // context afterwards. The context stays valid until then. If it returns an error, done must not be called.
+  // The executor resumes the stream of the node when done is called, so the thread is free in between.
   [[nodiscard]] virtual Status ComputeAsync(_Inout_ OpKernelContext*, DoneCallback) const {
     ORT_NOT_IMPLEMENTED(__FUNCTION__, " is not implemented");
   }
@@ -130,6 +136,25 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to use pre-packed weights that were produced by PrePack() for the same kernel, attributes
+  // and tensor, and were loaded from the pre-packed weights cache file (session.prepacked_weights_cache_file).
+  // It is called instead of PrePack(), so the kernel must restore everything PrePack() would have computed.
+  // Return used_cached_buffers = false if that is not possible, and PrePack() will be called.
+  // @param tensor: The initialized constant tensor
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param prepacked_buffers: The pre-packed buffers in the order PrePack() stored them. As for
+  //                           UseSharedPrePackedBuffers(), the deleters are NULL as the kernel doesn't own them.
+  // @param prepacked_buffer_sizes: The size in bytes of each buffer
+  // @param used_cached_buffers: Boolean flag set by the kernel implementation indicating
+  // that the provided buffers have been used by the kernel.
+  virtual Status UseCachedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                           std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                           gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                           /*out*/ bool& used_cached_buffers) {
+    used_cached_buffers = false;
+    return Status::OK();
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
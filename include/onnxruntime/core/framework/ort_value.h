@@ -42,6 +42,11 @@ struct OrtValue {
     type_ = type;
   }
 
+  void Init(std::shared_ptr<void> data, onnxruntime::MLDataType type) {
+    data_ = std::move(data);
+    type_ = type;
+  }
+
   bool IsAllocated() const {
     return data_ && type_;
   }
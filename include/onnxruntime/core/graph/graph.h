@@ -393,7 +393,11 @@ class Node {
   bool ClearAttribute(const std::string& attr_name);
 
   /** Gets the Node's mutable attributes. */
-  NodeAttributes& GetMutableAttributes() noexcept { return attributes_; }
+  NodeAttributes& GetMutableAttributes() noexcept {
+    // someone fetching these is going to change something
+    ++attributes_version_;
+    return attributes_;
+  }
 
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
@@ -604,6 +608,13 @@ class Node {
   const Definitions& GetDefinitions() const noexcept { return definitions_; }
   const Relationships& GetRelationships() const noexcept { return relationships_; }
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // Graph::Resolve skips type and shape inferencing for a node if the op, the attributes and the input and output
+  // defs, including their types and shapes, are the same as when the node was last inferred.
+  bool IsTypeInferenceUpToDate() const noexcept;
+  void SetTypeInferenceUpToDate();
+#endif
+
   // Node index. Default to impossible value rather than 0.
   NodeIndex index_ = std::numeric_limits<NodeIndex>::max();
 
@@ -667,6 +678,21 @@ class Node {
   // This allows attribute adding and removing.
   NodeAttributes attributes_;
 
+  // Incremented whenever the attributes may change.
+  uint64_t attributes_version_ = 0;
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // The state of the node that type and shape inferencing used, when it last ran on the node.
+  struct TypeInferenceState {
+    const ONNX_NAMESPACE::OpSchema* op = nullptr;
+    uint64_t attributes_version = 0;
+    // the input defs followed by the output defs, with their type versions
+    InlinedVector<std::pair<const NodeArg*, uint64_t>> defs;
+  };
+
+  TypeInferenceState type_inference_state_;
+#endif
+
   // Graph that contains this Node
   Graph* graph_ = nullptr;
 
@@ -1630,6 +1656,14 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
   // Implementation for initializer replacement
   Status ReplaceInitializedTensorImpl(ONNX_NAMESPACE::TensorProto new_initializer, bool is_external);
 
+  // Type and shape inferencing may use the data of an initializer, so the consumers of an initializer that was
+  // added, replaced or removed are inferred again by the next Resolve.
+  void InitializerChanged(const std::string& name) {
+    if (NodeArg* node_arg = GetNodeArg(name); node_arg != nullptr) {
+      node_arg->UpdateTypeVersion();
+    }
+  }
+
   std::vector<NodeArg*> CreateNodeArgs(const google::protobuf::RepeatedPtrField<std::string>& names,
                                        const ArgNameToTypeMap& name_to_type_map);
 
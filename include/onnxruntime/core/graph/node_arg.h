@@ -111,6 +111,11 @@ class NodeArg {
   Optional inputs are allowed in ONNX and an empty #Name represents a non-existent input argument. */
   bool Exists() const noexcept;
 
+  /** Gets a value that changes whenever the type or shape of this NodeArg, or the data of the initializer it refers
+  to, changes. Values are unique across all NodeArg instances, so a NodeArg created at the address of a deleted one
+  does not have the same value. */
+  uint64_t TypeVersion() const noexcept { return type_version_; }
+
   friend class Graph;
 
   NodeArg(NodeArgInfo&& node_arg_info);
@@ -121,6 +126,7 @@ class NodeArg {
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
   void SetType(const ONNX_NAMESPACE::TypeProto& type_proto);
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+  void UpdateTypeVersion() noexcept;
 
   // Node arg PType.
   const std::string* type_;
@@ -130,5 +136,8 @@ class NodeArg {
 
   // Flag indicates whether <*this> node arg exists or not.
   bool exists_;
+
+  // See TypeVersion().
+  uint64_t type_version_;
 };
 }  // namespace onnxruntime
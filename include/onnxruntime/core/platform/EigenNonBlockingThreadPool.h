@@ -338,6 +338,9 @@ class ExtendedThreadPoolInterface : public Eigen::ThreadPoolInterface {
                              unsigned n, std::ptrdiff_t block_size) = 0;
   virtual void StartProfiling() = 0;
   virtual std::string StopProfiling() = 0;
+
+  // Total time the worker threads spent running tasks, in nanoseconds.
+  virtual uint64_t GetBusyNanoseconds() const = 0;
 };
 
 class ThreadPoolParallelSection {
@@ -729,6 +732,14 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return profiler_.Stop();
   }
 
+  uint64_t GetBusyNanoseconds() const override {
+    uint64_t busy_ns = 0;
+    for (size_t i = 0; i < worker_data_.size(); ++i) {
+      busy_ns += worker_data_[i].busy_ns.load(std::memory_order_relaxed);
+    }
+    return busy_ns;
+  }
+
   struct Tag {
     constexpr Tag() : v_(0) {
     }
@@ -1331,6 +1342,22 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     spin_loop_status_ = SpinLoopStatus::kIdle;
   }
 
+  // While the calls to StartSpinningWithoutBlocking outnumber those to StopSpinningWithoutBlocking, the workers
+  // that find no work spin until they get some instead of blocking, so handing them work never needs an OS wakeup.
+  // The workers that are blocked when spinning starts are woken up.
+  void StartSpinningWithoutBlocking() {
+    // seq_cst, with the status checked by EnsureAwake, synchronizes with the pre-block test of WorkerLoop
+    if (spinning_without_blocking_.fetch_add(1, std::memory_order_seq_cst) == 0) {
+      for (auto& td : worker_data_) {
+        td.EnsureAwake();
+      }
+    }
+  }
+
+  void StopSpinningWithoutBlocking() {
+    spinning_without_blocking_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
  private:
   void ComputeCoprimes(int N, Eigen::MaxSizeVector<unsigned>* coprimes) {
     for (int i = 1; i <= N; i++) {
@@ -1393,6 +1420,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     }
     std::unique_ptr<Thread> thread;
     Queue queue;
+    // time spent running tasks. a task of a parallel section runs until the section ends, including the time it
+    // waits for the next loop of the section.
+    std::atomic<uint64_t> busy_ns{0};
 
     // Each thread has a status, available read-only without locking, and protected
     // by the mutex field below for updates.  The status is used for three
@@ -1513,6 +1543,10 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   // Default is no control over spinning
   std::atomic<SpinLoopStatus> spin_loop_status_{SpinLoopStatus::kBusy};
 
+  // Number of StartSpinningWithoutBlocking calls not yet matched by StopSpinningWithoutBlocking. Takes precedence
+  // over spin_loop_status_ and the spin count.
+  std::atomic<int> spinning_without_blocking_{0};
+
   // Wake any blocked workers so that they can cleanly exit WorkerLoop().  For
   // a clean exit, each thread will observe (1) done_ set, indicating that the
   // destructor has been called, (2) all threads blocked, and (3) no
@@ -1536,8 +1570,8 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     assert(td.GetStatus() == WorkerData::ThreadStatus::Spinning);
 
     constexpr int log2_spin = 20;
-    const int spin_count = allow_spinning_ ? (1ull << log2_spin) : 0;
-    const int steal_count = spin_count / 100;
+    const uint64_t spin_count = allow_spinning_ ? (1ull << log2_spin) : 0;
+    constexpr uint64_t steal_count = (1ull << log2_spin) / 100;
 
     SetDenormalAsZero(set_denormal_as_zero_);
     profiler_.LogThreadId(thread_id);
@@ -1545,8 +1579,13 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     while (!should_exit) {
       Task t = q.PopFront();
       if (!t) {
-        // Spin waiting for work.
-        for (int i = 0; i < spin_count && !done_; i++) {
+        // Spin waiting for work, without a limit while spinning without blocking.
+        for (uint64_t i = 0; !done_; i++) {
+          const bool spin_without_blocking = spinning_without_blocking_.load(std::memory_order_relaxed) > 0;
+          if (i >= spin_count && !spin_without_blocking) {
+            break;
+          }
+
           if (((i + 1) % steal_count == 0)) {
             t = Steal(StealAttemptKind::TRY_ONE);
           } else {
@@ -1554,7 +1593,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           }
           if (t) break;
 
-          if (spin_loop_status_.load(std::memory_order_relaxed) == SpinLoopStatus::kIdle) {
+          if (!spin_without_blocking && spin_loop_status_.load(std::memory_order_relaxed) == SpinLoopStatus::kIdle) {
             break;
           }
           onnxruntime::concurrency::SpinPause();
@@ -1586,6 +1625,12 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
                       should_block = false;
                     }
 
+                    // Likewise, StartSpinningWithoutBlocking either sees us blocking and wakes us, or we see
+                    // it here and go back to spinning.
+                    if (should_block && spinning_without_blocking_.load(std::memory_order_seq_cst) > 0 && !done_) {
+                      should_block = false;
+                    }
+
                     // No work pushed to us, continue attempting to block.  The remaining
                     // test  is to synchronize with termination requests.  If we are
                     // shutting down and all worker threads blocked without work, that's
@@ -1632,7 +1677,12 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
       if (t) {
         td.SetActive();
+        const auto task_start = std::chrono::steady_clock::now();
         t();
+        td.busy_ns.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                       std::chrono::steady_clock::now() - task_start)
+                                                       .count()),
+                             std::memory_order_relaxed);
         profiler_.LogRun(thread_id);
         td.SetSpinning();
       }
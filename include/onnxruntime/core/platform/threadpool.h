@@ -16,10 +16,13 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #pragma once
+#include <atomic>
 #include <string>
 #include <vector>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include "core/common/common.h"
 #include "core/platform/env.h"
 
@@ -127,13 +130,30 @@ struct TensorOpCost {
   double compute_cycles;
 };
 
+// Default arguments giving the location of the caller of a function, like C++20's std::source_location::current().
+// TODO replace them with std::source_location when we move to C++20
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+#define ORT_CALLER_FILE __builtin_FILE()
+#define ORT_CALLER_LINE __builtin_LINE()
+#else
+#define ORT_CALLER_FILE ""
+#define ORT_CALLER_LINE 0
+#endif
+
 namespace concurrency {
 
+// The code running a parallel loop, which identifies the loop for the cost calibration.
+struct ParallelForCallSite {
+  const char* file;
+  int line;
+};
+
 template <typename Environment>
 class ThreadPoolTempl;
 
 class ExtendedThreadPoolInterface;
 class LoopCounter;
+class ParallelForCostCalibration;
 class ThreadPoolParallelSection;
 
 class ThreadPool {
@@ -213,6 +233,37 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Priority class of a session run, see RunScope.
+  enum class RunPriority {
+    kNormal,
+    kHigh,
+  };
+
+  // Limits the parallel loops started by the current thread while the object is alive, e.g. those of the nodes
+  // of one session run. max_degree_of_parallelism caps the number of threads, including the calling one, that work
+  // on each loop, 0 meaning no cap. While a high priority run is in progress in tp, the loops of the normal priority
+  // runs are run by their calling threads only, so the threads of tp take the work of the high priority runs first.
+  //
+  // The limits only apply to the loops started by the thread that created the scope, and not to those of the nodes
+  // run by inter-op threads in the parallel execution mode. A nested scope replaces the limits until it ends.
+  //
+  // shared_max_degree_of_parallelism is an optional second cap that may change while the scope is alive, e.g. the
+  // share of the pool given to the session by a scheduler. It is read on every loop and must outlive the scope.
+  class RunScope {
+   public:
+    RunScope(ThreadPool* tp, int max_degree_of_parallelism, RunPriority priority,
+             const std::atomic<int>* shared_max_degree_of_parallelism = nullptr);
+    ~RunScope();
+
+   private:
+    ThreadPool* tp_;
+    int previous_max_degree_of_parallelism_;
+    const std::atomic<int>* previous_shared_max_degree_of_parallelism_;
+    RunPriority previous_priority_;
+    bool previous_in_run_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunScope);
+  };
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -221,6 +272,18 @@ class ThreadPool {
 
   void DisableSpinning();
 
+  // While StartSpinningWithoutBlocking has been called more times than StopSpinningWithoutBlocking, the threads of
+  // the pool spin until they get work instead of blocking, and are never woken up by the OS to run it.
+  void StartSpinningWithoutBlocking();
+
+  void StopSpinningWithoutBlocking();
+
+  // Measures the cost of the loops run by TryParallelFor and uses the measured costs to split the later ones,
+  // instead of the costs declared by the callers. It must be set before the pool runs any loop.
+  void SetCostCalibration(std::shared_ptr<ParallelForCostCalibration> cost_calibration) {
+    cost_calibration_ = std::move(cost_calibration);
+  }
+
   // Schedules fn() for execution in the pool of threads.  The function may run
   // synchronously if it cannot be enqueued.  This will occur if the thread pool's
   // degree-of-parallelism is 1, but it may also occur for implementation-dependent
@@ -246,13 +309,20 @@ class ThreadPool {
   // parallelism, and may also cause inefficiencies due to load balancing
   // issues and stragglers.
 
+  //
+  // "call_site_file" and "call_site_line" default to the location of the
+  // caller, and identify the loop for the cost calibration.
+
   static void TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
-    TryParallelFor(tp, total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn,
+                             const char* call_site_file = ORT_CALLER_FILE, int call_site_line = ORT_CALLER_LINE) {
+    TryParallelFor(tp, total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn,
+                   call_site_file, call_site_line);
   }
 
   static void TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn,
+                             const char* call_site_file = ORT_CALLER_FILE, int call_site_line = ORT_CALLER_LINE);
 
   // Directly schedule the 'total' tasks to the underlying threadpool, without
   // cutting them by halves
@@ -360,6 +430,31 @@ class ThreadPool {
   // working in combination with the thread initiating the loop.
   static int DegreeOfParallelism(const ThreadPool* tp);
 
+  // Returns the total time the threads of the pool spent running work, in nanoseconds, and the number of threads.
+  // The busy ratio of the pool over an interval is the difference of the busy time divided by the interval and
+  // the number of threads. Both are 0 if tp is nullptr or the pool has no threads.
+  static uint64_t GetBusyNanoseconds(const ThreadPool* tp);
+  static int NumThreads(const ThreadPool* tp);
+
+  // Returns the number of NUMA nodes the threads of the pool are divided between, 0 if tp is nullptr or the pool is
+  // not partitioned by NUMA node.
+  static unsigned NumNumaNodes(const ThreadPool* tp);
+
+  // Statistics of the loops the pool divided between its threads, to compare the parallelism the loops actually use
+  // with the threads of the pool, e.g. to size the pool of a session.
+  struct ParallelismStats {
+    // number of threads started by the pool, 0 until the first parallel loop when the threads are created lazily
+    int created_threads{0};
+    // number of loops divided between more than one thread
+    uint64_t num_loops{0};
+    // sum and maximum over those loops of the threads, including the caller, each loop was divided between.
+    // The effective parallelism of the pool is sum_loop_threads / num_loops.
+    uint64_t sum_loop_threads{0};
+    int max_loop_threads{0};
+  };
+  // All zero if tp is nullptr.
+  static ParallelismStats GetParallelismStats(const ThreadPool* tp);
+
   ORT_DISALLOW_COPY_AND_ASSIGNMENT(ThreadPool);
 
   // StartProfiling and StopProfiling are not to be consumed as public-facing API
@@ -369,14 +464,29 @@ class ThreadPool {
  private:
   friend class LoopCounter;
 
-  // Returns the number of threads created in the pool.  This may be different from the
-  // value returned by DegreeOfParallelism to code using the pool.
+  // Returns the number of threads of the pool, whether they were created yet or not.  This may be different
+  // from the value returned by DegreeOfParallelism to code using the pool.
   int NumThreads() const;
 
+  // Returns the underlying pool, creating its threads first if ThreadOptions::create_threads_lazily is set and this is
+  // the first use that needs them. Returns nullptr if the pool has no threads.
+  ExtendedThreadPoolInterface* GetUnderlyingThreadPool();
+
+  // Creates extended_eigen_threadpool_ with the threads of the pool. Called by the constructor, or under
+  // lazy_creation_mutex_ by GetUnderlyingThreadPool.
+  void CreateUnderlyingThreadPool();
+
+  // Returns the number of threads, including the caller, that may work on a loop started by the calling thread.
+  // This is NumThreads() + 1 unless the calling thread is in a RunScope that limits it.
+  int MaxParallelism() const;
+
   // Returns current thread id between 0 and NumThreads() - 1, if called from a
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
 
+  // Returns the NUMA node of the current thread when the pool is partitioned by NUMA node, 0 otherwise.
+  unsigned CurrentNumaNode() const;
+
   // Run fn with up to n degree-of-parallelism enlisting the thread pool for
   // help.  The degree-of-parallelism includes the caller, and so if n==1
   // then the function will run directly in the caller.  The fork-join
@@ -401,11 +511,9 @@ class ThreadPool {
 
   // Internal (non-static) parallel loop methods.  Unlike the public static methods,
   // these will not handle the cases of OpenMP builds. or builds without a threadpool.
-  void ParallelFor(std::ptrdiff_t total, double cost_per_unit,
-                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
-
   void ParallelFor(std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
-                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn);
+                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn,
+                   const ParallelForCallSite& call_site);
 
   void SimpleParallelFor(std::ptrdiff_t total, const std::function<void(std::ptrdiff_t)>& fn);
 
@@ -417,17 +525,48 @@ class ThreadPool {
 
   ThreadOptions thread_options_;
 
+  // Number of NUMA nodes the threads are divided between, 0 if the pool is not partitioned by NUMA node.
+  unsigned num_numa_nodes_ = 0;
+
   // If a thread pool is created with degree_of_parallelism != 1 then an underlying
   // EigenThreadPool is used to create OS threads and handle work distribution to them.
   // If degree_of_parallelism == 1 then underlying_threadpool_ is left as nullptr
-  // and parallel work is run directly by the caller.
-  ExtendedThreadPoolInterface* underlying_threadpool_ = nullptr;
+  // and parallel work is run directly by the caller. It is also nullptr until the first parallel loop when the
+  // threads are created lazily, so it is only read through GetUnderlyingThreadPool or with acquire semantics.
+  std::atomic<ExtendedThreadPoolInterface*> underlying_threadpool_{nullptr};
 
   // If used, underlying_threadpool_ is instantiated and owned by the ThreadPool.
   std::unique_ptr<ThreadPoolTempl<Env> > extended_eigen_threadpool_;
 
+  // The arguments of the underlying pool, kept to create it lazily.
+  Env* env_;
+  std::optional<std::basic_string<NAME_CHAR_TYPE> > name_;
+  int threads_to_create_ = 0;
+  bool low_latency_hint_;
+
+  // Serializes the lazy creation of the underlying pool with the spinning controls, whose state is kept below until
+  // the pool exists and applied to it once created.
+  std::mutex lazy_creation_mutex_;
+  bool spinning_disabled_ = false;
+  int spinning_without_blocking_ = 0;
+
   // Force the thread pool to run in hybrid mode on a normal cpu.
   bool force_hybrid_ = false;
+
+  // Optional, replaces the costs declared to TryParallelFor with measured ones.
+  std::shared_ptr<ParallelForCostCalibration> cost_calibration_;
+
+  // Number of high priority runs in progress, see RunScope.
+  std::atomic<int> high_priority_runs_{0};
+
+  // Counters of ParallelismStats. Each thread dividing loops between the threads of the pool updates counters of its
+  // own, so the loops of concurrent runs don't write to shared cache lines. GetParallelismStats sums them.
+  struct LoopStats;
+  LoopStats& CurrentThreadLoopStats();
+  // unique among the pools of the process, so a thread can cache its counters of a pool by this id
+  const uint64_t id_;
+  mutable std::mutex loop_stats_mutex_;
+  std::vector<std::unique_ptr<LoopStats>> loop_stats_;
 };
 
 }  // namespace concurrency
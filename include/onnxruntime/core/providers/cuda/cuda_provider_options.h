@@ -40,4 +40,6 @@ struct OrtCUDAProviderOptionsV2 {
   int use_tf32 = 1;                                                                                            // use TF32
   int fuse_conv_bias = 0;                                                                                      // Enable CUDNN Frontend kernel fusing, results in JIT compiles
   int sdpa_kernel = 0;                                                                                         // Scaled Dot Product Attention kernel option
+  int cuda_graph_max_num_graphs = 0;                                                                           // maximum number of captured CUDA graphs, the least recently used one is destroyed first. 0 means unlimited.
+  int copy_staging_buffer_size = 0;                                                                            // size in bytes of the pinned buffers copies between pageable host memory and the device are staged through. 0 means disabled.
 };
@@ -13,6 +13,8 @@
 
 struct OrtThreadingOptions;
 namespace onnxruntime {
+class ThreadPoolScheduler;
+
 /** TODO: remove this class
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -55,6 +57,14 @@ class Environment {
     return create_global_thread_pools_;
   }
 
+  /**
+   * Returns the scheduler that divides the global intra-op thread pool between the sessions using it,
+   * or nullptr if the environment was created without global thread pools.
+   */
+  ThreadPoolScheduler* GetIntraOpThreadPoolScheduler() const {
+    return intra_op_scheduler_.get();
+  }
+
   /**
    * Registers an allocator for sharing between multiple sessions.
    * Return an error if an allocator with the same OrtMemoryInfo is already registered.
@@ -80,6 +90,7 @@ class Environment {
   Status UnregisterAllocator(const OrtMemoryInfo& mem_info);
 
   Environment() = default;
+  ~Environment();
 
   /**
    * Create and register an allocator, specified by provider_type, for sharing between multiple sessions.
@@ -97,6 +108,8 @@ class Environment {
   std::unique_ptr<logging::LoggingManager> logging_manager_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> intra_op_thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
+  // declared after the thread pools so it is destroyed first
+  std::unique_ptr<ThreadPoolScheduler> intra_op_scheduler_;
   bool create_global_thread_pools_{false};
   std::vector<AllocatorPtr> shared_allocators_;
 };
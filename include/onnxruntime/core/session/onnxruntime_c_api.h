@@ -305,6 +305,7 @@ ORT_RUNTIME_CLASS(OpAttr);
 ORT_RUNTIME_CLASS(Logger);
 ORT_RUNTIME_CLASS(ShapeInferContext);
 ORT_RUNTIME_CLASS(LoraAdapter);
+ORT_RUNTIME_CLASS(PreparedRun);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -350,6 +351,9 @@ typedef enum GraphOptimizationLevel {
 typedef enum ExecutionMode {
   ORT_SEQUENTIAL = 0,
   ORT_PARALLEL = 1,
+  /// Run each node on the inter-op thread pool as soon as all of its inputs are available.
+  /// Falls back to ORT_PARALLEL for graphs that need cross-stream synchronization (e.g. GPU execution providers).
+  ORT_PARALLEL_WORK_STEALING = 2,
 } ExecutionMode;
 
 /** \brief Language projection identifiers
@@ -919,6 +923,8 @@ struct OrtApi {
    *
    * Controls whether you want to execute operators in your graph sequentially or in parallel. Usually when the model
    *  has many branches, setting this option to ExecutionMode.ORT_PARALLEL will give you better performance.
+   *  ExecutionMode.ORT_PARALLEL_WORK_STEALING schedules individual nodes instead of streams, which helps wide
+   *  CPU-only models with many independent branches.
    *  See [docs/ONNX_Runtime_Perf_Tuning.md] for more details.
    *
    * \param[in] options
@@ -2810,6 +2816,19 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_max_bytes": Maximum number of bytes each per-thread small-chunk cache may hold.
+   *  Small allocations (up to 64KB) that are freed are parked in a cache owned by the calling thread and
+   *  reused without taking the arena lock. Cache hits/misses are reported in the allocator stats.
+   *  Use 0 or -1 to disable the cache (default).
+   * "idle_shrink_interval_ms": Interval in milliseconds at which a background thread frees the allocation regions
+   *  of the arena that had no memory in use for a whole interval. Enough memory is kept for the recent peak usage,
+   *  which decays by half every interval, so a steady workload does not have to extend the arena again.
+   *  Only used by arenas that are not stream aware, e.g. the CPU arena. Use 0 or -1 to disable it (default).
+   * "use_huge_pages": 1 to back the regions of a CPU arena with 2MB huge pages, which reduces TLB misses.
+   *  Use 0 or -1 to disable it (default).
+   * "cross_stream_reuse": 1 to let a stream of a stream aware arena, e.g. the CUDA arena, reuse the memory freed by
+   *  another stream when no free memory of its own fits, instead of extending the arena. The stream then waits for
+   *  the other one first. Use 0 or -1 to disable it (default).
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -3670,6 +3689,10 @@ struct OrtApi {
    *   "enable_htp_spill_fill_buffer": Enable HTP spill fill buffer setting. The flag is used while generating context binary.
    *     - "0": Default. Disabled.
    *     - "1": Enabled.
+   *   "enable_async_execution": Execute the QNN graphs with QnnGraph_executeAsync. Concurrent Run/RunAsync calls then
+   *   only serialize the graph submission, and overlap their CPU work with the execution on the device.
+   *     - "0": Default. Disabled.
+   *     - "1": Enabled.
    *
    * SNPE supported keys:
    *   "runtime": SNPE runtime engine, options: "CPU", "CPU_FLOAT32", "GPU", "GPU_FLOAT32_16_HYBRID", "GPU_FLOAT16",
@@ -4778,6 +4801,163 @@ struct OrtApi {
    */
   ORT_API2_STATUS(SetEpDynamicOptions, _Inout_ OrtSession* sess, _In_reads_(kv_len) const char* const* keys,
                   _In_reads_(kv_len) const char* const* values, _In_ size_t kv_len);
+
+  /// @}
+  /// \name OrtSession
+  /// @{
+
+  /** \brief Get the kernel time statistics of the sampling profiler
+   *
+   * The sampling profiler is enabled with the "session.profiling_sampling_interval" session config entry
+   * (see onnxruntime_session_options_config_keys.h). It records the kernel times of one in every N runs
+   * and aggregates them per node and per op type, so it can be left enabled in production.
+   *
+   * The statistics are returned as a json object with the "sampled_runs" count, a "nodes" array and an "op_types"
+   * array. Each entry has the "count", "total_us", "min_us" and "max_us" of the kernel times, and a "histogram"
+   * with log2 buckets: bucket 0 counts the times below 1us, and bucket i the times in [2^(i-1), 2^i) us.
+   *
+   * \param[in] session
+   * \param[in] reset If true, the statistics are cleared so that the next call reports the runs sampled after this one.
+   * \param[in] allocator Allocator used to allocate the returned string.
+   * \param[out] out Null terminated string with the statistics, or an empty string if sampling is not enabled.
+   *  It must be freed with `allocator`.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.21.
+   */
+  ORT_API2_STATUS(SessionGetProfilingStatistics, _Inout_ OrtSession* session, _In_ bool reset,
+                  _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
+
+  /** \brief Get the memory timeline of the session
+   *
+   * The timeline is simulated from the allocation plan of the main graph, without executing the model.
+   * For each node of the execution order, it reports the bytes that are live and which values are allocated and
+   * released, and for each device the peak and the values that are live at the peak, the largest first.
+   * Each value has the node that produces it, its size, and whether it is allocated from the memory pattern,
+   * dynamically, or reuses the buffer of another value.
+   *
+   * The sizes come from the inferred shapes, so values with dynamic dimensions have a size of -1.
+   * Use OrtApi::AddFreeDimensionOverrideByName to simulate the timeline for a given batch size.
+   *
+   * \param[in] session An initialized session.
+   * \param[in] allocator Allocator used to allocate the returned string.
+   * \param[out] out Null terminated json string with the timeline. It must be freed with `allocator`.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.21.
+   */
+  ORT_API2_STATUS(SessionGetMemoryTimeline, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Get the metrics of the session in the Prometheus text exposition format
+   *
+   * The metrics are collected on every run with atomic counters, so they are always available:
+   * run duration and queue wait histograms, run failures, the stats of the session allocators (bytes in use,
+   * reserved and peak, allocations), the busy time and number of threads of the session thread pools, and the number of
+   * nodes assigned to each execution provider, including the nodes that fell back to the CPU execution provider.
+   *
+   * The text can be served to Prometheus or to an OpenTelemetry collector with a Prometheus receiver.
+   *
+   * \param[in] session
+   * \param[in] allocator Allocator used to allocate the returned string.
+   * \param[out] out Null terminated string with the metrics. It must be freed with `allocator`.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.21.
+   */
+  ORT_API2_STATUS(SessionGetMetrics, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Resolve the input and output names of the runs to come once
+   *
+   * The names are mapped to the inputs and outputs of the model and the device copies of the values are planned
+   * when the ::OrtPreparedRun is created. OrtApi::RunPrepared then takes the values by position, without looking up
+   * or copying any name, which lowers the fixed cost of a run for small models.
+   *
+   * The ::OrtPreparedRun can be used by concurrent runs of the session and must be released before the session.
+   *
+   * \param[in] session
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input_len Number of elements in the input_names array
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of elements in the output_names array
+   * \param[out] out Newly created ::OrtPreparedRun. Must be freed with OrtApi::ReleasePreparedRun
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.21.
+   */
+  ORT_API2_STATUS(CreatePreparedRun, _Inout_ OrtSession* session,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Outptr_ OrtPreparedRun** out);
+
+  /** \brief Release an ::OrtPreparedRun
+   *
+   * \since Version 1.21.
+   */
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  /** \brief Run the model with the inputs and outputs of an ::OrtPreparedRun
+   *
+   * Same as OrtApi::Run, with the values passed in the order of the names given to OrtApi::CreatePreparedRun.
+   * The values are still checked against the types and shapes of the model inputs and outputs.
+   * Active LoRA adapters of the run options have no effect, as they would add inputs.
+   *
+   * \param[in] session
+   * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+   * \param[in] prepared_run Created by OrtApi::CreatePreparedRun for this session
+   * \param[in] inputs Array of ::OrtValue%s of the inputs
+   * \param[in] input_len Number of elements in the inputs array, which must match the prepared input names
+   * \param[in,out] outputs Array of ::OrtValue%s that the outputs are stored in. This can also be
+   *     an array of nullptr values, in this case ::OrtValue objects will be allocated and pointers
+   *     to them will be set into the `outputs` array.
+   * \param[in] output_len Number of elements in the outputs array, which must match the prepared output names
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.21.
+   */
+  ORT_API2_STATUS(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _In_ const OrtPreparedRun* prepared_run,
+                  _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                  _Inout_updates_all_(output_len) OrtValue** outputs, size_t output_len);
+
+  /** \brief Select the fastest of candidate session options for a model on this device
+   *
+   * Each candidate usually appends different execution providers. The candidates are created one at a time and
+   * run on the same generated inputs: dynamic dimensions are 1, floating point inputs have deterministic values in
+   * [0, 1) and the other inputs are 0. After a warmup run the median time of `num_runs` runs is compared.
+   * The first candidate is the reference, which must succeed. Other candidates are skipped if they fail or if an
+   * element of a floating point output differs from the reference by more than
+   * `accuracy_tolerance * (1 + |reference|)`. Other outputs must be equal.
+   *
+   * If `cache_path` is given, the decision is appended to that file, keyed by a hash of the model file, the device
+   * and the candidates. A later call with the same key returns the cached decision without creating any session.
+   * The data of external initializers is not part of the key.
+   *
+   * The selected candidate is then used to create the session with OrtApi::CreateSession.
+   *
+   * \param[in] env
+   * \param[in] model_path
+   * \param[in] candidates Array of the candidate ::OrtSessionOptions
+   * \param[in] num_candidates Number of elements in the candidates array
+   * \param[in] cache_path Optional file the decisions are persisted in
+   * \param[in] accuracy_tolerance Relative tolerance of the floating point outputs
+   * \param[in] num_runs Number of timed runs of each candidate
+   * \param[out] selected_index Index of the selected candidate
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.21.
+   */
+  ORT_API2_STATUS(SelectFastestSessionOptions, _In_ const OrtEnv* env, _In_ const ORTCHAR_T* model_path,
+                  _In_reads_(num_candidates) const OrtSessionOptions* const* candidates, size_t num_candidates,
+                  _In_opt_z_ const ORTCHAR_T* cache_path, float accuracy_tolerance, int num_runs,
+                  _Out_ size_t* selected_index);
 };
 
 /*
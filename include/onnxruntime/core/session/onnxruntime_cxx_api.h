@@ -509,6 +509,7 @@ ORT_DEFINE_RELEASE(ThreadingOptions);
 ORT_DEFINE_RELEASE(Env);
 ORT_DEFINE_RELEASE(RunOptions);
 ORT_DEFINE_RELEASE(LoraAdapter);
+ORT_DEFINE_RELEASE(PreparedRun);
 ORT_DEFINE_RELEASE(Session);
 ORT_DEFINE_RELEASE(SessionOptions);
 ORT_DEFINE_RELEASE(TensorTypeAndShapeInfo);
@@ -725,6 +726,11 @@ struct Env : detail::Base<OrtEnv> {
   Env& CreateAndRegisterAllocator(const OrtMemoryInfo* mem_info, const OrtArenaCfg* arena_cfg);  ///< Wraps OrtApi::CreateAndRegisterAllocator
 
   Env& CreateAndRegisterAllocatorV2(const std::string& provider_type, const OrtMemoryInfo* mem_info, const std::unordered_map<std::string, std::string>& options, const OrtArenaCfg* arena_cfg);  ///< Wraps OrtApi::CreateAndRegisterAllocatorV2
+
+  /// \brief Wraps OrtApi::SelectFastestSessionOptions. Returns the index of the selected candidate.
+  size_t SelectFastestSessionOptions(const ORTCHAR_T* model_path, const std::vector<const OrtSessionOptions*>& candidates,
+                                     const ORTCHAR_T* cache_path = nullptr, float accuracy_tolerance = 1e-3f,
+                                     int num_runs = 10) const;
 };
 
 /** \brief Custom Op Domain
@@ -769,6 +775,17 @@ struct LoraAdapter : detail::Base<OrtLoraAdapter> {
                                                 OrtAllocator* allocator);
 };
 
+/// \brief PreparedRun holds the input and output names of the runs of a session, resolved once
+///
+/// Created by Session::PrepareRun and passed to Session::Run with the values by position.
+/// It must be released before the session that created it.
+struct PreparedRun : detail::Base<OrtPreparedRun> {
+  using Base = detail::Base<OrtPreparedRun>;
+  using Base::Base;
+
+  explicit PreparedRun(std::nullptr_t) {}  ///< Create an empty PreparedRun object, must be assigned a valid one to be used
+};
+
 /** \brief RunOptions
  *
  */
@@ -1119,6 +1136,25 @@ struct SessionImpl : ConstSessionImpl<T> {
 
   void Run(const RunOptions& run_options, const IoBinding&);  ///< Wraps OrtApi::RunWithBinding
 
+  /** \brief Resolve the input and output names of the runs to come once
+   *
+   * Wraps OrtApi::CreatePreparedRun
+   *
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input_count Number of elements in the input_names array
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_count Number of elements in the output_names array
+   */
+  PreparedRun PrepareRun(const char* const* input_names, size_t input_count,
+                         const char* const* output_names, size_t output_count);
+
+  /** \brief Run the model with the values of the inputs and outputs of a PreparedRun, in the same order
+   *
+   * Wraps OrtApi::RunPrepared
+   */
+  void Run(const RunOptions& run_options, const PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+           Value* output_values, size_t output_count);
+
   /** \brief Run the model asynchronously in a thread owned by intra op thread pool
    *
    * Wraps OrtApi::RunAsync
@@ -1149,6 +1185,28 @@ struct SessionImpl : ConstSessionImpl<T> {
    */
   AllocatedStringPtr EndProfilingAllocated(OrtAllocator* allocator);  ///< Wraps OrtApi::SessionEndProfiling
 
+  /** \brief Get the kernel time statistics of the sampling profiler as json
+   *
+   * \param reset clears the statistics after reading them
+   * \param allocator to allocate memory for the copy of the string returned
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   */
+  AllocatedStringPtr GetProfilingStatisticsAllocated(bool reset, OrtAllocator* allocator);  ///< Wraps OrtApi::SessionGetProfilingStatistics
+
+  /** \brief Get the memory timeline simulated from the allocation plan, as json
+   *
+   * \param allocator to allocate memory for the copy of the string returned
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   */
+  AllocatedStringPtr GetMemoryTimelineAllocated(OrtAllocator* allocator);  ///< Wraps OrtApi::SessionGetMemoryTimeline
+
+  /** \brief Get the metrics of the session in the Prometheus text exposition format
+   *
+   * \param allocator to allocate memory for the copy of the string returned
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   */
+  AllocatedStringPtr GetMetricsAllocated(OrtAllocator* allocator);  ///< Wraps OrtApi::SessionGetMetrics
+
   /** \brief Set DynamicOptions for EPs (Execution Providers)
    *
    * Wraps OrtApi::SetEpDynamicOptions
@@ -549,6 +549,16 @@ inline Env& Env::CreateAndRegisterAllocatorV2(const std::string& provider_type,
   return *this;
 }
 
+inline size_t Env::SelectFastestSessionOptions(const ORTCHAR_T* model_path,
+                                               const std::vector<const OrtSessionOptions*>& candidates,
+                                               const ORTCHAR_T* cache_path, float accuracy_tolerance,
+                                               int num_runs) const {
+  size_t selected_index = 0;
+  ThrowOnError(GetApi().SelectFastestSessionOptions(p_, model_path, candidates.data(), candidates.size(), cache_path,
+                                                    accuracy_tolerance, num_runs, &selected_index));
+  return selected_index;
+}
+
 inline CustomOpDomain::CustomOpDomain(const char* domain) {
   ThrowOnError(GetApi().CreateCustomOpDomain(domain, &p_));
 }
@@ -1076,6 +1086,25 @@ inline void SessionImpl<T>::Run(const RunOptions& run_options, const IoBinding&
   ThrowOnError(GetApi().RunWithBinding(this->p_, run_options, io_binding));
 }
 
+template <typename T>
+inline PreparedRun SessionImpl<T>::PrepareRun(const char* const* input_names, size_t input_count,
+                                              const char* const* output_names, size_t output_count) {
+  OrtPreparedRun* out = nullptr;
+  ThrowOnError(GetApi().CreatePreparedRun(this->p_, input_names, input_count, output_names, output_count, &out));
+  return PreparedRun{out};
+}
+
+template <typename T>
+inline void SessionImpl<T>::Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                                const Value* input_values, size_t input_count,
+                                Value* output_values, size_t output_count) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(GetApi().RunPrepared(this->p_, run_options, prepared_run, ort_input_values, input_count,
+                                    ort_output_values, output_count));
+}
+
 template <typename T>
 inline void SessionImpl<T>::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
                                      const char* const* output_names, Value* output_values, size_t output_count, RunAsyncCallbackFn callback, void* user_data) {
@@ -1093,6 +1122,27 @@ inline AllocatedStringPtr SessionImpl<T>::EndProfilingAllocated(OrtAllocator* al
   return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
 }
 
+template <typename T>
+inline AllocatedStringPtr SessionImpl<T>::GetProfilingStatisticsAllocated(bool reset, OrtAllocator* allocator) {
+  char* out = nullptr;
+  ThrowOnError(GetApi().SessionGetProfilingStatistics(this->p_, reset, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
+template <typename T>
+inline AllocatedStringPtr SessionImpl<T>::GetMemoryTimelineAllocated(OrtAllocator* allocator) {
+  char* out = nullptr;
+  ThrowOnError(GetApi().SessionGetMemoryTimeline(this->p_, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
+template <typename T>
+inline AllocatedStringPtr SessionImpl<T>::GetMetricsAllocated(OrtAllocator* allocator) {
+  char* out = nullptr;
+  ThrowOnError(GetApi().SessionGetMetrics(this->p_, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
 template <typename T>
 inline void SessionImpl<T>::SetEpDynamicOptions(const char* const* keys, const char* const* values, size_t kv_len) {
   ThrowOnError(GetApi().SetEpDynamicOptions(this->p_, keys, values, kv_len));
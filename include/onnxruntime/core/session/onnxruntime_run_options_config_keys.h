@@ -43,9 +43,34 @@ static const char* const kOrtRunOptionsConfigQnnPerfModePostRun = "qnn.htp_perf_
 // Set RPC control latency for QNN HTP backend
 static const char* const kOrtRunOptionsConfigQnnRpcControlLatency = "qnn.rpc_control_latency";
 
+// Set to "1" to release the D3D12 buffers cached by the DML EP for reuse once the run completes, e.g. before the
+// application goes to the background. The buffers still in use by the session are kept. Default is "0".
+static const char* const kOrtRunOptionsConfigDmlTrimMemory = "dml.trim_memory";
+
+// Set to "1" to evict the D3D12 buffers cached by the DML EP for reuse once the run completes, e.g. when the session
+// is going to be idle. Evicted buffers stay cached and are made resident again when they are reused, which lets the
+// OS page them out of video memory under pressure meanwhile. Default is "0".
+static const char* const kOrtRunOptionsConfigDmlEvictCachedMemory = "dml.evict_cached_memory";
+
 // Set graph annotation id for CUDA EP. Use with enable_cuda_graph=true.
 // The value should be an integer. If the value is not set, the default value is 0 and
 // ORT session only captures one cuda graph before another capture is requested.
 // If the value is set to -1, cuda graph capture/replay is disabled in that run.
 // User are not expected to set the value to 0 as it is reserved for internal use.
 static const char* const kOrtRunOptionsConfigCudaGraphAnnotation = "gpu_graph_id";
+
+// Caps the number of threads of the intra-op thread pool, including the thread calling Run, that work on each
+// parallel section of the nodes in this run. The value should be a non-negative integer, 0 meaning no cap, which is
+// the default. It can only lower the parallelism set by the session option intra_op_num_threads.
+// The cap applies to the nodes run by the thread calling Run, i.e. all of them in the sequential execution mode.
+static const char* const kOrtRunOptionsConfigIntraOpNumThreads = "session.intra_op.num_threads";
+
+// Priority class of this run in the intra-op thread pool, "normal" (default) or "high".
+// While a high priority run is in progress, the parallel sections of the normal priority runs using the same
+// intra-op thread pool, e.g. of the same session or of sessions sharing the global thread pools, are run by their
+// calling threads only, so the threads of the pool are available to the high priority runs.
+static const char* const kOrtRunOptionsConfigIntraOpPriority = "session.intra_op.priority";
+
+// Set to "0" to run a session with streaming states (kOrtSessionOptionsStreamingStates) without feeding the kept
+// state values to the model and without updating them. Default is "1".
+static const char* const kOrtRunOptionsConfigUseStreamingStates = "session.use_streaming_states";
@@ -24,6 +24,13 @@ static const char* const kOrtSessionOptionsConfigDisablePrepacking = "session.di
 // will be used. Use this to override the usage of env allocators on a per session level.
 static const char* const kOrtSessionOptionsConfigUseEnvAllocators = "session.use_env_allocators";
 
+// Back the large allocations of the CPU execution provider added by the session, e.g. the regions of its arena and
+// the prepacked weights, with 2MB huge pages to reduce TLB misses. See "use_huge_pages" of OrtArenaCfg for the
+// allocators registered in the env.
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsConfigUseHugePages = "session.use_huge_pages";
+
 // Set to 'ORT' (case sensitive) to load an ORT format model.
 // If unset, model type will default to ONNX unless inferred from filename ('.ort' == ORT format) or bytes to be ORT
 static const char* const kOrtSessionOptionsConfigLoadModelFormat = "session.load_model_format";
@@ -67,6 +74,17 @@ static const char* const kOrtSessionOptionsEnableQuantQDQCleanup = "session.enab
 // GeluApproximation has side effects which may change the inference results. It is disabled by default due to this.
 static const char* const kOrtSessionOptionsEnableGeluApproximation = "optimization.enable_gelu_approximation";
 
+// Fuse float 8 DequantizeLinear -> MatMul [-> QuantizeLinear] assigned to the CUDA EP into com.microsoft.GemmFloat8,
+// which runs on the float 8 tensor cores with cuBLASLt. Requires a GPU with compute capability 8.9 or higher.
+// "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableGemmFloat8Fusion = "optimization.enable_gemm_float8_fusion";
+
+// Compute the logits of a decoder model for the last valid token of each sequence only, as generation reads only
+// those. The final normalization and lm_head MatMul then run on one token per sequence, and the logits output has
+// shape (batch_size, 1, vocab_size) instead of (batch_size, sequence_length, vocab_size).
+// "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsLastTokenLogitsOnly = "optimization.last_token_logits_only";
+
 // This setting controls whether to enable AheadOfTime function inlining.
 // AOT function inlining examines the graph and attempts to inline as many locally defined functions in the model
 // as possible with the help of enabled execution providers.
@@ -107,10 +125,32 @@ static const char* const kOrtSessionOptionsMemoryOptimizerProbeConfig = "optimiz
 // Default is an empty string which means no optimizers are disabled.
 static const char* const kOrtSessionOptionsDisableSpecifiedOptimizers = "optimization.disable_specified_optimizers";
 
+// Maximum size in bytes of a tensor produced by constant folding. A node is not constant folded if one of its outputs
+// would be larger than this, so that folding e.g. an Expand or a Tile of a small initializer does not replace it with
+// a much larger one and bloat the model.
+// Default is "0" which means there is no limit.
+static const char* const kOrtSessionOptionsConstantFoldingMaxOutputSizeInBytes =
+    "optimization.constant_folding_max_output_size_in_bytes";
+
+// Budget in bytes for the estimated peak size of the intermediate values of an inference graph. While the peak is
+// above it, values that are live across the peak without being used there, and that a cheap node produces from graph
+// inputs and initializers, are recomputed right before their later consumers instead of being kept alive.
+// The estimate only counts values with a static shape. Recomputed nodes trade latency for memory.
+// Default is "0" which means there is no budget.
+static const char* const kOrtSessionOptionsActivationMemoryBudgetInBytes =
+    "optimization.activation_memory_budget_in_bytes";
+
 // Enable or disable using device allocator for allocating initialized tensor memory. "1": enable; "0": disable. The default is "0".
 // Using device allocators means the memory allocation is made using malloc/new.
 static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "session.use_device_allocator_for_initializers";
 
+// Enable or disable loading the initializers in parallel on the intra-op thread pool during session initialization.
+// "1": enable; "0": disable. The default is "0".
+// Each initializer is read (or memory mapped, for external data), converted and copied to its device by a separate
+// task, which mostly helps large models with external data placed on a non-CPU device. The execution provider's
+// data transfer must support concurrent copies.
+static const char* const kOrtSessionOptionsLoadInitializersInParallel = "session.load_initializers_in_parallel";
+
 // Configure whether to allow the inter_op/intra_op threads spinning a number of times before blocking
 // "0": thread will block if found no job to run
 // "1": default, thread will spin a number of times before blocking
@@ -128,13 +168,23 @@ static const char* const kOrtSessionOptionsConfigUseORTModelBytesDirectly = "ses
 /// <summary>
 /// Key for using the ORT format model flatbuffer bytes directly for initializers.
 /// This avoids copying the bytes and reduces peak memory usage during model loading and initialization.
-/// Requires `session.use_ort_model_bytes_directly` to be true.
+/// Requires `session.use_ort_model_bytes_directly` to be true, or the model to be loaded from a file that is mapped
+/// into memory (see `session.map_ort_model_file`), in which case it defaults to true.
 /// If set, the flatbuffer bytes provided when creating the InferenceSession MUST remain valid for the entire
 /// duration of the InferenceSession.
 /// </summary>
 static const char* const kOrtSessionOptionsConfigUseORTModelBytesForInitializers =
     "session.use_ort_model_bytes_for_initializers";
 
+// Key for mapping an ORT format model file into memory when the session is created from its path.
+// The pages of the file are read on first access and are shared with other processes that map the same file.
+// The initializers use the mapped bytes unless `session.use_ort_model_bytes_for_initializers` is "0", in which case
+// the mapping is released once the session is initialized. The file must not be modified while it is mapped.
+// Option values:
+// - "0": the model file is read into a buffer.
+// - "1": the model file is mapped into memory, or read if it can't be mapped. [DEFAULT]
+static const char* const kOrtSessionOptionsConfigMapORTModelFile = "session.map_ort_model_file";
+
 // This should only be specified when exporting an ORT format model for use on a different platform.
 // If the ORT format model will be used on ARM platforms set to "1". For other platforms set to "0"
 // Available since version 1.11.
@@ -183,20 +233,74 @@ static const char* const kOrtSessionOptionsConfigDynamicBlockBase = "session.dyn
 // Applies only to internal thread-pools
 static const char* const kOrtSessionOptionsConfigForceSpinningStop = "session.force_spinning_stop";
 
+// Low latency mode of the intra-op thread pool. While a Run() call is in progress, the intra-op threads that run out
+// of work spin until they get more instead of blocking, so the parallel loops of the run don't wait for threads to be
+// woken up by the OS. Threads blocked between runs are woken up when a run starts, before its inputs are validated.
+// The threads keep a CPU core busy for the whole run. Combine with session.intra_op_thread_affinities to pin them
+// to cores that are not used by other threads.
+// The "onnxruntime_session_run_duration_*" metrics of InferenceSession::GetMetrics report the jitter of the runs.
+// "0": default, the threads spin as configured by session.intra_op.allow_spinning, then block.
+// "1": the threads spin without blocking during runs.
+static const char* const kOrtSessionOptionsConfigIntraOpSpinDuringRun = "session.intra_op.spin_during_run";
+
 // "1": all inconsistencies encountered during shape and type inference
 // will result in failures.
 // "0": in some cases warnings will be logged but processing will continue. The default.
 // May be useful to expose bugs in models.
 static const char* const kOrtSessionOptionsConfigStrictShapeTypeInference = "session.strict_shape_type_inference";
 
+// When loading an ONNX model from a file, initializers whose embedded raw_data has at least this many bytes are not
+// copied while the model is parsed. They are recorded as external data referring to their byte range in the model
+// file and materialized when the session is initialized, which memory maps them where possible. This reduces the peak
+// memory of loading large models, and allows models with over 2GB of embedded initializers to be loaded.
+// The model file must not be modified or removed while the session is initialized.
+// "0": default, the whole model is parsed into memory.
+static const char* const kOrtSessionOptionsLazyLoadRawDataThreshold = "session.lazy_load_raw_data_threshold";
+
+// Converts the float nodes of the model to a lower precision when the session is initialized, for the nodes whose
+// assigned execution provider has a kernel for it. Constant initializers are converted once and Cast nodes are
+// inserted only where converted and float values meet. Precision sensitive operators (Softmax, the normalizations,
+// the reductions, Exp, Log, Pow, ...) are always kept in float.
+// "": default, disabled.
+// "fp16": convert to float16.
+// "bf16": convert to bfloat16.
+static const char* const kOrtSessionOptionsAutoMixedPrecision = "session.auto_mixed_precision";
+
+// Semicolon separated op types to convert with session.auto_mixed_precision in addition to the default list of
+// Add, AveragePool, Concat, Conv, ConvTranspose, Flatten, Gather, Gemm, GlobalAveragePool, GlobalMaxPool, LeakyRelu,
+// MatMul, MaxPool, Mul, Relu, Reshape, Sigmoid, Slice, Split, Squeeze, Sub, Tanh, Transpose and Unsqueeze.
+static const char* const kOrtSessionOptionsAutoMixedPrecisionAllowOps = "session.auto_mixed_precision.allow_ops";
+
+// Semicolon separated op types to keep in float with session.auto_mixed_precision.
+static const char* const kOrtSessionOptionsAutoMixedPrecisionDenyOps = "session.auto_mixed_precision.deny_ops";
+
 // "1": every model using a more recent opset than the latest released one will fail
 // "0": the model may or may not work if onnxruntime cannot find an implementation, this option
 // is used for development purpose.
 static const char* const kOrtSessionOptionsConfigStrictAllowReleasedOpsetsOnly = "session.allow_released_opsets_only";
 
-// The file saves configuration for partitioning node among logic streams
+// The file saves configuration for partitioning node among logic streams.
+// {"type":"BranchBasedPartitioner","max_streams_per_device":N} spreads the independent branches of the graph over
+// up to N streams per non-CPU device, so that e.g. small CUDA kernels of different branches can overlap.
+// Adding "collective_stream":true runs the AllReduce, AllGather and AllToAll nodes of each non-CPU device on a
+// dedicated stream, so that the NCCL communication overlaps with the independent computation of the other streams.
 static const char* const kNodePartitionConfigFile = "session.node_partition_config_file";
 
+// Reorders the nodes of graphs that run on a single logic stream, before the memory reuse is planned, to reduce the
+// peak size of the intermediate values. The order is picked greedily with a one node lookahead, using the sizes
+// from shape inference where symbolic dimensions count as 1. It is only used if its estimated peak is lower than the
+// one of the default order. It has no effect with parallel execution.
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsMemoryAwareExecutionOrder = "session.memory_aware_execution_order";
+
+// Lets kernels that may run in place write their outputs over the inputs fed to Run, and lets the planner reuse the
+// buffers of those inputs for other values after their last use. The inputs hold undefined data once Run returns.
+// Only enable it if the caller doesn't read the inputs after Run and no buffer is fed as more than one input.
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsAllowInplaceOnGraphInputs = "session.allow_inplace_on_graph_inputs";
+
 // This Option allows setting affinities for intra op threads.
 // Affinity string follows format:
 // logical_processor_id,logical_processor_id;logical_processor_id,logical_processor_id
@@ -214,6 +318,92 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// This option partitions the intra op thread pool by NUMA node on systems with more than one node.
+// The threads are divided between the nodes in proportion to their number of logical processors, and each thread is
+// attached to the processors of its node. Parallel loops then give the threads of a node a contiguous part of the
+// iteration space, so that the same rows of a tensor keep being processed, and first touched, on the same node.
+// It cannot be combined with "session.intra_op_thread_affinities".
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsConfigIntraOpNumaAware = "session.intra_op_numa_aware";
+
+// This option restricts the intra op thread pool to the cores of the highest performance class on systems with cores
+// of different performance classes, e.g. P-cores and E-cores, so that the latency of a session is not set by its
+// slowest cores. If the number of intra op threads is not set, there is one thread per performance core.
+// It cannot be combined with "session.intra_op_thread_affinities" or "session.intra_op_numa_aware".
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsConfigIntraOpPerformanceCoresOnly =
+    "session.intra_op_performance_cores_only";
+
+// This option creates the threads of the per session intra op and inter op thread pools on their first parallel loop
+// or task instead of when the session is created, so a session whose kernels never divide their work between threads,
+// e.g. one running on a GPU, does not hold idle threads. The first parallel loop pays for creating the threads.
+// The threads that were created and the parallelism the loops actually used are reported by the session metrics.
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsConfigThreadPoolsCreateThreadsLazily =
+    "session.thread_pools_create_threads_lazily";
+
+// This option measures the cost of the parallel loops run by the kernels on the intra op thread pool, and uses the
+// measured costs instead of the costs declared by the kernels to decide how many threads run the later loops.
+// The first loops of each call site and shape are timed, so it adds a small overhead until the costs are calibrated.
+// Only per session thread pools are calibrated.
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsIntraOpCostCalibration = "session.intra_op_cost_calibration";
+
+// Path of a file used to persist the costs calibrated with "session.intra_op_cost_calibration", which is enabled
+// by setting this option. If the file exists, the costs are loaded when the session is created. The costs calibrated
+// by the session are written to the file when the session is destroyed.
+// The file is only used by the build of ONNX Runtime that wrote it on a CPU with the same instruction set extensions.
+// "": no persistence. [DEFAULT]
+static const char* const kOrtSessionOptionsIntraOpCostCalibrationFile = "session.intra_op_cost_calibration_file";
+
+// The following options configure how a session using the global thread pools, i.e. with
+// "session.use_per_session_threads" set to "0", shares the global intra op thread pool with the other sessions.
+//
+// Share of the global intra op thread pool relative to the other sessions. While several sessions with a weight are
+// running, the threads of the pool are divided between them in proportion to their weights, so that one session's
+// parallel loops cannot take every thread. The value should be a non-negative integer.
+// "0": the session is not balanced with the others and its runs may use every thread. [DEFAULT]
+static const char* const kOrtSessionOptionsGlobalThreadPoolWeight = "session.global_thread_pool.weight";
+
+// Maximum number of threads of the global intra op thread pool, including the thread calling Run, working on each
+// parallel loop of the session's runs. The value should be a non-negative integer.
+// "0": no quota. [DEFAULT]
+static const char* const kOrtSessionOptionsGlobalThreadPoolMaxThreads = "session.global_thread_pool.max_threads";
+
+// Maximum number of runs of the session in progress at the same time. Additional runs wait until one finishes, and
+// the wait is recorded in the queue wait metrics of the session. The value should be a non-negative integer.
+// "0": no limit. [DEFAULT]
+static const char* const kOrtSessionOptionsGlobalThreadPoolMaxConcurrentRuns =
+    "session.global_thread_pool.max_concurrent_runs";
+
+// Directory of the optimized model cache. When set, the graph is saved to the directory as an ORT format model after
+// it is optimized, in a file named by a hash of the model, the execution providers, the session options and the
+// version of ONNX Runtime. Later sessions with the same model and configuration load that file and skip the graph
+// optimizations. The directory must exist.
+// The model is not cached if it is loaded from an ORT format model, if "optimized_model_filepath" is set, if
+// external initializers are added with AddExternalInitializers, or if an execution provider compiles nodes of the
+// graph. Use the "ep.context_*" options to cache the models compiled by an execution provider.
+// "": no cache. [DEFAULT]
+static const char* const kOrtSessionOptionsOptimizedModelCacheDir = "session.optimized_model_cache_dir";
+
+// Defer loading the initializers of the subgraphs of control flow nodes (If, Loop, Scan, ...), creating their kernels
+// and pre-packing their weights until the first time each subgraph is executed. This reduces the initialization
+// time and the memory usage of models with subgraphs that are rarely executed, at the cost of a slower first run of
+// each subgraph. Not supported when the pre-packed weights are saved with the model.
+// "0": initialize all the subgraphs in InferenceSession::Initialize(). [DEFAULT]
+// "1": initialize the subgraphs on their first execution.
+static const char* const kOrtSessionOptionsLazySubgraphInitialization = "session.lazy_subgraph_initialization";
+
+// Comma separated list of names of control flow nodes whose subgraphs, including the subgraphs nested in them, are
+// initialized in InferenceSession::Initialize() when "session.lazy_subgraph_initialization" is enabled.
+// This is meant for latency critical paths. A node in a subgraph that is itself initialized lazily is ignored.
+// "": no exceptions. [DEFAULT]
+static const char* const kOrtSessionOptionsLazySubgraphWarmupNodes = "session.lazy_subgraph_warmup_nodes";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
@@ -261,6 +451,123 @@ static const char* const kOrtSessionOptionsOptimizedModelExternalInitializersMin
 static const char* const kOrtSessionOptionsSavePrePackedConstantInitializers =
     "session.save_external_prepacked_constant_initializers";
 
+// Path of a file that caches the pre-packed weights of the CPU EP's kernels across sessions and processes.
+// If the file exists and was written by the same build of ONNX Runtime on a CPU with the same instruction set
+// extensions, it is memory mapped and the kernels that support it use the cached buffers instead of calling PrePack().
+// Otherwise, or if some weights are not in the file, PrePack() runs and the file is rewritten with all the weights
+// once the session is initialized. The file can be shared by several models and processes. The mapped pages are
+// shared through the OS page cache, so the workers serving the same model on a host keep one copy of the packed
+// weights. The cached buffers are used before the ones in an OrtPrepackedWeightsContainer.
+// Currently the float MatMul and Gemm kernels can restore their pre-packed weights from the file.
+// Default is "" (disabled).
+// Sample usage: sess_options.add_session_config_entry(kOrtSessionOptionsPrePackedWeightsCacheFile, "model.prepack")
+static const char* const kOrtSessionOptionsPrePackedWeightsCacheFile = "session.prepacked_weights_cache_file";
+
+// Round each input dimension up to a multiple of this value when looking up the memory pattern cache, so that
+// nearby input shapes (e.g. different sequence lengths) share one memory pattern. Within a bucket the pattern
+// learned from the largest inputs is kept and its blocks are reused for smaller tensors.
+// Only relevant if memory pattern is enabled.
+// "0" or "1": no bucketing, every distinct set of input shapes gets its own memory pattern. [DEFAULT]
+static const char* const kOrtSessionOptionsMemoryPatternShapeBucketSize = "session.memory_pattern_shape_bucket_size";
+
+// Maximum number of memory patterns cached by the session. The least recently used pattern is evicted when the
+// limit is reached.
+// "0": unbounded. [DEFAULT]
+static const char* const kOrtSessionOptionsMemoryPatternCacheMaxEntries = "session.memory_pattern_cache_max_entries";
+
+// Path of a file used to persist the learned memory patterns of the main graph.
+// If the file exists, the patterns are loaded at session initialization. The patterns learned by the session are
+// written to the file when the session is destroyed.
+// The file is only valid for the same model, session options and execution providers it was created with.
+// "": no persistence. [DEFAULT]
+static const char* const kOrtSessionOptionsMemoryPatternCacheFile = "session.memory_pattern_cache_file";
+
+// Path of a file used to persist the TunableOp results of the execution providers that support TunableOp.
+// If the file exists, the results whose validators (ORT version and build, runtime library versions and device
+// model) match the session are loaded at session initialization, and TunableOp is enabled for their providers.
+// When the session is destroyed, the results tuned by the session are merged into the file, so that a file can be
+// shared by sessions running on different devices.
+// "": no persistence. [DEFAULT]
+static const char* const kOrtSessionOptionsTuningResultsCacheFile = "session.tuning_results_cache_file";
+
+// Set to "1" to only load the tuning results cache file, and never write to it. Useful when the file is produced by
+// a single tuning run and deployed with the model.
+// "0": the file is updated when the session is destroyed. [DEFAULT]
+// "1": the file is read only.
+static const char* const kOrtSessionOptionsTuningResultsCacheReadOnly = "session.tuning_results_cache_read_only";
+
+// TunableOp for the default CPU execution provider: some MLAS calls, e.g. the float MatMul with non-constant B, pick
+// the fastest of several partitioning and packing strategies for each shape and thread count.
+// "session.cpu_tunable_op_enable": "1" uses the tuning results, "0" [DEFAULT] runs the default strategies.
+// "session.cpu_tunable_op_tuning_enable": "1" benchmarks the strategies on the first run of a shape without a
+// result, "0" [DEFAULT] only uses the results loaded, e.g. from the tuning results cache file.
+// "session.cpu_tunable_op_max_tuning_duration_ms": maximum time spent benchmarking one strategy, "0" [DEFAULT] for
+// no limit.
+static const char* const kOrtSessionOptionsCpuTunableOpEnable = "session.cpu_tunable_op_enable";
+static const char* const kOrtSessionOptionsCpuTunableOpTuningEnable = "session.cpu_tunable_op_tuning_enable";
+static const char* const kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs =
+    "session.cpu_tunable_op_max_tuning_duration_ms";
+
+// Enables the sampling profiler: the kernel times of one in every N executions of the graph (and of the subgraphs
+// of control flow nodes) are aggregated in memory into per node and per op type histograms, which can be queried
+// while the session is running with OrtApi::SessionGetProfilingStatistics. It does not require enable_profiling,
+// and its memory does not grow with the number of runs.
+// "0": sampling is disabled. [DEFAULT]
+// "N": every N-th execution is sampled, e.g. "1" samples every run.
+static const char* const kOrtSessionOptionsProfilingSamplingInterval = "session.profiling_sampling_interval";
+
+// Adds the hardware performance counters of each kernel to the node events of the profile file written when
+// enable_profiling is set: "cpu_cycles", "instructions", "llc_misses" and "llc_miss_bytes".
+// The counters are read with perf_event_open and are only available on Linux, when the kernel allows it.
+// Only the thread that calls the kernel is counted, not the intra-op thread pool.
+// "0": disabled. [DEFAULT]
+// "1": enabled.
+static const char* const kOrtSessionOptionsProfilingHardwareCounters = "session.profiling_hardware_counters";
+
+// The peak compute throughput in GFLOP/s and memory bandwidth in GB/s of the device, for the roofline summary of the
+// profile written when enable_profiling is set. The node events always have the estimated "flops" and "bytes" of the
+// kernel and its achieved "gflops_per_s" and "gb_per_s". When both peaks are set, EndProfiling also logs the nodes
+// ranked by the time they would save at the roofline, with whether each is compute or memory bound.
+// The estimates are approximate and ops without a cost function have no flops.
+// "0": no summary. [DEFAULT]
+static const char* const kOrtSessionOptionsProfilingRooflinePeakGflops = "session.profiling_roofline_peak_gflops";
+static const char* const kOrtSessionOptionsProfilingRooflinePeakGbps = "session.profiling_roofline_peak_gbps";
+
+// Enables the streaming mode for models called once per chunk of a sequence, e.g. streaming speech recognition.
+// The value lists the recurrent states of the model (KV cache, LSTM hidden state, convolution cache...) as
+// "input_name:output_name" pairs separated by ';', e.g. "past_key:present_key;past_value:present_value".
+// After each Run the session keeps the value of each state output, on the device of the nodes consuming the state
+// input, and feeds it to that input in the next Run unless the input is fed by the caller, so the states don't have to
+// go through user memory between chunks. The runs of a streaming session are serialized.
+// The first Run must feed the state inputs that don't have an initializer. InferenceSession::ResetStreamingStates
+// starts a new sequence. The run option kOrtRunOptionsConfigUseStreamingStates set to "0" runs without the states.
+// By default, the value is empty and the session is stateless.
+static const char* const kOrtSessionOptionsStreamingStates = "session.streaming_states";
+
+// Captures one graph per set of input shapes when graph capture is enabled for the EP (e.g. enable_cuda_graph for the
+// CUDA EP) and the run options don't set kOrtRunOptionsConfigCudaGraphAnnotation.
+// The inputs are copied to device buffers owned by the session for each set of input shapes, and the outputs are
+// copied out of the buffers the captured graph writes to, so inputs and outputs don't have to be bound to fixed
+// addresses and the shapes can vary between runs. The number of captured graphs is bounded by the EP
+// (cuda_graph_max_num_graphs for the CUDA EP), the buffers of an evicted graph are released by the session.
+// "0": disable. [DEFAULT]
+// "1": enable.
+static const char* const kOrtSessionOptionsGraphCaptureByInputShapes = "session.graph_capture_by_input_shapes";
+
+// Maximum number of shape-specialized copies of the model the session builds for the input shapes it observes.
+// A copy is built once a set of values of the symbolic dimensions (dim_param) of the inputs has been seen in
+// kOrtSessionOptionsShapeSpecializationMinRuns runs. It is loaded again from the model path with the dimensions
+// overridden as with free_dimension_overrides, so the optimizers see the concrete shapes and constant folding
+// removes the Shape subgraphs. Runs with these values are then dispatched to the copy, which shares the thread
+// pools of the session. They are not included in the profile and the metrics of the session.
+// Only supported for ONNX models loaded from a path that are run by the CPU EP.
+// "0": disabled. [DEFAULT]
+static const char* const kOrtSessionOptionsShapeSpecializationMaxSessions = "session.shape_specialization_max_sessions";
+
+// Number of runs with the same values of the symbolic input dimensions before a shape-specialized copy of the model
+// is built for them. Default is "10".
+static const char* const kOrtSessionOptionsShapeSpecializationMinRuns = "session.shape_specialization_min_runs";
+
 // Enable EP context feature to dump the partitioned graph which includes the EP context into Onnx file.
 // The dumped Onnx model with EP context can be used for future inference to avoid the EP graph partitioning/compile overhead.
 // "0": disable. (default)
@@ -289,6 +596,45 @@ static const char* const kOrtSessionOptionShareEpContexts = "ep.share_ep_context
 // - "1": Gemm FastMath mode is enabled.
 static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas.enable_gemm_fastmath_arm64_bfloat16";
 
+// Gemm fastmath mode on x64. The fp32 weights of MatMul are converted to bfloat16 when they are pre-packed, the
+// products are computed with the AVX512-BF16 instructions and accumulated in fp32.
+// It has no effect on CPUs without AVX512-BF16 and on platforms other than Linux.
+// Option values:
+// - "0": Gemm FastMath mode is not enabled. [DEFAULT]
+// - "1": Gemm FastMath mode is enabled.
+static const char* const kOrtSessionOptionsMlasGemmFastMathX64Bfloat16 = "mlas.enable_gemm_fastmath_x64_bfloat16";
+
+// DynamicQuantizeMatMul on CPU quantizes input A with a single scale and zero point computed over the whole tensor.
+// When enabled, each row (token) of A is quantized with its own symmetric scale instead, which is applied together
+// with the scale of B and the bias when the int32 result is converted to float. This improves the accuracy for
+// activations whose range varies from token to token.
+// Option values:
+// - "0": A is quantized per tensor. [DEFAULT]
+// - "1": A is quantized per row.
+static const char* const kOrtSessionOptionsDynamicQuantizeMatMulPerRow = "mlas.dynamic_quantize_matmul_per_row";
+
+// Minimum fraction of zero blocks of a constant float weight of MatMul or Gemm on CPU for it to be packed as a block
+// sparse matrix, whose multiplication skips the zero blocks. The blocks are 4 rows along K by 16 columns along N, so
+// this targets block pruned weights. Unstructured or N:M sparsity rarely zeroes whole blocks and keeps the dense path.
+// Values between 0.5 and 0.8 are typical, as the dense kernels are faster on moderately sparse weights.
+// Option values:
+// - "0": the weights are packed for the dense kernels. [DEFAULT]
+// - a value in (0, 1]: the minimum fraction of zero blocks.
+static const char* const kOrtSessionOptionsMlasBlockSparseGemmMinSparsity = "mlas.block_sparse_gemm_min_sparsity";
+
+// Graph partitioning assigns every subgraph proposed by an execution provider to it, which can offload small
+// subgraphs whose inputs and outputs must be copied between the host and the device at a higher cost than running
+// them on the CPU. When set, the subgraphs proposed by execution providers on a non-CPU device are scored with an
+// estimate of their operations (from the static shapes) and of the bytes copied at their boundary, and the ones with
+// fewer operations per copied byte than this value are left to the next execution providers, typically the CPU EP.
+// Subgraphs with dynamic shapes, or with nodes that the CPU EP cannot run, are always offloaded. The decisions are
+// logged at the INFO level.
+// Option values:
+// - "0": every proposed subgraph is offloaded. [DEFAULT]
+// - a positive number: the minimum estimated operations per copied byte for offloading a subgraph.
+static const char* const kOrtSessionOptionsPartitioningCostModelMinOpsPerByte =
+    "session.partitioning_cost_model_min_ops_per_byte";
+
 // When converting DQ + MatMul -> MatMulNBits, the accuracy level of the MatMulNBits is controlled by this option.
 // Refer to MatMulNBits op schema for more details.
 // If not provided, default is 4.
@@ -164,6 +164,11 @@ struct GroupQueryAttentionParameters {
   AttentionQkvFormat past_kv_format;
   int zeros_count;
   int* zero_ptr;
+  // paged kv cache
+  bool is_paged_kv_cache;       // past/present kv are a block pool addressed through a block table
+  int kv_cache_block_size;      // number of tokens per block
+  int num_kv_cache_blocks;      // number of blocks in the pool
+  int max_blocks_per_sequence;  // number of entries per sequence in the block table
 };
 
 // Parameters for sparse attention.
@@ -242,9 +247,17 @@ constexpr const char* kDisableMemoryEfficientAttention = "ORT_DISABLE_MEMORY_EFF
 // Environment variable to enable or disable flash attention. Default is 0 (enabled).
 constexpr const char* kDisableFlashAttention = "ORT_DISABLE_FLASH_ATTENTION";
 
-// Environment variable to enable or disable lean attention. Default is 0 (disabled).
+// Environment variable to enable or disable lean attention. When it is not set, lean attention is selected for
+// decoding when it fills the GPU better than flash attention (see kMinSeqLenForLeanAttention).
+// 1 uses lean attention whenever it is supported, 0 disables it.
 constexpr const char* kEnableLeanAttention = "ORT_ENABLE_LEAN_ATTENTION";
 
+// Minimum total sequence length to select lean attention for decoding when it is not explicitly enabled.
+constexpr const char* kMinSeqLenForLeanAttention = "ORT_MIN_SEQ_LEN_LEAN_ATTENTION";
+
+// Default value for the above setting.
+constexpr int kDefaultMinSeqLenForLeanAttention = 2048;
+
 // Minimum sequence length to perfer memory efficient attention when data type is float32
 constexpr const char* kMinSeqLenForEfficientAttentionFp32 = "ORT_MIN_SEQ_LEN_EFFICIENT_ATTENTION_FP32";
 
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "contrib_ops/cpu/bert/attention_base.h"
 #include "contrib_ops/cpu/bert/attention_helper.h"
 #include "core/common/common.h"
@@ -163,6 +165,11 @@ class AttentionCPUBase : public AttentionBase {
     DUMP_CPU_TENSOR("K", K, batch_size, num_heads_, total_sequence_length, head_size);
     DUMP_CPU_TENSOR("Attn_Bias", attn_bias_data, attn_bias_dims);
 
+    // The softmax of float scores is fused into the loop below, so that a head is normalized while it is still in
+    // cache, and a single additive term (attention bias or mask) is read by the softmax instead of being copied to
+    // the output before the GEMM. The scaled Q*K' is an output when output_qk_data is given, so it is not fused then.
+    const bool fuse_softmax = std::is_same_v<T, float> && output_qk_data == nullptr;
+
     {
       const int loop_len = batch_size * num_heads_;
       const float alpha = scale;
@@ -202,6 +209,7 @@ class AttentionCPUBase : public AttentionBase {
           const ptrdiff_t mask_offset = SafeInt<ptrdiff_t>(batch_index) * probs_matrix_size;
 
           T* output = attention_probs + output_offset;
+          const T* additive_data = nullptr;
 
           if (attn_bias_data != nullptr) {
             // Attention bias has shape (B or 1, N or 1, S, T)
@@ -214,7 +222,11 @@ class AttentionCPUBase : public AttentionBase {
               attn_bias_offset += head_index * probs_matrix_size;
             }
 
-            memcpy(output, attn_bias_data + attn_bias_offset, probs_matrix_bytes);
+            if (fuse_softmax && mask_data == nullptr) {
+              additive_data = attn_bias_data + attn_bias_offset;
+            } else {
+              memcpy(output, attn_bias_data + attn_bias_offset, probs_matrix_bytes);
+            }
 
             if (mask_data != nullptr) {
               // This can be optimized with vectorized add using MlasAddFloat32x4.
@@ -224,7 +236,11 @@ class AttentionCPUBase : public AttentionBase {
             }
           } else if (mask_data != nullptr) {
             // Broadcast mask data: (Bx)SxT -> (BxNx)SxT
-            memcpy(output, mask_data + mask_offset, probs_matrix_bytes);
+            if (fuse_softmax) {
+              additive_data = mask_data + mask_offset;
+            } else {
+              memcpy(output, mask_data + mask_offset, probs_matrix_bytes);
+            }
           }
 
           const T* k = K + kv_input_chunk_length * i;
@@ -247,8 +263,19 @@ class AttentionCPUBase : public AttentionBase {
           // C: attention_probs  (B x N x) S x T          (B x N x) S x T        S x T
           math::Gemm<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, total_sequence_length, head_size, alpha,
                                     Q + q_input_chunk_length * i, k,
-                                    (mask_data != nullptr || attn_bias_data != nullptr) ? 1.0f : 0.0f,
+                                    (additive_data == nullptr && (mask_data != nullptr || attn_bias_data != nullptr))
+                                        ? 1.0f
+                                        : 0.0f,
                                     output, nullptr);
+
+          if constexpr (std::is_same_v<T, float>) {
+            if (fuse_softmax) {
+              MlasComputeAttentionSoftmax(output, static_cast<size_t>(total_sequence_length), additive_data,
+                                          static_cast<size_t>(total_sequence_length),
+                                          static_cast<size_t>(sequence_length),
+                                          static_cast<size_t>(total_sequence_length), 1.0f, -1, nullptr);
+            }
+          }
         }
       });
     }
@@ -259,10 +286,10 @@ class AttentionCPUBase : public AttentionBase {
              SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * total_sequence_length * sizeof(T));
     }
 
-    DUMP_CPU_TENSOR("QK (scaled)", attention_probs, batch_size, num_heads_, sequence_length, total_sequence_length);
-
     // attention_probs(B, N, S, T) = Softmax(attention_probs)
-    {
+    if (!fuse_softmax) {
+      DUMP_CPU_TENSOR("QK (scaled)", attention_probs, batch_size, num_heads_, sequence_length, total_sequence_length);
+
       const int N = batch_size * num_heads_ * sequence_length;
       const int D = total_sequence_length;
       ComputeAttentionSoftmaxInplace(attention_probs, N, D, tp);
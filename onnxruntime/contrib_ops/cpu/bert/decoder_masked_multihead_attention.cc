@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <optional>
+
 #include "attention_cpu_base.h"
 #include "attention_utils.h"
 #include "core/platform/env_var_utils.h"
@@ -67,10 +69,33 @@ Status DecoderMaskedMultiHeadAttention<T>::Compute(OpKernelContext* context) con
 
   DecoderMaskedMultiHeadAttentionParams parameters;
 
+  // Beam width (in case we are using this op inside BeamSearch)
+  int beam_width_value = 1;
+  if (beam_width != nullptr) {
+    beam_width_value = static_cast<int>(*beam_width->Data<int32_t>());
+  }
+
+  // In cross-attention, the key and value of shape (B, N, L, H) may be shared by the beams of each batch entry
+  // instead of being expanded to (B * beam_width, N, L, H). They are checked as views of the expanded shape.
+  const bool is_kv_shared_by_beams = beam_width_value > 1 && past_key == nullptr && key != nullptr &&
+                                     value != nullptr && key->Shape().NumDimensions() == 4 &&
+                                     key->Shape()[0] * beam_width_value == query->Shape()[0];
+  Tensor expanded_key;
+  Tensor expanded_value;
+  if (is_kv_shared_by_beams) {
+    TensorShape expanded_key_shape(key->Shape());
+    expanded_key_shape[0] = query->Shape()[0];
+    expanded_key = Tensor(key->DataType(), expanded_key_shape, const_cast<void*>(key->DataRaw()), key->Location());
+    TensorShape expanded_value_shape(value->Shape());
+    expanded_value_shape[0] = query->Shape()[0];
+    expanded_value = Tensor(value->DataType(), expanded_value_shape, const_cast<void*>(value->DataRaw()),
+                            value->Location());
+  }
+
   bool is_unidirectional = false;
   ORT_RETURN_IF_ERROR(multihead_attention_helper::CheckInputs<Tensor>(query,
-                                                                      key,
-                                                                      value,
+                                                                      is_kv_shared_by_beams ? &expanded_key : key,
+                                                                      is_kv_shared_by_beams ? &expanded_value : value,
                                                                       bias,
                                                                       mask_index,
                                                                       attention_bias,
@@ -163,12 +188,6 @@ Status DecoderMaskedMultiHeadAttention<T>::Compute(OpKernelContext* context) con
     output_qk = context->Output(kQKOutputIndex, qk_shape);
   }
 
-  // Beam width (in case we are using this op inside BeamSearch)
-  int beam_width_value = 1;
-  if (beam_width != nullptr) {
-    beam_width_value = static_cast<int>(*beam_width->Data<int32_t>());
-  }
-
   // Cache indirection (in case we are using this op inside BeamSearch)
   if (beam_width_value > 1 && cache_indir == nullptr) {
     // If beam width > 1, then cache indirection buffer MUST be present
@@ -185,6 +204,15 @@ Status DecoderMaskedMultiHeadAttention<T>::Compute(OpKernelContext* context) con
 
   // Cross-attention case
   if (parameters.is_cross_attention) {
+    if (is_kv_shared_by_beams) {
+      return ApplyCrossAttentionSharedByBeams(Q.GetMutable<Tensor>()->MutableData<T>(),
+                                              key->Data<T>(),
+                                              value->Data<T>(),
+                                              mask_index, output, batch_size, parameters.kv_sequence_length,
+                                              head_size, v_head_size, v_hidden_size, context, beam_width_value,
+                                              output_qk);
+    }
+
     return ApplyAttention(Q.GetMutable<Tensor>()->MutableData<T>(),
                           key->Data<T>(),
                           value->Data<T>(),
@@ -221,6 +249,87 @@ Status DecoderMaskedMultiHeadAttention<T>::Compute(OpKernelContext* context) con
                                  beam_width_value, output_qk);
 }
 
+// The beams of a batch entry attend to the same key and value in cross-attention, so they are computed as the
+// query sequence of that entry: the key and value are read once per batch entry rather than once per beam.
+template <typename T>
+Status DecoderMaskedMultiHeadAttention<T>::ApplyCrossAttentionSharedByBeams(
+    const T* Q,
+    const T* K,
+    const T* V,
+    const Tensor* mask_index,
+    Tensor* output,
+    int batch_size,
+    int kv_sequence_length,
+    int head_size,
+    int v_head_size,
+    int v_hidden_size,
+    OpKernelContext* context,
+    int beam_width,
+    Tensor* output_qk) const {
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  const int kv_batch_size = batch_size / beam_width;
+  const size_t num_heads = static_cast<size_t>(num_heads_);
+  const size_t beams = static_cast<size_t>(beam_width);
+
+  // Q is (B * beam_width, N, 1, H). Transpose it to (B, N, beam_width, H).
+  auto grouped_q = IAllocator::MakeUniquePtr<T>(allocator, SafeInt<size_t>(batch_size) * num_heads * head_size);
+  for (size_t b = 0; b < static_cast<size_t>(kv_batch_size); b++) {
+    for (size_t beam = 0; beam < beams; beam++) {
+      for (size_t n = 0; n < num_heads; n++) {
+        std::memcpy(grouped_q.get() + ((b * num_heads + n) * beams + beam) * head_size,
+                    Q + ((b * beams + beam) * num_heads + n) * head_size,
+                    static_cast<size_t>(head_size) * sizeof(T));
+      }
+    }
+  }
+
+  // The key padding mask is expanded from the encoder attention mask, so the beams of an entry share its row.
+  std::optional<Tensor> grouped_mask;
+  if (mask_index != nullptr) {
+    const int32_t* mask_data = mask_index->Data<int32_t>();
+    grouped_mask.emplace(mask_index->DataType(), TensorShape({kv_batch_size, kv_sequence_length}), allocator);
+    int32_t* grouped_mask_data = grouped_mask->MutableData<int32_t>();
+    for (size_t b = 0; b < static_cast<size_t>(kv_batch_size); b++) {
+      std::memcpy(grouped_mask_data + b * kv_sequence_length, mask_data + b * beams * kv_sequence_length,
+                  static_cast<size_t>(kv_sequence_length) * sizeof(int32_t));
+    }
+  }
+
+  // The output (B, beam_width, v_hidden_size) has the layout of (B * beam_width, 1, v_hidden_size), while QK is
+  // computed as (B, N, beam_width, L) and transposed to (B * beam_width, N, 1, L) afterwards.
+  std::optional<Tensor> grouped_qk;
+  if (output_qk != nullptr) {
+    grouped_qk.emplace(output_qk->DataType(),
+                       TensorShape({kv_batch_size, num_heads_, beam_width, kv_sequence_length}), allocator);
+  }
+
+  ORT_RETURN_IF_ERROR(ApplyAttention(grouped_q.get(), K, V,
+                                     grouped_mask.has_value() ? &*grouped_mask : nullptr,
+                                     nullptr /* past */, nullptr /* past_key */, nullptr /* past_value */, output,
+                                     nullptr /* present_key */, nullptr /* present_value */,
+                                     kv_batch_size, beam_width /* sequence_length */, kv_sequence_length,
+                                     head_size, v_head_size, v_hidden_size, nullptr /* attn_bias */, context,
+                                     grouped_qk.has_value() ? &*grouped_qk : nullptr));
+
+  if (output_qk != nullptr) {
+    const T* grouped_qk_data = grouped_qk->Data<T>();
+    T* output_qk_data = output_qk->MutableData<T>();
+    for (size_t b = 0; b < static_cast<size_t>(kv_batch_size); b++) {
+      for (size_t n = 0; n < num_heads; n++) {
+        for (size_t beam = 0; beam < beams; beam++) {
+          std::memcpy(output_qk_data + ((b * beams + beam) * num_heads + n) * kv_sequence_length,
+                      grouped_qk_data + ((b * num_heads + n) * beams + beam) * kv_sequence_length,
+                      static_cast<size_t>(kv_sequence_length) * sizeof(T));
+        }
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 Status DecoderMaskedMultiHeadAttention<T>::ApplyAttentionWithBeams(
     const T* Q,
@@ -64,6 +64,19 @@ class DecoderMaskedMultiHeadAttention final : public OpKernel, public AttentionC
                                         const int32_t* cache_indir_data,
                                         int beam_width,
                                         ThreadPool* tp) const;
+  Status ApplyCrossAttentionSharedByBeams(const T* Q,
+                                          const T* K,
+                                          const T* V,
+                                          const Tensor* mask_index,
+                                          Tensor* output,
+                                          int batch_size,
+                                          int kv_sequence_length,
+                                          int head_size,
+                                          int v_head_size,
+                                          int v_hidden_size,
+                                          OpKernelContext* context,
+                                          int beam_width,
+                                          Tensor* output_qk = nullptr) const;
   Status Compute(OpKernelContext* context) const override;
 
  protected:
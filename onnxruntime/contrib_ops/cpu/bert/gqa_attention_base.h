@@ -10,6 +10,13 @@
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
+#include "core/platform/env_var_utils.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace onnxruntime {
 namespace contrib {
@@ -34,6 +41,9 @@ class GQAAttentionBase {
     use_smooth_softmax_ = info.GetAttrOrDefault<int64_t>("smooth_softmax", 0) == 1;
 
     local_window_size_ = has_local ? static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1)) : -1;
+
+    l2_cache_size_ = Env::Default().GetL2CacheSize();
+    disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
   }
 
   int num_heads_;     // number of attention heads of Q
@@ -46,6 +56,9 @@ class GQAAttentionBase {
 
   bool use_smooth_softmax_;
 
+  bool disable_flash_;
+  int l2_cache_size_;
+
   template <typename T>
   Status ApplyAttention(const T* Q,                                 // Q data with shape BxNxSxH
                         const T* K,                                 // K data with shape BxN_kvxSxH
@@ -56,6 +69,7 @@ class GQAAttentionBase {
                         Tensor* present_key,                        // present K output tensor (if separating present KV)
                         Tensor* present_value,                      // present V output tensor (if separating present KV)
                         const Tensor* seqlens_k,                    // past sequence lengths tensor
+                        const Tensor* block_table,                  // block table of the paged kv cache, or nullptr
                         GroupQueryAttentionParameters& parameters,  // attention parameters
                         AllocatorPtr allocator,                     // allocator for temporary tensors
                         OpKernelContext* context) const {
@@ -74,10 +88,17 @@ class GQAAttentionBase {
     }
     int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
 
-    // Compute the attention score.
-    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(float);
-    auto attention_probs = allocator->Alloc(bytes);
-    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+    PagedKVCache paged_kv_cache;
+    if (parameters.is_paged_kv_cache) {
+      // past and present are block pools. the attention probs are laid out as if the sequences had contiguous
+      // buffers of the capacity of the block table.
+      seqlen_past_kv_cache = parameters.seqlen_past_kv_cache;
+      seqlen_present_kv_cache = parameters.seqlen_present_kv_cache;
+      paged_kv_cache.block_table = block_table->Data<int32_t>();
+      paged_kv_cache.block_size = static_cast<size_t>(parameters.kv_cache_block_size);
+      paged_kv_cache.max_blocks_per_sequence = static_cast<size_t>(parameters.max_blocks_per_sequence);
+      paged_kv_cache.block_stride = SafeInt<size_t>(kv_num_heads_) * paged_kv_cache.block_size * head_size;
+    }
 
     const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
     T* present_key_data = present_key != nullptr ? present_key->MutableData<T>() : nullptr;
@@ -87,22 +108,423 @@ class GQAAttentionBase {
     bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
 
     const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+    if (paged_kv_cache.IsEnabled()) {
+      ORT_RETURN_IF_ERROR(UpdatePagedKVCache(k, v, seqlens_k->Data<int32_t>(), batch_size, sequence_length, head_size,
+                                             past_key_data, past_value_data, present_key_data, present_value_data,
+                                             past_present_share_buffer, packed_qkv, is_prompt, paged_kv_cache,
+                                             parameters.num_kv_cache_blocks, tp));
+    }
+
+    if constexpr (std::is_same_v<T, float>) {
+      if (!disable_flash_ && l2_cache_size_ > 0 && softcap_ == 0.0f && !use_smooth_softmax_ &&
+          !paged_kv_cache.IsEnabled()) {
+        ApplyFlashAttention(Q, k, v, seqlens_k->Data<int32_t>(), batch_size, sequence_length, seqlen_past_kv_cache,
+                            seqlen_present_kv_cache, head_size, past_key_data, past_value_data, present_key_data,
+                            present_value_data, past_present_share_buffer, packed_qkv, is_prompt,
+                            output->MutableData<float>(), allocator, tp);
+        return Status::OK();
+      }
+    }
+
+    // Compute the attention score.
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(float);
+    auto attention_probs = allocator->Alloc(bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
     ComputeAttentionProbs<T>(static_cast<float*>(attention_probs), Q, k, seqlens_k->Data<int32_t>(), batch_size,
                              sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size, past_key_data,
-                             present_key_data, past_present_share_buffer, packed_qkv, is_prompt, tp, allocator);
+                             present_key_data, past_present_share_buffer, packed_qkv, is_prompt, paged_kv_cache, tp,
+                             allocator);
 
     // Compute the attentionScore * Value: out(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
-    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
     ComputeVxAttentionScore(output->MutableData<T>(), static_cast<float*>(attention_probs), v,
                             seqlens_k->Data<int32_t>(),
                             batch_size, sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size,
                             hidden_size, past_value_data, present_value_data, past_present_share_buffer, packed_qkv,
-                            is_prompt, tp, allocator);
+                            is_prompt, paged_kv_cache, tp, allocator);
+
+    return Status::OK();
+  }
+
+  // Attention with a kv cache of int8 values. The new key and value tokens are quantized with the scale of their kv
+  // head when they are appended, and the cache of a head is dequantized to float right before the products with Q
+  // and with the attention probs of each of its query heads.
+  template <typename T>
+  Status ApplyAttentionWithInt8KVCache(const T* Q,                                 // Q data with shape BxNxSxH
+                                       const T* K,                                 // K data with shape BxN_kvxSxH
+                                       const T* V,                                 // V data with shape BxN_kvxSxH
+                                       const Tensor* past_key,                     // past int8 K, or nullptr
+                                       const Tensor* past_value,                   // past int8 V, or nullptr
+                                       Tensor* output,                             // output tensor
+                                       Tensor* present_key,                        // present int8 K
+                                       Tensor* present_value,                      // present int8 V
+                                       const Tensor* seqlens_k,                    // past sequence lengths tensor
+                                       const Tensor* k_scale,                      // scales of K, (1) or (N_kv)
+                                       const Tensor* v_scale,                      // scales of V, (1) or (N_kv)
+                                       GroupQueryAttentionParameters& parameters,  // attention parameters
+                                       AllocatorPtr allocator,                     // allocator for temporary buffers
+                                       OpKernelContext* context) const {
+    const bool is_prompt = parameters.is_first_prompt;
+    const size_t batch_size = static_cast<size_t>(parameters.batch_size);
+    const size_t sequence_length = static_cast<size_t>(parameters.sequence_length);
+    const size_t head_size = static_cast<size_t>(parameters.head_size);
+    const size_t hidden_size = static_cast<size_t>(parameters.hidden_size);
+    const bool packed_qkv = parameters.is_packed_qkv;
+
+    auto* tp = context->GetOperatorThreadPool();
+
+    const size_t past_buffer_sequence_length =
+        past_key != nullptr ? static_cast<size_t>(past_key->Shape().GetDims()[2]) : 0;
+    const size_t present_buffer_sequence_length = static_cast<size_t>(present_key->Shape().GetDims()[2]);
+
+    const int8_t* past_key_data = past_key != nullptr ? past_key->Data<int8_t>() : nullptr;
+    const int8_t* past_value_data = past_value != nullptr ? past_value->Data<int8_t>() : nullptr;
+    int8_t* present_key_data = present_key->MutableData<int8_t>();
+    int8_t* present_value_data = present_value->MutableData<int8_t>();
+    const bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+
+    const auto k_scales = k_scale->DataAsSpan<float>();
+    const auto v_scales = v_scale->DataAsSpan<float>();
+    auto head_scale = [](gsl::span<const float> scales, size_t kv_head_index) {
+      return scales.size() == 1 ? scales[0] : scales[kv_head_index];
+    };
+
+    const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const size_t kv_input_chunk_length = sequence_length * head_size;                     // L x H
+    const size_t past_buff_chunk_length = past_buffer_sequence_length * head_size;        // L x H
+    const size_t present_buff_chunk_length = present_buffer_sequence_length * head_size;  // T x H
+
+    if (!past_present_share_buffer) {
+      const size_t present_bytes = SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_length;
+      memset(present_key_data, 0, present_bytes);
+      memset(present_value_data, 0, present_bytes);
+    }
+
+    std::vector<size_t> total_seqlens(batch_size);
+    const int32_t* seqlens_k_data = seqlens_k->Data<int32_t>();
+    for (size_t b = 0; b < batch_size; b++) {
+      total_seqlens[b] = static_cast<size_t>(seqlens_k_data[b]) + 1;
+    }
+    const size_t max_total_seqlen = *std::max_element(total_seqlens.begin(), total_seqlens.end());
+
+    // Append the new tokens of each kv head to the present buffers.
+    TensorOpCost append_cost;
+    append_cost.compute_cycles = static_cast<double>(4 * kv_input_chunk_length);
+    append_cost.bytes_loaded = static_cast<double>(2 * kv_input_chunk_length * sizeof(T));
+    append_cost.bytes_stored = static_cast<double>(2 * present_buff_chunk_length);
+
+    ThreadPool::TryParallelFor(tp, batch_size * kv_num_heads_, append_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      std::vector<float> chunk_fp32(std::is_same_v<T, float> ? 0 : kv_input_chunk_length);
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = i / kv_num_heads_;
+        const size_t kv_head_index = i % kv_num_heads_;
+        const size_t total_seqlen = total_seqlens[batch_index];
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;  // Assume no padding sequence length
+        const size_t past_chunk_length = past_seqlen * head_size;
+
+        const ptrdiff_t input_offset =
+            packed_qkv ? packed_batch_stride * batch_index + kv_input_chunk_length * kv_head_index
+                       : SafeInt<ptrdiff_t>(kv_input_chunk_length) * i;
+        for (const bool is_key : {true, false}) {
+          const int8_t* past = is_key ? past_key_data : past_value_data;
+          int8_t* present = (is_key ? present_key_data : present_value_data) + i * present_buff_chunk_length;
+          if (!past_present_share_buffer && past_chunk_length > 0) {
+            memcpy(present, past + i * past_buff_chunk_length, past_chunk_length);
+          }
+
+          const T* chunk = (is_key ? k : v) + input_offset;
+          const float* chunk_data;
+          if constexpr (std::is_same_v<T, float>) {
+            chunk_data = chunk;
+          } else {
+            MlasConvertHalfToFloatBuffer(chunk, chunk_fp32.data(), kv_input_chunk_length);
+            chunk_data = chunk_fp32.data();
+          }
+          MlasQuantizeLinear<int8_t>(chunk_data, present + past_chunk_length, kv_input_chunk_length,
+                                     head_scale(is_key ? k_scales : v_scales, kv_head_index), 0);
+        }
+      }
+    });
+
+    // Compute the attention of each query head from the dequantized cache of its kv head.
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(4) * sequence_length * head_size * max_total_seqlen);
+    unit_cost.bytes_loaded = static_cast<double>((sequence_length * sizeof(T) + 2 * max_total_seqlen) * head_size);
+    unit_cost.bytes_stored = static_cast<double>(sequence_length * head_size * sizeof(T));
+
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    const size_t q_input_chunk_length = sequence_length * head_size;  // S x H
+    T* output_data = output->MutableData<T>();
+
+    ThreadPool::TryParallelFor(tp, batch_size * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      // the dequantized kv, the attention probs and, for float16, q and the output of a head
+      const size_t buffer_length = SafeInt<size_t>(max_total_seqlen) * (head_size + sequence_length) +
+                                   (std::is_same_v<T, float> ? 0 : 2 * q_input_chunk_length);
+      auto buffer = IAllocator::MakeUniquePtr<float>(allocator, buffer_length);
+      float* kv_fp32 = buffer.get();
+      float* probs = kv_fp32 + max_total_seqlen * head_size;
+      float* q_fp32 = probs + max_total_seqlen * sequence_length;
+      float* output_fp32 = q_fp32 + q_input_chunk_length;
+
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = i / num_heads_;
+        const size_t head_index = i % num_heads_;
+        const size_t kv_head_index = head_index / kv_num_heads_factor;
+        const size_t kv_i = batch_index * kv_num_heads_ + kv_head_index;
+        const size_t total_seqlen = total_seqlens[batch_index];
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;  // Assume no padding sequence length
+
+        const T* q = packed_qkv ? Q + packed_batch_stride * batch_index + q_input_chunk_length * head_index
+                                : Q + q_input_chunk_length * i;
+        const float* q_data;
+        if constexpr (std::is_same_v<T, float>) {
+          q_data = q;
+        } else {
+          MlasConvertHalfToFloatBuffer(q, q_fp32, q_input_chunk_length);
+          q_data = q_fp32;
+        }
+
+        // probs(S, T) = alpha x Q(S, H) x K'(H, T)
+        DequantizeKVChunk(present_key_data + kv_i * present_buff_chunk_length, kv_fp32, total_seqlen * head_size,
+                          head_scale(k_scales, kv_head_index));
+        math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, total_seqlen, head_size, alpha,
+                                        q_data, static_cast<int>(head_size), kv_fp32, static_cast<int>(head_size),
+                                        0.0f /*beta*/, probs, static_cast<int>(total_seqlen), nullptr);
+        ComputeCausalSoftmaxInplace(probs, sequence_length, past_seqlen, total_seqlen, total_seqlen);
+
+        // out(S, H) = probs(S, T) x V(T, H)
+        DequantizeKVChunk(present_value_data + kv_i * present_buff_chunk_length, kv_fp32, total_seqlen * head_size,
+                          head_scale(v_scales, kv_head_index));
+        T* output_current = output_data + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
+        if constexpr (std::is_same_v<T, float>) {
+          math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, total_seqlen, 1.0f,
+                                          probs, static_cast<int>(total_seqlen), kv_fp32, static_cast<int>(head_size),
+                                          0.0f /*beta*/, output_current, static_cast<int>(hidden_size), nullptr);
+        } else {
+          math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, total_seqlen, 1.0f,
+                                          probs, static_cast<int>(total_seqlen), kv_fp32, static_cast<int>(head_size),
+                                          0.0f /*beta*/, output_fp32, static_cast<int>(head_size), nullptr);
+          for (size_t seq = 0; seq < sequence_length; seq++) {
+            MlasConvertFloatToHalfBuffer(output_fp32 + seq * head_size, output_current + seq * hidden_size, head_size);
+          }
+        }
+      }
+    });
 
     return Status::OK();
   }
 
  private:
+  static void DequantizeKVChunk(const int8_t* input, float* output, size_t length, float scale) {
+    for (size_t i = 0; i < length; i++) {
+      output[i] = static_cast<float>(input[i]) * scale;
+    }
+  }
+
+  // Block table of a paged kv cache. Logical block j of sequence b is stored in pool block
+  // block_table[b * max_blocks_per_sequence + j], which holds block_size tokens of every kv head.
+  struct PagedKVCache {
+    const int32_t* block_table = nullptr;
+    size_t block_size = 0;
+    size_t max_blocks_per_sequence = 0;
+    size_t block_stride = 0;  // kv_num_heads x block_size x head_size
+
+    bool IsEnabled() const { return block_table != nullptr; }
+
+    // offset of the first token of logical block `logical_block` of kv head `kv_head_index` in the pool
+    size_t BlockOffset(size_t batch_index, size_t kv_head_index, size_t logical_block, size_t head_size) const {
+      const size_t block = static_cast<size_t>(block_table[batch_index * max_blocks_per_sequence + logical_block]);
+      return block * block_stride + kv_head_index * block_size * head_size;
+    }
+  };
+
+  // Appends the new K and V to the present buffers and computes the attention with the tiled kernel of MLAS, which
+  // keeps the scores of a block of queries and keys in the L2 cache instead of materializing the attention probs.
+  void ApplyFlashAttention(const float* Q,                               // Q data with shape BxNxSxH
+                           const float* K,                               // new k data
+                           const float* V,                               // new v data
+                           const int32_t* seqlens_k,                     // total - 1 sequence lengths tensor
+                           const size_t batch_size,                      // batch size of self-attention
+                           const size_t sequence_length,                 // sequence length of self-attention (S)
+                           const size_t past_buffer_sequence_length,     // sequence length of past state
+                           const size_t present_buffer_sequence_length,  // sequence length of present state
+                           const size_t head_size,                       // head size of self-attention
+                           const float* past_key,                        // past key only
+                           const float* past_value,                      // past value only
+                           float* present_key,                           // present key only
+                           float* present_value,                         // present value only
+                           const bool past_present_share_buffer,         // whether present and past share buffers
+                           const bool packed_qkv,                        // whether Q, K, V are packed
+                           const bool is_prompt,                         // whether it is prompt
+                           float* output,                                // output with shape BxSxNxH
+                           AllocatorPtr allocator,                       // allocator for temporary buffers
+                           ThreadPool* tp) const {
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_input_chunk_length = sequence_length * head_size;                     // L x H
+    const size_t past_buff_chunk_length = past_buffer_sequence_length * head_size;        // L x H
+    const size_t present_buff_chunk_length = present_buffer_sequence_length * head_size;  // T x H
+
+    if (!past_present_share_buffer) {
+      const size_t present_bytes = SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_length *
+                                   sizeof(float);
+      memset(present_key, 0, present_bytes);
+      memset(present_value, 0, present_bytes);
+    }
+
+    std::vector<int> total_seqlens(batch_size);
+    for (size_t b = 0; b < batch_size; b++) {
+      total_seqlens[b] = seqlens_k[b] + 1;
+    }
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles = 0;
+    unit_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length * sizeof(float));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+
+    ThreadPool::TryParallelFor(tp, batch_size * kv_num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = i / kv_num_heads_;
+        const size_t kv_head_index = i % kv_num_heads_;
+        const size_t total_seqlen = static_cast<size_t>(total_seqlens[batch_index]);
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;  // Assume no padding sequence length
+        const size_t past_chunk_length = past_seqlen * head_size;
+
+        const ptrdiff_t input_offset =
+            packed_qkv ? packed_batch_stride * batch_index + kv_input_chunk_length * kv_head_index
+                       : SafeInt<ptrdiff_t>(kv_input_chunk_length) * i;
+        ConcatStateChunkGQA(past_key, K + input_offset, present_key, present_buff_chunk_length,
+                            past_buff_chunk_length, past_chunk_length, kv_input_chunk_length,
+                            past_present_share_buffer, i);
+        ConcatStateChunkGQA(past_value, V + input_offset, present_value, present_buff_chunk_length,
+                            past_buff_chunk_length, past_chunk_length, kv_input_chunk_length,
+                            past_present_share_buffer, i);
+      }
+    });
+
+    const int head_size_int = static_cast<int>(head_size);
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = static_cast<int>(batch_size);
+    args.num_heads = num_heads_;
+    args.q_sequence_length = static_cast<int>(sequence_length);
+    args.kv_sequence_length = *std::max_element(total_seqlens.begin(), total_seqlens.end());
+    args.qk_head_size = head_size_int;
+    args.v_head_size = head_size_int;
+    args.scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    // Same block sizes as MultiHeadAttention, see the derivation there.
+    args.kv_block_size = l2_cache_size_ / (static_cast<int>(sizeof(float)) * 4 * (2 * head_size_int));
+    args.kv_block_size = std::max(args.kv_block_size, 1);
+    args.q_block_size = std::min(args.kv_block_size, 2 * head_size_int);
+    args.kv_block_size = std::min(args.kv_block_size, args.kv_sequence_length);
+    args.q_block_size = std::min(args.q_block_size, args.q_sequence_length);
+
+    args.thread_count = ThreadPool::DegreeOfParallelism(tp);
+    args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
+                                   static_cast<size_t>(args.q_block_size) * head_size) *
+                                  sizeof(float);
+    size_t buffer_bytes = args.buffer_size_per_thread * args.thread_count;
+    IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
+    args.buffer = reinterpret_cast<float*>(buffer.get());
+
+    args.query = Q;
+    args.key = present_key;
+    args.value = present_value;
+    args.output = output;
+
+    args.kv_num_heads = kv_num_heads_;
+    args.kv_buffer_sequence_length = static_cast<int>(present_buffer_sequence_length);
+    args.q_batch_stride = packed_qkv ? static_cast<size_t>(packed_batch_stride) : 0;
+    args.kv_sequence_lengths = total_seqlens.data();
+    args.is_causal = true;
+    args.local_window_size = local_window_size_;
+
+    MlasFlashAttention(&args, tp);
+  }
+
+  // Validates the block table and writes the new key and value tokens into their blocks of the present pool.
+  template <typename T>
+  Status UpdatePagedKVCache(const T* K,                           // new k data
+                            const T* V,                           // new v data
+                            const int32_t* seqlens_k,             // total - 1 sequence lengths tensor
+                            const size_t batch_size,              // batch size of self-attention
+                            const size_t sequence_length,         // sequence length of self-attention (S)
+                            const size_t head_size,               // head size of self-attention
+                            const T* past_key,                    // past key block pool
+                            const T* past_value,                  // past value block pool
+                            T* present_key,                       // present key block pool
+                            T* present_value,                     // present value block pool
+                            const bool past_present_share_buffer,  // whether present and past pools are the same
+                            const bool packed_qkv,                // whether Q, K, V are packed
+                            const bool is_prompt,                 // whether it is prompt
+                            const PagedKVCache& paged_kv_cache,   // block table
+                            const int num_blocks,                 // number of blocks in the pool
+                            ThreadPool* tp) const {
+    const size_t block_size = paged_kv_cache.block_size;
+    for (size_t b = 0; b < batch_size; b++) {
+      const size_t total_seqlen = static_cast<size_t>(seqlens_k[b]) + 1;
+      ORT_RETURN_IF(seqlens_k[b] < 0 || total_seqlen > paged_kv_cache.max_blocks_per_sequence * block_size,
+                    "seqlens_k[", b, "] is out of the range of the block table.");
+      const size_t num_used_blocks = (total_seqlen + block_size - 1) / block_size;
+      for (size_t j = 0; j < num_used_blocks; j++) {
+        const int32_t block = paged_kv_cache.block_table[b * paged_kv_cache.max_blocks_per_sequence + j];
+        ORT_RETURN_IF(block < 0 || block >= num_blocks, "block_table[", b, ", ", j, "] = ", block,
+                      " is not a valid block of the kv cache with ", num_blocks, " blocks.");
+      }
+    }
+
+    if (!past_present_share_buffer) {
+      const size_t pool_bytes = SafeInt<size_t>(num_blocks) * paged_kv_cache.block_stride * sizeof(T);
+      memcpy(present_key, past_key, pool_bytes);
+      memcpy(present_value, past_value, pool_bytes);
+    }
+
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(0);
+    const size_t kv_input_chunk_length = sequence_length * head_size;  // L x H
+    const size_t loop_len = batch_size * kv_num_heads_;
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles = 0;
+    unit_cost.bytes_loaded = static_cast<double>(2 * kv_input_chunk_length * sizeof(T));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+
+    ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = i / kv_num_heads_;
+        const size_t kv_head_index = i % kv_num_heads_;
+        const size_t total_seqlen = static_cast<size_t>(seqlens_k[batch_index]) + 1;
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;  // Assume no padding sequence length
+
+        const ptrdiff_t input_offset =
+            packed_qkv ? packed_batch_stride * batch_index + kv_input_chunk_length * kv_head_index
+                       : SafeInt<ptrdiff_t>(kv_input_chunk_length) * i;
+        const T* k = K + input_offset;
+        const T* v = V + input_offset;
+
+        // padding tokens of a prompt don't get a place in the cache
+        for (size_t pos = past_seqlen; pos < total_seqlen && pos < past_seqlen + sequence_length; pos++) {
+          const size_t offset = paged_kv_cache.BlockOffset(batch_index, kv_head_index, pos / block_size, head_size) +
+                                (pos % block_size) * head_size;
+          memcpy(present_key + offset, k + (pos - past_seqlen) * head_size, head_size * sizeof(T));
+          memcpy(present_value + offset, v + (pos - past_seqlen) * head_size, head_size * sizeof(T));
+        }
+      }
+    });
+
+    return Status::OK();
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
@@ -121,6 +543,7 @@ class GQAAttentionBase {
                              const bool past_present_share_buffer,         // whether present key and value share the same buffer
                              const bool packed_qkv,                        // whether Q, K, V are packed
                              const bool is_prompt,                         // whether it is prompt
+                             const PagedKVCache& paged_kv_cache,           // block table if present key is paged
                              ThreadPool* tp,                               // thread pool
                              AllocatorPtr allocator) const {               // allocator for temporary buffer
     const ptrdiff_t packed_batch_stride =
@@ -132,7 +555,7 @@ class GQAAttentionBase {
     const size_t past_buff_chunk_length = past_buffer_sequence_length * head_size;        // L x H
     const size_t present_buff_chunk_length = present_buffer_sequence_length * head_size;  // T x H
 
-    if (!past_present_share_buffer) {
+    if (!past_present_share_buffer && !paged_kv_cache.IsEnabled()) {
       memset((void*)present_key,
              0,
              batch_size * kv_num_heads_ * present_buffer_sequence_length * head_size * sizeof(T));
@@ -176,7 +599,9 @@ class GQAAttentionBase {
         } else {
           k = K + kv_input_chunk_length * (i / kv_num_heads_factor);
         }
-        if (nullptr != present_key) {
+        if (paged_kv_cache.IsEnabled()) {
+          // the new tokens have already been written to the blocks, k is read block by block below
+        } else if (nullptr != present_key) {
           k = ConcatStateChunkGQA(past_key, k, present_key, present_buff_chunk_length, past_buff_chunk_length,
                                   past_chunk_length, kv_input_chunk_length, past_present_share_buffer,
                                   i / kv_num_heads_factor);
@@ -194,10 +619,26 @@ class GQAAttentionBase {
           q = Q + q_input_chunk_length * i;
         }
 
+        const size_t kv_head_index = head_index / kv_num_heads_factor;
         if constexpr (std::is_same<T, float>::value) {
-          math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, total_seqlen, head_size, alpha, q,
-                                          static_cast<int>(head_size), k, static_cast<int>(head_size), 0.0f /*bata*/,
-                                          output, static_cast<int>(present_buffer_sequence_length), nullptr);
+          if (paged_kv_cache.IsEnabled()) {
+            // one gemm per block, writing the columns of the tokens in the block
+            const size_t block_size = paged_kv_cache.block_size;
+            for (size_t block_start = 0; block_start < total_seqlen; block_start += block_size) {
+              const size_t block_tokens = std::min(block_size, total_seqlen - block_start);
+              const T* k_block = present_key + paged_kv_cache.BlockOffset(batch_index, kv_head_index,
+                                                                           block_start / block_size, head_size);
+              math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, block_tokens, head_size,
+                                              alpha, q, static_cast<int>(head_size), k_block,
+                                              static_cast<int>(head_size), 0.0f /*bata*/, output + block_start,
+                                              static_cast<int>(present_buffer_sequence_length), nullptr);
+            }
+          } else {
+            math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, total_seqlen, head_size, alpha,
+                                            q, static_cast<int>(head_size), k, static_cast<int>(head_size),
+                                            0.0f /*bata*/, output, static_cast<int>(present_buffer_sequence_length),
+                                            nullptr);
+          }
         } else {
           size_t bytes = head_size * (sequence_length + total_seqlen) * sizeof(float);
           auto q_k_fp32 = allocator->Alloc(bytes);
@@ -207,7 +648,18 @@ class GQAAttentionBase {
           MlasConvertHalfToFloatBuffer(q, q_fp32, head_size * sequence_length);
 
           float* k_fp32 = q_fp32 + head_size * sequence_length;
-          MlasConvertHalfToFloatBuffer(k, k_fp32, head_size * total_seqlen);
+          if (paged_kv_cache.IsEnabled()) {
+            // gather the blocks while converting them
+            const size_t block_size = paged_kv_cache.block_size;
+            for (size_t block_start = 0; block_start < total_seqlen; block_start += block_size) {
+              const size_t block_tokens = std::min(block_size, total_seqlen - block_start);
+              const T* k_block = present_key + paged_kv_cache.BlockOffset(batch_index, kv_head_index,
+                                                                           block_start / block_size, head_size);
+              MlasConvertHalfToFloatBuffer(k_block, k_fp32 + block_start * head_size, head_size * block_tokens);
+            }
+          } else {
+            MlasConvertHalfToFloatBuffer(k, k_fp32, head_size * total_seqlen);
+          }
 
           math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, total_seqlen, head_size, alpha, q_fp32,
                                           static_cast<int>(head_size), k_fp32, static_cast<int>(head_size), 0.0f /*bata*/,
@@ -215,44 +667,58 @@ class GQAAttentionBase {
         }
 
         // compute Softmax
-        float* output_softmax = output;
-        for (size_t seq = 0; seq < sequence_length; seq++) {
-          size_t seq_causal_length = past_seqlen + seq + 1;
-          if (local_window_size_ > 0 && seq_causal_length > static_cast<size_t>(local_window_size_) + 1) {
-            for (size_t total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
-              output_softmax[total_seq_id] = 0.f;
-            }
-            if (softcap_ > 0.f) {
-              ComputeAttentionSoftcapInplace(output_softmax + seq_causal_length - local_window_size_ - 1,
-                                             local_window_size_ + 1, softcap_);
-            }
-            if (use_smooth_softmax_) {
-              ComputeSmoothSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
-                                          local_window_size_ + 1, nullptr);
-            } else {
-              ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
-                                             local_window_size_ + 1, nullptr);
-            }
-          } else {
-            if (softcap_ > 0.f) {
-              ComputeAttentionSoftcapInplace(output_softmax, static_cast<int>(seq_causal_length), softcap_);
-            }
-            if (use_smooth_softmax_) {
-              ComputeSmoothSoftmaxInplace(output_softmax, 1, static_cast<int>(seq_causal_length), nullptr);
-            } else {
-              ComputeAttentionSoftmaxInplace(output_softmax, 1, static_cast<int>(seq_causal_length), nullptr);
-            }
-          }
+        ComputeCausalSoftmaxInplace(output, sequence_length, past_seqlen, total_seqlen,
+                                    present_buffer_sequence_length);
+      }
+    });
+  }
 
-          // set causal [seq_causal_length, total_seqlen) to 0.f
-          for (size_t total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
-            output_softmax[total_seq_id] = 0.f;
-          }
+  // Applies the softcap, the local window and the causal mask to the S x total_seqlen scores of a head, with rows
+  // `ld` apart, and computes their softmax in place.
+  void ComputeCausalSoftmaxInplace(float* output_softmax, size_t sequence_length, size_t past_seqlen,
+                                   size_t total_seqlen, size_t ld) const {
+    if (softcap_ == 0.f && !use_smooth_softmax_ && local_window_size_ <= 0) {
+      // Plain causal softmax: MLAS skips the masked tail of each row and zeroes it in the same pass.
+      MlasComputeAttentionSoftmax(output_softmax, ld, nullptr, 0, sequence_length, total_seqlen, 1.0f,
+                                  static_cast<ptrdiff_t>(past_seqlen), nullptr);
+      return;
+    }
 
-          output_softmax += present_buffer_sequence_length;
+    for (size_t seq = 0; seq < sequence_length; seq++) {
+      size_t seq_causal_length = past_seqlen + seq + 1;
+      if (local_window_size_ > 0 && seq_causal_length > static_cast<size_t>(local_window_size_) + 1) {
+        for (size_t total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
+          output_softmax[total_seq_id] = 0.f;
+        }
+        if (softcap_ > 0.f) {
+          ComputeAttentionSoftcapInplace(output_softmax + seq_causal_length - local_window_size_ - 1,
+                                         local_window_size_ + 1, softcap_);
+        }
+        if (use_smooth_softmax_) {
+          ComputeSmoothSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
+                                      local_window_size_ + 1, nullptr);
+        } else {
+          ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
+                                         local_window_size_ + 1, nullptr);
+        }
+      } else {
+        if (softcap_ > 0.f) {
+          ComputeAttentionSoftcapInplace(output_softmax, static_cast<int>(seq_causal_length), softcap_);
+        }
+        if (use_smooth_softmax_) {
+          ComputeSmoothSoftmaxInplace(output_softmax, 1, static_cast<int>(seq_causal_length), nullptr);
+        } else {
+          ComputeAttentionSoftmaxInplace(output_softmax, 1, static_cast<int>(seq_causal_length), nullptr);
         }
       }
-    });
+
+      // set causal [seq_causal_length, total_seqlen) to 0.f
+      for (size_t total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
+        output_softmax[total_seq_id] = 0.f;
+      }
+
+      output_softmax += ld;
+    }
   }
 
   template <typename T>
@@ -271,6 +737,7 @@ class GQAAttentionBase {
                                const bool past_present_share_buffer,         // whether present key and value share the same buffer
                                const bool packed_qkv,                        // whether Q, K, V are packed
                                const bool is_prompt,                         // whether it is prompt
+                               const PagedKVCache& paged_kv_cache,           // block table if present value is paged
                                ThreadPool* tp,
                                AllocatorPtr allocator) const {
     const ptrdiff_t packed_batch_stride =
@@ -281,7 +748,7 @@ class GQAAttentionBase {
     const size_t past_buff_chunk_length = past_buffer_sequence_length * head_size;        // L x H
     const size_t present_buff_chunk_length = present_buffer_sequence_length * head_size;  // T x H
 
-    if (!past_present_share_buffer) {
+    if (!past_present_share_buffer && !paged_kv_cache.IsEnabled()) {
       memset((void*)present_value,
              0,
              batch_size * kv_num_heads_ * present_buffer_sequence_length * head_size * sizeof(T));
@@ -329,7 +796,9 @@ class GQAAttentionBase {
         } else {
           v = V + kv_input_chunk_length * (i / kv_num_heads_factor);
         }
-        if (nullptr != present_value) {
+        if (paged_kv_cache.IsEnabled()) {
+          // the new tokens have already been written to the blocks, v is read block by block below
+        } else if (nullptr != present_value) {
           v = ConcatStateChunkGQA(past_value, v, present_value, present_buff_chunk_length, past_buff_chunk_length,
                                   past_chunk_length, kv_input_chunk_length, past_present_share_buffer,
                                   i / kv_num_heads_factor);
@@ -337,20 +806,46 @@ class GQAAttentionBase {
 
         ptrdiff_t attention_probs_offset = SafeInt<ptrdiff_t>(sequence_length) * present_buffer_sequence_length * i;
 
+        const size_t kv_head_index = head_index / kv_num_heads_factor;
         if constexpr (std::is_same<T, float>::value) {
           T* output_current = output + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
-          math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, total_seqlen,
-                                          1.f, /*alpha*/ attention_probs + attention_probs_offset,
-                                          static_cast<int>(present_buffer_sequence_length), v,
-                                          static_cast<int>(head_size), 0.0f /*beta*/, output_current,
-                                          static_cast<int>(hidden_size), nullptr);
+          if (paged_kv_cache.IsEnabled()) {
+            // accumulate the product of each block
+            const size_t block_size = paged_kv_cache.block_size;
+            for (size_t block_start = 0; block_start < total_seqlen; block_start += block_size) {
+              const size_t block_tokens = std::min(block_size, total_seqlen - block_start);
+              const T* v_block = present_value + paged_kv_cache.BlockOffset(batch_index, kv_head_index,
+                                                                             block_start / block_size, head_size);
+              math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, block_tokens,
+                                              1.f, /*alpha*/ attention_probs + attention_probs_offset + block_start,
+                                              static_cast<int>(present_buffer_sequence_length), v_block,
+                                              static_cast<int>(head_size), block_start == 0 ? 0.0f : 1.0f /*beta*/,
+                                              output_current, static_cast<int>(hidden_size), nullptr);
+            }
+          } else {
+            math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, total_seqlen,
+                                            1.f, /*alpha*/ attention_probs + attention_probs_offset,
+                                            static_cast<int>(present_buffer_sequence_length), v,
+                                            static_cast<int>(head_size), 0.0f /*beta*/, output_current,
+                                            static_cast<int>(hidden_size), nullptr);
+          }
         } else {
           size_t bytes = head_size * total_seqlen * sizeof(float);
           auto v_fp32 = allocator->Alloc(bytes);
           BufferUniquePtr scratch_buffer(v_fp32, BufferDeleter(allocator));
 
           float* v_fp32_ptr = static_cast<float*>(v_fp32);
-          MlasConvertHalfToFloatBuffer(v, v_fp32_ptr, head_size * total_seqlen);
+          if (paged_kv_cache.IsEnabled()) {
+            const size_t block_size = paged_kv_cache.block_size;
+            for (size_t block_start = 0; block_start < total_seqlen; block_start += block_size) {
+              const size_t block_tokens = std::min(block_size, total_seqlen - block_start);
+              const T* v_block = present_value + paged_kv_cache.BlockOffset(batch_index, kv_head_index,
+                                                                             block_start / block_size, head_size);
+              MlasConvertHalfToFloatBuffer(v_block, v_fp32_ptr + block_start * head_size, head_size * block_tokens);
+            }
+          } else {
+            MlasConvertHalfToFloatBuffer(v, v_fp32_ptr, head_size * total_seqlen);
+          }
 
           float* output_fp32_current = static_cast<float*>(output_fp32) +
                                        (batch_index * sequence_length * num_heads_ + head_index) * head_size;
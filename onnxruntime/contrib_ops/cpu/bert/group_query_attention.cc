@@ -22,16 +22,17 @@ namespace onnxruntime {
 namespace contrib {
 
 // These ops are internal-only, so register outside of onnx
-#define REGISTER_KERNEL_TYPED(T)                                        \
-  ONNX_OPERATOR_TYPED_KERNEL_EX(                                        \
-      GroupQueryAttention,                                              \
-      kMSDomain,                                                        \
-      1,                                                                \
-      T,                                                                \
-      kCpuExecutionProvider,                                            \
-      KernelDefBuilder()                                                \
-          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())        \
-          .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()), \
+#define REGISTER_KERNEL_TYPED(T)                                                                                \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                                                \
+      GroupQueryAttention,                                                                                      \
+      kMSDomain,                                                                                                \
+      1,                                                                                                        \
+      T,                                                                                                        \
+      kCpuExecutionProvider,                                                                                    \
+      KernelDefBuilder()                                                                                        \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())                                                \
+          .TypeConstraint("T_CACHE", {DataTypeImpl::GetTensorType<T>(), DataTypeImpl::GetTensorType<int8_t>()}) \
+          .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),                                         \
       GroupQueryAttention<T>);
 
 REGISTER_KERNEL_TYPED(float)
@@ -52,6 +53,9 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   const Tensor* total_seqlen_tensor = context->Input<Tensor>(6);
   const Tensor* cos_cache = context->Input<Tensor>(7);
   const Tensor* sin_cache = context->Input<Tensor>(8);
+  const Tensor* block_table = context->Input<Tensor>(9);
+  const Tensor* k_scale = context->Input<Tensor>(10);
+  const Tensor* v_scale = context->Input<Tensor>(11);
 
   GroupQueryAttentionParameters parameters = {};
   ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckInputs(query,
@@ -67,7 +71,11 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
                                                                 seqlens_k,
                                                                 total_seqlen_tensor,
                                                                 scale_,
-                                                                softcap_));
+                                                                softcap_,
+                                                                block_table));
+  ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckKVCacheScales(k_scale, v_scale, past_key, past_value,
+                                                                       kv_num_heads_, parameters.is_paged_kv_cache));
+  const bool quantized_kv_cache = k_scale != nullptr;
 
   const int batch_size = parameters.batch_size;
   const int sequence_length = parameters.sequence_length;
@@ -84,8 +92,24 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
 
   std::vector<int64_t> present_k_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
   std::vector<int64_t> present_v_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
+  if (parameters.is_paged_kv_cache) {
+    // present is the updated block pool
+    const auto past_dims = past_key->Shape().GetDims();
+    present_k_shape.assign(past_dims.begin(), past_dims.end());
+    present_v_shape = present_k_shape;
+  }
   Tensor* present_k = context->Output(1, present_k_shape);
   Tensor* present_v = context->Output(2, present_v_shape);
+  if (parameters.is_paged_kv_cache && (present_k == nullptr || present_v == nullptr)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Output 'present_key' and 'present_value' are required when 'block_table' is given.");
+  }
+  if (quantized_kv_cache && (present_k == nullptr || present_v == nullptr || !present_k->IsDataType<int8_t>() ||
+                             !present_v->IsDataType<int8_t>())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Output 'present_key' and 'present_value' are required and shall be int8 when 'k_scale' "
+                           "and 'v_scale' are given.");
+  }
 
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
@@ -192,10 +216,17 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   }
 
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  if (quantized_kv_cache) {
+    return ApplyAttentionWithInt8KVCache(q_rotary, packed_qkv ? nullptr : k_rotary,
+                                         packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, output,
+                                         present_k, present_v, seqlens_k, k_scale, v_scale, parameters, allocator,
+                                         context);
+  }
+
   // Compute the attention score and apply the score to V
   return ApplyAttention(q_rotary, packed_qkv ? nullptr : k_rotary, packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(),
                         past_key, past_value, output, present_k, present_v,
-                        seqlens_k, parameters, allocator, context);
+                        seqlens_k, block_table, parameters, allocator, context);
 }
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -25,10 +25,14 @@ Status CheckInputs(const T* query,
                    const T* seqlens_k,
                    const T* total_seqlen,
                    float scale,
-                   float softcap) {
+                   float softcap,
+                   const T* block_table = nullptr) {
   // Note: Here S* is seqlen_past_kv_cache, S+ is seqlen_present_kv_cache
   //     past_key                   : (B, N_k, S*, H) or (B, N_k, S+, H) or nullptr
   //     past_value                 : (B, N_k, S*, H) or (B, N_k, S+, H) or nullptr
+  // paged kv cache (block table of shape (B, max_blocks_per_sequence)), where S' is the block size:
+  //     past_key                   : (num_blocks, N_k, S', H)
+  //     past_value                 : (num_blocks, N_k, S', H)
   // no packing for q/k/v:
   //     query            (Q)       : (B, S, D) or (B, S, (D_q + 2 D_kv))
   //     key              (K)       : (B, S, D_kv) or nullptr
@@ -111,7 +115,41 @@ Status CheckInputs(const T* query,
 
   // Check past-present KV
   int32_t past_sequence_length = 0;
-  if (past_key != nullptr && past_value != nullptr) {
+  int kv_cache_block_size = 0;
+  int num_kv_cache_blocks = 0;
+  int max_blocks_per_sequence = 0;
+  if (block_table != nullptr) {
+    if (past_key == nullptr || past_value == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'past_key' and 'past_value' are required when 'block_table' is given.");
+    }
+    const auto& block_table_dims = block_table->Shape().GetDims();
+    if (block_table_dims.size() != 2 || block_table_dims[0] != batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'block_table' is expected to have shape (batch_size, max_blocks_per_sequence).");
+    }
+    const auto& past_key_dims = past_key->Shape().GetDims();
+    const auto& past_value_dims = past_value->Shape().GetDims();
+    if (past_key_dims.size() != 4 || past_key->Shape() != past_value->Shape()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'past_key' and 'past_value' are expected to have the same shape "
+                             "(num_blocks, kv_num_heads, block_size, head_size) when 'block_table' is given.");
+    }
+    if (past_key_dims[1] != kv_num_heads || past_key_dims[3] != head_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'past_key' shall have kv_num_heads heads of head_size, got ",
+                             past_key->Shape());
+    }
+    if (past_key_dims[0] <= 0 || past_key_dims[2] <= 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "The paged kv cache shall have at least one block of at least one token.");
+    }
+    num_kv_cache_blocks = static_cast<int>(past_key_dims[0]);
+    kv_cache_block_size = static_cast<int>(past_key_dims[2]);
+    max_blocks_per_sequence = static_cast<int>(block_table_dims[1]);
+    // the logical cache of every sequence is addressed as if it was a buffer of this length
+    past_sequence_length = max_blocks_per_sequence * kv_cache_block_size;
+  } else if (past_key != nullptr && past_value != nullptr) {
     const auto& past_key_dims = past_key->Shape().GetDims();
     const auto& past_value_dims = past_value->Shape().GetDims();
 
@@ -182,6 +220,11 @@ Status CheckInputs(const T* query,
   }
   int total_sequence_length = *((*total_seqlen).template Data<int32_t>());
   int present_sequence_length = std::max(total_sequence_length, past_sequence_length);
+  if (block_table != nullptr && total_sequence_length > past_sequence_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "total_sequence_length ", total_sequence_length,
+                           " exceeds the capacity of the block table, which is ", past_sequence_length, " tokens.");
+  }
 
   int rotary_dim = 0;
   if (cos_cache != nullptr && sin_cache != nullptr) {
@@ -261,6 +304,10 @@ Status CheckInputs(const T* query,
     output_parameters->softcap = softcap;
     output_parameters->qkv_format = qkv_format;
     output_parameters->past_kv_format = past_kv_format;
+    output_parameters->is_paged_kv_cache = block_table != nullptr;
+    output_parameters->kv_cache_block_size = kv_cache_block_size;
+    output_parameters->num_kv_cache_blocks = num_kv_cache_blocks;
+    output_parameters->max_blocks_per_sequence = max_blocks_per_sequence;
   }
 
   return Status::OK();
@@ -288,6 +335,56 @@ Status CheckInputs(const T* query,
 
   return CheckInputs(query, key, value, past_key, past_value, cos_cache, sin_cache, parameters, num_heads, kv_num_heads, seqlens_k, total_seqlen, scale, softcap);
 }
+
+// Checks the scales of a quantized kv cache. With the scales, past key and value shall hold int8 values.
+template <typename T = Tensor>
+Status CheckKVCacheScales(const T* k_scale,
+                          const T* v_scale,
+                          const T* past_key,
+                          const T* past_value,
+                          int kv_num_heads,
+                          bool is_paged_kv_cache) {
+  if ((k_scale == nullptr) != (v_scale == nullptr)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'k_scale' and 'v_scale' shall be both present or both absent.");
+  }
+
+  const bool past_is_int8 = (past_key != nullptr && past_key->IsDataType<int8_t>()) ||
+                            (past_value != nullptr && past_value->IsDataType<int8_t>());
+  if (k_scale == nullptr) {
+    if (past_is_int8) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'k_scale' and 'v_scale' are required when 'past_key' and 'past_value' are int8.");
+    }
+    return Status::OK();
+  }
+
+  if (is_paged_kv_cache) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "A quantized kv cache is not supported with 'block_table'.");
+  }
+
+  if (past_key != nullptr && (!past_key->IsDataType<int8_t>() || !past_value->IsDataType<int8_t>())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' and 'past_value' shall be int8 when 'k_scale' and 'v_scale' are given.");
+  }
+
+  for (const T* kv_scale : {k_scale, v_scale}) {
+    const int64_t num_scales = kv_scale->Shape().Size();
+    if (kv_scale->Shape().NumDimensions() != 1 || (num_scales != 1 && num_scales != kv_num_heads)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'k_scale' and 'v_scale' are expected to have shape (1) or (kv_num_heads), got ",
+                             kv_scale->Shape());
+    }
+    for (const float s : kv_scale->template DataAsSpan<float>()) {
+      if (!(s > 0.0f)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The kv cache scales shall be positive, got ", s);
+      }
+    }
+  }
+
+  return Status::OK();
+}
 }  // namespace group_query_attention_helper
 }  // namespace contrib
 }  // namespace onnxruntime
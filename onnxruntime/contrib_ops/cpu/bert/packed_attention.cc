@@ -0,0 +1,218 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/bert/packed_attention.h"
+
+#include <algorithm>
+
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "contrib_ops/cpu/bert/multihead_attention_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    PackedAttention, kMSDomain, 1, float, kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    PackedAttention);
+
+PackedAttention::PackedAttention(const OpKernelInfo& info) : OpKernel(info), PackedAttentionCPUBase(info) {
+  if (!info.GetAttrs<int64_t>("qkv_hidden_sizes", qkv_hidden_sizes_).IsOK()) {
+    qkv_hidden_sizes_.clear();
+  }
+}
+
+Status PackedAttention::CheckInputs(const TensorShape& input_shape,
+                                    const TensorShape& weights_shape,
+                                    const TensorShape& bias_shape,
+                                    const TensorShape& token_offset_shape,
+                                    const TensorShape& cu_seq_len_shape,
+                                    const Tensor* attention_bias,
+                                    PackedAttentionParameters& parameters) const {
+  // Abbreviation and Meanings:
+  //   T:    token_count
+  //   B:    batch_size
+  //   S:    sequence_length
+  //   N:    num_heads
+  //   H:    head size for Q and K
+  //   H_v:  v_head_size
+  //   D_i:  input hidden size
+  //   D:    hidden size for Q and K (D = N * H)
+  //   D_v:  v_hidden_size = num_heads * v_head_size
+
+  // Input shapes:
+  //   input:                  : (T, D_i)
+  //   weights      (Q/K/V)    : (D_i, D + D + D_v)
+  //   bias         (Q/K/V)    : (D + D + D_v)
+  //   token_offset            : (B, S)
+  //   cu_seq_len_shape        : (B + 1)
+  //   attention_bias          : (B or 1, N or 1, S, S) or NULL
+  const auto& input_dims = input_shape.GetDims();
+  if (input_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'input' is expected to have 2 dimensions in packing mode, got ",
+                           input_dims.size());
+  }
+  int64_t token_count = input_dims[0];
+  int64_t input_hidden_size = input_dims[1];
+
+  const auto& token_offset_dims = token_offset_shape.GetDims();
+  if (token_offset_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'packing_token_offset' is expected to have 2 dimensions in packing mode, got ",
+                           token_offset_dims.size());
+  }
+
+  int64_t batch_size = token_offset_dims[0];
+  int64_t sequence_length = token_offset_dims[1];
+
+  const auto& bias_dims = bias_shape.GetDims();
+  if (bias_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'bias' is expected to have 1 dimension, got ",
+                           bias_dims.size());
+  }
+
+  const auto& weights_dims = weights_shape.GetDims();
+  if (weights_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'weights' is expected to have 2 dimensions, got ",
+                           weights_dims.size());
+  }
+  if (weights_dims[0] != input_hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 1 dimension 0 should have same length as dimension 2 of input 0");
+  }
+
+  if (bias_dims[0] != weights_dims[1]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'bias' dimension 0 should have same length as dimension 1 of input 'weights'");
+  }
+
+  const auto& cu_seq_len_dims = cu_seq_len_shape.GetDims();
+  if (cu_seq_len_dims.size() != 1 || cu_seq_len_dims[0] != batch_size + 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'cumulative_sequence_length' should have 1 dimension with size equal to batch_size + 1");
+  }
+
+  const int num_heads = GetNumHeads();
+  int64_t q_hidden_size = bias_dims[0] / static_cast<int64_t>(3);
+  int64_t k_hidden_size = q_hidden_size;
+  int64_t v_hidden_size = k_hidden_size;
+  if (qkv_hidden_sizes_.size() != 0) {
+    if (qkv_hidden_sizes_.size() != 3) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "qkv_hidden_sizes attribute should have 3 elements");
+    }
+
+    q_hidden_size = qkv_hidden_sizes_[0];
+    k_hidden_size = qkv_hidden_sizes_[1];
+    v_hidden_size = qkv_hidden_sizes_[2];
+  }
+
+  if (q_hidden_size % num_heads != 0 || k_hidden_size % num_heads != 0 || v_hidden_size % num_heads != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "hidden_size should be divisible by num_heads: ", num_heads);
+  }
+
+  if (q_hidden_size != k_hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "qkv_hidden_sizes first element should be same as the second");
+  }
+
+  if (bias_dims[0] != q_hidden_size + k_hidden_size + v_hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'bias' dimension 0 should have same length as sum of Q/K/V hidden sizes:",
+                           " q_hidden_size=", q_hidden_size, " k_hidden_size=", k_hidden_size, " v_hidden_size=",
+                           v_hidden_size, "bias_dims[0]=", bias_dims[0]);
+  }
+
+  gsl::span<const int64_t> attention_bias_dims;
+  if (attention_bias != nullptr) {
+    attention_bias_dims = attention_bias->Shape().GetDims();
+    ORT_RETURN_IF_ERROR(multihead_attention_helper::CheckAttentionBias(
+        attention_bias_dims, batch_size, num_heads, sequence_length, sequence_length));
+  }
+  parameters.broadcast_attn_bias_dim_0 = attention_bias_dims.size() > 0 && attention_bias_dims[0] == 1;
+  parameters.broadcast_attn_bias_dim_1 = attention_bias_dims.size() > 1 && attention_bias_dims[1] == 1;
+
+  parameters.batch_size = narrow<int>(batch_size);
+  parameters.sequence_length = narrow<int>(sequence_length);
+  parameters.input_hidden_size = narrow<int>(input_hidden_size);
+  parameters.hidden_size = narrow<int>(q_hidden_size);
+  parameters.v_hidden_size = narrow<int>(v_hidden_size);
+  parameters.head_size = static_cast<int>(q_hidden_size) / num_heads;
+  parameters.v_head_size = static_cast<int>(v_hidden_size) / num_heads;
+  parameters.num_heads = num_heads;
+  parameters.scale = GetScale();
+  parameters.token_count = narrow<int32_t>(token_count);
+  parameters.use_tf32 = false;
+
+  return Status::OK();
+}
+
+Status PackedAttention::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weights = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* token_offset = context->Input<Tensor>(3);
+  const Tensor* cumulative_sequence_length = context->Input<Tensor>(4);
+  const Tensor* attention_bias = context->Input<Tensor>(5);
+
+  PackedAttentionParameters parameters;
+  ORT_RETURN_IF_ERROR(CheckInputs(input->Shape(),
+                                  weights->Shape(),
+                                  bias->Shape(),
+                                  token_offset->Shape(),
+                                  cumulative_sequence_length->Shape(),
+                                  attention_bias,
+                                  parameters));
+
+  const int32_t* cu_seq_len_data = cumulative_sequence_length->Data<int32_t>();
+  ORT_RETURN_IF_ERROR(CheckCumulativeSequenceLength(cu_seq_len_data, parameters));
+
+  TensorShapeVector output_shape{parameters.token_count, parameters.v_hidden_size};
+  Tensor* output = context->Output(0, output_shape);
+  if (parameters.token_count == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  auto* tp = context->GetOperatorThreadPool();
+
+  const size_t token_count = static_cast<size_t>(parameters.token_count);
+  const size_t input_hidden_size = static_cast<size_t>(parameters.input_hidden_size);
+  const size_t hidden_size = static_cast<size_t>(parameters.hidden_size);
+  const size_t v_hidden_size = static_cast<size_t>(parameters.v_hidden_size);
+  const size_t weights_row_size = hidden_size * 2 + v_hidden_size;
+
+  // Project the input to Q, K and V, each of them (token_count, num_heads, head_size) as ApplyAttention expects.
+  // The columns of the merged weights are multiplied separately so that no transpose is needed.
+  auto qkv_buffer = IAllocator::MakeUniquePtr<float>(allocator, token_count * weights_row_size);
+  float* q = qkv_buffer.get();
+  float* k = q + token_count * hidden_size;
+  float* v = k + token_count * hidden_size;
+
+  const float* input_data = input->Data<float>();
+  const float* weights_data = weights->Data<float>();
+  const float* bias_data = bias->Data<float>();
+
+  auto project = [&](float* result, size_t column_offset, size_t columns) {
+    for (size_t t = 0; t < token_count; t++) {
+      std::copy_n(bias_data + column_offset, columns, result + t * columns);
+    }
+    MlasGemm(CblasNoTrans, CblasNoTrans, token_count, columns, input_hidden_size, 1.0f,
+             input_data, input_hidden_size,
+             weights_data + column_offset, weights_row_size,
+             1.0f, result, columns, tp);
+  };
+  project(q, 0, hidden_size);
+  project(k, hidden_size, hidden_size);
+  project(v, hidden_size * 2, v_hidden_size);
+
+  return ApplyAttention(q, k, v, cu_seq_len_data, attention_bias, parameters, output->MutableData<float>(), context);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "contrib_ops/cpu/bert/packed_attention_cpu_base.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class PackedAttention final : public OpKernel, public PackedAttentionCPUBase {
+ public:
+  PackedAttention(const OpKernelInfo& info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  Status CheckInputs(const TensorShape& input_shape,
+                     const TensorShape& weights_shape,
+                     const TensorShape& bias_shape,
+                     const TensorShape& token_offset_shape,
+                     const TensorShape& cu_seq_len_shape,
+                     const Tensor* attention_bias,
+                     PackedAttentionParameters& parameters) const;
+
+  std::vector<int64_t> qkv_hidden_sizes_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,180 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/bert/packed_attention_cpu_base.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
+#include "core/platform/env_var_utils.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+PackedAttentionCPUBase::PackedAttentionCPUBase(const OpKernelInfo& info) {
+  int64_t num_heads = 0;
+  ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+  num_heads_ = static_cast<int>(num_heads);
+
+  scale_ = info.GetAttrOrDefault<float>("scale", 0.0f);
+
+  l2_cache_size_ = Env::Default().GetL2CacheSize();
+  disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
+}
+
+Status PackedAttentionCPUBase::CheckCumulativeSequenceLength(const int32_t* cumulative_sequence_length,
+                                                             const PackedAttentionParameters& parameters) const {
+  if (cumulative_sequence_length[0] != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'cumulative_sequence_length' is expected to start with 0, got ",
+                           cumulative_sequence_length[0]);
+  }
+
+  for (int b = 0; b < parameters.batch_size; b++) {
+    const int32_t length = cumulative_sequence_length[b + 1] - cumulative_sequence_length[b];
+    if (length < 0 || length > parameters.sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'cumulative_sequence_length' has a sequence of ", length,
+                             " tokens at batch ", b, ", which is out of range [0, ", parameters.sequence_length, "]");
+    }
+  }
+
+  if (cumulative_sequence_length[parameters.batch_size] != parameters.token_count) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'cumulative_sequence_length' is expected to end with the token count ",
+                           parameters.token_count, ", got ", cumulative_sequence_length[parameters.batch_size]);
+  }
+
+  return Status::OK();
+}
+
+Status PackedAttentionCPUBase::ApplyAttention(const float* query,
+                                              const float* key,
+                                              const float* value,
+                                              const int32_t* cumulative_sequence_length,
+                                              const Tensor* attention_bias,
+                                              const PackedAttentionParameters& parameters,
+                                              float* output,
+                                              OpKernelContext* context) const {
+  const int batch_size = parameters.batch_size;
+  const int num_heads = parameters.num_heads;
+  const int qk_head_size = parameters.head_size;
+  const int v_head_size = parameters.v_head_size;
+  const float scale = parameters.scale == 0.0f ? 1.0f / std::sqrt(static_cast<float>(qk_head_size))
+                                               : parameters.scale;
+
+  int max_sequence_length = 0;
+  for (int b = 0; b < batch_size; b++) {
+    max_sequence_length = std::max(max_sequence_length,
+                                   cumulative_sequence_length[b + 1] - cumulative_sequence_length[b]);
+  }
+  if (max_sequence_length == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  auto* tp = context->GetOperatorThreadPool();
+
+  if (!disable_flash_ && attention_bias == nullptr && l2_cache_size_ > 0) {
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads;
+    args.q_sequence_length = max_sequence_length;
+    args.kv_sequence_length = max_sequence_length;
+    args.qk_head_size = qk_head_size;
+    args.v_head_size = v_head_size;
+    args.scale = scale;
+
+    // The block sizes are chosen like MultiHeadAttention, so that the blocks of Q, K, V, the scores and the
+    // temporary output fit in 3/4 of the L2 cache.
+    args.kv_block_size = l2_cache_size_ / (static_cast<int>(sizeof(float)) * 4 * (qk_head_size + v_head_size));
+    args.kv_block_size = std::max(args.kv_block_size, 1);
+    args.q_block_size = std::min(args.kv_block_size, qk_head_size + v_head_size);
+    args.kv_block_size = std::min(args.kv_block_size, max_sequence_length);
+    args.q_block_size = std::min(args.q_block_size, max_sequence_length);
+
+    args.thread_count = concurrency::ThreadPool::DegreeOfParallelism(tp);
+    args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.v_head_size)) *
+                                  sizeof(float);
+    size_t buffer_bytes = args.buffer_size_per_thread * args.thread_count;
+    IAllocatorUniquePtr<void> buffer = IAllocator::MakeUniquePtr<void>(allocator, buffer_bytes);
+    args.buffer = reinterpret_cast<float*>(buffer.get());
+
+    args.query = query;
+    args.key = key;
+    args.value = value;
+    args.output = output;
+    args.cumulative_sequence_lengths = cumulative_sequence_length;
+
+    MlasFlashAttention(&args, tp);
+    return Status::OK();
+  }
+
+  // Unfused path, used for the attention bias: the scores of one head of one sequence are computed at once.
+  // The rows of a head are strided in the token major Q, K, V and output, which the GEMMs read and write in place.
+  const size_t qk_row_stride = static_cast<size_t>(num_heads) * static_cast<size_t>(qk_head_size);
+  const size_t v_row_stride = static_cast<size_t>(num_heads) * static_cast<size_t>(v_head_size);
+
+  const float* attention_bias_data = attention_bias != nullptr ? attention_bias->Data<float>() : nullptr;
+  const size_t bias_matrix_size = static_cast<size_t>(parameters.sequence_length) *
+                                  static_cast<size_t>(parameters.sequence_length);
+  const size_t bias_head_stride = parameters.broadcast_attn_bias_dim_1 ? 0 : bias_matrix_size;
+  const size_t bias_batch_stride = parameters.broadcast_attn_bias_dim_0
+                                       ? 0
+                                       : (parameters.broadcast_attn_bias_dim_1 ? 1 : static_cast<size_t>(num_heads)) *
+                                             bias_matrix_size;
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      tp, static_cast<std::ptrdiff_t>(batch_size) * num_heads,
+      [&](std::ptrdiff_t task) {
+        const std::ptrdiff_t b = task / num_heads;
+        const size_t n = static_cast<size_t>(task % num_heads);
+        const size_t token_start = static_cast<size_t>(cumulative_sequence_length[b]);
+        const size_t length = static_cast<size_t>(cumulative_sequence_length[b + 1]) - token_start;
+        if (length == 0) {
+          return;
+        }
+
+        const size_t head_row = token_start * static_cast<size_t>(num_heads) + n;
+        const float* q = query + head_row * static_cast<size_t>(qk_head_size);
+        const float* k = key + head_row * static_cast<size_t>(qk_head_size);
+        const float* v = value + head_row * static_cast<size_t>(v_head_size);
+        float* o = output + head_row * static_cast<size_t>(v_head_size);
+
+        auto scores_buffer = IAllocator::MakeUniquePtr<float>(allocator, length * length);
+        float* scores = scores_buffer.get();
+
+        // scores = scale * Q * K'
+        MlasGemm(CblasNoTrans, CblasTrans, length, length, static_cast<size_t>(qk_head_size), scale,
+                 q, qk_row_stride, k, qk_row_stride, 0.0f, scores, length, nullptr);
+
+        if (attention_bias_data != nullptr) {
+          // The tokens of the sequence are its first positions in the padded (S, S) bias.
+          const float* bias = attention_bias_data + static_cast<size_t>(b) * bias_batch_stride + n * bias_head_stride;
+          for (size_t i = 0; i < length; i++) {
+            const float* bias_row = bias + i * static_cast<size_t>(parameters.sequence_length);
+            float* scores_row = scores + i * length;
+            for (size_t j = 0; j < length; j++) {
+              scores_row[j] += bias_row[j];
+            }
+          }
+        }
+
+        MlasComputeSoftmax(scores, scores, length, length, false, false, nullptr);
+
+        // output = softmax(scores) * V
+        MlasGemm(CblasNoTrans, CblasNoTrans, length, static_cast<size_t>(v_head_size), length, 1.0f,
+                 scores, length, v, v_row_stride, 0.0f, o, v_row_stride, nullptr);
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
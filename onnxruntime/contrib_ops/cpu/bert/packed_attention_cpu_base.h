@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "contrib_ops/cpu/bert/attention_common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Attention of packed sequences without padding, shared by the PackedAttention and PackedMultiHeadAttention
+// operators. Sequence b has the tokens [cumulative_sequence_length[b], cumulative_sequence_length[b + 1]) and only
+// attends to its own tokens, so no work is spent on the padding of the shorter sequences.
+class PackedAttentionCPUBase {
+ protected:
+  PackedAttentionCPUBase(const OpKernelInfo& info);
+
+  // Checks that cumulative_sequence_length starts at 0, is non-decreasing with sequences of at most
+  // sequence_length tokens, and ends at token_count.
+  Status CheckCumulativeSequenceLength(const int32_t* cumulative_sequence_length,
+                                       const PackedAttentionParameters& parameters) const;
+
+  // Q and K are (token_count, num_heads, head_size) and V is (token_count, num_heads, v_head_size).
+  // The output is (token_count, num_heads, v_head_size).
+  Status ApplyAttention(const float* query,
+                        const float* key,
+                        const float* value,
+                        const int32_t* cumulative_sequence_length,
+                        const Tensor* attention_bias,  // (B or 1, N or 1, S, S) or nullptr
+                        const PackedAttentionParameters& parameters,
+                        float* output,
+                        OpKernelContext* context) const;
+
+  int GetNumHeads() const { return num_heads_; }
+  float GetScale() const { return scale_; }
+
+  int num_heads_;  // number of attention heads
+  float scale_;    // scale of Q*K', 0 means 1/sqrt(head_size)
+  bool disable_flash_;
+  int l2_cache_size_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,255 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/bert/packed_multihead_attention.h"
+
+#include <cstring>
+
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
+#include "contrib_ops/cpu/bert/multihead_attention_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    PackedMultiHeadAttention, kMSDomain, 1, float, kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    PackedMultiHeadAttention);
+
+PackedMultiHeadAttention::PackedMultiHeadAttention(const OpKernelInfo& info)
+    : OpKernel(info), PackedAttentionCPUBase(info) {
+}
+
+Status PackedMultiHeadAttention::CheckInputs(const TensorShape& query_shape,
+                                             const Tensor* key,
+                                             const Tensor* value,
+                                             const Tensor* bias,
+                                             const TensorShape& token_offset_shape,
+                                             const TensorShape& cu_seq_len_shape,
+                                             const Tensor* attention_bias,
+                                             PackedAttentionParameters& parameters) const {
+  // Shapes of inputs and output:
+  // When Q, K and V are not packed:
+  //   Input 'query':                      (token_count, hidden_size)
+  //   Input 'key':                        (token_count, hidden_size)
+  //   Input 'value':                      (token_count, v_hidden_size)
+  // When Q, K and V are packed:
+  //   Input 'query':                      (token_count, num_heads, 3, head_size)
+  //   Input 'key':                        None
+  //   Input 'value':                      None
+  // Input 'token_offset':                 (batch_size, sequence_length)
+  // Input 'cumulative_sequence_length':   (batch_size + 1)
+  // Input 'attention_bias':               (batch_size or 1, num_heads or 1, sequence_length, sequence_length) or None
+  // Output 'output':                      (token_count, v_hidden_size)
+
+  const int num_heads = GetNumHeads();
+
+  const auto& query_dims = query_shape.GetDims();
+  if (query_dims.size() != 2 && query_dims.size() != 4) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'query' is expected to have 2 or 4 dimensions in packing mode, got ",
+                           query_dims.size());
+  }
+  int64_t token_count = query_dims[0];
+  int64_t hidden_size = (query_dims.size() == 2) ? query_dims[1] : (query_dims[1] * query_dims[3]);
+
+  const auto& token_offset_dims = token_offset_shape.GetDims();
+  if (token_offset_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'token_offset' is expected to have 2 dimensions in packing mode, got ",
+                           token_offset_dims.size());
+  }
+
+  int64_t batch_size = token_offset_dims[0];
+  int64_t sequence_length = token_offset_dims[1];
+
+  int64_t v_hidden_size = hidden_size;
+  if (query_dims.size() == 4) {
+    if (key != nullptr || value != nullptr) {
+      return ORT_MAKE_STATUS(
+          ONNXRUNTIME, INVALID_ARGUMENT,
+          "Input 'key' and 'value' is expected to be empty when 'query' has 4 dimensions in packing mode");
+    }
+    if (query_dims[1] != num_heads || query_dims[2] != 3) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'query' is expected to have shape (token_count, num_heads, 3, head_size) "
+                             "when Q, K and V are packed");
+    }
+  } else {  // query_dims.size() == 2
+    if (key == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'key' is expected when 'query' has 2 dimensions in packing mode");
+    }
+
+    const auto& key_dims = key->Shape().GetDims();
+    if (key_dims.size() != 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'key' is expected to have 2 dimension, got ",
+                             key_dims.size());
+    }
+    if (key_dims != query_dims) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'query' and 'key' is expected to have same shape");
+    }
+
+    if (value == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'value' is expected when 'query' has 2 dimensions in packing mode");
+    }
+    const auto& value_dims = value->Shape().GetDims();
+    if (value_dims.size() != 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'value' is expected to have 2 dimensions, got ",
+                             value_dims.size());
+    }
+    if (value_dims[0] != token_count) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 2 dimension 0 should have same length as dimension 0 of input 0");
+    }
+    v_hidden_size = value_dims[1];
+
+    if (hidden_size % num_heads != 0 || v_hidden_size % num_heads != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "hidden_size and v_hidden_size should be divisible by num_heads: ", num_heads);
+    }
+  }
+
+  if (bias != nullptr) {
+    const auto& bias_dims = bias->Shape().GetDims();
+    if (bias_dims.size() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'bias' is expected to have 1 dimension, got ",
+                             bias_dims.size());
+    }
+
+    if (bias_dims[0] != hidden_size + hidden_size + v_hidden_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'bias' size is expected to be ",
+                             hidden_size + hidden_size + v_hidden_size, ", got ", bias_dims[0]);
+    }
+  }
+
+  const auto& cu_seq_len_dims = cu_seq_len_shape.GetDims();
+  if (cu_seq_len_dims.size() != 1 || cu_seq_len_dims[0] != batch_size + 1) {
+    return ORT_MAKE_STATUS(
+        ONNXRUNTIME, INVALID_ARGUMENT,
+        "Input 'cumulative_sequence_length' should have 1 dimension with size equal to batch_size + 1");
+  }
+
+  gsl::span<const int64_t> attention_bias_dims;
+  if (attention_bias != nullptr) {
+    attention_bias_dims = attention_bias->Shape().GetDims();
+    ORT_RETURN_IF_ERROR(multihead_attention_helper::CheckAttentionBias(
+        attention_bias_dims, batch_size, num_heads, sequence_length, sequence_length));
+  }
+  parameters.broadcast_attn_bias_dim_0 = attention_bias_dims.size() > 0 && attention_bias_dims[0] == 1;
+  parameters.broadcast_attn_bias_dim_1 = attention_bias_dims.size() > 1 && attention_bias_dims[1] == 1;
+
+  parameters.batch_size = narrow<int>(batch_size);
+  parameters.sequence_length = narrow<int>(sequence_length);
+  parameters.input_hidden_size = -1;  // not applicable
+  parameters.hidden_size = narrow<int>(hidden_size);
+  parameters.v_hidden_size = narrow<int>(v_hidden_size);
+  parameters.head_size = static_cast<int>(hidden_size) / num_heads;
+  parameters.v_head_size = static_cast<int>(v_hidden_size) / num_heads;
+  parameters.num_heads = num_heads;
+  parameters.scale = GetScale();
+  parameters.token_count = narrow<int32_t>(token_count);
+  parameters.use_tf32 = false;
+
+  return Status::OK();
+}
+
+Status PackedMultiHeadAttention::Compute(OpKernelContext* context) const {
+  const Tensor* query = context->Input<Tensor>(0);
+  const Tensor* key = context->Input<Tensor>(1);
+  const Tensor* value = context->Input<Tensor>(2);
+  const Tensor* bias = context->Input<Tensor>(3);
+  const Tensor* token_offset = context->Input<Tensor>(4);
+  const Tensor* cumulative_sequence_length = context->Input<Tensor>(5);
+  const Tensor* attention_bias = context->Input<Tensor>(6);
+
+  PackedAttentionParameters parameters;
+  ORT_RETURN_IF_ERROR(CheckInputs(query->Shape(),
+                                  key,
+                                  value,
+                                  bias,
+                                  token_offset->Shape(),
+                                  cumulative_sequence_length->Shape(),
+                                  attention_bias,
+                                  parameters));
+
+  const int32_t* cu_seq_len_data = cumulative_sequence_length->Data<int32_t>();
+  ORT_RETURN_IF_ERROR(CheckCumulativeSequenceLength(cu_seq_len_data, parameters));
+
+  TensorShapeVector output_shape{parameters.token_count, parameters.v_hidden_size};
+  Tensor* output = context->Output(0, output_shape);
+  if (parameters.token_count == 0) {
+    return Status::OK();
+  }
+
+  // Q, K and V are used in place when they are already (token_count, num_heads, head_size). Otherwise the packed
+  // QKV is split, and the bias is added, into a token major buffer.
+  const bool is_packed_qkv = query->Shape().NumDimensions() == 4;
+  const float* q = query->Data<float>();
+  const float* k = is_packed_qkv ? nullptr : key->Data<float>();
+  const float* v = is_packed_qkv ? nullptr : value->Data<float>();
+
+  IAllocatorUniquePtr<float> qkv_buffer;
+  if (is_packed_qkv || bias != nullptr) {
+    AllocatorPtr allocator;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+    const size_t token_count = static_cast<size_t>(parameters.token_count);
+    const size_t hidden_size = static_cast<size_t>(parameters.hidden_size);
+    const size_t v_hidden_size = static_cast<size_t>(parameters.v_hidden_size);
+    const size_t head_size = static_cast<size_t>(parameters.head_size);
+    const size_t num_heads = static_cast<size_t>(parameters.num_heads);
+
+    qkv_buffer = IAllocator::MakeUniquePtr<float>(allocator, token_count * (hidden_size * 2 + v_hidden_size));
+    float* q_out = qkv_buffer.get();
+    float* k_out = q_out + token_count * hidden_size;
+    float* v_out = k_out + token_count * hidden_size;
+
+    const float* bias_data = bias != nullptr ? bias->Data<float>() : nullptr;
+    auto copy_row = [](float* dst, const float* src, const float* row_bias, size_t count) {
+      if (row_bias == nullptr) {
+        memcpy(dst, src, count * sizeof(float));
+      } else {
+        for (size_t i = 0; i < count; i++) {
+          dst[i] = src[i] + row_bias[i];
+        }
+      }
+    };
+
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(token_count),
+        static_cast<double>(hidden_size * 2 + v_hidden_size) * 2.0,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (size_t t = static_cast<size_t>(first); t < static_cast<size_t>(last); t++) {
+            if (is_packed_qkv) {
+              // (num_heads, 3, head_size) per token
+              const float* src = q + t * hidden_size * 3;
+              for (size_t n = 0; n < num_heads; n++) {
+                const size_t offset = n * head_size;
+                copy_row(q_out + t * hidden_size + offset, src + (n * 3) * head_size,
+                         bias_data != nullptr ? bias_data + offset : nullptr, head_size);
+                copy_row(k_out + t * hidden_size + offset, src + (n * 3 + 1) * head_size,
+                         bias_data != nullptr ? bias_data + hidden_size + offset : nullptr, head_size);
+                copy_row(v_out + t * hidden_size + offset, src + (n * 3 + 2) * head_size,
+                         bias_data != nullptr ? bias_data + hidden_size * 2 + offset : nullptr, head_size);
+              }
+            } else {
+              copy_row(q_out + t * hidden_size, q + t * hidden_size, bias_data, hidden_size);
+              copy_row(k_out + t * hidden_size, k + t * hidden_size, bias_data + hidden_size, hidden_size);
+              copy_row(v_out + t * v_hidden_size, v + t * v_hidden_size, bias_data + hidden_size * 2, v_hidden_size);
+            }
+          }
+        });
+
+    q = q_out;
+    k = k_out;
+    v = v_out;
+  }
+
+  return ApplyAttention(q, k, v, cu_seq_len_data, attention_bias, parameters, output->MutableData<float>(), context);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "contrib_ops/cpu/bert/packed_attention_cpu_base.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class PackedMultiHeadAttention final : public OpKernel, public PackedAttentionCPUBase {
+ public:
+  PackedMultiHeadAttention(const OpKernelInfo& info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  Status CheckInputs(const TensorShape& query_shape,
+                     const Tensor* key,
+                     const Tensor* value,
+                     const Tensor* bias,
+                     const TensorShape& token_offset_shape,
+                     const TensorShape& cu_seq_len_shape,
+                     const Tensor* attention_bias,
+                     PackedAttentionParameters& parameters) const;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
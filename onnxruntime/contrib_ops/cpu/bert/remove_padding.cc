@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/bert/remove_padding.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    RemovePadding, kMSDomain, 1, float, kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    RemovePadding);
+
+Status RemovePadding::Compute(OpKernelContext* context) const {
+  // shape of inputs:
+  //   input:                   (batch_size, sequence_length, hidden_size)
+  //   sequence_token_count:    (batch_size)
+  // shape of outputs:
+  //   output:                  (total_tokens, hidden_size)
+  //   token_offset:            (batch_size, sequence_length)
+  //   cumulated_seq_len:       (batch_size + 1)
+  //   max_token_count:         (1)
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* sequence_token_count = context->Input<Tensor>(1);
+
+  const auto& dims = input->Shape().GetDims();
+  if (dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'input' is expected to have 3 dimensions, got ",
+                           dims.size());
+  }
+
+  const int64_t batch_size = dims[0];
+  const int64_t sequence_length = dims[1];
+  const int64_t hidden_size = dims[2];
+
+  if (sequence_token_count->Shape().NumDimensions() != 1 || sequence_token_count->Shape()[0] != batch_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'sequence_token_count' is expected to have shape (batch_size), got ",
+                           sequence_token_count->Shape());
+  }
+
+  Tensor* token_offset = context->Output(1, {batch_size, sequence_length});
+  Tensor* cumulated_seq_len = context->Output(2, {batch_size + 1});
+  Tensor* max_token_count = context->Output(3, {1});
+
+  // The tokens of all the sequences come first in token_offset, followed by the paddings.
+  const int32_t* token_count_data = sequence_token_count->Data<int32_t>();
+  int32_t* token_offset_data = token_offset->MutableData<int32_t>();
+  int32_t* cumulated_seq_len_data = cumulated_seq_len->MutableData<int32_t>();
+  const int32_t seq_len = narrow<int32_t>(sequence_length);
+
+  int32_t total_tokens = 0;
+  int32_t max_tokens = 0;
+  cumulated_seq_len_data[0] = 0;
+  for (int64_t b = 0; b < batch_size; b++) {
+    const int32_t count = token_count_data[b];
+    if (count < 0 || count > seq_len) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'sequence_token_count' has value ", count,
+                             " at batch ", b, ", which is out of range [0, ", seq_len, "]");
+    }
+    const int32_t batch_offset = narrow<int32_t>(b) * seq_len;
+    for (int32_t j = 0; j < count; j++) {
+      token_offset_data[total_tokens + j] = batch_offset + j;
+    }
+    total_tokens += count;
+    max_tokens = std::max(max_tokens, count);
+    cumulated_seq_len_data[b + 1] = total_tokens;
+  }
+
+  int32_t index = total_tokens;
+  for (int64_t b = 0; b < batch_size; b++) {
+    const int32_t batch_offset = narrow<int32_t>(b) * seq_len;
+    for (int32_t j = token_count_data[b]; j < seq_len; j++) {
+      token_offset_data[index++] = batch_offset + j;
+    }
+  }
+
+  max_token_count->MutableData<int32_t>()[0] = max_tokens;
+
+  Tensor* output = context->Output(0, {static_cast<int64_t>(total_tokens), hidden_size});
+  if (total_tokens == 0 || hidden_size == 0) {
+    return Status::OK();
+  }
+
+  const size_t row_size = narrow<size_t>(hidden_size);
+  const float* input_data = input->Data<float>();
+  float* output_data = output->MutableData<float>();
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(total_tokens),
+      static_cast<double>(row_size * sizeof(float)),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; i++) {
+          memcpy(output_data + static_cast<size_t>(i) * row_size,
+                 input_data + static_cast<size_t>(token_offset_data[i]) * row_size,
+                 row_size * sizeof(float));
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/bert/restore_padding.h"
+
+#include <atomic>
+#include <cstring>
+
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    RestorePadding, kMSDomain, 1, float, kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    RestorePadding);
+
+Status RestorePadding::Compute(OpKernelContext* context) const {
+  // shape of inputs:
+  //   input:                (total_tokens, hidden_size)
+  //   token_offset:         (batch_size, sequence_length)
+  // shape of outputs:
+  //   output:               (batch_size, sequence_length, hidden_size)
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* token_offset = context->Input<Tensor>(1);
+
+  const auto& dims = input->Shape().GetDims();
+  if (dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'input' is expected to have 2 dimensions, got ",
+                           dims.size());
+  }
+  const int64_t total_tokens = dims[0];
+  const int64_t hidden_size = dims[1];
+
+  const auto& token_offset_dims = token_offset->Shape().GetDims();
+  if (token_offset_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'token_offset' is expected to have 2 dimensions, got ",
+                           token_offset_dims.size());
+  }
+  const int64_t batch_size = token_offset_dims[0];
+  const int64_t sequence_length = token_offset_dims[1];
+  const int64_t padded_tokens = batch_size * sequence_length;
+  if (total_tokens > padded_tokens) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'input' has ", total_tokens,
+                           " tokens, which is more than batch_size * sequence_length of 'token_offset'");
+  }
+
+  Tensor* output = context->Output(0, {batch_size, sequence_length, hidden_size});
+  if (padded_tokens == 0 || hidden_size == 0) {
+    return Status::OK();
+  }
+
+  // The first total_tokens entries of token_offset are the positions of the tokens and the rest are the paddings,
+  // so every row of the output is written once: either copied from the input or zeroed.
+  const size_t row_size = narrow<size_t>(hidden_size);
+  const float* input_data = input->Data<float>();
+  const int32_t* token_offset_data = token_offset->Data<int32_t>();
+  float* output_data = output->MutableData<float>();
+
+  std::atomic<bool> offset_error{false};
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), narrow<std::ptrdiff_t>(padded_tokens),
+      static_cast<double>(row_size * sizeof(float)),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; i++) {
+          const int32_t offset = token_offset_data[i];
+          if (offset < 0 || offset >= padded_tokens) {
+            offset_error = true;
+            return;
+          }
+          float* output_row = output_data + static_cast<size_t>(offset) * row_size;
+          if (i < total_tokens) {
+            memcpy(output_row, input_data + static_cast<size_t>(i) * row_size, row_size * sizeof(float));
+          } else {
+            memset(output_row, 0, row_size * sizeof(float));
+          }
+        }
+      });
+
+  if (offset_error) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input 'token_offset' has values out of range [0, ",
+                           padded_tokens, ")");
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
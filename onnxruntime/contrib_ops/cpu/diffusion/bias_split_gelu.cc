@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/diffusion/bias_split_gelu.h"
+
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    BiasSplitGelu, kMSDomain, 1, float, kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    BiasSplitGelu);
+
+Status BiasSplitGelu::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+
+  const auto& input_dims = input->Shape().GetDims();
+  if (input_dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "input is expected to have 3 dimensions, got ", input_dims.size());
+  }
+
+  if (input_dims[2] % 2 != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "hidden size should be even, got ", input_dims[2]);
+  }
+
+  const Tensor* bias = context->Input<Tensor>(1);
+  const auto& bias_dims = bias->Shape().GetDims();
+  if (bias_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "bias is expected to have 1 dimensions, got ", bias_dims.size());
+  }
+  if (bias_dims[0] != input_dims[2]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "last dimension of input and bias are not the same");
+  }
+
+  TensorShapeVector output_shape = input->Shape().AsShapeVector();
+  output_shape[2] = input_dims[2] / 2;
+  Tensor* output = context->Output(0, output_shape);
+
+  const size_t half_hidden_size = narrow<size_t>(input_dims[2] / 2);
+  const float* input_data = input->Data<float>();
+  const float* bias_data = bias->Data<float>();
+  float* output_data = output->MutableData<float>();
+
+  // Every row computes (left + bias_left) * Gelu(right + bias_right), where Gelu(x) = 0.5 * x * (1 + erf(x / sqrt(2))).
+  // The erf argument is staged in the output row so that MLAS evaluates the whole row at once.
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), narrow<std::ptrdiff_t>(input_dims[0] * input_dims[1]),
+      static_cast<double>(half_hidden_size * 16),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const float* left = input_data + static_cast<size_t>(row) * half_hidden_size * 2;
+          const float* right = left + half_hidden_size;
+          const float* bias_right = bias_data + half_hidden_size;
+          float* y = output_data + static_cast<size_t>(row) * half_hidden_size;
+
+          for (size_t i = 0; i < half_hidden_size; i++) {
+            y[i] = (right[i] + bias_right[i]) * 0.70710678118654752f;
+          }
+          MlasComputeErf(y, y, half_hidden_size);
+          for (size_t i = 0; i < half_hidden_size; i++) {
+            const float value_right = right[i] + bias_right[i];
+            y[i] = (left[i] + bias_data[i]) * 0.5f * value_right * (y[i] + 1.0f);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,292 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/diffusion/group_norm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    GroupNorm, kMSDomain, 1, float, kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<float>()),
+    GroupNorm);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    SkipGroupNorm, kMSDomain, 1, float, kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("M", DataTypeImpl::GetTensorType<float>()),
+    GroupNorm);
+
+namespace {
+
+// Applies y = y * sigmoid(y) to a contiguous range, using the vectorized MLAS logistic function on small chunks.
+void ApplySwish(float* data, size_t count) {
+  constexpr size_t kChunkSize = 256;
+  float sigmoid[kChunkSize];
+  for (size_t offset = 0; offset < count; offset += kChunkSize) {
+    const size_t chunk = std::min(kChunkSize, count - offset);
+    MlasComputeLogistic(data + offset, sigmoid, chunk);
+    for (size_t i = 0; i < chunk; i++) {
+      data[offset + i] *= sigmoid[i];
+    }
+  }
+}
+
+}  // namespace
+
+GroupNorm::GroupNorm(const OpKernelInfo& op_info) : OpKernel(op_info) {
+  has_skip_ = op_info.GetKernelDef().OpName() == "SkipGroupNorm";
+
+  epsilon_ = op_info.GetAttrOrDefault<float>("epsilon", 1e-5f);
+  ORT_ENFORCE(epsilon_ >= 0);
+
+  ORT_ENFORCE(op_info.GetAttr("groups", &num_groups_).IsOK());
+  ORT_ENFORCE(num_groups_ > 0);
+
+  int64_t activation;
+  ORT_ENFORCE(op_info.GetAttr("activation", &activation).IsOK());
+  ORT_ENFORCE(activation == 0 || activation == 1);  // 0 is None, 1 is Swish
+  use_swish_activation_ = (activation == 1);
+
+  channels_last_ = (op_info.GetAttrOrDefault<int64_t>("channels_last", static_cast<int64_t>(1)) != 0);
+}
+
+Status GroupNorm::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* gamma = context->Input<Tensor>(1);
+  const Tensor* beta = context->Input<Tensor>(2);
+
+  const auto& input_dims = input->Shape().GetDims();
+  if (input_dims.size() != 4) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "input is expected to have 4 dimensions, got ", input_dims.size());
+  }
+
+  if (has_skip_ && !channels_last_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "SkipGroupNorm only supports the channels_last layout");
+  }
+
+  const int64_t batch_size = input_dims[0];
+  const int64_t num_channels = channels_last_ ? input_dims[3] : input_dims[1];
+  const int64_t image_size = channels_last_ ? input_dims[1] * input_dims[2] : input_dims[2] * input_dims[3];
+
+  if (num_channels % num_groups_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "number of channels should be divisible by num_groups");
+  }
+
+  if (gamma->Shape().NumDimensions() != 1 || gamma->Shape()[0] != num_channels) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "gamma is expected to have shape (C), got ",
+                           gamma->Shape());
+  }
+
+  if (beta->Shape().NumDimensions() != 1 || beta->Shape()[0] != num_channels) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "beta is expected to have shape (C), got ",
+                           beta->Shape());
+  }
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (input->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  const size_t C = narrow<size_t>(num_channels);
+  const size_t HW = narrow<size_t>(image_size);
+  const size_t channels_per_group = C / narrow<size_t>(num_groups_);
+
+  const float* x = input->Data<float>();
+  float* y = output->MutableData<float>();
+
+  if (has_skip_) {
+    const Tensor* skip = context->Input<Tensor>(3);
+    const Tensor* bias = context->Input<Tensor>(4);
+
+    const auto& skip_dims = skip->Shape().GetDims();
+    const int64_t skip_size = skip->Shape().Size();
+    const bool broadcast_skip = skip_size != input->Shape().Size();
+    if ((skip_dims.size() != 2 && skip_dims.size() != 4) || skip_dims[0] != batch_size ||
+        skip_dims.back() != num_channels || (broadcast_skip && skip_size != batch_size * num_channels)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "skip is expected to have shape (N, H, W, C), (N, 1, 1, C) or (N, C), got ",
+                             skip->Shape());
+    }
+
+    if (bias != nullptr && (bias->Shape().NumDimensions() != 1 || bias->Shape()[0] != num_channels)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "bias is expected to have shape (C), got ",
+                             bias->Shape());
+    }
+
+    // The sum is written to the optional output S, or to Y which is then normalized in place.
+    Tensor* add_out = context->Output(1, input->Shape());
+    float* sum = add_out != nullptr ? add_out->MutableData<float>() : y;
+    const float* skip_data = skip->Data<float>();
+    const float* bias_data = bias != nullptr ? bias->Data<float>() : nullptr;
+
+    concurrency::ThreadPool::TryParallelFor(
+        tp, narrow<std::ptrdiff_t>(batch_size * image_size), static_cast<double>(C * 2),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t pixel = first; pixel < last; ++pixel) {
+            const size_t offset = static_cast<size_t>(pixel) * C;
+            const float* skip_row = skip_data + (broadcast_skip ? static_cast<size_t>(pixel) / HW * C : offset);
+            for (size_t c = 0; c < C; c++) {
+              float value = x[offset + c] + skip_row[c];
+              if (bias_data != nullptr) {
+                value += bias_data[c];
+              }
+              sum[offset + c] = value;
+            }
+          }
+        });
+
+    x = sum;
+  }
+
+  const size_t N = narrow<size_t>(batch_size);
+  const float* gamma_data = gamma->Data<float>();
+  const float* beta_data = beta->Data<float>();
+
+  // The statistics are accumulated per channel in double precision, then combined per group.
+  // For NHWC, every image is split into pixel blocks whose per channel partial sums are added afterwards.
+  size_t blocks_per_image = 1;
+  if (channels_last_) {
+    constexpr size_t kMinPixelsPerBlock = 64;
+    const size_t threads = static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(tp));
+    blocks_per_image = std::max<size_t>(1, std::min(HW / kMinPixelsPerBlock, (threads * 4 + N - 1) / N));
+  }
+  const size_t pixels_per_block = (HW + blocks_per_image - 1) / blocks_per_image;
+
+  std::vector<double> partial_sums;
+  if (channels_last_) {
+    partial_sums.assign(N * blocks_per_image * C * 2, 0.0);
+    concurrency::ThreadPool::TryParallelFor(
+        tp, narrow<std::ptrdiff_t>(N * blocks_per_image), static_cast<double>(pixels_per_block * C * 2),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t task = first; task < last; ++task) {
+            const size_t n = static_cast<size_t>(task) / blocks_per_image;
+            const size_t block = static_cast<size_t>(task) % blocks_per_image;
+            const size_t pixel_begin = block * pixels_per_block;
+            const size_t pixel_end = std::min(HW, pixel_begin + pixels_per_block);
+            double* channel_sum = partial_sums.data() + static_cast<size_t>(task) * C * 2;
+            double* channel_sum_sq = channel_sum + C;
+            const float* row = x + (n * HW + pixel_begin) * C;
+            for (size_t p = pixel_begin; p < pixel_end; p++, row += C) {
+              for (size_t c = 0; c < C; c++) {
+                const double value = row[c];
+                channel_sum[c] += value;
+                channel_sum_sq[c] += value * value;
+              }
+            }
+          }
+        });
+  } else {
+    partial_sums.assign(N * C * 2, 0.0);
+    concurrency::ThreadPool::TryParallelFor(
+        tp, narrow<std::ptrdiff_t>(N * C), static_cast<double>(HW * 2),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t task = first; task < last; ++task) {
+            const float* plane = x + static_cast<size_t>(task) * HW;
+            double sum = 0.0;
+            double sum_sq = 0.0;
+            for (size_t i = 0; i < HW; i++) {
+              const double value = plane[i];
+              sum += value;
+              sum_sq += value * value;
+            }
+            partial_sums[static_cast<size_t>(task) * 2] = sum;
+            partial_sums[static_cast<size_t>(task) * 2 + 1] = sum_sq;
+          }
+        });
+  }
+
+  // Fold the group statistics with gamma and beta into a per channel y = x * scale + shift.
+  std::vector<float> scale(N * C);
+  std::vector<float> shift(N * C);
+  const double group_count = static_cast<double>(channels_per_group * HW);
+  for (size_t n = 0; n < N; n++) {
+    for (size_t group_begin = 0; group_begin < C; group_begin += channels_per_group) {
+      double sum = 0.0;
+      double sum_sq = 0.0;
+      for (size_t c = group_begin; c < group_begin + channels_per_group; c++) {
+        if (channels_last_) {
+          for (size_t block = 0; block < blocks_per_image; block++) {
+            const double* block_sums = partial_sums.data() + (n * blocks_per_image + block) * C * 2;
+            sum += block_sums[c];
+            sum_sq += block_sums[C + c];
+          }
+        } else {
+          sum += partial_sums[(n * C + c) * 2];
+          sum_sq += partial_sums[(n * C + c) * 2 + 1];
+        }
+      }
+      const double mean = sum / group_count;
+      const double variance = std::max(sum_sq / group_count - mean * mean, 0.0);
+      const double inv_std_dev = 1.0 / std::sqrt(variance + static_cast<double>(epsilon_));
+      for (size_t c = group_begin; c < group_begin + channels_per_group; c++) {
+        const double channel_scale = inv_std_dev * gamma_data[c];
+        scale[n * C + c] = static_cast<float>(channel_scale);
+        shift[n * C + c] = static_cast<float>(beta_data[c] - mean * channel_scale);
+      }
+    }
+  }
+
+  if (channels_last_) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, narrow<std::ptrdiff_t>(N * blocks_per_image), static_cast<double>(pixels_per_block * C * 4),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t task = first; task < last; ++task) {
+            const size_t n = static_cast<size_t>(task) / blocks_per_image;
+            const size_t block = static_cast<size_t>(task) % blocks_per_image;
+            const size_t pixel_begin = block * pixels_per_block;
+            const size_t pixel_end = std::min(HW, pixel_begin + pixels_per_block);
+            if (pixel_begin >= pixel_end) {
+              continue;
+            }
+            const float* channel_scale = scale.data() + n * C;
+            const float* channel_shift = shift.data() + n * C;
+            const size_t offset = (n * HW + pixel_begin) * C;
+            for (size_t p = pixel_begin, i = offset; p < pixel_end; p++, i += C) {
+              for (size_t c = 0; c < C; c++) {
+                y[i + c] = x[i + c] * channel_scale[c] + channel_shift[c];
+              }
+            }
+            if (use_swish_activation_) {
+              ApplySwish(y + offset, (pixel_end - pixel_begin) * C);
+            }
+          }
+        });
+  } else {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, narrow<std::ptrdiff_t>(N * C), static_cast<double>(HW * 4),
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t task = first; task < last; ++task) {
+            const size_t offset = static_cast<size_t>(task) * HW;
+            const float channel_scale = scale[static_cast<size_t>(task)];
+            const float channel_shift = shift[static_cast<size_t>(task)];
+            for (size_t i = offset; i < offset + HW; i++) {
+              y[i] = x[i] * channel_scale + channel_shift;
+            }
+            if (use_swish_activation_) {
+              ApplySwish(y + offset, HW);
+            }
+          }
+        });
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -19,6 +19,8 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
     1,
     float,
     KernelDefBuilder()
+        // The Sum input is accumulated by the convolution, so reusing its buffer avoids copying it to the output.
+        .MayInplace(3, 0)
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     FusedConvFloat);
 
@@ -0,0 +1,354 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/fused_elementwise.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+namespace {
+
+// Number of output elements evaluated through the whole program at a time. The scratch buffer holds one block
+// per register, so this keeps the working set of typical chains within the L2 cache.
+constexpr size_t kBlockSize = 1024;
+
+// An input that repeats with the given period along the flattened output. A full size input has a period equal
+// to the output size and a scalar has a period of one.
+struct InputSource {
+  const float* data;
+  size_t period;
+};
+
+struct Operand {
+  const float* data;
+  bool is_scalar;
+};
+
+// Expands the input to the full output shape. Used for the inputs whose broadcast pattern is not periodic along
+// the flattened output, for example a [N, 1] tensor broadcast against [N, C].
+void BroadcastToOutput(const float* input, gsl::span<const int64_t> input_dims, gsl::span<const int64_t> output_dims,
+                       float* output) {
+  const size_t rank = output_dims.size();
+  const size_t axis_offset = rank - input_dims.size();
+
+  InlinedVector<int64_t> strides(rank, 0);
+  int64_t stride = 1;
+  for (size_t i = input_dims.size(); i-- > 0;) {
+    if (input_dims[i] != 1) {
+      strides[axis_offset + i] = stride;
+    }
+    stride *= input_dims[i];
+  }
+
+  const int64_t inner_size = output_dims[rank - 1];
+  const int64_t inner_stride = strides[rank - 1];
+  int64_t outer_size = 1;
+  for (size_t axis = 0; axis + 1 < rank; ++axis) {
+    outer_size *= output_dims[axis];
+  }
+
+  InlinedVector<int64_t> counters(rank, 0);
+  int64_t input_offset = 0;
+
+  for (int64_t outer = 0; outer < outer_size; ++outer) {
+    for (int64_t i = 0; i < inner_size; ++i) {
+      output[i] = input[input_offset + i * inner_stride];
+    }
+    output += inner_size;
+
+    for (size_t axis = rank - 1; axis-- > 0;) {
+      input_offset += strides[axis];
+      if (++counters[axis] < output_dims[axis]) {
+        break;
+      }
+      input_offset -= strides[axis] * output_dims[axis];
+      counters[axis] = 0;
+    }
+  }
+}
+
+void CopyPeriodic(const InputSource& source, size_t offset, size_t count, float* output) {
+  size_t index = offset % source.period;
+  while (count > 0) {
+    const size_t n = std::min(count, source.period - index);
+    std::copy_n(source.data + index, n, output);
+    output += n;
+    count -= n;
+    index = 0;
+  }
+}
+
+template <typename Op>
+void EvaluateBinary(const Operand& a, const Operand& b, float* output, size_t count, Op op) {
+  if (a.is_scalar && b.is_scalar) {
+    std::fill_n(output, count, op(*a.data, *b.data));
+  } else if (a.is_scalar) {
+    const float a_value = *a.data;
+    for (size_t i = 0; i < count; ++i) {
+      output[i] = op(a_value, b.data[i]);
+    }
+  } else if (b.is_scalar) {
+    const float b_value = *b.data;
+    for (size_t i = 0; i < count; ++i) {
+      output[i] = op(a.data[i], b_value);
+    }
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      output[i] = op(a.data[i], b.data[i]);
+    }
+  }
+}
+
+template <typename Op>
+void EvaluateUnary(const float* input, float* output, size_t count, Op op) {
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = op(input[i]);
+  }
+}
+
+void EvaluateStep(FusedElementwise::OpType op, const Operand& a, const Operand& b, float* output, size_t count) {
+  using OpType = FusedElementwise::OpType;
+
+  switch (op) {
+    case OpType::Add:
+      EvaluateBinary(a, b, output, count, [](float x, float y) { return x + y; });
+      return;
+    case OpType::Sub:
+      EvaluateBinary(a, b, output, count, [](float x, float y) { return x - y; });
+      return;
+    case OpType::Mul:
+      EvaluateBinary(a, b, output, count, [](float x, float y) { return x * y; });
+      return;
+    case OpType::Div:
+      EvaluateBinary(a, b, output, count, [](float x, float y) { return x / y; });
+      return;
+    default:
+      break;
+  }
+
+  // The unary operators run in place on a broadcast copy of a scalar operand.
+  const float* input = a.data;
+  if (a.is_scalar) {
+    std::fill_n(output, count, *a.data);
+    input = output;
+  }
+
+  switch (op) {
+    case OpType::Relu:
+      EvaluateUnary(input, output, count, [](float x) { return std::max(x, 0.0f); });
+      break;
+    case OpType::Sigmoid:
+      MlasComputeLogistic(input, output, count);
+      break;
+    case OpType::Tanh:
+      MlasComputeTanh(input, output, count);
+      break;
+    case OpType::Exp:
+      MlasComputeExp(input, output, count);
+      break;
+    case OpType::Log:
+      EvaluateUnary(input, output, count, [](float x) { return std::log(x); });
+      break;
+    case OpType::Neg:
+      EvaluateUnary(input, output, count, [](float x) { return -x; });
+      break;
+    case OpType::Abs:
+      EvaluateUnary(input, output, count, [](float x) { return std::fabs(x); });
+      break;
+    case OpType::Sqrt:
+      EvaluateUnary(input, output, count, [](float x) { return std::sqrt(x); });
+      break;
+    case OpType::Reciprocal:
+      EvaluateUnary(input, output, count, [](float x) { return 1.0f / x; });
+      break;
+    case OpType::Erf:
+      MlasComputeErf(input, output, count);
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace
+
+bool FusedElementwise::TryParseOpType(const std::string& op_type, OpType& op) {
+  static const InlinedHashMap<std::string, OpType> op_types{
+      {"Add", OpType::Add},
+      {"Sub", OpType::Sub},
+      {"Mul", OpType::Mul},
+      {"Div", OpType::Div},
+      {"Relu", OpType::Relu},
+      {"Sigmoid", OpType::Sigmoid},
+      {"Tanh", OpType::Tanh},
+      {"Exp", OpType::Exp},
+      {"Log", OpType::Log},
+      {"Neg", OpType::Neg},
+      {"Abs", OpType::Abs},
+      {"Sqrt", OpType::Sqrt},
+      {"Reciprocal", OpType::Reciprocal},
+      {"Erf", OpType::Erf},
+  };
+
+  auto it = op_types.find(op_type);
+  if (it == op_types.end()) {
+    return false;
+  }
+  op = it->second;
+  return true;
+}
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  const auto ops = info.GetAttrsOrDefault<std::string>("ops");
+  const auto lhs = info.GetAttrsOrDefault<int64_t>("lhs");
+  const auto rhs = info.GetAttrsOrDefault<int64_t>("rhs");
+
+  ORT_ENFORCE(!ops.empty(), "FusedElementwise requires at least one operator.");
+  ORT_ENFORCE(lhs.size() == ops.size() && rhs.size() == ops.size(),
+              "FusedElementwise attributes ops, lhs and rhs must have the same length.");
+
+  const int64_t num_inputs = static_cast<int64_t>(info.GetInputCount());
+  steps_.reserve(ops.size());
+
+  for (size_t i = 0; i < ops.size(); ++i) {
+    OpType op = OpType::Add;
+    ORT_ENFORCE(TryParseOpType(ops[i], op), "FusedElementwise does not support operator ", ops[i]);
+
+    // A step may only read the inputs and the results of the preceding steps.
+    const int64_t num_registers = num_inputs + static_cast<int64_t>(i);
+    ORT_ENFORCE(lhs[i] >= 0 && lhs[i] < num_registers, "FusedElementwise step ", i, " has invalid lhs ", lhs[i]);
+    if (IsBinaryOp(op)) {
+      ORT_ENFORCE(rhs[i] >= 0 && rhs[i] < num_registers, "FusedElementwise step ", i, " has invalid rhs ", rhs[i]);
+    } else {
+      ORT_ENFORCE(rhs[i] == -1, "FusedElementwise step ", i, " is unary and requires rhs to be -1.");
+    }
+
+    steps_.push_back(Step{op, narrow<int>(lhs[i]), narrow<int>(rhs[i])});
+  }
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const int num_inputs = context->InputCount();
+
+  size_t rank = 0;
+  for (int i = 0; i < num_inputs; ++i) {
+    rank = std::max(rank, context->Input<Tensor>(i)->Shape().NumDimensions());
+  }
+
+  TensorShapeVector output_dims(rank, 1);
+  for (int i = 0; i < num_inputs; ++i) {
+    const auto& input_shape = context->Input<Tensor>(i)->Shape();
+    const auto input_dims = input_shape.GetDims();
+    const size_t axis_offset = rank - input_dims.size();
+    for (size_t j = 0; j < input_dims.size(); ++j) {
+      int64_t& output_dim = output_dims[axis_offset + j];
+      if (input_dims[j] == output_dim || input_dims[j] == 1) {
+        continue;
+      }
+      if (output_dim != 1) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "FusedElementwise: input ", i, " with shape ",
+                               input_shape, " can not be broadcast to ", TensorShape(output_dims));
+      }
+      output_dim = input_dims[j];
+    }
+  }
+
+  const TensorShape output_shape(output_dims);
+  Tensor* output = context->Output(0, output_shape);
+  const size_t total = narrow<size_t>(output_shape.Size());
+  if (total == 0) {
+    return Status::OK();
+  }
+
+  // Classify each input by how it repeats along the flattened output. An input whose dimensions, after
+  // dropping its leading ones, match the trailing output dimensions is periodic; anything else is expanded.
+  InlinedVector<InputSource> sources;
+  sources.reserve(num_inputs);
+  InlinedVector<IAllocatorUniquePtr<float>> expanded_inputs;
+
+  for (int i = 0; i < num_inputs; ++i) {
+    const Tensor& input = *context->Input<Tensor>(i);
+    const auto input_dims = input.Shape().GetDims();
+
+    size_t first_dim = 0;
+    while (first_dim < input_dims.size() && input_dims[first_dim] == 1) {
+      ++first_dim;
+    }
+    const auto trailing_dims = input_dims.subspan(first_dim);
+    const bool is_periodic = std::equal(trailing_dims.begin(), trailing_dims.end(),
+                                        output_dims.end() - trailing_dims.size());
+
+    if (is_periodic) {
+      sources.push_back(InputSource{input.Data<float>(), narrow<size_t>(input.Shape().Size())});
+    } else {
+      AllocatorPtr alloc;
+      ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+      auto buffer = IAllocator::MakeUniquePtr<float>(alloc, total);
+      BroadcastToOutput(input.Data<float>(), input_dims, output_dims, buffer.get());
+      sources.push_back(InputSource{buffer.get(), total});
+      expanded_inputs.push_back(std::move(buffer));
+    }
+  }
+
+  float* output_data = output->MutableData<float>();
+  const size_t num_steps = steps_.size();
+  const size_t num_blocks = (total + kBlockSize - 1) / kBlockSize;
+
+  const TensorOpCost cost{static_cast<double>(num_inputs * kBlockSize * sizeof(float)),
+                          static_cast<double>(kBlockSize * sizeof(float)),
+                          static_cast<double>(num_steps * kBlockSize)};
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_blocks), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // One block per step result followed by one block per input for the periodic copies.
+        std::vector<float> scratch((num_steps + num_inputs) * kBlockSize);
+        InlinedVector<Operand> registers(num_inputs + num_steps);
+
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const size_t offset = static_cast<size_t>(block) * kBlockSize;
+          const size_t count = std::min(kBlockSize, total - offset);
+
+          for (int i = 0; i < num_inputs; ++i) {
+            const InputSource& source = sources[i];
+            if (source.period == 1) {
+              registers[i] = Operand{source.data, true};
+            } else if (source.period == total) {
+              registers[i] = Operand{source.data + offset, false};
+            } else {
+              float* buffer = scratch.data() + (num_steps + i) * kBlockSize;
+              CopyPeriodic(source, offset, count, buffer);
+              registers[i] = Operand{buffer, false};
+            }
+          }
+
+          for (size_t s = 0; s < num_steps; ++s) {
+            const Step& step = steps_[s];
+            float* step_output = (s + 1 == num_steps) ? output_data + offset : scratch.data() + s * kBlockSize;
+            const Operand rhs = step.rhs >= 0 ? registers[step.rhs] : Operand{nullptr, false};
+            EvaluateStep(step.op, registers[step.lhs], rhs, step_output, count);
+            registers[num_inputs + s] = Operand{step_output, false};
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
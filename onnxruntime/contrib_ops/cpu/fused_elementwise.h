@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/**
+ * @brief Evaluates a chain of element-wise operators in one blocked pass over the broadcast output.
+ *
+ * The attributes describe a small register program. Registers [0, N) hold the N inputs and step i writes
+ * register N + i. Each block of the output is computed through every step before moving to the next block,
+ * so the intermediate results stay in a cache-resident scratch buffer instead of full-size tensors.
+ */
+class FusedElementwise final : public OpKernel {
+ public:
+  enum class OpType : uint8_t {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Relu,
+    Sigmoid,
+    Tanh,
+    Exp,
+    Log,
+    Neg,
+    Abs,
+    Sqrt,
+    Reciprocal,
+    Erf,
+  };
+
+  struct Step {
+    OpType op;
+    int lhs;
+    int rhs;  // -1 for unary operators
+  };
+
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  // Returns false if op_type is not an element-wise operator this kernel can evaluate.
+  static bool TryParseOpType(const std::string& op_type, OpType& op);
+
+  static bool IsBinaryOp(OpType op) {
+    return op == OpType::Add || op == OpType::Sub || op == OpType::Mul || op == OpType::Div;
+  }
+
+ private:
+  InlinedVector<Step> steps_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
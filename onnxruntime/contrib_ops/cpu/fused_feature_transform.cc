@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/**
+ * @brief Imputer, Scaler and Normalizer applied row by row in a single pass.
+ *
+ * Each row is imputed and scaled into the output and then normalized in place while it is still in the cache,
+ * instead of writing a full intermediate tensor per operator. The results match the ai.onnx.ml kernels.
+ */
+class FusedFeatureTransform final : public OpKernel {
+ public:
+  explicit FusedFeatureTransform(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  enum class Norm : uint8_t {
+    None,
+    Max,
+    L1,
+    L2,
+  };
+
+  std::vector<float> imputed_values_;
+  float replaced_value_;
+  std::vector<float> offset_;
+  std::vector<float> scale_;
+  Norm norm_{Norm::None};
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedFeatureTransform,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).MayInplace(0, 0),
+    FusedFeatureTransform);
+
+FusedFeatureTransform::FusedFeatureTransform(const OpKernelInfo& info)
+    : OpKernel(info),
+      imputed_values_(info.GetAttrsOrDefault<float>("imputed_values")),
+      replaced_value_(info.GetAttrOrDefault<float>("replaced_value", 0.0f)),
+      offset_(info.GetAttrsOrDefault<float>("offset")),
+      scale_(info.GetAttrsOrDefault<float>("scale")) {
+  ORT_ENFORCE(scale_.size() == offset_.size(),
+              "Scale size: (", scale_.size(), ") != offset size: (", offset_.size(), ")");
+
+  const std::string norm = info.GetAttrOrDefault<std::string>("norm", "");
+  if (norm == "MAX") {
+    norm_ = Norm::Max;
+  } else if (norm == "L1") {
+    norm_ = Norm::L1;
+  } else if (norm == "L2") {
+    norm_ = Norm::L2;
+  } else {
+    ORT_ENFORCE(norm.empty(), "Invalid norm value of ", norm);
+  }
+}
+
+Status FusedFeatureTransform::Compute(OpKernelContext* context) const {
+  const Tensor& X = *context->Input<Tensor>(0);
+  const TensorShape& x_shape = X.Shape();
+  if (x_shape.NumDimensions() == 0 || x_shape.NumDimensions() > 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input must be 1D or 2D. Got ", x_shape.NumDimensions(),
+                           " dimensions");
+  }
+
+  const size_t num_rows = x_shape.NumDimensions() == 1 ? 1 : narrow<size_t>(x_shape[0]);
+  const size_t num_features = narrow<size_t>(x_shape[x_shape.NumDimensions() - 1]);
+
+  // The Scaler only accepts per feature or single values, while the Imputer falls back to the first value.
+  if (!scale_.empty() && scale_.size() != num_features && scale_.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Either both scale and offset can be of feature size (",
+                           num_features, ") or 1");
+  }
+
+  Tensor* Y = context->Output(0, x_shape);
+  if (num_rows == 0 || num_features == 0) {
+    return Status::OK();
+  }
+
+  const float* x_data = X.Data<float>();
+  float* y_data = Y->MutableData<float>();
+
+  const bool impute = !imputed_values_.empty();
+  const bool impute_per_feature = imputed_values_.size() == num_features;
+  const bool replace_nan = std::isnan(replaced_value_);
+  const bool scale = !scale_.empty();
+  const bool scale_per_feature = scale_.size() == num_features;
+
+  auto transform_rows = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      const float* x = x_data + static_cast<size_t>(row) * num_features;
+      float* y = y_data + static_cast<size_t>(row) * num_features;
+
+      for (size_t i = 0; i < num_features; ++i) {
+        float value = x[i];
+        if (impute && ((replace_nan && std::isnan(value)) || value == replaced_value_)) {
+          value = imputed_values_[impute_per_feature ? i : 0];
+        }
+        if (scale) {
+          const size_t j = scale_per_feature ? i : 0;
+          value = (value - offset_[j]) * scale_[j];
+        }
+        y[i] = value;
+      }
+
+      switch (norm_) {
+        case Norm::Max: {
+          float max = std::numeric_limits<float>::lowest();
+          for (size_t i = 0; i < num_features; ++i) {
+            max = std::max(max, y[i]);
+          }
+          if (max != 0.f) {
+            for (size_t i = 0; i < num_features; ++i) {
+              y[i] /= max;
+            }
+          }
+          break;
+        }
+        case Norm::L1: {
+          float sum = 0.f;
+          for (size_t i = 0; i < num_features; ++i) {
+            sum += std::abs(y[i]);
+          }
+          if (sum != 0.f) {
+            for (size_t i = 0; i < num_features; ++i) {
+              y[i] /= sum;
+            }
+          }
+          break;
+        }
+        case Norm::L2: {
+          float sum = 0.f;
+          for (size_t i = 0; i < num_features; ++i) {
+            sum += y[i] * y[i];
+          }
+          if (sum != 0.f) {
+            for (size_t i = 0; i < num_features; ++i) {
+              const float value = std::sqrt(y[i] * y[i] / sum);
+              y[i] = y[i] < 0 ? -value : value;
+            }
+          }
+          break;
+        }
+        case Norm::None:
+          break;
+      }
+    }
+  };
+
+  const double row_bytes = static_cast<double>(num_features * sizeof(float));
+  concurrency::ThreadPool::TryParallelFor(context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_rows),
+                                          TensorOpCost{row_bytes, row_bytes, 4.0 * static_cast<double>(num_features)},
+                                          transform_rows);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
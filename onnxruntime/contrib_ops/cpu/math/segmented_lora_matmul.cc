@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Applies the LoRA adapter selected by adapter_indices to each batch entry, so that a batch can mix the requests of
+// many adapters. Runs of batch entries sharing an adapter are computed as one segment: two GEMMs with the A and B
+// matrices of the adapter, read in place from the stacked lora_a and lora_b inputs.
+class SegmentedLoraMatMul final : public OpKernel {
+ public:
+  explicit SegmentedLoraMatMul(const OpKernelInfo& info) : OpKernel(info) {
+    scale_ = info.GetAttrOrDefault<float>("scale", 1.0f);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  float scale_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    SegmentedLoraMatMul,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("I", std::vector<MLDataType>{DataTypeImpl::GetTensorType<int32_t>(),
+                                                     DataTypeImpl::GetTensorType<int64_t>()})
+        .MayInplace(4, 0),
+    SegmentedLoraMatMul);
+
+namespace {
+
+struct Segment {
+  size_t first_batch;
+  size_t num_batches;
+  size_t adapter;
+};
+
+template <typename TIndex>
+Status GetSegments(const Tensor& adapter_indices, size_t num_adapters, InlinedVector<Segment>& segments) {
+  const auto indices = adapter_indices.DataAsSpan<TIndex>();
+  for (size_t b = 0; b < indices.size(); ++b) {
+    const auto index = static_cast<int64_t>(indices[b]);
+    if (index < 0) {
+      // no LoRA update for this batch entry
+      continue;
+    }
+
+    ORT_RETURN_IF_NOT(static_cast<uint64_t>(index) < num_adapters, "adapter_indices[", b, "] is ", index,
+                      ", out of range for ", num_adapters, " adapters");
+    const auto adapter = static_cast<size_t>(index);
+    if (!segments.empty() && segments.back().adapter == adapter &&
+        segments.back().first_batch + segments.back().num_batches == b) {
+      ++segments.back().num_batches;
+    } else {
+      segments.push_back(Segment{b, 1, adapter});
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
+Status SegmentedLoraMatMul::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* lora_a = context->Input<Tensor>(1);
+  const Tensor* lora_b = context->Input<Tensor>(2);
+  const Tensor* adapter_indices = context->Input<Tensor>(3);
+  const Tensor* base = context->Input<Tensor>(4);
+
+  const auto& x_shape = X->Shape();
+  const auto& a_shape = lora_a->Shape();
+  const auto& b_shape = lora_b->Shape();
+  ORT_RETURN_IF_NOT(x_shape.NumDimensions() == 2 || x_shape.NumDimensions() == 3,
+                    "X must have 2 or 3 dimensions, got ", x_shape);
+  ORT_RETURN_IF_NOT(a_shape.NumDimensions() == 3 && b_shape.NumDimensions() == 3,
+                    "lora_a and lora_b must have 3 dimensions, got ", a_shape, " and ", b_shape);
+
+  const size_t batch_size = narrow<size_t>(x_shape[0]);
+  const size_t rows_per_batch = x_shape.NumDimensions() == 3 ? narrow<size_t>(x_shape[1]) : 1;
+  const size_t K = narrow<size_t>(x_shape[x_shape.NumDimensions() - 1]);
+  const size_t num_adapters = narrow<size_t>(a_shape[0]);
+  const size_t rank = narrow<size_t>(a_shape[2]);
+  const size_t N = narrow<size_t>(b_shape[2]);
+
+  ORT_RETURN_IF_NOT(narrow<size_t>(a_shape[1]) == K, "lora_a ", a_shape, " does not match the K dimension of X ",
+                    x_shape);
+  ORT_RETURN_IF_NOT(narrow<size_t>(b_shape[0]) == num_adapters && narrow<size_t>(b_shape[1]) == rank,
+                    "lora_b ", b_shape, " does not match lora_a ", a_shape);
+  ORT_RETURN_IF_NOT(adapter_indices->Shape().NumDimensions() == 1 &&
+                        narrow<size_t>(adapter_indices->Shape()[0]) == batch_size,
+                    "adapter_indices must have shape (", batch_size, "), got ", adapter_indices->Shape());
+
+  TensorShape y_shape(x_shape);
+  y_shape[y_shape.NumDimensions() - 1] = static_cast<int64_t>(N);
+  ORT_RETURN_IF_NOT(base == nullptr || base->Shape() == y_shape, "base must have shape ", y_shape, ", got ",
+                    base == nullptr ? TensorShape() : base->Shape());
+
+  Tensor* Y = context->Output(0, y_shape);
+  float* y_data = Y->MutableData<float>();
+  const size_t y_size = narrow<size_t>(y_shape.Size());
+
+  // the entries without an adapter, and the segments, start from the base output
+  if (base == nullptr) {
+    std::fill_n(y_data, y_size, 0.0f);
+  } else if (base->Data<float>() != y_data) {
+    std::copy_n(base->Data<float>(), y_size, y_data);
+  }
+
+  InlinedVector<Segment> segments;
+  if (adapter_indices->IsDataType<int32_t>()) {
+    ORT_RETURN_IF_ERROR(GetSegments<int32_t>(*adapter_indices, num_adapters, segments));
+  } else {
+    ORT_RETURN_IF_ERROR(GetSegments<int64_t>(*adapter_indices, num_adapters, segments));
+  }
+
+  if (segments.empty() || rows_per_batch == 0 || K == 0 || rank == 0 || N == 0) {
+    return Status::OK();
+  }
+
+  // X * A of every row, with rank columns
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  auto intermediate = IAllocator::MakeUniquePtr<float>(allocator, batch_size * rows_per_batch * rank);
+
+  const float* x_data = X->Data<float>();
+  const float* a_data = lora_a->Data<float>();
+  const float* b_data = lora_b->Data<float>();
+  float* t_data = intermediate.get();
+  const float scale = scale_;
+
+  auto compute_segment = [&](const Segment& segment, concurrency::ThreadPool* thread_pool) {
+    const size_t first_row = segment.first_batch * rows_per_batch;
+    const size_t M = segment.num_batches * rows_per_batch;
+    float* t = t_data + first_row * rank;
+
+    MlasGemm(CblasNoTrans, CblasNoTrans, M, rank, K,
+             1.0f, x_data + first_row * K, K, a_data + segment.adapter * K * rank, rank,
+             0.0f, t, rank, thread_pool);
+    MlasGemm(CblasNoTrans, CblasNoTrans, M, N, rank,
+             scale, t, rank, b_data + segment.adapter * rank * N, N,
+             1.0f, y_data + first_row * N, N, thread_pool);
+  };
+
+  // many small segments are computed in parallel, a few large ones split their GEMMs across the threads
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+  if (segments.size() >= static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool))) {
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(segments.size()),
+        [&](std::ptrdiff_t i) { compute_segment(segments[static_cast<size_t>(i)], nullptr); });
+  } else {
+    for (const auto& segment : segments) {
+      compute_segment(segment, thread_pool);
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -255,6 +255,61 @@ Status NchwcAveragePool::Compute(OpKernelContext* context) const {
                                                                          : MlasAveragePoolingExcludePad);
 }
 
+Status NchwcMul::Compute(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto* S = context->Input<Tensor>(1);
+  const auto X_shape = X->Shape().GetDims();
+  const auto S_shape = S->Shape().GetDims();
+  ORT_ENFORCE(X_shape.size() == 4);
+  ORT_ENFORCE((X_shape[1] % MlasNchwcGetBlockSize()) == 0);
+  ORT_RETURN_IF_NOT(S_shape.size() == 4 && (S_shape[0] == X_shape[0] || S_shape[0] == 1) &&
+                        S_shape[1] == X_shape[1] && S_shape[2] == 1 && S_shape[3] == 1,
+                    "scale shape must be [N, C, 1, 1]");
+
+  auto* Y = context->Output(0, X->Shape());
+
+  // Bail out early if one of the dimensions is zero.
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const int64_t nchwc_block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  const int64_t blocks_per_image = X_shape[1] / nchwc_block_size;
+  const int64_t spatial_size = X_shape[2] * X_shape[3];
+  const int64_t block_stride = spatial_size * nchwc_block_size;
+  const bool broadcast_batch = S_shape[0] != X_shape[0];
+
+  const auto* x_data = X->Data<float>();
+  const auto* s_data = S->Data<float>();
+  auto* y_data = Y->MutableData<float>();
+
+  const TensorOpCost cost{static_cast<double>(block_stride * sizeof(float)),
+                          static_cast<double>(block_stride * sizeof(float)),
+                          static_cast<double>(block_stride)};
+
+  // Each iteration scales the spatial_size chunk of one NCHWc block.
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(X_shape[0] * blocks_per_image), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t block = first; block < last; block++) {
+          const int64_t scale_block = broadcast_batch ? block % blocks_per_image : block;
+          const float* s = s_data + scale_block * nchwc_block_size;
+          const float* x = x_data + block * block_stride;
+          float* y = y_data + block * block_stride;
+
+          for (int64_t i = 0; i < spatial_size; i++) {
+            for (int64_t j = 0; j < nchwc_block_size; j++) {
+              y[j] = x[j] * s[j];
+            }
+            x += nchwc_block_size;
+            y += nchwc_block_size;
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
 std::vector<float> NchwcUpsample::ComputeInterpolation(int64_t input_length,
                                                        int64_t output_length,
                                                        int64_t scale) const {
@@ -437,6 +492,15 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcAveragePool);
 
+ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
+    Mul,
+    1,
+    float,
+    KernelDefBuilder()
+        .MayInplace(0, 0)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcMul);
+
 ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
     Upsample,
     1,
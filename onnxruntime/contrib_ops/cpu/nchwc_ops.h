@@ -80,6 +80,16 @@ class NchwcAveragePool final : public OpKernel, public NchwcPoolBase {
   Status Compute(OpKernelContext* context) const override;
 };
 
+// Scales each channel block of an NCHWc tensor by a [N, C, 1, 1] tensor, such as the excitation of a
+// squeeze-and-excitation block.
+class NchwcMul final : public OpKernel {
+ public:
+  NchwcMul(const OpKernelInfo& info) : OpKernel(info) {
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+};
+
 class NchwcUpsample final : public OpKernel {
  private:
   enum class TransformationMode {
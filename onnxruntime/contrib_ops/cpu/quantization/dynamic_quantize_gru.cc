@@ -0,0 +1,317 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/rnn/deep_cpu_gru.h"
+#include "core/providers/cpu/rnn/rnn_helpers.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using namespace rnn::detail;
+
+// GRU with 8 bit weights. The input of each GEMM is quantized dynamically, per GEMM.
+// The weights are transposed compared to GRU:
+//   W: [num_directions, input_size, 3*hidden_size]
+//   R: [num_directions, hidden_size, 3*hidden_size]
+// and the recurrent weights are packed in separate buffers for the update and reset gates, and the hidden gate.
+class DynamicQuantizeGRU : public OpKernel, public GRUBase {
+ public:
+  DynamicQuantizeGRU(const OpKernelInfo& info) : OpKernel(info), GRUBase(info) {}
+
+  Status PrePack(const Tensor& tensor, int input_idx,
+                 AllocatorPtr alloc, /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+  ~DynamicQuantizeGRU() override = default;
+
+ private:
+  bool TryPackInputWeights(const Tensor& weights, AllocatorPtr& alloc);
+
+  bool TryPackRecurrentWeights(const Tensor& weights, AllocatorPtr& alloc);
+
+  PackedWeights packed_W_;
+  // update and reset gates of the recurrent weights, fwd followed by bwd
+  PackedWeights packed_R_ZR_;
+  // hidden gate of the recurrent weights, fwd followed by bwd
+  PackedWeights packed_R_H_;
+  bool is_W_signed_{false};
+  bool is_R_signed_{false};
+};
+
+namespace {
+
+// packs the columns [column, column + N) of the [K, ldb] weights of each direction
+size_t PackWeights(const uint8_t* weights, int64_t num_directions, size_t K, size_t ldb, size_t column, size_t N,
+                   bool is_signed, PackedWeights& packed_weights, AllocatorPtr& alloc) {
+  const size_t packed_weights_size = MlasGemmPackBSize(N, K, false /*AIsSigned*/, is_signed);
+  if (packed_weights_size == 0) {
+    return 0;
+  }
+
+  const size_t buffer_size = SafeInt<size_t>(packed_weights_size) * num_directions;
+  packed_weights.buffer_ = IAllocator::MakeUniquePtr<void>(alloc, buffer_size, true);
+
+  auto* packed_weights_data = static_cast<uint8_t*>(packed_weights.buffer_.get());
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we don not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_weights_data, 0, buffer_size);
+
+  packed_weights.buffer_size_ = buffer_size;
+  packed_weights.weights_size_ = packed_weights_size;
+
+  for (int64_t dir = 0; dir < num_directions; ++dir) {
+    MlasGemmPackB(N, K, weights + column, ldb, false /*AIsSigned*/, is_signed, packed_weights_data);
+    weights += K * ldb;
+    packed_weights_data += packed_weights_size;
+  }
+
+  return packed_weights_size;
+}
+
+// scale and zero point have shape [num_directions] for per-tensor/layer quantization or
+// [num_directions, 3*hidden_size] for per-channel quantization
+Status ValidateQuantizationParameters(const Tensor& scale, const Tensor& zero_point, bool is_signed,
+                                      int64_t num_directions, int64_t hidden_size, const char* weight_name) {
+  for (const Tensor* tensor : {&scale, &zero_point}) {
+    const auto& shape = tensor->Shape();
+    if ((shape.NumDimensions() != 1 && shape.NumDimensions() != 2) || shape[0] != num_directions ||
+        (shape.NumDimensions() == 2 && shape[1] != hidden_size * 3) || shape != scale.Shape()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "DynamicQuantizeGRU : The scale and the zero point of ", weight_name, " must have shape {",
+                             num_directions, "} for per-tensor/layer quantization or shape {", num_directions, ", 3*",
+                             hidden_size, "} for per-channel quantization. Actual:", shape);
+    }
+  }
+
+  // the quantized GEMM applies a single zero point to the weights of a direction
+  const auto zero_points = gsl::make_span(static_cast<const uint8_t*>(zero_point.DataRaw()),
+                                          narrow<size_t>(zero_point.Shape().Size()));
+  if (is_signed && std::any_of(zero_points.begin(), zero_points.end(), [](uint8_t zp) { return zp != 0; })) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "DynamicQuantizeGRU : ", weight_name, " zero point must be zero");
+  }
+  const size_t zero_points_per_direction = zero_points.size() / narrow<size_t>(num_directions);
+  for (size_t dir = 0; dir < narrow<size_t>(num_directions); ++dir) {
+    const auto dir_zero_points = zero_points.subspan(dir * zero_points_per_direction, zero_points_per_direction);
+    if (std::any_of(dir_zero_points.begin(), dir_zero_points.end(),
+                    [&](uint8_t zp) { return zp != dir_zero_points[0]; })) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "DynamicQuantizeGRU : ", weight_name, " zero point must be the same in a direction");
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
+bool DynamicQuantizeGRU::TryPackInputWeights(const Tensor& weights, AllocatorPtr& alloc) {
+  // weights: [num_directions, input_size, 3*hidden_size]
+  const auto& shape = weights.Shape();
+  if (shape.NumDimensions() != 3 || shape[0] != num_directions_ || shape[2] != static_cast<int64_t>(hidden_size_) * 3) {
+    return false;
+  }
+
+  const size_t K = narrow<size_t>(shape[1]);
+  const size_t N = narrow<size_t>(shape[2]);
+  is_W_signed_ = weights.IsDataType<int8_t>();
+  if (PackWeights(static_cast<const uint8_t*>(weights.DataRaw()), num_directions_, K, N, 0, N, is_W_signed_,
+                  packed_W_, alloc) == 0) {
+    return false;
+  }
+
+  packed_W_.shape_ = shape;
+  return true;
+}
+
+bool DynamicQuantizeGRU::TryPackRecurrentWeights(const Tensor& weights, AllocatorPtr& alloc) {
+  // recurrence weights: [num_directions, hidden_size, 3*hidden_size]
+  const auto& shape = weights.Shape();
+  if (shape.NumDimensions() != 3 || shape[0] != num_directions_ || shape[1] != hidden_size_ ||
+      shape[2] != static_cast<int64_t>(hidden_size_) * 3) {
+    return false;
+  }
+
+  const size_t hidden_size = static_cast<size_t>(hidden_size_);
+  const auto* weights_data = static_cast<const uint8_t*>(weights.DataRaw());
+  is_R_signed_ = weights.IsDataType<int8_t>();
+  if (PackWeights(weights_data, num_directions_, hidden_size, 3 * hidden_size, 0, 2 * hidden_size, is_R_signed_,
+                  packed_R_ZR_, alloc) == 0 ||
+      PackWeights(weights_data, num_directions_, hidden_size, 3 * hidden_size, 2 * hidden_size, hidden_size,
+                  is_R_signed_, packed_R_H_, alloc) == 0) {
+    packed_R_ZR_.buffer_.reset();
+    packed_R_H_.buffer_.reset();
+    return false;
+  }
+
+  // original shape, not used in prepacked calculations, but useful for validation
+  packed_R_ZR_.shape_ = shape;
+  packed_R_H_.shape_ = shape;
+  return true;
+}
+
+Status DynamicQuantizeGRU::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                                   /*out*/ bool& is_packed,
+                                   /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  const bool share_prepacked_weights = (prepacked_weights != nullptr);
+  if (input_idx == 1) {
+    is_packed = TryPackInputWeights(tensor, alloc);
+    if (is_packed && share_prepacked_weights) {
+      prepacked_weights->buffers_.push_back(std::move(packed_W_.buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_W_.buffer_size_);
+    }
+  } else if (input_idx == 2) {
+    is_packed = TryPackRecurrentWeights(tensor, alloc);
+    if (is_packed && share_prepacked_weights) {
+      prepacked_weights->buffers_.push_back(std::move(packed_R_ZR_.buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_R_ZR_.buffer_size_);
+      prepacked_weights->buffers_.push_back(std::move(packed_R_H_.buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_R_H_.buffer_size_);
+    }
+  }
+
+  return Status::OK();
+}
+
+Status DynamicQuantizeGRU::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                     int input_idx,
+                                                     /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    packed_W_.buffer_ = std::move(prepacked_buffers[0]);
+    used_shared_buffers = true;
+  } else if (input_idx == 2) {
+    packed_R_ZR_.buffer_ = std::move(prepacked_buffers[0]);
+    packed_R_H_.buffer_ = std::move(prepacked_buffers[1]);
+    used_shared_buffers = true;
+  }
+
+  return Status::OK();
+}
+
+Status DynamicQuantizeGRU::Compute(OpKernelContext* context) const {
+  const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
+  // weights. [num_directions, input_size, 3*hidden_size]
+  const Tensor* W = packed_W_.buffer_ ? nullptr : context->Input<Tensor>(1);
+  // recurrence weights. [num_directions, hidden_size, 3*hidden_size]
+  const Tensor* R = packed_R_ZR_.buffer_ ? nullptr : context->Input<Tensor>(2);
+
+  const auto& W_shape = (W != nullptr) ? W->Shape() : packed_W_.shape_;
+  const auto& R_shape = (R != nullptr) ? R->Shape() : packed_R_ZR_.shape_;
+  if (W_shape.NumDimensions() != 3 || R_shape.NumDimensions() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "DynamicQuantizeGRU : W and R must have rank 3. W:", W_shape,
+                           " R:", R_shape);
+  }
+
+  // the common validation expects the layout of GRU
+  ORT_RETURN_IF_ERROR(ValidateInputs(X, TensorShape{W_shape[0], W_shape[2], W_shape[1]},
+                                     TensorShape{R_shape[0], R_shape[2], R_shape[1]},
+                                     context->Input<Tensor>(3), context->Input<Tensor>(4), context->Input<Tensor>(5)));
+
+  const Tensor& w_scale = *context->Input<Tensor>(6);
+  const Tensor& w_zp = *context->Input<Tensor>(7);
+  const Tensor& r_scale = *context->Input<Tensor>(8);
+  const Tensor& r_zp = *context->Input<Tensor>(9);
+
+  const bool is_W_signed = (W != nullptr) ? W->IsDataType<int8_t>() : is_W_signed_;
+  const bool is_R_signed = (R != nullptr) ? R->IsDataType<int8_t>() : is_R_signed_;
+  ORT_RETURN_IF_ERROR(ValidateQuantizationParameters(w_scale, w_zp, is_W_signed, num_directions_, hidden_size_, "W"));
+  ORT_RETURN_IF_ERROR(ValidateQuantizationParameters(r_scale, r_zp, is_R_signed, num_directions_, hidden_size_, "R"));
+
+  const size_t hidden_size = static_cast<size_t>(hidden_size_);
+  const bool is_W_per_channel = w_scale.Shape().NumDimensions() == 2;
+  const bool is_R_per_channel = r_scale.Shape().NumDimensions() == 2;
+  const size_t W_scale_size = is_W_per_channel ? 3 * hidden_size : 1;
+  const size_t R_scale_size = is_R_per_channel ? 3 * hidden_size : 1;
+
+  const auto* w_scale_data = w_scale.Data<float>();
+  const auto* w_zp_data = static_cast<const uint8_t*>(w_zp.DataRaw());
+  const auto* r_scale_data = r_scale.Data<float>();
+  const auto* r_zp_data = static_cast<const uint8_t*>(r_zp.DataRaw());
+
+  // the update and reset gates use the first 2*hidden_size channels, and the hidden gate the remaining ones
+  const size_t R_H_offset = is_R_per_channel ? 2 * hidden_size : 0;
+  std::vector<QuantizationParameter> quant_paras;
+  quant_paras.reserve(6);
+  for (int dir = 0; dir < num_directions_; ++dir) {
+    quant_paras.emplace_back(w_scale_data + dir * W_scale_size, w_zp_data + dir * W_scale_size, is_W_signed,
+                             W_scale_size);
+    quant_paras.emplace_back(r_scale_data + dir * R_scale_size, r_zp_data + dir * R_scale_size, is_R_signed,
+                             is_R_per_channel ? 2 * hidden_size : 1);
+    quant_paras.emplace_back(r_scale_data + dir * R_scale_size + R_H_offset, r_zp_data + dir * R_scale_size + R_H_offset,
+                             is_R_signed, is_R_per_channel ? hidden_size : 1);
+  }
+
+  const uint8_t* W_data = W != nullptr ? static_cast<const uint8_t*>(W->DataRaw()) : nullptr;
+  const size_t W_size_per_direction = SafeInt<size_t>(W_shape[1]) * W_shape[2];
+
+  // the quantized GEMM needs contiguous weights for each gate, so unpacked recurrent weights are split
+  IAllocatorUniquePtr<uint8_t> R_split_buffer;
+  const uint8_t* R_ZR_data = nullptr;
+  const uint8_t* R_H_data = nullptr;
+  const size_t R_ZR_size_per_direction = 2 * hidden_size * hidden_size;
+  const size_t R_H_size_per_direction = hidden_size * hidden_size;
+  if (R != nullptr) {
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+    const size_t R_size = SafeInt<size_t>(num_directions_) * 3 * hidden_size * hidden_size;
+    R_split_buffer = IAllocator::MakeUniquePtr<uint8_t>(alloc, R_size);
+    uint8_t* ZR_dst = R_split_buffer.get();
+    uint8_t* H_dst = ZR_dst + num_directions_ * R_ZR_size_per_direction;
+    const auto* src = static_cast<const uint8_t*>(R->DataRaw());
+    for (size_t row = 0; row < num_directions_ * hidden_size; ++row) {
+      std::copy_n(src, 2 * hidden_size, ZR_dst);
+      std::copy_n(src + 2 * hidden_size, hidden_size, H_dst);
+      src += 3 * hidden_size;
+      ZR_dst += 2 * hidden_size;
+      H_dst += hidden_size;
+    }
+    R_ZR_data = R_split_buffer.get();
+    R_H_data = R_split_buffer.get() + num_directions_ * R_ZR_size_per_direction;
+  }
+
+  GemmWeights<uint8_t> W_1(0, W_data, W_size_per_direction, packed_W_, &quant_paras[0]);
+  GemmWeights<uint8_t> R_ZR_1(0, R_ZR_data, R_ZR_size_per_direction, packed_R_ZR_, &quant_paras[1]);
+  GemmWeights<uint8_t> R_H_1(0, R_H_data, R_H_size_per_direction, packed_R_H_, &quant_paras[2]);
+
+  GemmWeights<uint8_t> W_2;
+  GemmWeights<uint8_t> R_ZR_2;
+  GemmWeights<uint8_t> R_H_2;
+  if (direction_ == Direction::kBidirectional) {
+    W_2.Init(1, W_data, W_size_per_direction, packed_W_, &quant_paras[3]);
+    R_ZR_2.Init(1, R_ZR_data, R_ZR_size_per_direction, packed_R_ZR_, &quant_paras[4]);
+    R_H_2.Init(1, R_H_data, R_H_size_per_direction, packed_R_H_, &quant_paras[5]);
+  }
+
+  return GRUBase::ComputeImpl<float, uint8_t>(*context, W_1, W_2, R_ZR_1, R_ZR_2, R_H_1, R_H_2);
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DynamicQuantizeGRU,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()}),
+    DynamicQuantizeGRU);
+
+}  // namespace contrib
+}  // namespace onnxruntime
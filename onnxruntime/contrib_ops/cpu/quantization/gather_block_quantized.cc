@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <type_traits>
 #include <vector>
 #include <unordered_map>
 
@@ -16,6 +18,47 @@
 namespace onnxruntime {
 namespace contrib {
 
+namespace {
+
+// Dequantizes a row of K 4-bit values packed two per byte, low bits first. K is even, as is the block size, so each
+// byte is in one block. The 16 values of a block are dequantized once, and the row is a table lookup per value.
+template <bool is_signed, typename T2, typename GetZeroPoint>
+void DequantizeRow4Bits(const uint8_t* data, const T2* scales, const GetZeroPoint& zero_point,
+                        int64_t K, int64_t block_size, T2* output) {
+  T2 table[16];
+  for (int64_t block = 0, k = 0; k < K; ++block, k += block_size) {
+    const float scale = static_cast<float>(scales[block]);
+    const int32_t zp = zero_point(block);
+    for (int32_t v = 0; v < 16; ++v) {
+      const int32_t q = is_signed ? (v ^ 8) - 8 : v;
+      table[v] = static_cast<T2>(static_cast<float>(q - zp) * scale);
+    }
+
+    const int64_t end = std::min(K, k + block_size);
+    for (int64_t i = k; i < end; i += 2) {
+      const uint8_t packed = data[i >> 1];
+      output[i] = table[packed & 0x0F];
+      output[i + 1] = table[packed >> 4];
+    }
+  }
+}
+
+// Dequantizes a row of K 8-bit values.
+template <typename T2, typename GetZeroPoint>
+void DequantizeRow8Bits(const uint8_t* data, const T2* scales, const GetZeroPoint& zero_point,
+                        int64_t K, int64_t block_size, T2* output) {
+  for (int64_t block = 0, k = 0; k < K; ++block, k += block_size) {
+    const float scale = static_cast<float>(scales[block]);
+    const int32_t zp = zero_point(block);
+    const int64_t end = std::min(K, k + block_size);
+    for (int64_t i = k; i < end; ++i) {
+      output[i] = static_cast<T2>(static_cast<float>(static_cast<int32_t>(data[i]) - zp) * scale);
+    }
+  }
+}
+
+}  // namespace
+
 template <typename T1, typename Tind>
 class GatherBlockQuantized : public OpKernel {
  public:
@@ -34,12 +77,19 @@ class GatherBlockQuantized : public OpKernel {
 
     ORT_ENFORCE(block_size_ >= 16 && ((block_size_ - 1) & block_size_) == 0,
                 "'block_size' must be 2's power and not less than 16.");
+
+    if constexpr (std::is_same_v<T1, uint8_t>) {
+      bits_ = info.GetAttrOrDefault<int64_t>("bits", 4);
+      ORT_ENFORCE(bits_ == 4 || bits_ == 8, "'bits' must be 4 or 8 for uint8 data.");
+    }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  protected:
   struct Prepare {
+    // the shape of the quantized values, whose last dimension is unpacked for uint8 data
+    TensorShape data_shape;
     const Tensor* data_tensor;
     const Tensor* indices_tensor;
     const Tensor* scales_tensor;
@@ -65,10 +115,29 @@ class GatherBlockQuantized : public OpKernel {
                                const int64_t quantize_N,
                                concurrency::ThreadPool* tp) const;
 
+  // Dequantizes the gathered blocks row by row, when they are quantized along the last axis.
+  template <typename T2>
+  Status CopyRowsAndDequantize(const T1* data_ptr,
+                               const Tind* indices_ptr,
+                               const T2* scales_ptr,
+                               const T1* zero_points_ptr,
+                               T2* output_ptr,
+                               const int64_t gather_M,
+                               const int64_t gather_N,
+                               const int64_t gather_axis_dim,
+                               const int64_t gather_block,
+                               const int64_t quantize_axis_dim,
+                               concurrency::ThreadPool* tp) const;
+
+  template <typename T2>
+  Status Dequantize(const Prepare& p, concurrency::ThreadPool* tp) const;
+
  private:
   int64_t gather_axis_;
   int64_t quantize_axis_;
   int64_t block_size_;
+  // bits of the values packed in uint8 data
+  int64_t bits_{4};
 };
 
 template <typename T1, typename Tind>
@@ -78,12 +147,19 @@ Status GatherBlockQuantized<T1, Tind>::PrepareForCompute(OpKernelContext* contex
   p.scales_tensor = context->Input<Tensor>(2);
   p.zero_points_tensor = context->Input<Tensor>(3);
 
-  const auto& data_shape = p.data_tensor->Shape();
+  p.data_shape = p.data_tensor->Shape();
+  const auto& data_shape = p.data_shape;
   const auto& indices_shape = p.indices_tensor->Shape();
   const auto data_rank = data_shape.NumDimensions();
   p.gather_axis = HandleNegativeAxis(gather_axis_, narrow<int64_t>(data_rank));
   p.quantize_axis = HandleNegativeAxis(quantize_axis_, narrow<int64_t>(data_rank));
 
+  if constexpr (std::is_same_v<T1, uint8_t>) {
+    ORT_RETURN_IF_NOT(p.quantize_axis == static_cast<int64_t>(data_rank) - 1 && p.gather_axis != p.quantize_axis,
+                      "uint8 data must be quantized along the last axis and gathered along another one.");
+    p.data_shape[data_rank - 1] = data_shape[data_rank - 1] * 8 / bits_;
+  }
+
   std::vector<int64_t> shape;
   shape.reserve(data_rank - 1 + indices_shape.NumDimensions());
 
@@ -116,7 +192,11 @@ Status GatherBlockQuantized<T1, Tind>::PrepareForCompute(OpKernelContext* contex
     ORT_RETURN_IF_NOT(scales_shape.NumDimensions() == zero_points_shape.NumDimensions(),
                       "scales and zero_points must have the same rank.");
     for (size_t i = 0; i < scales_shape.NumDimensions(); ++i) {
-      ORT_RETURN_IF_NOT(scales_shape[i] == zero_points_shape[i],
+      // uint8 zero points are packed along the last axis
+      const int64_t expected_dim = std::is_same_v<T1, uint8_t> && i == data_rank - 1
+                                       ? (scales_shape[i] * bits_ + 7) / 8
+                                       : scales_shape[i];
+      ORT_RETURN_IF_NOT(zero_points_shape[i] == expected_dim,
                         "scales and zero_points must have the same shape.");
     }
   }
@@ -202,11 +282,111 @@ Status GatherBlockQuantized<T1, Tind>::CopyDataAndDequantize(const T1* data_ptr,
 }
 
 template <typename T1, typename Tind>
-Status GatherBlockQuantized<T1, Tind>::Compute(OpKernelContext* context) const {
-  Prepare p;
-  ORT_RETURN_IF_ERROR(PrepareForCompute(context, p));
+template <typename T2>
+Status GatherBlockQuantized<T1, Tind>::CopyRowsAndDequantize(const T1* data_ptr,
+                                                             const Tind* indices_ptr,
+                                                             const T2* scales_ptr,
+                                                             const T1* zero_points_ptr,
+                                                             T2* output_ptr,
+                                                             const int64_t gather_M,
+                                                             const int64_t gather_N,
+                                                             const int64_t gather_axis_dim,
+                                                             const int64_t gather_block,
+                                                             const int64_t quantize_axis_dim,
+                                                             concurrency::ThreadPool* tp) const {
+  // the data is [num_rows, K] quantized along K, and the gathered blocks are whole rows
+  const int64_t K = quantize_axis_dim;
+  const int64_t num_blocks = (K + block_size_ - 1) / block_size_;
+  const int64_t rows_per_gather_block = gather_block / K;
+  const auto data_full_block = gather_axis_dim * gather_block;
+
+  auto dequantize_row = [&](int64_t row, T2* output) {
+    const T2* row_scales = scales_ptr + row * num_blocks;
+    if constexpr (std::is_same_v<T1, uint8_t>) {
+      const uint8_t* row_data = data_ptr + row * (K * bits_ / 8);
+      const int64_t zero_points_per_row = (num_blocks * bits_ + 7) / 8;
+      const uint8_t* row_zero_points = zero_points_ptr ? zero_points_ptr + row * zero_points_per_row : nullptr;
+      const int32_t default_zero_point = 1 << (bits_ - 1);
+      if (bits_ == 4) {
+        DequantizeRow4Bits<false>(
+            row_data, row_scales,
+            [&](int64_t block) {
+              return row_zero_points ? static_cast<int32_t>((row_zero_points[block >> 1] >> ((block & 1) * 4)) & 0x0F)
+                                     : default_zero_point;
+            },
+            K, block_size_, output);
+      } else {
+        DequantizeRow8Bits(
+            row_data, row_scales,
+            [&](int64_t block) {
+              return row_zero_points ? static_cast<int32_t>(row_zero_points[block]) : default_zero_point;
+            },
+            K, block_size_, output);
+      }
+    } else {
+      // 4-bit data is packed along the flattened tensor, K is even so rows start at a byte
+      const auto* row_data = reinterpret_cast<const uint8_t*>(data_ptr) + row * K / 2;
+      DequantizeRow4Bits<std::is_same_v<T1, Int4x2>>(
+          row_data, row_scales,
+          [&](int64_t block) {
+            const int64_t zp_idx = row * num_blocks + block;
+            return zero_points_ptr
+                       ? static_cast<int32_t>(zero_points_ptr[zp_idx >> 1].GetElem(narrow<size_t>(zp_idx & 1)))
+                       : 0;
+          },
+          K, block_size_, output);
+    }
+  };
 
-  const auto& data_shape = p.data_tensor->Shape();
+  auto lambda = [&](int64_t gather_MN_idx, std::unordered_map<int64_t, int64_t>& cache) {
+    int64_t gather_M_idx = gather_MN_idx / gather_N;
+    int64_t gather_N_idx = gather_MN_idx % gather_N;
+
+    int64_t indices_val = static_cast<int64_t>(indices_ptr[gather_N_idx]);
+    ORT_ENFORCE(indices_val >= -gather_axis_dim && indices_val < gather_axis_dim,
+                "indices element out of data bounds, idx=", indices_val,
+                " must be within the inclusive range [", -gather_axis_dim, ",", gather_axis_dim - 1, "]");
+
+    indices_val = indices_val < 0 ? indices_val + gather_axis_dim : indices_val;
+    int64_t output_idx_base = gather_MN_idx * gather_block;
+    int64_t data_idx_base = gather_M_idx * data_full_block + indices_val * gather_block;
+
+    if (auto it = cache.find(data_idx_base); it != cache.end()) {
+      int64_t output_src_idx = it->second;
+      memcpy(output_ptr + output_idx_base, output_ptr + output_src_idx, narrow<size_t>(gather_block * sizeof(T2)));
+      return;
+    }
+
+    const int64_t first_row = data_idx_base / K;
+    for (int64_t r = 0; r < rows_per_gather_block; ++r) {
+      dequantize_row(first_row + r, output_ptr + output_idx_base + r * K);
+    }
+
+    cache[data_idx_base] = output_idx_base;
+  };
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp,
+      SafeInt<ptrdiff_t>(gather_M) * gather_N,
+      static_cast<double>(gather_block * 2),
+      [&lambda](ptrdiff_t first, ptrdiff_t last) {
+        // cache dequantized gather_block. Key is data_idx_base. Value is the output_idx_base.
+        std::unordered_map<int64_t, int64_t> cache;
+
+        for (auto index = static_cast<int64_t>(first), end = static_cast<int64_t>(last);
+             index < end;
+             ++index) {
+          lambda(index, cache);
+        }
+      });
+
+  return Status::OK();
+}
+
+template <typename T1, typename Tind>
+template <typename T2>
+Status GatherBlockQuantized<T1, Tind>::Dequantize(const Prepare& p, concurrency::ThreadPool* tp) const {
+  const auto& data_shape = p.data_shape;
   // re-shape the data tensor to [gather_M, gather_axis_dim, gather_block]
   // re-shape the indices tensor to [gather_N]
   // re-shape the output tensor to [gather_M, gather_N, gather_block]
@@ -232,28 +412,46 @@ Status GatherBlockQuantized<T1, Tind>::Compute(OpKernelContext* context) const {
   const int64_t quantize_axis_dim = data_shape[narrow<size_t>(p.quantize_axis)];
   const int64_t quantize_N = data_shape.SizeFromDimension(SafeInt<size_t>(p.quantize_axis) + 1);
 
-  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
   const auto* data_ptr = p.data_tensor->template Data<T1>();
   const auto* indices_ptr = p.indices_tensor->template Data<Tind>();
   const auto* zero_points_ptr = p.zero_points_tensor ? p.zero_points_tensor->template Data<T1>() : nullptr;
+  const auto* scales_ptr = p.scales_tensor->template Data<T2>();
+  auto* output_ptr = p.output_tensor->template MutableData<T2>();
+
+  // Gathering along an axis before the last one, which is quantized, picks whole rows of blocks. 4-bit rows must
+  // start at a byte. uint8 data is always quantized along the last axis.
+  const bool quantized_rows = p.quantize_axis == static_cast<int64_t>(data_shape.NumDimensions()) - 1 &&
+                              p.gather_axis < p.quantize_axis &&
+                              (std::is_same_v<T1, uint8_t> || quantize_axis_dim % 2 == 0);
+  if (quantized_rows) {
+    return CopyRowsAndDequantize<T2>(data_ptr, indices_ptr, scales_ptr, zero_points_ptr,
+                                     output_ptr, gather_M, gather_N, gather_axis_dim, gather_block,
+                                     quantize_axis_dim, tp);
+  }
+
+  if constexpr (!std::is_same_v<T1, uint8_t>) {
+    return CopyDataAndDequantize<T2>(data_ptr, indices_ptr, scales_ptr, zero_points_ptr,
+                                     output_ptr, gather_M, gather_N, gather_axis_dim, gather_block,
+                                     quantize_axis_dim, quantize_N,
+                                     tp);
+  } else {
+    ORT_UNUSED_PARAMETER(quantize_N);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "uint8 data must be quantized along the last axis.");
+  }
+}
+
+template <typename T1, typename Tind>
+Status GatherBlockQuantized<T1, Tind>::Compute(OpKernelContext* context) const {
+  Prepare p;
+  ORT_RETURN_IF_ERROR(PrepareForCompute(context, p));
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
   const auto dequantized_type = p.scales_tensor->GetElementType();
 
   if (dequantized_type == ONNX_NAMESPACE::TensorProto::FLOAT) {
-    const auto* scales_ptr = p.scales_tensor->template Data<float>();
-    auto* output_ptr = p.output_tensor->template MutableData<float>();
-
-    return CopyDataAndDequantize<float>(data_ptr, indices_ptr, scales_ptr, zero_points_ptr,
-                                        output_ptr, gather_M, gather_N, gather_axis_dim, gather_block,
-                                        quantize_axis_dim, quantize_N,
-                                        tp);
+    return Dequantize<float>(p, tp);
   } else if (dequantized_type == ONNX_NAMESPACE::TensorProto::FLOAT16) {
-    const auto* scales_ptr = p.scales_tensor->template Data<MLFloat16>();
-    auto* output_ptr = p.output_tensor->template MutableData<MLFloat16>();
-
-    return CopyDataAndDequantize<MLFloat16>(data_ptr, indices_ptr, scales_ptr, zero_points_ptr,
-                                            output_ptr, gather_M, gather_N, gather_axis_dim, gather_block,
-                                            quantize_axis_dim, quantize_N,
-                                            tp);
+    return Dequantize<MLFloat16>(p, tp);
   } else if (dequantized_type == ONNX_NAMESPACE::TensorProto::BFLOAT16) {
     ORT_THROW("DequantizeLinear into BFLOAT16 is not implemented yet.");
   } else {
@@ -277,6 +475,8 @@ REGISTER_GATHERBLOCKQUANTIZED(UInt4x2, int32_t);
 REGISTER_GATHERBLOCKQUANTIZED(UInt4x2, int64_t);
 REGISTER_GATHERBLOCKQUANTIZED(Int4x2, int32_t);
 REGISTER_GATHERBLOCKQUANTIZED(Int4x2, int64_t);
+REGISTER_GATHERBLOCKQUANTIZED(uint8_t, int32_t);
+REGISTER_GATHERBLOCKQUANTIZED(uint8_t, int64_t);
 
 }  // namespace contrib
 }  // namespace onnxruntime
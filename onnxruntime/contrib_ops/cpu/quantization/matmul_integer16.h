@@ -16,7 +16,21 @@ class MatMulInteger16 final : public OpKernel {
   MatMulInteger16(const OpKernelInfo& info) : OpKernel(info) {
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // A constant B is stored transposed, as [batch, N, K], so that every output is the dot product of two contiguous
+  // rows.
+  BufferUniquePtr packed_b_;
+  TensorShape b_shape_;
 };
 }  // namespace contrib
 }  // namespace onnxruntime
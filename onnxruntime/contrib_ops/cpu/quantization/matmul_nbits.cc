@@ -4,6 +4,7 @@
 #include "contrib_ops/cpu/quantization/matmul_nbits_impl.h"
 
 #include <cstdint>
+#include <mutex>
 #include <type_traits>
 
 #include "core/common/common.h"
@@ -111,8 +112,8 @@ class MatMulNBits final : public OpKernel {
       has_unquantized_zero_point_ = type != ONNX_NAMESPACE::TensorProto_DataType_UINT8;
     }
 
-    ORT_ENFORCE(nbits_ == 4,
-                "Only 4b quantization is supported for MatMulNBits op, additional bits support is planned.");
+    ORT_ENFORCE(nbits_ == 2 || nbits_ == 3 || nbits_ == 4,
+                "Only 2b, 3b and 4b quantization is supported for MatMulNBits op, additional bits support is planned.");
     const Tensor* tensor_zero_point = nullptr;
     has_zp_input_ = info.TryGetConstantInput(InputIndex::zero_points, &tensor_zero_point);
   }
@@ -136,13 +137,22 @@ class MatMulNBits final : public OpKernel {
   const MLAS_QNBIT_GEMM_COMPUTE_TYPE compute_type_;
   bool has_unquantized_zero_point_{false};
   const bool column_wise_quant_{true};
-  IAllocatorUniquePtr<void> packed_b_{};
+  // Mutable so that the first run can move it to the NUMA nodes reading it. See PlacePackedBOnNumaNodes().
+  mutable IAllocatorUniquePtr<void> packed_b_{};
   size_t packed_b_size_{0};
+  AllocatorPtr packed_b_allocator_{};
+  bool packed_b_shared_{false};
+  mutable std::once_flag packed_b_placement_once_;
   IAllocatorUniquePtr<float> scales_fp32_{};
   IAllocatorUniquePtr<float> bias_fp32_{};
 
   bool has_zp_input_{false};
 
+  // When the intra-op thread pool is partitioned by NUMA node, copies packed B, the first time the kernel runs, to a
+  // new buffer whose pages are first written by the threads that compute the corresponding columns of the output.
+  // The threads of each node then stream their slice of the weights from local memory.
+  void PlacePackedBOnNumaNodes(concurrency::ThreadPool* thread_pool) const;
+
   // dequantize B first and then compute float gemm
   Status ComputeBUnpacked(const Tensor* a,
                           const Tensor* b,
@@ -187,6 +197,7 @@ Status MatMulNBits<T1>::PrePack(const Tensor& tensor, int input_idx, /*out*/ All
     }
     auto qptr = tensor.DataRaw();
     packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size_, true);
+    packed_b_allocator_ = alloc;
     MlasQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type_, qptr, packed_b_.get(), nullptr, has_zp_input_, nullptr, nullptr);
     is_packed = true;
   } else if (compute_type_ == SQNBIT_CompInt8) {
@@ -242,6 +253,7 @@ Status MatMulNBits<MLFloat16>::PrePack(const Tensor& tensor, int input_idx, /*ou
     }
     auto qptr = tensor.DataRaw();
     packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size_, true);
+    packed_b_allocator_ = alloc;
     MlasQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type_, qptr, packed_b_.get(),
                                 nullptr, has_zp_input_, nullptr, nullptr);
     is_packed = true;
@@ -272,11 +284,28 @@ Status MatMulNBits<T1>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>&
   if (input_idx == 1) {
     used_shared_buffers = true;
     packed_b_ = std::move(prepacked_buffers[0]);
+    packed_b_shared_ = true;
   }
 
   return Status::OK();
 }
 
+template <typename T1>
+void MatMulNBits<T1>::PlacePackedBOnNumaNodes(concurrency::ThreadPool* thread_pool) const {
+  // A buffer shared with other kernels stays where it is.
+  if (packed_b_shared_ || packed_b_allocator_ == nullptr ||
+      concurrency::ThreadPool::NumNumaNodes(thread_pool) <= 1) {
+    return;
+  }
+
+  std::call_once(packed_b_placement_once_, [&]() {
+    auto placed_b = IAllocator::MakeUniquePtr<void>(packed_b_allocator_, packed_b_size_, true);
+    MlasQNBitGemmCopyPackedQuantBData(N_, K_, nbits_, block_size_, compute_type_, packed_b_.get(), placed_b.get(),
+                                      thread_pool);
+    packed_b_ = std::move(placed_b);
+  });
+}
+
 template <typename T1>
 Status MatMulNBits<T1>::ComputeBPacked(const Tensor* a,
                                        const Tensor* scales,
@@ -435,7 +464,20 @@ Status MatMulNBits<float>::ComputeBUnpacked(const Tensor* a,
   // TODO(fajin): move B dequant to prepack
   auto tmp_b_data_ptr = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(K_) * N_, true);
 
-  if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<float>())) {
+  if (nbits_ != 4) {
+    ORT_ENFORCE(column_wise_quant_, "Row-wise quantization is not supported for now");
+    if (zero_points && zero_points->IsDataType<float>()) {
+      DequantizeBlockwiseNBits<float, float>(
+          tmp_b_data_ptr.get(), b_data, scales_data, static_cast<const float*>(zero_points_data), reorder_idx_data,
+          static_cast<int32_t>(nbits_), static_cast<int32_t>(block_size_),
+          static_cast<int32_t>(K_), static_cast<int32_t>(N_), thread_pool);
+    } else {
+      DequantizeBlockwiseNBits<float, uint8_t>(
+          tmp_b_data_ptr.get(), b_data, scales_data, static_cast<const uint8_t*>(zero_points_data), reorder_idx_data,
+          static_cast<int32_t>(nbits_), static_cast<int32_t>(block_size_),
+          static_cast<int32_t>(K_), static_cast<int32_t>(N_), thread_pool);
+    }
+  } else if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<float>())) {
     // dequantize b, only 4b quantization is supported for now
     MlasDequantizeBlockwise<float, 4>(
         tmp_b_data_ptr.get(),                           // dequantized output
@@ -554,7 +596,20 @@ Status MatMulNBits<MLFloat16>::ComputeBUnpacked(const Tensor* a,
   // TODO(fajin): move B dequant to prepack
   auto tmp_b_data_ptr = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(K_) * N_, true);
 
-  if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<MLFloat16>())) {
+  if (nbits_ != 4) {
+    ORT_ENFORCE(column_wise_quant_, "Row-wise quantization is not supported for now");
+    if (zero_points && zero_points->IsDataType<MLFloat16>()) {
+      DequantizeBlockwiseNBits<float, MLFloat16>(
+          tmp_b_data_ptr.get(), b_data, scales_ptr, static_cast<const MLFloat16*>(zero_points_data), reorder_idx_data,
+          static_cast<int32_t>(nbits_), static_cast<int32_t>(block_size_),
+          static_cast<int32_t>(K_), static_cast<int32_t>(N_), thread_pool);
+    } else {
+      DequantizeBlockwiseNBits<float, uint8_t>(
+          tmp_b_data_ptr.get(), b_data, scales_ptr, static_cast<const uint8_t*>(zero_points_data), reorder_idx_data,
+          static_cast<int32_t>(nbits_), static_cast<int32_t>(block_size_),
+          static_cast<int32_t>(K_), static_cast<int32_t>(N_), thread_pool);
+    }
+  } else if ((reorder_idx_data == nullptr) && (!zero_points || !zero_points->IsDataType<MLFloat16>())) {
     // dequantize b, only 4b quantization is supported for now
     MlasDequantizeBlockwise<float, 4>(
         tmp_b_data_ptr.get(),                           // dequantized output
@@ -685,6 +740,7 @@ Status MatMulNBits<T1>::Compute(OpKernelContext* ctx) const {
                     // MlasQNBitGemmPackQuantBDataSize() returns 0, we can consider calling MlasQNBitGemmBatch()
                     // with B directly too.
     if (MlasIsQNBitGemmAvailable(nbits_, block_size_, compute_type_)) {
+      PlacePackedBOnNumaNodes(thread_pool);
       return ComputeBPacked(a, scales, zero_points, bias, y, allocator, thread_pool, helper);
     }
   }
@@ -117,5 +117,79 @@ template void DequantizeBlockwise<float, MLFloat16>(
     const MLFloat16* zero_points, const int32_t* reorder_idx, int32_t block_size,
     bool columnwise, int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
 
+namespace {
+
+// the nbits value at index i of a little endian bit stream
+inline uint32_t GetBitStreamValue(const uint8_t* data, int64_t i, int32_t nbits) {
+  const int64_t bit_offset = i * nbits;
+  const uint8_t* src = data + bit_offset / 8;
+  const int32_t shift = static_cast<int32_t>(bit_offset % 8);
+  uint32_t bits = src[0];
+  if (shift + nbits > 8) {
+    bits |= static_cast<uint32_t>(src[1]) << 8;
+  }
+  return (bits >> shift) & ((1u << nbits) - 1);
+}
+
+}  // namespace
+
+template <typename inputT, typename zeroT>
+void DequantizeBlockwiseNBits(
+    inputT* output,
+    const uint8_t* quant_data,
+    const inputT* scales_data,
+    const zeroT* zero_points,
+    const int32_t* reorder_idx,
+    int32_t nbits,
+    int32_t block_size,
+    int32_t K,
+    int32_t N,
+    onnxruntime::concurrency::ThreadPool* pool) {
+  const int64_t blocks_per_col = (K + block_size - 1) / block_size;
+  const int64_t blob_size = (static_cast<int64_t>(block_size) * nbits + 7) / 8;
+  const int64_t zp_bytes_per_col = (blocks_per_col * nbits + 7) / 8;
+  const float default_zp = static_cast<float>(1 << (nbits - 1));
+
+  concurrency::ThreadPool::TryParallelFor(
+      pool, static_cast<std::ptrdiff_t>(N),
+      TensorOpCost{static_cast<double>(K) * nbits / 8, static_cast<double>(K) * sizeof(inputT),
+                   static_cast<double>(K) * 4},
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t n = begin; n < end; ++n) {
+          const uint8_t* col_data = quant_data + n * blocks_per_col * blob_size;
+          const inputT* col_scales = scales_data + n * blocks_per_col;
+          inputT* col_output = output + n * K;
+          for (int32_t k = 0; k < K; ++k) {
+            const int64_t blk = reorder_idx ? reorder_idx[k] : k / block_size;
+            float zp = default_zp;
+            if (zero_points) {
+              if constexpr (std::is_same_v<zeroT, uint8_t>) {
+                zp = static_cast<float>(GetBitStreamValue(zero_points + n * zp_bytes_per_col, blk, nbits));
+              } else {
+                zp = static_cast<float>(zero_points[n * blocks_per_col + blk]);
+              }
+            }
+            const uint32_t q = GetBitStreamValue(col_data + (k / block_size) * blob_size, k % block_size, nbits);
+            col_output[k] = static_cast<inputT>((static_cast<float>(q) - zp) * static_cast<float>(col_scales[blk]));
+          }
+        }
+      });
+}
+
+template void DequantizeBlockwiseNBits<float, uint8_t>(
+    float* output, const uint8_t* quant_data, const float* scales_data,
+    const uint8_t* zero_points, const int32_t* reorder_idx, int32_t nbits, int32_t block_size,
+    int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
+
+template void DequantizeBlockwiseNBits<float, float>(
+    float* output, const uint8_t* quant_data, const float* scales_data,
+    const float* zero_points, const int32_t* reorder_idx, int32_t nbits, int32_t block_size,
+    int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
+
+template void DequantizeBlockwiseNBits<float, MLFloat16>(
+    float* output, const uint8_t* quant_data, const float* scales_data,
+    const MLFloat16* zero_points, const int32_t* reorder_idx, int32_t nbits, int32_t block_size,
+    int32_t K, int32_t N, onnxruntime::concurrency::ThreadPool* thread_pool);
+
 }  // namespace contrib
 }  // namespace onnxruntime
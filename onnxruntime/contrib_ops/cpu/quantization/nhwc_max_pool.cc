@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/pool_attributes.h"
@@ -11,7 +13,32 @@
 namespace onnxruntime {
 namespace contrib {
 
-template <typename T8Bits>
+namespace {
+
+template <typename T>
+void MaximumPool(const T* const* input, T* output, size_t channels, size_t output_count, size_t kernel_size) {
+  MlasMaximumPool(input, output, channels, output_count, kernel_size);
+}
+
+// MLAS only implements the 8-bit channels last maximum pool.
+template <>
+void MaximumPool(const float* const* input, float* output, size_t channels, size_t output_count, size_t kernel_size) {
+  for (size_t i = 0; i < output_count; i++) {
+    std::copy_n(input[0], channels, output);
+    for (size_t k = 1; k < kernel_size; k++) {
+      const float* x = input[k];
+      for (size_t c = 0; c < channels; c++) {
+        output[c] = std::max(output[c], x[c]);
+      }
+    }
+    input += kernel_size;
+    output += channels;
+  }
+}
+
+}  // namespace
+
+template <typename T>
 class NhwcMaxPool : public OpKernel {
  public:
   explicit NhwcMaxPool(const OpKernelInfo& info) : OpKernel(info),
@@ -24,8 +51,8 @@ class NhwcMaxPool : public OpKernel {
   PoolAttributes pool_attrs_;
 };
 
-template <typename T8Bits>
-Status NhwcMaxPool<T8Bits>::Compute(OpKernelContext* context) const {
+template <typename T>
+Status NhwcMaxPool<T>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
   const TensorShape& input_shape = X->Shape();
 
@@ -75,17 +102,17 @@ Status NhwcMaxPool<T8Bits>::Compute(OpKernelContext* context) const {
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
   int64_t col_buffer_batch_count = std::min(output_image_size, output_batch_count);
-  auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(const T8Bits*)) * kernel_size * col_buffer_batch_count);
+  auto* col_data = alloc->Alloc(SafeInt<size_t>(sizeof(const T*)) * kernel_size * col_buffer_batch_count);
   BufferUniquePtr col_buffer(col_data, BufferDeleter(std::move(alloc)));
-  std::vector<T8Bits> padding_data(static_cast<size_t>(C), std::numeric_limits<T8Bits>::lowest());
+  std::vector<T> padding_data(static_cast<size_t>(C), std::numeric_limits<T>::lowest());
 
-  const auto* Xdata = X->Data<T8Bits>();
-  auto* Ydata = Y->MutableData<T8Bits>();
+  const auto* Xdata = X->Data<T>();
+  auto* Ydata = Y->MutableData<T>();
 
   for (int64_t image_id = 0; image_id < N; ++image_id) {
     for (int64_t output_start = 0; output_start < output_image_size;) {
       int64_t output_count = std::min(output_image_size - output_start, output_batch_count);
-      math::Im2col<T8Bits, StorageOrder::NHWC>()(
+      math::Im2col<T, StorageOrder::NHWC>()(
           Xdata,
           C,
           input_shape.GetDims().data() + 1,
@@ -97,10 +124,10 @@ Status NhwcMaxPool<T8Bits>::Compute(OpKernelContext* context) const {
           static_cast<ptrdiff_t>(spatial_dims),
           output_start,
           output_count,
-          static_cast<T8Bits const**>(col_buffer.get()),
+          static_cast<T const**>(col_buffer.get()),
           padding_data.data());
-      MlasMaximumPool(
-          static_cast<T8Bits const**>(col_buffer.get()),
+      MaximumPool(
+          static_cast<T const**>(col_buffer.get()),
           Ydata,
           static_cast<size_t>(C),
           static_cast<size_t>(output_count),
@@ -129,6 +156,7 @@ Status NhwcMaxPool<T8Bits>::Compute(OpKernelContext* context) const {
 
 REGISTER_NHWCMAXPOOL_TYPED_KERNEL(int8_t);
 REGISTER_NHWCMAXPOOL_TYPED_KERNEL(uint8_t);
+REGISTER_NHWCMAXPOOL_TYPED_KERNEL(float);
 
 }  // namespace contrib
 }  // namespace onnxruntime
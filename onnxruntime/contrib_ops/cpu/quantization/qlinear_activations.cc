@@ -4,6 +4,9 @@
 #include "qlinear_activations.h"
 #include "qlinear_lookup_table.h"
 
+#include <cmath>
+#include <string>
+
 #include "core/common/narrow.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
@@ -97,6 +100,37 @@ Status QLinearSigmoid<T>::Compute(OpKernelContext* context) const {
   });
 }
 
+namespace {
+float ComputeGelu(float v, bool approximate_tanh) {
+  if (approximate_tanh) {
+    constexpr float B = 0.7978845608028654f;    // sqrt(2.0 / M_PI)
+    constexpr float C = 0.035677408136300125f;  // 0.044715 * sqrt(2.0 / M_PI)
+    return 0.5f * v * (1.0f + std::tanh(v * (C * v * v + B)));
+  }
+  constexpr float kSqrt1_2 = 0.7071067811865476f;  // 1 / sqrt(2.0)
+  return 0.5f * v * (1.0f + std::erf(v * kSqrt1_2));
+}
+}  // namespace
+
+template <typename T>
+QLinearGelu<T>::QLinearGelu(const OpKernelInfo& info)
+    : QLinearLookupBase<T>(info) {
+  const std::string approximate = info.GetAttrOrDefault<std::string>("approximate", "none");
+  ORT_ENFORCE(approximate == "none" || approximate == "tanh",
+              "approximate attribute must be \"none\" or \"tanh\", got ", approximate);
+  approximate_tanh_ = approximate == "tanh";
+  this->BuildLookupTableIfFixed(info, [this](float v) -> float {
+    return ComputeGelu(v, approximate_tanh_);
+  });
+}
+
+template <typename T>
+Status QLinearGelu<T>::Compute(OpKernelContext* context) const {
+  return this->ComputeBase(context, [this](float v) -> float {
+    return ComputeGelu(v, approximate_tanh_);
+  });
+}
+
 #define REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(op_name, version, data_type, KERNEL_CLASS) \
   ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(                                                         \
       op_name, version, data_type,                                                           \
@@ -108,6 +142,8 @@ REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearLeakyRelu, 1, int8_t, QLinearLe
 REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearLeakyRelu, 1, uint8_t, QLinearLeakyRelu);
 REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearSigmoid, 1, int8_t, QLinearSigmoid);
 REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearSigmoid, 1, uint8_t, QLinearSigmoid);
+REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearGelu, 1, int8_t, QLinearGelu);
+REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearGelu, 1, uint8_t, QLinearGelu);
 
 }  // namespace contrib
 }  // namespace onnxruntime
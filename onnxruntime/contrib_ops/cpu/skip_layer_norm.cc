@@ -39,7 +39,8 @@ REGISTER_KERNEL_TYPED(MLFloat16)
 
 namespace {
 
-template <typename T, typename = std::enable_if_t<std::is_same_v<T, float> || std::is_same_v<T, double>, void>>
+// Used for double, for which there is no MLAS kernel.
+template <typename T>
 void ComputeJob(
     const T* input_data,
     const T* skip_data,
@@ -161,90 +162,58 @@ Status SkipLayerNorm<T, simplified>::Compute(OpKernelContext* p_ctx) const {
   T* skip_input_bias_add_output_data = skip_input_bias_add_output == nullptr ? nullptr : skip_input_bias_add_output->MutableData<T>();
   const int64_t skip_size = skip ? skip->Shape().Size() : prepacked_skip_fp32_size_;
 
-  if constexpr (std::is_same_v<T, MLFloat16>) {
-    const size_t total_data_size = static_cast<size_t>(input->Shape().Size());
-
-    AllocatorPtr alloc;
-    ORT_RETURN_IF_ERROR(p_ctx->GetTempSpaceAllocator(&alloc));
-
-    IAllocatorUniquePtr<float> input_fp32;
-    IAllocatorUniquePtr<float> output_fp32;
-    IAllocatorUniquePtr<float> skip_input_bias_add_output_fp32;
-    IAllocatorUniquePtr<float> skip_fp32;
-    IAllocatorUniquePtr<float> gamma_fp32;
-    IAllocatorUniquePtr<float> beta_fp32;
-    IAllocatorUniquePtr<float> bias_fp32;
-
-    const float* input_data_f = nullptr;
+  if constexpr (std::is_same_v<T, double>) {
+    concurrency::ThreadPool::TryBatchParallelFor(
+        p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
+        [&](ptrdiff_t task_idx) {
+          ComputeJob(input_data, skip_data, gamma_data, beta_data, bias_data, task_idx, hidden_size, skip_size,
+                     epsilon_, simplified, output_data, skip_input_bias_add_output_data);
+        },
+        0);
+  } else {
     const float* skip_data_f = nullptr;
     const float* gamma_data_f = nullptr;
     const float* beta_data_f = nullptr;
     const float* bias_data_f = nullptr;
-    float* output_data_f = nullptr;
-    float* skip_input_bias_add_output_data_f = nullptr;
-
-    const size_t num_elems = static_cast<size_t>(hidden_size);
-
-    input_fp32 = IAllocator::MakeUniquePtr<float>(alloc, total_data_size);
-    MlasConvertHalfToFloatBuffer(input_data, input_fp32.get(), total_data_size);
-    input_data_f = input_fp32.get();
-
-    output_fp32 = IAllocator::MakeUniquePtr<float>(alloc, total_data_size);
-    output_data_f = output_fp32.get();
-
-    skip_input_bias_add_output_fp32 = IAllocator::MakeUniquePtr<float>(alloc, total_data_size);
-    skip_input_bias_add_output_data_f = skip_input_bias_add_output_fp32.get();
-
-    if (skip_data) {
-      skip_fp32 = IAllocator::MakeUniquePtr<float>(alloc, static_cast<size_t>(skip_size));
-      MlasConvertHalfToFloatBuffer(skip_data, skip_fp32.get(), static_cast<size_t>(skip_size));
-      skip_data_f = skip_fp32.get();
-    } else if (prepacked_skip_fp32_data_) {
-      skip_data_f = prepacked_skip_fp32_data_.get();
-    }
 
-    if (gamma_data) {
-      gamma_fp32 = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-      MlasConvertHalfToFloatBuffer(gamma_data, gamma_fp32.get(), num_elems);
-      gamma_data_f = gamma_fp32.get();
-    } else if (prepacked_gamma_fp32_data_) {
-      gamma_data_f = prepacked_gamma_fp32_data_.get();
-    }
-
-    if (beta_data) {
-      beta_fp32 = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-      MlasConvertHalfToFloatBuffer(beta_data, beta_fp32.get(), num_elems);
-      beta_data_f = beta_fp32.get();
-    } else if (prepacked_beta_fp32_data_) {
-      beta_data_f = prepacked_beta_fp32_data_.get();
-    }
+    IAllocatorUniquePtr<float> skip_fp32;
+    IAllocatorUniquePtr<float> gamma_fp32;
+    IAllocatorUniquePtr<float> beta_fp32;
+    IAllocatorUniquePtr<float> bias_fp32;
 
-    if (bias_data) {
-      bias_fp32 = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-      MlasConvertHalfToFloatBuffer(bias_data, bias_fp32.get(), num_elems);
-      bias_data_f = bias_fp32.get();
-    } else if (prepacked_bias_fp32_data_) {
-      bias_data_f = prepacked_bias_fp32_data_.get();
+    if constexpr (std::is_same_v<T, MLFloat16>) {
+      // The MLAS kernel reads the input and writes the outputs in half precision, but takes the skip, gamma, beta
+      // and bias in single precision.
+      AllocatorPtr alloc;
+      ORT_RETURN_IF_ERROR(p_ctx->GetTempSpaceAllocator(&alloc));
+
+      const size_t num_elems = static_cast<size_t>(hidden_size);
+
+      auto convert = [&alloc](const MLFloat16* src, const IAllocatorUniquePtr<float>& prepacked, size_t count,
+                              IAllocatorUniquePtr<float>& dest) -> const float* {
+        if (src != nullptr) {
+          dest = IAllocator::MakeUniquePtr<float>(alloc, count);
+          MlasConvertHalfToFloatBuffer(src, dest.get(), count);
+          return dest.get();
+        }
+        return prepacked.get();
+      };
+
+      skip_data_f = convert(skip_data, prepacked_skip_fp32_data_, static_cast<size_t>(skip_size), skip_fp32);
+      gamma_data_f = convert(gamma_data, prepacked_gamma_fp32_data_, num_elems, gamma_fp32);
+      beta_data_f = convert(beta_data, prepacked_beta_fp32_data_, num_elems, beta_fp32);
+      bias_data_f = convert(bias_data, prepacked_bias_fp32_data_, num_elems, bias_fp32);
+    } else {
+      skip_data_f = skip_data;
+      gamma_data_f = gamma_data;
+      beta_data_f = beta_data;
+      bias_data_f = bias_data;
     }
 
-    concurrency::ThreadPool::TryBatchParallelFor(
-        p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
-        [&](ptrdiff_t task_idx) {
-          ComputeJob(input_data_f, skip_data_f, gamma_data_f, beta_data_f, bias_data_f, task_idx, hidden_size, skip_size,
-                     epsilon_, simplified, output_data_f, skip_input_bias_add_output_data_f);
-        },
-        0);
-    MlasConvertFloatToHalfBuffer(output_data_f, output_data, total_data_size);
-    if (skip_input_bias_add_output_data != nullptr)
-      MlasConvertFloatToHalfBuffer(skip_input_bias_add_output_data_f, skip_input_bias_add_output_data, total_data_size);
-  } else {
-    concurrency::ThreadPool::TryBatchParallelFor(
-        p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
-        [&](ptrdiff_t task_idx) {
-          ComputeJob(input_data, skip_data, gamma_data, beta_data, bias_data, task_idx, hidden_size, skip_size,
-                     epsilon_, simplified, output_data, skip_input_bias_add_output_data);
-        },
-        0);
+    MlasSkipLayerNorm(input_data, skip_data_f, static_cast<size_t>(skip_size), bias_data_f, gamma_data_f,
+                      beta_data_f, output_data, skip_input_bias_add_output_data,
+                      static_cast<size_t>(task_count), static_cast<size_t>(hidden_size), epsilon_, simplified,
+                      p_ctx->GetOperatorThreadPool());
   }
 
   return Status::OK();
@@ -92,6 +92,13 @@ class BeamSearchGpt : public BeamSearchBase<T> {
       int input_sequence_len,
       bool need_cache_indir);
 
+  // Create the inputs of the first run for one beam of each batch entry, from those for all the beams.
+  void CreatePromptFeeds(const std::vector<OrtValue>& feeds, std::vector<OrtValue>& prompt_feeds);
+
+  // Expand a present output of the first run from (2, batch_size, num_heads, sequence_length, head_size)
+  // to (2, batch_size * num_beams, num_heads, sequence_length, head_size).
+  OrtValue ExpandPresentState(const OrtValue& present);
+
   const SessionState* init_run_decoder_session_state_ = nullptr;
   GptSubgraph* init_run_gpt_subgraph_ = nullptr;
   GptSubgraph& gpt_subgraph_;
@@ -185,6 +192,67 @@ Status BeamSearchGpt<T>::UpdateFeeds(
                             need_cache_indir);
 }
 
+template <typename T>
+void BeamSearchGpt<T>::CreatePromptFeeds(const std::vector<OrtValue>& feeds, std::vector<OrtValue>& prompt_feeds) {
+  const int batch_size = this->parameters_->batch_size;
+  const int num_beams = this->parameters_->num_beams;
+  prompt_feeds = feeds;
+
+  // input_ids, position_ids and attention_mask have shape (batch_size * num_beams, sequence_length)
+  for (size_t i = 0; i < 3; i++) {
+    const Tensor& input = feeds[i].Get<Tensor>();
+    const int64_t sequence_length = input.Shape()[1];
+    OrtValue prompt_input;
+    Tensor::InitOrtValue(input.DataType(), TensorShape{batch_size, sequence_length}, this->temp_space_allocator_,
+                         prompt_input);
+    gsl::span<const int32_t> source = input.DataAsSpan<int32_t>();
+    gsl::span<int32_t> target = prompt_input.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>();
+    for (int b = 0; b < batch_size; b++) {
+      gsl::copy(source.subspan(SafeInt<size_t>(b) * num_beams * sequence_length, static_cast<size_t>(sequence_length)),
+                target.subspan(SafeInt<size_t>(b) * sequence_length, static_cast<size_t>(sequence_length)));
+    }
+    prompt_feeds[i] = prompt_input;
+  }
+
+  // empty past state of shape (2, batch_size, num_heads, 0, head_size)
+  const int first_past_input_index = gpt_subgraph_.GetFirstPastInputIndex();
+  const Tensor& past = feeds[first_past_input_index].Get<Tensor>();
+  const TensorShape& past_shape = past.Shape();
+  OrtValue empty_past;
+  Tensor::InitOrtValue(past.DataType(), TensorShape{past_shape[0], batch_size, past_shape[2], 0, past_shape[4]},
+                       this->temp_space_allocator_, empty_past);
+  for (int i = 0; i < gpt_subgraph_.num_layers; i++) {
+    prompt_feeds[SafeInt<size_t>(first_past_input_index) + i] = empty_past;
+  }
+}
+
+template <typename T>
+OrtValue BeamSearchGpt<T>::ExpandPresentState(const OrtValue& present) {
+  const int num_beams = this->parameters_->num_beams;
+  const Tensor& present_tensor = present.Get<Tensor>();
+  const TensorShape& present_shape = present_tensor.Shape();
+
+  OrtValue expanded;
+  Tensor::InitOrtValue(present_tensor.DataType(),
+                       TensorShape{present_shape[0], present_shape[1] * num_beams, present_shape[2], present_shape[3],
+                                   present_shape[4]},
+                       this->temp_space_allocator_, expanded);
+
+  // each (num_heads, sequence_length, head_size) block of the key and value is copied for every beam
+  const size_t block_size = SafeInt<size_t>(present_shape[2]) * present_shape[3] * present_shape[4];
+  const size_t num_blocks = SafeInt<size_t>(present_shape[0]) * present_shape[1];
+  const T* source = present_tensor.Data<T>();
+  T* target = expanded.GetMutable<Tensor>()->MutableData<T>();
+  for (size_t i = 0; i < num_blocks; i++) {
+    for (int j = 0; j < num_beams; j++) {
+      std::copy_n(source, block_size, target);
+      target += block_size;
+    }
+    source += block_size;
+  }
+  return expanded;
+}
+
 template <typename T>
 Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                                  const FeedsFetchesManager& feeds_fetches_manager) {
@@ -274,6 +342,18 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
+  // The beams of a batch entry start from the same prompt. On CPU, the first run is done once per batch entry,
+  // and its past state is expanded to the beams afterwards, instead of running the prompt num_beams times.
+  std::vector<OrtValue> prompt_feeds;
+  if (!this->IsCuda() && parameters->num_beams > 1 && !gpt_subgraph_.past_present_share_buffer_) {
+    CreatePromptFeeds(feeds, prompt_feeds);
+  }
+
+  // On CPU, a long prompt may be run in chunks to bound the memory of the first run.
+  const bool prefill_in_chunks = !this->IsCuda() && !gpt_subgraph_.past_present_share_buffer_ &&
+                                 parameters->prefill_chunk_size > 0 &&
+                                 parameters->sequence_length > parameters->prefill_chunk_size;
+
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
@@ -291,15 +371,30 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
     }
 #endif
 
-    // For the first iteration use the init_run_decoder subgraph (if present)
-    if (iteration_counter++ == 0 &&
-        init_run_decoder_session_state_ != nullptr) {
+    const std::vector<OrtValue>& run_feeds = (iteration_counter == 0 && !prompt_feeds.empty()) ? prompt_feeds : feeds;
+
+    if (iteration_counter == 0 && prefill_in_chunks) {
+      iteration_counter++;
+      const bool use_init_run_decoder = init_run_decoder_session_state_ != nullptr;
+      GptSubgraph& first_run_subgraph = use_init_run_decoder ? *init_run_gpt_subgraph_ : gpt_subgraph_;
+      status = first_run_subgraph.ExecuteInChunks(
+          use_init_run_decoder ? *init_run_decoder_session_state_ : this->decoder_session_state_,
+          use_init_run_decoder ? *init_run_feeds_fetches_manager : feeds_fetches_manager,
+          run_feeds,
+          fetches,
+          parameters->prefill_chunk_size,
+          this->context_.GetTerminateFlag(),
+          this->context_.Logger(),
+          this->ort_stream_);
+    } else if (iteration_counter++ == 0 &&
+               init_run_decoder_session_state_ != nullptr) {
+      // For the first iteration use the init_run_decoder subgraph (if present)
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
       const_cast<SessionState*>(this->init_run_decoder_session_state_)->IncrementGraphExecutionCounter();
 #endif
       status = utils::ExecuteSubgraph(*init_run_decoder_session_state_,
                                       *init_run_feeds_fetches_manager,
-                                      feeds,
+                                      run_feeds,
                                       fetches,
                                       {},
                                       ExecutionMode::ORT_SEQUENTIAL,
@@ -312,7 +407,7 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
 #endif
       status = utils::ExecuteSubgraph(this->decoder_session_state_,
                                       feeds_fetches_manager,
-                                      feeds,
+                                      run_feeds,
                                       fetches,
                                       {},
                                       ExecutionMode::ORT_SEQUENTIAL,
@@ -323,6 +418,14 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
 
     ORT_RETURN_IF_ERROR(status);
 
+    if (iteration_counter == 1 && !prompt_feeds.empty()) {
+      // The logits of the batch entries are expanded to the beams by ProcessLogits.
+      for (size_t i = static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()); i < fetches.size(); i++) {
+        fetches[i] = ExpandPresentState(fetches[i]);
+      }
+      prompt_feeds.clear();
+    }
+
     const OrtValue& logits = fetches[0];
     gsl::span<int32_t> beam_next_tokens;
     ORT_RETURN_IF_ERROR(this->GenerateNextToken(logits,
@@ -25,6 +25,7 @@ void BeamSearchParameters::ParseFromAttributes(const OpKernelInfo& info) {
   decoder_start_token_id = static_cast<int>(info.GetAttrOrDefault<int64_t>("decoder_start_token_id", -1));
   no_repeat_ngram_size = static_cast<int>(info.GetAttrOrDefault<int64_t>("no_repeat_ngram_size", 0));
   vocab_size = static_cast<int>(info.GetAttrOrDefault<int64_t>("vocab_size", -1));
+  prefill_chunk_size = static_cast<int>(info.GetAttrOrDefault<int64_t>("prefill_chunk_size", 0));
 }
 
 void BeamSearchParameters::ParseFromInputs(OpKernelContext* context) {
@@ -564,6 +564,22 @@ void PickGptPastState(const std::vector<OrtValue>& last_outputs,
                       int gpt_subgraph_first_present_output_idx,
                       AllocatorPtr allocator) {
   int num_present_tensors = static_cast<int>(last_outputs.size()) - gpt_subgraph_first_present_output_idx;
+
+  // When every beam continues from its own sequence, the present state is the past state and needn't be copied.
+  bool is_same_order = true;
+  for (size_t j = 0; j < beam_indices.size(); j++) {
+    if (beam_indices[j] != static_cast<int32_t>(j)) {
+      is_same_order = false;
+      break;
+    }
+  }
+  if (is_same_order) {
+    for (ptrdiff_t i = 0; i < num_present_tensors; ++i) {
+      next_inputs[gpt_subgraph_first_past_input_idx + i] = last_outputs[gpt_subgraph_first_present_output_idx + i];
+    }
+    return;
+  }
+
   for (ptrdiff_t i = 0; i < num_present_tensors; ++i) {
     const OrtValue& present = last_outputs[gpt_subgraph_first_present_output_idx + i];
 
@@ -90,8 +90,10 @@ struct ISamplingState {
   size_t temp_storage_bytes;
   std::default_random_engine generator;
 
+  // CPU buffers of shape (batch_size, vocab_size) for top-p filtering
+  gsl::span<T> next_token_probs;
   gsl::span<T> sorted_scores;
-  gsl::span<T> cumulative_probs;
+  gsl::span<int32_t> sorted_indices;
 };
 
 struct ISequences {
@@ -148,6 +150,7 @@ struct IGenerationParameters {
   int decoder_start_token_id;
   int no_repeat_ngram_size;
   bool early_stopping;
+  int prefill_chunk_size = 0;
 
   // Parameters from inputs
   int min_length;
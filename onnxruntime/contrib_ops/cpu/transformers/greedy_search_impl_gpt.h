@@ -3,6 +3,7 @@
 
 #pragma once
 #include <algorithm>
+#include <numeric>
 #include <vector>
 
 #include "core/common/span_utils.h"
@@ -79,6 +80,25 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
   }
 #endif
 
+  // Enable speculative decoding, where the draft decoder proposes the tokens verified by the decoder.
+  Status InitializeSpeculativeDecoding(const SessionState* draft_decoder_session_state,
+                                       GptSubgraph* draft_gpt_subgraph,
+                                       const FeedsFetchesManager* draft_feeds_fetches_manager) {
+    ORT_RETURN_IF(this->IsCuda(), "Speculative decoding is only supported on CPU.");
+    ORT_RETURN_IF(draft_gpt_subgraph->vocab_size != gpt_subgraph_.vocab_size,
+                  "draft_decoder shall have the same vocabulary size as decoder, got ", draft_gpt_subgraph->vocab_size,
+                  " and ", gpt_subgraph_.vocab_size);
+    ORT_RETURN_IF(draft_gpt_subgraph->IsOutputFloat16() != gpt_subgraph_.IsOutputFloat16(),
+                  "draft_decoder shall have the same logits data type as decoder");
+    ORT_RETURN_IF(gpt_subgraph_.past_present_share_buffer_ || draft_gpt_subgraph->past_present_share_buffer_ ||
+                      (init_run_gpt_subgraph_ != nullptr && init_run_gpt_subgraph_->past_present_share_buffer_),
+                  "Speculative decoding does not support past_present_share_buffer");
+    draft_decoder_session_state_ = draft_decoder_session_state;
+    draft_gpt_subgraph_ = draft_gpt_subgraph;
+    draft_feeds_fetches_manager_ = draft_feeds_fetches_manager;
+    return Status::OK();
+  }
+
   // Execute beam search in iterations util stopping criteria is reached.
   // In each iteration, GPT subgraph is called, and next token for each sequence is generated.
   Status Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
@@ -101,10 +121,53 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
       gsl::span<const int32_t> next_tokens,
       int past_sequence_length);
 
+  // Update the input for next iteration, for the unfinished sequences in rows. The outputs of the last iteration
+  // are those of the sequences in last_rows, and next_tokens has the tokens of all the sequences.
+  Status UpdateFeedsForRows(const std::vector<OrtValue>& last_outputs,
+                            std::vector<OrtValue>& next_inputs,
+                            int current_length,
+                            OrtValue& position_ids,
+                            bool increase_position,
+                            gsl::span<const int32_t> next_tokens,
+                            gsl::span<const int> last_rows,
+                            gsl::span<const int> rows);
+
+  // Generate the remaining tokens with speculative decoding, after the first run of the decoder on the prompt.
+  // feeds and fetches are those of the first run, and iteration_counter counts the tokens generated so far.
+  Status ExecuteSpeculativeDecoding(const FeedsFetchesManager& feeds_fetches_manager,
+                                    std::vector<OrtValue>& feeds,
+                                    std::vector<OrtValue>& fetches,
+                                    GreedySearchState<T>& greedy_state,
+                                    SamplingState<T>& sampling_state,
+                                    int current_length,
+                                    int iteration_counter);
+
+  // Set the inputs of a subgraph run on num_tokens tokens of each sequence, which follow the past_length tokens
+  // whose state is in the presents of last_outputs. tokens has shape (batch_size, num_tokens).
+  Status CreateSpeculativeFeeds(const GptSubgraph& subgraph,
+                                const std::vector<OrtValue>& last_outputs,
+                                int past_length,
+                                int num_tokens,
+                                gsl::span<const int32_t> tokens,
+                                gsl::span<const int32_t> sequence_lengths,
+                                std::vector<OrtValue>& next_inputs);
+
+  // Returns the state of the first past_length tokens in a present output of shape
+  // (2, batch_size, num_heads, sequence_length, head_size).
+  OrtValue SlicePastState(const OrtValue& present, int past_length);
+
   const SessionState* init_run_decoder_session_state_ = nullptr;
   GptSubgraph* init_run_gpt_subgraph_ = nullptr;
   GptSubgraph& gpt_subgraph_;
 
+  // Speculative decoding
+  const SessionState* draft_decoder_session_state_ = nullptr;
+  GptSubgraph* draft_gpt_subgraph_ = nullptr;
+  const FeedsFetchesManager* draft_feeds_fetches_manager_ = nullptr;
+  // position ids and attention mask of the prompt, of shape (batch_size, sequence_length)
+  std::vector<int32_t> prompt_position_ids_;
+  std::vector<int32_t> prompt_attention_mask_;
+
   // Device specific functions
   GenerationDeviceHelper::CreateGptInputsFunc create_inputs_func_;
   GenerationDeviceHelper::AddToFeedsFunc add_to_feeds_func_;
@@ -187,6 +250,362 @@ Status GreedySearchGpt<T, ParametersT>::UpdateFeeds(
                             false);
 }
 
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::UpdateFeedsForRows(const std::vector<OrtValue>& last_outputs,
+                                                           std::vector<OrtValue>& next_inputs,
+                                                           int current_length,
+                                                           OrtValue& position_ids,
+                                                           bool increase_position,
+                                                           gsl::span<const int32_t> next_tokens,
+                                                           gsl::span<const int> last_rows,
+                                                           gsl::span<const int> rows) {
+  // last_outputs: logits, present_0, present_1, ...
+  // next_inputs: input_ids, position_id, attention_mask, past_0, past_1
+  const int64_t num_rows = static_cast<int64_t>(rows.size());
+  auto int32_type = DataTypeImpl::GetType<int32_t>();
+
+  // rows is a subset of last_rows, and both are sorted.
+  std::vector<size_t> last_row_indices;
+  last_row_indices.reserve(rows.size());
+  for (size_t i = 0, j = 0; i < rows.size(); i++) {
+    while (last_rows[j] != rows[i]) {
+      ++j;
+    }
+    last_row_indices.push_back(j);
+  }
+
+  int32_t* all_positions = position_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  if (increase_position) {
+    for (size_t i = 0; i < next_tokens.size(); i++) {
+      all_positions[i]++;
+    }
+  }
+
+  int64_t dims[] = {num_rows, 1};
+  TensorShape input_ids_shape(&dims[0], 2);
+  OrtValue input_ids;
+  Tensor::InitOrtValue(int32_type, input_ids_shape, this->temp_space_allocator_, input_ids);
+  OrtValue row_position_ids;
+  Tensor::InitOrtValue(int32_type, input_ids_shape, this->temp_space_allocator_, row_position_ids);
+  int32_t* input_ids_data = input_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  int32_t* position_data = row_position_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (size_t i = 0; i < rows.size(); i++) {
+    input_ids_data[i] = next_tokens[rows[i]];
+    position_data[i] = all_positions[rows[i]];
+  }
+
+  const int32_t* old_mask_data = next_inputs[2].Get<Tensor>().Data<int32_t>();
+  int64_t mask_dims[] = {num_rows, current_length};
+  TensorShape mask_shape(&mask_dims[0], 2);
+  OrtValue attention_mask;
+  Tensor::InitOrtValue(int32_type, mask_shape, this->temp_space_allocator_, attention_mask);
+  int32_t* mask_data = attention_mask.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (size_t i = 0; i < rows.size(); i++) {
+    std::copy_n(old_mask_data + last_row_indices[i] * (current_length - 1), current_length - 1, mask_data);
+    mask_data[current_length - 1] = 1;
+    mask_data += current_length;
+  }
+
+  next_inputs[0] = input_ids;
+  next_inputs[1] = row_position_ids;
+  next_inputs[2] = attention_mask;
+
+  // Gather the rows of the present state of shape (2, last_num_rows, num_heads, past_seq_len, head_size).
+  const size_t first_past_input_index = static_cast<size_t>(gpt_subgraph_.GetFirstPastInputIndex());
+  const size_t first_present_output_index = static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex());
+  for (size_t i = first_present_output_index; i < last_outputs.size(); i++) {
+    const OrtValue& present = last_outputs[i];
+    OrtValue& past = next_inputs[i - first_present_output_index + first_past_input_index];
+    if (rows.size() == last_rows.size()) {
+      past = present;
+      continue;
+    }
+
+    const Tensor& present_tensor = present.Get<Tensor>();
+    const TensorShape& present_shape = present_tensor.Shape();
+    Tensor::InitOrtValue(present_tensor.DataType(),
+                         TensorShape{present_shape[0], num_rows, present_shape[2], present_shape[3], present_shape[4]},
+                         this->temp_space_allocator_, past);
+    const size_t block_size = SafeInt<size_t>(present_shape[2]) * present_shape[3] * present_shape[4];
+    const T* present_data = present_tensor.Data<T>();
+    T* past_data = past.GetMutable<Tensor>()->MutableData<T>();
+    for (int64_t kv = 0; kv < present_shape[0]; kv++) {
+      const T* source = present_data + SafeInt<size_t>(kv) * present_shape[1] * block_size;
+      for (size_t last_row_index : last_row_indices) {
+        std::copy_n(source + last_row_index * block_size, block_size, past_data);
+        past_data += block_size;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
+template <typename T, typename ParametersT>
+OrtValue GreedySearchGpt<T, ParametersT>::SlicePastState(const OrtValue& present, int past_length) {
+  const Tensor& present_tensor = present.Get<Tensor>();
+  const TensorShape& present_shape = present_tensor.Shape();
+  if (present_shape[3] == past_length) {
+    return present;
+  }
+
+  TensorShape past_shape{present_shape[0], present_shape[1], present_shape[2], past_length, present_shape[4]};
+  OrtValue past;
+  Tensor::InitOrtValue(present_tensor.DataType(), past_shape, this->temp_space_allocator_, past);
+
+  // copy the first past_length rows of each (sequence_length, head_size) block
+  const size_t num_blocks = SafeInt<size_t>(present_shape[0]) * present_shape[1] * present_shape[2];
+  const size_t present_block_size = SafeInt<size_t>(present_shape[3]) * present_shape[4];
+  const size_t past_block_size = SafeInt<size_t>(past_length) * present_shape[4];
+  const T* present_data = present_tensor.Data<T>();
+  T* past_data = past.GetMutable<Tensor>()->MutableData<T>();
+  for (size_t i = 0; i < num_blocks; i++) {
+    std::copy_n(present_data + i * present_block_size, past_block_size, past_data + i * past_block_size);
+  }
+  return past;
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::CreateSpeculativeFeeds(const GptSubgraph& subgraph,
+                                                               const std::vector<OrtValue>& last_outputs,
+                                                               int past_length,
+                                                               int num_tokens,
+                                                               gsl::span<const int32_t> tokens,
+                                                               gsl::span<const int32_t> sequence_lengths,
+                                                               std::vector<OrtValue>& next_inputs) {
+  // last_outputs: logits, present_0, present_1, ...
+  // next_inputs: input_ids, position_id, attention_mask, past_0, past_1
+  const int batch_size = this->parameters_->batch_size;
+  const int prompt_length = this->parameters_->sequence_length;
+  const int total_length = past_length + num_tokens;
+  auto int32_type = DataTypeImpl::GetType<int32_t>();
+
+  int64_t dims[] = {batch_size, num_tokens};
+  TensorShape input_ids_shape(&dims[0], 2);
+  OrtValue input_ids;
+  Tensor::InitOrtValue(int32_type, input_ids_shape, this->temp_space_allocator_, input_ids);
+  gsl::copy(tokens, input_ids.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>());
+
+  // The tokens of the prompt keep the position ids and mask computed for the first run. The generated tokens
+  // follow the last non-padding token of the prompt.
+  OrtValue position_ids;
+  Tensor::InitOrtValue(int32_type, input_ids_shape, this->temp_space_allocator_, position_ids);
+  int32_t* position_data = position_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int i = 0; i < batch_size; i++) {
+    for (int j = 0; j < num_tokens; j++) {
+      const int index = past_length + j;
+      *position_data++ = index < prompt_length ? prompt_position_ids_[SafeInt<size_t>(i) * prompt_length + index]
+                                               : sequence_lengths[i] + index - prompt_length;
+    }
+  }
+
+  int64_t mask_dims[] = {batch_size, total_length};
+  TensorShape mask_shape(&mask_dims[0], 2);
+  OrtValue attention_mask;
+  Tensor::InitOrtValue(int32_type, mask_shape, this->temp_space_allocator_, attention_mask);
+  int32_t* mask_data = attention_mask.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int i = 0; i < batch_size; i++) {
+    for (int j = 0; j < total_length; j++) {
+      *mask_data++ = j < prompt_length ? prompt_attention_mask_[SafeInt<size_t>(i) * prompt_length + j] : 1;
+    }
+  }
+
+  next_inputs[0] = input_ids;
+  next_inputs[1] = position_ids;
+  next_inputs[2] = attention_mask;
+
+  // Without past state, the subgraph keeps the empty past state of its initial feeds.
+  if (past_length > 0) {
+    for (int i = 0; i < subgraph.num_layers; i++) {
+      next_inputs[SafeInt<size_t>(subgraph.GetFirstPastInputIndex()) + i] =
+          SlicePastState(last_outputs[SafeInt<size_t>(subgraph.GetFirstPresentOutputIndex()) + i], past_length);
+    }
+  }
+
+  return Status::OK();
+}
+
+// Speculative decoding: in each round, the draft decoder proposes up to num_speculative_tokens tokens one at a time,
+// then the decoder runs once on the last token and the proposed ones. The logits of each position are processed
+// as in the regular loop to get the next token, and the proposed tokens are accepted as long as they match
+// those tokens. So every round generates at least one token, and the sequences are the same as without speculation.
+// The tokens accepted are the same for all the sequences of the batch, so that the past state keeps one length.
+// The state of the rejected tokens is dropped by slicing the presents in the next round.
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::ExecuteSpeculativeDecoding(const FeedsFetchesManager& feeds_fetches_manager,
+                                                                   std::vector<OrtValue>& feeds,
+                                                                   std::vector<OrtValue>& fetches,
+                                                                   GreedySearchState<T>& greedy_state,
+                                                                   SamplingState<T>& sampling_state,
+                                                                   int current_length,
+                                                                   int iteration_counter) {
+  const ParametersT* parameters = this->parameters_;
+  const int batch_size = parameters->batch_size;
+  const int vocab_size = parameters->vocab_size;
+  const int num_speculative_tokens = parameters->num_speculative_tokens;
+  gsl::span<bool>& eos_meet = greedy_state.eos_meet;
+
+  // feeds still hold the inputs of the first run
+  const auto prompt_position_ids = feeds[1].Get<Tensor>().DataAsSpan<int32_t>();
+  const auto prompt_attention_mask = feeds[2].Get<Tensor>().DataAsSpan<int32_t>();
+  prompt_position_ids_.assign(prompt_position_ids.begin(), prompt_position_ids.end());
+  prompt_attention_mask_.assign(prompt_attention_mask.begin(), prompt_attention_mask.end());
+  gsl::span<const int32_t> sequence_lengths = greedy_state.sequence_lengths;
+
+  // The draft decoder starts from an empty past state, and runs on the prompt in the first round.
+  std::vector<OrtValue> draft_feeds;
+  std::vector<OrtValue> draft_fetches;
+  IAllocatorUniquePtr<char> draft_buffer;
+  OrtValue draft_expanded_input_ids;
+  std::vector<int32_t> draft_sequence_lengths(batch_size);
+  gsl::span<int32_t> draft_sequence_lengths_span(draft_sequence_lengths);
+  const OrtValue* input_ids_value = this->context_.GetInputOrtValue(0);
+  ORT_RETURN_IF_ERROR(draft_gpt_subgraph_->CreateInitialFeeds(input_ids_value->Get<Tensor>(),
+                                                              this->implicit_inputs_,
+                                                              parameters->num_beams,
+                                                              parameters->pad_token_id,
+                                                              draft_sequence_lengths_span,
+                                                              draft_expanded_input_ids,
+                                                              this->context_.GetInputOrtValue(6),
+                                                              draft_feeds,
+                                                              this->create_inputs_func_,
+                                                              this->add_to_feeds_func_,
+                                                              draft_buffer,
+                                                              this->ort_stream_));
+  // number of tokens in the past state of the draft decoder
+  int draft_past_length = 0;
+
+  // logits of one position of the decoder run, of shape (batch_size, 1, vocab_size)
+  int64_t step_logits_dims[] = {batch_size, 1, vocab_size};
+  TensorShape step_logits_shape(&step_logits_dims[0], 3);
+  OrtValue step_logits;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<T>(), step_logits_shape, this->temp_space_allocator_, step_logits);
+  T* step_logits_data = step_logits.GetMutable<Tensor>()->MutableData<T>();
+
+  std::vector<int32_t> draft_tokens(static_cast<size_t>(batch_size) * num_speculative_tokens);
+  std::vector<int32_t> step_tokens;
+
+  while (current_length < parameters->max_length) {
+    // The verification generates one more token than proposed.
+    const int num_draft_tokens = std::min(num_speculative_tokens, parameters->max_length - current_length - 1);
+
+    for (int k = 0; k < num_draft_tokens; k++) {
+      // The first run of the round catches up with the tokens generated since the last round.
+      const int num_tokens = (k == 0) ? current_length - draft_past_length : 1;
+      step_tokens.resize(static_cast<size_t>(batch_size) * num_tokens);
+      for (int i = 0; i < batch_size; i++) {
+        gsl::span<const int32_t> sequence = greedy_state.sequences.GetSequence(i);
+        for (int j = 0; j < num_tokens; j++) {
+          step_tokens[SafeInt<size_t>(i) * num_tokens + j] =
+              (k == 0) ? sequence[SafeInt<size_t>(draft_past_length) + j]
+                       : draft_tokens[SafeInt<size_t>(i) * num_speculative_tokens + k - 1];
+        }
+      }
+
+      ORT_RETURN_IF_ERROR(CreateSpeculativeFeeds(*draft_gpt_subgraph_, draft_fetches, draft_past_length, num_tokens,
+                                                 step_tokens, sequence_lengths, draft_feeds));
+      draft_fetches.clear();
+      ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(*draft_decoder_session_state_,
+                                                 *draft_feeds_fetches_manager_,
+                                                 draft_feeds,
+                                                 draft_fetches,
+                                                 {},
+                                                 ExecutionMode::ORT_SEQUENTIAL,
+                                                 this->context_.GetTerminateFlag(),
+                                                 this->context_.Logger(),
+                                                 this->ort_stream_));
+      draft_past_length += num_tokens;
+
+      // The draft token is the most likely one after the last position.
+      const Tensor& draft_logits = draft_fetches[0].Get<Tensor>();
+      const int64_t draft_vocab_size = draft_logits.Shape()[2];
+      const T* draft_logits_data = draft_logits.Data<T>();
+      for (int i = 0; i < batch_size; i++) {
+        const T* scores = draft_logits_data + (SafeInt<size_t>(i) * num_tokens + num_tokens - 1) * draft_vocab_size;
+        const T* best = std::max_element(scores, scores + vocab_size, [](const T& a, const T& b) {
+          return static_cast<float>(a) < static_cast<float>(b);
+        });
+        draft_tokens[SafeInt<size_t>(i) * num_speculative_tokens + k] = static_cast<int32_t>(best - scores);
+      }
+    }
+
+    // Verify the draft tokens with one run of the decoder on the last token followed by them.
+    const int num_tokens = num_draft_tokens + 1;
+    step_tokens.resize(static_cast<size_t>(batch_size) * num_tokens);
+    for (int i = 0; i < batch_size; i++) {
+      step_tokens[SafeInt<size_t>(i) * num_tokens] = greedy_state.sequences.GetSequence(i)[current_length - 1];
+      for (int j = 1; j < num_tokens; j++) {
+        step_tokens[SafeInt<size_t>(i) * num_tokens + j] =
+            draft_tokens[SafeInt<size_t>(i) * num_speculative_tokens + j - 1];
+      }
+    }
+
+    ORT_RETURN_IF_ERROR(CreateSpeculativeFeeds(gpt_subgraph_, fetches, current_length - 1, num_tokens,
+                                               step_tokens, sequence_lengths, feeds));
+    fetches.clear();
+#ifdef DEBUG_NODE_INPUTS_OUTPUTS
+    const_cast<SessionState&>(this->decoder_session_state_).IncrementGraphExecutionCounter();
+#endif
+    ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(this->decoder_session_state_,
+                                               feeds_fetches_manager,
+                                               feeds,
+                                               fetches,
+                                               {},
+                                               ExecutionMode::ORT_SEQUENTIAL,
+                                               this->context_.GetTerminateFlag(),
+                                               this->context_.Logger(),
+                                               this->ort_stream_));
+
+    const Tensor& logits = fetches[0].Get<Tensor>();
+    const int64_t logits_vocab_size = logits.Shape()[2];
+    const T* logits_data = logits.Data<T>();
+
+    bool all_finished = false;
+    for (int j = 0; j < num_tokens; j++) {
+      for (int i = 0; i < batch_size; i++) {
+        const T* source = logits_data + (SafeInt<size_t>(i) * num_tokens + j) * logits_vocab_size;
+        std::copy_n(source, vocab_size, step_logits_data + SafeInt<size_t>(i) * vocab_size);
+      }
+
+      gsl::span<int32_t> next_tokens;
+      ORT_RETURN_IF_ERROR(this->GenerateNextToken(step_logits,
+                                                  next_tokens,
+                                                  greedy_state,
+                                                  sampling_state,
+                                                  ++iteration_counter,
+                                                  parameters->eos_token_id));
+      ++current_length;
+
+      all_finished = std::all_of(eos_meet.begin(), eos_meet.end(), [](bool finished) { return finished; });
+      if (all_finished || j == num_draft_tokens) {
+        break;
+      }
+
+      // Stop at the first draft token that differs from the generated one in a sequence that is not finished.
+      bool accepted = true;
+      for (int i = 0; i < batch_size; i++) {
+        if (!eos_meet[i] && next_tokens[i] != draft_tokens[SafeInt<size_t>(i) * num_speculative_tokens + j]) {
+          accepted = false;
+          break;
+        }
+      }
+      if (!accepted) {
+        break;
+      }
+    }
+
+    // When all batches are finished, stop earlier to avoid wasting computation.
+    if (all_finished) {
+      break;
+    }
+
+    // The past state of the draft decoder is valid up to the last accepted draft token.
+    draft_past_length = std::min(draft_past_length, current_length - 1);
+  }
+
+  return Status::OK();
+}
+
 template <typename T, typename ParametersT>
 Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                                                 const FeedsFetchesManager& feeds_fetches_manager) {
@@ -268,6 +687,20 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
+  // Rows of the batch in the runs of the decoder. On CPU, finished sequences are removed from the batch
+  // so that the following runs only compute the unfinished ones.
+  const bool remove_finished_rows = !this->IsCuda() && !gpt_subgraph_.past_present_share_buffer_;
+  std::vector<int> rows(parameters->BatchBeamSize());
+  std::iota(rows.begin(), rows.end(), 0);
+  std::vector<int> next_rows;
+  // logits of all the rows when the decoder runs on some of them
+  OrtValue batch_logits;
+
+  // On CPU, a long prompt may be run in chunks to bound the memory of the first run.
+  const bool prefill_in_chunks = !this->IsCuda() && !gpt_subgraph_.past_present_share_buffer_ &&
+                                 parameters->prefill_chunk_size > 0 &&
+                                 parameters->sequence_length > parameters->prefill_chunk_size;
+
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
@@ -280,9 +713,22 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     dumper->Print("past", feeds[3]);
 #endif
 
-    // For the first iteration use the init_run_decoder subgraph (if present)
-    if (iteration_counter++ == 0 &&
-        init_run_decoder_session_state_ != nullptr) {
+    if (iteration_counter == 0 && prefill_in_chunks) {
+      iteration_counter++;
+      const bool use_init_run_decoder = init_run_decoder_session_state_ != nullptr;
+      GptSubgraph& first_run_subgraph = use_init_run_decoder ? *init_run_gpt_subgraph_ : gpt_subgraph_;
+      status = first_run_subgraph.ExecuteInChunks(
+          use_init_run_decoder ? *init_run_decoder_session_state_ : this->decoder_session_state_,
+          use_init_run_decoder ? *init_run_feeds_fetches_manager : feeds_fetches_manager,
+          feeds,
+          fetches,
+          parameters->prefill_chunk_size,
+          this->context_.GetTerminateFlag(),
+          this->context_.Logger(),
+          this->ort_stream_);
+    } else if (iteration_counter++ == 0 &&
+               init_run_decoder_session_state_ != nullptr) {
+      // For the first iteration use the init_run_decoder subgraph (if present)
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
       const_cast<SessionState*>(this->init_run_decoder_session_state_)->IncrementGraphExecutionCounter();
 #endif
@@ -312,7 +758,26 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
 
     ORT_RETURN_IF_ERROR(status);
 
-    const OrtValue& logits = fetches[0];
+    if (rows.size() < static_cast<size_t>(parameters->BatchBeamSize())) {
+      // The logits of the finished rows are not updated, their next tokens are padding. They are still processed
+      // and sampled with the others, so they start as zeros rather than uninitialized memory that may hold NaN.
+      const Tensor& row_logits = fetches[0].Get<Tensor>();
+      const size_t vocab_size = static_cast<size_t>(row_logits.Shape()[2]);
+      if (!batch_logits.IsAllocated()) {
+        Tensor::InitOrtValue(row_logits.DataType(),
+                             TensorShape{parameters->BatchBeamSize(), 1, row_logits.Shape()[2]},
+                             this->temp_space_allocator_, batch_logits);
+        Tensor* batch_logits_tensor = batch_logits.GetMutable<Tensor>();
+        memset(batch_logits_tensor->MutableDataRaw(), 0, batch_logits_tensor->SizeInBytes());
+      }
+      const T* source = row_logits.Data<T>();
+      T* target = batch_logits.GetMutable<Tensor>()->MutableData<T>();
+      for (size_t i = 0; i < rows.size(); i++) {
+        std::copy_n(source + i * vocab_size, vocab_size, target + SafeInt<size_t>(rows[i]) * vocab_size);
+      }
+    }
+
+    const OrtValue& logits = rows.size() < static_cast<size_t>(parameters->BatchBeamSize()) ? batch_logits : fetches[0];
     gsl::span<int32_t> next_tokens;
 
     ORT_RETURN_IF_ERROR(this->GenerateNextToken(logits,
@@ -338,6 +803,12 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     // Increase sequence length after a new token is generated.
     ++current_length;
 
+    if (draft_gpt_subgraph_ != nullptr) {
+      status = ExecuteSpeculativeDecoding(feeds_fetches_manager, feeds, fetches, greedy_state, sampling_state,
+                                          current_length, iteration_counter);
+      break;
+    }
+
 #ifdef USE_CUDA
     // Reorder past state after first run if the GPT subgraph (the one used after the first iteration)
     // contains DecoderMaskedSelfAttention nodes
@@ -357,15 +828,30 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     }
 #endif
 
+    next_rows.clear();
+    for (int row : rows) {
+      if (!remove_finished_rows || !eos_meet[row]) {
+        next_rows.push_back(row);
+      }
+    }
+
     // Prepare inputs for next round of subgraph call.
     if (current_length < parameters->max_length) {
       bool increase_position = (iteration_counter > 1);
 
-      ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
-                                      position_ids, increase_position,
-                                      ReinterpretAsSpan<const int32_t>(next_tokens),
-                                      current_length - 1));
+      if (next_rows.size() < static_cast<size_t>(parameters->BatchBeamSize())) {
+        ORT_RETURN_IF_ERROR(UpdateFeedsForRows(fetches, feeds, current_length,
+                                               position_ids, increase_position,
+                                               ReinterpretAsSpan<const int32_t>(next_tokens),
+                                               rows, next_rows));
+      } else {
+        ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
+                                        position_ids, increase_position,
+                                        ReinterpretAsSpan<const int32_t>(next_tokens),
+                                        current_length - 1));
+      }
     }
+    rows.swap(next_rows);
     if (gpt_subgraph_.past_present_share_buffer_) {
       // clear fetched values before presents[]
       for (int idx = 0; idx < gpt_subgraph_.GetFirstPresentOutputIndex(); idx++) {
@@ -376,6 +862,8 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     }
   }
 
+  ORT_RETURN_IF_ERROR(status);
+
   // Copy the sequences to output
   gsl::span<int32_t> output = output_sequences->MutableDataAsSpan<int32_t>();
   for (int batch_id = 0; batch_id < parameters->batch_size; ++batch_id) {
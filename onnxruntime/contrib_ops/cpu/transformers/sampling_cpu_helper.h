@@ -2,55 +2,63 @@
 // Licensed under the MIT License.
 #pragma once
 
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <gsl/gsl>
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/generator/random.h"
+#include "core/providers/cpu/math/softmax_shared.h"
+#include "contrib_ops/cpu/transformers/generation_shared.h"
+#include "contrib_ops/cpu/utils/console_dumper.h"
+
 namespace onnxruntime {
 namespace contrib {
 namespace SamplingCpuHelper {
 
-template <typename T>
-void filter_scores(std::vector<size_t>& sorted_indice,
-                   gsl::span<T>& next_token_score,
-                   const transformers::IGenerationParameters* parameters,
-                   size_t chunk_offset,
-                   size_t offset) {
-  size_t real_index = sorted_indice[chunk_offset + offset];
-  next_token_score[chunk_offset + real_index] = (T)parameters->filter_value;
-}
+// Number of most likely tokens sorted first when looking for the tokens to keep. Top-p keeps a few tokens of
+// a peaked distribution, so it is cheaper to grow a sorted prefix than to sort the whole vocabulary.
+constexpr size_t kInitialTopPCandidates = 64;
 
+// Returns the number of most likely tokens to keep, and moves their indices to the front of token_indices in
+// descending order of probability. A token is filtered when the tokens more likely than it have a probability mass
+// of at least top_p (above top_p for custom sampling). The min_tokens_to_keep most likely tokens are always kept.
 template <typename T>
-void cumulate_and_filter_custom(gsl::span<T>& next_token_scores,
-                                gsl::span<T>& cumulative_probs,
-                                const transformers::IGenerationParameters* parameters,
-                                std::vector<size_t>& sorted_indices) {
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    size_t offset = i * parameters->vocab_size;
-    if (cumulative_probs[offset] > parameters->top_p) {
-      filter_scores(sorted_indices, next_token_scores, parameters, offset, 1);
+size_t select_top_p(gsl::span<const T> probs,
+                    gsl::span<int32_t> token_indices,
+                    float top_p,
+                    bool custom_sampling,
+                    size_t min_tokens_to_keep) {
+  const size_t vocab_size = probs.size();
+  const size_t num_keep = custom_sampling ? 1 : std::max<size_t>(min_tokens_to_keep, 1);
+  auto more_likely = [&probs](int32_t a, int32_t b) { return probs[a] > probs[b]; };
+
+  std::iota(token_indices.begin(), token_indices.end(), 0);
+
+  T cumulative_prob = 0;
+  size_t num_sorted = 0;
+  size_t num_candidates = std::min(vocab_size, std::max(kInitialTopPCandidates, num_keep));
+  for (;;) {
+    // Move the next most likely tokens to [num_sorted, num_candidates) in descending order.
+    auto first = token_indices.begin() + num_sorted;
+    auto last = token_indices.begin() + num_candidates;
+    if (num_candidates < vocab_size) {
+      std::nth_element(first, last, token_indices.end(), more_likely);
     }
-    for (size_t j = 1; j < static_cast<size_t>(parameters->vocab_size) - 1; j++) {
-      cumulative_probs[j + offset] += cumulative_probs[j + offset - 1];
-      if (cumulative_probs[j + offset] > parameters->top_p) {
-        filter_scores(sorted_indices, next_token_scores, parameters, offset, j + 1);
+    std::sort(first, last, more_likely);
+
+    for (size_t k = num_sorted; k < num_candidates; k++) {
+      if (k >= num_keep && (custom_sampling ? cumulative_prob > top_p : cumulative_prob >= top_p)) {
+        return k;
       }
+      cumulative_prob += probs[token_indices[k]];
     }
-  }
-}
 
-template <typename T>
-void cumulate_and_filter(gsl::span<T>& next_token_scores,
-                         gsl::span<T>& cumulative_probs,
-                         const transformers::IGenerationParameters* parameters,
-                         std::vector<size_t>& sorted_indices) {
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    size_t offset = i * parameters->vocab_size;
-    if (cumulative_probs[offset] <= 1 - parameters->top_p) {
-      filter_scores(sorted_indices, next_token_scores, parameters, offset, 0);
-    }
-    for (size_t j = 1; j < static_cast<size_t>(parameters->vocab_size) - static_cast<size_t>(parameters->min_tokens_to_keep); j++) {
-      cumulative_probs[j + offset] += cumulative_probs[j + offset - 1];
-      if (cumulative_probs[j + offset] <= 1 - parameters->top_p) {
-        filter_scores(sorted_indices, next_token_scores, parameters, offset, j);
-      }
+    if (num_candidates == vocab_size) {
+      return vocab_size;
     }
+    num_sorted = num_candidates;
+    num_candidates = std::min(vocab_size, 2 * num_candidates);
   }
 }
 
@@ -64,55 +72,47 @@ Status Sample(AllocatorPtr& allocator,
               const IConsoleDumper* dumper) {
   ORT_UNUSED_PARAMETER(dumper);
 
+  const size_t batch_size = static_cast<size_t>(parameters->batch_size);
+  const size_t vocab_size = static_cast<size_t>(parameters->vocab_size);
+  gsl::span<T>& next_token_probs = sampling_state->next_token_probs;
   gsl::span<T>& sorted_scores = sampling_state->sorted_scores;
-  memcpy(sorted_scores.data(), next_token_scores.data(), next_token_scores.size_bytes());
-  std::vector<size_t> sorted_indices(static_cast<size_t>(parameters->batch_size) * static_cast<size_t>(parameters->vocab_size));
-
-  std::function<bool(T, T)> predicator;
-  if (parameters->custom_sampling) {
-    predicator = std::greater<T>();
-  } else {
-    predicator = std::less<T>();
-  }
-
-  // TODO: This could be optimized with allocated buffer and handwritten sort algorithm
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    auto indices_begin = sorted_indices.begin() + i * parameters->vocab_size;
-    auto indices_end = sorted_indices.begin() + (i + 1) * parameters->vocab_size;
-    gsl::span<T> next_token_score = next_token_scores.subspan(i * parameters->vocab_size, parameters->vocab_size);
-    std::iota(indices_begin, indices_end, 0);
-    std::sort(indices_begin, indices_end,
-              [&next_token_score, &predicator](size_t i1, size_t i2) {
-                return predicator(next_token_score[i1], next_token_score[i2]);
-              });
-
-    std::sort(sorted_scores.begin() + i * parameters->vocab_size,
-              sorted_scores.begin() + (i + 1) * parameters->vocab_size,
-              predicator);
-  }
-
-#ifdef DEBUG_GENERATION
-  dumper->Print("sorted_scores", sorted_scores.data(), parameters->batch_size, parameters->vocab_size);
-  dumper->Print("sorted_indices", sorted_indices.data(), parameters->batch_size, parameters->vocab_size);
-#endif
+  gsl::span<int32_t>& sorted_indices = sampling_state->sorted_indices;
 
-  gsl::span<T>& cumulative_probs = sampling_state->cumulative_probs;
-
-  ORT_RETURN_IF_ERROR(SoftmaxCPU<T>(parameters->batch_size,
-                                    parameters->vocab_size,
-                                    sorted_scores.data(),
-                                    cumulative_probs.data(),
+  ORT_RETURN_IF_ERROR(SoftmaxCPU<T>(batch_size,
+                                    vocab_size,
+                                    next_token_scores.data(),
+                                    next_token_probs.data(),
                                     false,
                                     thread_pool));
 
-  if (parameters->custom_sampling) {
-    cumulate_and_filter_custom(next_token_scores, cumulative_probs, parameters, sorted_indices);
-  } else {
-    cumulate_and_filter(next_token_scores, cumulative_probs, parameters, sorted_indices);
-  }
+  // Keep the scores of the selected tokens, and set the others to filter_value.
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(batch_size), [&](std::ptrdiff_t batch_id) {
+        const size_t offset = static_cast<size_t>(batch_id) * vocab_size;
+        gsl::span<T> scores = next_token_scores.subspan(offset, vocab_size);
+        gsl::span<int32_t> indices = sorted_indices.subspan(offset, vocab_size);
+        gsl::span<T> kept_scores = sorted_scores.subspan(offset, vocab_size);
+
+        const size_t num_kept = select_top_p<T>(next_token_probs.subspan(offset, vocab_size),
+                                                indices,
+                                                parameters->top_p,
+                                                parameters->custom_sampling,
+                                                static_cast<size_t>(parameters->min_tokens_to_keep));
+        if (num_kept == vocab_size) {
+          return;
+        }
+
+        for (size_t k = 0; k < num_kept; k++) {
+          kept_scores[k] = scores[indices[k]];
+        }
+        std::fill(scores.begin(), scores.end(), static_cast<T>(parameters->filter_value));
+        for (size_t k = 0; k < num_kept; k++) {
+          scores[indices[k]] = kept_scores[k];
+        }
+      });
 
 #ifdef DEBUG_GENERATION
-  dumper->Print("cumulative_probs after filtering", cumulative_probs.data(), parameters->batch_size, parameters->vocab_size);
+  dumper->Print("next_token_probs", next_token_probs.data(), parameters->batch_size, parameters->vocab_size);
   dumper->Print("next_token_scores after filtering", next_token_scores.data(), parameters->batch_size, parameters->vocab_size);
 #endif
 
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <utility>
 #include "core/framework/framework_common.h"
 #include "core/framework/session_state.h"
@@ -185,6 +186,32 @@ Status Subgraph::GetParameters(const ONNX_NAMESPACE::TensorShapeProto* past_shap
   return Status::OK();
 }
 
+bool Subgraph::IsSharedByBeams(const std::string& input_name) const {
+  const auto consumers = subgraph.GetConsumerNodes(input_name);
+  return !consumers.empty() &&
+         std::all_of(consumers.begin(), consumers.end(), [&input_name](const Node* consumer) {
+           if (consumer == nullptr || consumer->OpType() != "DecoderMaskedMultiHeadAttention" ||
+               consumer->Domain() != kMSDomain || consumer->GetExecutionProviderType() != kCpuExecutionProvider) {
+             return false;
+           }
+
+           // key and value of cross-attention, which has no past key
+           const auto& input_defs = consumer->InputDefs();
+           constexpr size_t past_key_index = 5;
+           if (input_defs.size() > past_key_index && input_defs[past_key_index]->Exists()) {
+             return false;
+           }
+
+           for (size_t i = 0; i < input_defs.size(); ++i) {
+             if (input_defs[i]->Name() == input_name && i != 1 && i != 2) {
+               return false;
+             }
+           }
+
+           return true;
+         });
+}
+
 Status Subgraph::AppendPastSequenceLength(std::vector<OrtValue>& feeds,
                                           AllocatorPtr cpu_allocator,
                                           const int32_t init_value) {
@@ -47,6 +47,9 @@ class Subgraph {
   bool past_present_share_buffer_;
   bool has_decoder_masked_attention_;
   bool output_cross_qk_ = false;
+  // Cross attention past key/value are fed once per batch entry instead of once per beam, since all their consumers
+  // share them across beams.
+  bool cross_past_shared_by_beams_ = false;
 
   // Setup execution
   Status Setup(const SessionState& session_state,
@@ -79,6 +82,10 @@ class Subgraph {
                                       const int64_t num_beams,
                                       const int64_t max_seq_len);
 
+  // Whether the input is only consumed as key or value by CPU DecoderMaskedMultiHeadAttention cross-attention nodes,
+  // which accept them without expansion to the beams.
+  bool IsSharedByBeams(const std::string& input_name) const;
+
   AllocatorPtr allocator_;
   const SessionState* session_state_;
   const SessionState* subgraph_session_state_;
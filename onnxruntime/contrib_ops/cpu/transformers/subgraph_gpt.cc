@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/framework/framework_common.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tensorprotoutils.h"
@@ -112,9 +114,69 @@ Status GptSubgraph::CreateInitialFeeds(
     }
   }
 
-  // Pass in implicit inputs
-  for (const auto* entry : implicit_inputs) {
-    feeds.push_back(*entry);
+  // Pass in implicit inputs used by this subgraph, as the subgraphs of the node may not all use the same ones.
+  for (size_t i = 0; i < implicit_inputs.size(); ++i) {
+    if (used_implicit_inputs[i]) {
+      feeds.push_back(*implicit_inputs[i]);
+    }
+  }
+
+  return Status::OK();
+}
+
+Status GptSubgraph::ExecuteInChunks(const SessionState& session_state,
+                                    const FeedsFetchesManager& feeds_fetches_manager,
+                                    const std::vector<OrtValue>& feeds,
+                                    std::vector<OrtValue>& fetches,
+                                    int chunk_size,
+                                    const bool& terminate_flag,
+                                    const logging::Logger& logger,
+                                    Stream* ort_stream) {
+  ORT_ENFORCE(allocator_ != nullptr, "CreateInitialFeeds must be called before ExecuteInChunks");
+  ORT_RETURN_IF(past_present_share_buffer_, "Chunked prefill does not support past_present_share_buffer");
+  ORT_RETURN_IF(chunk_size <= 0, "prefill_chunk_size shall be positive, got ", chunk_size);
+
+  const TensorShape& input_ids_shape = feeds[0].Get<Tensor>().Shape();
+  const int64_t batch_size = input_ids_shape[0];
+  const int64_t sequence_length = input_ids_shape[1];
+
+  // Copy columns [begin, end) of an input of shape (batch_size, width)
+  auto slice_columns = [this, batch_size](const OrtValue& input, int64_t begin, int64_t end, OrtValue& slice) {
+    const Tensor& tensor = input.Get<Tensor>();
+    const int64_t width = tensor.Shape()[1];
+    Tensor::InitOrtValue(tensor.DataType(), TensorShape{batch_size, end - begin}, allocator_, slice);
+    const int32_t* source = tensor.Data<int32_t>();
+    int32_t* target = slice.GetMutable<Tensor>()->MutableData<int32_t>();
+    for (int64_t b = 0; b < batch_size; b++) {
+      std::copy_n(source + b * width + begin, end - begin, target + b * (end - begin));
+    }
+  };
+
+  std::vector<OrtValue> chunk_feeds = feeds;
+  for (int64_t begin = 0; begin < sequence_length; begin += chunk_size) {
+    const int64_t end = std::min(begin + chunk_size, sequence_length);
+    slice_columns(feeds[0], begin, end, chunk_feeds[0]);  // input_ids
+    slice_columns(feeds[1], begin, end, chunk_feeds[1]);  // position_ids
+    slice_columns(feeds[2], 0, end, chunk_feeds[2]);      // attention_mask covers the past and the chunk
+
+    if (begin > 0) {
+      // The present state of the previous chunks is the past state of this one.
+      for (int i = 0; i < num_layers; i++) {
+        chunk_feeds[static_cast<size_t>(first_past_input_index_) + i] =
+            fetches[static_cast<size_t>(first_present_output_index_) + i];
+      }
+    }
+
+    fetches.clear();
+    ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(session_state,
+                                               feeds_fetches_manager,
+                                               chunk_feeds,
+                                               fetches,
+                                               {},
+                                               ExecutionMode::ORT_SEQUENTIAL,
+                                               terminate_flag,
+                                               logger,
+                                               ort_stream));
   }
 
   return Status::OK();
@@ -37,6 +37,19 @@ class GptSubgraph : public Subgraph {
       int past_present_share_buffer_max_seq_len = -1,
       bool need_cache_indir = false);
 
+  // Run the subgraph on the prompt in chunks of chunk_size tokens, each appending to the past state of the previous
+  // ones, so that the attention scratch and logits of the first run are bounded by the chunk size.
+  // feeds are those of the first run in CPU memory, without past_present_share_buffer. fetches receive the logits of
+  // the last chunk and the present state of the whole prompt.
+  Status ExecuteInChunks(const SessionState& session_state,
+                         const FeedsFetchesManager& feeds_fetches_manager,
+                         const std::vector<OrtValue>& feeds,
+                         std::vector<OrtValue>& fetches,
+                         int chunk_size,
+                         const bool& terminate_flag,
+                         const logging::Logger& logger,
+                         Stream* ort_stream);
+
   Status Validate(const std::vector<const NodeArg*>& subgraph_inputs,
                   const std::vector<const NodeArg*>& subgraph_outputs) override;
 
@@ -137,6 +137,13 @@ Status T5DecoderSubgraph::Validate(const std::vector<const NodeArg*>& subgraph_i
 
   is_output_float16_ = (subgraph_outputs[0]->TypeAsProto()->tensor_type().elem_type() == float16_type);
 
+  if (has_decoder_masked_attention_) {
+    cross_past_shared_by_beams_ = true;
+    for (int i = first_past_input_index_ + 2 * num_layers; i < first_past_input_index_ + 4 * num_layers; i++) {
+      cross_past_shared_by_beams_ = cross_past_shared_by_beams_ && IsSharedByBeams(subgraph_inputs[i]->Name());
+    }
+  }
+
   return Status::OK();
 }
 
@@ -286,6 +293,12 @@ Status T5DecoderSubgraph::CreateInitialFeeds(
       }
       decoder_feeds.push_back(expanded_hidden_states);
     } else {
+      if (cross_past_shared_by_beams_ && j >= first_past_input_index_ + 2 * static_cast<size_t>(num_layers)) {
+        // the beams of each batch entry read the same cross attention past key/value
+        decoder_feeds.push_back(encoder_fetches[j]);
+        continue;
+      }
+
       // past key/value for cross attention does not need to be initialized with max_seq_len since they are static.
       bool use_max_seq_len = (j - first_past_input_index_) < 2 * static_cast<size_t>(num_layers);
 
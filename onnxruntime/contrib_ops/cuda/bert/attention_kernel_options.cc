@@ -30,7 +30,12 @@ void AttentionKernelOptions::Initialize(int value, bool use_build_flag, bool che
   } else {
     use_flash_attention_ = !ParseEnvironmentVariableWithDefault<bool>(kDisableFlashAttention, false);
 #if USE_LEAN_ATTENTION
-    use_lean_attention_ = ParseEnvironmentVariableWithDefault<bool>(kEnableLeanAttention, false);
+    const auto enable_lean_attention = ParseEnvironmentVariable<bool>(kEnableLeanAttention);
+    use_lean_attention_ = enable_lean_attention.value_or(true);
+    if (!enable_lean_attention.has_value()) {
+      min_seq_len_for_lean_attention_ = ParseEnvironmentVariableWithDefault<int>(
+          kMinSeqLenForLeanAttention, kDefaultMinSeqLenForLeanAttention);
+    }
 #endif
     use_efficient_attention_ = !ParseEnvironmentVariableWithDefault<bool>(kDisableMemoryEfficientAttention, false);
     use_trt_fused_attention_ = !ParseEnvironmentVariableWithDefault<bool>(kDisableFusedSelfAttention, false);
@@ -77,6 +82,19 @@ void AttentionKernelOptions::Initialize(int value, bool use_build_flag, bool che
   }
 }
 
+bool AttentionKernelOptions::UseLeanAttentionForDecoding(int batch_size, int num_heads, int total_sequence_length,
+                                                         int multi_processor_count) const {
+  if (!use_lean_attention_) {
+    return false;
+  }
+
+  if (min_seq_len_for_lean_attention_ == 0) {
+    return true;
+  }
+
+  return batch_size * num_heads < multi_processor_count && total_sequence_length >= min_seq_len_for_lean_attention_;
+}
+
 void AttentionKernelOptions::InitializeOnce(
     int sdpa_kernel, bool use_build_flag, bool check_cudnn_version) {
   std::call_once(this->initialize_once_flag_, [&]() {
@@ -93,6 +111,9 @@ void AttentionKernelOptions::Print() const {
   sstream << " FLASH_ATTENTION=" << int(use_flash_attention_);
 #if USE_LEAN_ATTENTION
   sstream << " LEAN_ATTENTION=" << int(use_lean_attention_);
+  if (use_lean_attention_ && min_seq_len_for_lean_attention_ > 0) {
+    sstream << " (total_sequence_length>=" << min_seq_len_for_lean_attention_ << ")";
+  }
 #endif
   sstream << " EFFICIENT_ATTENTION=" << int(use_efficient_attention_);
   sstream << " TRT_FUSED_ATTENTION=" << int(use_trt_fused_attention_);
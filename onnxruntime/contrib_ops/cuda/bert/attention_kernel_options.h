@@ -38,6 +38,14 @@ class AttentionKernelOptions {
 
   int MinSeqLenForFlashAttentionPackedQkv() const { return min_seq_len_for_flash_attention_packed_qkv_; }
   int MinSeqLenForEfficientAttentionFp32() const { return min_seq_len_for_efficient_attention_fp32_; }
+  int MinSeqLenForLeanAttention() const { return min_seq_len_for_lean_attention_; }
+
+  // Selects lean attention for decoding (sequence_length == 1) when it is enabled and, unless it was explicitly
+  // enabled, when batch_size x num_heads can't fill the SMs and the KV sequence is long. Flash attention splits the
+  // KV sequence too, but lean attention balances the tiles of all heads across the SMs and reduces the splits in
+  // the same kernel.
+  bool UseLeanAttentionForDecoding(int batch_size, int num_heads, int total_sequence_length,
+                                   int multi_processor_count) const;
 
  protected:
   void Print() const;
@@ -65,6 +73,9 @@ class AttentionKernelOptions {
 
   int min_seq_len_for_efficient_attention_fp32_{0};
 
+  // 0 when lean attention is explicitly enabled.
+  int min_seq_len_for_lean_attention_{0};
+
   std::once_flag initialize_once_flag_;
 };
 
@@ -169,6 +169,10 @@ Status MultiHeadAttention<T>::ComputeInternal(OpKernelContext* context) const {
   // Lean attention only supports token-generation phase with sequence_length == 1.
   bool use_lean_attention = enable_lean_attention_ &&
                             parameters.sequence_length == 1 &&
+                            kernel_options_->UseLeanAttentionForDecoding(parameters.batch_size,
+                                                                         parameters.num_heads,
+                                                                         parameters.total_sequence_length,
+                                                                         device_prop.multiProcessorCount) &&
                             parameters.past_sequence_length > 0 &&
                             nullptr == attention_bias &&
                             nullptr == key_padding_mask &&
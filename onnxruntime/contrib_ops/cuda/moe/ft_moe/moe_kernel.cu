@@ -983,6 +983,24 @@ void CutlassMoeFCRunner<T, WeightType, Enable>::get_total_rows_info(int64_t expe
     total_covered_rows = total_rows_before_expert_host_[experts_end_index] - total_past_rows;
 }
 
+template <typename T, typename WeightType, typename Enable>
+void CutlassMoeFCRunner<T, WeightType, Enable>::get_expert_row_counts(int num_experts, std::vector<int64_t> &row_counts,
+                                                                      cudaStream_t stream) {
+    // dispatch_activations() copies the totals before making them relative to the local experts.
+    if (total_rows_before_expert_host_.size() != static_cast<size_t>(num_experts)) {
+        total_rows_before_expert_host_.resize(num_experts);
+        cudaMemcpyAsync(total_rows_before_expert_host_.data(), total_rows_before_expert_, num_experts * sizeof(int64_t),
+                        cudaMemcpyDeviceToHost, stream);
+    }
+    cudaStreamSynchronize(stream);
+
+    row_counts.resize(num_experts);
+    for (int expert = 0; expert < num_experts; ++expert) {
+        row_counts[expert] =
+            total_rows_before_expert_host_[expert] - (expert > 0 ? total_rows_before_expert_host_[expert - 1] : 0);
+    }
+}
+
 // ========================== Permutation things =======================================
 
 // Duplicated and permutes rows for MoE. In addition, reverse the permutation map to help with finalizing routing.
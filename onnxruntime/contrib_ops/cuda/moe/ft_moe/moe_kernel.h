@@ -138,6 +138,9 @@ class CutlassMoeFCRunner {
   void get_total_rows_info(int64_t experts_start_index, int64_t local_num_experts, int64_t& total_past_rows,
                            int64_t& total_covered_rows);
 
+  // Gets the number of expanded rows routed to each of the num_experts experts by the last run. Waits for the stream.
+  void get_expert_row_counts(int num_experts, std::vector<int64_t>& row_counts, cudaStream_t stream);
+
  private:
   void configure_ws_ptrs(char* ws_ptr, size_t num_rows, size_t hidden_size, size_t inter_size, size_t num_experts,
                          size_t k);
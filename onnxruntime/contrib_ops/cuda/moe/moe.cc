@@ -97,6 +97,8 @@ Status MoE<T>::ComputeInternal(OpKernelContext* context) const {
       reinterpret_cast<int*>(expanded_source_row_to_expanded_dest_row.get()),
       reinterpret_cast<int*>(expert_for_source_row.get()), Stream(context));
 
+  LogExpertLoad(moe_runner, context->Logger(), moe_params, Stream(context));
+
   Tensor* output = context->Output(0, input->Shape());
 
   ort_fastertransformer::finalize_moe_routing_kernelLauncher(
@@ -3,7 +3,13 @@
 
 #pragma once
 
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
 #include "core/common/common.h"
+#include "core/common/logging/logging.h"
 #include "core/framework/tensor_shape.h"
 #include "core/framework/op_kernel.h"
 #include "contrib_ops/cuda/moe/ft_moe/moe_gemm_kernels.h"
@@ -233,6 +239,30 @@ class MoEBase {
     }
   }
 
+  // Logs the number of rows routed to each expert by the last run of moe_runner, and the ratio of the most loaded
+  // expert to the mean, to show the imbalance of the routing. Only done with verbose logging, as it waits for stream.
+  template <typename Runner>
+  void LogExpertLoad(Runner& moe_runner, const logging::Logger& logger, const MoEParameters& parameters,
+                     cudaStream_t stream) const {
+    if (!logger.OutputIsEnabled(logging::Severity::kVERBOSE, logging::DataType::SYSTEM)) {
+      return;
+    }
+
+    std::vector<int64_t> row_counts;
+    moe_runner.get_expert_row_counts(static_cast<int>(parameters.num_experts), row_counts, stream);
+
+    const int64_t total_rows = std::accumulate(row_counts.begin(), row_counts.end(), int64_t{0});
+    const int64_t max_rows = row_counts.empty() ? 0 : *std::max_element(row_counts.begin(), row_counts.end());
+    std::ostringstream counts;
+    for (size_t i = 0; i < row_counts.size(); ++i) {
+      counts << (i == 0 ? "" : ",") << row_counts[i];
+    }
+
+    LOGS(logger, VERBOSE) << "MoE rows per expert: [" << counts.str() << "], max/mean load: "
+                          << (total_rows > 0 ? static_cast<double>(max_rows) * parameters.num_experts / total_rows
+                                             : 0.0);
+  }
+
   bool normalize_routing_weights_;
   bool use_sparse_mixer_;
   int64_t k_;
@@ -15,6 +15,9 @@ namespace webgpu {
 
 using namespace onnxruntime::webgpu;
 
+// Declares total_sequence_length and past_sequence_length for the batch, which are read from seqlen_k for GQA.
+void InitVarStub(std::ostringstream& ss, const Tensor* seqlen_k, bool is_first_prompt);
+
 class TransferBSDToBNSHProgram final : public Program<TransferBSDToBNSHProgram> {
  public:
   TransferBSDToBNSHProgram(bool has_bias) : Program{"TransferBSDToBNSH"}, has_bias_(has_bias) {}
@@ -0,0 +1,240 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/webgpu/bert/flash_attention.h"
+
+#include "contrib_ops/webgpu/bert/attention.h"
+#include "core/providers/webgpu/webgpu_supported_types.h"
+using namespace onnxruntime::webgpu;
+using namespace ::onnxruntime::common;
+
+namespace onnxruntime {
+namespace contrib {
+namespace webgpu {
+
+namespace {
+
+// Number of query rows, one per invocation, processed by a workgroup.
+constexpr int kFlashAttentionTileSize = 64;
+// Number of keys staged in workgroup memory per iteration.
+constexpr int kFlashAttentionKVTileSize = 16;
+// The per-row accumulators are kept in private memory, which bounds the supported head size.
+constexpr int kFlashAttentionMaxHeadSize = 128;
+
+}  // namespace
+
+Status FlashAttentionProgram::GenerateShaderCode(ShaderHelper& shader) const {
+  shader.AddInput("q", ShaderUsage::UseUniform | ShaderUsage::UseValueTypeAlias);
+  shader.AddInput("key", ShaderUsage::UseUniform);
+  shader.AddInput("value", ShaderUsage::UseUniform);
+  if (feed_past_) {
+    shader.AddInput("past_key", ShaderUsage::UseUniform);
+    shader.AddInput("past_value", ShaderUsage::UseUniform);
+  }
+  if (has_attention_bias_) {
+    shader.AddInput("attention_bias", ShaderUsage::UseUniform);
+  }
+  if (seqlen_k_ != nullptr) {
+    shader.AddInput("seqlen_k", ShaderUsage::UseUniform);
+  }
+  shader.AddOutput("output", ShaderUsage::UseUniform | ShaderUsage::UseValueTypeAlias);
+  if (has_present_) {
+    shader.AddOutput("present_key", ShaderUsage::UseUniform);
+    shader.AddOutput("present_value", ShaderUsage::UseUniform);
+  }
+
+  shader.AdditionalImplementation() << "const head_size_vec: u32 = " << head_size_vec_ << "u;\n"
+                                    << "const KV_TILE_SIZE: u32 = " << kv_tile_size_ << "u;\n"
+                                    << "var<workgroup> tileK: array<array<q_value_t, head_size_vec>, KV_TILE_SIZE>;\n"
+                                    << "var<workgroup> tileV: array<array<q_value_t, head_size_vec>, KV_TILE_SIZE>;\n";
+
+  shader.MainFunctionBody() << "let head_idx = workgroup_id.z % uniforms.num_heads;\n"
+                            << "let batch_idx = workgroup_id.z / uniforms.num_heads;\n"
+                            << "let m = workgroup_id.y * TILE_SIZE + local_idx;\n"
+                            << "let sequence_length = uniforms.sequence_length;\n"
+                            << "var total_sequence_length = uniforms.total_sequence_length;\n";
+  std::ostringstream oss;
+  InitVarStub(oss, seqlen_k_, is_first_prompt_);
+  shader.MainFunctionBody() << oss.str();
+
+  // With GQA, n_reps consecutive query heads share one KV head.
+  const std::string past_stride = past_present_share_buffer_ ? "uniforms.present_sequence_length" : "uniforms.past_sequence_length";
+  shader.MainFunctionBody() << "let kv_head_idx = workgroup_id.z / uniforms.n_reps;\n"
+                            << "let kv_offset = kv_head_idx * uniforms.kv_sequence_length * head_size_vec;\n";
+  if (feed_past_ || past_present_share_buffer_) {
+    shader.MainFunctionBody() << "let past_offset = kv_head_idx * " << past_stride << " * head_size_vec;\n";
+  }
+  if (has_present_) {
+    shader.MainFunctionBody() << "let present_offset = kv_head_idx * uniforms.present_sequence_length * head_size_vec;\n"
+                              << "// Only one workgroup of the query heads sharing a KV head appends to the present state.\n"
+                              << "let write_present = workgroup_id.y == 0u && head_idx % uniforms.n_reps == 0u;\n";
+  }
+  shader.MainFunctionBody() << "let seq_causal_length = " << (seqlen_k_ ? "min(past_sequence_length + m + 1u, total_sequence_length)" : "total_sequence_length") << ";\n";
+
+  shader.MainFunctionBody() << "var q_row: array<vec4<f32>, head_size_vec>;\n"
+                            << "var o_row: array<vec4<f32>, head_size_vec>;\n"
+                            << "if (m < sequence_length) {\n"
+                            << "  let q_offset = (workgroup_id.z * sequence_length + m) * head_size_vec;\n"
+                            << "  for (var d = 0u; d < head_size_vec; d++) {\n"
+                            << "    q_row[d] = vec4<f32>(q[q_offset + d]) * uniforms.alpha;\n"
+                            << "  }\n"
+                            << "}\n"
+                            << "var row_max = f32(-3.402823e+38f);\n"
+                            << "var row_sum = f32(0);\n"
+                            << "var scores: array<f32, KV_TILE_SIZE>;\n";
+
+  // Stage the next KV_TILE_SIZE keys and values, taken from the past state for positions before
+  // past_sequence_length and from the new K and V after it. The loop is bounded by the uniform total sequence
+  // length, which covers the per batch length read from seqlen_k, so that the barriers stay in uniform control flow.
+  shader.MainFunctionBody() << "for (var t = 0u; t < uniforms.total_sequence_length; t += KV_TILE_SIZE) {\n"
+                            << "  for (var i = local_idx; i < KV_TILE_SIZE * head_size_vec; i += TILE_SIZE) {\n"
+                            << "    let j = i / head_size_vec;\n"
+                            << "    let d = i % head_size_vec;\n"
+                            << "    let pos = t + j;\n"
+                            << "    var k_value = q_value_t(0);\n"
+                            << "    var v_value = q_value_t(0);\n";
+  if (feed_past_ || past_present_share_buffer_) {
+    const std::string past_key = past_present_share_buffer_ ? "present_key" : "past_key";
+    const std::string past_value = past_present_share_buffer_ ? "present_value" : "past_value";
+    shader.MainFunctionBody() << "    if (pos < past_sequence_length) {\n"
+                              << "      k_value = " << past_key << "[past_offset + pos * head_size_vec + d];\n"
+                              << "      v_value = " << past_value << "[past_offset + pos * head_size_vec + d];\n"
+                              << "    } else if (pos < total_sequence_length) {\n";
+  } else {
+    shader.MainFunctionBody() << "    if (pos < total_sequence_length) {\n";
+  }
+  shader.MainFunctionBody() << "      let new_offset = kv_offset + (pos - past_sequence_length) * head_size_vec + d;\n"
+                            << "      k_value = key[new_offset];\n"
+                            << "      v_value = value[new_offset];\n"
+                            << "    }\n";
+  if (has_present_) {
+    if (past_present_share_buffer_) {
+      shader.MainFunctionBody() << "    if (write_present && pos >= past_sequence_length && pos < total_sequence_length) {\n";
+    } else {
+      shader.MainFunctionBody() << "    if (write_present && pos < total_sequence_length) {\n";
+    }
+    shader.MainFunctionBody() << "      present_key[present_offset + pos * head_size_vec + d] = k_value;\n"
+                              << "      present_value[present_offset + pos * head_size_vec + d] = v_value;\n"
+                              << "    }\n";
+  }
+  shader.MainFunctionBody() << "    tileK[j][d] = k_value;\n"
+                            << "    tileV[j][d] = v_value;\n"
+                            << "  }\n"
+                            << "  workgroupBarrier();\n";
+
+  // Rescale the running output by exp(old_max - new_max) once per tile instead of once per key.
+  shader.MainFunctionBody() << "  if (m < sequence_length && t < seq_causal_length) {\n"
+                            << "    let tile_length = min(KV_TILE_SIZE, seq_causal_length - t);\n"
+                            << "    var tile_max = row_max;\n"
+                            << "    for (var j = 0u; j < tile_length; j++) {\n"
+                            << "      var score = f32(0);\n"
+                            << "      for (var d = 0u; d < head_size_vec; d++) {\n"
+                            << "        score += dot(q_row[d], vec4<f32>(tileK[j][d]));\n"
+                            << "      }\n";
+  if (has_attention_bias_) {
+    shader.MainFunctionBody() << "      score += f32(attention_bias[(workgroup_id.z * sequence_length + m) * uniforms.total_sequence_length + t + j]);\n";
+  }
+  shader.MainFunctionBody() << "      scores[j] = score;\n"
+                            << "      tile_max = max(tile_max, score);\n"
+                            << "    }\n"
+                            << "    let correction = exp(row_max - tile_max);\n"
+                            << "    row_sum *= correction;\n"
+                            << "    for (var d = 0u; d < head_size_vec; d++) {\n"
+                            << "      o_row[d] *= correction;\n"
+                            << "    }\n"
+                            << "    for (var j = 0u; j < tile_length; j++) {\n"
+                            << "      let p = exp(scores[j] - tile_max);\n"
+                            << "      row_sum += p;\n"
+                            << "      for (var d = 0u; d < head_size_vec; d++) {\n"
+                            << "        o_row[d] += p * vec4<f32>(tileV[j][d]);\n"
+                            << "      }\n"
+                            << "    }\n"
+                            << "    row_max = tile_max;\n"
+                            << "  }\n"
+                            << "  workgroupBarrier();\n"
+                            << "}\n";
+
+  shader.MainFunctionBody() << "// The output is written in BSND format.\n"
+                            << "if (m < sequence_length) {\n"
+                            << "  let inv_sum = select(f32(0), 1.0 / row_sum, row_sum > 0.0);\n"
+                            << "  let output_offset = ((batch_idx * sequence_length + m) * uniforms.num_heads + head_idx) * head_size_vec;\n"
+                            << "  for (var d = 0u; d < head_size_vec; d++) {\n"
+                            << "    output[output_offset + d] = output_value_t(o_row[d] * inv_sum);\n"
+                            << "  }\n"
+                            << "}\n";
+
+  return Status::OK();
+}
+
+bool CanApplyFlashAttention(const Tensor* Q, const WebgpuAttentionParameters& parameters,
+                            onnxruntime::webgpu::ComputeContext& context) {
+  // Decoding a single token is better served by the three pass path, which parallelizes over the keys.
+  if (parameters.sequence_length_ <= 1 ||
+      parameters.head_size_ != parameters.v_head_size_ ||
+      parameters.head_size_ % 4 != 0 ||
+      parameters.head_size_ > kFlashAttentionMaxHeadSize) {
+    return false;
+  }
+  const uint64_t tile_bytes = uint64_t{2} * kFlashAttentionKVTileSize * parameters.head_size_ * Q->DataType()->Size();
+  return tile_bytes <= context.DeviceLimits().maxComputeWorkgroupStorageSize;
+}
+
+Status ApplyFlashAttention(const Tensor* Q, const Tensor* K, const Tensor* V, const Tensor* attention_bias,
+                           const Tensor* past_key, const Tensor* past_value, Tensor* output, Tensor* present_key, Tensor* present_value,
+                           WebgpuAttentionParameters& parameters, onnxruntime::webgpu::ComputeContext& context, const Tensor* seqlen_k) {
+  const int output_count = std::min({context.OutputCount(), 1 + (past_key != nullptr ? 1 : 0) + (past_value != nullptr ? 1 : 0)});
+  const int past_sequence_length = output_count > 1 ? parameters.past_sequence_length_ : 0;
+  const int total_sequence_length = past_sequence_length + parameters.kv_sequence_length_;
+  const float alpha = parameters.scale_ == 0.0f ? 1.f / sqrt(static_cast<float>(parameters.head_size_))
+                                                : parameters.scale_;
+
+  const bool has_present = output_count > 1 && past_key != nullptr && present_key != nullptr && present_value != nullptr;
+  const bool feed_past = has_present && past_key->SizeInBytes() > 0 && past_value != nullptr && !parameters.past_present_share_buffer_;
+  const bool has_attention_bias = attention_bias != nullptr;
+  const bool past_present_share_buffer = has_present && parameters.past_present_share_buffer_;
+  constexpr int components = 4;
+  const int head_size_vec = parameters.head_size_ / components;
+
+  FlashAttentionProgram program{"FlashAttention", feed_past, has_present, has_attention_bias, head_size_vec,
+                                kFlashAttentionKVTileSize, parameters.is_first_prompt_, parameters.n_reps, seqlen_k,
+                                past_present_share_buffer};
+  program.AddInputs({{Q, ProgramTensorMetadataDependency::TypeAndRank, components},
+                     {K, ProgramTensorMetadataDependency::TypeAndRank, components},
+                     {V, ProgramTensorMetadataDependency::TypeAndRank, components}});
+  if (feed_past) {
+    program.AddInputs({{past_key, ProgramTensorMetadataDependency::TypeAndRank, components},
+                       {past_value, ProgramTensorMetadataDependency::TypeAndRank, components}});
+  }
+  if (has_attention_bias) {
+    program.AddInput({attention_bias, ProgramTensorMetadataDependency::TypeAndRank});
+  }
+  if (seqlen_k != nullptr) {
+    program.AddInput({seqlen_k, ProgramTensorMetadataDependency::TypeAndRank});
+  }
+  program.AddOutput({output, ProgramTensorMetadataDependency::TypeAndRank, components});
+  if (has_present) {
+    program.AddOutputs({{present_key, ProgramTensorMetadataDependency::Rank, components},
+                        {present_value, ProgramTensorMetadataDependency::Rank, components}});
+  }
+
+  program.SetDispatchGroupSize(1,
+                               (parameters.sequence_length_ + kFlashAttentionTileSize - 1) / kFlashAttentionTileSize,
+                               parameters.batch_size_ * parameters.num_heads_)
+      .SetWorkgroupSize(kFlashAttentionTileSize)
+      .CacheHint(std::to_string(kFlashAttentionTileSize), head_size_vec, past_present_share_buffer, feed_past, has_present, has_attention_bias, seqlen_k != nullptr, parameters.is_first_prompt_)
+      .AddUniformVariables({{static_cast<uint32_t>(parameters.sequence_length_)},
+                            {static_cast<uint32_t>(total_sequence_length)},
+                            {static_cast<uint32_t>(parameters.num_heads_)},
+                            {static_cast<float>(alpha)},
+                            {static_cast<uint32_t>(past_sequence_length)},
+                            {static_cast<uint32_t>(parameters.kv_sequence_length_)},
+                            {static_cast<uint32_t>(seqlen_k == nullptr ? total_sequence_length : parameters.seqlen_present_kv_cache_)},
+                            {static_cast<uint32_t>(parameters.n_reps)}})
+      .SetOverridableConstants({{static_cast<uint32_t>(kFlashAttentionTileSize)}});
+
+  return context.RunProgram(program);
+}
+
+}  // namespace webgpu
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/webgpu/compute_context.h"
+#include "core/providers/webgpu/program.h"
+#include "core/providers/webgpu/shader_helper.h"
+#include "core/providers/webgpu/webgpu_kernel.h"
+#include "contrib_ops/webgpu/bert/attention_common.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace webgpu {
+
+using namespace onnxruntime::webgpu;
+
+// Computes softmax(Q * K' * alpha + attention_bias) * V in a single pass without materializing the attention
+// probabilities. Each invocation owns one query row, and the workgroup stages tiles of K and V in workgroup memory
+// while every row keeps a running max and sum of the softmax (online softmax). The new K and V are appended to
+// present_key and present_value by the same dispatch.
+class FlashAttentionProgram final : public Program<FlashAttentionProgram> {
+ public:
+  FlashAttentionProgram(const std::string& kernel_name, bool feed_past, bool has_present, bool has_attention_bias,
+                        int head_size_vec, int kv_tile_size, bool is_first_prompt, int n_reps = 1,
+                        const Tensor* seqlen_k = nullptr, bool past_present_share_buffer = false)
+      : Program{kernel_name}, feed_past_(feed_past), has_present_(has_present), has_attention_bias_(has_attention_bias), head_size_vec_(head_size_vec), kv_tile_size_(kv_tile_size), n_reps_(n_reps), seqlen_k_(seqlen_k), past_present_share_buffer_(past_present_share_buffer), is_first_prompt_(is_first_prompt) {
+  }
+
+  Status GenerateShaderCode(ShaderHelper& sh) const override;
+
+  WEBGPU_PROGRAM_DEFINE_UNIFORM_VARIABLES({"sequence_length", ProgramUniformVariableDataType::Uint32},
+                                          {"total_sequence_length", ProgramUniformVariableDataType::Uint32},
+                                          {"num_heads", ProgramUniformVariableDataType::Uint32},
+                                          {"alpha", ProgramUniformVariableDataType::Float32},
+                                          {"past_sequence_length", ProgramUniformVariableDataType::Uint32},
+                                          {"kv_sequence_length", ProgramUniformVariableDataType::Uint32},
+                                          {"present_sequence_length", ProgramUniformVariableDataType::Uint32},
+                                          {"n_reps", ProgramUniformVariableDataType::Uint32});
+
+  WEBGPU_PROGRAM_DEFINE_OVERRIDABLE_CONSTANTS({"TILE_SIZE", ProgramConstantDataType::Uint32});
+
+ private:
+  bool feed_past_;
+  bool has_present_;
+  bool has_attention_bias_;
+  int head_size_vec_;
+  int kv_tile_size_;
+  int n_reps_;
+  const Tensor* seqlen_k_;
+  bool past_present_share_buffer_;
+  bool is_first_prompt_;
+};
+
+// Returns true if ApplyFlashAttention() supports the given attention. The fused program is used for prompts, where
+// there are enough query rows to fill a workgroup, and requires K and V to have the same, vec4 aligned, head size.
+bool CanApplyFlashAttention(const Tensor* Q, const WebgpuAttentionParameters& parameters,
+                            onnxruntime::webgpu::ComputeContext& context);
+
+Status ApplyFlashAttention(const Tensor* Q, const Tensor* K, const Tensor* V, const Tensor* attention_bias,
+                           const Tensor* past_key, const Tensor* past_value, Tensor* output, Tensor* present_key, Tensor* present_value,
+                           WebgpuAttentionParameters& parameters, onnxruntime::webgpu::ComputeContext& context, const Tensor* seqlen_k = nullptr);
+
+}  // namespace webgpu
+}  // namespace contrib
+}  // namespace onnxruntime
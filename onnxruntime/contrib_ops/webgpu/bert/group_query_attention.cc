@@ -24,6 +24,7 @@ ONNX_OPERATOR_KERNEL_EX(
     kWebGpuExecutionProvider,
     (*KernelDefBuilder::Create())
         .TypeConstraint("T", WebGpuSupportedFloatTypes())
+        .TypeConstraint("T_CACHE", WebGpuSupportedFloatTypes())
         .MayInplace(3, 1)
         .MayInplace(4, 2)
         .InputMemoryType(OrtMemTypeCPUInput, 6),
@@ -39,6 +40,9 @@ Status GroupQueryAttention::ComputeInternal(onnxruntime::webgpu::ComputeContext&
   const Tensor* total_seqlen_tensor = context.Input<Tensor>(6);
   const Tensor* cos_cache = context.Input<Tensor>(7);
   const Tensor* sin_cache = context.Input<Tensor>(8);
+  if (context.Input<Tensor>(9) != nullptr) {
+    ORT_NOT_IMPLEMENTED("Paged kv cache (block_table) is not implemented for webgpu-ep.");
+  }
 
   GroupQueryAttentionParameters params;
   ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckInputs(query,
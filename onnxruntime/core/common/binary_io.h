@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "core/common/narrow.h"
+
+// Helpers for the binary cache files written by ONNX Runtime, like the memory pattern, pre-packed weights, cost
+// calibration and WebGPU pipeline caches. The files are only read on the machine that wrote them, so values are
+// written in the byte order of the host.
+//
+// The files start with a common header:
+//   uint32 magic, uint32 version, uint64 identity length, identity bytes
+// The identity holds what the contents depend on besides the version, e.g. the build of ONNX Runtime and the CPU,
+// and may be empty. A string is written as its uint64 length followed by its bytes.
+
+namespace onnxruntime {
+namespace binary_io {
+
+template <typename T>
+void WritePod(std::ostream& out, const T& value) {
+  static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written as bytes.");
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void WriteString(std::ostream& out, std::string_view str) {
+  WritePod(out, static_cast<uint64_t>(str.size()));
+  out.write(str.data(), str.size());
+}
+
+inline void WriteHeader(std::ostream& out, uint32_t magic, uint32_t version, std::string_view identity) {
+  WritePod(out, magic);
+  WritePod(out, version);
+  WriteString(out, identity);
+}
+
+// Number of bytes written by WriteHeader().
+inline size_t HeaderSize(std::string_view identity) {
+  return sizeof(uint32_t) * 2 + sizeof(uint64_t) + identity.size();
+}
+
+enum class HeaderStatus {
+  kOk,
+  // not a file of the expected kind and version, or a truncated one
+  kInvalid,
+  // a file written with another identity
+  kIdentityMismatch,
+};
+
+// Reads the values written to a stream.
+class StreamReader {
+ public:
+  explicit StreamReader(std::istream& in) : in_{in} {}
+
+  template <typename T>
+  bool ReadPod(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as bytes.");
+    in_.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in_);
+  }
+
+  // Fails if the string is longer than max_length, which keeps a corrupted length from allocating a huge string.
+  bool ReadString(std::string& str, uint64_t max_length = std::numeric_limits<uint32_t>::max()) {
+    uint64_t length = 0;
+    if (!ReadPod(length) || length > max_length) {
+      return false;
+    }
+    str.resize(narrow<size_t>(length));
+    in_.read(str.data(), str.size());
+    return static_cast<bool>(in_);
+  }
+
+ private:
+  std::istream& in_;
+};
+
+// Reads the values written to a file from a buffer holding it, e.g. a mapped file.
+class BufferReader {
+ public:
+  BufferReader(const char* data, size_t size) : data_{data}, size_{size} {}
+
+  template <typename T>
+  bool ReadPod(T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read as bytes.");
+    if (size_ - pos_ < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data_ + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+
+  bool ReadString(std::string& str, uint64_t max_length = std::numeric_limits<uint64_t>::max()) {
+    uint64_t length = 0;
+    if (!ReadPod(length) || length > max_length || size_ - pos_ < length) {
+      return false;
+    }
+    str.assign(data_ + pos_, narrow<size_t>(length));
+    pos_ += narrow<size_t>(length);
+    return true;
+  }
+
+  size_t Position() const { return pos_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+// Reads the header written by WriteHeader() with a reader above, and checks it against the expected values.
+template <typename Reader>
+HeaderStatus ReadHeader(Reader& reader, uint32_t magic, uint32_t version, std::string_view identity) {
+  uint32_t file_magic = 0, file_version = 0;
+  if (!reader.ReadPod(file_magic) || file_magic != magic || !reader.ReadPod(file_version) ||
+      file_version != version) {
+    return HeaderStatus::kInvalid;
+  }
+
+  // a longer identity is a mismatch, there is no need to read all of it
+  std::string file_identity;
+  if (!reader.ReadString(file_identity, identity.size() + 1)) {
+    return HeaderStatus::kIdentityMismatch;
+  }
+  return file_identity == identity ? HeaderStatus::kOk : HeaderStatus::kIdentityMismatch;
+}
+
+}  // namespace binary_io
+}  // namespace onnxruntime
@@ -15,6 +15,7 @@
 #if defined(CPUIDINFO_ARCH_ARM)
 
 #include <sys/auxv.h>
+#include <sys/prctl.h>
 #include <asm/hwcap.h>
 // N.B. Support building with older versions of asm/hwcap.h that do not define
 // this capability bit.
@@ -22,6 +23,10 @@
 #define HWCAP_ASIMDDP (1 << 20)
 #endif
 
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1 << 22)
+#endif
+
 #ifndef HWCAP2_I8MM
 #define HWCAP2_I8MM (1 << 13)
 #endif
@@ -34,6 +39,14 @@
 #define HWCAP2_BF16 (1 << 14)
 #endif
 
+#ifndef PR_SVE_GET_VL
+#define PR_SVE_GET_VL 51
+#endif
+
+#ifndef PR_SVE_VL_LEN_MASK
+#define PR_SVE_VL_LEN_MASK 0xffff
+#endif
+
 #endif  // ARM
 
 #endif  // Linux
@@ -157,6 +170,7 @@ void CPUIDInfo::ArmLinuxInit() {
     has_arm_neon_i8mm_ = cpuinfo_has_arm_i8mm();
     has_arm_sve_i8mm_ = cpuinfo_has_arm_sve() && cpuinfo_has_arm_i8mm();
     has_arm_neon_bf16_ = cpuinfo_has_arm_neon_bf16();
+    has_arm_sve_ = cpuinfo_has_arm_sve();
 
     const uint32_t core_cnt = cpuinfo_get_cores_count();
     core_uarchs_.resize(core_cnt, cpuinfo_uarch_unknown);
@@ -188,6 +202,17 @@ void CPUIDInfo::ArmLinuxInit() {
     has_arm_sve_i8mm_ = ((getauxval(AT_HWCAP2) & HWCAP2_SVEI8MM) != 0);
 
     has_arm_neon_bf16_ = ((getauxval(AT_HWCAP2) & HWCAP2_BF16) != 0);
+    has_arm_sve_ = ((getauxval(AT_HWCAP) & HWCAP_SVE) != 0);
+  }
+
+  // The vector length is chosen by the kernel for each thread, new threads inherit the length of their creator.
+  if (has_arm_sve_) {
+    const int sve_vl = prctl(PR_SVE_GET_VL);
+    if (sve_vl > 0) {
+      arm_sve_vector_length_ = static_cast<uint32_t>(sve_vl & PR_SVE_VL_LEN_MASK);
+    } else {
+      has_arm_sve_ = false;
+    }
   }
 }
 
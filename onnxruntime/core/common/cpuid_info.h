@@ -31,6 +31,12 @@ class CPUIDInfo {
   bool HasArmNeon_I8MM() const { return has_arm_neon_i8mm_; }
   bool HasArmSVE_I8MM() const { return has_arm_sve_i8mm_; }
   bool HasArmNeon_BF16() const { return has_arm_neon_bf16_; }
+  bool HasArmSVE() const { return has_arm_sve_; }
+
+  /**
+   * @return SVE vector length in bytes, or 0 if SVE is not available
+   */
+  uint32_t GetArmSVEVectorLengthInBytes() const { return arm_sve_vector_length_; }
 
   uint32_t GetCurrentCoreIdx() const;
 
@@ -117,6 +123,8 @@ class CPUIDInfo {
   bool has_arm_neon_i8mm_{false};
   bool has_arm_sve_i8mm_{false};
   bool has_arm_neon_bf16_{false};
+  bool has_arm_sve_{false};
+  uint32_t arm_sve_vector_length_{0};
 
 #if defined(CPUIDINFO_ARCH_X86)
 
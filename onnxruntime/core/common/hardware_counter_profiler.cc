@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/hardware_counter_profiler.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#endif
+
+namespace onnxruntime {
+namespace profiling {
+
+#if defined(__linux__)
+namespace {
+
+constexpr uint64_t kCacheLineSize = 64;
+
+constexpr std::array<uint64_t, 3> kCounterConfigs = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+};
+
+using CounterValues = std::array<uint64_t, kCounterConfigs.size()>;
+
+// The counters of one thread. They are opened as a group so a single read() returns all of them.
+class ThreadCounters {
+ public:
+  ThreadCounters() {
+    for (size_t i = 0; i < kCounterConfigs.size(); ++i) {
+      perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = kCounterConfigs[i];
+      attr.read_format = PERF_FORMAT_GROUP;
+      // user space only, which doesn't require the perf_event_paranoid level to be lowered
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+
+      const int group_fd = fds_.empty() ? -1 : fds_[0];
+      const int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, /*pid*/ 0, /*cpu*/ -1, group_fd, 0));
+      if (fd < 0) {
+        error_ = errno;
+        Close();
+        return;
+      }
+      fds_.push_back(fd);
+    }
+  }
+
+  ~ThreadCounters() {
+    Close();
+  }
+
+  bool IsValid() const {
+    return !fds_.empty();
+  }
+
+  int Error() const {
+    return error_;
+  }
+
+  bool Read(CounterValues& values) const {
+    if (!IsValid()) {
+      return false;
+    }
+
+    // layout of PERF_FORMAT_GROUP: the number of counters followed by their values
+    std::array<uint64_t, kCounterConfigs.size() + 1> buffer{};
+    if (read(fds_[0], buffer.data(), sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) ||
+        buffer[0] != kCounterConfigs.size()) {
+      return false;
+    }
+
+    std::copy(buffer.begin() + 1, buffer.end(), values.begin());
+    return true;
+  }
+
+ private:
+  void Close() {
+    for (int fd : fds_) {
+      close(fd);
+    }
+    fds_.clear();
+  }
+
+  std::vector<int> fds_;
+  int error_{0};
+};
+
+ThreadCounters& GetThreadCounters() {
+  thread_local ThreadCounters counters;
+  return counters;
+}
+
+class HardwareCounterProfiler final : public EpProfiler {
+ public:
+  explicit HardwareCounterProfiler(const logging::Logger& logger) : logger_(logger) {}
+
+  bool StartProfiling(TimePoint /*profiling_start_time*/) override {
+    const ThreadCounters& counters = GetThreadCounters();
+    if (!counters.IsValid()) {
+      LOGS(logger_, WARNING) << "Hardware performance counters are not available. perf_event_open failed with: "
+                             << strerror(counters.Error());
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.clear();
+    return true;
+  }
+
+  void EndProfiling(TimePoint /*start_time*/, Events& events) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& event : events) {
+      if (event.cat != NODE_EVENT) {
+        continue;
+      }
+
+      auto record = records_.find({event.tid, static_cast<uint64_t>(event.ts)});
+      if (record == records_.end()) {
+        continue;
+      }
+
+      const CounterValues& values = record->second;
+      event.args["cpu_cycles"] = std::to_string(values[0]);
+      event.args["instructions"] = std::to_string(values[1]);
+      event.args["llc_misses"] = std::to_string(values[2]);
+      event.args["llc_miss_bytes"] = std::to_string(values[2] * kCacheLineSize);
+    }
+
+    records_.clear();
+  }
+
+  // the id is the time stamp of the event, which is started and stopped on the same thread
+  void Start(uint64_t id) override {
+    CounterValues values;
+    if (GetThreadCounters().Read(values)) {
+      pending_.emplace_back(PendingRead{this, id, values});
+    }
+  }
+
+  void Stop(uint64_t id) override {
+    CounterValues end_values;
+    if (!GetThreadCounters().Read(end_values)) {
+      return;
+    }
+
+    // events nest, so the matching start is normally the last one. Starts that were never stopped, e.g. when
+    // a kernel threw, are dropped.
+    for (auto it = pending_.rbegin(); it != pending_.rend(); ++it) {
+      if (it->profiler != this || it->id != id) {
+        continue;
+      }
+
+      CounterValues deltas;
+      for (size_t i = 0; i < deltas.size(); ++i) {
+        deltas[i] = end_values[i] - it->values[i];
+      }
+      pending_.erase(std::next(it).base(), pending_.end());
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      records_[{static_cast<int>(logging::GetThreadId()), id}] = deltas;
+      return;
+    }
+  }
+
+ private:
+  struct PendingRead {
+    const HardwareCounterProfiler* profiler;
+    uint64_t id;
+    CounterValues values;
+  };
+
+  // starts of the events of the current thread that have not been stopped yet
+  static thread_local std::vector<PendingRead> pending_;
+
+  const logging::Logger& logger_;
+  std::mutex mutex_;
+  // counter deltas by thread id and time stamp of the event
+  std::map<std::pair<int, uint64_t>, CounterValues> records_;
+};
+
+thread_local std::vector<HardwareCounterProfiler::PendingRead> HardwareCounterProfiler::pending_;
+
+}  // namespace
+
+std::unique_ptr<EpProfiler> CreateHardwareCounterProfiler(const logging::Logger& logger) {
+  return std::make_unique<HardwareCounterProfiler>(logger);
+}
+
+#else
+
+std::unique_ptr<EpProfiler> CreateHardwareCounterProfiler(const logging::Logger& logger) {
+  LOGS(logger, WARNING) << "Hardware performance counters are only supported on Linux.";
+  return nullptr;
+}
+
+#endif
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+
+#include "core/common/profiler_common.h"
+#include "core/common/logging/logging.h"
+
+namespace onnxruntime {
+namespace profiling {
+
+/*
+Creates a profiler that reads the hardware performance counters of the calling thread around each profiled event,
+and adds the counts to the args of the node events when profiling ends:
+  "cpu_cycles", "instructions", "llc_misses" and "llc_miss_bytes" (the last level cache misses multiplied by the
+  cache line size, an estimate of the memory traffic of the kernel).
+The counters are read with perf_event_open, so it is only available on Linux, and returns nullptr elsewhere.
+Only the thread that calls the kernel's Compute is counted, not the work the kernel dispatches to the intra-op
+thread pool.
+*/
+std::unique_ptr<EpProfiler> CreateHardwareCounterProfiler(const logging::Logger& logger);
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/logging/sinks/async_sink.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace onnxruntime {
+namespace logging {
+
+namespace {
+uint64_t NextSinkId() {
+  static std::atomic<uint64_t> next_id{0};
+  return next_id++;
+}
+}  // namespace
+
+AsyncSink::AsyncSink(std::unique_ptr<ISink> sink, std::chrono::milliseconds flush_interval)
+    : sink_(std::move(sink)), flush_interval_(flush_interval), id_(NextSinkId()) {
+  thread_ = std::thread([this]() { Run(); });
+}
+
+AsyncSink::~AsyncSink() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    stop_ = true;
+  }
+
+  wake_.notify_one();
+  thread_.join();
+  Flush();
+}
+
+AsyncSink::ThreadBuffer& AsyncSink::GetThreadBuffer() {
+  // the buffers of the sinks this thread logged to. a buffer whose sink was destroyed is only referenced from here.
+  thread_local std::vector<std::pair<uint64_t, std::shared_ptr<ThreadBuffer>>> thread_buffers;
+
+  for (const auto& [id, buffer] : thread_buffers) {
+    if (id == id_) {
+      return *buffer;
+    }
+  }
+
+  thread_buffers.erase(std::remove_if(thread_buffers.begin(), thread_buffers.end(),
+                                      [](const auto& entry) { return entry.second.use_count() == 1; }),
+                       thread_buffers.end());
+
+  auto buffer = std::make_shared<ThreadBuffer>();
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    buffers_.push_back(buffer);
+  }
+
+  thread_buffers.emplace_back(id_, buffer);
+  return *buffer;
+}
+
+void AsyncSink::SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) {
+  ThreadBuffer& buffer = GetThreadBuffer();
+
+  bool buffer_full = false;
+  {
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.messages.push_back(BufferedMessage{timestamp, logger_id, message.Severity(), message.Category(),
+                                              message.DataType(), message.Location(), message.Message()});
+    buffer_full = buffer.messages.size() == kMaxBufferedMessages;
+  }
+
+  if (message.Severity() >= Severity::kERROR) {
+    Flush();
+  } else if (buffer_full) {
+    {
+      std::lock_guard<std::mutex> lock(wake_mutex_);
+      flush_requested_ = true;
+    }
+
+    wake_.notify_one();
+  }
+}
+
+void AsyncSink::Flush() {
+  std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+
+  std::vector<BufferedMessage> messages;
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    auto collect = [&messages](const std::shared_ptr<ThreadBuffer>& buffer) {
+      std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+      // check before taking the messages. the thread may log more and exit right after they're taken.
+      const bool thread_exited = buffer.use_count() == 1;
+      std::move(buffer->messages.begin(), buffer->messages.end(), std::back_inserter(messages));
+      buffer->messages.clear();
+      return thread_exited;
+    };
+
+    buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), collect), buffers_.end());
+  }
+
+  // the messages of each thread are in order. interleave the threads.
+  std::vector<const BufferedMessage*> ordered;
+  ordered.reserve(messages.size());
+  for (const auto& message : messages) {
+    ordered.push_back(&message);
+  }
+
+  std::stable_sort(ordered.begin(), ordered.end(),
+                   [](const BufferedMessage* a, const BufferedMessage* b) { return a->timestamp < b->timestamp; });
+
+  for (const BufferedMessage* message : ordered) {
+    // not associated with a logger so it isn't logged again when destroyed
+    Capture capture(message->severity, message->category, message->data_type, message->location);
+    capture.Stream() << message->message;
+    sink_->Send(message->timestamp, message->logger_id, capture);
+  }
+}
+
+void AsyncSink::Run() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      wake_.wait_for(lock, flush_interval_, [this]() { return stop_ || flush_requested_; });
+      if (stop_) {
+        return;
+      }
+
+      flush_requested_ = false;
+    }
+
+    Flush();
+  }
+}
+
+}  // namespace logging
+}  // namespace onnxruntime
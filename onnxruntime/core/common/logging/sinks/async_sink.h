@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/logging/capture.h"
+#include "core/common/logging/isink.h"
+
+namespace onnxruntime {
+namespace logging {
+/// <summary>
+/// ISink that sends the messages to another sink from a background thread, so the threads that log don't wait for
+/// the I/O of the sink or contend with each other on it.
+/// Each logging thread appends its messages to a buffer of its own. The background thread collects the buffers every
+/// flush interval, or sooner if one holds kMaxBufferedMessages, and sends the messages in timestamp order.
+/// Messages of kERROR severity and above are sent before Send returns so they aren't lost if the process crashes.
+/// </summary>
+/// <seealso cref="ISink" />
+class AsyncSink : public ISink {
+ public:
+  static constexpr size_t kMaxBufferedMessages = 1024;
+
+  explicit AsyncSink(std::unique_ptr<ISink> sink,
+                     std::chrono::milliseconds flush_interval = std::chrono::milliseconds(10));
+
+  /// <summary>
+  /// Sends the buffered messages and stops the background thread.
+  /// </summary>
+  ~AsyncSink() override;
+
+  /// <summary>
+  /// Sends the messages logged so far to the wrapped sink.
+  /// </summary>
+  void Flush();
+
+  void SendProfileEvent(profiling::EventRecord& event_record) const override {
+    sink_->SendProfileEvent(event_record);
+  }
+
+ private:
+  struct BufferedMessage {
+    Timestamp timestamp;
+    std::string logger_id;
+    logging::Severity severity;
+    const char* category;
+    logging::DataType data_type;
+    CodeLocation location;
+    std::string message;
+  };
+
+  struct ThreadBuffer {
+    // only contended when the background thread collects the messages
+    std::mutex mutex;
+    std::vector<BufferedMessage> messages;
+  };
+
+  void SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) override;
+
+  ThreadBuffer& GetThreadBuffer();
+
+  void Run();
+
+  std::unique_ptr<ISink> sink_;
+  const std::chrono::milliseconds flush_interval_;
+  // identifies the sink in the thread local buffer lists, as a new sink may be allocated where a destroyed one was
+  const uint64_t id_;
+
+  std::mutex buffers_mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;  // GUARDED_BY(buffers_mutex_)
+
+  // serializes the sends to sink_
+  std::mutex flush_mutex_;
+
+  std::mutex wake_mutex_;
+  std::condition_variable wake_;
+  bool stop_ = false;             // GUARDED_BY(wake_mutex_)
+  bool flush_requested_ = false;  // GUARDED_BY(wake_mutex_)
+
+  std::thread thread_;
+};
+}  // namespace logging
+}  // namespace onnxruntime
@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/parallel_for_cost_calibration.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+
+#include "core/common/binary_io.h"
+
+namespace onnxruntime {
+namespace concurrency {
+
+namespace {
+
+// File layout, after the header of core/common/binary_io.h with the platform identity:
+//   uint64 number of entries
+//   per entry: string call site file, int32 call site line,
+//              double bytes loaded, double bytes stored, double compute cycles (the declared cost),
+//              double calibrated cycles per unit
+constexpr uint32_t kCostCalibrationFileMagic = 0x4346504F;  // "OPFC"
+constexpr uint32_t kCostCalibrationFileVersion = 2;
+
+// The cost model of the thread pool counts cycles. Measured times are converted with a nominal clock rate, which
+// only needs to be in the range of the clocks the model's thresholds were chosen for.
+constexpr double kCyclesPerNanosecond = 3.0;
+
+// a call site file name is a path, anything longer is a corrupted length
+constexpr uint64_t kMaxCallSiteFileLength = 4096;
+
+}  // namespace
+
+size_t ParallelForCostCalibration::KeyHash::operator()(const Key& key) const {
+  size_t hash = std::hash<std::string_view>{}(key.file);
+  hash ^= std::hash<int>{}(key.line) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  hash ^= std::hash<double>{}(key.bytes_loaded) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  hash ^= std::hash<double>{}(key.bytes_stored) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  hash ^= std::hash<double>{}(key.compute_cycles) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  return hash;
+}
+
+bool ParallelForCostCalibration::GetCost(const ParallelForCallSite& call_site, const TensorOpCost& declared,
+                                         TensorOpCost& cost) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(MakeKey(call_site, declared));
+  if (it != entries_.end() && it->second.cycles_per_unit >= 0.0) {
+    cost = TensorOpCost{0, 0, it->second.cycles_per_unit};
+    return false;
+  }
+  cost = declared;
+  // once the table is full, new loops keep their declared cost and are not timed
+  return it != entries_.end() || entries_.size() < max_entries_;
+}
+
+void ParallelForCostCalibration::AddSample(const ParallelForCallSite& call_site, const TensorOpCost& declared,
+                                           std::ptrdiff_t num_units, std::chrono::nanoseconds busy_time) {
+  if (num_units <= 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Key key = MakeKey(call_site, declared);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    if (entries_.size() >= max_entries_) {
+      return;
+    }
+    it = entries_.emplace(key, Entry{}).first;
+  }
+
+  Entry& entry = it->second;
+  if (entry.cycles_per_unit >= 0.0) {
+    // calibrated by a concurrent loop
+    return;
+  }
+
+  entry.samples.push_back(static_cast<double>(busy_time.count()) / static_cast<double>(num_units));
+  if (entry.samples.size() == kNumSamples) {
+    // the median discards the first loops, which run with cold caches
+    auto median = entry.samples.begin() + kNumSamples / 2;
+    std::nth_element(entry.samples.begin(), median, entry.samples.end());
+    entry.cycles_per_unit = *median * kCyclesPerNanosecond;
+    entry.samples = {};
+    ++num_calibrated_;
+    dirty_ = true;
+  }
+}
+
+size_t ParallelForCostCalibration::NumCalibratedEntries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_calibrated_;
+}
+
+bool ParallelForCostCalibration::IsDirty() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dirty_;
+}
+
+Status ParallelForCostCalibration::Save(const PathString& file_path, const std::string& platform_identity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+  ORT_RETURN_IF_NOT(out, "Failed to open thread pool cost calibration file for writing: ",
+                    PathToUTF8String(file_path));
+
+  using namespace binary_io;
+  WriteHeader(out, kCostCalibrationFileMagic, kCostCalibrationFileVersion, platform_identity);
+  WritePod(out, static_cast<uint64_t>(num_calibrated_));
+  for (const auto& [key, entry] : entries_) {
+    if (entry.cycles_per_unit < 0.0) {
+      continue;
+    }
+    WriteString(out, key.file);
+    WritePod(out, static_cast<int32_t>(key.line));
+    WritePod(out, key.bytes_loaded);
+    WritePod(out, key.bytes_stored);
+    WritePod(out, key.compute_cycles);
+    WritePod(out, entry.cycles_per_unit);
+  }
+
+  ORT_RETURN_IF_NOT(out.good(), "Failed to write thread pool cost calibration file: ", PathToUTF8String(file_path));
+  dirty_ = false;
+  return Status::OK();
+}
+
+Status ParallelForCostCalibration::Load(const PathString& file_path, const std::string& platform_identity) {
+  std::ifstream in(file_path, std::ios::binary);
+  ORT_RETURN_IF_NOT(in, "Failed to open thread pool cost calibration file: ", PathToUTF8String(file_path));
+
+  binary_io::StreamReader reader(in);
+  const auto header = binary_io::ReadHeader(reader, kCostCalibrationFileMagic, kCostCalibrationFileVersion,
+                                            platform_identity);
+  ORT_RETURN_IF(header == binary_io::HeaderStatus::kInvalid,
+                "Invalid thread pool cost calibration file: ", PathToUTF8String(file_path));
+  ORT_RETURN_IF(header == binary_io::HeaderStatus::kIdentityMismatch,
+                "Thread pool cost calibration file was written by another build or on another machine: ",
+                PathToUTF8String(file_path));
+
+  uint64_t num_entries = 0;
+  ORT_RETURN_IF_NOT(reader.ReadPod(num_entries), "Truncated thread pool cost calibration file.");
+
+  // parse everything before touching the entries so a bad file doesn't leave them partially populated.
+  // the file names of the call sites are interned in file_names_ once the file is accepted.
+  struct LoadedEntry {
+    std::string file;
+    Key key;
+    double cycles_per_unit;
+  };
+  std::vector<LoadedEntry> loaded;
+  loaded.reserve(static_cast<size_t>(std::min<uint64_t>(num_entries, max_entries_)));
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    LoadedEntry entry{};
+    int32_t line = 0;
+    ORT_RETURN_IF_NOT(reader.ReadString(entry.file, kMaxCallSiteFileLength) && reader.ReadPod(line) &&
+                          reader.ReadPod(entry.key.bytes_loaded) && reader.ReadPod(entry.key.bytes_stored) &&
+                          reader.ReadPod(entry.key.compute_cycles) && reader.ReadPod(entry.cycles_per_unit),
+                      "Truncated thread pool cost calibration file.");
+    ORT_RETURN_IF_NOT(entry.cycles_per_unit >= 0.0, "Invalid cost in thread pool cost calibration file.");
+    entry.key.line = line;
+    if (loaded.size() < max_entries_) {
+      loaded.push_back(std::move(entry));
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& [file, loaded_key, cycles_per_unit] : loaded) {
+    Key key = loaded_key;
+    key.file = *file_names_.insert(std::move(file)).first;
+    Entry& entry = entries_[key];
+    if (entry.cycles_per_unit < 0.0) {
+      ++num_calibrated_;
+    }
+    entry.cycles_per_unit = cycles_per_unit;
+    entry.samples = {};
+  }
+  dirty_ = false;
+  return Status::OK();
+}
+
+}  // namespace concurrency
+}  // namespace onnxruntime
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace concurrency {
+
+/**
+Measures the cost of the loops run by ThreadPool::TryParallelFor to replace the costs declared by the kernels.
+
+The declared costs are estimates made once for all CPUs and are easily off by an order of magnitude on a given one,
+so small loops get split into too many shards and large ones into too few. A loop is identified by its call site,
+and by its declared cost, which the kernels compute from the attributes of the node and the shapes of its inputs, so
+each shape of a call site gets its own measurement and unrelated loops declaring the same cost don't share one. The
+first kNumSamples loops of an entry are timed, and later loops are split based on the median of the measured costs.
+
+The measured costs can be saved to a file and loaded by later sessions on the same machine.
+This class is thread-safe.
+*/
+class ParallelForCostCalibration {
+ public:
+  static constexpr size_t kNumSamples = 8;
+  static constexpr size_t kDefaultMaxEntries = 4096;
+
+  explicit ParallelForCostCalibration(size_t max_entries = kDefaultMaxEntries) : max_entries_(max_entries) {}
+
+  // Sets `cost` to the cost to use for a loop of `call_site` declared with `declared`.
+  // Returns true if the loop should be timed and the time passed to AddSample().
+  bool GetCost(const ParallelForCallSite& call_site, const TensorOpCost& declared, TensorOpCost& cost) const;
+
+  // Records the time spent in `num_units` units of a loop of `call_site` declared with `declared`, summed over all
+  // the threads.
+  void AddSample(const ParallelForCallSite& call_site, const TensorOpCost& declared, std::ptrdiff_t num_units,
+                 std::chrono::nanoseconds busy_time);
+
+  size_t NumCalibratedEntries() const;
+
+  // true if costs were calibrated since the calibration was created or last saved/loaded.
+  bool IsDirty() const;
+
+  // Writes the calibrated costs. `platform_identity` must identify the build and the machine, the file is rejected
+  // by Load() if it was written with another identity.
+  Status Save(const PathString& file_path, const std::string& platform_identity);
+  Status Load(const PathString& file_path, const std::string& platform_identity);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelForCostCalibration);
+
+  struct Key {
+    // the file names of the call sites are string literals, or the ones interned in file_names_ for loaded entries
+    std::string_view file;
+    int line;
+    double bytes_loaded;
+    double bytes_stored;
+    double compute_cycles;
+
+    bool operator==(const Key& other) const {
+      return line == other.line && bytes_loaded == other.bytes_loaded && bytes_stored == other.bytes_stored &&
+             compute_cycles == other.compute_cycles && file == other.file;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Entry {
+    // measured nanoseconds per unit, until the entry is calibrated
+    std::vector<double> samples;
+    // negative until the entry is calibrated
+    double cycles_per_unit{-1.0};
+  };
+
+  static Key MakeKey(const ParallelForCallSite& call_site, const TensorOpCost& cost) {
+    return {call_site.file, call_site.line, cost.bytes_loaded, cost.bytes_stored, cost.compute_cycles};
+  }
+
+  const size_t max_entries_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<Key, Entry, KeyHash> entries_;
+  // file names of the call sites of the loaded entries
+  std::unordered_set<std::string> file_names_;
+  size_t num_calibrated_{0};
+  bool dirty_{false};
+};
+
+}  // namespace concurrency
+}  // namespace onnxruntime
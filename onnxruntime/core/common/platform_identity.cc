@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/platform_identity.h"
+
+#include <sstream>
+
+#include "core/common/cpuid_info.h"
+#include "onnxruntime_config.h"
+
+namespace onnxruntime {
+
+const std::string& GetPlatformIdentity() {
+  static const std::string identity = []() {
+    const auto& cpu_info = CPUIDInfo::GetCPUIDInfo();
+    std::ostringstream ss;
+    ss << "onnxruntime-" << ORT_VERSION << "|" << sizeof(void*)
+       << "|avx" << cpu_info.HasAVX() << cpu_info.HasAVX2() << cpu_info.HasAVX512f() << cpu_info.HasAVX512Skylake()
+       << cpu_info.HasAVX512_BF16() << cpu_info.HasAMX_BF16() << cpu_info.HasF16C()
+       << "|sse" << cpu_info.HasSSE3() << cpu_info.HasSSE4_1()
+       << "|arm" << cpu_info.HasArmNeonDot() << cpu_info.HasArmNeon_I8MM() << cpu_info.HasArmSVE_I8MM()
+       << cpu_info.HasArmNeon_BF16() << cpu_info.HasFp16VectorAcceleration();
+    return ss.str();
+  }();
+  return identity;
+}
+
+}  // namespace onnxruntime
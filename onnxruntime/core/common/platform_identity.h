@@ -0,0 +1,15 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+namespace onnxruntime {
+
+// Identifies the build of ONNX Runtime and the instruction set extensions of the CPU.
+// Files and caches of data that depend on them, like pre-packed weights or calibrated costs, are keyed by it so that
+// they are not reused by another build or on another CPU.
+const std::string& GetPlatformIdentity();
+
+}  // namespace onnxruntime
@@ -3,6 +3,11 @@
 
 #include "profiler.h"
 
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
 namespace onnxruntime {
 namespace profiling {
 using namespace std::chrono;
@@ -106,6 +111,7 @@ std::string Profiler::EndProfiling() {
   if (!enabled_) {
     return std::string();
   }
+  LogRooflineSummary();
   if (profile_with_logger_) {
     profile_with_logger_ = false;
     return std::string();
@@ -157,5 +163,185 @@ std::string Profiler::EndProfiling() {
   return profile_stream_file_;
 }
 
+bool Profiler::SampleRun() {
+  if (sampling_interval_ == 0) {
+    return false;
+  }
+
+  if (num_runs_.fetch_add(1, std::memory_order_relaxed) % sampling_interval_ != 0) {
+    return false;
+  }
+
+  num_sampled_runs_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void Profiler::SampleStatistics::Add(long long duration_us) {
+  if (count == 0 || duration_us < min_us) {
+    min_us = duration_us;
+  }
+  if (count == 0 || duration_us > max_us) {
+    max_us = duration_us;
+  }
+  ++count;
+  total_us += duration_us;
+
+  size_t bucket = 0;
+  for (long long d = duration_us; d > 0 && bucket < kNumSampleBuckets - 1; d >>= 1) {
+    ++bucket;
+  }
+  ++buckets[bucket];
+}
+
+void Profiler::SampleStatistics::Merge(const SampleStatistics& other) {
+  if (other.count == 0) {
+    return;
+  }
+  if (count == 0 || other.min_us < min_us) {
+    min_us = other.min_us;
+  }
+  if (count == 0 || other.max_us > max_us) {
+    max_us = other.max_us;
+  }
+  count += other.count;
+  total_us += other.total_us;
+  for (size_t i = 0; i < kNumSampleBuckets; ++i) {
+    buckets[i] += other.buckets[i];
+  }
+}
+
+void Profiler::RecordSample(const std::string& node_name, const std::string& op_type, long long duration_us) {
+  std::lock_guard<std::mutex> lock(sampling_mutex_);
+  auto& stats = sampled_nodes_[node_name];
+  if (stats.count == 0) {
+    stats.op_type = op_type;
+  }
+  stats.Add(duration_us);
+}
+
+void Profiler::RecordNodeCost(const std::string& node_name, const std::string& op_type, double flops, double bytes,
+                              long long duration_us) {
+  if (!IsRooflineEnabled()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& stats = roofline_nodes_[node_name];
+  if (stats.count == 0) {
+    stats.op_type = op_type;
+  }
+  ++stats.count;
+  stats.flops += flops;
+  stats.bytes += bytes;
+  stats.total_us += duration_us;
+}
+
+void Profiler::LogRooflineSummary() {
+  constexpr size_t kMaxNodes = 20;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (session_logger_ == nullptr || roofline_nodes_.empty()) {
+    return;
+  }
+
+  struct Entry {
+    const std::string* name;
+    const RooflineStatistics* stats;
+    double bound_us;
+    bool compute_bound;
+  };
+
+  std::vector<Entry> entries;
+  entries.reserve(roofline_nodes_.size());
+  long long total_us = 0;
+  for (const auto& node : roofline_nodes_) {
+    // 1 GFLOP/s is 1e3 flops per us, and 1 GB/s 1e3 bytes per us
+    const double compute_us = node.second.flops / (roofline_peak_gflops_ * 1e3);
+    const double memory_us = node.second.bytes / (roofline_peak_gb_per_s_ * 1e3);
+    entries.push_back({&node.first, &node.second, std::max(compute_us, memory_us), compute_us >= memory_us});
+    total_us += node.second.total_us;
+  }
+
+  // the nodes that would save the most time if their kernels reached the roofline come first
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    return a.stats->total_us - a.bound_us > b.stats->total_us - b.bound_us;
+  });
+
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(2);
+  ss << "Roofline summary (peak " << roofline_peak_gflops_ << " GFLOP/s, " << roofline_peak_gb_per_s_
+     << " GB/s), " << total_us << "us in " << roofline_nodes_.size() << " nodes:";
+  for (size_t i = 0; i < std::min(kMaxNodes, entries.size()); ++i) {
+    const auto& entry = entries[i];
+    const auto& stats = *entry.stats;
+    const double us = static_cast<double>(std::max(stats.total_us, 1LL));
+    ss << "\n  " << *entry.name << " (" << stats.op_type << "): " << stats.total_us << "us in " << stats.count
+       << " runs, " << stats.flops / us / 1e3 << " GFLOP/s, " << stats.bytes / us / 1e3 << " GB/s, "
+       << (entry.compute_bound ? "compute" : "memory") << " bound, " << 100 * entry.bound_us / us
+       << "% of the roofline";
+  }
+  roofline_nodes_.clear();
+
+  LOGS(*session_logger_, INFO) << ss.str();
+}
+
+std::string Profiler::GetSamplingStatistics(bool reset) {
+  std::map<std::string, SampleStatistics> nodes;
+  uint64_t num_sampled_runs = 0;
+  {
+    std::lock_guard<std::mutex> lock(sampling_mutex_);
+    if (reset) {
+      nodes.swap(sampled_nodes_);
+      num_sampled_runs = num_sampled_runs_.exchange(0);
+    } else {
+      nodes = sampled_nodes_;
+      num_sampled_runs = num_sampled_runs_.load();
+    }
+  }
+
+  std::map<std::string, SampleStatistics> op_types;
+  for (const auto& node : nodes) {
+    auto& stats = op_types[node.second.op_type];
+    stats.op_type = node.second.op_type;
+    stats.Merge(node.second);
+  }
+
+  auto write_stats = [](std::ostringstream& ss, const SampleStatistics& stats) {
+    ss << "\"count\" : " << stats.count << ", ";
+    ss << "\"total_us\" : " << stats.total_us << ", ";
+    ss << "\"min_us\" : " << stats.min_us << ", ";
+    ss << "\"max_us\" : " << stats.max_us << ", ";
+    ss << "\"histogram\" : [";
+    for (size_t i = 0; i < kNumSampleBuckets; ++i) {
+      ss << (i == 0 ? "" : ", ") << stats.buckets[i];
+    }
+    ss << "]";
+  };
+
+  std::ostringstream ss;
+  ss << "{\"sampling_interval\" : " << sampling_interval_ << ", ";
+  ss << "\"sampled_runs\" : " << num_sampled_runs << ",\n";
+  ss << "\"nodes\" : [";
+  bool is_first = true;
+  for (const auto& node : nodes) {
+    ss << (is_first ? "\n" : ",\n");
+    ss << R"({"name" : ")" << node.first << R"(", "op_type" : ")" << node.second.op_type << "\", ";
+    write_stats(ss, node.second);
+    ss << "}";
+    is_first = false;
+  }
+  ss << "],\n";
+  ss << "\"op_types\" : [";
+  is_first = true;
+  for (const auto& op_type : op_types) {
+    ss << (is_first ? "\n" : ",\n");
+    ss << R"({"op_type" : ")" << op_type.first << "\", ";
+    write_stats(ss, op_type.second);
+    ss << "}";
+    is_first = false;
+  }
+  ss << "]}\n";
+  return ss.str();
+}
+
 }  // namespace profiling
 }  // namespace onnxruntime
@@ -3,10 +3,12 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <fstream>
 #include <initializer_list>
 #include <iostream>
+#include <map>
 #include <tuple>
 
 #include "core/common/profiler_common.h"
@@ -110,6 +112,72 @@ class Profiler {
     global_max_num_events_.store(new_max_num_events);
   }
 
+  /*
+  Enables the sampling mode: the kernel times of one in every `interval` executions are aggregated into
+  per node statistics that can be queried while the session is running. It is independent of StartProfiling,
+  and the memory used does not grow with the number of runs. 0 disables sampling.
+  */
+  /*
+  Stops collecting events and samples until Resume is called, without ending the profiling.
+  The executions in between must not overlap with the executions that should be profiled.
+  */
+  void Pause() {
+    paused_enabled_ = enabled_;
+    paused_sampling_interval_ = sampling_interval_;
+    enabled_ = false;
+    sampling_interval_ = 0;
+  }
+
+  void Resume() {
+    enabled_ = paused_enabled_;
+    sampling_interval_ = paused_sampling_interval_;
+  }
+
+  void EnableSampling(uint32_t interval) {
+    sampling_interval_ = interval;
+  }
+
+  bool IsSamplingEnabled() const {
+    return sampling_interval_ > 0;
+  }
+
+  /*
+  Called when an execution starts. Returns true if the kernel times of the execution should be recorded.
+  */
+  bool SampleRun();
+
+  /*
+  Adds the time of a kernel of a sampled execution to the statistics of its node.
+  */
+  void RecordSample(const std::string& node_name, const std::string& op_type, long long duration_us);
+
+  /*
+  Returns the sampled statistics as json, per node and aggregated per op type. Each entry has a histogram of the
+  kernel times with log2 buckets: bucket 0 counts the times below 1us, and bucket i the times in [2^(i-1), 2^i) us.
+  If reset is true the statistics are cleared, so consecutive calls report rolling windows.
+  */
+  std::string GetSamplingStatistics(bool reset);
+
+  /*
+  Sets the peak compute throughput and memory bandwidth of the device. When set, the cost of the kernels recorded
+  with RecordNodeCost is aggregated per node, and EndProfiling logs the nodes ranked by the time they spend above
+  their roofline, i.e. max(flops / peak flops, bytes / peak bandwidth). 0 for either disables the summary.
+  */
+  void SetRoofline(double peak_gflops, double peak_gb_per_s) {
+    roofline_peak_gflops_ = peak_gflops;
+    roofline_peak_gb_per_s_ = peak_gb_per_s;
+  }
+
+  bool IsRooflineEnabled() const {
+    return roofline_peak_gflops_ > 0 && roofline_peak_gb_per_s_ > 0;
+  }
+
+  /*
+  Adds the estimated flops and bytes of a kernel execution, and its time, to the roofline summary of its node.
+  */
+  void RecordNodeCost(const std::string& node_name, const std::string& op_type, double flops, double bytes,
+                      long long duration_us);
+
   void AddEpProfilers(std::unique_ptr<EpProfiler> ep_profiler) {
     if (ep_profiler) {
       ep_profilers_.push_back(std::move(ep_profiler));
@@ -156,6 +224,45 @@ class Profiler {
 #endif
 
   std::vector<std::unique_ptr<EpProfiler>> ep_profilers_;
+
+  static constexpr size_t kNumSampleBuckets = 24;
+
+  struct SampleStatistics {
+    std::string op_type;
+    uint64_t count{0};
+    long long total_us{0};
+    long long min_us{0};
+    long long max_us{0};
+    std::array<uint64_t, kNumSampleBuckets> buckets{};
+
+    void Add(long long duration_us);
+    void Merge(const SampleStatistics& other);
+  };
+
+  uint32_t sampling_interval_{0};
+  bool paused_enabled_{false};
+  uint32_t paused_sampling_interval_{0};
+  std::atomic<uint64_t> num_runs_{0};
+  std::atomic<uint64_t> num_sampled_runs_{0};
+  // Only taken for the kernels of sampled executions, so runs that are not sampled never contend on it.
+  std::mutex sampling_mutex_;
+  // ordered so the statistics are reported in a stable order
+  std::map<std::string, SampleStatistics> sampled_nodes_;
+
+  struct RooflineStatistics {
+    std::string op_type;
+    uint64_t count{0};
+    double flops{0};
+    double bytes{0};
+    long long total_us{0};
+  };
+
+  void LogRooflineSummary();
+
+  double roofline_peak_gflops_{0};
+  double roofline_peak_gb_per_s_{0};
+  // guarded by mutex_
+  std::map<std::string, RooflineStatistics> roofline_nodes_;
 };
 
 }  // namespace profiling
@@ -13,12 +13,19 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <thread>
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
 #include "core/common/cpuid_info.h"
+#include "core/common/parallel_for_cost_calibration.h"
 #include "core/common/eigen_common_wrapper.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include <mutex>
@@ -307,6 +314,21 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
     return idx % _num_shards;
   }
 
+  // Allocate the threads of a NUMA node to the shards of a contiguous part
+  // of the iteration space, so that a given iteration tends to run on the
+  // same node in successive loops, and the memory it touches stays local to
+  // that node.  Threads that run out of work in their node move on to the
+  // shards of the next nodes.  Without enough shards for every node, this
+  // falls back to the allocation by worker ID.
+  unsigned GetHomeShard(unsigned idx, unsigned numa_node, unsigned num_numa_nodes) const {
+    if (num_numa_nodes <= 1 || _num_shards < num_numa_nodes) {
+      return GetHomeShard(idx);
+    }
+    unsigned first_shard = numa_node * _num_shards / num_numa_nodes;
+    unsigned num_node_shards = (numa_node + 1) * _num_shards / num_numa_nodes - first_shard;
+    return first_shard + idx % num_node_shards;
+  }
+
   // Attempt to claim iterations from the sharded counter.  The function either
   // returns true, along with a block of exactly block_size iterations, or it returns false
   // if all of the iterations have been claimed.
@@ -370,13 +392,32 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
 #pragma warning(pop) /* Padding added in LoopCounterShard, LoopCounter */
 #endif
 
+namespace {
+std::atomic<uint64_t> next_thread_pool_id{0};
+}  // namespace
+
+// The counters are only written by the thread they belong to, so they are updated with plain loads and stores.
+// They are atomic for GetParallelismStats, which reads them from another thread.
+struct ORT_ALIGN_TO_AVOID_FALSE_SHARING ThreadPool::LoopStats {
+  explicit LoopStats(std::thread::id owner) : owner{owner} {}
+
+  const std::thread::id owner;
+  std::atomic<uint64_t> num_loops{0};
+  std::atomic<uint64_t> sum_loop_threads{0};
+  std::atomic<int> max_loop_threads{0};
+};
+
 ThreadPool::ThreadPool(Env* env,
                        const ThreadOptions& thread_options,
                        const NAME_CHAR_TYPE* name,
                        int degree_of_parallelism,
                        bool low_latency_hint,
                        bool force_hybrid)
-    : thread_options_(thread_options), force_hybrid_(force_hybrid) {
+    : thread_options_(thread_options),
+      env_(env),
+      low_latency_hint_(low_latency_hint),
+      force_hybrid_(force_hybrid),
+      id_(next_thread_pool_id.fetch_add(1, std::memory_order_relaxed)) {
   // In the current implementation, a thread pool with degree_of_parallelism==1 uses
   // the caller as one of the threads for executing work.  Hence we only create
   // additional thread(s) for degree_of_parallelism>=2.
@@ -390,18 +431,53 @@ ThreadPool::ThreadPool(Env* env,
       assert(thread_options_.affinities.size() >= size_t(threads_to_create));
     }
 
-    extended_eigen_threadpool_ =
-        std::make_unique<ThreadPoolTempl<Env> >(name,
-                                                threads_to_create,
-                                                low_latency_hint,
-                                                *env,
-                                                thread_options_);
-    underlying_threadpool_ = extended_eigen_threadpool_.get();
+    if (!thread_options_.numa_nodes.empty()) {
+      assert(thread_options_.numa_nodes.size() >= size_t(degree_of_parallelism));
+      num_numa_nodes_ = static_cast<unsigned>(*std::max_element(thread_options_.numa_nodes.begin(),
+                                                                thread_options_.numa_nodes.end()) +
+                                              1);
+    }
+
+    threads_to_create_ = threads_to_create;
+    if (name != nullptr) {
+      name_ = name;
+    }
+    if (!thread_options_.create_threads_lazily) {
+      CreateUnderlyingThreadPool();
+    }
   }
 }
 
 ThreadPool::~ThreadPool() = default;
 
+void ThreadPool::CreateUnderlyingThreadPool() {
+  extended_eigen_threadpool_ =
+      std::make_unique<ThreadPoolTempl<Env> >(name_ ? name_->c_str() : nullptr,
+                                              threads_to_create_,
+                                              low_latency_hint_,
+                                              *env_,
+                                              thread_options_);
+  if (spinning_disabled_) {
+    extended_eigen_threadpool_->DisableSpinning();
+  }
+  for (int i = 0; i < spinning_without_blocking_; ++i) {
+    extended_eigen_threadpool_->StartSpinningWithoutBlocking();
+  }
+  underlying_threadpool_.store(extended_eigen_threadpool_.get(), std::memory_order_release);
+}
+
+ExtendedThreadPoolInterface* ThreadPool::GetUnderlyingThreadPool() {
+  ExtendedThreadPoolInterface* underlying_threadpool = underlying_threadpool_.load(std::memory_order_acquire);
+  if (underlying_threadpool == nullptr && thread_options_.create_threads_lazily && threads_to_create_ > 0) {
+    std::lock_guard<std::mutex> lock(lazy_creation_mutex_);
+    if (!extended_eigen_threadpool_) {
+      CreateUnderlyingThreadPool();
+    }
+    underlying_threadpool = extended_eigen_threadpool_.get();
+  }
+  return underlying_threadpool;
+}
+
 // Base case for parallel loops, running iterations 0..total, divided into blocks
 // of block_size iterations, and calling into a function that takes a start..end
 // range of indices to run.
@@ -416,18 +492,24 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     return;
   }
 
+  const int max_parallelism = MaxParallelism();
+  if (max_parallelism == 1) {
+    fn(0, total);
+    return;
+  }
+
   auto d_of_p = DegreeOfParallelism(this);
   if (thread_options_.dynamic_block_base_ <= 0) {
     // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
     // hence we need at most one for each thread, even if the number of blocks of iterations is larger.
     auto num_blocks = total / block_size;
-    auto num_threads_inc_main = NumThreads() + 1;
+    auto num_threads_inc_main = max_parallelism;
     int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(num_threads_inc_main), num_blocks));
     assert(num_work_items > 0);
 
     LoopCounter lc(total, d_of_p, block_size);
     std::function<void(unsigned)> run_work = [&](unsigned idx) {
-      unsigned my_home_shard = lc.GetHomeShard(idx);
+      unsigned my_home_shard = lc.GetHomeShard(idx, CurrentNumaNode(), num_numa_nodes_);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
       while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block_size)) {
@@ -446,7 +528,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     LoopCounter lc(total, d_of_p, base_block_size);
     std::function<void(unsigned)> run_work = [&](unsigned idx) {
       std::ptrdiff_t b = base_block_size;
-      unsigned my_home_shard = lc.GetHomeShard(idx);
+      unsigned my_home_shard = lc.GetHomeShard(idx, CurrentNumaNode(), num_numa_nodes_);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
       while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, b)) {
@@ -460,7 +542,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     };
     // Distribute task among all threads in the pool, reduce number of work items if
     // num_of_blocks is smaller than number of threads.
-    RunInParallel(run_work, std::min(NumThreads() + 1, num_of_blocks), base_block_size);
+    RunInParallel(run_work, std::min(max_parallelism, num_of_blocks), base_block_size);
   }
 }
 
@@ -473,22 +555,23 @@ void ThreadPool::SimpleParallelFor(std::ptrdiff_t total, const std::function<voi
 }
 
 void ThreadPool::Schedule(std::function<void()> fn) {
-  if (underlying_threadpool_) {
-    underlying_threadpool_->Schedule(std::move(fn));
+  if (auto* underlying_threadpool = GetUnderlyingThreadPool()) {
+    underlying_threadpool->Schedule(std::move(fn));
   } else {
     fn();
   }
 }
 
+// Profiling measures the threads, so it creates them if they are created lazily.
 void ThreadPool::StartProfiling() {
-  if (underlying_threadpool_) {
-    underlying_threadpool_->StartProfiling();
+  if (auto* underlying_threadpool = GetUnderlyingThreadPool()) {
+    underlying_threadpool->StartProfiling();
   }
 }
 
 std::string ThreadPool::StopProfiling() {
-  if (underlying_threadpool_) {
-    return underlying_threadpool_->StopProfiling();
+  if (auto* underlying_threadpool = underlying_threadpool_.load(std::memory_order_acquire)) {
+    return underlying_threadpool->StopProfiling();
   } else {
     return {};
   }
@@ -496,41 +579,138 @@ std::string ThreadPool::StopProfiling() {
 
 namespace {
 thread_local std::optional<ThreadPoolParallelSection> current_parallel_section;
+
+// Limits of the run in progress on the current thread, see ThreadPool::RunScope.
+struct RunLimits {
+  bool in_run{false};
+  int max_degree_of_parallelism{0};
+  const std::atomic<int>* shared_max_degree_of_parallelism{nullptr};
+  ThreadPool::RunPriority priority{ThreadPool::RunPriority::kNormal};
+};
+thread_local RunLimits current_run_limits;
+}  // namespace
+
+ThreadPool::RunScope::RunScope(ThreadPool* tp, int max_degree_of_parallelism, RunPriority priority,
+                               const std::atomic<int>* shared_max_degree_of_parallelism)
+    : tp_(priority == RunPriority::kHigh ? tp : nullptr),
+      previous_max_degree_of_parallelism_(current_run_limits.max_degree_of_parallelism),
+      previous_shared_max_degree_of_parallelism_(current_run_limits.shared_max_degree_of_parallelism),
+      previous_priority_(current_run_limits.priority),
+      previous_in_run_(current_run_limits.in_run) {
+  current_run_limits.in_run = true;
+  current_run_limits.max_degree_of_parallelism = max_degree_of_parallelism;
+  current_run_limits.shared_max_degree_of_parallelism = shared_max_degree_of_parallelism;
+  current_run_limits.priority = priority;
+  if (tp_) {
+    tp_->high_priority_runs_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+ThreadPool::RunScope::~RunScope() {
+  if (tp_) {
+    tp_->high_priority_runs_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  current_run_limits.in_run = previous_in_run_;
+  current_run_limits.max_degree_of_parallelism = previous_max_degree_of_parallelism_;
+  current_run_limits.shared_max_degree_of_parallelism = previous_shared_max_degree_of_parallelism_;
+  current_run_limits.priority = previous_priority_;
+}
+
+int ThreadPool::MaxParallelism() const {
+  int threads = NumThreads() + 1;
+  if (current_run_limits.in_run) {
+    if (current_run_limits.priority != RunPriority::kHigh &&
+        high_priority_runs_.load(std::memory_order_relaxed) > 0) {
+      return 1;
+    }
+    if (current_run_limits.max_degree_of_parallelism > 0) {
+      threads = std::min(threads, current_run_limits.max_degree_of_parallelism);
+    }
+    if (current_run_limits.shared_max_degree_of_parallelism != nullptr) {
+      const int shared = current_run_limits.shared_max_degree_of_parallelism->load(std::memory_order_relaxed);
+      if (shared > 0) {
+        threads = std::min(threads, shared);
+      }
+    }
+  }
+  return threads;
 }
 
 ThreadPool::ParallelSection::ParallelSection(ThreadPool* tp) {
   ORT_ENFORCE(!current_parallel_section.has_value(), "Nested parallelism not supported");
   ORT_ENFORCE(!ps_);
   tp_ = tp;
-  if (tp && tp->underlying_threadpool_) {
+  if (auto* underlying_threadpool = tp ? tp->GetUnderlyingThreadPool() : nullptr) {
     current_parallel_section.emplace();
     ps_ = &*current_parallel_section;
-    tp_->underlying_threadpool_->StartParallelSection(*ps_);
+    underlying_threadpool->StartParallelSection(*ps_);
   }
 }
 
 ThreadPool::ParallelSection::~ParallelSection() {
   if (current_parallel_section) {
-    tp_->underlying_threadpool_->EndParallelSection(*ps_);
+    tp_->underlying_threadpool_.load(std::memory_order_acquire)->EndParallelSection(*ps_);
     current_parallel_section.reset();
   }
 }
 
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
-  if (underlying_threadpool_) {
+  // a loop run by the caller alone does not need the threads
+  auto* underlying_threadpool =
+      n > 1 ? GetUnderlyingThreadPool() : underlying_threadpool_.load(std::memory_order_acquire);
+  if (underlying_threadpool) {
+    if (n > 1) {
+      LoopStats& stats = CurrentThreadLoopStats();
+      stats.num_loops.store(stats.num_loops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      stats.sum_loop_threads.store(stats.sum_loop_threads.load(std::memory_order_relaxed) + n,
+                                   std::memory_order_relaxed);
+      if (static_cast<int>(n) > stats.max_loop_threads.load(std::memory_order_relaxed)) {
+        stats.max_loop_threads.store(static_cast<int>(n), std::memory_order_relaxed);
+      }
+    }
     if (current_parallel_section.has_value()) {
-      underlying_threadpool_->RunInParallelSection(*current_parallel_section,
-                                                   std::move(fn),
-                                                   n, block_size);
+      underlying_threadpool->RunInParallelSection(*current_parallel_section,
+                                                  std::move(fn),
+                                                  n, block_size);
     } else {
-      underlying_threadpool_->RunInParallel(std::move(fn),
-                                            n, block_size);
+      underlying_threadpool->RunInParallel(std::move(fn),
+                                           n, block_size);
     }
   } else {
     fn(0);
   }
 }
 
+ThreadPool::LoopStats& ThreadPool::CurrentThreadLoopStats() {
+  // the counters of the last pools the thread ran loops on. the ids of the pools are never reused, so the entry of a
+  // destroyed pool is never matched.
+  struct CachedLoopStats {
+    uint64_t pool_id = std::numeric_limits<uint64_t>::max();
+    LoopStats* stats = nullptr;
+  };
+  static thread_local std::array<CachedLoopStats, 4> cache;
+  static thread_local size_t next_cache_entry = 0;
+
+  for (const auto& entry : cache) {
+    if (entry.pool_id == id_) {
+      return *entry.stats;
+    }
+  }
+
+  LoopStats* stats = nullptr;
+  {
+    const auto thread_id = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(loop_stats_mutex_);
+    auto it = std::find_if(loop_stats_.begin(), loop_stats_.end(),
+                           [thread_id](const std::unique_ptr<LoopStats>& entry) { return entry->owner == thread_id; });
+    stats = it != loop_stats_.end() ? it->get() : loop_stats_.emplace_back(std::make_unique<LoopStats>(thread_id)).get();
+  }
+
+  cache[next_cache_entry] = {id_, stats};
+  next_cache_entry = (next_cache_entry + 1) % cache.size();
+  return *stats;
+}
+
 bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
                                        const std::ptrdiff_t block_size) const {
   // Do not parallelize trivial loops, with only a single block of work
@@ -547,6 +727,11 @@ bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
     return false;
   }
 
+  // Do not parallelize the loops of a run limited to the calling thread.
+  if (MaxParallelism() == 1) {
+    return false;
+  }
+
   return true;
 }
 
@@ -612,24 +797,41 @@ static ptrdiff_t CalculateParallelForBlock(const ptrdiff_t n, const Eigen::Tenso
 }
 
 void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f) {
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f,
+                             const ParallelForCallSite& call_site) {
   ORT_ENFORCE(n >= 0);
-  Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
+  TensorOpCost c_to_use = c;
+  const bool measure = cost_calibration_ && n > 0 && cost_calibration_->GetCost(call_site, c, c_to_use);
+
+  // While a cost is calibrated, the time spent in f is summed over all the threads running the loop.
+  std::atomic<int64_t> busy_ns{0};
+  std::function<void(std::ptrdiff_t, std::ptrdiff_t)> timed_f;
+  if (measure) {
+    timed_f = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      const auto start = std::chrono::steady_clock::now();
+      f(first, last);
+      const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start);
+      busy_ns.fetch_add(elapsed.count(), std::memory_order_relaxed);
+    };
+  }
+  const auto& fn = measure ? timed_f : f;
+
+  Eigen::TensorOpCost cost{c_to_use.bytes_loaded, c_to_use.bytes_stored, c_to_use.compute_cycles};
   auto d_of_p = DegreeOfParallelism(this);
   // Compute small problems directly in the caller thread.
   if ((!ShouldParallelizeLoop(n)) ||
       CostModel::numThreads(static_cast<double>(n), cost, d_of_p) == 1) {
-    f(0, n);
-    return;
+    fn(0, n);
+  } else {
+    ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, d_of_p);
+    ParallelForFixedBlockSizeScheduling(n, block, fn);
   }
 
-  ptrdiff_t block = CalculateParallelForBlock(n, cost, nullptr, d_of_p);
-  ParallelForFixedBlockSizeScheduling(n, block, f);
-}
-
-void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn) {
-  ParallelFor(total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
+  if (measure) {
+    cost_calibration_->AddSample(call_site, c, n,
+                                 std::chrono::nanoseconds(busy_ns.load(std::memory_order_relaxed)));
+  }
 }
 
 bool ThreadPool::ShouldParallelize(const concurrency::ThreadPool* tp) {
@@ -640,16 +842,53 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   // When not using OpenMP, we parallelize over the N threads created by the pool
   // tp, plus 1 for the thread entering a loop.
   if (tp) {
+    const int threads = tp->MaxParallelism();
+    if (threads == 1 && tp->NumThreads() > 0) {
+      // the run in progress on the calling thread is limited to that thread
+      return 1;
+    }
     if (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid()) {
-      return ((tp->NumThreads() + 1)) * TaskGranularityFactor;
+      return threads * TaskGranularityFactor;
     } else {
-      return ((tp->NumThreads() + 1));
+      return threads;
     }
   } else {
     return 1;
   }
 }
 
+uint64_t ThreadPool::GetBusyNanoseconds(const concurrency::ThreadPool* tp) {
+  if (auto* underlying_threadpool = tp ? tp->underlying_threadpool_.load(std::memory_order_acquire) : nullptr) {
+    return underlying_threadpool->GetBusyNanoseconds();
+  }
+  return 0;
+}
+
+ThreadPool::ParallelismStats ThreadPool::GetParallelismStats(const concurrency::ThreadPool* tp) {
+  ParallelismStats stats;
+  if (tp) {
+    if (auto* underlying_threadpool = tp->underlying_threadpool_.load(std::memory_order_acquire)) {
+      stats.created_threads = underlying_threadpool->NumThreads();
+    }
+    std::lock_guard<std::mutex> lock(tp->loop_stats_mutex_);
+    for (const auto& loop_stats : tp->loop_stats_) {
+      stats.num_loops += loop_stats->num_loops.load(std::memory_order_relaxed);
+      stats.sum_loop_threads += loop_stats->sum_loop_threads.load(std::memory_order_relaxed);
+      stats.max_loop_threads = std::max(stats.max_loop_threads,
+                                        loop_stats->max_loop_threads.load(std::memory_order_relaxed));
+    }
+  }
+  return stats;
+}
+
+int ThreadPool::NumThreads(const concurrency::ThreadPool* tp) {
+  return tp ? tp->NumThreads() : 0;
+}
+
+unsigned ThreadPool::NumNumaNodes(const concurrency::ThreadPool* tp) {
+  return tp ? tp->num_numa_nodes_ : 0;
+}
+
 void ThreadPool::StartProfiling(concurrency::ThreadPool* tp) {
   if (tp) {
     tp->StartProfiling();
@@ -664,44 +903,84 @@ std::string ThreadPool::StopProfiling(concurrency::ThreadPool* tp) {
   }
 }
 
+// When the threads are created lazily, the spinning state is kept under lazy_creation_mutex_ so that the threads
+// start in the state set before they existed.
 void ThreadPool::EnableSpinning() {
+  std::unique_lock<std::mutex> lock(lazy_creation_mutex_, std::defer_lock);
+  if (thread_options_.create_threads_lazily) {
+    lock.lock();
+    spinning_disabled_ = false;
+  }
   if (extended_eigen_threadpool_) {
     extended_eigen_threadpool_->EnableSpinning();
   }
 }
 
 void ThreadPool::DisableSpinning() {
+  std::unique_lock<std::mutex> lock(lazy_creation_mutex_, std::defer_lock);
+  if (thread_options_.create_threads_lazily) {
+    lock.lock();
+    spinning_disabled_ = true;
+  }
   if (extended_eigen_threadpool_) {
     extended_eigen_threadpool_->DisableSpinning();
   }
 }
 
-// Return the number of threads created by the pool.
-int ThreadPool::NumThreads() const {
-  if (underlying_threadpool_) {
-    return underlying_threadpool_->NumThreads();
-  } else {
-    return 0;
+void ThreadPool::StartSpinningWithoutBlocking() {
+  std::unique_lock<std::mutex> lock(lazy_creation_mutex_, std::defer_lock);
+  if (thread_options_.create_threads_lazily) {
+    lock.lock();
+    ++spinning_without_blocking_;
+  }
+  if (extended_eigen_threadpool_) {
+    extended_eigen_threadpool_->StartSpinningWithoutBlocking();
   }
 }
 
+void ThreadPool::StopSpinningWithoutBlocking() {
+  std::unique_lock<std::mutex> lock(lazy_creation_mutex_, std::defer_lock);
+  if (thread_options_.create_threads_lazily) {
+    lock.lock();
+    --spinning_without_blocking_;
+  }
+  if (extended_eigen_threadpool_) {
+    extended_eigen_threadpool_->StopSpinningWithoutBlocking();
+  }
+}
+
+// Return the number of threads of the pool, including those not created yet.
+int ThreadPool::NumThreads() const {
+  return threads_to_create_;
+}
+
 // Return ID of the current thread within this pool.  Returns -1 for a thread outside the
 // current pool.
 int ThreadPool::CurrentThreadId() const {
-  if (underlying_threadpool_) {
-    return underlying_threadpool_->CurrentThreadId();
+  if (auto* underlying_threadpool = underlying_threadpool_.load(std::memory_order_acquire)) {
+    return underlying_threadpool->CurrentThreadId();
   } else {
     return -1;
   }
 }
 
+// Return the NUMA node of the current thread, or 0 if the pool is not partitioned by NUMA node.
+// Threads outside the pool are given the node of the thread entering the loops.
+unsigned ThreadPool::CurrentNumaNode() const {
+  if (num_numa_nodes_ <= 1) {
+    return 0;
+  }
+  return static_cast<unsigned>(thread_options_.numa_nodes[CurrentThreadId() + 1]);
+}
+
 void ThreadPool::TryParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
-                                const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
+                                const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn,
+                                const char* call_site_file, int call_site_line) {
   if (tp == nullptr) {
     fn(0, total);
     return;
   }
-  tp->ParallelFor(total, cost_per_unit, fn);
+  tp->ParallelFor(total, cost_per_unit, fn, ParallelForCallSite{call_site_file, call_site_line});
 }
 
 }  // namespace concurrency
@@ -2,8 +2,13 @@
 // Licensed under the MIT License.
 
 #include "core/eager/ort_kernel_invoker.h"
+
+#include <algorithm>
+#include <sstream>
+
 #include "core/optimizer/optimizer_execution_frame.h"
 #include "core/common/logging/logging.h"
+#include "core/framework/config_options.h"
 #include "core/graph/model.h"
 #include "core/framework/op_kernel.h"
 #include "core/session/ort_env.h"
@@ -13,46 +18,93 @@ namespace onnxruntime {
 
 #define ORT_EAGER_ONNX_OPSET_VERSION 14
 
-common::Status ORTInvoker::Invoke(const std::string& op_name,
-                                  // optional inputs / outputs?
-                                  const std::vector<OrtValue>& inputs,
-                                  std::vector<OrtValue>& outputs,
-                                  const NodeAttributes* attributes,
-                                  const std::string& domain,
-                                  const int version) {
+// A kernel with the single node graph it was created from. The kernel and its OpKernelInfo reference the node, the
+// frame info and the config options, so they all live as long as the kernel.
+struct ORTInvoker::CachedKernel {
+  std::unique_ptr<Model> model;
+  const Node* node{nullptr};
+  std::function<bool(const std::string&)> is_sparse_initializer_func;
+  ConfigOptions config_options;
+  std::unique_ptr<OptimizerExecutionFrame::Info> info;
+  std::unique_ptr<const OpKernel> kernel;
+};
+
+namespace {
+
+std::string GetKernelCacheKey(const std::string& op_name, const std::vector<OrtValue>& inputs, size_t output_count,
+                              const NodeAttributes* attributes, const std::string& domain, int version) {
+  std::ostringstream key;
+  key << domain << ':' << op_name << ':' << version << ':' << output_count;
+  for (const auto& input : inputs) {
+    key << ':' << input.Get<Tensor>().GetElementType();
+  }
+
+  if (attributes != nullptr) {
+    // the attributes are unordered
+    std::vector<const std::string*> names;
+    names.reserve(attributes->size());
+    for (const auto& attribute : *attributes) {
+      names.push_back(&attribute.first);
+    }
+    std::sort(names.begin(), names.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+    for (const auto* name : names) {
+      const std::string value = attributes->at(*name).SerializeAsString();
+      key << ':' << value.size() << ':' << value;
+    }
+  }
+
+  return key.str();
+}
+
+}  // namespace
+
+Status ORTInvoker::GetOrCreateKernel(const std::string& op_name, const std::vector<OrtValue>& inputs,
+                                     size_t output_count, const NodeAttributes* attributes,
+                                     const std::string& domain, int version,
+                                     std::shared_ptr<const CachedKernel>& kernel) {
+  const std::string key = GetKernelCacheKey(op_name, inputs, output_count, attributes, domain, version);
+  {
+    std::lock_guard<std::mutex> lock(kernel_cache_mutex_);
+    auto it = kernel_cache_.find(key);
+    if (it != kernel_cache_.end()) {
+      kernel_cache_list_.splice(kernel_cache_list_.begin(), kernel_cache_list_, it->second);
+      kernel = it->second->second;
+      return Status::OK();
+    }
+  }
+
   std::unordered_map<std::string, int> domain_version_map = {{kOnnxDomain, ORT_EAGER_ONNX_OPSET_VERSION},
                                                              {kMSDomain, 1}};
+  auto cached = std::make_shared<CachedKernel>();
   // create a graph
-  Model model("test",
-              false,
-              ModelMetaData(),
-              ORT_TSTR(""),
-              custom_op_registries_,
-              domain_version_map,
-              {},
-              logger_);
+  cached->model = std::make_unique<Model>("test",
+                                          false,
+                                          ModelMetaData(),
+                                          ORT_TSTR(""),
+                                          custom_op_registries_,
+                                          domain_version_map,
+                                          std::vector<ONNX_NAMESPACE::FunctionProto>{},
+                                          logger_);
 
   std::vector<onnxruntime::NodeArg*> input_args;
   std::vector<onnxruntime::NodeArg*> output_args;
 
   input_args.reserve(inputs.size());
-  output_args.reserve(outputs.size());
+  output_args.reserve(output_count);
 
-  Graph& graph = model.MainGraph();
-  std::unordered_map<std::string, OrtValue> initializer_map;
+  Graph& graph = cached->model->MainGraph();
   size_t i = 0;
 
-  for (auto input : inputs) {
+  for (const auto& input : inputs) {
     std::string name = "I" + std::to_string(i++);
     const Tensor& input_tensor = input.Get<Tensor>();
     ONNX_NAMESPACE::TypeProto input_tensor_type;
     input_tensor_type.mutable_tensor_type()->set_elem_type(input_tensor.GetElementType());
     auto& arg = graph.GetOrCreateNodeArg(name, &input_tensor_type);
     input_args.push_back(&arg);
-    initializer_map[name] = input;
   }
 
-  for (i = 0; i < outputs.size(); ++i) {
+  for (i = 0; i < output_count; ++i) {
     auto& arg = graph.GetOrCreateNodeArg("O" + std::to_string(i), nullptr);
     output_args.push_back(&arg);
   }
@@ -61,36 +113,85 @@ common::Status ORTInvoker::Invoke(const std::string& op_name,
   ORT_RETURN_IF_ERROR(graph.Resolve());
 
   node.SetExecutionProviderType(execution_provider_->Type());
-  std::vector<const Node*> frame_nodes{&node};
-
-  OptimizerExecutionFrame::Info info({&node}, initializer_map, graph.ModelPath(), *execution_provider_, [](std::string const&) { return false; });
+  cached->node = &node;
+
+  // The kernel is created without initializers, so it reads every input at compute time and can be reused for
+  // different input values.
+  cached->is_sparse_initializer_func = [](const std::string&) { return false; };
+  cached->info = std::make_unique<OptimizerExecutionFrame::Info>(
+      std::vector<const Node*>{&node}, std::unordered_map<std::string, OrtValue>{}, graph.ModelPath(),
+      *execution_provider_, cached->is_sparse_initializer_func, logger_);
   const KernelCreateInfo* kernel_create_info = nullptr;
-  ORT_RETURN_IF_ERROR(info.TryFindKernel(&node, &kernel_create_info));
+  ORT_RETURN_IF_ERROR(cached->info->TryFindKernel(&node, &kernel_create_info));
   if (!kernel_create_info) {
     ORT_THROW("Could not find kernel name:", op_name, ", domain:", domain, ", version:", version);
   }
-  // check whether the inputs are contiguous tensor
-  const auto& may_strided_inputs = kernel_create_info->kernel_def->MayStridedInput();
-  for (i = 0; i < inputs.size(); ++i) {
-    const Tensor& input_tensor = inputs[i].Get<Tensor>();
-    if (!input_tensor.IsContiguous() && std::find(may_strided_inputs.begin(), may_strided_inputs.end(),
-                                                  static_cast<int>(i)) == may_strided_inputs.end())
-      ORT_THROW("kernel name:", op_name, "'s ", i, "th input doesn't support non-contiguous tensor.");
+  cached->kernel = cached->info->CreateKernel(&node, cached->config_options);
+  if (!cached->kernel) {
+    ORT_THROW("Could not find kernel name:", op_name, ", domain:", domain, ", version:", version);
   }
 
-  auto kernel = info.CreateKernel(&node);
-  if (!kernel) {
-    ORT_THROW("Could not find kernel name:", op_name, ", domain:", domain, ", version:", version);
+  std::lock_guard<std::mutex> lock(kernel_cache_mutex_);
+  // another thread may have created the same kernel meanwhile, use the one in the cache
+  auto it = kernel_cache_.find(key);
+  if (it != kernel_cache_.end()) {
+    kernel = it->second->second;
+    return Status::OK();
+  }
+
+  kernel_cache_list_.emplace_front(key, std::move(cached));
+  kernel_cache_.emplace(key, kernel_cache_list_.begin());
+  kernel = kernel_cache_list_.front().second;
+  if (kernel_cache_list_.size() > kMaxCachedKernels) {
+    kernel_cache_.erase(kernel_cache_list_.back().first);
+    kernel_cache_list_.pop_back();
+  }
+  return Status::OK();
+}
+
+void ORTInvoker::ClearKernelCache() {
+  std::lock_guard<std::mutex> lock(kernel_cache_mutex_);
+  kernel_cache_.clear();
+  kernel_cache_list_.clear();
+}
+
+common::Status ORTInvoker::Invoke(const std::string& op_name,
+                                  // optional inputs / outputs?
+                                  const std::vector<OrtValue>& inputs,
+                                  std::vector<OrtValue>& outputs,
+                                  const NodeAttributes* attributes,
+                                  const std::string& domain,
+                                  const int version) {
+  std::shared_ptr<const CachedKernel> cached;
+  ORT_RETURN_IF_ERROR(GetOrCreateKernel(op_name, inputs, outputs.size(), attributes, domain, version, cached));
+
+  const Node& node = *cached->node;
+  std::unordered_map<std::string, OrtValue> initializer_map;
+  size_t i = 0;
+  for (const auto& input : inputs) {
+    // check whether the inputs are contiguous tensor
+    const Tensor& input_tensor = input.Get<Tensor>();
+    if (!input_tensor.IsContiguous()) {
+      const auto& may_strided_inputs = cached->kernel->KernelDef().MayStridedInput();
+      if (std::find(may_strided_inputs.begin(), may_strided_inputs.end(), static_cast<int>(i)) ==
+          may_strided_inputs.end()) {
+        ORT_THROW("kernel name:", op_name, "'s ", i, "th input doesn't support non-contiguous tensor.");
+      }
+    }
+    initializer_map[node.InputDefs()[i++]->Name()] = input;
   }
 
+  // The frame takes the inputs of this invocation from its info.
+  OptimizerExecutionFrame::Info info({&node}, initializer_map, node.ModelPath(), *execution_provider_,
+                                     cached->is_sparse_initializer_func, logger_);
   std::vector<int> fetch_mlvalue_idxs;
   for (const auto* node_out : node.OutputDefs()) {
     fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
   }
 
   OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs, outputs);
-  OpKernelContext op_kernel_context(&frame, kernel.get(), nullptr, nullptr, logger_);
-  ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
+  OpKernelContext op_kernel_context(&frame, cached->kernel.get(), nullptr, nullptr, logger_);
+  ORT_RETURN_IF_ERROR(cached->kernel->Compute(&op_kernel_context));
 
   return frame.GetOutputs(outputs);
 }
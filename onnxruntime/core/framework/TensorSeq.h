@@ -98,6 +98,26 @@ class TensorSeq {
     Add(std::move(value));
   }
 
+  // Inserts the tensor at position `index`, shifting the following ones.
+  void Insert(size_t index, OrtValue&& tensor) {
+    ORT_ENFORCE(index <= tensors_.size());
+    ORT_ENFORCE(IsSameDataType(tensor.Get<Tensor>()),
+                "TensorSeq: tensor to be inserted has a different data type.");
+    tensors_.insert(tensors_.begin() + index, std::move(tensor));
+  }
+
+  void Insert(size_t index, Tensor&& tensor) {
+    OrtValue value;
+    Tensor::InitOrtValue(std::move(tensor), value);
+    Insert(index, std::move(value));
+  }
+
+  // Removes the tensor at position `index`. The buffer is released with the last OrtValue sharing it.
+  void Erase(size_t index) {
+    ORT_ENFORCE(index < tensors_.size());
+    tensors_.erase(tensors_.begin() + index);
+  }
+
   static void InitOrtValue(const TensorSeq& source_tensor_seq, std::shared_ptr<IAllocator> allocator, OrtValue& ort_value) {
     auto target_tensor_seq = std::make_unique<TensorSeq>(source_tensor_seq.DataType());
     target_tensor_seq->Reserve(source_tensor_seq.Size());
@@ -5,9 +5,13 @@
 #include <list>
 #include <algorithm>
 #include <deque>
+#include <limits>
+#include <numeric>
+#include <optional>
 #include <sstream>
 #include <ctime>
 #include <iomanip>
+#include <tuple>
 #include "core/common/exceptions.h"
 #include "core/common/inlined_containers.h"
 #include "core/common/safeint.h"
@@ -543,6 +547,8 @@ class PlannerImpl {
 
   bool SameSize(const onnxruntime::NodeArg& arg1, const onnxruntime::NodeArg& arg2) {
     if ((!arg1.Exists()) || (!arg2.Exists())) return false;
+    // A sequence has no planned buffer: reusing one only shares the TensorSeq, which the kernel resizes as needed.
+    if (IsSequence(arg1) && IsSequence(arg2)) return true;
     auto p_shape1 = context_->GetShape(arg1);
     auto p_shape2 = context_->GetShape(arg2);
     // If the shapes are unknown, we conservatively assume they may be of different size.
@@ -641,9 +647,13 @@ class PlannerImpl {
   }
 
   Status ComputeReuseCount() {
-    for (auto graph_input : graph_viewer_.GetInputs()) {
-      OrtValueIndex index = Index(graph_input->Name());
-      UseCount(index)++;  // Models caller's usage post-inference; ensures it will not be reused.
+    // the user may permit writing over the feeds of the main graph. subgraph inputs are owned by the parent node.
+    const bool reuse_graph_inputs = parent_node_ == nullptr && context_->GetAllowInplaceOnGraphInputs();
+    if (!reuse_graph_inputs) {
+      for (auto graph_input : graph_viewer_.GetInputs()) {
+        OrtValueIndex index = Index(graph_input->Name());
+        UseCount(index)++;  // Models caller's usage post-inference; ensures it will not be reused.
+      }
     }
 
     for (auto node_arg : outer_scope_node_args_) {
@@ -1864,7 +1874,7 @@ class PlannerImpl {
             break;
           }
         }
-        if (is_all_consumer_same_stream) {
+        if (is_all_consumer_same_stream && !context_->IsWorkStealingExecutionEnabled()) {
           // all the consumers are on the same stream, so the first element is the last consumer int the stream.
           process_consumer(release_action_idx, ortvalue_to_consumers_map[i][0]);
         } else {
@@ -1878,6 +1888,220 @@ class PlannerImpl {
     return Status::OK();
   }
 
+  // Estimated size in bytes of a tensor produced by a node, for ReorderNodesForPeakMemory.
+  // Symbolic dimensions count as 1, values without a known shape or that aren't tensors count as 0.
+  size_t EstimateValueSize(const onnxruntime::NodeArg& arg) const {
+    const auto* type_proto = arg.TypeAsProto();
+    const auto* shape = context_->GetShape(arg);
+    if (type_proto == nullptr || !utils::HasTensorType(*type_proto) || !utils::HasElemType(type_proto->tensor_type()) ||
+        shape == nullptr) {
+      return 0;
+    }
+
+    SafeInt<size_t> size = GetElementSize(arg.Type());
+    for (const auto& dim : shape->dim()) {
+      if (utils::HasDimValue(dim) && dim.dim_value() > 0) {
+        size *= static_cast<size_t>(dim.dim_value());
+      }
+    }
+    return size;
+  }
+
+  // Reorders the nodes of a single logic stream to reduce the peak size of the values they produce, before the reuse
+  // plan is computed on top of the order. Nodes are picked greedily among the ready ones, preferring the node that
+  // leads to the lowest live size after it runs or after one of the nodes it alone makes ready runs, then the lowest
+  // peak while it runs, then the original order. The new order is only used if its estimated peak is lower.
+  void ReorderNodesForPeakMemory() {
+    if (stream_nodes_.size() != 1 || context_->IsParallelExecutionEnabled()) {
+      return;
+    }
+
+    auto& nodes = stream_nodes_[0];
+    const size_t num_nodes = nodes.size();
+    if (num_nodes < 3) {
+      return;
+    }
+
+    InlinedHashMap<NodeIndex, size_t> node_positions;
+    node_positions.reserve(num_nodes);
+    for (size_t i = 0; i < num_nodes; ++i) {
+      node_positions[nodes[i]] = i;
+    }
+
+    // the values produced by the nodes. graph outputs are never freed.
+    struct ValueInfo {
+      int64_t size;
+      int num_consumers;
+      bool is_graph_output;
+    };
+    InlinedVector<ValueInfo> values;
+    InlinedHashMap<const NodeArg*, size_t> value_ids;
+    InlinedHashSet<const NodeArg*> graph_outputs(graph_viewer_.GetOutputs().begin(), graph_viewer_.GetOutputs().end());
+
+    // per node: the ids of the values it produces and consumes, the nodes that depend on it, the number of nodes it
+    // depends on, and the size it allocates
+    std::vector<InlinedVector<size_t>> node_outputs(num_nodes);
+    std::vector<InlinedVector<size_t>> node_inputs(num_nodes);
+    std::vector<InlinedVector<size_t>> successors(num_nodes);
+    std::vector<size_t> num_predecessors(num_nodes, 0);
+    std::vector<int64_t> alloc_size(num_nodes, 0);
+
+    for (size_t i = 0; i < num_nodes; ++i) {
+      const auto* node = graph_viewer_.GetNode(nodes[i]);
+      for (const auto* output_def : node->OutputDefs()) {
+        if (!output_def->Exists() || value_ids.count(output_def) != 0) {
+          continue;
+        }
+        const auto size = static_cast<int64_t>(EstimateValueSize(*output_def));
+        value_ids[output_def] = values.size();
+        node_outputs[i].push_back(values.size());
+        values.push_back({size, 0, graph_outputs.count(output_def) != 0});
+        alloc_size[i] += size;
+      }
+    }
+
+    for (size_t i = 0; i < num_nodes; ++i) {
+      const auto* node = graph_viewer_.GetNode(nodes[i]);
+      auto add_input = [&](const NodeArg* input_def) {
+        auto it = value_ids.find(input_def);
+        if (it != value_ids.end() &&
+            std::find(node_inputs[i].begin(), node_inputs[i].end(), it->second) == node_inputs[i].end()) {
+          node_inputs[i].push_back(it->second);
+          ++values[it->second].num_consumers;
+        }
+      };
+      for (const auto* input_def : node->InputDefs()) {
+        add_input(input_def);
+      }
+      for (const auto* input_def : node->ImplicitInputDefs()) {
+        add_input(input_def);
+      }
+
+      InlinedHashSet<size_t> predecessors;
+      for (auto edge = node->InputEdgesBegin(); edge != node->InputEdgesEnd(); ++edge) {
+        auto it = node_positions.find(edge->GetNode().Index());
+        if (it != node_positions.end() && predecessors.insert(it->second).second) {
+          successors[it->second].push_back(i);
+        }
+      }
+      num_predecessors[i] = predecessors.size();
+    }
+
+    auto consumes = [&node_inputs](size_t node, size_t value) {
+      return std::find(node_inputs[node].begin(), node_inputs[node].end(), value) != node_inputs[node].end();
+    };
+
+    // the size freed once `node` has run, given the remaining number of consumers of each value. `prior` is a node
+    // that runs before it and isn't accounted for in `remaining` yet.
+    auto freed_size = [&](size_t node, const std::vector<int>& remaining, std::optional<size_t> prior) {
+      int64_t freed = 0;
+      for (size_t value : node_inputs[node]) {
+        const int remaining_consumers = remaining[value] - (prior && consumes(*prior, value) ? 1 : 0);
+        if (remaining_consumers == 1 && !values[value].is_graph_output) {
+          freed += values[value].size;
+        }
+      }
+      for (size_t value : node_outputs[node]) {
+        if (values[value].num_consumers == 0 && !values[value].is_graph_output) {
+          freed += values[value].size;
+        }
+      }
+      return freed;
+    };
+
+    auto estimate_peak = [&](gsl::span<const size_t> order) {
+      std::vector<int> remaining(values.size());
+      for (size_t v = 0; v < values.size(); ++v) {
+        remaining[v] = values[v].num_consumers;
+      }
+      int64_t live = 0;
+      int64_t peak = 0;
+      for (size_t node : order) {
+        live += alloc_size[node];
+        peak = std::max(peak, live);
+        live -= freed_size(node, remaining, std::nullopt);
+        for (size_t value : node_inputs[node]) {
+          --remaining[value];
+        }
+      }
+      return peak;
+    };
+
+    std::vector<int> remaining(values.size());
+    for (size_t v = 0; v < values.size(); ++v) {
+      remaining[v] = values[v].num_consumers;
+    }
+    std::vector<size_t> pending_predecessors = num_predecessors;
+    InlinedVector<size_t> ready;
+    for (size_t i = 0; i < num_nodes; ++i) {
+      if (pending_predecessors[i] == 0) {
+        ready.push_back(i);
+      }
+    }
+
+    std::vector<size_t> order;
+    order.reserve(num_nodes);
+    int64_t live = 0;
+    while (!ready.empty()) {
+      size_t best = 0;
+      std::tuple<int64_t, int64_t, size_t> best_key{std::numeric_limits<int64_t>::max(), 0, 0};
+      for (size_t r = 0; r < ready.size(); ++r) {
+        const size_t node = ready[r];
+        const int64_t peak_while_running = live + alloc_size[node];
+        const int64_t live_after = peak_while_running - freed_size(node, remaining, std::nullopt);
+
+        // look ahead at the nodes that only wait for this one
+        int64_t lowest_live = live_after;
+        for (size_t successor : successors[node]) {
+          if (pending_predecessors[successor] == 1) {
+            lowest_live = std::min(lowest_live,
+                                   live_after + alloc_size[successor] - freed_size(successor, remaining, node));
+          }
+        }
+
+        const std::tuple<int64_t, int64_t, size_t> key{lowest_live, peak_while_running, node};
+        if (key < best_key) {
+          best_key = key;
+          best = r;
+        }
+      }
+
+      const size_t node = ready[best];
+      ready.erase(ready.begin() + best);
+      order.push_back(node);
+      live += alloc_size[node] - freed_size(node, remaining, std::nullopt);
+      for (size_t value : node_inputs[node]) {
+        --remaining[value];
+      }
+      for (size_t successor : successors[node]) {
+        if (--pending_predecessors[successor] == 0) {
+          ready.push_back(successor);
+        }
+      }
+    }
+
+    // a cycle would have left nodes out. the graph is sorted so it is a bug if this happens.
+    ORT_ENFORCE(order.size() == num_nodes, "Failed to order the nodes of the graph for the peak memory.");
+
+    std::vector<size_t> original_order(num_nodes);
+    std::iota(original_order.begin(), original_order.end(), size_t{0});
+    const int64_t original_peak = estimate_peak(original_order);
+    const int64_t reordered_peak = estimate_peak(order);
+    if (reordered_peak >= original_peak) {
+      return;
+    }
+
+    LOGS(logger_, INFO) << "Reordered the nodes of graph " << graph_viewer_.Name()
+                        << " for the peak memory. Estimated peak: " << original_peak << " -> " << reordered_peak
+                        << " bytes.";
+    InlinedVector<NodeIndex> reordered_nodes;
+    reordered_nodes.reserve(num_nodes);
+    for (size_t position : order) {
+      reordered_nodes.push_back(nodes[position]);
+    }
+    nodes = std::move(reordered_nodes);
+  }
+
 #ifndef ORT_ENABLE_STREAM
   void PartitionIntoStreams(const ExecutionProviders& /*execution_providers*/,
                             const PathString& /*partition_config_file*/) {
@@ -2254,6 +2478,11 @@ class PlannerImpl {
     return !utils::HasTensorType(type_proto);
   }
 
+  static bool IsSequence(const onnxruntime::NodeArg& nodearg) {
+    const auto* type_proto = nodearg.TypeAsProto();
+    return type_proto != nullptr && type_proto->value_case() == ONNX_NAMESPACE::TypeProto::kSequenceType;
+  }
+
 #if !defined(DISABLE_OPTIONAL_TYPE)
   static bool IsOptionalType(const onnxruntime::NodeArg& nodearg) {
     const auto* type_proto = nodearg.TypeAsProto();
@@ -2295,6 +2524,10 @@ Status PlannerImpl::CreatePlan(
   // 1. partition graph into streams
   PartitionIntoStreams(execution_providers_, parent_node_ ? PathString{} : partition_config_file);
 
+  if (context_->GetEnableMemoryAwareOrder()) {
+    ReorderNodesForPeakMemory();
+  }
+
   // 2. initialize the plan based on stream partition result
   int num_ml_values = ort_value_name_idx_map_.MaxIdx() + 1;
 
@@ -2548,11 +2781,188 @@ void DeviceBasedPartitioner::SaveConfig() const {
   }
 }
 
+/*
+BranchBasedPartitioner stores config in json format:
+------------------------------------------------------
+{
+"type":"BranchBasedPartitioner",
+"max_streams_per_device":4,
+"collective_stream":true
+}
+------------------------------------------------------
+Nodes of a non-CPU device are spread over a pool of up to "max_streams_per_device" streams, so that independent
+branches of the graph (e.g. the towers of an encoder or the experts of a MoE layer) can run concurrently.
+A node continues the stream of one of its producers when that producer is the last node of the stream, so chains
+of nodes stay on one stream. The other consumers of a producer start a new branch, which gets a new stream while
+the pool is not full, and the least used stream of the device otherwise.
+The dependencies between streams are synchronized by the notifications the planner inserts for every cross stream
+edge. CPU nodes are kept on a single stream.
+With "collective_stream", the collective ops of a non-CPU device (AllReduce, AllGather, AllToAll) run on a stream
+of their own, outside of the pool, so that the other streams keep computing while the collectives communicate.
+The nodes waiting on a collective are also moved after the independent nodes that precede the next collective
+depending on them, so that this independent work, e.g. dequantizing the weights of the next layer, is issued first.
+*/
+class BranchBasedPartitioner : public IGraphPartitioner {
+ public:
+  BranchBasedPartitioner(const logging::Logger& logger,
+                         const PathString& config_file,
+                         size_t max_streams_per_device,
+                         bool collective_stream) : IGraphPartitioner(logger, config_file),
+                                                   max_streams_per_device_(std::max<size_t>(1, max_streams_per_device)),
+                                                   collective_stream_(collective_stream) {}
+
+  Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
+                        const ExecutionProviders& execution_providers,
+                        std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                        ExecutionOrder execution_order) override;
+
+  const char* Type() const override { return "BranchBasedPartitioner"; }
+  size_t Streams() const override { return num_streams_; }
+
+ private:
+  static bool IsCollective(const Node& node) {
+    return node.Domain() == kMSDomain &&
+           (node.OpType() == "AllReduce" || node.OpType() == "AllGather" || node.OpType() == "AllToAll");
+  }
+
+  // Moves the nodes waiting on recently issued collectives after the independent nodes of their streams.
+  void OverlapCollectives(const onnxruntime::GraphViewer& graph_viewer,
+                          std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                          const InlinedHashMap<NodeIndex, size_t>& node_stream,
+                          const InlinedHashSet<NodeIndex>& collectives,
+                          ExecutionOrder execution_order) const;
+
+  size_t max_streams_per_device_;
+  bool collective_stream_;
+  size_t num_streams_ = 0;
+};
+
+Status BranchBasedPartitioner::PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
+                                              const ExecutionProviders& execution_providers,
+                                              std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                                              ExecutionOrder execution_order) {
+  stream_nodes.clear();
+  // streams of each device, indexing into stream_nodes
+  InlinedHashMap<OrtDevice, InlinedVector<size_t>> device_streams;
+  InlinedHashMap<NodeIndex, size_t> node_stream;
+  // collective stream of each device, not part of the pool of device_streams
+  InlinedHashMap<OrtDevice, size_t> collective_streams;
+  InlinedHashSet<NodeIndex> collectives;
+
+  for (auto node_index : graph_viewer.GetNodesInTopologicalOrder(execution_order)) {
+    const auto* node = graph_viewer.GetNode(node_index);
+    const auto* ep = execution_providers.Get(*node);
+    ORT_RETURN_IF(ep == nullptr, "Failed to find the execution provider of node ", node->Name());
+    const auto device = ep->GetOrtDeviceByMemType(OrtMemType::OrtMemTypeDefault);
+
+    if (collective_stream_ && device.Type() != OrtDevice::CPU && IsCollective(*node)) {
+      auto it = collective_streams.find(device);
+      if (it == collective_streams.end()) {
+        it = collective_streams.emplace(device, stream_nodes.size()).first;
+        stream_nodes.emplace_back();
+      }
+      stream_nodes[it->second].push_back(node_index);
+      node_stream[node_index] = it->second;
+      collectives.insert(node_index);
+      continue;
+    }
+
+    auto& streams = device_streams[device];
+
+    std::optional<size_t> stream;
+    for (auto input_edge = node->InputEdgesBegin(); input_edge != node->InputEdgesEnd() && !stream; ++input_edge) {
+      const auto producer = input_edge->GetNode().Index();
+      auto it = node_stream.find(producer);
+      if (it != node_stream.end() && stream_nodes[it->second].back() == producer &&
+          std::find(streams.begin(), streams.end(), it->second) != streams.end()) {
+        stream = it->second;
+      }
+    }
+
+    if (!stream) {
+      if (streams.empty() || (device.Type() != OrtDevice::CPU && streams.size() < max_streams_per_device_)) {
+        streams.push_back(stream_nodes.size());
+        stream_nodes.emplace_back();
+        stream = streams.back();
+      } else {
+        stream = *std::min_element(streams.begin(), streams.end(), [&stream_nodes](size_t a, size_t b) {
+          return stream_nodes[a].size() < stream_nodes[b].size();
+        });
+      }
+    }
+
+    stream_nodes[*stream].push_back(node_index);
+    node_stream[node_index] = *stream;
+  }
+
+  if (!collectives.empty()) {
+    OverlapCollectives(graph_viewer, stream_nodes, node_stream, collectives, execution_order);
+  }
+
+  num_streams_ = stream_nodes.size();
+  LOGS(logger_, INFO) << "BranchBasedPartitioner placed " << node_stream.size() << " nodes on " << num_streams_
+                      << " streams";
+  return Status::OK();
+}
+
+// The nodes waiting on a collective issued since the last flush, directly or through other waiting nodes, are
+// deferred. They are flushed to their streams, in topological order, when a collective depends on one of them, which
+// starts a new window. A deferred node only moves after nodes that don't depend on it, so the order of every stream
+// remains a subsequence of a single topological order, and the notifications between streams can't deadlock.
+void BranchBasedPartitioner::OverlapCollectives(const onnxruntime::GraphViewer& graph_viewer,
+                                                std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                                                const InlinedHashMap<NodeIndex, size_t>& node_stream,
+                                                const InlinedHashSet<NodeIndex>& collectives,
+                                                ExecutionOrder execution_order) const {
+  for (auto& nodes : stream_nodes) {
+    nodes.clear();
+  }
+
+  InlinedHashSet<NodeIndex> waiting;
+  InlinedVector<NodeIndex> deferred;
+  size_t num_deferred = 0;
+  auto flush = [&]() {
+    for (auto deferred_index : deferred) {
+      stream_nodes[node_stream.at(deferred_index)].push_back(deferred_index);
+    }
+    deferred.clear();
+    waiting.clear();
+  };
+
+  for (auto node_index : graph_viewer.GetNodesInTopologicalOrder(execution_order)) {
+    const auto* node = graph_viewer.GetNode(node_index);
+    bool waits = false;
+    for (auto input_edge = node->InputEdgesBegin(); input_edge != node->InputEdgesEnd() && !waits; ++input_edge) {
+      waits = waiting.count(input_edge->GetNode().Index()) > 0;
+    }
+
+    if (collectives.count(node_index) > 0) {
+      if (waits) {
+        flush();
+      }
+      stream_nodes[node_stream.at(node_index)].push_back(node_index);
+      waiting.insert(node_index);
+    } else if (waits) {
+      deferred.push_back(node_index);
+      waiting.insert(node_index);
+      ++num_deferred;
+    } else {
+      stream_nodes[node_stream.at(node_index)].push_back(node_index);
+    }
+  }
+  flush();
+
+  LOGS(logger_, INFO) << "BranchBasedPartitioner placed " << collectives.size() << " collectives on their own streams, "
+                      << num_deferred << " nodes waiting on them run after independent work";
+}
+
 std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(const logging::Logger& logger,
                                                                              const PathString& config_file) {
   // use device based partitioner by default
   IGraphPartitioner::GraphPartitioningStrategy partitioner_type =
       IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
+  size_t max_streams_per_device = 4;
+  bool collective_stream = false;
   if (!config_file.empty()) {
     std::ifstream f(config_file);
     if (f.is_open()) {
@@ -2562,6 +2972,10 @@ std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(con
           auto type = json_config["type"];
           if (type == "DeviceBasedPartitioner") {
             partitioner_type = IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
+          } else if (type == "BranchBasedPartitioner") {
+            partitioner_type = IGraphPartitioner::GraphPartitioningStrategy::BranchBasedPartition;
+            max_streams_per_device = json_config.value("max_streams_per_device", max_streams_per_device);
+            collective_stream = json_config.value("collective_stream", collective_stream);
           }
         }
       } catch (const std::exception& ex) {
@@ -2573,6 +2987,10 @@ std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(con
   if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition) {
     LOGS(logger, INFO) << "Use DeviceBasedPartition as default";
     return std::make_unique<DeviceBasedPartitioner>(logger, config_file);
+  } else if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::BranchBasedPartition) {
+    LOGS(logger, INFO) << "Use BranchBasedPartition with up to " << max_streams_per_device << " streams per device"
+                       << (collective_stream ? " and a stream for the collectives" : "");
+    return std::make_unique<BranchBasedPartitioner>(logger, config_file, max_streams_per_device, collective_stream);
   }  // else if other partitioner types ...
   ORT_THROW("Failed to create partitioner");
 }
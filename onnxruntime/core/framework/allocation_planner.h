@@ -43,34 +43,60 @@ class ISequentialPlannerContext {
   // see PlannerImpl::ComputeReusePlan
   virtual bool IsParallelExecutionEnabled() const { return false; }
 
+  // If it returns true, nodes within a logic stream may run out of order, so the planner can't statically pick the
+  // last consumer of a value and uses ref counting for all releases. see PlannerImpl::GenerateDeallocationPlan
+  virtual bool IsWorkStealingExecutionEnabled() const { return false; }
+
   virtual ExecutionOrder GetExecutionOrder() const { return ExecutionOrder::DEFAULT; }
 
   virtual bool GetEnableMemoryReuse() const { return true; }
+
+  // If it returns true, the planner reorders the nodes of a single logic stream to reduce the peak size of the
+  // values they produce. see PlannerImpl::ReorderNodesForPeakMemory
+  virtual bool GetEnableMemoryAwareOrder() const { return false; }
+
+  // If it returns true, the inputs of the main graph are treated like intermediate values after their last use, so
+  // an in-place kernel may write its output over a graph input and the buffer may be reused for other values.
+  // see PlannerImpl::ComputeReuseCount
+  virtual bool GetAllowInplaceOnGraphInputs() const { return false; }
   virtual ~ISequentialPlannerContext() = default;
 };
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse)
+  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse,
+                           bool enable_memory_aware_order = false, bool allow_inplace_on_graph_inputs = false)
       : execution_mode_(execution_mode),
         execution_order_(execution_order),
-        enable_memory_reuse_(enable_memory_reuse) {
+        enable_memory_reuse_(enable_memory_reuse),
+        enable_memory_aware_order_(enable_memory_aware_order),
+        allow_inplace_on_graph_inputs_(allow_inplace_on_graph_inputs) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     return arg.Shape();
   }
 
-  bool IsParallelExecutionEnabled() const override { return execution_mode_ == ExecutionMode::ORT_PARALLEL; }
+  bool IsParallelExecutionEnabled() const override { return execution_mode_ != ExecutionMode::ORT_SEQUENTIAL; }
+
+  bool IsWorkStealingExecutionEnabled() const override {
+    return execution_mode_ == ExecutionMode::ORT_PARALLEL_WORK_STEALING;
+  }
 
   ExecutionOrder GetExecutionOrder() const override { return execution_order_; }
 
   bool GetEnableMemoryReuse() const override { return enable_memory_reuse_; }
 
+  bool GetEnableMemoryAwareOrder() const override { return enable_memory_aware_order_; }
+
+  bool GetAllowInplaceOnGraphInputs() const override { return allow_inplace_on_graph_inputs_; }
+
  private:
   ExecutionMode execution_mode_ = ExecutionMode::ORT_SEQUENTIAL;
   ExecutionOrder execution_order_ = ExecutionOrder::DEFAULT;
   bool enable_memory_reuse_ = true;
+  bool enable_memory_aware_order_ = false;
+  bool allow_inplace_on_graph_inputs_ = false;
 };
 
 #ifdef ORT_ENABLE_STREAM
@@ -82,9 +108,10 @@ class IGraphPartitioner {
   // DeviceBasedPartitioner is the default, who partitions a graph based off device information.
   // i.e., given a graph which has CPU EP nodes, Cuda EP nodes and TRT EP nodes,
   // it will be partitioned as two sequences, one is for CPU EP nodes, another is for TRT and Cuda nodes.
-  // We will add more optimized partitioner later.
+  // BranchBasedPartitioner additionally spreads independent branches of a device over a pool of streams.
   enum GraphPartitioningStrategy {
     DeviceBasedPartition = 0,
+    BranchBasedPartition,
     Unknown,
   };
   virtual ~IGraphPartitioner() = default;
@@ -34,6 +34,12 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
     int64_t max_power_of_two_extend_bytes = info.arena_cfg.max_power_of_two_extend_bytes == -1
                                                 ? BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES
                                                 : info.arena_cfg.max_power_of_two_extend_bytes;
+    int64_t thread_cache_max_bytes = info.arena_cfg.thread_cache_max_bytes == -1
+                                         ? BFCArena::DEFAULT_THREAD_CACHE_MAX_BYTES
+                                         : info.arena_cfg.thread_cache_max_bytes;
+    int64_t idle_shrink_interval_ms = info.arena_cfg.idle_shrink_interval_ms == -1
+                                          ? BFCArena::DEFAULT_IDLE_SHRINK_INTERVAL_MS
+                                          : info.arena_cfg.idle_shrink_interval_ms;
     ArenaExtendStrategy arena_extend_str;
     switch (info.arena_cfg.arena_extend_strategy) {
       case static_cast<int>(ArenaExtendStrategy::kSameAsRequested):
@@ -54,11 +60,13 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
       return AllocatorPtr(
           std::make_unique<StreamAwareArena>(std::move(device_allocator),
                                              max_mem,
-                                             info.enable_cross_stream_reusing,
+                                             info.enable_cross_stream_reusing ||
+                                                 info.arena_cfg.cross_stream_reuse == 1,
                                              arena_extend_str,
                                              initial_chunk_size_bytes,
                                              max_dead_bytes_per_chunk,
-                                             initial_growth_chunk_size_bytes));
+                                             initial_growth_chunk_size_bytes,
+                                             max_power_of_two_extend_bytes));
 #else
       ORT_THROW("StreamAwareArena should be transparent to minimal build.");
 #endif
@@ -70,7 +78,9 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                      initial_chunk_size_bytes,
                                      max_dead_bytes_per_chunk,
                                      initial_growth_chunk_size_bytes,
-                                     max_power_of_two_extend_bytes));
+                                     max_power_of_two_extend_bytes,
+                                     thread_cache_max_bytes,
+                                     idle_shrink_interval_ms));
     }
   } else {
     return device_allocator;
@@ -3,6 +3,10 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <type_traits>
 
 namespace onnxruntime {
@@ -12,7 +16,9 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int64_t thread_cache_max_bytes,
+                   int64_t idle_shrink_interval_ms)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -25,12 +31,16 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
       initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
-      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes) {
+      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes),
+      thread_cache_max_bytes_(thread_cache_max_bytes > 0 ? static_cast<size_t>(thread_cache_max_bytes) : 0),
+      idle_shrink_interval_ms_(std::max<int64_t>(idle_shrink_interval_ms, 0)) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
+                     << " thread_cache_max_bytes: " << thread_cache_max_bytes_
+                     << " idle_shrink_interval_ms: " << idle_shrink_interval_ms_
                      << " memory limit: " << total_memory
                      << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
 
@@ -75,9 +85,30 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (thread_cache_max_bytes_ > 0) {
+    thread_cache_shards_ = std::make_unique<ThreadCacheShard[]>(kNumThreadCacheShards);
+    for (size_t i = 0; i < kNumThreadCacheShards; ++i) {
+      thread_cache_shards_[i].free_lists.resize(kMaxThreadCachedChunkSize / kMinAllocationSize);
+    }
+    thread_cache_registry_ = std::make_unique<ThreadCacheRegistryShard[]>(kNumThreadCacheShards);
+  }
+
+  if (idle_shrink_interval_ms_ > 0) {
+    idle_shrink_thread_ = std::thread(&BFCArena::IdleShrinkLoop, this);
+  }
 }
 
 BFCArena::~BFCArena() {
+  if (idle_shrink_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(idle_shrink_mutex_);
+      stop_idle_shrink_ = true;
+    }
+    idle_shrink_cv_.notify_one();
+    idle_shrink_thread_.join();
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -269,9 +300,106 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_cache_max_bytes_ > 0 && size > 0 && size <= kMaxThreadCachedChunkSize) {
+    return AllocFromThreadCache(size);
+  }
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
+// static
+size_t BFCArena::ThreadCacheShardIndex() {
+  static std::atomic<size_t> next_shard_index{0};
+  thread_local const size_t shard_index =
+      next_shard_index.fetch_add(1, std::memory_order_relaxed) % kNumThreadCacheShards;
+  return shard_index;
+}
+
+void* BFCArena::AllocFromThreadCache(size_t size) {
+  const size_t rounded_bytes = RoundedBytes(size);
+  void* ptr = nullptr;
+  {
+    ThreadCacheShard& shard = thread_cache_shards_[ThreadCacheShardIndex()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& free_list = shard.free_lists[ThreadCacheFreeListIndex(rounded_bytes)];
+    if (!free_list.empty()) {
+      ptr = free_list.back();
+      free_list.pop_back();
+      shard.cached_bytes -= rounded_bytes;
+    }
+  }
+
+  if (ptr != nullptr) {
+    // the registry entry is kept while the chunk is parked so there is nothing else to update
+    num_thread_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+    return ptr;
+  }
+
+  num_thread_cache_misses_.fetch_add(1, std::memory_order_relaxed);
+  // allocate the rounded size so the chunk can service any request in the same size class when it is reused
+  ptr = AllocateRawInternal(rounded_bytes, false, nullptr, false, nullptr);
+
+  ThreadCacheRegistryShard& registry = ThreadCacheRegistryShardFor(ptr);
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.rounded_sizes[ptr] = rounded_bytes;
+  return ptr;
+}
+
+bool BFCArena::FreeToThreadCache(void* p) {
+  ThreadCacheRegistryShard& registry = ThreadCacheRegistryShardFor(p);
+  size_t rounded_bytes = 0;
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.rounded_sizes.find(p);
+    if (it == registry.rounded_sizes.end()) {
+      return false;
+    }
+    rounded_bytes = it->second;
+  }
+
+  {
+    ThreadCacheShard& shard = thread_cache_shards_[ThreadCacheShardIndex()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.cached_bytes + rounded_bytes <= thread_cache_max_bytes_) {
+      shard.free_lists[ThreadCacheFreeListIndex(rounded_bytes)].push_back(p);
+      shard.cached_bytes += rounded_bytes;
+      return true;
+    }
+  }
+
+  // the shard is full. stop tracking the chunk and let the caller return it to the arena.
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.rounded_sizes.erase(p);
+  return false;
+}
+
+void BFCArena::FlushThreadCaches() {
+  if (thread_cache_max_bytes_ == 0) {
+    return;
+  }
+
+  std::vector<void*> parked;
+  for (size_t i = 0; i < kNumThreadCacheShards; ++i) {
+    ThreadCacheShard& shard = thread_cache_shards_[i];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (auto& free_list : shard.free_lists) {
+      parked.insert(parked.end(), free_list.begin(), free_list.end());
+      free_list.clear();
+    }
+    shard.cached_bytes = 0;
+  }
+
+  for (void* p : parked) {
+    ThreadCacheRegistryShard& registry = ThreadCacheRegistryShardFor(p);
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.rounded_sizes.erase(p);
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  for (void* p : parked) {
+    DeallocateRawInternal(p);
+  }
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -335,11 +463,11 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
                              wait_fn);
 
   if (chunk != nullptr) {
-    // if it is on default stream (the new allocate chunk), assign to current stream
-    if (chunk->stream == nullptr) {
+    // The chunk was free on no stream, or its stream is ordered before this one. Assign it to this stream so that
+    // the stream it was on waits for this one before reusing it.
+    if (stream && chunk->stream != stream) {
       chunk->stream = stream;
-      if (stream)
-        chunk->stream_timestamp = stream->GetCurrentTimestamp();
+      chunk->stream_timestamp = stream->GetCurrentTimestamp();
     }
     return chunk->ptr;
   }
@@ -352,9 +480,10 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   if (status.IsOK()) {
     chunk = FindChunkPtr(bin_num, rounded_bytes, num_bytes, stream, false);
     if (chunk != nullptr) {
-      // if it is on default stream (the new allocate chunk), assign to current stream
-      if (chunk->stream == nullptr && stream) {
+      // the new chunk is on no stream, assign it to the current one
+      if (stream) {
         chunk->stream = stream;
+        chunk->stream_timestamp = stream->GetCurrentTimestamp();
       }
       return chunk->ptr;
     } else {
@@ -379,6 +508,10 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<std::mutex> lock(lock_);
   *stats = stats_;
+  stats->num_thread_cache_hits = num_thread_cache_hits_.load(std::memory_order_relaxed);
+  stats->num_thread_cache_misses = num_thread_cache_misses_.load(std::memory_order_relaxed);
+  // cache hits never reach the arena so count them here to keep num_allocs consistent with the number of Alloc calls
+  stats->num_allocs += stats->num_thread_cache_hits;
 }
 
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
@@ -410,6 +543,10 @@ BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* fr
       std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
   stats_.max_alloc_size =
       std::max<int64_t>(stats_.max_alloc_size, static_cast<int64_t>(chunk->size));
+  if (idle_shrink_interval_ms_ > 0) {
+    interval_peak_bytes_in_use_ = std::max(interval_peak_bytes_in_use_, stats_.bytes_in_use);
+    region_manager_.set_last_use_epoch(chunk->ptr, idle_shrink_epoch_);
+  }
   return chunk;
 }
 
@@ -417,7 +554,8 @@ BFCArena::Chunk* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
                                         size_t num_bytes, Stream* stream,
                                         bool allow_chunk_from_different_stream,
                                         WaitNotificationFn wait_fn) {
-  BFCArena::Chunk* other_stream_candidate = nullptr;
+  BFCArena::Bin::FreeChunkSet* other_stream_free_chunks = nullptr;
+  BFCArena::Bin::FreeChunkSet::iterator other_stream_citer;
   // First identify the first bin that could satisfy rounded_bytes.
   for (; bin_num < kNumBins; bin_num++) {
     // Start searching from the first bin for the smallest chunk that fits
@@ -436,21 +574,22 @@ BFCArena::Chunk* BFCArena::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
         if (safe_to_use) {
           // the chunk with same stream has higher priority.
           return SplitFreeChunkFromBin(&b->free_chunks, citer, rounded_bytes, num_bytes);
-        } else if (allow_chunk_from_different_stream && !other_stream_candidate) {
-          other_stream_candidate = chunk;
+        } else if (allow_chunk_from_different_stream && !other_stream_free_chunks) {
+          // the smallest chunk that fits, the bins and their free chunks are ordered by size
+          other_stream_free_chunks = &b->free_chunks;
+          other_stream_citer = citer;
         }
       }
     }
   }
-  // if trying to use an unsafe chunk from other streams, secure it.
-  if (other_stream_candidate) {
-    SecureTheChunk(other_stream_candidate->stream, stream, wait_fn);
-    // if find some available chunk, make sure mark it as "being used" before return
-    other_stream_candidate->allocation_id = next_allocation_id_++;
-    other_stream_candidate->bin_num = kInvalidBinNum;
+  // if trying to use an unsafe chunk from other streams, make this stream wait for that one first.
+  // the chunk is split like any other so the rest of it stays available to the stream it was on.
+  if (other_stream_free_chunks) {
+    SecureTheChunk(ChunkFromHandle(*other_stream_citer)->stream, stream, wait_fn);
+    return SplitFreeChunkFromBin(other_stream_free_chunks, other_stream_citer, rounded_bytes, num_bytes);
   }
 
-  return other_stream_candidate;
+  return nullptr;
 }
 
 void BFCArena::SplitChunk(BFCArena::ChunkHandle h, size_t num_bytes) {
@@ -496,6 +635,9 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (thread_cache_max_bytes_ > 0 && FreeToThreadCache(p)) {
+    return;
+  }
   std::lock_guard<std::mutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -508,69 +650,123 @@ void BFCArena::Free(void* p) {
   }
 }
 
+bool BFCArena::IsRegionInUse(void* region_ptr) {
+  ChunkHandle h = region_manager_.get_handle(region_ptr);
+  while (h != kInvalidChunkHandle) {
+    const Chunk* c = ChunkFromHandle(h);
+    if (c->in_use()) {
+      return true;
+    }
+    h = c->next;
+  }
+
+  return false;
+}
+
+void BFCArena::RemoveRegion(void* region_ptr, size_t region_size) {
+  stats_.num_arena_shrinkages += 1;
+  stats_.total_allocated_bytes -= region_size;
+
+  LOGS_DEFAULT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
+                        << region_size << " bytes. "
+                        << " The total allocated bytes is now " << stats_.total_allocated_bytes;
+
+  ChunkHandle h = region_manager_.get_handle(region_ptr);
+  while (h != kInvalidChunkHandle) {
+    const ChunkHandle next = ChunkFromHandle(h)->next;
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    h = next;
+  }
+
+  region_manager_.RemoveAllocationRegion(region_ptr);
+  stats_.num_arena_extensions--;
+}
+
 Status BFCArena::Shrink() {
-  std::lock_guard<std::mutex> lock(lock_);
-  auto num_regions = region_manager_.regions().size();
-  std::vector<void*> region_ptrs;
-  std::vector<size_t> region_sizes;
-  region_ptrs.reserve(num_regions);
-  region_sizes.reserve(num_regions);
+  FlushThreadCaches();
 
-  for (const auto& region : region_manager_.regions()) {
-    if (consider_first_allocation_region_for_shrinkage_ || region.id() != 0) {
-      region_ptrs.push_back(region.ptr());
-      region_sizes.push_back(region.memory_size());
+  std::vector<void*> removed_region_ptrs;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    std::vector<std::pair<void*, size_t>> regions;
+    regions.reserve(region_manager_.regions().size());
+
+    for (const auto& region : region_manager_.regions()) {
+      if (consider_first_allocation_region_for_shrinkage_ || region.id() != 0) {
+        regions.emplace_back(region.ptr(), region.memory_size());
+      }
     }
-  }
 
-  size_t i = 0;
-  for (void* region_ptr : region_ptrs) {
-    bool deallocate_region = true;
-    ChunkHandle region_begin_chunk = region_manager_.get_handle(region_ptr);
-    ChunkHandle h = region_begin_chunk;
-    while (h != kInvalidChunkHandle) {
-      const Chunk* c = ChunkFromHandle(h);
-      if (c->in_use()) {
-        // at-least one used chunk found in the allocation region -
-        // so we cannot deallocate it
-        deallocate_region = false;
-        break;
+    for (const auto& [region_ptr, region_size] : regions) {
+      // a region with at least one used chunk cannot be deallocated
+      if (!IsRegionInUse(region_ptr)) {
+        RemoveRegion(region_ptr, region_size);
+        removed_region_ptrs.push_back(region_ptr);
       }
-      h = c->next;
     }
 
-    if (deallocate_region) {
-      auto shrink_size = region_sizes[i];
-      stats_.num_arena_shrinkages += 1;
-      stats_.total_allocated_bytes -= shrink_size;
+    // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
+    // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
+    curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+  }
 
-      LOGS_DEFAULT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
-                            << shrink_size << " bytes. "
-                            << " The total allocated bytes is now " << stats_.total_allocated_bytes;
+  // the regions are no longer reachable from the arena so their memory is freed without holding the arena lock
+  for (void* region_ptr : removed_region_ptrs) {
+    device_allocator_->Free(region_ptr);
+  }
 
-      h = region_begin_chunk;
-      ChunkHandle temp = region_begin_chunk;
-      while (h != kInvalidChunkHandle) {
-        const Chunk* c = ChunkFromHandle(h);
-        temp = c->next;
-        RemoveFreeChunkFromBin(h);
-        DeleteChunk(h);
-        h = temp;
+  return Status::OK();
+}
+
+void BFCArena::ShrinkIdleRegions() {
+  std::vector<void*> removed_region_ptrs;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    recent_peak_bytes_in_use_ = std::max(interval_peak_bytes_in_use_, recent_peak_bytes_in_use_ / 2);
+    interval_peak_bytes_in_use_ = stats_.bytes_in_use;
+
+    // regions with no chunk allocated in the interval that just ended and none in use now, largest first
+    std::vector<std::pair<size_t, void*>> idle_regions;
+    for (const auto& region : region_manager_.regions()) {
+      if ((consider_first_allocation_region_for_shrinkage_ || region.id() != 0) &&
+          region.last_use_epoch() < idle_shrink_epoch_ && !IsRegionInUse(region.ptr())) {
+        idle_regions.emplace_back(region.memory_size(), region.ptr());
+      }
+    }
+
+    std::sort(idle_regions.begin(), idle_regions.end(), std::greater<>());
+
+    for (const auto& [region_size, region_ptr] : idle_regions) {
+      // keep enough memory for the recent peak so a steady workload does not extend the arena again
+      if (stats_.total_allocated_bytes - static_cast<int64_t>(region_size) < recent_peak_bytes_in_use_) {
+        continue;
       }
 
-      device_allocator_->Free(region_ptr);
-      region_manager_.RemoveAllocationRegion(region_ptr);
-      stats_.num_arena_extensions--;
+      RemoveRegion(region_ptr, region_size);
+      removed_region_ptrs.push_back(region_ptr);
     }
 
-    ++i;
+    if (!removed_region_ptrs.empty()) {
+      curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+    }
+
+    ++idle_shrink_epoch_;
   }
 
-  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
-  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
-  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+  for (void* region_ptr : removed_region_ptrs) {
+    device_allocator_->Free(region_ptr);
+  }
+}
 
-  return Status::OK();
+void BFCArena::IdleShrinkLoop() {
+  std::unique_lock<std::mutex> lock(idle_shrink_mutex_);
+  while (!idle_shrink_cv_.wait_for(lock, std::chrono::milliseconds(idle_shrink_interval_ms_),
+                                   [this] { return stop_idle_shrink_; })) {
+    lock.unlock();
+    ShrinkIdleRegions();
+    lock.lock();
+  }
 }
 
 void BFCArena::DeallocateRawInternal(void* ptr) {
@@ -16,9 +16,13 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 #include "onnxruntime_config.h"
 
@@ -61,6 +65,10 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  // The per-thread small-chunk cache is disabled by default.
+  static const int64_t DEFAULT_THREAD_CACHE_MAX_BYTES = 0;
+  // Shrinking idle allocation regions in the background is disabled by default.
+  static const int64_t DEFAULT_IDLE_SHRINK_INTERVAL_MS = 0;
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +81,9 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int64_t thread_cache_max_bytes = DEFAULT_THREAD_CACHE_MAX_BYTES,
+           int64_t idle_shrink_interval_ms = DEFAULT_IDLE_SHRINK_INTERVAL_MS);
 
   ~BFCArena() override;
 
@@ -87,12 +97,18 @@ class BFCArena : public IAllocator {
 
   // Frees all allocation regions in which no chunk is in use.
   // Does not free any reserved chunks.
+  // Chunks parked in the per-thread small-chunk caches are returned to the arena first.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
   // future allocation sizes are determined by the arena growth strategy
   // and the allocation request.
   Status Shrink();
 
+  // Frees the allocation regions that had no chunk in use for at least one interval, as long as the arena keeps
+  // enough memory for the recent peak usage. The peak of each interval decays by half for every following interval.
+  // Called every `idle_shrink_interval_ms` by a background thread when that interval is positive.
+  void ShrinkIdleRegions();
+
   void* Reserve(size_t size) override;
 
   void GetStats(AllocatorStats* stats) override;
@@ -123,6 +139,52 @@ class BFCArena : public IAllocator {
  private:
   void DeallocateRawInternal(void* ptr);
 
+  // Per-thread small-chunk cache.
+  //
+  // When enabled (thread_cache_max_bytes > 0), allocations of up to kMaxThreadCachedChunkSize bytes made through
+  // Alloc()/Free() are serviced from a cache shard selected by the calling thread before falling back to the
+  // arena. Each thread is assigned its own shard (round-robin once there are more threads than shards), so in the
+  // steady state the shard mutex is uncontended and the global arena lock_ is not taken for cache hits.
+  //
+  // A cached chunk is still 'in use' from the arena's point of view, so a chunk handed out through the cache can be
+  // released via the regular arena path by any thread. ThreadCacheRegistryShard records which pointers were handed
+  // out through the cache (keyed by pointer so it works regardless of which thread frees the buffer).
+  static constexpr size_t kMaxThreadCachedChunkSize = 64 * 1024;
+  static constexpr size_t kNumThreadCacheShards = 16;
+
+  struct ThreadCacheShard {
+    std::mutex mutex;
+    // Free lists indexed by (rounded_bytes / kMinAllocationSize) - 1.
+    std::vector<std::vector<void*>> free_lists;
+    size_t cached_bytes = 0;
+  };
+
+  struct ThreadCacheRegistryShard {
+    std::mutex mutex;
+    // Pointers owned by the cache (handed out or parked), mapped to their rounded size.
+    std::unordered_map<const void*, size_t> rounded_sizes;
+  };
+
+  static size_t ThreadCacheShardIndex();
+  static size_t ThreadCacheFreeListIndex(size_t rounded_bytes) { return (rounded_bytes >> kMinAllocationBits) - 1; }
+  ThreadCacheRegistryShard& ThreadCacheRegistryShardFor(const void* p) {
+    return thread_cache_registry_[(reinterpret_cast<std::uintptr_t>(p) >> kMinAllocationBits) %
+                                  kNumThreadCacheShards];
+  }
+
+  // Removes the region and its chunks from the arena. The caller frees the memory of the region, which may be done
+  // after releasing lock_. Requires that no chunk of the region is in use.
+  void RemoveRegion(void* region_ptr, size_t region_size);
+  bool IsRegionInUse(void* region_ptr);
+
+  void IdleShrinkLoop();
+
+  void* AllocFromThreadCache(size_t size);
+  // Returns true if 'p' was handed out through the cache and is now parked in the calling thread's shard.
+  bool FreeToThreadCache(void* p);
+  // Returns all parked chunks to the arena.
+  void FlushThreadCaches();
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -264,6 +326,8 @@ class BFCArena : public IAllocator {
     }
     void set_handle(const void* p, ChunkHandle h) { handles_[IndexFor(p)] = h; }
     void erase(const void* p) { set_handle(p, kInvalidChunkHandle); }
+    uint64_t last_use_epoch() const { return last_use_epoch_; }
+    void set_last_use_epoch(uint64_t epoch) { last_use_epoch_ = epoch; }
 
    private:
     void Swap(AllocationRegion& other) {
@@ -271,6 +335,7 @@ class BFCArena : public IAllocator {
       std::swap(memory_size_, other.memory_size_);
       std::swap(end_ptr_, other.end_ptr_);
       std::swap(id_, other.id_);
+      std::swap(last_use_epoch_, other.last_use_epoch_);
       std::swap(handles_, other.handles_);
     }
 
@@ -289,6 +354,8 @@ class BFCArena : public IAllocator {
     // A unique identifier for this allocation region
     // (May be used by the client to track which allocation region was allocated first, second, and so on)
     int64_t id_ = -1;
+    // The idle shrink interval in which a chunk of this region was last allocated.
+    uint64_t last_use_epoch_ = 0;
 
     // Array of size "memory_size / kMinAllocationSize".  It is
     // indexed by (p-base) / kMinAllocationSize, contains ChunkHandle
@@ -332,6 +399,7 @@ class BFCArena : public IAllocator {
       return MutableRegionFor(p)->set_handle(p, h);
     }
     void erase(const void* p) { return MutableRegionFor(p)->erase(p); }
+    void set_last_use_epoch(const void* p, uint64_t epoch) { MutableRegionFor(p)->set_last_use_epoch(epoch); }
 
     const std::vector<AllocationRegion>& regions() const { return regions_; }
 
@@ -509,6 +577,23 @@ class BFCArena : public IAllocator {
   const int initial_growth_chunk_size_bytes_;
   const int64_t max_power_of_two_extend_bytes_;
 
+  // Maximum bytes parked in each thread cache shard. 0 disables the cache.
+  const size_t thread_cache_max_bytes_;
+  std::unique_ptr<ThreadCacheShard[]> thread_cache_shards_;
+  std::unique_ptr<ThreadCacheRegistryShard[]> thread_cache_registry_;
+  std::atomic<int64_t> num_thread_cache_hits_{0};
+  std::atomic<int64_t> num_thread_cache_misses_{0};
+
+  // Background shrinking of idle regions. The epoch and the peaks are GUARDED_BY(lock_).
+  const int64_t idle_shrink_interval_ms_;
+  uint64_t idle_shrink_epoch_ = 0;
+  int64_t interval_peak_bytes_in_use_ = 0;
+  int64_t recent_peak_bytes_in_use_ = 0;
+  std::thread idle_shrink_thread_;
+  std::mutex idle_shrink_mutex_;
+  std::condition_variable idle_shrink_cv_;
+  bool stop_idle_shrink_ = false;  // GUARDED_BY(idle_shrink_mutex_)
+
   // This flag is only relevant if Shrink() is invoked.
   // This is a boolean flag that controls whether the first allocation region
   // is to be considered for shrinkage or not.
@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/framework/data_transfer_manager.h"
+
+#include <algorithm>
+
+#include "core/common/inlined_containers.h"
 #include "core/framework/tensor.h"
 #include "core/framework/sparse_tensor.h"
 
@@ -96,49 +100,44 @@ common::Status DataTransferManager::CopyTensors(const std::vector<IDataTransfer:
   if (src_dst_pairs.empty())
     return Status::OK();
 
-  const auto& first_pair = src_dst_pairs.front();
-  const OrtDevice& src_device = first_pair.src.get().Location().device;
-  const OrtDevice& dst_device = first_pair.dst.get().Location().device;
-
-  bool all_same = std::all_of(src_dst_pairs.cbegin() + 1, src_dst_pairs.cend(),
-                              [&src_device, &dst_device](const IDataTransfer::SrcDstPair& pair) {
-                                return pair.src.get().Location().device == src_device &&
-                                       pair.dst.get().Location().device == dst_device;
-                              });
-
-  IDataTransfer* first_dt = nullptr;
-
-  for (auto& data_transfer : datatransfers_) {
-    if (data_transfer->CanCopy(src_device, dst_device)) {
-      first_dt = data_transfer.get();
-      break;
+  // batch the copies of each IDataTransfer instance so each of them can issue its copies together and synchronize
+  // once. the copies of an instance keep their relative order.
+  InlinedVector<std::pair<const IDataTransfer*, std::vector<IDataTransfer::SrcDstPair>>, 2> batches;
+  const OrtDevice* src_device = nullptr;
+  const OrtDevice* dst_device = nullptr;
+  std::vector<IDataTransfer::SrcDstPair>* batch = nullptr;
+  for (const auto& pair : src_dst_pairs) {
+    const OrtDevice& pair_src_device = pair.src.get().Location().device;
+    const OrtDevice& pair_dst_device = pair.dst.get().Location().device;
+    if (batch == nullptr || pair_src_device != *src_device || pair_dst_device != *dst_device) {
+      const IDataTransfer* data_transfer = GetDataTransfer(pair_src_device, pair_dst_device);
+      if (data_transfer == nullptr) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME,
+                               FAIL,
+                               "There's no data transfer registered for copying tensors from ",
+                               pair_src_device.ToString(),
+                               " to ",
+                               pair_dst_device.ToString());
+      }
+
+      auto it = std::find_if(batches.begin(), batches.end(),
+                             [data_transfer](const auto& entry) { return entry.first == data_transfer; });
+      if (it == batches.end()) {
+        batches.emplace_back(data_transfer, std::vector<IDataTransfer::SrcDstPair>{});
+        it = batches.end() - 1;
+        it->second.reserve(src_dst_pairs.size());
+      }
+
+      batch = &it->second;
+      src_device = &pair_src_device;
+      dst_device = &pair_dst_device;
     }
-  }
 
-  if (first_dt == nullptr) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME,
-                           FAIL,
-                           "There's no data transfer registered for copying tensors from ",
-                           src_device.ToString(),
-                           " to ",
-                           dst_device.ToString());
-  }
-
-  // all copies are between the same devices so we can do them all at once
-  if (all_same) {
-    return first_dt->CopyTensors(src_dst_pairs);
+    batch->push_back(pair);
   }
 
-  // there are a mix of devices requiring copies. we don't expect this to happen, so just iterate the pairs
-  // copying one at a time. if this becomes expected we could create a list for each IDataTransfer instance so we
-  // batch as much as possible.
-
-  // copy the first one as we already did the IDataTransfer lookup
-  ORT_RETURN_IF_ERROR(first_pair.src_stream ? first_dt->CopyTensorAsync(first_pair.src.get(), first_pair.dst.get(), *(first_pair.src_stream))
-                                            : first_dt->CopyTensor(first_pair.src.get(), first_pair.dst.get()));
-
-  for (auto cur_pair = src_dst_pairs.cbegin() + 1, end_pair = src_dst_pairs.cend(); cur_pair != end_pair; ++cur_pair) {
-    ORT_RETURN_IF_ERROR(!cur_pair->src_stream ? CopyTensor(cur_pair->src, cur_pair->dst) : CopyTensorAsync(cur_pair->src, cur_pair->dst, *(cur_pair->src_stream)));
+  for (const auto& [data_transfer, pairs] : batches) {
+    ORT_RETURN_IF_ERROR(data_transfer->CopyTensors(pairs));
   }
 
   return Status::OK();
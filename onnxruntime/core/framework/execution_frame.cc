@@ -357,7 +357,8 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
       device_streams_(device_streams),
 #endif
       session_state_(session_state),
-      mem_patterns_(nullptr) {
+      mem_patterns_(nullptr),
+      object_arena_(session_state.AcquireFrameObjectArena()) {
   Init(
       feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(),
 #if !defined(DISABLE_SPARSE_TENSORS)
@@ -410,8 +411,9 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
       // if no existing patterns, generate one in this execution frame
       if (!mem_patterns_) {
         planner_.emplace(*session_state.GetExecutionPlan());
-      } else {
-        // pre-allocate the big chunk requested in memory pattern.
+      } else if (!session_state.AcquireMemoryPatternBuffers(*mem_patterns_, buffers_)) {
+        // pre-allocate the big chunk requested in memory pattern, unless a previous execution of the subgraph
+        // left the buffers for it.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
         buffers_.reserve(mem_patterns_->locations.size());
         for (size_t i = 0; i < mem_patterns_->locations.size(); i++) {
@@ -492,7 +494,13 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
   }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  session_state_.ReleaseFrameObjectArena(std::move(object_arena_));
+
+  if (mem_patterns_ && !buffers_.empty()) {
+    session_state_.ReleaseMemoryPatternBuffers(std::move(mem_patterns_), std::move(buffers_));
+  }
+}
 
 Status ExecutionFrame::CopyTensor(const Tensor& src, Tensor& dest) const {
   return session_state_.GetDataTransferMgr().CopyTensor(src, dest);
@@ -502,6 +510,21 @@ const DataTransferManager& ExecutionFrame::GetDataTransferManager() const {
   return session_state_.GetDataTransferMgr();
 }
 
+template <typename... TArgs>
+void ExecutionFrame::InitTensorOrtValue(OrtValue& ort_value, int ort_value_index, TArgs&&... tensor_args) {
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+
+  // graph outputs are handed to the caller so they would keep the arena from being reused
+  if (object_arena_ && ort_value_index != NodeIndexInfo::kInvalidEntry && !IsOutput(ort_value_index)) {
+    ort_value.Init(std::allocate_shared<Tensor>(FrameObjectArenaAllocator<Tensor>(object_arena_),
+                                                std::forward<TArgs>(tensor_args)...),
+                   ml_tensor);
+  } else {
+    auto p_tensor = std::make_unique<Tensor>(std::forward<TArgs>(tensor_args)...);
+    ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+  }
+}
+
 Status ExecutionFrame::AllocateMLValueTensorSelfOwnBuffer(OrtValue& ort_value, int ort_value_index,
                                                           MLDataType element_type, const OrtDevice& location,
                                                           const TensorShape& shape) {
@@ -541,33 +564,33 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
 
   if (mem_patterns_ && per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput &&
       per_alloc_plan.alloc_kind != AllocKind::kAllocatedExternally) {
-    auto pattern = mem_patterns_->GetPatterns(location);
-    if (pattern) {
-      auto block = pattern->GetBlock(ort_value_index);
-      // if block not found, fall back to default behavior
-      if (block) {
-        auto it = buffers_.find(location);
-        if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
-            void* buffer = it->second.get();
-            auto status = AllocateTensorWithPreAllocateBufferHelper(
-                ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
-                shape);
-            return status;
-          } else {
-            // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
-            // fed in, so use VERBOSE as the log level as it's expected.
-            // TODO: Should we reuse the block if the size is large enough? Would probably need to allow it
-            // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
-            LOGS(session_state_.Logger(), VERBOSE) << "For ort_value with index: " << ort_value_index
-                                                   << ", block in memory pattern size is: " << block->size_
-                                                   << " but the actual size is: " << size
-                                                   << ", fall back to default allocation behavior";
-          }
+    const MemoryBlock* block = mem_patterns_->GetBlock(location, ort_value_index);
+    // if block not found, fall back to default behavior
+    if (block) {
+      auto it = buffers_.find(location);
+      if (it != buffers_.end()) {
+        // if the block is not correct, log message then fall back to default behavior.
+        // with shape bucketing the pattern was learned from the largest shapes in the bucket so smaller
+        // tensors can use the block as well.
+        if (block->size_ == size ||
+            (block->size_ > size && session_state_.IsMemoryPatternShapeBucketingEnabled())) {
+          void* buffer = it->second.get();
+          auto status = AllocateTensorWithPreAllocateBufferHelper(
+              ort_value, ort_value_index, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type,
+              location, shape);
+          return status;
+        } else {
+          // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
+          // fed in, so use VERBOSE as the log level as it's expected.
+          // TODO: Should we reuse the block if the size is large enough? Would probably need to allow it
+          // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
+          LOGS(session_state_.Logger(), VERBOSE) << "For ort_value with index: " << ort_value_index
+                                                 << ", block in memory pattern size is: " << block->size_
+                                                 << " but the actual size is: " << size
+                                                 << ", fall back to default allocation behavior";
         }
-        // else { we couldn't allocate the large block for the buffer so we didn't insert an entry }
       }
+      // else { we couldn't allocate the large block for the buffer so we didn't insert an entry }
     }
   }
 
@@ -585,15 +608,15 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       auto wait_handle = this->session_state_.GetStreamHandleRegistryInstance().GetWaitHandle(
           current_stream->GetDevice().Type(), current_stream->GetDevice().Type());
       void* p_data = stream_aware_alloc->AllocOnStream(buffer_size, current_stream, wait_handle);
-      Tensor::InitOrtValue(element_type, shape, p_data, std::move(alloc), ort_value);
+      InitTensorOrtValue(ort_value, ort_value_index, element_type, shape, p_data, std::move(alloc));
     } else {
-      Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
+      InitTensorOrtValue(ort_value, ort_value_index, element_type, shape, std::move(alloc));
     }
 #else
     ORT_THROW("Ort value is associated with a Stream but Stream is not enabled in the build.");
 #endif
   } else {
-    Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
+    InitTensorOrtValue(ort_value, ort_value_index, element_type, shape, std::move(alloc));
   }
 
   // trace the memory allocation.
@@ -621,6 +644,15 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
                                                               MLDataType element_type, const OrtDevice& location,
                                                               const TensorShape& shape,
                                                               bool is_strided_tensor) {
+  return AllocateMLValueTensorPreAllocateBufferImpl(ort_value, NodeIndexInfo::kInvalidEntry, ort_value_index_reuse,
+                                                    element_type, location, shape, is_strided_tensor);
+}
+
+Status ExecutionFrame::AllocateMLValueTensorPreAllocateBufferImpl(OrtValue& ort_value, int ort_value_index,
+                                                                  int ort_value_index_reuse,
+                                                                  MLDataType element_type, const OrtDevice& location,
+                                                                  const TensorShape& shape,
+                                                                  bool is_strided_tensor) {
   OrtValue& ort_value_reuse = GetMutableMLValue(ort_value_index_reuse);
 
   auto* reuse_tensor = ort_value_reuse.GetMutable<Tensor>();
@@ -658,14 +690,15 @@ Status ExecutionFrame::AllocateMLValueTensorPreAllocateBuffer(OrtValue& ort_valu
 
   void* reuse_buffer = reuse_tensor->MutableDataRaw();
 
-  return AllocateTensorWithPreAllocateBufferHelper(ort_value, reuse_buffer, element_type, location, shape);
+  return AllocateTensorWithPreAllocateBufferHelper(ort_value, ort_value_index, reuse_buffer, element_type, location,
+                                                   shape);
 }
 
-Status ExecutionFrame::AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_value, void* pBuffer,
-                                                                 MLDataType element_type,
+Status ExecutionFrame::AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_value, int ort_value_index,
+                                                                 void* pBuffer, MLDataType element_type,
                                                                  const OrtDevice& location,
                                                                  const TensorShape& shape) {
-  Tensor::InitOrtValue(element_type, shape, pBuffer, GetAllocator(location)->Info(), ort_value, 0L);
+  InitTensorOrtValue(ort_value, ort_value_index, element_type, shape, pBuffer, GetAllocator(location)->Info());
   return Status::OK();
 }
 
@@ -766,8 +799,8 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
 #ifdef ENABLE_STRIDED_TENSORS
         is_strided_tensor = per_alloc_plan.is_strided_tensor;
 #endif  // ENABLE_STRIDED_TENSORS
-        ORT_RETURN_IF_ERROR(AllocateMLValueTensorPreAllocateBuffer(
-            ort_value, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, is_strided_tensor));
+        ORT_RETURN_IF_ERROR(AllocateMLValueTensorPreAllocateBufferImpl(
+            ort_value, ort_value_index, reuse_mlvalue_index, ml_data_type, alloc_info, *shape, is_strided_tensor));
         break;
       }
       case AllocKind::kShare: {
@@ -909,9 +942,10 @@ void ExecutionFrame::TraceFree(int ort_value_idx) {
     ORT_ENFORCE(ort_value_idx >= 0 && static_cast<size_t>(ort_value_idx) < alloc_plan.size());
     const auto& per_alloc_plan = alloc_plan[ort_value_idx];
 
-    // only trace tensors
+    // only trace tensors. graph inputs are released after their last use if they may be written over, but they were
+    // not allocated by this frame.
     auto ml_type = per_alloc_plan.value_type;
-    if (ml_type->IsTensorType()) {
+    if (ml_type->IsTensorType() && per_alloc_plan.alloc_kind != AllocKind::kPreExisting) {
       // tensors
       auto ml_data_type = static_cast<const TensorTypeBase*>(ml_type)->GetElementType();
       // don't trace string tensors
@@ -9,6 +9,7 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/common/status.h"
+#include "core/framework/frame_object_arena.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
@@ -209,8 +210,18 @@ class ExecutionFrame final : public IExecutionFrame {
   Status AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_value, int ort_value_index, MLDataType element_type,
                                                   const OrtDevice& location, const TensorShape& shape);
 
-  Status AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_value, void* pBuffer, MLDataType element_type,
-                                                   const OrtDevice& location, const TensorShape& shape);
+  Status AllocateMLValueTensorPreAllocateBufferImpl(OrtValue& ort_value, int ort_value_index,
+                                                    int ort_value_index_reuse, MLDataType element_type,
+                                                    const OrtDevice& location, const TensorShape& shape,
+                                                    bool is_strided_tensor);
+
+  Status AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_value, int ort_value_index, void* pBuffer,
+                                                   MLDataType element_type, const OrtDevice& location,
+                                                   const TensorShape& shape);
+
+  // Creates the Tensor of the value, in object_arena_ unless it is a graph output.
+  template <typename... TArgs>
+  void InitTensorOrtValue(OrtValue& ort_value, int ort_value_index, TArgs&&... tensor_args);
 
   void TraceAllocate(int ort_value_idx, size_t size);
   void TraceFree(int ort_value_idx);
@@ -231,7 +242,7 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -240,12 +251,15 @@ class ExecutionFrame final : public IExecutionFrame {
   // Big chunks on different locations that will be used by mem_pattern.
   InlinedHashMap<OrtDevice, BufferUniquePtr> buffers_;
 
+  // Holds the Tensor objects of the values that don't leave this execution, i.e. all but the graph outputs.
+  std::shared_ptr<FrameObjectArena> object_arena_;
+
   // Given the input shapes of the executed graph, ExecutionFrame tries inferring
   // all symbolic shapes. inferred_shapes_[i] is the shape of OrtValue indexed
   // by i, if the key i exists.
   // inferred_shapes_ is generated together with mem_patterns_.
   // It is never updated after creation
-  const InlinedHashMap<int, TensorShape>* inferred_shapes_{nullptr};
+  std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes_;
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Size of virtual memory allocated before any kernel execution.
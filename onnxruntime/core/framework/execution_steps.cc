@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/framework/execution_steps.h"
+
+#include <algorithm>
+
 #include "core/framework/sequential_executor.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 
@@ -70,6 +74,40 @@ Status LaunchKernelStep::Execute(StreamExecutionContext& ctx,
     return Status::OK();
   }
 #endif
+#ifdef ENABLE_TRAINING
+  // a partial graph run in single thread mode doesn't wait for the suspended streams
+  const bool can_suspend = ctx.GetCurrentRange() == nullptr;
+#else
+  constexpr bool can_suspend = true;
+#endif
+  if (can_suspend && ctx.GetSessionState().GetKernel(node_index_)->IsAsync()) {
+    // Suspend the stream until the kernel completed, then resume it after this step on the inter-op thread pool.
+    // The pending task keeps the run alive meanwhile.
+    const auto& steps = ctx.GetSessionState().GetExecutionPlan()->execution_plan[stream_idx]->steps_;
+    const auto it = std::find_if(steps.begin(), steps.end(), [this](const auto& step) { return step.get() == this; });
+    const size_t next_step = static_cast<size_t>(it - steps.begin()) + 1;
+
+    ctx.AddTask();
+    Status status = ExecuteKernelAsync(
+        ctx, node_index_, stream_idx, terminate_flag, session_scope,
+        [&ctx, stream_idx, next_step, &terminate_flag, &session_scope](Status kernel_status) {
+          if (!kernel_status.IsOK()) {
+            ctx.SetStatus(kernel_status);
+            ctx.CompleteTask();
+            return;
+          }
+          auto* tp = ctx.SingleThreadMode() ? nullptr : ctx.GetSessionState().GetInterOpThreadPool();
+          concurrency::ThreadPool::Schedule(tp, [&ctx, stream_idx, next_step, &terminate_flag, &session_scope]() {
+            RunSince(stream_idx, ctx, session_scope, terminate_flag, next_step);
+          });
+        });
+    if (!status.IsOK()) {
+      ctx.CompleteTask();
+    }
+    continue_flag = false;
+    return status;
+  }
+
   Status status = ExecuteKernel(ctx, node_index_, stream_idx, terminate_flag, session_scope);
   continue_flag = status.IsOK();
   return status;
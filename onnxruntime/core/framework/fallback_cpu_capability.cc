@@ -4,7 +4,9 @@
 #include "core/framework/fallback_cpu_capability.h"
 #include "core/common/inlined_containers.h"
 
+#include <algorithm>
 #include <queue>
+#include <utility>
 
 #include "onnx/defs/data_type_utils.h"
 
@@ -37,6 +39,157 @@ static bool IsSmallInitializer(const onnxruntime::GraphViewer& graph, const Node
 
   return size <= kSmallInitializerThreshold;
 }
+
+// Whether the value is a small integer or bool tensor, like a shape, indices or a size.
+static bool IsSmallMetadata(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return false;
+  }
+
+  const auto elem_type = type->tensor_type().elem_type();
+  if (elem_type != ONNX_NAMESPACE::TensorProto_DataType_INT64 &&
+      elem_type != ONNX_NAMESPACE::TensorProto_DataType_INT32 &&
+      elem_type != ONNX_NAMESPACE::TensorProto_DataType_BOOL) {
+    return false;
+  }
+
+  // the size must be known, so that large integer tensors like token ids stay on the device
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+  int64_t size = 1;
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value()) {
+      return false;
+    }
+    size *= dim.dim_value();
+  }
+
+  return size <= kSmallInitializerThreshold;
+}
+
+// Whether all the outputs of the node are small metadata.
+static bool ProducesSmallMetadata(const Node& node) {
+  for (const auto* output : node.OutputDefs()) {
+    if (output->Exists() && !IsSmallMetadata(*output)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Finds the nodes computing the values which the target EP consumes as CPU inputs, e.g. the shape input of Reshape,
+// if they only compute small metadata from CPU tensors, small initializers, small graph inputs and each other.
+// Placing them on CPU avoids copying the values to the device and back, which would make the device stream wait.
+static InlinedVector<NodeIndex> GetShapeComputationNodes(
+    const onnxruntime::GraphViewer& graph,
+    const InlinedHashSet<NodeIndex>& provider_nodes,
+    const InlinedHashMap<NodeIndex, const KernelCreateInfo*>& node_to_kernel,
+    const InlinedHashSet<const NodeArg*>& cpu_output_args) {
+  const auto& graph_inputs = graph.GetInputs();
+
+  // whether the node gets the input from outside of the shape computation. a large graph input is left out, as it
+  // is headed for the device and would pull its consumers to CPU.
+  auto is_available_on_cpu = [&](const Node& node, size_t input_index) {
+    const auto* input = node.InputDefs()[input_index];
+    return !input->Exists() || node_to_kernel.at(node.Index())->kernel_def->IsInputOnCpu(input_index) ||
+           IsSmallInitializer(graph, input) || cpu_output_args.find(input) != cpu_output_args.end() ||
+           (std::find(graph_inputs.begin(), graph_inputs.end(), input) != graph_inputs.end() &&
+            IsSmallMetadata(*input));
+  };
+
+  InlinedHashMap<NodeIndex, bool> is_shape_computation;
+
+  // a node is a shape computation if its other inputs are all produced by shape computations. the producers are
+  // checked first, by revisiting a node once the producers pushed after it are done.
+  auto check_node = [&](const Node& root) -> bool {
+    InlinedVector<std::pair<const Node*, bool>> stack{{&root, false}};
+    while (!stack.empty()) {
+      auto [node, producers_checked] = stack.back();
+      stack.pop_back();
+
+      if (!producers_checked) {
+        if (is_shape_computation.find(node->Index()) != is_shape_computation.end()) {
+          continue;
+        }
+        if (provider_nodes.find(node->Index()) == provider_nodes.end() || !ProducesSmallMetadata(*node)) {
+          is_shape_computation[node->Index()] = false;
+          continue;
+        }
+
+        stack.push_back({node, true});
+        for (size_t i = 0; i < node->InputDefs().size(); ++i) {
+          const Node* producer = is_available_on_cpu(*node, i)
+                                     ? nullptr
+                                     : graph.GetProducerNode(node->InputDefs()[i]->Name());
+          if (producer != nullptr) {
+            stack.push_back({producer, false});
+          }
+        }
+        continue;
+      }
+
+      bool result = true;
+      for (size_t i = 0; i < node->InputDefs().size() && result; ++i) {
+        if (is_available_on_cpu(*node, i)) {
+          continue;
+        }
+
+        const Node* producer = graph.GetProducerNode(node->InputDefs()[i]->Name());
+        auto it = producer != nullptr ? is_shape_computation.find(producer->Index()) : is_shape_computation.end();
+        result = it != is_shape_computation.end() && it->second;
+      }
+      is_shape_computation[node->Index()] = result;
+    }
+
+    return is_shape_computation[root.Index()];
+  };
+
+  InlinedVector<NodeIndex> shape_nodes;
+  InlinedHashSet<NodeIndex> added;
+  auto add_with_producers = [&](const Node& root) {
+    InlinedVector<const Node*> worklist{&root};
+    while (!worklist.empty()) {
+      const Node* node = worklist.back();
+      worklist.pop_back();
+      if (!added.insert(node->Index()).second) {
+        continue;
+      }
+
+      shape_nodes.push_back(node->Index());
+      for (const auto* input : node->InputDefs()) {
+        const Node* producer = input->Exists() ? graph.GetProducerNode(input->Name()) : nullptr;
+        if (producer != nullptr) {
+          auto it = is_shape_computation.find(producer->Index());
+          if (it != is_shape_computation.end() && it->second) {
+            worklist.push_back(producer);
+          }
+        }
+      }
+    }
+  };
+
+  for (const auto& [node_index, kernel_info] : node_to_kernel) {
+    const Node* node = graph.GetNode(node_index);
+    for (size_t i = 0; i < node->InputDefs().size(); ++i) {
+      const auto* input = node->InputDefs()[i];
+      if (!input->Exists() || !kernel_info->kernel_def->IsInputOnCpu(i) ||
+          cpu_output_args.find(input) != cpu_output_args.end()) {
+        continue;
+      }
+
+      const Node* producer = graph.GetProducerNode(input->Name());
+      if (producer != nullptr && check_node(*producer)) {
+        add_with_producers(*producer);
+      }
+    }
+  }
+
+  return shape_nodes;
+}
 }  // namespace
 
 std::unordered_set<NodeIndex> GetCpuPreferredNodes(const onnxruntime::GraphViewer& graph,
@@ -96,6 +249,25 @@ std::unordered_set<NodeIndex> GetCpuPreferredNodes(const onnxruntime::GraphViewe
   visited.reserve(candidates.size());
   std::unordered_set<NodeIndex> cpu_nodes;
   cpu_nodes.reserve(candidates.size());
+
+  // Place the shape computations feeding CPU inputs of the target EP on CPU first. The walk below only moves nodes
+  // downstream of CPU tensors, so it misses the nodes which get their values from graph inputs and initializers.
+  for (NodeIndex node_id : GetShapeComputationNodes(graph, provider_nodes, node_to_kernel, cpu_output_args)) {
+    const Node* node = graph.GetNode(node_id);
+    cpu_nodes.insert(node_id);
+    visited.insert(node_id);
+    LOGS(logger, INFO) << "ORT optimization- Force fallback to CPU execution for node: " << node->Name()
+                       << " because it computes shape values consumed on CPU by the target EP";
+    for (auto* output : node->OutputDefs()) {
+      cpu_output_args.insert(output);
+    }
+  }
+  for (NodeIndex node_id : cpu_nodes) {
+    const Node* node = graph.GetNode(node_id);
+    for (auto it = node->OutputNodesBegin(); it != node->OutputNodesEnd(); ++it) {
+      candidates.push((*it).Index());
+    }
+  }
   // The algo below is trying to identity a subgraph that only depends on cpu tensors.
   // Usually it is a subgraph that doing shape calculation based on a GPU tensor, then reshape it back.
   // The detail:
@@ -69,6 +69,17 @@ FeedsFetchesManager::FeedsFetchesManager(FeedsFetchesInfo&& info)
   fetches_device_copy_info_.resize(feeds_fetches_info_.output_names.size());
 }
 
+void FeedsFetchesManager::CopyStaticCopyInfoFrom(const FeedsFetchesManager& other) {
+  ORT_ENFORCE(other.static_copy_info_initialized_, "The static copy info of the source manager is not initialized.");
+  ORT_ENFORCE(feeds_device_copy_info_.size() == other.feeds_device_copy_info_.size() &&
+              fetches_device_copy_info_.size() == other.fetches_device_copy_info_.size());
+
+  device_copy_checks_ = other.device_copy_checks_;
+  feeds_device_copy_info_ = other.feeds_device_copy_info_;
+  fetches_device_copy_info_ = other.fetches_device_copy_info_;
+  static_copy_info_initialized_ = true;
+}
+
 void FeedsFetchesManager::SetDeviceCopyChecks(DeviceCopyCheck input_copy_needed, DeviceCopyCheck output_copy_needed) {
   ORT_ENFORCE(input_copy_needed != DeviceCopyCheck::Unknown &&
               output_copy_needed != DeviceCopyCheck::Unknown);
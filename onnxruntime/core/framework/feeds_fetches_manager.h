@@ -90,6 +90,11 @@ class FeedsFetchesManager {
 
   FeedsFetchesManager(FeedsFetchesInfo&& info);
 
+  // Copies the static device copy info set by utils::InitializeFeedFetchCopyInfo from `other`, which must have the
+  // same feeds and fetches and must not have been finalized with the feeds and fetches of a run.
+  // This lets a manager cached across runs skip the initialization.
+  void CopyStaticCopyInfoFrom(const FeedsFetchesManager& other);
+
   const FeedsFetchesInfo& GetFeedsFetchesInfo() const { return feeds_fetches_info_; }
 
   std::vector<MLValueCopyInfo>& GetMutableFeedsDeviceCopyInfo() { return feeds_device_copy_info_; }
@@ -101,10 +106,14 @@ class FeedsFetchesManager {
   const DeviceCopyChecks& GetDeviceCopyChecks() const { return device_copy_checks_; }
   void SetDeviceCopyChecks(DeviceCopyCheck input_copy_needed, DeviceCopyCheck output_copy_needed);
 
+  bool IsStaticCopyInfoInitialized() const { return static_copy_info_initialized_; }
+  void SetStaticCopyInfoInitialized() { static_copy_info_initialized_ = true; }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FeedsFetchesManager);
 
   DeviceCopyChecks device_copy_checks_ = {};
+  bool static_copy_info_initialized_ = false;
 
   FeedsFetchesInfo feeds_fetches_info_;
 
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/frame_object_arena.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+namespace {
+constexpr size_t kObjectAlignment = alignof(std::max_align_t);
+
+constexpr size_t AlignObjectSize(size_t size) {
+  return (size + kObjectAlignment - 1) / kObjectAlignment * kObjectAlignment;
+}
+}  // namespace
+
+void FrameObjectArena::AllocateBlock(size_t size) {
+  blocks_.push_back(std::make_unique<std::byte[]>(size));
+  current_block_size_ = size;
+  current_block_used_ = 0;
+  ++num_block_allocations_;
+}
+
+void* FrameObjectArena::Allocate(size_t size) {
+  size = AlignObjectSize(size);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (blocks_.empty() || current_block_size_ - current_block_used_ < size) {
+    AllocateBlock(std::max(block_size_, size));
+  }
+
+  void* p = blocks_.back().get() + current_block_used_;
+  current_block_used_ += size;
+  bytes_used_ += size;
+  return p;
+}
+
+void FrameObjectArena::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (blocks_.size() > 1) {
+    // the allocations didn't fit in one block. replace the blocks with one that fits them all.
+    const size_t size = std::max(block_size_, bytes_used_);
+    blocks_.clear();
+    AllocateBlock(size);
+  }
+
+  current_block_used_ = 0;
+  bytes_used_ = 0;
+}
+
+}  // namespace onnxruntime
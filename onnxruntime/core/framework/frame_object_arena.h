@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+
+namespace onnxruntime {
+
+// Bump allocator for the bookkeeping objects of one execution, e.g. the Tensor objects and shared_ptr control blocks
+// of the OrtValues an ExecutionFrame creates for the node outputs. Freeing is a no-op. The memory is reclaimed by
+// Reset() once all the objects are gone, so the session can reuse the arena for its next execution and a model with
+// many small nodes doesn't call the heap allocator for every node output.
+class FrameObjectArena {
+ public:
+  static constexpr size_t kDefaultBlockSize = 16 * 1024;
+
+  explicit FrameObjectArena(size_t block_size = kDefaultBlockSize) : block_size_(block_size) {}
+
+  // Returns memory aligned for any fundamental type.
+  void* Allocate(size_t size);
+
+  // Forgets all the allocations. Must only be called when none of the objects are alive.
+  // The blocks are merged into one that fits all the allocations made since the last reset, so an execution that
+  // allocates the same objects as the previous one doesn't allocate new blocks.
+  void Reset();
+
+  // Number of blocks allocated from the heap since the arena was created.
+  // Doesn't grow across executions in the steady state.
+  size_t NumBlockAllocations() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_block_allocations_;
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FrameObjectArena);
+
+  void AllocateBlock(size_t size);
+
+  mutable std::mutex mutex_;
+  const size_t block_size_;
+  InlinedVector<std::unique_ptr<std::byte[]>, 1> blocks_;  // GUARDED_BY(mutex_)
+  size_t current_block_size_ = 0;                          // GUARDED_BY(mutex_)
+  size_t current_block_used_ = 0;                          // GUARDED_BY(mutex_)
+  size_t bytes_used_ = 0;                                  // GUARDED_BY(mutex_)
+  size_t num_block_allocations_ = 0;                       // GUARDED_BY(mutex_)
+};
+
+// STL allocator allocating from a FrameObjectArena, for std::allocate_shared.
+// Each copy shares the ownership of the arena, so it lives as long as the objects allocated from it.
+template <typename T>
+class FrameObjectArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit FrameObjectArenaAllocator(std::shared_ptr<FrameObjectArena> arena) noexcept : arena_(std::move(arena)) {}
+
+  template <typename U>
+  FrameObjectArenaAllocator(const FrameObjectArenaAllocator<U>& other) noexcept : arena_(other.arena_) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T*, size_t) noexcept {}
+
+  template <typename U>
+  bool operator==(const FrameObjectArenaAllocator<U>& other) const noexcept { return arena_ == other.arena_; }
+
+  template <typename U>
+  bool operator!=(const FrameObjectArenaAllocator<U>& other) const noexcept { return arena_ != other.arena_; }
+
+ private:
+  template <typename U>
+  friend class FrameObjectArenaAllocator;
+
+  std::shared_ptr<FrameObjectArena> arena_;
+};
+
+}  // namespace onnxruntime
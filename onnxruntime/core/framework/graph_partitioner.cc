@@ -3,19 +3,26 @@
 
 #include "core/framework/graph_partitioner.h"
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
+#include <limits>
 
+#include "core/common/inlined_containers.h"
+#include "core/common/parse_string.h"
+#include "core/common/profiler.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/func_kernel.h"
 #include "core/framework/kernel_lookup.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/kernel_registry.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/graph/function.h"
 #include "core/graph/function_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
+#include "core/platform/threadpool.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
 // uncomment this line to count non-CUDA ops in ONNX domain
@@ -58,6 +65,8 @@ struct PartitionParams {
   std::reference_wrapper<int> fused_node_unique_id;
   std::reference_wrapper<const layout_transformation::TransformLayoutFunction> transform_layout_function;
   std::reference_wrapper<const layout_transformation::DebugGraphFn> debug_graph_fn;
+  concurrency::ThreadPool* compile_thread_pool;
+  profiling::Profiler* profiler;
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 };
 }  // namespace
@@ -73,6 +82,66 @@ static void BuildFusedKernelDef(KernelDefBuilder& builder, const IndexedSubGraph
       .Provider(provider_type);
 }
 
+// Compile the fused nodes assigned to an EP. If the EP supports concurrent compilation, each node is compiled by its
+// own call to Compile, in parallel on the thread pool, and is timed separately in the profile.
+static Status CompileFusedNodes(IExecutionProvider& ep,
+                                const std::vector<IExecutionProvider::FusedNodeAndGraph>& nodes_and_viewers,
+                                std::vector<NodeComputeInfo>& node_compute_funcs,
+                                concurrency::ThreadPool* thread_pool,
+                                profiling::Profiler* profiler) {
+  const bool profile = profiler != nullptr && profiler->IsEnabled();
+  const size_t num_nodes = nodes_and_viewers.size();
+
+  if (!ep.ConcurrentCompileSupported() || num_nodes < 2) {
+    TimePoint start;
+    if (profile) {
+      start = profiler->Start();
+    }
+    ORT_RETURN_IF_ERROR(ep.Compile(nodes_and_viewers, node_compute_funcs));
+    if (profile) {
+      profiler->EndTimeAndRecordEvent(profiling::SESSION_EVENT, ep.Type() + "_compile", start,
+                                      {{"num_partitions", std::to_string(num_nodes)}});
+    }
+    return Status::OK();
+  }
+
+  std::vector<std::vector<NodeComputeInfo>> partition_compute_funcs(num_nodes);
+  std::vector<Status> statuses(num_nodes);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(num_nodes), [&](std::ptrdiff_t i) {
+        const auto& node_and_viewer = nodes_and_viewers[i];
+        TimePoint start;
+        if (profile) {
+          start = profiler->Start();
+        }
+        ORT_TRY {
+          statuses[i] = ep.Compile({node_and_viewer}, partition_compute_funcs[i]);
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+          });
+        }
+        if (profile) {
+          profiler->EndTimeAndRecordEvent(profiling::SESSION_EVENT,
+                                          node_and_viewer.fused_node.get().Name() + "_compile", start,
+                                          {{"provider", ep.Type()},
+                                           {"num_nodes", std::to_string(node_and_viewer.filtered_graph.get().NumberOfNodes())}});
+        }
+      });
+
+  node_compute_funcs.reserve(node_compute_funcs.size() + num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    ORT_RETURN_IF_ERROR(statuses[i]);
+    if (partition_compute_funcs[i].size() != 1) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ep.Type(), " did not return correct number of compiled functions");
+    }
+    node_compute_funcs.push_back(std::move(partition_compute_funcs[i][0]));
+  }
+
+  return Status::OK();
+}
+
 /// <summary>
 /// Check if a node can be placed on a specific provider. If yes, then set the nodes execution provider.
 /// Do nothing if the node is already assigned.
@@ -353,6 +422,269 @@ static Node* PlaceNode(Graph& graph, const IndexedSubGraph& capability,
   return result;
 }
 
+namespace {
+// Whether the elements of a tensor of the type have a fixed size that DataTypeImpl knows in this build. Strings,
+// packed 4 bit and complex elements are not estimated.
+bool IsFixedSizeElementType(int32_t elem_type) {
+  switch (elem_type) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT64:
+#if !defined(DISABLE_FLOAT8_TYPES)
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E4M3FN:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E4M3FNUZ:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E5M2:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E5M2FNUZ:
+#endif
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Number of bytes of a tensor NodeArg. Returns false if its type or shape is not known statically, or if its
+// element type has no fixed size.
+bool TryGetTensorSizeInBytes(const NodeArg& node_arg, int64_t& num_elements, int64_t& num_bytes) {
+  const auto* type = node_arg.TypeAsProto();
+  const auto* shape = node_arg.Shape();
+  if (type == nullptr || shape == nullptr || !type->has_tensor_type() ||
+      !IsFixedSizeElementType(type->tensor_type().elem_type())) {
+    return false;
+  }
+
+  num_elements = utils::GetTensorShapeFromTensorShapeProto(*shape).Size();
+  if (num_elements < 0) {
+    return false;
+  }
+
+  const auto* element_type = DataTypeImpl::TensorTypeFromONNXEnum(type->tensor_type().elem_type())->GetElementType();
+  num_bytes = num_elements * static_cast<int64_t>(element_type->Size());
+  return true;
+}
+
+// Rough number of operations of a node: the number of output elements, times the length of the reduction for the
+// matrix multiplication and convolution ops. Returns false if a size is not known statically.
+bool TryEstimateNodeOps(const Node& node, double& ops) {
+  int64_t output_elements = 0;
+  for (const auto* output_def : node.OutputDefs()) {
+    int64_t num_elements = 0, num_bytes = 0;
+    if (!output_def->Exists()) {
+      continue;
+    }
+    if (!TryGetTensorSizeInBytes(*output_def, num_elements, num_bytes)) {
+      return false;
+    }
+    output_elements += num_elements;
+  }
+
+  // length of the reduction per output element, taken from the shape of the second input (B or W)
+  int64_t reduction = 1;
+  const auto& op_type = node.OpType();
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() > 1 && input_defs[1]->Shape() != nullptr) {
+    const auto b_shape = utils::GetTensorShapeFromTensorShapeProto(*input_defs[1]->Shape());
+    const auto b_rank = b_shape.NumDimensions();
+    if (op_type == "MatMul" || op_type == "MatMulInteger" || op_type == "FusedMatMul" || op_type == "Gemm") {
+      // B is [..., K, N] or [K] for MatMul, and [K, N] (or [N, K] if transposed) for Gemm
+      bool trans_b = false;
+      if (op_type == "Gemm") {
+        const auto& attrs = node.GetAttributes();
+        const auto attr = attrs.find("transB");
+        trans_b = attr != attrs.end() && attr->second.i() != 0;
+      }
+      if (b_rank == 1) {
+        reduction = b_shape[0];
+      } else if (b_rank >= 2) {
+        reduction = trans_b ? b_shape[b_rank - 1] : b_shape[b_rank - 2];
+      }
+    } else if (op_type == "Conv" || op_type == "ConvInteger" || op_type == "FusedConv") {
+      // W is [M, C/group, k1, ..., kn]
+      reduction = b_rank > 1 ? b_shape.SizeFromDimension(1) : 1;
+    } else if (op_type == "ConvTranspose") {
+      // W is [C, M/group, k1, ..., kn]. Each input element is scattered over M/group * k1 * ... * kn outputs.
+      if (b_rank > 1) {
+        const int64_t out_channels = b_shape[1];
+        const int64_t kernel_size = b_shape.SizeFromDimension(2);
+        reduction = out_channels < 0 || kernel_size < 0 ? -1 : out_channels * kernel_size;
+      }
+    }
+  }
+
+  if (reduction < 0) {
+    return false;
+  }
+
+  ops = static_cast<double>(output_elements) * static_cast<double>(std::max<int64_t>(reduction, 1));
+  return true;
+}
+
+// Estimates the operations of the nodes of a subgraph proposed by an EP, and the bytes copied between the host and
+// the EP device at its boundary: the inputs produced outside the nodes of the EP (or fed by the graph inputs) and
+// the outputs used outside of them (or by the graph outputs). Initializers are copied once when the session is
+// created, so they are not counted. Returns false if a size is not known statically.
+bool TryEstimateSubGraphCost(const Graph& graph, const IndexedSubGraph& sub_graph,
+                             const InlinedHashSet<NodeIndex>& ep_nodes, double& ops, int64_t& copied_bytes) {
+  InlinedHashSet<const NodeArg*> copied_node_args;
+  ops = 0;
+  copied_bytes = 0;
+
+  auto add_copy = [&copied_node_args, &copied_bytes](const NodeArg& node_arg) {
+    if (copied_node_args.insert(&node_arg).second) {
+      int64_t num_elements = 0, num_bytes = 0;
+      if (!TryGetTensorSizeInBytes(node_arg, num_elements, num_bytes)) {
+        return false;
+      }
+      copied_bytes += num_bytes;
+    }
+    return true;
+  };
+
+  for (auto node_index : sub_graph.nodes) {
+    const Node* node = graph.GetNode(node_index);
+    if (node == nullptr) {
+      return false;
+    }
+
+    double node_ops = 0;
+    if (!TryEstimateNodeOps(*node, node_ops)) {
+      return false;
+    }
+    ops += node_ops;
+
+    auto add_input_copy = [&](const NodeArg& input_def) {
+      if (!input_def.Exists() || graph.IsInitializedTensor(input_def.Name())) {
+        return true;
+      }
+      const Node* producer = graph.GetProducerNode(input_def.Name());
+      return (producer != nullptr && ep_nodes.count(producer->Index()) != 0) || add_copy(input_def);
+    };
+    for (const auto* input_def : node->InputDefs()) {
+      if (!add_input_copy(*input_def)) {
+        return false;
+      }
+    }
+    for (const auto* input_def : node->ImplicitInputDefs()) {
+      if (!add_input_copy(*input_def)) {
+        return false;
+      }
+    }
+
+    for (const auto* output_def : node->OutputDefs()) {
+      if (!output_def->Exists()) {
+        continue;
+      }
+      bool used_outside = graph.IsOutput(output_def);
+      for (const Node* consumer : graph.GetConsumerNodes(output_def->Name())) {
+        used_outside = used_outside || consumer == nullptr || ep_nodes.count(consumer->Index()) == 0;
+      }
+      if (used_outside && !add_copy(*output_def)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+}  // namespace
+
+// Removes the subgraphs proposed by an EP on a non-CPU device that are not worth offloading: those whose estimated
+// operations per byte copied between the host and the device is below min_ops_per_byte. Their nodes are left to the
+// next EPs, which are usually the CPU EP, so a subgraph is only removed if the CPU EP has kernels for all its nodes.
+// Removing a subgraph can add copies at the boundary of its neighbors, so this repeats until no subgraph is removed.
+static void ApplyPartitioningCostModel(const Graph& graph,
+                                       const KernelRegistryManager& kernel_registry_mgr,
+                                       const IExecutionProvider& current_ep,
+                                       float min_ops_per_byte,
+                                       std::vector<std::unique_ptr<ComputeCapability>>& capabilities,
+                                       const logging::Logger& logger) {
+  const auto& ep_type = current_ep.Type();
+  if (min_ops_per_byte <= 0.0f || current_ep.GetOrtDeviceByMemType(OrtMemTypeDefault).Type() == OrtDevice::CPU ||
+      current_ep.GetPreferredLayout() == DataLayout::NHWC) {
+    // NHWC EPs have their nodes assigned and converted by the layout transformer before this point.
+    return;
+  }
+
+  const size_t num_proposed = capabilities.size();
+  bool removed = true;
+  while (removed && !capabilities.empty()) {
+    removed = false;
+
+    // the nodes that will run on the device of this EP: the ones already assigned to it and the proposed ones
+    InlinedHashSet<NodeIndex> ep_nodes;
+    for (const auto& node : graph.Nodes()) {
+      if (node.GetExecutionProviderType() == ep_type) {
+        ep_nodes.insert(node.Index());
+      }
+    }
+    for (const auto& capability : capabilities) {
+      ep_nodes.insert(capability->sub_graph->nodes.cbegin(), capability->sub_graph->nodes.cend());
+    }
+
+    // the decisions to offload are logged once no more subgraphs are removed
+    std::vector<std::string> offload_decisions;
+    for (auto it = capabilities.begin(); it != capabilities.end();) {
+      const IndexedSubGraph& sub_graph = *(*it)->sub_graph;
+      const Node* first_node = sub_graph.nodes.empty() ? nullptr : graph.GetNode(sub_graph.nodes[0]);
+      std::ostringstream decision;
+      decision << ep_type << ": subgraph of " << sub_graph.nodes.size() << " nodes starting at '"
+               << (first_node != nullptr ? first_node->Name() : std::string{}) << "' ";
+
+      double ops = 0;
+      int64_t copied_bytes = 0;
+      if (!TryEstimateSubGraphCost(graph, sub_graph, ep_nodes, ops, copied_bytes)) {
+        decision << "has dynamic shapes or sizes so its cost cannot be estimated. Offloading it.";
+        offload_decisions.push_back(decision.str());
+        ++it;
+        continue;
+      }
+
+      const double ops_per_byte = copied_bytes > 0 ? ops / static_cast<double>(copied_bytes)
+                                                   : std::numeric_limits<double>::infinity();
+      decision << "has an estimated " << ops << " operations and copies " << copied_bytes
+               << " bytes to or from the host (" << ops_per_byte << " operations per byte, minimum "
+               << min_ops_per_byte << "). ";
+
+      if (ops_per_byte >= min_ops_per_byte) {
+        decision << "Offloading it.";
+      } else if (!std::all_of(sub_graph.nodes.cbegin(), sub_graph.nodes.cend(), [&](NodeIndex index) {
+                   const Node* node = graph.GetNode(index);
+                   return node != nullptr && KernelRegistryManager::HasImplementationOf(
+                                                 kernel_registry_mgr, *node, kCpuExecutionProvider, logger);
+                 })) {
+        decision << "Offloading it as the CPU EP cannot run all its nodes.";
+      } else {
+        decision << "Leaving it to the next execution providers.";
+        LOGS(logger, INFO) << decision.str();
+        it = capabilities.erase(it);
+        removed = true;
+        continue;
+      }
+
+      offload_decisions.push_back(decision.str());
+      ++it;
+    }
+
+    if (!removed) {
+      for (const auto& offload_decision : offload_decisions) {
+        LOGS(logger, INFO) << offload_decision;
+      }
+    }
+  }
+
+  LOGS(logger, INFO) << ep_type << ": partitioning cost model kept " << capabilities.size() << " of "
+                     << num_proposed << " proposed subgraphs.";
+}
+
 // for the current EP, recursively iterate through the Graph and any nested subgraphs (recursion is bottom-up).
 // assign any nodes to the EP that are currently unassigned, and that the EP can handle.
 static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
@@ -363,6 +695,9 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
                                            int& fused_node_unique_id,
                                            const layout_transformation::TransformLayoutFunction& transform_layout_fn,
                                            const layout_transformation::DebugGraphFn& debug_graph_fn,
+                                           float min_ops_per_byte,
+                                           concurrency::ThreadPool* compile_thread_pool,
+                                           profiling::Profiler* profiler,
                                            const logging::Logger& logger) {
   // handle testing edge case where optimizers or constant lifting results in graph with no nodes.
   // doing it here saves all providers checking for this in GetCapability
@@ -377,7 +712,8 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
       // we pass through the FuncManager from the top level graph
       ORT_RETURN_IF_ERROR(PartitionOnnxFormatModelImpl(*subgraph, func_mgr, kernel_registry_mgr,
                                                        fused_kernel_registry, current_ep, mode, fused_node_unique_id,
-                                                       transform_layout_fn, debug_graph_fn, logger));
+                                                       transform_layout_fn, debug_graph_fn, min_ops_per_byte,
+                                                       compile_thread_pool, profiler, logger));
     }
   }
 
@@ -403,6 +739,9 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
       std::cref(debug_graph_fn)};
 
   ORT_RETURN_IF_ERROR(GetCapabilityForEP(get_capability_params, logger));
+  if (mode == GraphPartitioner::Mode::kNormal) {
+    ApplyPartitioningCostModel(graph, kernel_registry_mgr, current_ep, min_ops_per_byte, capabilities, logger);
+  }
   if (capabilities.empty()) {
     return Status::OK();
   }
@@ -463,7 +802,8 @@ static Status PartitionOnnxFormatModelImpl(Graph& graph, FuncManager& func_mgr,
         nodes_and_viewers.push_back(IExecutionProvider::FusedNodeAndGraph{*node, *viewers.back()});
       }
 
-      ORT_RETURN_IF_ERROR(current_ep.Compile(nodes_and_viewers, node_compute_funcs));
+      ORT_RETURN_IF_ERROR(CompileFusedNodes(current_ep, nodes_and_viewers, node_compute_funcs, compile_thread_pool,
+                                            profiler));
 
       if (node_compute_funcs.size() != nodes_to_compile.size()) {
         return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, type, " did not return correct number of compiled functions");
@@ -735,6 +1075,7 @@ static Status CreateEpContextModel(const ExecutionProviders& execution_providers
 static Status PartitionOnnxFormatModel(const PartitionParams& partition_params, GraphPartitioner::Mode mode,
                                        const ExecutionProviders& execution_providers,
                                        KernelRegistryManager& kernel_registry_manager,
+                                       float min_ops_per_byte,
                                        const logging::Logger& logger) {
   bool modified_graph = false;
 
@@ -751,6 +1092,9 @@ static Status PartitionOnnxFormatModel(const PartitionParams& partition_params,
                                                        fused_kernel_registry, *ep, mode, fused_node_unique_id,
                                                        transform_layout_function,
                                                        partition_params.debug_graph_fn,
+                                                       min_ops_per_byte,
+                                                       partition_params.compile_thread_pool,
+                                                       partition_params.profiler,
                                                        logger));
     }
 
@@ -849,16 +1193,38 @@ static Status PartitionOrtFormatModelImpl(const PartitionParams& partition_param
   }
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
-  // We will compile the fused nodes one by one, and fuse the subgraph if successful.
-  for (const auto& compilation_entry : compilation_entries) {
+  // We will compile the fused nodes one by one, unless the EP compiles them concurrently, and fuse the subgraphs if
+  // successful.
+  std::vector<NodeComputeInfo> node_compute_funcs;
+  if (current_ep.ConcurrentCompileSupported()) {
+    std::vector<IExecutionProvider::FusedNodeAndGraph> nodes_and_viewers;
+    nodes_and_viewers.reserve(compilation_entries.size());
+    for (const auto& compilation_entry : compilation_entries) {
+      nodes_and_viewers.push_back(
+          IExecutionProvider::FusedNodeAndGraph{compilation_entry.fused_node, *compilation_entry.viewer});
+    }
+    ORT_RETURN_IF_ERROR(CompileFusedNodes(current_ep, nodes_and_viewers, node_compute_funcs,
+                                          partition_params.compile_thread_pool, partition_params.profiler));
+    ORT_RETURN_IF(node_compute_funcs.size() != compilation_entries.size(),
+                  current_ep.Type(), " did not return correct number of compiled functions");
+  } else {
+    node_compute_funcs.reserve(compilation_entries.size());
+    for (const auto& compilation_entry : compilation_entries) {
+      std::vector<NodeComputeInfo> single_node_compute_func;
+      ORT_RETURN_IF_ERROR(CompileFusedNodes(
+          current_ep, {IExecutionProvider::FusedNodeAndGraph{compilation_entry.fused_node, *compilation_entry.viewer}},
+          single_node_compute_func, partition_params.compile_thread_pool, partition_params.profiler));
+      ORT_RETURN_IF(single_node_compute_func.empty(), "single_node_compute_func should have 1 element.");
+      node_compute_funcs.push_back(std::move(single_node_compute_func[0]));
+    }
+  }
+
+  for (size_t j = 0, end = compilation_entries.size(); j < end; j++) {
+    const auto& compilation_entry = compilation_entries[j];
     Node& node = compilation_entry.fused_node;
-    std::vector<NodeComputeInfo> single_node_compute_func;
-    ORT_RETURN_IF_ERROR(current_ep.Compile({IExecutionProvider::FusedNodeAndGraph{node, *compilation_entry.viewer}},
-                                           single_node_compute_func));
 
-    ORT_RETURN_IF(single_node_compute_func.empty(), "single_node_compute_func should have 1 element.");
     auto& func_mgr = partition_params.func_mgr.get();
-    ORT_RETURN_IF_ERROR(func_mgr.AddFuncInfo(node.Name(), std::move(single_node_compute_func[0])));
+    ORT_RETURN_IF_ERROR(func_mgr.AddFuncInfo(node.Name(), std::move(node_compute_funcs[j])));
 
     const ComputeCapability& cur_capability = compilation_entry.capability;
     const IndexedSubGraph& indexed_sub_graph = *cur_capability.sub_graph;
@@ -975,6 +1341,8 @@ Status GraphPartitioner::Partition(Graph& graph, FuncManager& func_mgr,
       std::ref(fused_node_unique_id),
       std::cref(transform_layout_function),
       std::cref(debug_graph_fn),
+      compile_thread_pool_,
+      profiler_,
   };
 
 #else  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -990,7 +1358,17 @@ Status GraphPartitioner::Partition(Graph& graph, FuncManager& func_mgr,
 
   if (mode == Mode::kNormal || mode == Mode::kAssignOnly) {
 #if !defined(ORT_MINIMAL_BUILD)
-    ORT_RETURN_IF_ERROR(PartitionOnnxFormatModel(partition_params, mode, providers_, kernel_registry_mgr_, logger));
+    const std::string min_ops_per_byte_str =
+        config_options.GetConfigOrDefault(kOrtSessionOptionsPartitioningCostModelMinOpsPerByte, "0");
+    float min_ops_per_byte = 0.0f;
+    if (!TryParseStringWithClassicLocale<float>(min_ops_per_byte_str, min_ops_per_byte) || min_ops_per_byte < 0.0f) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                             kOrtSessionOptionsPartitioningCostModelMinOpsPerByte, ": ", min_ops_per_byte_str,
+                             ". Expected a non-negative number.");
+    }
+
+    ORT_RETURN_IF_ERROR(PartitionOnnxFormatModel(partition_params, mode, providers_, kernel_registry_mgr_,
+                                                 min_ops_per_byte, logger));
 
     bool ep_context_enabled = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextEnable, "0") == "1";
     std::string ep_context_path = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextFilePath, "");
@@ -14,6 +14,12 @@ class ExecutionProviders;
 class KernelRegistryManager;
 class Model;
 struct ConfigOptions;
+namespace concurrency {
+class ThreadPool;
+}
+namespace profiling {
+class Profiler;
+}
 
 class GraphPartitioner {
  public:
@@ -24,9 +30,15 @@ class GraphPartitioner {
   };
 
   // The order of providers represents the user preference.
-  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers)
+  // Partitions of EPs that support concurrent compilation are compiled in parallel on compile_thread_pool, if given,
+  // and the compilations are recorded by profiler when it is enabled.
+  GraphPartitioner(KernelRegistryManager& kernel_registry_mgr, const ExecutionProviders& providers,
+                   concurrency::ThreadPool* compile_thread_pool = nullptr,
+                   profiling::Profiler* profiler = nullptr)
       : kernel_registry_mgr_(kernel_registry_mgr),
-        providers_(providers) {
+        providers_(providers),
+        compile_thread_pool_(compile_thread_pool),
+        profiler_(profiler) {
   }
 
   // Run partitioning.
@@ -64,6 +76,8 @@ class GraphPartitioner {
 
   KernelRegistryManager& kernel_registry_mgr_;
   const ExecutionProviders& providers_;
+  concurrency::ThreadPool* compile_thread_pool_;
+  profiling::Profiler* profiler_;
 };
 
 }  // namespace onnxruntime
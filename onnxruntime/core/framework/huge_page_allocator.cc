@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/huge_page_allocator.h"
+
+#include <cstdint>
+
+#include "core/mlas/inc/mlas.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace onnxruntime {
+
+namespace {
+
+// Returns the address of a mapping of `mapped_size` bytes backed by huge pages, or nullptr.
+void* MapHugePages(size_t size, size_t& mapped_size) {
+#if defined(_WIN32)
+  const size_t large_page_size = GetLargePageMinimum();
+  if (large_page_size == 0) {
+    return nullptr;
+  }
+
+  // fails unless the process has the SeLockMemoryPrivilege
+  mapped_size = (size + large_page_size - 1) / large_page_size * large_page_size;
+  return VirtualAlloc(nullptr, mapped_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+#elif defined(__linux__)
+  constexpr size_t kHugePageSize = HugePageCPUAllocator::kMinHugePageAllocationSize;
+  mapped_size = (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  // pages reserved in /sys/kernel/mm/hugepages/hugepages-2048kB
+  void* p = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0);
+  if (p != MAP_FAILED) {
+    return p;
+  }
+#endif
+
+#if defined(MADV_HUGEPAGE)
+  // transparent huge pages only back the 2MB aligned parts of a mapping, so map one more page and trim it
+  char* base = static_cast<char*>(mmap(nullptr, mapped_size + kHugePageSize, PROT_READ | PROT_WRITE,
+                                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  if (base == MAP_FAILED) {
+    return nullptr;
+  }
+
+  const size_t head = (kHugePageSize - reinterpret_cast<std::uintptr_t>(base) % kHugePageSize) % kHugePageSize;
+  if (head > 0) {
+    munmap(base, head);
+  }
+  munmap(base + head + mapped_size, kHugePageSize - head);
+
+  // a hint; the memory is still usable if the kernel doesn't back it with huge pages
+  madvise(base + head, mapped_size, MADV_HUGEPAGE);
+  return base + head;
+#else
+  return nullptr;
+#endif
+#else
+  ORT_UNUSED_PARAMETER(size);
+  ORT_UNUSED_PARAMETER(mapped_size);
+  return nullptr;
+#endif
+}
+
+void UnmapHugePages(void* p, size_t mapped_size) {
+#if defined(_WIN32)
+  ORT_UNUSED_PARAMETER(mapped_size);
+  VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(__linux__)
+  munmap(p, mapped_size);
+#else
+  ORT_UNUSED_PARAMETER(p);
+  ORT_UNUSED_PARAMETER(mapped_size);
+#endif
+}
+
+}  // namespace
+
+void* HugePageCPUAllocator::Alloc(size_t size) {
+  if (size < kMinHugePageAllocationSize) {
+    return AllocatorDefaultAlloc(size);
+  }
+
+  size_t mapped_size = 0;
+  void* p = MapHugePages(size + MLAS_SYMM_QGEMM_BUF_OVERRUN, mapped_size);
+  if (p == nullptr) {
+    return AllocatorDefaultAlloc(size);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  huge_page_allocations_.emplace(p, mapped_size);
+  return p;
+}
+
+void HugePageCPUAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = huge_page_allocations_.find(p);
+    if (it != huge_page_allocations_.end()) {
+      const size_t mapped_size = it->second;
+      huge_page_allocations_.erase(it);
+      UnmapHugePages(p, mapped_size);
+      return;
+    }
+  }
+
+  AllocatorDefaultFree(p);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include "core/framework/allocator.h"
+
+namespace onnxruntime {
+
+// CPU allocator that backs large allocations, e.g. the regions of the CPU arena and prepacked weights, with 2MB pages
+// to reduce the TLB misses of the kernels reading them.
+// On Linux, pages reserved for MAP_HUGETLB are used if available, otherwise the memory is marked for transparent huge
+// pages. On Windows, large pages are used if the process has the SeLockMemoryPrivilege.
+// Smaller allocations, and large ones that huge pages cannot back, use AllocatorDefaultAlloc.
+class HugePageCPUAllocator : public IAllocator {
+ public:
+  // Minimum size of the allocations backed by huge pages.
+  static constexpr size_t kMinHugePageAllocationSize = 2 * 1024 * 1024;
+
+  explicit HugePageCPUAllocator(const OrtMemoryInfo& memory_info) : IAllocator(memory_info) {}
+
+  HugePageCPUAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+ private:
+  std::mutex mutex_;
+  // Size of the mapping of each allocation backed by huge pages.
+  std::unordered_map<void*, size_t> huge_page_allocations_;  // GUARDED_BY(mutex_)
+};
+
+}  // namespace onnxruntime
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
+
 #include "core/common/common.h"
 #include "core/common/inlined_containers.h"
 #include "core/framework/allocation_planner.h"
@@ -20,6 +22,7 @@ struct MemoryBlock {
 
 class MemoryPattern {
   friend class MemPatternPlanner;
+  friend class MemoryPatternCache;
 
  public:
   MemoryPattern() = default;
@@ -62,6 +65,14 @@ struct MemoryPatternGroup {
   std::vector<OrtDevice> locations;
   std::vector<MemoryPattern> patterns;
 
+  // The block of each value in patterns, indexed by OrtValue index, so that finding the block of a node output
+  // doesn't search the locations and hash. Built by IndexBlocks() once the patterns are complete.
+  struct ValueBlock {
+    int location_index{-1};  // -1 if the value has no block
+    MemoryBlock block;
+  };
+  std::vector<ValueBlock> value_blocks;
+
   const MemoryPattern* GetPatterns(const OrtDevice& location) const {
     for (size_t i = 0; i < locations.size(); i++)
       if (locations[i] == location) {
@@ -69,5 +80,40 @@ struct MemoryPatternGroup {
       }
     return nullptr;
   }
+
+  void IndexBlocks() {
+    int max_ml_value_idx = -1;
+    for (const auto& pattern : patterns) {
+      for (const auto& entry : pattern.GetPatternsMap()) {
+        max_ml_value_idx = std::max(max_ml_value_idx, entry.first);
+      }
+    }
+
+    value_blocks.assign(static_cast<size_t>(max_ml_value_idx + 1), ValueBlock{});
+    for (size_t i = 0; i < patterns.size(); i++) {
+      for (const auto& entry : patterns[i].GetPatternsMap()) {
+        value_blocks[entry.first] = ValueBlock{static_cast<int>(i), entry.second};
+      }
+    }
+  }
+
+  // Returns the block of the value at the location, or nullptr if it has none.
+  const MemoryBlock* GetBlock(const OrtDevice& location, int ml_value_idx) const {
+    if (value_blocks.empty()) {
+      const auto* pattern = GetPatterns(location);
+      return pattern ? pattern->GetBlock(ml_value_idx) : nullptr;
+    }
+
+    if (ml_value_idx < 0 || static_cast<size_t>(ml_value_idx) >= value_blocks.size()) {
+      return nullptr;
+    }
+
+    const auto& value_block = value_blocks[ml_value_idx];
+    if (value_block.location_index < 0 || !(locations[value_block.location_index] == location)) {
+      return nullptr;
+    }
+
+    return &value_block.block;
+  }
 };
 }  // namespace onnxruntime
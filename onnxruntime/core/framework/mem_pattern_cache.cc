@@ -0,0 +1,263 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <fstream>
+
+#include "core/common/binary_io.h"
+#include "core/common/narrow.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// File layout, after the header of core/common/binary_io.h with an empty identity:
+//   int64 shape bucket size, uint64 number of entries
+//   per entry: int64 key, int64 feeds size, uint64 number of locations
+//     per location: int8 device type, int8 memory type, int16 device id, uint64 peak size, uint64 number of blocks
+//       per block: string name, uint64 offset, uint64 size
+constexpr uint32_t kMemoryPatternCacheFileMagic = 0x4D50434F;  // "OCPM"
+constexpr uint32_t kMemoryPatternCacheFileVersion = 2;
+
+// Keys are persisted so they must not depend on std::hash, which is implementation defined.
+inline void MixKey(uint64_t value, uint64_t& key) {
+  key ^= value + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+}
+
+}  // namespace
+
+void MemoryPatternCache::SetOptions(const Options& options) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ORT_ENFORCE(entries_.empty(), "Memory pattern cache options must be set before any pattern is cached.");
+  options_ = options;
+}
+
+int64_t MemoryPatternCache::ComputeKey(gsl::span<const OrtValue> tensor_inputs) const {
+  const int64_t bucket = options_.shape_bucket_size;
+  uint64_t key = 0;
+  for (const auto& input : tensor_inputs) {
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    MixKey(dims.size(), key);
+    for (int64_t dim : dims) {
+      if (bucket > 1 && dim > 0) {
+        dim = ((dim + bucket - 1) / bucket) * bucket;
+      }
+      MixKey(static_cast<uint64_t>(dim), key);
+    }
+  }
+  return static_cast<int64_t>(key);
+}
+
+// static
+int64_t MemoryPatternCache::TotalFeedsSize(gsl::span<const OrtValue> tensor_inputs) {
+  int64_t total = 0;
+  for (const auto& input : tensor_inputs) {
+    total += input.Get<Tensor>().Shape().Size();
+  }
+  return total;
+}
+
+void MemoryPatternCache::TouchLocked(CacheEntry& cache_entry) {
+  if (cache_entry.lru_it != lru_.begin()) {
+    lru_.splice(lru_.begin(), lru_, cache_entry.lru_it);
+  }
+}
+
+bool MemoryPatternCache::Find(gsl::span<const OrtValue> tensor_inputs, Entry& entry) {
+  const int64_t key = ComputeKey(tensor_inputs);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+
+  // a pattern learned from smaller feeds has blocks that are too small for (some of) the tensors in this run.
+  // report a miss so the memory pattern planner traces this run and the result replaces the entry.
+  if (IsShapeBucketingEnabled() && TotalFeedsSize(tensor_inputs) > it->second.feeds_size) {
+    return false;
+  }
+
+  TouchLocked(it->second);
+  entry = it->second.entry;
+  return true;
+}
+
+MemoryPatternCache::Entry MemoryPatternCache::InsertLocked(int64_t key, int64_t feeds_size, Entry entry) {
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    TouchLocked(it->second);
+    if (it->second.feeds_size >= feeds_size) {
+      // keep the existing pattern as it covers at least the same feeds
+      return it->second.entry;
+    }
+
+    it->second.entry = std::move(entry);
+    it->second.feeds_size = feeds_size;
+    dirty_ = true;
+    return it->second.entry;
+  }
+
+  lru_.push_front(key);
+  auto& cache_entry = entries_[key];
+  cache_entry.entry = std::move(entry);
+  cache_entry.feeds_size = feeds_size;
+  cache_entry.lru_it = lru_.begin();
+  dirty_ = true;
+
+  if (options_.max_entries > 0) {
+    while (entries_.size() > options_.max_entries) {
+      // the shared pointers keep the evicted entry alive for any ExecutionFrame still using it
+      entries_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+
+  return cache_entry.entry;
+}
+
+MemoryPatternCache::Entry MemoryPatternCache::Insert(gsl::span<const OrtValue> tensor_inputs,
+                                                     MemoryPatternGroup patterns,
+                                                     std::unique_ptr<InferredShapes> inferred_shapes) {
+  const int64_t key = ComputeKey(tensor_inputs);
+  const int64_t feeds_size = TotalFeedsSize(tensor_inputs);
+
+  patterns.IndexBlocks();
+
+  Entry entry;
+  entry.patterns = std::make_shared<const MemoryPatternGroup>(std::move(patterns));
+  entry.inferred_shapes = std::move(inferred_shapes);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  return InsertLocked(key, feeds_size, std::move(entry));
+}
+
+size_t MemoryPatternCache::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+bool MemoryPatternCache::IsDirty() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dirty_;
+}
+
+Status MemoryPatternCache::Save(const PathString& file_path, const OrtValueNameIdxMap& ort_value_name_idx_map) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+  ORT_RETURN_IF_NOT(out, "Failed to open memory pattern cache file for writing: ", PathToUTF8String(file_path));
+
+  using namespace binary_io;
+  WriteHeader(out, kMemoryPatternCacheFileMagic, kMemoryPatternCacheFileVersion, {});
+  WritePod(out, options_.shape_bucket_size);
+  WritePod(out, static_cast<uint64_t>(entries_.size()));
+
+  // write the least recently used entry first so the LRU order is restored on load
+  std::string name;
+  for (auto key_it = lru_.rbegin(); key_it != lru_.rend(); ++key_it) {
+    const CacheEntry& cache_entry = entries_.at(*key_it);
+    const MemoryPatternGroup& group = *cache_entry.entry.patterns;
+
+    WritePod(out, *key_it);
+    WritePod(out, cache_entry.feeds_size);
+    WritePod(out, static_cast<uint64_t>(group.locations.size()));
+    for (size_t i = 0; i < group.locations.size(); ++i) {
+      const OrtDevice& device = group.locations[i];
+      const MemoryPattern& pattern = group.patterns[i];
+      WritePod(out, static_cast<int8_t>(device.Type()));
+      WritePod(out, static_cast<int8_t>(device.MemType()));
+      WritePod(out, static_cast<int16_t>(device.Id()));
+      WritePod(out, static_cast<uint64_t>(pattern.peak_size_));
+      WritePod(out, static_cast<uint64_t>(pattern.patterns_.size()));
+      for (const auto& [ort_value_idx, block] : pattern.patterns_) {
+        ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetName(ort_value_idx, name));
+        WriteString(out, name);
+        WritePod(out, static_cast<uint64_t>(block.offset_));
+        WritePod(out, static_cast<uint64_t>(block.size_));
+      }
+    }
+  }
+
+  ORT_RETURN_IF_NOT(out.good(), "Failed to write memory pattern cache file: ", PathToUTF8String(file_path));
+  dirty_ = false;
+  return Status::OK();
+}
+
+Status MemoryPatternCache::Load(const PathString& file_path, const OrtValueNameIdxMap& ort_value_name_idx_map) {
+  std::ifstream in(file_path, std::ios::binary);
+  ORT_RETURN_IF_NOT(in, "Failed to open memory pattern cache file: ", PathToUTF8String(file_path));
+
+  binary_io::StreamReader reader(in);
+  ORT_RETURN_IF_NOT(binary_io::ReadHeader(reader, kMemoryPatternCacheFileMagic, kMemoryPatternCacheFileVersion, {}) ==
+                        binary_io::HeaderStatus::kOk,
+                    "Invalid memory pattern cache file: ", PathToUTF8String(file_path));
+
+  int64_t shape_bucket_size = 0;
+  uint64_t num_entries = 0;
+  ORT_RETURN_IF_NOT(reader.ReadPod(shape_bucket_size) && reader.ReadPod(num_entries),
+                    "Truncated memory pattern cache file.");
+  ORT_RETURN_IF_NOT(shape_bucket_size == options_.shape_bucket_size,
+                    "Memory pattern cache file was written with shape bucket size ", shape_bucket_size,
+                    " but the session uses ", options_.shape_bucket_size);
+
+  // parse everything before touching the cache so a bad file doesn't leave it partially populated
+  struct LoadedEntry {
+    int64_t key;
+    int64_t feeds_size;
+    MemoryPatternGroup group;
+  };
+  std::vector<LoadedEntry> loaded;
+  loaded.reserve(narrow<size_t>(num_entries));
+
+  std::string name;
+  for (uint64_t e = 0; e < num_entries; ++e) {
+    LoadedEntry& loaded_entry = loaded.emplace_back();
+    uint64_t num_locations = 0;
+    ORT_RETURN_IF_NOT(reader.ReadPod(loaded_entry.key) && reader.ReadPod(loaded_entry.feeds_size) &&
+                          reader.ReadPod(num_locations),
+                      "Truncated memory pattern cache file.");
+
+    for (uint64_t l = 0; l < num_locations; ++l) {
+      int8_t device_type = 0, mem_type = 0;
+      int16_t device_id = 0;
+      uint64_t peak_size = 0, num_blocks = 0;
+      ORT_RETURN_IF_NOT(reader.ReadPod(device_type) && reader.ReadPod(mem_type) && reader.ReadPod(device_id) &&
+                            reader.ReadPod(peak_size) && reader.ReadPod(num_blocks),
+                        "Truncated memory pattern cache file.");
+
+      MemoryPattern pattern;
+      pattern.peak_size_ = narrow<size_t>(peak_size);
+      pattern.patterns_.reserve(narrow<size_t>(num_blocks));
+      for (uint64_t b = 0; b < num_blocks; ++b) {
+        uint64_t offset = 0, size = 0;
+        ORT_RETURN_IF_NOT(reader.ReadString(name) && reader.ReadPod(offset) && reader.ReadPod(size),
+                          "Truncated memory pattern cache file.");
+        ORT_RETURN_IF_NOT(offset + size <= peak_size, "Invalid block in memory pattern cache file.");
+
+        int ort_value_idx = -1;
+        ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetIdx(name, ort_value_idx));
+        pattern.patterns_[ort_value_idx] = MemoryBlock(narrow<size_t>(offset), narrow<size_t>(size));
+      }
+
+      loaded_entry.group.locations.push_back(OrtDevice(device_type, mem_type, device_id));
+      loaded_entry.group.patterns.push_back(std::move(pattern));
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& loaded_entry : loaded) {
+    loaded_entry.group.IndexBlocks();
+
+    Entry entry;
+    entry.patterns = std::make_shared<const MemoryPatternGroup>(std::move(loaded_entry.group));
+    InsertLocked(loaded_entry.key, loaded_entry.feeds_size, std::move(entry));
+  }
+
+  // the cache contents now match the file
+  dirty_ = false;
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
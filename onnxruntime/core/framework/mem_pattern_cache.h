@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/path_string.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+
+/**
+Cache of MemoryPatternGroup instances keyed by the shapes of the feeds.
+
+Optionally
+  - buckets the feed shapes: each dimension is rounded up to a multiple of shape_bucket_size before computing the key,
+    so nearby shapes (e.g. sequence lengths 65..128 with a bucket size of 64) share one pattern. Within a bucket the
+    pattern learned from the largest feeds is kept, and blocks are allowed to hold smaller tensors.
+  - bounds the number of entries with LRU eviction.
+  - serializes the learned patterns to a file so they can be preloaded by a new session.
+
+Entries are handed out as shared pointers so an entry can be replaced or evicted while an ExecutionFrame is still
+using it. This class is thread-safe.
+*/
+class MemoryPatternCache {
+ public:
+  struct Options {
+    // Round each feed dimension up to a multiple of this value when computing the key. 0 or 1 disables bucketing.
+    int64_t shape_bucket_size = 0;
+    // Maximum number of cached patterns. 0 means unbounded.
+    size_t max_entries = 0;
+  };
+
+  using InferredShapes = InlinedHashMap<int, TensorShape>;
+
+  struct Entry {
+    std::shared_ptr<const MemoryPatternGroup> patterns;
+    // only generated in training builds. may be nullptr.
+    std::shared_ptr<const InferredShapes> inferred_shapes;
+  };
+
+  MemoryPatternCache() = default;
+  explicit MemoryPatternCache(const Options& options) : options_(options) {}
+
+  void SetOptions(const Options& options);
+  const Options& GetOptions() const { return options_; }
+
+  bool IsShapeBucketingEnabled() const { return options_.shape_bucket_size > 1; }
+
+  // Computes the cache key for the feeds. All feeds must be tensors.
+  int64_t ComputeKey(gsl::span<const OrtValue> tensor_inputs) const;
+
+  // Returns true and sets `entry` if a pattern that can service the feeds is cached.
+  // With shape bucketing enabled, a cached pattern learned from smaller feeds is reported as a miss so that a pattern
+  // covering the larger feeds gets generated and replaces it.
+  bool Find(gsl::span<const OrtValue> tensor_inputs, Entry& entry);
+
+  // Adds the pattern generated for the feeds. An existing entry is only replaced if the new pattern was learned from
+  // larger feeds, so pointers handed out for the existing entry stay valid either way.
+  Entry Insert(gsl::span<const OrtValue> tensor_inputs, MemoryPatternGroup patterns,
+               std::unique_ptr<InferredShapes> inferred_shapes = nullptr);
+
+  size_t Size() const;
+
+  // true if entries were added since the cache was created or last saved/loaded.
+  bool IsDirty() const;
+
+  // Serializes the cached patterns. OrtValue indexes are stored by name so the file remains valid as long as the
+  // optimized graph is the same.
+  Status Save(const PathString& file_path, const OrtValueNameIdxMap& ort_value_name_idx_map);
+
+  // Loads patterns previously written by Save. The file is rejected as a whole if it was written with a different
+  // bucket size or refers to OrtValues that don't exist in `ort_value_name_idx_map`.
+  Status Load(const PathString& file_path, const OrtValueNameIdxMap& ort_value_name_idx_map);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  struct CacheEntry {
+    Entry entry;
+    // total number of feed elements the pattern was learned from
+    int64_t feeds_size{0};
+    std::list<int64_t>::iterator lru_it;
+  };
+
+  static int64_t TotalFeedsSize(gsl::span<const OrtValue> tensor_inputs);
+
+  // must be called with mutex_ held
+  Entry InsertLocked(int64_t key, int64_t feeds_size, Entry entry);
+  void TouchLocked(CacheEntry& cache_entry);
+
+  Options options_;
+
+  mutable std::mutex mutex_;
+  NodeHashMap<int64_t, CacheEntry> entries_;
+  // most recently used key is at the front
+  std::list<int64_t> lru_;
+  bool dirty_{false};
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,268 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/memory_timeline.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "core/common/inlined_containers.h"
+#include "core/framework/session_state.h"
+#include "core/framework/tensor.h"
+#include "core/framework/tensorprotoutils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Returns -1 if the size is not known statically.
+int64_t GetStaticSizeInBytes(const NodeArg& node_arg, MLDataType value_type) {
+  if (value_type == nullptr || !value_type->IsTensorType() || node_arg.Shape() == nullptr) {
+    return -1;
+  }
+
+  const TensorShape shape = utils::GetTensorShapeFromTensorShapeProto(*node_arg.Shape());
+  if (shape.Size() < 0) {
+    return -1;
+  }
+
+  const auto* element_type = value_type->AsTensorType()->GetElementType();
+  return static_cast<int64_t>(Tensor::CalculateTensorStorageSize(element_type, shape));
+}
+
+const char* GetSource(AllocKind alloc_kind, bool enable_mem_pattern, bool has_static_size) {
+  switch (alloc_kind) {
+    case AllocKind::kAllocate:
+      // the memory pattern only covers the values whose size is known when the first run is planned
+      return enable_mem_pattern && has_static_size ? "pattern" : "dynamic";
+    case AllocKind::kReuse:
+    case AllocKind::kShare:
+      return "reuse";
+    case AllocKind::kAllocateOutput:
+      return "output";
+    default:
+      return "external";
+  }
+}
+
+void WriteValueIndices(std::ostringstream& ss, const std::vector<size_t>& indices) {
+  ss << "[";
+  for (size_t i = 0; i < indices.size(); ++i) {
+    ss << (i == 0 ? "" : ", ") << indices[i];
+  }
+  ss << "]";
+}
+
+}  // namespace
+
+Status CreateMemoryTimeline(const SessionState& session_state, MemoryTimeline& timeline) {
+  const SequentialExecutionPlan* plan = session_state.GetExecutionPlan();
+  ORT_RETURN_IF(plan == nullptr, "The session state has no execution plan.");
+
+  const GraphViewer& graph_viewer = session_state.GetGraphViewer();
+  const OrtValueNameIdxMap& name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& execution_order =
+      graph_viewer.GetNodesInTopologicalOrder(session_state.GetSessionOptions().execution_order);
+  const bool enable_mem_pattern = session_state.GetEnableMemoryPattern();
+
+  timeline = MemoryTimeline{};
+
+  for (const auto& initializer : session_state.GetInitializedTensors()) {
+    if (initializer.second.IsTensor()) {
+      timeline.initializer_bytes += initializer.second.Get<Tensor>().SizeInBytes();
+    }
+  }
+
+  InlinedHashMap<OrtValueIndex, std::string_view> index_to_name;
+  for (const auto& name_index : name_idx_map) {
+    index_to_name[name_index.second] = name_index.first;
+  }
+
+  // OrtValueIndex to index in timeline.values
+  InlinedHashMap<OrtValueIndex, size_t> value_positions;
+  std::vector<bool> is_released;
+
+  for (size_t step_idx = 0; step_idx < execution_order.size(); ++step_idx) {
+    const Node* node = graph_viewer.GetNode(execution_order[step_idx]);
+    ORT_RETURN_IF(node == nullptr, "Node ", execution_order[step_idx], " is not in the graph.");
+
+    MemoryTimeline::Step step;
+    step.node_index = node->Index();
+    step.node_name = node->Name().empty() ? MakeString(node->OpType(), "_", node->Index()) : node->Name();
+    step.op_type = node->OpType();
+
+    for (const NodeArg* output : node->OutputDefs()) {
+      if (!output->Exists()) {
+        continue;
+      }
+
+      OrtValueIndex value_idx;
+      ORT_RETURN_IF_ERROR(name_idx_map.GetIdx(output->Name(), value_idx));
+      const AllocPlanPerValue& alloc_plan = plan->allocation_plan[value_idx];
+
+      MemoryTimeline::Value value;
+      value.name = output->Name();
+      value.node_name = step.node_name;
+      value.alloc_kind = alloc_plan.alloc_kind;
+      value.location = alloc_plan.location;
+      value.start_step = value.end_step = step_idx;
+
+      if (alloc_plan.alloc_kind == AllocKind::kReuse || alloc_plan.alloc_kind == AllocKind::kShare) {
+        // the bytes are accounted for by the value that owns the buffer
+        value.size_in_bytes = 0;
+        value.reused_value = std::string(index_to_name[alloc_plan.reused_buffer]);
+      } else {
+        value.size_in_bytes = GetStaticSizeInBytes(*output, alloc_plan.value_type);
+        if (value.size_in_bytes < 0) {
+          ++timeline.num_unknown_size_values;
+        }
+      }
+
+      value.source = GetSource(alloc_plan.alloc_kind, enable_mem_pattern, value.size_in_bytes >= 0);
+
+      value_positions[value_idx] = timeline.values.size();
+      step.allocated.push_back(timeline.values.size());
+      timeline.values.push_back(std::move(value));
+      is_released.push_back(false);
+    }
+
+    // the plan releases the buffer owner after its last consumer. with multiple streams a buffer can be in the
+    // release list of several nodes, in which case the last of them in the execution order releases it.
+    if (step.node_index < plan->node_release_list.size()) {
+      for (size_t action_idx : plan->node_release_list[step.node_index]) {
+        const auto value_idx = static_cast<OrtValueIndex>(plan->release_actions[action_idx].value_index);
+        auto position = value_positions.find(value_idx);
+        if (position != value_positions.end()) {
+          timeline.values[position->second].end_step = step_idx;
+          is_released[position->second] = true;
+        }
+      }
+    }
+
+    timeline.steps.push_back(std::move(step));
+  }
+
+  if (timeline.steps.empty()) {
+    return Status::OK();
+  }
+
+  // graph outputs and values that are not consumed stay alive until the end of the run
+  const size_t last_step = timeline.steps.size() - 1;
+  for (size_t i = 0; i < timeline.values.size(); ++i) {
+    MemoryTimeline::Value& value = timeline.values[i];
+    if (!is_released[i]) {
+      value.end_step = last_step;
+    }
+    timeline.steps[value.end_step].released.push_back(i);
+  }
+
+  // sweep the steps, keeping the live bytes of each device
+  std::vector<std::pair<OrtDevice, size_t>> device_live_bytes;
+  auto get_device = [&](const OrtDevice& device) -> size_t {
+    for (size_t i = 0; i < device_live_bytes.size(); ++i) {
+      if (device_live_bytes[i].first == device) {
+        return i;
+      }
+    }
+    device_live_bytes.emplace_back(device, 0);
+    timeline.device_peaks.push_back(MemoryTimeline::DevicePeak{device});
+    return device_live_bytes.size() - 1;
+  };
+
+  size_t live_bytes = 0;
+  for (size_t step_idx = 0; step_idx < timeline.steps.size(); ++step_idx) {
+    MemoryTimeline::Step& step = timeline.steps[step_idx];
+    for (size_t value_idx : step.allocated) {
+      const auto& value = timeline.values[value_idx];
+      const size_t bytes = value.size_in_bytes > 0 ? static_cast<size_t>(value.size_in_bytes) : 0;
+      device_live_bytes[get_device(value.location)].second += bytes;
+      live_bytes += bytes;
+    }
+
+    step.live_bytes = live_bytes;
+    for (size_t i = 0; i < device_live_bytes.size(); ++i) {
+      auto& peak = timeline.device_peaks[i];
+      if (device_live_bytes[i].second > peak.peak_bytes) {
+        peak.peak_bytes = device_live_bytes[i].second;
+        peak.peak_step = step_idx;
+      }
+    }
+
+    for (size_t value_idx : step.released) {
+      const auto& value = timeline.values[value_idx];
+      const size_t bytes = value.size_in_bytes > 0 ? static_cast<size_t>(value.size_in_bytes) : 0;
+      device_live_bytes[get_device(value.location)].second -= bytes;
+      live_bytes -= bytes;
+    }
+  }
+
+  for (auto& peak : timeline.device_peaks) {
+    for (size_t i = 0; i < timeline.values.size(); ++i) {
+      const auto& value = timeline.values[i];
+      if (value.location == peak.device && value.size_in_bytes > 0 &&
+          value.start_step <= peak.peak_step && peak.peak_step <= value.end_step) {
+        peak.peak_values.push_back(i);
+      }
+    }
+
+    // largest first, as these are the values to look at to reduce the peak
+    std::stable_sort(peak.peak_values.begin(), peak.peak_values.end(), [&timeline](size_t a, size_t b) {
+      return timeline.values[a].size_in_bytes > timeline.values[b].size_in_bytes;
+    });
+  }
+
+  return Status::OK();
+}
+
+std::string MemoryTimeline::ToJson() const {
+  std::ostringstream ss;
+  ss << "{\"initializer_bytes\" : " << initializer_bytes << ", ";
+  ss << "\"unknown_size_values\" : " << num_unknown_size_values << ",\n";
+
+  ss << "\"peaks\" : [";
+  for (size_t i = 0; i < device_peaks.size(); ++i) {
+    const auto& peak = device_peaks[i];
+    ss << (i == 0 ? "\n" : ",\n");
+    ss << R"({"device" : ")" << peak.device.ToString() << "\", ";
+    ss << "\"peak_bytes\" : " << peak.peak_bytes << ", ";
+    ss << "\"peak_step\" : " << peak.peak_step << ", ";
+    ss << "\"live_values\" : ";
+    WriteValueIndices(ss, peak.peak_values);
+    ss << "}";
+  }
+  ss << "],\n";
+
+  ss << "\"steps\" : [";
+  for (size_t i = 0; i < steps.size(); ++i) {
+    const auto& step = steps[i];
+    ss << (i == 0 ? "\n" : ",\n");
+    ss << R"({"node" : ")" << step.node_name << R"(", "op_type" : ")" << step.op_type << "\", ";
+    ss << "\"live_bytes\" : " << step.live_bytes << ", ";
+    ss << "\"allocated\" : ";
+    WriteValueIndices(ss, step.allocated);
+    ss << ", \"released\" : ";
+    WriteValueIndices(ss, step.released);
+    ss << "}";
+  }
+  ss << "],\n";
+
+  ss << "\"values\" : [";
+  for (size_t i = 0; i < values.size(); ++i) {
+    const auto& value = values[i];
+    ss << (i == 0 ? "\n" : ",\n");
+    ss << R"({"name" : ")" << value.name << R"(", "node" : ")" << value.node_name << "\", ";
+    ss << "\"size\" : " << value.size_in_bytes << ", ";
+    ss << R"("source" : ")" << value.source << "\", ";
+    if (!value.reused_value.empty()) {
+      ss << R"("reuses" : ")" << value.reused_value << "\", ";
+    }
+    ss << R"("device" : ")" << value.location.ToString() << "\", ";
+    ss << "\"start\" : " << value.start_step << ", ";
+    ss << "\"end\" : " << value.end_step << "}";
+  }
+  ss << "]}\n";
+
+  return ss.str();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/status.h"
+#include "core/framework/alloc_kind.h"
+#include "core/framework/ortdevice.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class SessionState;
+
+// Memory timeline of a session, simulated from its allocation plan without executing any kernel.
+// Each step is a node of the execution order. A value is live from the step of the node that produces it until the
+// step after which the plan releases its buffer. Sizes come from the inferred shapes of the graph, so free dimension
+// overrides can be used to simulate a batch size. Values with a dynamic shape can't be sized and are reported with
+// a size of -1.
+struct MemoryTimeline {
+  struct Value {
+    std::string name;
+    // the node that produces the value
+    std::string node_name;
+    AllocKind alloc_kind{AllocKind::kNotSet};
+    // "pattern": allocated from the block of the memory pattern,
+    // "dynamic": allocated when the node runs,
+    // "reuse": reuses the buffer of reused_value, planned statically,
+    // "output": a graph output, allocated when the node runs unless it is pre-allocated by the user.
+    std::string source;
+    std::string reused_value;
+    OrtDevice location;
+    int64_t size_in_bytes{-1};
+    size_t start_step{0};
+    size_t end_step{0};
+  };
+
+  struct Step {
+    NodeIndex node_index{0};
+    std::string node_name;
+    std::string op_type;
+    // bytes of the values that are live while the node runs, for all devices
+    size_t live_bytes{0};
+    // values, indices into MemoryTimeline::values, whose buffer is allocated or released by this step
+    std::vector<size_t> allocated;
+    std::vector<size_t> released;
+  };
+
+  struct DevicePeak {
+    OrtDevice device;
+    size_t peak_bytes{0};
+    size_t peak_step{0};
+    // the values live at the peak step, indices into MemoryTimeline::values
+    std::vector<size_t> peak_values;
+  };
+
+  std::vector<Value> values;
+  std::vector<Step> steps;
+  std::vector<DevicePeak> device_peaks;
+  size_t initializer_bytes{0};
+  size_t num_unknown_size_values{0};
+
+  std::string ToJson() const;
+};
+
+// Creates the memory timeline of the main graph of the session state.
+Status CreateMemoryTimeline(const SessionState& session_state, MemoryTimeline& timeline);
+
+}  // namespace onnxruntime
@@ -15,6 +15,9 @@
 
 /* Modifications Copyright (c) Microsoft. */
 
+#include <algorithm>
+#include <limits>
+
 #include "core/framework/endian.h"
 
 #include "core/util/force_inline.h"
@@ -344,4 +347,18 @@ void MurmurHash3::x86_128(const void* key, int len, uint32_t seed, void* out) {
   ((uint32_t*)out)[3] = h4;
 }
 
+void MurmurHash3::x86_128_append(const void* key, size_t len, uint32_t* hash) {
+  const uint64_t len64 = len;
+  x86_128(&len64, static_cast<int>(sizeof(len64)), hash[0], hash);
+
+  // x86_128 takes an int length, so larger buffers are hashed in chunks
+  const auto* data = static_cast<const uint8_t*>(key);
+  while (len > 0) {
+    const size_t chunk = std::min(len, static_cast<size_t>(std::numeric_limits<int>::max()));
+    x86_128(data, static_cast<int>(chunk), hash[0], hash);
+    data += chunk;
+    len -= chunk;
+  }
+}
+
 }  // namespace onnxruntime
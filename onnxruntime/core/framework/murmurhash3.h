@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 namespace onnxruntime {
@@ -12,5 +13,9 @@ struct MurmurHash3 {
 
   // generate 128-bit hash from input and write to 'out'.
   static void x86_128(const void* key, int len, uint32_t seed, void* out);
+
+  // add a buffer of any length to the running 128-bit hash in hash[0..3], seeded with hash[0].
+  // the length is hashed too, so the boundaries between the buffers added to a hash are part of it.
+  static void x86_128_append(const void* key, size_t len, uint32_t* hash);
 };
 }  // namespace onnxruntime
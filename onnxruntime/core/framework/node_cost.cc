@@ -0,0 +1,225 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_cost.h"
+
+#include <string>
+
+#include "core/common/inlined_containers.h"
+#include "core/framework/tensor.h"
+#include "core/graph/constants.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+
+namespace {
+
+using CostFunction = double (*)(const Node& node, gsl::span<const Tensor* const> inputs,
+                                gsl::span<const Tensor* const> outputs);
+
+const Tensor* At(gsl::span<const Tensor* const> tensors, size_t index) {
+  return index < tensors.size() ? tensors[index] : nullptr;
+}
+
+double NumElements(const Tensor* tensor) {
+  return tensor != nullptr ? static_cast<double>(tensor->Shape().Size()) : 0.0;
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto& attributes = node.GetAttributes();
+  auto it = attributes.find(name);
+  return it != attributes.end() ? it->second.i() : default_value;
+}
+
+// 2 * M * N * K, with K the last dimension of A for all the MatMul variants (A is input 0).
+double MatMulFlops(const Node&, gsl::span<const Tensor* const> inputs, gsl::span<const Tensor* const> outputs) {
+  const Tensor* a = At(inputs, 0);
+  if (a == nullptr || a->Shape().NumDimensions() == 0) {
+    return 0;
+  }
+  const auto k = static_cast<double>(a->Shape()[a->Shape().NumDimensions() - 1]);
+  return 2 * NumElements(At(outputs, 0)) * k;
+}
+
+double GemmFlops(const Node& node, gsl::span<const Tensor* const> inputs, gsl::span<const Tensor* const> outputs) {
+  const Tensor* a = At(inputs, 0);
+  if (a == nullptr || a->Shape().NumDimensions() != 2) {
+    return 0;
+  }
+  const auto k = static_cast<double>(a->Shape()[GetIntAttribute(node, "transA", 0) != 0 ? 0 : 1]);
+  // the scaled bias adds one operation per element
+  return (2 * k + (At(inputs, 2) != nullptr ? 1 : 0)) * NumElements(At(outputs, 0));
+}
+
+// Every output element of a convolution with weight [M, C / group, k1, k2, ...] takes C / group * k1 * k2 * ...
+// multiply-adds.
+double ConvFlopsWithWeight(size_t weight_index, gsl::span<const Tensor* const> inputs,
+                           gsl::span<const Tensor* const> outputs) {
+  const Tensor* w = At(inputs, weight_index);
+  if (w == nullptr || w->Shape().NumDimensions() < 2) {
+    return 0;
+  }
+  return 2 * NumElements(At(outputs, 0)) * static_cast<double>(w->Shape().SizeFromDimension(1));
+}
+
+double ConvFlops(const Node&, gsl::span<const Tensor* const> inputs, gsl::span<const Tensor* const> outputs) {
+  return ConvFlopsWithWeight(1, inputs, outputs);
+}
+
+double QLinearConvFlops(const Node&, gsl::span<const Tensor* const> inputs, gsl::span<const Tensor* const> outputs) {
+  return ConvFlopsWithWeight(3, inputs, outputs);
+}
+
+// Every input element of a transposed convolution with weight [C, M / group, k1, k2, ...] is scattered with
+// M / group * k1 * k2 * ... multiply-adds.
+double ConvTransposeFlops(const Node&, gsl::span<const Tensor* const> inputs, gsl::span<const Tensor* const>) {
+  const Tensor* w = At(inputs, 1);
+  if (w == nullptr || w->Shape().NumDimensions() < 2) {
+    return 0;
+  }
+  return 2 * NumElements(At(inputs, 0)) * static_cast<double>(w->Shape().SizeFromDimension(1));
+}
+
+// Q * K^T and the product with V: 4 * batch * sequence * total sequence * hidden size, ignoring the softmax.
+double AttentionCoreFlops(double batch, double sequence, double total_sequence, double hidden) {
+  return 4 * batch * sequence * total_sequence * hidden;
+}
+
+// Attention: input [B, S, D_in] and packed weights [D_in, 3 * D], with the past key of shape [2, B, N, P, H].
+double AttentionFlops(const Node&, gsl::span<const Tensor* const> inputs, gsl::span<const Tensor* const>) {
+  const Tensor* input = At(inputs, 0);
+  const Tensor* weights = At(inputs, 1);
+  if (input == nullptr || weights == nullptr || input->Shape().NumDimensions() != 3 ||
+      weights->Shape().NumDimensions() != 2) {
+    return 0;
+  }
+  const auto batch = static_cast<double>(input->Shape()[0]);
+  const auto sequence = static_cast<double>(input->Shape()[1]);
+  const auto hidden = static_cast<double>(weights->Shape()[1]) / 3;
+  double total_sequence = sequence;
+  if (const Tensor* past = At(inputs, 4); past != nullptr && past->Shape().NumDimensions() == 5) {
+    total_sequence += static_cast<double>(past->Shape()[3]);
+  }
+  const double projection = 2 * batch * sequence * static_cast<double>(weights->Shape().Size());
+  return projection + AttentionCoreFlops(batch, sequence, total_sequence, hidden);
+}
+
+// MultiHeadAttention: query [B, S, D] and key [B, L, D] or [B, N, L, H], or packed QKV [B, S, N, 3, H].
+double MultiHeadAttentionFlops(const Node&, gsl::span<const Tensor* const> inputs, gsl::span<const Tensor* const>) {
+  const Tensor* query = At(inputs, 0);
+  if (query == nullptr || query->Shape().NumDimensions() < 3) {
+    return 0;
+  }
+  const auto& q_shape = query->Shape();
+  const auto batch = static_cast<double>(q_shape[0]);
+  const auto sequence = static_cast<double>(q_shape[1]);
+  const auto hidden = q_shape.NumDimensions() == 5 ? static_cast<double>(q_shape[2] * q_shape[4])
+                                                   : static_cast<double>(q_shape[2]);
+  double total_sequence = sequence;
+  if (const Tensor* key = At(inputs, 1); key != nullptr) {
+    total_sequence = static_cast<double>(key->Shape().NumDimensions() == 4 ? key->Shape()[2] : key->Shape()[1]);
+  }
+  if (const Tensor* past_key = At(inputs, 6); past_key != nullptr && past_key->Shape().NumDimensions() == 4) {
+    total_sequence += static_cast<double>(past_key->Shape()[2]);
+  }
+  return AttentionCoreFlops(batch, sequence, total_sequence, hidden);
+}
+
+// GroupQueryAttention: query [B, S, D], and the present key [B, N_kv, T, H] output holds the total sequence.
+double GroupQueryAttentionFlops(const Node&, gsl::span<const Tensor* const> inputs,
+                                gsl::span<const Tensor* const> outputs) {
+  const Tensor* query = At(inputs, 0);
+  const Tensor* present_key = At(outputs, 1);
+  if (query == nullptr || present_key == nullptr || query->Shape().NumDimensions() != 3 ||
+      present_key->Shape().NumDimensions() != 4) {
+    return 0;
+  }
+  const auto& output = At(outputs, 0);
+  const auto hidden = output != nullptr && output->Shape().NumDimensions() == 3
+                          ? static_cast<double>(output->Shape()[2])
+                          : static_cast<double>(query->Shape()[2]);
+  return AttentionCoreFlops(static_cast<double>(query->Shape()[0]), static_cast<double>(query->Shape()[1]),
+                            static_cast<double>(present_key->Shape()[2]), hidden);
+}
+
+template <int kFlopsPerElement>
+double PerOutputElementFlops(const Node&, gsl::span<const Tensor* const>, gsl::span<const Tensor* const> outputs) {
+  return kFlopsPerElement * NumElements(At(outputs, 0));
+}
+
+template <int kFlopsPerElement>
+double PerInputElementFlops(const Node&, gsl::span<const Tensor* const> inputs, gsl::span<const Tensor* const>) {
+  return kFlopsPerElement * NumElements(At(inputs, 0));
+}
+
+const InlinedHashMap<std::string, CostFunction>& CostFunctions() {
+  static const InlinedHashMap<std::string, CostFunction> cost_functions = [] {
+    InlinedHashMap<std::string, CostFunction> functions;
+    for (const char* op : {"MatMul", "MatMulInteger", "QLinearMatMul", "FusedMatMul", "MatMulNBits",
+                           "MatMulIntegerToFloat", "DynamicQuantizeMatMul", "MatMulFpQ4", "MatMulBnb4"}) {
+      functions[op] = MatMulFlops;
+    }
+    for (const char* op : {"Gemm", "QGemm", "GemmFloat8"}) {
+      functions[op] = GemmFlops;
+    }
+    for (const char* op : {"Conv", "ConvInteger", "FusedConv", "NhwcConv", "NhwcFusedConv"}) {
+      functions[op] = ConvFlops;
+    }
+    functions["QLinearConv"] = QLinearConvFlops;
+    functions["ConvTranspose"] = ConvTransposeFlops;
+    functions["Attention"] = AttentionFlops;
+    functions["MultiHeadAttention"] = MultiHeadAttentionFlops;
+    functions["GroupQueryAttention"] = GroupQueryAttentionFlops;
+
+    for (const char* op : {"Add", "Sub", "Mul", "Div", "Max", "Min", "Sum", "Mean", "Pow", "Relu", "LeakyRelu",
+                           "Neg", "Abs", "Sqrt", "Reciprocal", "Clip", "Where", "Equal", "Less", "Greater",
+                           "LessOrEqual", "GreaterOrEqual", "BiasAdd", "QuickGelu", "PRelu", "Mod"}) {
+      functions[op] = PerOutputElementFlops<1>;
+    }
+    // transcendental functions are counted as a few operations each
+    for (const char* op : {"Exp", "Log", "Sigmoid", "Tanh", "Erf", "Gelu", "FastGelu", "BiasGelu", "Softplus",
+                           "HardSigmoid", "Elu", "Selu", "Silu", "Swish", "Mish"}) {
+      functions[op] = PerOutputElementFlops<4>;
+    }
+    for (const char* op : {"ReduceSum", "ReduceMean", "ReduceMax", "ReduceMin", "ReduceProd", "ReduceL1",
+                           "ReduceL2", "ReduceSumSquare", "ReduceLogSumExp", "ArgMax", "ArgMin", "GlobalAveragePool",
+                           "GlobalMaxPool", "AveragePool", "MaxPool"}) {
+      functions[op] = PerInputElementFlops<1>;
+    }
+    // max, exp, sum and scale
+    for (const char* op : {"Softmax", "LogSoftmax"}) {
+      functions[op] = PerInputElementFlops<5>;
+    }
+    // mean, variance, normalization, scale and bias
+    for (const char* op : {"LayerNormalization", "SkipLayerNormalization", "SimplifiedLayerNormalization",
+                           "SkipSimplifiedLayerNormalization", "RMSNormalization", "GroupNorm",
+                           "InstanceNormalization", "BatchNormalization", "EmbedLayerNormalization"}) {
+      functions[op] = PerInputElementFlops<8>;
+    }
+    return functions;
+  }();
+  return cost_functions;
+}
+
+}  // namespace
+
+NodeCost EstimateNodeCost(const Node& node, gsl::span<const Tensor* const> inputs,
+                          gsl::span<const Tensor* const> outputs) {
+  NodeCost cost;
+  for (const auto* tensors : {&inputs, &outputs}) {
+    for (const Tensor* tensor : *tensors) {
+      if (tensor != nullptr) {
+        cost.bytes += static_cast<double>(tensor->SizeInBytes());
+      }
+    }
+  }
+
+  const auto& cost_functions = CostFunctions();
+  auto it = cost_functions.find(node.OpType());
+  if (it != cost_functions.end()) {
+    cost.flops = it->second(node, inputs, outputs);
+  }
+  return cost;
+}
+
+}  // namespace onnxruntime
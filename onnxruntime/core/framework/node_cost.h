@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <gsl/gsl>
+
+namespace onnxruntime {
+
+class Node;
+class Tensor;
+
+// The estimated work of one execution of a node: the floating point (or integer) operations, a multiply-add counting
+// as two, and the bytes of its inputs and outputs. The profiler divides them by the kernel time to annotate the node
+// events with the achieved throughput.
+struct NodeCost {
+  double flops{0};
+  double bytes{0};
+};
+
+// Estimates the cost of the node from the tensors of one execution. Missing (optional or non tensor) inputs and
+// outputs are null. Ops without a cost function have no flops, e.g. the data movement ops, but have their bytes.
+NodeCost EstimateNodeCost(const Node& node, gsl::span<const Tensor* const> inputs,
+                          gsl::span<const Tensor* const> outputs);
+
+}  // namespace onnxruntime
@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace onnxruntime {
+namespace philox {
+
+// Philox4x32-10 counter based random number engine for the CPU, see
+// "Parallel Random Numbers: As Easy as 1, 2, 3" (Salmon et al., SC 2011).
+//
+// The stream of a (seed, offset) pair is made of 128-bit blocks: block b is the encryption of the counter offset + b
+// with the key seed, and the 32-bit value i of the stream is word i % 4 of block i / 4. Any range of the stream can
+// be generated on its own, so the results do not depend on how the work is split between threads. The offset is
+// counted in blocks, as reserved with PhiloxGenerator::NextPhiloxSeeds().
+
+constexpr uint32_t kMultiplier0 = 0xD2511F53;
+constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+constexpr uint32_t kWeyl0 = 0x9E3779B9;
+constexpr uint32_t kWeyl1 = 0xBB67AE85;
+constexpr int kRounds = 10;
+
+// Number of blocks encrypted together. The rounds run over arrays of kLanes words, which the compiler vectorizes with
+// the 32x32->64 bit multiplies of SSE2/AVX2 or NEON.
+constexpr size_t kLanes = 8;
+
+// Encrypts the 128-bit counter with the 64-bit key.
+inline void Philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]) {
+  uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+  uint32_t k0 = key[0], k1 = key[1];
+
+  for (int round = 0; round < kRounds; round++) {
+    const uint64_t p0 = uint64_t{kMultiplier0} * c0;
+    const uint64_t p1 = uint64_t{kMultiplier1} * c2;
+    c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+    c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+    c1 = static_cast<uint32_t>(p1);
+    c3 = static_cast<uint32_t>(p0);
+    k0 += kWeyl0;
+    k1 += kWeyl1;
+  }
+
+  result[0] = c0;
+  result[1] = c1;
+  result[2] = c2;
+  result[3] = c3;
+}
+
+// Writes the block_count blocks of the stream of seed starting at counter, 4 words each.
+inline void GenerateBlocks(uint64_t seed, uint64_t counter, size_t block_count, uint32_t* out) {
+  const uint32_t key[2] = {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+
+  for (; block_count >= kLanes; block_count -= kLanes, counter += kLanes, out += 4 * kLanes) {
+    uint32_t c0[kLanes], c1[kLanes], c2[kLanes], c3[kLanes];
+    for (size_t l = 0; l < kLanes; l++) {
+      const uint64_t block_counter = counter + l;
+      c0[l] = static_cast<uint32_t>(block_counter);
+      c1[l] = static_cast<uint32_t>(block_counter >> 32);
+      c2[l] = 0;
+      c3[l] = 0;
+    }
+
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < kRounds; round++) {
+      for (size_t l = 0; l < kLanes; l++) {
+        const uint64_t p0 = uint64_t{kMultiplier0} * c0[l];
+        const uint64_t p1 = uint64_t{kMultiplier1} * c2[l];
+        c0[l] = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+        c2[l] = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+        c1[l] = static_cast<uint32_t>(p1);
+        c3[l] = static_cast<uint32_t>(p0);
+      }
+      k0 += kWeyl0;
+      k1 += kWeyl1;
+    }
+
+    for (size_t l = 0; l < kLanes; l++) {
+      out[4 * l + 0] = c0[l];
+      out[4 * l + 1] = c1[l];
+      out[4 * l + 2] = c2[l];
+      out[4 * l + 3] = c3[l];
+    }
+  }
+
+  for (; block_count > 0; block_count--, counter++, out += 4) {
+    const uint32_t block_counter[4] = {static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0};
+    Philox4x32(block_counter, key, out);
+  }
+}
+
+// Writes the 32-bit values [first, first + count) of the stream of (seed, offset).
+inline void Generate(uint64_t seed, uint64_t offset, uint64_t first, size_t count, uint32_t* out) {
+  uint64_t block = offset + first / 4;
+  uint32_t words[4];
+
+  const size_t skip = static_cast<size_t>(first % 4);
+  if (skip != 0 && count > 0) {
+    const size_t n = std::min(count, 4 - skip);
+    GenerateBlocks(seed, block++, 1, words);
+    std::memcpy(out, words + skip, n * sizeof(uint32_t));
+    out += n;
+    count -= n;
+  }
+
+  const size_t full_blocks = count / 4;
+  GenerateBlocks(seed, block, full_blocks, out);
+  block += full_blocks;
+  out += 4 * full_blocks;
+  count -= 4 * full_blocks;
+
+  if (count > 0) {
+    GenerateBlocks(seed, block, 1, words);
+    std::memcpy(out, words, count * sizeof(uint32_t));
+  }
+}
+
+// A float takes one 32-bit value of the stream and a double takes two.
+template <typename T>
+constexpr size_t kWordsPerValue = sizeof(T) / sizeof(uint32_t);
+
+// Number of blocks to reserve for count values of type T, uniform or normal.
+template <typename T>
+constexpr uint64_t BlockCount(size_t count) {
+  return ((static_cast<uint64_t>(count) + 1) * kWordsPerValue<T> + 3) / 4;
+}
+
+// Maps the next kWordsPerValue<T> words to [0, 1), with all the bits of the mantissa random.
+template <typename T>
+T ToUnitInterval(const uint32_t* words);
+
+template <>
+inline float ToUnitInterval<float>(const uint32_t* words) {
+  return static_cast<float>(words[0] >> 8) * (1.0f / 16777216.0f);
+}
+
+template <>
+inline double ToUnitInterval<double>(const uint32_t* words) {
+  return static_cast<double>(((uint64_t{words[0]} << 32) | words[1]) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Number of values converted per chunk of words on the stack.
+constexpr size_t kChunkSize = 256;
+
+// Writes the values [first, first + count) of the uniform distribution in [low, high) of the stream of
+// (seed, offset). Value i takes the words [i * kWordsPerValue<T>, (i + 1) * kWordsPerValue<T>).
+template <typename T>
+void GenerateUniform(uint64_t seed, uint64_t offset, uint64_t first, size_t count, T low, T high, T* out) {
+  constexpr size_t W = kWordsPerValue<T>;
+  uint32_t words[kChunkSize * W];
+  const T range = high - low;
+
+  while (count > 0) {
+    const size_t n = std::min(count, kChunkSize);
+    Generate(seed, offset, first * W, n * W, words);
+    for (size_t i = 0; i < n; i++) {
+      out[i] = low + range * ToUnitInterval<T>(words + i * W);
+    }
+    first += n;
+    out += n;
+    count -= n;
+  }
+}
+
+// Writes the values [first, first + count) of the normal distribution N(mean, scale^2) of the stream of
+// (seed, offset), with the Box-Muller transform. Values 2p and 2p + 1 are the cosine and sine branches of the
+// uniform pair taking the words [2p * kWordsPerValue<T>, (2p + 2) * kWordsPerValue<T>).
+template <typename T>
+void GenerateNormal(uint64_t seed, uint64_t offset, uint64_t first, size_t count, T mean, T scale, T* out) {
+  constexpr size_t W = kWordsPerValue<T>;
+  constexpr T kTwoPi = static_cast<T>(6.283185307179586476925286766559);
+  uint32_t words[kChunkSize * 2 * W];
+
+  const uint64_t end = first + count;
+  uint64_t i = first;
+  while (i < end) {
+    const uint64_t pair_begin = i / 2;
+    const uint64_t pair_end = std::min<uint64_t>((end + 1) / 2, pair_begin + kChunkSize);
+    Generate(seed, offset, pair_begin * 2 * W, static_cast<size_t>(pair_end - pair_begin) * 2 * W, words);
+
+    const uint64_t chunk_end = std::min(end, pair_end * 2);
+    for (; i < chunk_end; i++) {
+      const uint32_t* pair_words = words + static_cast<size_t>(i / 2 - pair_begin) * 2 * W;
+      // 1 - u is in (0, 1], so that its log is finite.
+      const T radius = std::sqrt(static_cast<T>(-2) * std::log(static_cast<T>(1) - ToUnitInterval<T>(pair_words)));
+      const T theta = kTwoPi * ToUnitInterval<T>(pair_words + W);
+      *out++ = mean + scale * radius * ((i % 2 == 0) ? std::cos(theta) : std::sin(theta));
+    }
+  }
+}
+
+}  // namespace philox
+}  // namespace onnxruntime
@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file_cache.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "core/common/binary_io.h"
+#include "core/common/logging/logging.h"
+#include "core/common/narrow.h"
+#include "core/common/platform_identity.h"
+#include "core/common/safeint.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// File layout, after the header of core/common/binary_io.h with the platform identity:
+//   uint64 number of entries
+//   per entry: string key, uint64 number of buffers, per buffer: uint64 offset, uint64 size
+//   followed by the buffers, each one starting at a multiple of kBufferAlignment from the start of the file.
+// A buffer that was null when it was added is stored with a size of 0.
+constexpr uint32_t kPrepackedWeightsFileMagic = 0x57505052;  // "RPPW"
+constexpr uint32_t kPrepackedWeightsFileVersion = 1;
+
+// the mapping starts at a page boundary so the buffers keep this alignment in memory
+constexpr size_t kBufferAlignment = 64;
+
+// a lock older than this was left by a process that didn't finish writing the file
+constexpr auto kStaleLockAge = std::chrono::minutes(10);
+
+size_t AlignUp(size_t value) {
+  return (value + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+}
+
+}  // namespace
+
+PrepackedWeightsFileCache::PrepackedWeightsFileCache(const Env& env, PathString file_path,
+                                                     const logging::Logger& logger)
+    : env_{env}, file_path_{std::move(file_path)}, logger_{logger} {
+  std::error_code ec;
+  if (!std::filesystem::exists(std::filesystem::path{file_path_}, ec)) {
+    LOGS(logger_, INFO) << "Pre-packed weights cache file " << PathToUTF8String(file_path_)
+                        << " doesn't exist yet.";
+    return;
+  }
+
+  auto status = Load(env_, file_path_, mapped_file_, loaded_);
+  if (!status.IsOK()) {
+    // a stale file is expected after an update, and the cache starts empty
+    LOGS(logger_, WARNING) << "Pre-packed weights cache not loaded: " << status.ErrorMessage();
+    loaded_.clear();
+    mapped_file_.reset();
+  } else {
+    LOGS(logger_, INFO) << "Loaded " << loaded_.size() << " pre-packed weights from "
+                        << PathToUTF8String(file_path_);
+  }
+}
+
+// static
+Status PrepackedWeightsFileCache::Load(const Env& env, const PathString& file_path, Env::MappedMemoryPtr& mapped_file,
+                                       Entries& entries) {
+  size_t file_length = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(file_path.c_str(), file_length));
+  ORT_RETURN_IF(file_length == 0, "The pre-packed weights cache file is empty.");
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(file_path.c_str(), 0, file_length, mapped_file));
+
+  const char* data = mapped_file.get();
+  binary_io::BufferReader reader(data, file_length);
+
+  const auto header = binary_io::ReadHeader(reader, kPrepackedWeightsFileMagic, kPrepackedWeightsFileVersion,
+                                            GetPlatformIdentity());
+  ORT_RETURN_IF(header == binary_io::HeaderStatus::kInvalid,
+                "Invalid pre-packed weights cache file: ", PathToUTF8String(file_path));
+  ORT_RETURN_IF(header == binary_io::HeaderStatus::kIdentityMismatch,
+                "The pre-packed weights cache file was created by a different build of ONNX Runtime or for a ",
+                "different CPU.");
+
+  uint64_t num_entries = 0;
+  ORT_RETURN_IF_NOT(reader.ReadPod(num_entries), "Truncated pre-packed weights cache file.");
+
+  std::string key;
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    uint64_t num_buffers = 0;
+    ORT_RETURN_IF_NOT(reader.ReadString(key) && reader.ReadPod(num_buffers),
+                      "Truncated pre-packed weights cache file.");
+
+    PrePackedWeights weights;
+    for (uint64_t j = 0; j < num_buffers; ++j) {
+      uint64_t offset = 0, size = 0;
+      ORT_RETURN_IF_NOT(reader.ReadPod(offset) && reader.ReadPod(size), "Truncated pre-packed weights cache file.");
+      ORT_RETURN_IF_NOT(offset <= file_length && size <= file_length - offset,
+                        "Pre-packed weights cache entry ", key, " is out of bounds.");
+
+      // the mapping is owned by the cache, so the buffers must not free it
+      void* buffer = size == 0 ? nullptr : const_cast<char*>(data) + narrow<size_t>(offset);
+      weights.buffers_.push_back(IAllocatorUniquePtr<void>(buffer, [](void*) {}));
+      weights.buffer_sizes_.push_back(narrow<size_t>(size));
+    }
+
+    entries.insert_or_assign(key, std::move(weights));
+  }
+
+  return Status::OK();
+}
+
+const PrePackedWeights* PrepackedWeightsFileCache::Find(const std::string& key) const {
+  if (auto it = loaded_.find(key); it != loaded_.end()) {
+    return &it->second;
+  }
+  if (auto it = added_.find(key); it != added_.end()) {
+    return &it->second;
+  }
+  return nullptr;
+}
+
+void PrepackedWeightsFileCache::Add(const std::string& key, const PrePackedWeights& weights) {
+  if (loaded_.find(key) == loaded_.end()) {
+    added_.insert_or_assign(key, weights.CreateReferringCopy());
+  }
+}
+
+Status PrepackedWeightsFileCache::Save() {
+  if (added_.empty()) {
+    return Status::OK();
+  }
+
+  // Creating a directory is atomic, so it serves as a lock between the processes using the file.
+  std::filesystem::path lock_path{file_path_};
+  lock_path += ".lock";
+  std::error_code ec;
+  if (!std::filesystem::create_directory(lock_path, ec)) {
+    ORT_RETURN_IF(ec, "Failed to create ", PathToUTF8String(lock_path.native()), ": ", ec.message());
+
+    // the writer may have crashed if the lock is old
+    const auto lock_time = std::filesystem::last_write_time(lock_path, ec);
+    if (ec || std::filesystem::file_time_type::clock::now() - lock_time < kStaleLockAge ||
+        !std::filesystem::remove(lock_path, ec) || !std::filesystem::create_directory(lock_path, ec)) {
+      LOGS(logger_, INFO) << "The pre-packed weights cache " << PathToUTF8String(file_path_)
+                          << " is being written by another process.";
+      return Status::OK();
+    }
+  }
+
+  // another process may have written weights since the file was loaded. they don't have to be valid for this
+  // process, as nothing but the identity check is needed to copy them.
+  Env::MappedMemoryPtr on_disk_mapping;
+  Entries on_disk_entries;
+  if (std::filesystem::exists(std::filesystem::path{file_path_}, ec) &&
+      !Load(env_, file_path_, on_disk_mapping, on_disk_entries).IsOK()) {
+    on_disk_entries.clear();
+  }
+
+  auto status = Write(on_disk_entries);
+  std::filesystem::remove(lock_path, ec);
+  return status;
+}
+
+Status PrepackedWeightsFileCache::Write(const Entries& on_disk_entries) const {
+  // the entries loaded from the file are kept so one file can serve several models and processes
+  InlinedVector<const std::pair<const std::string, PrePackedWeights>*> entries;
+  entries.reserve(on_disk_entries.size() + loaded_.size() + added_.size());
+  for (const auto& entry : on_disk_entries) {
+    if (loaded_.find(entry.first) == loaded_.end() && added_.find(entry.first) == added_.end()) {
+      entries.push_back(&entry);
+    }
+  }
+  for (const auto& entry : loaded_) {
+    entries.push_back(&entry);
+  }
+  for (const auto& entry : added_) {
+    entries.push_back(&entry);
+  }
+
+  SafeInt<size_t> header_size = binary_io::HeaderSize(GetPlatformIdentity()) + sizeof(uint64_t);
+  for (const auto* entry : entries) {
+    header_size += sizeof(uint64_t) * 2 + entry->first.size() + SafeInt<size_t>(sizeof(uint64_t) * 2) *
+                                                                    entry->second.buffers_.size();
+  }
+
+  // write to a temporary file first so other processes never map a partially written cache
+  std::filesystem::path file_path{file_path_};
+  std::filesystem::path temp_path{file_path};
+  temp_path += ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(out, "Failed to open ", PathToUTF8String(temp_path.native()), " for writing.");
+
+    using namespace binary_io;
+    WriteHeader(out, kPrepackedWeightsFileMagic, kPrepackedWeightsFileVersion, GetPlatformIdentity());
+    WritePod(out, static_cast<uint64_t>(entries.size()));
+
+    size_t offset = AlignUp(header_size);
+    for (const auto* entry : entries) {
+      const auto& weights = entry->second;
+      WriteString(out, entry->first);
+      WritePod(out, static_cast<uint64_t>(weights.buffers_.size()));
+      for (size_t i = 0; i < weights.buffers_.size(); ++i) {
+        const size_t size = weights.buffers_[i] ? weights.buffer_sizes_[i] : 0;
+        WritePod(out, static_cast<uint64_t>(size == 0 ? 0 : offset));
+        WritePod(out, static_cast<uint64_t>(size));
+        offset = AlignUp(SafeInt<size_t>(offset) + size);
+      }
+    }
+
+    static constexpr char kPadding[kBufferAlignment] = {};
+    size_t position = header_size;
+    for (const auto* entry : entries) {
+      const auto& weights = entry->second;
+      for (size_t i = 0; i < weights.buffers_.size(); ++i) {
+        if (!weights.buffers_[i] || weights.buffer_sizes_[i] == 0) {
+          continue;
+        }
+        out.write(kPadding, AlignUp(position) - position);
+        out.write(static_cast<const char*>(weights.buffers_[i].get()), weights.buffer_sizes_[i]);
+        position = AlignUp(position) + weights.buffer_sizes_[i];
+      }
+    }
+
+    ORT_RETURN_IF_NOT(out.good(), "Failed to write ", PathToUTF8String(temp_path.native()));
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(temp_path, file_path, ec);
+  ORT_RETURN_IF(ec, "Failed to replace ", PathToUTF8String(file_path_), ": ", ec.message());
+
+  LOGS(logger_, INFO) << "Saved " << entries.size() << " pre-packed weights to " << PathToUTF8String(file_path_);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace logging {
+class Logger;
+}
+
+//
+// PrepackedWeightsFileCache keeps the buffers produced by OpKernel::PrePack() in a file, so that later sessions in
+// this or other processes can hand them to the kernels without packing the weights again.
+//
+// The file is memory mapped read-only, so the buffers are loaded lazily by the OS and the pages are shared by all the
+// processes using the same file. The layout of pre-packed buffers depends on the MLAS kernels selected at runtime, so
+// the file is only used by the build of ONNX Runtime that wrote it on a CPU with the same instruction set extensions.
+// Otherwise the cache starts empty and the file is replaced by Save().
+//
+// The keys are computed by the caller and must identify everything that determines the content of the buffers:
+// the kernel, its attributes, the input index and the content of the weight.
+//
+// This class is not thread-safe.
+//
+class PrepackedWeightsFileCache {
+ public:
+  PrepackedWeightsFileCache(const Env& env, PathString file_path, const logging::Logger& logger);
+
+  // Returns the pre-packed weights stored for `key`, or nullptr.
+  // The buffers point into the mapped file and remain valid for the lifetime of the cache.
+  const PrePackedWeights* Find(const std::string& key) const;
+
+  // Adds pre-packed weights created in this session to be written by Save().
+  // The buffers are not copied and must remain valid until Save() returns.
+  void Add(const std::string& key, const PrePackedWeights& weights);
+
+  // Writes the file if weights were added since it was loaded.
+  // Several processes may use the same file. The writers are serialized by a lock next to the file, and the entries
+  // written by other processes in the meantime are kept, so the workers of a host converge on one file that has the
+  // weights of all of them. If another process holds the lock, the file is left to it and nothing is written.
+  Status Save();
+
+  size_t NumLoadedEntries() const noexcept { return loaded_.size(); }
+  size_t NumAddedEntries() const noexcept { return added_.size(); }
+  const PathString& FilePath() const noexcept { return file_path_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsFileCache);
+
+  using Entries = std::unordered_map<std::string, PrePackedWeights>;
+
+  // Maps the file and reads its entries, whose buffers point into `mapped_file`.
+  static Status Load(const Env& env, const PathString& file_path, Env::MappedMemoryPtr& mapped_file,
+                     Entries& entries);
+  Status Write(const Entries& on_disk_entries) const;
+
+  const Env& env_;
+  const PathString file_path_;
+  const logging::Logger& logger_;
+
+  // the buffers of these entries point into mapped_file_
+  Env::MappedMemoryPtr mapped_file_;
+  Entries loaded_;
+  // referring copies of weights owned by the kernels, the graphs or a shared container
+  Entries added_;
+};
+
+}  // namespace onnxruntime
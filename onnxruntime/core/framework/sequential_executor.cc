@@ -3,14 +3,21 @@
 
 #include "core/framework/sequential_executor.h"
 
+#include <algorithm>
 #include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
 #include <thread>
 #include <vector>
 #include <sstream>
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#include "core/common/narrow.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/node_cost.h"
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
@@ -138,6 +145,37 @@ static void CalculateTotalInputSizes(const OpKernelContextInternal* op_kernel_co
   input_type_shape = ss.str();
 }
 
+// Estimates the flops and bytes of the execution from its input and output tensors. Constant inputs are taken from
+// the kernel info like in CalculateTotalInputSizes.
+static NodeCost CalculateNodeCost(OpKernelContextInternal* op_kernel_context,
+                                  const onnxruntime::OpKernel* p_op_kernel) {
+  InlinedVector<const Tensor*> inputs;
+  const int input_count = op_kernel_context->InputCount();
+  inputs.reserve(static_cast<size_t>(input_count));
+  for (auto i = 0; i < input_count; i++) {
+    const Tensor* p_tensor = nullptr;
+    if (!p_op_kernel->Info().TryGetConstantInput(i, &p_tensor)) {
+      const OrtValue* p_input = op_kernel_context->GetInputMLValue(i);
+      if (p_input != nullptr && p_input->IsTensor() && p_input->IsAllocated()) {
+        p_tensor = &p_input->Get<Tensor>();
+      }
+    }
+    inputs.push_back(p_tensor);
+  }
+
+  InlinedVector<const Tensor*> outputs;
+  const int output_count = op_kernel_context->OutputCount();
+  outputs.reserve(static_cast<size_t>(output_count));
+  for (auto i = 0; i < output_count; i++) {
+    const OrtValue* p_output = op_kernel_context->GetOutputMLValue(i);
+    outputs.push_back(p_output != nullptr && p_output->IsTensor() && p_output->IsAllocated()
+                          ? &p_output->Get<Tensor>()
+                          : nullptr);
+  }
+
+  return EstimateNodeCost(p_op_kernel->Node(), inputs, outputs);
+}
+
 class KernelScope;
 
 #ifdef CONCURRENCY_VISUALIZER
@@ -180,6 +218,10 @@ class SessionScope {
       session_start_ = session_state.Profiler().Start();
     }
 
+    if (session_state_.Profiler().IsSamplingEnabled()) {
+      sampled_ = session_state_.Profiler().SampleRun();
+    }
+
     auto& logger = session_state_.Logger();
     VLOGS(logger, 0) << "Begin execution";
     const SequentialExecutionPlan& seq_exec_plan = *session_state_.GetExecutionPlan();
@@ -250,6 +292,8 @@ class SessionScope {
  private:
   const SessionState& session_state_;
   TimePoint session_start_;
+  // whether the kernel times of this execution are recorded by the sampling profiler
+  bool sampled_{false};
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   const ExecutionFrame& frame_;
   // Whether memory profiler need create events and flush to file.
@@ -346,6 +390,10 @@ class KernelScope {
                                input_activation_sizes_, input_parameter_sizes_,
                                node_name_, input_type_shape_);
     }
+
+    if (session_scope_.sampled_) {
+      sample_begin_time_ = std::chrono::high_resolution_clock::now();
+    }
   }
 
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelScope);
@@ -355,10 +403,22 @@ class KernelScope {
     node_compute_range_.End();
 #endif
 
+    if (session_scope_.sampled_) {
+      const auto& node = kernel_.Node();
+      session_state_.Profiler().RecordSample(
+          node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name(),
+          node.OpType(), TimeDiffMicroSeconds(sample_begin_time_));
+    }
+
     if (session_state_.Profiler().IsEnabled()) {
       auto& profiler = session_state_.Profiler();
       std::string output_type_shape_;
       CalculateTotalOutputSizes(&kernel_context_, total_output_sizes_, node_name_, output_type_shape_);
+      const NodeCost cost = CalculateNodeCost(&kernel_context_, &kernel_);
+      const long long duration_us = TimeDiffMicroSeconds(kernel_begin_time_);
+      // 1 GFLOP/s is 1e3 flops per us, and 1 GB/s 1e3 bytes per us
+      const double duration = static_cast<double>(std::max(duration_us, 1LL)) * 1e3;
+      profiler.RecordNodeCost(node_name_, kernel_.Node().OpType(), cost.flops, cost.bytes, duration_us);
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                      node_name_ + "_kernel_time",
                                      kernel_begin_time_,
@@ -372,6 +432,10 @@ class KernelScope {
                                          {"output_size", std::to_string(total_output_sizes_)},
                                          {"input_type_shape", input_type_shape_},
                                          {"output_type_shape", output_type_shape_},
+                                         {"flops", MakeString(cost.flops)},
+                                         {"bytes", MakeString(cost.bytes)},
+                                         {"gflops_per_s", MakeString(cost.flops / duration)},
+                                         {"gb_per_s", MakeString(cost.bytes / duration)},
                                          {"thread_scheduling_stats",
                                           concurrency::ThreadPool::StopProfiling(session_state_.GetThreadPool())},
                                      });
@@ -398,6 +462,7 @@ class KernelScope {
 
  private:
   TimePoint kernel_begin_time_;
+  TimePoint sample_begin_time_;
   SessionScope& session_scope_;
   const SessionState& session_state_;
   std::string node_name_;
@@ -422,6 +487,30 @@ class KernelScope {
 #endif
 };
 
+// Releases the inputs of the node after its kernel ran, or adds the node to the error message if the kernel failed.
+static Status CompleteKernel(StreamExecutionContext& ctx, const OpKernel& kernel, NodeIndex idx, size_t stream_idx,
+                             const Status& status) {
+  auto& logger = ctx.GetLogger();
+  if (!status.IsOK()) {
+    std::ostringstream ss;
+    const auto& node = kernel.Node();
+    ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
+       << "' Status Message: " << status.ErrorMessage();
+    // If the computation failed, we still can record the memory consumption
+#if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
+    ctx.GetSessionState().GetMemoryProfiler()->CreateEvents(
+        "dynamic activations_" + std::to_string(ctx.GetSessionState().GetMemoryProfiler()->GetMemoryInfo().GetIteration()),
+        ctx.GetSessionState().GetMemoryProfiler()->GetAndIncreasePid(), MemoryInfo::MapType::DynamicActivation, "", 0);
+#endif
+    const auto msg_string = ss.str();
+    LOGS(logger, ERROR) << msg_string;
+    return Status(status.Category(), status.Code(), msg_string);
+  }
+  ctx.RecycleNodeInputs(idx);
+  VLOGS(logger, 0) << "stream " << stream_idx << " launch kernel with idx " << idx;
+  return Status::OK();
+}
+
 onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                   NodeIndex idx,
                                   size_t stream_idx,
@@ -445,9 +534,24 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                      terminate_flag,
                                      ctx.GetDeviceStream(stream_idx));
   onnxruntime::Status status;
-  auto& logger = ctx.GetLogger();
   if (p_kernel->IsAsync()) {
-    ORT_THROW("Async Kernel Support is not implemented yet.");
+    // the caller can't be suspended, so wait for the kernel here
+    KernelScope kernel_scope(session_scope, kernel_ctx, *p_kernel);
+    ORT_TRY {
+      std::promise<Status> done;
+      auto result = done.get_future();
+      status = p_kernel->ComputeAsync(&kernel_ctx, [&done](Status kernel_status) {
+        done.set_value(std::move(kernel_status));
+      });
+      if (status.IsOK()) {
+        status = result.get();
+      }
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
   } else {
     KernelScope kernel_scope(session_scope, kernel_ctx, *p_kernel);
     ORT_TRY {
@@ -470,7 +574,7 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
         if (p_kernel->Node().OutputDefs().size() == 1) {
           cached_arg_name = p_kernel->Node().OutputDefs()[0]->Name();
           if (cache.get()->count(cached_arg_name)) {  // found arg in cache_
-            VLOGS(logger, 1) << "Found OrtValue in cache for arg: " << cached_arg_name;
+            VLOGS(ctx.GetLogger(), 1) << "Found OrtValue in cache for arg: " << cached_arg_name;
             reuse_cached_value = true;
           }
         }
@@ -490,23 +594,221 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
       });
     }
   }
+  return CompleteKernel(ctx, *p_kernel, idx, stream_idx, status);
+}
+
+namespace {
+// The state of an async kernel between ComputeAsync() and its done callback.
+struct AsyncKernelRun {
+  AsyncKernelRun(StreamExecutionContext& ctx, const OpKernel& kernel, size_t stream_idx, const bool& terminate_flag,
+                 SessionScope& session_scope)
+      : kernel_ctx(ctx.GetSessionState(), ctx.GetExecutionFrame(), kernel, ctx.GetLogger(), terminate_flag,
+                   ctx.GetDeviceStream(stream_idx)),
+        kernel_scope(session_scope, kernel_ctx, kernel) {}
+
+  OpKernelContextInternal kernel_ctx;
+  KernelScope kernel_scope;
+};
+}  // namespace
+
+onnxruntime::Status ExecuteKernelAsync(StreamExecutionContext& ctx,
+                                       NodeIndex idx,
+                                       size_t stream_idx,
+                                       const bool& terminate_flag,
+                                       SessionScope& session_scope,
+                                       std::function<void(Status)> on_done) {
+  const auto* p_kernel = ctx.GetSessionState().GetKernel(idx);
+  auto run = std::make_shared<AsyncKernelRun>(ctx, *p_kernel, stream_idx, terminate_flag, session_scope);
+  auto* kernel_ctx = &run->kernel_ctx;
+  OpKernel::DoneCallback done = [&ctx, p_kernel, idx, stream_idx, run = std::move(run),
+                                 on_done = std::move(on_done)](Status status) mutable {
+    // end the kernel scope, which records the profiling event, before the inputs are released
+    run.reset();
+    on_done(CompleteKernel(ctx, *p_kernel, idx, stream_idx, status));
+  };
+
+  Status status;
+  ORT_TRY {
+    status = p_kernel->ComputeAsync(kernel_ctx, std::move(done));
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+    });
+  }
   if (!status.IsOK()) {
-    std::ostringstream ss;
-    const auto& node = p_kernel->Node();
-    ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
-       << "' Status Message: " << status.ErrorMessage();
-    // If the computation failed, we still can record the memory consumption
-#if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
-    ctx.GetSessionState().GetMemoryProfiler()->CreateEvents(
-        "dynamic activations_" + std::to_string(ctx.GetSessionState().GetMemoryProfiler()->GetMemoryInfo().GetIteration()),
-        ctx.GetSessionState().GetMemoryProfiler()->GetAndIncreasePid(), MemoryInfo::MapType::DynamicActivation, "", 0);
+    return CompleteKernel(ctx, *p_kernel, idx, stream_idx, status);
+  }
+  return Status::OK();
+}
+
+
+namespace {
+// State shared by all the tasks of one ExecuteWorkStealing call.
+struct WorkStealingRun {
+  StreamExecutionContext& ctx;
+  const WorkStealingSchedule& schedule;
+  SessionScope& session_scope;
+  const bool& terminate_flag;
+  concurrency::ThreadPool* tp;
+  // number of upstream nodes that haven't completed yet. indexed by NodeIndex.
+  std::unique_ptr<std::atomic_int[]> pending;
+};
+
+// Runs the node and then keeps running nodes it made ready on the current thread, which keeps the producer's
+// outputs in cache. Additional ready nodes are pushed to the inter-op thread pool queues for idle workers to steal.
+void RunNodeAndReadyConsumers(WorkStealingRun& run, NodeIndex node_index) {
+  auto& ctx = run.ctx;
+  while (true) {
+    if (!ctx.TaskStatus().IsOK()) {
+      // already in bad status, terminate it
+      ctx.CompleteTask();
+      return;
+    }
+    if (run.terminate_flag) {
+      Status status_made = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+      ctx.SetStatus(status_made);
+      ctx.CompleteTask();
+      return;
+    }
+
+    Status status;
+#ifdef ENABLE_TRAINING
+    // legacy code required by ORTTrainer. Should be removed when ORTTrainer is removed
+    auto* node_to_execute = ctx.GetNodeToExecute();
+    const bool skip_node = node_to_execute && node_to_execute->count(node_index) == 0;
+#else
+    constexpr bool skip_node = false;
 #endif
-    const auto msg_string = ss.str();
-    LOGS(logger, ERROR) << msg_string;
-    return Status(status.Category(), status.Code(), msg_string);
+    if (!skip_node) {
+      ORT_TRY {
+        status = ExecuteKernel(ctx, node_index, run.schedule.node_stream[node_index], run.terminate_flag,
+                               run.session_scope);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        });
+      }
+    }
+    if (!status.IsOK()) {
+      ctx.SetStatus(status);
+      ctx.CompleteTask();
+      return;
+    }
+
+    std::optional<NodeIndex> next;
+    for (NodeIndex consumer : run.schedule.consumers[node_index]) {
+      if (run.pending[consumer].fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        continue;
+      }
+      if (!next.has_value()) {
+        next = consumer;
+        continue;
+      }
+      // add the task before the current one completes so WaitAll can't observe zero remaining tasks in between
+      ctx.AddTask();
+      concurrency::ThreadPool::Schedule(run.tp, [&run, consumer]() {
+        RunNodeAndReadyConsumers(run, consumer);
+      });
+    }
+
+    if (!next.has_value()) {
+      ctx.CompleteTask();
+      return;
+    }
+    node_index = *next;
   }
-  ctx.RecycleNodeInputs(idx);
-  VLOGS(logger, 0) << "stream " << stream_idx << " launch kernel with idx " << idx;
+}
+
+#ifdef ORT_ENABLE_STREAM
+bool UsesDeviceStreams(const DeviceStreamCollection* device_streams) {
+  if (device_streams) {
+    for (size_t i = 0; i < device_streams->NumStreams(); ++i) {
+      if (device_streams->GetStream(i)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+#endif
+}  // namespace
+
+onnxruntime::Status ExecuteWorkStealing(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
+                                        gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
+                                        std::vector<OrtValue>& fetches,
+                                        const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                        const logging::Logger& logger,
+#ifdef ORT_ENABLE_STREAM
+                                        const DeviceStreamCollection* device_streams,
+#endif
+                                        const bool& terminate_flag,
+                                        const bool only_execute_path_to_fetches) {
+  const auto* schedule = session_state.GetWorkStealingSchedule();
+  ORT_RETURN_IF(schedule == nullptr, "Work stealing execution is not available for this session.");
+  auto* execution_plan = session_state.GetExecutionPlan();
+  VLOGS(logger, 0) << "Number of root nodes: " << schedule->roots.size();
+
+  // each root starts a task. the task count is increased whenever a task hands off a ready node.
+  const auto num_root_tasks = narrow<int32_t>(schedule->roots.size());
+#ifdef ORT_ENABLE_STREAM
+  StreamExecutionContext ctx(session_state,
+                             num_root_tasks,
+                             execution_plan->notification_owners,
+                             execution_plan->num_barriers,
+                             device_streams,
+                             feed_mlvalue_idxs,
+                             feeds,
+                             fetch_mlvalue_idxs,
+                             fetches,
+                             fetch_allocators,
+                             logger,
+                             /*single_thread_mode*/ false);
+#else
+  ORT_UNUSED_PARAMETER(execution_plan);
+  StreamExecutionContext ctx(session_state,
+                             num_root_tasks,
+                             feed_mlvalue_idxs,
+                             feeds,
+                             fetch_mlvalue_idxs,
+                             fetches,
+                             fetch_allocators,
+                             logger,
+                             /*single_thread_mode*/ false);
+#endif
+#ifdef ENABLE_TRAINING
+  if (only_execute_path_to_fetches) {
+    auto* node_to_execute = session_state.GetToBeExecutedRange(fetch_mlvalue_idxs);
+    ctx.SetNodeToExecute(node_to_execute);
+  }
+#else
+  ORT_UNUSED_PARAMETER(only_execute_path_to_fetches);
+#endif
+
+  SessionScope session_scope(session_state, ctx.GetExecutionFrame());
+
+  const size_t num_node_slots = schedule->num_dependencies.size();
+  WorkStealingRun run{ctx, *schedule, session_scope, terminate_flag, session_state.GetInterOpThreadPool(),
+                      std::make_unique<std::atomic_int[]>(num_node_slots)};
+  for (size_t i = 0; i < num_node_slots; ++i) {
+    run.pending[i].store(schedule->num_dependencies[i], std::memory_order_relaxed);
+  }
+
+  // the calling thread works on the first root instead of idling in WaitAll
+  for (size_t i = 1; i < schedule->roots.size(); ++i) {
+    const NodeIndex root = schedule->roots[i];
+    concurrency::ThreadPool::Schedule(run.tp, [&run, root]() {
+      RunNodeAndReadyConsumers(run, root);
+    });
+  }
+  if (!schedule->roots.empty()) {
+    RunNodeAndReadyConsumers(run, schedule->roots.front());
+  }
+
+  ctx.WaitAll();
+  ORT_RETURN_IF_ERROR(ctx.TaskStatus());
+  ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GetOutputs(fetches));
   return Status::OK();
 }
 
@@ -521,6 +823,20 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                                    const bool& terminate_flag,
                                    const bool only_execute_path_to_fetches,
                                    bool single_thread_mode) {
+  // node level scheduling can't be combined with device streams as kernels on a stream must be launched in plan order
+  if (!single_thread_mode && session_state.GetWorkStealingSchedule() != nullptr
+#ifdef ORT_ENABLE_STREAM
+      && !UsesDeviceStreams(device_streams)
+#endif
+  ) {
+    return ExecuteWorkStealing(session_state, feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                               fetch_allocators, logger,
+#ifdef ORT_ENABLE_STREAM
+                               device_streams,
+#endif
+                               terminate_flag, only_execute_path_to_fetches);
+  }
+
   auto* execution_plan = session_state.GetExecutionPlan();
   VLOGS(logger, 0) << "Number of streams: " << execution_plan->execution_plan.size();
   int32_t valid_streams = 0;
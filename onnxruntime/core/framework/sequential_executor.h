@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <vector>
 #include "core/common/common.h"
 #include "core/common/status.h"
@@ -36,6 +37,16 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                   const bool& terminate_flag,
                                   SessionScope& session_scope);
 
+// Starts the async kernel of the node and returns without waiting for it. Once the kernel completed, the inputs of
+// the node are released and on_done is called with its status, on the thread that completed the kernel. If the
+// kernel fails to start, the error is returned and on_done is not called.
+onnxruntime::Status ExecuteKernelAsync(StreamExecutionContext& ctx,
+                                       NodeIndex idx,
+                                       size_t stream_idx,
+                                       const bool& terminate_flag,
+                                       SessionScope& session_scope,
+                                       std::function<void(Status)> on_done);
+
 onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
                                    gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
                                    std::vector<OrtValue>& fetches,
@@ -48,6 +59,19 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                                    const bool only_execute_path_to_fetches,
                                    bool single_thread_mode);
 
+// Executes each node as soon as all of its upstream nodes completed, using the WorkStealingSchedule of the session
+// state. ExecuteThePlan dispatches here for ExecutionMode::ORT_PARALLEL_WORK_STEALING when possible.
+onnxruntime::Status ExecuteWorkStealing(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
+                                        gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
+                                        std::vector<OrtValue>& fetches,
+                                        const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                                        const logging::Logger& logger,
+#ifdef ORT_ENABLE_STREAM
+                                        const DeviceStreamCollection* device_streams,
+#endif
+                                        const bool& terminate_flag,
+                                        const bool only_execute_path_to_fetches);
+
 #ifdef ENABLE_TRAINING
 onnxruntime::Status PartialExecuteThePlan(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
                                           std::vector<OrtValue>& feeds, gsl::span<const int> fetch_mlvalue_idxs,
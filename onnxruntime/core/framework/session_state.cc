@@ -3,13 +3,19 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
+#include <iomanip>
+#include <limits>
 #include <sstream>
 
 #include <mutex>
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
+#include "core/common/string_utils.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
@@ -90,6 +96,15 @@ SessionState::SessionState(Graph& graph,
 {
   enable_mem_pattern_ = sess_options_.enable_mem_pattern &&
                         sess_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
+
+  MemoryPatternCache::Options mem_pattern_cache_options;
+  mem_pattern_cache_options.shape_bucket_size = ParseStringWithClassicLocale<int64_t>(
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryPatternShapeBucketSize, "0"));
+  mem_pattern_cache_options.max_entries = ParseStringWithClassicLocale<size_t>(
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryPatternCacheMaxEntries, "0"));
+  ORT_ENFORCE(mem_pattern_cache_options.shape_bucket_size >= 0,
+              kOrtSessionOptionsMemoryPatternShapeBucketSize, " must not be negative.");
+  mem_pattern_cache_.SetOptions(mem_pattern_cache_options);
   if (parent_allocators) {
     allocators_ = parent_allocators;
   } else {
@@ -124,7 +139,10 @@ void SessionState::UpdateAllocatorsWithEnvAllocators(const std::vector<Allocator
 }
 
 void SessionState::CreateGraphInfo(bool save_prepacked_on) {
-  graph_.ConstructPrepackedSharedContainerAndSetMode(save_prepacked_on);
+  // the pre-packed weights container of the Graph belongs to the session the kernels were created by
+  if (kernel_source_ == nullptr) {
+    graph_.ConstructPrepackedSharedContainerAndSetMode(save_prepacked_on);
+  }
 
   graph_viewer_.emplace(graph_);
   // use graph_viewer_ to initialize ort_value_name_idx_map_
@@ -403,6 +421,78 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
   return ss_1.str();
 }
 
+static Status KernelUseCachedPrePackedBuffers(OpKernel& kernel, const Tensor& tensor, int input_idx,
+                                              const PrePackedWeights& prepacked_weights,
+                                              /*out*/ bool& used_cached_buffers) {
+  std::vector<BufferUniquePtr> cached_prepacked_buffers;
+  cached_prepacked_buffers.reserve(prepacked_weights.buffers_.size());
+
+  for (const auto& prepacked_buffer : prepacked_weights.buffers_) {
+    // BufferDeleter is nullptr because the buffers are owned by the pre-packed weights cache
+    cached_prepacked_buffers.emplace_back(prepacked_buffer.get(), BufferDeleter(nullptr));
+  }
+
+  return kernel.UseCachedPrePackedBuffers(tensor, input_idx, cached_prepacked_buffers,
+                                          prepacked_weights.buffer_sizes_, used_cached_buffers);
+}
+
+// PrePack() isn't called for the weights found in the pre-packed weights cache file, so the key contains everything
+// that determines its result: the kernel, the node's attributes, the MLAS session options, the input index and the
+// content of the tensor. Returns an empty key if the tensor can't be cached.
+static std::string GenerateKeyForPrepackedWeightsFile(const Node& node, int input_idx, const Tensor& tensor,
+                                                      const ConfigOptions& config_options) {
+  if (tensor.IsDataTypeString()) {
+    return {};
+  }
+
+  uint32_t hash[4] = {0, 0, 0, 0};
+  auto hash_bytes = [&hash](const void* data, size_t length) {
+    // MurmurHash3 takes an int length
+    const auto* bytes = static_cast<const char*>(data);
+    while (length > 0) {
+      const size_t chunk = std::min(length, static_cast<size_t>(std::numeric_limits<int>::max()));
+      MurmurHash3::x86_128(bytes, static_cast<int>(chunk), hash[0], &hash);
+      bytes += chunk;
+      length -= chunk;
+    }
+  };
+
+  hash_bytes(tensor.DataRaw(), tensor.SizeInBytes());
+
+  // the attributes are unordered
+  InlinedVector<const std::pair<const std::string, ONNX_NAMESPACE::AttributeProto>*> attributes;
+  for (const auto& attribute : node.GetAttributes()) {
+    if (attribute.second.type() != ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPH &&
+        attribute.second.type() != ONNX_NAMESPACE::AttributeProto_AttributeType_GRAPHS) {
+      attributes.push_back(&attribute);
+    }
+  }
+  std::sort(attributes.begin(), attributes.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+  for (const auto* attribute : attributes) {
+    const std::string serialized = attribute->second.SerializeAsString();
+    hash_bytes(serialized.data(), serialized.size());
+  }
+
+  std::ostringstream ss;
+  ss << node.Domain() << ":" << node.OpType() << ":" << node.SinceVersion() << "|" << node.GetExecutionProviderType()
+     << "|" << input_idx << "|" << tensor.GetElementType() << "|" << tensor.Shape().ToString() << "|"
+     << std::hex << std::setfill('0') << std::setw(8) << hash[0] << std::setw(8) << hash[1] << std::setw(8) << hash[2]
+     << std::setw(8) << hash[3] << std::dec;
+
+  std::vector<std::pair<std::string, std::string>> mlas_options;
+  for (const auto& [key, value] : config_options.configurations) {
+    if (key.rfind("mlas.", 0) == 0) {
+      mlas_options.emplace_back(key, value);
+    }
+  }
+  std::sort(mlas_options.begin(), mlas_options.end());
+  for (const auto& [key, value] : mlas_options) {
+    ss << "|" << key << "=" << value;
+  }
+
+  return ss.str();
+}
+
 Status SessionState::PrepackConstantInitializedTensors(
     InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
     const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
@@ -430,9 +520,29 @@ Status SessionState::PrepackConstantInitializedTensors(
                 auto iter = initializers_to_share_map.find(input_name);
                 bool is_shared_initializer = (iter != initializers_to_share_map.end());
 
-                // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
-                if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
+                // Look up the pre-packed weights cache file first, PrePack() isn't needed if the kernel can restore
+                // its state from the cached buffers. The file is memory mapped, so its pages are shared by all the
+                // sessions and processes using it, which is why it takes precedence over the shared container.
+                PrepackedWeightsFileCache* file_cache = GetPrepackedWeightsFileCache();
+                std::string file_cache_key;
+                if (file_cache != nullptr && !prepacked_for_graph->IsSaveModeOn() &&
                     node.GetExecutionProviderType() == kCpuExecutionProvider) {
+                  file_cache_key = GenerateKeyForPrepackedWeightsFile(node, input_idx, const_initialized_tensor,
+                                                                      sess_options_.config_options);
+                  if (const auto* cached = file_cache_key.empty() ? nullptr : file_cache->Find(file_cache_key)) {
+                    ORT_RETURN_IF_ERROR(KernelUseCachedPrePackedBuffers(*kernel, const_initialized_tensor,
+                                                                        input_idx, *cached, is_packed));
+                    if (is_packed) {
+                      ++used_cached_pre_packed_weights_counter_;
+                    }
+                  }
+                }
+
+                if (is_packed) {
+                  // restored from the pre-packed weights cache file
+                } else if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
+                           node.GetExecutionProviderType() == kCpuExecutionProvider) {
+                  // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
                   // caching of pre-packed weights' turned ON
 
                   AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
@@ -486,6 +596,10 @@ Status SessionState::PrepackConstantInitializedTensors(
 
                       ++used_shared_pre_packed_weights_counter_;
 
+                      if (!file_cache_key.empty()) {
+                        file_cache->Add(file_cache_key, prepacked_shared);
+                      }
+
                       // Write references to what is stored in the shared container
                       // and release memory mapped entries this container may have loaded from disk
                       std::ignore = prepacked_for_graph->ReplaceWithReferenceIfSaving(input_name,
@@ -526,6 +640,10 @@ Status SessionState::PrepackConstantInitializedTensors(
                       ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
                                                                           shared_prepacked,
                                                                           node.Name()));
+
+                      if (!file_cache_key.empty()) {
+                        file_cache->Add(file_cache_key, shared_prepacked);
+                      }
                     }
                   }
 
@@ -573,6 +691,10 @@ Status SessionState::PrepackConstantInitializedTensors(
                     ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
                                                                         *weights_to_use,
                                                                         node.Name()));
+
+                    if (!file_cache_key.empty()) {
+                      file_cache->Add(file_cache_key, *weights_to_use);
+                    }
                   }
                 }
 
@@ -616,15 +738,6 @@ Status SessionState::PrepackConstantInitializedTensors(
   }
 }
 
-static int64_t
-CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
-  for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
-  }
-  return key;
-}
-
 #ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
@@ -859,26 +972,22 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+// MemoryPatternGroup is cached. It is only replaced if a pattern learned from larger feeds
+// in the same shape bucket is added, and callers share ownership of the entry they got.
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>>& out_inferred_shapes) const {
   out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-  std::lock_guard<std::mutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+  MemoryPatternCache::Entry entry;
+  if (!mem_pattern_cache_.Find(tensor_inputs, entry)) {
 #ifdef ENABLE_TRAINING
     MemoryPatternGroup mem_patterns;
-    InlinedHashMap<int, TensorShape> inferred_shapes;
-    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
+    auto inferred_shapes = std::make_unique<InlinedHashMap<int, TensorShape>>();
+    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, *inferred_shapes).IsOK()) {
+      entry = mem_pattern_cache_.Insert(tensor_inputs, std::move(mem_patterns), std::move(inferred_shapes));
+      out_inferred_shapes = entry.inferred_shapes;
+      return entry.patterns;
     }
 #else
     ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
@@ -886,11 +995,8 @@ const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
     return nullptr;
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
-  }
-  return &it->second;
+  out_inferred_shapes = entry.inferred_shapes;
+  return entry.patterns;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -941,14 +1047,82 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-
-  std::lock_guard<std::mutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  // Does not update if present, unless the new pattern was learned from larger feeds in the same shape bucket
+  mem_pattern_cache_.Insert(tensor_inputs, std::move(mem_patterns));
   return Status::OK();
 }
 
+bool SessionState::AcquireMemoryPatternBuffers(const MemoryPatternGroup& mem_patterns,
+                                               InlinedHashMap<OrtDevice, BufferUniquePtr>& buffers) const {
+  std::lock_guard<std::mutex> lock(mem_pattern_buffers_mutex_);
+  auto it = std::find_if(mem_pattern_buffers_.begin(), mem_pattern_buffers_.end(),
+                         [&mem_patterns](const MemoryPatternBuffers& entry) {
+                           return entry.mem_patterns.get() == &mem_patterns;
+                         });
+  if (it == mem_pattern_buffers_.end()) {
+    return false;
+  }
+
+  buffers = std::move(it->buffers);
+  mem_pattern_buffers_.erase(it);
+  return true;
+}
+
+void SessionState::ReleaseMemoryPatternBuffers(std::shared_ptr<const MemoryPatternGroup> mem_patterns,
+                                               InlinedHashMap<OrtDevice, BufferUniquePtr>&& buffers) const {
+  // one entry per concurrent execution of the subgraph is enough to avoid the allocations in a loop
+  constexpr size_t kMaxMemoryPatternBuffers = 4;
+
+  if (parent_ == nullptr ||
+      std::any_of(buffers.begin(), buffers.end(),
+                  [](const auto& entry) { return entry.first.Type() != OrtDevice::CPU; })) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mem_pattern_buffers_mutex_);
+  if (mem_pattern_buffers_.size() == kMaxMemoryPatternBuffers) {
+    mem_pattern_buffers_.erase(mem_pattern_buffers_.begin());
+  }
+
+  mem_pattern_buffers_.push_back({std::move(mem_patterns), std::move(buffers)});
+}
+
+std::shared_ptr<FrameObjectArena> SessionState::AcquireFrameObjectArena() const {
+  {
+    std::lock_guard<std::mutex> lock(frame_object_arenas_mutex_);
+    auto it = std::find_if(frame_object_arenas_.begin(), frame_object_arenas_.end(),
+                           [](const std::shared_ptr<FrameObjectArena>& arena) { return arena.use_count() == 1; });
+    if (it != frame_object_arenas_.end()) {
+      auto arena = std::move(*it);
+      frame_object_arenas_.erase(it);
+      arena->Reset();
+      return arena;
+    }
+  }
+
+  return std::make_shared<FrameObjectArena>();
+}
+
+void SessionState::ReleaseFrameObjectArena(std::shared_ptr<FrameObjectArena> arena) const {
+  // one entry per concurrent execution is enough
+  constexpr size_t kMaxFrameObjectArenas = 4;
+
+  std::lock_guard<std::mutex> lock(frame_object_arenas_mutex_);
+  if (frame_object_arenas_.size() == kMaxFrameObjectArenas) {
+    frame_object_arenas_.erase(frame_object_arenas_.begin());
+  }
+
+  frame_object_arenas_.push_back(std::move(arena));
+}
+
+Status SessionState::LoadMemoryPatternCache(const PathString& file_path) const {
+  return mem_pattern_cache_.Load(file_path, ort_value_name_idx_map_);
+}
+
+Status SessionState::SaveMemoryPatternCache(const PathString& file_path) const {
+  return mem_pattern_cache_.Save(file_path, ort_value_name_idx_map_);
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 bool SessionState::GetEnableMemoryReuse() const { return sess_options_.enable_mem_reuse; }
@@ -1281,14 +1455,86 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
   ORT_RETURN_IF_ERROR(VerifyEachNodeIsAssignedToAnEp(graph_, logger_, execution_providers_));
   ORT_RETURN_IF_ERROR(PopulateKernelCreateInfo(kernel_registry_manager, saving_ort_format));
 
+  const std::string prepacked_weights_cache_file =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsPrePackedWeightsCacheFile, "");
+  if (!prepacked_weights_cache_file.empty()) {
+    prepacked_weights_file_cache_ = std::make_unique<PrepackedWeightsFileCache>(
+        Env::Default(), ToPathString(prepacked_weights_cache_file), logger_);
+  }
+
   InlinedHashMap<std::string, size_t> constant_initializers_use_count;
   ComputeConstantInitializerUseCount(graph_, constant_initializers_use_count);
-  return FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
-                                  remove_initializers,
-                                  GetSaveModeForPrepacks(!remove_initializers, saving_ort_format),
+  ORT_RETURN_IF_ERROR(FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
+                                               remove_initializers,
+                                               GetSaveModeForPrepacks(!remove_initializers, saving_ort_format),
+                                               constant_initializers_use_count));
+
+  if (prepacked_weights_file_cache_) {
+    // the session can be used without the file, so failing to write it is not an error
+    auto status = prepacked_weights_file_cache_->Save();
+    if (!status.IsOK()) {
+      LOGS(logger_, WARNING) << "Failed to save the pre-packed weights cache: " << status.ErrorMessage();
+    }
+  }
+
+  return Status::OK();
+}
+
+Status SessionState::FinalizeSessionStateFromSource(const SessionState& source,
+                                                    const KernelRegistryManager& kernel_registry_manager) {
+  ORT_RETURN_IF_NOT(&source.graph_ == &graph_, "The source SessionState must be for the same Graph.");
+  ORT_RETURN_IF_NOT(source.graph_viewer_.has_value(), "The source SessionState has not been finalized.");
+
+  ORT_RETURN_IF_ERROR(CreateSubgraphSessionState());
+  ORT_RETURN_IF_ERROR(SetKernelSource(source));
+
+  // nothing is pre-packed, so the use counts are not needed
+  InlinedHashMap<std::string, size_t> constant_initializers_use_count;
+  return FinalizeSessionStateImpl(ORT_TSTR(""), kernel_registry_manager, nullptr, sess_options_,
+                                  /*remove_initializers*/ false, /*save_prepacked_initializers*/ false,
                                   constant_initializers_use_count);
 }
 
+Status SessionState::SetKernelSource(const SessionState& source) {
+  kernel_source_ = &source;
+  kernel_create_info_map_ = source.kernel_create_info_map_;
+
+  for (auto& [node_index, attr_to_subgraph_session_state] : subgraph_session_states_) {
+    for (auto& [attr_name, subgraph_session_state] : attr_to_subgraph_session_state) {
+      const auto* source_subgraph_session_state = source.GetSubgraphSessionState(node_index, attr_name);
+      ORT_RETURN_IF(source_subgraph_session_state == nullptr,
+                    "The source SessionState has no session state for the subgraph in attribute ", attr_name,
+                    " of node ", node_index);
+      ORT_RETURN_IF_ERROR(subgraph_session_state->SetKernelSource(*source_subgraph_session_state));
+    }
+  }
+
+  return Status::OK();
+}
+
+Status SessionState::ShareKernelSourceInitializers() {
+  // a subgraph of the source may not have been executed yet if its initialization was deferred
+  ORT_RETURN_IF_ERROR(kernel_source_->FinalizeDeferredInitialization());
+
+  // the OrtValue instances share the buffers of the source, which keeps ownership of them
+  initialized_tensors_ = kernel_source_->initialized_tensors_;
+  constant_initialized_tensors_ = kernel_source_->constant_initialized_tensors_;
+#if !defined(DISABLE_SPARSE_TENSORS)
+  sparse_initialized_tensors_ = kernel_source_->sparse_initialized_tensors_;
+#endif
+
+  node_index_info_.emplace(*graph_viewer_, ort_value_name_idx_map_);
+  return Status::OK();
+}
+
+PrepackedWeightsFileCache* SessionState::GetPrepackedWeightsFileCache() const {
+  const SessionState* root = this;
+  while (root->parent_ != nullptr) {
+    root = root->parent_;
+  }
+  return root->prepacked_weights_file_cache_.get();
+}
+
 bool SessionState::GetSaveModeForPrepacks(bool saving_model, bool saving_ort_format) {
   bool save_prepacked_constant_initializers =
       sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsSavePrePackedConstantInitializers,
@@ -1443,7 +1689,8 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                               bool save_prepacked_initializers,
                                               InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                               const InlinedHashMap<OrtValueName, OrtDevice>& outer_scope_node_arg_to_location_map,
-                                              bool graph_info_already_created) {
+                                              bool graph_info_already_created,
+                                              bool defer_initialization) {
   if (!graph_info_already_created) {
     CreateGraphInfo(save_prepacked_initializers);
   }
@@ -1497,9 +1744,19 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
+  // values recomputed to keep a memory budget only help if they run right before their consumers, which the memory
+  // aware order does given that they free nothing
+  const bool enable_memory_aware_order =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryAwareExecutionOrder, "0") == "1" ||
+      ParseStringWithClassicLocale<size_t>(session_options.config_options.GetConfigOrDefault(
+          kOrtSessionOptionsActivationMemoryBudgetInBytes, "0")) > 0;
+  const bool allow_inplace_on_graph_inputs =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsAllowInplaceOnGraphInputs, "0") == "1";
   SequentialPlannerContext context(session_options.execution_mode,
                                    session_options.execution_order,
-                                   session_options.enable_mem_reuse);
+                                   session_options.enable_mem_reuse,
+                                   enable_memory_aware_order,
+                                   allow_inplace_on_graph_inputs);
 
 #ifdef _WIN32
 
@@ -1528,6 +1785,14 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                               p_seq_exec_plan_);
   ORT_RETURN_IF_ERROR(status);
 
+  if (session_options.execution_mode == ExecutionMode::ORT_PARALLEL_WORK_STEALING && parent_node == nullptr) {
+    work_stealing_schedule_ = WorkStealingSchedule::Create(*p_seq_exec_plan_, *graph_viewer_);
+    if (!work_stealing_schedule_.has_value()) {
+      LOGS(logger_, INFO) << "The execution plan requires cross-stream synchronization. "
+                          << "Falling back to stream based parallel execution.";
+    }
+  }
+
   // Record the allocation plan
 
   // Uncomment the below to dump the allocation plan to std::cout
@@ -1537,6 +1802,112 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   GetMemoryProfiler()->Init(GetExecutionPlan(), GetOrtValueNameIdxMap());
 #endif
 
+#ifdef ORT_ENABLE_STREAM
+  // set the has_device_stream_enabled_ep_ flag
+  has_device_stream_enabled_ep_ = false;
+  if (p_seq_exec_plan_.has_value()) {
+    auto& execution_plan = (*p_seq_exec_plan_).execution_plan;
+    for (size_t i = 0; i < execution_plan.size(); ++i) {
+      auto& logic_stream = execution_plan[i];
+      if (logic_stream->steps_.size() > 0) {
+        auto create_stream_fn = GetStreamHandleRegistryInstance().GetCreateStreamFn(logic_stream->device_.Type());
+        if (create_stream_fn) {
+          has_device_stream_enabled_ep_ = true;
+        }
+      }
+    }
+  }
+#endif
+
+  if (kernel_source_ != nullptr) {
+    ORT_RETURN_IF_ERROR(ShareKernelSourceInitializers());
+  } else if (defer_initialization) {
+    deferred_initialization_.emplace(
+        DeferredInitializationInfo{graph_location, &kernel_registry_manager, session_options, remove_initializers});
+  } else {
+    ORT_RETURN_IF_ERROR(CreateKernelsAndInitializers(graph_location, kernel_registry_manager, session_options,
+                                                     remove_initializers, constant_initializers_use_count));
+  }
+
+  ORT_RETURN_IF_ERROR(
+      session_state_utils::SaveInputOutputNamesToNodeMapping(*graph_viewer_, *this, valid_outer_scope_node_args));
+
+  // Need to recurse into subgraph session state instances to finalize them and add the execution info
+
+  // Currently all subgraphs need to be executed using the sequential EP due to potential deadlock with the current
+  // parallel executor implementation
+  SessionOptions subgraph_session_options(session_options);
+  subgraph_session_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+
+  // The pre-packed weights that are saved with the model must exist once the session is initialized.
+  // The kernels of a clone already exist.
+  const bool lazy_subgraph_initialization =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsLazySubgraphInitialization, "0") == "1" &&
+      !save_prepacked_initializers && kernel_source_ == nullptr;
+  const std::string warmup_nodes_config =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsLazySubgraphWarmupNodes, "");
+  const auto warmup_nodes = utils::SplitString(warmup_nodes_config, ",");
+
+  for (const auto& node_to_subgraph_ss : subgraph_session_states_) {
+    Node& node = *graph_.GetNode(node_to_subgraph_ss.first);
+
+    // The subgraphs of a node in a deferred subgraph are deferred too, as the kernel of the node doesn't exist yet.
+    // Otherwise the node must be in the warmup list, or in a subgraph of a node in the warmup list, to be initialized
+    // now.
+    const bool defer_subgraph_initialization =
+        lazy_subgraph_initialization &&
+        (defer_initialization ||
+         (parent_node == nullptr &&
+          std::find(warmup_nodes.begin(), warmup_nodes.end(), node.Name()) == warmup_nodes.end()));
+
+    for (const auto& attr_subgraph_pair : node.GetAttributeNameToMutableSubgraphMap()) {
+      auto& attr_name = attr_subgraph_pair.first;
+      auto entry = node_to_subgraph_ss.second.find(attr_name);
+      // CreateSubgraphSessionState should ensure all these entries are created
+      ORT_ENFORCE(entry != node_to_subgraph_ss.second.cend(),
+                  "Missing session state for subgraph. Node:'", node.Name(),
+                  "' OpType:", node.OpType(), " Index:", node.Index(), " Attribute:", attr_name);
+
+      SessionState& subgraph_session_state = *entry->second;
+
+      // recurse
+
+      // We need to create graph info for the subgraphs because information accumulated there
+      // is used in OuterScopeNodeArgLocationAccumulator()
+      subgraph_session_state.CreateGraphInfo(save_prepacked_initializers);
+
+      InlinedHashMap<OrtValueName, OrtDevice> subgraph_outer_scope_node_arg_to_location_map;
+      ORT_RETURN_IF_ERROR(OuterScopeNodeArgLocationAccumulator(*p_seq_exec_plan_, GetOrtValueNameIdxMap(),
+                                                               node,
+                                                               subgraph_session_state.GetGraphViewer(),
+                                                               subgraph_outer_scope_node_arg_to_location_map));
+
+      ORT_RETURN_IF_ERROR(subgraph_session_state.FinalizeSessionStateImpl(
+          graph_location, kernel_registry_manager, &node, subgraph_session_options, remove_initializers,
+          save_prepacked_initializers,
+          constant_initializers_use_count, subgraph_outer_scope_node_arg_to_location_map, true,
+          defer_subgraph_initialization));
+
+      // the kernel of the node is created by FinalizeDeferredInitialization if this graph is deferred, and the
+      // kernel of the source was set up already when sharing kernels.
+      if (!defer_initialization && kernel_source_ == nullptr) {
+        ORT_RETURN_IF_ERROR(SetupSubgraphExecutionInfo(node, attr_name, subgraph_session_state));
+      }
+    }
+
+    // TODO: Once the subgraph session states have been finalized, can we go back and plan the location of implicit
+    // inputs that are fed through as graph inputs in the graph level holding the subgraphs ? Ideally the planned
+    // locations for these would be the locations they are explicitly consumed on in nested subgraphs.
+  }
+
+  return Status::OK();
+}
+
+Status SessionState::CreateKernelsAndInitializers(const std::basic_string<PATH_CHAR_TYPE>& graph_location,
+                                                  const KernelRegistryManager& kernel_registry_manager,
+                                                  const SessionOptions& session_options,
+                                                  bool remove_initializers,
+                                                  InlinedHashMap<std::string, size_t>& constant_initializers_use_count) {
   // Note: For Training Prepacking should be always disabled.
   // For inference it is enabled by default, but users can choose to disable it via session options.
   const bool disable_prepacking =
@@ -1577,22 +1948,11 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
 
 #endif
 
-#ifdef ORT_ENABLE_STREAM
-  // set the has_device_stream_enabled_ep_ flag
-  has_device_stream_enabled_ep_ = false;
-  if (p_seq_exec_plan_.has_value()) {
-    auto& execution_plan = (*p_seq_exec_plan_).execution_plan;
-    for (size_t i = 0; i < execution_plan.size(); ++i) {
-      auto& logic_stream = execution_plan[i];
-      if (logic_stream->steps_.size() > 0) {
-        auto create_stream_fn = GetStreamHandleRegistryInstance().GetCreateStreamFn(logic_stream->device_.Type());
-        if (create_stream_fn) {
-          has_device_stream_enabled_ep_ = true;
-        }
-      }
-    }
+  const bool profiling_enabled = profiler_.IsEnabled();
+  TimePoint phase_start;
+  if (profiling_enabled) {
+    phase_start = profiler_.Start();
   }
-#endif
 
   ORT_RETURN_IF_ERROR(session_state_utils::SaveInitializedTensors(
       Env::Default(), graph_location, *graph_viewer_,
@@ -1607,7 +1967,7 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
         return Status::OK();
       },
       logger_, data_transfer_mgr_, external_data_loader_mgr_, *p_seq_exec_plan_, session_options,
-      memory_profile_func, name_to_buffered_tensor_, graph_.GetPrepacked()));
+      memory_profile_func, name_to_buffered_tensor_, graph_.GetPrepacked(), GetThreadPool(), &profiler_));
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Record Weight allocation info on device
@@ -1621,68 +1981,98 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
     CleanInitializedTensorsFromGraph();
   }
 
+  if (profiling_enabled) {
+    profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "initializer_loading", phase_start,
+                                    {{"phase", "initializer_loading"}});
+    phase_start = profiler_.Start();
+  }
+
   ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
 
+  if (profiling_enabled) {
+    profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "kernel_creation", phase_start,
+                                    {{"phase", "kernel_creation"}});
+  }
+
   if (!disable_prepacking) {
+    if (profiling_enabled) {
+      phase_start = profiler_.Start();
+    }
+
     ORT_RETURN_IF_ERROR(PrepackConstantInitializedTensors(constant_initializers_use_count,
                                                           session_options.initializers_to_share_map));
-  }
 
-  ORT_RETURN_IF_ERROR(
-      session_state_utils::SaveInputOutputNamesToNodeMapping(*graph_viewer_, *this, valid_outer_scope_node_args));
+    if (profiling_enabled) {
+      profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "prepacking", phase_start,
+                                      {{"phase", "prepacking"}});
+    }
+  }
 
-  // Need to recurse into subgraph session state instances to finalize them and add the execution info
+  return Status::OK();
+}
 
-  // Currently all subgraphs need to be executed using the sequential EP due to potential deadlock with the current
-  // parallel executor implementation
-  SessionOptions subgraph_session_options(session_options);
-  subgraph_session_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+Status SessionState::SetupSubgraphExecutionInfo(const Node& node, const std::string& attribute_name,
+                                                SessionState& subgraph_session_state) {
+  // setup all the info for handling the feeds and fetches used in subgraph execution
+  auto* p_op_kernel = GetMutableKernel(node.Index());
+  ORT_ENFORCE(p_op_kernel);
 
-  for (const auto& node_to_subgraph_ss : subgraph_session_states_) {
-    Node& node = *graph_.GetNode(node_to_subgraph_ss.first);
+  // Downcast is safe, since only control flow nodes have subgraphs
+  // (node.GetAttributeNameToMutableSubgraphMap() is non-empty)
+  auto& control_flow_kernel = static_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
+  return control_flow_kernel.SetupSubgraphExecutionInfo(*this, attribute_name, subgraph_session_state);
+}
 
-    for (const auto& attr_subgraph_pair : node.GetAttributeNameToMutableSubgraphMap()) {
-      auto& attr_name = attr_subgraph_pair.first;
-      auto entry = node_to_subgraph_ss.second.find(attr_name);
-      // CreateSubgraphSessionState should ensure all these entries are created
-      ORT_ENFORCE(entry != node_to_subgraph_ss.second.cend(),
-                  "Missing session state for subgraph. Node:'", node.Name(),
-                  "' OpType:", node.OpType(), " Index:", node.Index(), " Attribute:", attr_name);
+Status SessionState::FinalizeDeferredInitialization() const {
+  if (!deferred_initialization_.has_value() || deferred_initialization_done_.load(std::memory_order_acquire)) {
+    return Status::OK();
+  }
 
-      SessionState& subgraph_session_state = *entry->second;
+  const SessionState* root = this;
+  while (root->parent_ != nullptr) {
+    root = root->parent_;
+  }
 
-      // recurse
+  std::lock_guard<std::mutex> lock(root->deferred_initialization_mutex_);
+  if (deferred_initialization_done_.load(std::memory_order_relaxed)) {
+    return Status::OK();
+  }
 
-      // We need to create graph info for the subgraphs because information accumulated there
-      // is used in OuterScopeNodeArgLocationAccumulator()
-      subgraph_session_state.CreateGraphInfo(save_prepacked_initializers);
+  // the subgraph is not executed before this completes, so it's the only user of this instance
+  ORT_RETURN_IF_ERROR(const_cast<SessionState*>(this)->FinalizeDeferredInitializationImpl());
+  deferred_initialization_done_.store(true, std::memory_order_release);
+  return Status::OK();
+}
 
-      InlinedHashMap<OrtValueName, OrtDevice> subgraph_outer_scope_node_arg_to_location_map;
-      ORT_RETURN_IF_ERROR(OuterScopeNodeArgLocationAccumulator(*p_seq_exec_plan_, GetOrtValueNameIdxMap(),
-                                                               node,
-                                                               subgraph_session_state.GetGraphViewer(),
-                                                               subgraph_outer_scope_node_arg_to_location_map));
+Status SessionState::FinalizeDeferredInitializationImpl() {
+  const auto& info = *deferred_initialization_;
 
-      ORT_RETURN_IF_ERROR(subgraph_session_state.FinalizeSessionStateImpl(
-          graph_location, kernel_registry_manager, &node, subgraph_session_options, remove_initializers,
-          save_prepacked_initializers,
-          constant_initializers_use_count, subgraph_outer_scope_node_arg_to_location_map, true));
+  // Only the initializers of this graph can be released once pre-packed. The outer scope values are owned by session
+  // states that may be in use by a concurrent execution. As the initializers of this graph can only be used by this
+  // graph and its subgraphs, counting the uses here is enough.
+  InlinedHashMap<std::string, size_t> constant_initializers_use_count;
+  ComputeConstantInitializerUseCount(graph_, constant_initializers_use_count);
+  for (auto it = constant_initializers_use_count.begin(); it != constant_initializers_use_count.end();) {
+    if (graph_.GetConstantInitializer(it->first, false /*check_outer_scope*/) == nullptr) {
+      constant_initializers_use_count.erase(it++);
+    } else {
+      ++it;
+    }
+  }
 
-      // setup all the info for handling the feeds and fetches used in subgraph execution
-      auto* p_op_kernel = GetMutableKernel(node.Index());
-      ORT_ENFORCE(p_op_kernel);
+  ORT_RETURN_IF_ERROR(CreateKernelsAndInitializers(info.graph_location, *info.kernel_registry_manager,
+                                                   info.session_options, info.remove_initializers,
+                                                   constant_initializers_use_count));
 
-      // Downcast is safe, since only control flow nodes have subgraphs
-      // (node.GetAttributeNameToMutableSubgraphMap() is non-empty)
-      auto& control_flow_kernel = static_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
-      ORT_RETURN_IF_ERROR(control_flow_kernel.SetupSubgraphExecutionInfo(*this, attr_name, subgraph_session_state));
+  for (const auto& node_to_subgraph_ss : subgraph_session_states_) {
+    const Node& node = *graph_.GetNode(node_to_subgraph_ss.first);
+    for (const auto& [attr_name, subgraph_session_state] : node_to_subgraph_ss.second) {
+      ORT_RETURN_IF_ERROR(SetupSubgraphExecutionInfo(node, attr_name, *subgraph_session_state));
     }
-
-    // TODO: Once the subgraph session states have been finalized, can we go back and plan the location of implicit
-    // inputs that are fed through as graph inputs in the graph level holding the subgraphs ? Ideally the planned
-    // locations for these would be the locations they are explicitly consumed on in nested subgraphs.
   }
 
+  LOGS(logger_, INFO) << "Created the kernels of the subgraph of node '" << graph_viewer_->ParentNode()->Name()
+                      << "' on its first execution.";
   return Status::OK();
 }
 
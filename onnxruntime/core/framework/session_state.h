@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -26,13 +27,17 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_file_cache.h"
+#include "core/framework/frame_object_arena.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/work_stealing_schedule.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/onnx_protobuf.h"
 #include <mutex>
@@ -114,6 +119,10 @@ class SessionState {
   // Get kernel for specified node.
   // It should called right before graph execution only.
   const OpKernel* GetKernel(size_t node_id) const {
+    if (kernel_source_ != nullptr) {
+      return kernel_source_->GetKernel(node_id);
+    }
+
     return (node_id < session_kernels_.size()) ? session_kernels_[node_id].get() : nullptr;
   }
 
@@ -194,6 +203,12 @@ class SessionState {
   // execution plan. nullptr until FinalizeSessionState is called
   const SequentialExecutionPlan* GetExecutionPlan() const;
 
+  // data-flow view of the execution plan used by ExecutionMode::ORT_PARALLEL_WORK_STEALING.
+  // nullptr if that mode isn't enabled or the plan can't be executed node by node.
+  const WorkStealingSchedule* GetWorkStealingSchedule() const {
+    return work_stealing_schedule_.has_value() ? &*work_stealing_schedule_ : nullptr;
+  }
+
   const std::vector<AllocPlanPerValue>& GetPerValueAllocPlan() const;
 
   /**
@@ -219,16 +234,14 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  In training scenarios, the pattern and the inferred shapes may be generated on a cache miss.
+  The returned pointers share ownership with the cache so they stay valid if the entry is
+  evicted or replaced while the caller still uses them.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+      std::shared_ptr<const InlinedHashMap<int, TensorShape>>& inferred_shapes) const;
 
   /**
   Set generated memory pattern with a given input shapes.
@@ -238,6 +251,46 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Take the buffers a finished ExecutionFrame of this subgraph allocated for the same memory patterns, so a control
+  flow node that executes the subgraph repeatedly doesn't allocate them for every iteration.
+  Returns false if there are none, in which case the caller allocates the buffers.
+  */
+  bool AcquireMemoryPatternBuffers(const MemoryPatternGroup& mem_patterns,
+                                   InlinedHashMap<OrtDevice, BufferUniquePtr>& buffers) const;
+
+  /**
+  Keep the memory pattern buffers of a finished ExecutionFrame for the next execution.
+  Only the CPU buffers of subgraphs are kept. Others are freed, as the main graph is not executed in a loop and
+  device buffers may still be in use by a stream.
+  */
+  void ReleaseMemoryPatternBuffers(std::shared_ptr<const MemoryPatternGroup> mem_patterns,
+                                   InlinedHashMap<OrtDevice, BufferUniquePtr>&& buffers) const;
+
+  /**
+  Get an arena for the bookkeeping objects of a new ExecutionFrame, reusing the arena of a finished execution if
+  none of the objects allocated from it are still alive.
+  */
+  std::shared_ptr<FrameObjectArena> AcquireFrameObjectArena() const;
+
+  /**
+  Keep the arena of a finished ExecutionFrame for a later execution.
+  */
+  void ReleaseFrameObjectArena(std::shared_ptr<FrameObjectArena> arena) const;
+
+  /**
+  True if memory pattern blocks may hold tensors smaller than the planned size.
+  This is the case when nearby input shapes are bucketed to share one memory pattern.
+  */
+  bool IsMemoryPatternShapeBucketingEnabled() const { return mem_pattern_cache_.IsShapeBucketingEnabled(); }
+
+  /**
+  Load/save the learned memory patterns from/to a file so a new session can skip the warmup.
+  */
+  Status LoadMemoryPatternCache(const PathString& file_path) const;
+  Status SaveMemoryPatternCache(const PathString& file_path) const;
+  bool HasNewMemoryPatterns() const { return mem_pattern_cache_.IsDirty(); }
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -319,10 +372,25 @@ class SessionState {
                               bool remove_initializers = true,
                               bool saving_ort_format = false);
 
+  /**
+   * Finalizes this instance using the kernels and initializers of a finalized SessionState for the same Graph,
+   * which is how a session is cloned. The kernels, along with their pre-packed weights, and the initializers of
+   * the source are used as is, and its kernel lookups are copied. Only the execution plan is created again, for the
+   * session options of this instance.
+   * The source must outlive this instance.
+   */
+  Status FinalizeSessionStateFromSource(const SessionState& source,
+                                        const KernelRegistryManager& kernel_registry_manager);
+
   SessionState* Parent() {
     return parent_;
   }
 
+  // Loads the initializers of a subgraph and creates its kernels if that was deferred until the first execution of
+  // the subgraph by kOrtSessionOptionsLazySubgraphInitialization. Does nothing if they were already created.
+  // This is thread safe as it is called by the control flow kernels when executing the subgraph.
+  Status FinalizeDeferredInitialization() const;
+
   // Clear all removable attributes if they exists.
   // The function logs the list of removable attributes for every node.
   void PruneRemovableAttributes();
@@ -335,6 +403,13 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedCachedPrePackedWeightCounter() const {
+    return used_cached_pre_packed_weights_counter_;
+  }
+
+  // The pre-packed weights cache file of the session, which is owned by the root session state. Can be nullptr.
+  PrepackedWeightsFileCache* GetPrepackedWeightsFileCache() const;
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -413,7 +488,27 @@ class SessionState {
                                   bool save_prepacked_initializers,
                                   InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                   const InlinedHashMap<OrtValueName, OrtDevice>& outer_scope_node_arg_to_location_map = {},
-                                  bool graph_info_already_created = false);
+                                  bool graph_info_already_created = false,
+                                  bool defer_initialization = false);
+
+  // Moves the initializers from the Graph into this session state, creates the kernels and pre-packs the weights.
+  Status CreateKernelsAndInitializers(const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
+                                      const KernelRegistryManager& kernel_registry_manager,
+                                      const SessionOptions& session_options,
+                                      bool remove_initializers,
+                                      InlinedHashMap<std::string, size_t>& constant_initializers_use_count);
+
+  // Passes the subgraph session state to the kernel of the control flow node so it can execute the subgraph.
+  Status SetupSubgraphExecutionInfo(const Node& node, const std::string& attribute_name,
+                                    SessionState& subgraph_session_state);
+
+  Status FinalizeDeferredInitializationImpl();
+
+  // Sets the SessionState whose kernels are used by this instance and the instances of its subgraphs.
+  Status SetKernelSource(const SessionState& source);
+
+  // Takes the initializers of the kernel source, as its kernels were created with them.
+  Status ShareKernelSourceInitializers();
 
 #ifdef ENABLE_TRAINING
   Status GeneratePatternGroupCache(
@@ -426,6 +521,9 @@ class SessionState {
   // KernelCreateInfo for each node so we do kernel lookup once
   KernelCreateInfoMap kernel_create_info_map_;
 
+  // the kernels of this session state and the subgraphs can use buffers owned by the cache, so it must outlive them
+  std::unique_ptr<PrepackedWeightsFileCache> prepacked_weights_file_cache_;
+
   // fused_funcs_mgr_ must live longer than the session_kernels_, becaues a kernel could be created from this manager
   FuncManager fused_funcs_mgr_;
 
@@ -494,6 +592,7 @@ class SessionState {
   InlinedHashMap<int, OrtCallback> deleter_for_initialized_tensors_;
   InlinedVector<BufferUniquePtr> weights_buffers_;
   std::optional<SequentialExecutionPlan> p_seq_exec_plan_;
+  std::optional<WorkStealingSchedule> work_stealing_schedule_;
 
   const logging::Logger& logger_;
   profiling::Profiler& profiler_;
@@ -505,18 +604,23 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
-  // lock for the mem_patterns_
-  mutable std::mutex mem_patterns_lock_;
   // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  // entries are shared pointers as an ExecutionFrame keeps using the pattern it got for the duration of the run.
+  mutable MemoryPatternCache mem_pattern_cache_;
+
+  // memory pattern buffers of finished executions of a subgraph. the patterns are held so that an entry can't match
+  // a new pattern allocated at the address of an evicted one.
+  struct MemoryPatternBuffers {
+    std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+    InlinedHashMap<OrtDevice, BufferUniquePtr> buffers;
+  };
+  mutable std::mutex mem_pattern_buffers_mutex_;
+  mutable InlinedVector<MemoryPatternBuffers> mem_pattern_buffers_;
+
+  // arenas of finished executions. an arena is reused once it is the only owner left, i.e. the OrtValues allocated
+  // from it are gone.
+  mutable std::mutex frame_object_arenas_mutex_;
+  mutable InlinedVector<std::shared_ptr<FrameObjectArena>> frame_object_arenas_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -551,6 +655,24 @@ class SessionState {
 #endif
 
   SessionState* parent_ = nullptr;
+
+  // What FinalizeDeferredInitialization needs to finish the initialization of a subgraph on its first execution.
+  struct DeferredInitializationInfo {
+    std::basic_string<PATH_CHAR_TYPE> graph_location;
+    const KernelRegistryManager* kernel_registry_manager;
+    SessionOptions session_options;
+    bool remove_initializers;
+  };
+  std::optional<DeferredInitializationInfo> deferred_initialization_;
+
+  // The SessionState of another session whose kernels and initializers are used by this instance.
+  // See FinalizeSessionStateFromSource.
+  const SessionState* kernel_source_ = nullptr;
+  mutable std::atomic<bool> deferred_initialization_done_{false};
+  // serializes the deferred initialization of all the subgraphs. only the instance of the main graph is used as the
+  // subgraphs can pre-pack outer scope values, which updates the Graph they are owned by.
+  mutable std::mutex deferred_initialization_mutex_;
+
   // Assign each graph in each session an unique id.
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
   int graph_id_ = 0;
@@ -571,6 +693,10 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times the pre-packed weights of a constant initialized weight were restored from the
+  // pre-packed weights cache file instead of calling PrePack()
+  size_t used_cached_pre_packed_weights_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <chrono>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -14,6 +15,8 @@
 #include "core/framework/session_state_utils.h"
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
+#include "core/common/narrow.h"
+#include "core/common/profiler.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/graph_partitioner.h"
@@ -28,6 +31,7 @@
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/framework/mem_buffer.h"
 #include "core/framework/tensor_allocator.h"
+#include "core/platform/threadpool.h"
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 #include "core/framework/memory_info.h"
 #endif
@@ -276,7 +280,9 @@ common::Status SaveInitializedTensors(
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
     std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
-    PrepackedWeightsForGraph& prepacked_for_graph) {
+    PrepackedWeightsForGraph& prepacked_for_graph,
+    concurrency::ThreadPool* thread_pool,
+    profiling::Profiler* profiler) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
@@ -371,7 +377,125 @@ common::Status SaveInitializedTensors(
 
   OrtCallback deleter{nullptr, nullptr};
 
-  // 3. create weight tensors based on weights buffer
+  const bool use_device_allocator_for_initializers =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
+  const bool load_in_parallel =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsLoadInitializersInParallel, "0") == "1" &&
+      concurrency::ThreadPool::DegreeOfParallelism(thread_pool) > 1;
+  const bool profiling_enabled = profiler != nullptr && profiler->IsEnabled();
+
+  // an initializer that is created from its TensorProto
+  struct InitializerToLoad {
+    const ONNX_NAMESPACE::TensorProto* tensor_proto = nullptr;
+    std::optional<MemBuffer> m;
+    AllocatorPtr alloc;
+    Tensor* buffered_tensor = nullptr;
+    OrtValue ort_value;
+    Status status;
+    // pre-packed weights found in the external data file when loading in parallel
+    PrepackedKeyToBlobMap prepacked_blobs;
+  };
+
+  auto prepare_initializer = [&](int ort_value_index, const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                 InitializerToLoad& initializer) -> Status {
+    initializer.tensor_proto = &tensor_proto;
+    // TODO: if the tensor need be copied, does it have enough room?
+    ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, tensor_proto.name(), initializer.m,
+                                                      initializer.alloc));
+
+    if (auto iter = buffered_tensors.find(tensor_proto.name());
+        iter != buffered_tensors.end()) {
+      initializer.buffered_tensor = iter->second.release();
+      buffered_tensors.erase(iter);
+    }
+    return Status::OK();
+  };
+
+  auto load_initializer = [&](InitializerToLoad& initializer, PrepackedWeightsForGraph& prepacked) -> Status {
+    const auto& tensor_proto = *initializer.tensor_proto;
+    Status st = DeserializeTensorProto(env, graph_loc, tensor_proto,
+                                       (initializer.m.has_value()) ? &*initializer.m : nullptr, initializer.alloc,
+                                       default_cpu_alloc, initializer.ort_value, data_transfer_mgr,
+                                       external_data_loader_mgr, prepacked,
+                                       use_device_allocator_for_initializers, initializer.buffered_tensor);
+    if (!st.IsOK()) {
+      std::ostringstream oss;
+      oss << "Deserialize tensor " << tensor_proto.name() << " failed." << st.ErrorMessage();
+      return Status(st.Category(), st.Code(), oss.str());
+    }
+    return Status::OK();
+  };
+
+  // 3. load the initializers with external data in parallel.
+  // Reading (or mapping) the data and copying it to the device only depends on the initializer, and the buffers were
+  // planned above. The other initializers are deserialized when they are saved below, as their data is already in
+  // memory and creating them all upfront would keep two copies of it alive until the graph's initializers are removed.
+  std::vector<InitializerToLoad> preloaded_initializers;
+  InlinedHashMap<int, size_t> ort_value_index_to_preloaded;
+  if (load_in_parallel) {
+    for (const auto& entry : id_to_initialized_tensor) {
+      const auto& tensor_proto = *entry.second;
+      if (!tensor_proto.name().empty() && utils::HasExternalData(tensor_proto) &&
+          user_supplied_initializer_ids.find(entry.first) == user_supplied_initializer_ids.end()) {
+        ort_value_index_to_preloaded[entry.first] = preloaded_initializers.size();
+        preloaded_initializers.emplace_back();
+        ORT_RETURN_IF_ERROR(prepare_initializer(entry.first, tensor_proto, preloaded_initializers.back()));
+      }
+    }
+  }
+
+  if (!preloaded_initializers.empty()) {
+    TimePoint profiling_start;
+    if (profiling_enabled) {
+      profiling_start = profiler->Start();
+    }
+    const auto load_start = std::chrono::steady_clock::now();
+
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool, narrow<std::ptrdiff_t>(preloaded_initializers.size()), [&](std::ptrdiff_t i) {
+          auto& initializer = preloaded_initializers[narrow<size_t>(i)];
+          // PrepackedWeightsForGraph is not thread-safe, each task collects its blobs and they are merged below
+          PrepackedWeightsForGraph prepacked(initializer.prepacked_blobs, /* save_mode_on_ */ false);
+          ORT_TRY {
+            initializer.status = load_initializer(initializer, prepacked);
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              initializer.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Deserialize tensor ",
+                                                   initializer.tensor_proto->name(), " failed.", ex.what());
+            });
+          }
+        });
+
+    size_t num_bytes = 0;
+    for (auto& initializer : preloaded_initializers) {
+      ORT_RETURN_IF_ERROR(initializer.status);
+      for (auto& key_and_blobs : initializer.prepacked_blobs) {
+        prepacked_for_graph.InsertPrepackedWeights(key_and_blobs.first, std::move(key_and_blobs.second));
+      }
+      initializer.prepacked_blobs.clear();
+      num_bytes += initializer.ort_value.Get<Tensor>().SizeInBytes();
+    }
+
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - load_start);
+    LOGS(logger, INFO) << "Loaded " << preloaded_initializers.size() << " initializers with external data ("
+                       << num_bytes << " bytes) in " << duration.count() << " ms using up to "
+                       << concurrency::ThreadPool::DegreeOfParallelism(thread_pool) << " threads.";
+    if (profiling_enabled) {
+      profiler->EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SaveInitializedTensors_load_external_data",
+                                      profiling_start,
+                                      {{"initializer_count", std::to_string(preloaded_initializers.size())},
+                                       {"size_in_bytes", std::to_string(num_bytes)}});
+    }
+  }
+
+  // 4. create the remaining weight tensors based on weights buffer and save all of them
+  TimePoint profiling_start;
+  if (profiling_enabled) {
+    profiling_start = profiler->Start();
+  }
+
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
     const std::string& name = entry.second->name();
@@ -386,32 +510,14 @@ common::Status SaveInitializedTensors(
     if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
       ort_value = *(session_options.initializers_to_share_map.at(name));
       LOGS(logger, INFO) << "Using user supplied initializer with name (" << name << ").";
+    } else if (auto preloaded = ort_value_index_to_preloaded.find(ort_value_index);
+               preloaded != ort_value_index_to_preloaded.end()) {
+      ort_value = std::move(preloaded_initializers[preloaded->second].ort_value);
     } else {
-      const ONNX_NAMESPACE::TensorProto& tensor_proto = *(entry.second);
-
-      std::optional<MemBuffer> m;
-      AllocatorPtr alloc;
-      // TODO: if the tensor need be copied, does it have enough room?
-      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
-      bool use_device_allocator_for_initializers =
-          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
-
-      Tensor* p_tensor = nullptr;
-      if (auto iter = buffered_tensors.find(name);
-          iter != buffered_tensors.end()) {
-        p_tensor = iter->second.release();
-        buffered_tensors.erase(iter);
-      }
-
-      Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
-                                         default_cpu_alloc, ort_value, data_transfer_mgr, external_data_loader_mgr,
-                                         prepacked_for_graph,
-                                         use_device_allocator_for_initializers, p_tensor);
-      if (!st.IsOK()) {
-        std::ostringstream oss;
-        oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
-        return Status(st.Category(), st.Code(), oss.str());
-      }
+      InitializerToLoad initializer;
+      ORT_RETURN_IF_ERROR(prepare_initializer(ort_value_index, *entry.second, initializer));
+      ORT_RETURN_IF_ERROR(load_initializer(initializer, prepacked_for_graph));
+      ort_value = std::move(initializer.ort_value);
     }
 
     // 'name' is a reference to a string within the TensorProto that save_tensor_func may free
@@ -429,6 +535,11 @@ common::Status SaveInitializedTensors(
 #endif
   }
 
+  if (profiling_enabled) {
+    profiler->EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SaveInitializedTensors_save", profiling_start,
+                                    {{"initializer_count", std::to_string(id_to_initialized_tensor.size())}});
+  }
+
   LOGS(logger, INFO) << "Done saving initialized tensors";
   return common::Status::OK();
 }
@@ -34,6 +34,14 @@ namespace logging {
 class Logger;
 }
 
+namespace concurrency {
+class ThreadPool;
+}
+
+namespace profiling {
+class Profiler;
+}
+
 namespace session_state_utils {
 using SaveTensorFunction = std::function<Status(const std::string& name, int idx, const OrtValue& value,
                                                 const OrtCallback& d, bool constant, bool sparse)>;
@@ -52,7 +60,10 @@ common::Status SaveInitializedTensors(
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
     std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
-    PrepackedWeightsForGraph& prepacked_for_graph);
+    PrepackedWeightsForGraph& prepacked_for_graph,
+    // used to load the initializers in parallel if kOrtSessionOptionsLoadInitializersInParallel is set
+    concurrency::ThreadPool* thread_pool = nullptr,
+    profiling::Profiler* profiler = nullptr);
 
 common::Status AllocateTensor(
     const onnxruntime::MemBuffer* m,
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/common/narrow.h"
 #include "core/framework/copy.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/transpose_helper.h"
@@ -240,6 +241,202 @@ void SingleAxisTranspose(gsl::span<const size_t> permutations, const Tensor& inp
   }
 }
 
+namespace {
+
+// number of rows and columns in each tile of the 2D transposes done by TiledTranspose
+constexpr size_t kTransposeTileSize = 64;
+
+template <typename T>
+void TransposeTile(const T* input, size_t input_stride, T* output, size_t output_stride, size_t rows,
+                   size_t columns) {
+  if constexpr (std::is_same_v<T, uint64_t>) {
+    for (size_t c = 0; c < columns; ++c) {
+      for (size_t r = 0; r < rows; ++r) {
+        output[c * output_stride + r] = input[r * input_stride + c];
+      }
+    }
+  } else {
+    MlasTranspose(input, input_stride, output, output_stride, rows, columns);
+  }
+}
+
+// an axis of the outer loop of TiledTranspose
+struct TiledTransposeAxis {
+  size_t dim;
+  size_t input_stride;
+  size_t output_stride;
+};
+
+template <typename T>
+void TiledTransposeImpl(const T* input, T* output, gsl::span<const TiledTransposeAxis> outer_axes,
+                        const TiledTransposeAxis& row_axis, const TiledTransposeAxis& column_axis,
+                        concurrency::ThreadPool* tp) {
+  // the input tile is rows x columns where the rows are the innermost axis of the output and the columns are the
+  // innermost axis of the input.
+  const size_t row_tiles = (row_axis.dim + kTransposeTileSize - 1) / kTransposeTileSize;
+  const size_t column_tiles = (column_axis.dim + kTransposeTileSize - 1) / kTransposeTileSize;
+  const size_t tiles_per_block = row_tiles * column_tiles;
+
+  size_t num_blocks = 1;
+  for (const auto& axis : outer_axes) {
+    num_blocks *= axis.dim;
+  }
+
+  const double bytes_per_tile = static_cast<double>(kTransposeTileSize * kTransposeTileSize * sizeof(T));
+  const TensorOpCost cost{bytes_per_tile, bytes_per_tile, static_cast<double>(kTransposeTileSize * kTransposeTileSize)};
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_blocks * tiles_per_block), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (auto tile = static_cast<size_t>(first), end = static_cast<size_t>(last); tile < end; ++tile) {
+          // the row tiles are innermost so consecutive tiles write to adjacent output
+          size_t block = tile / tiles_per_block;
+          const size_t tile_in_block = tile % tiles_per_block;
+          const size_t row_start = (tile_in_block % row_tiles) * kTransposeTileSize;
+          const size_t column_start = (tile_in_block / row_tiles) * kTransposeTileSize;
+
+          size_t input_offset = row_start * row_axis.input_stride + column_start;
+          size_t output_offset = column_start * column_axis.output_stride + row_start;
+
+          for (size_t i = outer_axes.size(); i-- > 0;) {
+            const auto& axis = outer_axes[i];
+            const size_t index = block % axis.dim;
+            block /= axis.dim;
+            input_offset += index * axis.input_stride;
+            output_offset += index * axis.output_stride;
+          }
+
+          TransposeTile(input + input_offset, row_axis.input_stride, output + output_offset,
+                        column_axis.output_stride, std::min(kTransposeTileSize, row_axis.dim - row_start),
+                        std::min(kTransposeTileSize, column_axis.dim - column_start));
+        }
+      });
+}
+
+}  // namespace
+
+//  `input_shape_override` overrides the shape of `input` for compute purposes.
+bool TiledTranspose(gsl::span<const size_t> permutations, const Tensor& input, Tensor& output,
+                    const TensorShape* input_shape_override, concurrency::ThreadPool* tp) {
+  const auto& input_shape = input_shape_override ? *input_shape_override : input.Shape();
+  const auto input_dims = input_shape.GetDims();
+  const size_t rank = input_dims.size();
+
+  if (input_shape.Size() == 0) {
+    return true;
+  }
+
+  // drop the axes of size 1
+  InlinedVector<size_t> kept_axis(rank);
+  InlinedVector<size_t> dims;
+  for (size_t i = 0; i < rank; ++i) {
+    kept_axis[i] = dims.size();
+    if (input_dims[i] != 1) {
+      dims.push_back(narrow<size_t>(input_dims[i]));
+    }
+  }
+
+  InlinedVector<size_t> perm;
+  for (size_t i = 0; i < rank; ++i) {
+    if (input_dims[permutations[i]] != 1) {
+      perm.push_back(kept_axis[permutations[i]]);
+    }
+  }
+
+  // merge the runs of output axes that are also adjacent in the input. each run becomes one axis.
+  InlinedVector<size_t> run_of_input_axis(dims.size());
+  InlinedVector<size_t> run_first_input_axis;
+  for (size_t i = 0; i < perm.size(); ++i) {
+    if (i == 0 || perm[i] != perm[i - 1] + 1) {
+      run_first_input_axis.push_back(perm[i]);
+    }
+    run_of_input_axis[perm[i]] = run_first_input_axis.size() - 1;
+  }
+
+  // the merged input axes are the runs ordered by their first input axis
+  const size_t merged_rank = run_first_input_axis.size();
+  InlinedVector<size_t> merged_axis_of_run(merged_rank);
+  InlinedVector<size_t> merged_dims;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    const size_t run = run_of_input_axis[i];
+    if (run_first_input_axis[run] == i) {
+      merged_axis_of_run[run] = merged_dims.size();
+      merged_dims.push_back(dims[i]);
+    } else {
+      merged_dims.back() *= dims[i];
+    }
+  }
+
+  InlinedVector<size_t> merged_perm(merged_rank);
+  for (size_t run = 0; run < merged_rank; ++run) {
+    merged_perm[run] = merged_axis_of_run[run];
+  }
+
+  // an innermost axis that doesn't move is copied as a block, so treat it as part of the element
+  size_t element_size = input.DataType()->Size();
+  if (merged_rank > 0 && merged_perm.back() == merged_rank - 1) {
+    element_size *= merged_dims.back();
+    merged_dims.pop_back();
+    merged_perm.pop_back();
+  }
+
+  const size_t num_axes = merged_dims.size();
+  if (num_axes < 2) {
+    return false;
+  }
+
+  InlinedVector<size_t> input_strides(num_axes);
+  InlinedVector<size_t> output_strides(num_axes);  // indexed by the input axis
+  input_strides[num_axes - 1] = 1;
+  for (size_t i = num_axes - 1; i-- > 0;) {
+    input_strides[i] = input_strides[i + 1] * merged_dims[i + 1];
+  }
+  size_t output_stride = 1;
+  for (size_t i = num_axes; i-- > 0;) {
+    output_strides[merged_perm[i]] = output_stride;
+    output_stride *= merged_dims[merged_perm[i]];
+  }
+
+  const size_t row_input_axis = merged_perm[num_axes - 1];
+  const size_t column_input_axis = num_axes - 1;
+  const TiledTransposeAxis row_axis{merged_dims[row_input_axis], input_strides[row_input_axis], 1};
+  const TiledTransposeAxis column_axis{merged_dims[column_input_axis], 1, output_strides[column_input_axis]};
+
+  InlinedVector<TiledTransposeAxis> outer_axes;
+  for (size_t i = 0; i < num_axes - 1; ++i) {
+    const size_t axis = merged_perm[i];
+    if (axis != column_input_axis) {
+      outer_axes.push_back({merged_dims[axis], input_strides[axis], output_strides[axis]});
+    }
+  }
+
+  const auto* input_data = input.DataRaw();
+  auto* output_data = output.MutableDataRaw();
+
+  switch (element_size) {
+    case sizeof(uint8_t):
+      TiledTransposeImpl(static_cast<const uint8_t*>(input_data), static_cast<uint8_t*>(output_data), outer_axes,
+                         row_axis, column_axis, tp);
+      break;
+    case sizeof(uint16_t):
+      TiledTransposeImpl(static_cast<const uint16_t*>(input_data), static_cast<uint16_t*>(output_data), outer_axes,
+                         row_axis, column_axis, tp);
+      break;
+    case sizeof(uint32_t):
+      TiledTransposeImpl(static_cast<const uint32_t*>(input_data), static_cast<uint32_t*>(output_data), outer_axes,
+                         row_axis, column_axis, tp);
+      break;
+    case sizeof(uint64_t):
+      TiledTransposeImpl(static_cast<const uint64_t*>(input_data), static_cast<uint64_t*>(output_data), outer_axes,
+                         row_axis, column_axis, tp);
+      break;
+    default:
+      return false;
+  }
+
+  return true;
+}
+
 bool IsTransposeMovingSingleAxis(gsl::span<const size_t> permutations, size_t& from, size_t& to) {
   // if a single axis moved to an outer dimension, the values should be one lower than the index until the slot the
   // axis was moved from, and equal to the index after that.
@@ -27,6 +27,14 @@ We use simple pointer arithmetic if the size of each read/write is a power of 2
 We use memcpy if the block size is larger.
 
 We fall back to the default implementation in all other cases, and if the input is std::string.
+
+For any other permutation TiledTranspose can be used. Axes of size 1 are dropped and axes that stay adjacent in the
+output are merged, which reduces most transposes to a small rank. An innermost axis that doesn't move is folded into
+the element size. The remaining problem is a batch of 2D transposes between the innermost axis of the input and the
+innermost axis of the output. These are split into tiles that are transposed with MlasTranspose and processed in
+parallel.
+
+  e.g. a {N, C, D, H, W} -> {N, D, H, W, C} transpose with N == 1 becomes a transpose of {C, D*H*W}.
 */
 
 #include <sstream>
@@ -44,4 +52,9 @@ bool IsTransposeMovingSingleAxis(gsl::span<const size_t> permutations, size_t& f
 void SingleAxisTranspose(gsl::span<const size_t> permutations, const Tensor& input, Tensor& output, size_t from,
                          size_t to, const TensorShape* input_shape_override = nullptr,
                          concurrency::ThreadPool* tp = nullptr);
+
+// Returns false if the transpose isn't supported, which is the case if the element size after folding the innermost
+// axis isn't 1, 2, 4 or 8 bytes. The input must not be std::string.
+bool TiledTranspose(gsl::span<const size_t> permutations, const Tensor& input, Tensor& output,
+                    const TensorShape* input_shape_override = nullptr, concurrency::ThreadPool* tp = nullptr);
 }  // namespace onnxruntime
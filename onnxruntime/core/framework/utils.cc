@@ -329,13 +329,14 @@ common::Status InitializeFeedFetchCopyInfo(const SessionState& session_state,
     feeds_fetches_manager.SetDeviceCopyChecks(DeviceCopyCheck::NoCopy, DeviceCopyCheck::NoCopy);
   } else {
     // setup all the static info about where the graph inputs and outputs are located
-    auto info = feeds_fetches_manager.GetFeedsFetchesInfo();
+    const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
     auto& feed_copy_info = feeds_fetches_manager.GetMutableFeedsDeviceCopyInfo();
     auto& fetch_copy_info = feeds_fetches_manager.GetMutableFetchesDeviceCopyInfo();
     ORT_RETURN_IF_ERROR(utils::CalculateStaticCopyInfoForFeeds(session_state, info.feed_names, feed_copy_info));
     ORT_RETURN_IF_ERROR(utils::CalculateStaticCopyInfoForFetches(session_state, info.output_names, fetch_copy_info));
   }
 
+  feeds_fetches_manager.SetStaticCopyInfoInitialized();
   return Status::OK();
 }
 
@@ -742,7 +743,10 @@ common::Status ExecuteGraph(const SessionState& session_state,
 #endif
                             bool only_execute_path_to_fetches,
                             Stream* parent_stream) {
-  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
+  // the static copy info may have been copied from a manager cached by the session
+  if (!feeds_fetches_manager.IsStaticCopyInfoInitialized()) {
+    ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
+  }
 
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
   FinalizeFeedFetchCopyInfo(feeds_fetches_manager, feeds, fetches);
@@ -903,6 +907,8 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
                                ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
                                Stream* parent_stream,
                                bool sync_subgraph_fetches) {
+  ORT_RETURN_IF_ERROR(session_state.FinalizeDeferredInitialization());
+
 #ifdef ORT_ENABLE_STREAM
   DeviceStreamCollectionHolder device_stream_collection_holder(&session_state);
   DeviceStreamCollection* device_stream_collection = device_stream_collection_holder.p_.get();
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/work_stealing_schedule.h"
+
+#include <limits>
+
+#include "core/framework/execution_steps.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+std::optional<WorkStealingSchedule> WorkStealingSchedule::Create(const SequentialExecutionPlan& plan,
+                                                                 const GraphViewer& graph_viewer) {
+  // notifications and barriers synchronize streams based on the position of steps, which has no meaning once nodes
+  // are executed out of order.
+  if (!plan.notification_owners.empty() || plan.num_barriers > 0) {
+    return std::nullopt;
+  }
+
+  const size_t num_node_slots = static_cast<size_t>(graph_viewer.MaxNodeIndex());
+  constexpr size_t kNotInPlan = std::numeric_limits<size_t>::max();
+
+  WorkStealingSchedule schedule;
+  schedule.num_dependencies.resize(num_node_slots, 0);
+  schedule.consumers.resize(num_node_slots);
+  schedule.node_stream.resize(num_node_slots, kNotInPlan);
+
+  for (size_t stream_idx = 0; stream_idx < plan.execution_plan.size(); ++stream_idx) {
+    for (const auto& step : plan.execution_plan[stream_idx]->steps_) {
+      if (dynamic_cast<const LaunchKernelStep*>(step.get()) == nullptr) {
+        return std::nullopt;
+      }
+
+      schedule.node_stream[step->GetNodeIndex()] = stream_idx;
+    }
+  }
+
+  InlinedHashSet<NodeIndex> upstream;
+  for (NodeIndex node_index = 0; node_index < num_node_slots; ++node_index) {
+    if (schedule.node_stream[node_index] == kNotInPlan) {
+      continue;
+    }
+
+    // the input edges cover explicit and implicit inputs as well as control edges.
+    // nodes producing multiple inputs of this node only count once.
+    const Node* node = graph_viewer.GetNode(node_index);
+    upstream.clear();
+    for (auto it = node->InputNodesBegin(), end = node->InputNodesEnd(); it != end; ++it) {
+      const NodeIndex input_node_index = it->Index();
+      if (schedule.node_stream[input_node_index] != kNotInPlan && upstream.insert(input_node_index).second) {
+        schedule.consumers[input_node_index].push_back(node_index);
+      }
+    }
+
+    schedule.num_dependencies[node_index] = static_cast<int>(upstream.size());
+    if (upstream.empty()) {
+      schedule.roots.push_back(node_index);
+    }
+  }
+
+  return schedule;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "core/common/inlined_containers.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+struct SequentialExecutionPlan;
+
+// Data-flow view of an execution plan used by ExecutionMode::ORT_PARALLEL_WORK_STEALING.
+//
+// Instead of walking the steps of each logic stream in order, every node tracks how many of its upstream nodes are
+// still pending. A node is scheduled on the inter-op thread pool as soon as that count drops to zero. The thread that
+// completes a node continues with one of the nodes it made ready and pushes the others to the thread pool queues,
+// from which idle workers steal them.
+//
+// This is only possible if the plan doesn't rely on the order of steps within a stream for synchronization, i.e.
+// it contains no notifications or barriers. Create returns std::nullopt otherwise.
+struct WorkStealingSchedule {
+  // nodes with no upstream dependencies within the plan
+  InlinedVector<NodeIndex> roots;
+  // number of distinct upstream nodes. indexed by NodeIndex.
+  std::vector<int> num_dependencies;
+  // distinct downstream nodes. indexed by NodeIndex.
+  std::vector<InlinedVector<NodeIndex>> consumers;
+  // logic stream the node was assigned to. indexed by NodeIndex.
+  std::vector<size_t> node_stream;
+
+  static std::optional<WorkStealingSchedule> Create(const SequentialExecutionPlan& plan,
+                                                    const GraphViewer& graph_viewer);
+};
+
+}  // namespace onnxruntime
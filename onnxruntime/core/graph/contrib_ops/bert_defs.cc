@@ -318,8 +318,17 @@ void BaseGroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceConte
 
 void GroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index) {
   // TODO(aciddelgado): propagate output shapes depending if kv-share buffer is on or not
-  constexpr int use_max_past_present_buffer = -1;
+  // With a block table, past and present are the same block pool.
+  constexpr int kBlockTableIndex = 9;
+  const int use_max_past_present_buffer = hasInputShape(ctx, kBlockTableIndex) ? 1 : -1;
   BaseGroupQueryAttentionTypeAndShapeInference(ctx, past_key_index, use_max_past_present_buffer);
+
+  // With the k-v cache scales, present holds int8 values.
+  constexpr size_t kKScaleIndex = 10;
+  if (ctx.getNumOutputs() > 1 && ctx.getNumInputs() > kKScaleIndex && ctx.getInputType(kKScaleIndex) != nullptr) {
+    updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::INT8);
+    updateOutputElemType(ctx, 2, ONNX_NAMESPACE::TensorProto::INT8);
+  }
 }
 
 void SparseAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index) {
@@ -1049,6 +1058,20 @@ Only supports causal and local attention.
 Supports rotary position embedding for CPU and CUDA.
 Supports packed input for CPU and CUDA.
 Supports continuous decoding for batch_size == 1 for CPU and CUDA.
+Supports paged k-v cache for CPU.
+
+Paged k-v cache: when block_table is given, past_key and past_value are a pool of fixed size blocks with shape
+(num_blocks, kv_num_heads, block_size, head_size) shared by all the sequences, and present_key and present_value have
+the same shape as past_key and past_value. Row b of block_table lists the blocks holding tokens
+[j * block_size, (j + 1) * block_size) of sequence b in entry j. The kernel writes the new key and value tokens into
+these blocks, so the blocks covering positions [0, seqlens_k[b] + 1) must be assigned. Sequences only need as many
+blocks as they have tokens, instead of a max_sequence_length buffer each.
+
+Quantized k-v cache: when k_scale and v_scale are given, past_key, past_value, present_key and present_value hold int8
+values. The new key and value tokens are quantized symmetrically with the scale of their kv head when they are
+appended, x_int8 = saturate(round(x / scale)), and the cache is dequantized on the fly by the attention. The scales
+have shape (1) for one scale per tensor or (kv_num_heads) for one scale per kv head. Supported for CPU without a
+block_table.
 
 )DOC";
 
@@ -1101,13 +1124,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "past_key",
                "past state key with support for format BNSH. When past_key uses same tensor as present_key"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(4,
                "past_value",
                "past state value with support for format BNSH. When past_value uses same tensor as present_value"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(5,
                "seqlens_k",
@@ -1128,6 +1151,24 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "2D tensor with shape (max_sequence_length, head_size / 2).",
                "T",
                OpSchema::Optional)
+        .Input(9,
+               "block_table",
+               "2D tensor with shape (batch_size, max_blocks_per_sequence) mapping the logical blocks of each "
+               "sequence to blocks of the paged k-v cache in past_key and past_value. Entries past the blocks in "
+               "use are ignored.",
+               "M",
+               OpSchema::Optional)
+        .Input(10,
+               "k_scale",
+               "Scale of the int8 key cache with shape (1) or (kv_num_heads). The k-v cache holds int8 values when "
+               "it is given.",
+               "T_SCALE",
+               OpSchema::Optional)
+        .Input(11,
+               "v_scale",
+               "Scale of the int8 value cache with shape (1) or (kv_num_heads). Required when k_scale is given.",
+               "T_SCALE",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, hidden_size)",
@@ -1137,14 +1178,17 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                 "present state key with support for format BNSH. When past_key uses same tensor as present_key"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .Output(2,
                 "present_value",
                 "present state value with support for format BNSH. When past_value uses same tensor as present_value"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .TypeConstraint("T", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)"}, "Constrain input and output to float tensors.")
+        .TypeConstraint("T_CACHE", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)", "tensor(int8)"},
+                        "Constrain the k-v cache to float tensors, or int8 tensors when it is quantized.")
+        .TypeConstraint("T_SCALE", {"tensor(float)"}, "Constrain the k-v cache scales to float tensors.")
         .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask to int tensor.")
         .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
           GroupQueryAttentionTypeAndShapeInference(ctx, 3);
@@ -1143,6 +1143,11 @@ ONNX_MS_OPERATOR_SET_SCHEMA(BeamSearch, 1,
                                 .Attr("pad_token_id", "The id of the padding token", AttributeProto::INT)
                                 .Attr("decoder_start_token_id", "The id of the token that indicates decoding starts.", AttributeProto::INT, static_cast<int64_t>(-1))
                                 .Attr("no_repeat_ngram_size", "no repeat ngrams size", AttributeProto::INT, static_cast<int64_t>(0))
+                                .Attr("prefill_chunk_size",
+                                      "If positive, the prompt is run by the decoder in chunks of this many tokens, each appending to the past state of "
+                                      "the previous ones, to bound the memory of the first run on long prompts. 0 runs the whole prompt at once. "
+                                      "This is relevant only for the GPT2 model on CPU without past_present_share_buffer.",
+                                      AttributeProto::INT, static_cast<int64_t>(0))
                                 .Attr("early_stopping", "early stop or not", AttributeProto::INT, static_cast<int64_t>(0))
                                 .Attr("model_type", "model type: 0 for GPT-2; 1 for encoder decoder like T5", AttributeProto::INT, static_cast<int64_t>(0))
                                 .Attr("encoder", "The subgraph for initialization of encoder and decoder. It will be called once before decoder subgraph.", AttributeProto::GRAPH, OPTIONAL_VALUE)
@@ -1314,6 +1319,11 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GreedySearch, 1,
                                 .Attr("pad_token_id", "The id of the padding token", AttributeProto::INT)
                                 .Attr("decoder_start_token_id", "The id of the token that indicates decoding starts.", AttributeProto::INT, static_cast<int64_t>(-1))
                                 .Attr("no_repeat_ngram_size", "no repeat ngrams size", AttributeProto::INT, static_cast<int64_t>(0))
+                                .Attr("prefill_chunk_size",
+                                      "If positive, the prompt is run by the decoder in chunks of this many tokens, each appending to the past state of "
+                                      "the previous ones, to bound the memory of the first run on long prompts. 0 runs the whole prompt at once. "
+                                      "This is relevant only for the GPT2 model on CPU without past_present_share_buffer.",
+                                      AttributeProto::INT, static_cast<int64_t>(0))
                                 .Attr("model_type", "model type: 0 for decoder only like GPT-2; 1 for encoder decoder like Bart", AttributeProto::INT, static_cast<int64_t>(0))
                                 .Attr("encoder", "The subgraph for initialization of encoder and decoder. It will be called once before `decoder` subgraph.", AttributeProto::GRAPH, OPTIONAL_VALUE)
                                 .Attr("init_decoder",
@@ -1321,6 +1331,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GreedySearch, 1,
                                       "This is relevant only for the GPT2 model. If this attribute is missing, the `decoder` subgraph will be used for all decoding runs",
                                       AttributeProto::GRAPH, OPTIONAL_VALUE)
                                 .Attr("decoder", "Decoder subgraph to execute in a loop.", AttributeProto::GRAPH)
+                                .Attr("draft_decoder",
+                                      "A smaller decoder subgraph with the same inputs, outputs and vocabulary as `decoder`, used for speculative decoding. "
+                                      "It proposes `num_speculative_tokens` tokens that are verified by a single run of `decoder`, which keeps the longest prefix "
+                                      "it agrees with. The generated sequences are the same as without it. This is relevant only for the GPT2 model on CPU.",
+                                      AttributeProto::GRAPH, OPTIONAL_VALUE)
+                                .Attr("num_speculative_tokens", "The number of tokens proposed by `draft_decoder` for each run of `decoder`.",
+                                      AttributeProto::INT, static_cast<int64_t>(4))
                                 .Attr("vocab_size",
                                       "Size of the vocabulary. "
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
@@ -1347,6 +1364,11 @@ ONNX_MS_OPERATOR_SET_SCHEMA(Sampling, 1,
                                 .Attr("pad_token_id", "The id of the padding token", AttributeProto::INT)
                                 .Attr("decoder_start_token_id", "The id of the token that indicates decoding starts.", AttributeProto::INT, static_cast<int64_t>(-1))
                                 .Attr("no_repeat_ngram_size", "no repeat ngrams size", AttributeProto::INT, static_cast<int64_t>(0))
+                                .Attr("prefill_chunk_size",
+                                      "If positive, the prompt is run by the decoder in chunks of this many tokens, each appending to the past state of "
+                                      "the previous ones, to bound the memory of the first run on long prompts. 0 runs the whole prompt at once. "
+                                      "This is relevant only for the GPT2 model on CPU without past_present_share_buffer.",
+                                      AttributeProto::INT, static_cast<int64_t>(0))
                                 .Attr("temperature", "The value used to module the next token probabilities.", AttributeProto::FLOAT, 1.0f)
                                 .Attr("top_p",
                                       "If set to float < 1, only the smallest set of most probable tokens with probabilities that add up to `top_p` or higher are kept for generation.",
@@ -1798,6 +1820,66 @@ activation and leaky_relu_alpha.)DOC")
                                   }
                                 }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Evaluates a chain of element-wise operators in a single pass over the broadcast output shape, without
+materializing the intermediate results. The program is described by the parallel attributes `ops`, `lhs`
+and `rhs`. Registers 0 to N-1 hold the N inputs and step i stores its result in register N+i. Each step reads
+register `lhs[i]` and, for binary operators, register `rhs[i]` (`rhs[i]` is -1 for unary operators). The
+output is the result of the last step. The inputs follow multidirectional (Numpy-style) broadcasting.
+Supported binary operators are Add, Sub, Mul and Div. Supported unary operators are Relu, Sigmoid, Tanh,
+Exp, Log, Neg, Abs, Sqrt, Reciprocal and Erf.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(FusedElementwise, 1,
+                            OpSchema()
+                                .SetDoc(FusedElementwise_ver1_doc)
+                                .Attr("ops", "Operator type of each step.", AttributeProto::STRINGS)
+                                .Attr("lhs", "First operand register of each step.", AttributeProto::INTS)
+                                .Attr("rhs", "Second operand register of each step, or -1 for unary operators.",
+                                      AttributeProto::INTS)
+                                .Input(0, "X", "List of tensors read by the program.", "T", OpSchema::Variadic)
+                                .Output(0, "Y", "Result of the last step.", "T")
+                                .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+                                  const size_t num_inputs = ctx.getNumInputs();
+                                  if (!hasNInputShapes(ctx, static_cast<int>(num_inputs))) {
+                                    return;
+                                  }
+                                  std::vector<const TensorShapeProto*> shapes;
+                                  shapes.reserve(num_inputs);
+                                  for (size_t i = 0; i < num_inputs; ++i) {
+                                    shapes.push_back(&ctx.getInputType(i)->tensor_type().shape());
+                                  }
+                                  multidirectionalBroadcastShapeInference(
+                                      shapes, *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+                                }));
+
+constexpr const char* FusedFeatureTransform_ver1_doc = R"DOC(
+Applies the per-feature preprocessing of a chain of ai.onnx.ml Imputer, Scaler and Normalizer operators in a
+single pass over the rows of X, which is (F) or (N, F). Each step is optional and they run in this order:
+values equal to `replaced_value` (or NaN if it is NaN) are replaced by `imputed_values`, then features are
+transformed by (x - offset) * scale, then each row is normalized with `norm`. `imputed_values`, `offset`
+and `scale` hold one value per feature or a single value for all of them, as in the original operators.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(FusedFeatureTransform, 1,
+                            OpSchema()
+                                .SetDoc(FusedFeatureTransform_ver1_doc)
+                                .Attr("imputed_values", "Values replacing the missing ones. Empty to skip imputation.",
+                                      AttributeProto::FLOATS, OPTIONAL_VALUE)
+                                .Attr("replaced_value", "Value marking a missing feature.", AttributeProto::FLOAT, 0.0f)
+                                .Attr("offset", "Subtracted from the features first. Empty to skip scaling.",
+                                      AttributeProto::FLOATS, OPTIONAL_VALUE)
+                                .Attr("scale", "Multiplies the features after the offset, same length as offset.",
+                                      AttributeProto::FLOATS, OPTIONAL_VALUE)
+                                .Attr("norm", "Row normalization: 'MAX', 'L1', 'L2', or empty to skip it.",
+                                      AttributeProto::STRING, std::string())
+                                .Input(0, "X", "Features, (F) or (N, F).", "T")
+                                .Output(0, "Y", "Transformed features, with the shape of X.", "T")
+                                .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+                                .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(ExpandDims, 1,
                             OpSchema()
                                 .Input(0, "X", "input", "T")
@@ -2179,6 +2261,47 @@ ONNX_MS_OPERATOR_SET_SCHEMA(FusedMatMul, 1,
                                 .SetDoc(FusedMatMul_doc)
                                 .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) { FusedMatMulShapeInference(ctx); }));
 
+constexpr const char* SegmentedLoraMatMul_ver1_doc = R"DOC(
+Applies a different LoRA adapter to each batch entry: Y[b] = base[b] + scale * X[b] * lora_a[i] * lora_b[i], where
+i = adapter_indices[b]. The A and B matrices of all the adapters are stacked in `lora_a` and `lora_b`, so a batch
+mixing the requests of many adapters runs in a single node. Batch entries with a negative adapter index get no
+LoRA update. Consecutive batch entries with the same adapter form a segment that is computed with one matrix
+multiplication per LoRA matrix, so sorting the batch by adapter index gives the largest segments.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(SegmentedLoraMatMul, 1,
+                            OpSchema()
+                                .SetDoc(SegmentedLoraMatMul_ver1_doc)
+                                .Attr("scale", "Scale of the LoRA update, usually alpha / rank.", AttributeProto::FLOAT, 1.0f)
+                                .Input(0, "X", "Input with shape (batch_size, K) or (batch_size, sequence_length, K)", "T")
+                                .Input(1, "lora_a", "A matrices of the adapters with shape (num_adapters, K, rank)", "T")
+                                .Input(2, "lora_b", "B matrices of the adapters with shape (num_adapters, rank, N)", "T")
+                                .Input(3, "adapter_indices", "Adapter of each batch entry with shape (batch_size)", "I")
+                                .Input(4, "base",
+                                       "Output of the base weights, added to the LoRA update. Same shape as Y.", "T",
+                                       OpSchema::Optional)
+                                .Output(0, "Y", "Output with the shape of X, the last dimension being N", "T")
+                                .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+                                .TypeConstraint("I", {"tensor(int32)", "tensor(int64)"},
+                                                "Constrain adapter indices to integer tensors.")
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+                                  if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 2)) {
+                                    return;
+                                  }
+                                  const auto& x_shape = getInputShape(ctx, 0);
+                                  const auto& lora_b_shape = getInputShape(ctx, 2);
+                                  if (x_shape.dim_size() != 2 && x_shape.dim_size() != 3) {
+                                    fail_shape_inference("X must have 2 or 3 dimensions");
+                                  }
+                                  if (lora_b_shape.dim_size() != 3) {
+                                    fail_shape_inference("lora_b must have 3 dimensions");
+                                  }
+                                  TensorShapeProto output_shape = x_shape;
+                                  *output_shape.mutable_dim(x_shape.dim_size() - 1) = lora_b_shape.dim(2);
+                                  updateOutputShape(ctx, 0, output_shape);
+                                }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(FusedMatMulActivation, 1,
                             OpSchema()
                                 .Input(0, "A", "N-dimensional matrix A", "T")
@@ -3574,6 +3697,13 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
   3. During the op execution, `data` and `indices` are first used to generate the quantized output. Then, `scales` and `zero_points` are used
      to dequantize the output.
   4. The `output` and `scales` have the same type. The `data` and `zero_points` have the same type.
+  5. If `data` is uint8, it holds `bits`-bit values packed along the last axis like the weight of MatMulNBits, so the
+     last axis of `data` has K * bits / 8 elements for K quantized values. `quantize_axis` must be the last axis and
+     `gather_axis` another one. `zero_points` are packed the same way, and if they are not provided,
+     2^(bits - 1) is the zero point. A weight tied between an embedding and the lm_head MatMulNBits can then be stored
+     once: for a [N, K] weight with K a multiple of `block_size`, `data` of shape [N, K * bits / 8], `scales` of shape
+     [N, K / block_size] and `zero_points` of shape [N, CeilDiv(K / block_size * bits, 8)] are also valid inputs of
+     MatMulNBits.
 )DOC";
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(GatherBlockQuantized)
@@ -3592,6 +3722,10 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
             "(Optional) block size used for weight quantization. It needs to be a power of 2 and not smaller than 16.",
             AttributeProto::INT,
             static_cast<int64_t>(128))
+      .Attr("bits",
+            "(Optional) Number of bits of the values packed in uint8 data, 4 or 8. Ignored for the other types.",
+            AttributeProto::INT,
+            static_cast<int64_t>(4))
       .Input(0, "data", "Tensor of rank r >= 1. Block-wise quantized.", "T1")
       .Input(1,
              "indices",
@@ -3601,7 +3735,7 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
       .Input(2, "scales", "quantization scale", "T2")
       .Input(3, "zero_points", "quantization zero points", "T1", OpSchema::Optional)
       .Output(0, "output", "Dequantized output tensor of rank q + (r - 1).", "T2")
-      .TypeConstraint("T1", {"tensor(int4)", "tensor(uint4)"}, "Constrain quantized types.")
+      .TypeConstraint("T1", {"tensor(int4)", "tensor(uint4)", "tensor(uint8)"}, "Constrain quantized types.")
       .TypeConstraint("T2", {"tensor(float)", "tensor(float16)", "tensor(bfloat16)"}, "Constrain dequantized types.")
       .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices to integer types.")
       .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
@@ -3611,9 +3745,10 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
         if (!hasNInputShapes(ctx, 3)) {
           return;
         }
-        const TensorShapeProto& data_shape = ctx.getInputType(0)->tensor_type().shape();
+        TensorShapeProto data_shape = ctx.getInputType(0)->tensor_type().shape();
         const TensorShapeProto& indices_shape = ctx.getInputType(1)->tensor_type().shape();
         const TensorShapeProto& scales_shape = ctx.getInputType(2)->tensor_type().shape();
+        const bool is_packed = ctx.getInputType(0)->tensor_type().elem_type() == TensorProto::UINT8;
         int r = data_shape.dim_size();
 
         if (r < 1) {
@@ -3636,6 +3771,21 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
         gather_axis = (gather_axis + r) % r;
         quantize_axis = (quantize_axis + r) % r;
 
+        auto bits = getAttribute(ctx, "bits", 4);
+        if (is_packed) {
+          if (bits != 4 && bits != 8) {
+            fail_shape_inference("bits must be 4 or 8");
+          }
+          if (quantize_axis != r - 1 || gather_axis == quantize_axis) {
+            fail_shape_inference("uint8 data must be quantized along the last axis and gathered along another one");
+          }
+          // the number of packed values
+          auto* last_dim = data_shape.mutable_dim(r - 1);
+          if (last_dim->has_dim_value()) {
+            last_dim->set_dim_value(last_dim->dim_value() * 8 / bits);
+          }
+        }
+
         if (scales_shape.dim_size() != r) {
           fail_shape_inference("scales must have the same rank as data");
         }
@@ -3661,8 +3811,10 @@ GatherBlockQuantized is a Gather with data quantized. It is similar to Gather (h
           }
 
           for (int i = 0; i < r; ++i) {
-            if (!zp_shape.dim(i).has_dim_value() ||
-                zp_shape.dim(i).dim_value() != scales_shape.dim(i).dim_value()) {
+            const int64_t expected_dim = (is_packed && i == r - 1)
+                                             ? (scales_shape.dim(i).dim_value() * bits + 7) / 8
+                                             : scales_shape.dim(i).dim_value();
+            if (!zp_shape.dim(i).has_dim_value() || zp_shape.dim(i).dim_value() != expected_dim) {
               fail_shape_inference("zero points shape and scales shape do not match");
             }
           }
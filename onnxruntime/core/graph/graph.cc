@@ -3,6 +3,7 @@
 
 #include "core/graph/graph.h"
 
+#include <atomic>
 #include <cassert>
 #include <fstream>
 #include <iostream>
@@ -198,6 +199,7 @@ NodeArg::NodeArg(const std::string& name, const TypeProto* p_node_arg_type) {
   } else {
     type_ = nullptr;
   }
+  UpdateTypeVersion();
 }
 #endif  // #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD) || defined(ORT_MINIMAL_BUILD_CUSTOM_OPS)
 
@@ -210,6 +212,7 @@ NodeArg::NodeArg(NodeArgInfo&& node_arg_info) {
   else {
     type_ = nullptr;
   }
+  UpdateTypeVersion();
 }
 
 const std::string& NodeArg::Name() const noexcept {
@@ -291,7 +294,30 @@ bool NodeArg::HasTensorOrScalarShape() const {
 }
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+static bool IsSameShape(const TensorShapeProto& lhs, const TensorShapeProto& rhs) {
+  if (lhs.dim_size() != rhs.dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < lhs.dim_size(); ++i) {
+    const auto& lhs_dim = lhs.dim(i);
+    const auto& rhs_dim = rhs.dim(i);
+    if (lhs_dim.value_case() != rhs_dim.value_case() || lhs_dim.denotation() != rhs_dim.denotation() ||
+        (utils::HasDimValue(lhs_dim) && lhs_dim.dim_value() != rhs_dim.dim_value()) ||
+        (utils::HasDimParam(lhs_dim) && lhs_dim.dim_param() != rhs_dim.dim_param())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 void NodeArg::SetShape(const TensorShapeProto& shape) {
+  // type and shape inferencing sets the shape of every output it infers, so keep the type version if nothing changes
+  if (const auto* current_shape = Shape(); current_shape != nullptr && IsSameShape(*current_shape, shape)) {
+    return;
+  }
+
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
@@ -320,9 +346,15 @@ void NodeArg::SetShape(const TensorShapeProto& shape) {
     default:
       return;
   }
+
+  UpdateTypeVersion();
 }
 
 void NodeArg::ClearShape() {
+  if (Shape() == nullptr) {
+    return;
+  }
+
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
@@ -352,12 +384,40 @@ void NodeArg::ClearShape() {
     default:
       return;
   }
+
+  UpdateTypeVersion();
 }
 
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
 #if !defined(ORT_MINIMAL_BUILD)
 
+// Returns the element type and shape of a tensor, sparse tensor or optional tensor type, which are the parts of the
+// type that NodeArg::UpdateTypeAndShape changes. The shape is nullptr if it is unknown.
+static std::pair<int32_t, const TensorShapeProto*> GetElemTypeAndShape(const TypeProto& type) {
+  switch (type.value_case()) {
+    case TypeProto::kTensorType:
+      return {type.tensor_type().elem_type(),
+              utils::HasShape(type.tensor_type()) ? &type.tensor_type().shape() : nullptr};
+#if !defined(DISABLE_SPARSE_TENSORS)
+    case TypeProto::kSparseTensorType:
+      return {type.sparse_tensor_type().elem_type(),
+              utils::HasShape(type.sparse_tensor_type()) ? &type.sparse_tensor_type().shape() : nullptr};
+#endif
+#if !defined(DISABLE_OPTIONAL_TYPE)
+    case TypeProto::kOptionalType:
+      if (utils::HasOptionalTensorType(type)) {
+        return GetElemTypeAndShape(utils::GetOptionalTypeProto(type));
+      }
+      break;
+#endif
+    default:
+      break;
+  }
+
+  return {TensorProto_DataType_UNDEFINED, nullptr};
+}
+
 common::Status NodeArg::OverrideTypesHelper(const ONNX_NAMESPACE::TypeProto& input_type,
                                             int32_t input_tensor_elem_type,
                                             int32_t current_tensor_elem_type,
@@ -395,6 +455,25 @@ common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& inpu
   const auto current_type_case = current_type.value_case();
   const auto input_type_case = input_type.value_case();
 
+  // the shape is merged in place. merging the same shape as the current one changes nothing, so the current shape is
+  // only kept to compare with the merged one when the input shape differs.
+  const auto previous = GetElemTypeAndShape(current_type);
+  const auto* input_shape = GetElemTypeAndShape(input_type).second;
+  std::optional<TensorShapeProto> previous_shape;
+  if (previous.second != nullptr && input_shape != nullptr && !IsSameShape(*previous.second, *input_shape)) {
+    previous_shape = *previous.second;
+  }
+
+  const int32_t previous_elem_type = previous.first;
+  const bool previous_has_shape = previous.second != nullptr;
+  auto update_type_version = gsl::finally([this, previous_elem_type, previous_has_shape, &previous_shape]() {
+    const auto [elem_type, shape] = GetElemTypeAndShape(node_arg_info_.type());
+    if (elem_type != previous_elem_type || (shape != nullptr) != previous_has_shape ||
+        (previous_shape.has_value() && shape != nullptr && !IsSameShape(*previous_shape, *shape))) {
+      UpdateTypeVersion();
+    }
+  });
+
   if (current_type_case != input_type_case)
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Type mismatch. Current=",
                            current_type_case, " Input=", input_type_case);
@@ -509,6 +588,7 @@ void NodeArg::SetType(DataType p_type) {
 
   type_ = p_type;
   *(node_arg_info_.mutable_type()) = DataTypeUtils::ToTypeProto(p_type);
+  UpdateTypeVersion();
 }
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
@@ -518,6 +598,7 @@ void NodeArg::SetType(DataType p_type) {
 void NodeArg::SetType(const TypeProto& type_proto) {
   type_ = DataTypeUtils::ToType(type_proto);
   *(node_arg_info_.mutable_type()) = type_proto;
+  UpdateTypeVersion();
 }
 
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -526,6 +607,12 @@ bool NodeArg::Exists() const noexcept {
   return exists_;
 }
 
+void NodeArg::UpdateTypeVersion() noexcept {
+  // NodeArgs are created by concurrent model loads
+  static std::atomic<uint64_t> last_type_version{0};
+  type_version_ = last_type_version.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 Node::EdgeEnd::EdgeEnd(const Node& node, int src_arg_index, int dst_arg_index) noexcept
     : node_(&node),
       src_arg_index_(src_arg_index),
@@ -987,6 +1074,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 
 void Node::AddAttributeProto(AttributeProto value) {
   utils::SetNodeAttribute(std::move(value), attributes_);
+  ++attributes_version_;
   if (graph_) {
     graph_->SetGraphResolveNeeded();
     graph_->SetGraphProtoSyncNeeded();
@@ -1037,6 +1125,7 @@ void Node::AddAttribute(std::string attr_name, GraphProto value) {
 bool Node::ClearAttribute(const std::string& attr_name) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  ++attributes_version_;
   return attributes_.erase(attr_name) > 0;
 }
 
@@ -1045,6 +1134,7 @@ bool Node::ClearAttribute(const std::string& attr_name) {
 int Node::PruneRemovableAttributes(gsl::span<const std::string> removable_attributes) {
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
+  ++attributes_version_;
   int n_removed = 0;
   for (const auto& name : removable_attributes) {
     n_removed += static_cast<int>(attributes_.erase(name));
@@ -1054,6 +1144,38 @@ int Node::PruneRemovableAttributes(gsl::span<const std::string> removable_attrib
 }
 
 #if !defined(ORT_MINIMAL_BUILD)
+bool Node::IsTypeInferenceUpToDate() const noexcept {
+  const auto& state = type_inference_state_;
+  if (state.op == nullptr || state.op != op_ || state.attributes_version != attributes_version_ ||
+      state.defs.size() != definitions_.input_defs.size() + definitions_.output_defs.size()) {
+    return false;
+  }
+
+  size_t i = 0;
+  for (const auto* defs : {&definitions_.input_defs, &definitions_.output_defs}) {
+    for (const NodeArg* def : *defs) {
+      if (state.defs[i].first != def || state.defs[i].second != def->TypeVersion()) {
+        return false;
+      }
+      ++i;
+    }
+  }
+
+  return true;
+}
+
+void Node::SetTypeInferenceUpToDate() {
+  auto& state = type_inference_state_;
+  state.op = op_;
+  state.attributes_version = attributes_version_;
+  state.defs.clear();
+  for (const auto* defs : {&definitions_.input_defs, &definitions_.output_defs}) {
+    for (const NodeArg* def : *defs) {
+      state.defs.emplace_back(def, def->TypeVersion());
+    }
+  }
+}
+
 Status Node::UpdateInputArgCount() {
   // The node refers to a primitive operator.
   // Infer and verify node input arg type information.
@@ -3128,6 +3250,13 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
     lsc.output_names.insert(std::string(input));
   }
 
+  // a node that is unchanged since it was last inferred, and whose inputs have the same types and shapes, infers the
+  // same output types and shapes. so only the nodes that were modified and the nodes downstream of them, whose
+  // inputs have a type or shape that changed, are inferred again.
+  // nodes with subgraphs, and the nodes in subgraphs, depend on outer scope values and are always inferred.
+  const bool incremental_inferencing = parent_node_ == nullptr && !options.override_types;
+  size_t num_inferred_nodes = 0;
+
   for (auto node_index : nodes_in_topological_order_) {
     // Node verification.
     auto& node = *GetNode(node_index);
@@ -3217,7 +3346,11 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
       }
     }
 
-    NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+    if (!incremental_inferencing || node.ContainsSubgraph() || !node.IsTypeInferenceUpToDate()) {
+      NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+      node.SetTypeInferenceUpToDate();
+      ++num_inferred_nodes;
+    }
 
     // Accumulate output names of the iterated Node
     for (const auto& output : node.OutputDefs()) {
@@ -3225,6 +3358,11 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
     }
   }
 
+  if (incremental_inferencing) {
+    LOGS(logger_, VERBOSE) << "Type and shape inferencing ran on " << num_inferred_nodes << " of "
+                           << nodes_in_topological_order_.size() << " nodes.";
+  }
+
   // verify subgraphs
   for (auto node_index : nodes_in_topological_order_) {
     auto& node = *GetNode(node_index);
@@ -3407,6 +3545,7 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
   const gsl::not_null<TensorProto*> tensor_added{graph_proto_->add_initializer()};
   *(tensor_added) = tensor;
   name_to_initial_tensor_.emplace(tensor.name(), tensor_added);
+  InitializerChanged(tensor.name());
   SetGraphResolveNeeded();
   if (!is_loaded_from_model_file_ && GetNodeArg(tensor.name()) == nullptr) {
     // make sure there is a NodeArg for the initializer as SetGraphInputsOutputs may add it to the graph inputs.
@@ -3495,6 +3634,7 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
   found = iter != name_to_initial_tensor_.end();
   if (found) {
     name_to_initial_tensor_.erase(iter);
+    InitializerChanged(tensor_name);
 #if !defined(DISABLE_SPARSE_TENSORS)
     sparse_tensor_names_.erase(tensor_name);
 #endif
@@ -3554,6 +3694,7 @@ Status Graph::ReplaceInitializedTensorImpl(ONNX_NAMESPACE::TensorProto new_initi
   ORT_ENFORCE(existing_entry != mutable_initializers.pointer_end(),
               "graph_proto_ is not in sync with name_to_initial_tensor_");
 
+  InitializerChanged(initializer_name);
   **existing_entry = std::move(new_initializer);
 
   return Status::OK();
@@ -4865,6 +5006,8 @@ Status Graph::AddConstantProtoAsInitializer(const ONNX_NAMESPACE::NodeProto& nod
   if (GetNodeArg(tensor->name()) == nullptr) {
     TypeProto t{TypeProtoFromTensorProto(*tensor)};
     ORT_IGNORE_RETURN_VALUE(GetOrCreateNodeArg(tensor->name(), &t));
+  } else {
+    InitializerChanged(tensor->name());
   }
 
 #if !defined(DISABLE_SPARSE_TENSORS)
@@ -1,8 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
 #include <memory>
+#include <string_view>
 #include "core/common/logging/logging.h"
+#include "core/common/narrow.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/flatbuffers/flatbuffers_utils.h"
 #include "core/framework/tensorprotoutils.h"
@@ -487,6 +490,206 @@ Status Model::Load(ModelProto&& model_proto,
   return status;
 }
 
+namespace {
+
+// Walks the wire format of a serialized ModelProto and copies it, except for the raw_data of initializers with at
+// least threshold bytes. Those initializers are given external data referring to the byte range of their raw_data in
+// the model file instead, so the large buffers are neither copied into the ModelProto nor into the rewritten bytes,
+// and the rest of the model can be parsed even when the file exceeds the 2GB protobuf limit.
+class LazyRawDataRewriter {
+ public:
+  LazyRawDataRewriter(gsl::span<const uint8_t> model_bytes, std::string location, size_t threshold)
+      : bytes_(model_bytes), location_(std::move(location)), threshold_(threshold) {}
+
+  Status Rewrite(std::string& out) const {
+    return RewriteMessage(MessageKind::kModel, 0, bytes_.size(), out);
+  }
+
+ private:
+  enum class MessageKind {
+    kNone,
+    kModel,
+    kGraph,
+    kNode,
+    kAttribute,
+    kTensor,
+  };
+
+  // field numbers from onnx.proto
+  static constexpr uint32_t kModelGraph = 7;
+  static constexpr uint32_t kGraphNode = 1;
+  static constexpr uint32_t kGraphInitializer = 5;
+  static constexpr uint32_t kNodeAttribute = 5;
+  static constexpr uint32_t kAttributeGraph = 6;
+  static constexpr uint32_t kAttributeGraphs = 11;
+  static constexpr uint32_t kTensorRawData = 9;
+  static constexpr uint32_t kTensorExternalData = 13;
+  static constexpr uint32_t kTensorDataLocation = 14;
+  static constexpr uint32_t kStringStringEntryKey = 1;
+  static constexpr uint32_t kStringStringEntryValue = 2;
+
+  static constexpr int kWireTypeVarint = 0;
+  static constexpr int kWireTypeFixed64 = 1;
+  static constexpr int kWireTypeLengthDelimited = 2;
+  static constexpr int kWireTypeFixed32 = 5;
+
+  // The messages that may contain initializers, directly or in a subgraph.
+  static MessageKind GetChildKind(MessageKind parent, uint32_t field) {
+    switch (parent) {
+      case MessageKind::kModel:
+        return field == kModelGraph ? MessageKind::kGraph : MessageKind::kNone;
+      case MessageKind::kGraph:
+        return field == kGraphInitializer ? MessageKind::kTensor
+                                          : (field == kGraphNode ? MessageKind::kNode : MessageKind::kNone);
+      case MessageKind::kNode:
+        return field == kNodeAttribute ? MessageKind::kAttribute : MessageKind::kNone;
+      case MessageKind::kAttribute:
+        return field == kAttributeGraph || field == kAttributeGraphs ? MessageKind::kGraph : MessageKind::kNone;
+      default:
+        return MessageKind::kNone;
+    }
+  }
+
+  Status ReadVarint(size_t& pos, size_t end, uint64_t& value) const {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      ORT_RETURN_IF(pos >= end, "Truncated varint in the model file.");
+      const uint8_t byte = bytes_[pos++];
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if ((byte & 0x80) == 0) {
+        return Status::OK();
+      }
+    }
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Malformed varint in the model file.");
+  }
+
+  static void WriteVarint(uint64_t value, std::string& out) {
+    while (value >= 0x80) {
+      out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+  }
+
+  static void WriteLengthDelimited(uint32_t field, std::string_view value, std::string& out) {
+    WriteVarint((static_cast<uint64_t>(field) << 3) | kWireTypeLengthDelimited, out);
+    WriteVarint(value.size(), out);
+    out.append(value);
+  }
+
+  static void WriteExternalDataEntry(std::string_view key, std::string_view value, std::string& out) {
+    std::string entry;
+    WriteLengthDelimited(kStringStringEntryKey, key, entry);
+    WriteLengthDelimited(kStringStringEntryValue, value, entry);
+    WriteLengthDelimited(kTensorExternalData, entry, out);
+  }
+
+  Status RewriteMessage(MessageKind kind, size_t begin, size_t end, std::string& out) const {
+    size_t raw_data_offset = 0;
+    size_t raw_data_length = 0;
+    bool raw_data_is_external = false;
+
+    size_t pos = begin;
+    while (pos < end) {
+      const size_t field_begin = pos;
+      uint64_t tag = 0;
+      ORT_RETURN_IF_ERROR(ReadVarint(pos, end, tag));
+      const auto field = static_cast<uint32_t>(tag >> 3);
+      const auto wire_type = static_cast<int>(tag & 0x7);
+
+      size_t length = 0;
+      switch (wire_type) {
+        case kWireTypeVarint: {
+          uint64_t value = 0;
+          ORT_RETURN_IF_ERROR(ReadVarint(pos, end, value));
+          break;
+        }
+        case kWireTypeFixed64:
+          length = 8;
+          break;
+        case kWireTypeFixed32:
+          length = 4;
+          break;
+        case kWireTypeLengthDelimited: {
+          uint64_t value = 0;
+          ORT_RETURN_IF_ERROR(ReadVarint(pos, end, value));
+          length = narrow<size_t>(value);
+          break;
+        }
+        default:
+          return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unsupported wire type ", wire_type, " in the model file.");
+      }
+      ORT_RETURN_IF(length > end - pos, "Truncated field ", field, " in the model file.");
+      const size_t value_begin = pos;
+      pos += length;
+
+      if (wire_type != kWireTypeLengthDelimited) {
+        out.append(reinterpret_cast<const char*>(bytes_.data()) + field_begin, pos - field_begin);
+        continue;
+      }
+
+      if (kind == MessageKind::kTensor && field == kTensorRawData && length >= threshold_) {
+        raw_data_offset = value_begin;
+        raw_data_length = length;
+        raw_data_is_external = true;
+        continue;
+      }
+
+      const MessageKind child_kind = GetChildKind(kind, field);
+      if (child_kind == MessageKind::kNone) {
+        out.append(reinterpret_cast<const char*>(bytes_.data()) + field_begin, pos - field_begin);
+        continue;
+      }
+
+      std::string child;
+      ORT_RETURN_IF_ERROR(RewriteMessage(child_kind, value_begin, pos, child));
+      WriteLengthDelimited(field, child, out);
+    }
+
+    if (raw_data_is_external) {
+      WriteExternalDataEntry("location", location_, out);
+      WriteExternalDataEntry("offset", std::to_string(raw_data_offset), out);
+      WriteExternalDataEntry("length", std::to_string(raw_data_length), out);
+      WriteVarint((static_cast<uint64_t>(kTensorDataLocation) << 3) | kWireTypeVarint, out);
+      WriteVarint(TensorProto_DataLocation_EXTERNAL, out);
+    }
+
+    return Status::OK();
+  }
+
+  gsl::span<const uint8_t> bytes_;
+  std::string location_;
+  size_t threshold_;
+};
+
+// Parse the model file through a memory mapping, leaving the large raw_data in the file. See LazyRawDataRewriter.
+Status LoadModelWithLazyRawData(const std::filesystem::path& file_path, size_t lazy_raw_data_threshold,
+                                ModelProto& model_proto) {
+  const Env& env = Env::Default();
+  size_t file_length = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(file_path.native().c_str(), file_length));
+
+  Env::MappedMemoryPtr mapped_model;
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(file_path.native().c_str(), 0, file_length, mapped_model));
+
+  // the external data location is relative to the directory of the model
+  LazyRawDataRewriter rewriter(gsl::make_span(reinterpret_cast<const uint8_t*>(mapped_model.get()), file_length),
+                               PathToUTF8String(file_path.filename().native()), lazy_raw_data_threshold);
+  std::string model_bytes;
+  ORT_RETURN_IF_ERROR(rewriter.Rewrite(model_bytes));
+  mapped_model.reset();
+
+  ORT_RETURN_IF(model_bytes.size() > static_cast<size_t>(std::numeric_limits<int>::max()),
+                "The model is larger than 2GB without the raw_data of its initializers over the lazy load threshold.");
+  if (!model_proto.ParseFromString(model_bytes)) {
+    return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
 template <typename T, typename Loader>
 static Status LoadModelHelper(const T& file_path, Loader loader) {
   int fd;
@@ -535,6 +738,17 @@ template <typename T>
 static Status LoadModel(const T& file_path, std::shared_ptr<Model>& p_model,
                         const IOnnxRuntimeOpSchemaRegistryList* local_registries,
                         const logging::Logger& logger, const ModelOptions& options) {
+  if (options.lazy_raw_data_threshold > 0) {
+    ModelProto model_proto;
+    const Status status = LoadModelWithLazyRawData(ToPathString(file_path), options.lazy_raw_data_threshold,
+                                                   model_proto);
+    if (status.IsOK()) {
+      return Model::Load(std::move(model_proto), ToPathString(file_path), p_model, local_registries, logger, options);
+    }
+    // fall back to parsing the whole file, which reports the errors of a missing or invalid model file as usual
+    LOGS(logger, INFO) << "Lazy raw_data load of " << ToUTF8String(file_path) << " failed: " << status.ErrorMessage();
+  }
+
   const auto loader = [&file_path, &p_model, local_registries, &logger, &options](int fd) {
     return Model::Load(fd, ToPathString(file_path), p_model, local_registries, logger, options);
   };
@@ -38,6 +38,11 @@ struct ModelOptions {
   // be returned.
   bool strict_shape_type_inference;
 
+  // If non-zero, a model loaded from a file is parsed without copying the raw_data of its initializers of at least
+  // this many bytes. Those are recorded as external data referring to their byte range in the model file instead,
+  // and are materialized (usually memory mapped) when the session state is created.
+  size_t lazy_raw_data_threshold = 0;
+
   ModelOptions(bool allow_released_opsets_only, bool strict_shape_type_inference)
       : allow_released_opsets_only(allow_released_opsets_only),
         strict_shape_type_inference(strict_shape_type_inference) {}
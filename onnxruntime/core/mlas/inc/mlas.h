@@ -73,6 +73,9 @@ Abstract:
 #if defined(__loongarch64)
 #define MLAS_TARGET_LARCH64
 #endif
+#if defined(__riscv) && (__riscv_xlen == 64)
+#define MLAS_TARGET_RISCV64
+#endif
 //
 // Define the support levels for the target architecture.
 //
@@ -95,6 +98,15 @@ Abstract:
 #endif // ARM64
 #endif // Visual Studio 16 or earlier does not support fp16 intrinsic
 
+//
+// Bfloat16 precision GEMM (SBGEMM) uses the bf16 instructions of ARM64 and the
+// AVX512-BF16 instructions of x64. The kernels are only built on Linux.
+//
+
+#if defined(__linux__) && (defined(__aarch64__) || defined(MLAS_TARGET_AMD64))
+#define MLAS_SBGEMM_SUPPORTED
+#endif
+
 //
 // Basic Linear Algebra Subprograms (BLAS) types.
 //
@@ -242,6 +254,43 @@ MlasGemmBatch(
     MLAS_THREADPOOL* ThreadPool
     );
 
+/**
+ * @brief Supply the shape of one problem of a grouped single precision gemm
+ */
+struct MLAS_SGEMM_GROUP_SHAPE {
+    size_t M = 0; /**< Supplies the number of rows of matrix A and matrix C. */
+    size_t N = 0; /**< Supplies the number of columns of matrix B and matrix C. */
+    size_t K = 0; /**< Supplies the number of columns of matrix A and the number of rows of matrix B. */
+};
+
+/**
+ * @brief  Grouped single precision matrix/matrix multiply operation (SGEMM)
+ *
+ *         Unlike MlasGemmBatch, each problem of the group has its own shape,
+ *         e.g. the token count routed to each expert of a mixture of experts
+ *         or each sequence of an unpadded batch. The problems are split into
+ *         tiles of similar cost that are balanced across the thread pool in a
+ *         single dispatch.
+ *
+ * @param TransA     Supplies the transpose operation for matrix A.
+ * @param TransB     Supplies the transpose operation for matrix B.
+ * @param Shapes     A array of problem shapes
+ * @param Data       A array of matrices data parameters
+ * @param GroupCount Supplies number of multiplications in this group
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasGemmGrouped(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    const MLAS_SGEMM_GROUP_SHAPE* Shapes,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t GroupCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 /**
  * @brief  Single precision matrix/matrix multiply operation (SGEMM)
  *
@@ -527,11 +576,13 @@ public:
         const float* Scale,
         const float* Bias,
         MLAS_QGEMM_OUTPUT_MODE Mode = MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
-        MLAS_QUANTIZATION_GRANULARITY QuantGran = MLAS_QUANTIZATION_GRANULARITY::PerMatrix) :
+        MLAS_QUANTIZATION_GRANULARITY QuantGran = MLAS_QUANTIZATION_GRANULARITY::PerMatrix,
+        const float* RowScale = nullptr) :
             Output_(Output),
             LeadingDimensionOutput_(LeadingDimensionOutput),
             Scale_(Scale),
             Bias_(Bias),
+            RowScale_(RowScale),
             OutputMode_(Mode),
             QuantGran_(QuantGran)
     {
@@ -565,6 +616,7 @@ private:
     size_t LeadingDimensionOutput_;
     const float* Scale_;
     const float* Bias_;
+    const float* RowScale_;
     MLAS_QGEMM_OUTPUT_MODE OutputMode_;
     MLAS_QUANTIZATION_GRANULARITY QuantGran_;
 };
@@ -697,6 +749,84 @@ MlasGemmPackB(
     void* PackedB
     );
 
+//
+// Block sparse single precision matrix/matrix multiply for pruned weights.
+// Matrix B is packed as the blocks of MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K rows by
+// MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N columns that have a non-zero element, and the
+// multiplication skips the zero blocks.
+//
+
+#define MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K 4
+#define MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N 16
+
+/**
+ * @brief Returns the size of the block sparse packing buffer of matrix B, or 0 if
+ *        the fraction of its blocks that are zero is below MinimumSparsity, in
+ *        which case the dense MlasGemm is expected to be faster.
+ *
+ * @param TransB          Supplies the transpose operation for matrix B.
+ * @param N               Supplies the number of columns of matrix B.
+ * @param K               Supplies the number of rows of matrix B.
+ * @param B               Supplies the address of matrix B.
+ * @param ldb             Supplies the first dimension of matrix B.
+ * @param MinimumSparsity Supplies the minimum fraction of zero blocks, in [0, 1].
+ */
+size_t
+MLASCALL
+MlasBlockSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    float MinimumSparsity
+    );
+
+/**
+ * @brief Packs the non-zero blocks of matrix B to a buffer sized by
+ *        MlasBlockSparseGemmPackBSize().
+ */
+void
+MLASCALL
+MlasBlockSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+/**
+ * @brief Computes C = alpha * A * B + beta * C with the block sparse packed
+ *        matrix B, skipping its zero blocks.
+ *
+ * @param M          Supplies the number of rows of matrix A and matrix C.
+ * @param A          Supplies the address of matrix A, not transposed.
+ * @param lda        Supplies the first dimension of matrix A.
+ * @param PackedB    Supplies the buffer packed by MlasBlockSparseGemmPackB(),
+ *                   which holds N and K.
+ * @param C          Supplies the address of matrix C.
+ * @param ldc        Supplies the first dimension of matrix C.
+ * @param alpha      Supplies the scalar multiplier of A * B.
+ * @param beta       Supplies the scalar multiplier of matrix C.
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasBlockSparseGemm(
+    size_t M,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc,
+    float alpha,
+    float beta,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -755,6 +885,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -820,6 +951,48 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Winograd F(4x4, 3x3) convolution routines. The filter is transformed and
+// packed once by MlasConvWinogradPackFilter, then a convolution prepared by
+// MlasConvPrepare is switched to the Winograd algorithm by
+// MlasConvWinogradPrepare and executed by MlasConv with the packed filter.
+//
+
+bool
+MLASCALL
+MlasConvWinogradIsSupported(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape
+    );
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t FilterCount,
+    size_t InputChannels
+    );
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    void* PackedFilter
+    );
+
+void
+MLASCALL
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasConvDepthwise(
@@ -1018,6 +1191,34 @@ MlasComputeSoftmax(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Softmax of attention scores fused with the scale, the additive attention bias
+// and the causal mask, whose masked tail is skipped and set to zero.
+//
+
+void
+MLASCALL
+MlasComputeAttentionSoftmax(
+    float* Scores,
+    size_t Ld,
+    const float* Bias,
+    size_t BiasLd,
+    size_t N,
+    size_t D,
+    float Scale,
+    ptrdiff_t CausalOffset,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasComputeLogSumExp(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D
+    );
+
 void
 MLASCALL
 MlasComputeTanh(
@@ -1075,6 +1276,44 @@ MlasTranspose(
     size_t N
     );
 
+//
+// Transpose routines for matrices with leading dimensions, used to transpose
+// a tile of a larger tensor.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    size_t ldInput,
+    uint8_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    size_t ldInput,
+    uint16_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    size_t ldInput,
+    uint32_t* Output,
+    size_t ldOutput,
+    size_t M,
+    size_t N
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -1328,6 +1567,41 @@ MlasFindMinMaxElement(
     size_t N
     );
 
+//
+// Zero point shared by all rows quantized by MlasDynamicQuantizeLinearPerRow.
+//
+
+constexpr uint8_t MLAS_DYNAMIC_QUANTIZE_ROW_ZERO_POINT = 128;
+
+/**
+ * @brief Dynamically quantize each row of a matrix to uint8 using a symmetric
+ *        per row scale. The zero point of every row is
+ *        MLAS_DYNAMIC_QUANTIZE_ROW_ZERO_POINT, so the output can be supplied
+ *        directly as matrix A of MlasGemm with the returned scales supplied
+ *        as the row scales of MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR.
+ *
+ * @param [IN]  Input       Supplies the M x K input matrix.
+ * @param [IN]  lda         Supplies the leading dimension of the input matrix.
+ * @param [OUT] Output      Returns the M x K quantized matrix.
+ * @param [IN]  ldo         Supplies the leading dimension of the output matrix.
+ * @param [OUT] Scale       Returns the M row scales.
+ * @param [IN]  M           Supplies the number of rows.
+ * @param [IN]  K           Supplies the number of columns.
+ * @param [IN]  ThreadPool  Optional thread pool for parallel processing.
+ */
+void
+MLASCALL
+MlasDynamicQuantizeLinearPerRow(
+    const float* Input,
+    size_t lda,
+    uint8_t* Output,
+    size_t ldo,
+    float* Scale,
+    size_t M,
+    size_t K,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 size_t
 MLASCALL
 MlasQLinearSafePaddingElementCount(
@@ -1435,6 +1709,37 @@ MLAS_FP16* Destination,
 size_t Count
 );
 
+//
+// 8-bit floating-point routines.
+//
+
+enum MLAS_FLOAT8_TYPE {
+    MlasFloat8E4M3FN,
+    MlasFloat8E4M3FNUZ,
+    MlasFloat8E5M2,
+    MlasFloat8E5M2FNUZ,
+};
+
+/**
+ * @brief Converts a buffer of 8-bit floating-point values to float, and multiplies them by Scale.
+ *        This is the per-tensor DequantizeLinear of the fp8 types, which have no zero point.
+ *
+ * @param Source        the fp8 values, with the bit layout of Type
+ * @param Destination   Count float values
+ * @param Count         number of values
+ * @param Type          the fp8 format of Source
+ * @param Scale         the factor the converted values are multiplied by
+ */
+void
+MLASCALL
+MlasConvertFloat8ToFloatBuffer(
+    const uint8_t* Source,
+    float* Destination,
+    size_t Count,
+    MLAS_FLOAT8_TYPE Type,
+    float Scale = 1.0f
+);
+
 /**
  * @brief rotary embedding for one hidden state vector
  *
@@ -1458,6 +1763,103 @@ MlasRotaryEmbedOneRow(
     T* output
 );
 
+/**
+ * @brief Layer normalization of the rows of a matrix.
+ *
+ * @tparam T: data type of input and output. Currently only float32/16 are supported.
+ * @param Input:      input matrix, of shape [N, D]
+ * @param Scale:      scale vector, of shape [D]
+ * @param Bias:       optional bias vector, of shape [D]
+ * @param Output:     output matrix, of shape [N, D]. May be the same as Input.
+ * @param Mean:       optional output buffer for the mean of each row, of shape [N]
+ * @param InvStdDev:  optional output buffer for the inverse standard deviation of each row, of shape [N]
+ * @param N:          number of rows
+ * @param D:          number of columns
+ * @param Epsilon:    value added to the variance to avoid dividing by zero
+ * @param ThreadPool: thread pool, nullptr to run on the calling thread
+ */
+template <typename T>
+void
+MLASCALL
+MlasLayerNormalization(
+    const T* Input,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+);
+
+/**
+ * @brief Root mean square normalization of the rows of a matrix.
+ *
+ * @tparam T: data type of input and output. Currently only float32/16 are supported.
+ * @param Input:      input matrix, of shape [N, D]
+ * @param Scale:      scale vector, of shape [D]
+ * @param Output:     output matrix, of shape [N, D]. May be the same as Input.
+ * @param InvStdDev:  optional output buffer for the inverse root mean square of each row, of shape [N]
+ * @param N:          number of rows
+ * @param D:          number of columns
+ * @param Epsilon:    value added to the mean square to avoid dividing by zero
+ * @param ThreadPool: thread pool, nullptr to run on the calling thread
+ */
+template <typename T>
+void
+MLASCALL
+MlasRmsNorm(
+    const T* Input,
+    const float* Scale,
+    T* Output,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+);
+
+/**
+ * @brief Layer normalization or root mean square normalization of the sum of
+ *        the rows of a matrix, a skip matrix and a bias vector.
+ *
+ * @tparam T: data type of input and outputs. Currently only float32/16 are supported.
+ * @param Input:            input matrix, of shape [N, D]
+ * @param Skip:             skip matrix, broadcast to the rows of the input matrix
+ * @param SkipSize:         number of elements of the skip matrix, a multiple of D
+ * @param Bias:             optional bias vector added to the input rows, of shape [D]
+ * @param Scale:            scale vector, of shape [D]
+ * @param ScaleBias:        optional bias vector added to the normalized rows, of shape [D].
+ *                          Ignored if Simplified is true.
+ * @param Output:           output matrix, of shape [N, D]
+ * @param InputSkipBiasSum: optional output matrix for the sum of the input, skip and bias, of shape [N, D]
+ * @param N:                number of rows
+ * @param D:                number of columns
+ * @param Epsilon:          value added to the variance to avoid dividing by zero
+ * @param Simplified:       whether to compute the root mean square normalization
+ * @param ThreadPool:       thread pool, nullptr to run on the calling thread
+ */
+template <typename T>
+void
+MLASCALL
+MlasSkipLayerNorm(
+    const T* Input,
+    const float* Skip,
+    size_t SkipSize,
+    const float* Bias,
+    const float* Scale,
+    const float* ScaleBias,
+    T* Output,
+    T* InputSkipBiasSum,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+);
+
     /**
  * @brief Whether current CPU supports FP16 acceleration.
 */
@@ -1666,7 +2068,7 @@ MlasHalfGemmConvertPackB(
     void* PackedB
     );
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 /**
  * @brief Whether current CPU supports Bfloat16(bf16) acceleration.
  */
@@ -1777,7 +2179,7 @@ MlasSBGemmPackBSize(size_t N, size_t K);
  */
 void MLASCALL
 MlasSBGemmConvertPackB(size_t N, size_t K, const float* B, size_t ldb, void* PackedB);
-#endif
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
 
 /**
  * @brief Indirect Depthwise convolution for fp16
@@ -1859,6 +2261,36 @@ MlasNhwcAvgPool(
     size_t KernelSize
     );
 
+enum MLAS_FP16_BINARY_OP {
+    MlasFp16Add,
+    MlasFp16Sub,
+    MlasFp16Mul,
+    MlasFp16Div,
+};
+
+/**
+ * @brief Binary element-wise arithmetic on fp16 vectors, C[i] = A[i] op B[i]
+ * @param Op        The arithmetic operation
+ * @param A         Address of the first operand
+ * @param StrideA   1 if A is a vector of N elements, 0 to broadcast the scalar A[0]
+ * @param B         Address of the second operand
+ * @param StrideB   1 if B is a vector of N elements, 0 to broadcast the scalar B[0]
+ * @param C         Address of the result, may alias a vector operand
+ * @param N         Number of elements
+ * @return
+*/
+void
+MLASCALL
+MlasEltwiseBinaryFp16(
+    MLAS_FP16_BINARY_OP Op,
+    const MLAS_FP16* A,
+    size_t StrideA,
+    const MLAS_FP16* B,
+    size_t StrideB,
+    MLAS_FP16* C,
+    size_t N
+    );
+
 #endif
 
 struct MlasFlashAttentionThreadedArgs {
@@ -1878,6 +2310,35 @@ struct MlasFlashAttentionThreadedArgs {
     const float* key;
     const float* value;
     float* output;
+    //
+    // The following members extend the kernel for GroupQueryAttention. Their defaults
+    // give the layout above: Q, K and V are contiguous BNSH tensors and nothing is masked.
+    //
+    // Number of heads of K and V. Query head n attends to kv head n / (num_heads / kv_num_heads).
+    // 0 means num_heads.
+    int kv_num_heads = 0;
+    // Sequence length of the K and V buffers, which may be longer than the valid tokens,
+    // e.g. a present buffer of the maximum sequence length. 0 means kv_sequence_length.
+    int kv_buffer_sequence_length = 0;
+    // Number of elements between the batches of Q, e.g. for packed QKV. 0 means
+    // num_heads * q_sequence_length * qk_head_size.
+    size_t q_batch_stride = 0;
+    // Number of valid tokens of K and V of each batch, at most kv_sequence_length.
+    // nullptr means kv_sequence_length for all batches.
+    const int* kv_sequence_lengths = nullptr;
+    // The queries are the last tokens of the sequence of each batch: query i of batch b is at
+    // position max(0, kv_len[b] - q_sequence_length) + i and only attends to the tokens up to it.
+    bool is_causal = false;
+    // If > 0, a query at position p only attends to the tokens in [p - local_window_size, p].
+    // Requires is_causal.
+    int local_window_size = -1;
+    // Packed sequences of variable length, like the PackedMultiHeadAttention operator. If not null,
+    // sequence b has the tokens [cumulative_sequence_lengths[b], cumulative_sequence_lengths[b + 1])
+    // of batch_size + 1 offsets, and Q, K, V and the output are token major without padding, i.e.
+    // (token_count, num_heads, head_size). The queries and the keys of a sequence are its tokens, and
+    // q_sequence_length and kv_sequence_length are the maximum sequence length. q_batch_stride,
+    // kv_buffer_sequence_length and kv_sequence_lengths are ignored.
+    const int* cumulative_sequence_lengths = nullptr;
 };
 
 /**
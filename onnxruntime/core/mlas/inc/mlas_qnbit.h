@@ -199,3 +199,31 @@ MlasQNBitGemmPackQuantBData(
     const void* QuantBZeroPoint,
     MLAS_THREADPOOL* ThreadPool
 );
+
+/**
+ * @brief Copies the quantized B data packed by MlasQNBitGemmPackQuantBData() to another buffer.
+ *
+ * The copy is divided between the threads of the thread pool along the columns of B, the way MlasQNBitGemmBatch()
+ * divides the columns of a matrix-vector product. When the thread pool is partitioned by NUMA node, the pages of
+ * each part of a newly allocated buffer are therefore first written, and placed, on the node that mostly reads them.
+ *
+ * @param[in]   N                   column size of matrix B and C
+ * @param[in]   K                   column size of matrix A and row size of matrix B
+ * @param[in]   BlkBitWidth         quantized value bit width (e.g., 4 means 4 bit ints)
+ * @param[in]   BlkLen              number of quantized values per block
+ * @param[in]   ComputeType         GEMM compute type (e.g., multiplying float or int8 values)
+ * @param[in]   PackedQuantBData    packed quantized B data, of size MlasQNBitGemmPackQuantBDataSize()
+ * @param[out]  Destination         buffer of the same size to copy the packed quantized B data to
+ * @param[in]   ThreadPool          thread pool to use (no parallel if nullptr)
+ */
+void MLASCALL
+MlasQNBitGemmCopyPackedQuantBData(
+    size_t N,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    MLAS_QNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const void* PackedQuantBData,
+    void* Destination,
+    MLAS_THREADPOOL* ThreadPool
+);
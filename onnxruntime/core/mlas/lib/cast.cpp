@@ -10,11 +10,15 @@ Module Name:
 
 Abstract:
 
-    This module implements Half (F16) to Single (F32) precision casting.
+    This module implements Half (F16) and 8-bit (F8) to Single (F32) precision
+    casting.
 
 --*/
 #include "mlasi.h"
 
+#include <cmath>
+#include <limits>
+
 void
 MLASCALL
 MlasConvertHalfToFloatBuffer(
@@ -50,3 +54,144 @@ MlasConvertFloatToHalfBuffer(
         GetMlasPlatform().CastF32ToF16Kernel(Source, reinterpret_cast<unsigned short*>(Destination), Count);
     }
 }
+
+namespace
+{
+
+float
+MlasFloat8ToFloat(
+    uint8_t Value,
+    MLAS_FLOAT8_TYPE Type
+    )
+/*++
+
+Routine Description:
+
+    This routine decodes a single 8-bit floating-point value.
+
+Arguments:
+
+    Value - Supplies the bits of the value.
+
+    Type - Supplies the format of the value. The FNUZ formats have a bias one
+        higher than the others, no negative zero and no infinity, and 0x80 is
+        their only NaN. E4M3FN has no infinity and 0x7F/0xFF are its NaNs.
+
+Return Value:
+
+    The value as float.
+
+--*/
+{
+    const bool IsE4M3 = Type == MlasFloat8E4M3FN || Type == MlasFloat8E4M3FNUZ;
+    const bool IsFnuz = Type == MlasFloat8E4M3FNUZ || Type == MlasFloat8E5M2FNUZ;
+    const int MantissaBits = IsE4M3 ? 3 : 2;
+    const int ExponentMask = IsE4M3 ? 0xF : 0x1F;
+    const int Bias = (IsE4M3 ? 7 : 15) + (IsFnuz ? 1 : 0);
+
+    const int Exponent = (Value >> MantissaBits) & ExponentMask;
+    const int Mantissa = Value & ((1 << MantissaBits) - 1);
+    const float Sign = (Value & 0x80) != 0 ? -1.0f : 1.0f;
+
+    if (IsFnuz) {
+        if (Value == 0x80) {
+            return std::numeric_limits<float>::quiet_NaN();
+        }
+    } else if (IsE4M3) {
+        if ((Value & 0x7F) == 0x7F) {
+            return std::numeric_limits<float>::quiet_NaN();
+        }
+    } else if (Exponent == ExponentMask) {
+        return Mantissa == 0 ? Sign * std::numeric_limits<float>::infinity()
+                             : std::numeric_limits<float>::quiet_NaN();
+    }
+
+    if (Exponent == 0) {
+        return Sign * std::ldexp(float(Mantissa), 1 - Bias - MantissaBits);
+    }
+
+    return Sign * std::ldexp(float(Mantissa + (1 << MantissaBits)), Exponent - Bias - MantissaBits);
+}
+
+struct MLAS_FLOAT8_TABLE {
+    float Values[256];
+
+    explicit MLAS_FLOAT8_TABLE(MLAS_FLOAT8_TYPE Type)
+    {
+        for (int i = 0; i < 256; ++i) {
+            Values[i] = MlasFloat8ToFloat(uint8_t(i), Type);
+        }
+    }
+};
+
+const float*
+MlasGetFloat8Table(
+    MLAS_FLOAT8_TYPE Type
+    )
+{
+    static const MLAS_FLOAT8_TABLE E4M3FN(MlasFloat8E4M3FN);
+    static const MLAS_FLOAT8_TABLE E4M3FNUZ(MlasFloat8E4M3FNUZ);
+    static const MLAS_FLOAT8_TABLE E5M2(MlasFloat8E5M2);
+    static const MLAS_FLOAT8_TABLE E5M2FNUZ(MlasFloat8E5M2FNUZ);
+
+    switch (Type) {
+        case MlasFloat8E4M3FN:
+            return E4M3FN.Values;
+        case MlasFloat8E4M3FNUZ:
+            return E4M3FNUZ.Values;
+        case MlasFloat8E5M2:
+            return E5M2.Values;
+        default:
+            return E5M2FNUZ.Values;
+    }
+}
+
+}  // namespace
+
+void
+MLASCALL
+MlasConvertFloat8ToFloatBuffer(
+    const uint8_t* Source,
+    float* Destination,
+    size_t Count,
+    MLAS_FLOAT8_TYPE Type,
+    float Scale
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of 8-bit floating-point values to float.
+    An fp8 value has only 256 encodings, so the conversion is a lookup in a
+    table of the decoded values, which is built once per format.
+
+Arguments:
+
+    Source - Supplies the fp8 values.
+
+    Destination - Supplies the buffer of Count float values.
+
+    Count - Supplies the number of values.
+
+    Type - Supplies the format of the values.
+
+    Scale - Supplies the factor the converted values are multiplied by.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* Table = MlasGetFloat8Table(Type);
+
+    if (Scale == 1.0f) {
+        for (size_t i = 0; i < Count; ++i) {
+            Destination[i] = Table[Source[i]];
+        }
+    } else {
+        for (size_t i = 0; i < Count; ++i) {
+            Destination[i] = Table[Source[i]] * Scale;
+        }
+    }
+}
@@ -987,3 +987,305 @@ Return Value:
 
     MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, ThreadCountN, ThreadPool);
 }
+
+//
+// Structure to maintain the context of the threaded attention softmax.
+//
+
+struct MLAS_ATTENTION_SOFTMAX_WORK_BLOCK {
+    ptrdiff_t ThreadCountN;
+    float* Scores;
+    size_t Ld;
+    const float* Bias;
+    size_t BiasLd;
+    size_t N;
+    size_t D;
+    float Scale;
+    ptrdiff_t CausalOffset;
+};
+
+void
+MlasComputeAttentionSoftmaxThreaded(
+    void* Context,
+    ptrdiff_t Index
+)
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of an
+    attention softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_ATTENTION_SOFTMAX_WORK_BLOCK*)Context;
+
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->N, &n, &CountN);
+
+    const size_t D = WorkBlock->D;
+    const float Scale = WorkBlock->Scale;
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+    const bool ApplyScale = (Scale != 1.0f);
+
+    for (; CountN > 0; n++, CountN--) {
+
+        float* Row = WorkBlock->Scores + n * WorkBlock->Ld;
+        const float* BiasRow = (WorkBlock->Bias != nullptr) ? WorkBlock->Bias + n * WorkBlock->BiasLd : nullptr;
+
+        //
+        // The causal mask hides the tail of the row, which is neither read
+        // nor exponentiated.
+        //
+
+        size_t Length = D;
+
+        if (WorkBlock->CausalOffset >= 0) {
+            Length = std::min(D, size_t(WorkBlock->CausalOffset) + n + 1);
+        }
+
+        //
+        // Apply the scale and the additive bias to the attended scores.
+        //
+
+        if (BiasRow != nullptr || ApplyScale) {
+
+            size_t d = 0;
+
+            if (BiasRow != nullptr) {
+
+                for (; d + 4 <= Length; d += 4) {
+                    MlasStoreFloat32x4(Row + d, MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Row + d),
+                                                                         ScaleVector,
+                                                                         MlasLoadFloat32x4(BiasRow + d)));
+                }
+
+                for (; d < Length; d++) {
+                    Row[d] = Row[d] * Scale + BiasRow[d];
+                }
+
+            } else {
+
+                for (; d + 4 <= Length; d += 4) {
+                    MlasStoreFloat32x4(Row + d, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Row + d), ScaleVector));
+                }
+
+                for (; d < Length; d++) {
+                    Row[d] *= Scale;
+                }
+            }
+        }
+
+        //
+        // Compute the softmax of the attended scores in place.
+        //
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
+        float Maximum = GetMlasPlatform().ReduceMaximumF32Kernel(Row, Length);
+#else
+        float Maximum = MlasReduceMaximumF32Kernel(Row, Length);
+#endif
+        float NegativeMaximum = -Maximum;
+
+#if defined(MLAS_TARGET_AMD64)
+        float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Row, Row, Length, &NegativeMaximum);
+#else
+        float Accumulation = MlasComputeSumExpF32Kernel(Row, Row, Length, &NegativeMaximum);
+#endif
+
+        float Parameters[] = {1.0f / Accumulation};
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
+        GetMlasPlatform().ComputeSoftmaxOutputF32Kernel(Row, Length, Parameters);
+#else
+        MlasComputeSoftmaxOutputF32Kernel(Row, Length, Parameters);
+#endif
+
+        std::fill(Row + Length, Row + D, 0.0f);
+    }
+}
+
+void
+MLASCALL
+MlasComputeAttentionSoftmax(
+    float* Scores,
+    size_t Ld,
+    const float* Bias,
+    size_t BiasLd,
+    size_t N,
+    size_t D,
+    float Scale,
+    ptrdiff_t CausalOffset,
+    MLAS_THREADPOOL* ThreadPool
+)
+/*++
+
+Routine Description:
+
+    This routine computes the softmax of rows of attention scores in place,
+    fused with the scale, the additive attention bias and the causal mask:
+
+        Scores[n, d] = Softmax(Scale * Scores[n, d] + Bias[n, d]) for d < L(n)
+        Scores[n, d] = 0 for L(n) <= d < D
+
+    where L(n) = min(D, CausalOffset + n + 1) with a causal mask, else D.
+
+Arguments:
+
+    Scores - Supplies the scores, which are replaced by the probabilities.
+
+    Ld - Supplies the number of elements between the rows of Scores.
+
+    Bias - Optionally supplies the additive attention bias.
+
+    BiasLd - Supplies the number of elements between the rows of Bias.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    Scale - Supplies the scale of the scores.
+
+    CausalOffset - Supplies the number of columns before the diagonal, i.e.
+        the position of the first row in the sequence of the columns, or -1
+        if there is no causal mask.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_ATTENTION_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Scores = Scores;
+    WorkBlock.Ld = Ld;
+    WorkBlock.Bias = Bias;
+    WorkBlock.BiasLd = BiasLd;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.Scale = Scale;
+    WorkBlock.CausalOffset = CausalOffset;
+
+    ptrdiff_t ThreadCountN = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCountN) > N) {
+        ThreadCountN = ptrdiff_t(N);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((N * D) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCountN) > BlockCount) {
+        ThreadCountN = ptrdiff_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCountN = ThreadCountN;
+
+    MlasExecuteThreaded(MlasComputeAttentionSoftmaxThreaded, &WorkBlock, ThreadCountN, ThreadPool);
+}
+
+void
+MLASCALL
+MlasComputeLogSumExp(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D
+)
+/*++
+
+Routine Description:
+
+    This routine computes the log of the sum of the exponentials of each row
+    of a matrix.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer, one element per row.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N > 0) {
+
+        //
+        // Find the maximum value for the row. The maximum is subtracted from
+        // each element to keep the exponentials in range.
+        //
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
+        float Maximum = GetMlasPlatform().ReduceMaximumF32Kernel(Input, D);
+#else
+        float Maximum = MlasReduceMaximumF32Kernel(Input, D);
+#endif
+
+        if (std::isfinite(Maximum)) {
+
+            float NegativeMaximum = -Maximum;
+
+#if defined(MLAS_TARGET_AMD64)
+            float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
+#else
+            float Accumulation = MlasComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
+#endif
+
+            *Output = std::log(Accumulation) + Maximum;
+
+        } else {
+
+            //
+            // The row contains an infinity or a NaN. Shift by the maximum of
+            // the finite elements instead so that the infinities propagate
+            // through the exponentials as they would without the shift.
+            //
+
+            float Shift = 0.0f;
+            bool HasFinite = false;
+
+            for (size_t d = 0; d < D; d++) {
+                if (std::isfinite(Input[d]) && (!HasFinite || Input[d] > Shift)) {
+                    Shift = Input[d];
+                    HasFinite = true;
+                }
+            }
+
+            float Accumulation = 0.0f;
+
+            for (size_t d = 0; d < D; d++) {
+                Accumulation += std::exp(Input[d] - Shift);
+            }
+
+            *Output = std::log(Accumulation) + Shift;
+        }
+
+        Input += D;
+        Output += 1;
+        N -= 1;
+    }
+}
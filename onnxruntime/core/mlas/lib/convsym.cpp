@@ -142,6 +142,17 @@ MlasConvSymDepthwiseKernelSize25ArmU8S8(
 #endif
 }
 
+#if defined(MLAS_TARGET_ARM64) && defined(__linux__)
+
+//
+// Define the prototypes of the NEON I8MM routines written with intrinsics.
+//
+
+MLAS_CONV_SYM_KERNEL MlasConvSymS8KernelI8mm;
+MLAS_CONV_SYM_KERNEL MlasConvSymU8KernelI8mm;
+
+#endif
+
 struct MLAS_CONV_SYM_DISPATCH {
     MLAS_CONV_SYM_KERNEL* Kernel;
 #if defined(MLAS_TARGET_ARM64)
@@ -299,6 +310,49 @@ const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchDot = {
     4,   // KernelDepthwiseOutputCount
     false
 };
+
+#if defined(__linux__)
+
+//
+// The I8MM kernels consume the unsigned input directly with USMMLA, so the
+// input zero point does not need the fixup used by the NEON kernels.
+//
+
+const MLAS_CONV_SYM_DISPATCH MlasConvSymU8DispatchI8mm = {
+    MlasConvSymU8KernelI8mm,
+    MlasConvSymU8KernelI8mm,
+    MlasConvSymDepthwiseU8KernelNeon,
+    MlasConvSymDepthwiseKernelSize9Arm64U8S8,
+    MlasConvSymDepthwiseKernelSize25ArmU8S8,
+    8,   // FilterInputChannelPackCount
+    16,  // FilterOutputChannelPackCount
+    0,   // KernelChannelCount
+    4,   // KernelOutputCount
+    8,   // KernelInputChannelAlignment
+    16,  // KernelOutputChannelAlignment
+    16,  // KernelDepthwiseChannelCount
+    4,   // KernelDepthwiseOutputCount
+    false
+};
+
+const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchI8mm = {
+    MlasConvSymS8KernelI8mm,
+    MlasConvSymS8KernelI8mm,
+    MlasConvSymDepthwiseS8KernelNeon,
+    MlasConvSymDepthwiseKernelSize9Arm64S8S8,
+    MlasConvSymDepthwiseKernelSize25ArmS8S8,
+    8,   // FilterInputChannelPackCount
+    16,  // FilterOutputChannelPackCount
+    0,   // KernelChannelCount
+    4,   // KernelOutputCount
+    8,   // KernelInputChannelAlignment
+    16,  // KernelOutputChannelAlignment
+    16,  // KernelDepthwiseChannelCount
+    4,   // KernelDepthwiseOutputCount
+    false
+};
+
+#endif // __linux__
 #endif // MLAS_TARGET_AMD64
 
 MLAS_FORCEINLINE
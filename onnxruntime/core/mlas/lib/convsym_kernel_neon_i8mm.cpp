@@ -0,0 +1,286 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convsym_kernel_neon_i8mm.cpp
+
+Abstract:
+
+    This module implements the symmetric quantized integer convolution
+    kernels for ARM64 processors that support the I8MM extension.
+
+    The kernels multiply 2x8 blocks of the input (two output pixels by eight
+    input channels) with 8x2 blocks of the filter (eight input channels by
+    two output channels) using SMMLA for signed inputs and USMMLA for
+    unsigned inputs. The filter is packed by MlasConvSymPackW with an input
+    channel pack count of 8 and an output channel pack count of 16, so each
+    16 byte load of the packed filter is one 8x2 block. The accumulators are
+    requantized and stored to the NHWC output without leaving the kernel.
+
+--*/
+
+#include <arm_neon.h>
+
+#include "mlasi.h"
+
+//
+// Number of output pixels and output channels computed by one iteration of
+// the kernel.
+//
+
+constexpr size_t MLAS_CONV_SYM_I8MM_OUTPUT_COUNT = 4;
+constexpr size_t MLAS_CONV_SYM_I8MM_CHANNEL_COUNT = 16;
+
+template <bool InputIsSigned>
+MLAS_FORCEINLINE
+int32x4_t
+MlasConvSymI8mmAccumulate(
+    int32x4_t Accumulator,
+    uint8x16_t Input,
+    int8x16_t Filter
+    );
+
+template <>
+MLAS_FORCEINLINE
+int32x4_t
+MlasConvSymI8mmAccumulate<true>(
+    int32x4_t Accumulator,
+    uint8x16_t Input,
+    int8x16_t Filter
+    )
+{
+    return vmmlaq_s32(Accumulator, vreinterpretq_s8_u8(Input), Filter);
+}
+
+template <>
+MLAS_FORCEINLINE
+int32x4_t
+MlasConvSymI8mmAccumulate<false>(
+    int32x4_t Accumulator,
+    uint8x16_t Input,
+    int8x16_t Filter
+    )
+{
+    return vusmmlaq_s32(Accumulator, Input, Filter);
+}
+
+template <bool InputIsSigned>
+MLAS_FORCEINLINE
+void
+MlasConvSymI8mmStoreOutput(
+    void* Output,
+    int16x8_t Low,
+    int16x8_t High
+    );
+
+template <>
+MLAS_FORCEINLINE
+void
+MlasConvSymI8mmStoreOutput<true>(
+    void* Output,
+    int16x8_t Low,
+    int16x8_t High
+    )
+{
+    vst1q_s8(static_cast<int8_t*>(Output), vcombine_s8(vqmovn_s16(Low), vqmovn_s16(High)));
+}
+
+template <>
+MLAS_FORCEINLINE
+void
+MlasConvSymI8mmStoreOutput<false>(
+    void* Output,
+    int16x8_t Low,
+    int16x8_t High
+    )
+{
+    vst1q_u8(static_cast<uint8_t*>(Output), vcombine_u8(vqmovun_s16(Low), vqmovun_s16(High)));
+}
+
+template <bool InputIsSigned>
+void
+MlasConvSymKernelI8mm(
+    const void* Input,
+    const void* Filter,
+    void* Output,
+    size_t KernelSize,
+    size_t InputChannels,
+    size_t OutputChannels,
+    unsigned ChannelCount,
+    unsigned OutputCount,
+    const MLAS_CONV_SYM_POST_PROCESS_PARAMS* PostProcessParams,
+    unsigned KernelFlags
+    )
+/*++
+
+Routine Description:
+
+    This routine computes up to four output pixels for all of the supplied
+    output channels.
+
+Arguments:
+
+    Input - Supplies the indirection buffer of the input pixels, else the
+        address of the first input pixel if MLAS_CONV_SYM_FLAG_INPUT_DIRECT
+        is set.
+
+    Filter - Supplies the packed filter.
+
+    Output - Supplies the address of the first output pixel.
+
+    KernelSize - Supplies the number of kernel positions.
+
+    InputChannels - Supplies the number of input channels, which must be a
+        multiple of 8.
+
+    OutputChannels - Supplies the stride of the output pixels.
+
+    ChannelCount - Supplies the number of output channels to compute, which
+        must be a multiple of 16.
+
+    OutputCount - Supplies the number of output pixels to compute.
+
+    PostProcessParams - Supplies the parameters of the requantization.
+
+    KernelFlags - Supplies the MLAS_CONV_SYM_FLAG_* flags.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const bool InputDirect = (KernelFlags & MLAS_CONV_SYM_FLAG_INPUT_DIRECT) != 0;
+    const bool PerChannelScale = (KernelFlags & MLAS_CONV_SYM_FLAG_PER_CHANNEL_SCALE) != 0;
+
+    const float32x4_t MinimumValue = vdupq_n_f32(PostProcessParams->MinimumValue);
+    const float32x4_t MaximumValue = vdupq_n_f32(PostProcessParams->MaximumValue);
+    const int32x4_t OutputZeroPoint = vdupq_n_s32(PostProcessParams->OutputZeroPoint);
+
+    const int8_t* filter = static_cast<const int8_t*>(Filter);
+
+    for (size_t oc = 0; oc < ChannelCount; oc += MLAS_CONV_SYM_I8MM_CHANNEL_COUNT) {
+
+        //
+        // Accumulators for the pixel pairs {0, 1} and {2, 3} by the output
+        // channel pairs of this block.
+        //
+
+        int32x4_t Accumulators[2][MLAS_CONV_SYM_I8MM_CHANNEL_COUNT / 2];
+
+        for (size_t j = 0; j < MLAS_CONV_SYM_I8MM_CHANNEL_COUNT / 2; j++) {
+            Accumulators[0][j] = vdupq_n_s32(0);
+            Accumulators[1][j] = vdupq_n_s32(0);
+        }
+
+        for (size_t k = 0; k < KernelSize; k++) {
+
+            //
+            // Resolve the input rows of this kernel position. The rows past
+            // the output count repeat the last row and are not stored.
+            //
+
+            const uint8_t* Rows[MLAS_CONV_SYM_I8MM_OUTPUT_COUNT];
+
+            for (size_t p = 0; p < MLAS_CONV_SYM_I8MM_OUTPUT_COUNT; p++) {
+                const size_t pixel = std::min<size_t>(p, OutputCount - 1);
+                if (InputDirect) {
+                    Rows[p] = static_cast<const uint8_t*>(Input) + pixel * InputChannels;
+                } else {
+                    Rows[p] = static_cast<const uint8_t*>(static_cast<const void* const*>(Input)[pixel * KernelSize + k]);
+                }
+            }
+
+            for (size_t ic = 0; ic < InputChannels; ic += 8) {
+
+                const uint8x16_t Input01 = vcombine_u8(vld1_u8(Rows[0] + ic), vld1_u8(Rows[1] + ic));
+                const uint8x16_t Input23 = vcombine_u8(vld1_u8(Rows[2] + ic), vld1_u8(Rows[3] + ic));
+
+                for (size_t j = 0; j < MLAS_CONV_SYM_I8MM_CHANNEL_COUNT / 2; j++) {
+                    const int8x16_t FilterBlock = vld1q_s8(filter);
+                    filter += 16;
+                    Accumulators[0][j] = MlasConvSymI8mmAccumulate<InputIsSigned>(Accumulators[0][j], Input01, FilterBlock);
+                    Accumulators[1][j] = MlasConvSymI8mmAccumulate<InputIsSigned>(Accumulators[1][j], Input23, FilterBlock);
+                }
+            }
+        }
+
+        //
+        // Each accumulator holds {pixel 2i, pixel 2i + 1} x {channel 2j, channel 2j + 1},
+        // so interleave the 64-bit halves of adjacent accumulators to form rows
+        // of four channels for a pixel.
+        //
+
+        for (size_t p = 0; p < OutputCount && p < MLAS_CONV_SYM_I8MM_OUTPUT_COUNT; p++) {
+
+            const int32x4_t* PairAccumulators = Accumulators[p / 2];
+            int32x4_t Values[4];
+
+            for (size_t q = 0; q < 4; q++) {
+
+                const int64x2_t Even = vreinterpretq_s64_s32(PairAccumulators[2 * q]);
+                const int64x2_t Odd = vreinterpretq_s64_s32(PairAccumulators[2 * q + 1]);
+
+                int32x4_t Value = vreinterpretq_s32_s64((p & 1) ? vzip2q_s64(Even, Odd) : vzip1q_s64(Even, Odd));
+
+                Value = vaddq_s32(Value, vld1q_s32(PostProcessParams->Bias + oc + 4 * q));
+
+                const float32x4_t Scale = PerChannelScale ? vld1q_f32(PostProcessParams->Scale + oc + 4 * q)
+                                                          : vdupq_n_f32(PostProcessParams->Scale[0]);
+
+                float32x4_t FloatValue = vmulq_f32(vcvtq_f32_s32(Value), Scale);
+                FloatValue = vminq_f32(vmaxq_f32(FloatValue, MinimumValue), MaximumValue);
+
+                Values[q] = vaddq_s32(vcvtnq_s32_f32(FloatValue), OutputZeroPoint);
+            }
+
+            const int16x8_t Low = vcombine_s16(vqmovn_s32(Values[0]), vqmovn_s32(Values[1]));
+            const int16x8_t High = vcombine_s16(vqmovn_s32(Values[2]), vqmovn_s32(Values[3]));
+
+            MlasConvSymI8mmStoreOutput<InputIsSigned>(
+                static_cast<uint8_t*>(Output) + p * OutputChannels + oc, Low, High);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasConvSymS8KernelI8mm(
+    const void* Input,
+    const void* Filter,
+    void* Output,
+    size_t KernelSize,
+    size_t InputChannels,
+    size_t OutputChannels,
+    unsigned ChannelCount,
+    unsigned OutputCount,
+    const MLAS_CONV_SYM_POST_PROCESS_PARAMS* PostProcessParams,
+    unsigned KernelFlags
+    )
+{
+    MlasConvSymKernelI8mm<true>(Input, Filter, Output, KernelSize, InputChannels, OutputChannels,
+                                ChannelCount, OutputCount, PostProcessParams, KernelFlags);
+}
+
+void
+MLASCALL
+MlasConvSymU8KernelI8mm(
+    const void* Input,
+    const void* Filter,
+    void* Output,
+    size_t KernelSize,
+    size_t InputChannels,
+    size_t OutputChannels,
+    unsigned ChannelCount,
+    unsigned OutputCount,
+    const MLAS_CONV_SYM_POST_PROCESS_PARAMS* PostProcessParams,
+    unsigned KernelFlags
+    )
+{
+    MlasConvSymKernelI8mm<false>(Input, Filter, Output, KernelSize, InputChannels, OutputChannels,
+                                 ChannelCount, OutputCount, PostProcessParams, KernelFlags);
+}
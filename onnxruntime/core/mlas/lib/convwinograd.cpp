@@ -0,0 +1,775 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convwinograd.cpp
+
+Abstract:
+
+    This module implements the single precision Winograd F(4x4, 3x3)
+    convolution for 3x3 kernels with unit strides and dilations.
+
+    The filter is transformed once to 36 matrices of shape [InputChannels,
+    FilterCount] that are packed for the SGEMM kernels. The convolution then
+    transforms blocks of 6x6 input tiles, multiplies the 36 transformed
+    matrices, and transforms the products back to 4x4 output tiles. This
+    reduces the multiplies per output element and input channel from 9 to
+    2.25.
+
+--*/
+
+#include "mlasi.h"
+
+#include <vector>
+
+//
+// Size of the output tile and of the transformed tile.
+//
+
+constexpr size_t MLAS_WINOGRAD_OUTPUT_TILE = 4;
+constexpr size_t MLAS_WINOGRAD_INPUT_TILE = 6;
+constexpr size_t MLAS_WINOGRAD_POINTS = MLAS_WINOGRAD_INPUT_TILE * MLAS_WINOGRAD_INPUT_TILE;
+
+//
+// Target number of tiles transformed and multiplied together by a thread.
+//
+
+constexpr size_t MLAS_WINOGRAD_TILE_BLOCK = 32;
+
+//
+// Smallest channel counts where the transforms are amortized by the savings
+// in the matrix multiplies.
+//
+
+constexpr size_t MLAS_WINOGRAD_MINIMUM_INPUT_CHANNELS = 16;
+constexpr size_t MLAS_WINOGRAD_MINIMUM_FILTER_COUNT = 16;
+
+struct MLAS_WINOGRAD_TILING {
+    size_t TilesHeight;
+    size_t TilesWidth;
+    size_t RowsPerBlock;
+    size_t ColumnsPerBlock;
+    size_t BlocksHeight;
+    size_t BlocksWidth;
+    size_t TileBlock;
+};
+
+struct MLAS_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* PackedFilter;
+    const float* Bias;
+    float* WorkingBuffer;
+    float* Output;
+    MLAS_WINOGRAD_TILING Tiling;
+};
+
+MLAS_FORCEINLINE
+size_t
+MlasConvWinogradAlignedFilterCount(
+    size_t FilterCount
+    )
+{
+    return (FilterCount + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) & ~(MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1);
+}
+
+MLAS_FORCEINLINE
+size_t
+MlasConvWinogradPackedPointSize(
+    size_t FilterCount,
+    size_t InputChannels
+    )
+{
+    return MlasGemmPackBSize(FilterCount, InputChannels);
+}
+
+void
+MlasConvWinogradComputeTiling(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    MLAS_WINOGRAD_TILING* Tiling
+    )
+/*++
+
+Routine Description:
+
+    This routine partitions the output tiles of an image into the blocks of
+    tiles processed together. Narrow images use blocks of complete tile rows
+    and wide images use blocks of partial tile rows.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Tiling - Returns the tiling of the output image.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    Tiling->TilesHeight = (Parameters->OutputShape[0] + MLAS_WINOGRAD_OUTPUT_TILE - 1) / MLAS_WINOGRAD_OUTPUT_TILE;
+    Tiling->TilesWidth = (Parameters->OutputShape[1] + MLAS_WINOGRAD_OUTPUT_TILE - 1) / MLAS_WINOGRAD_OUTPUT_TILE;
+
+    if (Tiling->TilesWidth >= MLAS_WINOGRAD_TILE_BLOCK) {
+        Tiling->RowsPerBlock = 1;
+        Tiling->ColumnsPerBlock = MLAS_WINOGRAD_TILE_BLOCK;
+    } else {
+        Tiling->RowsPerBlock = std::min(Tiling->TilesHeight, MLAS_WINOGRAD_TILE_BLOCK / Tiling->TilesWidth);
+        Tiling->ColumnsPerBlock = Tiling->TilesWidth;
+    }
+
+    Tiling->BlocksHeight = (Tiling->TilesHeight + Tiling->RowsPerBlock - 1) / Tiling->RowsPerBlock;
+    Tiling->BlocksWidth = (Tiling->TilesWidth + Tiling->ColumnsPerBlock - 1) / Tiling->ColumnsPerBlock;
+    Tiling->TileBlock = Tiling->RowsPerBlock * Tiling->ColumnsPerBlock;
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradTransformFilterTile(
+    const float* g,
+    float* U,
+    size_t PointStride
+    )
+/*++
+
+Routine Description:
+
+    This routine computes G * g * G^T for a 3x3 filter tile and stores the
+    36 transformed values with the supplied stride.
+
+--*/
+{
+    float t[MLAS_WINOGRAD_INPUT_TILE][3];
+
+    for (size_t j = 0; j < 3; j++) {
+
+        const float g0 = g[0 * 3 + j];
+        const float g1 = g[1 * 3 + j];
+        const float g2 = g[2 * 3 + j];
+
+        t[0][j] = g0 * (1.0f / 4.0f);
+        t[1][j] = (g0 + g1 + g2) * (-1.0f / 6.0f);
+        t[2][j] = (g0 - g1 + g2) * (-1.0f / 6.0f);
+        t[3][j] = g0 * (1.0f / 24.0f) + g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+        t[4][j] = g0 * (1.0f / 24.0f) - g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+        t[5][j] = g2;
+    }
+
+    for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+
+        const float g0 = t[i][0];
+        const float g1 = t[i][1];
+        const float g2 = t[i][2];
+
+        float* u = U + i * MLAS_WINOGRAD_INPUT_TILE * PointStride;
+
+        u[0 * PointStride] = g0 * (1.0f / 4.0f);
+        u[1 * PointStride] = (g0 + g1 + g2) * (-1.0f / 6.0f);
+        u[2 * PointStride] = (g0 - g1 + g2) * (-1.0f / 6.0f);
+        u[3 * PointStride] = g0 * (1.0f / 24.0f) + g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+        u[4 * PointStride] = g0 * (1.0f / 24.0f) - g1 * (1.0f / 12.0f) + g2 * (1.0f / 6.0f);
+        u[5 * PointStride] = g2;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradTransformInputTile(
+    const float d[MLAS_WINOGRAD_INPUT_TILE][MLAS_WINOGRAD_INPUT_TILE],
+    float* V,
+    size_t PointStride
+    )
+/*++
+
+Routine Description:
+
+    This routine computes B^T * d * B for a 6x6 input tile and stores the 36
+    transformed values with the supplied stride.
+
+--*/
+{
+    float t[MLAS_WINOGRAD_INPUT_TILE][MLAS_WINOGRAD_INPUT_TILE];
+
+    for (size_t j = 0; j < MLAS_WINOGRAD_INPUT_TILE; j++) {
+
+        const float d0 = d[0][j];
+        const float d1 = d[1][j];
+        const float d2 = d[2][j];
+        const float d3 = d[3][j];
+        const float d4 = d[4][j];
+        const float d5 = d[5][j];
+
+        t[0][j] = 4.0f * d0 - 5.0f * d2 + d4;
+        t[1][j] = -4.0f * (d1 + d2) + d3 + d4;
+        t[2][j] = 4.0f * (d1 - d2) - d3 + d4;
+        t[3][j] = 2.0f * (d3 - d1) - d2 + d4;
+        t[4][j] = 2.0f * (d1 - d3) - d2 + d4;
+        t[5][j] = 4.0f * d1 - 5.0f * d3 + d5;
+    }
+
+    for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+
+        const float d0 = t[i][0];
+        const float d1 = t[i][1];
+        const float d2 = t[i][2];
+        const float d3 = t[i][3];
+        const float d4 = t[i][4];
+        const float d5 = t[i][5];
+
+        float* v = V + i * MLAS_WINOGRAD_INPUT_TILE * PointStride;
+
+        v[0 * PointStride] = 4.0f * d0 - 5.0f * d2 + d4;
+        v[1 * PointStride] = -4.0f * (d1 + d2) + d3 + d4;
+        v[2 * PointStride] = 4.0f * (d1 - d2) - d3 + d4;
+        v[3 * PointStride] = 2.0f * (d3 - d1) - d2 + d4;
+        v[4 * PointStride] = 2.0f * (d1 - d3) - d2 + d4;
+        v[5 * PointStride] = 4.0f * d1 - 5.0f * d3 + d5;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradTransformOutputTile(
+    const float* Y,
+    size_t PointStride,
+    float o[MLAS_WINOGRAD_OUTPUT_TILE][MLAS_WINOGRAD_OUTPUT_TILE]
+    )
+/*++
+
+Routine Description:
+
+    This routine computes A^T * m * A for the 36 products of a tile read with
+    the supplied stride.
+
+--*/
+{
+    float t[MLAS_WINOGRAD_OUTPUT_TILE][MLAS_WINOGRAD_INPUT_TILE];
+
+    for (size_t j = 0; j < MLAS_WINOGRAD_INPUT_TILE; j++) {
+
+        const float m0 = Y[(0 * MLAS_WINOGRAD_INPUT_TILE + j) * PointStride];
+        const float m1 = Y[(1 * MLAS_WINOGRAD_INPUT_TILE + j) * PointStride];
+        const float m2 = Y[(2 * MLAS_WINOGRAD_INPUT_TILE + j) * PointStride];
+        const float m3 = Y[(3 * MLAS_WINOGRAD_INPUT_TILE + j) * PointStride];
+        const float m4 = Y[(4 * MLAS_WINOGRAD_INPUT_TILE + j) * PointStride];
+        const float m5 = Y[(5 * MLAS_WINOGRAD_INPUT_TILE + j) * PointStride];
+
+        t[0][j] = m0 + (m1 + m2) + (m3 + m4);
+        t[1][j] = (m1 - m2) + 2.0f * (m3 - m4);
+        t[2][j] = (m1 + m2) + 4.0f * (m3 + m4);
+        t[3][j] = (m1 - m2) + 8.0f * (m3 - m4) + m5;
+    }
+
+    for (size_t i = 0; i < MLAS_WINOGRAD_OUTPUT_TILE; i++) {
+
+        const float m0 = t[i][0];
+        const float m1 = t[i][1];
+        const float m2 = t[i][2];
+        const float m3 = t[i][3];
+        const float m4 = t[i][4];
+        const float m5 = t[i][5];
+
+        o[i][0] = m0 + (m1 + m2) + (m3 + m4);
+        o[i][1] = (m1 - m2) + 2.0f * (m3 - m4);
+        o[i][2] = (m1 + m2) + 4.0f * (m3 + m4);
+        o[i][3] = (m1 - m2) + 8.0f * (m3 - m4) + m5;
+    }
+}
+
+void
+MlasConvWinogradProcessBlock(
+    const MLAS_WINOGRAD_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    const float* Bias,
+    float* Output,
+    size_t TileRowStart,
+    size_t TileColumnStart,
+    float* WorkingBuffer
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the output tiles of one block of an image.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the convolution and the
+        tiling of the output image.
+
+    Input - Supplies the input image.
+
+    Bias - Optionally supplies the bias vector.
+
+    Output - Supplies the output image.
+
+    TileRowStart - Supplies the first tile row of the block.
+
+    TileColumnStart - Supplies the first tile column of the block.
+
+    WorkingBuffer - Supplies the working buffer of this thread.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+    const MLAS_WINOGRAD_TILING& Tiling = WorkBlock->Tiling;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const float Beta = Parameters->Beta;
+
+    const size_t TileRows = std::min(Tiling.RowsPerBlock, Tiling.TilesHeight - TileRowStart);
+    const size_t TileColumns = std::min(Tiling.ColumnsPerBlock, Tiling.TilesWidth - TileColumnStart);
+    const size_t TileCount = TileRows * TileColumns;
+
+    //
+    // The transformed input is laid out as 36 matrices of [TileBlock, InputChannels]
+    // followed by the products laid out as 36 matrices of [TileBlock, FilterCount].
+    //
+
+    const size_t InputPointStride = Tiling.TileBlock * InputChannels;
+    const size_t OutputPointStride = Tiling.TileBlock * FilterCount;
+
+    float* V = WorkingBuffer;
+    float* Y = WorkingBuffer + MLAS_WINOGRAD_POINTS * InputPointStride;
+
+    //
+    // Transform the input tiles.
+    //
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* input = Input + c * InputSize;
+
+        for (size_t tile = 0; tile < TileCount; tile++) {
+
+            const size_t tr = TileRowStart + tile / TileColumns;
+            const size_t tc = TileColumnStart + tile % TileColumns;
+
+            //
+            // Read the 6x6 input tile, treating the padding as zeros. The
+            // unsigned coordinates wrap around for the leading padding.
+            //
+
+            const size_t ih0 = tr * MLAS_WINOGRAD_OUTPUT_TILE - PaddingTop;
+            const size_t iw0 = tc * MLAS_WINOGRAD_OUTPUT_TILE - PaddingLeft;
+
+            float d[MLAS_WINOGRAD_INPUT_TILE][MLAS_WINOGRAD_INPUT_TILE];
+
+            if (ih0 + MLAS_WINOGRAD_INPUT_TILE <= InputHeight && iw0 + MLAS_WINOGRAD_INPUT_TILE <= InputWidth &&
+                ih0 < InputHeight && iw0 < InputWidth) {
+
+                for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+                    const float* row = input + (ih0 + i) * InputWidth + iw0;
+                    for (size_t j = 0; j < MLAS_WINOGRAD_INPUT_TILE; j++) {
+                        d[i][j] = row[j];
+                    }
+                }
+
+            } else {
+
+                for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+                    const size_t ih = ih0 + i;
+                    for (size_t j = 0; j < MLAS_WINOGRAD_INPUT_TILE; j++) {
+                        const size_t iw = iw0 + j;
+                        d[i][j] = (ih < InputHeight && iw < InputWidth) ? input[ih * InputWidth + iw] : 0.0f;
+                    }
+                }
+            }
+
+            MlasConvWinogradTransformInputTile(d, V + tile * InputChannels + c, InputPointStride);
+        }
+    }
+
+    //
+    // Multiply each transformed input matrix by the packed transformed filter.
+    //
+
+    const size_t AlignedFilterCount = MlasConvWinogradAlignedFilterCount(FilterCount);
+    const size_t PackedPointSize = MlasConvWinogradPackedPointSize(FilterCount, InputChannels) / sizeof(float);
+
+    for (size_t point = 0; point < MLAS_WINOGRAD_POINTS; point++) {
+
+        MlasSgemmPackedOperation(CblasNoTrans, TileCount, 0, FilterCount, InputChannels, 1.0f,
+            V + point * InputPointStride, InputChannels, WorkBlock->PackedFilter + point * PackedPointSize,
+            AlignedFilterCount, 0.0f, Y + point * OutputPointStride, FilterCount);
+    }
+
+    //
+    // Transform the products to the output tiles.
+    //
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        float* output = Output + f * OutputSize;
+
+        for (size_t tile = 0; tile < TileCount; tile++) {
+
+            const size_t tr = TileRowStart + tile / TileColumns;
+            const size_t tc = TileColumnStart + tile % TileColumns;
+
+            const size_t oh0 = tr * MLAS_WINOGRAD_OUTPUT_TILE;
+            const size_t ow0 = tc * MLAS_WINOGRAD_OUTPUT_TILE;
+            const size_t CountH = std::min(MLAS_WINOGRAD_OUTPUT_TILE, OutputHeight - oh0);
+            const size_t CountW = std::min(MLAS_WINOGRAD_OUTPUT_TILE, OutputWidth - ow0);
+
+            float o[MLAS_WINOGRAD_OUTPUT_TILE][MLAS_WINOGRAD_OUTPUT_TILE];
+
+            MlasConvWinogradTransformOutputTile(Y + tile * FilterCount + f, OutputPointStride, o);
+
+            for (size_t i = 0; i < CountH; i++) {
+
+                float* row = output + (oh0 + i) * OutputWidth + ow0;
+
+                if (Beta == 0.0f) {
+                    for (size_t j = 0; j < CountW; j++) {
+                        row[j] = o[i][j];
+                    }
+                } else {
+                    for (size_t j = 0; j < CountW; j++) {
+                        row[j] = Beta * row[j] + o[i][j];
+                    }
+                }
+            }
+        }
+    }
+
+    //
+    // Apply the activation with optional bias to the output rows of this
+    // block while they are still in the cache.
+    //
+
+    const size_t OutputRowStart = TileRowStart * MLAS_WINOGRAD_OUTPUT_TILE;
+    const size_t OutputRowEnd = std::min(OutputHeight, (TileRowStart + TileRows) * MLAS_WINOGRAD_OUTPUT_TILE);
+    const size_t OutputColumnStart = TileColumnStart * MLAS_WINOGRAD_OUTPUT_TILE;
+    const size_t OutputColumnEnd = std::min(OutputWidth, (TileColumnStart + TileColumns) * MLAS_WINOGRAD_OUTPUT_TILE);
+
+    if (OutputColumnStart == 0 && OutputColumnEnd == OutputWidth) {
+
+        MlasActivation(Parameters->Activation, Output + OutputRowStart * OutputWidth, Bias, FilterCount,
+            (OutputRowEnd - OutputRowStart) * OutputWidth, OutputSize);
+
+    } else {
+
+        for (size_t oh = OutputRowStart; oh < OutputRowEnd; oh++) {
+            MlasActivation(Parameters->Activation, Output + oh * OutputWidth + OutputColumnStart, Bias,
+                FilterCount, OutputColumnEnd - OutputColumnStart, OutputSize);
+        }
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    Winograd convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = static_cast<const MLAS_WINOGRAD_WORK_BLOCK*>(Context);
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+    const MLAS_WINOGRAD_TILING& Tiling = WorkBlock->Tiling;
+
+    const size_t BlocksPerImage = Tiling.BlocksHeight * Tiling.BlocksWidth;
+    const size_t TotalBlocks = Parameters->BatchCount * BlocksPerImage;
+
+    size_t BlockStart;
+    size_t BlockRemaining;
+
+    MlasPartitionWork(Index, Parameters->ThreadCount, TotalBlocks, &BlockStart, &BlockRemaining);
+
+    const size_t WorkingBufferSizePerThread =
+        MLAS_WINOGRAD_POINTS * Tiling.TileBlock * (Parameters->InputChannels + Parameters->FilterCount);
+    float* WorkingBuffer = WorkBlock->WorkingBuffer + Index * WorkingBufferSizePerThread;
+
+    for (size_t block = BlockStart; block < BlockStart + BlockRemaining; block++) {
+
+        const size_t batch = block / BlocksPerImage;
+        const size_t BlockIndex = block % BlocksPerImage;
+        const size_t TileRowStart = (BlockIndex / Tiling.BlocksWidth) * Tiling.RowsPerBlock;
+        const size_t TileColumnStart = (BlockIndex % Tiling.BlocksWidth) * Tiling.ColumnsPerBlock;
+
+        const float* Input = WorkBlock->Input + batch * Parameters->InputChannels * Parameters->InputSize;
+        float* Output = WorkBlock->Output + batch * Parameters->FilterCount * Parameters->OutputSize;
+
+        MlasConvWinogradProcessBlock(WorkBlock, Input, WorkBlock->Bias, Output, TileRowStart,
+            TileColumnStart, WorkingBuffer);
+    }
+}
+
+bool
+MLASCALL
+MlasConvWinogradIsSupported(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether a two dimensional convolution with the
+    supplied filter attributes should use the Winograd algorithm.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of output channels per group.
+
+    KernelShape - Supplies the shape of the kernel transformation.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    StrideShape - Supplies the shape of the stride.
+
+Return Value:
+
+    Returns true if the filter should be packed with
+    MlasConvWinogradPackFilter and the convolution executed with
+    MlasConvWinogradPrepare, else false.
+
+--*/
+{
+    return GroupCount == 1 &&
+        KernelShape[0] == 3 && KernelShape[1] == 3 &&
+        DilationShape[0] == 1 && DilationShape[1] == 1 &&
+        StrideShape[0] == 1 && StrideShape[1] == 1 &&
+        InputChannels >= MLAS_WINOGRAD_MINIMUM_INPUT_CHANNELS &&
+        FilterCount >= MLAS_WINOGRAD_MINIMUM_FILTER_COUNT;
+}
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t FilterCount,
+    size_t InputChannels
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed Winograd filter
+    buffer.
+
+Arguments:
+
+    FilterCount - Supplies the number of output channels.
+
+    InputChannels - Supplies the number of input channels.
+
+Return Value:
+
+    Returns the size in bytes for the packed filter buffer.
+
+--*/
+{
+    return MLAS_WINOGRAD_POINTS * MlasConvWinogradPackedPointSize(FilterCount, InputChannels);
+}
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t FilterCount,
+    size_t InputChannels,
+    const float* Filter,
+    void* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a filter of shape [FilterCount, InputChannels, 3, 3]
+    to the Winograd domain and packs each of the 36 transformed matrices for
+    the SGEMM kernels. The destination buffer should be sized based on
+    MlasConvWinogradPackFilterSize() and aligned to the value returned from
+    MlasGetPreferredBufferAlignment().
+
+Arguments:
+
+    FilterCount - Supplies the number of output channels.
+
+    InputChannels - Supplies the number of input channels.
+
+    Filter - Supplies the filter tensor.
+
+    PackedFilter - Supplies the address of the packed filter buffer.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PointStride = FilterCount * InputChannels;
+
+    //
+    // Transform the filter to 36 matrices of [FilterCount, InputChannels].
+    //
+
+    std::vector<float> Transformed(MLAS_WINOGRAD_POINTS * PointStride);
+
+    for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t c = 0; c < InputChannels; c++) {
+            MlasConvWinogradTransformFilterTile(Filter + (f * InputChannels + c) * 9,
+                Transformed.data() + f * InputChannels + c, PointStride);
+        }
+    }
+
+    //
+    // Pack the transpose of each matrix as the B operand of the SGEMM.
+    //
+
+    const size_t PackedPointSize = MlasConvWinogradPackedPointSize(FilterCount, InputChannels);
+
+    for (size_t point = 0; point < MLAS_WINOGRAD_POINTS; point++) {
+        MlasGemmPackB(CblasTrans, FilterCount, InputChannels, Transformed.data() + point * PointStride,
+            InputChannels, static_cast<uint8_t*>(PackedFilter) + point * PackedPointSize);
+    }
+}
+
+void
+MLASCALL
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine switches a convolution prepared by MlasConvPrepare to the
+    Winograd algorithm. The convolution must be supported according to
+    MlasConvWinogradIsSupported and the filter argument of MlasConv must then
+    be the buffer packed by MlasConvWinogradPackFilter.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    WorkingBufferSize - Returns the number of elements required for the
+        working buffer.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_WINOGRAD_TILING Tiling;
+
+    MlasConvWinogradComputeTiling(Parameters, &Tiling);
+
+    const size_t TotalBlocks = Parameters->BatchCount * Tiling.BlocksHeight * Tiling.BlocksWidth;
+
+    ptrdiff_t TargetThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(TargetThreadCount) >= TotalBlocks) {
+        TargetThreadCount = ptrdiff_t(TotalBlocks);
+    }
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->ThreadCount = TargetThreadCount;
+
+    *WorkingBufferSize = size_t(TargetThreadCount) * MLAS_WINOGRAD_POINTS * Tiling.TileBlock *
+        (Parameters->InputChannels + Parameters->FilterCount);
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the Winograd convolution operation.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    PackedFilter - Supplies the filter packed by MlasConvWinogradPackFilter.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvWinogradPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.PackedFilter = PackedFilter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+
+    MlasConvWinogradComputeTiling(Parameters, &WorkBlock.Tiling);
+
+    MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+}
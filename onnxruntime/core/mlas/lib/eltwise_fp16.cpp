@@ -0,0 +1,165 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+    eltwise_fp16.cpp
+
+Abstract:
+    This module implements the binary element-wise arithmetic operations
+    for fp16 tensors.
+--*/
+
+#include "mlasi.h"
+
+#include "fp16_common.h"
+
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+
+struct MLAS_FP16_ADD {
+    static MLAS_FLOAT16X8 Op(MLAS_FLOAT16X8 a, MLAS_FLOAT16X8 b) { return MlasAddFloat16x8(a, b); }
+    static MLAS_FLOAT16X4 Op(MLAS_FLOAT16X4 a, MLAS_FLOAT16X4 b) { return MlasAddFloat16x4(a, b); }
+};
+
+struct MLAS_FP16_SUB {
+    static MLAS_FLOAT16X8 Op(MLAS_FLOAT16X8 a, MLAS_FLOAT16X8 b) { return MlasSubtractFloat16x8(a, b); }
+    static MLAS_FLOAT16X4 Op(MLAS_FLOAT16X4 a, MLAS_FLOAT16X4 b) { return MlasSubtractFloat16x4(a, b); }
+};
+
+struct MLAS_FP16_MUL {
+    static MLAS_FLOAT16X8 Op(MLAS_FLOAT16X8 a, MLAS_FLOAT16X8 b) { return MlasMultiplyFloat16x8(a, b); }
+    static MLAS_FLOAT16X4 Op(MLAS_FLOAT16X4 a, MLAS_FLOAT16X4 b) { return MlasMultiplyFloat16x4(a, b); }
+};
+
+struct MLAS_FP16_DIV {
+    static MLAS_FLOAT16X8 Op(MLAS_FLOAT16X8 a, MLAS_FLOAT16X8 b) { return MlasDivFloat16x8(a, b); }
+    static MLAS_FLOAT16X4 Op(MLAS_FLOAT16X4 a, MLAS_FLOAT16X4 b) { return MlasDivFloat16x4(a, b); }
+};
+
+//
+// Loads the next elements of an operand, or keeps the broadcast scalar when
+// the operand has a zero stride.
+//
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X8
+LoadOperand16x8(const _mlas_fp16_* Buffer, size_t Stride, MLAS_FLOAT16X8 Scalar)
+{
+    return Stride == 0 ? Scalar : MlasLoadFloat16x8(Buffer);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+LoadOperand16x4(const _mlas_fp16_* Buffer, size_t Stride, MLAS_FLOAT16X4 Scalar)
+{
+    return Stride == 0 ? Scalar : MlasLoadFloat16x4(Buffer);
+}
+
+MLAS_FORCEINLINE
+MLAS_FLOAT16X4
+LoadPartialOperand16x4(const _mlas_fp16_* Buffer, size_t Stride, MLAS_FLOAT16X4 Scalar, size_t len)
+{
+    return Stride == 0 ? Scalar : MlasLoadPartialFloat16x4(Buffer, len);
+}
+
+template <typename OpType>
+void
+MlasEltwiseBinaryFp16Kernel(
+    const _mlas_fp16_* A,
+    size_t StrideA,
+    const _mlas_fp16_* B,
+    size_t StrideB,
+    _mlas_fp16_* C,
+    size_t N
+    )
+{
+    const MLAS_FLOAT16X8 ScalarA8 = MlasBroadcastFloat16x8(A);
+    const MLAS_FLOAT16X8 ScalarB8 = MlasBroadcastFloat16x8(B);
+    const MLAS_FLOAT16X4 ScalarA4 = MlasBroadcastFloat16x4(A);
+    const MLAS_FLOAT16X4 ScalarB4 = MlasBroadcastFloat16x4(B);
+
+    while (N >= 32) {
+        MLAS_FLOAT16X8 c0 = OpType::Op(LoadOperand16x8(A, StrideA, ScalarA8), LoadOperand16x8(B, StrideB, ScalarB8));
+        MLAS_FLOAT16X8 c1 = OpType::Op(LoadOperand16x8(A + 8 * StrideA, StrideA, ScalarA8),
+                                       LoadOperand16x8(B + 8 * StrideB, StrideB, ScalarB8));
+        MLAS_FLOAT16X8 c2 = OpType::Op(LoadOperand16x8(A + 16 * StrideA, StrideA, ScalarA8),
+                                       LoadOperand16x8(B + 16 * StrideB, StrideB, ScalarB8));
+        MLAS_FLOAT16X8 c3 = OpType::Op(LoadOperand16x8(A + 24 * StrideA, StrideA, ScalarA8),
+                                       LoadOperand16x8(B + 24 * StrideB, StrideB, ScalarB8));
+        MlasStoreFloat16x8(C, c0);
+        MlasStoreFloat16x8(C + 8, c1);
+        MlasStoreFloat16x8(C + 16, c2);
+        MlasStoreFloat16x8(C + 24, c3);
+
+        A += 32 * StrideA;
+        B += 32 * StrideB;
+        C += 32;
+        N -= 32;
+    }
+
+    while (N >= 8) {
+        MlasStoreFloat16x8(
+            C, OpType::Op(LoadOperand16x8(A, StrideA, ScalarA8), LoadOperand16x8(B, StrideB, ScalarB8)));
+        A += 8 * StrideA;
+        B += 8 * StrideB;
+        C += 8;
+        N -= 8;
+    }
+
+    if (N >= 4) {
+        MlasStoreFloat16x4(
+            C, OpType::Op(LoadOperand16x4(A, StrideA, ScalarA4), LoadOperand16x4(B, StrideB, ScalarB4)));
+        A += 4 * StrideA;
+        B += 4 * StrideB;
+        C += 4;
+        N -= 4;
+    }
+
+    if (N > 0) {
+        MlasStorePartialFloat16x4(
+            C,
+            OpType::Op(LoadPartialOperand16x4(A, StrideA, ScalarA4, N),
+                       LoadPartialOperand16x4(B, StrideB, ScalarB4, N)),
+            N);
+    }
+}
+
+void
+MLASCALL
+MlasEltwiseBinaryFp16(
+    MLAS_FP16_BINARY_OP Op,
+    const MLAS_FP16* A,
+    size_t StrideA,
+    const MLAS_FP16* B,
+    size_t StrideB,
+    MLAS_FP16* C,
+    size_t N
+    )
+{
+    if (N == 0) {
+        return;
+    }
+
+    const auto* a = reinterpret_cast<const _mlas_fp16_*>(A);
+    const auto* b = reinterpret_cast<const _mlas_fp16_*>(B);
+    auto* c = reinterpret_cast<_mlas_fp16_*>(C);
+
+    switch (Op) {
+        case MlasFp16Add:
+            MlasEltwiseBinaryFp16Kernel<MLAS_FP16_ADD>(a, StrideA, b, StrideB, c, N);
+            break;
+        case MlasFp16Sub:
+            MlasEltwiseBinaryFp16Kernel<MLAS_FP16_SUB>(a, StrideA, b, StrideB, c, N);
+            break;
+        case MlasFp16Mul:
+            MlasEltwiseBinaryFp16Kernel<MLAS_FP16_MUL>(a, StrideA, b, StrideB, c, N);
+            break;
+        case MlasFp16Div:
+            MlasEltwiseBinaryFp16Kernel<MLAS_FP16_DIV>(a, StrideA, b, StrideB, c, N);
+            break;
+    }
+}
+
+#endif  // MLAS_F16VEC_INTRINSICS_SUPPORTED
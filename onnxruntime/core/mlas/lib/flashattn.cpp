@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <numeric>
 
 #include "mlasi.h"
@@ -24,6 +25,22 @@ MlasFlashAttentionThreaded(
     const float* key = args->key;
     const float* value = args->value;
     float* output = args->output;
+    ptrdiff_t kv_num_heads = args->kv_num_heads > 0 ? static_cast<ptrdiff_t>(args->kv_num_heads) : num_heads;
+    ptrdiff_t kv_num_heads_factor = num_heads / kv_num_heads;
+    ptrdiff_t kv_buffer_sequence_length = args->kv_buffer_sequence_length > 0
+                                              ? static_cast<ptrdiff_t>(args->kv_buffer_sequence_length)
+                                              : kv_sequence_length;
+    ptrdiff_t q_batch_stride = args->q_batch_stride > 0 ? static_cast<ptrdiff_t>(args->q_batch_stride)
+                                                        : num_heads * q_sequence_length * qk_head_size;
+    bool is_causal = args->is_causal;
+    ptrdiff_t local_window_size = static_cast<ptrdiff_t>(args->local_window_size);
+    const int* cumulative_sequence_lengths = args->cumulative_sequence_lengths;
+    bool is_packed = cumulative_sequence_lengths != nullptr;
+
+    // Q, K and V are token major for packed sequences, so the rows of a head are strided.
+    size_t q_row_stride = static_cast<size_t>(is_packed ? num_heads * qk_head_size : qk_head_size);
+    size_t k_row_stride = static_cast<size_t>(is_packed ? kv_num_heads * qk_head_size : qk_head_size);
+    size_t v_row_stride = static_cast<size_t>(is_packed ? kv_num_heads * v_head_size : v_head_size);
 
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
     auto&& mlas_platform = GetMlasPlatform();
@@ -34,6 +51,14 @@ MlasFlashAttentionThreaded(
     ptrdiff_t task_start = 0;
     ptrdiff_t task_end = 0;
     ptrdiff_t total_task_count = batch_size * num_heads * q_chunk_count;
+    if (is_packed) {
+        // Only the blocks of the tokens of each sequence are tasks, so no thread is left with padding only.
+        total_task_count = 0;
+        for (ptrdiff_t b = 0; b < batch_size; ++b) {
+            ptrdiff_t length = cumulative_sequence_lengths[b + 1] - cumulative_sequence_lengths[b];
+            total_task_count += num_heads * ((length + (q_block_size - 1)) / q_block_size);
+        }
+    }
     ptrdiff_t quotient = total_task_count / thread_count;
     ptrdiff_t remainder = total_task_count % thread_count;
     if (thread_id < remainder) {
@@ -44,12 +69,45 @@ MlasFlashAttentionThreaded(
         task_end = task_start + quotient;
     }
 
+    // The sequence of the current task for packed sequences, and the range of its tasks.
+    ptrdiff_t seq_idx = -1;
+    ptrdiff_t seq_task_start = 0;
+    ptrdiff_t seq_task_end = 0;
+    ptrdiff_t seq_chunk_count = 0;
+
     for (ptrdiff_t task_index = task_start; task_index < task_end; ++task_index) {
-        ptrdiff_t batch_idx = task_index;
-        ptrdiff_t q_idx = (batch_idx % q_chunk_count) * q_block_size;
-        batch_idx /= q_chunk_count;
-        ptrdiff_t head_idx = batch_idx % num_heads;
-        batch_idx /= num_heads;
+        ptrdiff_t batch_idx;
+        ptrdiff_t q_idx;
+        ptrdiff_t head_idx;
+        // the token of the first query of the batch, and the number of queries and keys
+        ptrdiff_t token_start;
+        ptrdiff_t q_len = q_sequence_length;
+        ptrdiff_t kv_len;
+        if (is_packed) {
+            while (task_index >= seq_task_end) {
+                ++seq_idx;
+                ptrdiff_t length = cumulative_sequence_lengths[seq_idx + 1] - cumulative_sequence_lengths[seq_idx];
+                seq_chunk_count = (length + (q_block_size - 1)) / q_block_size;
+                seq_task_start = seq_task_end;
+                seq_task_end = seq_task_start + num_heads * seq_chunk_count;
+            }
+            batch_idx = seq_idx;
+            q_idx = ((task_index - seq_task_start) % seq_chunk_count) * q_block_size;
+            head_idx = (task_index - seq_task_start) / seq_chunk_count;
+            token_start = cumulative_sequence_lengths[seq_idx];
+            q_len = cumulative_sequence_lengths[seq_idx + 1] - token_start;
+            kv_len = q_len;
+        } else {
+            batch_idx = task_index;
+            q_idx = (batch_idx % q_chunk_count) * q_block_size;
+            batch_idx /= q_chunk_count;
+            head_idx = batch_idx % num_heads;
+            batch_idx /= num_heads;
+            token_start = batch_idx * q_sequence_length;
+            kv_len = args->kv_sequence_lengths != nullptr
+                         ? static_cast<ptrdiff_t>(args->kv_sequence_lengths[batch_idx])
+                         : kv_sequence_length;
+        }
 
         char* buffer_current_thread = reinterpret_cast<char*>(buffer) + thread_id * buffer_size_per_thread;
         float* l = reinterpret_cast<float*>(buffer_current_thread);
@@ -61,7 +119,25 @@ MlasFlashAttentionThreaded(
         float* temp_output = intermediate + q_block_size * kv_block_size;
         float negmax = 0;
 
-        for (ptrdiff_t ir = 0; ir < kv_sequence_length; ir += kv_block_size) {
+        size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_len - q_idx));
+
+        // The range of tokens attended by any query of the block. The blocks of K and V outside of it are skipped,
+        // and with a causal mask the scores of the tokens outside of the range of each query are masked.
+        ptrdiff_t q_position = is_causal ? std::max<ptrdiff_t>(0, kv_len - q_len) + q_idx : 0;
+        ptrdiff_t kv_start = 0;
+        ptrdiff_t kv_end = kv_len;
+        if (is_causal) {
+            kv_end = std::min(kv_len, q_position + static_cast<ptrdiff_t>(row_size_q_capped));
+            if (local_window_size > 0) {
+                kv_start = std::max<ptrdiff_t>(0, q_position - local_window_size);
+            }
+        }
+
+        for (ptrdiff_t t = 0; t < static_cast<ptrdiff_t>(row_size_q_capped); ++t) {
+            l[t] = 0.0f;
+        }
+
+        for (ptrdiff_t ir = kv_start; ir < kv_end; ir += kv_block_size) {
             /*
                 S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, head_idx, ir:ir+kv_block_size, :]).T
                 old_m = m
@@ -71,13 +147,22 @@ MlasFlashAttentionThreaded(
                 l = exp(diff) * l + rowsum(S)
                 O = diag(exp(diff)) * O + S * V[batch_idx, head_idx, ir:ir+kv_block_size, :]
             */
-            ptrdiff_t h = batch_idx * num_heads + head_idx;
-            const float* inputQ = query + (h * q_sequence_length + q_idx) * qk_head_size;
-            const float* inputK = key + (h * kv_sequence_length + ir) * qk_head_size;
-            const float* inputV = value + (h * kv_sequence_length + ir) * v_head_size;
+            const float* inputQ;
+            const float* inputK;
+            const float* inputV;
+            if (is_packed) {
+                ptrdiff_t kv_head_idx = head_idx / kv_num_heads_factor;
+                inputQ = query + ((token_start + q_idx) * num_heads + head_idx) * qk_head_size;
+                inputK = key + ((token_start + ir) * kv_num_heads + kv_head_idx) * qk_head_size;
+                inputV = value + ((token_start + ir) * kv_num_heads + kv_head_idx) * v_head_size;
+            } else {
+                ptrdiff_t kv_h = batch_idx * kv_num_heads + head_idx / kv_num_heads_factor;
+                inputQ = query + batch_idx * q_batch_stride + (head_idx * q_sequence_length + q_idx) * qk_head_size;
+                inputK = key + (kv_h * kv_buffer_sequence_length + ir) * qk_head_size;
+                inputV = value + (kv_h * kv_buffer_sequence_length + ir) * v_head_size;
+            }
 
-            size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
-            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_sequence_length - ir));
+            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_end - ir));
 
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
                      CBLAS_TRANSPOSE::CblasTrans,
@@ -86,9 +171,9 @@ MlasFlashAttentionThreaded(
                      static_cast<size_t>(qk_head_size),
                      args->scale,
                      inputQ,
-                     static_cast<size_t>(qk_head_size),
+                     q_row_stride,
                      inputK,
-                     static_cast<size_t>(qk_head_size),
+                     k_row_stride,
                      0.0f,
                      intermediate,
                      row_size_kv_capped);
@@ -96,6 +181,25 @@ MlasFlashAttentionThreaded(
             for (ptrdiff_t irow = 0; irow < static_cast<ptrdiff_t>(row_size_q_capped); ++irow) {
                 float* p = intermediate + irow * row_size_kv_capped;
 
+                if (is_causal) {
+                    // the tokens attended by this query, relative to the block
+                    ptrdiff_t col_start = 0;
+                    ptrdiff_t col_end = q_position + irow + 1 - ir;
+                    if (local_window_size > 0) {
+                        col_start = q_position + irow - local_window_size - ir;
+                    }
+                    col_start = std::max<ptrdiff_t>(col_start, 0);
+                    col_end = std::min(col_end, static_cast<ptrdiff_t>(row_size_kv_capped));
+
+                    if (col_start >= col_end) {
+                        // nothing to attend in this block. m and l are unchanged and the row adds nothing to O.
+                        std::fill_n(p, row_size_kv_capped, 0.0f);
+                        continue;
+                    }
+                    std::fill(p, p + col_start, std::numeric_limits<float>::lowest());
+                    std::fill(p + col_end, p + row_size_kv_capped, std::numeric_limits<float>::lowest());
+                }
+
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
                 float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_capped);
 #else
@@ -112,8 +216,8 @@ MlasFlashAttentionThreaded(
                 float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
 #endif
 
-                // Note: for ir == 0, there is actually no need to calculate exp_diff
-                if (ir != 0) {
+                // Note: for the first block, there is actually no need to calculate exp_diff
+                if (ir != kv_start) {
                     float exp_diff = std::exp(m_diff);
                     l[irow] = exp_diff * l[irow] + rowsum;
 
@@ -122,7 +226,7 @@ MlasFlashAttentionThreaded(
                     }
                 } else {
                     l[irow] = rowsum;
-                    // When ir == 0, there is no need to scale the old result because it is zero.
+                    // For the first block, there is no need to scale the old result because it is zero.
                 }
             }
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
@@ -134,16 +238,22 @@ MlasFlashAttentionThreaded(
                      intermediate,
                      row_size_kv_capped,
                      inputV,
-                     static_cast<size_t>(v_head_size),
-                     ir == 0 ? 0.0f : 1.0f,
+                     v_row_stride,
+                     ir == kv_start ? 0.0f : 1.0f,
                      temp_output,
                      static_cast<size_t>(v_head_size));
         }
 
-        float* output_row = output + ((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size;
-        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
+        float* output_row = output + ((token_start + q_idx) * num_heads + head_idx) * v_head_size;
+        ptrdiff_t row_size_q_valid = static_cast<ptrdiff_t>(row_size_q_capped);
         // TODO: leverage advanced instruction sets
         for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
+            if (l[irow] == 0.0f) {
+                // a padding query of a masked sequence that attends to no token
+                std::fill_n(output_row, v_head_size, 0.0f);
+                output_row += num_heads * v_head_size;
+                continue;
+            }
             for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
                 output_row[icol] = temp_output[irow * v_head_size + icol] / l[irow];
             }
@@ -0,0 +1,177 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx2.cpp
+
+Abstract:
+
+    This module implements the row kernels for the layer normalization
+    routines with AVX2 and FMA3 instructions.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+__m256i
+MlasLayerNormMaskAvx2(
+    size_t N
+    )
+{
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(int32_t(N)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+void
+MLASCALL
+MlasLayerNormAccumulateF32KernelAvx2(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float* Accumulation
+    )
+{
+    const bool StoreOutput = (Skip != nullptr || Bias != nullptr);
+
+    __m256 SumVector0 = _mm256_setzero_ps();
+    __m256 SumVector1 = _mm256_setzero_ps();
+    __m256 SumSquareVector0 = _mm256_setzero_ps();
+    __m256 SumSquareVector1 = _mm256_setzero_ps();
+
+    while (N >= 16) {
+
+        __m256 Vector0 = _mm256_loadu_ps(Input);
+        __m256 Vector1 = _mm256_loadu_ps(Input + 8);
+
+        if (Skip != nullptr) {
+            Vector0 = _mm256_add_ps(Vector0, _mm256_loadu_ps(Skip));
+            Vector1 = _mm256_add_ps(Vector1, _mm256_loadu_ps(Skip + 8));
+            Skip += 16;
+        }
+
+        if (Bias != nullptr) {
+            Vector0 = _mm256_add_ps(Vector0, _mm256_loadu_ps(Bias));
+            Vector1 = _mm256_add_ps(Vector1, _mm256_loadu_ps(Bias + 8));
+            Bias += 16;
+        }
+
+        if (StoreOutput) {
+            _mm256_storeu_ps(Output, Vector0);
+            _mm256_storeu_ps(Output + 8, Vector1);
+        }
+
+        SumVector0 = _mm256_add_ps(SumVector0, Vector0);
+        SumVector1 = _mm256_add_ps(SumVector1, Vector1);
+        SumSquareVector0 = _mm256_fmadd_ps(Vector0, Vector0, SumSquareVector0);
+        SumSquareVector1 = _mm256_fmadd_ps(Vector1, Vector1, SumSquareVector1);
+
+        Input += 16;
+        Output += 16;
+        N -= 16;
+    }
+
+    while (N > 0) {
+
+        //
+        // Process the remaining elements eight at a time, masking the
+        // elements past the end of the row. The masked elements load as zero.
+        //
+
+        const __m256i Mask = MlasLayerNormMaskAvx2(N);
+
+        __m256 Vector = _mm256_maskload_ps(Input, Mask);
+
+        if (Skip != nullptr) {
+            Vector = _mm256_add_ps(Vector, _mm256_maskload_ps(Skip, Mask));
+            Skip += 8;
+        }
+
+        if (Bias != nullptr) {
+            Vector = _mm256_add_ps(Vector, _mm256_maskload_ps(Bias, Mask));
+            Bias += 8;
+        }
+
+        if (StoreOutput) {
+            _mm256_maskstore_ps(Output, Mask, Vector);
+        }
+
+        SumVector0 = _mm256_add_ps(SumVector0, Vector);
+        SumSquareVector0 = _mm256_fmadd_ps(Vector, Vector, SumSquareVector0);
+
+        const size_t CountN = std::min<size_t>(N, 8);
+
+        Input += CountN;
+        Output += CountN;
+        N -= CountN;
+    }
+
+    __m256 SumVector = _mm256_add_ps(SumVector0, SumVector1);
+    __m256 SumSquareVector = _mm256_add_ps(SumSquareVector0, SumSquareVector1);
+
+    //
+    // Reduce the two vectors together, interleaving the sums and the sums of
+    // squares.
+    //
+
+    __m256 Reduction = _mm256_hadd_ps(SumVector, SumSquareVector);
+    __m128 Reduction128 = _mm_add_ps(_mm256_castps256_ps128(Reduction), _mm256_extractf128_ps(Reduction, 1));
+    Reduction128 = _mm_hadd_ps(Reduction128, Reduction128);
+
+    Accumulation[0] = _mm_cvtss_f32(Reduction128);
+    Accumulation[1] = _mm_cvtss_f32(_mm_shuffle_ps(Reduction128, Reduction128, _MM_SHUFFLE(1, 1, 1, 1)));
+}
+
+void
+MLASCALL
+MlasLayerNormNormalizeF32KernelAvx2(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+{
+    const __m256 MeanVector = _mm256_broadcast_ss(&Parameters[0]);
+    const __m256 InvStdDevVector = _mm256_broadcast_ss(&Parameters[1]);
+
+    while (N >= 8) {
+
+        __m256 Vector = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(Input), MeanVector), InvStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector = _mm256_fmadd_ps(Vector, _mm256_loadu_ps(Scale), _mm256_loadu_ps(Bias));
+            Bias += 8;
+        } else {
+            Vector = _mm256_mul_ps(Vector, _mm256_loadu_ps(Scale));
+        }
+
+        _mm256_storeu_ps(Output, Vector);
+
+        Input += 8;
+        Scale += 8;
+        Output += 8;
+        N -= 8;
+    }
+
+    if (N > 0) {
+
+        const __m256i Mask = MlasLayerNormMaskAvx2(N);
+
+        __m256 Vector = _mm256_mul_ps(_mm256_sub_ps(_mm256_maskload_ps(Input, Mask), MeanVector), InvStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector = _mm256_fmadd_ps(Vector, _mm256_maskload_ps(Scale, Mask), _mm256_maskload_ps(Bias, Mask));
+        } else {
+            Vector = _mm256_mul_ps(Vector, _mm256_maskload_ps(Scale, Mask));
+        }
+
+        _mm256_maskstore_ps(Output, Mask, Vector);
+    }
+}
@@ -0,0 +1,144 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx512f.cpp
+
+Abstract:
+
+    This module implements the row kernels for the layer normalization
+    routines with AVX512F instructions.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasLayerNormAccumulateF32KernelAvx512F(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float* Accumulation
+    )
+{
+    const bool StoreOutput = (Skip != nullptr || Bias != nullptr);
+
+    __m512 SumVector0 = _mm512_setzero_ps();
+    __m512 SumVector1 = _mm512_setzero_ps();
+    __m512 SumSquareVector0 = _mm512_setzero_ps();
+    __m512 SumSquareVector1 = _mm512_setzero_ps();
+
+    while (N >= 32) {
+
+        __m512 Vector0 = _mm512_loadu_ps(Input);
+        __m512 Vector1 = _mm512_loadu_ps(Input + 16);
+
+        if (Skip != nullptr) {
+            Vector0 = _mm512_add_ps(Vector0, _mm512_loadu_ps(Skip));
+            Vector1 = _mm512_add_ps(Vector1, _mm512_loadu_ps(Skip + 16));
+            Skip += 32;
+        }
+
+        if (Bias != nullptr) {
+            Vector0 = _mm512_add_ps(Vector0, _mm512_loadu_ps(Bias));
+            Vector1 = _mm512_add_ps(Vector1, _mm512_loadu_ps(Bias + 16));
+            Bias += 32;
+        }
+
+        if (StoreOutput) {
+            _mm512_storeu_ps(Output, Vector0);
+            _mm512_storeu_ps(Output + 16, Vector1);
+        }
+
+        SumVector0 = _mm512_add_ps(SumVector0, Vector0);
+        SumVector1 = _mm512_add_ps(SumVector1, Vector1);
+        SumSquareVector0 = _mm512_fmadd_ps(Vector0, Vector0, SumSquareVector0);
+        SumSquareVector1 = _mm512_fmadd_ps(Vector1, Vector1, SumSquareVector1);
+
+        Input += 32;
+        Output += 32;
+        N -= 32;
+    }
+
+    while (N > 0) {
+
+        //
+        // Process the remaining elements sixteen at a time, masking the
+        // elements past the end of the row. The masked elements load as zero.
+        //
+
+        const size_t CountN = std::min<size_t>(N, 16);
+        const __mmask16 Mask = __mmask16(0xFFFF >> (16 - CountN));
+
+        __m512 Vector = _mm512_maskz_loadu_ps(Mask, Input);
+
+        if (Skip != nullptr) {
+            Vector = _mm512_add_ps(Vector, _mm512_maskz_loadu_ps(Mask, Skip));
+            Skip += CountN;
+        }
+
+        if (Bias != nullptr) {
+            Vector = _mm512_add_ps(Vector, _mm512_maskz_loadu_ps(Mask, Bias));
+            Bias += CountN;
+        }
+
+        if (StoreOutput) {
+            _mm512_mask_storeu_ps(Output, Mask, Vector);
+        }
+
+        SumVector0 = _mm512_add_ps(SumVector0, Vector);
+        SumSquareVector0 = _mm512_fmadd_ps(Vector, Vector, SumSquareVector0);
+
+        Input += CountN;
+        Output += CountN;
+        N -= CountN;
+    }
+
+    Accumulation[0] = _mm512_reduce_add_ps(_mm512_add_ps(SumVector0, SumVector1));
+    Accumulation[1] = _mm512_reduce_add_ps(_mm512_add_ps(SumSquareVector0, SumSquareVector1));
+}
+
+void
+MLASCALL
+MlasLayerNormNormalizeF32KernelAvx512F(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+{
+    const __m512 MeanVector = _mm512_set1_ps(Parameters[0]);
+    const __m512 InvStdDevVector = _mm512_set1_ps(Parameters[1]);
+
+    while (N > 0) {
+
+        const size_t CountN = std::min<size_t>(N, 16);
+        const __mmask16 Mask = __mmask16(0xFFFF >> (16 - CountN));
+
+        __m512 Vector = _mm512_sub_ps(_mm512_maskz_loadu_ps(Mask, Input), MeanVector);
+        Vector = _mm512_mul_ps(Vector, InvStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector = _mm512_fmadd_ps(Vector, _mm512_maskz_loadu_ps(Mask, Scale), _mm512_maskz_loadu_ps(Mask, Bias));
+            Bias += CountN;
+        } else {
+            Vector = _mm512_mul_ps(Vector, _mm512_maskz_loadu_ps(Mask, Scale));
+        }
+
+        _mm512_mask_storeu_ps(Output, Mask, Vector);
+
+        Input += CountN;
+        Scale += CountN;
+        Output += CountN;
+        N -= CountN;
+    }
+}
@@ -0,0 +1,755 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements routines to compute the layer normalization, the
+    skip layer normalization and the root mean square normalization of the
+    rows of a matrix.
+
+    Each row is processed in two passes: the first pass computes the sum and
+    the sum of squares of the row, optionally adding the skip and bias vectors
+    and storing the resulting row; the second pass normalizes the row and
+    applies the scale and bias vectors.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the parameters to execute segments of a normalization operation on
+// worker threads.
+//
+
+struct MLAS_LAYERNORM_WORK_BLOCK {
+    ptrdiff_t ThreadCountN;
+    const void* Input;
+    const float* Skip;
+    size_t SkipSize;
+    const float* Bias;
+    const float* Scale;
+    const float* ScaleBias;
+    void* Output;
+    void* InputSkipBiasSum;
+    float* Mean;
+    float* InvStdDev;
+    size_t N;
+    size_t D;
+    float Epsilon;
+    bool Simplified;
+};
+
+void
+MLASCALL
+MlasLayerNormAccumulateF32Kernel(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float* Accumulation
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sum and the sum of squares of the elements of a
+    row, after optionally adding the skip and bias vectors to the row.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Skip - Optionally supplies the skip row to add to the input row.
+
+    Bias - Optionally supplies the bias vector to add to the input row.
+
+    Output - Supplies the output row. The sum of the input, skip and bias rows
+        is stored to this row if either the skip or bias row is supplied.
+
+    N - Supplies the number of elements to process.
+
+    Accumulation - Supplies the output buffer that receives the sum and the
+        sum of squares of the elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const bool StoreOutput = (Skip != nullptr || Bias != nullptr);
+
+    MLAS_FLOAT32X4 SumVector = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquareVector = MlasZeroFloat32x4();
+
+    size_t n = 0;
+
+    for (; n + 4 <= N; n += 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input + n);
+
+        if (Skip != nullptr) {
+            Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Skip + n));
+        }
+
+        if (Bias != nullptr) {
+            Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Bias + n));
+        }
+
+        if (StoreOutput) {
+            MlasStoreFloat32x4(Output + n, Vector);
+        }
+
+        SumVector = MlasAddFloat32x4(SumVector, Vector);
+        SumSquareVector = MlasMultiplyAddFloat32x4(Vector, Vector, SumSquareVector);
+    }
+
+    float Sum = MlasReduceAddFloat32x4(SumVector);
+    float SumSquare = MlasReduceAddFloat32x4(SumSquareVector);
+
+    for (; n < N; n++) {
+
+        float Value = Input[n];
+
+        if (Skip != nullptr) {
+            Value += Skip[n];
+        }
+
+        if (Bias != nullptr) {
+            Value += Bias[n];
+        }
+
+        if (StoreOutput) {
+            Output[n] = Value;
+        }
+
+        Sum += Value;
+        SumSquare += Value * Value;
+    }
+
+    Accumulation[0] = Sum;
+    Accumulation[1] = SumSquare;
+}
+
+void
+MLASCALL
+MlasLayerNormNormalizeF32Kernel(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes the elements of a row and applies the scale and
+    bias vectors.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Scale - Supplies the scale vector.
+
+    Bias - Optionally supplies the bias vector.
+
+    Output - Supplies the output row.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies the mean and the inverse standard deviation of the
+        row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float Mean = Parameters[0];
+    const float InvStdDev = Parameters[1];
+
+    const MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(Mean);
+    const MLAS_FLOAT32X4 InvStdDevVector = MlasBroadcastFloat32x4(InvStdDev);
+
+    size_t n = 0;
+
+    for (; n + 4 <= N; n += 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasSubtractFloat32x4(MlasLoadFloat32x4(Input + n), MeanVector);
+        Vector = MlasMultiplyFloat32x4(Vector, InvStdDevVector);
+
+        if (Bias != nullptr) {
+            Vector = MlasMultiplyAddFloat32x4(Vector, MlasLoadFloat32x4(Scale + n), MlasLoadFloat32x4(Bias + n));
+        } else {
+            Vector = MlasMultiplyFloat32x4(Vector, MlasLoadFloat32x4(Scale + n));
+        }
+
+        MlasStoreFloat32x4(Output + n, Vector);
+    }
+
+    for (; n < N; n++) {
+
+        float Value = (Input[n] - Mean) * InvStdDev * Scale[n];
+
+        if (Bias != nullptr) {
+            Value += Bias[n];
+        }
+
+        Output[n] = Value;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormAccumulateRow(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float* Accumulation
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().LayerNormAccumulateF32Kernel(Input, Skip, Bias, Output, N, Accumulation);
+#else
+    MlasLayerNormAccumulateF32Kernel(Input, Skip, Bias, Output, N, Accumulation);
+#endif
+}
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormNormalizeRow(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().LayerNormNormalizeF32Kernel(Input, Scale, Bias, Output, N, Parameters);
+#else
+    MlasLayerNormNormalizeF32Kernel(Input, Scale, Bias, Output, N, Parameters);
+#endif
+}
+
+template<typename T>
+void
+MlasLayerNormThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    normalization operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_LAYERNORM_WORK_BLOCK*)Context;
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->N, &n, &CountN);
+
+    const size_t D = WorkBlock->D;
+    const bool Simplified = WorkBlock->Simplified;
+
+    const T* Input = reinterpret_cast<const T*>(WorkBlock->Input) + n * D;
+    T* Output = reinterpret_cast<T*>(WorkBlock->Output) + n * D;
+    T* InputSkipBiasSum = reinterpret_cast<T*>(WorkBlock->InputSkipBiasSum);
+
+    if (InputSkipBiasSum != nullptr) {
+        InputSkipBiasSum += n * D;
+    }
+
+    //
+    // Half precision rows are converted to a single precision row buffer, which
+    // is normalized in place before being converted back.
+    //
+
+    float* RowBuffer = nullptr;
+
+    if constexpr (std::is_same_v<T, MLAS_FP16>) {
+        MlasThreadedBufAlloc(D * sizeof(float));
+        RowBuffer = reinterpret_cast<float*>(ThreadedBufHolder.get());
+    }
+
+    for (size_t CountRemainingN = CountN; CountRemainingN > 0; CountRemainingN--, n++) {
+
+        const float* Skip = nullptr;
+
+        if (WorkBlock->Skip != nullptr) {
+            Skip = WorkBlock->Skip + (n * D) % WorkBlock->SkipSize;
+        }
+
+        const bool HasSum = (Skip != nullptr || WorkBlock->Bias != nullptr);
+
+        const float* InputRow;
+        float* SumRow;
+        float* OutputRow;
+
+        if constexpr (std::is_same_v<T, MLAS_FP16>) {
+            MlasConvertHalfToFloatBuffer(Input, RowBuffer, D);
+            InputRow = RowBuffer;
+            SumRow = RowBuffer;
+            OutputRow = RowBuffer;
+        } else {
+            InputRow = Input;
+            SumRow = (InputSkipBiasSum != nullptr) ? InputSkipBiasSum : Output;
+            OutputRow = Output;
+        }
+
+        //
+        // Compute the sum and the sum of squares of the row, storing the sum of
+        // the input, skip and bias rows if supplied.
+        //
+
+        float Accumulation[2];
+
+        MlasLayerNormAccumulateRow(InputRow, Skip, WorkBlock->Bias, SumRow, D, Accumulation);
+
+        if (HasSum) {
+            InputRow = SumRow;
+        }
+
+        if constexpr (std::is_same_v<T, MLAS_FP16>) {
+            if (InputSkipBiasSum != nullptr) {
+                MlasConvertFloatToHalfBuffer(SumRow, InputSkipBiasSum, D);
+            }
+        } else {
+            if (InputSkipBiasSum != nullptr && !HasSum) {
+                std::copy_n(Input, D, InputSkipBiasSum);
+            }
+        }
+
+        //
+        // Compute the mean and the inverse standard deviation of the row.
+        //
+
+        float Mean = 0.0f;
+        float Variance;
+
+        if (Simplified) {
+            Variance = Accumulation[1] / D;
+        } else {
+            Mean = Accumulation[0] / D;
+            Variance = std::max(Accumulation[1] / D - Mean * Mean, 0.0f);
+        }
+
+        const float InvStdDev = 1.0f / std::sqrt(Variance + WorkBlock->Epsilon);
+
+        if (WorkBlock->Mean != nullptr) {
+            WorkBlock->Mean[n] = Mean;
+        }
+
+        if (WorkBlock->InvStdDev != nullptr) {
+            WorkBlock->InvStdDev[n] = InvStdDev;
+        }
+
+        //
+        // Normalize the row and apply the scale and bias vectors.
+        //
+
+        const float Parameters[] = {Mean, InvStdDev};
+
+        MlasLayerNormNormalizeRow(InputRow, WorkBlock->Scale, WorkBlock->ScaleBias, OutputRow, D, Parameters);
+
+        if constexpr (std::is_same_v<T, MLAS_FP16>) {
+            MlasConvertFloatToHalfBuffer(OutputRow, Output, D);
+        }
+
+        Input += D;
+        Output += D;
+
+        if (InputSkipBiasSum != nullptr) {
+            InputSkipBiasSum += D;
+        }
+    }
+}
+
+template<typename T>
+void
+MlasLayerNormExecute(
+    MLAS_LAYERNORM_WORK_BLOCK* WorkBlock,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    const size_t N = WorkBlock->N;
+    const size_t D = WorkBlock->D;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // normalization operation. Limit the number of threads to the number of
+    // rows and try to keep each thread processing a minimum number of elements
+    // before using another thread.
+    //
+
+    ptrdiff_t ThreadCountN = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCountN) > N) {
+        ThreadCountN = ptrdiff_t(N);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((N * D) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCountN) > BlockCount) {
+        ThreadCountN = ptrdiff_t(BlockCount);
+    }
+
+    WorkBlock->ThreadCountN = ThreadCountN;
+
+    MlasExecuteThreaded(MlasLayerNormThreaded<T>, WorkBlock, ThreadCountN, ThreadPool);
+}
+
+template<typename T>
+void
+MLASCALL
+MlasLayerNormalization(
+    const T* Input,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the layer normalization of the rows of a matrix.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Scale - Supplies the scale vector of D elements.
+
+    Bias - Optionally supplies the bias vector of D elements.
+
+    Output - Supplies the output buffer.
+
+    Mean - Optionally supplies the buffer that receives the mean of each row.
+
+    InvStdDev - Optionally supplies the buffer that receives the inverse
+        standard deviation of each row.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    Epsilon - Supplies the value added to the variance to avoid dividing by
+        zero.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_LAYERNORM_WORK_BLOCK WorkBlock{};
+
+    WorkBlock.Input = Input;
+    WorkBlock.Scale = Scale;
+    WorkBlock.ScaleBias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.Mean = Mean;
+    WorkBlock.InvStdDev = InvStdDev;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.Epsilon = Epsilon;
+    WorkBlock.Simplified = false;
+
+    MlasLayerNormExecute<T>(&WorkBlock, ThreadPool);
+}
+
+template<typename T>
+void
+MLASCALL
+MlasRmsNorm(
+    const T* Input,
+    const float* Scale,
+    T* Output,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the root mean square normalization of the rows of a
+    matrix.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Scale - Supplies the scale vector of D elements.
+
+    Output - Supplies the output buffer.
+
+    InvStdDev - Optionally supplies the buffer that receives the inverse root
+        mean square of each row.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    Epsilon - Supplies the value added to the mean square to avoid dividing by
+        zero.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_LAYERNORM_WORK_BLOCK WorkBlock{};
+
+    WorkBlock.Input = Input;
+    WorkBlock.Scale = Scale;
+    WorkBlock.Output = Output;
+    WorkBlock.InvStdDev = InvStdDev;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.Epsilon = Epsilon;
+    WorkBlock.Simplified = true;
+
+    MlasLayerNormExecute<T>(&WorkBlock, ThreadPool);
+}
+
+template<typename T>
+void
+MLASCALL
+MlasSkipLayerNorm(
+    const T* Input,
+    const float* Skip,
+    size_t SkipSize,
+    const float* Bias,
+    const float* Scale,
+    const float* ScaleBias,
+    T* Output,
+    T* InputSkipBiasSum,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine adds the skip and bias vectors to the rows of a matrix and
+    computes the layer normalization or the root mean square normalization of
+    the resulting rows.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Skip - Supplies the skip buffer, which is broadcast to the rows of the
+        input buffer if SkipSize is less than N * D.
+
+    SkipSize - Supplies the number of elements of the skip buffer, which must
+        be a multiple of D.
+
+    Bias - Optionally supplies the bias vector of D elements added to the
+        input rows.
+
+    Scale - Supplies the scale vector of D elements.
+
+    ScaleBias - Optionally supplies the bias vector of D elements added to the
+        normalized rows.
+
+    Output - Supplies the output buffer.
+
+    InputSkipBiasSum - Optionally supplies the buffer that receives the sum of
+        the input, skip and bias rows.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    Epsilon - Supplies the value added to the variance to avoid dividing by
+        zero.
+
+    Simplified - Supplies true to compute the root mean square normalization,
+        else false to compute the layer normalization.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_LAYERNORM_WORK_BLOCK WorkBlock{};
+
+    WorkBlock.Input = Input;
+    WorkBlock.Skip = Skip;
+    WorkBlock.SkipSize = SkipSize;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Scale = Scale;
+    WorkBlock.ScaleBias = Simplified ? nullptr : ScaleBias;
+    WorkBlock.Output = Output;
+    WorkBlock.InputSkipBiasSum = InputSkipBiasSum;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+    WorkBlock.Epsilon = Epsilon;
+    WorkBlock.Simplified = Simplified;
+
+    MlasLayerNormExecute<T>(&WorkBlock, ThreadPool);
+}
+
+template
+void
+MLASCALL
+MlasLayerNormalization<float>(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasLayerNormalization<MLAS_FP16>(
+    const MLAS_FP16* Input,
+    const float* Scale,
+    const float* Bias,
+    MLAS_FP16* Output,
+    float* Mean,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasRmsNorm<float>(
+    const float* Input,
+    const float* Scale,
+    float* Output,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasRmsNorm<MLAS_FP16>(
+    const MLAS_FP16* Input,
+    const float* Scale,
+    MLAS_FP16* Output,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasSkipLayerNorm<float>(
+    const float* Input,
+    const float* Skip,
+    size_t SkipSize,
+    const float* Bias,
+    const float* Scale,
+    const float* ScaleBias,
+    float* Output,
+    float* InputSkipBiasSum,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasSkipLayerNorm<MLAS_FP16>(
+    const MLAS_FP16* Input,
+    const float* Skip,
+    size_t SkipSize,
+    const float* Bias,
+    const float* Scale,
+    const float* ScaleBias,
+    MLAS_FP16* Output,
+    MLAS_FP16* InputSkipBiasSum,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    bool Simplified,
+    MLAS_THREADPOOL* ThreadPool
+    );
@@ -195,6 +195,10 @@ class MLASCPUIDInfo
 
     bool HasArmNeon_BF16() const { return has_arm_neon_bf16_; }
 
+    bool HasArmSVE() const { return has_arm_sve_; }
+
+    uint32_t GetArmSVEVectorLengthInBytes() const { return arm_sve_vector_length_; }
+
    private:
     MLASCPUIDInfo();
 
@@ -203,6 +207,8 @@ class MLASCPUIDInfo
     bool has_arm_neon_i8mm_{false};
     bool has_arm_sve_i8mm_{false};
     bool has_arm_neon_bf16_{false};
+    bool has_arm_sve_{false};
+    uint32_t arm_sve_vector_length_{0};
 };
 using MLAS_CPUIDINFO = MLASCPUIDInfo;
 
@@ -610,6 +616,28 @@ void
     const float* Parameters
     );
 
+typedef
+void
+(MLASCALL MLAS_LAYERNORM_ACCUMULATE_FLOAT_KERNEL)(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    float* Accumulation
+    );
+
+typedef
+void
+(MLASCALL MLAS_LAYERNORM_NORMALIZE_FLOAT_KERNEL)(
+    const float* Input,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    );
+
 typedef
 float
 (MLASCALL MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL)(
@@ -801,6 +829,14 @@ extern "C" {
 #endif
     MLAS_GEMM_DOUBLE_KERNEL MlasDgemmKernelZero;
     MLAS_GEMM_DOUBLE_KERNEL MlasDgemmKernelAdd;
+#if defined(MLAS_TARGET_ARM64) && defined(MLAS_USE_SVE)
+    MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelZeroSve;
+    MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelAddSve;
+#endif
+#if defined(MLAS_TARGET_RISCV64)
+    MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelZeroRvv;
+    MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelAddRvv;
+#endif
 #endif
 
 #if defined(MLAS_TARGET_AMD64)
@@ -871,9 +907,16 @@ extern "C" {
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasComputeExpF32Kernel;
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasLogisticKernel;
     MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasTanhKernel;
+#if defined(MLAS_TARGET_RISCV64)
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasErfKernelRvv;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasLogisticKernelRvv;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL MlasTanhKernelRvv;
+#endif
     MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32Kernel;
     MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32Kernel;
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeLogSoftmaxOutputF32Kernel;
+    MLAS_LAYERNORM_ACCUMULATE_FLOAT_KERNEL MlasLayerNormAccumulateF32Kernel;
+    MLAS_LAYERNORM_NORMALIZE_FLOAT_KERNEL MlasLayerNormNormalizeF32Kernel;
     MLAS_QLINEAR_BINARY_OP_S8_KERNEL MlasQLinearAddS8Kernel;
     MLAS_QLINEAR_BINARY_OP_U8_KERNEL MlasQLinearAddU8Kernel;
     MLAS_QUANTIZE_LINEAR_S8_KERNEL MlasQuantizeLinearS8Kernel;
@@ -892,6 +935,10 @@ extern "C" {
     MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelAvx512F;
     MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32KernelAvx;
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeLogSoftmaxOutputF32KernelAvx;
+    MLAS_LAYERNORM_ACCUMULATE_FLOAT_KERNEL MlasLayerNormAccumulateF32KernelAvx2;
+    MLAS_LAYERNORM_ACCUMULATE_FLOAT_KERNEL MlasLayerNormAccumulateF32KernelAvx512F;
+    MLAS_LAYERNORM_NORMALIZE_FLOAT_KERNEL MlasLayerNormNormalizeF32KernelAvx2;
+    MLAS_LAYERNORM_NORMALIZE_FLOAT_KERNEL MlasLayerNormNormalizeF32KernelAvx512F;
     MLAS_QLINEAR_BINARY_OP_S8_KERNEL MlasQLinearAddS8KernelAvx2;
     MLAS_QLINEAR_BINARY_OP_U8_KERNEL MlasQLinearAddU8KernelAvx2;
     MLAS_QUANTIZE_LINEAR_S8_KERNEL MlasQuantizeLinearS8KernelAvx512F;
@@ -945,7 +992,7 @@ extern "C" {
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (size_t(64) * size_t(1024))
 #define MLAS_QGEMM_THREAD_COMPLEXITY                65536
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 #define MLAS_SBGEMM_THREAD_COMPLEXITY (size_t(64) * size_t(1024))
 #endif
 
@@ -970,6 +1017,38 @@ MlasSgemmOperation(
     size_t ldc
     );
 
+void
+MlasSgemmPackedOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc
+    );
+
+//
+// Winograd convolution routines.
+//
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Quantized integer matrix/matrix dispatch structure.
 //
@@ -994,6 +1073,7 @@ extern const MLAS_GEMM_QUANT_DISPATCH MlasGemmS8S8DispatchSmmla;
 extern const MLAS_GEMM_QUANT_DISPATCH MlasGemmU8X8DispatchWasmSimd;
 extern const MLAS_GEMM_QUANT_DISPATCH MlasGemmQuantDispatchDefault;
 extern const MLAS_GEMM_QUANT_DISPATCH MlasGemm8X8DispatchPOWER10;
+extern const MLAS_GEMM_QUANT_DISPATCH MlasGemmU8X8DispatchRvv;
 
 //
 // Symmetric quantized qgemm dispatch structure
@@ -1016,6 +1096,8 @@ extern const MLAS_CONV_SYM_DISPATCH MlasConvSymU8DispatchNeon;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchNeon;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymU8DispatchDot;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchDot;
+extern const MLAS_CONV_SYM_DISPATCH MlasConvSymU8DispatchI8mm;
+extern const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchI8mm;
 
 //
 // Quantized 8-bit integer/quantized 4-bit integer matrix/matrix multiply dispatch structure.
@@ -1041,6 +1123,8 @@ struct MLAS_QNBIT_GEMM_DISPATCH;
 
 extern const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchNeon;
 
+extern const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchSve;
+
 extern const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx2;
 
 extern const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx2vnni;
@@ -1049,6 +1133,18 @@ extern const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512;
 
 extern const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnni;
 
+extern const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchWasmSimd;
+
+//
+// Bfloat16 precision matrix/matrix multiply dispatch structure.
+//
+
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
+struct MLAS_SBGEMM_DISPATCH;
+
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16;
+#endif
+
 //
 // Rotary embedding dispatch structure.
 //
@@ -1157,6 +1253,16 @@ struct MLAS_PLATFORM {
     MLAS_QUANT_KERNEL<int8_t, int8_t>::DepthwiseKernel* ConvDepthwiseS8S8Kernel;
     MLAS_QUANT_KERNEL<int8_t, uint8_t>::DepthwiseKernel* ConvDepthwiseS8U8Kernel;
 
+#if defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_RISCV64)
+    MLAS_GEMM_FLOAT_KERNEL* GemmFloatKernelZero;
+    MLAS_GEMM_FLOAT_KERNEL* GemmFloatKernelAdd;
+#endif
+#if defined(MLAS_TARGET_RISCV64)
+    const MLAS_GEMM_QUANT_DISPATCH* GemmU8X8Dispatch;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* ErfKernelRoutine;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* LogisticKernelRoutine;
+    MLAS_COMPUTE_UNARY_FLOAT_KERNEL* TanhKernelRoutine;
+#endif
 #if defined(MLAS_TARGET_POWER)
     MLAS_GEMM_DOUBLE_KERNEL* GemmDoubleKernel;
     const MLAS_GEMM_QUANT_DISPATCH* GemmU8X8Dispatch;
@@ -1191,6 +1297,8 @@ struct MLAS_PLATFORM {
     MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL* ComputeSumExpF32Kernel;
     MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeSoftmaxOutputF32Kernel;
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeLogSoftmaxOutputF32Kernel;
+    MLAS_LAYERNORM_ACCUMULATE_FLOAT_KERNEL* LayerNormAccumulateF32Kernel;
+    MLAS_LAYERNORM_NORMALIZE_FLOAT_KERNEL* LayerNormNormalizeF32Kernel;
     MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL* ReduceMaximumF32Kernel;
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL* ReduceMinimumMaximumF32Kernel;
     MLAS_QUANTIZE_LINEAR_S8_KERNEL* QuantizeLinearS8Kernel;
@@ -1213,6 +1321,10 @@ struct MLAS_PLATFORM {
 
     const MLAS_QNBIT_GEMM_DISPATCH* QNBitGemmDispatch{nullptr};
 
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
+    const MLAS_SBGEMM_DISPATCH* SBGemmDispatch{nullptr};
+#endif
+
     MLAS_CAST_F16_TO_F32_KERNEL* CastF16ToF32Kernel;
     MLAS_CAST_F32_TO_F16_KERNEL* CastF32ToF16Kernel;
 
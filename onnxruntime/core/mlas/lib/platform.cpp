@@ -17,6 +17,8 @@ Abstract:
 
 #include "mlasi.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <thread>
 #include <mutex>
 
@@ -31,6 +33,17 @@ Abstract:
 #endif
 #endif
 
+#if defined(MLAS_TARGET_RISCV64) && defined(__linux__)
+#include <sys/auxv.h>
+
+//
+// The hardware capabilities reported by the kernel for the single letter
+// extensions of the ISA are a bit per letter.
+//
+
+#define MLAS_RISCV_HWCAP_ISA_V (1ul << ('V' - 'A'))
+#endif
+
 #if defined(MLAS_TARGET_ARM64)
 #if defined(_WIN32)
 
@@ -52,6 +65,7 @@ MLASCPUIDInfo::MLASCPUIDInfo()
 #elif defined(__linux__)
 
 #include <sys/auxv.h>
+#include <sys/prctl.h>
 #include <asm/hwcap.h>
 // N.B. Support building with older versions of asm/hwcap.h that do not define
 // this capability bit.
@@ -59,6 +73,10 @@ MLASCPUIDInfo::MLASCPUIDInfo()
 #define HWCAP_ASIMDDP (1 << 20)
 #endif
 
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1 << 22)
+#endif
+
 #ifndef HWCAP2_I8MM
 #define HWCAP2_I8MM (1 << 13)
 #endif
@@ -71,6 +89,14 @@ MLASCPUIDInfo::MLASCPUIDInfo()
 #define HWCAP2_BF16 (1 << 14)
 #endif
 
+#ifndef PR_SVE_GET_VL
+#define PR_SVE_GET_VL 51
+#endif
+
+#ifndef PR_SVE_VL_LEN_MASK
+#define PR_SVE_VL_LEN_MASK 0xffff
+#endif
+
 #if defined(BUILD_MLAS_NO_ONNXRUNTIME)
 MLASCPUIDInfo::MLASCPUIDInfo()
 {
@@ -83,6 +109,14 @@ MLASCPUIDInfo::MLASCPUIDInfo()
     has_arm_sve_i8mm_ = ((getauxval(AT_HWCAP2) & HWCAP2_SVEI8MM) != 0);
 
     has_arm_neon_bf16_ = ((getauxval(AT_HWCAP2) & HWCAP2_BF16) != 0);
+
+    if ((getauxval(AT_HWCAP) & HWCAP_SVE) != 0) {
+        const int sve_vl = prctl(PR_SVE_GET_VL);
+        if (sve_vl > 0) {
+            has_arm_sve_ = true;
+            arm_sve_vector_length_ = static_cast<uint32_t>(sve_vl & PR_SVE_VL_LEN_MASK);
+        }
+    }
 }
 #endif
 
@@ -220,6 +254,86 @@ MLAS_INTERNAL_DATA MLAS_DECLSPEC_ALIGN(const uint32_t MlasMaskMoveTableLasx[16],
 };
 
 #endif
+#if defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_ARM64)
+
+//
+// The MLAS_MAXIMUM_ISA environment variable limits the instruction set
+// extensions that the platform dispatches to, so that the kernels of
+// different extensions can be compared on the same machine. Every level
+// includes the levels below it. Extensions the processor does not support
+// are never used, whatever the value.
+//
+
+enum MLAS_ISA_LEVEL {
+    MlasIsaBaseline,
+#if defined(MLAS_TARGET_AMD64_IX86)
+    MlasIsaAvx,
+    MlasIsaAvx2,
+    MlasIsaAvxVnni,
+    MlasIsaAvx512F,
+    MlasIsaAvx512Core,
+    MlasIsaAvx512Vnni,
+    MlasIsaAmx,
+#else
+    MlasIsaDot,
+    MlasIsaI8mm,
+    MlasIsaSve,
+#endif
+    MlasIsaAll,
+};
+
+static
+MLAS_ISA_LEVEL
+MlasGetMaximumIsaLevel(
+    void
+    )
+{
+    static const struct {
+        const char* Name;
+        MLAS_ISA_LEVEL Level;
+    } IsaLevels[] = {
+#if defined(MLAS_TARGET_AMD64_IX86)
+        {"sse2", MlasIsaBaseline},
+        {"avx", MlasIsaAvx},
+        {"avx2", MlasIsaAvx2},
+        {"avxvnni", MlasIsaAvxVnni},
+        {"avx512f", MlasIsaAvx512F},
+        {"avx512core", MlasIsaAvx512Core},
+        {"avx512vnni", MlasIsaAvx512Vnni},
+        {"amx", MlasIsaAmx},
+#else
+        {"neon", MlasIsaBaseline},
+        {"dot", MlasIsaDot},
+        {"i8mm", MlasIsaI8mm},
+        {"sve", MlasIsaSve},
+#endif
+    };
+
+    char Value[32];
+#if defined(_WIN32)
+    DWORD Length = GetEnvironmentVariableA("MLAS_MAXIMUM_ISA", Value, sizeof(Value));
+    if (Length == 0 || Length >= sizeof(Value)) {
+        return MlasIsaAll;
+    }
+#else
+    const char* EnvironmentValue = getenv("MLAS_MAXIMUM_ISA");
+    if (EnvironmentValue == nullptr || strlen(EnvironmentValue) >= sizeof(Value)) {
+        return MlasIsaAll;
+    }
+    strcpy(Value, EnvironmentValue);
+#endif
+
+    for (const auto& IsaLevel : IsaLevels) {
+        if (strcmp(Value, IsaLevel.Name) == 0) {
+            return IsaLevel.Level;
+        }
+    }
+
+    return MlasIsaAll;
+}
+
+#endif
+
 MLAS_PLATFORM::MLAS_PLATFORM(
     void
     )
@@ -275,6 +389,8 @@ Return Value:
     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
     this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32Kernel;
     this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
+    this->LayerNormAccumulateF32Kernel = MlasLayerNormAccumulateF32Kernel;
+    this->LayerNormNormalizeF32Kernel = MlasLayerNormNormalizeF32Kernel;
     this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
     this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
     this->QLinearAddS8Kernel = MlasQLinearAddS8Kernel;
@@ -300,6 +416,8 @@ Return Value:
 
 #endif
 
+    const MLAS_ISA_LEVEL MaximumIsa = MlasGetMaximumIsaLevel();
+
     unsigned Cpuid1[4];
 #if defined(_WIN32)
     __cpuid((int*)Cpuid1, 1);
@@ -327,7 +445,7 @@ Return Value:
     //
 
 #ifndef FORCE_GENERIC_ALGORITHMS
-    if ((Cpuid1[2] & 0x18000000) == 0x18000000) {
+    if ((Cpuid1[2] & 0x18000000) == 0x18000000 && MaximumIsa >= MlasIsaAvx) {
 #else  // FORCE_GENERIC_ALGORITHMS
     if (false) {
 #endif  // FORCE_GENERIC_ALGORITHMS
@@ -372,7 +490,7 @@ Return Value:
             __cpuid_count(7, 0, Cpuid7[0], Cpuid7[1], Cpuid7[2], Cpuid7[3]);
 #endif
 
-            if (((Cpuid1[2] & 0x1000) != 0) && ((Cpuid7[1] & 0x20) != 0)) {
+            if (((Cpuid1[2] & 0x1000) != 0) && ((Cpuid7[1] & 0x20) != 0) && MaximumIsa >= MlasIsaAvx2) {
 
                 this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAvx2;
                 this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx2;
@@ -398,6 +516,8 @@ Return Value:
                 this->ConvDepthwiseS8S8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, int8_t>;
                 this->ConvDepthwiseS8U8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, uint8_t>;
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                this->LayerNormAccumulateF32Kernel = MlasLayerNormAccumulateF32KernelAvx2;
+                this->LayerNormNormalizeF32Kernel = MlasLayerNormNormalizeF32KernelAvx2;
                 this->QNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx2;
                 this->CastF16ToF32Kernel = &MlasCastF16ToF32KernelAvx2;
                 this->CastF32ToF16Kernel = &MlasCastF32ToF16KernelAvx2;
@@ -422,7 +542,7 @@ Return Value:
                 __cpuid_count(7, 1, Cpuid7_1[0], Cpuid7_1[1], Cpuid7_1[2], Cpuid7_1[3]);
 #endif
 
-                if ((Cpuid7_1[0] & 0x10) != 0) {
+                if ((Cpuid7_1[0] & 0x10) != 0 && MaximumIsa >= MlasIsaAvxVnni) {
 
                     this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAvx2;
                     this->GemmU8S8Kernel = MlasGemmU8S8KernelAvxVnni;
@@ -438,7 +558,7 @@ Return Value:
                 // operating system supports saving AVX512F state.
                 //
 
-                if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0)) {
+                if (((Cpuid7[1] & 0x10000) != 0) && ((xcr0 & 0xE0) == 0xE0) && MaximumIsa >= MlasIsaAvx512F) {
 
                     this->GemmFloatKernel = MlasGemmFloatKernelAvx512F;
                     this->GemmDoubleKernel = MlasGemmDoubleKernelAvx512F;
@@ -452,6 +572,8 @@ Return Value:
                     this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
                     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
                     this->ReduceMaximumF32Kernel = MlasReduceMaximumF32KernelAvx512F;
+                    this->LayerNormAccumulateF32Kernel = MlasLayerNormAccumulateF32KernelAvx512F;
+                    this->LayerNormNormalizeF32Kernel = MlasLayerNormNormalizeF32KernelAvx512F;
                     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8KernelAvx512F;
                     this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8KernelAvx512F;
                     this->NchwcBlockSize = 16;
@@ -462,7 +584,7 @@ Return Value:
                     // (AVX512BW/AVX512DQ/AVX512VL).
                     //
 
-                    if ((Cpuid7[1] & 0xC0020000) == 0xC0020000) {
+                    if ((Cpuid7[1] & 0xC0020000) == 0xC0020000 && MaximumIsa >= MlasIsaAvx512Core) {
 
                         this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Core;
                         this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Core;
@@ -475,7 +597,7 @@ Return Value:
                         // Check if the processor supports AVX512VNNI.
                         //
 
-                        if ((Cpuid7[2] & 0x800) != 0) {
+                        if ((Cpuid7[2] & 0x800) != 0 && MaximumIsa >= MlasIsaAvx512Vnni) {
 
                             this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAvx2;
                             this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Vnni;
@@ -484,13 +606,23 @@ Return Value:
                             this->Q8Q4GemmDispatch = &MlasQ8Q4GemmDispatchAvx512vnni;
                             this->QNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx512vnni;
                         }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+                        //
+                        // Check if the processor supports AVX512_BF16.
+                        //
+
+                        if ((Cpuid7_1[0] & 0x20) != 0 && MaximumIsa >= MlasIsaAvx512Vnni) {
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAvx512Bf16;
+                        }
+#endif
                     }
                 }
 
                 //
                 // Check if the processor supports AVX-VNNI-INT8
                 //
-                if ((Cpuid7_1[3] & 0x10) != 0) {
+                if ((Cpuid7_1[3] & 0x10) != 0 && MaximumIsa >= MlasIsaAvxVnni) {
                     this->GemmU8U8Dispatch = &MlasGemmU8U8DispatchAvx2Vnni;
                     this->GemmS8S8Dispatch = &MlasGemmS8S8DispatchAvx2Vnni;
                     this->GemmS8S8Kernel = MlasGemmS8S8KernelAvx2Vnni;
@@ -515,7 +647,8 @@ Return Value:
                 //
                 if ((Cpuid7[3] & 0b1 << 24) != 0 &&
                     (Cpuid7[3] & 0b1 << 25) != 0 &&
-                    (xcr0 & XFEATURE_MASK_XTILE) == XFEATURE_MASK_XTILE) {
+                    (xcr0 & XFEATURE_MASK_XTILE) == XFEATURE_MASK_XTILE &&
+                    MaximumIsa >= MlasIsaAmx) {
                     if (MlasInitAMX()) {
                         this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAmx;
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
@@ -536,6 +669,8 @@ Return Value:
 
 #if defined(MLAS_TARGET_ARM64)
 
+    const MLAS_ISA_LEVEL MaximumIsa = MlasGetMaximumIsaLevel();
+
     this->GemmU8U8Dispatch = &MlasGemmU8X8DispatchNeon;
     this->GemmU8S8Dispatch = &MlasGemmX8S8DispatchNeon;
     this->GemmS8S8Dispatch = &MlasGemmX8S8DispatchNeon;
@@ -544,6 +679,8 @@ Return Value:
     this->ConvSymS8S8Dispatch = &MlasConvSymS8DispatchNeon;
     this->QNBitGemmDispatch = &MlasSQNBitGemmDispatchNeon;
     this->RopeDispatch = &MlasRopeDispatchNeon;
+    this->GemmFloatKernelZero = MlasSgemmKernelZero;
+    this->GemmFloatKernelAdd = MlasSgemmKernelAdd;
 
     //
     // Check if the processor supports ASIMD dot product instructions.
@@ -566,7 +703,7 @@ Return Value:
     HasDotProductInstructions = MLAS_CPUIDINFO::GetCPUIDInfo().HasArmNeonDot();
 #endif
 
-    if (HasDotProductInstructions) {
+    if (HasDotProductInstructions && MaximumIsa >= MlasIsaDot) {
         this->GemmU8U8Dispatch = &MlasGemmU8X8DispatchUdot;
         this->GemmU8S8Dispatch = &MlasGemmU8X8DispatchUdot;
         this->GemmS8S8Dispatch = &MlasGemmS8S8DispatchSdot;
@@ -579,12 +716,29 @@ Return Value:
     //
     // Check if the processor supports ASIMD I8MM instructions.
     //
-    if (MLAS_CPUIDINFO::GetCPUIDInfo().HasArmNeon_I8MM()) {
+    if (MLAS_CPUIDINFO::GetCPUIDInfo().HasArmNeon_I8MM() && MaximumIsa >= MlasIsaI8mm) {
         this->GemmU8U8Dispatch = &MlasGemmU8X8DispatchUmmla;
         this->GemmU8S8Dispatch = &MlasGemmU8X8DispatchUmmla;
         this->GemmS8S8Dispatch = &MlasGemmS8S8DispatchSmmla;
+        this->ConvSymU8S8Dispatch = &MlasConvSymU8DispatchI8mm;
+        this->ConvSymS8S8Dispatch = &MlasConvSymS8DispatchI8mm;
+    }
+
+#if defined(MLAS_USE_SVE)
+    //
+    // Check if the processor supports SVE with vectors wider than the NEON
+    // vectors. The SVE kernels are vector length agnostic, but at 128 bits the
+    // NEON kernels are at least as fast.
+    //
+    if (MLAS_CPUIDINFO::GetCPUIDInfo().HasArmSVE() &&
+        MLAS_CPUIDINFO::GetCPUIDInfo().GetArmSVEVectorLengthInBytes() > 16 &&
+        MaximumIsa >= MlasIsaSve) {
+        this->GemmFloatKernelZero = MlasSgemmKernelZeroSve;
+        this->GemmFloatKernelAdd = MlasSgemmKernelAddSve;
+        this->QNBitGemmDispatch = &MlasSQNBitGemmDispatchSve;
     }
 #endif
+#endif
 
 #if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
     this->CastF16ToF32Kernel = &MlasCastF16ToF32KernelNeon;
@@ -689,6 +843,38 @@ Return Value:
 
 #endif // MLAS_TARGET_LARCH64
 
+#if defined(MLAS_TARGET_RISCV64)
+
+    //
+    // Default to the generic kernels and select the vector kernels if the
+    // vector extension is available. The vector kernels are vector length
+    // agnostic, so no further detection is needed.
+    //
+
+    this->GemmFloatKernelZero = MlasSgemmKernelZero;
+    this->GemmFloatKernelAdd = MlasSgemmKernelAdd;
+    this->GemmU8X8Dispatch = &MlasGemmQuantDispatchDefault;
+    this->ErfKernelRoutine = MlasErfKernel;
+    this->LogisticKernelRoutine = MlasLogisticKernel;
+    this->TanhKernelRoutine = MlasTanhKernel;
+
+#if defined(__linux__)
+    if ((getauxval(AT_HWCAP) & MLAS_RISCV_HWCAP_ISA_V) != 0) {
+        this->GemmFloatKernelZero = MlasSgemmKernelZeroRvv;
+        this->GemmFloatKernelAdd = MlasSgemmKernelAddRvv;
+        this->GemmU8X8Dispatch = &MlasGemmU8X8DispatchRvv;
+        this->ErfKernelRoutine = MlasErfKernelRvv;
+        this->LogisticKernelRoutine = MlasLogisticKernelRvv;
+        this->TanhKernelRoutine = MlasTanhKernelRvv;
+    }
+#endif
+
+#endif // MLAS_TARGET_RISCV64
+
+#if defined(MLAS_TARGET_WASM_SIMD)
+    this->QNBitGemmDispatch = &MlasSQNBitGemmDispatchWasmSimd;
+#endif // MLAS_TARGET_WASM_SIMD
+
 }
 
 size_t
@@ -721,6 +907,17 @@ Return Value:
 #endif
 }
 
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
+
+bool
+MLASCALL
+MlasBf16AccelerationSupported()
+{
+    return GetMlasPlatform().SBGemmDispatch != nullptr;
+}
+
+#endif
+
 #ifdef MLAS_TARGET_AMD64_IX86
 
 bool
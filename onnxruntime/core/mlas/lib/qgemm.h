@@ -901,6 +901,8 @@ MlasGemmQuantGetDispatch(
         GemmQuantDispatch =
             BIsSigned ? GetMlasPlatform().GemmU8S8Dispatch : GetMlasPlatform().GemmU8U8Dispatch;
     }
+#elif defined(MLAS_TARGET_RISCV64)
+    GemmQuantDispatch = GetMlasPlatform().GemmU8X8Dispatch;
 #endif
 #endif // !defined(FORCE_GENERIC_ALGORITHMS)
 
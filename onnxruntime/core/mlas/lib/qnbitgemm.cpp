@@ -18,7 +18,9 @@ Abstract:
 #include "qnbitgemm.h"
 #include "sqnbitgemm_q8_block.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 namespace
 {
@@ -32,6 +34,8 @@ enum QNBitGemmVariant {
     SQNBitGemmVariant_BitWidth4_CompInt8,
     HQNBitGemmVariant_BitWidth4_CompFp16,
     HQNBitGemmVariant_BitWidth4_CompInt8,
+    SQNBitGemmVariant_BitWidth2_CompInt8,
+    SQNBitGemmVariant_BitWidth3_CompInt8,
 
     // End of valid variants
 
@@ -60,9 +64,36 @@ GetQNBitGemmVariant(
         }
     }
 
+    if ((BlkBitWidth == 2 || BlkBitWidth == 3) &&
+        (BlkLen == 16 || BlkLen == 32 || BlkLen == 64 || BlkLen == 128 || BlkLen == 256) &&
+        ComputeType == SQNBIT_CompInt8) {
+        return BlkBitWidth == 2 ? SQNBitGemmVariant_BitWidth2_CompInt8 : SQNBitGemmVariant_BitWidth3_CompInt8;
+    }
+
     return SQNBitGemmVariantInvalid;
 }
 
+//
+// 2-bit and 3-bit quantized B with int8 compute type. The blocks of B are used as stored by MatMulNBits, the
+// values are packed in a little endian bit stream and so are the zero points of each column.
+//
+
+MLAS_FORCEINLINE bool
+IsQLowBitCompInt8(size_t BlkBitWidth, MLAS_QNBIT_GEMM_COMPUTE_TYPE ComputeType)
+{
+    return (BlkBitWidth == 2 || BlkBitWidth == 3) && ComputeType == SQNBIT_CompInt8;
+}
+
+//
+// Each row of quantized A holds the int8 values of all the blocks, followed by the scale and the scaled sum of the
+// values of each block.
+//
+MLAS_FORCEINLINE size_t
+QLowBitQuantARowStride(size_t K, size_t BlkLen)
+{
+    return MlasDivRoundup(K, BlkLen) * (BlkLen + 2 * sizeof(float));
+}
+
 }  // namespace
 
 bool MLASCALL
@@ -94,6 +125,11 @@ MlasIsQNBitGemmAvailable(
               (Dispatch->SQ4BitGemmKernel_CompInt8 != nullptr && Dispatch->QuantizeARow_CompInt8 != nullptr) ||
               (Dispatch->SQ4BitGemmKernel_BlkSum_CompInt8 != nullptr && Dispatch->QuantizeARowComputeBlkSum_CompInt8 != nullptr);
         }
+        case SQNBitGemmVariant_BitWidth2_CompInt8:
+        case SQNBitGemmVariant_BitWidth3_CompInt8: {
+            // the kernels are portable, they are enabled on the platforms with n-bit GEMM kernels
+            return true;
+        }
         default: {
             return false;
         }
@@ -122,6 +158,11 @@ QNBitGemmPerGemmWorkspaceSize(
         return Dispatch->Q4BitGemmPerGemmWorkspaceSize(M, N, K, BlkLen, ComputeType);
     }
 
+    if (IsQLowBitCompInt8(BlkBitWidth, ComputeType)) {
+        MLAS_UNREFERENCED_PARAMETER(N);
+        return M * QLowBitQuantARowStride(K, BlkLen);
+    }
+
     return 0;
 }
 
@@ -141,6 +182,10 @@ QNBitGemmPerGemmWorkspaceAlignment(
         return Dispatch->Q4BitGemmPerGemmWorkspaceAlignment(BlkLen, ComputeType);
     }
 
+    if (IsQLowBitCompInt8(BlkBitWidth, ComputeType)) {
+        return alignof(float);
+    }
+
     return 1;
 }
 
@@ -204,6 +249,10 @@ MlasQNBitGemmPackQuantBDataSize(
         );
     }
 
+    if (IsQLowBitCompInt8(BlkBitWidth, ComputeType)) {
+        return N * MlasDivRoundup(K, BlkLen) * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    }
+
     return 0;
 }
 
@@ -283,7 +332,90 @@ MlasQNBitGemmPackQuantBData(
             );
             return;
         }
+    } else if (IsQLowBitCompInt8(BlkBitWidth, ComputeType)) {
+        //
+        // The kernels read the blocks as they are stored, the scales and zero points aren't packed.
+        //
+        if (QuantBData != nullptr) {
+            const size_t PackedQuantBDataSize =
+                N * MlasDivRoundup(K, BlkLen) * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+            std::copy_n(
+                static_cast<const std::byte*>(QuantBData), PackedQuantBDataSize,
+                static_cast<std::byte*>(PackedQuantBDataAndOrBlkSumWorkspace)
+            );
+        }
+    }
+}
+
+void MLASCALL
+MlasQNBitGemmCopyPackedQuantBData(
+    size_t N,
+    size_t K,
+    size_t BlkBitWidth,
+    size_t BlkLen,
+    MLAS_QNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const void* PackedQuantBData,
+    void* Destination,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    const size_t PackedQuantBDataSize = MlasQNBitGemmPackQuantBDataSize(N, K, BlkBitWidth, BlkLen, ComputeType);
+    if (PackedQuantBDataSize == 0) {
+        return;
+    }
+
+    //
+    // Each part of the packed data is ordered by column of B. Copy the same
+    // fraction of every part in a given iteration, so that the iterations map
+    // to ranges of columns like the threads of MlasQNBitGemmBatch() do.
+    //
+
+    struct CopyRegion {
+        const std::byte* Source;
+        std::byte* Destination;
+        size_t Size;
+    };
+
+    CopyRegion Regions[3];
+    size_t RegionCount = 0;
+
+    const auto* Dispatch = GetMlasPlatform().QNBitGemmDispatch;
+    if (BlkBitWidth == 4 && ComputeType == SQNBIT_CompInt8 && Dispatch->SQ4BitGemmPackQuantBDataAndBlkSum != nullptr) {
+        //
+        // The parts are aligned from the start of the buffer, their offsets may
+        // differ between the two buffers.
+        //
+        const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+        PackedQuantBDataStruct<float> Source(const_cast<void*>(PackedQuantBData), N, BlockCountK, BlkLen);
+        PackedQuantBDataStruct<float> Target(Destination, N, BlockCountK, BlkLen);
+
+        Regions[RegionCount++] = {
+            Source.PackedQuantBData, Target.PackedQuantBData,
+            N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen)
+        };
+        Regions[RegionCount++] = {
+            reinterpret_cast<const std::byte*>(Source.QuantBBlkSum), reinterpret_cast<std::byte*>(Target.QuantBBlkSum),
+            MlasDivRoundup(N, 16) * BlockCountK * 16 * sizeof(float)
+        };
+        Regions[RegionCount++] = {
+            reinterpret_cast<const std::byte*>(Source.PackedQuantBScale), reinterpret_cast<std::byte*>(Target.PackedQuantBScale),
+            N * BlockCountK * sizeof(float)
+        };
+    } else {
+        Regions[RegionCount++] = {
+            static_cast<const std::byte*>(PackedQuantBData), static_cast<std::byte*>(Destination), PackedQuantBDataSize
+        };
     }
+
+    const ptrdiff_t Iterations = static_cast<ptrdiff_t>(MlasDivRoundup(N, MLAS_QGEMM_STRIDEN_THREAD_ALIGN));
+
+    MlasTrySimpleParallel(ThreadPool, Iterations, [&](ptrdiff_t tid) {
+        for (size_t r = 0; r < RegionCount; r++) {
+            const size_t Begin = Regions[r].Size * tid / Iterations;
+            const size_t End = Regions[r].Size * (tid + 1) / Iterations;
+            std::copy(Regions[r].Source + Begin, Regions[r].Source + End, Regions[r].Destination + Begin);
+        }
+    });
 }
 
 namespace
@@ -636,6 +768,245 @@ SQ4BitGemm_CompInt8(
     }
 }
 
+//
+// Lookup table of the four 2-bit values of each byte.
+//
+struct Q2BitUnpackTable {
+    constexpr Q2BitUnpackTable() : Values()
+    {
+        for (size_t i = 0; i < 256; ++i) {
+            for (size_t j = 0; j < 4; ++j) {
+                Values[i][j] = static_cast<uint8_t>((i >> (2 * j)) & 0x3);
+            }
+        }
+    }
+
+    uint8_t Values[256][4];
+};
+
+constexpr Q2BitUnpackTable Q2BitUnpack{};
+
+/*++
+
+Routine Description:
+
+    This routine unpacks 2-bit or 3-bit quantized values to one unsigned byte each.
+
+Arguments:
+
+    QuantBData - Supplies the bit stream of the quantized values.
+
+    Count - Supplies the number of values, a multiple of 8.
+
+    Unpacked - Returns the values.
+
+Return Value:
+
+    None.
+
+--*/
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE void
+UnpackQLowBitData(const std::byte* QuantBData, size_t Count, uint8_t* Unpacked)
+{
+    if constexpr (BlkBitWidth == 2) {
+        for (size_t i = 0; i < Count / 4; ++i) {
+            std::copy_n(Q2BitUnpack.Values[std::to_integer<uint8_t>(QuantBData[i])], 4, Unpacked + i * 4);
+        }
+    } else {
+        static_assert(BlkBitWidth == 3, "unsupported bit width");
+        // each 3 bytes hold 8 values
+        for (size_t i = 0; i < Count / 8; ++i) {
+            const std::byte* src = QuantBData + i * 3;
+            const uint32_t bits = std::to_integer<uint32_t>(src[0]) |
+                                  (std::to_integer<uint32_t>(src[1]) << 8) |
+                                  (std::to_integer<uint32_t>(src[2]) << 16);
+            for (size_t j = 0; j < 8; ++j) {
+                Unpacked[i * 8 + j] = static_cast<uint8_t>((bits >> (3 * j)) & 0x7);
+            }
+        }
+    }
+}
+
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE float
+GetQLowBitZeroPoint(const std::byte* QuantBZeroPoint, size_t BlkIdx)
+{
+    if (QuantBZeroPoint == nullptr) {
+        return static_cast<float>(1 << (BlkBitWidth - 1));
+    }
+
+    const size_t BitOffset = BlkIdx * BlkBitWidth;
+    uint32_t bits = std::to_integer<uint32_t>(QuantBZeroPoint[BitOffset / 8]);
+    if (BitOffset % 8 + BlkBitWidth > 8) {
+        bits |= std::to_integer<uint32_t>(QuantBZeroPoint[BitOffset / 8 + 1]) << 8;
+    }
+    return static_cast<float>((bits >> (BitOffset % 8)) & ((1u << BlkBitWidth) - 1));
+}
+
+MLAS_FORCEINLINE int32_t
+DotQLowBitBlk(const int8_t* QuantA, const uint8_t* UnpackedB, size_t BlkLen)
+{
+    // written so that compilers vectorize it to the int8/uint8 dot products of the target
+    int32_t sum = 0;
+    for (size_t k = 0; k < BlkLen; ++k) {
+        sum += int32_t{QuantA[k]} * int32_t{UnpackedB[k]};
+    }
+    return sum;
+}
+
+/*++
+
+Routine Description:
+
+    This routine quantizes a row of A to int8 per block of BlkLen values, in the layout of QLowBitQuantARowStride.
+
+Arguments:
+
+    BlkLen - Supplies the number of values per block.
+
+    A - Supplies the row of A.
+
+    CountK - Supplies the number of values of the row.
+
+    QuantA - Returns the quantized row.
+
+Return Value:
+
+    None.
+
+--*/
+void
+QuantizeARowQLowBit_CompInt8(size_t BlkLen, const float* A, size_t CountK, std::byte* QuantA)
+{
+    const size_t BlockCountK = MlasDivRoundup(CountK, BlkLen);
+    int8_t* QuantAData = reinterpret_cast<int8_t*>(QuantA);
+    float* QuantAScale = reinterpret_cast<float*>(QuantA + BlockCountK * BlkLen);
+    float* QuantABlkSum = QuantAScale + BlockCountK;
+
+    for (size_t blk = 0; blk < BlockCountK; ++blk) {
+        const float* a = A + blk * BlkLen;
+        int8_t* qa = QuantAData + blk * BlkLen;
+        const size_t CountBlk = std::min(CountK - blk * BlkLen, BlkLen);
+
+        float amax = 0.0f;
+        for (size_t k = 0; k < CountBlk; ++k) {
+            amax = std::max(amax, std::fabs(a[k]));
+        }
+
+        const float scale = amax / 127.0f;
+        const float inverse_scale = scale != 0.0f ? 1.0f / scale : 0.0f;
+        int32_t sum = 0;
+        for (size_t k = 0; k < CountBlk; ++k) {
+            const int32_t q = std::clamp(static_cast<int32_t>(std::nearbyint(a[k] * inverse_scale)), -127, 127);
+            qa[k] = static_cast<int8_t>(q);
+            sum += q;
+        }
+        std::fill(qa + CountBlk, qa + BlkLen, int8_t{0});
+
+        QuantAScale[blk] = scale;
+        QuantABlkSum[blk] = scale * static_cast<float>(sum);
+    }
+}
+
+//
+// With the weights unpacked to unsigned values, the zero point of each block is applied to the block sum of A:
+//   sum(a * (b - zp)) * scale_b = (dot(qa, b) * scale_a - zp * sum(qa) * scale_a) * scale_b
+// A column of B is unpacked once for all the rows of the range.
+//
+template <size_t BlkBitWidth>
+void
+SQLowBitGemm_CompInt8(
+    const size_t BlkLen,
+    const size_t K,
+    const MLAS_QNBIT_GEMM_DATA_PARAMS<float>* const DataParams,
+    void* const PerGemmWorkspace,
+    const size_t RangeStartM,
+    const size_t RangeCountM,
+    const size_t RangeStartN,
+    const size_t RangeCountN
+)
+{
+    const size_t k_blks = MlasDivRoundup(K, BlkLen);
+
+    const size_t lda = QLowBitQuantARowStride(K, BlkLen);
+    const size_t ldc = DataParams->ldc;
+    const size_t ldb = k_blks * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t k_blks_zp_bytes = MlasDivRoundup(k_blks * BlkBitWidth, 8);
+
+    const std::byte* QuantA = static_cast<const std::byte*>(PerGemmWorkspace) + RangeStartM * lda;
+
+    const std::byte* QuantBData = DataParams->PackedQuantBData + RangeStartN * ldb;
+    const float* QuantBScale = DataParams->QuantBScale + RangeStartN * k_blks;
+    const std::byte* QuantBZeroPoint =
+        (DataParams->QuantBZeroPoint == nullptr)
+            ? nullptr
+            : static_cast<const std::byte*>(DataParams->QuantBZeroPoint) + RangeStartN * k_blks_zp_bytes;
+
+    float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
+
+    const float* Bias = (DataParams->Bias == nullptr) ? nullptr : DataParams->Bias + RangeStartN;
+
+    MlasThreadedBufAlloc(k_blks * BlkLen);
+    uint8_t* b_col_unpacked = ThreadedBufHolder.get();
+
+    for (size_t n = 0; n < RangeCountN; ++n) {
+        const float* b_col_scale = QuantBScale + n * k_blks;
+        const std::byte* b_col_zp = (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * k_blks_zp_bytes;
+
+        UnpackQLowBitData<BlkBitWidth>(QuantBData + n * ldb, k_blks * BlkLen, b_col_unpacked);
+
+        for (size_t m = 0; m < RangeCountM; ++m) {
+            const std::byte* a_row = QuantA + m * lda;
+            const int8_t* a_data = reinterpret_cast<const int8_t*>(a_row);
+            const float* a_scale = reinterpret_cast<const float*>(a_row + k_blks * BlkLen);
+            const float* a_blk_sum = a_scale + k_blks;
+
+            float sum = (Bias == nullptr) ? 0.0f : Bias[n];
+            for (size_t blk = 0; blk < k_blks; ++blk) {
+                const int32_t dot = DotQLowBitBlk(a_data + blk * BlkLen, b_col_unpacked + blk * BlkLen, BlkLen);
+                const float zp = GetQLowBitZeroPoint<BlkBitWidth>(b_col_zp, blk);
+                sum += (static_cast<float>(dot) * a_scale[blk] - zp * a_blk_sum[blk]) * b_col_scale[blk];
+            }
+            C[m * ldc + n] = sum;
+        }
+    }
+
+    if (DataParams->PostProcessor != nullptr) {
+        DataParams->PostProcessor->Process(
+            DataParams->C, RangeStartM, RangeStartN, RangeCountM, RangeCountN, ldc
+        );
+    }
+}
+
+void
+InitializeWorkspace_QLowBit_CompInt8(
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchN,
+    size_t BlkLen,
+    const MLAS_QNBIT_GEMM_DATA_PARAMS<float>* DataParams,
+    void* Workspace,
+    size_t PerGemmWorkspaceStride,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(N);
+
+    const size_t QuantAStride = QLowBitQuantARowStride(K, BlkLen);
+
+    MlasTrySimpleParallel(ThreadPool, BatchN * M, [&](ptrdiff_t tid) {
+        const size_t gemm_idx = static_cast<size_t>(tid) / M;
+        const size_t m = static_cast<size_t>(tid) % M;
+        const auto& data = DataParams[gemm_idx];
+
+        std::byte* QuantARowPtr =
+            static_cast<std::byte*>(Workspace) + gemm_idx * PerGemmWorkspaceStride + m * QuantAStride;
+        QuantizeARowQLowBit_CompInt8(BlkLen, data.A + m * data.lda, K, QuantARowPtr);
+    });
+}
+
 template <typename T>
 void
 InitializeWorkspace_CompInt8(
@@ -755,6 +1126,9 @@ GetInitializeWorkspace(QNBitGemmVariant variant)
     switch (variant) {
         case SQNBitGemmVariant_BitWidth4_CompInt8:
             return InitializeWorkspace_CompInt8<float>;
+        case SQNBitGemmVariant_BitWidth2_CompInt8:
+        case SQNBitGemmVariant_BitWidth3_CompInt8:
+            return InitializeWorkspace_QLowBit_CompInt8;
         default:
             return nullptr;
     }
@@ -797,6 +1171,10 @@ GetQNBitGemm(QNBitGemmVariant variant)
             return SQ4BitGemm_CompFp32;
         case SQNBitGemmVariant_BitWidth4_CompInt8:
             return SQ4BitGemm_CompInt8;
+        case SQNBitGemmVariant_BitWidth2_CompInt8:
+            return SQLowBitGemm_CompInt8<2>;
+        case SQNBitGemmVariant_BitWidth3_CompInt8:
+            return SQLowBitGemm_CompInt8<3>;
         default:
             return nullptr;
     }
@@ -862,7 +1240,8 @@ MlasQNBitGemmBatch(
             const auto* Data = &DataParams[gemm_i];
             void* PerGemmWorkspace =
                 reinterpret_cast<std::byte*>(Workspace) + gemm_i * PerGemmWorkspaceStride;
-            if (ComputeType == SQNBIT_CompInt8 && GetMlasPlatform().QNBitGemmDispatch->SQ4BitGemmPackQuantBDataAndBlkSum != nullptr) {
+            if (BlkBitWidth == 4 && ComputeType == SQNBIT_CompInt8 &&
+                GetMlasPlatform().QNBitGemmDispatch->SQ4BitGemmPackQuantBDataAndBlkSum != nullptr) {
                 PackedQuantBDataStruct<T> packed_quant_b(const_cast<void*>(Data->QuantBDataWorkspace), N, BlockCountK, BlkLen);
                 const_cast<MLAS_QNBIT_GEMM_DATA_PARAMS<T>*>(Data)->PackedQuantBData = packed_quant_b.PackedQuantBData;
                 const_cast<MLAS_QNBIT_GEMM_DATA_PARAMS<T>*>(Data)->QuantBBlkSum = packed_quant_b.QuantBBlkSum;
@@ -933,7 +1312,8 @@ MlasQNBitGemmBatch(
 
         void* PerGemmWorkspace =
             reinterpret_cast<std::byte*>(Workspace) + gemm_i * PerGemmWorkspaceStride;
-        if (ComputeType == SQNBIT_CompInt8 && GetMlasPlatform().QNBitGemmDispatch->SQ4BitGemmPackQuantBDataAndBlkSum != nullptr) {
+        if (BlkBitWidth == 4 && ComputeType == SQNBIT_CompInt8 &&
+            GetMlasPlatform().QNBitGemmDispatch->SQ4BitGemmPackQuantBDataAndBlkSum != nullptr) {
             PackedQuantBDataStruct<T> packed_quant_b(const_cast<void*>(Data->QuantBDataWorkspace), N, BlockCountK, BlkLen);
             const_cast<MLAS_QNBIT_GEMM_DATA_PARAMS<T>*>(Data)->PackedQuantBData = packed_quant_b.PackedQuantBData;
             const_cast<MLAS_QNBIT_GEMM_DATA_PARAMS<T>*>(Data)->QuantBBlkSum = packed_quant_b.QuantBBlkSum;
@@ -51,11 +51,11 @@ Q4BitGemmPackQuantBDataSize(
 }
 
 void
-SQ4BitGemmPackQuantBData(
+SQ4BitGemmPackQuantBDataForSubBlkLen(
     size_t N,
     size_t K,
     size_t BlkLen,
-    MLAS_QNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    size_t SubBlkLen,
     const std::byte* QuantBDataBegin,
     std::byte* PackedQuantBDataBegin,
     MLAS_THREADPOOL* ThreadPool
@@ -64,15 +64,12 @@ SQ4BitGemmPackQuantBData(
     constexpr size_t BlkBitWidth = 4;
 
     assert(BlkLen >= 16 && BlkLen % 16 == 0);
+    assert(SubBlkLen >= 16 && BlkLen % SubBlkLen == 0);
 
     const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
     const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
     const size_t Iterations = N * BlockCountK;  // one iteration per block
 
-    const size_t SubBlkLen = (ComputeType == SQNBIT_CompInt8)
-                                 ? ((BlkLen == 16) ? 16 : 32)
-                                 : 16;
-
     const size_t SubBlkDataSize = SubBlkLen / 2;
     const size_t SubBlkBytePairCount = SubBlkLen / 4;
 
@@ -121,6 +118,50 @@ SQ4BitGemmPackQuantBData(
     );
 }
 
+void
+SQ4BitGemmPackQuantBData(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_QNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    const size_t SubBlkLen = (ComputeType == SQNBIT_CompInt8)
+                                 ? ((BlkLen == 16) ? 16 : 32)
+                                 : 16;
+
+    SQ4BitGemmPackQuantBDataForSubBlkLen(N, K, BlkLen, SubBlkLen, QuantBDataBegin, PackedQuantBDataBegin, ThreadPool);
+}
+
+#if defined(MLAS_USE_SVE)
+
+void
+SQ4BitGemmPackQuantBData_Sve(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_QNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    //
+    // The SVE int8 kernel loads as many bytes of a block as fit in a vector, so
+    // a block is packed as a single sub-block: the low and high halves of
+    // byte i hold values i and i + BlkLen / 2.
+    //
+
+    const size_t SubBlkLen = (ComputeType == SQNBIT_CompInt8) ? BlkLen : 16;
+
+    SQ4BitGemmPackQuantBDataForSubBlkLen(N, K, BlkLen, SubBlkLen, QuantBDataBegin, PackedQuantBDataBegin, ThreadPool);
+}
+
+#endif  // defined(MLAS_USE_SVE)
+
 //
 // Workspace size calculation function implementation.
 //
@@ -199,3 +240,21 @@ const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchNeon = []() {
 
     return d;
 }();
+
+#if defined(MLAS_USE_SVE)
+
+//
+// The SVE dispatch replaces the int8 kernel, which depends on the packing of
+// matrix B, and otherwise uses the NEON kernels.
+//
+
+const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchSve = []() {
+    MLAS_QNBIT_GEMM_DISPATCH d = MlasSQNBitGemmDispatchNeon;
+
+    d.SQ4BitGemmPackQuantBData = sqnbitgemm_neon::SQ4BitGemmPackQuantBData_Sve;
+    d.SQ4BitGemmKernel_CompInt8 = sqnbitgemm_neon::SQ4BitGemmKernel_CompInt8_Sve;
+
+    return d;
+}();
+
+#endif  // defined(MLAS_USE_SVE)
@@ -131,6 +131,27 @@ SQ4BitGemmKernel_CompInt8(
     const float* Bias
 );
 
+#if defined(MLAS_USE_SVE)
+
+// The SVE kernel requires the packing of SQ4BitGemmPackQuantBData_Sve.
+size_t
+SQ4BitGemmKernel_CompInt8_Sve(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+);
+
+#endif  // defined(MLAS_USE_SVE)
+
 //
 // General helpers.
 //
@@ -115,7 +115,9 @@ MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR::ProcessImpl(
 Routine Description:
 
     This routine converts the output matrix C to a floating point format using
-    the stored scale and bias parameters.
+    the stored scale and bias parameters. If row scales were supplied, each
+    row of the output is additionally multiplied by its row scale before the
+    bias is added.
 
 Arguments:
 
@@ -149,9 +151,17 @@ Return Value:
         Scale += StartN;
     }
 
+    const float* RowScale = RowScale_;
+
+    if (RowScale != nullptr) {
+        RowScale += StartM;
+    }
+
     MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale_);
+    MLAS_FLOAT32X4 RowScaleVector = MlasBroadcastFloat32x4(1.0f);
 #if !defined(MLAS_SSE2_INTRINSICS)
     float ScaleValue = MlasExtractLaneFloat32x4<0>(ScaleVector);
+    float RowScaleValue = 1.0f;
 #endif
 
     C += StartM * ldc + StartN;
@@ -165,6 +175,26 @@ Return Value:
         const float* bias = Bias;
         const float* scale = Scale;
 
+        //
+        // Fold the row scale into the matrix scale when the scale is uniform,
+        // otherwise apply the row scale separately to each column vector.
+        //
+
+        if (RowScale != nullptr) {
+            if (QuantGran == MLAS_QUANTIZATION_GRANULARITY::PerColumn) {
+                RowScaleVector = MlasBroadcastFloat32x4(RowScale);
+#if !defined(MLAS_SSE2_INTRINSICS)
+                RowScaleValue = *RowScale;
+#endif
+            } else {
+                ScaleVector = MlasBroadcastFloat32x4(Scale_[0] * *RowScale);
+#if !defined(MLAS_SSE2_INTRINSICS)
+                ScaleValue = Scale_[0] * *RowScale;
+#endif
+            }
+            RowScale++;
+        }
+
         size_t n = CountN;
 
         while (n >= 4) {
@@ -174,6 +204,10 @@ Return Value:
             if (QuantGran == MLAS_QUANTIZATION_GRANULARITY::PerColumn) {
                 ScaleVector = MlasLoadFloat32x4(scale);
                 scale += 4;
+
+                if (RowScale != nullptr) {
+                    FloatVector = MlasMultiplyFloat32x4(FloatVector, RowScaleVector);
+                }
             }
 
             if (Mode == MLAS_QGEMM_OUTPUT_MODE::AccumulateMode) {
@@ -201,6 +235,10 @@ Return Value:
 
             if (QuantGran == MLAS_QUANTIZATION_GRANULARITY::PerColumn) {
                 ScaleVector = _mm_load_ss(&scale[offset]);
+
+                if (RowScale != nullptr) {
+                    FloatVector = _mm_mul_ss(FloatVector, RowScaleVector);
+                }
             }
 
             if (Mode == MLAS_QGEMM_OUTPUT_MODE::AccumulateMode) {
@@ -220,6 +258,9 @@ Return Value:
             }
 
             float result = float(c[offset]) * ScaleValue;
+            if (QuantGran == MLAS_QUANTIZATION_GRANULARITY::PerColumn && RowScale != nullptr) {
+                result *= RowScaleValue;
+            }
             if (HasBias) {
                 result += bias[offset];
             }
@@ -2119,3 +2119,96 @@ Return Value:
     MlasReduceMinimumMaximumF32Kernel(Input, Min, Max, N);
 #endif
 }
+
+void
+MLASCALL
+MlasDynamicQuantizeLinearPerRow(
+    const float* Input,
+    size_t lda,
+    uint8_t* Output,
+    size_t ldo,
+    float* Scale,
+    size_t M,
+    size_t K,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine quantizes each row of the input matrix to uint8 using a
+    symmetric scale derived from the absolute maximum of the row. The range
+    of the row is found and the row is quantized back to back, so the second
+    pass over the row is served from the cache.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    lda - Supplies the leading dimension of the input matrix.
+
+    Output - Returns the quantized matrix.
+
+    ldo - Supplies the leading dimension of the output matrix.
+
+    Scale - Returns the scale of each row.
+
+    M - Supplies the number of rows.
+
+    K - Supplies the number of columns.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Limit the number of threads to the number of rows and try to keep each
+    // thread processing a minimum number of elements before using another
+    // thread.
+    //
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > M) {
+        ThreadCount = ptrdiff_t(M);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((M * K) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = ptrdiff_t(BlockCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t ThreadId) {
+
+        size_t RowStart;
+        size_t RowCount;
+
+        MlasPartitionWork(ThreadId, ThreadCount, M, &RowStart, &RowCount);
+
+        for (size_t m = RowStart; m < RowStart + RowCount; m++) {
+
+            const float* InputRow = Input + m * lda;
+            uint8_t* OutputRow = Output + m * ldo;
+
+            float Minimum;
+            float Maximum;
+
+            MlasFindMinMaxElement(InputRow, &Minimum, &Maximum, K);
+
+            const float AbsMaximum = std::max(std::fabs(Minimum), std::fabs(Maximum));
+            const float RowScale = (AbsMaximum > 0.0f) ? AbsMaximum / 127.0f : 1.0f;
+
+            MlasQuantizeLinear<uint8_t>(InputRow, OutputRow, K, RowScale, MLAS_DYNAMIC_QUANTIZE_ROW_ZERO_POINT);
+
+            Scale[m] = RowScale;
+        }
+    });
+}
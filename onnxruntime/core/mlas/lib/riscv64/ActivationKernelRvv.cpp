@@ -0,0 +1,345 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    ActivationKernelRvv.cpp
+
+Abstract:
+
+    This module implements the kernels for the logistic, hyperbolic tangent
+    and error functions using the RISC-V vector extension.
+
+    The kernels evaluate the same approximations as the generic kernels in
+    logistic.cpp, tanh.cpp and erf.cpp. The constants are repeated here as the
+    generic kernels bundle them in unnamed structures.
+
+--*/
+
+#include "mlasi.h"
+
+#include <riscv_vector.h>
+
+namespace {
+
+struct MLAS_LOGISTIC_CONSTANTS_RVV {
+    static constexpr float LowerRange = -18.0f;
+    static constexpr float UpperRange = 18.0f;
+    static constexpr float alpha_9 = 4.37031012579801e-11f;
+    static constexpr float alpha_7 = 1.15627324459942e-07f;
+    static constexpr float alpha_5 = 6.08574864600143e-05f;
+    static constexpr float alpha_3 = 8.51377133304701e-03f;
+    static constexpr float alpha_1 = 2.48287947061529e-01f;
+    static constexpr float beta_10 = 6.10247389755681e-13f;
+    static constexpr float beta_8 = 5.76102136993427e-09f;
+    static constexpr float beta_6 = 6.29106785017040e-06f;
+    static constexpr float beta_4 = 1.70198817374094e-03f;
+    static constexpr float beta_2 = 1.16817656904453e-01f;
+    static constexpr float beta_0 = 9.93151921023180e-01f;
+    static constexpr float one_half = 0.5f;
+};
+
+struct MLAS_TANH_CONSTANTS_RVV {
+    static constexpr float LowerRange = -9.0f;
+    static constexpr float UpperRange = 9.0f;
+    static constexpr float alpha_13 = -2.76076847742355e-16f;
+    static constexpr float alpha_11 = 2.00018790482477e-13f;
+    static constexpr float alpha_9 = -8.60467152213735e-11f;
+    static constexpr float alpha_7 = 5.12229709037114e-08f;
+    static constexpr float alpha_5 = 1.48572235717979e-05f;
+    static constexpr float alpha_3 = 6.37261928875436e-04f;
+    static constexpr float alpha_1 = 4.89352455891786e-03f;
+    static constexpr float beta_6 = 1.19825839466702e-06f;
+    static constexpr float beta_4 = 1.18534705686654e-04f;
+    static constexpr float beta_2 = 2.26843463243900e-03f;
+    static constexpr float beta_0 = 4.89352518554385e-03f;
+};
+
+struct MLAS_ERF_CONSTANTS_RVV {
+    static constexpr float ErfUpperAbsRange = 3.925f;
+    static constexpr float ErfSplitBoundary = 0.921875f;
+    static constexpr float ErfSMALL_P0 = -5.99104969e-4f;
+    static constexpr float ErfSMALL_P1 = 4.99339588e-3f;
+    static constexpr float ErfSMALL_P2 = -2.67667342e-2f;
+    static constexpr float ErfSMALL_P3 = 1.12818025e-1f;
+    static constexpr float ErfSMALL_P4 = -3.76124859e-1f;
+    static constexpr float ErfSMALL_P5_Minus_One = 1.28379151e-1f;
+    static constexpr float ErfBIG_P0 = 1.72948930e-5f;
+    static constexpr float ErfBIG_P1 = -3.83208680e-4f;
+    static constexpr float ErfBIG_P2 = 3.88393435e-3f;
+    static constexpr float ErfBIG_P3 = -2.42545605e-2f;
+    static constexpr float ErfBIG_P4 = 1.06777847e-1f;
+    static constexpr float ErfBIG_P5 = 6.34846687e-1f;
+    static constexpr float ErfBIG_P6_Minus_One = 1.28717512e-1f;
+    static constexpr float ErfOne = 1.0f;
+
+    static constexpr float Exp_LowerRange = -88.3762626647949f;
+    static constexpr float Exp_Log2Reciprocal = 1.44269504088896341f;
+    static constexpr float Exp_log2_hi = -6.93145752e-1f;
+    static constexpr float Exp_log2_lo = -1.42860677e-6f;
+    static constexpr float Exp_P0 = 1.38319808e-3f;
+    static constexpr float Exp_P1 = 8.37550033e-3f;
+    static constexpr float Exp_P2 = 4.16689515e-2f;
+    static constexpr float Exp_P3 = 1.66664466e-1f;
+    static constexpr float Exp_P4 = 4.99999851e-1f;
+    static constexpr float Exp_P5 = 1.00000000e+0f;
+    static constexpr float Exp_P6 = 1.00000000e+0f;
+    static constexpr float Exp_C = 1.25829120e+7f;
+    static constexpr int32_t Exp_X7F = 127;
+};
+
+MLAS_FORCEINLINE
+vfloat32m4_t
+MlasClampFloat32Rvv(
+    vfloat32m4_t Value,
+    float LowerRange,
+    float UpperRange,
+    size_t vl
+    )
+{
+    //
+    // Clamp with comparisons instead of vfmax/vfmin, which return the other
+    // operand for a NaN input, so that a NaN input produces a NaN output as
+    // with the generic kernels.
+    //
+
+    Value = __riscv_vfmerge_vfm_f32m4(Value, LowerRange, __riscv_vmflt_vf_f32m4_b8(Value, LowerRange, vl), vl);
+    Value = __riscv_vfmerge_vfm_f32m4(Value, UpperRange, __riscv_vmfgt_vf_f32m4_b8(Value, UpperRange, vl), vl);
+
+    return Value;
+}
+
+}  // namespace
+
+void
+MLASCALL
+MlasLogisticKernelRvv(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vector kernel for the logistic function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Constants = MLAS_LOGISTIC_CONSTANTS_RVV;
+
+    while (N > 0) {
+
+        const size_t vl = __riscv_vsetvl_e32m4(N);
+
+        vfloat32m4_t Value = __riscv_vle32_v_f32m4(Input, vl);
+        Value = MlasClampFloat32Rvv(Value, Constants::LowerRange, Constants::UpperRange, vl);
+
+        vfloat32m4_t ValueSquared = __riscv_vfmul_vv_f32m4(Value, Value, vl);
+
+        vfloat32m4_t p = __riscv_vfmv_v_f_f32m4(Constants::alpha_7, vl);
+        p = __riscv_vfmacc_vf_f32m4(p, Constants::alpha_9, ValueSquared, vl);
+        p = __riscv_vfmadd_vv_f32m4(p, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::alpha_5, vl), vl);
+        p = __riscv_vfmadd_vv_f32m4(p, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::alpha_3, vl), vl);
+        p = __riscv_vfmadd_vv_f32m4(p, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::alpha_1, vl), vl);
+        p = __riscv_vfmul_vv_f32m4(p, Value, vl);
+
+        vfloat32m4_t q = __riscv_vfmv_v_f_f32m4(Constants::beta_8, vl);
+        q = __riscv_vfmacc_vf_f32m4(q, Constants::beta_10, ValueSquared, vl);
+        q = __riscv_vfmadd_vv_f32m4(q, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::beta_6, vl), vl);
+        q = __riscv_vfmadd_vv_f32m4(q, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::beta_4, vl), vl);
+        q = __riscv_vfmadd_vv_f32m4(q, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::beta_2, vl), vl);
+        q = __riscv_vfmadd_vv_f32m4(q, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::beta_0, vl), vl);
+
+        vfloat32m4_t Result = __riscv_vfadd_vf_f32m4(__riscv_vfdiv_vv_f32m4(p, q, vl), Constants::one_half, vl);
+        __riscv_vse32_v_f32m4(Output, Result, vl);
+
+        Input += vl;
+        Output += vl;
+        N -= vl;
+    }
+}
+
+void
+MLASCALL
+MlasTanhKernelRvv(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vector kernel for the hyperbolic tangent
+    function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Constants = MLAS_TANH_CONSTANTS_RVV;
+
+    while (N > 0) {
+
+        const size_t vl = __riscv_vsetvl_e32m4(N);
+
+        vfloat32m4_t Value = __riscv_vle32_v_f32m4(Input, vl);
+        Value = MlasClampFloat32Rvv(Value, Constants::LowerRange, Constants::UpperRange, vl);
+
+        vfloat32m4_t ValueSquared = __riscv_vfmul_vv_f32m4(Value, Value, vl);
+
+        vfloat32m4_t p = __riscv_vfmv_v_f_f32m4(Constants::alpha_11, vl);
+        p = __riscv_vfmacc_vf_f32m4(p, Constants::alpha_13, ValueSquared, vl);
+        p = __riscv_vfmadd_vv_f32m4(p, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::alpha_9, vl), vl);
+        p = __riscv_vfmadd_vv_f32m4(p, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::alpha_7, vl), vl);
+        p = __riscv_vfmadd_vv_f32m4(p, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::alpha_5, vl), vl);
+        p = __riscv_vfmadd_vv_f32m4(p, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::alpha_3, vl), vl);
+        p = __riscv_vfmadd_vv_f32m4(p, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::alpha_1, vl), vl);
+        p = __riscv_vfmul_vv_f32m4(p, Value, vl);
+
+        vfloat32m4_t q = __riscv_vfmv_v_f_f32m4(Constants::beta_4, vl);
+        q = __riscv_vfmacc_vf_f32m4(q, Constants::beta_6, ValueSquared, vl);
+        q = __riscv_vfmadd_vv_f32m4(q, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::beta_2, vl), vl);
+        q = __riscv_vfmadd_vv_f32m4(q, ValueSquared, __riscv_vfmv_v_f_f32m4(Constants::beta_0, vl), vl);
+
+        __riscv_vse32_v_f32m4(Output, __riscv_vfdiv_vv_f32m4(p, q, vl), vl);
+
+        Input += vl;
+        Output += vl;
+        N -= vl;
+    }
+}
+
+void
+MLASCALL
+MlasErfKernelRvv(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the vector kernel for the error function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Constants = MLAS_ERF_CONSTANTS_RVV;
+
+    while (N > 0) {
+
+        const size_t vl = __riscv_vsetvl_e32m4(N);
+
+        vfloat32m4_t Value = __riscv_vle32_v_f32m4(Input, vl);
+        vfloat32m4_t AbsValue = __riscv_vfabs_v_f32m4(Value, vl);
+        vbool8_t SplitMask = __riscv_vmfgt_vf_f32m4_b8(AbsValue, Constants::ErfSplitBoundary, vl);
+
+        //
+        // Evaluate the approximation for the values below the split boundary.
+        //
+
+        vfloat32m4_t SquareValue = __riscv_vfmul_vv_f32m4(AbsValue, AbsValue, vl);
+
+        vfloat32m4_t r_small = __riscv_vfmv_v_f_f32m4(Constants::ErfSMALL_P1, vl);
+        r_small = __riscv_vfmacc_vf_f32m4(r_small, Constants::ErfSMALL_P0, SquareValue, vl);
+        r_small = __riscv_vfmadd_vv_f32m4(r_small, SquareValue, __riscv_vfmv_v_f_f32m4(Constants::ErfSMALL_P2, vl), vl);
+        r_small = __riscv_vfmadd_vv_f32m4(r_small, SquareValue, __riscv_vfmv_v_f_f32m4(Constants::ErfSMALL_P3, vl), vl);
+        r_small = __riscv_vfmadd_vv_f32m4(r_small, SquareValue, __riscv_vfmv_v_f_f32m4(Constants::ErfSMALL_P4, vl), vl);
+        r_small = __riscv_vfmadd_vv_f32m4(r_small, SquareValue, __riscv_vfmv_v_f_f32m4(Constants::ErfSMALL_P5_Minus_One, vl), vl);
+        r_small = __riscv_vfmadd_vv_f32m4(r_small, AbsValue, AbsValue, vl);
+
+        //
+        // Evaluate 1 - exp(-r_big) for the values above the split boundary.
+        //
+
+        AbsValue = __riscv_vfmin_vf_f32m4(AbsValue, Constants::ErfUpperAbsRange, vl);
+
+        vfloat32m4_t r_big = __riscv_vfmv_v_f_f32m4(Constants::ErfBIG_P1, vl);
+        r_big = __riscv_vfmacc_vf_f32m4(r_big, Constants::ErfBIG_P0, AbsValue, vl);
+        r_big = __riscv_vfmadd_vv_f32m4(r_big, AbsValue, __riscv_vfmv_v_f_f32m4(Constants::ErfBIG_P2, vl), vl);
+        r_big = __riscv_vfmadd_vv_f32m4(r_big, AbsValue, __riscv_vfmv_v_f_f32m4(Constants::ErfBIG_P3, vl), vl);
+        r_big = __riscv_vfmadd_vv_f32m4(r_big, AbsValue, __riscv_vfmv_v_f_f32m4(Constants::ErfBIG_P4, vl), vl);
+        r_big = __riscv_vfmadd_vv_f32m4(r_big, AbsValue, __riscv_vfmv_v_f_f32m4(Constants::ErfBIG_P5, vl), vl);
+        r_big = __riscv_vfmadd_vv_f32m4(r_big, AbsValue, __riscv_vfmv_v_f_f32m4(Constants::ErfBIG_P6_Minus_One, vl), vl);
+        r_big = __riscv_vfmadd_vv_f32m4(r_big, AbsValue, AbsValue, vl);
+
+        r_big = __riscv_vfneg_v_f32m4(r_big, vl);
+        r_big = __riscv_vfmax_vf_f32m4(r_big, Constants::Exp_LowerRange, vl);
+
+        vfloat32m4_t r = __riscv_vfmv_v_f_f32m4(Constants::Exp_C, vl);
+        r = __riscv_vfmacc_vf_f32m4(r, Constants::Exp_Log2Reciprocal, r_big, vl);
+        r = __riscv_vfsub_vf_f32m4(r, Constants::Exp_C, vl);
+
+        vfloat32m4_t fx = __riscv_vfmacc_vf_f32m4(r_big, Constants::Exp_log2_hi, r, vl);
+        fx = __riscv_vfmacc_vf_f32m4(fx, Constants::Exp_log2_lo, r, vl);
+
+        vfloat32m4_t y = __riscv_vfmv_v_f_f32m4(Constants::Exp_P1, vl);
+        y = __riscv_vfmacc_vf_f32m4(y, Constants::Exp_P0, fx, vl);
+        y = __riscv_vfmadd_vv_f32m4(y, fx, __riscv_vfmv_v_f_f32m4(Constants::Exp_P2, vl), vl);
+        y = __riscv_vfmadd_vv_f32m4(y, fx, __riscv_vfmv_v_f_f32m4(Constants::Exp_P3, vl), vl);
+        y = __riscv_vfmadd_vv_f32m4(y, fx, __riscv_vfmv_v_f_f32m4(Constants::Exp_P4, vl), vl);
+        y = __riscv_vfmadd_vv_f32m4(y, fx, __riscv_vfmv_v_f_f32m4(Constants::Exp_P5, vl), vl);
+        y = __riscv_vfmadd_vv_f32m4(y, fx, __riscv_vfmv_v_f_f32m4(Constants::Exp_P6, vl), vl);
+
+        //
+        // Scale by 2^r, which is an integer, by building the exponent bits.
+        //
+
+        vint32m4_t Exponent = __riscv_vfcvt_x_f_v_i32m4(r, vl);
+        Exponent = __riscv_vsll_vx_i32m4(__riscv_vadd_vx_i32m4(Exponent, Constants::Exp_X7F, vl), 23, vl);
+        y = __riscv_vfmul_vv_f32m4(y, __riscv_vreinterpret_v_i32m4_f32m4(Exponent), vl);
+        y = __riscv_vfrsub_vf_f32m4(y, Constants::ErfOne, vl);
+
+        //
+        // Merge the results of the two ranges and restore the sign.
+        //
+
+        vfloat32m4_t Result = __riscv_vmerge_vvm_f32m4(r_small, y, SplitMask, vl);
+        Result = __riscv_vfsgnj_vv_f32m4(Result, Value, vl);
+
+        __riscv_vse32_v_f32m4(Output, Result, vl);
+
+        Input += vl;
+        Output += vl;
+        N -= vl;
+    }
+}
@@ -0,0 +1,257 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    SgemmKernelRvv.cpp
+
+Abstract:
+
+    This module implements the kernels for the single precision matrix/matrix
+    multiply operation (SGEMM) using the RISC-V vector extension.
+
+    The kernels are vector length agnostic: the 16 columns of a panel of the
+    packed matrix B are processed in as many vectors as the hardware vector
+    length requires.
+
+--*/
+
+#include "mlasi.h"
+
+#include <riscv_vector.h>
+
+template<size_t RowCount, bool ZeroMode>
+MLAS_FORCEINLINE
+void
+MlasSgemmComputeBlockRvv(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine computes up to RowCount rows and CountN columns of matrix C
+    from columns of a single panel of the packed matrix B.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of the first column to process within a panel of
+        the packed matrix B.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountN - Supplies the number of columns to process, which must fit in a
+        single vector.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scaler multiplier (see SGEMM definition).
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t vl = __riscv_vsetvl_e32m4(CountN);
+
+    vfloat32m4_t Accumulator0 = __riscv_vfmv_v_f_f32m4(0.0f, vl);
+    vfloat32m4_t Accumulator1 = Accumulator0;
+    vfloat32m4_t Accumulator2 = Accumulator0;
+    vfloat32m4_t Accumulator3 = Accumulator0;
+
+    for (size_t k = 0; k < CountK; k++) {
+
+        vfloat32m4_t BElements = __riscv_vle32_v_f32m4(B, vl);
+
+        Accumulator0 = __riscv_vfmacc_vf_f32m4(Accumulator0, A[k], BElements, vl);
+        if constexpr (RowCount > 1) {
+            Accumulator1 = __riscv_vfmacc_vf_f32m4(Accumulator1, A[lda + k], BElements, vl);
+        }
+        if constexpr (RowCount > 2) {
+            Accumulator2 = __riscv_vfmacc_vf_f32m4(Accumulator2, A[2 * lda + k], BElements, vl);
+        }
+        if constexpr (RowCount > 3) {
+            Accumulator3 = __riscv_vfmacc_vf_f32m4(Accumulator3, A[3 * lda + k], BElements, vl);
+        }
+
+        B += 16;
+    }
+
+    //
+    // Multiply by the alpha value and accumulate into matrix C if needed.
+    //
+
+    auto StoreRow = [&](float* c, vfloat32m4_t Accumulator) {
+        if constexpr (ZeroMode) {
+            Accumulator = __riscv_vfmul_vf_f32m4(Accumulator, alpha, vl);
+        } else {
+            Accumulator = __riscv_vfmadd_vf_f32m4(Accumulator, alpha, __riscv_vle32_v_f32m4(c, vl), vl);
+        }
+        __riscv_vse32_v_f32m4(c, Accumulator, vl);
+    };
+
+    StoreRow(C, Accumulator0);
+    if constexpr (RowCount > 1) {
+        StoreRow(C + ldc, Accumulator1);
+    }
+    if constexpr (RowCount > 2) {
+        StoreRow(C + 2 * ldc, Accumulator2);
+    }
+    if constexpr (RowCount > 3) {
+        StoreRow(C + 3 * ldc, Accumulator3);
+    }
+}
+
+template<size_t RowCount, bool ZeroMode>
+void
+MlasSgemmComputeRowsRvv(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+{
+    //
+    // Process the packed matrix B one panel of 16 columns at a time. The
+    // last panel is zero padded, but only the valid columns are stored.
+    //
+
+    while (CountN > 0) {
+
+        const size_t CountPanelN = std::min<size_t>(CountN, 16);
+
+        for (size_t n = 0; n < CountPanelN;) {
+
+            const size_t vl = __riscv_vsetvl_e32m4(CountPanelN - n);
+
+            MlasSgemmComputeBlockRvv<RowCount, ZeroMode>(A, B + n, C + n, CountK, vl, lda, ldc, alpha);
+
+            n += vl;
+        }
+
+        B += CountK * 16;
+        C += CountPanelN;
+        CountN -= CountPanelN;
+    }
+}
+
+template<bool ZeroMode>
+size_t
+MlasSgemmKernelRvv(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. The matrix data has been packed using
+        MlasSgemmCopyPackB or MlasSgemmTransposePackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scaler multiplier (see SGEMM definition).
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    if (CountM >= 4) {
+        MlasSgemmComputeRowsRvv<4, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+        return 4;
+    }
+
+    if (CountM >= 2) {
+        MlasSgemmComputeRowsRvv<2, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+        return 2;
+    }
+
+    MlasSgemmComputeRowsRvv<1, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+    return 1;
+}
+
+size_t
+MLASCALL
+MlasSgemmKernelZeroRvv(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+{
+    return MlasSgemmKernelRvv<true>(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+}
+
+size_t
+MLASCALL
+MlasSgemmKernelAddRvv(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+{
+    return MlasSgemmKernelRvv<false>(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+}
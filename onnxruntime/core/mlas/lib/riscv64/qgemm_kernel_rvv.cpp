@@ -0,0 +1,246 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    qgemm_kernel_rvv.cpp
+
+Abstract:
+
+    This module implements QGEMM kernels for the RISC-V vector extension.
+
+    The matrices are packed as for the default kernel: the rows of matrix A
+    and the columns of matrix B are stored contiguously with signed values
+    converted to unsigned ones, so that the kernel computes the dot products
+    along the K dimension with widening unsigned multiplies and reductions.
+
+--*/
+
+#include "mlasi.h"
+#include "qgemm.h"
+
+#include <riscv_vector.h>
+
+struct MLAS_GEMM_U8X8_KERNEL_RVV
+{
+    typedef uint8_t PackedAType;
+    typedef uint8_t PackedBType;
+    typedef uint8_t OffsetAType;
+    typedef uint8_t OffsetBType;
+
+    static constexpr size_t PackedK = 4;
+    static constexpr MLAS_GEMM_QUANT_STRIDES Strides{ 16, 128, 128 };
+    static constexpr MLAS_GEMM_QUANT_STRIDES PackedStrides{ 0, 0, 0 };
+};
+
+constexpr size_t MLAS_GEMM_U8X8_KERNEL_RVV::PackedK;
+constexpr MLAS_GEMM_QUANT_STRIDES MLAS_GEMM_U8X8_KERNEL_RVV::Strides;
+constexpr MLAS_GEMM_QUANT_STRIDES MLAS_GEMM_U8X8_KERNEL_RVV::PackedStrides;
+
+template<>
+MLAS_FORCEINLINE constexpr
+int32_t
+MlasGemmQuantFixupZeroPointA<MLAS_GEMM_U8X8_KERNEL_RVV>(
+    int32_t ZeroPointA,
+    bool AIsSigned
+    )
+{
+    if (AIsSigned) {
+        ZeroPointA = (uint8_t)(ZeroPointA ^ 0x80);
+    }
+
+    return ZeroPointA;
+}
+
+template<>
+MLAS_FORCEINLINE constexpr
+int32_t
+MlasGemmQuantFixupZeroPointB<MLAS_GEMM_U8X8_KERNEL_RVV>(
+    int32_t ZeroPointB,
+    bool BIsSigned
+    )
+{
+    if (BIsSigned) {
+        ZeroPointB = MLAS_GEMM_U8X8_KERNEL_RVV::OffsetBType(ZeroPointB ^ 0x80);
+    }
+
+    return ZeroPointB;
+}
+
+template<>
+void
+MlasGemmQuantCopyPackA<MLAS_GEMM_U8X8_KERNEL_RVV>(
+    MLAS_GEMM_U8X8_KERNEL_RVV::PackedAType* D,
+    const uint8_t* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK,
+    int32_t* RowSumBuffer,
+    bool AIsSigned
+    )
+{
+    const size_t AlignedCountK = (CountK + MLAS_GEMM_U8X8_KERNEL_RVV::PackedK - 1) &
+                                 ~(MLAS_GEMM_U8X8_KERNEL_RVV::PackedK - 1);
+
+    const uint8_t BitFlipValue = (AIsSigned ? 0x80 : 0);
+
+    //
+    // Process a single row of matrix A in a loop.
+    //
+
+    while (CountM-- > 0) {
+
+        vuint32m1_t RowSum = __riscv_vmv_v_x_u32m1(0, 1);
+
+        for (size_t k = 0; k < CountK;) {
+
+            const size_t vl = __riscv_vsetvl_e8m2(CountK - k);
+
+            vuint8m2_t a = __riscv_vxor_vx_u8m2(__riscv_vle8_v_u8m2(&A[k], vl), BitFlipValue, vl);
+            __riscv_vse8_v_u8m2(&D[k], a, vl);
+
+            RowSum = __riscv_vwredsumu_vs_u16m4_u32m1(__riscv_vzext_vf2_u16m4(a, vl), RowSum, vl);
+
+            k += vl;
+        }
+
+        for (size_t k = CountK; k < AlignedCountK; k++) {
+            D[k] = 0;
+        }
+
+        *RowSumBuffer++ = int32_t(__riscv_vmv_x_s_u32m1_u32(RowSum));
+
+        A += lda;
+        D += AlignedCountK;
+    }
+}
+
+template<>
+void
+MlasGemmQuantCopyPackB<MLAS_GEMM_U8X8_KERNEL_RVV>(
+    MLAS_GEMM_U8X8_KERNEL_RVV::PackedBType* D,
+    const uint8_t* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    int32_t* ColumnSumBuffer,
+    bool BIsSigned
+    )
+{
+    const size_t AlignedCountK = (CountK + MLAS_GEMM_U8X8_KERNEL_RVV::PackedK - 1) &
+                                 ~(MLAS_GEMM_U8X8_KERNEL_RVV::PackedK - 1);
+
+    const uint8_t BitFlipValue = (BIsSigned ? 0x80 : 0);
+
+    //
+    // Process a single column of matrix B in a loop, transposing the column
+    // to the packed buffer with strided loads.
+    //
+
+    while (CountN-- > 0) {
+
+        vuint32m1_t ColumnSum = __riscv_vmv_v_x_u32m1(0, 1);
+
+        for (size_t k = 0; k < CountK;) {
+
+            const size_t vl = __riscv_vsetvl_e8m2(CountK - k);
+
+            vuint8m2_t b = __riscv_vlse8_v_u8m2(&B[k * ldb], ptrdiff_t(ldb), vl);
+            b = __riscv_vxor_vx_u8m2(b, BitFlipValue, vl);
+            __riscv_vse8_v_u8m2(&D[k], b, vl);
+
+            ColumnSum = __riscv_vwredsumu_vs_u16m4_u32m1(__riscv_vzext_vf2_u16m4(b, vl), ColumnSum, vl);
+
+            k += vl;
+        }
+
+        for (size_t k = CountK; k < AlignedCountK; k++) {
+            D[k] = 0;
+        }
+
+        *ColumnSumBuffer++ = int32_t(__riscv_vmv_x_s_u32m1_u32(ColumnSum));
+
+        B += 1;
+        D += AlignedCountK;
+    }
+}
+
+template<>
+size_t
+MlasGemmQuantKernel<MLAS_GEMM_U8X8_KERNEL_RVV>(
+    const MLAS_GEMM_U8X8_KERNEL_RVV::PackedAType* A,
+    const MLAS_GEMM_U8X8_KERNEL_RVV::PackedBType* B,
+    int32_t* C,
+    size_t PackedCountK,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const int32_t* RowSumBuffer,
+    const int32_t* ColumnSumBuffer,
+    const int32_t* ZeroPointB,
+    bool ZeroMode
+    )
+{
+    MLAS_UNREFERENCED_PARAMETER(CountM);
+    MLAS_UNREFERENCED_PARAMETER(ldc);
+
+    const size_t CountK = PackedCountK * MLAS_GEMM_U8X8_KERNEL_RVV::PackedK;
+
+    //
+    // Process a single column of matrix B in a loop.
+    //
+
+    while (CountN-- > 0) {
+
+        int32_t Accumulator = *RowSumBuffer;
+
+        if (ZeroPointB != nullptr) {
+            Accumulator *= *ZeroPointB++;
+        }
+
+        Accumulator += *ColumnSumBuffer++;
+
+        //
+        // The products of unsigned 8-bit values fit in 16 bits and are summed
+        // with a widening reduction to 32 bits.
+        //
+
+        vuint32m1_t DotProduct = __riscv_vmv_v_x_u32m1(0, 1);
+
+        for (size_t k = 0; k < CountK;) {
+
+            const size_t vl = __riscv_vsetvl_e8m2(CountK - k);
+
+            vuint8m2_t a = __riscv_vle8_v_u8m2(&A[k], vl);
+            vuint8m2_t b = __riscv_vle8_v_u8m2(&B[k], vl);
+
+            DotProduct = __riscv_vwredsumu_vs_u16m4_u32m1(__riscv_vwmulu_vv_u16m4(a, b, vl), DotProduct, vl);
+
+            k += vl;
+        }
+
+        Accumulator += int32_t(__riscv_vmv_x_s_u32m1_u32(DotProduct));
+
+        if (!ZeroMode) {
+            Accumulator += C[0];
+        }
+
+        C[0] = Accumulator;
+        C += 1;
+        B += CountK;
+    }
+
+    return 1;
+}
+
+const MLAS_GEMM_QUANT_DISPATCH MlasGemmU8X8DispatchRvv = {
+    MlasGemmQuantOperation<MLAS_GEMM_U8X8_KERNEL_RVV>,
+    nullptr,
+    nullptr,
+    MLAS_GEMM_U8X8_KERNEL_RVV::PackedK,
+    0,
+    MLAS_GEMM_U8X8_KERNEL_RVV::Strides.M
+};
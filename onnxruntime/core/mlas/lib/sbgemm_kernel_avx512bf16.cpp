@@ -0,0 +1,255 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_avx512bf16.cpp
+
+Abstract:
+
+    This module implements bfloat16 precision GEMM kernel for AVX512_BF16.
+
+    The fp32 matrix B is converted to bf16 and packed into panels of 16
+    columns, in which the elements of two consecutive rows of a column are
+    adjacent, the layout consumed by vdpbf16ps. The rows of matrix A are
+    converted to bf16 by the kernel. The products are accumulated in fp32.
+
+--*/
+
+#include "mlasi.h"
+#include "sbgemm.h"
+
+#if defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
+
+struct MLAS_SBGEMM_KERNEL_AVX512BF16 {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 8;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 2;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+static_assert(MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN == 16, "a panel of B is one vector of fp32 columns");
+
+//
+// Interleaves the bf16 values of two rows converted by vcvtne2ps2bf16:
+// element 2j of the result is element j of the first row and element 2j+1 is
+// element j of the second row.
+//
+MLAS_DECLSPEC_ALIGN(static const uint16_t MlasSBGemmInterleaveRowsAvx512Bf16[32], 64) = {
+    0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23,
+    8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31,
+};
+
+/*
+    This routine converts fp32 to bf16 and copies elements from the source
+    matrix to the destination packed buffer.
+
+    The columns are packed in panels of 16. A panel stores the pairs of rows
+    one after the other, each as 16 pairs of bf16 values. The remaining
+    columns and the odd row are padded with zeros.
+*/
+static void
+MlasSBGemmConvertCopyPackB(bfloat16_t* D, const float* B, size_t ldb, size_t CountN, size_t CountK)
+{
+    const __m512i Interleave = _mm512_load_si512(MlasSBGemmInterleaveRowsAvx512Bf16);
+
+    for (size_t n = 0; n < CountN; n += 16) {
+        const size_t CountColumns = std::min<size_t>(CountN - n, 16);
+        const __mmask16 ColumnMask = static_cast<__mmask16>((1u << CountColumns) - 1);
+        const float* b = B + n;
+
+        for (size_t k = 0; k < CountK; k += 2) {
+            __m512 Row0 = _mm512_maskz_loadu_ps(ColumnMask, b);
+            __m512 Row1 = (k + 1 < CountK) ? _mm512_maskz_loadu_ps(ColumnMask, b + ldb) : _mm512_setzero_ps();
+            __m512i Rows = (__m512i)_mm512_cvtne2ps_pbh(Row1, Row0);
+            _mm512_storeu_si512(D, _mm512_permutexvar_epi16(Interleave, Rows));
+            D += 32;
+            b += 2 * ldb;
+        }
+    }
+}
+
+template <>
+void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX512BF16>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    constexpr size_t PackedN = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN;
+    const size_t AlignedN = (CountN + PackedN - 1) & ~(PackedN - 1);
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+    size_t K_block_size;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides;
+
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+
+        MlasSBGemmConvertCopyPackB(PackedB, B + k * ldb, ldb, CountN, K_block_size);
+        PackedB = PackedB + AlignedN * K_block_size;
+    }
+}
+
+/*
+    This routine computes a block of up to 8 rows and 32 columns of matrix C.
+
+    PackedA holds the rows of A converted to bf16, each as CountK2 pairs of
+    values. B points to the panel of the first 16 columns, the panel of the
+    next 16 columns follows it.
+*/
+template <size_t RowCount, size_t PanelCount>
+MLAS_FORCEINLINE void
+MlasSBGemmComputeBlockAvx512Bf16(
+    const uint32_t* PackedA,
+    size_t CountK2,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    constexpr size_t PackedAStride = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides.K / 2;
+    const size_t PanelStride = CountK2 * 32;
+
+    __m512 Accumulators[RowCount][PanelCount];
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t p = 0; p < PanelCount; p++) {
+            Accumulators[r][p] = _mm512_setzero_ps();
+        }
+    }
+
+    for (size_t k = 0; k < CountK2; k++) {
+        __m512i BElements[PanelCount];
+        for (size_t p = 0; p < PanelCount; p++) {
+            BElements[p] = _mm512_loadu_si512(B + p * PanelStride + k * 32);
+        }
+        for (size_t r = 0; r < RowCount; r++) {
+            __m512i AElements = _mm512_set1_epi32(static_cast<int>(PackedA[r * PackedAStride + k]));
+            for (size_t p = 0; p < PanelCount; p++) {
+                Accumulators[r][p] = _mm512_dpbf16_ps(Accumulators[r][p], (__m512bh)AElements, (__m512bh)BElements[p]);
+            }
+        }
+    }
+
+    for (size_t p = 0; p < PanelCount; p++) {
+        const size_t CountColumns = std::min<size_t>(CountN - p * 16, 16);
+        const __mmask16 ColumnMask = static_cast<__mmask16>((1u << CountColumns) - 1);
+        __m512 BiasElements = (ZeroMode && Bias != nullptr) ? _mm512_maskz_loadu_ps(ColumnMask, Bias + p * 16)
+                                                            : _mm512_setzero_ps();
+        for (size_t r = 0; r < RowCount; r++) {
+            float* c = C + r * ldc + p * 16;
+            __m512 Addend = ZeroMode ? BiasElements : _mm512_maskz_loadu_ps(ColumnMask, c);
+            _mm512_mask_storeu_ps(c, ColumnMask, _mm512_add_ps(Accumulators[r][p], Addend));
+        }
+    }
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE void
+MlasSBGemmComputeRowsAvx512Bf16(
+    const uint32_t* PackedA,
+    size_t CountK2,
+    const bfloat16_t* B,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    const size_t PanelStride = CountK2 * 32;
+
+    size_t n = 0;
+    for (; n + 16 < CountN; n += 32) {
+        MlasSBGemmComputeBlockAvx512Bf16<RowCount, 2>(PackedA, CountK2, B, C + n, ldc, CountN - n,
+                                                      Bias == nullptr ? nullptr : Bias + n, ZeroMode);
+        B += 2 * PanelStride;
+    }
+    if (n < CountN) {
+        MlasSBGemmComputeBlockAvx512Bf16<RowCount, 1>(PackedA, CountK2, B, C + n, ldc, CountN - n,
+                                                      Bias == nullptr ? nullptr : Bias + n, ZeroMode);
+    }
+}
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AVX512BF16>(size_t CountM, size_t CountN, size_t CountK, const float* A, size_t lda, const bfloat16_t* B, float* C, size_t ldc, const float* Bias, const bool ZeroMode)
+{
+    constexpr size_t KernelMaxM = MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM;
+    constexpr size_t MaxCountK = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides.K;
+    assert(CountK <= MaxCountK);
+
+    //
+    // The rows of A converted to bf16, each row as pairs of values that are
+    // broadcast as 32 bit elements.
+    //
+    MLAS_DECLSPEC_ALIGN(uint32_t PackedA[KernelMaxM * MaxCountK / 2], 64);
+
+    const size_t CountK2 = (CountK + 1) / 2;
+
+    while (CountM > 0) {
+        const size_t RowsHandled = std::min(CountM, KernelMaxM);
+
+        for (size_t r = 0; r < RowsHandled; r++) {
+            const float* a = A + r * lda;
+            uint32_t* pa = PackedA + r * (MaxCountK / 2);
+            for (size_t k = 0; k < CountK; k += 32) {
+                const size_t CountLow = std::min<size_t>(CountK - k, 16);
+                const size_t CountHigh = CountK - k > 16 ? std::min<size_t>(CountK - k - 16, 16) : 0;
+                __m512 Low = _mm512_maskz_loadu_ps(static_cast<__mmask16>((1u << CountLow) - 1), a + k);
+                __m512 High = _mm512_maskz_loadu_ps(static_cast<__mmask16>((1u << CountHigh) - 1), a + k + 16);
+                _mm512_store_si512(pa + k / 2, (__m512i)_mm512_cvtne2ps_pbh(High, Low));
+            }
+        }
+
+        switch (RowsHandled) {
+            case 1:
+                MlasSBGemmComputeRowsAvx512Bf16<1>(PackedA, CountK2, B, C, ldc, CountN, Bias, ZeroMode);
+                break;
+            case 2:
+                MlasSBGemmComputeRowsAvx512Bf16<2>(PackedA, CountK2, B, C, ldc, CountN, Bias, ZeroMode);
+                break;
+            case 3:
+                MlasSBGemmComputeRowsAvx512Bf16<3>(PackedA, CountK2, B, C, ldc, CountN, Bias, ZeroMode);
+                break;
+            case 4:
+                MlasSBGemmComputeRowsAvx512Bf16<4>(PackedA, CountK2, B, C, ldc, CountN, Bias, ZeroMode);
+                break;
+            case 5:
+                MlasSBGemmComputeRowsAvx512Bf16<5>(PackedA, CountK2, B, C, ldc, CountN, Bias, ZeroMode);
+                break;
+            case 6:
+                MlasSBGemmComputeRowsAvx512Bf16<6>(PackedA, CountK2, B, C, ldc, CountN, Bias, ZeroMode);
+                break;
+            case 7:
+                MlasSBGemmComputeRowsAvx512Bf16<7>(PackedA, CountK2, B, C, ldc, CountN, Bias, ZeroMode);
+                break;
+            default:
+                MlasSBGemmComputeRowsAvx512Bf16<8>(PackedA, CountK2, B, C, ldc, CountN, Bias, ZeroMode);
+                break;
+        }
+
+        C += ldc * RowsHandled;
+        A += lda * RowsHandled;
+        CountM -= RowsHandled;
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16 = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AVX512BF16>,
+    MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX512BF16>,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM,
+    0  // kernel doesn't read beyond buffer end
+};
+
+#endif  // defined(MLAS_SBGEMM_SUPPORTED) && defined(MLAS_TARGET_AMD64)
@@ -17,6 +17,8 @@ Abstract:
 
 #include "mlasi.h"
 
+#include <vector>
+
 //
 // Define the number of rows from matrix A to transpose to a local buffer.
 //
@@ -1063,6 +1065,12 @@ Return Value:
 
 #if (defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_POWER) || defined(MLAS_TARGET_LARCH64)) && !defined(FORCE_GENERIC_ALGORITHMS)
         RowsHandled = GetMlasPlatform().GemmFloatKernel(A, B, C, CountK, CountM, CountN, lda, ldc, alpha, ZeroMode);
+#elif (defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_RISCV64)) && !defined(FORCE_GENERIC_ALGORITHMS)
+        if (ZeroMode) {
+            RowsHandled = GetMlasPlatform().GemmFloatKernelZero(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+        } else {
+            RowsHandled = GetMlasPlatform().GemmFloatKernelAdd(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+        }
 #else
         if (ZeroMode) {
             RowsHandled = MlasSgemmKernelZero(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
@@ -1641,6 +1649,150 @@ MlasGemmBatch(
 #pragma warning(pop)
 #endif
 
+void
+MLASCALL
+MlasGemmGrouped(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    const MLAS_SGEMM_GROUP_SHAPE* Shapes,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t GroupCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a group of single precision matrix/matrix
+    multiply operations with independent shapes.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    Shapes - Supplies the shape of each multiplication.
+
+    Data - Supplies the data position and layout of each multiplication.
+
+    GroupCount - Supplies the number of multiplications.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (GroupCount == 0) {
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the total complexity of the
+    // group, as MlasGemmBatch does for a single shape.
+    //
+
+    double TotalComplexity = 0.0;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+        TotalComplexity += double(Shapes[g].M) * double(Shapes[g].N) * double(Shapes[g].K);
+    }
+
+    ptrdiff_t TargetThreadCount;
+
+    if (TotalComplexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(TotalComplexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Split each problem into tiles of roughly the same cost. The tiles are
+    // sized to give each thread several tiles so that the thread pool can
+    // balance problems of very different sizes, but no smaller than the
+    // complexity that justifies a thread on its own. A single thread runs
+    // each problem as one tile.
+    //
+    // N.B. Each problem is segmented as a 1D partition like MlasGemmBatch.
+    //
+
+    const double TileComplexity = (TargetThreadCount == 1)
+        ? TotalComplexity + 1.0
+        : std::max(double(MLAS_SGEMM_THREAD_COMPLEXITY), TotalComplexity / double(TargetThreadCount * 4));
+
+    struct MLAS_SGEMM_GROUP_PARTITION {
+        size_t TileStart;
+        ptrdiff_t ThreadCountM;
+        ptrdiff_t ThreadCountN;
+    };
+
+    std::vector<MLAS_SGEMM_GROUP_PARTITION> Partitions(GroupCount);
+
+    size_t TileCount = 0;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+
+        const size_t M = Shapes[g].M;
+        const size_t N = Shapes[g].N;
+
+        Partitions[g].TileStart = TileCount;
+        Partitions[g].ThreadCountM = 1;
+        Partitions[g].ThreadCountN = 1;
+
+        if (M == 0 || N == 0) {
+            Partitions[g].ThreadCountN = 0;
+            continue;
+        }
+
+        const double Complexity = double(M) * double(N) * double(Shapes[g].K);
+
+        size_t Tiles = size_t(Complexity / TileComplexity) + 1;
+
+        if (N > M) {
+
+            const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+                MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+            Partitions[g].ThreadCountN = ptrdiff_t(std::min(Tiles, BlockedN));
+
+        } else {
+
+            Partitions[g].ThreadCountM = ptrdiff_t(std::min(Tiles, M));
+        }
+
+        TileCount += size_t(Partitions[g].ThreadCountM * Partitions[g].ThreadCountN);
+    }
+
+    if (TileCount == 0) {
+        return;
+    }
+
+    MlasTrySimpleParallel(ThreadPool, ptrdiff_t(TileCount), [&](ptrdiff_t tid)
+    {
+        //
+        // Locate the problem that owns this tile.
+        //
+
+        const auto it = std::upper_bound(Partitions.begin(), Partitions.end(), size_t(tid),
+            [](size_t Tile, const MLAS_SGEMM_GROUP_PARTITION& Partition) { return Tile < Partition.TileStart; });
+        const size_t g = size_t(std::distance(Partitions.begin(), it)) - 1;
+        const MLAS_SGEMM_GROUP_PARTITION& Partition = Partitions[g];
+
+        MlasSgemmThreaded(Partition.ThreadCountM, Partition.ThreadCountN, TransA, TransB,
+            Shapes[g].M, Shapes[g].N, Shapes[g].K, &Data[g], ptrdiff_t(tid - Partition.TileStart));
+    });
+}
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -1741,3 +1893,432 @@ Return Value:
         PackedB = (float*)PackedB + AlignedN * CountK;
     }
 }
+
+//
+// Define the header of a block sparse packed matrix B. It is followed by the
+// PanelCount + 1 indices of the first block of each panel of
+// MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N columns, the index along K of each block and,
+// aligned to MLAS_BLOCK_SPARSE_SGEMM_ALIGNMENT, the values of each block stored
+// row by row. Elements past N and K are zero.
+//
+
+struct MLAS_BLOCK_SPARSE_PACKED_B {
+    size_t N;
+    size_t K;
+    size_t PanelCount;
+    size_t BlockCount;
+};
+
+#define MLAS_BLOCK_SPARSE_SGEMM_ALIGNMENT 64
+
+//
+// Define the number of rows of matrix A computed by a thread at a time.
+//
+
+#define MLAS_BLOCK_SPARSE_SGEMM_TILE_M 16
+
+constexpr size_t MlasBlockSparseGemmBlockSize = MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N;
+
+static_assert(MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N == 16, "the kernel computes a block row as four vectors");
+
+MLAS_FORCEINLINE
+size_t
+MlasBlockSparseGemmValuesOffset(
+    size_t PanelCount,
+    size_t BlockCount
+    )
+{
+    const size_t Offset = sizeof(MLAS_BLOCK_SPARSE_PACKED_B) + (PanelCount + 1 + BlockCount) * sizeof(uint32_t);
+
+    return (Offset + MLAS_BLOCK_SPARSE_SGEMM_ALIGNMENT - 1) & ~size_t(MLAS_BLOCK_SPARSE_SGEMM_ALIGNMENT - 1);
+}
+
+static
+bool
+MlasBlockSparseGemmIsZeroBlock(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    size_t Panel,
+    size_t BlockK
+    )
+{
+    const size_t KEnd = std::min(K, (BlockK + 1) * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K);
+    const size_t NEnd = std::min(N, (Panel + 1) * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N);
+
+    for (size_t k = BlockK * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K; k < KEnd; k++) {
+        for (size_t n = Panel * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N; n < NEnd; n++) {
+            const float Value = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+            // N.B. a NaN is not zero, so it propagates to the output.
+            if (!(Value == 0.0f)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static
+size_t
+MlasBlockSparseGemmCountBlocks(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+{
+    const size_t PanelCount = (N + MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N - 1) / MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N;
+    const size_t BlockCountK = (K + MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K - 1) / MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K;
+
+    size_t BlockCount = 0;
+
+    for (size_t Panel = 0; Panel < PanelCount; Panel++) {
+        for (size_t BlockK = 0; BlockK < BlockCountK; BlockK++) {
+            if (!MlasBlockSparseGemmIsZeroBlock(TransB, N, K, B, ldb, Panel, BlockK)) {
+                BlockCount++;
+            }
+        }
+    }
+
+    return BlockCount;
+}
+
+size_t
+MLASCALL
+MlasBlockSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    float MinimumSparsity
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes of the block sparse packing
+    buffer of matrix B.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    MinimumSparsity - Supplies the minimum fraction of the blocks of matrix B
+        that are zero.
+
+Return Value:
+
+    Returns the size in bytes of the packing buffer, else 0 if matrix B is
+    empty or less sparse than MinimumSparsity.
+
+--*/
+{
+    const size_t PanelCount = (N + MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N - 1) / MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N;
+    const size_t BlockCountK = (K + MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K - 1) / MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K;
+    const size_t TotalBlockCount = PanelCount * BlockCountK;
+
+    if (TotalBlockCount == 0 || TotalBlockCount >= size_t(std::numeric_limits<uint32_t>::max())) {
+        return 0;
+    }
+
+    const size_t BlockCount = MlasBlockSparseGemmCountBlocks(TransB, N, K, B, ldb);
+
+    if (double(TotalBlockCount - BlockCount) < double(MinimumSparsity) * double(TotalBlockCount)) {
+        return 0;
+    }
+
+    return MlasBlockSparseGemmValuesOffset(PanelCount, BlockCount) +
+        BlockCount * MlasBlockSparseGemmBlockSize * sizeof(float);
+}
+
+void
+MLASCALL
+MlasBlockSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the non-zero blocks of matrix B to the destination
+    buffer. The destination buffer should be sized based on
+    MlasBlockSparseGemmPackBSize().
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t PanelCount = (N + MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N - 1) / MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N;
+    const size_t BlockCountK = (K + MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K - 1) / MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K;
+    const size_t BlockCount = MlasBlockSparseGemmCountBlocks(TransB, N, K, B, ldb);
+
+    auto* Header = reinterpret_cast<MLAS_BLOCK_SPARSE_PACKED_B*>(PackedB);
+    Header->N = N;
+    Header->K = K;
+    Header->PanelCount = PanelCount;
+    Header->BlockCount = BlockCount;
+
+    uint32_t* PanelStart = reinterpret_cast<uint32_t*>(Header + 1);
+    uint32_t* BlockIndexK = PanelStart + PanelCount + 1;
+    float* Values = reinterpret_cast<float*>(
+        reinterpret_cast<uint8_t*>(PackedB) + MlasBlockSparseGemmValuesOffset(PanelCount, BlockCount));
+
+    size_t Block = 0;
+
+    for (size_t Panel = 0; Panel < PanelCount; Panel++) {
+
+        PanelStart[Panel] = uint32_t(Block);
+
+        for (size_t BlockK = 0; BlockK < BlockCountK; BlockK++) {
+
+            if (MlasBlockSparseGemmIsZeroBlock(TransB, N, K, B, ldb, Panel, BlockK)) {
+                continue;
+            }
+
+            BlockIndexK[Block] = uint32_t(BlockK);
+            float* BlockValues = Values + Block * MlasBlockSparseGemmBlockSize;
+
+            for (size_t kk = 0; kk < MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K; kk++) {
+                for (size_t nn = 0; nn < MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N; nn++) {
+                    const size_t k = BlockK * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K + kk;
+                    const size_t n = Panel * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N + nn;
+                    float Value = 0.0f;
+                    if (k < K && n < N) {
+                        Value = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+                    }
+                    BlockValues[kk * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N + nn] = Value;
+                }
+            }
+
+            Block++;
+        }
+    }
+
+    PanelStart[PanelCount] = uint32_t(Block);
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasBlockSparseGemmKernel(
+    const float* A,
+    size_t lda,
+    size_t K,
+    const uint32_t* BlockIndexK,
+    const float* Values,
+    size_t BlockCount,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of one panel of matrix C from the
+    non-zero blocks of the panel.
+
+--*/
+{
+    MLAS_FLOAT32X4 Accumulators[RowCount][4];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t i = 0; i < 4; i++) {
+            Accumulators[r][i] = MlasZeroFloat32x4();
+        }
+    }
+
+    for (size_t Block = 0; Block < BlockCount; Block++) {
+
+        const size_t k = size_t(BlockIndexK[Block]) * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K;
+        const size_t CountK = std::min(K - k, size_t(MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K));
+        const float* BlockValues = Values + Block * MlasBlockSparseGemmBlockSize;
+
+        for (size_t kk = 0; kk < CountK; kk++) {
+
+            const float* b = BlockValues + kk * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N;
+            const MLAS_FLOAT32X4 B0 = MlasLoadFloat32x4(b);
+            const MLAS_FLOAT32X4 B1 = MlasLoadFloat32x4(b + 4);
+            const MLAS_FLOAT32X4 B2 = MlasLoadFloat32x4(b + 8);
+            const MLAS_FLOAT32X4 B3 = MlasLoadFloat32x4(b + 12);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const MLAS_FLOAT32X4 a = MlasBroadcastFloat32x4(A[r * lda + k + kk]);
+                Accumulators[r][0] = MlasMultiplyAddFloat32x4(a, B0, Accumulators[r][0]);
+                Accumulators[r][1] = MlasMultiplyAddFloat32x4(a, B1, Accumulators[r][1]);
+                Accumulators[r][2] = MlasMultiplyAddFloat32x4(a, B2, Accumulators[r][2]);
+                Accumulators[r][3] = MlasMultiplyAddFloat32x4(a, B3, Accumulators[r][3]);
+            }
+        }
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+
+        MLAS_DECLSPEC_ALIGN(float Row[MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N], 16);
+
+        for (size_t i = 0; i < 4; i++) {
+            MlasStoreFloat32x4(Row + i * 4, Accumulators[r][i]);
+        }
+
+        float* c = C + r * ldc;
+
+        // N.B. matrix C is not read when beta is zero, it may be uninitialized.
+        if (beta == 0.0f) {
+            for (size_t n = 0; n < CountN; n++) {
+                c[n] = alpha * Row[n];
+            }
+        } else {
+            for (size_t n = 0; n < CountN; n++) {
+                c[n] = alpha * Row[n] + beta * c[n];
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasBlockSparseGemm(
+    size_t M,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc,
+    float alpha,
+    float beta,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation C = alpha * A * B + beta * C with a block sparse packed matrix B.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the block sparse packed matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* Header = reinterpret_cast<const MLAS_BLOCK_SPARSE_PACKED_B*>(PackedB);
+    const size_t N = Header->N;
+    const size_t K = Header->K;
+    const size_t PanelCount = Header->PanelCount;
+
+    if (M == 0 || N == 0) {
+        return;
+    }
+
+    const uint32_t* PanelStart = reinterpret_cast<const uint32_t*>(Header + 1);
+    const uint32_t* BlockIndexK = PanelStart + PanelCount + 1;
+    const float* Values = reinterpret_cast<const float*>(
+        reinterpret_cast<const uint8_t*>(PackedB) + MlasBlockSparseGemmValuesOffset(PanelCount, Header->BlockCount));
+
+    //
+    // Split matrix C into tiles of rows by panels, ordered by panel so that
+    // the consecutive tiles of a thread reuse the blocks of a panel. The
+    // number of threads is computed from the work done on the non-zero
+    // blocks only.
+    //
+
+    const size_t TileCountM = (M + MLAS_BLOCK_SPARSE_SGEMM_TILE_M - 1) / MLAS_BLOCK_SPARSE_SGEMM_TILE_M;
+    const size_t TileCount = TileCountM * PanelCount;
+
+    const double Complexity = double(M) * double(Header->BlockCount) * double(MlasBlockSparseGemmBlockSize);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    TargetThreadCount = std::min(TargetThreadCount, MlasGetMaximumThreadCount(ThreadPool));
+    TargetThreadCount = std::min(TargetThreadCount, ptrdiff_t(TileCount));
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid)
+    {
+        size_t TileIndex;
+        size_t TileRemaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, TileCount, &TileIndex, &TileRemaining);
+
+        for (; TileRemaining > 0; TileIndex++, TileRemaining--) {
+
+            const size_t Panel = TileIndex / TileCountM;
+            const size_t StartM = (TileIndex % TileCountM) * MLAS_BLOCK_SPARSE_SGEMM_TILE_M;
+            const size_t EndM = std::min(M, StartM + MLAS_BLOCK_SPARSE_SGEMM_TILE_M);
+
+            const size_t BlockStart = PanelStart[Panel];
+            const size_t BlockCount = PanelStart[Panel + 1] - BlockStart;
+            const float* PanelValues = Values + BlockStart * MlasBlockSparseGemmBlockSize;
+
+            const size_t n = Panel * MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N;
+            const size_t CountN = std::min(N - n, size_t(MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N));
+
+            size_t m = StartM;
+
+            for (; m + 2 <= EndM; m += 2) {
+                MlasBlockSparseGemmKernel<2>(A + m * lda, lda, K, BlockIndexK + BlockStart, PanelValues, BlockCount,
+                    C + m * ldc + n, ldc, CountN, alpha, beta);
+            }
+
+            if (m < EndM) {
+                MlasBlockSparseGemmKernel<1>(A + m * lda, lda, K, BlockIndexK + BlockStart, PanelValues, BlockCount,
+                    C + m * ldc + n, ldc, CountN, alpha, beta);
+            }
+        }
+    });
+}
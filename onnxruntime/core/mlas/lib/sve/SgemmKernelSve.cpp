@@ -0,0 +1,264 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    SgemmKernelSve.cpp
+
+Abstract:
+
+    This module implements the kernels for the single precision matrix/matrix
+    multiply operation (SGEMM) using the ARM Scalable Vector Extension.
+
+    The kernels are vector length agnostic: the 16 columns of a panel of the
+    packed matrix B are processed in as many vectors as the hardware vector
+    length requires.
+
+--*/
+
+#include "mlasi.h"
+
+#if defined(MLAS_USE_SVE)
+
+#include <arm_sve.h>
+
+template<bool ZeroMode>
+MLAS_FORCEINLINE
+void
+MlasSgemmStoreRowSve(
+    svbool_t pg,
+    float* C,
+    svfloat32_t Accumulator,
+    float alpha
+    )
+{
+    if constexpr (ZeroMode) {
+        Accumulator = svmul_n_f32_x(pg, Accumulator, alpha);
+    } else {
+        Accumulator = svmla_n_f32_x(pg, svld1_f32(pg, C), Accumulator, alpha);
+    }
+
+    svst1_f32(pg, C, Accumulator);
+}
+
+template<size_t RowCount, bool ZeroMode>
+MLAS_FORCEINLINE
+void
+MlasSgemmComputeBlockSve(
+    svbool_t pg,
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine computes up to RowCount rows of matrix C for the columns of
+    a single vector within a panel of the packed matrix B.
+
+Arguments:
+
+    pg - Supplies the predicate of the columns to process.
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of the first column to process within a panel of
+        the packed matrix B.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scaler multiplier (see SGEMM definition).
+
+Return Value:
+
+    None.
+
+--*/
+{
+    svfloat32_t Accumulator0 = svdup_n_f32(0.0f);
+    svfloat32_t Accumulator1 = Accumulator0;
+    svfloat32_t Accumulator2 = Accumulator0;
+    svfloat32_t Accumulator3 = Accumulator0;
+
+    for (size_t k = 0; k < CountK; k++) {
+
+        svfloat32_t BElements = svld1_f32(pg, B);
+
+        Accumulator0 = svmla_n_f32_x(pg, Accumulator0, BElements, A[k]);
+        if constexpr (RowCount > 1) {
+            Accumulator1 = svmla_n_f32_x(pg, Accumulator1, BElements, A[lda + k]);
+        }
+        if constexpr (RowCount > 2) {
+            Accumulator2 = svmla_n_f32_x(pg, Accumulator2, BElements, A[2 * lda + k]);
+        }
+        if constexpr (RowCount > 3) {
+            Accumulator3 = svmla_n_f32_x(pg, Accumulator3, BElements, A[3 * lda + k]);
+        }
+
+        B += 16;
+    }
+
+    MlasSgemmStoreRowSve<ZeroMode>(pg, C, Accumulator0, alpha);
+    if constexpr (RowCount > 1) {
+        MlasSgemmStoreRowSve<ZeroMode>(pg, C + ldc, Accumulator1, alpha);
+    }
+    if constexpr (RowCount > 2) {
+        MlasSgemmStoreRowSve<ZeroMode>(pg, C + 2 * ldc, Accumulator2, alpha);
+    }
+    if constexpr (RowCount > 3) {
+        MlasSgemmStoreRowSve<ZeroMode>(pg, C + 3 * ldc, Accumulator3, alpha);
+    }
+}
+
+template<size_t RowCount, bool ZeroMode>
+void
+MlasSgemmComputeRowsSve(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+{
+    const size_t VectorLength = svcntw();
+
+    //
+    // Process the packed matrix B one panel of 16 columns at a time. The
+    // last panel is zero padded, but only the valid columns are stored.
+    //
+
+    while (CountN > 0) {
+
+        const size_t CountPanelN = std::min<size_t>(CountN, 16);
+
+        for (size_t n = 0; n < CountPanelN; n += VectorLength) {
+
+            const svbool_t pg = svwhilelt_b32(uint64_t(n), uint64_t(CountPanelN));
+
+            MlasSgemmComputeBlockSve<RowCount, ZeroMode>(pg, A, B + n, C + n, CountK, lda, ldc, alpha);
+        }
+
+        B += CountK * 16;
+        C += CountPanelN;
+        CountN -= CountPanelN;
+    }
+}
+
+template<bool ZeroMode>
+size_t
+MlasSgemmKernelSve(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. The matrix data has been packed using
+        MlasSgemmCopyPackB or MlasSgemmTransposePackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scaler multiplier (see SGEMM definition).
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    if (CountM >= 4) {
+        MlasSgemmComputeRowsSve<4, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+        return 4;
+    }
+
+    if (CountM >= 2) {
+        MlasSgemmComputeRowsSve<2, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+        return 2;
+    }
+
+    MlasSgemmComputeRowsSve<1, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+    return 1;
+}
+
+size_t
+MLASCALL
+MlasSgemmKernelZeroSve(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+{
+    return MlasSgemmKernelSve<true>(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+}
+
+size_t
+MLASCALL
+MlasSgemmKernelAddSve(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+{
+    return MlasSgemmKernelSve<false>(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+}
+
+#endif  // defined(MLAS_USE_SVE)
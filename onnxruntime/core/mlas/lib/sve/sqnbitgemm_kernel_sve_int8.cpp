@@ -0,0 +1,177 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_sve_int8.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernel for ARM SVE specific to
+    MLAS_QNBIT_GEMM_COMPUTE_TYPE SQNBIT_CompInt8.
+
+    The kernel is vector length agnostic. Matrix B is packed by
+    SQ4BitGemmPackQuantBData_Sve: byte i of a block holds values i and
+    i + BlkLen / 2, so that a vector of bytes unpacks into two vectors of
+    values matching two contiguous ranges of the quantized A block.
+
+--*/
+
+#include "qnbitgemm.h"
+#include "qnbitgemm_kernel_neon.h"
+#include "sqnbitgemm_q8_block.h"
+
+#if defined(MLAS_USE_SVE)
+
+#include <arm_sve.h>
+
+namespace sqnbitgemm_neon
+{
+
+namespace
+{
+
+template <bool HasZeroPoint>
+MLAS_FORCEINLINE float
+SQ4BitGemmDotProduct_CompInt8_Sve(
+    size_t BlkLen,
+    const std::byte* QuantARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    size_t BlockCountK
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t HalfBlkLen = BlkLen / 2;
+    const size_t VectorLength = svcntb();
+
+    const svbool_t pg32 = svptrue_b32();
+
+    svfloat32_t acc = svdup_n_f32(0.0f);
+
+    for (size_t k_blk_idx = 0; k_blk_idx < BlockCountK; ++k_blk_idx) {
+        const float scale = Q8BlkScale(QuantARowPtr) * QuantBScaleColPtr[k_blk_idx];
+        const int8_t* QuantAData = Q8BlkData(QuantARowPtr);
+
+        int8_t bzp = 8;
+        if constexpr (HasZeroPoint) {
+            const std::byte zp_packed = QuantBZeroPointColPtr[k_blk_idx / 2];
+            bzp = std::to_integer<int8_t>((k_blk_idx & 1) ? (zp_packed >> 4) : (zp_packed & std::byte{0x0F}));
+        }
+
+        svint32_t dot = svdup_n_s32(0);
+
+        for (size_t kk = 0; kk < HalfBlkLen; kk += VectorLength) {
+            const svbool_t pg = svwhilelt_b8(uint64_t(kk), uint64_t(HalfBlkLen));
+
+            const svuint8_t bv_packed = svld1_u8(pg, reinterpret_cast<const uint8_t*>(QuantBDataColPtr) + kk);
+
+            // The inactive elements of the A vectors are zero, so those of the B vectors don't contribute.
+            const svint8_t av_lo = svld1_s8(pg, QuantAData + kk);
+            const svint8_t av_hi = svld1_s8(pg, QuantAData + HalfBlkLen + kk);
+
+            svint8_t bv_lo = svreinterpret_s8_u8(svand_n_u8_x(pg, bv_packed, 0x0F));
+            svint8_t bv_hi = svreinterpret_s8_u8(svlsr_n_u8_x(pg, bv_packed, 4));
+            bv_lo = svsub_n_s8_x(pg, bv_lo, bzp);
+            bv_hi = svsub_n_s8_x(pg, bv_hi, bzp);
+
+            dot = svdot_s32(dot, av_lo, bv_lo);
+            dot = svdot_s32(dot, av_hi, bv_hi);
+        }
+
+        acc = svmla_n_f32_x(pg32, acc, svcvt_f32_s32_x(pg32, dot), scale);
+
+        QuantARowPtr += Q8BlkSize(BlkLen);
+        QuantBDataColPtr += BlkDataSize;
+    }
+
+    return svaddv_f32(pg32, acc);
+}
+
+template <bool HasZeroPoint>
+void
+SQ4BitGemmKernel_CompInt8_Sve_Impl(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    const size_t StrideQuantA = BlockCountK * Q8BlkSize(BlkLen);
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockCountK;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    for (size_t m = 0; m < CountM; ++m) {
+        const std::byte* QuantARowPtr = QuantA + m * StrideQuantA;
+        float* SumPtr = C + m * ldc;
+
+        for (size_t n = 0; n < CountN; ++n) {
+            float sum = SQ4BitGemmDotProduct_CompInt8_Sve<HasZeroPoint>(
+                BlkLen,
+                QuantARowPtr,
+                QuantBData + n * StrideQuantBData,
+                QuantBScale + n * StrideQuantBScale,
+                HasZeroPoint ? QuantBZeroPoint + n * StrideQuantBZeroPoint : nullptr,
+                BlockCountK
+            );
+
+            if (Bias != nullptr) {
+                sum += Bias[n];
+            }
+
+            SumPtr[n] = sum;
+        }
+    }
+}
+
+}  // namespace
+
+size_t
+SQ4BitGemmKernel_CompInt8_Sve(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t /*CountK*/,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+)
+{
+    if (QuantBZeroPoint != nullptr) {
+        SQ4BitGemmKernel_CompInt8_Sve_Impl<true>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountM, CountN, BlockCountK, ldc, Bias
+        );
+    } else {
+        SQ4BitGemmKernel_CompInt8_Sve_Impl<false>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountM, CountN, BlockCountK, ldc, Bias
+        );
+    }
+
+    return CountM;
+}
+
+}  // namespace sqnbitgemm_neon
+
+#endif  // defined(MLAS_USE_SVE)
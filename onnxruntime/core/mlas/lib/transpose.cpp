@@ -545,7 +545,9 @@ void
 MLASCALL
 MlasTranspose(
     const uint32_t* Input,
+    size_t ldInput,
     uint32_t* Output,
+    size_t ldOutput,
     size_t M,
     size_t N
     )
@@ -560,8 +562,14 @@ Arguments:
 
     Input - Supplies the input buffer.
 
+    ldInput - Supplies the number of elements between rows of the input
+        matrix.
+
     Output - Supplies the output buffer.
 
+    ldOutput - Supplies the number of elements between rows of the output
+        matrix.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -592,9 +600,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4x4Block(s, N, d, M);
+            MlasTranspose4x4Block(s, ldInput, d, ldOutput);
 
-            s += N * 4;
+            s += ldInput * 4;
             d += 4;
             m -= 4;
         }
@@ -603,15 +611,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose4xNVector(s, 1, d, M);
+            MlasTranspose4xNVector(s, 1, d, ldOutput);
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 4;
-        Output += M * 4;
+        Output += ldOutput * 4;
         n -= 4;
     }
 
@@ -628,9 +636,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4xNVector(s, N, d, 1);
+            MlasTranspose4xNVector(s, ldInput, d, 1);
 
-            s += N * 4;
+            s += ldInput * 4;
             d += 4;
             m -= 4;
         }
@@ -639,17 +647,29 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += ldOutput;
         n -= 1;
     }
 }
 
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, N, Output, M, M, N);
+}
+
 void
 MLASCALL
 MlasTranspose(
@@ -671,7 +691,9 @@ void
 MLASCALL
 MlasTranspose(
     const uint16_t* Input,
+    size_t ldInput,
     uint16_t* Output,
+    size_t ldOutput,
     size_t M,
     size_t N
     )
@@ -686,8 +708,14 @@ Arguments:
 
     Input - Supplies the input buffer.
 
+    ldInput - Supplies the number of elements between rows of the input
+        matrix.
+
     Output - Supplies the output buffer.
 
+    ldOutput - Supplies the number of elements between rows of the output
+        matrix.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -717,9 +745,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4x4Block(s, N, d, M);
+            MlasTranspose4x4Block(s, ldInput, d, ldOutput);
 
-            s += N * 4;
+            s += ldInput * 4;
             d += 4;
             m -= 4;
         }
@@ -728,15 +756,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose4xNVector(s, 1, d, M);
+            MlasTranspose4xNVector(s, 1, d, ldOutput);
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 4;
-        Output += M * 4;
+        Output += ldOutput * 4;
         n -= 4;
     }
 
@@ -753,9 +781,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4xNVector(s, N, d, 1);
+            MlasTranspose4xNVector(s, ldInput, d, 1);
 
-            s += N * 4;
+            s += ldInput * 4;
             d += 4;
             m -= 4;
         }
@@ -764,23 +792,37 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += ldOutput;
         n -= 1;
     }
 }
 
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, N, Output, M, M, N);
+}
+
 
 void
 MLASCALL
 MlasTranspose(
     const uint8_t* Input,
+    size_t ldInput,
     uint8_t* Output,
+    size_t ldOutput,
     size_t M,
     size_t N
     )
@@ -795,8 +837,14 @@ Arguments:
 
     Input - Supplies the input buffer.
 
+    ldInput - Supplies the number of elements between rows of the input
+        matrix.
+
     Output - Supplies the output buffer.
 
+    ldOutput - Supplies the number of elements between rows of the output
+        matrix.
+
     M - Supplies the number of rows for the input matrix and the number of
         columns for the output matrix.
 
@@ -823,24 +871,24 @@ Return Value:
         size_t m = M;
         while (m >= 16) {
 
-            MlasTranspose16x16Block(s, N, d, M);
+            MlasTranspose16x16Block(s, ldInput, d, ldOutput);
 
-            s += N * 16;
+            s += ldInput * 16;
             d += 16;
             m -= 16;
         }
 
         while (m > 0) {
 
-            MlasTranspose16xNVector(s, 1, d, M);
+            MlasTranspose16xNVector(s, 1, d, ldOutput);
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 16;
-        Output += M * 16;
+        Output += ldOutput * 16;
         n -= 16;
     }
 #endif
@@ -854,9 +902,9 @@ Return Value:
 
         while (m >= 8) {
 
-            MlasTranspose8x8Block(s, N, d, M);
+            MlasTranspose8x8Block(s, ldInput, d, ldOutput);
 
-            s += N * 8;
+            s += ldInput * 8;
             d += 8;
             m -= 8;
         }
@@ -865,15 +913,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose8xNVector(s, 1, d, M);
+            MlasTranspose8xNVector(s, 1, d, ldOutput);
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 8;
-        Output += M * 8;
+        Output += ldOutput * 8;
         n -= 8;
     }
 
@@ -890,9 +938,9 @@ Return Value:
 
         while (m >= 8) {
 
-            MlasTranspose8xNVector(s, N, d, 1);
+            MlasTranspose8xNVector(s, ldInput, d, 1);
 
-            s += N * 8;
+            s += ldInput * 8;
             d += 8;
             m -= 8;
         }
@@ -901,17 +949,29 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += ldInput;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += ldOutput;
         n -= 1;
     }
 }
 
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    uint8_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, N, Output, M, M, N);
+}
+
 void
 MLASCALL
 MlasTranspose(
@@ -0,0 +1,314 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    SQNBitGemmKernelWasmSimd.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernels for WebAssembly SIMD128.
+
+    Only the 4-bit float compute type (SQNBIT_CompFp32) is implemented. The
+    quantized B data is used in the layout of the MatMulNBits operator: each
+    byte holds two consecutive values of a column of B, the first one in the
+    low nibble.
+
+--*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "qnbitgemm.h"
+
+namespace sqnbitgemm_wasmsimd
+{
+
+namespace
+{
+
+constexpr size_t BlkBitWidth = 4;
+
+//
+// Number of values of B unpacked at a time.
+//
+constexpr size_t SubBlkLen = 16;
+
+MLAS_FORCEINLINE
+void
+UnpackQ4x16(
+    const std::byte* QuantBData,
+    float* Values
+    )
+{
+    for (size_t i = 0; i < SubBlkLen / 2; ++i) {
+        const uint8_t b = std::to_integer<uint8_t>(QuantBData[i]);
+        Values[2 * i] = static_cast<float>(b & 0x0F);
+        Values[2 * i + 1] = static_cast<float>(b >> 4);
+    }
+}
+
+MLAS_FORCEINLINE
+float
+GetZeroPoint(
+    const std::byte* QuantBZeroPointCol,
+    size_t BlkIdx
+    )
+{
+    if (QuantBZeroPointCol == nullptr) {
+        return 8.0f;
+    }
+
+    const uint8_t zp_packed = std::to_integer<uint8_t>(QuantBZeroPointCol[BlkIdx / 2]);
+    return static_cast<float>(((BlkIdx & 1) == 1) ? (zp_packed >> 4) : (zp_packed & 0x0F));
+}
+
+//
+// Quantized B data packing. The data is kept in the layout used by MatMulNBits.
+//
+
+size_t
+Q4BitGemmPackQuantBDataSize(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_QNBIT_GEMM_COMPUTE_TYPE ComputeType
+    )
+{
+    MLAS_UNREFERENCED_PARAMETER(ComputeType);
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    return N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+}
+
+void
+SQ4BitGemmPackQuantBData(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_QNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+
+    std::memcpy(PackedQuantBDataBegin, QuantBDataBegin, Q4BitGemmPackQuantBDataSize(N, K, BlkLen, ComputeType));
+}
+
+//
+// Computes the dot products of a row of A with NCols adjacent columns of B.
+//
+// Within a block the dot product with the unshifted values of B is scaled
+// once: sum(a * (b - zp) * scale) = scale * (sum(a * b) - zp * sum(a)).
+//
+
+template <size_t NCols>
+MLAS_FORCEINLINE
+void
+ComputeDotProducts(
+    size_t BlkLen,
+    const float* ARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    float* SumPtr,
+    size_t CountK,
+    size_t StrideQuantBData,
+    size_t StrideQuantBScale,
+    size_t StrideQuantBZeroPoint,
+    const float* BiasPtr
+    )
+{
+    MLAS_DECLSPEC_ALIGN(float a[SubBlkLen], 16);
+    MLAS_DECLSPEC_ALIGN(float b[SubBlkLen], 16);
+
+    float Sum[NCols];
+    for (size_t i = 0; i < NCols; ++i) {
+        Sum[i] = (BiasPtr != nullptr) ? BiasPtr[i] : 0.0f;
+    }
+
+    for (size_t k = 0, k_blk_idx = 0; k < CountK; k += BlkLen, ++k_blk_idx) {
+        const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+        MLAS_FLOAT32X4 ASum = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Dot[NCols];
+        for (size_t i = 0; i < NCols; ++i) {
+            Dot[i] = MlasZeroFloat32x4();
+        }
+
+        for (size_t kk = 0; kk < k_blk_len; kk += SubBlkLen) {
+            const size_t kklen = std::min(k_blk_len - kk, SubBlkLen);
+
+            // The values of A past the end of the row are zero so the padding of the last block of B is ignored.
+            const float* APtr = ARowPtr + k + kk;
+            if (kklen < SubBlkLen) {
+                std::fill_n(std::copy_n(APtr, kklen, a), SubBlkLen - kklen, 0.0f);
+                APtr = a;
+            }
+
+            MLAS_FLOAT32X4 AVec[4];
+            for (size_t j = 0; j < 4; ++j) {
+                AVec[j] = MlasLoadFloat32x4(APtr + 4 * j);
+                ASum = MlasAddFloat32x4(ASum, AVec[j]);
+            }
+
+            for (size_t i = 0; i < NCols; ++i) {
+                UnpackQ4x16(QuantBDataColPtr + i * StrideQuantBData + (k + kk) * BlkBitWidth / 8, b);
+                for (size_t j = 0; j < 4; ++j) {
+                    Dot[i] = MlasMultiplyAddFloat32x4(AVec[j], MlasLoadFloat32x4(b + 4 * j), Dot[i]);
+                }
+            }
+        }
+
+        const float ASumValue = MlasReduceAddFloat32x4(ASum);
+        for (size_t i = 0; i < NCols; ++i) {
+            const float Scale = QuantBScaleColPtr[i * StrideQuantBScale + k_blk_idx];
+            const std::byte* ZeroPointPtr =
+                (QuantBZeroPointColPtr == nullptr) ? nullptr : QuantBZeroPointColPtr + i * StrideQuantBZeroPoint;
+            Sum[i] += Scale * (MlasReduceAddFloat32x4(Dot[i]) - GetZeroPoint(ZeroPointPtr, k_blk_idx) * ASumValue);
+        }
+    }
+
+    for (size_t i = 0; i < NCols; ++i) {
+        SumPtr[i] = Sum[i];
+    }
+}
+
+void
+SQ4BitGemmM1Kernel_CompFp32(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    constexpr size_t NCols = 4;
+
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockCountK;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    size_t n = 0;
+
+    for (; n + NCols <= CountN; n += NCols) {
+        ComputeDotProducts<NCols>(
+            BlkLen, A,
+            QuantBData + n * StrideQuantBData,
+            QuantBScale + n * StrideQuantBScale,
+            (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * StrideQuantBZeroPoint,
+            C + n, CountK, StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint,
+            (Bias == nullptr) ? nullptr : Bias + n
+        );
+    }
+
+    for (; n < CountN; ++n) {
+        ComputeDotProducts<1>(
+            BlkLen, A,
+            QuantBData + n * StrideQuantBData,
+            QuantBScale + n * StrideQuantBScale,
+            (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * StrideQuantBZeroPoint,
+            C + n, CountK, StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint,
+            (Bias == nullptr) ? nullptr : Bias + n
+        );
+    }
+}
+
+//
+// Dequantizes B into the 16 column wide panels expected by the SGEMM kernel,
+// like MlasSgemmCopyPackB does with float data. The columns past CountN in the
+// last panel are zero.
+//
+
+void
+SQ4BitBlkDequantBForSgemm_CompFp32(
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK
+    )
+{
+    constexpr size_t PanelWidth = 16;
+
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    MLAS_DECLSPEC_ALIGN(float b[SubBlkLen], 16);
+
+    float* Dst = FpData;
+
+    for (size_t n = 0; n < CountN; n += PanelWidth) {
+        const size_t PanelCountN = std::min(CountN - n, PanelWidth);
+
+        if (PanelCountN < PanelWidth) {
+            std::fill_n(Dst, PanelWidth * CountK, 0.0f);
+        }
+
+        for (size_t nn = 0; nn < PanelCountN; ++nn) {
+            const std::byte* QuantBDataCol = QuantBData + (n + nn) * StrideQuantBData;
+            const float* QuantBScaleCol = QuantBScale + (n + nn) * BlockCountK;
+            const std::byte* QuantBZeroPointCol =
+                (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + (n + nn) * StrideQuantBZeroPoint;
+
+            for (size_t k = 0, k_blk_idx = 0; k < CountK; k += BlkLen, ++k_blk_idx) {
+                const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+                const MLAS_FLOAT32X4 ScaleVec = MlasBroadcastFloat32x4(QuantBScaleCol[k_blk_idx]);
+                const MLAS_FLOAT32X4 ZeroPointVec =
+                    MlasBroadcastFloat32x4(GetZeroPoint(QuantBZeroPointCol, k_blk_idx));
+
+                for (size_t kk = 0; kk < k_blk_len; kk += SubBlkLen) {
+                    UnpackQ4x16(QuantBDataCol + (k + kk) * BlkBitWidth / 8, b);
+                    for (size_t j = 0; j < 4; ++j) {
+                        MLAS_FLOAT32X4 Value = MlasLoadFloat32x4(b + 4 * j);
+                        Value = MlasMultiplyFloat32x4(MlasSubtractFloat32x4(Value, ZeroPointVec), ScaleVec);
+                        MlasStoreFloat32x4(b + 4 * j, Value);
+                    }
+
+                    const size_t kklen = std::min(k_blk_len - kk, SubBlkLen);
+                    float* DstCol = Dst + (k + kk) * PanelWidth + nn;
+                    for (size_t r = 0; r < kklen; ++r) {
+                        DstCol[r * PanelWidth] = b[r];
+                    }
+                }
+            }
+        }
+
+        Dst += PanelWidth * CountK;
+    }
+}
+
+}  // namespace
+
+}  // namespace sqnbitgemm_wasmsimd
+
+//
+// Kernel dispatch structure definition.
+//
+
+const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchWasmSimd = []() {
+    MLAS_QNBIT_GEMM_DISPATCH d;
+
+    d.Q4BitGemmPackQuantBDataSize = sqnbitgemm_wasmsimd::Q4BitGemmPackQuantBDataSize;
+    d.SQ4BitGemmPackQuantBData = sqnbitgemm_wasmsimd::SQ4BitGemmPackQuantBData;
+
+    d.SQ4BitGemmM1Kernel_CompFp32 = sqnbitgemm_wasmsimd::SQ4BitGemmM1Kernel_CompFp32;
+    d.SQ4BitBlkDequantBForSgemm_CompFp32 = sqnbitgemm_wasmsimd::SQ4BitBlkDequantBForSgemm_CompFp32;
+
+    return d;
+}();
@@ -0,0 +1,254 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/auto_mixed_precision.h"
+
+#include <map>
+
+#include "core/framework/data_types.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+
+// Operators which are safe to run in float16 or bfloat16 and benefit from it.
+constexpr const char* kDefaultAllowedOpTypes[] = {
+    "Add", "AveragePool", "Concat", "Conv", "ConvTranspose", "Flatten", "Gather", "Gemm",
+    "GlobalAveragePool", "GlobalMaxPool", "LeakyRelu", "MatMul", "MaxPool", "Mul", "Relu", "Reshape",
+    "Sigmoid", "Slice", "Split", "Squeeze", "Sub", "Tanh", "Transpose", "Unsqueeze"};
+
+// Operators whose accumulations or value ranges need float. They are never converted.
+constexpr const char* kPrecisionSensitiveOpTypes[] = {
+    "BatchNormalization", "CumSum", "Exp", "GroupNormalization", "InstanceNormalization",
+    "LayerNormalization", "Log", "LogSoftmax", "LpNormalization", "Pow", "Reciprocal", "ReduceL1",
+    "ReduceL2", "ReduceLogSum", "ReduceLogSumExp", "ReduceMean", "ReduceProd", "ReduceSum",
+    "ReduceSumSquare", "Softmax", "Sqrt"};
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+TypeProto MakeTargetType(const NodeArg& arg, TensorProto_DataType target_type) {
+  TypeProto type = *arg.TypeAsProto();
+  type.mutable_tensor_type()->set_elem_type(target_type);
+  return type;
+}
+
+// Get the type string of the formal parameter of each input and output of the node.
+bool GetFormalTypeStrs(const Node& node, InlinedVector<const std::string*>& input_type_strs,
+                       InlinedVector<const std::string*>& output_type_strs) {
+  const auto& schema = *node.Op();
+  const auto& input_arg_counts = node.InputArgCount();
+  for (size_t i = 0; i < input_arg_counts.size() && i < schema.inputs().size(); ++i) {
+    for (int j = 0; j < input_arg_counts[i]; ++j) {
+      input_type_strs.push_back(&schema.inputs()[i].GetTypeStr());
+    }
+  }
+
+  if (!schema.outputs().empty()) {
+    // only the last formal output can be variadic
+    for (size_t i = 0; i < node.OutputDefs().size(); ++i) {
+      output_type_strs.push_back(&schema.outputs()[std::min(i, schema.outputs().size() - 1)].GetTypeStr());
+    }
+  }
+
+  return input_type_strs.size() == node.InputDefs().size() && output_type_strs.size() == node.OutputDefs().size();
+}
+
+}  // namespace
+
+AutoMixedPrecision::AutoMixedPrecision(TensorProto_DataType target_type,
+                                       const KernelRegistryManager& kernel_registry_manager,
+                                       const InlinedHashSet<std::string>& extra_allowed_op_types,
+                                       const InlinedHashSet<std::string>& denied_op_types)
+    : GraphTransformer("AutoMixedPrecision"),
+      target_type_(target_type),
+      kernel_registry_manager_(kernel_registry_manager) {
+  ORT_ENFORCE(target_type == TensorProto_DataType_FLOAT16 || target_type == TensorProto_DataType_BFLOAT16,
+              "AutoMixedPrecision converts to float16 or bfloat16 only.");
+
+  allowed_op_types_.insert(std::begin(kDefaultAllowedOpTypes), std::end(kDefaultAllowedOpTypes));
+  allowed_op_types_.insert(extra_allowed_op_types.begin(), extra_allowed_op_types.end());
+  for (const auto& op_type : denied_op_types) {
+    allowed_op_types_.erase(op_type);
+  }
+  for (const char* op_type : kPrecisionSensitiveOpTypes) {
+    allowed_op_types_.erase(op_type);
+  }
+}
+
+Status AutoMixedPrecision::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
+                                     const logging::Logger& logger) const {
+  const MLDataType target_ml_type = target_type_ == TensorProto_DataType_FLOAT16
+                                        ? DataTypeImpl::GetTensorType<MLFloat16>()
+                                        : DataTypeImpl::GetTensorType<BFloat16>();
+  const std::string suffix = target_type_ == TensorProto_DataType_FLOAT16 ? "_fp16" : "_bf16";
+
+  // float value -> the same value in the target type, shared by all the converted consumers
+  InlinedHashMap<const NodeArg*, NodeArg*> converted_args;
+  // the inserted Cast nodes, with the EP of the node they were inserted for
+  InlinedVector<std::pair<NodeIndex, std::string>> cast_nodes;
+  // the Cast nodes converting outputs back to float, which are not needed if all the consumers were converted
+  InlinedVector<NodeIndex> cast_back_nodes;
+
+  auto add_cast_node = [&](NodeArg& input, NodeArg& output, TensorProto_DataType to,
+                           const std::string& provider_type) -> Node& {
+    Node& cast_node = graph.AddNode(graph.GenerateNodeName("AutoMixedPrecisionCast_" + input.Name()), "Cast",
+                                    "cast node inserted by AutoMixedPrecision", {&input}, {&output});
+    cast_node.AddAttribute("to", static_cast<int64_t>(to));
+    cast_nodes.emplace_back(cast_node.Index(), provider_type);
+    return cast_node;
+  };
+
+  bool converted_any = false;
+  GraphViewer graph_viewer(graph);
+  for (NodeIndex node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node* node = graph.GetNode(node_index);
+    if (node == nullptr || node->Op() == nullptr || node->ContainsSubgraph() || node->Domain() != kOnnxDomain ||
+        node->GetExecutionProviderType().empty() ||
+        allowed_op_types_.find(node->OpType()) == allowed_op_types_.end()) {
+      continue;
+    }
+
+    InlinedVector<const std::string*> input_type_strs;
+    InlinedVector<const std::string*> output_type_strs;
+    if (!GetFormalTypeStrs(*node, input_type_strs, output_type_strs)) {
+      continue;
+    }
+
+    // A type constraint is converted if all the values bound to it are float tensors.
+    InlinedHashMap<std::string, bool> constraint_is_float;
+    for (const auto& param : node->Op()->typeConstraintParams()) {
+      constraint_is_float.emplace(param.type_param_str, false);
+    }
+    InlinedHashSet<std::string> non_float_constraints;
+    auto check_arg = [&](const NodeArg& arg, const std::string& type_str) {
+      auto it = constraint_is_float.find(type_str);
+      if (it != constraint_is_float.end() && arg.Exists()) {
+        if (IsFloatTensor(arg)) {
+          it->second = true;
+        } else {
+          non_float_constraints.insert(type_str);
+        }
+      }
+    };
+    for (size_t i = 0; i < node->InputDefs().size(); ++i) {
+      check_arg(*node->InputDefs()[i], *input_type_strs[i]);
+    }
+    for (size_t i = 0; i < node->OutputDefs().size(); ++i) {
+      check_arg(*node->OutputDefs()[i], *output_type_strs[i]);
+    }
+
+    KernelRegistry::TypeConstraintMap type_constraints;
+    for (const auto& [type_str, is_float] : constraint_is_float) {
+      if (is_float && non_float_constraints.find(type_str) == non_float_constraints.end()) {
+        type_constraints.emplace(type_str, target_ml_type);
+      }
+    }
+    if (type_constraints.empty()) {
+      continue;
+    }
+
+    const std::string& provider_type = node->GetExecutionProviderType();
+    const auto kernel_registries = kernel_registry_manager_.GetKernelRegistriesByProviderType(provider_type);
+    const bool has_kernel = std::any_of(kernel_registries.begin(), kernel_registries.end(),
+                                        [&](const KernelRegistry* kernel_registry) {
+                                          const KernelCreateInfo* kernel_create_info = nullptr;
+                                          return kernel_registry->TryFindKernel(*node, provider_type,
+                                                                                type_constraints, logger,
+                                                                                &kernel_create_info)
+                                              .IsOK();
+                                        });
+    if (!has_kernel) {
+      continue;
+    }
+
+    std::map<const NodeArg*, NodeArg*> replacement_defs;
+    for (size_t i = 0; i < node->InputDefs().size(); ++i) {
+      NodeArg* input = node->MutableInputDefs()[i];
+      if (!input->Exists() || type_constraints.find(*input_type_strs[i]) == type_constraints.end() ||
+          replacement_defs.find(input) != replacement_defs.end()) {
+        continue;
+      }
+
+      auto converted = converted_args.find(input);
+      if (converted == converted_args.end()) {
+        NodeArg* converted_arg = nullptr;
+        const std::string converted_name = graph.GenerateNodeArgName(input->Name() + suffix);
+        if (const auto* initializer = graph_utils::IsConstantInitializer(graph, input->Name())
+                                          ? graph.GetConstantInitializer(input->Name(), true)
+                                          : nullptr;
+            initializer != nullptr) {
+          // convert constant initializers once instead of casting them on every run
+          Initializer value{*initializer, graph.ModelPath()};
+          converted_arg = &graph_utils::AddInitializer(graph, target_type_ == TensorProto_DataType_FLOAT16
+                                                                  ? value.ToFP16(converted_name)
+                                                                  : value.ToBFloat16(converted_name));
+        } else {
+          TypeProto converted_type = MakeTargetType(*input, target_type_);
+          converted_arg = &graph.GetOrCreateNodeArg(converted_name, &converted_type);
+          add_cast_node(*input, *converted_arg, target_type_, provider_type);
+        }
+        converted = converted_args.emplace(input, converted_arg).first;
+      }
+      replacement_defs[input] = converted->second;
+    }
+
+    for (size_t i = 0; i < node->OutputDefs().size(); ++i) {
+      NodeArg* output = node->MutableOutputDefs()[i];
+      if (!output->Exists() || type_constraints.find(*output_type_strs[i]) == type_constraints.end()) {
+        continue;
+      }
+
+      TypeProto converted_type = MakeTargetType(*output, target_type_);
+      NodeArg& converted_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(output->Name() + suffix),
+                                                        &converted_type);
+      // the original output is still produced, in float, for the consumers which are not converted
+      Node& cast_back_node = add_cast_node(converted_arg, *output, TensorProto_DataType_FLOAT, provider_type);
+      cast_back_nodes.push_back(cast_back_node.Index());
+      converted_args.emplace(output, &converted_arg);
+      replacement_defs[output] = &converted_arg;
+    }
+
+    node->ReplaceDefs(replacement_defs);
+    converted_any = true;
+  }
+
+  if (!converted_any) {
+    return Status::OK();
+  }
+
+  modified = true;
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  // Between converted nodes the values stay in the target type, so most of the casts back to float are unused.
+  for (NodeIndex node_index : cast_back_nodes) {
+    const Node* cast_back_node = graph.GetNode(node_index);
+    const NodeArg* output = cast_back_node->OutputDefs()[0];
+    if (cast_back_node->GetOutputEdgesCount() == 0 && !graph.IsOutput(output)) {
+      graph.RemoveNode(node_index);
+    }
+  }
+
+  // The casts run on the EP of the converted node if it can, or else on CPU.
+  for (const auto& [node_index, provider_type] : cast_nodes) {
+    Node* cast_node = graph.GetNode(node_index);
+    if (cast_node != nullptr) {
+      cast_node->SetExecutionProviderType(
+          KernelRegistryManager::HasImplementationOf(kernel_registry_manager_, *cast_node, provider_type, logger)
+              ? provider_type
+              : kCpuExecutionProvider);
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/framework/kernel_registry_manager.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class AutoMixedPrecision
+
+Transformer that converts float nodes to float16 or bfloat16 after the graph has been partitioned, for the nodes
+whose execution provider registers a kernel for the lower precision type.
+
+Only the ONNX operators in the allowed list are converted. Precision sensitive operators such as Softmax, the
+normalizations and the reductions always stay in float. Constant initializers are converted once, and a Cast node
+is inserted where a converted value meets a float one, so a chain of converted nodes is not interrupted by casts.
+*/
+class AutoMixedPrecision : public GraphTransformer {
+ public:
+  /**
+   * @param target_type FLOAT16 or BFLOAT16.
+   * @param kernel_registry_manager used to check that the assigned EP has a kernel for the converted node.
+   * @param extra_allowed_op_types op types to convert in addition to the default list.
+   * @param denied_op_types op types of the default list to keep in float.
+   */
+  AutoMixedPrecision(ONNX_NAMESPACE::TensorProto_DataType target_type,
+                     const KernelRegistryManager& kernel_registry_manager,
+                     const InlinedHashSet<std::string>& extra_allowed_op_types = {},
+                     const InlinedHashSet<std::string>& denied_op_types = {});
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const ONNX_NAMESPACE::TensorProto_DataType target_type_;
+  const KernelRegistryManager& kernel_registry_manager_;
+  InlinedHashSet<std::string> allowed_op_types_;
+};
+
+}  // namespace onnxruntime
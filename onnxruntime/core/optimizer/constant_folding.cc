@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <limits>
 
 #include "core/optimizer/constant_folding.h"
@@ -11,6 +12,9 @@
 #include "core/optimizer/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/common/parse_string.h"
+#include "core/platform/threadpool.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 using namespace onnxruntime::common;
 
@@ -20,12 +24,14 @@ ConstantFolding::ConstantFolding(const IExecutionProvider& execution_provider,
                                  bool skip_dequantize_linear,
                                  const ConfigOptions& config_options,
                                  const InlinedHashSet<std::string_view>& compatible_execution_providers,
-                                 const InlinedHashSet<std::string>& excluded_initializers) noexcept
+                                 const InlinedHashSet<std::string>& excluded_initializers,
+                                 concurrency::ThreadPool* thread_pool) noexcept
     : GraphTransformer("ConstantFolding", compatible_execution_providers),
       skip_dequantize_linear_(skip_dequantize_linear),
       config_options_(config_options),
       excluded_initializers_(excluded_initializers),
-      execution_provider_(execution_provider) {
+      execution_provider_(execution_provider),
+      thread_pool_(thread_pool) {
 }
 
 // We need to handle a Shape node separately as the input doesn't need to be a constant initializer for
@@ -131,23 +137,210 @@ static Status ConstantFoldIfNode(Graph& graph, Node& if_node, const logging::Log
   return status;
 }
 
+namespace {
+// A node with constant inputs, and everything needed to evaluate it without accessing the graph.
+struct FoldCandidate {
+  Node* node;
+  std::unique_ptr<OptimizerExecutionFrame::Info> info;
+  std::unique_ptr<const OpKernel> kernel;
+  std::vector<int> fetch_mlvalue_idxs;
+
+  // set by EvaluateFoldCandidate
+  Status status;
+  bool fold = false;
+  std::vector<ONNX_NAMESPACE::TensorProto> outputs;
+};
+}  // namespace
+
+// Returns true if the output is known to be larger than max_size_in_bytes before computing it.
+static bool OutputExceedsMaxSize(const NodeArg& output, size_t max_size_in_bytes) {
+  const auto* type = output.TypeAsProto();
+  const auto* shape = output.Shape();
+  if (max_size_in_bytes == 0 || type == nullptr || !utils::HasTensorType(*type) || shape == nullptr) {
+    return false;
+  }
+
+  ONNX_NAMESPACE::TensorProto tensor_proto;
+  tensor_proto.set_data_type(type->tensor_type().elem_type());
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim)) {
+      return false;
+    }
+    tensor_proto.add_dims(dim.dim_value());
+  }
+
+  size_t size_in_bytes = 0;
+  return utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &size_in_bytes).IsOK() &&
+         size_in_bytes > max_size_in_bytes;
+}
+
+// Runs the kernel of the candidate and converts the outputs to TensorProto. This does not modify the graph so it can
+// be called concurrently for different candidates.
+static Status EvaluateFoldCandidate(FoldCandidate& candidate, size_t max_output_size_in_bytes,
+                                    const logging::Logger& logger) {
+  const Node& node = *candidate.node;
+  std::vector<OrtValue> fetches;
+  {
+    OptimizerExecutionFrame frame(*candidate.info, candidate.fetch_mlvalue_idxs);
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable : 6387)
+#endif
+    OpKernelContext op_kernel_context(&frame, candidate.kernel.get(), /*stream*/ nullptr, nullptr, logger);
+    ORT_RETURN_IF_ERROR(candidate.kernel->Compute(&op_kernel_context));
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+  }
+
+  // the frame is gone so free the copies of the inputs before converting the outputs, rather than holding everything
+  // until the graph is updated.
+  candidate.kernel.reset();
+  candidate.info.reset();
+
+  // Go over all output node args and substitute them with the newly computed tensors, which will be
+  // added to the graph as initializers.
+  ORT_ENFORCE(fetches.size() == node.OutputDefs().size());
+  for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
+    const auto& constant_arg_out = *node.OutputDefs()[fetch_idx];
+    // XXX: Add support for SparseTensors outputs when we have sparse outputs
+    if (!utils::HasTensorType(*constant_arg_out.TypeAsProto())) {
+      LOGS(logger, INFO) << "Unsupported output type of " << constant_arg_out.Type()
+                         << ". Can't constant fold " << node.OpType() << " node '" << node.Name() << "'";
+      return Status::OK();
+    }
+
+    const size_t size_in_bytes = fetches[fetch_idx].Get<Tensor>().SizeInBytes();
+    if (max_output_size_in_bytes != 0 && size_in_bytes > max_output_size_in_bytes) {
+      LOGS(logger, INFO) << "Output '" << constant_arg_out.Name() << "' of " << size_in_bytes
+                         << " bytes exceeds the constant folding limit of " << max_output_size_in_bytes
+                         << " bytes. Can't constant fold " << node.OpType() << " node '" << node.Name() << "'";
+      return Status::OK();
+    }
+  }
+
+  candidate.outputs.reserve(fetches.size());
+  for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
+    // Build the TensorProto that corresponds to the computed OrtValue. The OrtValue is released once converted.
+    const Tensor& out_tensor = fetches[fetch_idx].Get<Tensor>();
+    candidate.outputs.push_back(utils::TensorToTensorProto(out_tensor, node.OutputDefs()[fetch_idx]->Name()));
+    fetches[fetch_idx] = OrtValue();
+  }
+
+  candidate.fold = true;
+  return Status::OK();
+}
+
+// Removes a node that was converted to constants, and the single-output node chains feeding it.
+static void RemoveConstantFoldedNode(Graph& graph, Node& node) {
+  // Remove single-output node chain for inputs of the node
+  auto p_ip_node = node.InputNodesBegin();
+  const auto p_ip_node_end = node.InputNodesEnd();
+  while (p_ip_node != p_ip_node_end) {
+    const auto& input_node = *p_ip_node;
+    // Update the node iterator before removing the corresponding node because removing
+    // the node will invalidate the node iterator
+    ++p_ip_node;
+    graph_utils::RemoveNodesWithOneOutputBottomUp(graph, input_node);
+  }
+
+  // Remove the output edges of the constant node and then remove the node itself.
+  graph_utils::RemoveNodeOutputEdges(graph, node);
+  graph.RemoveNode(node.Index());
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
   bool have_updated_nodes = false;
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
 
+  size_t max_output_size_in_bytes = 0;
+  ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(
+      config_options_.GetConfigOrDefault(kOrtSessionOptionsConstantFoldingMaxOutputSizeInBytes, "0"),
+      max_output_size_in_bytes));
+
 #if !defined(DISABLE_SPARSE_TENSORS)
   std::function<bool(const std::string&)> is_sparse_initializer_check = [&graph](const std::string& name) -> bool {
     return graph.IsSparseInitializer(name);
   };
+#else
+  std::function<bool(const std::string&)> is_sparse_initializer_check = [](const std::string&) { return false; };
 #endif
 
+  // Nodes that can be folded are collected and evaluated together so that the thread pool can run them in parallel.
+  // A node that consumes the output of a pending node is only looked at once the pending nodes have been folded, so
+  // the result doesn't depend on the number of threads. The number of pending nodes is limited to the number of
+  // threads to bound the memory used by copies of their inputs.
+  const size_t max_pending = static_cast<size_t>(
+      std::max(1, concurrency::ThreadPool::DegreeOfParallelism(thread_pool_)));
+  std::vector<FoldCandidate> pending;
+  InlinedHashSet<const NodeArg*> pending_outputs;
+
+  const auto fold_pending = [&]() -> Status {
+    if (pending.empty()) {
+      return Status::OK();
+    }
+
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        thread_pool_, static_cast<std::ptrdiff_t>(pending.size()), [&](std::ptrdiff_t i) {
+          auto& candidate = pending[static_cast<size_t>(i)];
+          ORT_TRY {
+            candidate.status = EvaluateFoldCandidate(candidate, max_output_size_in_bytes, logger);
+          }
+          ORT_CATCH(const std::exception& ex) {
+            ORT_HANDLE_EXCEPTION([&]() {
+              candidate.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Constant folding ", candidate.node->OpType(),
+                                                 " node '", candidate.node->Name(), "' failed: ", ex.what());
+            });
+          }
+        });
+
+    // update the graph in topological order
+    for (auto& candidate : pending) {
+      ORT_RETURN_IF_ERROR(candidate.status);
+      if (!candidate.fold) {
+        continue;
+      }
+
+      Node& node = *candidate.node;
+      for (size_t i = 0; i < candidate.outputs.size(); ++i) {
+        const auto& out_tensorproto = candidate.outputs[i];
+        ONNX_NAMESPACE::TensorShapeProto result_shape;
+        for (const auto dim : out_tensorproto.dims()) {
+          result_shape.add_dim()->set_dim_value(dim);
+        }
+
+        node.MutableOutputDefs()[i]->SetShape(result_shape);
+        graph.AddInitializedTensor(out_tensorproto);
+      }
+
+      RemoveConstantFoldedNode(graph, node);
+      modified = true;
+      have_updated_nodes = true;
+    }
+
+    pending.clear();
+    pending_outputs.clear();
+    return Status::OK();
+  };
+
   for (NodeIndex i : order) {
     auto* node = graph.GetNode(i);
     if (!node) {
       continue;
     }
 
+    if (!pending_outputs.empty()) {
+      const auto consumes_pending_output = [&pending_outputs](const NodeArg* def) {
+        return pending_outputs.count(def) != 0;
+      };
+      if (std::any_of(node->InputDefs().begin(), node->InputDefs().end(), consumes_pending_output) ||
+          std::any_of(node->ImplicitInputDefs().begin(), node->ImplicitInputDefs().end(), consumes_pending_output)) {
+        ORT_RETURN_IF_ERROR(fold_pending());
+      }
+    }
+
     ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
 
     // Updating a node may allow shape inferencing to infer output shapes of following nodes,
@@ -224,26 +417,30 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         }
       }
 
-#if !defined(DISABLE_SPARSE_TENSORS)
-      // Create execution frame for executing constant nodes.
-      OptimizerExecutionFrame::Info info({node}, constant_inputs, graph.ModelPath(), execution_provider_,
-                                         is_sparse_initializer_check, logger);
-#else
-      // Create execution frame for executing constant nodes.
-      OptimizerExecutionFrame::Info info(
-          {node}, constant_inputs, graph.ModelPath(), execution_provider_, [](const std::string&) { return false; },
-          logger);
-#endif
+      // skip the evaluation if the shape inferencing already tells us the result is too large
+      const auto output_defs = node->OutputDefs();
+      if (std::any_of(output_defs.begin(), output_defs.end(), [max_output_size_in_bytes](const NodeArg* def) {
+            return OutputExceedsMaxSize(*def, max_output_size_in_bytes);
+          })) {
+        LOGS(logger, INFO) << "Output size exceeds the constant folding limit of " << max_output_size_in_bytes
+                           << " bytes. Can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
+        continue;
+      }
+
+      FoldCandidate candidate;
+      candidate.node = node;
+
+      // Create execution frame info for executing constant nodes.
+      candidate.info = std::make_unique<OptimizerExecutionFrame::Info>(
+          std::vector<const Node*>{node}, constant_inputs, graph.ModelPath(), execution_provider_,
+          is_sparse_initializer_check, logger);
 
-      std::vector<int> fetch_mlvalue_idxs;
       for (const auto* node_out : node->OutputDefs()) {
-        fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
+        candidate.fetch_mlvalue_idxs.push_back(candidate.info->GetMLValueIndex(node_out->Name()));
       }
 
       const bool node_on_cpu_ep = node->GetExecutionProviderType() == kCpuExecutionProvider;
 
-      std::unique_ptr<const OpKernel> kernel;
-
       if (!node_on_cpu_ep) {
         // We need to copy the string here instead of taking a reference to it since node->SetExecutionProviderType
         // will change the value of the reference
@@ -252,12 +449,12 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         // override the EP assigned to the node so that it will use the CPU kernel for Compute.
         node->SetExecutionProviderType(kCpuExecutionProvider);
 
-        kernel = info.CreateKernel(node, config_options_);
+        candidate.kernel = candidate.info->CreateKernel(node, config_options_);
 
         // undo the EP change to the value that was assigned at graph partitioning time
         node->SetExecutionProviderType(ep_type);
       } else {
-        kernel = info.CreateKernel(node, config_options_);
+        candidate.kernel = candidate.info->CreateKernel(node, config_options_);
       }
 
       // We currently constant fold using the CPU EP only.
@@ -265,7 +462,7 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       //
       // TODO(adrianlizarraga): Support constant folding with other execution providers. For example, we may be able
       // to use a CUDA kernel to constant fold operators with data types not supported by the CPU EP kernel.
-      if (kernel == nullptr) {
+      if (candidate.kernel == nullptr) {
         LOGS(logger, WARNING) << "Could not find a CPU kernel and hence "
                               << "can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
 
@@ -273,74 +470,20 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         continue;
       }
 
-      OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
-#ifdef _WIN32
-#pragma warning(push)
-#pragma warning(disable : 6387)
-#endif
-      OpKernelContext op_kernel_context(&frame, kernel.get(), /*stream*/ nullptr, nullptr, logger);
-      ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
-#ifdef _WIN32
-#pragma warning(pop)
-#endif
-
-      std::vector<OrtValue> fetches;
-      ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
-
-      // Go over all output node args and substitute them with the newly computed tensors, which will be
-      // added to the graph as initializers.
-      ORT_ENFORCE(fetches.size() == node->OutputDefs().size());
-      converted_to_constant = true;
-      for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-        const auto& constant_arg_out = *node->OutputDefs()[fetch_idx];
-        // XXX: Add support for SparseTensors outputs when we have sparse outputs
-        if (!utils::HasTensorType(*constant_arg_out.TypeAsProto())) {
-          LOGS(logger, INFO) << "Unsupported output type of " << constant_arg_out.Type()
-                             << ". Can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
-          converted_to_constant = false;
-          break;
-        }
-      }
-
-      if (converted_to_constant) {
-        for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-          OrtValue& ort_value = fetches[fetch_idx];
-          // Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
-          auto* constant_arg_out = node->MutableOutputDefs()[fetch_idx];
-          const Tensor& out_tensor = ort_value.Get<Tensor>();
-          ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out->Name());
-
-          ONNX_NAMESPACE::TensorShapeProto result_shape;
-          for (auto& dim : out_tensor.Shape().GetDims()) {
-            result_shape.add_dim()->set_dim_value(dim);
-          }
-
-          constant_arg_out->SetShape(result_shape);
-          graph.AddInitializedTensor(out_tensorproto);
-        }
+      pending_outputs.insert(output_defs.begin(), output_defs.end());
+      pending.push_back(std::move(candidate));
+      if (pending.size() >= max_pending) {
+        ORT_RETURN_IF_ERROR(fold_pending());
       }
     }
 
     if (converted_to_constant) {
-      // Remove single-output node chain for inputs of the node
-      auto p_ip_node = node->InputNodesBegin();
-      const auto p_ip_node_end = node->InputNodesEnd();
-      while (p_ip_node != p_ip_node_end) {
-        const auto& input_node = *p_ip_node;
-        // Update the node iterator before removing the corresponding node because removing
-        // the node will invalidate the node iterator
-        ++p_ip_node;
-        graph_utils::RemoveNodesWithOneOutputBottomUp(graph, input_node);
-      }
-
-      // Remove the output edges of the constant node and then remove the node itself.
-      graph_utils::RemoveNodeOutputEdges(graph, *node);
-      graph.RemoveNode(node->Index());
+      RemoveConstantFoldedNode(graph, *node);
       modified = true;
       have_updated_nodes = true;
     }
   }
 
-  return Status::OK();
+  return fold_pending();
 }
 }  // namespace onnxruntime
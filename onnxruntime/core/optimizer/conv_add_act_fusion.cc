@@ -123,7 +123,6 @@ class ConvAddActivationSelector : public NodeSelector {
 
   const Node* SelectProducerConv(const Node& node) const {
     InlinedVector<const Node*> inputs_node;
-    constexpr int32_t kTensorDims = 4;  // NCHW
     const auto& input_defs = node.InputDefs();
 
     for (auto producer_node_ptr = node.InputNodesBegin(); producer_node_ptr != node.InputNodesEnd(); ++producer_node_ptr) {
@@ -137,10 +136,12 @@ class ConvAddActivationSelector : public NodeSelector {
     // Test if all of inputs have an equal shape.
     auto* input_0_shape = input_defs[0]->Shape();
     // Check if ONNX shape inferencing has computed a precise dimension value.
-    if ((input_0_shape == nullptr) || (input_0_shape->dim_size() != kTensorDims)) {
+    // 1D, 2D and 3D convolutions (N x C x D1 ... Dn) are supported.
+    if ((input_0_shape == nullptr) || (input_0_shape->dim_size() < 3) || (input_0_shape->dim_size() > 5)) {
       return nullptr;
     }
-    for (int i = 0; i < kTensorDims; i++) {
+    const int tensor_dims = input_0_shape->dim_size();
+    for (int i = 0; i < tensor_dims; i++) {
       auto& input_0_dim = input_0_shape->dim(i);
       // even though zero-dim is valid, but we don't support here
       if (!utils::HasDimValue(input_0_dim) || (input_0_dim.dim_value() == 0)) {
@@ -152,10 +153,10 @@ class ConvAddActivationSelector : public NodeSelector {
     // we can't fuse them if shape is not matched, it will happens when broadcast-Add
     for (size_t n = 1; n < input_defs_count; n++) {
       auto* input_n_shape = input_defs[n]->Shape();
-      if (input_n_shape == nullptr || (input_n_shape->dim_size() != kTensorDims)) {
+      if (input_n_shape == nullptr || (input_n_shape->dim_size() != tensor_dims)) {
         return nullptr;
       }
-      for (int i = 0; i < kTensorDims; i++) {
+      for (int i = 0; i < tensor_dims; i++) {
         auto& input_0_dim = input_0_shape->dim(i);
         auto& input_n_dim = input_n_shape->dim(i);
         if (!utils::HasDimValue(input_n_dim) || (input_0_dim.dim_value() != input_n_dim.dim_value())) {
@@ -175,24 +176,17 @@ class ConvAddActivationSelector : public NodeSelector {
       // Check if this is a single use convolution that hasn't already
       // been fused with another Add/Sum node. The Add/Sum can also only be
       // fused if the convolution isn't itself fused with an activation.
+      // A missing bias is filled with an empty argument by the action.
       if ((inputs_node[n]->OpType() == "Conv") && (pre_input_defs_count < 4) &&
           (producer_input_args_count.size() < 4) &&
           (graph_utils::GetNodeAttribute(*inputs_node[n], "activation") == nullptr) &&
           (inputs_node[n]->GetOutputEdgesCount() == 1)) {
-        if (pre_input_defs_count < 3) {  // The optional bias parameter is empty so set to an empty string.
-          // TODO, add a new null arguments for bias
-          continue;
-        }
         return inputs_node[n];
       }
       if (inputs_node[n]->OpType() == "NhwcFusedConv" && (pre_input_defs_count < 4) &&
           (producer_input_args_count.size() < 5) &&
           (graph_utils::GetNodeAttribute(*inputs_node[n], "activation") == nullptr) &&
           (inputs_node[n]->GetOutputEdgesCount() == 1)) {
-        if (pre_input_defs_count < 3) {  // The optional bias parameter is empty so set to an empty string.
-          // TODO, add a new null arguments for bias
-          continue;
-        }
         return inputs_node[n];
       }
     }
@@ -209,6 +203,15 @@ class FuseConvAddActivationAction : public ReplaceWithNew {
  public:
   FuseConvAddActivationAction() = default;
 
+  Status Run(Graph& graph, const NodesToOptimize& selected_nodes) const override {
+    // The Add input becomes the Sum input, so a missing bias needs an empty argument in its slot.
+    Node& conv = selected_nodes.Target();
+    if (conv.InputDefs().size() < 3) {
+      graph_utils::AddNodeInput(conv, 2, graph.GetOrCreateNodeArg("", nullptr));
+    }
+    return ReplaceWithNew::Run(graph, selected_nodes);
+  }
+
  private:
   std::string OpType(const RuntimeState& runtimeState) const override {
     return (runtimeState.selected_nodes.Target().OpType() == "Conv") ? "FusedConv" : "NhwcFusedConv";
@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/duplicate_initializer_elimination.h"
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+namespace onnxruntime {
+
+namespace {
+
+using HashValue = std::array<uint32_t, 4>;
+
+struct HashValueHash {
+  size_t operator()(const HashValue& value) const {
+    return (static_cast<size_t>(value[1]) << 32) ^ value[0];
+  }
+};
+
+// Initializers are only compared to those with the same data type and shape.
+std::string MakeCandidateKey(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  std::string key = std::to_string(tensor_proto.data_type());
+  for (const auto dim : tensor_proto.dims()) {
+    key += "_" + std::to_string(dim);
+  }
+  return key;
+}
+
+// Return false if the initializer can not be replaced in all of its consumers, i.e. if it is used by a subgraph.
+bool GetConsumerInputPorts(const Graph& graph, const NodeArg& initializer_node_arg,
+                           InlinedVector<std::pair<const Node*, InlinedVector<int>>>& consumer_input_ports) {
+  for (const Node* consumer : graph.GetConsumerNodes(initializer_node_arg.Name())) {
+    const auto& implicit_inputs = consumer->ImplicitInputDefs();
+    if (std::find(implicit_inputs.begin(), implicit_inputs.end(), &initializer_node_arg) != implicit_inputs.end()) {
+      return false;
+    }
+
+    InlinedVector<int> input_ports;
+    const auto& inputs = consumer->InputDefs();
+    for (int i = 0, end = static_cast<int>(inputs.size()); i < end; ++i) {
+      if (inputs[i] == &initializer_node_arg) {
+        input_ports.push_back(i);
+      }
+    }
+    consumer_input_ports.emplace_back(consumer, std::move(input_ports));
+  }
+  return true;
+}
+
+struct UniqueInitializer {
+  NodeArg* node_arg;
+  Initializer value;
+};
+
+}  // namespace
+
+Status DuplicateInitializerElimination::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                                  const logging::Logger& logger) const {
+  for (auto& node : graph.Nodes()) {
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+  }
+
+  // Group the candidates by data type and shape first, so that only the initializers which may have a duplicate
+  // are loaded and hashed.
+  InlinedHashMap<std::string, InlinedVector<std::string>> candidates;
+  for (const auto& [name, tensor_proto] : graph.GetAllInitializedTensors()) {
+    if (tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING ||
+        tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED ||
+        !graph_utils::IsConstantInitializer(graph, name) ||
+        excluded_initializers_.find(name) != excluded_initializers_.end()) {
+      continue;
+    }
+    const NodeArg* node_arg = graph.GetNodeArg(name);
+    if (node_arg == nullptr || graph.IsOutput(node_arg)) {
+      continue;
+    }
+    candidates[MakeCandidateKey(*tensor_proto)].push_back(name);
+  }
+
+  size_t eliminated_count = 0;
+  size_t eliminated_bytes = 0;
+  for (auto& candidate : candidates) {
+    auto& names = candidate.second;
+    if (names.size() < 2) {
+      continue;
+    }
+
+    // visit the initializers in a deterministic order, so the same one is kept for every load of the model
+    std::sort(names.begin(), names.end());
+
+    std::unordered_multimap<HashValue, UniqueInitializer, HashValueHash> unique_initializers;
+    for (const auto& name : names) {
+      NodeArg* node_arg = graph.GetNodeArg(name);
+      InlinedVector<std::pair<const Node*, InlinedVector<int>>> consumer_input_ports;
+      if (!GetConsumerInputPorts(graph, *node_arg, consumer_input_ports)) {
+        continue;
+      }
+
+      const ONNX_NAMESPACE::TensorProto* tensor_proto = graph.GetConstantInitializer(name, true);
+      Initializer value{*tensor_proto, graph.ModelPath()};
+      const auto bytes = value.DataAsByteSpan();
+      HashValue hash{};
+      MurmurHash3::x86_128_append(bytes.data(), bytes.size(), hash.data());
+
+      NodeArg* duplicate_of = nullptr;
+      auto [begin, end] = unique_initializers.equal_range(hash);
+      for (auto it = begin; it != end; ++it) {
+        if (SpanEq(it->second.value.DataAsByteSpan(), bytes)) {
+          duplicate_of = it->second.node_arg;
+          break;
+        }
+      }
+
+      if (duplicate_of == nullptr) {
+        unique_initializers.emplace(hash, UniqueInitializer{node_arg, std::move(value)});
+        continue;
+      }
+
+      for (const auto& [consumer, input_ports] : consumer_input_ports) {
+        Node& node = *graph.GetNode(consumer->Index());
+        for (int input_port : input_ports) {
+          graph_utils::ReplaceNodeInput(node, input_port, *duplicate_of);
+        }
+        graph.RemoveConsumerNode(name, &node);
+
+        const auto shared_consumers = graph.GetConsumerNodes(duplicate_of->Name());
+        if (std::find(shared_consumers.begin(), shared_consumers.end(), &node) == shared_consumers.end()) {
+          graph.AddConsumerNode(duplicate_of->Name(), &node);
+        }
+      }
+
+      if (graph.GetConsumerNodes(name).empty()) {
+        graph.RemoveInitializedTensor(name);
+      }
+
+      ++eliminated_count;
+      eliminated_bytes += bytes.size();
+      modified = true;
+    }
+  }
+
+  if (eliminated_count > 0) {
+    LOGS(logger, INFO) << "Eliminated " << eliminated_count << " duplicate initializers, saving "
+                       << eliminated_bytes << " bytes.";
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
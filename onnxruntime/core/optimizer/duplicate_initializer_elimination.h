@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@class DuplicateInitializerElimination
+
+Transformer that makes the consumers of identical constant initializers of any size use a single one of them, so
+that only one copy is kept in memory. Exported models often contain large duplicates, e.g. tied weights or repeated
+position tables. Candidates with the same data type and shape are hashed with MurmurHash3 and compared byte by byte
+before they are merged. Unlike ConstantSharing, no new initializer is created: the first one found is kept.
+*/
+class DuplicateInitializerElimination : public GraphTransformer {
+ public:
+  /**
+   * @param excluded_initializers explicitly excluded initializer names that should not changed.
+   */
+  DuplicateInitializerElimination(const InlinedHashSet<std::string>& excluded_initializers = {}) noexcept
+      : GraphTransformer("DuplicateInitializerElimination"),
+        excluded_initializers_(excluded_initializers) {
+  }
+
+  bool ShouldOnlyApplyOnce() const override { return true; }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const InlinedHashSet<std::string> excluded_initializers_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+
+#include <algorithm>
+#include <array>
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// Upper bound on the number of nodes in one fused chain. The kernel keeps a scratch block per step.
+constexpr size_t kMaxFusedNodes = 16;
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return arg.Exists() && type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+bool IsFusibleNode(const Node& node, const InlinedHashSet<std::string_view>& compatible_providers) {
+  size_t expected_inputs = 1;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14})) {
+    expected_inputs = 2;
+  } else if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) &&
+             !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) &&
+             !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) &&
+             !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6, 13}) &&
+             !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Log", {6, 13}) &&
+             !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) &&
+             !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6, 13}) &&
+             !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6, 13}) &&
+             !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6, 13}) &&
+             !graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13})) {
+    return false;
+  }
+
+  if (!graph_utils::IsSupportedProvider(node, compatible_providers) ||
+      node.InputDefs().size() != expected_inputs || node.OutputDefs().size() != 1) {
+    return false;
+  }
+
+  return std::all_of(node.InputDefs().begin(), node.InputDefs().end(),
+                     [](const NodeArg* arg) { return IsFloatTensor(*arg); }) &&
+         IsFloatTensor(*node.OutputDefs()[0]);
+}
+
+}  // namespace
+
+/**
+Fuse chains of element-wise operators into a FusedElementwise node.
+
+Starting from each fusible node in topological order, the chain grows by adding a fusible consumer of a node
+already in the chain whose other inputs are either produced by the chain or by nodes earlier in topological
+order than the start of the chain. The latter guarantees the fused node can not introduce a cycle. Nodes are
+then dropped from the end of the chain until only the last node's output is used outside of the chain.
+*/
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                    const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashMap<NodeIndex, size_t> positions;
+  positions.reserve(node_topology_list.size());
+  for (size_t i = 0; i < node_topology_list.size(); ++i) {
+    positions[node_topology_list[i]] = i;
+  }
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (!p_node) continue;
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!IsFusibleNode(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const size_t first_position = positions[node.Index()];
+    InlinedVector<std::reference_wrapper<Node>> nodes_to_fuse{node};
+    InlinedHashSet<NodeIndex> fused_node_indices{node.Index()};
+    InlinedHashSet<const NodeArg*> fused_outputs{node.OutputDefs()[0]};
+
+    auto is_available = [&](const NodeArg* arg) {
+      if (fused_outputs.count(arg) != 0) {
+        return true;
+      }
+      const Node* producer = graph.GetProducerNode(arg->Name());
+      return producer == nullptr || positions.at(producer->Index()) < first_position;
+    };
+
+    bool grown = true;
+    while (grown && nodes_to_fuse.size() < kMaxFusedNodes) {
+      grown = false;
+      for (size_t i = nodes_to_fuse.size(); i-- > 0 && !grown;) {
+        const Node& member = nodes_to_fuse[i];
+        for (auto it = member.OutputNodesBegin(), end = member.OutputNodesEnd(); it != end; ++it) {
+          if (fused_node_indices.count(it->Index()) != 0 ||
+              !IsFusibleNode(*it, GetCompatibleExecutionProviders()) ||
+              !std::all_of(it->InputDefs().begin(), it->InputDefs().end(), is_available)) {
+            continue;
+          }
+          Node& consumer = *graph.GetNode(it->Index());
+          nodes_to_fuse.push_back(consumer);
+          fused_node_indices.insert(consumer.Index());
+          fused_outputs.insert(consumer.OutputDefs()[0]);
+          grown = true;
+          break;
+        }
+      }
+    }
+
+    // Only the output of the last node may be consumed outside of the fused chain.
+    auto has_external_consumer = [&](const Node& member) {
+      if (graph.NodeProducesGraphOutput(member)) {
+        return true;
+      }
+      for (auto it = member.OutputNodesBegin(), end = member.OutputNodesEnd(); it != end; ++it) {
+        if (fused_node_indices.count(it->Index()) == 0) {
+          return true;
+        }
+      }
+      return false;
+    };
+
+    while (nodes_to_fuse.size() >= 2 &&
+           std::any_of(nodes_to_fuse.begin(), nodes_to_fuse.end() - 1,
+                       [&](const Node& member) { return has_external_consumer(member); })) {
+      const Node& last = nodes_to_fuse.back();
+      fused_node_indices.erase(last.Index());
+      fused_outputs.erase(last.OutputDefs()[0]);
+      nodes_to_fuse.pop_back();
+    }
+
+    if (nodes_to_fuse.size() < 2) {
+      continue;
+    }
+
+    // Assign registers: the distinct external inputs first, then one register per fused node.
+    InlinedVector<NodeArg*> fused_inputs;
+    InlinedHashMap<const NodeArg*, int64_t> registers;
+    for (Node& member : nodes_to_fuse) {
+      for (NodeArg* input : member.MutableInputDefs()) {
+        if (fused_outputs.count(input) == 0 &&
+            registers.emplace(input, static_cast<int64_t>(fused_inputs.size())).second) {
+          fused_inputs.push_back(input);
+        }
+      }
+    }
+
+    const int64_t num_inputs = static_cast<int64_t>(fused_inputs.size());
+    std::vector<std::string> ops;
+    std::vector<int64_t> lhs;
+    std::vector<int64_t> rhs;
+    for (size_t i = 0; i < nodes_to_fuse.size(); ++i) {
+      const Node& member = nodes_to_fuse[i];
+      const auto& input_defs = member.InputDefs();
+      ops.push_back(member.OpType());
+      lhs.push_back(registers.at(input_defs[0]));
+      rhs.push_back(input_defs.size() > 1 ? registers.at(input_defs[1]) : -1);
+      registers[member.OutputDefs()[0]] = num_inputs + static_cast<int64_t>(i);
+    }
+
+    Node& last_node = nodes_to_fuse.back();
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(last_node.Name() + "/ElementwiseFusion/"),
+                                     "FusedElementwise", "fused element-wise operators", fused_inputs,
+                                     std::array{last_node.MutableOutputDefs()[0]}, nullptr, kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    fused_node.AddAttribute("lhs", lhs);
+    fused_node.AddAttribute("rhs", rhs);
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    // The fused node takes the place of the last node, so anything later in the order that consumes it can
+    // still be checked against the chain it is part of.
+    positions[fused_node.Index()] = positions[last_node.Index()];
+
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, fused_node);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
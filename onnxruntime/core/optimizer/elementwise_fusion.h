@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Fuse chains of float element-wise operators (Add, Mul, Sigmoid, Relu, ...) into a single
+ * com.microsoft.FusedElementwise node that evaluates the chain block by block without materializing the
+ * intermediate tensors. Runs after the pattern-specific fusions so that chains such as Gelu or QuickGelu keep
+ * their dedicated kernels.
+ */
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
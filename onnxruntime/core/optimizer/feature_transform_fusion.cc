@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/feature_transform_fusion.h"
+
+#include <array>
+
+#include "core/framework/op_node_proto_helper.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// Position of an operator in the fused pipeline, which runs the stages in this order.
+enum class Stage : int {
+  Impute = 0,
+  Scale = 1,
+  Normalize = 2,
+  None = 3,
+};
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return arg.Exists() && type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+Stage GetStage(const Node& node, const InlinedHashSet<std::string_view>& compatible_providers) {
+  if (!graph_utils::IsSupportedProvider(node, compatible_providers) ||
+      node.InputDefs().size() != 1 || node.OutputDefs().size() != 1 ||
+      !IsFloatTensor(*node.InputDefs()[0]) || !IsFloatTensor(*node.OutputDefs()[0])) {
+    return Stage::None;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Imputer", {1}, kMLDomain)) {
+    // only the float attributes apply to a float input
+    const auto* imputed_values = graph_utils::GetNodeAttribute(node, "imputed_value_floats");
+    return imputed_values != nullptr && imputed_values->floats_size() > 0 ? Stage::Impute : Stage::None;
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Scaler", {1}, kMLDomain)) {
+    const auto* scale = graph_utils::GetNodeAttribute(node, "scale");
+    const auto* offset = graph_utils::GetNodeAttribute(node, "offset");
+    return scale != nullptr && offset != nullptr && scale->floats_size() > 0 &&
+                   scale->floats_size() == offset->floats_size()
+               ? Stage::Scale
+               : Stage::None;
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Normalizer", {1}, kMLDomain)) {
+    return Stage::Normalize;
+  }
+  return Stage::None;
+}
+
+}  // namespace
+
+/**
+Fuse Imputer -> Scaler -> Normalizer chains into a FusedFeatureTransform node.
+
+A chain starts at a supported node and grows while the last node has a single consumer which is the next
+stage of the pipeline. The intermediate outputs must not be graph outputs. The input must be 1D or 2D, like
+Normalizer requires, so that all the operators agree on the feature axis.
+*/
+Status FeatureTransformFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                         const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (!p_node) continue;
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    Stage stage = GetStage(node, GetCompatibleExecutionProviders());
+    if (stage == Stage::None || stage == Stage::Normalize) {
+      continue;
+    }
+
+    const auto* input_shape = node.InputDefs()[0]->Shape();
+    if (input_shape == nullptr || input_shape->dim_size() < 1 || input_shape->dim_size() > 2) {
+      continue;
+    }
+
+    std::array<Node*, 3> stage_nodes{};
+    stage_nodes[static_cast<int>(stage)] = &node;
+    InlinedVector<std::reference_wrapper<Node>> nodes_to_fuse{node};
+
+    while (stage != Stage::Normalize) {
+      const Node& last = nodes_to_fuse.back();
+      if (last.GetOutputEdgesCount() != 1 || graph.NodeProducesGraphOutput(last)) {
+        break;
+      }
+
+      Node& next = *graph.GetNode(last.OutputNodesBegin()->Index());
+      const Stage next_stage = GetStage(next, GetCompatibleExecutionProviders());
+      if (next_stage == Stage::None || static_cast<int>(next_stage) <= static_cast<int>(stage) ||
+          next.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+        break;
+      }
+
+      stage = next_stage;
+      stage_nodes[static_cast<int>(stage)] = &next;
+      nodes_to_fuse.push_back(next);
+    }
+
+    if (nodes_to_fuse.size() < 2) {
+      continue;
+    }
+
+    Node& last_node = nodes_to_fuse.back();
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(last_node.Name() + "/FeatureTransformFusion/"),
+                                     "FusedFeatureTransform", "fused Imputer, Scaler and Normalizer",
+                                     std::array{node.MutableInputDefs()[0]},
+                                     std::array{last_node.MutableOutputDefs()[0]}, nullptr, kMSDomain);
+
+    if (const Node* imputer = stage_nodes[static_cast<int>(Stage::Impute)]; imputer != nullptr) {
+      ProtoHelperNodeContext helper_ctx(*imputer);
+      OpNodeProtoHelper<ProtoHelperNodeContext> helper(&helper_ctx);
+      fused_node.AddAttribute("imputed_values", helper.GetAttrsOrDefault<float>("imputed_value_floats"));
+      fused_node.AddAttribute("replaced_value", helper.GetAttrOrDefault<float>("replaced_value_float", 0.0f));
+    }
+    if (const Node* scaler = stage_nodes[static_cast<int>(Stage::Scale)]; scaler != nullptr) {
+      ProtoHelperNodeContext helper_ctx(*scaler);
+      OpNodeProtoHelper<ProtoHelperNodeContext> helper(&helper_ctx);
+      fused_node.AddAttribute("offset", helper.GetAttrsOrDefault<float>("offset"));
+      fused_node.AddAttribute("scale", helper.GetAttrsOrDefault<float>("scale"));
+    }
+    if (const Node* normalizer = stage_nodes[static_cast<int>(Stage::Normalize)]; normalizer != nullptr) {
+      ProtoHelperNodeContext helper_ctx(*normalizer);
+      OpNodeProtoHelper<ProtoHelperNodeContext> helper(&helper_ctx);
+      fused_node.AddAttribute("norm", helper.GetAttrOrDefault<std::string>("norm", "MAX"));
+    }
+    fused_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, fused_node);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Fuse chains of the float ai.onnx.ml preprocessing operators Imputer -> Scaler -> Normalizer (any two or
+ * all three of them, in this order) into a single com.microsoft.FusedFeatureTransform node, which transforms each
+ * row in one pass instead of materializing a full tensor per operator.
+ */
+class FeatureTransformFusion : public GraphTransformer {
+ public:
+  FeatureTransformFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("FeatureTransformFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
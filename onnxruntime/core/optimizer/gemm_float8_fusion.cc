@@ -0,0 +1,212 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/gemm_float8_fusion.h"
+
+#include <string>
+
+#include "core/common/narrow.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloat8Type(int32_t elem_type) {
+  return elem_type == TensorProto_DataType_FLOAT8E4M3FN || elem_type == TensorProto_DataType_FLOAT8E5M2;
+}
+
+int32_t GetElemType(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() ? type->tensor_type().elem_type()
+                                                    : TensorProto_DataType_UNDEFINED;
+}
+
+// The scale must be a float with a single value, as cuBLASLt only supports per tensor scaling.
+bool IsPerTensorFloatScale(const NodeArg& scale) {
+  if (GetElemType(scale) != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+  const auto* shape = scale.Shape();
+  return shape != nullptr && (shape->dim_size() == 0 || (shape->dim_size() == 1 && shape->dim(0).has_dim_value() &&
+                                                         shape->dim(0).dim_value() == 1));
+}
+
+// A float 8 zero point is 0 if absent, or if each value is +0 or -0.
+bool HasZeroZeroPoint(const Graph& graph, const Node& node) {
+  const auto& inputs = node.InputDefs();
+  if (inputs.size() < 3 || !inputs[2]->Exists()) {
+    return true;
+  }
+
+  const TensorProto* zero_point = graph_utils::GetConstantInitializer(graph, inputs[2]->Name());
+  if (zero_point == nullptr) {
+    return false;
+  }
+
+  Initializer value{*zero_point, graph.ModelPath()};
+  for (const uint8_t byte : value.DataAsByteSpan()) {
+    if ((byte & 0x7F) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool HasNoBlocks(const Node& node) {
+  const auto* block_size = graph_utils::GetNodeAttribute(node, "block_size");
+  return block_size == nullptr || block_size->i() == 0;
+}
+
+// DequantizeLinear from float 8 to float, consumed only by the MatMul.
+bool IsFloat8Dequantize(const Graph& graph, const Node& node, const InlinedHashSet<std::string_view>& providers,
+                        int32_t& elem_type) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "DequantizeLinear", {19, 21}) ||
+      !graph_utils::IsSupportedProvider(node, providers) || !optimizer_utils::CheckOutputEdges(graph, node, 1)) {
+    return false;
+  }
+
+  elem_type = GetElemType(*node.InputDefs()[0]);
+  return IsFloat8Type(elem_type) && IsPerTensorFloatScale(*node.InputDefs()[1]) && HasZeroZeroPoint(graph, node) &&
+         HasNoBlocks(node);
+}
+
+// QuantizeLinear from float to float 8 with a constant scale and saturation, which cuBLASLt applies.
+bool IsFloat8Quantize(const Graph& graph, const Node& node, const InlinedHashSet<std::string_view>& providers,
+                      int32_t& elem_type, float& scale) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "QuantizeLinear", {19, 21}) ||
+      !graph_utils::IsSupportedProvider(node, providers) || node.OutputDefs().size() != 1) {
+    return false;
+  }
+
+  elem_type = GetElemType(*node.OutputDefs()[0]);
+  const auto* saturate = graph_utils::GetNodeAttribute(node, "saturate");
+  if (!IsFloat8Type(elem_type) || (saturate != nullptr && saturate->i() == 0) ||
+      !IsPerTensorFloatScale(*node.InputDefs()[1]) || !HasZeroZeroPoint(graph, node) || !HasNoBlocks(node)) {
+    return false;
+  }
+
+  const TensorProto* scale_proto = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+  if (scale_proto == nullptr) {
+    return false;
+  }
+  Initializer scale_value{*scale_proto, graph.ModelPath()};
+  scale = *scale_value.data<float>();
+  return scale != 0.0f;
+}
+
+}  // namespace
+
+Status GemmFloat8Fusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                   const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (!p_node) continue;
+
+    Node& matmul = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(matmul, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(matmul, "MatMul", {1, 9, 13}) ||
+        !graph_utils::IsSupportedProvider(matmul, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const Node* dq_a = graph_utils::GetInputNode(matmul, 0);
+    const Node* dq_b = graph_utils::GetInputNode(matmul, 1);
+    int32_t type_a = TensorProto_DataType_UNDEFINED;
+    int32_t type_b = TensorProto_DataType_UNDEFINED;
+    if (dq_a == nullptr || dq_b == nullptr || dq_a == dq_b ||
+        !IsFloat8Dequantize(graph, *dq_a, GetCompatibleExecutionProviders(), type_a) ||
+        !IsFloat8Dequantize(graph, *dq_b, GetCompatibleExecutionProviders(), type_b) ||
+        // cuBLASLt has no kernel for two float8e5m2 inputs
+        (type_a == TensorProto_DataType_FLOAT8E5M2 && type_b == TensorProto_DataType_FLOAT8E5M2)) {
+      continue;
+    }
+
+    const auto* shape_a = dq_a->InputDefs()[0]->Shape();
+    const TensorProto* b_proto = graph_utils::GetConstantInitializer(graph, dq_b->InputDefs()[0]->Name());
+    if (shape_a == nullptr || shape_a->dim_size() != 2 || b_proto == nullptr || b_proto->dims_size() != 2) {
+      continue;
+    }
+
+    Node* quantize = nullptr;
+    int32_t type_y = TensorProto_DataType_FLOAT;
+    float scale_y = 1.0f;
+    if (optimizer_utils::CheckOutputEdges(graph, matmul, 1)) {
+      Node& next = *graph.GetNode(matmul.OutputNodesBegin()->Index());
+      if (IsFloat8Quantize(graph, next, GetCompatibleExecutionProviders(), type_y, scale_y)) {
+        quantize = &next;
+      } else {
+        type_y = TensorProto_DataType_FLOAT;
+      }
+    }
+
+    // cuBLASLt requires B^T for float 8, so B is transposed once here
+    Initializer b{*b_proto, graph.ModelPath()};
+    const int64_t K = b.dims()[0];
+    const int64_t N = b.dims()[1];
+    const auto b_bytes = b.DataAsByteSpan();
+    std::string b_transposed(b_bytes.size(), '\0');
+    for (int64_t k = 0; k < K; ++k) {
+      for (int64_t n = 0; n < N; ++n) {
+        b_transposed[narrow<size_t>(n * K + k)] = static_cast<char>(b_bytes[narrow<size_t>(k * N + n)]);
+      }
+    }
+
+    TensorProto b_transposed_proto;
+    b_transposed_proto.set_name(graph.GenerateNodeArgName(b_proto->name() + "_transposed"));
+    b_transposed_proto.set_data_type(type_b);
+    b_transposed_proto.add_dims(N);
+    b_transposed_proto.add_dims(K);
+    utils::SetRawDataInTensorProto(b_transposed_proto, std::move(b_transposed));
+    NodeArg& b_transposed_arg = graph_utils::AddInitializer(graph, b_transposed_proto);
+
+    NodeArg& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+    auto& dq_a_inputs = graph.GetNode(dq_a->Index())->MutableInputDefs();
+    auto& dq_b_inputs = graph.GetNode(dq_b->Index())->MutableInputDefs();
+    InlinedVector<NodeArg*> inputs{dq_a_inputs[0], &b_transposed_arg, &empty_arg, dq_a_inputs[1], dq_b_inputs[1]};
+    if (quantize != nullptr) {
+      // cuBLASLt multiplies the result by the scale of D, QuantizeLinear divides it by its scale
+      TensorProto scale_y_proto;
+      scale_y_proto.set_name(graph.GenerateNodeArgName(quantize->Name() + "_scale_reciprocal"));
+      scale_y_proto.set_data_type(TensorProto_DataType_FLOAT);
+      scale_y_proto.add_float_data(1.0f / scale_y);
+      inputs.push_back(&graph_utils::AddInitializer(graph, scale_y_proto));
+    }
+
+    Node& last_node = quantize != nullptr ? *quantize : matmul;
+    Node& gemm = graph.AddNode(graph.GenerateNodeName(matmul.Name() + "/GemmFloat8Fusion/"), "GemmFloat8",
+                               "fused float 8 DequantizeLinear, MatMul and QuantizeLinear", inputs,
+                               {last_node.MutableOutputDefs()[0]}, nullptr, kMSDomain);
+    gemm.AddAttribute("transA", static_cast<int64_t>(0));
+    gemm.AddAttribute("transB", static_cast<int64_t>(1));
+    gemm.AddAttribute("dtype", static_cast<int64_t>(type_y));
+    gemm.SetExecutionProviderType(matmul.GetExecutionProviderType());
+
+    graph_utils::ReplaceDownstreamNodeInput(graph, last_node, 0, gemm, 0);
+    InlinedVector<NodeIndex> nodes_to_remove{dq_a->Index(), dq_b->Index(), matmul.Index()};
+    if (quantize != nullptr) {
+      nodes_to_remove.push_back(quantize->Index());
+    }
+    for (NodeIndex index : nodes_to_remove) {
+      Node& node = *graph.GetNode(index);
+      graph_utils::RemoveNodeOutputEdges(graph, node);
+      graph.RemoveNode(index);
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Fuse MatMul between two float 8 DequantizeLinear nodes, and the float 8 QuantizeLinear node following it
+ * if any, into com.microsoft.GemmFloat8, which runs the product on the float 8 tensor cores with cuBLASLt.
+ *
+ *   DQ(A_f8, scale_a) -> MatMul <- DQ(B_f8, scale_b)   =>   GemmFloat8(A_f8, B_f8^T, scaleA, scaleB)
+ *   ... -> MatMul -> Q(scale_y) -> Y_f8                =>   GemmFloat8(..., scaleY = 1 / scale_y) -> Y_f8
+ *
+ * The scales must be per tensor and the zero points 0. A must be 2D and B a constant 2D initializer, which is
+ * transposed once as cuBLASLt requires B^T for float 8. The float 8 tensor cores need compute capability 8.9 or
+ * higher, which the optimizer can't check, so the fusion has to be enabled explicitly.
+ */
+class GemmFloat8Fusion : public GraphTransformer {
+ public:
+  GemmFloat8Fusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GemmFloat8Fusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
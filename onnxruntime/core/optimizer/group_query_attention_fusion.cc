@@ -0,0 +1,747 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/group_query_attention_fusion.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/narrow.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+constexpr const char* kAttentionMaskName = "attention_mask";
+
+// the mask subgraph is searched up to this number of nodes
+constexpr size_t kMaxMaskNodes = 256;
+
+bool IsOp(const Node* node, std::string_view op_type,
+          std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion> versions) {
+  return node != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*node, op_type, versions);
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr && attr->has_i() ? attr->i() : default_value;
+}
+
+bool IsAxis(const Node& node, int64_t expected_axis, int64_t rank) {
+  const int64_t axis = GetIntAttribute(node, "axis", 0);
+  return axis == expected_axis || axis == expected_axis - rank;
+}
+
+// the only node consuming the output of node, if the output is not a graph output
+const Node* GetOnlyConsumer(const Graph& graph, const Node& node) {
+  return optimizer_utils::CheckOutputEdges(graph, node, 1) ? &*node.OutputNodesBegin() : nullptr;
+}
+
+bool GetScalarValue(const Graph& graph, const NodeArg& arg, float& value) {
+  const TensorProto* tensor = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (tensor == nullptr || !optimizer_utils::IsScalar(arg)) {
+    return false;
+  }
+
+  Initializer initializer{*tensor, graph.ModelPath()};
+  if (tensor->data_type() == TensorProto::FLOAT) {
+    value = *initializer.data<float>();
+  } else if (tensor->data_type() == TensorProto::FLOAT16) {
+    value = initializer.data<MLFloat16>()->ToFloat();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+bool GetIntValues(const Graph& graph, const NodeArg& arg, InlinedVector<int64_t>& values) {
+  values.clear();
+  return arg.Exists() && optimizer_utils::AppendTensorFromInitializer(graph, arg, values);
+}
+
+// The (num_heads, head_size) of a (batch_size, sequence_length, num_heads, head_size) tensor.
+bool GetHeads(const NodeArg& bsnh, int64_t& num_heads, int64_t& head_size) {
+  const auto* shape = bsnh.Shape();
+  if (shape == nullptr || shape->dim_size() != 4 || !shape->dim(2).has_dim_value() ||
+      !shape->dim(3).has_dim_value()) {
+    return false;
+  }
+
+  num_heads = shape->dim(2).dim_value();
+  head_size = shape->dim(3).dim_value();
+  return num_heads > 0 && head_size > 0;
+}
+
+// The (batch_size, sequence_length, num_heads, head_size) input of the Transpose to BNSH producing bnsh.
+const NodeArg* GetBsnhInput(const Graph& graph, const NodeArg& bnsh, InlinedVector<NodeIndex>& nodes) {
+  const Node* transpose = graph.GetProducerNode(bnsh.Name());
+  if (!IsOp(transpose, "Transpose", {1, 13, 21}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(*transpose, "perm", {0, 2, 1, 3})) {
+    return nullptr;
+  }
+
+  nodes.push_back(transpose->Index());
+  return transpose->InputDefs()[0];
+}
+
+// Whether slice takes [start, end) of the last axis of a 4-D tensor.
+bool IsLastAxisSlice(const Graph& graph, const Node& slice, int64_t start, int64_t min_end, int64_t max_end) {
+  InlinedVector<int64_t> starts, ends, axes, steps;
+  const auto& inputs = slice.InputDefs();
+  if (!GetIntValues(graph, *inputs[1], starts) || !GetIntValues(graph, *inputs[2], ends) ||
+      inputs.size() < 4 || !GetIntValues(graph, *inputs[3], axes) ||
+      (inputs.size() > 4 && inputs[4]->Exists() &&
+       (!GetIntValues(graph, *inputs[4], steps) || steps != InlinedVector<int64_t>{1}))) {
+    return false;
+  }
+
+  return starts.size() == 1 && ends.size() == 1 && axes.size() == 1 && (axes[0] == 3 || axes[0] == -1) &&
+         starts[0] == start && ends[0] >= min_end && ends[0] <= max_end;
+}
+
+// The constant (max_position, head_size) table that cos or sin are gathered from by position:
+// Gather(table, position_ids) -> [Unsqueeze] -> [Cast], where the table may be sliced from the start.
+const TensorProto* GetRotaryTable(const Graph& graph, const NodeArg& arg, int64_t head_size,
+                                  InlinedVector<NodeIndex>& nodes) {
+  const Node* node = graph.GetProducerNode(arg.Name());
+  while (IsOp(node, "Unsqueeze", {13, 21}) || IsOp(node, "Cast", {6, 9, 13, 19, 21})) {
+    nodes.push_back(node->Index());
+    node = graph.GetProducerNode(node->InputDefs()[0]->Name());
+  }
+
+  if (!IsOp(node, "Gather", {1, 11, 13}) || GetIntAttribute(*node, "axis", 0) != 0) {
+    return nullptr;
+  }
+  nodes.push_back(node->Index());
+
+  const NodeArg* table_arg = node->InputDefs()[0];
+  const Node* slice = graph.GetProducerNode(table_arg->Name());
+  if (IsOp(slice, "Slice", {10, 11, 13})) {
+    InlinedVector<int64_t> starts;
+    if (!GetIntValues(graph, *slice->InputDefs()[1], starts) ||
+        std::any_of(starts.begin(), starts.end(), [](int64_t start) { return start != 0; })) {
+      return nullptr;
+    }
+    nodes.push_back(slice->Index());
+    table_arg = slice->InputDefs()[0];
+  }
+
+  const TensorProto* table = graph_utils::GetConstantInitializer(graph, table_arg->Name());
+  if (table == nullptr || table->dims_size() != 2 || table->dims(1) != head_size ||
+      (table->data_type() != TensorProto::FLOAT && table->data_type() != TensorProto::FLOAT16)) {
+    return nullptr;
+  }
+  return table;
+}
+
+struct Rotary {
+  // the BNSH tensor before the rotary embedding
+  const NodeArg* input{nullptr};
+  const TensorProto* cos_table{nullptr};
+  const TensorProto* sin_table{nullptr};
+};
+
+// Matches output = x * cos + rotate_half(x) * sin, rotate_half(x) = Concat(-x[..., H/2:], x[..., :H/2]).
+std::optional<Rotary> MatchRotary(const Graph& graph, const NodeArg& output, InlinedVector<NodeIndex>& nodes) {
+  const Node* add = graph.GetProducerNode(output.Name());
+  if (!IsOp(add, "Add", {7, 13, 14})) {
+    return std::nullopt;
+  }
+
+  const Node* muls[2] = {graph.GetProducerNode(add->InputDefs()[0]->Name()),
+                         graph.GetProducerNode(add->InputDefs()[1]->Name())};
+  if (!IsOp(muls[0], "Mul", {7, 13, 14}) || !IsOp(muls[1], "Mul", {7, 13, 14})) {
+    return std::nullopt;
+  }
+
+  for (int sin_index : {0, 1}) {
+    const Node& cos_mul = *muls[1 - sin_index];
+    const Node& sin_mul = *muls[sin_index];
+    for (int concat_input : {0, 1}) {
+      const Node* concat = graph.GetProducerNode(sin_mul.InputDefs()[concat_input]->Name());
+      if (!IsOp(concat, "Concat", {4, 11, 13}) || concat->InputDefs().size() != 2 || !IsAxis(*concat, 3, 4)) {
+        continue;
+      }
+
+      const Node* neg = graph.GetProducerNode(concat->InputDefs()[0]->Name());
+      const Node* low_half = graph.GetProducerNode(concat->InputDefs()[1]->Name());
+      const Node* high_half = neg != nullptr ? graph.GetProducerNode(neg->InputDefs()[0]->Name()) : nullptr;
+      if (!IsOp(neg, "Neg", {6, 13}) || !IsOp(low_half, "Slice", {10, 11, 13}) ||
+          !IsOp(high_half, "Slice", {10, 11, 13}) || low_half->InputDefs()[0] != high_half->InputDefs()[0]) {
+        continue;
+      }
+
+      const NodeArg* x = low_half->InputDefs()[0];
+      const NodeArg* cos = cos_mul.InputDefs()[0] == x   ? cos_mul.InputDefs()[1]
+                           : cos_mul.InputDefs()[1] == x ? cos_mul.InputDefs()[0]
+                                                         : nullptr;
+      const auto* shape = x->Shape();
+      if (cos == nullptr || shape == nullptr || shape->dim_size() != 4 || !shape->dim(3).has_dim_value() ||
+          shape->dim(3).dim_value() % 2 != 0) {
+        continue;
+      }
+
+      const int64_t head_size = shape->dim(3).dim_value();
+      const int64_t half = head_size / 2;
+      if (!IsLastAxisSlice(graph, *low_half, 0, half, half) ||
+          !IsLastAxisSlice(graph, *high_half, half, head_size, std::numeric_limits<int64_t>::max())) {
+        continue;
+      }
+
+      InlinedVector<NodeIndex> rotary_nodes{add->Index(), cos_mul.Index(), sin_mul.Index(), concat->Index(),
+                                            neg->Index(), low_half->Index(), high_half->Index()};
+      Rotary rotary;
+      rotary.input = x;
+      rotary.cos_table = GetRotaryTable(graph, *cos, head_size, rotary_nodes);
+      rotary.sin_table = GetRotaryTable(graph, *sin_mul.InputDefs()[1 - concat_input], head_size, rotary_nodes);
+      if (rotary.cos_table == nullptr || rotary.sin_table == nullptr) {
+        return std::nullopt;
+      }
+
+      nodes.insert(nodes.end(), rotary_nodes.begin(), rotary_nodes.end());
+      return rotary;
+    }
+  }
+
+  return std::nullopt;
+}
+
+// Skips the Unsqueeze(axis 2) -> Expand -> Reshape that repeat each key or value head for a group of query heads.
+const NodeArg* SkipRepeatKv(const Graph& graph, const NodeArg& arg, InlinedVector<NodeIndex>& nodes) {
+  const Node* reshape = graph.GetProducerNode(arg.Name());
+  const Node* expand = reshape != nullptr ? graph.GetProducerNode(reshape->InputDefs()[0]->Name()) : nullptr;
+  const Node* unsqueeze = expand != nullptr ? graph.GetProducerNode(expand->InputDefs()[0]->Name()) : nullptr;
+  InlinedVector<int64_t> axes;
+  if (!IsOp(reshape, "Reshape", {5, 13, 14, 19, 21}) || !IsOp(expand, "Expand", {8, 13}) ||
+      !IsOp(unsqueeze, "Unsqueeze", {13, 21}) || !GetIntValues(graph, *unsqueeze->InputDefs()[1], axes) ||
+      axes != InlinedVector<int64_t>{2}) {
+    return &arg;
+  }
+
+  nodes.insert(nodes.end(), {reshape->Index(), expand->Index(), unsqueeze->Index()});
+  return unsqueeze->InputDefs()[0];
+}
+
+// Skips the Concat of a past key or value graph input with the new ones along the sequence axis.
+const NodeArg* SkipPastConcat(const Graph& graph, const NodeArg& arg, const Node*& concat) {
+  concat = graph.GetProducerNode(arg.Name());
+  if (!IsOp(concat, "Concat", {4, 11, 13}) || concat->InputDefs().size() != 2 || !IsAxis(*concat, 2, 4) ||
+      !graph.IsInputsIncludingInitializers(concat->InputDefs()[0]) ||
+      graph_utils::IsInitializer(graph, concat->InputDefs()[0]->Name(), true)) {
+    concat = nullptr;
+    return &arg;
+  }
+
+  return concat->InputDefs()[1];
+}
+
+bool FeedsComparison(const Graph& graph, const Node& node, int depth) {
+  for (auto it = node.OutputNodesBegin(); it != node.OutputNodesEnd(); ++it) {
+    const Node& consumer = *it;
+    if (IsOp(&consumer, "Greater", {7, 9, 13}) || IsOp(&consumer, "Less", {7, 9, 13}) ||
+        IsOp(&consumer, "GreaterOrEqual", {12, 16}) || IsOp(&consumer, "LessOrEqual", {12, 16})) {
+      return true;
+    }
+    if (depth > 0 && (IsOp(&consumer, "Unsqueeze", {13, 21}) || IsOp(&consumer, "Reshape", {5, 13, 14, 19, 21}) ||
+                      IsOp(&consumer, "Cast", {6, 9, 13, 19, 21})) &&
+        FeedsComparison(graph, consumer, depth - 1)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The analysis of an additive attention mask.
+struct MaskInfo {
+  // the number of keys each query attends to if the mask is a sliding window, or -1. Not set if it is not causal.
+  std::optional<int64_t> window;
+  // the nodes computing the mask
+  InlinedVector<NodeIndex> nodes;
+};
+
+// The mask is causal if it is computed with Trilu or by comparing positions.
+MaskInfo AnalyzeMask(const Graph& graph, const NodeArg& mask) {
+  MaskInfo info;
+  bool is_causal = false;
+  InlinedHashSet<int64_t> windows;
+  InlinedHashSet<NodeIndex> visited;
+  std::deque<const Node*> queue;
+  if (const Node* producer = graph.GetProducerNode(mask.Name())) {
+    queue.push_back(producer);
+  }
+
+  while (!queue.empty() && visited.size() < kMaxMaskNodes) {
+    const Node* node = queue.front();
+    queue.pop_front();
+    if (!visited.insert(node->Index()).second) {
+      continue;
+    }
+    info.nodes.push_back(node->Index());
+
+    InlinedVector<int64_t> values;
+    if (IsOp(node, "Trilu", {14})) {
+      is_causal = true;
+      // tril(x, -W) marks the keys at least W positions behind the query
+      if (GetIntAttribute(*node, "upper", 1) == 0 && node->InputDefs().size() > 1 &&
+          GetIntValues(graph, *node->InputDefs()[1], values) && values.size() == 1 && values[0] < 0) {
+        windows.insert(-values[0]);
+      }
+    } else if (IsOp(node, "Greater", {7, 9, 13}) || IsOp(node, "Less", {7, 9, 13}) ||
+               IsOp(node, "GreaterOrEqual", {12, 16}) || IsOp(node, "LessOrEqual", {12, 16})) {
+      is_causal = true;
+    } else if (IsOp(node, "Sub", {7, 13, 14}) && optimizer_utils::IsScalar(*node->InputDefs()[1]) &&
+               GetIntValues(graph, *node->InputDefs()[1], values) && values.size() == 1 && values[0] > 1 &&
+               FeedsComparison(graph, *node, 2)) {
+      // position - W compared with the key positions
+      windows.insert(values[0]);
+    }
+
+    for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+      queue.push_back(&*it);
+    }
+  }
+
+  if (is_causal && windows.size() <= 1) {
+    info.window = windows.empty() ? -1 : *windows.begin();
+  }
+  return info;
+}
+
+// The attention_mask input of the graph, a (batch_size, total_sequence_length) int32 or int64 tensor.
+const NodeArg* GetAttentionMask(const Graph& graph) {
+  for (const NodeArg* input : graph.GetInputs()) {
+    const auto* type = input->TypeAsProto();
+    if (input->Name() == kAttentionMaskName && type != nullptr && type->has_tensor_type() &&
+        (type->tensor_type().elem_type() == TensorProto::INT64 ||
+         type->tensor_type().elem_type() == TensorProto::INT32) &&
+        input->Shape() != nullptr && input->Shape()->dim_size() == 2) {
+      return input;
+    }
+  }
+  return nullptr;
+}
+
+NodeArg& AddConstant(Graph& graph, const std::string& base_name, int32_t data_type, const void* data,
+                        size_t size_in_bytes, std::initializer_list<int64_t> dims) {
+  TensorProto tensor;
+  tensor.set_name(graph.GenerateNodeArgName(base_name));
+  tensor.set_data_type(data_type);
+  for (int64_t dim : dims) {
+    tensor.add_dims(dim);
+  }
+  utils::SetRawDataInTensorProto(tensor, data, size_in_bytes);
+  return graph_utils::AddInitializer(graph, tensor);
+}
+
+NodeArg& AddTensorArg(Graph& graph, const std::string& base_name, int32_t elem_type) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(base_name), &type);
+}
+
+// Adds the edge from the node producing arg, if arg is produced by a node that existed before this transformer.
+void AddInputEdge(Graph& graph, const NodeArg& arg, const Node& node, int input_index) {
+  if (const Node* producer = graph.GetProducerNode(arg.Name())) {
+    graph.AddEdge(producer->Index(), node.Index(), optimizer_utils::IndexOfNodeOutput(*producer, arg), input_index);
+  }
+}
+
+// The (max_position, head_size / 2) cos or sin cache of GroupQueryAttention, from a (max_position, head_size) table
+// repeating the frequencies in both halves.
+std::optional<TensorProto> MakeRotaryCache(const Graph& graph, const TensorProto& table, int32_t elem_type) {
+  Initializer initializer{table, graph.ModelPath()};
+  const int64_t max_position = table.dims(0);
+  const int64_t half = table.dims(1) / 2;
+  std::vector<float> values(initializer.size());
+  if (table.data_type() == TensorProto::FLOAT) {
+    std::copy_n(initializer.data<float>(), values.size(), values.begin());
+  } else {
+    const MLFloat16* data = initializer.data<MLFloat16>();
+    std::transform(data, data + values.size(), values.begin(), [](MLFloat16 value) { return value.ToFloat(); });
+  }
+
+  TensorProto cache;
+  cache.set_name(graph.GenerateNodeArgName(table.name() + "_half"));
+  cache.set_data_type(elem_type);
+  cache.add_dims(max_position);
+  cache.add_dims(half);
+  std::vector<float> cache_values;
+  cache_values.reserve(narrow<size_t>(max_position * half));
+  for (int64_t p = 0; p < max_position; ++p) {
+    const float* row = values.data() + p * half * 2;
+    if (!std::equal(row, row + half, row + half)) {
+      return std::nullopt;
+    }
+    cache_values.insert(cache_values.end(), row, row + half);
+  }
+
+  if (elem_type == TensorProto::FLOAT) {
+    utils::SetRawDataInTensorProto(cache, cache_values.data(), cache_values.size() * sizeof(float));
+  } else {
+    std::vector<MLFloat16> half_values(cache_values.begin(), cache_values.end());
+    utils::SetRawDataInTensorProto(cache, half_values.data(), half_values.size() * sizeof(MLFloat16));
+  }
+  return cache;
+}
+
+// A matched attention subgraph.
+struct AttentionMatch {
+  const NodeArg* query{nullptr};  // BSNH
+  const NodeArg* key{nullptr};
+  const NodeArg* value{nullptr};
+  const Node* key_concat{nullptr};
+  const Node* value_concat{nullptr};
+  const Node* output_reshape{nullptr};
+  std::optional<Rotary> rotary;
+  float scale{1.0f};
+  int64_t num_heads{0};
+  int64_t kv_num_heads{0};
+  int64_t head_size{0};
+  int64_t window{-1};
+  // the nodes that are removed when they are no longer used
+  InlinedVector<NodeIndex> nodes;
+};
+
+// Matches the attention subgraph around a Softmax. masks holds the analysis of the masks already seen.
+std::optional<AttentionMatch> MatchAttention(const Graph& graph, const Node& softmax,
+                                             InlinedHashMap<std::string, MaskInfo>& masks) {
+  AttentionMatch match;
+  auto& nodes = match.nodes;
+  nodes.push_back(softmax.Index());
+  if (GetIntAttribute(softmax, "axis", -1) != -1 && GetIntAttribute(softmax, "axis", -1) != 3) {
+    return std::nullopt;
+  }
+
+  // fp16 graphs compute the softmax in float
+  const Node* add = graph.GetProducerNode(softmax.InputDefs()[0]->Name());
+  if (IsOp(add, "Cast", {6, 9, 13, 19, 21})) {
+    nodes.push_back(add->Index());
+    add = graph.GetProducerNode(add->InputDefs()[0]->Name());
+  }
+  if (!IsOp(add, "Add", {7, 13, 14})) {
+    return std::nullopt;
+  }
+  nodes.push_back(add->Index());
+
+  // scores = MatMul(q, k^T) [* scale], and the other input of the Add is the mask
+  const Node* qk = nullptr;
+  const NodeArg* mask = nullptr;
+  for (int scores_input : {0, 1}) {
+    const Node* node = graph.GetProducerNode(add->InputDefs()[scores_input]->Name());
+    float scale = 1.0f;
+    if ((IsOp(node, "Mul", {7, 13, 14}) || IsOp(node, "Div", {7, 13, 14})) &&
+        GetScalarValue(graph, *node->InputDefs()[1], scale) && scale != 0.0f) {
+      match.scale = node->OpType() == "Mul" ? scale : 1.0f / scale;
+      nodes.push_back(node->Index());
+      node = graph.GetProducerNode(node->InputDefs()[0]->Name());
+    }
+    if (IsOp(node, "MatMul", {1, 9, 13})) {
+      qk = node;
+      mask = add->InputDefs()[1 - scores_input];
+      break;
+    }
+  }
+  if (qk == nullptr) {
+    return std::nullopt;
+  }
+  nodes.push_back(qk->Index());
+
+  const Node* key_transpose = graph.GetProducerNode(qk->InputDefs()[1]->Name());
+  if (!IsOp(key_transpose, "Transpose", {1, 13, 21}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(*key_transpose, "perm", {0, 1, 3, 2})) {
+    return std::nullopt;
+  }
+  nodes.push_back(key_transpose->Index());
+
+  // probs -> [Cast] -> MatMul(probs, v) -> Transpose -> Reshape (B, S, N * H)
+  const Node* probs = &softmax;
+  const Node* pv = GetOnlyConsumer(graph, softmax);
+  if (IsOp(pv, "Cast", {6, 9, 13, 19, 21})) {
+    nodes.push_back(pv->Index());
+    probs = pv;
+    pv = GetOnlyConsumer(graph, *pv);
+  }
+  const Node* output_transpose = pv != nullptr ? GetOnlyConsumer(graph, *pv) : nullptr;
+  match.output_reshape = output_transpose != nullptr ? GetOnlyConsumer(graph, *output_transpose) : nullptr;
+  if (!IsOp(pv, "MatMul", {1, 9, 13}) || pv->InputDefs()[0] != probs->OutputDefs()[0] ||
+      !IsOp(output_transpose, "Transpose", {1, 13, 21}) ||
+      !optimizer_utils::IsAttributeWithExpectedValues(*output_transpose, "perm", {0, 2, 1, 3}) ||
+      !IsOp(match.output_reshape, "Reshape", {5, 13, 14, 19, 21}) ||
+      match.output_reshape->OutputDefs()[0]->Shape() == nullptr ||
+      match.output_reshape->OutputDefs()[0]->Shape()->dim_size() != 3) {
+    return std::nullopt;
+  }
+  nodes.insert(nodes.end(), {pv->Index(), output_transpose->Index()});
+
+  // query: Transpose -> [rotary]
+  const NodeArg* query_bnsh = qk->InputDefs()[0];
+  match.rotary = MatchRotary(graph, *query_bnsh, nodes);
+  match.query = GetBsnhInput(graph, match.rotary ? *match.rotary->input : *query_bnsh, nodes);
+
+  // key: Transpose -> [rotary] -> [Concat past_key] -> [repeat_kv]
+  const NodeArg* key_bnsh = SkipPastConcat(graph, *SkipRepeatKv(graph, *key_transpose->InputDefs()[0], nodes),
+                                           match.key_concat);
+  std::optional<Rotary> key_rotary = MatchRotary(graph, *key_bnsh, nodes);
+  match.key = GetBsnhInput(graph, key_rotary ? *key_rotary->input : *key_bnsh, nodes);
+
+  // value: Transpose -> [Concat past_value] -> [repeat_kv]
+  const NodeArg* value_bnsh = SkipPastConcat(graph, *SkipRepeatKv(graph, *pv->InputDefs()[1], nodes),
+                                             match.value_concat);
+  match.value = GetBsnhInput(graph, *value_bnsh, nodes);
+
+  if (match.query == nullptr || match.key == nullptr || match.value == nullptr ||
+      match.rotary.has_value() != key_rotary.has_value() ||
+      (match.rotary && (match.rotary->cos_table != key_rotary->cos_table ||
+                        match.rotary->sin_table != key_rotary->sin_table)) ||
+      (match.key_concat == nullptr) != (match.value_concat == nullptr)) {
+    return std::nullopt;
+  }
+
+  int64_t key_heads = 0, value_heads = 0, key_head_size = 0, value_head_size = 0;
+  if (!GetHeads(*match.query, match.num_heads, match.head_size) || !GetHeads(*match.key, key_heads, key_head_size) ||
+      !GetHeads(*match.value, value_heads, value_head_size) || key_heads != value_heads ||
+      key_head_size != match.head_size || value_head_size != match.head_size || match.num_heads % key_heads != 0) {
+    return std::nullopt;
+  }
+  match.kv_num_heads = key_heads;
+
+  const auto* elem_type = match.query->TypeAsProto();
+  if (elem_type == nullptr || (elem_type->tensor_type().elem_type() != TensorProto::FLOAT &&
+                               elem_type->tensor_type().elem_type() != TensorProto::FLOAT16)) {
+    return std::nullopt;
+  }
+
+  auto mask_info = masks.find(mask->Name());
+  if (mask_info == masks.end()) {
+    mask_info = masks.emplace(mask->Name(), AnalyzeMask(graph, *mask)).first;
+  }
+  const std::optional<int64_t>& window = mask_info->second.window;
+  if (!window.has_value()) {
+    return std::nullopt;
+  }
+  // GroupQueryAttention attends to local_window_size + 1 keys
+  match.window = *window > 0 ? *window - 1 : -1;
+
+  return match;
+}
+
+// Removes the output edges of a node, returning them to be added again from the node replacing it.
+std::vector<graph_utils::GraphEdge> TakeOutputEdges(Graph& graph, const Node& node) {
+  auto edges = graph_utils::GraphEdge::GetNodeOutputEdges(node);
+  graph_utils::GraphEdge::RemoveGraphEdges(graph, edges);
+  return edges;
+}
+
+// Removes the nodes that no longer have consumers, along with the nodes that only they consumed.
+void RemoveUnusedNodes(Graph& graph, const InlinedVector<NodeIndex>& nodes) {
+  for (bool removed = true; removed;) {
+    removed = false;
+    for (NodeIndex index : nodes) {
+      const Node* node = graph.GetNode(index);
+      if (node != nullptr && node->GetOutputEdgesCount() == 0 && !graph.NodeProducesGraphOutput(*node)) {
+        graph.RemoveNode(index);
+        removed = true;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+Status GroupQueryAttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  const auto onnx_version = domain_to_version.find(kOnnxDomain);
+  const NodeArg* attention_mask = GetAttentionMask(graph);
+  if (onnx_version == domain_to_version.end() || onnx_version->second < 13 || attention_mask == nullptr) {
+    return Status::OK();
+  }
+
+  InlinedHashMap<std::string, MaskInfo> masks;
+  InlinedHashMap<std::string, std::pair<NodeArg*, NodeArg*>> rotary_caches;
+  NodeArg* seqlens_k = nullptr;
+  NodeArg* total_sequence_length = nullptr;
+  Node* seqlens_k_node = nullptr;
+  Node* total_sequence_length_node = nullptr;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr) continue;  // Node was removed.
+
+    auto& softmax = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(softmax, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(softmax, "Softmax", {13}) ||
+        !graph_utils::IsSupportedProvider(softmax, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    auto match = MatchAttention(graph, softmax, masks);
+    if (!match) {
+      continue;
+    }
+
+    const std::string& provider = softmax.GetExecutionProviderType();
+    const int32_t elem_type = match->query->TypeAsProto()->tensor_type().elem_type();
+
+    // the cos and sin caches, which are shared by the layers
+    NodeArg* cos_cache = nullptr;
+    NodeArg* sin_cache = nullptr;
+    if (match->rotary) {
+      const std::string cache_key = match->rotary->cos_table->name() + "/" + match->rotary->sin_table->name();
+      auto cache = rotary_caches.find(cache_key);
+      if (cache == rotary_caches.end()) {
+        auto cos = MakeRotaryCache(graph, *match->rotary->cos_table, elem_type);
+        auto sin = MakeRotaryCache(graph, *match->rotary->sin_table, elem_type);
+        std::pair<NodeArg*, NodeArg*> args{nullptr, nullptr};
+        if (cos && sin) {
+          args = {&graph_utils::AddInitializer(graph, *cos), &graph_utils::AddInitializer(graph, *sin)};
+        }
+        cache = rotary_caches.emplace(cache_key, args).first;
+      }
+      std::tie(cos_cache, sin_cache) = cache->second;
+      if (cos_cache == nullptr) {
+        continue;
+      }
+    }
+
+    // seqlens_k = ReduceSum(attention_mask, 1) - 1 and total_sequence_length = attention_mask.shape[1], as int32
+    if (seqlens_k == nullptr) {
+      const int32_t mask_type = attention_mask->TypeAsProto()->tensor_type().elem_type();
+      const int64_t one_int64 = 1;
+      const int32_t one_int32 = 1;
+      NodeArg& one = mask_type == TensorProto::INT64
+                         ? AddConstant(graph, "one", mask_type, &one_int64, sizeof(one_int64), {})
+                         : AddConstant(graph, "one", mask_type, &one_int32, sizeof(one_int32), {});
+      NodeArg& axis = AddConstant(graph, "sequence_axis", TensorProto::INT64, &one_int64, sizeof(one_int64), {1});
+      NodeArg& index = AddConstant(graph, "sequence_index", TensorProto::INT64, &one_int64, sizeof(one_int64), {});
+      NodeArg& lengths = AddTensorArg(graph, "sequence_lengths", mask_type);
+      NodeArg& lengths_minus_one = AddTensorArg(graph, "sequence_lengths_minus_one", mask_type);
+      NodeArg& mask_shape = AddTensorArg(graph, "attention_mask_shape", TensorProto::INT64);
+      NodeArg& total_length = AddTensorArg(graph, "total_sequence_length_int64", TensorProto::INT64);
+      seqlens_k = &AddTensorArg(graph, "seqlens_k", TensorProto::INT32);
+      total_sequence_length = &AddTensorArg(graph, "total_sequence_length", TensorProto::INT32);
+
+      NodeArg* mask_arg = graph.GetNodeArg(attention_mask->Name());
+      Node& reduce_sum = graph.AddNode(graph.GenerateNodeName("SequenceLengths"), "ReduceSum",
+                                       "sequence lengths", {mask_arg, &axis}, {&lengths});
+      reduce_sum.AddAttribute("keepdims", static_cast<int64_t>(0));
+      Node& sub = graph.AddNode(graph.GenerateNodeName("SequenceLengthsMinusOne"), "Sub", "sequence lengths - 1",
+                                {&lengths, &one}, {&lengths_minus_one});
+      seqlens_k_node = &graph.AddNode(graph.GenerateNodeName("SeqlensK"), "Cast", "seqlens_k",
+                                      {&lengths_minus_one}, {seqlens_k});
+      seqlens_k_node->AddAttribute("to", static_cast<int64_t>(TensorProto::INT32));
+      Node& shape = graph.AddNode(graph.GenerateNodeName("AttentionMaskShape"), "Shape", "attention mask shape",
+                                  {mask_arg}, {&mask_shape});
+      Node& gather = graph.AddNode(graph.GenerateNodeName("TotalSequenceLength"), "Gather",
+                                   "total sequence length", {&mask_shape, &index}, {&total_length});
+      total_sequence_length_node = &graph.AddNode(graph.GenerateNodeName("TotalSequenceLengthInt32"), "Cast",
+                                                  "total sequence length", {&total_length}, {total_sequence_length});
+      total_sequence_length_node->AddAttribute("to", static_cast<int64_t>(TensorProto::INT32));
+
+      for (Node* node : {&reduce_sum, &sub, seqlens_k_node, &shape, &gather, total_sequence_length_node}) {
+        node->SetExecutionProviderType(provider);
+      }
+      graph.AddEdge(reduce_sum.Index(), sub.Index(), 0, 0);
+      graph.AddEdge(sub.Index(), seqlens_k_node->Index(), 0, 0);
+      graph.AddEdge(shape.Index(), gather.Index(), 0, 0);
+      graph.AddEdge(gather.Index(), total_sequence_length_node->Index(), 0, 0);
+    }
+
+    // (B, S, num_heads, H) -> (B, S, num_heads * H)
+    auto add_reshape = [&](const NodeArg& bsnh, int64_t num_heads) -> Node& {
+      const int64_t shape_values[] = {0, 0, num_heads * match->head_size};
+      NodeArg& shape = AddConstant(graph, "bsh_shape", TensorProto::INT64, shape_values, sizeof(shape_values), {3});
+      NodeArg& output = AddTensorArg(graph, bsnh.Name() + "_bsh", elem_type);
+      Node& reshape = graph.AddNode(graph.GenerateNodeName("GroupQueryAttentionReshape"), "Reshape",
+                                    "BSNH to BSH", {graph.GetNodeArg(bsnh.Name()), &shape}, {&output});
+      reshape.SetExecutionProviderType(provider);
+      AddInputEdge(graph, bsnh, reshape, 0);
+      return reshape;
+    };
+    Node& query = add_reshape(*match->query, match->num_heads);
+    Node& key = add_reshape(*match->key, match->kv_num_heads);
+    Node& value = add_reshape(*match->value, match->kv_num_heads);
+
+    // the GroupQueryAttention replaces the output Reshape and the past Concats, which produce its outputs
+    NodeArg* output = graph.GetNodeArg(match->output_reshape->OutputDefs()[0]->Name());
+    NodeArg* present_key = match->key_concat != nullptr
+                               ? graph.GetNodeArg(match->key_concat->OutputDefs()[0]->Name())
+                               : &AddTensorArg(graph, "present_key", elem_type);
+    NodeArg* present_value = match->value_concat != nullptr
+                                 ? graph.GetNodeArg(match->value_concat->OutputDefs()[0]->Name())
+                                 : &AddTensorArg(graph, "present_value", elem_type);
+    NodeArg& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+    NodeArg* past_key = match->key_concat != nullptr ? graph.GetNodeArg(match->key_concat->InputDefs()[0]->Name())
+                                                     : &empty_arg;
+    NodeArg* past_value = match->value_concat != nullptr
+                              ? graph.GetNodeArg(match->value_concat->InputDefs()[0]->Name())
+                              : &empty_arg;
+
+    std::vector<graph_utils::GraphEdge> output_edges[3];
+    const Node* replaced[3] = {match->output_reshape, match->key_concat, match->value_concat};
+    for (int i = 0; i < 3; ++i) {
+      if (replaced[i] != nullptr) {
+        output_edges[i] = TakeOutputEdges(graph, *replaced[i]);
+        graph.RemoveNode(replaced[i]->Index());
+      }
+    }
+
+    InlinedVector<NodeArg*> inputs{query.MutableOutputDefs()[0], key.MutableOutputDefs()[0],
+                                   value.MutableOutputDefs()[0], past_key, past_value, seqlens_k,
+                                   total_sequence_length};
+    if (match->rotary) {
+      inputs.push_back(cos_cache);
+      inputs.push_back(sin_cache);
+    }
+    Node& gqa = graph.AddNode(graph.GenerateNodeName("GroupQueryAttention"), "GroupQueryAttention",
+                              "Fused decoder attention", inputs, {output, present_key, present_value}, nullptr,
+                              kMSDomain);
+    gqa.AddAttribute("num_heads", match->num_heads);
+    gqa.AddAttribute("kv_num_heads", match->kv_num_heads);
+    gqa.AddAttribute("scale", match->scale);
+    gqa.AddAttribute("local_window_size", match->window);
+    gqa.AddAttribute("do_rotary", static_cast<int64_t>(match->rotary ? 1 : 0));
+    gqa.AddAttribute("rotary_interleaved", static_cast<int64_t>(0));
+    gqa.SetExecutionProviderType(provider);
+
+    graph.AddEdge(query.Index(), gqa.Index(), 0, 0);
+    graph.AddEdge(key.Index(), gqa.Index(), 0, 1);
+    graph.AddEdge(value.Index(), gqa.Index(), 0, 2);
+    graph.AddEdge(seqlens_k_node->Index(), gqa.Index(), 0, 5);
+    graph.AddEdge(total_sequence_length_node->Index(), gqa.Index(), 0, 6);
+    for (int i = 0; i < 3; ++i) {
+      for (const auto& edge : output_edges[i]) {
+        graph.AddEdge(gqa.Index(), edge.dst_node, i, edge.dst_arg_index);
+      }
+    }
+
+    RemoveUnusedNodes(graph, match->nodes);
+
+    LOGS(logger, INFO) << "Fused the attention of " << output->Name() << " into GroupQueryAttention";
+    modified = true;
+  }
+
+  // the masks are shared by the layers, so they are unused once all of them are fused
+  for (const auto& mask : masks) {
+    RemoveUnusedNodes(graph, mask.second.nodes);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
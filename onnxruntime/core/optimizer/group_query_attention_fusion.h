@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GroupQueryAttentionFusion
+
+Fuse the decoder attention subgraphs of models exported from PyTorch into GroupQueryAttention:
+
+  q (B, S, N, H) -> Transpose -> [rotary] ---------------------------------------------> MatMul -> [Mul|Div scale]
+  k (B, S, Nkv, H) -> Transpose -> [rotary] -> [Concat past_key] -> [repeat_kv] -> Transpose ^        |
+                                                                                          Add causal mask
+                                                                                                     |
+  v (B, S, Nkv, H) -> Transpose -----------> [Concat past_value] -> [repeat_kv] -> MatMul <- Softmax
+                                                                                     |
+                                                                       Transpose -> Reshape (B, S, N * H)
+
+The rotary embedding is x * cos + rotate_half(x) * sin with cos and sin gathered from constant tables, and repeat_kv
+is the Unsqueeze, Expand and Reshape that repeat the key and value heads for each group of query heads. The inputs of
+the first Transposes are matched as they are, so a normalization of the query and key heads before the rotary
+embedding (QK-norm) stays in the graph. The mask must be computed with Trilu or a comparison, which marks it as causal,
+and a sliding window is recognized from a Trilu below the diagonal or a position minus a constant window.
+
+GroupQueryAttention computes the sequence lengths and the rotary positions from the attention_mask input of the
+graph, assuming that the sequences are padded on the right, which is also what the exported positions mean when there
+is no padding.
+*/
+class GroupQueryAttentionFusion : public GraphTransformer {
+ public:
+  GroupQueryAttentionFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GroupQueryAttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
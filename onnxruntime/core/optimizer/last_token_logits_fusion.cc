@@ -0,0 +1,239 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/last_token_logits_fusion.h"
+
+#include <initializer_list>
+#include <limits>
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsLastAxisNormalization(const Node& node) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "LayerNormalization", {1, 17}) &&
+      !graph_utils::IsSupportedOptypeVersionAndDomain(node, "SimplifiedLayerNormalization", {1})) {
+    return false;
+  }
+
+  const auto* axis = graph_utils::GetNodeAttribute(node, "axis");
+  return axis == nullptr || (utils::HasInt(*axis) && (axis->i() == -1 || axis->i() == 2));
+}
+
+bool HasRank(const NodeArg& arg, int rank) {
+  return arg.Shape() != nullptr && arg.Shape()->dim_size() == rank;
+}
+
+// (batch_size, sequence_length, hidden_size) -> (batch_size, 1, hidden_size)
+void SetSequenceLengthToOne(NodeArg& arg) {
+  if (HasRank(arg, 3)) {
+    TensorShapeProto shape = *arg.Shape();
+    shape.mutable_dim(1)->set_dim_value(1);
+    arg.SetShape(shape);
+  }
+}
+
+NodeArg& AddInt64Initializer(Graph& graph, const std::string& base_name, std::initializer_list<int64_t> values,
+                             bool is_scalar) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(graph.GenerateNodeArgName(base_name));
+  tensor_proto.set_data_type(TensorProto_DataType_INT64);
+  if (!is_scalar) {
+    tensor_proto.add_dims(static_cast<int64_t>(values.size()));
+  }
+  for (int64_t value : values) {
+    tensor_proto.add_int64_data(value);
+  }
+  return graph_utils::AddInitializer(graph, tensor_proto);
+}
+
+NodeArg& AddInt64NodeArg(Graph& graph, const std::string& base_name) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(base_name), &type);
+}
+
+// The seqlens_k input of GroupQueryAttention: the total sequence length of each entry minus 1.
+NodeArg* FindSeqlensK(Graph& graph) {
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "GroupQueryAttention" && node.Domain() == kMSDomain && node.InputDefs().size() > 5 &&
+        node.InputDefs()[5]->Exists()) {
+      return node.MutableInputDefs()[5];
+    }
+  }
+
+  return nullptr;
+}
+
+// The node producing the logits from the normalized hidden states: MatMul, optionally followed by a bias Add.
+// Returns nullptr if the logits are not a graph output that only the caller of the session reads.
+Node* GetLogitsNode(Graph& graph, const Node& matmul) {
+  if (graph.NodeProducesGraphOutput(matmul)) {
+    return matmul.GetOutputEdgesCount() == 0 ? graph.GetNode(matmul.Index()) : nullptr;
+  }
+
+  if (matmul.GetOutputEdgesCount() != 1) {
+    return nullptr;
+  }
+
+  Node* add = graph.GetNode(matmul.OutputNodesBegin()->Index());
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(*add, "Add", {7, 13, 14}) ||
+      !graph.NodeProducesGraphOutput(*add) || add->GetOutputEdgesCount() != 0 ||
+      !graph_utils::IsConstantInitializer(graph, add->InputDefs()[1]->Name()) ||
+      !HasRank(*add->InputDefs()[1], 1)) {
+    return nullptr;
+  }
+
+  return add;
+}
+
+}  // namespace
+
+/**
+Gather the last valid token before the final normalization and lm_head MatMul of a decoder:
+
+  hidden (B, S, H) -> LayerNormalization -> MatMul -> [Add] -> logits (B, S, V)
+
+becomes
+
+  hidden (B, S, H) -> GatherND or Slice (B, 1, H) -> LayerNormalization -> MatMul -> [Add] -> logits (B, 1, V)
+
+The normalization is over the last axis, so it is the same for the gathered token.
+*/
+Status LastTokenLogitsFusion::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
+                                        const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  const auto onnx_version = domain_to_version.find(kOnnxDomain);
+  if (onnx_version == domain_to_version.end() || onnx_version->second < 13) {
+    return Status::OK();
+  }
+
+  for (auto node_index : order) {
+    Node* norm = graph.GetNode(node_index);
+    if (norm == nullptr) {
+      continue;
+    }
+
+    // The logits are outputs of the main graph, so subgraphs are not visited.
+    if (!IsLastAxisNormalization(*norm) ||
+        !graph_utils::IsSupportedProvider(*norm, GetCompatibleExecutionProviders()) ||
+        graph.NodeProducesGraphOutput(*norm) || norm->GetOutputEdgesCount() != 1 ||
+        !HasRank(*norm->InputDefs()[0], 3)) {
+      continue;
+    }
+
+    const Node& matmul = *norm->OutputNodesBegin();
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(matmul, "MatMul", {1, 9, 13}) ||
+        matmul.InputDefs()[0] != norm->OutputDefs()[0] || !HasRank(*matmul.InputDefs()[1], 2)) {
+      continue;
+    }
+
+    Node* logits = GetLogitsNode(graph, matmul);
+    if (logits == nullptr) {
+      continue;
+    }
+
+    NodeArg* hidden = norm->MutableInputDefs()[0];
+    const Node::EdgeEnd* hidden_edge = graph_utils::GetInputEdge(*norm, 0);
+    const Node* hidden_producer = hidden_edge != nullptr ? &hidden_edge->GetNode() : nullptr;
+    const int hidden_producer_output = hidden_edge != nullptr ? hidden_edge->GetSrcArgIndex() : 0;
+    if (hidden_producer != nullptr) {
+      graph.RemoveEdge(hidden_producer->Index(), norm->Index(), hidden_producer_output, 0);
+    }
+
+    TypeProto last_token_type = *hidden->TypeAsProto();
+    last_token_type.mutable_tensor_type()->mutable_shape()->mutable_dim(1)->set_dim_value(1);
+    NodeArg& last_token = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("last_token"), &last_token_type);
+    const std::string& provider = norm->GetExecutionProviderType();
+
+    Node* gather = nullptr;
+    NodeArg* seqlens_k = FindSeqlensK(graph);
+    if (seqlens_k != nullptr) {
+      // GroupQueryAttention pads on the right. The last valid token of each entry in this run is at
+      // min(seqlens_k, sequence_length - 1): its prompt length minus 1 in the first run, 0 in the next ones.
+      NodeArg& one = AddInt64Initializer(graph, "one", {1}, true);
+      NodeArg& unsqueeze_axes = AddInt64Initializer(graph, "unsqueeze_axes", {1, 2}, false);
+      NodeArg& seqlens = AddInt64NodeArg(graph, "seqlens_k_int64");
+      NodeArg& hidden_shape = AddInt64NodeArg(graph, "hidden_shape");
+      NodeArg& sequence_length = AddInt64NodeArg(graph, "sequence_length");
+      NodeArg& last_position = AddInt64NodeArg(graph, "last_position");
+      NodeArg& positions = AddInt64NodeArg(graph, "last_token_positions");
+      NodeArg& indices = AddInt64NodeArg(graph, "last_token_indices");
+
+      Node& cast = graph.AddNode(graph.GenerateNodeName("LastTokenCast"), "Cast", "seqlens_k to int64",
+                                 {seqlens_k}, {&seqlens});
+      cast.AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_INT64));
+      Node& shape = graph.AddNode(graph.GenerateNodeName("LastTokenShape"), "Shape", "shape of the hidden states",
+                                  {hidden}, {&hidden_shape});
+      Node& get_length = graph.AddNode(graph.GenerateNodeName("LastTokenSequenceLength"), "Gather",
+                                       "sequence length", {&hidden_shape, &one}, {&sequence_length});
+      Node& sub = graph.AddNode(graph.GenerateNodeName("LastTokenLastPosition"), "Sub", "sequence length - 1",
+                                {&sequence_length, &one}, {&last_position});
+      Node& min = graph.AddNode(graph.GenerateNodeName("LastTokenPositions"), "Min", "last valid token positions",
+                                {&seqlens, &last_position}, {&positions});
+      Node& unsqueeze = graph.AddNode(graph.GenerateNodeName("LastTokenIndices"), "Unsqueeze",
+                                      "positions as (batch_size, 1, 1)", {&positions, &unsqueeze_axes}, {&indices});
+      gather = &graph.AddNode(graph.GenerateNodeName("LastTokenGather"), "GatherND", "gather the last valid tokens",
+                              {hidden, &indices}, {&last_token});
+      gather->AddAttribute("batch_dims", static_cast<int64_t>(1));
+
+      for (Node* node : {&cast, &shape, &get_length, &sub, &min, &unsqueeze}) {
+        node->SetExecutionProviderType(provider);
+      }
+
+      const Node* seqlens_producer = graph.GetProducerNode(seqlens_k->Name());
+      if (seqlens_producer != nullptr) {
+        const auto& producer_outputs = seqlens_producer->OutputDefs();
+        for (int i = 0; i < static_cast<int>(producer_outputs.size()); ++i) {
+          if (producer_outputs[i] == seqlens_k) {
+            graph.AddEdge(seqlens_producer->Index(), cast.Index(), i, 0);
+          }
+        }
+      }
+      if (hidden_producer != nullptr) {
+        graph.AddEdge(hidden_producer->Index(), shape.Index(), hidden_producer_output, 0);
+      }
+      graph.AddEdge(shape.Index(), get_length.Index(), 0, 0);
+      graph.AddEdge(get_length.Index(), sub.Index(), 0, 0);
+      graph.AddEdge(cast.Index(), min.Index(), 0, 0);
+      graph.AddEdge(sub.Index(), min.Index(), 0, 1);
+      graph.AddEdge(min.Index(), unsqueeze.Index(), 0, 0);
+      graph.AddEdge(unsqueeze.Index(), gather->Index(), 0, 1);
+    } else {
+      // Models driven by an attention mask pad on the left, so the last valid token is the last position.
+      NodeArg& starts = AddInt64Initializer(graph, "last_token_starts", {-1}, false);
+      NodeArg& ends = AddInt64Initializer(graph, "last_token_ends", {std::numeric_limits<int64_t>::max()}, false);
+      NodeArg& axes = AddInt64Initializer(graph, "last_token_axes", {1}, false);
+      gather = &graph.AddNode(graph.GenerateNodeName("LastTokenSlice"), "Slice", "slice the last tokens",
+                              {hidden, &starts, &ends, &axes}, {&last_token});
+    }
+
+    gather->SetExecutionProviderType(provider);
+    if (hidden_producer != nullptr) {
+      graph.AddEdge(hidden_producer->Index(), gather->Index(), hidden_producer_output, 0);
+    }
+
+    graph_utils::ReplaceNodeInput(*norm, 0, last_token);
+    graph.AddEdge(gather->Index(), norm->Index(), 0, 0);
+
+    SetSequenceLengthToOne(*norm->MutableOutputDefs()[0]);
+    SetSequenceLengthToOne(*graph.GetNode(matmul.Index())->MutableOutputDefs()[0]);
+    SetSequenceLengthToOne(*logits->MutableOutputDefs()[0]);
+
+    LOGS(logger, INFO) << "Computing the logits of " << logits->OutputDefs()[0]->Name() << " for the last token only";
+    modified = true;
+    break;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Compute the logits of a decoder for the last valid token of each sequence only.
+ *
+ * Exported decoders apply the final layer normalization and the lm_head MatMul to every position, while
+ * generation only reads the logits of the last token, so in a prompt run the lm_head is the largest GEMM of the
+ * model. When the session is configured to consume only the last-token logits, the token is gathered from the
+ * hidden states before the final LayerNormalization, and the logits output has shape (batch_size, 1, vocab_size).
+ *
+ * The last valid token of each sequence is given by the seqlens_k input of GroupQueryAttention, which uses right
+ * padding, or is the last position otherwise, as models driven by an attention mask pad on the left.
+ */
+class LastTokenLogitsFusion : public GraphTransformer {
+ public:
+  LastTokenLogitsFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("LastTokenLogitsFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_nbits_qkv_fusion.h"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+
+#include "core/common/inlined_containers.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// MatMulNBits input indices
+constexpr int kB = 1, kScales = 2, kZeroPoints = 3, kGIdx = 4, kBias = 5;
+
+bool HasInput(const Node& node, int index) {
+  return node.InputDefs().size() > static_cast<size_t>(index) && node.InputDefs()[index]->Exists();
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr && attr->has_i() ? attr->i() : default_value;
+}
+
+// the MatMulNBits that produces the given GroupQueryAttention input, if its constant inputs can be concatenated
+const Node* GetFusableMatMulNBits(const Graph& graph, const Node& gqa, int input_index) {
+  const Node* node = graph_utils::GetInputNode(gqa, input_index);
+  if (node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "MatMulNBits", {1}, kMSDomain) ||
+      node->GetExecutionProviderType() != gqa.GetExecutionProviderType() ||
+      !optimizer_utils::CheckOutputEdges(graph, *node, 1) || HasInput(*node, kGIdx)) {
+    return nullptr;
+  }
+
+  for (int input : {kB, kScales, kZeroPoints, kBias}) {
+    if (HasInput(*node, input) && !graph_utils::IsConstantInitializer(graph, node->InputDefs()[input]->Name())) {
+      return nullptr;
+    }
+  }
+
+  return node;
+}
+
+// concatenates the constant inputs of the nodes along their first dimension, which is N for all the inputs
+std::optional<TensorProto> ConcatInitializers(const Graph& graph, const std::array<const Node*, 3>& nodes,
+                                              int input_index) {
+  TensorProto result;
+  std::vector<uint8_t> result_data;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const auto& name = nodes[i]->InputDefs()[input_index]->Name();
+    const TensorProto* tensor = graph_utils::GetConstantInitializer(graph, name);
+    if (tensor == nullptr || tensor->dims_size() == 0) {
+      return std::nullopt;
+    }
+
+    if (i == 0) {
+      result.set_name(graph.GenerateNodeArgName(name + "_qkv"));
+      result.set_data_type(tensor->data_type());
+      result.mutable_dims()->CopyFrom(tensor->dims());
+    } else {
+      if (tensor->data_type() != result.data_type() || tensor->dims_size() != result.dims_size() ||
+          !std::equal(tensor->dims().begin() + 1, tensor->dims().end(), result.dims().begin() + 1)) {
+        return std::nullopt;
+      }
+      result.set_dims(0, result.dims(0) + tensor->dims(0));
+    }
+
+    std::vector<uint8_t> data;
+    if (!utils::UnpackInitializerData(*tensor, graph.ModelPath(), data).IsOK()) {
+      return std::nullopt;
+    }
+    result_data.insert(result_data.end(), data.begin(), data.end());
+  }
+
+  utils::SetRawDataInTensorProto(result, result_data.data(), result_data.size());
+  return result;
+}
+
+}  // namespace
+
+Status MatMulNBitsQkvFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                       const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr) continue;  // Node was removed.
+
+    auto& gqa = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(gqa, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(gqa, "GroupQueryAttention", {1}, kMSDomain) ||
+        !graph_utils::IsSupportedProvider(gqa, GetCompatibleExecutionProviders()) ||
+        !HasInput(gqa, 1) || !HasInput(gqa, 2)) {
+      continue;
+    }
+
+    std::array<const Node*, 3> matmuls{};
+    bool fusable = true;
+    for (int i = 0; i < 3 && fusable; ++i) {
+      matmuls[i] = GetFusableMatMulNBits(graph, gqa, i);
+      fusable = matmuls[i] != nullptr;
+    }
+    if (!fusable) {
+      continue;
+    }
+
+    // the projections of the same input with the same quantization
+    const Node& q_matmul = *matmuls[0];
+    for (int i = 1; i < 3 && fusable; ++i) {
+      const Node& matmul = *matmuls[i];
+      fusable = matmul.InputDefs()[0] == q_matmul.InputDefs()[0] &&
+                HasInput(matmul, kZeroPoints) == HasInput(q_matmul, kZeroPoints) &&
+                HasInput(matmul, kBias) == HasInput(q_matmul, kBias);
+      for (const char* attr : {"K", "bits", "block_size", "accuracy_level"}) {
+        fusable = fusable && GetIntAttribute(matmul, attr, 0) == GetIntAttribute(q_matmul, attr, 0);
+      }
+    }
+    if (!fusable || GetIntAttribute(*matmuls[1], "N", 0) != GetIntAttribute(*matmuls[2], "N", 0)) {
+      continue;
+    }
+
+    auto b = ConcatInitializers(graph, matmuls, kB);
+    auto scales = ConcatInitializers(graph, matmuls, kScales);
+    std::optional<TensorProto> zero_points;
+    std::optional<TensorProto> bias;
+    if (HasInput(q_matmul, kZeroPoints)) {
+      zero_points = ConcatInitializers(graph, matmuls, kZeroPoints);
+    }
+    if (HasInput(q_matmul, kBias)) {
+      bias = ConcatInitializers(graph, matmuls, kBias);
+    }
+    if (!b || !scales || (HasInput(q_matmul, kZeroPoints) && !zero_points) || (HasInput(q_matmul, kBias) && !bias)) {
+      continue;
+    }
+
+    NodeArg& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+    InlinedVector<NodeArg*> inputs{const_cast<NodeArg*>(q_matmul.InputDefs()[0]),
+                                   &graph_utils::AddInitializer(graph, *b),
+                                   &graph_utils::AddInitializer(graph, *scales)};
+    if (zero_points || bias) {
+      inputs.push_back(zero_points ? &graph_utils::AddInitializer(graph, *zero_points) : &empty_arg);
+    }
+    if (bias) {
+      inputs.push_back(&empty_arg);
+      inputs.push_back(&graph_utils::AddInitializer(graph, *bias));
+    }
+
+    NodeArg& packed_qkv = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("packed_qkv"),
+                                                   q_matmul.OutputDefs()[0]->TypeAsProto());
+    Node& fused_matmul = graph.AddNode(graph.GenerateNodeName(q_matmul.Name() + "_qkv"), "MatMulNBits",
+                                       "Fused Q, K and V projections of " + gqa.Name(), inputs, {&packed_qkv},
+                                       &q_matmul.GetAttributes(), kMSDomain);
+    fused_matmul.AddAttribute("N", GetIntAttribute(*matmuls[0], "N", 0) + GetIntAttribute(*matmuls[1], "N", 0) +
+                                       GetIntAttribute(*matmuls[2], "N", 0));
+    fused_matmul.SetExecutionProviderType(q_matmul.GetExecutionProviderType());
+
+    for (const Node* matmul : matmuls) {
+      Node& node = *graph.GetNode(matmul->Index());
+      graph_utils::RemoveNodeOutputEdges(graph, node);
+      graph.RemoveNode(node.Index());
+    }
+
+    // the query input holds the packed QKV, key and value are absent
+    graph_utils::ReplaceNodeInput(gqa, 0, packed_qkv);
+    graph_utils::ReplaceNodeInput(gqa, 1, empty_arg);
+    graph_utils::ReplaceNodeInput(gqa, 2, empty_arg);
+    graph.AddEdge(fused_matmul.Index(), gqa.Index(), 0, 0);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulNBitsQkvFusion
+
+Fuse the three MatMulNBits that compute the query, key and value inputs of a GroupQueryAttention from the same input
+into one MatMulNBits over the concatenated weights, whose output is the packed QKV input of the GroupQueryAttention.
+
+A decode step then quantizes the input once and runs one n-bit GEMM instead of three, and the GroupQueryAttention
+applies the rotary embedding and appends to the KV cache from the packed buffer.
+*/
+class MatMulNBitsQkvFusion : public GraphTransformer {
+ public:
+  MatMulNBitsQkvFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulNBitsQkvFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,260 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/memory_budget_recompute.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <string_view>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/logging/logging.h"
+#include "core/common/safeint.h"
+#include "core/framework/data_types.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// ops that are cheap to run again and whose output doesn't alias an input
+constexpr std::array<std::string_view, 17> kRecomputableOps = {
+    "Add", "Cast", "Concat", "ConstantOfShape", "Div", "Equal", "Expand", "Gather", "Greater",
+    "Less", "Mul", "Neg", "Not", "Range", "Sub", "Tile", "Where"};
+
+// the maximum number of nodes the transformer adds to a graph
+constexpr size_t kMaxRecomputedNodes = 64;
+
+// size of a tensor with a static shape, 0 otherwise
+int64_t GetStaticSizeInBytes(const NodeArg& arg) {
+  const auto* type_proto = arg.TypeAsProto();
+  const auto* shape = arg.Shape();
+  if (type_proto == nullptr || !utils::HasTensorType(*type_proto) || !utils::HasElemType(type_proto->tensor_type()) ||
+      shape == nullptr) {
+    return 0;
+  }
+
+  const auto elem_type = type_proto->tensor_type().elem_type();
+  if (elem_type == TensorProto_DataType_STRING) {
+    return 0;
+  }
+
+  const int64_t num_elements = utils::GetTensorShapeFromTensorShapeProto(*shape).Size();
+  if (num_elements <= 0) {
+    return 0;
+  }
+
+  return SafeInt<int64_t>(num_elements) *
+         static_cast<int64_t>(DataTypeImpl::TensorTypeFromONNXEnum(elem_type)->GetElementType()->Size());
+}
+
+// a node whose single output can be computed again anywhere, as its inputs are graph inputs or initializers
+bool IsRecomputable(const Graph& graph, const Node& node) {
+  if (node.Domain() != kOnnxDomain || node.ContainsSubgraph() || node.OutputDefs().size() != 1 ||
+      std::find(kRecomputableOps.begin(), kRecomputableOps.end(), node.OpType()) == kRecomputableOps.end()) {
+    return false;
+  }
+
+  return std::all_of(node.InputDefs().begin(), node.InputDefs().end(), [&graph](const NodeArg* input) {
+    return !input->Exists() || graph_utils::IsGraphInput(graph, input) ||
+           graph_utils::IsInitializer(graph, input->Name(), true);
+  });
+}
+
+struct ValueLifetime {
+  Node* producer;
+  int64_t size;
+  // positions in the execution order of the producer and of the last consumer
+  size_t start;
+  size_t end;
+};
+
+}  // namespace
+
+Status MemoryBudgetRecompute::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                        const logging::Logger& logger) const {
+  // subgraphs run while the node that contains them holds its inputs, they are left as they are
+  if (graph_level > 0) {
+    return Status::OK();
+  }
+
+  InlinedHashSet<NodeIndex> recompute_nodes;
+  int64_t previous_peak = std::numeric_limits<int64_t>::max();
+  for (size_t num_recomputed = 0; num_recomputed < kMaxRecomputedNodes; ++num_recomputed) {
+    GraphViewer graph_viewer(graph);
+    const auto& default_order = graph_viewer.GetNodesInTopologicalOrder();
+    if (default_order.empty()) {
+      return Status::OK();
+    }
+
+    // the default order runs the copies, which only consume graph inputs and initializers, as early as it can.
+    // the estimate places them right before their first consumer, close to where the memory aware order of the
+    // planner runs them.
+    InlinedVector<NodeIndex> order;
+    order.reserve(default_order.size());
+    for (const NodeIndex node_index : default_order) {
+      if (recompute_nodes.count(node_index) != 0) {
+        continue;
+      }
+
+      const Node* node = graph.GetNode(node_index);
+      for (auto input_node = node->InputNodesBegin(); input_node != node->InputNodesEnd(); ++input_node) {
+        if (recompute_nodes.count(input_node->Index()) != 0 &&
+            std::find(order.begin(), order.end(), input_node->Index()) == order.end()) {
+          order.push_back(input_node->Index());
+        }
+      }
+      order.push_back(node_index);
+    }
+
+    InlinedVector<size_t> positions(graph.MaxNodeIndex(), order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      positions[order[i]] = i;
+    }
+
+    const auto& graph_outputs = graph.GetOutputs();
+    InlinedVector<ValueLifetime> lifetimes;
+    std::vector<int64_t> size_changes(order.size() + 1, 0);
+    for (size_t i = 0; i < order.size(); ++i) {
+      Node* node = graph.GetNode(order[i]);
+      for (const auto* output_def : node->OutputDefs()) {
+        const int64_t size = output_def->Exists() ? GetStaticSizeInBytes(*output_def) : 0;
+        if (size == 0) {
+          continue;
+        }
+
+        size_t end = i;
+        if (std::find(graph_outputs.begin(), graph_outputs.end(), output_def) != graph_outputs.end()) {
+          end = order.size() - 1;
+        } else {
+          for (const Node* consumer : graph.GetConsumerNodes(output_def->Name())) {
+            end = std::max(end, positions[consumer->Index()]);
+          }
+        }
+
+        if (node->OutputDefs().size() == 1) {
+          lifetimes.push_back({node, size, i, end});
+        }
+        size_changes[i] += size;
+        size_changes[end + 1] -= size;
+      }
+    }
+
+    // the peak and the first position it is reached at
+    int64_t live = 0;
+    int64_t peak = 0;
+    size_t peak_position = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+      live += size_changes[i];
+      if (live > peak) {
+        peak = live;
+        peak_position = i;
+      }
+    }
+
+    if (peak <= static_cast<int64_t>(memory_budget_in_bytes_)) {
+      return Status::OK();
+    }
+
+    // stop if the last copy didn't help
+    if (peak >= previous_peak) {
+      LOGS(logger, WARNING) << "Recomputing values didn't reduce the estimated peak size of the intermediate values of "
+                            << "graph " << graph.Name() << " of " << peak << " bytes under the budget of "
+                            << memory_budget_in_bytes_ << " bytes.";
+      return Status::OK();
+    }
+    previous_peak = peak;
+
+    // the largest value that is live at the peak without being used there
+    const ValueLifetime* candidate = nullptr;
+    for (const auto& lifetime : lifetimes) {
+      if (lifetime.start >= peak_position || lifetime.end <= peak_position ||
+          (candidate != nullptr && lifetime.size <= candidate->size) ||
+          !IsRecomputable(graph, *lifetime.producer)) {
+        continue;
+      }
+
+      const NodeArg* value = lifetime.producer->OutputDefs()[0];
+      const auto consumers = graph.GetConsumerNodes(value->Name());
+      const bool can_move_consumers = std::none_of(
+          consumers.begin(), consumers.end(), [&](const Node* consumer) {
+            const auto& implicit_inputs = consumer->ImplicitInputDefs();
+            return positions[consumer->Index()] == peak_position ||
+                   std::find(implicit_inputs.begin(), implicit_inputs.end(), value) != implicit_inputs.end();
+          });
+      if (can_move_consumers &&
+          std::find(graph_outputs.begin(), graph_outputs.end(), value) == graph_outputs.end()) {
+        candidate = &lifetime;
+      }
+    }
+
+    if (candidate == nullptr) {
+      LOGS(logger, WARNING) << "The estimated peak size of the intermediate values of graph " << graph.Name() << " is "
+                            << peak << " bytes, above the budget of " << memory_budget_in_bytes_
+                            << " bytes, and no value live at the peak can be recomputed.";
+      return Status::OK();
+    }
+
+    // the copy computes the value for the consumers after the peak
+    Node& producer = *candidate->producer;
+    NodeArg& value = *producer.MutableOutputDefs()[0];
+    NodeArg& recomputed_value = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(value.Name() + "_recompute"),
+                                                         value.TypeAsProto());
+    Node& recompute_node = graph.AddNode(graph.GenerateNodeName(producer.Name() + "_recompute"), producer.OpType(),
+                                         "Recomputed to keep the peak memory under the budget",
+                                         producer.MutableInputDefs(), {&recomputed_value},
+                                         &producer.GetAttributes(), producer.Domain());
+    recompute_node.SetExecutionProviderType(producer.GetExecutionProviderType());
+    recompute_nodes.insert(recompute_node.Index());
+    graph.UpdateProducerNode(recomputed_value.Name(), recompute_node.Index());
+    for (const auto* input_def : recompute_node.InputDefs()) {
+      if (input_def->Exists()) {
+        graph.AddConsumerNode(input_def->Name(), &recompute_node);
+      }
+    }
+
+    for (Node* consumer : graph.GetMutableConsumerNodes(value.Name())) {
+      if (positions[consumer->Index()] < peak_position) {
+        continue;
+      }
+
+      auto& input_defs = consumer->MutableInputDefs();
+      for (size_t input_index = 0; input_index < input_defs.size(); ++input_index) {
+        if (input_defs[input_index] == &value) {
+          const int dst_arg_index = static_cast<int>(input_index);
+          graph.RemoveEdge(producer.Index(), consumer->Index(), 0, dst_arg_index);
+          graph_utils::ReplaceNodeInput(*consumer, dst_arg_index, recomputed_value);
+          graph.AddEdge(recompute_node.Index(), consumer->Index(), 0, dst_arg_index);
+        }
+      }
+
+      graph.RemoveConsumerNode(value.Name(), consumer);
+      graph.AddConsumerNode(recomputed_value.Name(), consumer);
+    }
+
+    LOGS(logger, VERBOSE) << "Recomputing " << value.Name() << " (" << candidate->size << " bytes) after node "
+                          << graph.GetNode(order[peak_position])->Name() << " to reduce the estimated peak of "
+                          << peak << " bytes.";
+
+    // the producer is gone if all the consumers were after the peak
+    if (graph.GetConsumerNodes(value.Name()).empty()) {
+      for (const auto* input_def : producer.InputDefs()) {
+        if (input_def->Exists()) {
+          graph.RemoveConsumerNode(input_def->Name(), &producer);
+        }
+      }
+      graph.RemoveNode(producer.Index());
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
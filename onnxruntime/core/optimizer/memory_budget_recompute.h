@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MemoryBudgetRecompute
+
+Transformer that keeps the estimated peak size of the intermediate values of an inference graph under a budget by
+recomputing values instead of keeping them alive until their last consumer.
+
+The peak is estimated over the default topological order, from the sizes of the values with a static shape.
+While it is above the budget, the largest value that is live at the peak but not used there, and that a cheap node
+computes from graph inputs and initializers only (e.g. an attention mask that is expanded once and consumed by every
+layer), is recomputed by a copy of its producer for the consumers after the peak. Each copy runs again, so the
+latency cost is one execution of the producer per copy.
+
+The estimate places each copy right before its first consumer, close to where the memory aware execution order of the
+allocation planner runs it. It runs after partitioning, the copies are assigned to the EP of the node they copy.
+*/
+class MemoryBudgetRecompute : public GraphTransformer {
+ public:
+  explicit MemoryBudgetRecompute(size_t memory_budget_in_bytes) noexcept
+      : GraphTransformer("MemoryBudgetRecompute"), memory_budget_in_bytes_(memory_budget_in_bytes) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const size_t memory_budget_in_bytes_;
+};
+
+}  // namespace onnxruntime
@@ -1,10 +1,12 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <deque>
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/nchwc_transformer.h"
+#include "core/optimizer/utils.h"
 #include "core/mlas/inc/mlas.h"
 
 using namespace ONNX_NAMESPACE;
@@ -123,6 +125,9 @@ class NchwcTransformerImpl {
   void TransformPool(Node& node);
   void TransformBinary(Node& node, bool add_node);
   void TransformConcat(Node& node);
+  void TransformSplit(Node& node);
+  void TransformSlice(Node& node);
+  void TransformPad(Node& node);
   void TransformActivation(Node& node);
   void TransformBatchNormalization(Node& node);
   void TransformTransposeToNhwc(Node& node);
@@ -705,10 +710,7 @@ void NchwcTransformerImpl::TransformBinary(Node& node, bool add_node) {
     //
     // This optimization is restricted to Add/Sum nodes. Mul nodes would also work
     // using this code, however the common case here is multiplying a NxCxHxW
-    // matrix by a NxCx1x1 vector. The implementation of Mul does not currently
-    // vectorize well for the case of broadcasting a NCHWc sized channel block.
-    // This case should be handled by a ScaleShift kernel that can broadcast a
-    // multiply/add vector (BatchNormalization can also be reimplemented with this).
+    // matrix by a NxCx1x1 vector, which is handled below.
     for (size_t n = 0; n < input_defs_count; n++) {
       std::string reshape_input_def_name = graph_.GenerateNodeArgName("reshape");
       auto* reshape_input_arg = &graph_.GetOrCreateNodeArg(reshape_input_def_name, nullptr);
@@ -728,6 +730,62 @@ void NchwcTransformerImpl::TransformBinary(Node& node, bool add_node) {
     output_defs[0] = output_reshaped_arg;
     return;
   }
+
+  // Multiplying a NxCxHxW matrix by a NxCx1x1 vector is the excitation of a
+  // squeeze-and-excitation block. The implementation of Mul does not vectorize
+  // well for the case of broadcasting a NCHWc sized channel block, so replace
+  // the node with a NCHWc Mul that scales each channel block.
+  if (input_defs_count == 2) {
+    auto is_channel_vector = [](const NodeArg* arg) {
+      auto* shape = arg->Shape();
+      return (shape != nullptr) && (shape->dim_size() == kNchwcDims) &&
+             utils::HasDimValue(shape->dim(2)) && (shape->dim(2).dim_value() == 1) &&
+             utils::HasDimValue(shape->dim(3)) && (shape->dim(3).dim_value() == 1);
+    };
+
+    size_t scale_index;
+    if (is_channel_vector(input_defs[1])) {
+      scale_index = 1;
+    } else if (is_channel_vector(input_defs[0])) {
+      scale_index = 0;
+    } else {
+      return;
+    }
+    auto* nchwc_input = nchwc_inputs[scale_index ^ 1];
+    auto* nchwc_scale = nchwc_inputs[scale_index];
+
+    // Require that the batch count is the same or is broadcast from the vector.
+    if (!nchwc_input->shape_.IsDimEqual(nchwc_scale->shape_, 0)) {
+      auto* input_shape = input_defs[scale_index ^ 1]->Shape();
+      auto& scale_batch_dim = input_defs[scale_index]->Shape()->dim(0);
+      if (!utils::HasDimValue(scale_batch_dim)) {
+        return;
+      }
+      if (scale_batch_dim.dim_value() != 1) {
+        if ((input_shape == nullptr) || (input_shape->dim_size() != kNchwcDims) ||
+            !utils::HasDimValue(input_shape->dim(0)) ||
+            (input_shape->dim(0).dim_value() != scale_batch_dim.dim_value())) {
+          return;
+        }
+      }
+    }
+
+    std::string nchwc_node_name = graph_.GenerateNodeName(output_defs[0]->Name() + "_nchwc");
+    Node& nchwc_node = graph_.AddNode(nchwc_node_name,
+                                      "Mul",
+                                      nchwc_node_name,
+                                      {nchwc_input->nchwc_arg_, nchwc_scale->nchwc_arg_},
+                                      output_defs,
+                                      nullptr,
+                                      kMSNchwcDomain);
+    nchwc_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+    nchwc_input->remaining_original_uses_--;
+    nchwc_scale->remaining_original_uses_--;
+
+    CreateNchwcArgument(node, nchwc_node, channels, nchwc_input->shape_);
+    removed_nodes_.push_front(node.Index());
+  }
 }
 
 void NchwcTransformerImpl::TransformConcat(Node& node) {
@@ -776,6 +834,197 @@ void NchwcTransformerImpl::TransformConcat(Node& node) {
   CreateNchwcArgument(node, node, total_channels, output_shape);
 }
 
+// Split along the channel axis into block aligned outputs. The NCHWc tensor is
+// split by the original node as the channel blocks are contiguous.
+void NchwcTransformerImpl::TransformSplit(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  auto* nchwc_input = LookupNchwcArgument(input_defs[0]);
+  if (nchwc_input == nullptr) {
+    return;
+  }
+
+  // Verify that this is a split along the channel axis.
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  if (axis_attr == nullptr || !utils::HasInt(*axis_attr) || (axis_attr->i() != 1 && axis_attr->i() != -3)) {
+    return;
+  }
+
+  const size_t output_defs_count = output_defs.size();
+  InlinedVector<int64_t> split_channels;
+  if (input_defs.size() >= 2 && input_defs[1]->Exists()) {
+    if (!optimizer_utils::AppendTensorFromInitializer(graph_, *input_defs[1], split_channels)) {
+      return;
+    }
+  } else if (const auto* split_attr = graph_utils::GetNodeAttribute(node, "split"); split_attr != nullptr) {
+    split_channels.assign(split_attr->ints().begin(), split_attr->ints().end());
+  } else if ((nchwc_input->channels_ % static_cast<int64_t>(output_defs_count)) == 0) {
+    split_channels.assign(output_defs_count, nchwc_input->channels_ / static_cast<int64_t>(output_defs_count));
+  } else {
+    return;
+  }
+
+  // Verify that the logical number of channels of each output is block aligned.
+  const int64_t nchwc_block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  if (split_channels.size() != output_defs_count) {
+    return;
+  }
+  int64_t total_channels = 0;
+  for (int64_t channels : split_channels) {
+    if (channels <= 0 || (channels % nchwc_block_size) != 0) {
+      return;
+    }
+    total_channels += channels;
+  }
+  if (total_channels != nchwc_input->channels_) {
+    return;
+  }
+
+  input_defs[0] = nchwc_input->nchwc_arg_;
+  nchwc_input->remaining_original_uses_--;
+
+  // Count the original uses of each output before removing the output edges.
+  InlinedVector<size_t> original_uses(output_defs_count, 0);
+  for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+    original_uses[it->GetSrcArgIndex()]++;
+  }
+  graph_utils::RemoveNodeOutputEdges(graph_, node);
+
+  const auto& graph_outputs = graph_.GetOutputs();
+  for (size_t i = 0; i < output_defs_count; i++) {
+    auto* output_original_arg = output_defs[i];
+    // Bias the use count to handle an output that is a graph output.
+    if (std::find(graph_outputs.begin(), graph_outputs.end(), output_original_arg) != graph_outputs.end()) {
+      original_uses[i]++;
+    }
+
+    // Copy the shape from the NCHWc input, but use the current output for the
+    // channel dimension.
+    NchwcArgument::Shape output_shape = nchwc_input->shape_;
+    output_shape.dims_[1] = output_original_arg;
+
+    std::string output_reorder_def_name = graph_.GenerateNodeArgName("reorder");
+    auto* output_nchwc_arg = &graph_.GetOrCreateNodeArg(output_reorder_def_name, nullptr);
+    nchwc_args_[output_original_arg] =
+        std::make_unique<NchwcArgument>(node, output_nchwc_arg, original_uses[i], split_channels[i], output_shape);
+    output_defs[i] = output_nchwc_arg;
+  }
+}
+
+// Slice a block aligned range of channels. As with Split, the original node
+// can slice the NCHWc tensor directly.
+void NchwcTransformerImpl::TransformSlice(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  auto* nchwc_input = LookupNchwcArgument(input_defs[0]);
+  if (nchwc_input == nullptr) {
+    return;
+  }
+
+  // The padded NCHWc channels are only sliced correctly if the channels are
+  // already block aligned.
+  const int64_t nchwc_block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  const int64_t channels = nchwc_input->channels_;
+  if ((channels % nchwc_block_size) != 0) {
+    return;
+  }
+
+  // Verify that this is a slice along the channel axis with a unit step.
+  InlinedVector<int64_t> starts;
+  InlinedVector<int64_t> ends;
+  InlinedVector<int64_t> axes;
+  InlinedVector<int64_t> steps;
+  if (input_defs.size() < 4 || !input_defs[3]->Exists() ||
+      !optimizer_utils::AppendTensorFromInitializer(graph_, *input_defs[1], starts) ||
+      !optimizer_utils::AppendTensorFromInitializer(graph_, *input_defs[2], ends) ||
+      !optimizer_utils::AppendTensorFromInitializer(graph_, *input_defs[3], axes) ||
+      (input_defs.size() >= 5 && input_defs[4]->Exists() &&
+       !optimizer_utils::AppendTensorFromInitializer(graph_, *input_defs[4], steps))) {
+    return;
+  }
+  if (starts.size() != 1 || ends.size() != 1 || axes.size() != 1 || (axes[0] != 1 && axes[0] != -3) ||
+      (!steps.empty() && (steps.size() != 1 || steps[0] != 1))) {
+    return;
+  }
+
+  int64_t start = starts[0] < 0 ? starts[0] + channels : starts[0];
+  int64_t end = ends[0] < 0 ? ends[0] + channels : ends[0];
+  start = std::clamp<int64_t>(start, 0, channels);
+  end = std::clamp<int64_t>(end, 0, channels);
+  if (start >= end || (start % nchwc_block_size) != 0 || (end % nchwc_block_size) != 0) {
+    return;
+  }
+
+  input_defs[0] = nchwc_input->nchwc_arg_;
+  nchwc_input->remaining_original_uses_--;
+
+  NchwcArgument::Shape output_shape = nchwc_input->shape_;
+  output_shape.dims_[1] = output_defs[0];
+
+  CreateNchwcArgument(node, node, end - start, output_shape);
+}
+
+// Pad the spatial dimensions. The NCHWc tensor is reshaped to split the channel
+// blocks into a separate dimension so that the padding does not apply to the
+// elements of a block.
+void NchwcTransformerImpl::TransformPad(Node& node) {
+  auto& input_defs = node.MutableInputDefs();
+  auto& output_defs = node.MutableOutputDefs();
+
+  auto* nchwc_input = LookupNchwcArgument(input_defs[0]);
+  if (nchwc_input == nullptr) {
+    return;
+  }
+
+  // Verify that only the spatial dimensions are padded.
+  InlinedVector<int64_t> pads;
+  if (input_defs.size() < 2 || (input_defs.size() >= 4 && input_defs[3]->Exists()) ||
+      !optimizer_utils::AppendTensorFromInitializer(graph_, *input_defs[1], pads) ||
+      pads.size() != kNchwcDims * 2) {
+    return;
+  }
+  for (int i = 0; i < kNchwcBatchChannelDims; i++) {
+    if (pads[i] != 0 || pads[kNchwcDims + i] != 0) {
+      return;
+    }
+  }
+
+  // Build the pads for the split tensor, which has the channel blocks as the
+  // last dimension.
+  ONNX_NAMESPACE::TensorProto pads_tensor_proto;
+  pads_tensor_proto.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  pads_tensor_proto.set_name(graph_.GenerateNodeArgName("pads"));
+  for (int n = 0; n < 2; n++) {
+    for (int i = 0; i < kNchwcDims; i++) {
+      pads_tensor_proto.add_int64_data(pads[n * kNchwcDims + i]);
+    }
+    pads_tensor_proto.add_int64_data(0);
+  }
+  pads_tensor_proto.add_dims((kNchwcDims + 1) * 2);
+
+  std::string reshape_input_def_name = graph_.GenerateNodeArgName("reshape");
+  auto* reshape_input_arg = &graph_.GetOrCreateNodeArg(reshape_input_def_name, nullptr);
+  InsertReshape(nchwc_input->nchwc_arg_, reshape_input_arg, true);
+
+  input_defs[0] = reshape_input_arg;
+  input_defs[1] = &graph_utils::AddInitializer(graph_, pads_tensor_proto);
+  nchwc_input->remaining_original_uses_--;
+
+  std::string output_reshaped_def_name = graph_.GenerateNodeArgName("reshape");
+  auto* output_reshaped_arg = &graph_.GetOrCreateNodeArg(output_reshaped_def_name, nullptr);
+  Node& nchwc_node = InsertReshape(output_reshaped_arg, output_defs[0], false);
+
+  // Maintain the batch and channel dimensions from the NCHWc input.
+  NchwcArgument::Shape output_shape(output_defs[0]);
+  output_shape.dims_[0] = nchwc_input->shape_.dims_[0];
+  output_shape.dims_[1] = nchwc_input->shape_.dims_[1];
+
+  CreateNchwcArgument(node, nchwc_node, nchwc_input->channels_, output_shape);
+  output_defs[0] = output_reshaped_arg;
+}
+
 // After doing a Conv/Add fusion, there may be an activation node that could now
 // be fused into the Conv node as well. Otherwise, this is an elementwise
 // operation that can directly use the NCHWc input.
@@ -788,12 +1037,28 @@ void NchwcTransformerImpl::TransformActivation(Node& node) {
     nchwc_input->remaining_original_uses_--;
 
     // Check if this is a single use NCHWc convolution that hasn't already
-    // been fused with another activation.
+    // been fused with another activation. MLAS does not implement HardSwish
+    // as a convolution activation.
     auto& nchwc_node = nchwc_input->output_node_;
     if ((nchwc_node.OpType() == "Conv") && (nchwc_node.Domain() == kMSNchwcDomain) &&
         (nchwc_input->starting_original_uses_ == 1) &&
-        (graph_utils::GetNodeAttribute(nchwc_node, "activation") == nullptr)) {
+        (graph_utils::GetNodeAttribute(nchwc_node, "activation") == nullptr) &&
+        (node.OpType() != "HardSwish")) {
       nchwc_node.AddAttribute("activation", node.OpType());
+
+      InlinedVector<float> activation_params;
+      const auto* alpha_attr = graph_utils::GetNodeAttribute(node, "alpha");
+      if (node.OpType() == "LeakyRelu") {
+        activation_params.push_back(alpha_attr == nullptr ? 0.01f : alpha_attr->f());
+      } else if (node.OpType() == "HardSigmoid") {
+        const auto* beta_attr = graph_utils::GetNodeAttribute(node, "beta");
+        activation_params.push_back(alpha_attr == nullptr ? 0.2f : alpha_attr->f());
+        activation_params.push_back(beta_attr == nullptr ? 0.5f : beta_attr->f());
+      }
+      if (!activation_params.empty()) {
+        nchwc_node.AddAttribute("activation_params", gsl::span<const float>(activation_params));
+      }
+
       FuseNchwcArgument(node, *nchwc_input);
       removed_nodes_.push_front(node.Index());
     } else {
@@ -1168,9 +1433,18 @@ void NchwcTransformerImpl::Transform(Node& node) {
       TransformBinary(node, false);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11, 13})) {
       TransformConcat(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Split", {2, 11, 13, 18})) {
+      TransformSplit(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Slice", {10, 11, 13})) {
+      TransformSlice(node);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Pad", {11, 13, 18, 19})) {
+      TransformPad(node);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
                graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
-               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13})) {
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6, 16}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "HardSigmoid", {6}) ||
+               graph_utils::IsSupportedOptypeVersionAndDomain(node, "HardSwish", {14})) {
       TransformActivation(node);
     } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9, 14})) {
       TransformBatchNormalization(node);
@@ -474,6 +474,26 @@ Status DQMatMulToMatMulNBitsAction::ProcessNewNode(Graph& graph,
     }
   }
 
+  // a Gemm target is A * B with an optional bias of shape [N], see DQMatMulNodeGroupSelector
+  const auto& target = selected_nodes.Target();
+  if (target.OpType() == "Gemm") {
+    for (const char* attr : {"alpha", "beta", "transA", "transB"}) {
+      replacement_node.ClearAttribute(attr);
+    }
+
+    if (target.InputDefs().size() > 2 && target.InputDefs()[2]->Exists()) {
+      NodeArg& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+      if (!zp_T_tp) {
+        input_defs.push_back(&empty_arg);
+        replacement_node.MutableInputArgsCount().push_back(1);
+      }
+      input_defs.push_back(&empty_arg);  // g_idx
+      replacement_node.MutableInputArgsCount().push_back(1);
+      input_defs.push_back(const_cast<NodeArg*>(target.InputDefs()[2]));
+      replacement_node.MutableInputArgsCount().push_back(1);
+    }
+  }
+
   return Status::OK();
 }
 
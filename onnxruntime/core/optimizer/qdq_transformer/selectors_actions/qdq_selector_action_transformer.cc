@@ -160,6 +160,23 @@ void UnaryOpQDQRules(SelectorActionRegistry& qdq_selector_action_registry) {
 #else
   qdq_selector_action_registry.RegisterAction(action_name, std::move(action));
 #endif
+
+  // QLinearGelu is a lookup table that only the CPU EP implements. It covers both the ONNX Gelu and the exact Gelu of
+  // the com.microsoft domain, whose "approximate" attribute is copied to the replacement.
+  const std::string gelu_action_name{"1DQ_Gelu"};
+  std::unique_ptr<Action> gelu_action = std::make_unique<QDQ::UnaryReplaceWithQLinear>(kMSDomain);
+
+#if !defined(ORT_MINIMAL_BUILD)
+  std::vector<const char*> cpu_ep = {kCpuExecutionProvider};
+  std::unique_ptr<NodeSelector> gelu_selector = std::make_unique<QDQ::UnarySelector>(cpu_ep);
+  qdq_selector_action_registry.RegisterSelectorAndAction(gelu_action_name,
+                                                         {{"Gelu", {20}},
+                                                          {SelectorActionRegistry::OpVersionsMapKey("Gelu", kMSDomain), {}}},
+                                                         std::move(gelu_selector),
+                                                         std::move(gelu_action));
+#else
+  qdq_selector_action_registry.RegisterAction(gelu_action_name, std::move(gelu_action));
+#endif
 }
 
 void BinaryOpQDQRules(SelectorActionRegistry& qdq_selector_action_registry) {
@@ -283,7 +300,8 @@ void DQMatMulToMatMulNBitsRules(SelectorActionRegistry& qdq_selector_action_regi
                                 int64_t qdq_matmulnbits_accuracy_level,
                                 concurrency::ThreadPool* intra_op_thread_pool,
                                 std::unordered_map<std::string, std::unique_ptr<Tensor>>* p_buffered_tensors) {
-  // 2 nodes. DQ -> MatMul. DQ is the second input to MatMul.
+  // 2 nodes. DQ -> MatMul/Gemm. DQ is the second input to MatMul/Gemm.
+  // Gemm must not transpose or scale, and its optional bias must be a constant of shape [N].
   // DQ's weight is int4/uint4. DQ's scale is float/float16.
   // DQ is block-quantized along axis 0, with block_size >= 16 and as 2's power.
   const std::string action_name{"DQMatMulToMatMulNBits"};
@@ -297,7 +315,7 @@ void DQMatMulToMatMulNBitsRules(SelectorActionRegistry& qdq_selector_action_regi
   std::vector<const char*> providers = {kCpuExecutionProvider, kCudaExecutionProvider, kDmlExecutionProvider};
   std::unique_ptr<NodeSelector> selector = std::make_unique<QDQ::DQMatMulToMatMulNBitsSelector>(providers);
   qdq_selector_action_registry.RegisterSelectorAndAction(action_name,
-                                                         {{"MatMul", {}}},
+                                                         {{"MatMul", {}}, {"Gemm", {}}},
                                                          std::move(selector),
                                                          std::move(action));
 
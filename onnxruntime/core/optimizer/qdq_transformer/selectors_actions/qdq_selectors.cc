@@ -421,6 +421,33 @@ bool MatMulNodeGroupSelector::Check(const GraphViewer& graph_viewer,
   }
 }
 
+bool DQMatMulNodeGroupSelector::CheckGemmAsMatMul(const Graph& graph, const Node& node, const Node& dq_node) {
+  const auto* trans_a = graph_utils::GetNodeAttribute(node, "transA");
+  const auto* trans_b = graph_utils::GetNodeAttribute(node, "transB");
+  const auto* alpha = graph_utils::GetNodeAttribute(node, "alpha");
+  const auto* beta = graph_utils::GetNodeAttribute(node, "beta");
+  if ((trans_a && trans_a->i() != 0) || (trans_b && trans_b->i() != 0) || (alpha && alpha->f() != 1.0f)) {
+    return false;
+  }
+
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() < 3 || !input_defs[2]->Exists()) {
+    return true;
+  }
+
+  // the bias becomes the bias input of MatMulNBits, which only the CPU EP supports
+  if (node.GetExecutionProviderType() != kCpuExecutionProvider || (beta && beta->f() != 1.0f)) {
+    return false;
+  }
+
+  const auto* bias_tensor_proto = graph.GetConstantInitializer(input_defs[2]->Name(), true);
+  const auto* weight_shape = dq_node.InputDefs()[0]->Shape();
+  return bias_tensor_proto && weight_shape && weight_shape->dim_size() == 2 &&
+         weight_shape->dim(1).has_dim_value() && bias_tensor_proto->dims_size() == 1 &&
+         bias_tensor_proto->dims()[0] == weight_shape->dim(1).dim_value() &&
+         bias_tensor_proto->data_type() == input_defs[0]->TypeAsProto()->tensor_type().elem_type();
+}
+
 bool DQMatMulNodeGroupSelector::Check(const GraphViewer& graph_viewer,
                                       const Node& node,
                                       const std::vector<const Node*>& dq_nodes,
@@ -442,6 +469,11 @@ bool DQMatMulNodeGroupSelector::Check(const GraphViewer& graph_viewer,
     return false;
   }
 
+  // Gemm must compute A * B, with an optional constant bias of shape [N] that is added as it is
+  if (node.OpType() == "Gemm" && !CheckGemmAsMatMul(graph, node, *dq_nodes[0])) {
+    return false;
+  }
+
   // DQ weight/zero points types are int4/uint4, scales/output types are float or float16
   const auto* weight_arg = dq_nodes[0]->InputDefs()[0];
   const auto* scale_arg = dq_nodes[0]->InputDefs()[1];
@@ -0,0 +1,225 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/quantized_embedding_sharing.h"
+
+#include <vector>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/narrow.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// MatMulNBits input indices
+constexpr int kB = 1, kScales = 2, kZeroPoints = 3, kGIdx = 4;
+// GatherBlockQuantized input indices
+constexpr int kData = 0, kGatherScales = 2, kGatherZeroPoints = 3;
+
+bool HasInput(const Node& node, int index) {
+  return node.InputDefs().size() > static_cast<size_t>(index) && node.InputDefs()[index]->Exists();
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr && attr->has_i() ? attr->i() : default_value;
+}
+
+const TensorProto* GetConstantInput(const Graph& graph, const Node& node, int index) {
+  return HasInput(node, index) ? graph_utils::GetConstantInitializer(graph, node.InputDefs()[index]->Name())
+                               : nullptr;
+}
+
+// the 4-bit value i of data packed two per byte, low bits first
+int32_t GetPacked4Bits(const std::vector<uint8_t>& data, int64_t i) {
+  return (data[narrow<size_t>(i >> 1)] >> ((i & 1) * 4)) & 0x0F;
+}
+
+// The constant inputs of a GatherBlockQuantized gathering rows of a uint4 [N, K] weight quantized along K.
+struct EmbeddingWeight {
+  int64_t N{0};
+  int64_t K{0};
+  int64_t block_size{0};
+  int32_t scales_type{0};
+  std::vector<uint8_t> data;
+  std::vector<uint8_t> scales;
+  // uint4 [N, K / block_size], packed along the flattened tensor. Empty if the zero point is 0.
+  std::vector<uint8_t> zero_points;
+};
+
+bool GetEmbeddingWeight(const Graph& graph, const Node& gather, EmbeddingWeight& weight) {
+  const TensorProto* data = GetConstantInput(graph, gather, kData);
+  const TensorProto* scales = GetConstantInput(graph, gather, kGatherScales);
+  const TensorProto* zero_points = GetConstantInput(graph, gather, kGatherZeroPoints);
+  if (data == nullptr || data->data_type() != TensorProto::UINT4 || data->dims_size() != 2 || scales == nullptr ||
+      (HasInput(gather, kGatherZeroPoints) && zero_points == nullptr)) {
+    return false;
+  }
+
+  const int64_t gather_axis = GetIntAttribute(gather, "gather_axis", 0);
+  const int64_t quantize_axis = GetIntAttribute(gather, "quantize_axis", 1);
+  weight.N = data->dims(0);
+  weight.K = data->dims(1);
+  weight.block_size = GetIntAttribute(gather, "block_size", 128);
+  weight.scales_type = scales->data_type();
+  // the MatMulNBits blocks are padded, so only whole blocks are laid out the same
+  if ((gather_axis != 0 && gather_axis != -2) || (quantize_axis != 1 && quantize_axis != -1) ||
+      weight.block_size <= 0 || weight.K % weight.block_size != 0) {
+    return false;
+  }
+
+  return utils::UnpackInitializerData(*data, graph.ModelPath(), weight.data).IsOK() &&
+         utils::UnpackInitializerData(*scales, graph.ModelPath(), weight.scales).IsOK() &&
+         (zero_points == nullptr ||
+          utils::UnpackInitializerData(*zero_points, graph.ModelPath(), weight.zero_points).IsOK());
+}
+
+// Whether a 4-bit MatMulNBits over the [N, K] weight holds the same quantized weight. Its data and zero points are
+// returned if it does.
+bool IsTied(const Graph& graph, const Node& matmul, const EmbeddingWeight& weight,
+            std::vector<uint8_t>& matmul_data, std::vector<uint8_t>& matmul_zero_points) {
+  if (GetIntAttribute(matmul, "N", 0) != weight.N || GetIntAttribute(matmul, "K", 0) != weight.K ||
+      GetIntAttribute(matmul, "block_size", 0) != weight.block_size) {
+    return false;
+  }
+
+  const TensorProto* b = GetConstantInput(graph, matmul, kB);
+  const TensorProto* scales = GetConstantInput(graph, matmul, kScales);
+  const TensorProto* zero_points = GetConstantInput(graph, matmul, kZeroPoints);
+  if (b == nullptr || b->data_type() != TensorProto::UINT8 || scales == nullptr ||
+      scales->data_type() != weight.scales_type ||
+      (HasInput(matmul, kZeroPoints) && (zero_points == nullptr || zero_points->data_type() != TensorProto::UINT8))) {
+    return false;
+  }
+
+  std::vector<uint8_t> scales_data;
+  if (!utils::UnpackInitializerData(*b, graph.ModelPath(), matmul_data).IsOK() || matmul_data != weight.data ||
+      !utils::UnpackInitializerData(*scales, graph.ModelPath(), scales_data).IsOK() ||
+      scales_data != weight.scales) {
+    return false;
+  }
+
+  matmul_zero_points.clear();
+  if (zero_points != nullptr &&
+      !utils::UnpackInitializerData(*zero_points, graph.ModelPath(), matmul_zero_points).IsOK()) {
+    return false;
+  }
+
+  // MatMulNBits packs the zero points of each row, and defaults them to 8
+  const int64_t num_blocks = weight.K / weight.block_size;
+  const int64_t zero_points_per_row = (num_blocks + 1) / 2;
+  if (!matmul_zero_points.empty() &&
+      matmul_zero_points.size() != static_cast<size_t>(weight.N * zero_points_per_row)) {
+    return false;
+  }
+
+  for (int64_t n = 0; n < weight.N; ++n) {
+    for (int64_t block = 0; block < num_blocks; ++block) {
+      const int32_t gather_zp = weight.zero_points.empty()
+                                    ? 0
+                                    : GetPacked4Bits(weight.zero_points, n * num_blocks + block);
+      const int32_t matmul_zp = matmul_zero_points.empty()
+                                    ? 8
+                                    : GetPacked4Bits(matmul_zero_points, n * zero_points_per_row * 2 + block);
+      if (gather_zp != matmul_zp) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+NodeArg& AddUInt8Initializer(Graph& graph, const std::string& base_name, const std::vector<uint8_t>& data,
+                             int64_t rows) {
+  TensorProto tensor;
+  tensor.set_name(graph.GenerateNodeArgName(base_name));
+  tensor.set_data_type(TensorProto::UINT8);
+  tensor.add_dims(rows);
+  tensor.add_dims(static_cast<int64_t>(data.size()) / rows);
+  utils::SetRawDataInTensorProto(tensor, data.data(), data.size());
+  return graph_utils::AddInitializer(graph, tensor);
+}
+
+}  // namespace
+
+Status QuantizedEmbeddingSharing::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedVector<NodeIndex> gathers;
+  InlinedVector<NodeIndex> matmuls;
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr) continue;  // Node was removed.
+
+    auto& node = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "GatherBlockQuantized", {1}, kMSDomain)) {
+      gathers.push_back(node_index);
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMulNBits", {1}, kMSDomain) &&
+               GetIntAttribute(node, "bits", 4) == 4 && !HasInput(node, kGIdx)) {
+      matmuls.push_back(node_index);
+    }
+  }
+
+  for (auto gather_index : gathers) {
+    Node& gather = *graph.GetNode(gather_index);
+    EmbeddingWeight weight;
+    if (!GetEmbeddingWeight(graph, gather, weight)) {
+      continue;
+    }
+
+    for (auto matmul_index : matmuls) {
+      Node& matmul = *graph.GetNode(matmul_index);
+      std::vector<uint8_t> data;
+      std::vector<uint8_t> zero_points;
+      if (!IsTied(graph, matmul, weight, data, zero_points)) {
+        continue;
+      }
+
+      // MatMulNBits only reads the size of its data and scales, so the [N, K / 2] data and the [N, K / block_size]
+      // scales of the GatherBlockQuantized are valid inputs
+      NodeArg& shared_data = AddUInt8Initializer(graph, matmul.InputDefs()[kB]->Name() + "_shared", data, weight.N);
+      graph_utils::ReplaceNodeInput(gather, kData, shared_data);
+      graph_utils::ReplaceNodeInput(matmul, kB, shared_data);
+      graph_utils::ReplaceNodeInput(matmul, kScales, *gather.MutableInputDefs()[kGatherScales]);
+
+      if (!zero_points.empty()) {
+        NodeArg& shared_zero_points = AddUInt8Initializer(
+            graph, matmul.InputDefs()[kZeroPoints]->Name() + "_shared", zero_points, weight.N);
+        graph_utils::ReplaceNodeInput(matmul, kZeroPoints, shared_zero_points);
+        if (gather.InputDefs().size() > static_cast<size_t>(kGatherZeroPoints)) {
+          graph_utils::ReplaceNodeInput(gather, kGatherZeroPoints, shared_zero_points);
+        } else {
+          graph_utils::AddNodeInput(gather, kGatherZeroPoints, shared_zero_points);
+        }
+      } else if (HasInput(gather, kGatherZeroPoints)) {
+        // the zero points are 8, the default of uint8 data with bits=4
+        graph_utils::ReplaceNodeInput(gather, kGatherZeroPoints, graph.GetOrCreateNodeArg("", nullptr));
+      }
+
+      gather.AddAttribute("bits", static_cast<int64_t>(4));
+
+      LOGS(logger, INFO) << "Sharing the quantized weight of " << gather.Name() << " and " << matmul.Name();
+      modified = true;
+      break;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class QuantizedEmbeddingSharing
+
+Store a tied embedding weight once when it is quantized twice: for the embedding GatherBlockQuantized as a uint4
+[vocab_size, hidden_size] tensor, and for the lm_head MatMulNBits as 4-bit blocks.
+
+If both hold the same quantized values, scales and zero points, the GatherBlockQuantized reads the MatMulNBits blocks
+as uint8 data with bits=4, and both nodes share one data, scales and zero points initializer.
+*/
+class QuantizedEmbeddingSharing : public GraphTransformer {
+ public:
+  QuantizedEmbeddingSharing(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("QuantizedEmbeddingSharing", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
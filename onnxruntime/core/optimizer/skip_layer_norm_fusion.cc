@@ -25,10 +25,12 @@ static bool IsSupportedDataType(const Node& node) {
   return true;
 }
 
-static bool CheckFirstAdd(Node& add, ProviderType providertype) {
+// When allow_residual is true, the sum may also be consumed by other nodes, which then read the
+// input_skip_bias_sum output of the fused node.
+static bool CheckFirstAdd(Node& add, ProviderType providertype, bool allow_residual = false) {
   if (providertype != add.GetExecutionProviderType() ||
       !IsSupportedDataType(add) ||
-      add.GetOutputEdgesCount() != 1) {
+      (add.GetOutputEdgesCount() != 1 && !allow_residual)) {
     return false;
   }
 
@@ -121,6 +123,28 @@ static NodeArg* CastToFloat(Graph& graph, NodeArg* input, int32_t output_data_ty
   return &cast_float;
 }
 
+// Whether the norm node normalizes only the last axis of its 3D input.
+static bool NormalizesLastAxis(const Node& norm_node) {
+  const auto* axis = graph_utils::GetNodeAttribute(norm_node, "axis");
+  return axis == nullptr || !axis->has_i() || axis->i() == -1 || axis->i() == 2;
+}
+
+// Whether the outputs of the norm node other than its output Y are unused.
+static bool OnlyFirstOutputUsed(const Graph& graph, const Node& norm_node) {
+  for (auto it = norm_node.OutputEdgesBegin(); it != norm_node.OutputEdgesEnd(); ++it) {
+    if (it->GetSrcArgIndex() != 0) {
+      return false;
+    }
+  }
+  const auto& graph_outputs = graph.GetOutputs();
+  for (size_t i = 1; i < norm_node.OutputDefs().size(); ++i) {
+    if (std::find(graph_outputs.begin(), graph_outputs.end(), norm_node.OutputDefs()[i]) != graph_outputs.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /**
 Skip Layer Normalization will fuse Add + LayerNormalization into one node, and another Add if applicable
 
@@ -158,6 +182,16 @@ After fusion:
           \    /
     SkipLayerNormalization
 
+Add + SimplifiedLayerNormalization (RMSNorm) is fused the same way into SkipSimplifiedLayerNormalization. In decoders
+the residual sum Add1 is also the skip input of the next block, so Add1 may have other consumers, which then read the
+input_skip_bias_sum output of the fused node:
+
+      [Sub1]   [Sub2]                       [Sub1]   [Sub2]
+         \       /                             \       /
+            Add1 -----> [Sub3]    =>      SkipSimplifiedLayerNormalization
+             |                                 |              |
+   SimplifiedLayerNormalization               Y            [Sub3]
+
 Note: This fusion doesn't consider the following case:
       [Sub1]   [Sub2]
          \       /
@@ -181,12 +215,24 @@ Status SkipLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_le
     Node& ln_node = *p_layernorm;
     ORT_RETURN_IF_ERROR(Recurse(ln_node, modified, graph_level, logger));
 
-    if (!graph_utils::IsSupportedOptypeVersionAndDomain(ln_node, "LayerNormalization", {1, 17}) ||
+    const bool simplified =
+        graph_utils::IsSupportedOptypeVersionAndDomain(ln_node, "SimplifiedLayerNormalization", {1});
+    if ((!simplified && !graph_utils::IsSupportedOptypeVersionAndDomain(ln_node, "LayerNormalization", {1, 17})) ||
         !graph_utils::IsSupportedProvider(ln_node, GetCompatibleExecutionProviders()) ||
         !IsSupportedDataType(ln_node)) {
       continue;
     }
 
+    // SkipSimplifiedLayerNormalization normalizes the last axis and only outputs Y and the sum.
+    // Its input, skip and gamma have the same type, so the sum cannot be consumed when inputs are cast.
+    const bool allow_residual = simplified &&
+                                ln_node.InputDefs()[0]->TypeAsProto()->tensor_type().elem_type() ==
+                                    ln_node.OutputDefs()[0]->TypeAsProto()->tensor_type().elem_type();
+    if (simplified && (ln_node.GetExecutionProviderType() == kAclExecutionProvider || !NormalizesLastAxis(ln_node) ||
+                       !OnlyFirstOutputUsed(graph, ln_node))) {
+      continue;
+    }
+
     enum class Format : int8_t {
       Format1,
       Format2,
@@ -208,9 +254,9 @@ Status SkipLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_le
       p_add1 = const_cast<Node*>(&edges[0]->GetNode());
       p_add2 = const_cast<Node*>(&edges[1]->GetNode());
 
-      if (CheckFirstAdd(*p_add1, ln_node.GetExecutionProviderType()) &&
+      if (CheckFirstAdd(*p_add1, ln_node.GetExecutionProviderType(), allow_residual) &&
           CheckSecondAdd(graph, *p_add2, ln_node.GetExecutionProviderType()) &&
-          !graph.NodeProducesGraphOutput(*p_add1) &&
+          (allow_residual || !graph.NodeProducesGraphOutput(*p_add1)) &&
           !graph.NodeProducesGraphOutput(*p_add2)) {
         matched_format = Format::Format1;
       }
@@ -226,9 +272,9 @@ Status SkipLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_le
         p_add1 = const_cast<Node*>(&edges[0]->GetNode());
         p_add2 = const_cast<Node*>(&edges[1]->GetNode());
 
-        if (CheckFirstAdd(*p_add1, ln_node.GetExecutionProviderType()) &&
+        if (CheckFirstAdd(*p_add1, ln_node.GetExecutionProviderType(), allow_residual) &&
             CheckSecondAdd(graph, *p_add2, ln_node.GetExecutionProviderType()) &&
-            !graph.NodeProducesGraphOutput(*p_add1) &&
+            (allow_residual || !graph.NodeProducesGraphOutput(*p_add1)) &&
             !graph.NodeProducesGraphOutput(*p_add2)) {
           matched_format = Format::Format2;
         }
@@ -243,8 +289,8 @@ Status SkipLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_le
       if (graph_utils::FindPath(ln_node, true, format3_parent_path, edges, logger)) {
         p_add1 = const_cast<Node*>(&edges[0]->GetNode());
 
-        if (CheckFirstAdd(*p_add1, ln_node.GetExecutionProviderType()) &&
-            !graph.NodeProducesGraphOutput(*p_add1)) {
+        if (CheckFirstAdd(*p_add1, ln_node.GetExecutionProviderType(), allow_residual) &&
+            (allow_residual || !graph.NodeProducesGraphOutput(*p_add1))) {
           matched_format = Format::Format3;
         }
       }
@@ -261,6 +307,10 @@ Status SkipLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_le
                                                        p_add1->MutableInputDefs()[1],
                                                        ln_node.MutableInputDefs()[1],
                                                        ln_node.MutableInputDefs().size() == 2 ? &beta_place_holder : ln_node.MutableInputDefs()[2]};
+    if (simplified) {
+      // SkipSimplifiedLayerNormalization has no beta input.
+      skip_layer_norm_input_defs.pop_back();
+    }
 
     if (matched_format == Format::Format1) {
       skip_layer_norm_input_defs[0] = p_add2->MutableInputDefs()[0];
@@ -283,17 +333,33 @@ Status SkipLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_le
                               ln_node.GetExecutionProviderType());
     }
 
-    Node& skip_layer_norm_node = graph.AddNode(graph.GenerateNodeName("SkipLayerNormalization"),
-                                               "SkipLayerNormalization",
+    InlinedVector<NodeArg*> skip_layer_norm_output_defs{ln_node.MutableOutputDefs().begin(),
+                                                        ln_node.MutableOutputDefs().end()};
+    if (simplified) {
+      // The mean and inv_std_var outputs are unused, and the sum is output if Add1 has other consumers.
+      skip_layer_norm_output_defs.resize(1);
+      if (p_add1->GetOutputEdgesCount() > 1 || graph.NodeProducesGraphOutput(*p_add1)) {
+        NodeArg& place_holder = graph.GetOrCreateNodeArg("", nullptr);
+        skip_layer_norm_output_defs.insert(skip_layer_norm_output_defs.end(),
+                                           {&place_holder, &place_holder, p_add1->MutableOutputDefs()[0]});
+      }
+    }
+
+    const std::string op_type = simplified ? "SkipSimplifiedLayerNormalization" : "SkipLayerNormalization";
+    Node& skip_layer_norm_node = graph.AddNode(graph.GenerateNodeName(op_type),
+                                               op_type,
                                                "fused SkipLayerNorm subgraphs ",
                                                skip_layer_norm_input_defs,
-                                               ln_node.MutableOutputDefs(), {}, kMSDomain);
+                                               skip_layer_norm_output_defs, {}, kMSDomain);
     // Get attribute "epsilon" from "LayerNormalization" node if available. Else, default value
     // will be used.
     NodeAttributes ln_attrs = ln_node.GetAttributes();
     NodeAttributes::const_iterator epsilon = ln_attrs.find("epsilon");
     if (epsilon != ln_attrs.end()) {
       skip_layer_norm_node.AddAttributeProto(epsilon->second);
+    } else if (simplified) {
+      // the default epsilon of SimplifiedLayerNormalization
+      skip_layer_norm_node.AddAttribute("epsilon", 1e-5f);
     } else {
       skip_layer_norm_node.AddAttribute("epsilon", contrib::kDefaultSkipLayerNormEpsilon);
     }
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include "core/graph/constants.h"
 #include "core/framework/utils.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/optimizer/transpose_optimization/ort_optimizer_utils.h"
 
 using namespace onnx_transpose_optimization;
@@ -89,7 +90,9 @@ static bool HandleMaxPool(HandlerArgs& args) {
 
   auto info = args.ctx.graph.GetValueInfo(outputs[0]);
   api::DataType dtype = info->DType();
-  if (dtype != api::DataType::UINT8 && dtype != api::DataType::INT8) {
+  // fp32 is only converted where the NCHWc transformer doesn't already handle MaxPool with blocked kernels.
+  if (dtype != api::DataType::UINT8 && dtype != api::DataType::INT8 &&
+      (dtype != api::DataType::FLOAT || MlasNchwcGetBlockSize() > 1)) {
     return false;
   }
 
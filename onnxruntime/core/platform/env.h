@@ -91,6 +91,15 @@ struct ThreadOptions {
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
   int dynamic_block_base_ = 0;
+
+  // NUMA node of each thread, in the same order as affinities: the first element is for the thread that enters the
+  // parallel loops and is not created by the pool. If the vector is not empty, parallel loops give the threads of a
+  // node a contiguous part of the iteration space, so that they keep touching the same memory from one loop to the next.
+  std::vector<int> numa_nodes;
+
+  // Create the threads on the first parallel loop, parallel section or scheduled task instead of with the pool, so
+  // a pool whose work is never divided between threads costs no threads. The first loop pays for creating them.
+  bool create_threads_lazily = false;
 };
 
 std::ostream& operator<<(std::ostream& os, const LogicalProcessors&);
@@ -149,6 +158,20 @@ class Env {
 
   virtual int GetL2CacheSize() const = 0;
 
+  /// <summary>
+  /// The API returns the logical processors of each NUMA node that has processors
+  /// </summary>
+  /// <returns>The logical processors of each node, or an empty vector if the topology is not known</returns>
+  virtual std::vector<LogicalProcessors> GetNumaNodeProcessors() const { return {}; }
+
+  /// <summary>
+  /// The API returns the logical processors of each physical core of the highest performance class
+  /// on systems with cores of different performance classes, e.g. P-cores and E-cores
+  /// </summary>
+  /// <returns>The logical processors of each performance core, or an empty vector if all the cores are of
+  /// the same class or the classes are not known</returns>
+  virtual std::vector<LogicalProcessors> GetPerformanceCoreAffinities() const { return {}; }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
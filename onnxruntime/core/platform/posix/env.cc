@@ -31,6 +31,9 @@ limitations under the License.
 #endif
 #include <unistd.h>
 
+#include <algorithm>
+#include <charconv>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <thread>
@@ -53,6 +56,7 @@ limitations under the License.
 #include <gsl/gsl>
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
+#include "core/common/string_utils.h"
 #include "core/platform/scoped_resource.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 
@@ -254,6 +258,35 @@ class PosixThread : public EnvThread {
   pthread_t hThread;
 };
 
+#if defined(__linux__)
+// Reads a list of ids in the format of the cpu and node lists of sysfs, e.g. "0-3,8-11".
+// Returns an empty list if the file does not exist or cannot be parsed.
+std::vector<int> ReadSysfsIdList(const std::string& file_path) {
+  std::ifstream file(file_path);
+  std::string line;
+  if (!file || !std::getline(file, line)) {
+    return {};
+  }
+
+  std::vector<int> ids;
+  for (const auto interval : utils::SplitString(line, ",")) {
+    const auto dash = interval.find('-');
+    const auto first_str = interval.substr(0, dash);
+    const auto last_str = dash == std::string_view::npos ? first_str : interval.substr(dash + 1);
+    int first = 0, last = 0;
+    if (std::from_chars(first_str.data(), first_str.data() + first_str.size(), first).ec != std::errc{} ||
+        std::from_chars(last_str.data(), last_str.data() + last_str.size(), last).ec != std::errc{} ||
+        first < 0 || first > last) {
+      return {};
+    }
+    for (int id = first; id <= last; ++id) {
+      ids.push_back(id);
+    }
+  }
+  return ids;
+}
+#endif
+
 class PosixEnv : public Env {
  public:
   static PosixEnv& Instance() {
@@ -308,6 +341,70 @@ class PosixEnv : public Env {
     return ret;
   }
 
+  std::vector<LogicalProcessors> GetNumaNodeProcessors() const override {
+    std::vector<LogicalProcessors> ret;
+#if defined(__linux__)
+    for (int node : ReadSysfsIdList("/sys/devices/system/node/online")) {
+      auto processors = ReadSysfsIdList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+      // nodes with memory only, e.g. CXL memory expanders, have no processors
+      if (!processors.empty()) {
+        ret.push_back(std::move(processors));
+      }
+    }
+#endif
+    return ret;
+  }
+
+  std::vector<LogicalProcessors> GetPerformanceCoreAffinities() const override {
+    std::vector<LogicalProcessors> ret;
+#if defined(__linux__)
+    // Intel hybrid processors expose their P-cores and E-cores as two PMUs. Other processors, e.g. ARM big.LITTLE,
+    // expose the relative capacity of each logical processor.
+    std::vector<int> performance_processors;
+    if (!ReadSysfsIdList("/sys/devices/cpu_atom/cpus").empty()) {
+      performance_processors = ReadSysfsIdList("/sys/devices/cpu_core/cpus");
+    } else {
+      std::vector<std::pair<int, int>> capacities;
+      int max_capacity = 0;
+      for (int processor : ReadSysfsIdList("/sys/devices/system/cpu/online")) {
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(processor) + "/cpu_capacity");
+        int capacity = 0;
+        if (!(file >> capacity)) {
+          return ret;
+        }
+        capacities.emplace_back(processor, capacity);
+        max_capacity = std::max(max_capacity, capacity);
+      }
+      for (const auto& [processor, capacity] : capacities) {
+        if (capacity == max_capacity) {
+          performance_processors.push_back(processor);
+        }
+      }
+      if (performance_processors.size() == capacities.size()) {
+        return ret;
+      }
+    }
+    if (performance_processors.empty()) {
+      return ret;
+    }
+
+    for (auto& core : GetDefaultThreadAffinities()) {
+      if (!core.empty() &&
+          std::find(performance_processors.begin(), performance_processors.end(), core[0]) !=
+              performance_processors.end()) {
+        ret.push_back(std::move(core));
+      }
+    }
+    // the physical cores are not known without cpuinfo
+    if (ret.empty()) {
+      for (int processor : performance_processors) {
+        ret.push_back({processor});
+      }
+    }
+#endif
+    return ret;
+  }
+
   int GetL2CacheSize() const override {
 #ifdef _SC_LEVEL2_CACHE_SIZE
     return static_cast<int>(sysconf(_SC_LEVEL2_CACHE_SIZE));
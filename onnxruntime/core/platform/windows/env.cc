@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "core/platform/windows/env.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <optional>
@@ -307,6 +308,14 @@ int WindowsEnv::GetL2CacheSize() const {
   return l2_cache_size_;
 }
 
+std::vector<LogicalProcessors> WindowsEnv::GetNumaNodeProcessors() const {
+  return numa_nodes_;
+}
+
+std::vector<LogicalProcessors> WindowsEnv::GetPerformanceCoreAffinities() const {
+  return performance_cores_;
+}
+
 WindowsEnv& WindowsEnv::Instance() {
   static WindowsEnv default_env;
   return default_env;
@@ -902,6 +911,7 @@ void WindowsEnv::InitializeCpuInfo() {
 
   int core_id = 0;
   int global_processor_id = 0;
+  std::vector<BYTE> core_efficiency_classes;
   const BYTE* iter = reinterpret_cast<const BYTE*>(processorInfos);
   const BYTE* end = iter + returnLength;
   std::stringstream log_stream;
@@ -935,11 +945,56 @@ void WindowsEnv::InitializeCpuInfo() {
         }
       }
       cores_.push_back(std::move(core_global_proc_ids));
+      core_efficiency_classes.push_back(processor_info->Processor.EfficiencyClass);
       core_id++;
     }
     iter += size;
   }
 
+  // a higher efficiency class means a faster and less power efficient core
+  if (!core_efficiency_classes.empty()) {
+    const auto [min_class, max_class] =
+        std::minmax_element(core_efficiency_classes.begin(), core_efficiency_classes.end());
+    if (*min_class != *max_class) {
+      for (size_t i = 0; i < cores_.size(); ++i) {
+        if (core_efficiency_classes[i] == *max_class) {
+          performance_cores_.push_back(cores_[i]);
+        }
+      }
+    }
+  }
+
+  DWORD numaLength = 0;
+  GetLogicalProcessorInformationEx(RelationNumaNode, nullptr, &numaLength);
+  if (GetLastError() == ERROR_INSUFFICIENT_BUFFER) {
+    std::unique_ptr<char[]> numaAllocation = std::make_unique<char[]>(numaLength);
+    auto numaInfos = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(numaAllocation.get());
+    if (GetLogicalProcessorInformationEx(RelationNumaNode, numaInfos, &numaLength)) {
+      iter = reinterpret_cast<const BYTE*>(numaInfos);
+      end = iter + numaLength;
+      while (iter < end) {
+        auto processor_info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(iter);
+        if (processor_info->Relationship == RelationNumaNode) {
+          const auto& group_mask = processor_info->NumaNode.GroupMask;
+          constexpr KAFFINITY bit = 1;
+          LogicalProcessors node_global_proc_ids;
+          for (int id = 0; id < global_processor_id; ++id) {
+            const auto& info = global_processor_info_map_[id];
+            if (info.group_id == static_cast<int>(group_mask.Group) &&
+                (group_mask.Mask & (bit << info.local_processor_id))) {
+              node_global_proc_ids.push_back(id);
+            }
+          }
+          // nodes with memory only have no processors
+          if (!node_global_proc_ids.empty()) {
+            numa_nodes_.push_back(std::move(node_global_proc_ids));
+          }
+        }
+        iter += processor_info->Size;
+      }
+    }
+  }
+
   DWORD newLength = 0;
   GetLogicalProcessorInformationEx(RelationCache, nullptr, &newLength);
   last_error = GetLastError();
@@ -987,7 +1042,8 @@ void WindowsEnv::InitializeCpuInfo() {
   }
 
   if (logging::LoggingManager::HasDefaultLogger()) {
-    LOGS_DEFAULT(VERBOSE) << "Found total " << cores_.size() << " core(s) from windows system:";
+    LOGS_DEFAULT(VERBOSE) << "Found total " << cores_.size() << " core(s) in " << numa_nodes_.size()
+                          << " NUMA node(s) from windows system:";
     LOGS_DEFAULT(VERBOSE) << log_stream.str();
     LOGS_DEFAULT(VERBOSE) << "\nDetected L2 cache size: " << l2_cache_size_ << " bytes";
   }
@@ -56,6 +56,8 @@ class WindowsEnv : public Env {
   int GetNumPhysicalCpuCores() const override;
   std::vector<LogicalProcessors> GetDefaultThreadAffinities() const override;
   int GetL2CacheSize() const override;
+  std::vector<LogicalProcessors> GetNumaNodeProcessors() const override;
+  std::vector<LogicalProcessors> GetPerformanceCoreAffinities() const override;
   static WindowsEnv& Instance();
   PIDType GetSelfPid() const override;
   Status GetFileLength(_In_z_ const ORTCHAR_T* file_path, size_t& length) const override;
@@ -133,6 +135,15 @@ class WindowsEnv : public Env {
    * 0,1,2,3,0,1,2,3
    */
   GlobalProcessorInfoMap global_processor_info_map_;
+  /*
+   * "numa_nodes_" host the global processor ids of each NUMA node that has processors.
+   */
+  std::vector<LogicalProcessors> numa_nodes_;
+  /*
+   * "performance_cores_" host the cores of the highest efficiency class, i.e. the fastest cores,
+   * on systems with cores of different efficiency classes. It is empty otherwise.
+   */
+  std::vector<LogicalProcessors> performance_cores_;
   WindowsEnv();
 
  private:
@@ -7,6 +7,8 @@
 
 namespace onnxruntime {
 
+// The Azure EP registers no kernels. It only carries the "azure.*" session config entries, such as the endpoint type,
+// for the remote inference custom ops of onnxruntime-extensions, which own the HTTP clients and issue the requests.
 class AzureExecutionProvider : public IExecutionProvider {
  public:
   explicit AzureExecutionProvider(const std::unordered_map<std::string, std::string>& config);
@@ -179,6 +179,71 @@ Status CreateInputFeatureProvider(const std::unordered_map<std::string, OnnxTens
   return Status::OK();
 }
 
+// Creates MLMultiArrays backed by the ORT output tensors for the outputs with a static shape, so that CoreML can
+// write the output values directly into them. The outputs with types CoreML doesn't produce are skipped.
+API_AVAILABLE_COREML5
+Status CreateOutputBackings(const std::unordered_map<std::string, OnnxTensorInfo>& outputs,
+                            const GetOutputTensorMutableRawDataFn& get_output_tensor_mutable_raw_data_fn,
+                            NSMutableDictionary<NSString*, id>* output_backings) {
+  NSError* error = nil;
+  for (const auto& [name, output_tensor_info] : outputs) {
+    const auto& shape = output_tensor_info.shape;
+    if (!IsStaticShape(shape) || DoesShapeSpecifyZeroElements(shape)) {
+      continue;
+    }
+
+    MLMultiArrayDataType data_type;
+    switch (output_tensor_info.data_type) {
+      case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+        data_type = MLMultiArrayDataTypeFloat32;
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+        data_type = MLMultiArrayDataTypeFloat16;
+        break;
+      case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+        data_type = MLMultiArrayDataTypeInt32;
+        break;
+      default:
+        // int64 outputs are produced as int32 by CoreML and converted when copied
+        continue;
+    }
+
+    void* output_buffer = get_output_tensor_mutable_raw_data_fn(name, output_tensor_info.data_type, shape);
+
+    // scalar outputs are {1} MLMultiArrays
+    const size_t rank = std::max<size_t>(shape.size(), 1);
+    NSMutableArray* shape_array = [NSMutableArray arrayWithCapacity:rank];
+    NSMutableArray* strides_array = [NSMutableArray arrayWithCapacity:rank];
+    if (shape.empty()) {
+      [shape_array addObject:[NSNumber numberWithLongLong:1]];
+      [strides_array addObject:[NSNumber numberWithLongLong:1]];
+    } else {
+      int64_t stride = 1;
+      for (size_t idx = 0; idx < shape.size(); ++idx) {
+        const size_t idx_from_end = shape.size() - 1 - idx;
+        [shape_array insertObject:[NSNumber numberWithLongLong:shape[idx_from_end]] atIndex:0];
+        [strides_array insertObject:[NSNumber numberWithLongLong:stride] atIndex:0];
+        stride *= shape[idx_from_end];
+      }
+    }
+
+    MLMultiArray* multi_array = [[MLMultiArray alloc] initWithDataPointer:output_buffer
+                                                                    shape:shape_array
+                                                                 dataType:data_type
+                                                                  strides:strides_array
+                                                              deallocator:^(void* /* bytes */) {
+                                                              }
+                                                                    error:&error];
+    ORT_RETURN_IF(error != nil || multi_array == nil,
+                  "Failed to create MLMultiArray output backing for: ", name,
+                  (error != nil) ? MakeString(", error: ", [[error localizedDescription] UTF8String]) : "");
+
+    output_backings[util::Utf8StringToNSString(name.c_str())] = multi_array;
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 void StridedCopy(const T* src_buffer, T* dst_buffer, size_t block_size,
                  size_t num_blocks, size_t src_stride, size_t dst_stride) {
@@ -197,6 +262,11 @@ Status CopyMLMultiArrayBuffer(const void* mlmultiarray_buffer, void* tensor_buff
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "mlmultiarray_buffer has no data");
   }
 
+  if (mlmultiarray_buffer == tensor_buffer) {
+    // CoreML wrote the output directly into the tensor through its output backing
+    return Status::OK();
+  }
+
   // total including non-contiguous space
 
   int64_t array_total_elements = [array.strides[0] longLongValue] * [array.shape[0] longLongValue];
@@ -461,6 +531,8 @@ class Execution {
   const logging::Logger& logger_;
   CoreMLOptions coreml_options_;
   MLModel* model_{nil};
+  // set if CoreML fails to predict into the ORT output tensors, in which case the outputs are copied
+  bool output_backings_unsupported_{false};
 };
 
 Execution::Execution(const std::string& path, const logging::Logger& logger, const CoreMLOptions& coreml_options)
@@ -591,11 +663,36 @@ Status Execution::Predict(const std::unordered_map<std::string, OnnxTensorData>&
         ORT_RETURN_IF_ERROR(CreateInputFeatureProvider(inputs, logger_, &input_features, conversion_buffers));
 
         MLPredictionOptions* options = [[MLPredictionOptions alloc] init];
+        bool use_output_backings = false;
+        if (@available(macOS 12, iOS 15, *)) {
+          // ML Program output shapes match the ONNX ones, so the outputs with a static shape can be backed by the
+          // ORT output tensors and CoreML doesn't need to allocate them for us to copy from.
+          if (coreml_options_.CreateMLProgram() && !output_backings_unsupported_) {
+            NSMutableDictionary<NSString*, id>* output_backings = [NSMutableDictionary dictionary];
+            ORT_RETURN_IF_ERROR(CreateOutputBackings(outputs, get_output_tensor_mutable_raw_data_fn,
+                                                     output_backings));
+            if (output_backings.count > 0) {
+              options.outputBackings = output_backings;
+              use_output_backings = true;
+            }
+          }
+        }
+
         NSError* error = nil;
         id<MLFeatureProvider> output_features = [model_ predictionFromFeatures:input_features
                                                                        options:options
                                                                          error:&error];
 
+        if (error != nil && use_output_backings) {
+          LOGS(logger_, WARNING) << "CoreML prediction with output backings failed, retrying without them: "
+                                 << [[error localizedDescription] UTF8String];
+          output_backings_unsupported_ = true;
+          error = nil;
+          output_features = [model_ predictionFromFeatures:input_features
+                                                   options:[[MLPredictionOptions alloc] init]
+                                                     error:&error];
+        }
+
         if (error != nil) {
           return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Error executing model: ",
                                  [[error localizedDescription] UTF8String]);
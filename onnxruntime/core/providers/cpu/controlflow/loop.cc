@@ -15,6 +15,7 @@
 #include "core/framework/allocator.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/ort_value_tensor_slicer.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
@@ -193,6 +194,16 @@ Loop::Info::Info(const onnxruntime::Node& node, const GraphViewer& subgraph_in)
     auto& output = subgraph_outputs[i];
     subgraph_output_names.push_back(output->Name());
   }
+
+  // the condition is either a subgraph output directly, or forwarded by an Identity node
+  const auto& cond_in_name = subgraph_input_names[1];
+  const auto& cond_out_name = subgraph_output_names[0];
+  condition_is_loop_invariant = cond_out_name == cond_in_name;
+  if (!condition_is_loop_invariant) {
+    const auto* producer = subgraph.GetProducerNode(cond_out_name);
+    condition_is_loop_invariant = producer != nullptr && producer->OpType() == "Identity" &&
+                                  producer->InputDefs()[0]->Name() == cond_in_name;
+  }
 }
 
 class LoopImpl {
@@ -213,9 +224,18 @@ class LoopImpl {
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
   void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
 
+  // allocate the Loop outputs for all the iterations once the first one provided the per-iteration shape,
+  // and copy the first iteration's values to them.
+  Status AllocateScanOutputs(const std::vector<OrtValue>& first_iteration_outputs);
+
+  // add the slices of the Loop outputs that the next iteration writes to, to the fetches
+  void AddScanOutputSlices(std::vector<OrtValue>& fetches);
+
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
 
+  Status CopyTensor(const Tensor& src, Tensor& dst) const;
+
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
   const Loop::Info& info_;
@@ -232,6 +252,12 @@ class LoopImpl {
   // the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
 
+  // number of iterations if it's known before the first one, or -1.
+  // if known, each iteration writes its loop outputs directly to a slice of the Loop outputs so they don't need to
+  // be concatenated.
+  int64_t trip_count_;
+  std::vector<OrtValueTensorSlicer<OrtValue>::Iterator> scan_output_slices_;
+
   const Loop::ConcatOutput& concat_output_func_;
 };
 
@@ -394,6 +420,10 @@ LoopImpl::LoopImpl(OpKernelContextInternal& context,
 
   auto cond_tensor = context.Input<Tensor>(1);
   condition_ = cond_tensor ? *cond_tensor->Data<bool>() : true;
+
+  trip_count_ = max_trip_count_tensor && condition_ && subgraph_info.condition_is_loop_invariant
+                    ? std::max<int64_t>(max_trip_count_, 0)
+                    : -1;
 }
 
 Status LoopImpl::Initialize() {
@@ -465,6 +495,11 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
     next_inputs[i] = last_outputs[i - 1];
   }
 
+  // the loop outputs were written to the Loop outputs directly
+  if (!scan_output_slices_.empty()) {
+    return;
+  }
+
   // save loop outputs as we have to concatenate at the end
   for (ptrdiff_t j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
     ORT_ENFORCE(last_outputs[j + 1].IsTensor(), "All scan outputs MUST be tensors");
@@ -472,6 +507,56 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
   }
 }
 
+Status LoopImpl::CopyTensor(const Tensor& src, Tensor& dst) const {
+  // Safely use the IDataTransfer abstraction as we only allow using
+  // Loop on CUDA if the copy stream is the same as the compute stream.
+  // So there is no explicit sync required between the compute and copy streams
+  // to avoid data races.
+  auto* data_transfer = session_state_.GetDataTransferMgr().GetDataTransfer(src.Location().device,
+                                                                            dst.Location().device);
+  if (context_.GetComputeStream()) {
+    return data_transfer->CopyTensorAsync(src, dst, *context_.GetComputeStream());
+  }
+
+  return data_transfer->CopyTensor(src, dst);
+}
+
+Status LoopImpl::AllocateScanOutputs(const std::vector<OrtValue>& first_iteration_outputs) {
+  scan_output_slices_.reserve(static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars);
+
+  for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+    const auto& value = first_iteration_outputs[static_cast<ptrdiff_t>(i) + 1];  // skip cond
+    ORT_RETURN_IF_NOT(value.IsTensor(), "All scan outputs MUST be tensors");
+    const auto& per_iteration_output = value.Get<Tensor>();
+    const auto per_iteration_dims = per_iteration_output.Shape().GetDims();
+
+    // first dimension is number of iterations
+    TensorShapeVector dims;
+    dims.reserve(1 + per_iteration_dims.size());
+    dims.push_back(trip_count_);
+    std::copy(per_iteration_dims.begin(), per_iteration_dims.end(), std::back_inserter(dims));
+
+    Tensor* output = context_.Output(i, TensorShape(dims));
+    ORT_RETURN_IF(output == nullptr, "Failed to create output tensor for output #", i);
+
+    scan_output_slices_.push_back(OrtValueTensorSlicer<OrtValue>::Create(*context_.GetOutputMLValue(i)).begin());
+    ORT_RETURN_IF_ERROR(CopyTensor(per_iteration_output, *(*scan_output_slices_.back()).GetMutable<Tensor>()));
+  }
+
+  return Status::OK();
+}
+
+void LoopImpl::AddScanOutputSlices(std::vector<OrtValue>& fetches) {
+  // no pre-allocated values for cond and the loop carried vars
+  fetches.resize(static_cast<size_t>(info_.num_loop_carried_vars) + 1);
+
+  // the subgraph fails if the shape of a loop output doesn't match the slice
+  for (auto& slice : scan_output_slices_) {
+    ++slice;
+    fetches.push_back(*slice);
+  }
+}
+
 Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
   const auto& first_output = per_iteration_output.front().Get<Tensor>();
   const auto& per_iteration_dims = first_output.Shape().GetDims();
@@ -506,6 +591,10 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     if (iter_num_value != 0) {
       SaveOutputsAndUpdateFeeds(fetches, feeds);
       fetches.clear();
+
+      if (!scan_output_slices_.empty()) {
+        AddScanOutputSlices(fetches);
+      }
     }
 
     status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
@@ -518,6 +607,10 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
     condition_mlvalue_ = fetches[0];
 
+    if (iter_num_value == 0 && trip_count_ > 0 && info_.num_outputs > info_.num_loop_carried_vars) {
+      ORT_RETURN_IF_ERROR(AllocateScanOutputs(fetches));
+    }
+
     ++iter_num_value;
   }
 
@@ -593,6 +686,12 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       ORT_RETURN_IF_ERROR(copy_mlvalue_to_output(fetches[static_cast<ptrdiff_t>(i) + 1], i, iter_num_value, *info_.loop_carried_vars_types[static_cast<ptrdiff_t>(i)]));  // skip cond
     }
 
+    if (!scan_output_slices_.empty()) {
+      ORT_RETURN_IF_NOT(iter_num_value == trip_count_, "Loop stopped after ", iter_num_value,
+                        " iterations but the outputs were allocated for ", trip_count_);
+      return status;
+    }
+
     for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
       // add last output
       auto& per_iteration_outputs = loop_output_tensors_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars];
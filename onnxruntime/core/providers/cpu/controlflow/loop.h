@@ -38,6 +38,10 @@ class Loop : public controlflow::IControlFlowKernel {
     std::vector<std::string> subgraph_output_names;
 
     std::vector<const ONNX_NAMESPACE::TypeProto*> loop_carried_vars_types;
+
+    // true if the subgraph returns the condition it was given, in which case the Loop runs for the trip count if
+    // the initial condition is true.
+    bool condition_is_loop_invariant;
   };
 
   // function to concatenate the OrtValue instances from each Loop iteration into a single output buffer.
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/mlas/inc/mlas.h"
+
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+
+#include "core/framework/op_kernel.h"
+#include "core/providers/cpu/math/element_wise_ops.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Add, Sub, Mul and Div for type FP16, computed with the fp16
+ * vector arithmetic of the CPU, so the inputs are not cast to fp32 and back.
+ */
+template <MLAS_FP16_BINARY_OP Op>
+class BinaryFp16 final : public OpKernel {
+ public:
+  explicit BinaryFp16(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override {
+    ProcessBroadcastSpanFuncs funcs{
+        [](BroadcastHelper& per_iter_bh) {
+          auto input1 = per_iter_bh.SpanInput1<MLFloat16>();
+          auto output = per_iter_bh.OutputSpan<MLFloat16>();
+          MlasEltwiseBinaryFp16(Op, &per_iter_bh.ScalarInput0<MLFloat16>(), 0, input1.data(), 1,
+                                output.data(), output.size());
+        },
+        [](BroadcastHelper& per_iter_bh) {
+          auto input0 = per_iter_bh.SpanInput0<MLFloat16>();
+          auto output = per_iter_bh.OutputSpan<MLFloat16>();
+          MlasEltwiseBinaryFp16(Op, input0.data(), 1, &per_iter_bh.ScalarInput1<MLFloat16>(), 0,
+                                output.data(), output.size());
+        },
+        [](BroadcastHelper& per_iter_bh) {
+          auto input0 = per_iter_bh.SpanInput0<MLFloat16>();
+          auto input1 = per_iter_bh.SpanInput1<MLFloat16>();
+          auto output = per_iter_bh.OutputSpan<MLFloat16>();
+          MlasEltwiseBinaryFp16(Op, input0.data(), 1, input1.data(), 1, output.data(), output.size());
+        }};
+
+    UntypedBroadcastTwo(*context, funcs, 1.0);
+    return Status::OK();
+  }
+};
+
+//
+// Operator definitions
+//
+#define REG_BINARY_FP16_VERSIONED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, OP) \
+  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                     \
+      OP_TYPE,                                                                  \
+      VERSION_FROM, VERSION_TO,                                                 \
+      MLFloat16,                                                                \
+      KernelDefBuilder()                                                        \
+          .MayInplace({{0, 0}, {1, 0}})                                         \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),       \
+      BinaryFp16<OP>);
+
+#define REG_BINARY_FP16_KERNEL(OP_TYPE, VERSION, OP)                      \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                         \
+      OP_TYPE,                                                            \
+      VERSION,                                                            \
+      MLFloat16,                                                          \
+      KernelDefBuilder()                                                  \
+          .MayInplace({{0, 0}, {1, 0}})                                   \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()), \
+      BinaryFp16<OP>);
+
+REG_BINARY_FP16_VERSIONED_KERNEL(Add, 7, 12, MlasFp16Add)
+REG_BINARY_FP16_VERSIONED_KERNEL(Add, 13, 13, MlasFp16Add)
+REG_BINARY_FP16_KERNEL(Add, 14, MlasFp16Add)
+
+REG_BINARY_FP16_VERSIONED_KERNEL(Sub, 7, 12, MlasFp16Sub)
+REG_BINARY_FP16_VERSIONED_KERNEL(Sub, 13, 13, MlasFp16Sub)
+REG_BINARY_FP16_KERNEL(Sub, 14, MlasFp16Sub)
+
+REG_BINARY_FP16_VERSIONED_KERNEL(Mul, 7, 12, MlasFp16Mul)
+REG_BINARY_FP16_VERSIONED_KERNEL(Mul, 13, 13, MlasFp16Mul)
+REG_BINARY_FP16_KERNEL(Mul, 14, MlasFp16Mul)
+
+REG_BINARY_FP16_VERSIONED_KERNEL(Div, 7, 12, MlasFp16Div)
+REG_BINARY_FP16_VERSIONED_KERNEL(Div, 13, 13, MlasFp16Div)
+REG_BINARY_FP16_KERNEL(Div, 14, MlasFp16Div)
+
+}  // namespace onnxruntime
+
+#endif  // MLAS_F16VEC_INTRINSICS_SUPPORTED
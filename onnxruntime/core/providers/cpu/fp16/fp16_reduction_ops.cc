@@ -0,0 +1,249 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/mlas/inc/mlas.h"
+
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+
+#include <algorithm>
+#include <limits>
+
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+#include "core/providers/cpu/reduction/reduction_ops.h"
+#include "core/providers/cpu/tensor/transpose.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// fp16 elements converted at a time, so the fp32 buffer stays in the cache
+constexpr int64_t kReduceFp16BlockSize = 1024;
+
+struct ReduceSumFp16Agg {
+  static float Init() { return 0.0f; }
+  static float Update(float acc, float value) { return acc + value; }
+  static float Finalize(float acc, int64_t) { return acc; }
+  static Status FillForEmptySet(Tensor& output) {
+    std::fill_n(output.MutableData<MLFloat16>(), output.Shape().Size(), MLFloat16::FromBits(0));
+    return Status::OK();
+  }
+};
+
+struct ReduceMeanFp16Agg : ReduceSumFp16Agg {
+  static float Finalize(float acc, int64_t reduced_size) { return acc / static_cast<float>(reduced_size); }
+  static Status FillForEmptySet(Tensor&) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "ReduceMean of an empty set is not implemented.");
+  }
+};
+
+struct ReduceMaxFp16Agg {
+  static float Init() { return -std::numeric_limits<float>::infinity(); }
+  static float Update(float acc, float value) { return value > acc ? value : acc; }
+  static float Finalize(float acc, int64_t) { return acc; }
+  static Status FillForEmptySet(Tensor& output) {
+    std::fill_n(output.MutableData<MLFloat16>(), output.Shape().Size(), MLFloat16::NegativeInfinity);
+    return Status::OK();
+  }
+};
+
+// output[k] = reduce(input[k * R, (k + 1) * R))
+template <typename Agg>
+void ReduceRowsFp16(const MLFloat16* input, int64_t K, int64_t R, MLFloat16* output,
+                    concurrency::ThreadPool* tp) {
+  concurrency::ThreadPool::TryParallelFor(
+      tp, K, ParallelReduceFastCost(1, R, sizeof(MLFloat16), 6),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        float buffer[kReduceFp16BlockSize];
+        for (std::ptrdiff_t k = first; k < last; ++k) {
+          const MLFloat16* row = input + k * R;
+          float acc = Agg::Init();
+          for (int64_t r = 0; r < R; r += kReduceFp16BlockSize) {
+            const int64_t count = std::min(kReduceFp16BlockSize, R - r);
+            MlasConvertHalfToFloatBuffer(row + r, buffer, narrow<size_t>(count));
+            for (int64_t i = 0; i < count; ++i) {
+              acc = Agg::Update(acc, buffer[i]);
+            }
+          }
+          output[k] = MLFloat16(Agg::Finalize(acc, R));
+        }
+      });
+}
+
+// output[k0 * K1 + k1] = reduce over r of input[(k0 * R + r) * K1 + k1]
+template <typename Agg>
+void ReduceColumnsFp16(const MLFloat16* input, int64_t K0, int64_t R, int64_t K1, MLFloat16* output,
+                       concurrency::ThreadPool* tp) {
+  concurrency::ThreadPool::TryParallelFor(
+      tp, K0 * K1, ParallelReduceFastCost(1, R, sizeof(MLFloat16), 6),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        float buffer[kReduceFp16BlockSize];
+        float acc[kReduceFp16BlockSize];
+        // the columns of one k0 are reduced together, a block at a time
+        for (std::ptrdiff_t begin = first; begin < last;) {
+          const int64_t k0 = begin / K1;
+          const int64_t k1 = begin % K1;
+          const int64_t count = std::min({kReduceFp16BlockSize, K1 - k1, static_cast<int64_t>(last - begin)});
+          std::fill_n(acc, count, Agg::Init());
+          for (int64_t r = 0; r < R; ++r) {
+            MlasConvertHalfToFloatBuffer(input + (k0 * R + r) * K1 + k1, buffer, narrow<size_t>(count));
+            for (int64_t i = 0; i < count; ++i) {
+              acc[i] = Agg::Update(acc[i], buffer[i]);
+            }
+          }
+          for (int64_t i = 0; i < count; ++i) {
+            acc[i] = Agg::Finalize(acc[i], R);
+          }
+          MlasConvertFloatToHalfBuffer(acc, output + begin, narrow<size_t>(count));
+          begin += narrow<std::ptrdiff_t>(count);
+        }
+      });
+}
+
+}  // namespace
+
+/**
+ * @brief ReduceSum, ReduceMean and ReduceMax for type FP16.
+ * The fp16 input is read once and accumulated in fp32, so long reductions
+ * keep the precision of the fp32 kernels.
+ */
+template <typename Agg>
+class ReduceFp16 final : public ReduceKernel<true> {
+ public:
+  explicit ReduceFp16(const OpKernelInfo& info) : ReduceKernel<true>(info) {}
+
+  Status Compute(OpKernelContext* ctx) const override;
+};
+
+template <typename Agg>
+Status ReduceFp16<Agg>::Compute(OpKernelContext* ctx) const {
+  TensorShapeVector input_axes;
+  if (CommonFastReduceCopy(ctx, input_axes, noop_with_empty_axes_)) {
+    return Status::OK();
+  }
+
+  const Tensor* input = ctx->Input<Tensor>(0);
+  const auto& input_shape = input->Shape();
+  const auto& axes = input_axes.empty() ? axes_ : input_axes;
+
+  TensorShapeVector fast_shape, output_shape, fast_axes;
+  const FastReduceKind fast_kind = OptimizeShapeForFastReduce(input_shape.GetDims(), axes, fast_shape, output_shape,
+                                                              fast_axes, keepdims_, noop_with_empty_axes_);
+
+  if (input_shape.Size() == 0) {
+    // as in the fp32 kernels, the reduced dims of an empty set have a size of 1 in the output
+    TensorShapeVector empty_set_output_shape;
+    const auto dims = input_shape.GetDims();
+    const auto rank = narrow<int64_t>(dims.size());
+    for (int64_t i = 0; i < rank; ++i) {
+      const bool reduced = axes.empty() || std::any_of(axes.begin(), axes.end(), [&](int64_t axis) {
+                             return HandleNegativeAxis(axis, rank) == i;
+                           });
+      if (!reduced) {
+        empty_set_output_shape.push_back(dims[narrow<size_t>(i)]);
+      } else if (keepdims_) {
+        empty_set_output_shape.push_back(1);
+      }
+    }
+    Tensor* output = ctx->Output(0, empty_set_output_shape);
+    return output->Shape().Size() != 0 ? Agg::FillForEmptySet(*output) : Status::OK();
+  }
+
+  Tensor* output = ctx->Output(0, output_shape);
+  const MLFloat16* input_data = input->Data<MLFloat16>();
+  MLFloat16* output_data = output->MutableData<MLFloat16>();
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  switch (fast_kind) {
+    case FastReduceKind::kEmpty:
+      // a scalar
+      output_data[0] = MLFloat16(Agg::Finalize(Agg::Update(Agg::Init(), input_data[0].ToFloat()), 1));
+      return Status::OK();
+    case FastReduceKind::kK:
+      memcpy(output_data, input_data, input->SizeInBytes());
+      return Status::OK();
+    case FastReduceKind::kR:
+      ReduceRowsFp16<Agg>(input_data, 1, fast_shape[0], output_data, tp);
+      return Status::OK();
+    case FastReduceKind::kKR:
+      ReduceRowsFp16<Agg>(input_data, fast_shape[0], fast_shape[1], output_data, tp);
+      return Status::OK();
+    case FastReduceKind::kRK:
+      ReduceColumnsFp16<Agg>(input_data, 1, fast_shape[0], fast_shape[1], output_data, tp);
+      return Status::OK();
+    case FastReduceKind::kKRK:
+      ReduceColumnsFp16<Agg>(input_data, fast_shape[0], fast_shape[1], fast_shape[2], output_data, tp);
+      return Status::OK();
+    default:
+      break;
+  }
+
+  // Otherwise the kept dims are moved before the reduced ones, which turns the reduction into KR.
+  InlinedVector<size_t> permutation;
+  int64_t kept_size = 1;
+  int64_t reduced_size = 1;
+  for (size_t i = 0; i < fast_shape.size(); ++i) {
+    if (std::find(fast_axes.begin(), fast_axes.end(), narrow<int64_t>(i)) == fast_axes.end()) {
+      permutation.push_back(i);
+      kept_size *= fast_shape[i];
+    }
+  }
+  for (auto axis : fast_axes) {
+    permutation.push_back(narrow<size_t>(axis));
+    reduced_size *= fast_shape[narrow<size_t>(axis)];
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+  const TensorShape fast_input_shape(fast_shape);
+  TensorShapeVector transposed_dims;
+  for (auto axis : permutation) {
+    transposed_dims.push_back(fast_shape[axis]);
+  }
+  Tensor transposed(input->DataType(), TensorShape(transposed_dims), alloc);
+  ORT_RETURN_IF_ERROR(TransposeBase::DoTranspose(permutation, *input, transposed, &fast_input_shape, tp));
+
+  ReduceRowsFp16<Agg>(transposed.Data<MLFloat16>(), kept_size, reduced_size, output_data, tp);
+  return Status::OK();
+}
+
+//
+// Operator definitions
+//
+#define REGISTER_REDUCE_FP16_VERSIONED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, AGG)   \
+  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                             \
+      OP_TYPE,                                                                          \
+      VERSION_FROM, VERSION_TO,                                                         \
+      MLFloat16,                                                                        \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()), \
+      ReduceFp16<AGG>);
+
+#define REGISTER_REDUCE_FP16_KERNEL(OP_TYPE, VERSION, AGG)                              \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                       \
+      OP_TYPE,                                                                          \
+      VERSION,                                                                          \
+      MLFloat16,                                                                        \
+      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()), \
+      ReduceFp16<AGG>);
+
+REGISTER_REDUCE_FP16_VERSIONED_KERNEL(ReduceSum, 1, 10, ReduceSumFp16Agg)
+REGISTER_REDUCE_FP16_VERSIONED_KERNEL(ReduceSum, 11, 12, ReduceSumFp16Agg)
+REGISTER_REDUCE_FP16_KERNEL(ReduceSum, 13, ReduceSumFp16Agg)
+
+REGISTER_REDUCE_FP16_VERSIONED_KERNEL(ReduceMean, 1, 10, ReduceMeanFp16Agg)
+REGISTER_REDUCE_FP16_VERSIONED_KERNEL(ReduceMean, 11, 12, ReduceMeanFp16Agg)
+REGISTER_REDUCE_FP16_VERSIONED_KERNEL(ReduceMean, 13, 17, ReduceMeanFp16Agg)
+REGISTER_REDUCE_FP16_KERNEL(ReduceMean, 18, ReduceMeanFp16Agg)
+
+REGISTER_REDUCE_FP16_VERSIONED_KERNEL(ReduceMax, 1, 10, ReduceMaxFp16Agg)
+REGISTER_REDUCE_FP16_VERSIONED_KERNEL(ReduceMax, 11, 11, ReduceMaxFp16Agg)
+REGISTER_REDUCE_FP16_VERSIONED_KERNEL(ReduceMax, 12, 12, ReduceMaxFp16Agg)
+REGISTER_REDUCE_FP16_VERSIONED_KERNEL(ReduceMax, 13, 17, ReduceMaxFp16Agg)
+REGISTER_REDUCE_FP16_VERSIONED_KERNEL(ReduceMax, 18, 19, ReduceMaxFp16Agg)
+REGISTER_REDUCE_FP16_KERNEL(ReduceMax, 20, ReduceMaxFp16Agg)
+
+}  // namespace onnxruntime
+
+#endif  // MLAS_F16VEC_INTRINSICS_SUPPORTED
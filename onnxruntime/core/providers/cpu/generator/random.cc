@@ -26,8 +26,11 @@ limitations under the License.
 #include <random>
 
 #include "core/common/eigen_common_wrapper.h"
+#include "core/common/narrow.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel_type_control_utils.h"
+#include "core/framework/philox_engine.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "core/util/math_cpuonly.h"
 
@@ -126,11 +129,10 @@ ONNX_CPU_OPERATOR_KERNEL(
                         BuildKernelDefConstraintsFromTypeList<EnabledMultinomialOutputTypes>()),
     Multinomial);
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor);
-
-static Status RandomNormalCompute(float mean, float scale, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
-static Status RandomUniformCompute(float high, float low, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
+static Status RandomNormalCompute(float mean, float scale, PhiloxGenerator& generator, TensorProto::DataType dtype,
+                                  Tensor& Y, concurrency::ThreadPool* tp);
+static Status RandomUniformCompute(float high, float low, PhiloxGenerator& generator, TensorProto::DataType dtype,
+                                   Tensor& Y, concurrency::ThreadPool* tp);
 
 static Status CreateOutputTensorFromTensorShape(OpKernelContext* ctx, const Tensor& X, Tensor** Y);
 static TensorProto::DataType InferDataType(const Tensor& tensor);
@@ -138,8 +140,7 @@ static TensorProto::DataType InferDataType(const Tensor& tensor);
 Status RandomNormal::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<std::mutex> l(generator_mutex_);
-  auto status = RandomNormalCompute(mean_, scale_, generator_, dtype_, Y);
+  auto status = RandomNormalCompute(mean_, scale_, generator_, dtype_, Y, ctx->GetOperatorThreadPool());
 
   return status;
 }
@@ -147,8 +148,7 @@ Status RandomNormal::Compute(OpKernelContext* ctx) const {
 Status RandomUniform::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<std::mutex> l(generator_mutex_);
-  auto status = RandomUniformCompute(low_, high_, generator_, dtype_, Y);
+  auto status = RandomUniformCompute(low_, high_, generator_, dtype_, Y, ctx->GetOperatorThreadPool());
 
   return status;
 }
@@ -169,8 +169,7 @@ Status RandomNormalLike::Compute(OpKernelContext* ctx) const {
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
 
-  std::lock_guard<std::mutex> l(generator_mutex_);
-  status = RandomNormalCompute(mean_, scale_, generator_, dtype, *Y);
+  status = RandomNormalCompute(mean_, scale_, generator_, dtype, *Y, ctx->GetOperatorThreadPool());
 
   return status;
 }
@@ -190,8 +189,7 @@ Status RandomUniformLike::Compute(OpKernelContext* ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
-  std::lock_guard<std::mutex> l(generator_mutex_);
-  status = RandomUniformCompute(low_, high_, generator_, dtype, *Y);
+  status = RandomUniformCompute(low_, high_, generator_, dtype, *Y, ctx->GetOperatorThreadPool());
 
   return status;
 }
@@ -346,23 +344,59 @@ static TensorProto::DataType InferDataType(const Tensor& tensor) {
   return static_cast<TensorProto::DataType>(dtype);
 }
 
+// Fills the tensor with the values of the next range of the Philox stream of the generator. The range is split
+// between the threads, each of which generates its part of the stream independently.
+template <typename T, typename TGenerate>
+static void GenerateData(PhiloxGenerator& generator, Tensor& tensor, concurrency::ThreadPool* tp,
+                         TGenerate generate) {
+  const size_t count = narrow<size_t>(tensor.Shape().Size());
+  if (count == 0) {
+    return;
+  }
+
+  const auto seeds = generator.NextPhiloxSeeds(philox::BlockCount<T>(count));
+  T* out = tensor.MutableData<T>();
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(count), TensorOpCost{0, static_cast<double>(sizeof(T)), 64},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        generate(seeds.first, seeds.second, static_cast<uint64_t>(first), static_cast<size_t>(last - first),
+                 out + first);
+      });
+}
+
+template <typename T>
+static void GenerateNormalData(PhiloxGenerator& generator, T mean, T scale, Tensor& tensor,
+                               concurrency::ThreadPool* tp) {
+  GenerateData<T>(generator, tensor, tp,
+                  [mean, scale](uint64_t seed, uint64_t offset, uint64_t first, size_t count, T* out) {
+                    philox::GenerateNormal<T>(seed, offset, first, count, mean, scale, out);
+                  });
+}
+
+template <typename T>
+static void GenerateUniformData(PhiloxGenerator& generator, T low, T high, Tensor& tensor,
+                                concurrency::ThreadPool* tp) {
+  GenerateData<T>(generator, tensor, tp,
+                  [low, high](uint64_t seed, uint64_t offset, uint64_t first, size_t count, T* out) {
+                    philox::GenerateUniform<T>(seed, offset, first, count, low, high, out);
+                  });
+}
+
 static Status RandomNormalCompute(float mean, float scale,
-                                  std::default_random_engine& generator,
-                                  TensorProto::DataType dtype, Tensor& Y) {
+                                  PhiloxGenerator& generator,
+                                  TensorProto::DataType dtype, Tensor& Y, concurrency::ThreadPool* tp) {
   bool handled = false;
   switch (dtype) {
     case TensorProto::FLOAT: {
       if (utils::HasType<EnabledRandomNormalComputeOutputTypes, float>()) {
-        GenerateData<float, std::normal_distribution<float>>(
-            generator, std::normal_distribution<float>{mean, scale}, Y);
+        GenerateNormalData<float>(generator, mean, scale, Y, tp);
         handled = true;
       }
       break;
     }
     case TensorProto::DOUBLE: {
       if (utils::HasType<EnabledRandomNormalComputeOutputTypes, double>()) {
-        GenerateData<double, std::normal_distribution<double>>(
-            generator, std::normal_distribution<double>{mean, scale}, Y);
+        GenerateNormalData<double>(generator, mean, scale, Y, tp);
         handled = true;
       }
       break;
@@ -379,23 +413,21 @@ static Status RandomNormalCompute(float mean, float scale,
 }
 
 static Status RandomUniformCompute(float low, float high,
-                                   std::default_random_engine& generator,
+                                   PhiloxGenerator& generator,
                                    TensorProto::DataType dtype,
-                                   Tensor& Y) {
+                                   Tensor& Y, concurrency::ThreadPool* tp) {
   bool handled = false;
   switch (dtype) {
     case TensorProto::FLOAT: {
       if (utils::HasType<EnabledRandomUniformComputeOutputTypes, float>()) {
-        GenerateData<float, std::uniform_real_distribution<float>>(
-            generator, std::uniform_real_distribution<float>{low, high}, Y);
+        GenerateUniformData<float>(generator, low, high, Y, tp);
         handled = true;
       }
       break;
     }
     case TensorProto::DOUBLE: {
       if (utils::HasType<EnabledRandomUniformComputeOutputTypes, double>()) {
-        GenerateData<double, std::uniform_real_distribution<double>>(
-            generator, std::uniform_real_distribution<double>{low, high}, Y);
+        GenerateUniformData<double>(generator, low, high, Y, tp);
         handled = true;
       }
       break;
@@ -411,15 +443,6 @@ static Status RandomUniformCompute(float low, float high,
   return Status::OK();
 }
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor) {
-  T* out = tensor.MutableData<T>();
-  for (int64_t i = 0, end = tensor.Shape().Size(); i < end; ++i) {
-    *out = distribution(generator);
-    ++out;
-  }
-}
-
 template Status MultinomialComputeShared<int64_t>(AllocatorPtr& alloc,
                                                   const Tensor& X,
                                                   const int64_t batch_size,
@@ -1,19 +1,89 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <functional>
+#include <vector>
 
 #include "cumsum.h"
 #include "core/providers/common.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/threadpool.h"
 
 using namespace onnxruntime;
 
 namespace onnxruntime {
 
 namespace cumsum_op {
+namespace {
+
+// the scan is split in tasks of blocks of rows and columns of the slices. a block is at most kColumnBlockSize columns
+// wide, and when there are less than kMinimumIndependentScans slices and column blocks to scan in parallel, it is
+// also split along the axis in blocks of at least kMinimumBlockSize elements and kMinimumRowBlockSize rows.
+constexpr int64_t kColumnBlockSize = 4096;
+constexpr int64_t kMinimumIndependentScans = 64;
+constexpr int64_t kMinimumBlockSize = 16384;
+constexpr int64_t kMinimumRowBlockSize = 64;
+
+// row k of the scan order is the row k of the slice, or the row dim - 1 - k in reverse.
+inline int64_t RowIndex(int64_t k, int64_t dim, bool reverse) {
+  return reverse ? dim - 1 - k : k;
+}
+
+// computes in `sum` the sum of the rows [first_row, first_row + row_count) of the scan order, `width` elements each.
+template <typename T>
+void SumRows(const T* input, T* sum, int64_t first_row, int64_t row_count, int64_t dim, int64_t row_size,
+             int64_t width, bool reverse) {
+  std::fill_n(sum, width, T{0});
+  for (int64_t k = first_row; k < first_row + row_count; k++) {
+    const T* input_row = input + RowIndex(k, dim, reverse) * row_size;
+    for (int64_t i = 0; i < width; i++) {
+      sum[i] += input_row[i];
+    }
+  }
+}
+
+// scans the rows [first_row, first_row + row_count) of the scan order, `width` elements each, starting from the
+// carry of the previous rows, or from 0 if carry is nullptr.
+template <typename T>
+void ScanRows(const T* input, T* output, const T* carry, int64_t first_row, int64_t row_count, int64_t dim,
+              int64_t row_size, int64_t width, bool exclusive, bool reverse) {
+  const int64_t end_row = first_row + row_count;
+  const T* previous_input = input + RowIndex(first_row, dim, reverse) * row_size;
+  T* previous_output = output + RowIndex(first_row, dim, reverse) * row_size;
+
+  if (exclusive) {
+    if (carry != nullptr) {
+      std::copy_n(carry, width, previous_output);
+    } else {
+      std::fill_n(previous_output, width, T{0});
+    }
+  } else {
+    if (carry != nullptr) {
+      for (int64_t i = 0; i < width; i++) {
+        previous_output[i] = carry[i] + previous_input[i];
+      }
+    } else {
+      std::copy_n(previous_input, width, previous_output);
+    }
+  }
+
+  for (int64_t k = first_row + 1; k < end_row; k++) {
+    const T* input_row = input + RowIndex(k, dim, reverse) * row_size;
+    T* output_row = output + RowIndex(k, dim, reverse) * row_size;
+    const T* addend = exclusive ? previous_input : input_row;
+    for (int64_t i = 0; i < width; i++) {
+      output_row[i] = previous_output[i] + addend[i];
+    }
+    previous_input = input_row;
+    previous_output = output_row;
+  }
+}
+
+}  // namespace
+
 Status GetAxis(const Tensor* axis_tensor, int64_t input_rank, int64_t& axis_out) {
   if (!axis_tensor)
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Axis tensor must be provided to the CumSum op");
@@ -166,8 +236,13 @@ Status CumSum<T>::Compute(OpKernelContext* ctx) const {
   // 1) out[upper_dims...][0][lower_dims...] = 0
   // 2) out[upper_dims...][i][lower_dims...] =
   //      in[upper_dims...][i-1][lower_dims...] + out[upper_dims...][i-1][lower_dims...]
-  // we loop through the [upper_dims...] and start applying the identity in each slice
-  // since the [lower_dims...] are adjecent in memory, so we can add them like vectors
+  // each slice [upper_dims...] is a matrix of `dim` rows of the [lower_dims...], which are adjacent in memory so we
+  // can add them like vectors. the slices, and blocks of the columns of a slice, are scanned independently.
+  // when there are few of them and the axis is long, the rows are also split in blocks scanned in parallel:
+  // 1) the sum of each block of rows is computed
+  // 2) the sums are accumulated over the blocks, giving the carry into each block
+  // 3) each block is scanned from its carry
+  // the blocks only depend on the shape, so the result does not depend on the number of threads.
 
   const auto input_shape = input->Shape().GetDims();
   const size_t axis = onnxruntime::narrow<size_t>(axis_input);
@@ -177,71 +252,85 @@ Status CumSum<T>::Compute(OpKernelContext* ctx) const {
   const int64_t lower_dim_size =  // sizes of the slices we can treat as 1D arrays
       std::accumulate(input_shape.begin() + axis + 1, input_shape.end(), static_cast<int64_t>(1), std::multiplies<int64_t>());
 
-  if (!reverse_) {
-    const auto* input_iter = input->Data<T>();
-    auto* output_iter = output_tensor.MutableData<T>();
-    const auto* prev_output_iter = output_iter;
+  const int64_t column_block_size = std::min(lower_dim_size, cumsum_op::kColumnBlockSize);
+  const int64_t column_block_count = (lower_dim_size + column_block_size - 1) / column_block_size;
 
-    if (exclusive_) {
-      for (int64_t outer = 0; outer < upper_dim_count; outer++) {
-        prev_output_iter = output_iter;
-        for (int64_t inner = 0; inner < lower_dim_size; inner++) {
-          *(output_iter++) = 0;
-        }
-        for (int64_t cum_axis = 1; cum_axis < dim; cum_axis++) {
-          for (int64_t inner = 0; inner < lower_dim_size; inner++) {
-            *(output_iter++) = *(prev_output_iter++) + *(input_iter++);
-          }
-        }
-        input_iter += lower_dim_size;
-      }
-    } else {
-      for (int64_t outer = 0; outer < upper_dim_count; outer++) {
-        prev_output_iter = output_iter;
-        for (int64_t inner = 0; inner < lower_dim_size; inner++) {
-          *(output_iter++) = *(input_iter++);
-        }
-        for (int64_t cum_axis = 1; cum_axis < dim; cum_axis++) {
-          for (int64_t inner = 0; inner < lower_dim_size; inner++) {
-            *(output_iter++) = *(prev_output_iter++) + *(input_iter++);
-          }
-        }
-      }
-    }
-  } else {
-    // in this case the logic is mostly the same, but we start from the end
-    const auto* input_iter = input->Data<T>() + input->Shape().Size();
-    auto* output_iter = output_tensor.MutableData<T>() + output_shape.Size();
-    const auto* prev_output_iter = output_iter;
-
-    if (exclusive_) {
-      for (int64_t outer = upper_dim_count - 1; outer >= 0; outer--) {
-        prev_output_iter = output_iter;
-        for (int64_t inner = lower_dim_size - 1; inner >= 0; inner--) {
-          *(--output_iter) = 0;
-        }
-        for (int64_t cum_axis = dim - 1; cum_axis > 0; cum_axis--) {
-          for (int64_t inner = lower_dim_size - 1; inner >= 0; inner--) {
-            *(--output_iter) = *(--prev_output_iter) + *(--input_iter);
+  int64_t row_block_size = dim;
+  if (upper_dim_count * column_block_count < cumsum_op::kMinimumIndependentScans) {
+    row_block_size = std::max(cumsum_op::kMinimumRowBlockSize, cumsum_op::kMinimumBlockSize / column_block_size);
+    row_block_size = std::min(row_block_size, dim);
+  }
+  const int64_t row_block_count = (dim + row_block_size - 1) / row_block_size;
+
+  const T* input_data = input->Data<T>();
+  T* output_data = output_tensor.MutableData<T>();
+  const int64_t slice_size = dim * lower_dim_size;
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  const double block_elements = static_cast<double>(row_block_size * column_block_size);
+  const TensorOpCost block_cost{block_elements * sizeof(T), block_elements * sizeof(T), block_elements};
+
+  // carries[(outer * row_block_count + block) * lower_dim_size + column] is the sum of the rows of the blocks up to
+  // `block` included, which is the carry into block + 1.
+  std::vector<T> carries;
+  if (row_block_count > 1) {
+    carries.resize(narrow<size_t>(upper_dim_count * row_block_count * lower_dim_size));
+
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(upper_dim_count * row_block_count * column_block_count),
+        TensorOpCost{block_elements * sizeof(T), static_cast<double>(column_block_size * sizeof(T)), block_elements},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t task = first; task < last; task++) {
+            const int64_t column_block = task % column_block_count;
+            const int64_t block = (task / column_block_count) % row_block_count;
+            const int64_t outer = task / (column_block_count * row_block_count);
+            const int64_t column = column_block * column_block_size;
+            const int64_t first_row = block * row_block_size;
+            cumsum_op::SumRows(input_data + outer * slice_size + column,
+                               carries.data() + (outer * row_block_count + block) * lower_dim_size + column,
+                               first_row, std::min(row_block_size, dim - first_row), dim, lower_dim_size,
+                               std::min(column_block_size, lower_dim_size - column), reverse_ != 0);
           }
-        }
-        input_iter -= lower_dim_size;
-      }
-    } else {
-      for (int64_t outer = upper_dim_count - 1; outer >= 0; outer--) {
-        prev_output_iter = output_iter;
-        for (int64_t inner = lower_dim_size - 1; inner >= 0; inner--) {
-          *(--output_iter) = *(--input_iter);
-        }
-        for (int64_t cum_axis = dim - 1; cum_axis > 0; cum_axis--) {
-          for (int64_t inner = lower_dim_size - 1; inner >= 0; inner--) {
-            *(--output_iter) = *(--prev_output_iter) + *(--input_iter);
+        });
+
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(upper_dim_count * column_block_count),
+        TensorOpCost{static_cast<double>(row_block_count * column_block_size * sizeof(T)),
+                     static_cast<double>(row_block_count * column_block_size * sizeof(T)),
+                     static_cast<double>(row_block_count * column_block_size)},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t task = first; task < last; task++) {
+            const int64_t column = (task % column_block_count) * column_block_size;
+            const int64_t width = std::min(column_block_size, lower_dim_size - column);
+            T* carry = carries.data() + (task / column_block_count) * row_block_count * lower_dim_size + column;
+            for (int64_t block = 1; block < row_block_count; block++) {
+              const T* previous = carry;
+              carry += lower_dim_size;
+              for (int64_t i = 0; i < width; i++) {
+                carry[i] += previous[i];
+              }
+            }
           }
-        }
-      }
-    }
+        });
   }
 
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(upper_dim_count * row_block_count * column_block_count), block_cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t task = first; task < last; task++) {
+          const int64_t column_block = task % column_block_count;
+          const int64_t block = (task / column_block_count) % row_block_count;
+          const int64_t outer = task / (column_block_count * row_block_count);
+          const int64_t column = column_block * column_block_size;
+          const int64_t first_row = block * row_block_size;
+          const T* carry = block == 0 ? nullptr
+                                      : carries.data() + (outer * row_block_count + block - 1) * lower_dim_size + column;
+          cumsum_op::ScanRows(input_data + outer * slice_size + column, output_data + outer * slice_size + column,
+                              carry, first_row, std::min(row_block_size, dim - first_row), dim, lower_dim_size,
+                              std::min(column_block_size, lower_dim_size - column), exclusive_ != 0, reverse_ != 0);
+        }
+      });
+
   return Status::OK();
 }
 
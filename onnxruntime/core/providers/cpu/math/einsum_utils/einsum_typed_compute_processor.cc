@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "einsum_typed_compute_processor.h"
+
+#include <algorithm>
+#include <utility>
+
 #include "core/common/narrow.h"
 #include "core/common/span_utils.h"
 
@@ -332,6 +336,68 @@ std::unique_ptr<Tensor> EinsumTypedComputeProcessor<T>::PairwiseOperandProcess(c
   return output;
 }
 
+// Whether the dimension `dim` can be reduced when the operands `left` and `right` are contracted,
+// i.e. it doesn't occur in the output and no other operand has a non-trivial dim value along it
+static bool IsReducibleAfterContraction(const std::vector<TensorShape>& operand_dims,
+                                        const std::vector<int64_t>& subscript_indices_to_output_indices,
+                                        size_t left, size_t right, size_t dim) {
+  if (subscript_indices_to_output_indices[dim] != -1) {
+    return false;
+  }
+
+  for (size_t operand = 0, end = operand_dims.size(); operand < end; ++operand) {
+    if (operand != left && operand != right && operand_dims[operand][dim] > 1) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Picks the pair of operands to contract next with the greedy heuristic of opt_einsum:
+// the pair whose contraction removes the most elements (size of the result - sizes of the pair),
+// and among those, the pair that needs the fewest multiply-adds.
+// With 2 operands, this is the single pair there is, so only einsums of 3 or more operands
+// may be contracted in an order other than left to right.
+static std::pair<size_t, size_t> GreedyContractionPair(const std::vector<TensorShape>& operand_dims,
+                                                       const std::vector<int64_t>& subscript_indices_to_output_indices) {
+  std::pair<size_t, size_t> best_pair{0, 1};
+  double best_removed_size = 0;
+  double best_cost = 0;
+
+  const size_t num_dims = operand_dims[0].NumDimensions();
+  for (size_t left = 0, end = operand_dims.size(); left < end; ++left) {
+    for (size_t right = left + 1; right < end; ++right) {
+      double left_size = 1;
+      double right_size = 1;
+      double output_size = 1;
+      double cost = 1;
+      for (size_t dim = 0; dim < num_dims; ++dim) {
+        const auto left_dim = static_cast<double>(operand_dims[left][dim]);
+        const auto right_dim = static_cast<double>(operand_dims[right][dim]);
+        // dims of the pair match, or are 1 (see PairwiseOperandProcess())
+        const double dim_value = std::max(left_dim, right_dim);
+        left_size *= left_dim;
+        right_size *= right_dim;
+        cost *= dim_value;
+        if (!IsReducibleAfterContraction(operand_dims, subscript_indices_to_output_indices, left, right, dim)) {
+          output_size *= dim_value;
+        }
+      }
+
+      const double removed_size = output_size - left_size - right_size;
+      if ((left == 0 && right == 1) || removed_size < best_removed_size ||
+          (removed_size == best_removed_size && cost < best_cost)) {
+        best_pair = {left, right};
+        best_removed_size = removed_size;
+        best_cost = cost;
+      }
+    }
+  }
+
+  return best_pair;
+}
+
 template <typename T>
 void EinsumTypedComputeProcessor<T>::SetDeviceHelpers(const EinsumOp::DeviceHelpers::Transpose& device_transpose_func,
                                                       const EinsumOp::DeviceHelpers::MatMul<T>& device_matmul_func,
@@ -398,28 +464,60 @@ Status EinsumTypedComputeProcessor<T>::Run() {
     }
   }
 
-  // Process the operands in a pair-wise fashion
+  // Process the operands in a pair-wise fashion, in the order picked by GreedyContractionPair()
   {
-    bool is_final_pair = false;
-    // Keep processing each input pair-wise
+    const auto& subscript_indices_to_output_indices =
+        einsum_compute_preprocessor_.GetMappedSubscriptIndicesToOutputindices();
+
+    // The operands yet to be contracted and their homogenized dims. The intermediate results are owned by
+    // `intermediates` and are released as soon as they have been contracted.
+    std::vector<const Tensor*> operands;
+    std::vector<TensorShape> operand_dims;
+    std::vector<std::unique_ptr<const Tensor>> intermediates;
+    operands.reserve(static_cast<size_t>(num_inputs));
+    operand_dims.reserve(static_cast<size_t>(num_inputs));
+    intermediates.reserve(static_cast<size_t>(num_inputs));
+
+    operands.push_back(result ? result.get() : raw_inputs[0]);
+    operand_dims.push_back(result ? result->Shape() : homogenized_input_dims[0]);
+    intermediates.push_back(std::move(result));
     for (int input = 1; input < num_inputs; ++input) {
+      // Use either the preprocessed inputs (if it is available) or the corresponding raw inputs
+      operands.push_back(preprocessed_inputs[input] ? preprocessed_inputs[input].get() : raw_inputs[input]);
+      operand_dims.push_back(homogenized_input_dims[input]);
+      intermediates.push_back(nullptr);
+    }
+
+    // Keep processing pairs of operands until a single one is left
+    while (operands.size() > 1) {
+      const auto [left, right] = GreedyContractionPair(operand_dims, subscript_indices_to_output_indices);
+
       TensorShapeVector reduced_dims;
       reduced_dims.reserve(onnxruntime::narrow<size_t>(num_subscript_labels));  // num_subscript_labels is the upper bound. No harm in over-reserving by a small margin.
       for (int64_t dim = 0; dim < num_subscript_labels; ++dim) {
-        if (mapped_indices_to_last_input_index[onnxruntime::narrow<size_t>(dim)] == input) {
-          // This is the last input we are seeing this dimension (and it doesn't occur in the output), so reduce along the dimension
+        const auto dim_index = onnxruntime::narrow<size_t>(dim);
+        if ((operand_dims[left][dim_index] > 1 || operand_dims[right][dim_index] > 1) &&
+            IsReducibleAfterContraction(operand_dims, subscript_indices_to_output_indices, left, right, dim_index)) {
+          // No other operand has this dimension (and it doesn't occur in the output), so reduce along the dimension
           reduced_dims.push_back(dim);
         }
       }
-      if (input == num_inputs - 1) {
-        is_final_pair = true;
+
+      const bool is_final_pair = operands.size() == 2;
+      auto output = PairwiseOperandProcess(*operands[left], operand_dims[left],
+                                           *operands[right], operand_dims[right],
+                                           reduced_dims, is_final_pair);
+
+      // right > left, so erasing right first keeps the position of left
+      for (size_t operand : {right, left}) {
+        operands.erase(operands.begin() + operand);
+        operand_dims.erase(operand_dims.begin() + operand);
+        intermediates.erase(intermediates.begin() + operand);
       }
-      // Use either the preprocessed inputs (if it is available) or the corresponding raw inputs
-      result = PairwiseOperandProcess(result ? *result : *raw_inputs[0],
-                                      result ? result->Shape() : homogenized_input_dims[0],
-                                      preprocessed_inputs[input] ? *preprocessed_inputs[input] : *raw_inputs[input],
-                                      homogenized_input_dims[input],
-                                      reduced_dims, is_final_pair);
+
+      operands.push_back(output.get());
+      operand_dims.push_back(output->Shape());
+      intermediates.push_back(std::move(output));
     }
   }
 
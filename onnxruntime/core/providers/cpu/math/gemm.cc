@@ -4,11 +4,13 @@
 #include <onnxruntime_config.h>
 #include "core/providers/cpu/math/gemm.h"
 #include "core/common/narrow.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -138,6 +140,65 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
   return true;
 }
 
+bool GemmCanUsePackedBFp32(const Tensor& tensor_b,
+                           bool trans_b,
+                           gsl::span<const size_t> packed_b_sizes,
+                           TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2 || packed_b_sizes.size() != 1) {
+    return false;
+  }
+
+  const auto& shape = tensor_b.Shape();
+  const size_t K = trans_b ? static_cast<size_t>(shape[1]) : static_cast<size_t>(shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(shape[0]) : static_cast<size_t>(shape[1]);
+  if (packed_b_sizes[0] == 0 || packed_b_sizes[0] != MlasGemmPackBSize(N, K)) {
+    return false;
+  }
+
+  b_shape = shape;
+  return true;
+}
+
+float GemmBlockSparseMinSparsity(const OpKernelInfo& info) {
+  const std::string min_sparsity_str =
+      info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasBlockSparseGemmMinSparsity, "0");
+  float min_sparsity = 0.0f;
+  ORT_ENFORCE(TryParseStringWithClassicLocale<float>(min_sparsity_str, min_sparsity) &&
+                  min_sparsity >= 0.0f && min_sparsity <= 1.0f,
+              "Invalid value for ", kOrtSessionOptionsMlasBlockSparseGemmMinSparsity, ": ", min_sparsity_str,
+              ". Expected a value in [0, 1].");
+  return min_sparsity;
+}
+
+bool GemmPackBBlockSparseFp32(AllocatorPtr& alloc,
+                              const Tensor& tensor_b,
+                              bool trans_b,
+                              float min_sparsity,
+                              IAllocatorUniquePtr<void>& packed_b,
+                              size_t& packed_b_size,
+                              TensorShape& b_shape) {
+  if (min_sparsity <= 0.0f || tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const auto& shape = tensor_b.Shape();
+  const size_t K = trans_b ? static_cast<size_t>(shape[1]) : static_cast<size_t>(shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(shape[0]) : static_cast<size_t>(shape[1]);
+  const CBLAS_TRANSPOSE trans = trans_b ? CblasTrans : CblasNoTrans;
+
+  packed_b_size = MlasBlockSparseGemmPackBSize(trans, N, K, tensor_b.Data<float>(), trans_b ? K : N, min_sparsity);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  b_shape = shape;
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  // zero the alignment padding so that the buffer hashes the same when shared between sessions
+  memset(packed_b.get(), 0, packed_b_size);
+  MlasBlockSparseGemmPackB(trans, N, K, tensor_b.Data<float>(), trans_b ? K : N, packed_b.get());
+  return true;
+}
+
 template <typename T>
 void Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
@@ -263,7 +324,12 @@ Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx,
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-    is_packed = GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
+    packed_b_is_block_sparse_ =
+        trans_A_ == CblasNoTrans &&
+        GemmPackBBlockSparseFp32(alloc, tensor, trans_B_ != CblasNoTrans, block_sparse_min_sparsity_, packed_b_,
+                                 packed_b_size, b_shape_);
+    is_packed = packed_b_is_block_sparse_ ||
+                GemmPackBFp32(alloc, tensor, trans_B_ != CblasNoTrans, packed_b_, packed_b_size, b_shape_);
     bool share_prepacked_weights = (prepacked_weights != nullptr);
     if (is_packed && share_prepacked_weights) {
       prepacked_weights->buffers_.push_back(std::move(packed_b_));
@@ -294,6 +360,35 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::UseCachedPrePackedBuffers(const Tensor& /*tensor*/, int /*input_idx*/,
+                                          std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                          gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                          /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::UseCachedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                              std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              gsl::span<const size_t> prepacked_buffer_sizes,
+                                              /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+
+  // the block sparse packing depends on the values of the weight, let PrePack() decide
+  if (block_sparse_min_sparsity_ > 0.0f) {
+    return Status::OK();
+  }
+
+  if (input_idx == 1 &&
+      GemmCanUsePackedBFp32(tensor, trans_B_ != CblasNoTrans, prepacked_buffer_sizes, b_shape_)) {
+    used_cached_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
@@ -423,7 +518,17 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
                 c_data, c_shape, y_data, thread_pool);
   } else {
     GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
-    if (K > 0) {
+    if (K > 0 && packed_b_is_block_sparse_) {
+      MlasBlockSparseGemm(static_cast<size_t>(M),
+                          A->Data<float>(),
+                          static_cast<size_t>(K),
+                          packed_b_.get(),
+                          y_data,
+                          static_cast<size_t>(N),
+                          alpha_,
+                          c_data != nullptr ? beta_ : 0.0f,
+                          thread_pool);
+    } else if (K > 0) {
       MlasGemm(
           trans_A_,
           static_cast<size_t>(M),
@@ -14,4 +14,22 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
                    size_t& packed_b_size,
                    TensorShape& b_shape);
 
+// Checks that `packed_b_sizes` is what GemmPackBFp32 produces for `tensor_b` and sets b_shape if so.
+bool GemmCanUsePackedBFp32(const Tensor& tensor_b,
+                           bool trans_b,
+                           gsl::span<const size_t> packed_b_sizes,
+                           TensorShape& b_shape);
+
+// Returns the minimum sparsity of the weights packed by GemmPackBBlockSparseFp32, 0 if block sparse packing is disabled.
+float GemmBlockSparseMinSparsity(const OpKernelInfo& info);
+
+// Packs a 2D weight matrix for MlasBlockSparseGemm if at least `min_sparsity` of its blocks are zero.
+bool GemmPackBBlockSparseFp32(AllocatorPtr& alloc,
+                              const Tensor& tensor_b,
+                              bool trans_b,
+                              float min_sparsity,
+                              IAllocatorUniquePtr<void>& packed_b,
+                              size_t& packed_b_size,
+                              TensorShape& b_shape);
+
 };  // namespace onnxruntime
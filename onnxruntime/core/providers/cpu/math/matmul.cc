@@ -4,16 +4,28 @@
 #include "core/providers/cpu/math/matmul.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cpu/tunable/math/sgemm.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
+#ifdef ENABLE_STRIDED_TENSORS
+#include "core/framework/copy.h"
+#endif
+
 namespace onnxruntime {
 
+#ifdef ENABLE_STRIDED_TENSORS
+// the float kernel reads strided views of 2D matrices, e.g. the outputs of Slice and Transpose, in place
+#define CREATE_MATMUL_FLOAT_KERNEL_DEF KernelDefBuilder().MayStridedInput(0).MayStridedInput(1)
+#else
+#define CREATE_MATMUL_FLOAT_KERNEL_DEF KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     MatMul,
     1, 8,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    CREATE_MATMUL_FLOAT_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     MatMul<float>);
 
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
@@ -29,7 +41,7 @@ ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     9,
     12,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    CREATE_MATMUL_FLOAT_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     MatMul<float>);
 
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
@@ -62,7 +74,7 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     MatMul,
     13,
     float,
-    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    CREATE_MATMUL_FLOAT_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     MatMul<float>);
 
 ONNX_CPU_OPERATOR_TYPED_KERNEL(
@@ -133,7 +145,7 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   return Status::OK();
 }
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
 bool GemmPackBBfloat16(AllocatorPtr& alloc,
                        const Tensor& tensor_b,
                        bool trans_b,
@@ -180,7 +192,7 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
     size_t dim1 = 0;
     size_t dim2 = 0;
     TensorShape b_shape = tensor.Shape();
@@ -189,8 +201,18 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
       dim1 = static_cast<size_t>(b_shape[0]);
       dim2 = static_cast<size_t>(b_shape[1]);
     }
+#endif
+
+    packed_b_is_block_sparse_ =
+        trans_a_attr_ == 0 &&
+        GemmPackBBlockSparseFp32(alloc, tensor, trans_b_attr_ != 0, block_sparse_min_sparsity_, packed_b_,
+                                 packed_b_size, b_shape_);
 
-    if (use_fastmath_mode_ && (trans_b_attr_ == 0) && ((dim1 * dim2) >= kFastMathModeKernelsizeThreshold)) {
+    if (packed_b_is_block_sparse_) {
+      is_packed = true;
+    } else
+#if defined(MLAS_SBGEMM_SUPPORTED)
+        if (use_fastmath_mode_ && (trans_b_attr_ == 0) && ((dim1 * dim2) >= kFastMathModeKernelsizeThreshold)) {
       is_packed = GemmPackBBfloat16(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
     } else
 #endif
@@ -220,6 +242,81 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status MatMul<float>::UseCachedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                                std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                gsl::span<const size_t> prepacked_buffer_sizes,
+                                                /*out*/ bool& used_cached_buffers) {
+  used_cached_buffers = false;
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  // the bfloat16 packing depends on the session config, let PrePack() decide
+  if (use_fastmath_mode_) {
+    return Status::OK();
+  }
+#endif
+
+  // the block sparse packing depends on the values of the weight, let PrePack() decide
+  if (block_sparse_min_sparsity_ > 0.0f) {
+    return Status::OK();
+  }
+
+  if (input_idx == 1 &&
+      GemmCanUsePackedBFp32(tensor, trans_b_attr_ != 0, prepacked_buffer_sizes, b_shape_)) {
+    used_cached_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+#ifdef ENABLE_STRIDED_TENSORS
+namespace {
+// Lets MLAS read a non-contiguous operand of the GEMM in place if it's a 2D matrix with contiguous rows or columns,
+// adjusting the leading dimension, and flipping the transpose flag for contiguous columns.
+// Any other view is copied to `contiguous` first.
+Status PrepareStridedOperand(OpKernelContext* ctx, const Tensor& tensor, bool allow_transposed, Tensor& contiguous,
+                             const float*& data, size_t& ld, bool& trans) {
+  if (tensor.IsContiguous()) {
+    return Status::OK();
+  }
+
+  const auto& shape = tensor.Shape();
+  if (shape.NumDimensions() == 2) {
+    const auto strides = tensor.Strides();
+    const int64_t rows = shape[0];
+    const int64_t cols = shape[1];
+    if ((cols == 1 || strides[1] == 1) && (rows == 1 || strides[0] >= cols)) {
+      ld = narrow<size_t>(rows == 1 ? cols : strides[0]);
+      return Status::OK();
+    }
+
+    if (allow_transposed && (rows == 1 || strides[0] == 1) && (cols == 1 || strides[1] >= rows)) {
+      ld = narrow<size_t>(cols == 1 ? rows : strides[1]);
+      trans = !trans;
+      return Status::OK();
+    }
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+  contiguous = Tensor(tensor.DataType(), shape, std::move(alloc));
+  ORT_RETURN_IF_ERROR(DispatchStridedCopy<TypeList<float>>(ctx->GetOperatorThreadPool(),
+                                                           contiguous, 0, StridesForTensor(contiguous), shape,
+                                                           tensor, 0, ToShapeVector(tensor.Strides())));
+  data = contiguous.Data<float>();
+  return Status::OK();
+}
+}  // namespace
+#endif
+
+cpu::tunable::CpuTuningContext* MatMul<float>::GetCpuTuningContext(const OpKernelInfo& info) {
+  const auto* ep = info.GetExecutionProvider();
+  if (ep == nullptr || ep->Type() != kCpuExecutionProvider) {
+    return nullptr;
+  }
+  return static_cast<cpu::tunable::CpuTuningContext*>(ep->GetTuningContext());
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -256,10 +353,36 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t M = static_cast<size_t>(helper.M());
   const size_t N = static_cast<size_t>(helper.N());
   const size_t K = static_cast<size_t>(helper.K());
-  const size_t lda = helper.Lda(trans_a);
-  const size_t ldb = helper.Ldb(trans_b);
-#if defined(__aarch64__) && defined(__linux__)
-  if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
+  size_t lda = helper.Lda(trans_a);
+  size_t ldb = helper.Ldb(trans_b);
+  bool trans_a_data = trans_a;
+  bool trans_b_data = trans_b;
+
+#ifdef ENABLE_STRIDED_TENSORS
+  // the block sparse and bfloat16 kernels don't take a transpose flag for A
+  bool allow_transposed_a = !packed_b_is_block_sparse_;
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  allow_transposed_a = allow_transposed_a && !use_fastmath_mode_;
+#endif
+  Tensor a_contiguous;
+  Tensor b_contiguous;
+  ORT_RETURN_IF_ERROR(PrepareStridedOperand(ctx, *a, allow_transposed_a, a_contiguous, a_data, lda, trans_a_data));
+  if (b) {
+    ORT_RETURN_IF_ERROR(PrepareStridedOperand(ctx, *b, true, b_contiguous, b_data, ldb, trans_b_data));
+  }
+#endif
+
+  if (packed_b_is_block_sparse_) {
+    // B is 2D, so every product of the batch uses it
+    for (size_t i = 0; i < max_len; i++) {
+      MlasBlockSparseGemm(M, a_data + helper.LeftOffsets()[i], lda, packed_b_.get(),
+                          y_data + helper.OutputOffsets()[i], N, alpha_attr_, 0.0f, thread_pool);
+    }
+    return Status::OK();
+  }
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+  if (use_fastmath_mode_ && !trans_b_data && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
     std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
       data[i].BIsfp32 = !(bool(packed_b_));
@@ -289,8 +412,9 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
       data[i].alpha = alpha_attr_;
       data[i].beta = 0.0f;
     }
-    MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
-                  M, N, K, data.data(), max_len, thread_pool);
+    ORT_RETURN_IF_ERROR(cpu::tunable::TunableSgemmBatch(tuning_ctx_, trans_a_data ? CblasTrans : CblasNoTrans,
+                                                        trans_b_data ? CblasTrans : CblasNoTrans,
+                                                        M, N, K, data.data(), max_len, thread_pool));
   }
   return Status::OK();
 }
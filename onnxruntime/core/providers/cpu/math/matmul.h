@@ -5,10 +5,17 @@
 
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
+namespace cpu {
+namespace tunable {
+class CpuTuningContext;
+}  // namespace tunable
+}  // namespace cpu
+
 template <typename T>
 class MatMul final : public OpKernel {
  public:
@@ -29,11 +36,17 @@ class MatMul<float> final : public OpKernel {
     info.GetAttrOrDefault<int64_t>("transBatchB", &trans_batch_b_attr, 0);
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
+    block_sparse_min_sparsity_ = GemmBlockSparseMinSparsity(info);
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
+#if defined(MLAS_TARGET_AMD64)
+    auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathX64Bfloat16);
+#else
     auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
+#endif
     use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
 #endif
+    tuning_ctx_ = GetCpuTuningContext(info);
   }
 
   Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
@@ -43,11 +56,24 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseCachedPrePackedBuffers(const Tensor& tensor, int input_idx,
+                                   std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   gsl::span<const size_t> prepacked_buffer_sizes,
+                                   /*out*/ bool& used_cached_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
+  // packed_b_ holds the non-zero blocks of B for MlasBlockSparseGemm
+  bool packed_b_is_block_sparse_ = false;
+  float block_sparse_min_sparsity_ = 0.0f;
+
+  static cpu::tunable::CpuTuningContext* GetCpuTuningContext(const OpKernelInfo& info);
+
+  // the TunableOp context of the CPU EP, if the kernel runs on it
+  cpu::tunable::CpuTuningContext* tuning_ctx_ = nullptr;
 
   // For FusedMatMul contrib ops
   float alpha_attr_;
@@ -56,11 +82,12 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_a_;
   bool trans_batch_b_;
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SBGEMM_SUPPORTED)
   // fastmath mode state
   bool use_fastmath_mode_;
   // sbgemm kernel is implemented as 8x8 blocks with weights pre-packed to 4 blocks of 4x2
-  // so a minimum of 32 elements is defined to outweigh the additional prepacking overhead
+  // so a minimum of 32 elements is defined to outweigh the additional prepacking overhead.
+  // The x64 kernel computes blocks of 8 rows and 32 columns and uses the same threshold.
   const size_t kFastMathModeKernelsizeThreshold = 32;
 #endif
 };
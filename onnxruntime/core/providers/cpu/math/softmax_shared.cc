@@ -24,6 +24,8 @@
 #include <cmath>
 #include <gsl/gsl>
 
+#include "core/framework/float16.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
@@ -103,4 +105,37 @@ common::Status SoftmaxCPU<float>(size_t N,
   return Status::OK();
 }
 
+// The fp16 tensors are read and written once, but each block of rows is computed in fp32 so the sum of the
+// exponentials doesn't lose precision.
+template <>
+common::Status SoftmaxCPU<MLFloat16>(size_t N,
+                                     size_t D,
+                                     const MLFloat16* Xdata,
+                                     MLFloat16* Ydata,
+                                     bool logarithmic,
+                                     onnxruntime::concurrency::ThreadPool* thread_pool) {
+  // rows converted at a time, so the fp32 buffer stays in the cache
+  constexpr size_t kBlockElements = 16384;
+  const size_t rows_per_block = std::max<size_t>(1, kBlockElements / D);
+  const std::ptrdiff_t num_blocks = static_cast<std::ptrdiff_t>((N + rows_per_block - 1) / rows_per_block);
+  const double block_bytes = static_cast<double>(std::min(N, rows_per_block) * D * sizeof(MLFloat16));
+
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, num_blocks,
+      TensorOpCost{block_bytes, block_bytes, static_cast<double>(std::min(N, rows_per_block) * D) * 8.0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<float> buffer(std::min(N, rows_per_block) * D);
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const size_t row = static_cast<size_t>(block) * rows_per_block;
+          const size_t rows = std::min(rows_per_block, N - row);
+          const size_t count = rows * D;
+          MlasConvertHalfToFloatBuffer(Xdata + row * D, buffer.data(), count);
+          MlasComputeSoftmax(buffer.data(), buffer.data(), rows, D, logarithmic, false, nullptr);
+          MlasConvertFloatToHalfBuffer(buffer.data(), Ydata + row * D, count);
+        }
+      });
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
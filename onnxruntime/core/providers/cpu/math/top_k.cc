@@ -25,6 +25,7 @@
 #include <queue>
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 #include <core/common/safeint.h>
 
 namespace onnxruntime {
@@ -140,6 +141,98 @@ static void SelectTopK(const Comparator& comparer,
   // the data_holder now contains the indices of the top k elements in the first k elements
 }
 
+// Rows are split across the threads when there are fewer rows than threads (e.g. the scores of all the items
+// in a retrieval model) if each part of a row would have at least this many elements
+constexpr int64_t kMinTopKRowPartSize = 16 * 1024;
+
+// Selects the top k elements among the contiguous elements [begin, end) of the input. The indices of the top k
+// elements are written to 'top_k', in no particular order.
+template <class Comparator>
+static void SelectTopKInRange(const Comparator& comparer, const typename Comparator::DataType* input_data,
+                              int64_t begin, int64_t end, const unsigned k, std::vector<int64_t>& data_holder,
+                              int64_t* top_k) {
+  // same selector as FindTopKElements
+  const bool use_priority_queue = k < 4 || (std::log2(k) / std::log2(end - begin)) < 0.725;
+
+  if (use_priority_queue) {
+    // add first k items starting from the bottom up
+    int64_t cur_idx = begin;
+    for (size_t l = 0; l < k; ++l, ++cur_idx) {
+      top_k[k - l - 1] = cur_idx;
+      HeapifyIthPosition(top_k, k - l - 1, k, comparer);
+    }
+
+    // the top of the heap is the current worst top k value, so most of the values are discarded with a single
+    // comparison against it
+    auto top = input_data[top_k[0]];
+    for (; cur_idx < end; ++cur_idx) {
+      if (comparer.CompareValueOnly(input_data[cur_idx], top)) {
+        top_k[0] = cur_idx;
+        HeapifyIthPosition(top_k, 0, k, comparer);
+        top = input_data[top_k[0]];
+      }
+    }
+  } else {
+    data_holder.resize(onnxruntime::narrow<size_t>(end - begin));
+    std::iota(data_holder.begin(), data_holder.end(), begin);
+    std::nth_element(data_holder.begin(), data_holder.begin() + (k - 1), data_holder.end(), comparer);
+    std::copy(data_holder.begin(), data_holder.begin() + k, top_k);
+  }
+}
+
+// Finds the top k elements of each of the 'rows' rows of 'cols' contiguous elements by splitting the rows into
+// parts that are processed by different threads. The top k elements of a row are then selected among the top k
+// elements of its parts. As ties are broken by the index, this gives the same result as processing the whole row.
+// Returns false if the rows are too short to be worth splitting.
+template <class Comparator>
+static bool FindTopKElementsInLongRows(const typename Comparator::DataType* input_data, int64_t rows, int64_t cols,
+                                       const unsigned k, bool sorted, typename Comparator::DataType* values_data,
+                                       int64_t* indices_data, concurrency::ThreadPool* threadpool) {
+  const int64_t tp_threads = concurrency::ThreadPool::DegreeOfParallelism(threadpool);
+  const int64_t min_part_size = std::max(kMinTopKRowPartSize, static_cast<int64_t>(8) * k);
+  const int64_t parts_per_row = std::min((tp_threads + rows - 1) / rows, cols / min_part_size);
+  if (parts_per_row < 2) {
+    return false;
+  }
+
+  // the indices of the top k elements of each part
+  std::vector<int64_t> candidates(onnxruntime::narrow<size_t>(rows * parts_per_row * k));
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      threadpool, onnxruntime::narrow<ptrdiff_t>(rows * parts_per_row),
+      [&](std::ptrdiff_t part) {
+        const int64_t row = part / parts_per_row;
+        const int64_t part_in_row = part % parts_per_row;
+        // parts have at least min_part_size elements so there are always at least k elements in a part
+        const int64_t begin = row * cols + part_in_row * cols / parts_per_row;
+        const int64_t end = row * cols + (part_in_row + 1) * cols / parts_per_row;
+
+        Comparator comparer(input_data);
+        std::vector<int64_t> data_holder;
+        SelectTopKInRange(comparer, input_data, begin, end, k, data_holder, candidates.data() + part * k);
+      });
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      threadpool, onnxruntime::narrow<ptrdiff_t>(rows),
+      [&](std::ptrdiff_t row) {
+        Comparator comparer(input_data);
+        auto row_candidates = candidates.begin() + row * parts_per_row * k;
+        auto row_candidates_end = row_candidates + parts_per_row * k;
+        std::nth_element(row_candidates, row_candidates + (k - 1), row_candidates_end, comparer);
+        if (sorted) {
+          std::sort(row_candidates, row_candidates + k, comparer);
+        }
+
+        const int64_t row_offset = row * cols;
+        for (size_t l = 0; l < k; ++l) {
+          const int64_t idx = row_candidates[l];
+          values_data[row * k + l] = input_data[idx];
+          indices_data[row * k + l] = idx - row_offset;
+        }
+      });
+
+  return true;
+}
+
 // Given an input tensor 'input' and metadata values - 'k' and 'axis_parsed',
 // this method will extract the sorted top k largest/smallest elements and place them in the output tensor 'values'
 // along with the metadata output 'indices'
@@ -165,6 +258,15 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
   const int64_t block_slice = reduced_cols / k;
 
   int64_t tp_threads = concurrency::ThreadPool::DegreeOfParallelism(threadpool);
+
+  // if there are fewer rows than threads and the top k are selected along the innermost axis, long rows
+  // are split across the threads
+  if (block_slice == 1 && rows < tp_threads &&
+      FindTopKElementsInLongRows<Comparator>(input_data, rows, cols, k, sorted, values_data, indices_data,
+                                             threadpool)) {
+    return;
+  }
+
   int64_t num_threads = std::min(tp_threads, rows);  // split on rows so can't have more threads than rows
 
   // rough attempt to make sure there's enough work for each thread. if there's insufficient work the usage of
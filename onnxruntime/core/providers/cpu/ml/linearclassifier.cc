@@ -36,6 +36,8 @@ LinearClassifier::LinearClassifier(const OpKernelInfo& info)
 
   using_strings_ = !classlabels_strings_.empty();
   class_count_ = static_cast<ptrdiff_t>(intercepts_.size());
+
+  packed_coefficients_.Pack(info, coefficients_, static_cast<size_t>(class_count_));
 }
 
 // Use GEMM for the calculations, with broadcasting of intercepts
@@ -48,6 +50,7 @@ LinearClassifier::LinearClassifier(const OpKernelInfo& info)
 void LinearClassifier::ComputeImpl(const gsl::span<const float> input,
                                    ptrdiff_t num_batches, ptrdiff_t num_features, ptrdiff_t num_targets,
                                    const std::vector<float>& coefficients,
+                                   const PackedLinearCoefficients& packed_coefficients,
                                    const std::vector<float>& intercepts,
                                    Tensor& labels_output, Tensor& scores_output,
                                    POST_EVAL_TRANSFORM post_transform,
@@ -60,13 +63,17 @@ void LinearClassifier::ComputeImpl(const gsl::span<const float> input,
               "Scores output is incorrect size. Expected:", scores_output_size,
               " Found:", scores_output_data.size());
 
-  TensorShape intercepts_shape({num_targets});
-  onnxruntime::Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                        num_batches, num_targets, num_features,
-                                        1.f, input_data, coefficients.data(), 1.f,
-                                        intercepts.data(), &intercepts_shape,
-                                        scores_output_data.data(),
-                                        threadpool);
+  // The coefficients packed by the constructor can't be used if the input has a different number of features.
+  if (!packed_coefficients.Compute(input_data, narrow<size_t>(num_batches), narrow<size_t>(num_features),
+                                   intercepts.data(), scores_output_data.data(), threadpool)) {
+    TensorShape intercepts_shape({num_targets});
+    onnxruntime::Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                          num_batches, num_targets, num_features,
+                                          1.f, input_data, coefficients.data(), 1.f,
+                                          intercepts.data(), &intercepts_shape,
+                                          scores_output_data.data(),
+                                          threadpool);
+  }
 
   float* score = scores_output_data.data();
   float* end_scores = score + (num_batches * num_targets);  // we haven't added extra targets yet so iterate the original scores
@@ -196,7 +203,7 @@ Status LinearClassifier::Compute(OpKernelContext* ctx) const {
     input = cast_span;
   }
 
-  ComputeImpl(input, num_batches, num_features, class_count_, coefficients_, intercepts_,
+  ComputeImpl(input, num_batches, num_features, class_count_, coefficients_, packed_coefficients_, intercepts_,
               *Y, *Z, post_transform_, add_second_class, tp);
 
   if (cast_buffer != nullptr) {
@@ -19,6 +19,7 @@ class LinearClassifier final : public OpKernel {
  private:
   void ComputeImpl(const gsl::span<const float> input, ptrdiff_t num_batches, ptrdiff_t num_features, ptrdiff_t num_targets,
                    const std::vector<float>& coefficients,
+                   const PackedLinearCoefficients& packed_coefficients,
                    const std::vector<float>& intercepts,
                    Tensor& labels_output,
                    Tensor& scores_output,
@@ -34,6 +35,7 @@ class LinearClassifier final : public OpKernel {
   std::vector<float> intercepts_;
   std::vector<std::string> classlabels_strings_;
   std::vector<int64_t> classlabels_ints_;
+  PackedLinearCoefficients packed_coefficients_;
 };
 
 }  // namespace ml
@@ -26,6 +26,8 @@ LinearRegressor::LinearRegressor(const OpKernelInfo& info)
 
   // use the intercepts_ if they're valid
   use_intercepts_ = intercepts_.size() == static_cast<size_t>(num_targets_);
+
+  packed_coefficients_.Pack(info, coefficients_, narrow<size_t>(num_targets_));
 }
 
 // Use GEMM for the calculations, with broadcasting of intercepts
@@ -38,25 +40,22 @@ LinearRegressor::LinearRegressor(const OpKernelInfo& info)
 template <typename T>
 static Status ComputeImpl(const Tensor& input, ptrdiff_t num_batches, ptrdiff_t num_features, ptrdiff_t num_targets,
                           const std::vector<float>& coefficients,
+                          const PackedLinearCoefficients& packed_coefficients,
                           const std::vector<float>* intercepts, Tensor& output,
                           POST_EVAL_TRANSFORM post_transform,
                           concurrency::ThreadPool* threadpool) {
   const T* input_data = input.Data<T>();
   T* output_data = output.MutableData<T>();
 
-  if (intercepts != nullptr) {
+  // The coefficients packed by the constructor can't be used if the input has a different number of features.
+  if (!packed_coefficients.Compute(input_data, narrow<size_t>(num_batches), narrow<size_t>(num_features),
+                                   intercepts != nullptr ? intercepts->data() : nullptr, output_data, threadpool)) {
     TensorShape intercepts_shape({num_targets});
     onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
                                       num_batches, num_targets, num_features,
                                       1.f, input_data, coefficients.data(), 1.f,
-                                      intercepts->data(), &intercepts_shape,
-                                      output_data,
-                                      threadpool);
-  } else {
-    onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                      num_batches, num_targets, num_features,
-                                      1.f, input_data, coefficients.data(), 1.f,
-                                      nullptr, nullptr,
+                                      intercepts != nullptr ? intercepts->data() : nullptr,
+                                      intercepts != nullptr ? &intercepts_shape : nullptr,
                                       output_data,
                                       threadpool);
   }
@@ -91,7 +90,7 @@ Status LinearRegressor::Compute(OpKernelContext* ctx) const {
   switch (element_type) {
     case ONNX_NAMESPACE::TensorProto_DataType_FLOAT: {
       status = ComputeImpl<float>(X, num_batches, num_features, narrow<ptrdiff_t>(num_targets_), coefficients_,
-                                  use_intercepts_ ? &intercepts_ : nullptr,
+                                  packed_coefficients_, use_intercepts_ ? &intercepts_ : nullptr,
                                   Y, post_transform_, tp);
 
       break;
@@ -22,6 +22,7 @@ class LinearRegressor final : public OpKernel {
   std::vector<float> intercepts_;
   bool use_intercepts_;
   POST_EVAL_TRANSFORM post_transform_;
+  PackedLinearCoefficients packed_coefficients_;
 };
 
 }  // namespace ml
@@ -528,5 +528,75 @@ void batched_update_scores_inplace(gsl::span<T> scores, int64_t num_batches_in,
     }
   }
 }
+
+// Writes the value map holds for each element of input to output, or default_value for the elements it doesn't hold.
+// The lookups of large inputs are split across the threads of the pool.
+template <typename Map, typename TKey, typename TValue>
+void MapElements(const Map& map, gsl::span<const TKey> input, gsl::span<TValue> output, const TValue& default_value,
+                 concurrency::ThreadPool* threadpool) {
+  // a hash and a probe, which misses the cache for large maps
+  constexpr double kLookupCost = 64.0;
+  const TensorOpCost cost{static_cast<double>(sizeof(TKey)), static_cast<double>(sizeof(TValue)), kLookupCost};
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, static_cast<std::ptrdiff_t>(input.size()), cost,
+      [&map, input, output, &default_value](std::ptrdiff_t first, std::ptrdiff_t last) {
+        const auto map_end = map.end();
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const auto found = map.find(input[i]);
+          output[i] = found == map_end ? default_value : found->second;
+        }
+      });
+}
+
+// The coefficients [num_targets, num_features] of a linear model, packed once when the kernel is created so that each
+// batch of rows is scored with a single MlasGemm against the prepacked B.
+class PackedLinearCoefficients {
+ public:
+  void Pack(const OpKernelInfo& info, gsl::span<const float> coefficients, size_t num_targets) {
+    if (num_targets == 0 || coefficients.empty() || coefficients.size() % num_targets != 0) {
+      return;
+    }
+    const size_t num_features = coefficients.size() / num_targets;
+    const size_t packed_size = MlasGemmPackBSize(num_targets, num_features);
+    if (packed_size == 0) {
+      return;
+    }
+
+    AllocatorPtr alloc = info.GetAllocator(OrtMemType::OrtMemTypeDefault);
+    packed_ = IAllocator::MakeUniquePtr<void>(alloc, packed_size, true);
+    memset(packed_.get(), 0, packed_size);
+    MlasGemmPackB(CblasTrans, num_targets, num_features, coefficients.data(), num_features, packed_.get());
+    num_targets_ = num_targets;
+    num_features_ = num_features;
+  }
+
+  // Writes scores = input * coefficients^T + intercepts for the input [num_batches, num_features].
+  // intercepts has num_targets values or is nullptr. Returns false, without writing anything, if the coefficients
+  // could not be packed or have a different number of features.
+  bool Compute(const float* input, size_t num_batches, size_t num_features, const float* intercepts, float* scores,
+               concurrency::ThreadPool* threadpool) const {
+    if (packed_ == nullptr || num_features != num_features_) {
+      return false;
+    }
+    if (num_batches == 0) {
+      return true;
+    }
+
+    if (intercepts != nullptr) {
+      for (size_t i = 0; i < num_batches; ++i) {
+        std::copy_n(intercepts, num_targets_, scores + i * num_targets_);
+      }
+    }
+    MlasGemm(CblasNoTrans, num_batches, num_targets_, num_features_, 1.f, input, num_features_, packed_.get(),
+             intercepts != nullptr ? 1.f : 0.f, scores, num_targets_, threadpool);
+    return true;
+  }
+
+ private:
+  IAllocatorUniquePtr<void> packed_;
+  size_t num_targets_{0};
+  size_t num_features_{0};
+};
+
 }  // namespace ml
 }  // namespace onnxruntime
@@ -39,60 +39,69 @@ class SVMCommon {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
     if (kernel_type_ == KERNEL::RBF) {
-      T* cur_out = out.data();
-      const T* cur_batch = a.data();
+      // The squared distances are summed directly. Expanding them as |a|^2 + |b|^2 - 2 a.b to use a GEMM loses the
+      // small distances between vectors far from the origin to cancellation.
+      const auto support_vectors = ConstEigenMatrixMapRowMajor<T>(b.data(), n, k);
+      const TensorOpCost cost{static_cast<double>(n * k * sizeof(T)), static_cast<double>(n * sizeof(T)),
+                              static_cast<double>(n) * (static_cast<double>(k) * 3.0 + 8.0)};
+      concurrency::ThreadPool::TryParallelFor(
+          threadpool, m, cost,
+          [this, a, support_vectors, n, k, out](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t row = first; row < last; ++row) {
+              T* row_out = out.data() + row * n;
+              const auto features = ConstEigenVectorMap<T>(a.data() + row * k, k).transpose();
+              EigenVectorArrayMap<T>(row_out, n) =
+                  (support_vectors.rowwise() - features).rowwise().squaredNorm().array() * -gamma_;
+              MlasComputeExp(row_out, row_out, narrow<size_t>(n));
+            }
+          });
+      return;
+    }
 
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
+    float alpha = 1.f;
+    float beta = 1.f;
+    static const TensorShape shape_C({1});
+    float c = scalar_C;  // scalar_C is used for LINEAR in the GEMM
 
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
-        for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
+    if (kernel_type_ != KERNEL::LINEAR) {
+      // kernel_type_ == POLY or SIGMOID
+      alpha = gamma_;
+      c = coef0_;
+    }
 
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
-          }
+    onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                      m, n, k,
+                                      alpha, a.data(), b.data(), beta,
+                                      c != 0.f ? &c : nullptr, &shape_C,
+                                      out.data(),
+                                      threadpool);
 
-          *cur_out++ = std::exp(-gamma_ * sum);
-        }
-
-        cur_batch += k;  // move to start of next batch
-      }
-    } else {
-      float alpha = 1.f;
-      float beta = 1.f;
-      static const TensorShape shape_C({1});
-      float c = scalar_C;  // scalar_C is used for LINEAR in the GEMM
-
-      if (kernel_type_ != KERNEL::LINEAR) {
-        // kernel_type_ == POLY or SIGMOID
-        alpha = gamma_;
-        c = coef0_;
-      }
-
-      onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                        m, n, k,
-                                        alpha, a.data(), b.data(), beta,
-                                        c != 0.f ? &c : nullptr, &shape_C,
-                                        out.data(),
-                                        threadpool);
-
-      if (kernel_type_ == KERNEL::POLY) {
-        auto map_out = EigenVectorArrayMap<T>(out.data(), out.size());
-        if (degree_ == 2)
-          map_out = map_out.square();
-        else if (degree_ == 3)
-          map_out = map_out.cube();
-        else
-          map_out = map_out.pow(degree_);
-
-      } else if (kernel_type_ == KERNEL::SIGMOID) {
-        MlasComputeTanh(out.data(), out.data(), out.size());
-      }
+    if (kernel_type_ == KERNEL::LINEAR || m == 0 || n == 0) {
+      return;
     }
+
+    // The kernel transform of the rows is split across the threads, each row in one vectorized pass.
+    const TensorOpCost cost{static_cast<double>(n * sizeof(T)), static_cast<double>(n * sizeof(T)),
+                            static_cast<double>(n) * 16.0};
+    concurrency::ThreadPool::TryParallelFor(
+        threadpool, m, cost,
+        [this, n, out](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t row = first; row < last; ++row) {
+            T* row_out = out.data() + row * n;
+            auto map_out = EigenVectorArrayMap<T>(row_out, n);
+
+            if (kernel_type_ == KERNEL::POLY) {
+              if (degree_ == 2)
+                map_out = map_out.square();
+              else if (degree_ == 3)
+                map_out = map_out.cube();
+              else
+                map_out = map_out.pow(degree_);
+            } else if (kernel_type_ == KERNEL::SIGMOID) {
+              MlasComputeTanh(row_out, row_out, narrow<size_t>(n));
+            }
+          }
+        });
   }
 
  private:
@@ -54,6 +54,20 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   std::vector<SparseValue<ThresholdType>> weights_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
 
+  // Alternate layout of the trees used to evaluate blocks of rows, see BuildCompleteTreeLayout().
+  // Every tree is padded to a complete binary tree stored breadth first: the children of node k are 2k+1 (true)
+  // and 2k+2 (false), so a row reaches its leaf after `depth` comparisons without following pointers.
+  struct CompleteTree {
+    uint32_t node_offset;
+    uint32_t leaf_offset;
+    uint32_t depth;
+  };
+  std::vector<CompleteTree> complete_trees_;
+  std::vector<int32_t> complete_tree_features_;
+  std::vector<ThresholdType> complete_tree_thresholds_;
+  std::vector<const TreeNodeElement<ThresholdType>*> complete_tree_leaves_;
+  NODE_MODE_ORT complete_tree_mode_ = NODE_MODE_ORT::BRANCH_LEQ;
+
  public:
   TreeEnsembleCommon() {}
 
@@ -69,6 +83,11 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   TreeNodeElement<ThresholdType>* ProcessTreeNodeLeave(TreeNodeElement<ThresholdType>* root,
                                                        const InputType* x_data) const;
 
+  // Calls fn(i, leaf) with the leaf of tree `tree_index` reached by every row i in [begin, end).
+  template <typename Fn>
+  void ProcessTreeNodeLeaves(size_t tree_index, const InputType* x_data, int64_t stride, int64_t begin, int64_t end,
+                             Fn&& fn) const;
+
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
 
@@ -84,8 +103,22 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
                   gsl::span<const int64_t> nodes_missing_value_tracks_true, std::vector<size_t>& updated_mapping,
                   int64_t tree_id, const InlinedVector<TreeNodeElementId>& node_tree_ids, gsl::span<const float> target_class_weights,
                   gsl::span<const ThresholdType> target_class_weights_as_tensor, InlinedVector<std::pair<TreeNodeElementId, uint32_t>>& indices);
+
+  void BuildCompleteTreeLayout();
+  void FillCompleteTree(const TreeNodeElement<ThresholdType>* node, size_t position, uint32_t level,
+                        const CompleteTree& tree);
+  template <NODE_MODE_ORT mode, typename Fn>
+  void ProcessCompleteTreeLeaves(const CompleteTree& tree, const InputType* x_data, int64_t stride, int64_t begin,
+                                 int64_t end, Fn& fn) const;
 };
 
+// The complete tree layout is used when the padded trees are not much bigger than the original ones,
+// and for at least kMinRowsForCompleteTrees rows, evaluated by blocks of kCompleteTreeRowBlock rows.
+constexpr uint32_t kMaxCompleteTreeDepth = 12;
+constexpr size_t kMaxCompleteTreeExpansion = 4;
+constexpr int64_t kMinRowsForCompleteTrees = 4;
+constexpr int64_t kCompleteTreeRowBlock = 16;
+
 // Below is simple implementation of `bit_cast` as it is supported from c++20 and the current supported version is c++17
 // Remove it when that is not the case
 template <class To, class From>
@@ -288,9 +321,92 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     }
   }
 
+  BuildCompleteTreeLayout();
   return Status::OK();
 }
 
+// Returns the depth of the tree below `node`, or any value greater than max_depth if it is deeper than max_depth.
+template <typename T>
+uint32_t GetTreeDepth(const TreeNodeElement<T>* node, uint32_t max_depth) {
+  if (!node->is_not_leaf()) {
+    return 0;
+  }
+  if (max_depth == 0) {
+    return 1;
+  }
+  return 1 + std::max(GetTreeDepth(node + 1, max_depth - 1), GetTreeDepth(node->truenode_or_weight.ptr, max_depth - 1));
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::BuildCompleteTreeLayout() {
+  complete_trees_.clear();
+  complete_tree_features_.clear();
+  complete_tree_thresholds_.clear();
+  complete_tree_leaves_.clear();
+
+  // The rows of a block take different paths, so all the nodes must compare the same way.
+  // Missing value tracks would need one more test per node and keep the pointer based traversal.
+  if (!same_mode_ || has_missing_tracks_) {
+    return;
+  }
+  // same_mode_ is checked on the onnx modes, chains of BRANCH_EQ nodes may have been merged into BRANCH_MEMBER nodes
+  bool found_mode = false;
+  for (const auto& node : nodes_) {
+    if (!node.is_not_leaf()) {
+      continue;
+    }
+    if (!found_mode) {
+      complete_tree_mode_ = node.mode();
+      found_mode = true;
+    } else if (node.mode() != complete_tree_mode_) {
+      return;
+    }
+  }
+
+  size_t num_nodes = 0, num_leaves = 0;
+  complete_trees_.reserve(roots_.size());
+  for (const auto* root : roots_) {
+    const uint32_t depth = GetTreeDepth(root, kMaxCompleteTreeDepth);
+    if (depth > kMaxCompleteTreeDepth) {
+      complete_trees_.clear();
+      return;
+    }
+    complete_trees_.push_back({static_cast<uint32_t>(num_nodes), static_cast<uint32_t>(num_leaves), depth});
+    num_leaves += size_t{1} << depth;
+    num_nodes += (size_t{1} << depth) - 1;
+  }
+  if (num_nodes + num_leaves > kMaxCompleteTreeExpansion * nodes_.size()) {
+    complete_trees_.clear();
+    return;
+  }
+
+  complete_tree_features_.resize(num_nodes, 0);
+  complete_tree_thresholds_.resize(num_nodes, 0);
+  complete_tree_leaves_.resize(num_leaves, nullptr);
+  for (size_t j = 0; j < roots_.size(); ++j) {
+    FillCompleteTree(roots_[j], 0, 0, complete_trees_[j]);
+  }
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::FillCompleteTree(
+    const TreeNodeElement<ThresholdType>* node, size_t position, uint32_t level, const CompleteTree& tree) {
+  if (level == tree.depth) {
+    complete_tree_leaves_[tree.leaf_offset + position - ((size_t{1} << tree.depth) - 1)] = node;
+    return;
+  }
+  if (node->is_not_leaf()) {
+    complete_tree_features_[tree.node_offset + position] = node->feature_id;
+    complete_tree_thresholds_[tree.node_offset + position] = node->value_or_unique_weight;
+    FillCompleteTree(node->truenode_or_weight.ptr, 2 * position + 1, level + 1, tree);
+    FillCompleteTree(node + 1, 2 * position + 2, level + 1, tree);
+  } else {
+    // A leaf above the last level: both children of the padding node lead to it, whatever the comparison says.
+    FillCompleteTree(node, 2 * position + 1, level + 1, tree);
+    FillCompleteTree(node, 2 * position + 2, level + 1, tree);
+  }
+}
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 bool TreeEnsembleCommon<InputType, ThresholdType, OutputType>::CheckIfSubtreesAreEqual(
     const size_t left_id, const size_t right_id, const int64_t tree_id, const InlinedVector<NODE_MODE_ONNX>& cmodes,
@@ -524,9 +640,10 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
           scores[SafeInt<ptrdiff_t>(i - batch)] = {0, 0};
         }
         for (j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-          for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-          }
+          ProcessTreeNodeLeaves(j, x_data, stride, batch, batch_end,
+                                [&agg, &scores, batch](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                                  agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], leaf);
+                                });
         }
         for (i = batch; i < batch_end; ++i) {
           agg.FinalizeScores1(z_data + i, scores[SafeInt<ptrdiff_t>(i - batch)],
@@ -548,10 +665,10 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
                 scores[batch_num * SafeInt<ptrdiff_t>(N) + i] = {0, 0};
               }
               for (auto j = work.start; j < work.end; ++j) {
-                for (int64_t i = begin_n; i < end_n; ++i) {
-                  agg.ProcessTreeNodePrediction1(scores[batch_num * SafeInt<ptrdiff_t>(N) + i],
-                                                 *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-                }
+                ProcessTreeNodeLeaves(j, x_data, stride, begin_n, end_n,
+                                      [&agg, &scores, batch_num, N](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                                        agg.ProcessTreeNodePrediction1(scores[batch_num * SafeInt<ptrdiff_t>(N) + i], leaf);
+                                      });
               }
             });
         begin_n = end_n;
@@ -624,9 +741,10 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
           std::fill(scores[SafeInt<ptrdiff_t>(i - batch)].begin(), scores[SafeInt<ptrdiff_t>(i - batch)].end(), ScoreValue<ThresholdType>({0, 0}));
         }
         for (j = 0, limit = roots_.size(); j < limit; ++j) {
-          for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
-          }
+          ProcessTreeNodeLeaves(j, x_data, stride, batch, batch_end,
+                                [this, &agg, &scores, batch](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                                  agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], leaf, weights_);
+                                });
         }
         for (i = batch; i < batch_end; ++i) {
           agg.FinalizeScores(scores[SafeInt<ptrdiff_t>(i - batch)], z_data + i * n_targets_or_classes_, -1,
@@ -649,10 +767,11 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
                 scores[batch_num * SafeInt<ptrdiff_t>(N) + i].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
               }
               for (auto j = work.start; j < work.end; ++j) {
-                for (int64_t i = begin_n; i < end_n; ++i) {
-                  agg.ProcessTreeNodePrediction(scores[batch_num * SafeInt<ptrdiff_t>(N) + i],
-                                                *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
-                }
+                ProcessTreeNodeLeaves(j, x_data, stride, begin_n, end_n,
+                                      [this, &agg, &scores, batch_num, N](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                                        agg.ProcessTreeNodePrediction(scores[batch_num * SafeInt<ptrdiff_t>(N) + i], leaf,
+                                                                      weights_);
+                                      });
               }
             });
         begin_n = end_n;
@@ -814,6 +933,95 @@ TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeave(
   return root;
 }
 
+template <NODE_MODE_ORT mode, typename InputType, typename ThresholdType>
+inline bool CompareToThreshold(InputType val, ThresholdType threshold) {
+  if constexpr (mode == NODE_MODE_ORT::BRANCH_LEQ) {
+    return val <= threshold;
+  } else if constexpr (mode == NODE_MODE_ORT::BRANCH_LT) {
+    return val < threshold;
+  } else if constexpr (mode == NODE_MODE_ORT::BRANCH_GTE) {
+    return val >= threshold;
+  } else if constexpr (mode == NODE_MODE_ORT::BRANCH_GT) {
+    return val > threshold;
+  } else if constexpr (mode == NODE_MODE_ORT::BRANCH_EQ) {
+    return val == threshold;
+  } else if constexpr (mode == NODE_MODE_ORT::BRANCH_NEQ) {
+    return val != threshold;
+  } else {
+    return SetMembershipCheck(val, threshold);
+  }
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <NODE_MODE_ORT mode, typename Fn>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessCompleteTreeLeaves(
+    const CompleteTree& tree, const InputType* x_data, int64_t stride, int64_t begin, int64_t end, Fn& fn) const {
+  const int32_t* features = complete_tree_features_.data() + tree.node_offset;
+  const ThresholdType* thresholds = complete_tree_thresholds_.data() + tree.node_offset;
+  const TreeNodeElement<ThresholdType>* const* leaves = complete_tree_leaves_.data() + tree.leaf_offset;
+  const uint32_t first_leaf = (uint32_t{1} << tree.depth) - 1;
+
+  // The rows of a block go down the tree together, so the loads of different rows are independent and overlap,
+  // and the inner loop has no branch the compiler could not turn into a select.
+  uint32_t positions[kCompleteTreeRowBlock];
+  for (int64_t block = begin; block < end; block += kCompleteTreeRowBlock) {
+    const int64_t block_size = std::min(kCompleteTreeRowBlock, end - block);
+    const InputType* x_block = x_data + block * stride;
+    for (int64_t r = 0; r < block_size; ++r) {
+      positions[r] = 0;
+    }
+    for (uint32_t level = 0; level < tree.depth; ++level) {
+      for (int64_t r = 0; r < block_size; ++r) {
+        const uint32_t k = positions[r];
+        const bool is_true = CompareToThreshold<mode>(x_block[r * stride + features[k]], thresholds[k]);
+        positions[r] = 2 * k + 2 - static_cast<uint32_t>(is_true);
+      }
+    }
+    for (int64_t r = 0; r < block_size; ++r) {
+      fn(block + r, *leaves[positions[r] - first_leaf]);
+    }
+  }
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename Fn>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeaves(
+    size_t tree_index, const InputType* x_data, int64_t stride, int64_t begin, int64_t end, Fn&& fn) const {
+  if (complete_trees_.empty() || end - begin < kMinRowsForCompleteTrees) {
+    for (int64_t i = begin; i < end; ++i) {
+      fn(i, *ProcessTreeNodeLeave(roots_[tree_index], x_data + i * stride));
+    }
+    return;
+  }
+
+  const CompleteTree& tree = complete_trees_[tree_index];
+  switch (complete_tree_mode_) {
+    case NODE_MODE_ORT::BRANCH_LEQ:
+      ProcessCompleteTreeLeaves<NODE_MODE_ORT::BRANCH_LEQ>(tree, x_data, stride, begin, end, fn);
+      break;
+    case NODE_MODE_ORT::BRANCH_LT:
+      ProcessCompleteTreeLeaves<NODE_MODE_ORT::BRANCH_LT>(tree, x_data, stride, begin, end, fn);
+      break;
+    case NODE_MODE_ORT::BRANCH_GTE:
+      ProcessCompleteTreeLeaves<NODE_MODE_ORT::BRANCH_GTE>(tree, x_data, stride, begin, end, fn);
+      break;
+    case NODE_MODE_ORT::BRANCH_GT:
+      ProcessCompleteTreeLeaves<NODE_MODE_ORT::BRANCH_GT>(tree, x_data, stride, begin, end, fn);
+      break;
+    case NODE_MODE_ORT::BRANCH_EQ:
+      ProcessCompleteTreeLeaves<NODE_MODE_ORT::BRANCH_EQ>(tree, x_data, stride, begin, end, fn);
+      break;
+    case NODE_MODE_ORT::BRANCH_NEQ:
+      ProcessCompleteTreeLeaves<NODE_MODE_ORT::BRANCH_NEQ>(tree, x_data, stride, begin, end, fn);
+      break;
+    case NODE_MODE_ORT::BRANCH_MEMBER:
+      ProcessCompleteTreeLeaves<NODE_MODE_ORT::BRANCH_MEMBER>(tree, x_data, stride, begin, end, fn);
+      break;
+    case NODE_MODE_ORT::LEAF:
+      ORT_THROW("Unexpected mode for the complete tree layout.");
+  }
+}
+
 // TI: input type
 // TH: threshold type, double if T==double, float otherwise
 // TO: output type
@@ -2,6 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/zipmap.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 /**
 https://github.com/onnx/onnx/blob/main/onnx/defs/traditionalml/defs.cc
@@ -35,6 +40,54 @@ ONNX_CPU_OPERATOR_ML_KERNEL(
                                             DataTypeImpl::GetType<std::vector<std::map<std::int64_t, float>>>()}),
     ZipMapOp);
 
+namespace {
+
+// Returns the indices of labels in increasing label order. Of equal labels only the last one is kept, as it is the
+// value assigned last that the map holds.
+template <typename T>
+std::vector<size_t> SortedLabelOrder(const std::vector<T>& labels) {
+  std::vector<size_t> order(labels.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::stable_sort(order.begin(), order.end(), [&labels](size_t a, size_t b) { return labels[a] < labels[b]; });
+
+  std::vector<size_t> unique_order;
+  unique_order.reserve(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (i + 1 < order.size() && !(labels[order[i]] < labels[order[i + 1]])) {
+      continue;
+    }
+    unique_order.push_back(order[i]);
+  }
+  return unique_order;
+}
+
+// Builds one map per row. The labels are inserted in increasing order at the end of the map, which takes constant
+// time per label instead of a search, and the rows are split across the threads.
+template <typename T>
+void ZipRows(const std::vector<T>& labels, const std::vector<size_t>& label_order, const float* x_data,
+             size_t batch_size, size_t features_per_batch, std::vector<std::map<T, float>>& output,
+             concurrency::ThreadPool* threadpool) {
+  output.resize(batch_size);
+
+  // a node allocation per label dominates
+  const double features = static_cast<double>(features_per_batch);
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, static_cast<std::ptrdiff_t>(batch_size),
+      TensorOpCost{features * sizeof(float), features * 64.0, features * 32.0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t n = first; n < last; ++n) {
+          const float* x = x_data + static_cast<size_t>(n) * features_per_batch;
+          std::map<T, float> row;
+          for (size_t index : label_order) {
+            row.emplace_hint(row.end(), labels[index], x[index]);
+          }
+          output[static_cast<size_t>(n)] = std::move(row);
+        }
+      });
+}
+
+}  // namespace
+
 ZipMapOp::ZipMapOp(const OpKernelInfo& info)
     : OpKernel(info),
       classlabels_int64s_(info.GetAttrsOrDefault<int64_t>("classlabels_int64s")),
@@ -42,6 +95,7 @@ ZipMapOp::ZipMapOp(const OpKernelInfo& info)
   ORT_ENFORCE(classlabels_strings_.empty() ^ classlabels_int64s_.empty(),
               "Must provide classlabels_strings or classlabels_int64s but not both.");
   using_strings_ = !classlabels_strings_.empty();
+  label_order_ = using_strings_ ? SortedLabelOrder(classlabels_strings_) : SortedLabelOrder(classlabels_int64s_);
 }
 
 common::Status ZipMapOp::Compute(OpKernelContext* context) const {
@@ -77,17 +131,8 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     auto* y_data = context->Output<std::vector<std::map<std::string, float>>>(0);
     if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
 
-    // auto* y_data = Y->MutableData<std::vector<std::map<std::string, float>>>();
-    y_data->resize(onnxruntime::narrow<size_t>(batch_size));
-    int64_t current_weight_0 = 0;
-    for (int64_t n = 0; n < batch_size; n++) {
-      std::map<std::string, float> map1;
-      for (int64_t j = 0; j < features_per_batch; j++) {
-        map1[classlabels_strings_[onnxruntime::narrow<size_t>(j)]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[onnxruntime::narrow<size_t>(n)] = std::move(map1);
-    }
+    ZipRows(classlabels_strings_, label_order_, x_data, onnxruntime::narrow<size_t>(batch_size),
+            onnxruntime::narrow<size_t>(features_per_batch), *y_data, context->GetOperatorThreadPool());
   } else {
     if (features_per_batch != static_cast<int64_t>(classlabels_int64s_.size())) {
       return Status(ONNXRUNTIME,
@@ -97,17 +142,8 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     }
     auto* y_data = context->Output<std::vector<std::map<std::int64_t, float>>>(0);
     if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-    // auto* y_data = Y->MutableData<std::vector<std::map<int64_t, float>>>();
-    y_data->resize(onnxruntime::narrow<size_t>(batch_size));
-    int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<int64_t, float> map2;
-      for (int j = 0; j < features_per_batch; j++) {
-        map2[classlabels_int64s_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map2);
-    }
+    ZipRows(classlabels_int64s_, label_order_, x_data, onnxruntime::narrow<size_t>(batch_size),
+            onnxruntime::narrow<size_t>(features_per_batch), *y_data, context->GetOperatorThreadPool());
   }
   return common::Status::OK();
 }
@@ -16,6 +16,8 @@ class ZipMapOp final : public OpKernel {
   bool using_strings_;
   std::vector<int64_t> classlabels_int64s_;
   std::vector<std::string> classlabels_strings_;
+  // indices of the class labels in increasing label order, so that the maps are built by appending
+  std::vector<size_t> label_order_;
 };
 
 }  // namespace ml
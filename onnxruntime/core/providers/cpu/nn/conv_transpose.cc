@@ -17,6 +17,9 @@
 
 #include "core/providers/cpu/nn/conv_transpose.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "core/mlas/inc/mlas.h"
 #include "core/common/safeint.h"
 #include "core/util/math.h"
@@ -24,6 +27,276 @@
 
 namespace onnxruntime {
 
+namespace {
+
+// ConvTranspose with stride s computes each output position from the kernel taps k with (output + pad - k) % s == 0.
+// The outputs of the s^rank phases r = (output + pad) % s are therefore ordinary convolutions of the input with the
+// flipped sub-kernel of the taps r, r + s, r + 2s, ..., written interleaved into the output. This avoids the column
+// buffer and the scatter-add of Col2im.
+struct ConvTransposePhase {
+  int64_t phase[3]{};
+  int64_t kernel_shape[3]{};
+  int64_t kernel_size{1};
+  size_t filter_offset{0};
+};
+
+InlinedVector<ConvTransposePhase> GetConvTransposePhases(gsl::span<const int64_t> kernel_shape,
+                                                          gsl::span<const int64_t> strides,
+                                                          size_t filter_count, size_t group_input_channels,
+                                                          size_t& total_filter_size) {
+  const size_t rank = kernel_shape.size();
+  int64_t phase_count = 1;
+  for (size_t d = 0; d < rank; d++) {
+    phase_count *= strides[d];
+  }
+
+  InlinedVector<ConvTransposePhase> phases(onnxruntime::narrow<size_t>(phase_count));
+  total_filter_size = 0;
+  for (int64_t index = 0; index < phase_count; index++) {
+    auto& phase = phases[onnxruntime::narrow<size_t>(index)];
+    int64_t remainder = index;
+    for (size_t d = rank; d-- > 0;) {
+      phase.phase[d] = remainder % strides[d];
+      remainder /= strides[d];
+      phase.kernel_shape[d] = std::max<int64_t>(kernel_shape[d] - phase.phase[d] + strides[d] - 1, 0) / strides[d];
+      phase.kernel_size *= phase.kernel_shape[d];
+    }
+    phase.filter_offset = total_filter_size;
+    total_filter_size += filter_count * group_input_channels * onnxruntime::narrow<size_t>(phase.kernel_size);
+  }
+  return phases;
+}
+
+// Reorders the {C, M/group, k1, ...} ConvTranspose filter to the {M, C/group, k1/s1, ...} convolution filter of
+// each phase, with the sub-kernels flipped.
+void ReorderConvTransposePhaseFilters(const float* filter, float* phase_filters,
+                                      gsl::span<const ConvTransposePhase> phases,
+                                      gsl::span<const int64_t> kernel_shape, gsl::span<const int64_t> strides,
+                                      int64_t group, int64_t input_channels, int64_t group_output_channels) {
+  const size_t rank = kernel_shape.size();
+  const int64_t group_input_channels = input_channels / group;
+  const int64_t kernel_size = std::accumulate(kernel_shape.begin(), kernel_shape.end(), int64_t{1},
+                                              std::multiplies<int64_t>());
+
+  for (const auto& phase : phases) {
+    float* output = phase_filters + phase.filter_offset;
+    for (int64_t g = 0; g < group; g++) {
+      for (int64_t m = 0; m < group_output_channels; m++) {
+        for (int64_t c = 0; c < group_input_channels; c++) {
+          const float* input = filter + ((g * group_input_channels + c) * group_output_channels + m) * kernel_size;
+          for (int64_t j = 0; j < phase.kernel_size; j++) {
+            int64_t remainder = j;
+            int64_t kernel_offset = 0;
+            int64_t kernel_stride = 1;
+            for (size_t d = rank; d-- > 0;) {
+              const int64_t sub_index = remainder % phase.kernel_shape[d];
+              remainder /= phase.kernel_shape[d];
+              const int64_t k = phase.phase[d] + (phase.kernel_shape[d] - 1 - sub_index) * strides[d];
+              kernel_offset += k * kernel_stride;
+              kernel_stride *= kernel_shape[d];
+            }
+            *output++ = input[kernel_offset];
+          }
+        }
+      }
+    }
+  }
+}
+
+// Computes the float ConvTranspose as the stride-decomposed convolutions of each phase.
+Status SubPixelConvTranspose(const ConvTransposeAttributes::Prepare& p, int64_t group, const float* phase_filters,
+                             gsl::span<const ConvTransposePhase> phases, AllocatorPtr alloc,
+                             concurrency::ThreadPool* thread_pool) {
+  const size_t rank = p.kernel_shape.size();
+  const auto input_shape = p.input_shape.GetDims();
+  const auto output_shape = p.Y->Shape().GetDims().subspan(2);
+  const int64_t input_image_size = p.input_shape.Size();
+  const int64_t output_image_size = TensorShape(output_shape).Size();
+  const int64_t M = p.num_output_channels;
+
+  struct PhaseGeometry {
+    MLAS_CONV_PARAMETERS parameters;
+    int64_t count[3]{1, 1, 1};
+    int64_t start[3]{};
+    int64_t skip[3]{};
+    int64_t conv_output_shape[3]{1, 1, 1};
+    bool is_empty{false};
+    bool is_direct{false};
+  };
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasIdentityActivation;
+
+  // Compute the output positions of each phase and the padding of its convolution.
+  InlinedVector<PhaseGeometry> geometries(phases.size());
+  size_t working_buffer_size = 0;
+  int64_t phase_output_size = 0;
+  for (size_t i = 0; i < phases.size(); i++) {
+    const auto& phase = phases[i];
+    auto& geometry = geometries[i];
+    int64_t padding[6]{};
+    int64_t ones[3]{1, 1, 1};
+    bool is_direct = true;
+    for (size_t d = 0; d < rank; d++) {
+      const int64_t stride = p.strides[d];
+      const int64_t pad = p.pads[d];
+      const int64_t r = phase.phase[d];
+      const int64_t last = output_shape[d] - 1 + pad;
+      const int64_t q_start = pad > r ? (pad - r + stride - 1) / stride : 0;
+      const int64_t q_end = last >= r ? (last - r) / stride + 1 : 0;
+      geometry.count[d] = q_end - q_start;
+      geometry.start[d] = q_start;
+      if (geometry.count[d] <= 0) {
+        geometry.count[d] = 0;
+        continue;
+      }
+      const int64_t kernel = phase.kernel_shape[d];
+      const int64_t pad_begin = std::max<int64_t>(kernel - 1 - q_start, 0);
+      geometry.skip[d] = std::max<int64_t>(q_start - (kernel - 1), 0);
+      const int64_t pad_end = std::max<int64_t>(geometry.skip[d] + geometry.count[d] - 1 + kernel -
+                                                    input_shape[d] - pad_begin,
+                                                0);
+      padding[d] = pad_begin;
+      padding[rank + d] = pad_end;
+      geometry.conv_output_shape[d] = input_shape[d] + pad_begin + pad_end - kernel + 1;
+      is_direct = is_direct && stride == 1 && q_start == pad && geometry.skip[d] == 0 &&
+                  geometry.conv_output_shape[d] == output_shape[d];
+    }
+
+    if (std::any_of(geometry.count, geometry.count + rank, [](int64_t count) { return count == 0; })) {
+      // No output position belongs to this phase.
+      geometry.count[0] = 0;
+      continue;
+    }
+    if (phase.kernel_size == 0) {
+      // The kernel is smaller than the stride, so only the bias is written to the outputs of this phase.
+      geometry.is_empty = true;
+      continue;
+    }
+
+    size_t phase_working_buffer_size;
+    MlasConvPrepare(&geometry.parameters,
+                    rank,
+                    1,
+                    onnxruntime::narrow<size_t>(group),
+                    onnxruntime::narrow<size_t>(p.num_input_channels / group),
+                    input_shape.data(),
+                    phase.kernel_shape,
+                    ones,
+                    padding,
+                    ones,
+                    geometry.conv_output_shape,
+                    onnxruntime::narrow<size_t>(M / group),
+                    &activation,
+                    &phase_working_buffer_size,
+                    0.0f,
+                    thread_pool);
+    working_buffer_size = std::max(working_buffer_size, phase_working_buffer_size);
+
+    geometry.is_direct = is_direct;
+    if (!is_direct) {
+      phase_output_size = std::max<int64_t>(
+          phase_output_size,
+          std::accumulate(geometry.conv_output_shape, geometry.conv_output_shape + rank, int64_t{1},
+                          std::multiplies<int64_t>()));
+    }
+  }
+
+  auto* working_data = working_buffer_size > 0
+                           ? alloc->Alloc(SafeInt<size_t>(sizeof(float)) * working_buffer_size)
+                           : nullptr;
+  BufferUniquePtr working_buffer(working_data, BufferDeleter(alloc));
+  auto* phase_output_data = phase_output_size > 0
+                                ? alloc->Alloc(SafeInt<size_t>(sizeof(float)) * M * phase_output_size)
+                                : nullptr;
+  BufferUniquePtr phase_output_buffer(phase_output_data, BufferDeleter(alloc));
+  float* phase_output = static_cast<float*>(phase_output_buffer.get());
+
+  const float* Bdata = p.B != nullptr ? p.B->Data<float>() : nullptr;
+  const float* Xdata = p.X->Data<float>();
+  float* Ydata = p.Y->MutableData<float>();
+
+  // The output spatial dimensions, padded to three dimensions.
+  int64_t output_dims[3]{1, 1, 1};
+  std::copy(output_shape.begin(), output_shape.end(), output_dims + (3 - rank));
+
+  // Outputs before a negative padding don't belong to any phase.
+  const bool has_negative_pads = std::any_of(p.pads.begin(), p.pads.begin() + rank,
+                                             [](int64_t pad) { return pad < 0; });
+
+  for (int64_t image_id = 0; image_id < p.N; ++image_id) {
+    if (has_negative_pads) {
+      for (int64_t m = 0; m < M; m++) {
+        std::fill_n(Ydata + m * output_image_size, output_image_size, Bdata != nullptr ? Bdata[m] : 0.0f);
+      }
+    }
+
+    for (size_t i = 0; i < phases.size(); i++) {
+      const auto& phase = phases[i];
+      const auto& geometry = geometries[i];
+      if (geometry.count[0] == 0) {
+        continue;
+      }
+
+      if (geometry.is_direct) {
+        MlasConv(&geometry.parameters, Xdata, phase_filters + phase.filter_offset, Bdata,
+                 static_cast<float*>(working_buffer.get()), Ydata, thread_pool);
+        continue;
+      }
+
+      if (!geometry.is_empty) {
+        MlasConv(&geometry.parameters, Xdata, phase_filters + phase.filter_offset, Bdata,
+                 static_cast<float*>(working_buffer.get()), phase_output, thread_pool);
+      }
+
+      // Write the outputs of the phase interleaved into the output, padding the geometry to three dimensions.
+      int64_t count[3]{1, 1, 1}, start[3]{}, skip[3]{}, stride[3]{1, 1, 1}, offset[3]{}, conv_dims[3]{1, 1, 1};
+      for (size_t d = 0; d < rank; d++) {
+        const size_t d3 = 3 - rank + d;
+        count[d3] = geometry.count[d];
+        start[d3] = geometry.start[d];
+        skip[d3] = geometry.skip[d];
+        stride[d3] = p.strides[d];
+        offset[d3] = phase.phase[d] - p.pads[d];
+        conv_dims[d3] = geometry.conv_output_shape[d];
+      }
+      const int64_t conv_output_size = conv_dims[0] * conv_dims[1] * conv_dims[2];
+
+      auto scatter_worker = [&](std::ptrdiff_t m) {
+        float* y = Ydata + m * output_image_size;
+        const float* src = phase_output + m * conv_output_size;
+        const float bias = Bdata != nullptr ? Bdata[m] : 0.0f;
+        for (int64_t t0 = 0; t0 < count[0]; t0++) {
+          const int64_t o0 = (start[0] + t0) * stride[0] + offset[0];
+          for (int64_t t1 = 0; t1 < count[1]; t1++) {
+            const int64_t o1 = (start[1] + t1) * stride[1] + offset[1];
+            float* y_row = y + (o0 * output_dims[1] + o1) * output_dims[2] + start[2] * stride[2] + offset[2];
+            if (geometry.is_empty) {
+              for (int64_t t2 = 0; t2 < count[2]; t2++) {
+                y_row[t2 * stride[2]] = bias;
+              }
+            } else {
+              const float* src_row = src + ((skip[0] + t0) * conv_dims[1] + skip[1] + t1) * conv_dims[2] + skip[2];
+              for (int64_t t2 = 0; t2 < count[2]; t2++) {
+                y_row[t2 * stride[2]] = src_row[t2];
+              }
+            }
+          }
+        }
+      };
+      concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, onnxruntime::narrow<std::ptrdiff_t>(M),
+                                                    scatter_worker);
+    }
+
+    Xdata += p.num_input_channels * input_image_size;
+    Ydata += M * output_image_size;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     ConvTranspose,
     1, 10,
@@ -36,6 +309,14 @@ ONNX_CPU_OPERATOR_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     ConvTranspose<float>);
 
+template <>
+bool ConvTranspose<float>::UseSubPixelConvolution(size_t kernel_rank) const {
+  // MlasConv handles 1D, 2D and 3D convolutions. The phases of a dilated kernel overlap, so those keep using Col2im.
+  const auto& dilations = conv_transpose_attrs_.dilations;
+  return kernel_rank >= 1 && kernel_rank <= 3 &&
+         std::all_of(dilations.begin(), dilations.end(), [](int64_t dilation) { return dilation == 1; });
+}
+
 template <typename T>
 Status ConvTranspose<T>::PrePack(const Tensor& /*tensor*/, int /*input_idx*/, AllocatorPtr /*alloc*/,
                                  /*out*/ bool& is_packed,
@@ -58,6 +339,38 @@ Status ConvTranspose<float>::PrePack(const Tensor& tensor, int input_idx, Alloca
     }
     filter_shape_ = tensor.Shape();
 
+    const size_t kernel_rank = filter_shape_.NumDimensions() - 2;
+    if (UseSubPixelConvolution(kernel_rank)) {
+      TensorShapeVector strides(conv_transpose_attrs_.strides);
+      if (strides.empty()) {
+        strides.resize(kernel_rank, 1);
+      }
+      const auto kernel_shape = filter_shape_.GetDims().subspan(2);
+      const int64_t group = conv_transpose_attrs_.group;
+      const int64_t input_channels = filter_shape_[0];
+      const int64_t group_output_channels = filter_shape_[1];
+
+      size_t phase_filters_size = 0;
+      const auto phases = GetConvTransposePhases(
+          kernel_shape, strides, onnxruntime::narrow<size_t>(group * group_output_channels),
+          onnxruntime::narrow<size_t>(input_channels / group), phase_filters_size);
+
+      size_t phase_filters_data_size = SafeInt<size_t>(phase_filters_size) * sizeof(float);
+      auto* phase_filters_data = static_cast<float*>(alloc->Alloc(phase_filters_data_size));
+      phase_filters_ = BufferUniquePtr(phase_filters_data, BufferDeleter(std::move(alloc)));
+
+      ReorderConvTransposePhaseFilters(tensor.Data<float>(), phase_filters_data, phases, kernel_shape, strides,
+                                       group, input_channels, group_output_channels);
+
+      if (prepacked_weights != nullptr) {
+        prepacked_weights->buffers_.push_back(std::move(phase_filters_));
+        prepacked_weights->buffer_sizes_.push_back(phase_filters_data_size);
+      }
+
+      is_packed = true;
+      return Status::OK();
+    }
+
     const size_t K = static_cast<size_t>(filter_shape_[0]) / onnxruntime::narrow<size_t>(conv_transpose_attrs_.group);
     const size_t N = onnxruntime::narrow<size_t>(filter_shape_.SizeFromDimension(1));
     auto packed_elements_per_group = N * K;
@@ -108,7 +421,11 @@ Status ConvTranspose<float>::UseSharedPrePackedBuffers(std::vector<BufferUniqueP
 
   if (input_idx == 1) {
     used_shared_buffers = true;
-    transposed_filter_ = std::move(prepacked_buffers[0]);
+    if (UseSubPixelConvolution(filter_shape_.NumDimensions() - 2)) {
+      phase_filters_ = std::move(prepacked_buffers[0]);
+    } else {
+      transposed_filter_ = std::move(prepacked_buffers[0]);
+    }
   }
 
   return Status::OK();
@@ -226,13 +543,38 @@ Status ConvTranspose<float>::DoConvTranspose(OpKernelContext* context, bool dyna
   ConvTransposeAttributes::Prepare p;
   bool has_bias = dynamic_padding ? num_inputs == 4 : num_inputs == 3;
   ORT_RETURN_IF_ERROR(conv_transpose_attrs_.PrepareForCompute(
-      context, has_bias, p, dynamic_padding, transposed_filter_ ? &filter_shape_ : nullptr));
+      context, has_bias, p, dynamic_padding,
+      (transposed_filter_ || phase_filters_) ? &filter_shape_ : nullptr));
 
   // Bail out early if one of the dimensions is zero.
   if (p.Y->Shape().Size() == 0) {
     return Status::OK();
   }
 
+  if (UseSubPixelConvolution(p.kernel_shape.size())) {
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+    const int64_t group = conv_transpose_attrs_.group;
+    const int64_t group_output_channels = p.num_output_channels / group;
+    size_t phase_filters_size = 0;
+    const auto phases = GetConvTransposePhases(
+        p.kernel_shape, p.strides, onnxruntime::narrow<size_t>(p.num_output_channels),
+        onnxruntime::narrow<size_t>(p.num_input_channels / group), phase_filters_size);
+
+    // Reorder the filter here if it is not a constant.
+    IAllocatorUniquePtr<float> phase_filters_buffer;
+    const float* phase_filters = static_cast<const float*>(phase_filters_.get());
+    if (phase_filters == nullptr) {
+      phase_filters_buffer = IAllocator::MakeUniquePtr<float>(alloc, phase_filters_size);
+      ReorderConvTransposePhaseFilters(p.F->Data<float>(), phase_filters_buffer.get(), phases, p.kernel_shape,
+                                       p.strides, group, p.num_input_channels, group_output_channels);
+      phase_filters = phase_filters_buffer.get();
+    }
+
+    return SubPixelConvTranspose(p, group, phase_filters, phases, std::move(alloc), thread_pool);
+  }
+
   const int64_t input_image_size = p.input_shape.Size();
   const int64_t X_offset = p.num_input_channels / conv_transpose_attrs_.group * input_image_size;
   const int64_t Y_offset = p.Y->Shape().Size() / p.Y->Shape()[0] / conv_transpose_attrs_.group;
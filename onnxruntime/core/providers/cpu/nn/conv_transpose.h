@@ -41,11 +41,15 @@ class ConvTranspose : public OpKernel {
   Status DoConvTranspose(OpKernelContext* context, bool dynamic_padding) const;
 
  private:
+  // Whether the float ConvTranspose is computed as stride-decomposed convolutions instead of GEMM and Col2im.
+  bool UseSubPixelConvolution(size_t kernel_rank) const;
+
   ConvTransposeAttributes conv_transpose_attrs_;
 
   // for pre-packing usage
   TensorShape filter_shape_;
   BufferUniquePtr transposed_filter_;
+  BufferUniquePtr phase_filters_;
 };
 
 }  // namespace onnxruntime
@@ -3,11 +3,13 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "core/common/narrow.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/philox_engine.h"
 #include "core/framework/random_generator.h"
-#include <chrono>
-#include <random>
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -18,14 +20,14 @@ class Dropout final : public OpKernel {
   Dropout(const OpKernelInfo& info) : OpKernel{info} {
     int64_t seed = 0;
     if (info.GetAttr<int64_t>("seed", &seed).IsOK()) {
-      generator_ = std::make_unique<RandomGenerator>(seed);
+      generator_ = std::make_unique<PhiloxGenerator>(static_cast<uint64_t>(seed));
     }
   }
 
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  mutable std::unique_ptr<RandomGenerator> generator_;
+  mutable std::unique_ptr<PhiloxGenerator> generator_;
 };
 
 namespace {
@@ -78,21 +80,34 @@ Status Dropout<T1, T2>::Compute(OpKernelContext* context) const {
 
   } else {
     // drop some
-    ConstEigenVectorArrayMap<T1> X_arr(X_span.data(), X_span.size());
-    EigenVectorArrayMap<T1> Y_arr(Y_span.data(), Y_span.size());
-    EigenVectorArrayMap<bool> mask_arr(mask_span.data(), mask_span.size());
-
-    // generate mask
-    {
-      RandomGenerator& generator = generator_ != nullptr ? *generator_.get() : RandomGenerator::Default();
-      std::default_random_engine rng(gsl::narrow_cast<std::default_random_engine::result_type>(generator.NextSeed()));
-      std::uniform_real_distribution<float> dist{0.0f, 1.0f};
-      mask_arr = Eigen::ArrayX<bool>::NullaryExpr(
-          mask_arr.size(),
-          [ratio_value, &dist, &rng]() { return dist(rng) >= ratio_value; });
-    }
-
-    Y_arr = mask_arr.cast<T1>() * X_arr / (1.0f - ratio_value);
+    // The mask comes from the Philox stream of the generator, so that the elements are split between the threads
+    // and each of them generates its part of the stream independently of the others.
+    PhiloxGenerator& generator = generator_ != nullptr ? *generator_.get() : PhiloxGenerator::Default();
+    const size_t count = X_span.size();
+    const auto seeds = generator.NextPhiloxSeeds(philox::BlockCount<float>(count));
+    const T1 scale = static_cast<T1>(1.0f / (1.0f - ratio_value));
+
+    const T1* X_data = X_span.data();
+    T1* Y_data = Y_span.data();
+    bool* mask_data = mask_span.data();
+
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(count),
+        TensorOpCost{static_cast<double>(sizeof(T1)), static_cast<double>(sizeof(T1) + sizeof(bool)), 16},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          float uniform[philox::kChunkSize];
+          for (std::ptrdiff_t begin = first; begin < last;) {
+            const size_t n = std::min(static_cast<size_t>(last - begin), philox::kChunkSize);
+            philox::GenerateUniform<float>(seeds.first, seeds.second, static_cast<uint64_t>(begin), n,
+                                           0.0f, 1.0f, uniform);
+            for (size_t i = 0; i < n; i++) {
+              const bool keep = uniform[i] >= ratio_value;
+              mask_data[begin + i] = keep;
+              Y_data[begin + i] = keep ? X_data[begin + i] * scale : T1{0};
+            }
+            begin += static_cast<std::ptrdiff_t>(n);
+          }
+        });
   }
 
   return Status::OK();
@@ -9,6 +9,7 @@ namespace onnxruntime {
 #define REGISTER_ONNX_KERNEL_TYPED(T)                                                            \
   ONNX_CPU_OPERATOR_TYPED_KERNEL(LayerNormalization, 17, T,                                      \
                                  KernelDefBuilder()                                              \
+                                     .MayInplace(0, 0)                                           \
                                      .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())      \
                                      .TypeConstraint("U", DataTypeImpl::GetTensorType<float>()), \
                                  LayerNorm);
@@ -15,27 +15,19 @@ namespace onnxruntime {
 
 namespace {
 
-template <typename T,
-          typename U,
-          typename = std::enable_if_t<std::is_same_v<T, float> || std::is_same_v<T, double>, void>>
+// Used for double, for which there is no MLAS kernel.
+template <typename T, typename U>
 void ComputeJob(
     const T* X_data,
     const T* scale_data,
     const T* bias_data,
     const ptrdiff_t task_idx,
     const int64_t norm_size,
-    const float* scale_float_ptr,
-    const float* bias_float_ptr,
     float epsilon,
     bool simplified,
     T* Y_data,
     U* mean_data,
-    U* inv_std_dev_data,
-    AllocatorPtr alloc) {
-  ORT_UNUSED_PARAMETER(scale_float_ptr);  // only used in MLFloat16 overload
-  ORT_UNUSED_PARAMETER(bias_float_ptr);   // only used in MLFloat16 overload
-  ORT_UNUSED_PARAMETER(alloc);
-
+    U* inv_std_dev_data) {
   const T* p_input = X_data + task_idx * norm_size;
   T* p_output = Y_data + task_idx * norm_size;
 
@@ -75,73 +67,6 @@ void ComputeJob(
   }
 }
 
-template <typename U>
-void ComputeJob(
-    const MLFloat16* X_data,
-    const MLFloat16* scale_data,
-    const MLFloat16* bias_data,
-    const ptrdiff_t task_idx,
-    const int64_t norm_size,
-    const float* scale_float_ptr,
-    const float* bias_float_ptr,
-    float epsilon,
-    bool simplified,
-    MLFloat16* Y_data,
-    U* mean_data,
-    U* inv_std_dev_data,
-    AllocatorPtr alloc) {
-  ORT_UNUSED_PARAMETER(scale_data);  // only used in float/double overload
-  ORT_UNUSED_PARAMETER(bias_data);   // only used in float/double overload
-
-  const MLFloat16* p_input = X_data + task_idx * norm_size;
-  MLFloat16* p_output = Y_data + task_idx * norm_size;
-
-  float mean(0.0f);
-  float mean_square(0.0f);
-
-  const size_t num_elems = static_cast<size_t>(norm_size);
-  IAllocatorUniquePtr<float> input_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-  MlasConvertHalfToFloatBuffer(p_input, input_float_uptr.get(), num_elems);
-
-  IAllocatorUniquePtr<float> output_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-  float* output_float_ptr = output_float_uptr.get();
-
-  const float* input_float_ptr = input_float_uptr.get();
-  for (size_t h = 0; h < num_elems; h++) {
-    output_float_ptr[h] = input_float_ptr[h];
-    mean += input_float_ptr[h];
-    mean_square += input_float_ptr[h] * input_float_ptr[h];
-  }
-
-  mean = mean / norm_size;
-  if (simplified) {
-    mean_square = sqrt(mean_square / norm_size + epsilon);
-  } else {
-    mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
-  }
-
-  for (size_t h = 0; h < num_elems; h++) {
-    if (simplified) {
-      output_float_ptr[h] = output_float_ptr[h] / mean_square * scale_float_ptr[h];
-    } else if (nullptr == bias_float_ptr) {
-      output_float_ptr[h] = (output_float_ptr[h] - mean) / mean_square * scale_float_ptr[h];
-    } else {
-      output_float_ptr[h] = (output_float_ptr[h] - mean) / mean_square * scale_float_ptr[h] + bias_float_ptr[h];
-    }
-  }
-
-  MlasConvertFloatToHalfBuffer(output_float_ptr, p_output, num_elems);
-
-  if (mean_data != nullptr) {
-    // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
-    mean_data[task_idx] = MLFloat16(mean);
-  }
-
-  if (inv_std_dev_data != nullptr) {
-    inv_std_dev_data[task_idx] = MLFloat16(1 / mean_square);
-  }
-}
-
 void ConvertMLFloat16ToFloatIfNeeded(const Tensor& tensor, AllocatorPtr alloc, IAllocatorUniquePtr<float>& dest, bool& is_packed) {
   if (tensor.GetElementType() == utils::ToTensorProtoElementType<MLFloat16>()) {
     auto tensor_data_ptr = tensor.Data<MLFloat16>();
@@ -270,30 +195,84 @@ Status LayerNormImpl::ComputeWithoutContext(
                            scale_size, " and bias size of ", bias_size);
   }
 
-  IAllocatorUniquePtr<float> scale_fp32;
-  IAllocatorUniquePtr<float> bias_fp32;
-  if constexpr (std::is_same_v<T, MLFloat16>) {
-    if (prepacked_scale_fp32_data_ == nullptr) {
+  if constexpr (std::is_same_v<T, double>) {
+    ORT_UNUSED_PARAMETER(alloc);
+
+    concurrency::ThreadPool::TryBatchParallelFor(
+        thread_pool, static_cast<int32_t>(norm_count),
+        [&](ptrdiff_t task_idx) {
+          ComputeJob(X_data, scale_data, bias_data, task_idx, norm_size, epsilon, simplified,
+                     Y_data, mean_data, inv_std_dev_data);
+        },
+        0);
+  } else {
+    const float* scale_float_ptr = nullptr;
+    const float* bias_float_ptr = nullptr;
+    IAllocatorUniquePtr<float> scale_fp32;
+    IAllocatorUniquePtr<float> bias_fp32;
+    if constexpr (std::is_same_v<T, MLFloat16>) {
       const size_t num_elems = static_cast<size_t>(norm_size);
-      scale_fp32 = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-      MlasConvertHalfToFloatBuffer(scale_data, scale_fp32.get(), num_elems);
+      if (prepacked_scale_fp32_data_ == nullptr) {
+        scale_fp32 = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
+        MlasConvertHalfToFloatBuffer(scale_data, scale_fp32.get(), num_elems);
+        scale_float_ptr = scale_fp32.get();
+      } else {
+        scale_float_ptr = prepacked_scale_fp32_data_.get();
+      }
+      if (prepacked_bias_fp32_data_ == nullptr && bias_data) {
+        bias_fp32 = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
+        MlasConvertHalfToFloatBuffer(bias_data, bias_fp32.get(), num_elems);
+        bias_float_ptr = bias_fp32.get();
+      } else {
+        bias_float_ptr = prepacked_bias_fp32_data_.get();
+      }
+    } else {
+      scale_float_ptr = scale_data;
+      bias_float_ptr = bias_data;
     }
-    if (prepacked_bias_fp32_data_ == nullptr && bias_data) {
-      const size_t num_elems = static_cast<size_t>(norm_size);
-      bias_fp32 = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-      MlasConvertHalfToFloatBuffer(bias_data, bias_fp32.get(), num_elems);
+
+    if (simplified) {
+      bias_float_ptr = nullptr;
+    }
+
+    // The MLAS kernels output the mean and inverse standard deviation as float.
+    const size_t count = static_cast<size_t>(norm_count);
+    IAllocatorUniquePtr<float> mean_fp32;
+    IAllocatorUniquePtr<float> inv_std_dev_fp32;
+    float* mean_float_ptr = nullptr;
+    float* inv_std_dev_float_ptr = nullptr;
+    if constexpr (std::is_same_v<U, float>) {
+      mean_float_ptr = mean_data;
+      inv_std_dev_float_ptr = inv_std_dev_data;
+    } else {
+      if (mean_data != nullptr) {
+        mean_fp32 = IAllocator::MakeUniquePtr<float>(alloc, count);
+        mean_float_ptr = mean_fp32.get();
+      }
+      if (inv_std_dev_data != nullptr) {
+        inv_std_dev_fp32 = IAllocator::MakeUniquePtr<float>(alloc, count);
+        inv_std_dev_float_ptr = inv_std_dev_fp32.get();
+      }
     }
-  }
 
-  concurrency::ThreadPool::TryBatchParallelFor(
-      thread_pool, static_cast<int32_t>(norm_count),
-      [&](ptrdiff_t task_idx) {
-        ComputeJob(X_data, scale_data, bias_data, task_idx, norm_size,
-                   prepacked_scale_fp32_data_ ? prepacked_scale_fp32_data_.get() : scale_fp32.get(),
-                   prepacked_bias_fp32_data_ ? prepacked_bias_fp32_data_.get() : bias_fp32.get(),
-                   epsilon, simplified, Y_data, mean_data, inv_std_dev_data, alloc);
-      },
-      0);
+    const size_t norm_elems = static_cast<size_t>(norm_size);
+    if (simplified) {
+      // there is no mean output for the simplified variant
+      MlasRmsNorm(X_data, scale_float_ptr, Y_data, inv_std_dev_float_ptr, count, norm_elems, epsilon, thread_pool);
+    } else {
+      MlasLayerNormalization(X_data, scale_float_ptr, bias_float_ptr, Y_data, mean_float_ptr, inv_std_dev_float_ptr,
+                             count, norm_elems, epsilon, thread_pool);
+    }
+
+    if constexpr (!std::is_same_v<U, float>) {
+      if (mean_data != nullptr) {
+        MlasConvertFloatToHalfBuffer(mean_float_ptr, mean_data, count);
+      }
+      if (inv_std_dev_data != nullptr) {
+        MlasConvertFloatToHalfBuffer(inv_std_dev_float_ptr, inv_std_dev_data, count);
+      }
+    }
+  }
 
   return Status::OK();
 }
@@ -3,6 +3,7 @@
 
 #include "tfidfvectorizer.h"
 #include "core/common/common.h"
+#include "core/common/hash_combine.h"
 #include "core/common/inlined_containers.h"
 #include <core/common/safeint.h>
 #include "core/framework/tensor.h"
@@ -10,6 +11,7 @@
 
 #include <functional>
 #include <string_view>
+#include <type_traits>
 
 namespace onnxruntime {
 
@@ -25,66 +27,80 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 namespace ngram_details {
 
-// NgrampPart implements a Trie like structure
-// for a unigram (1) it would insert into a root map with a valid id.
+// NgramTrie holds the n-grams of the pool in a trie whose nodes are numbered, the root is node 0.
+// for a unigram (1) the root would have a child with a valid id.
 // for (1,2,3) node 2 would be a child of 1 but have id == 0
 // because (1,2) does not exists. Node 3 would have a valid id.
+// All the edges of the trie are held in a single flat hash map keyed on the parent node and the token,
+// so a lookup is one probe instead of a walk through a map per node.
 template <class T>
-struct NgramPart;
+class NgramTrie {
+ public:
+  // string tokens refer to the pool_strings attribute
+  using Token = std::conditional_t<std::is_same_v<T, std::string>, std::string_view, int64_t>;
+  static constexpr size_t kRoot = 0;
 
-template <>
-struct NgramPart<int64_t>;
+  NgramTrie() : ngram_ids_(1, 0) {}
 
-template <>
-struct NgramPart<std::string>;
+  bool Empty() const { return edges_.empty(); }
 
-using NgramPartInt = NgramPart<int64_t>;
-using NgramPartString = NgramPart<std::string>;
+  // Returns the child of node for token, kRoot if there is none.
+  size_t Find(size_t node, Token token) const {
+    auto hit = edges_.find(Edge{node, token});
+    return hit == edges_.end() ? kRoot : hit->second;
+  }
+
+  // Returns the child of node for token, adding it if it doesn't exist.
+  size_t Insert(size_t node, Token token) {
+    auto p = edges_.emplace(Edge{node, token}, ngram_ids_.size());
+    if (p.second) {
+      ngram_ids_.push_back(0);
+    }
+    return p.first->second;
+  }
 
-// Avoid recursive class definitions using unique_ptr + forward declaration
-using IntMap = InlinedHashMap<int64_t, std::unique_ptr<NgramPartInt>>;
+  // 0 - means no entry, search for a bigger N
+  size_t NgramId(size_t node) const { return ngram_ids_[node]; }
+  void SetNgramId(size_t node, size_t ngram_id) { ngram_ids_[node] = ngram_id; }
+
+ private:
+  struct Edge {
+    size_t parent;
+    Token token;
+    bool operator==(const Edge& other) const { return parent == other.parent && token == other.token; }
+  };
+
+  struct EdgeHash {
+    size_t operator()(const Edge& edge) const {
+      size_t seed = std::hash<Token>{}(edge.token);
+      HashCombine(edge.parent, seed);
+      return seed;
+    }
+  };
 
 #ifndef DISABLE_ABSEIL
-using StrMap = absl::flat_hash_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                   std::hash<std::string>, std::equal_to<std::string>>;
+  absl::flat_hash_map<Edge, size_t, EdgeHash> edges_;
 #else
-using StrMap = std::unordered_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                  std::hash<std::string>, std::equal_to<std::string>>;
+  std::unordered_map<Edge, size_t, EdgeHash> edges_;
 #endif
-
-template <>
-struct NgramPart<int64_t> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  IntMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
+  InlinedVector<size_t> ngram_ids_;
 };
 
-template <>
-struct NgramPart<std::string> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  StrMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
+using NgramTrieInt = NgramTrie<int64_t>;
+using NgramTrieString = NgramTrie<std::string>;
 
 // Returns next ngram_id
-template <class K, class ForwardIter, class Map>
+template <class K, class ForwardIter>
 inline size_t PopulateGrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t ngram_id,
-                            Map& c) {
+                            NgramTrie<K>& trie) {
   for (; ngrams > 0; --ngrams) {
-    size_t n = 1;
-    Map* m = &c;
-    while (true) {
-      auto p = m->emplace(*first, std::make_unique<NgramPart<K>>(0));
-      ++first;
-      if (n == ngram_size) {
-        ORT_ENFORCE(p.first->second->id_ == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
-        p.first->second->id_ = ngram_id;
-        ++ngram_id;
-        break;
-      }
-      ++n;
-      m = &p.first->second->leafs_;
+    size_t node = NgramTrie<K>::kRoot;
+    for (size_t n = 0; n < ngram_size; ++n, ++first) {
+      node = trie.Insert(node, static_cast<const K&>(*first));
     }
+    ORT_ENFORCE(trie.NgramId(node) == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
+    trie.SetNgramId(node, ngram_id);
+    ++ngram_id;
   }
   return ngram_id;
 }
@@ -134,11 +150,11 @@ struct TfIdfVectorizer::Impl {
   gsl::span<const int64_t> ngram_indexes_;
   gsl::span<const float> weights_;
 
-  // This map contains references to pool_string_ entries
+  // This trie contains references to pool_string_ entries
   // of pool_strings attribute
-  StrMap str_map_;
-  // This map contains pool_int64s entries
-  IntMap int64_map_;
+  NgramTrieString str_trie_;
+  // This trie contains pool_int64s entries
+  NgramTrieInt int64_trie_;
 
   size_t output_size_ = 0;
 
@@ -241,9 +257,9 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
         if (pool_strings.empty()) {
-          ngram_id = PopulateGrams<int64_t>(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_map_);
+          ngram_id = PopulateGrams<int64_t>(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_trie_);
         } else {
-          ngram_id = PopulateGrams<std::string>(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_map_);
+          ngram_id = PopulateGrams<std::string>(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_trie_);
         }
       } else {
         ngram_id += ngrams;
@@ -281,39 +297,37 @@ void TfIdfVectorizer::ComputeImpl(const void* x_data_raw, size_t elem_size, ptrd
       auto ngram_item = ngram_start;
       if (is_input_string) {
         const std::string* str_item = reinterpret_cast<const std::string*>(ngram_item);
-        const StrMap* str_map = &impl.str_map_;
+        const auto& str_trie = impl.str_trie_;
+        size_t node = NgramTrieString::kRoot;
         for (auto ngram_size = 1;
-             !str_map->empty() &&
              ngram_size <= max_gram_length &&
              str_item < ngram_row_end;
              ++ngram_size, str_item += skip_distance) {
-          auto hit = str_map->find(*str_item);
-          if (hit == str_map->end()) {
+          node = str_trie.Find(node, *str_item);
+          if (node == NgramTrieString::kRoot) {
             break;
           }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            output_idx = impl.OutputIdToIncrement(hit->second->id_);
+          if (ngram_size >= start_ngram_size && str_trie.NgramId(node) != 0) {
+            output_idx = impl.OutputIdToIncrement(str_trie.NgramId(node));
             fn_weight(output_idx, output_data);
           }
-          str_map = &hit->second->leafs_;
         }
       } else {
-        const IntMap* int_map = &impl.int64_map_;
+        const auto& int_trie = impl.int64_trie_;
+        size_t node = NgramTrieInt::kRoot;
         for (auto ngram_size = 1;
-             !int_map->empty() &&
              ngram_size <= max_gram_length &&
              ngram_item < ngram_row_end;
              ++ngram_size, ngram_item = AdvanceElementPtr(ngram_item, skip_distance, elem_size)) {
           int64_t val = (elem_size == 4) ? int64_t{*reinterpret_cast<const int32_t*>(ngram_item)} : *reinterpret_cast<const int64_t*>(ngram_item);
-          auto hit = int_map->find(val);
-          if (hit == int_map->end()) {
+          node = int_trie.Find(node, val);
+          if (node == NgramTrieInt::kRoot) {
             break;
           }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            output_idx = impl.OutputIdToIncrement(hit->second->id_);
+          if (ngram_size >= start_ngram_size && int_trie.NgramId(node) != 0) {
+            output_idx = impl.OutputIdToIncrement(int_trie.NgramId(node));
             fn_weight(output_idx, output_data);
           }
-          int_map = &hit->second->leafs_;
         }
       }
       // Sliding window shift
@@ -373,8 +387,8 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   const bool is_input_string = X->IsDataTypeString();
 
   if (total_items == 0 ||
-      (is_input_string && impl_->str_map_.empty()) ||
-      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_map_.empty())) {
+      (is_input_string && impl_->str_trie_.Empty()) ||
+      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_trie_.Empty())) {
     // TfidfVectorizer may receive an empty input when it follows a Tokenizer
     // (for example for a string containing only stopwords).
     // TfidfVectorizer returns a zero tensor of shape
@@ -13,10 +13,13 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 
-#include <queue>
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/platform/threadpool.h"
 #include "non_max_suppression_helper.h"
 
 // TODO:fix the warnings
@@ -43,6 +46,72 @@ ONNX_OPERATOR_KERNEL_EX(
 
 using namespace nms_helpers;
 
+namespace {
+
+// Corners and area of a box. They are computed once per batch, instead of for every pair of boxes that is compared
+// in every class.
+struct BoxCorners {
+  float x_min;
+  float y_min;
+  float x_max;
+  float y_max;
+  float area;
+};
+
+void ComputeBoxCorners(const float* boxes_data, int64_t num_boxes, int64_t center_point_box, BoxCorners* corners) {
+  for (int64_t box_index = 0; box_index < num_boxes; ++box_index) {
+    const float* box = boxes_data + 4 * box_index;
+    BoxCorners& box_corners = corners[box_index];
+    // center_point_box_ only support 0 or 1
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2],
+      MaxMin(box[1], box[3], box_corners.x_min, box_corners.x_max);
+      MaxMin(box[0], box[2], box_corners.y_min, box_corners.y_max);
+    } else {
+      // 1 == center_point_box_ => boxes data format [x_center, y_center, width, height]
+      float box_width_half = box[2] / 2;
+      float box_height_half = box[3] / 2;
+      box_corners.x_min = box[0] - box_width_half;
+      box_corners.x_max = box[0] + box_width_half;
+      box_corners.y_min = box[1] - box_height_half;
+      box_corners.y_max = box[1] + box_height_half;
+    }
+    box_corners.area = (box_corners.x_max - box_corners.x_min) * (box_corners.y_max - box_corners.y_min);
+  }
+}
+
+// Same as nms_helpers::SuppressByIOU, from precomputed corners.
+inline bool SuppressByIOU(const BoxCorners& box1, const BoxCorners& box2, float iou_threshold) {
+  const float intersection_x_min = std::max(box1.x_min, box2.x_min);
+  const float intersection_x_max = std::min(box1.x_max, box2.x_max);
+  if (intersection_x_max <= intersection_x_min)
+    return false;
+
+  const float intersection_y_min = std::max(box1.y_min, box2.y_min);
+  const float intersection_y_max = std::min(box1.y_max, box2.y_max);
+  if (intersection_y_max <= intersection_y_min)
+    return false;
+
+  const float intersection_area = (intersection_x_max - intersection_x_min) *
+                                  (intersection_y_max - intersection_y_min);
+
+  if (intersection_area <= .0f) {
+    return false;
+  }
+
+  const float union_area = box1.area + box2.area - intersection_area;
+
+  if (box1.area <= .0f || box2.area <= .0f || union_area <= .0f) {
+    return false;
+  }
+
+  const float intersection_over_union = intersection_area / union_area;
+
+  return intersection_over_union > iou_threshold;
+}
+
+}  // namespace
+
 // This works for both CPU and GPU.
 // CUDA kernel declare OrtMemTypeCPUInput for max_output_boxes_per_class(2), iou_threshold(3) and score_threshold(4)
 Status NonMaxSuppressionBase::PrepareCompute(OpKernelContext* ctx, PrepareContext& pc) {
@@ -148,55 +217,85 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   };
 
   const auto center_point_box = GetCenterPointBox();
+  const int64_t num_boxes = pc.num_boxes_;
 
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfoPtr> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), pc.num_boxes_));
-
+  std::vector<BoxCorners> box_corners(SafeInt<size_t>(pc.num_batches_) * num_boxes);
   for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfoPtr> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
-
-      // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            candidate_boxes.emplace_back(*class_scores, box_index);
-          }
-        }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          candidate_boxes.emplace_back(*class_scores, box_index);
-        }
-      }
-      std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(), std::move(candidate_boxes));
-
-      selected_boxes_inside_class.clear();
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfoPtr& next_top_score = sorted_boxes.top();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (SuppressByIOU(batch_boxes, next_top_score.index_, selected_index.index_, center_point_box, iou_threshold)) {
-            selected = false;
-            break;
+    ComputeBoxCorners(boxes_data + batch_index * num_boxes * 4, num_boxes, center_point_box,
+                      box_corners.data() + batch_index * num_boxes);
+  }
+
+  // The classes of all the batches are independent, so they are processed in parallel. The boxes selected in each
+  // class are gathered in order afterwards.
+  const int64_t num_classes_total = pc.num_batches_ * pc.num_classes_;
+  std::vector<std::vector<int64_t>> selected_boxes_of_class(narrow<size_t>(num_classes_total));
+  const size_t max_selected_boxes = std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), narrow<size_t>(num_boxes));
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), narrow<std::ptrdiff_t>(num_classes_total),
+      static_cast<double>(num_boxes) * 16.0,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<BoxInfoPtr> candidate_boxes;
+        candidate_boxes.reserve(narrow<size_t>(num_boxes));
+        std::vector<BoxCorners> selected_box_corners;
+        selected_box_corners.reserve(max_selected_boxes);
+
+        for (std::ptrdiff_t task = first; task < last; ++task) {
+          const int64_t batch_index = task / pc.num_classes_;
+          const int64_t box_score_offset = task * num_boxes;
+          const BoxCorners* batch_box_corners = box_corners.data() + batch_index * num_boxes;
+          auto& selected_boxes = selected_boxes_of_class[task];
+
+          // Filter by score_threshold_
+          candidate_boxes.clear();
+          const auto* class_scores = scores_data + box_score_offset;
+          if (pc.score_threshold_ != nullptr) {
+            for (int64_t box_index = 0; box_index < num_boxes; ++box_index, ++class_scores) {
+              if (*class_scores > score_threshold) {
+                candidate_boxes.emplace_back(*class_scores, box_index);
+              }
+            }
+          } else {
+            for (int64_t box_index = 0; box_index < num_boxes; ++box_index, ++class_scores) {
+              candidate_boxes.emplace_back(*class_scores, box_index);
+            }
           }
-        }
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+          // A heap only orders the boxes that are visited, which stops early once max_output_boxes_per_class boxes
+          // are selected.
+          std::make_heap(candidate_boxes.begin(), candidate_boxes.end());
+
+          selected_box_corners.clear();
+          // Get the next box with top score, filter by iou_threshold
+          while (!candidate_boxes.empty() && selected_box_corners.size() < max_selected_boxes) {
+            std::pop_heap(candidate_boxes.begin(), candidate_boxes.end());
+            const BoxInfoPtr next_top_score = candidate_boxes.back();
+            candidate_boxes.pop_back();
+            const BoxCorners& next_box_corners = batch_box_corners[next_top_score.index_];
+
+            bool selected = true;
+            // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
+            for (const auto& selected_corners : selected_box_corners) {
+              if (SuppressByIOU(next_box_corners, selected_corners, iou_threshold)) {
+                selected = false;
+                break;
+              }
+            }
+
+            if (selected) {
+              selected_box_corners.push_back(next_box_corners);
+              selected_boxes.push_back(next_top_score.index_);
+            }
+          }  // while
         }
-        sorted_boxes.pop();
-      }  // while
-    }  // for class_index
-  }  // for batch_index
+      });
+
+  std::vector<SelectedIndex> selected_indices;
+  for (int64_t task = 0; task < num_classes_total; ++task) {
+    for (int64_t box_index : selected_boxes_of_class[narrow<size_t>(task)]) {
+      selected_indices.emplace_back(task / pc.num_classes_, task % pc.num_classes_, box_index);
+    }
+  }
 
   constexpr auto last_dim = 3;
   const auto num_selected = selected_indices.size();
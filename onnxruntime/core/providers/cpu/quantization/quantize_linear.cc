@@ -433,8 +433,15 @@ struct DequantizeLinearApply<T, OutT, true> {
       for (size_t m = 0; m < M; m++) {                                                          \
         for (size_t bd = 0; bd < K; bd++) {                                                     \
           auto sc = scale[bd];                                                                  \
-          for (size_t bs = 0; bs < N; bs++, input++) {                                          \
-            *output++ = static_cast<OutT>(input->ToFloat() * sc);                               \
+          if constexpr (std::is_same_v<OutT, float>) {                                          \
+            MlasConvertFloat8ToFloatBuffer(reinterpret_cast<const uint8_t*>(input), output, N,  \
+                                           GetMlasFloat8Type<T>(), sc);                         \
+            input += N;                                                                         \
+            output += N;                                                                        \
+          } else {                                                                              \
+            for (size_t bs = 0; bs < N; bs++, input++) {                                        \
+              *output++ = static_cast<OutT>(input->ToFloat() * sc);                             \
+            }                                                                                   \
           }                                                                                     \
         }                                                                                       \
       }                                                                                         \
@@ -492,6 +499,15 @@ Status DequantizeLinear<T>::Compute(OpKernelContext* ctx) const {
                                 [](T zp) { return zp == T{0}; }),
                 "DequantizeLinear with type int32 or float8 should have no zero point or all zero points should be 0");
   }
+
+  // a single float scale is a table lookup per element, which is split across the thread pool
+  if constexpr (boost::mp11::mp_contains<element_type_lists::AllFloat8, T>::value) {
+    if (x_scale.GetElementType() == ONNX_NAMESPACE::TensorProto::FLOAT && block_size_ == 0 && broadcast_dim == 1) {
+      ParDequantizeLinear(x.Data<T>(), y.MutableData<float>(), static_cast<size_t>(x_shape.Size()),
+                          *x_scale.Data<float>(), ctx->GetOperatorThreadPool());
+      return Status::OK();
+    }
+  }
 #endif
 
   const auto to = x_scale.GetElementType();
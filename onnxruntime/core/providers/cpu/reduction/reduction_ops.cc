@@ -493,6 +493,56 @@ struct ParallelizedData {
   typename AGG::value_type* to_data;
 };
 
+// When the innermost axis is not reduced, consecutive outputs read consecutive inputs. Instead of walking
+// the whole reduced space with a stride for every output, the outputs are accumulated by blocks so that every
+// step of the reduction reads a contiguous piece of the input. Every accumulator still sees its elements in
+// the same order as in the loops below.
+template <typename AGG, bool two_loops>
+void NoTransposeReduceByBlocks(const ParallelizedData<AGG>& data, std::ptrdiff_t first, std::ptrdiff_t end) {
+  constexpr int64_t kBlockSize = 256;
+  const ResultsNoTransposePrepareForReduce& last_results = *data.last_results;
+  std::vector<AGG> accumulators;
+  accumulators.reserve(onnxruntime::narrow<size_t>(std::min(kBlockSize, last_results.last_loop_size)));
+
+  for (int64_t current = first; current < end;) {
+    const int64_t main_index = current / last_results.last_loop_size;
+    const int64_t loop = current % last_results.last_loop_size;
+    const int64_t block = std::min({kBlockSize, end - current, last_results.last_loop_size - loop});
+    const typename AGG::input_type* origin =
+        data.from_data + last_results.unprojected_index[onnxruntime::narrow<size_t>(main_index)] + loop;
+
+    accumulators.clear();
+    for (int64_t i = 0; i < block; ++i) {
+      accumulators.emplace_back(data.denominator, origin[last_results.projected_index[0] + i]);
+    }
+
+    if constexpr (two_loops) {
+      for (auto it = last_results.projected_index.begin(); it != last_results.projected_index.end(); ++it) {
+        for (int64_t red = 0; red < data.loop_size; red += last_results.last_loop_red_inc) {
+          const typename AGG::input_type* row = origin + *it + red;
+          for (int64_t i = 0; i < block; ++i) {
+            accumulators[i].update0(row[i]);
+          }
+        }
+      }
+    }
+
+    for (auto it = last_results.projected_index.begin(); it != last_results.projected_index.end(); ++it) {
+      for (int64_t red = 0; red < data.loop_size; red += last_results.last_loop_red_inc) {
+        const typename AGG::input_type* row = origin + *it + red;
+        for (int64_t i = 0; i < block; ++i) {
+          accumulators[i].update(row[i]);
+        }
+      }
+    }
+
+    for (int64_t i = 0; i < block; ++i) {
+      data.to_data[current + i] = accumulators[i].get_value();
+    }
+    current += block;
+  }
+}
+
 template <typename AGG>
 void NoTransposeReduce1Loop(Tensor* output, const TensorShape& new_input_shape, const Tensor& input,
                             gsl::span<const int64_t> reduced_axes, concurrency::ThreadPool* tp,
@@ -523,6 +573,18 @@ void NoTransposeReduce1Loop(Tensor* output, const TensorShape& new_input_shape,
   data.from_data = from_data;
   data.to_data = to_data;
 
+  auto cost = ParallelReduceFastCost(1,
+                                     last_results.projected_index.size() * last_results.last_loop_red_size,
+                                     sizeof(typename AGG::input_type), 6);
+
+  if (last_results.last_loop_inc == 1 && last_results.last_loop_size > 1) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(count), cost, [&data](std::ptrdiff_t first, std::ptrdiff_t end) {
+          NoTransposeReduceByBlocks<AGG, false>(data, first, end);
+        });
+    return;
+  }
+
   auto fn = [&data](std::ptrdiff_t first, std::ptrdiff_t end) {
     const typename AGG::input_type* loop_red_ptr;
     const ResultsNoTransposePrepareForReduce& last_results = *data.last_results;
@@ -552,9 +614,6 @@ void NoTransposeReduce1Loop(Tensor* output, const TensorShape& new_input_shape,
     }
   };
 
-  auto cost = ParallelReduceFastCost(1,
-                                     last_results.projected_index.size() * last_results.last_loop_red_size,
-                                     sizeof(typename AGG::input_type), 6);
   concurrency::ThreadPool::TryParallelFor(tp, onnxruntime::narrow<std::ptrdiff_t>(count), cost, fn);
 }
 
@@ -588,6 +647,18 @@ void NoTransposeReduce2Loops(Tensor* output, const TensorShape& new_input_shape,
   data.from_data = from_data;
   data.to_data = to_data;
 
+  auto cost = ParallelReduceFastCost(1,
+                                     last_results.projected_index.size() * last_results.last_loop_red_size,
+                                     sizeof(typename AGG::input_type), 8);
+
+  if (last_results.last_loop_inc == 1 && last_results.last_loop_size > 1) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(count), cost, [&data](std::ptrdiff_t first, std::ptrdiff_t end) {
+          NoTransposeReduceByBlocks<AGG, true>(data, first, end);
+        });
+    return;
+  }
+
   auto fn = [&](std::ptrdiff_t first, std::ptrdiff_t end) {
     const typename AGG::input_type* loop_red_ptr;
     const ResultsNoTransposePrepareForReduce& last_results = *data.last_results;
@@ -624,9 +695,6 @@ void NoTransposeReduce2Loops(Tensor* output, const TensorShape& new_input_shape,
     }
   };
 
-  auto cost = ParallelReduceFastCost(1,
-                                     last_results.projected_index.size() * last_results.last_loop_red_size,
-                                     sizeof(typename AGG::input_type), 8);
   concurrency::ThreadPool::TryParallelFor(tp, onnxruntime::narrow<std::ptrdiff_t>(count), cost, fn);
 }
 
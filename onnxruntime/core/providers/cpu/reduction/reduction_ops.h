@@ -12,6 +12,7 @@
 #include "core/util/math.h"
 #endif
 #include "core/framework/math.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/cpu/reduction/reduction_kernel_base.h"
@@ -70,6 +71,10 @@ FastReduceKind OptimizeShapeForFastReduce(gsl::span<const int64_t> input_shape,
                                           TensorShapeVector& fast_axes,
                                           bool keep_dims, bool noop_with_empty_axes = false);
 
+// Reads the axes from the optional second input into input_axes. Copies the input to the output and returns true
+// when the axes are empty and noop_with_empty_axes is set.
+bool CommonFastReduceCopy(OpKernelContext* ctx, TensorShapeVector& input_axes, bool noop_with_empty_axes);
+
 class ResultsNoTransposePrepareForReduce {
  public:
   TensorShapeVector input_shape;
@@ -206,6 +211,18 @@ class ReduceAggregator : public ReduceAggregatorBase {
           }
         });
   }
+
+  // Applies f to every element of the output once the reduction is done.
+  static void CommonFinalize(Tensor& output, concurrency::ThreadPool* tp, TVAL (*f)(TVAL)) {
+    TVAL* out = output.MutableData<TVAL>();
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(output.Shape().Size()), TensorOpCost{static_cast<double>(sizeof(TVAL)), static_cast<double>(sizeof(TVAL)), 10.0},
+        [out, f](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            out[i] = f(out[i]);
+          }
+        });
+  }
 };
 
 template <typename T>
@@ -293,13 +310,83 @@ template <typename T, typename TVAL = T>
 class ReduceAggregatorSumSquare : public ReduceAggregator<T, TVAL> {
  public:
   inline ReduceAggregatorSumSquare(int64_t N, const T&) : ReduceAggregator<T, TVAL>(N, 0) {}
+  static TVAL aggall(const T* from_data, int64_t size) {
+    return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).squaredNorm();
+  }
   inline TVAL aggall(const T* from_data) {
-    return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).squaredNorm();
+    return aggall(from_data, this->N_);
   }
   inline void update(const T& v) { this->accumulator_ += v * v; }
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    const T* data = input.Data<T>();
+    TVAL* out = output.MutableData<TVAL>();
+    int64_t stridei = fast_shape[1];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+        [data, stridei, out](ptrdiff_t first, ptrdiff_t last) {
+          for (ptrdiff_t d = first; d < last; ++d) {
+            out[d] = aggall(data + d * stridei, stridei);
+          }
+        });
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    int64_t N = fast_shape[1];
+    const T* data = input.Data<T>();
+    TVAL* out = output.MutableData<TVAL>();
+
+    int64_t n_rows = fast_shape[0];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
+          EigenVectorArrayMap<TVAL>(out + begin, end - begin) = ConstEigenVectorArrayMap<T>(data + begin, end - begin).square();
+          for (int64_t row = 1; row < n_rows; ++row) {
+            EigenVectorArrayMap<TVAL>(out + begin, end - begin) += ConstEigenVectorArrayMap<T>(
+                                                                       data + row * N + begin, end - begin)
+                                                                       .square();
+          }
+        });
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    const T* data = input.Data<T>();
+    TVAL* out = output.MutableData<TVAL>();
+    int64_t stridei = fast_shape[1] * fast_shape[2];
+    int64_t strideo = fast_shape[2];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+        [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
+          for (ptrdiff_t j = begin; j < end; ++j) {
+            EigenVectorMap<TVAL>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
+                ConstEigenMatrixMap<T>(
+                    data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
+                    .rowwise()
+                    .squaredNorm();
+          }
+        });
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregator<T, TVAL>::CommonFastReduceRKR(
+        input, fast_shape, output, tp,
+        [=](const T*) -> TVAL { return 0; },
+        [=](TVAL& value, const T* p, int64_t size) {
+          value += aggall(p, size);
+        });
+  }
 };
 
 template <typename T>
@@ -320,51 +407,27 @@ class ReduceAggregatorMean : public ReduceAggregatorSum<T> {
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
     ReduceAggregatorSum<T>::FastReduceKR(input, fast_shape, output, tp);
-    // TODO: use MLAS or BLAS
-    T* out = output.MutableData<T>();
-    T* end = out + fast_shape[0];
-    for (; out != end; ++out) {
-      *out /= static_cast<T>(fast_shape[1]);
-    }
+    EigenVectorArrayMap<T>(output.MutableData<T>(), onnxruntime::narrow<size_t>(fast_shape[0])) /= static_cast<T>(fast_shape[1]);
   }
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
     ReduceAggregatorSum<T>::FastReduceRK(input, fast_shape, output, tp);
-    // TODO: use MLAS or BLAS
-    T* out = output.MutableData<T>();
-    T* end = out + fast_shape[1];
-    for (; out != end; ++out) {
-      *out /= static_cast<T>(fast_shape[0]);
-    }
+    EigenVectorArrayMap<T>(output.MutableData<T>(), onnxruntime::narrow<size_t>(fast_shape[1])) /= static_cast<T>(fast_shape[0]);
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
     ReduceAggregatorSum<T>::FastReduceKRK(input, fast_shape, output, tp);
-    int64_t strideo = fast_shape[2];
-    T* out = output.MutableData<T>();
-    T* begin;
-    T* end;
-    T div = static_cast<T>(fast_shape[1]);
-    for (int64_t d = 0; d < fast_shape[0]; ++d) {
-      begin = out + strideo * d;
-      end = begin + strideo;
-      for (; begin != end; ++begin) {
-        *begin /= div;
-      }
-    }
+    EigenVectorArrayMap<T>(output.MutableData<T>(), onnxruntime::narrow<size_t>(fast_shape[0] * fast_shape[2])) /=
+        static_cast<T>(fast_shape[1]);
   }
 
   static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
     ReduceAggregatorSum<T>::FastReduceRKR(input, fast_shape, output, tp);
-    T* out = output.MutableData<T>();
-    T div = static_cast<T>(fast_shape[0] * fast_shape[2]);
-    T* end = out + fast_shape[1];
-    for (; out != end; ++out) {
-      *out /= div;
-    }
+    EigenVectorArrayMap<T>(output.MutableData<T>(), onnxruntime::narrow<size_t>(fast_shape[1])) /=
+        static_cast<T>(fast_shape[0] * fast_shape[2]);
   }
 };
 
@@ -439,8 +502,7 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
               if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
                 out[j] = out[j] || p[j];
               } else {
-                if (out[j] < p[j])
-                  out[j] = p[j];
+                out[j] = out[j] < p[j] ? p[j] : out[j];
               }
             }
           }
@@ -649,8 +711,7 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
               if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
                 out[j] = out[j] && p[j];
               } else {
-                if (out[j] > p[j])
-                  out[j] = p[j];
+                out[j] = out[j] > p[j] ? p[j] : out[j];
               }
             }
           }
@@ -720,14 +781,85 @@ template <typename T>
 class ReduceAggregatorL1 : public ReduceAggregator<T, T> {
  public:
   inline ReduceAggregatorL1(int64_t N, const T&) : ReduceAggregator<T, T>(N, 0) {}
+  static T aggall(const T* from_data, int64_t size) {
+    return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(size)).cwiseAbs().sum();
+  }
   inline T aggall(const T* from_data) {
-    return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).cwiseAbs().sum();
+    return aggall(from_data, this->N_);
   }
   inline void update(const T& v) { this->accumulator_ += v > 0 ? v : -v; }
 
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    const T* data = input.Data<T>();
+    T* out = output.MutableData<T>();
+    int64_t stridei = fast_shape[1];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+        [data, stridei, out](ptrdiff_t first, ptrdiff_t last) {
+          for (ptrdiff_t d = first; d < last; ++d) {
+            out[d] = aggall(data + d * stridei, stridei);
+          }
+        });
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    int64_t N = fast_shape[1];
+    const T* data = input.Data<T>();
+    T* out = output.MutableData<T>();
+
+    int64_t n_rows = fast_shape[0];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
+          EigenVectorArrayMap<T>(out + begin, end - begin) = ConstEigenVectorArrayMap<T>(data + begin, end - begin).abs();
+          for (int64_t row = 1; row < n_rows; ++row) {
+            EigenVectorArrayMap<T>(out + begin, end - begin) += ConstEigenVectorArrayMap<T>(
+                                                                    data + row * N + begin, end - begin)
+                                                                    .abs();
+          }
+        });
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    const T* data = input.Data<T>();
+    T* out = output.MutableData<T>();
+    int64_t stridei = fast_shape[1] * fast_shape[2];
+    int64_t strideo = fast_shape[2];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+        [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
+          for (ptrdiff_t j = begin; j < end; ++j) {
+            EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
+                ConstEigenMatrixMap<T>(
+                    data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
+                    .cwiseAbs()
+                    .rowwise()
+                    .sum();
+          }
+        });
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregator<T, T>::CommonFastReduceRKR(
+        input, fast_shape, output, tp,
+        [=](const T*) -> T { return 0; },
+        [=](T& value, const T* p, int64_t size) {
+          value += aggall(p, size);
+        });
+  }
 };
 
 template <typename T>
@@ -742,6 +874,35 @@ class ReduceAggregatorL2 : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
+
+  // Fast reduction: the sum of squares followed by a square root.
+  static inline FastReduceKind WhichFastReduce() {
+    return ReduceAggregatorSumSquare<T>::WhichFastReduce();
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorSumSquare<T>::FastReduceKR(input, fast_shape, output, tp);
+    ReduceAggregator<T, T>::CommonFinalize(output, tp, reduce_sqrt<T>);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorSumSquare<T>::FastReduceRK(input, fast_shape, output, tp);
+    ReduceAggregator<T, T>::CommonFinalize(output, tp, reduce_sqrt<T>);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorSumSquare<T>::FastReduceKRK(input, fast_shape, output, tp);
+    ReduceAggregator<T, T>::CommonFinalize(output, tp, reduce_sqrt<T>);
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorSumSquare<T>::FastReduceRKR(input, fast_shape, output, tp);
+    ReduceAggregator<T, T>::CommonFinalize(output, tp, reduce_sqrt<T>);
+  }
 };
 
 template <typename T>
@@ -756,6 +917,35 @@ class ReduceAggregatorLogSum : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = -std::numeric_limits<T>::infinity();
   }
+
+  // Fast reduction: the sum followed by a logarithm.
+  static inline FastReduceKind WhichFastReduce() {
+    return ReduceAggregatorSum<T>::WhichFastReduce();
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorSum<T>::FastReduceKR(input, fast_shape, output, tp);
+    ReduceAggregator<T, T>::CommonFinalize(output, tp, reduce_log<T>);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorSum<T>::FastReduceRK(input, fast_shape, output, tp);
+    ReduceAggregator<T, T>::CommonFinalize(output, tp, reduce_log<T>);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorSum<T>::FastReduceKRK(input, fast_shape, output, tp);
+    ReduceAggregator<T, T>::CommonFinalize(output, tp, reduce_log<T>);
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorSum<T>::FastReduceRKR(input, fast_shape, output, tp);
+    ReduceAggregator<T, T>::CommonFinalize(output, tp, reduce_log<T>);
+  }
 };
 
 template <typename T>
@@ -782,6 +972,113 @@ class ReduceAggregatorLogSumExp : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = -std::numeric_limits<T>::infinity();
   }
+
+  // Fast reduction, floating point types only. Like update0(), the elements are shifted by the maximum
+  // of the finite elements (or 0 if there are none) so that infinities propagate through the exponentials.
+  static inline FastReduceKind WhichFastReduce() {
+    if constexpr (std::is_floating_point_v<T>) {
+      return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK;
+    } else {
+      return FastReduceKind::kNone;
+    }
+  }
+
+  static T aggall(const T* from_data, int64_t size) {
+    if constexpr (std::is_same_v<T, float>) {
+      float value;
+      MlasComputeLogSumExp(from_data, &value, 1, onnxruntime::narrow<size_t>(size));
+      return value;
+    } else {
+      ConstEigenVectorArrayMap<T> row(from_data, onnxruntime::narrow<size_t>(size));
+      T shift = row.maxCoeff();
+      if (!std::isfinite(shift)) {
+        shift = 0;
+        bool has_finite = false;
+        for (int64_t i = 0; i < size; ++i) {
+          if (std::isfinite(from_data[i]) && (!has_finite || from_data[i] > shift)) {
+            shift = from_data[i];
+            has_finite = true;
+          }
+        }
+      }
+      return reduce_log<T>((row - shift).exp().sum()) + shift;
+    }
+  }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    const T* data = input.Data<T>();
+    T* out = output.MutableData<T>();
+    int64_t stridei = fast_shape[1];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 16),
+        [data, stridei, out](ptrdiff_t first, ptrdiff_t last) {
+          if constexpr (std::is_same_v<T, float>) {
+            MlasComputeLogSumExp(data + first * stridei, out + first, onnxruntime::narrow<size_t>(last - first),
+                                 onnxruntime::narrow<size_t>(stridei));
+          } else {
+            for (ptrdiff_t d = first; d < last; ++d) {
+              out[d] = aggall(data + d * stridei, stridei);
+            }
+          }
+        });
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    int64_t n_rows = fast_shape[0];
+    int64_t N = fast_shape[1];
+    const T* data = input.Data<T>();
+    T* out = output.MutableData<T>();
+    std::vector<T> shift(onnxruntime::narrow<size_t>(N));
+    T* shift_data = shift.data();
+
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 16),
+        [data, out, shift_data, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
+          ReduceColumns(data + begin, out + begin, shift_data + begin, n_rows, N, end - begin);
+        });
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    const T* data = input.Data<T>();
+    T* out = output.MutableData<T>();
+    int64_t n_rows = fast_shape[1];
+    int64_t N = fast_shape[2];
+    int64_t stridei = fast_shape[1] * fast_shape[2];
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 16),
+        [data, out, n_rows, N, stridei](ptrdiff_t begin, ptrdiff_t end) {
+          std::vector<T> shift(onnxruntime::narrow<size_t>(N));
+          for (ptrdiff_t j = begin; j < end; ++j) {
+            ReduceColumns(data + j * stridei, out + j * N, shift.data(), n_rows, N, N);
+          }
+        });
+  }
+
+ private:
+  // Reduces n_cols columns of a matrix with n_rows rows and a leading dimension ld. The rows are read
+  // contiguously, once to find the shift of every column and once to accumulate the exponentials.
+  static void ReduceColumns(const T* data, T* out, T* shift, int64_t n_rows, int64_t ld, int64_t n_cols) {
+    std::fill(shift, shift + n_cols, -std::numeric_limits<T>::infinity());
+    for (int64_t row = 0; row < n_rows; ++row) {
+      const T* p = data + row * ld;
+      for (int64_t j = 0; j < n_cols; ++j) {
+        shift[j] = std::isfinite(p[j]) && p[j] > shift[j] ? p[j] : shift[j];
+      }
+    }
+
+    EigenVectorArrayMap<T> shift_map(shift, onnxruntime::narrow<size_t>(n_cols));
+    shift_map = shift_map.isInf().select(static_cast<T>(0), shift_map);
+
+    EigenVectorArrayMap<T> out_map(out, onnxruntime::narrow<size_t>(n_cols));
+    out_map.setZero();
+    for (int64_t row = 0; row < n_rows; ++row) {
+      out_map += (ConstEigenVectorArrayMap<T>(data + row * ld, onnxruntime::narrow<size_t>(n_cols)) - shift_map).exp();
+    }
+    out_map = out_map.log() + shift_map;
+  }
 };
 
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
@@ -12,10 +12,11 @@
 namespace onnxruntime {
 
 /// The class represents GRU operator using DeepCPU implementation for
-/// fast inference computation on CPU machines.
-class DeepCpuGruOp final : public OpKernel {
- public:
-  DeepCpuGruOp(const OpKernelInfo& info) : OpKernel(info) {
+/// fast inference computation on CPU machines. It holds the attributes and runs the directions for both the float
+/// GRU and the dynamically quantized GRU kernels, which differ in the weights they pass in.
+class GRUBase {
+ protected:
+  GRUBase(const OpKernelInfo& info) {
     // required attributes
     std::string direction;
     ORT_ENFORCE(info.GetAttr("direction", &direction).IsOK());
@@ -56,6 +57,39 @@ class DeepCpuGruOp final : public OpKernel {
                 "Batchwise recurrent operations (layout == 1) are not supported. If you need support create a github issue with justification.");
   }
 
+  ~GRUBase() = default;
+
+  // W_shape and R_shape are the shapes of the weights in the layout of the ONNX GRU,
+  // [num_directions, 3*hidden_size, input_size] and [num_directions, 3*hidden_size, hidden_size]
+  Status ValidateInputs(const Tensor& X, const TensorShape& W_shape, const TensorShape& R_shape,
+                        const Tensor* B, const Tensor* sequence_lens, const Tensor* initial_h) const;
+
+  // runs the directions with the weights of the validated inputs. the recurrent weights of each direction are split in
+  // the weights of the update and reset gates, and the weights of the hidden gate.
+  template <typename T, typename WeightT>
+  Status ComputeImpl(OpKernelContext& context,
+                     const rnn::detail::GemmWeights<WeightT>& W_1,
+                     const rnn::detail::GemmWeights<WeightT>& W_2,
+                     const rnn::detail::GemmWeights<WeightT>& R_ZR_1,
+                     const rnn::detail::GemmWeights<WeightT>& R_ZR_2,
+                     const rnn::detail::GemmWeights<WeightT>& R_H_1,
+                     const rnn::detail::GemmWeights<WeightT>& R_H_2) const;
+
+  rnn::detail::Direction direction_;
+  int num_directions_;
+
+  int hidden_size_{};
+  float clip_;
+  int linear_before_reset_{};
+  int64_t layout_;
+
+  rnn::detail::ActivationFuncs activation_funcs_;
+};
+
+class DeepCpuGruOp final : public OpKernel, public GRUBase {
+ public:
+  DeepCpuGruOp(const OpKernelInfo& info) : OpKernel(info), GRUBase(info) {}
+
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuGruOp() override = default;
@@ -73,16 +107,6 @@ class DeepCpuGruOp final : public OpKernel {
 
   bool TryPackRecurrentWeights(const Tensor& weights, AllocatorPtr& alloc);
 
-  rnn::detail::Direction direction_;
-  int num_directions_;
-
-  int hidden_size_{};
-  float clip_;
-  int linear_before_reset_{};
-  int64_t layout_;
-
-  rnn::detail::ActivationFuncs activation_funcs_;
-
   // This kernel supports either forward or bidirectional
   // This is split in half for bidirectional, but we prepack it in the same buffer
   rnn::detail::PackedWeights pre_packed_input_weights_;
@@ -107,10 +131,11 @@ class UniDirectionalGru {
                     onnxruntime::concurrency::ThreadPool* ttp,
                     const bool training_mode = false);
 
+  template <typename WeightT>
   void Compute(gsl::span<const T> inputs, gsl::span<const int> sequence_lengths, int num_directions,
-               const rnn::detail::GemmWeights<T>& input_weights,
-               const rnn::detail::GemmWeights<T>& recurrent_weights_ZR,
-               const rnn::detail::GemmWeights<T>& recurrent_weights_H,
+               const rnn::detail::GemmWeights<WeightT>& input_weights,
+               const rnn::detail::GemmWeights<WeightT>& recurrent_weights_ZR,
+               const rnn::detail::GemmWeights<WeightT>& recurrent_weights_H,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   // This function overloads the above one by adding two additional reference inputs that are computed in this kernel:
@@ -126,10 +151,11 @@ class UniDirectionalGru {
   ~UniDirectionalGru() = default;
 
  private:
+  template <typename WeightT>
   void ComputeImpl(gsl::span<const T> inputs, gsl::span<const int> sequence_lengths, int num_directions,
-                   const rnn::detail::GemmWeights<T>& input_weights,
-                   const rnn::detail::GemmWeights<T>& recurrent_weights_ZR,
-                   const rnn::detail::GemmWeights<T>& recurrent_weights_H,
+                   const rnn::detail::GemmWeights<WeightT>& input_weights,
+                   const rnn::detail::GemmWeights<WeightT>& recurrent_weights_ZR,
+                   const rnn::detail::GemmWeights<WeightT>& recurrent_weights_H,
                    gsl::span<T>& outputs, gsl::span<T>& final_hidden_state,
                    gsl::span<T>& zrh);
 
@@ -191,6 +217,17 @@ class UniDirectionalGru {
 
   void AllocateBuffers();
 
+  template <typename WeightT>
+  void AllocateQuantizeBuffers(int max_sequence_length);
+
+  // Quantized operation related allocation members
+  // Buffer shared for the quantized inputs of all the steps, and the quantized Ht-1 of each step
+  IAllocatorUniquePtr<uint8_t> quantized_input_or_a_ptr_;
+  gsl::span<uint8_t> quantized_input_or_a_;
+  // Accumulation buffer of the quantized GEMMs that add to their output
+  IAllocatorUniquePtr<int32_t> quantized_C_buffer_ptr_;
+  gsl::span<int32_t> quantized_C_buffer_;
+
   onnxruntime::concurrency::ThreadPool* ttp_;
 
   const bool training_mode_ = false;
@@ -195,7 +195,8 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("S", DataTypeImpl::AllSequenceTensorTypes())
         .TypeConstraint("I", std::vector<MLDataType>{
                                  DataTypeImpl::GetTensorType<int32_t>(),
-                                 DataTypeImpl::GetTensorType<int64_t>()}),
+                                 DataTypeImpl::GetTensorType<int64_t>()})
+        .MayInplace(0, 0),
     SequenceInsert);
 
 // Using DataTransferManager here allows other non-CPU EPs to use this implementation of the sequence ops
@@ -234,6 +235,14 @@ Status SequenceInsert::Compute(OpKernelContext* context) const {
   }
 
   auto* Y = context->Output<TensorSeq>(0);
+
+  // When the input sequence has no other consumer the planner gives it to the output, and only the new tensor is
+  // added to it. The tensors of the sequence are shared OrtValues, so no tensor data is copied either way.
+  if (Y == S) {
+    Y->Insert(narrow<size_t>(input_seq_idx), CloneTensor(*X, context, Info().GetDataTransferManager()));
+    return Status::OK();
+  }
+
   Y->SetType(S->DataType());
   Y->Reserve(SafeInt<size_t>(num_tensors_input_seq) + 1);
 
@@ -262,7 +271,8 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("S", DataTypeImpl::AllSequenceTensorTypes())
         .TypeConstraint("I", std::vector<MLDataType>{
                                  DataTypeImpl::GetTensorType<int32_t>(),
-                                 DataTypeImpl::GetTensorType<int64_t>()}),
+                                 DataTypeImpl::GetTensorType<int64_t>()})
+        .MayInplace(0, 0),
     SequenceErase);
 
 Status SequenceErase::Compute(OpKernelContext* context) const {
@@ -284,6 +294,15 @@ Status SequenceErase::Compute(OpKernelContext* context) const {
   }
 
   auto* Y = context->Output<TensorSeq>(0);
+
+  // see SequenceInsert for the output reusing the input sequence.
+  if (Y == S) {
+    if (num_tensors_input_seq > 0) {
+      Y->Erase(narrow<size_t>(input_seq_idx));
+    }
+    return Status::OK();
+  }
+
   Y->SetType(S->DataType());
   Y->Reserve(SafeInt<size_t>(num_tensors_input_seq) - 1);
 
@@ -3,10 +3,12 @@
 
 #include "core/providers/cpu/signal/dft.h"
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <functional>
 #include <limits>
+#include <type_traits>
 #include <vector>
 #include <core/common/safeint.h>
 
@@ -199,6 +201,245 @@ T next_power_of_2(T in) {
   return out;
 }
 
+// Mixed radix FFT for the lengths whose prime factors are 2, 3 and 5, which covers the common audio frame sizes
+// (e.g. 400 = 4 * 4 * 5 * 5). The twiddles of a length are computed once, and the plan is shared by all the
+// transforms of a kernel invocation. For a real signal of even length, the forward transform runs a complex FFT of
+// half the length on the even and odd samples packed as complex values.
+template <typename T>
+class MixedRadixFft {
+ public:
+  static bool IsSupported(size_t dft_length) {
+    if (dft_length == 0) {
+      return false;
+    }
+    for (size_t radix : {2, 3, 5}) {
+      while (dft_length % radix == 0) {
+        dft_length /= radix;
+      }
+    }
+    return dft_length == 1;
+  }
+
+  // is_real_input is whether the signal is real. dft_length must be supported.
+  MixedRadixFft(size_t dft_length, bool inverse, bool is_real_input)
+      : dft_length_(dft_length),
+        inverse_(inverse),
+        is_half_length_(is_real_input && !inverse && dft_length % 2 == 0),
+        fft_length_(is_half_length_ ? dft_length / 2 : dft_length) {
+    // radix 4 first, then 2, 3 and 5. each stage is a (radix, remaining length) pair.
+    size_t n = fft_length_;
+    for (size_t radix : {4, 2, 3, 5}) {
+      while (n % radix == 0) {
+        n /= radix;
+        stages_.push_back(radix);
+        stages_.push_back(n);
+      }
+    }
+
+    const double direction = inverse ? 1. : -1.;
+    twiddles_.resize(fft_length_);
+    for (size_t k = 0; k < fft_length_; k++) {
+      const double angle = direction * 2. * M_PI * static_cast<double>(k) / static_cast<double>(fft_length_);
+      twiddles_[k] = std::complex<T>(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+    }
+
+    if (is_half_length_) {
+      half_length_twiddles_.resize(fft_length_ + 1);
+      for (size_t k = 0; k <= fft_length_; k++) {
+        const double angle = -2. * M_PI * static_cast<double>(k) / static_cast<double>(dft_length_);
+        half_length_twiddles_[k] = std::complex<T>(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+      }
+    }
+  }
+
+  // Buffers of a transform, reused by the transforms that run on a thread.
+  struct Scratch {
+    InlinedVector<std::complex<T>> input;
+    InlinedVector<std::complex<T>> output;
+  };
+
+  // Transforms the first dft_length samples of X, or X padded with zeros if it has fewer samples, multiplied by the
+  // window if any, and writes the first output_size values of the result to Y.
+  template <typename U>
+  void Transform(const U* X, size_t X_stride, size_t number_of_samples, const T* window,
+                 std::complex<T>* Y, size_t Y_stride, size_t output_size, Scratch& scratch) const {
+    scratch.input.resize(fft_length_);
+    scratch.output.resize(fft_length_);
+    const size_t samples = std::min(number_of_samples, dft_length_);
+    auto sample = [&](size_t n) -> U {
+      return window ? X[n * X_stride] * window[n] : X[n * X_stride];
+    };
+
+    std::complex<T>* input = scratch.input.data();
+    if constexpr (std::is_same<U, T>::value) {
+      if (is_half_length_) {
+        for (size_t n = 0; n < fft_length_; n++) {
+          input[n] = std::complex<T>(2 * n < samples ? sample(2 * n) : 0, 2 * n + 1 < samples ? sample(2 * n + 1) : 0);
+        }
+      } else {
+        for (size_t n = 0; n < fft_length_; n++) {
+          input[n] = std::complex<T>(n < samples ? sample(n) : 0, 0);
+        }
+      }
+    } else {
+      for (size_t n = 0; n < fft_length_; n++) {
+        input[n] = n < samples ? sample(n) : std::complex<T>(0, 0);
+      }
+    }
+
+    std::complex<T>* output = scratch.output.data();
+    if (stages_.empty()) {
+      // the transform of length 1 is the identity
+      output[0] = input[0];
+    } else {
+      Run(output, input, 1, stages_.data());
+    }
+
+    if (is_half_length_) {
+      // X[k] = E[k] + W^k * O[k], with E and O the transforms of the even and odd samples, that are
+      // E[k] = (Z[k] + conj(Z[M - k])) / 2 and O[k] = -i * (Z[k] - conj(Z[M - k])) / 2 for the transform Z of length M.
+      const size_t M = fft_length_;
+      for (size_t k = 0; k < std::min(output_size, M + 1); k++) {
+        const std::complex<T> z = output[k % M];
+        const std::complex<T> z_conj = std::conj(output[(M - k) % M]);
+        const std::complex<T> even = (z + z_conj) * static_cast<T>(0.5);
+        const std::complex<T> odd = (z - z_conj) * std::complex<T>(0, static_cast<T>(-0.5));
+        Y[k * Y_stride] = even + half_length_twiddles_[k] * odd;
+      }
+      // the transform of a real signal is conjugate symmetric
+      for (size_t k = M + 1; k < output_size; k++) {
+        Y[k * Y_stride] = std::conj(Y[(dft_length_ - k) * Y_stride]);
+      }
+    } else {
+      const T scale = inverse_ ? static_cast<T>(1) / static_cast<T>(dft_length_) : static_cast<T>(1);
+      for (size_t k = 0; k < output_size; k++) {
+        Y[k * Y_stride] = output[k] * scale;
+      }
+    }
+  }
+
+  // the cost of a transform for ThreadPool::TryParallelFor
+  double ComputeCost() const {
+    return 5. * static_cast<double>(fft_length_) * std::max(1., std::log2(static_cast<double>(fft_length_)));
+  }
+
+ private:
+  // Decimation in time: the transform of the samples of input at stride in_stride, which are
+  // stages[0] * stages[1] samples, is the stages[0] interleaved transforms of length stages[1] recombined.
+  void Run(std::complex<T>* output, const std::complex<T>* input, size_t in_stride, const size_t* stages) const {
+    const size_t radix = stages[0];
+    const size_t m = stages[1];
+    if (m == 1) {
+      for (size_t j = 0; j < radix; j++) {
+        output[j] = input[j * in_stride];
+      }
+    } else {
+      for (size_t j = 0; j < radix; j++) {
+        Run(output + j * m, input + j * in_stride, in_stride * radix, stages + 2);
+      }
+    }
+
+    switch (radix) {
+      case 2:
+        Butterfly2(output, in_stride, m);
+        break;
+      case 3:
+        Butterfly3(output, in_stride, m);
+        break;
+      case 4:
+        Butterfly4(output, in_stride, m);
+        break;
+      default:
+        Butterfly5(output, in_stride, m);
+        break;
+    }
+  }
+
+  void Butterfly2(std::complex<T>* output, size_t twiddle_stride, size_t m) const {
+    for (size_t k = 0; k < m; k++) {
+      const std::complex<T> t = output[k + m] * twiddles_[k * twiddle_stride];
+      output[k + m] = output[k] - t;
+      output[k] += t;
+    }
+  }
+
+  void Butterfly3(std::complex<T>* output, size_t twiddle_stride, size_t m) const {
+    // the imaginary part of the twiddle of 1/3 turn
+    const T sin_third = twiddles_[twiddle_stride * m].imag();
+    for (size_t k = 0; k < m; k++) {
+      const std::complex<T> s1 = output[k + m] * twiddles_[k * twiddle_stride];
+      const std::complex<T> s2 = output[k + 2 * m] * twiddles_[2 * k * twiddle_stride];
+      const std::complex<T> sum = s1 + s2;
+      const std::complex<T> diff = (s1 - s2) * sin_third;
+      const std::complex<T> mid = output[k] - sum * static_cast<T>(0.5);
+      output[k] += sum;
+      output[k + m] = std::complex<T>(mid.real() - diff.imag(), mid.imag() + diff.real());
+      output[k + 2 * m] = std::complex<T>(mid.real() + diff.imag(), mid.imag() - diff.real());
+    }
+  }
+
+  void Butterfly4(std::complex<T>* output, size_t twiddle_stride, size_t m) const {
+    for (size_t k = 0; k < m; k++) {
+      const std::complex<T> s0 = output[k + m] * twiddles_[k * twiddle_stride];
+      const std::complex<T> s1 = output[k + 2 * m] * twiddles_[2 * k * twiddle_stride];
+      const std::complex<T> s2 = output[k + 3 * m] * twiddles_[3 * k * twiddle_stride];
+      const std::complex<T> s3 = s0 + s2;
+      const std::complex<T> s4 = s0 - s2;
+      const std::complex<T> s5 = output[k] - s1;
+      const std::complex<T> s6 = output[k] + s1;
+      output[k] = s6 + s3;
+      output[k + 2 * m] = s6 - s3;
+      // s4 rotated by a quarter turn in the direction of the transform
+      const std::complex<T> s4_rotated = inverse_ ? std::complex<T>(-s4.imag(), s4.real())
+                                                  : std::complex<T>(s4.imag(), -s4.real());
+      output[k + m] = s5 + s4_rotated;
+      output[k + 3 * m] = s5 - s4_rotated;
+    }
+  }
+
+  void Butterfly5(std::complex<T>* output, size_t twiddle_stride, size_t m) const {
+    // the twiddles of 1/5 and 2/5 turn
+    const std::complex<T> ya = twiddles_[twiddle_stride * m];
+    const std::complex<T> yb = twiddles_[2 * twiddle_stride * m];
+    for (size_t k = 0; k < m; k++) {
+      const std::complex<T> s0 = output[k];
+      const std::complex<T> s1 = output[k + m] * twiddles_[k * twiddle_stride];
+      const std::complex<T> s2 = output[k + 2 * m] * twiddles_[2 * k * twiddle_stride];
+      const std::complex<T> s3 = output[k + 3 * m] * twiddles_[3 * k * twiddle_stride];
+      const std::complex<T> s4 = output[k + 4 * m] * twiddles_[4 * k * twiddle_stride];
+
+      const std::complex<T> s7 = s1 + s4;
+      const std::complex<T> s10 = s1 - s4;
+      const std::complex<T> s8 = s2 + s3;
+      const std::complex<T> s9 = s2 - s3;
+
+      output[k] = s0 + s7 + s8;
+
+      const std::complex<T> s5(s0.real() + s7.real() * ya.real() + s8.real() * yb.real(),
+                               s0.imag() + s7.imag() * ya.real() + s8.imag() * yb.real());
+      const std::complex<T> s6(s10.imag() * ya.imag() + s9.imag() * yb.imag(),
+                               -s10.real() * ya.imag() - s9.real() * yb.imag());
+      output[k + m] = s5 - s6;
+      output[k + 4 * m] = s5 + s6;
+
+      const std::complex<T> s11(s0.real() + s7.real() * yb.real() + s8.real() * ya.real(),
+                                s0.imag() + s7.imag() * yb.real() + s8.imag() * ya.real());
+      const std::complex<T> s12(-s10.imag() * yb.imag() + s9.imag() * ya.imag(),
+                                s10.real() * yb.imag() - s9.real() * ya.imag());
+      output[k + 2 * m] = s11 + s12;
+      output[k + 3 * m] = s11 - s12;
+    }
+  }
+
+  const size_t dft_length_;
+  const bool inverse_;
+  const bool is_half_length_;
+  const size_t fft_length_;
+  InlinedVector<size_t> stages_;
+  InlinedVector<std::complex<T>> twiddles_;
+  InlinedVector<std::complex<T>> half_length_twiddles_;
+};
+
 template <typename T, typename U>
 static Status dft_bluestein_z_chirp(
     OpKernelContext* ctx, const Tensor* X, Tensor* Y, Tensor& b_fft, Tensor& chirp, size_t X_offset, size_t X_stride, size_t Y_offset, size_t Y_stride,
@@ -333,9 +574,10 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
   }
 
   // Calculate x/y offsets/strides
-  for (size_t i = 0; i < total_dfts; i++) {
-    size_t X_offset = 0;
-    size_t X_stride = onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
+  const size_t X_stride = onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
+  const size_t Y_stride = onnxruntime::narrow<size_t>(Y_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / 2);
+  auto get_offsets = [&](size_t i, size_t& X_offset, size_t& Y_offset) {
+    X_offset = 0;
     size_t cumulative_packed_stride = total_dfts;
     size_t temp = i;
     for (size_t r = 0; r < batch_and_signal_rank; r++) {
@@ -348,8 +590,7 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
       X_offset += index * SafeInt<size_t>(X_shape.SizeFromDimension(r + 1)) / complex_input_factor;
     }
 
-    size_t Y_offset = 0;
-    size_t Y_stride = onnxruntime::narrow<size_t>(Y_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / 2);
+    Y_offset = 0;
     cumulative_packed_stride = total_dfts;
     temp = i;
     for (size_t r = 0; r < batch_and_signal_rank; r++) {
@@ -361,6 +602,35 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
       temp -= (index * cumulative_packed_stride);
       Y_offset += index * SafeInt<size_t>(Y_shape.SizeFromDimension(r + 1)) / 2;
     }
+  };
+
+  if (MixedRadixFft<T>::IsSupported(onnxruntime::narrow<size_t>(dft_length))) {
+    const MixedRadixFft<T> fft(onnxruntime::narrow<size_t>(dft_length), inverse, std::is_same<U, T>::value);
+    const auto* X_data = reinterpret_cast<const U*>(X->DataRaw());
+    auto* Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw());
+    const T* window_data = window ? reinterpret_cast<const T*>(window->DataRaw()) : nullptr;
+    const size_t number_of_samples = onnxruntime::narrow<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
+    const size_t output_size = onnxruntime::narrow<size_t>(Y_shape[onnxruntime::narrow<size_t>(axis)]);
+
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(total_dfts),
+        TensorOpCost{static_cast<double>(number_of_samples * sizeof(U)),
+                     static_cast<double>(output_size * sizeof(std::complex<T>)), fft.ComputeCost()},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          typename MixedRadixFft<T>::Scratch scratch;
+          for (std::ptrdiff_t i = first; i < last; i++) {
+            size_t X_offset, Y_offset;
+            get_offsets(static_cast<size_t>(i), X_offset, Y_offset);
+            fft.Transform(X_data + X_offset, X_stride, number_of_samples, window_data,
+                          Y_data + Y_offset, Y_stride, output_size, scratch);
+          }
+        });
+    return Status::OK();
+  }
+
+  for (size_t i = 0; i < total_dfts; i++) {
+    size_t X_offset, Y_offset;
+    get_offsets(i, X_offset, Y_offset);
 
     if (is_power_of_2(onnxruntime::narrow<size_t>(dft_length))) {
       ORT_RETURN_IF_ERROR((fft_radix2<T, U>(ctx, X, Y, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window,
@@ -529,6 +799,32 @@ static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_oneside
   auto dft_input_shape = onnxruntime::TensorShape({1, window_size, signal_components});
   auto dft_output_shape = onnxruntime::TensorShape({1, dft_output_size, output_components});
 
+  if (MixedRadixFft<T>::IsSupported(onnxruntime::narrow<size_t>(window_size))) {
+    // the frames of all the batches are transformed in parallel with the same plan
+    const MixedRadixFft<T> fft(onnxruntime::narrow<size_t>(window_size), false, std::is_same<U, T>::value);
+    const T* window_data = window ? reinterpret_cast<const T*>(window->DataRaw()) : nullptr;
+    auto* Y_complex_data = reinterpret_cast<std::complex<T>*>(Y_data);
+    const size_t frame_size = onnxruntime::narrow<size_t>(window_size);
+    const size_t output_size = onnxruntime::narrow<size_t>(dft_output_size);
+
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(batch_size * n_dfts),
+        TensorOpCost{static_cast<double>(frame_size * sizeof(U)),
+                     static_cast<double>(output_size * sizeof(std::complex<T>)), fft.ComputeCost()},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          typename MixedRadixFft<T>::Scratch scratch;
+          for (std::ptrdiff_t frame = first; frame < last; frame++) {
+            const int64_t batch_idx = frame / n_dfts;
+            const int64_t i = frame % n_dfts;
+            // the signal is indexed in U, which holds all the components of a sample
+            const U* input_frame_begin = signal_data + (batch_idx * signal_size) + (i * frame_step);
+            fft.Transform(input_frame_begin, 1, frame_size, window_data,
+                          Y_complex_data + frame * dft_output_size, 1, output_size, scratch);
+          }
+        });
+    return Status::OK();
+  }
+
   Tensor b_fft, chirp;
   InlinedVector<std::complex<T>> V;
   InlinedVector<std::complex<T>> temp_output;
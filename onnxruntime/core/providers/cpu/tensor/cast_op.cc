@@ -18,6 +18,7 @@
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 
 #include "Eigen/src/Core/arch/Default/BFloat16.h"
 #include "Eigen/src/Core/arch/Default/Half.h"
@@ -262,6 +263,17 @@ struct TensorCaster<MLFloat16, float> {
   }
 };
 
+#if !defined(DISABLE_FLOAT8_TYPES)
+// tensor float 8 -> float
+template <typename SrcType>
+struct TensorCaster<SrcType, float, std::enable_if_t<IsOrtFloat8Type<SrcType>::value>> {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    ParDequantizeLinear(in.Data<SrcType>(), out.MutableData<float>(), narrow<size_t>(shape.Size()), 1.0f,
+                        context.GetOperatorThreadPool());
+  }
+};
+#endif
+
 #if defined(_M_AMD64) && !defined(_M_ARM64EC)
 // specializations to use optimized and Windows x64-specific
 
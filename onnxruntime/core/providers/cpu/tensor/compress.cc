@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/compress.h"
 #include "core/providers/common.h"
+#include "core/providers/cpu/tensor/parallel_compaction.h"
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -38,17 +39,22 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto condition_length = condition->Shape().Size();
   auto condition_data = condition->Data<bool>();
 
-  int64_t positive_condition_count = 0;
   // if has axis, we need to compress on dimension[axis], otherwise compress on the flattened input data
   int64_t compress_input_length = has_axis_ ? input_dimensions[onnxruntime::narrow<size_t>(axis)] : input_tensor->Shape().Size();
   int64_t valid_condition_length = compress_input_length < condition_length ? compress_input_length : condition_length;
 
-  // Figure out output shape
-  for (int i = 0; i < valid_condition_length; ++i) {
-    if (condition_data[i]) {
-      ++positive_condition_count;
-    }
-  }
+  // Figure out output shape. The positive conditions are counted in blocks, which are also the unit of the parallel
+  // copy when compressing the flattened input.
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  ParallelCompaction compaction(tp, onnxruntime::narrow<size_t>(valid_condition_length),
+                                [condition_data](size_t begin, size_t end) {
+                                  size_t count = 0;
+                                  for (size_t i = begin; i < end; ++i) {
+                                    count += condition_data[i] ? 1 : 0;
+                                  }
+                                  return count;
+                                });
+  int64_t positive_condition_count = static_cast<int64_t>(compaction.Count());
 
   std::vector<int64_t> output_dims(input_dimensions.begin(), input_dimensions.end());
   if (has_axis_) {
@@ -68,7 +74,6 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto* output_data = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
   auto element_bytes = input_tensor->DataType()->Size();
   bool is_string_type = input_tensor->IsDataTypeString();
-  int64_t output_index = 0;
 
   if (has_axis_) {
     int64_t axes_left_stride = 1;
@@ -88,35 +93,46 @@ Status Compress::Compute(OpKernelContext* ctx) const {
     if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(axes_right_stride), element_bytes,
                                          &axes_right_stride_bytes))
       return Status(ONNXRUNTIME, FAIL, "size overflow");
-    for (int i = 0; i < axes_left_stride; ++i) {
-      for (int j = 0; j < valid_condition_length; ++j) {
-        if (!condition_data[j]) {
+
+    // every outer slice of the input produces positive_condition_count slices of the output, so the outer slices
+    // are copied in parallel
+    const int64_t output_outer_stride = positive_condition_count * axes_right_stride;
+    const double cost = static_cast<double>(output_outer_stride * element_bytes);
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(axes_left_stride), cost,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            int64_t output_index = i * output_outer_stride;
+            for (int64_t j = 0; j < valid_condition_length; ++j) {
+              if (!condition_data[j]) {
+                continue;
+              }
+              if (is_string_type) {
+                for (int64_t idxItem = 0; idxItem < axes_right_stride; ++idxItem) {
+                  reinterpret_cast<std::string*>(output_data)[output_index + idxItem] =
+                      reinterpret_cast<const std::string*>(input_data)[i * axes_included_right_stride + j * axes_right_stride + idxItem];
+                }
+              } else {
+                memcpy(output_data + output_index * element_bytes, input_data + i * axes_included_right_stride_bytes + j * axes_right_stride_bytes, axes_right_stride_bytes);
+              }
+              output_index += axes_right_stride;
+            }
+          }
+        });
+  } else {
+    compaction.Scatter([&](size_t begin, size_t end, size_t output_index) {
+      for (size_t i = begin; i < end; ++i) {
+        if (!condition_data[i]) {
           continue;
         }
         if (is_string_type) {
-          for (int idxItem = 0; idxItem < axes_right_stride; ++idxItem) {
-            reinterpret_cast<std::string*>(output_data)[output_index + idxItem] =
-                reinterpret_cast<const std::string*>(input_data)[i * axes_included_right_stride + j * axes_right_stride + idxItem];
-          }
-          output_index += axes_right_stride;
+          reinterpret_cast<std::string*>(output_data)[output_index] = reinterpret_cast<const std::string*>(input_data)[i];
         } else {
-          memcpy(output_data + output_index, input_data + i * axes_included_right_stride_bytes + j * axes_right_stride_bytes, axes_right_stride_bytes);
-          output_index += axes_right_stride_bytes;
+          memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
         }
+        ++output_index;
       }
-    }
-  } else {
-    for (int i = 0; i < valid_condition_length; ++i) {
-      if (!condition_data[i]) {
-        continue;
-      }
-      if (is_string_type) {
-        reinterpret_cast<std::string*>(output_data)[output_index] = reinterpret_cast<const std::string*>(input_data)[i];
-      } else {
-        memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
-      }
-      ++output_index;
-    }
+    });
   }
 
   return Status::OK();
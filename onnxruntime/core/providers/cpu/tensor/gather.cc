@@ -102,30 +102,59 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-  auto lambda = [&](int64_t index) {
-    int64_t batch = index / N;
-    int64_t i = index % N;
-
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
-    Tin idx = indices_data[i];
-    idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
-
-    if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
-    } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, narrow<size_t>(block_size));
+  // The indices are validated above, so the copy loops only normalize the negative indices. Every task walks a
+  // contiguous range of the (batch, index) pairs and advances the position incrementally.
+  auto copy_range = [&](ptrdiff_t first, ptrdiff_t last, auto copy_block) {
+    int64_t batch = first / N;
+    int64_t i = first % N;
+    for (ptrdiff_t index = first; index < last; ++index) {
+      Tin idx = indices_data[i];
+      idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
+      const int64_t src_offset = batch * data_batch_bytes + idx * block_size;
+      const int64_t dst_offset = batch * gathered_batch_bytes + i * block_size;
+      copy_block(dst_offset, src_offset);
+      if (++i == N) {
+        i = 0;
+        ++batch;
+      }
     }
   };
-  concurrency::ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(M) * N, static_cast<double>(block_size),
-                                          [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int index = static_cast<int>(first), end = static_cast<int>(last); index < end; ++index) {
-                                              lambda(index);
-                                            }
-                                          });
+
+  // Gathering a single scalar per index (e.g. embedding ids or the last axis) is dominated by the per element memcpy
+  // call, so the common element sizes are copied with typed loads and stores.
+  auto typed_copy = [&](auto type_tag) {
+    using T = decltype(type_tag);
+    return [&](ptrdiff_t first, ptrdiff_t last) {
+      copy_range(first, last, [&](int64_t dst_offset, int64_t src_offset) {
+        *reinterpret_cast<T*>(dst_base + dst_offset) = *reinterpret_cast<const T*>(src_base + src_offset);
+      });
+    };
+  };
+
+  const ptrdiff_t total = SafeInt<ptrdiff_t>(M) * N;
+  const double cost = static_cast<double>(block_size);
+  if (is_string_type) {
+    concurrency::ThreadPool::TryParallelFor(tp, total, cost, [&](ptrdiff_t first, ptrdiff_t last) {
+      copy_range(first, last, [&](int64_t dst_offset, int64_t src_offset) {
+        reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
+            reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
+      });
+    });
+  } else if (block_size == sizeof(uint32_t)) {
+    concurrency::ThreadPool::TryParallelFor(tp, total, cost, typed_copy(uint32_t{}));
+  } else if (block_size == sizeof(uint64_t)) {
+    concurrency::ThreadPool::TryParallelFor(tp, total, cost, typed_copy(uint64_t{}));
+  } else if (block_size == sizeof(uint16_t)) {
+    concurrency::ThreadPool::TryParallelFor(tp, total, cost, typed_copy(uint16_t{}));
+  } else if (block_size == sizeof(uint8_t)) {
+    concurrency::ThreadPool::TryParallelFor(tp, total, cost, typed_copy(uint8_t{}));
+  } else {
+    concurrency::ThreadPool::TryParallelFor(tp, total, cost, [&](ptrdiff_t first, ptrdiff_t last) {
+      copy_range(first, last, [&](int64_t dst_offset, int64_t src_offset) {
+        memcpy(dst_base + dst_offset, src_base + src_offset, narrow<size_t>(block_size));
+      });
+    });
+  }
 
   return Status::OK();
 }
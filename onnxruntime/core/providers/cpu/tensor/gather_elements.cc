@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <atomic>
 #include <string>
 #include "gather_elements.h"
 #include "onnxruntime_config.h"
@@ -68,15 +69,22 @@ static inline size_t CalculateOffset(size_t inner_dim, const TensorPitches& inpu
   return base_offset;
 }
 
+// Returns true if every index of the row is within [-axis_size, axis_size). The whole row is checked before any
+// element is copied, which keeps the bounds checks out of the copy loops.
 template <typename T>
-ORT_FORCEINLINE int64_t GetIndex(size_t i, const T* indices, int64_t axis_size) {
-  int64_t index = indices[i];
-  if (index < 0)  // Handle negative indices
-    index += axis_size;
-  if (std::make_unsigned_t<T>(index) >= std::make_unsigned_t<T>(axis_size))
-    ORT_THROW("Index out of range");
-  return index;
-};
+ORT_FORCEINLINE bool IndicesInRange(const T* indices, size_t count, int64_t axis_size) {
+  bool in_range = true;
+  for (size_t i = 0; i < count; i++) {
+    const int64_t index = indices[i];
+    in_range &= (index >= -axis_size) & (index < axis_size);
+  }
+  return in_range;
+}
+
+template <typename T>
+ORT_FORCEINLINE int64_t NormalizeIndex(T index, int64_t axis_size) {
+  return index < 0 ? index + axis_size : index;
+}
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -106,25 +114,25 @@ static void core_impl(const Tensor* input_tensor, const Tensor* indices_tensor,
   int64_t axis_size = input_tensor->Shape()[onnxruntime::narrow<size_t>(axis)];
 
   bool innermost_axis = axis == input_rank - 1;
-  bool index_error = false;
+  std::atomic<bool> index_error{false};
 
   auto MainLoop = [&](auto* output_data, auto* input_data) {
     auto BatchWork = [&](size_t inner_dim) {
-      ORT_TRY {
-        auto output = output_data + inner_dim_size * inner_dim;
-        auto input = input_data + CalculateOffset(inner_dim, input_shape_pitches, onnxruntime::narrow<size_t>(axis), indices_shape);
-        auto indices = indices_data + inner_dim_size * inner_dim;
-
-        if (innermost_axis) {
-          for (size_t i = 0; i < inner_dim_size; i++)
-            output[i] = input[GetIndex(i, indices, axis_size)];
-        } else {
-          for (size_t i = 0; i < inner_dim_size; i++)
-            output[i] = input[GetIndex(i, indices, axis_size) * axis_pitch + i];
-        }
-      }
-      ORT_CATCH(const std::exception&) {
+      auto output = output_data + inner_dim_size * inner_dim;
+      auto input = input_data + CalculateOffset(inner_dim, input_shape_pitches, onnxruntime::narrow<size_t>(axis), indices_shape);
+      auto indices = indices_data + inner_dim_size * inner_dim;
+
+      if (!IndicesInRange(indices, inner_dim_size, axis_size)) {
         index_error = true;
+        return;
+      }
+
+      if (innermost_axis) {
+        for (size_t i = 0; i < inner_dim_size; i++)
+          output[i] = input[NormalizeIndex(indices[i], axis_size)];
+      } else {
+        for (size_t i = 0; i < inner_dim_size; i++)
+          output[i] = input[NormalizeIndex(indices[i], axis_size) * axis_pitch + i];
       }
     };
 
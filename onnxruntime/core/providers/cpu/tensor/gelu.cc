@@ -105,4 +105,82 @@ Status Gelu<T>::Compute(OpKernelContext* context) const {
   return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported approximation_algorithm: ", approximation_algorithm_);
 }
 
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+// The fp16 tensors are read and written once, each chunk is computed in fp32 in a buffer that stays in the cache.
+template <>
+Status Gelu<MLFloat16>::Compute(OpKernelContext* context) const {
+  const bool use_tanh = approximation_algorithm_ == "tanh";
+  if (!use_tanh && approximation_algorithm_ != "none") {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported approximation_algorithm: ",
+                           approximation_algorithm_);
+  }
+
+  const Tensor* input = context->Input<Tensor>(0);
+  const MLFloat16* input_data = input->Data<MLFloat16>();
+
+  Tensor* output = context->Output(0, input->Shape());
+  MLFloat16* output_data = output->MutableData<MLFloat16>();
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  int64_t elem_count = input->Shape().Size();
+  constexpr int64_t length_per_task = 4096;
+  int64_t task_count = (elem_count + length_per_task - 1) / length_per_task;
+
+  static constexpr float B = 0.7978845608028654f;    // sqrt(2.0 / M_PI)
+  static constexpr float C = 0.035677408136300125f;  // 0.044715 * sqrt(2.0 / M_PI)
+
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, static_cast<int32_t>(task_count),
+      [&](ptrdiff_t task_idx) {
+        const auto start = task_idx * length_per_task;
+        const size_t count = narrow<size_t>(std::min(length_per_task, elem_count - start));
+        float x[length_per_task];
+        float y[length_per_task];
+
+        MlasConvertHalfToFloatBuffer(input_data + start, x, count);
+
+        if (use_tanh) {
+          for (size_t i = 0; i < count; i++) {
+            y[i] = x[i] * (C * x[i] * x[i] + B);
+          }
+          MlasComputeTanh(y, y, count);
+        } else {
+          for (size_t i = 0; i < count; i++) {
+            y[i] = x[i] * static_cast<float>(M_SQRT1_2);
+          }
+          MlasComputeErf(y, y, count);
+        }
+
+        for (size_t i = 0; i < count; i++) {
+          y[i] = 0.5f * x[i] * (y[i] + 1.0f);
+        }
+
+        MlasConvertFloatToHalfBuffer(y, output_data + start, count);
+      },
+      0);
+  return Status::OK();
+}
+
+// registered by RegisterFp16Kernels when the CPU has fp16 arithmetic
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Gelu,
+    20,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gelu<MLFloat16>);
+
+#ifndef DISABLE_CONTRIB_OPS
+namespace contrib {
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    Gelu,
+    kMSDomain,
+    1,
+    MLFloat16,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gelu<MLFloat16>);
+}
+#endif
+#endif  // MLAS_F16VEC_INTRINSICS_SUPPORTED
+
 }  // namespace onnxruntime
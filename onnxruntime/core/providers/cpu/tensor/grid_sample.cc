@@ -102,23 +102,85 @@ T GsBicubicInterpolate(T p[4][4], T x, T y) {
   return static_cast<T>(coeffs[0] * v[0] + coeffs[1] * v[1] + coeffs[2] * v[2] + coeffs[3] * v[3]);
 }
 
+// Returns the offset of the pixel at (r, c) after applying the padding mode, or -1 if the pixel is padding of zeros.
 template <typename T>
-T GridSample<T>::PixelAtGrid(const T* image, int64_t r, int64_t c, int64_t H, int64_t W, T border[/* 4 */]) const {
-  T pixel = {};  // default 0
+int64_t GridSample<T>::PixelOffset(int64_t r, int64_t c, int64_t H, int64_t W, const T border[/* 4 */]) const {
   if (padding_mode_ == Zeros) {
     if (c >= 0 && c < W && r >= 0 && r < H) {
-      pixel = image[r * W + c];
+      return r * W + c;
     }
+    return -1;
   } else if (padding_mode_ == Border) {
     c = std::clamp<int64_t>(c, 0, W - 1);
     r = std::clamp<int64_t>(r, 0, H - 1);
-    pixel = image[r * W + c];
   } else {  // (padding_mode_ == Reflection)
     c = static_cast<int64_t>(GsReflect(static_cast<T>(c), border[0], border[2]));
     r = static_cast<int64_t>(GsReflect(static_cast<T>(r), border[1], border[3]));
-    pixel = image[r * W + c];
   }
-  return pixel;
+  return r * W + c;
+}
+
+template <typename T>
+T GridSample<T>::PixelAtGrid(const T* image, int64_t r, int64_t c, int64_t H, int64_t W, T border[/* 4 */]) const {
+  const int64_t offset = PixelOffset(r, c, H, W, border);
+  return offset >= 0 ? image[offset] : T{};
+}
+
+// Compute the neighbors and the weights of one row of output pixels. The padding mode is resolved here, so that
+// sampling the channels is a branch free gather of one (nearest) or four (linear) pixels.
+template <typename T>
+void GridSample<T>::PrepareSamplePoints(const T* grid_row, int64_t W_out, int64_t H_in, int64_t W_in,
+                                        const T border[/* 4 */], SamplePoint* points) const {
+  for (int64_t ox = 0; ox < W_out; ox++) {
+    const T* gridpoint = grid_row + ox * 2;
+    auto x = GsDenormalize<T>(gridpoint[0], W_in, align_corners_);  // actual location
+    auto y = GsDenormalize<T>(gridpoint[1], H_in, align_corners_);
+    SamplePoint& point = points[ox];
+
+    if (mode_ == Nearest) {
+      // x, y are integers in all padding modes
+      point.pos1 = PixelOffset(static_cast<int64_t>(std::nearbyint(y)), static_cast<int64_t>(std::nearbyint(x)),
+                               H_in, W_in, border);
+      continue;
+    }
+
+    int64_t x1 = static_cast<int64_t>(std::floor(x));
+    int64_t y1 = static_cast<int64_t>(std::floor(y));
+    int64_t x2 = x1 + 1;
+    int64_t y2 = y1 + 1;
+
+    T dx2 = static_cast<T>(x2) - x;
+    T dx1 = x - static_cast<T>(x1);
+    T dy2 = static_cast<T>(y2) - y;
+    T dy1 = y - static_cast<T>(y1);
+
+    point.pos1 = PixelOffset(y1, x1, H_in, W_in, border);
+    point.pos2 = PixelOffset(y1, x2, H_in, W_in, border);
+    point.pos3 = PixelOffset(y2, x1, H_in, W_in, border);
+    point.pos4 = PixelOffset(y2, x2, H_in, W_in, border);
+    point.w1 = dy2 * dx2;
+    point.w2 = dy2 * dx1;
+    point.w3 = dy1 * dx2;
+    point.w4 = dy1 * dx1;
+
+    // Padding of zeros contributes nothing, so point at any pixel with a zero weight.
+    if (point.pos1 < 0) {
+      point.pos1 = 0;
+      point.w1 = 0;
+    }
+    if (point.pos2 < 0) {
+      point.pos2 = 0;
+      point.w2 = 0;
+    }
+    if (point.pos3 < 0) {
+      point.pos3 = 0;
+      point.w3 = 0;
+    }
+    if (point.pos4 < 0) {
+      point.pos4 = 0;
+      point.w4 = 0;
+    }
+  }
 }
 
 template <typename T>
@@ -203,46 +265,36 @@ Status GridSample<T>::Compute(OpKernelContext* context) const {
     }
     T border[] = {x_min, y_min, x_max, y_max};  // l-t-r-b
 
-    concurrency::ThreadPool* tp = H_out * W_out > 64 ? context->GetOperatorThreadPool() : nullptr;
-    for (int64_t n = 0; n < N; n++) {
-      const T* grid_data = grid->Data<T>() + n * (H_out * W_out) * 2;
-      concurrency::ThreadPool::TrySimpleParallelFor(
-          tp, onnxruntime::narrow<std::ptrdiff_t>(C),
-          [&](std::ptrdiff_t c) {
-            const T* X_data = input->Data<T>() + (n * C + c) * (H_in * W_in);
-            T* Y_data = Y.MutableData<T>() + (n * C + c) * (H_out * W_out);
-
-            for (int64_t oy = 0; oy < H_out; oy++) {
-              for (int64_t ox = 0; ox < W_out; ox++) {
-                const T* gridpoint = grid_data + (oy * W_out + ox) * 2;
-                T* Y_gridpoint = Y_data + oy * W_out + ox;
-                auto nx = gridpoint[0];  // normalized location
-                auto ny = gridpoint[1];
-                auto x = GsDenormalize<T>(nx, W_in, align_corners_);  // actual location
-                auto y = GsDenormalize<T>(ny, H_in, align_corners_);
-
-                if (mode_ == Nearest) {
-                  x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
-                  y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
-                  // x, y are integers in all padding modes
-                  *Y_gridpoint = PixelAtGrid(X_data, static_cast<int64_t>(y), static_cast<int64_t>(x), H_in, W_in, border);
-                } else if (mode_ == Linear) {
-                  int64_t x1 = static_cast<int64_t>(std::floor(x));
-                  int64_t y1 = static_cast<int64_t>(std::floor(y));
-                  int64_t x2 = x1 + 1;
-                  int64_t y2 = y1 + 1;
-
-                  T p11 = PixelAtGrid(X_data, y1, x1, H_in, W_in, border);
-                  T p12 = PixelAtGrid(X_data, y1, x2, H_in, W_in, border);
-                  T p21 = PixelAtGrid(X_data, y2, x1, H_in, W_in, border);
-                  T p22 = PixelAtGrid(X_data, y2, x2, H_in, W_in, border);
-
-                  T dx2 = static_cast<T>(x2) - x;
-                  T dx1 = x - static_cast<T>(x1);
-                  T dy2 = static_cast<T>(y2) - y;
-                  T dy1 = y - static_cast<T>(y1);
-                  *Y_gridpoint = dy2 * (dx2 * p11 + dx1 * p12) + dy1 * (dx2 * p21 + dx1 * p22);
-                } else if (mode_ == Cubic) {
+    const T* input_data = input->Data<T>();
+    const T* grid_data = grid->Data<T>();
+    T* output_data = Y.MutableData<T>();
+    const int64_t input_image_size = H_in * W_in;
+    const int64_t output_image_size = H_out * W_out;
+
+    // Each task samples whole output rows of all the channels of an image. The grid is shared by the channels, so
+    // the neighbors and weights of a row are computed once and then applied to every channel.
+    const double cost = static_cast<double>(C * W_out * (mode_ == Cubic ? 64 : 8));
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), onnxruntime::narrow<std::ptrdiff_t>(N * H_out), cost,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          std::vector<SamplePoint> points(mode_ == Cubic ? 0 : onnxruntime::narrow<size_t>(W_out));
+
+          for (std::ptrdiff_t row = first; row < last; row++) {
+            const int64_t n = row / H_out;
+            const int64_t oy = row % H_out;
+            const T* grid_row = grid_data + (n * H_out + oy) * W_out * 2;
+            const T* X_image = input_data + n * C * input_image_size;
+            T* Y_row = output_data + n * C * output_image_size + oy * W_out;
+
+            if (mode_ == Cubic) {
+              for (int64_t c = 0; c < C; c++) {
+                const T* X_data = X_image + c * input_image_size;
+                T* Y_data = Y_row + c * output_image_size;
+
+                for (int64_t ox = 0; ox < W_out; ox++) {
+                  const T* gridpoint = grid_row + ox * 2;
+                  auto x = GsDenormalize<T>(gridpoint[0], W_in, align_corners_);  // actual location
+                  auto y = GsDenormalize<T>(gridpoint[1], H_in, align_corners_);
                   int64_t x0 = static_cast<int64_t>(std::floor(x)) - 1;  // top-left corner of the bbox
                   int64_t y0 = static_cast<int64_t>(std::floor(y)) - 1;
 
@@ -254,12 +306,34 @@ Status GridSample<T>::Compute(OpKernelContext* context) const {
                   }
                   T dx = static_cast<T>(x - x0 - 1);
                   T dy = static_cast<T>(y - y0 - 1);
-                  *Y_gridpoint = GsBicubicInterpolate(p, dx, dy);
+                  Y_data[ox] = GsBicubicInterpolate(p, dx, dy);
                 }
               }
+              continue;
             }
-          });
-    }
+
+            PrepareSamplePoints(grid_row, W_out, H_in, W_in, border, points.data());
+            const SamplePoint* row_points = points.data();
+
+            for (int64_t c = 0; c < C; c++) {
+              const T* X_data = X_image + c * input_image_size;
+              T* Y_data = Y_row + c * output_image_size;
+
+              if (mode_ == Nearest) {
+                for (int64_t ox = 0; ox < W_out; ox++) {
+                  const int64_t pos = row_points[ox].pos1;
+                  Y_data[ox] = pos >= 0 ? X_data[pos] : T{};
+                }
+              } else {
+                for (int64_t ox = 0; ox < W_out; ox++) {
+                  const SamplePoint& point = row_points[ox];
+                  Y_data[ox] = point.w1 * X_data[point.pos1] + point.w2 * X_data[point.pos2] +
+                               point.w3 * X_data[point.pos3] + point.w4 * X_data[point.pos4];
+                }
+              }
+            }
+          }
+        });
   } else if (data_dims == 3) {
     // sample 3d;
     auto D_in = input_dims[2];
@@ -68,6 +68,23 @@ class GridSample final : public OpKernel {
     Reflection
   };
 
+  // Offsets and weights of the neighbors that produce one output pixel of the 2-D linear and nearest modes. They are
+  // shared by all the channels, with the padding mode already applied: a neighbor outside of the image in zeros
+  // padding mode has a zero weight (and offset -1 in nearest mode).
+  struct SamplePoint {
+    int64_t pos1;
+    int64_t pos2;
+    int64_t pos3;
+    int64_t pos4;
+    T w1;
+    T w2;
+    T w3;
+    T w4;
+  };
+
+  int64_t PixelOffset(int64_t r, int64_t c, int64_t H, int64_t W, const T border[/* 4 */]) const;
+  void PrepareSamplePoints(const T* grid_row, int64_t W_out, int64_t H_in, int64_t W_in, const T border[/* 4 */],
+                           SamplePoint* points) const;
   T PixelAtGrid(const T* image, int64_t r, int64_t c, int64_t H, int64_t W, T border[/* 4 */]) const;
   T PixelAtGrid3D(const T* image, int64_t d, int64_t h, int64_t w, int64_t D, int64_t H, int64_t W, T border[/* 6 */]) const;
 
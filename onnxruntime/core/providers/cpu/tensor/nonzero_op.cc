@@ -4,9 +4,9 @@
 #include "core/providers/cpu/tensor/nonzero_op.h"
 
 #include <cassert>
-#include <vector>
-#include <core/common/safeint.h>
-#include "core/util/math_cpuonly.h"
+
+#include "core/common/narrow.h"
+#include "core/providers/cpu/tensor/parallel_compaction.h"
 
 namespace onnxruntime {
 // kernel builder functions
@@ -59,25 +59,55 @@ Status NonZero<T>::Compute(OpKernelContext* context) const {
   const auto& X_shape = X->Shape();
   assert(X_shape.Size() >= 0);
 
-  const Eigen::Index coordinate_size = X_shape.IsScalar() ? 1 : onnxruntime::narrow<Eigen::Index>(X_shape.NumDimensions());
-  std::vector<int64_t> non_zero_indices_buffer{};
-  // reserve enough space for indices for every element of X
-  non_zero_indices_buffer.reserve(SafeInt<size_t>(X_shape.Size()) * coordinate_size);
-
+  const size_t coordinate_size = X_shape.IsScalar() ? 1 : X_shape.NumDimensions();
   const T* data = X->Data<T>();
 
+  // count the non-zero values of blocks of X in parallel, then write the coordinates of each block directly into
+  // the rows of the output
+  ParallelCompaction compaction(
+      context->GetOperatorThreadPool(), onnxruntime::narrow<size_t>(X_shape.Size()),
+      [data](size_t begin, size_t end) {
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) {
+          count += data[i] != T{} ? 1 : 0;
+        }
+        return count;
+      });
+
+  const size_t num_non_zero_values = compaction.Count();
+  Tensor* const Y = context->Output(0, {static_cast<int64_t>(coordinate_size),
+                                        static_cast<int64_t>(num_non_zero_values)});
+  ORT_ENFORCE(Y, "failed to get first output!");
+  int64_t* y_data = Y->MutableData<int64_t>();
+
   if (X_shape.IsScalar()) {
-    const T& value = *data;
-    if (value != T{}) {
-      non_zero_indices_buffer.push_back(0);
+    if (num_non_zero_values != 0) {
+      *y_data = 0;
+    }
+    return Status::OK();
+  }
+
+  compaction.Scatter([&](size_t begin, size_t end, size_t output_index) {
+    // coordinate of the first entry of the block
+    TensorShapeVector coordinate(coordinate_size, 0);
+    size_t remainder = begin;
+    for (size_t idx = coordinate_size; idx-- > 0;) {
+      const size_t dim = static_cast<size_t>(X_shape[idx]);
+      coordinate[idx] = static_cast<int64_t>(remainder % dim);
+      remainder /= dim;
     }
-  } else {
-    std::vector<int64_t> coordinate(coordinate_size, 0);
 
-    // as we iterate the entries, increment the coordinate for the current entry
-    // e.g. if shape is {2,2}, we start with 0,0 increment to 0,1 increment to 1,0 and finally 1,1
-    auto increment_coordinate = [&coordinate, &coordinate_size, &X_shape]() {
-      for (Eigen::Index idx = coordinate_size - 1; idx >= 0; --idx) {
+    for (size_t i = begin; i < end; ++i) {
+      if (data[i] != T{}) {
+        for (size_t idx = 0; idx < coordinate_size; ++idx) {
+          y_data[idx * num_non_zero_values + output_index] = coordinate[idx];
+        }
+        ++output_index;
+      }
+
+      // as we iterate the entries, increment the coordinate for the current entry
+      // e.g. if shape is {2,2}, we start with 0,0 increment to 0,1 increment to 1,0 and finally 1,1
+      for (size_t idx = coordinate_size; idx-- > 0;) {
         int64_t& cur_coord = coordinate[idx];
         if (cur_coord != X_shape[idx] - 1) {
           ++cur_coord;
@@ -85,33 +115,8 @@ Status NonZero<T>::Compute(OpKernelContext* context) const {
         }
         cur_coord = 0;
       }
-    };
-
-    for (size_t i = 0, end = onnxruntime::narrow<size_t>(X_shape.Size()); i < end; ++i) {
-      const T& value = *data++;
-      if (value != T{}) {
-        non_zero_indices_buffer.insert(non_zero_indices_buffer.end(),
-                                       coordinate.begin(), coordinate.end());
-      }
-
-      increment_coordinate();
     }
-  }
-
-  const Eigen::Index num_non_zero_values = onnxruntime::narrow<Eigen::Index>(non_zero_indices_buffer.size()) / coordinate_size;
-
-  // transpose result for output
-  ConstEigenMatrixMapRowMajor<int64_t> non_zero_indices_matrix{
-      non_zero_indices_buffer.data(),
-      num_non_zero_values, coordinate_size};
-
-  Tensor* const Y = context->Output(0, {coordinate_size, num_non_zero_values});
-  ORT_ENFORCE(Y, "failed to get first output!");
-
-  EigenMatrixMapRowMajor<int64_t> y_matrix{
-      Y->MutableData<int64_t>(),
-      coordinate_size, num_non_zero_values};
-  y_matrix = non_zero_indices_matrix.transpose();
+  });
 
   return Status::OK();
 }
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+// Two pass parallel stream compaction of the range [0, length), used by the operators whose output keeps the selected
+// elements of their input (NonZero, Compress).
+//
+// The range is split into blocks. The first pass counts the selected elements of every block in parallel, and an
+// exclusive prefix sum of these counts gives the position of the first output of every block. After the caller has
+// allocated the output from Count(), the second pass writes the outputs of every block in parallel.
+class ParallelCompaction {
+ public:
+  template <typename CountFn>
+  ParallelCompaction(concurrency::ThreadPool* tp, size_t length, CountFn&& count_selected)
+      : tp_(tp), length_(length) {
+    // Blocks are large enough to amortize the scheduling, and numerous enough to balance the threads.
+    constexpr size_t kMinBlockSize = 16384;
+    const size_t num_threads = static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(tp));
+    block_size_ = std::max(kMinBlockSize, (length + num_threads * 4 - 1) / (num_threads * 4));
+    const size_t num_blocks = length == 0 ? 0 : (length + block_size_ - 1) / block_size_;
+
+    block_offsets_.resize(num_blocks + 1, 0);
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        tp_, narrow<std::ptrdiff_t>(num_blocks),
+        [&](std::ptrdiff_t block) {
+          const size_t begin = static_cast<size_t>(block) * block_size_;
+          const size_t end = std::min(begin + block_size_, length_);
+          block_offsets_[static_cast<size_t>(block) + 1] = count_selected(begin, end);
+        });
+
+    for (size_t block = 0; block < num_blocks; block++) {
+      block_offsets_[block + 1] += block_offsets_[block];
+    }
+  }
+
+  // Number of the selected elements.
+  size_t Count() const {
+    return block_offsets_.back();
+  }
+
+  // Calls scatter(begin, end, output_index) for every block [begin, end) of the range, where output_index is the number
+  // of the selected elements before begin.
+  template <typename ScatterFn>
+  void Scatter(ScatterFn&& scatter) const {
+    const size_t num_blocks = block_offsets_.size() - 1;
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        tp_, narrow<std::ptrdiff_t>(num_blocks),
+        [&](std::ptrdiff_t block) {
+          const size_t begin = static_cast<size_t>(block) * block_size_;
+          const size_t end = std::min(begin + block_size_, length_);
+          if (block_offsets_[static_cast<size_t>(block) + 1] != block_offsets_[static_cast<size_t>(block)]) {
+            scatter(begin, end, block_offsets_[static_cast<size_t>(block)]);
+          }
+        });
+  }
+
+ private:
+  concurrency::ThreadPool* tp_;
+  size_t length_;
+  size_t block_size_;
+  std::vector<size_t> block_offsets_;
+};
+
+}  // namespace onnxruntime
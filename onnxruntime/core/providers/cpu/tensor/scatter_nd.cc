@@ -3,6 +3,9 @@
 
 #include "core/providers/cpu/tensor/scatter_nd.h"
 
+#include <algorithm>
+#include <numeric>
+
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/platform/threadpool.h"
@@ -113,11 +116,13 @@ struct Prepare {
   const TData* input_base;
   TData* output_base;
   uint64_t element_to_copy;
+  uint64_t slice_count;
   std::vector<uint64_t> element_offsets;
 
   Prepare() : input_base(nullptr),
               output_base(nullptr),
               element_to_copy(0),
+              slice_count(0),
               element_offsets(0) {}
 };  // struct Prepare
 
@@ -161,6 +166,7 @@ Status PrepareForCompute(OpKernelContext* context, Prepare<TData>& p) {
   }
 
   p.element_to_copy = input_shape.SizeFromDimension(onnxruntime::narrow<size_t>(last_indice_dimension));
+  p.slice_count = input_shape.SizeToDimension(onnxruntime::narrow<size_t>(last_indice_dimension));
   const int64_t* indice_offset = indice_tensor->Data<int64_t>();
   auto offset_count = indice_shape.Size() / last_indice_dimension;  // Times to copy
   p.element_offsets.assign(onnxruntime::narrow<size_t>(offset_count), 0LL);
@@ -350,59 +356,102 @@ struct Func_Max_ND<BFloat16> {
   }
 };
 
+// Returns true if several updates write the same slice of the output.
+template <typename TData>
+bool HasDuplicateOffsets(const Prepare<TData>& p) {
+  std::vector<bool> written(onnxruntime::narrow<size_t>(p.slice_count), false);
+  for (uint64_t offset : p.element_offsets) {
+    const size_t slice = onnxruntime::narrow<size_t>(offset / p.element_to_copy);
+    if (written[slice]) {
+      return true;
+    }
+    written[slice] = true;
+  }
+  return false;
+}
+
+template <typename TData, typename TFunc>
+void ScatterNDApply(const Prepare<TData>& p, concurrency::ThreadPool* tp) {
+  const TFunc func{};
+  const size_t update_count = p.element_offsets.size();
+  auto apply = [&](size_t i) {
+    func(p.output_base + p.element_offsets[i], p.input_base + i * p.element_to_copy, p.element_to_copy);
+  };
+
+  if (concurrency::ThreadPool::DegreeOfParallelism(tp) == 1 || update_count < 2) {
+    for (size_t i = 0; i < update_count; ++i) {
+      apply(i);
+    }
+    return;
+  }
+
+  if (!HasDuplicateOffsets(p)) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, update_count, static_cast<double>(p.element_to_copy),
+        [&apply](ptrdiff_t first, ptrdiff_t last) {
+          for (ptrdiff_t i = first; i < last; ++i) {
+            apply(static_cast<size_t>(i));
+          }
+        });
+    return;
+  }
+
+  // Partition the updates by destination slice, so that the updates of a slice are applied by a single task in
+  // their original order and the tasks never write the same output elements.
+  std::vector<size_t> order(update_count);
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::stable_sort(order.begin(), order.end(), [&p](size_t lhs, size_t rhs) {
+    return p.element_offsets[lhs] < p.element_offsets[rhs];
+  });
+
+  std::vector<size_t> group_starts;
+  for (size_t k = 0; k < update_count; ++k) {
+    if (k == 0 || p.element_offsets[order[k]] != p.element_offsets[order[k - 1]]) {
+      group_starts.push_back(k);
+    }
+  }
+  const size_t group_count = group_starts.size();
+  group_starts.push_back(update_count);
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, group_count, static_cast<double>(p.element_to_copy * update_count / group_count),
+      [&](ptrdiff_t first, ptrdiff_t last) {
+        for (size_t group = static_cast<size_t>(first), end = static_cast<size_t>(last); group < end; ++group) {
+          for (size_t k = group_starts[group]; k < group_starts[group + 1]; ++k) {
+            apply(order[k]);
+          }
+        }
+      });
+}
+
 template <typename TData>
 struct ScatterNDDispatchTarget {
   Status operator()(OpKernelContext* context, concurrency::ThreadPool* tp, ScatterND::Reduction reduction) const {
     Prepare<TData> prepare;
     ORT_RETURN_IF_ERROR(PrepareForCompute(context, prepare));
 
-    auto lambda = [&](int64_t i) {
-      switch (reduction) {
-        case ScatterND::Reduction::Add: {
-          auto func = Func_Add_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        case ScatterND::Reduction::Mul: {
-          auto func = Func_Mul_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        case ScatterND::Reduction::Min: {
-          auto func = Func_Min_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        case ScatterND::Reduction::Max: {
-          auto func = Func_Max_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        default:
-        case ScatterND::Reduction::None: {
-          auto func = Func_Copy_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-      }
-    };
-    concurrency::ThreadPool::TryParallelFor(
-        tp, prepare.element_offsets.size(), static_cast<double>(prepare.element_to_copy),
-        [&lambda](ptrdiff_t first, ptrdiff_t last) {
-          for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
-            lambda(i);
-          }
-        });
+    if (prepare.element_to_copy == 0) {
+      return Status::OK();
+    }
+
+    switch (reduction) {
+      case ScatterND::Reduction::Add:
+        ScatterNDApply<TData, Func_Add_ND<TData>>(prepare, tp);
+        break;
+      case ScatterND::Reduction::Mul:
+        ScatterNDApply<TData, Func_Mul_ND<TData>>(prepare, tp);
+        break;
+      case ScatterND::Reduction::Min:
+        ScatterNDApply<TData, Func_Min_ND<TData>>(prepare, tp);
+        break;
+      case ScatterND::Reduction::Max:
+        ScatterNDApply<TData, Func_Max_ND<TData>>(prepare, tp);
+        break;
+      default:
+      case ScatterND::Reduction::None:
+        ScatterNDApply<TData, Func_Copy_ND<TData>>(prepare, tp);
+        break;
+    }
     return Status::OK();
   }
 };
@@ -39,16 +39,22 @@ using EnabledIndicesTypes = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST_ALL_OPSETS(kCpuE
                                                                            Slice, Input, 1);
 }  // namespace
 
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_SLICE_KERNEL_DEF KernelDefBuilder().MayStridedOutput(0, 0)
+#else
+#define CREATE_SLICE_KERNEL_DEF KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     1, 9,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
+    CREATE_SLICE_KERNEL_DEF.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
     Slice1);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     10, 10,
-    KernelDefBuilder()
+    CREATE_SLICE_KERNEL_DEF
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
         .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
     Slice10);
@@ -57,7 +63,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     11,
     12,
-    KernelDefBuilder()
+    CREATE_SLICE_KERNEL_DEF
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
         .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
     Slice10);
@@ -65,7 +71,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
 ONNX_CPU_OPERATOR_KERNEL(
     Slice,
     13,
-    KernelDefBuilder()
+    CREATE_SLICE_KERNEL_DEF
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
         .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
     Slice10);
@@ -226,6 +232,60 @@ Status SliceBase::FillVectorsFromInput(const Tensor& start_tensor,
   return Status::OK();
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+// Describes the output as a view of the input. Returns false if that needs negative strides.
+static bool SetSliceOutputStrides(const Tensor& input_tensor,
+                                  const SliceOp::PrepareForComputeMetadata& compute_metadata,
+                                  Tensor& output_tensor) {
+  // starts_ and steps_ are relative to the coalesced dims if any were coalesced
+  const auto input_dims = compute_metadata.p_flattened_input_dims_
+                              ? gsl::make_span(compute_metadata.flattened_input_dims_)
+                              : compute_metadata.input_dimensions_;
+  const auto output_dims = compute_metadata.p_flattened_output_dims_
+                               ? gsl::make_span(compute_metadata.flattened_output_dims_)
+                               : gsl::make_span(compute_metadata.output_dims_);
+  const TensorPitches input_pitches(input_dims);
+
+  int64_t offset = 0;
+  TensorShapeVector strides(input_dims.size());
+  for (size_t i = 0; i < input_dims.size(); ++i) {
+    if (compute_metadata.steps_[i] <= 0) {
+      return false;
+    }
+
+    offset += compute_metadata.starts_[i] * input_pitches[i];
+    strides[i] = compute_metadata.steps_[i] * input_pitches[i];
+  }
+
+  // a coalesced dim covers consecutive dims of the output with contiguous elements. dims of size 1 can have any stride.
+  const auto& full_output_dims = compute_metadata.output_dims_;
+  TensorShapeVector output_strides(full_output_dims.size());
+  size_t dim = output_dims.size();
+  int64_t remaining = 1;
+  int64_t stride = 1;
+  for (size_t i = full_output_dims.size(); i > 0; --i) {
+    const int64_t output_dim = full_output_dims[i - 1];
+    if (output_dim != 1) {
+      while (remaining == 1) {
+        --dim;
+        remaining = output_dims[dim];
+        stride = strides[dim];
+      }
+
+      remaining /= output_dim;
+    }
+
+    output_strides[i - 1] = stride;
+    stride *= output_dim;
+  }
+
+  output_tensor.SetByteOffset(output_tensor.ByteOffset() +
+                              SafeInt<ptrdiff_t>(offset) * input_tensor.DataType()->Size());
+  output_tensor.SetShapeAndStrides(output_tensor.Shape(), output_strides);
+  return true;
+}
+#endif
+
 template <typename T>
 static Status SliceImpl(OpKernelContext* ctx,
                         const Tensor& input_tensor,
@@ -306,6 +366,22 @@ Status SliceBase::Compute(OpKernelContext* ctx) const {
     ORT_RETURN_IF_ERROR(PrepareForCompute(attr_starts_, attr_ends_, attr_axes_, compute_metadata));
   }
 
+#ifdef ENABLE_STRIDED_TENSORS
+  // the planner made the output share the buffer of the input as all its consumers accept strided inputs.
+  // describe the output as a view of the input.
+  auto& output_tensor = *ctx->Output(0, TensorShape(compute_metadata.output_dims_));
+  if (output_tensor.DataRaw() == input_tensor.DataRaw() && output_tensor.Shape().Size() > 0) {
+    if (!input_tensor.IsDataTypeString() && !input_tensor.DataType()->AsPrimitiveDataType()->HasSubElems() &&
+        SetSliceOutputStrides(input_tensor, compute_metadata, output_tensor)) {
+      return Status::OK();
+    }
+
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+    DetachStridedOutput(output_tensor, std::move(alloc));
+  }
+#endif
+
   Status status = Status::OK();
 
   bool supported = false;
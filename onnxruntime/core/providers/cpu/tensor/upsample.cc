@@ -35,6 +35,10 @@ REGISTER_VERSIONED_TYPED_KERNEL(int32_t, 9, 9);
 REGISTER_VERSIONED_TYPED_KERNEL(int8_t, 9, 9);
 REGISTER_VERSIONED_TYPED_KERNEL(uint8_t, 9, 9);
 
+// Resizes of at most this many output elements, counted per image plane or per image depending on the mode, run on
+// the calling thread, as spreading so little work over the operator thread pool costs more than it saves.
+static constexpr int64_t kMaxSingleThreadedOutputSize = 64;
+
 void UpsampleBase::AdjustOutputSizeAsPolicy(TensorShapeVector& output_dims, gsl::span<const int64_t> input_dims,
                                             InlinedVector<float>& scales) const {
   // AspectRatioPolicy::STRETCH is default policy when opset < 18
@@ -918,49 +922,64 @@ std::array<float, CubicModeGridLength> GetCubicCoeffs(float s, float cubic_coeff
   return coeffs;
 }
 
-// Get the tensor data at the requested coordinate
-template <typename T>
-T GetDataForCoordinate(const T* Xdata,
-                       int64_t x, int64_t y,
-                       int64_t input_height, int64_t input_width) {
-  x = std::max(static_cast<int64_t>(0), std::min(x, input_width - 1));
-  y = std::max(static_cast<int64_t>(0), std::min(y, input_height - 1));
-  return Xdata[y * input_width + x];
-}
+// Precomputed cubic interpolation of one output coordinate along an axis: the 4 input indices of the grid
+// (clamped to the input) and their weights, already divided by the weight sum.
+struct CubicAxisCoeffs {
+  // set when use_extrapolation is set and the original coordinate is out of the dim range
+  bool extrapolate;
+  std::array<int64_t, CubicModeGridLength> index;
+  std::array<float, CubicModeGridLength> coeff;
+};
 
-// Computes cubic convolution interpolation in 1D
-template <typename T>
-float CubicInterpolation1D(const T* Xdata,
-                           int64_t x,
-                           int64_t y,
-                           int64_t input_height,
-                           int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
-                           float coeff_sum,
-                           std::unordered_map<int64_t, float>& cache) {
-  // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
-  // opportunity to cache the results for previously seen combinations.
-  // Check if the result is already available in the cache
-  auto grid_start_pos = (y)*input_width + (x - 1);
-  if (cache.find(grid_start_pos) != cache.end()) {
-    return cache[grid_start_pos];
-  }
+static std::vector<CubicAxisCoeffs> SetupCubicAxisCoeffs(int64_t input_size,
+                                                         int64_t output_size,
+                                                         float scale,
+                                                         float roi_start,
+                                                         float roi_end,
+                                                         float cubic_coeff_a,
+                                                         bool use_extrapolation,
+                                                         bool exclude_outside,
+                                                         const GetOriginalCoordinateFunc& get_original_coordinate) {
+  std::vector<CubicAxisCoeffs> axis_coeffs(narrow<size_t>(output_size));
+  for (int64_t o = 0; o < output_size; ++o) {
+    auto& p = axis_coeffs[narrow<size_t>(o)];
+    float in_o = scale == 1 ? static_cast<float>(o)
+                            : get_original_coordinate(static_cast<float>(o), scale,
+                                                      static_cast<float>(output_size),
+                                                      static_cast<float>(input_size),
+                                                      roi_start, roi_end);
+    p.extrapolate = use_extrapolation && (in_o < 0 || in_o > static_cast<float>(input_size - 1));
+
+    auto o_int = static_cast<int64_t>(std::floor(in_o));
+    auto coeffs = GetCubicCoeffs(static_cast<float>(in_o - o_int), cubic_coeff_a);
+    float coeff_sum = 1;
+    if (exclude_outside) {
+      // When true, the weight of sampling locations outside the grid will be set to 0
+      // and the weight will be renormalized so that their sum is 1.0
+      coeff_sum = 0;
+      for (int64_t i = 0, val = o_int - 1; val <= o_int + 2; val++, i++) {
+        if (val < 0 || val >= input_size) {
+          coeffs[narrow<size_t>(i)] = 0.0f;
+        }
+        coeff_sum += coeffs[narrow<size_t>(i)];
+      }
+    }
 
-  // get the neighbors in 1D and find interpolation for this dimension
-  // for 1D cubic interpolation 4 samples are used. 2 on the left and 2 on the right of x
-  float result = 0;
-  for (int i = 0, j = -1; i < static_cast<int>(CubicModeGridLength); i++, j++) {
-    auto orig_data = GetDataForCoordinate(Xdata, x + j, y, input_height, input_width);
-    result += coeff_array[narrow<size_t>(i)] / coeff_sum * orig_data;
+    for (int64_t i = 0, val = o_int - 1; val <= o_int + 2; val++, i++) {
+      p.index[narrow<size_t>(i)] = std::max(static_cast<int64_t>(0), std::min(val, input_size - 1));
+      p.coeff[narrow<size_t>(i)] = coeffs[narrow<size_t>(i)] / coeff_sum;
+    }
   }
-  cache[grid_start_pos] = result;
-
-  return result;
+  return axis_coeffs;
 }
+
 #if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable : 6001)
 #endif
+// Bicubic interpolation is separable, so each channel is resized in two passes: a horizontal pass that interpolates
+// the input rows referenced by the output to output_width, and a vertical pass that combines 4 of those rows for each
+// output row. Both passes use the per-axis tables above and are parallelized over rows.
 template <typename T>
 void ResizeBiCubic(int64_t batch_size,
                    int64_t num_channels,
@@ -977,133 +996,91 @@ void ResizeBiCubic(int64_t batch_size,
                    gsl::span<const float> roi,
                    const T* Xdata,
                    T* Ydata,
-                   const GetOriginalCoordinateFunc& get_original_coordinate) {
-  std::vector<float> y_original;
-  y_original.reserve(narrow<size_t>(output_height));
-
-  std::vector<float> x_original;
-  x_original.reserve(narrow<size_t>(output_width));
-
-  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
+                   const GetOriginalCoordinateFunc& get_original_coordinate,
+                   concurrency::ThreadPool* tp) {
   auto roi_y_start = roi.size() / 2 - 2;
   auto roi_y_end = roi.size() - 2;
   auto roi_x_start = roi.size() / 2 - 1;
   auto roi_x_end = roi.size() - 1;
 
-  // generate coefficients in y direction
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = height_scale == 1 ? static_cast<float>(y)
-                                   : get_original_coordinate(static_cast<float>(y), height_scale,
-                                                             static_cast<float>(output_height),
-                                                             static_cast<float>(input_height),
-                                                             roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    auto s = y_original[narrow<size_t>(y)] - std::floor(y_original[narrow<size_t>(y)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // generate coefficients in x direction
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = width_scale == 1 ? static_cast<float>(x)
-                                  : get_original_coordinate(static_cast<float>(x),
-                                                            width_scale,
-                                                            static_cast<float>(output_width),
-                                                            static_cast<float>(input_width),
-                                                            roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    auto s = x_original[narrow<size_t>(x)] - std::floor(x_original[narrow<size_t>(x)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
+  const auto y_coeffs = SetupCubicAxisCoeffs(input_height, output_height, height_scale,
+                                             roi[roi_y_start], roi[roi_y_end], cubic_coeff_a,
+                                             use_extrapolation, exclude_outside, get_original_coordinate);
+  const auto x_coeffs = SetupCubicAxisCoeffs(input_width, output_width, width_scale,
+                                             roi[roi_x_start], roi[roi_x_end], cubic_coeff_a,
+                                             use_extrapolation, exclude_outside, get_original_coordinate);
+
+  // only the input rows referenced by a non-extrapolated output row need the horizontal pass
+  std::vector<uint8_t> row_used(narrow<size_t>(input_height), 0);
+  for (const auto& p : y_coeffs) {
+    if (!p.extrapolate) {
+      for (auto in_y : p.index) {
+        row_used[narrow<size_t>(in_y)] = 1;
+      }
     }
   }
 
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
-
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        auto in_y = y_original[narrow<size_t>(y)];
-
-        // when use_extrapolation is set and original index is out of the dim range
-        // then use extrapolation_value as the output value.
-        if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
-          for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
-          }
-          continue;
-        }
-
-        auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
-        y_coeff_sum = 1;
-
-        if (exclude_outside) {
-          // When true, the weight of sampling locations outside the grid will be set to 0
-          // and the weight will be renormalized so that their sum is 1.0
-          y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
-          for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
-            y_coeff_holder[narrow<size_t>(i)] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[narrow<size_t>(i)];
-            y_coeff_sum += y_coeff_holder[narrow<size_t>(i)];
+  // result of the horizontal pass for one channel
+  std::vector<float> x_interpolated(narrow<size_t>(input_height * output_width));
+  float* const x_interp = x_interpolated.data();
+  const double cost_per_row = static_cast<double>(output_width * CubicModeGridLength * 2);
+
+  for (int64_t nc = 0; nc < batch_size * num_channels; ++nc) {
+    const T* const Xchannel = Xdata + nc * input_height * input_width;
+    T* const Ychannel = Ydata + nc * output_height * output_width;
+
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(input_height), cost_per_row,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t in_y = first; in_y < last; ++in_y) {
+            if (!row_used[narrow<size_t>(in_y)]) {
+              continue;
+            }
+            const T* Xrow = Xchannel + in_y * input_width;
+            float* interp_row = x_interp + in_y * output_width;
+            for (int64_t x = 0; x < output_width; ++x) {
+              const auto& px = x_coeffs[narrow<size_t>(x)];
+              float result = 0;
+              for (size_t i = 0; i < CubicModeGridLength; ++i) {
+                result += px.coeff[i] * Xrow[px.index[i]];
+              }
+              interp_row[x] = result;
+            }
           }
-        }
-
-        for (int64_t x = 0; x < output_width; ++x) {
-          auto in_x = x_original[narrow<size_t>(x)];
+        });
 
-          // when use_extrapolation is set and original index is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
-            continue;
-          }
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(output_height), cost_per_row,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t y = first; y < last; ++y) {
+            const auto& py = y_coeffs[narrow<size_t>(y)];
+            T* Yrow = Ychannel + y * output_width;
+
+            // when use_extrapolation is set and original index is out of the dim range
+            // then use extrapolation_value as the output value.
+            if (py.extrapolate) {
+              std::fill_n(Yrow, narrow<size_t>(output_width), static_cast<T>(extrapolation_value));
+              continue;
+            }
 
-          auto x_int = static_cast<int64_t>(std::floor(in_x));
-          auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
-          x_coeff_sum = 1;
-
-          if (exclude_outside) {
-            // When true, the weight of sampling locations outside the grid will be set to 0
-            // and the weight will be renormalized so that their sum is 1.0
-            x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
-            for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
-              x_coeff_holder[narrow<size_t>(i)] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[narrow<size_t>(i)];
-              x_coeff_sum += x_coeff_holder[narrow<size_t>(i)];
+            const float* rows[CubicModeGridLength];
+            for (size_t i = 0; i < CubicModeGridLength; ++i) {
+              rows[i] = x_interp + py.index[i] * output_width;
             }
-          }
 
-          // Compute cubic interpolation in x dimension using the x coefficients.
-          // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
-          auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
-          float result = 0;
-          for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
-                                                               input_height, input_width, coeff_x, x_coeff_sum,
-                                                               interpolation_result_cache);
-            result += x_interpolation_result * coeff_y[narrow<size_t>(i)] / y_coeff_sum;
+            for (int64_t x = 0; x < output_width; ++x) {
+              if (x_coeffs[narrow<size_t>(x)].extrapolate) {
+                Yrow[x] = static_cast<T>(extrapolation_value);
+                continue;
+              }
+              float result = 0;
+              for (size_t i = 0; i < CubicModeGridLength; ++i) {
+                result += rows[i][x] * py.coeff[i];
+              }
+              Yrow[x] = static_cast<T>(result);
+            }
           }
-
-          Ydata[y * output_width + x] = static_cast<T>(result);
-        }
-      }
-
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
-
-      // clear the cache when moving to the next channel
-      coeff_to_1Dinterpolation_map.clear();
-    }
+        });
   }
 }
 #if defined(_MSC_VER)
@@ -1216,13 +1193,17 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
             UpsampleBilinearAntiAlias(batch_size, num_channels, input_height, input_width, output_height, output_width,
                                       height_scale, width_scale, roi, use_extrapolation_, extrapolation_value_, exclude_outside_,
                                       X, Y->MutableData<T>(), alloc, get_original_coordinate_,
-                                      output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
+                                      output_height * output_width > kMaxSingleThreadedOutputSize
+                                          ? context->GetOperatorThreadPool()
+                                          : nullptr);
           } else {
             UpsampleBilinear(batch_size, num_channels, input_height, input_width, output_height, output_width,
                              height_scale, width_scale, roi,
                              use_extrapolation_, extrapolation_value_, X->Data<T>(),
                              Y->MutableData<T>(), alloc, get_original_coordinate_,
-                             output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
+                             output_height * output_width > kMaxSingleThreadedOutputSize
+                                 ? context->GetOperatorThreadPool()
+                                 : nullptr);
           }
         } else {
           if (use_extrapolation_) {
@@ -1230,7 +1211,9 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
               NhwcUpsampleBilinearAntiAlias(batch_size, num_channels, input_height, input_width, output_height, output_width,
                                             height_scale, width_scale, roi, use_extrapolation_, extrapolation_value_, exclude_outside_,
                                             X, Y->MutableData<T>(), alloc, get_original_coordinate_,
-                                            output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
+                                            output_height * output_width > kMaxSingleThreadedOutputSize
+                                                ? context->GetOperatorThreadPool()
+                                                : nullptr);
             } else {
               if (!is_2D &&
                   (Y->GetElementType() == ONNX_NAMESPACE::TensorProto_DataType_UINT8 ||
@@ -1239,13 +1222,17 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
                     batch_size, num_channels, input_height, input_width, output_height, output_width,
                     height_scale, width_scale, roi, extrapolation_value_, X->Data<T>(), Y->MutableData<T>(),
                     alloc, get_original_coordinate_,
-                    output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool() : nullptr);
+                    output_height * output_width * num_channels > kMaxSingleThreadedOutputSize
+                        ? context->GetOperatorThreadPool()
+                        : nullptr);
               } else {
                 NhwcUpsampleBilinear<T, true>(
                     batch_size, num_channels, input_height, input_width, output_height, output_width,
                     height_scale, width_scale, roi, extrapolation_value_, X->Data<T>(), Y->MutableData<T>(),
                     alloc, get_original_coordinate_,
-                    output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool() : nullptr);
+                    output_height * output_width * num_channels > kMaxSingleThreadedOutputSize
+                        ? context->GetOperatorThreadPool()
+                        : nullptr);
               }
             }
           } else {
@@ -1253,7 +1240,9 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
               NhwcUpsampleBilinearAntiAlias(batch_size, num_channels, input_height, input_width, output_height, output_width,
                                             height_scale, width_scale, roi, use_extrapolation_, extrapolation_value_, exclude_outside_,
                                             X, Y->MutableData<T>(), alloc, get_original_coordinate_,
-                                            output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
+                                            output_height * output_width > kMaxSingleThreadedOutputSize
+                                                ? context->GetOperatorThreadPool()
+                                                : nullptr);
             } else {
               if (!is_2D &&
                   (Y->GetElementType() == ONNX_NAMESPACE::TensorProto_DataType_UINT8 ||
@@ -1262,13 +1251,17 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
                     batch_size, num_channels, input_height, input_width, output_height, output_width,
                     height_scale, width_scale, roi, extrapolation_value_, X->Data<T>(), Y->MutableData<T>(),
                     alloc, get_original_coordinate_,
-                    output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool() : nullptr);
+                    output_height * output_width * num_channels > kMaxSingleThreadedOutputSize
+                        ? context->GetOperatorThreadPool()
+                        : nullptr);
               } else {
                 NhwcUpsampleBilinear<T, false>(
                     batch_size, num_channels, input_height, input_width, output_height, output_width,
                     height_scale, width_scale, roi, extrapolation_value_, X->Data<T>(), Y->MutableData<T>(),
                     alloc, get_original_coordinate_,
-                    output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool() : nullptr);
+                    output_height * output_width * num_channels > kMaxSingleThreadedOutputSize
+                        ? context->GetOperatorThreadPool()
+                        : nullptr);
               }
             }
           }
@@ -1294,14 +1287,18 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
                                      is_3D ? scales[0] : scales[2], is_3D ? scales[1] : scales[3],
                                      is_3D ? scales[2] : scales[4], roi, use_extrapolation_, extrapolation_value_,
                                      exclude_outside_, X, Y->MutableData<T>(), alloc, get_original_coordinate_,
-                                     output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
+                                     output_height * output_width > kMaxSingleThreadedOutputSize
+                                         ? context->GetOperatorThreadPool()
+                                         : nullptr);
         } else {
           UpsampleTrilinear(batch_size, num_channels, input_depth, input_height, input_width,
                             output_depth, output_height, output_width,
                             is_3D ? scales[0] : scales[2], is_3D ? scales[1] : scales[3],
                             is_3D ? scales[2] : scales[4], roi, use_extrapolation_, extrapolation_value_,
                             X->Data<T>(), Y->MutableData<T>(), alloc, get_original_coordinate_,
-                            output_height * output_width > 64 ? context->GetOperatorThreadPool() : nullptr);
+                            output_height * output_width > kMaxSingleThreadedOutputSize
+                                ? context->GetOperatorThreadPool()
+                                : nullptr);
         }
         return Status::OK();
       } else {
@@ -1340,19 +1337,26 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
                                      height_scale, width_scale, cubic_coeff_a_, use_extrapolation_,
                                      extrapolation_value_, exclude_outside_, roi, X,
                                      Y->MutableData<T>(), alloc, get_original_coordinate_,
-                                     output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool() : nullptr);
+                                     output_height * output_width * num_channels > kMaxSingleThreadedOutputSize
+                                         ? context->GetOperatorThreadPool()
+                                         : nullptr);
         } else {
           ResizeBiCubicAntiAlias(batch_size, num_channels, input_height, input_width, output_height, output_width,
                                  height_scale, width_scale, cubic_coeff_a_, use_extrapolation_,
                                  extrapolation_value_, exclude_outside_, roi, X,
                                  Y->MutableData<T>(), alloc, get_original_coordinate_,
-                                 output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool() : nullptr);
+                                 output_height * output_width * num_channels > kMaxSingleThreadedOutputSize
+                                     ? context->GetOperatorThreadPool()
+                                     : nullptr);
         }
       } else {
         ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
                       height_scale, width_scale, cubic_coeff_a_, use_extrapolation_,
                       extrapolation_value_, exclude_outside_, roi, X->Data<float>(),
-                      Y->MutableData<float>(), get_original_coordinate_);
+                      Y->MutableData<float>(), get_original_coordinate_,
+                      output_height * output_width * num_channels > kMaxSingleThreadedOutputSize
+                          ? context->GetOperatorThreadPool()
+                          : nullptr);
       }
       return Status::OK();
     }
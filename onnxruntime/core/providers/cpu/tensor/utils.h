@@ -457,6 +457,15 @@ inline void CopyCpuTensor(const Tensor* src, Tensor* tgt) {
   }
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+// The output of a kernel registered with MayStridedOutput shares the buffer of the input if all its consumers accept
+// strided inputs, and the kernel is expected to describe it as a view of the input with SetShapeAndStrides.
+// A kernel that can't, e.g. Slice with a negative step, calls this to give the output a buffer of its own.
+inline void DetachStridedOutput(Tensor& output, AllocatorPtr allocator) {
+  output = Tensor(output.DataType(), output.Shape(), std::move(allocator));
+}
+#endif
+
 // This provides easy sequential iteration over a subset of a tensor given a span of starts, extents & optionally steps
 template <typename T>
 struct WritableSliceIterator {
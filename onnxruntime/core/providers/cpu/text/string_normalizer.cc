@@ -436,6 +436,50 @@ const std::string default_locale("en_US.UTF-8");  // All non-MS and not Apple
 #endif
 
 #endif  // _MSC_VER
+
+// Or-ing the bytes vectorizes, the string is ASCII if none has the high bit set.
+bool IsAscii(const std::string& s) {
+  unsigned char bits = 0;
+  for (const char ch : s) {
+    bits |= static_cast<unsigned char>(ch);
+  }
+  return bits < 0x80;
+}
+
+// Changes the case of an ASCII string a byte at a time, without the conversion to wide chars.
+void ChangeCaseAscii(StringNormalizer::CaseAction caseaction, const std::string& src, std::string& dest) {
+  assert(caseaction != StringNormalizer::NONE);
+  const unsigned char first = caseaction == StringNormalizer::LOWER ? 'A' : 'a';
+  dest.resize(src.size());
+  const char* src_data = src.data();
+  char* dest_data = dest.data();
+  for (size_t i = 0, lim = src.size(); i < lim; ++i) {
+    const unsigned char ch = static_cast<unsigned char>(src_data[i]);
+    dest_data[i] = static_cast<char>(static_cast<unsigned char>(ch - first) < 26 ? ch ^ 0x20 : ch);
+  }
+}
+
+// The ASCII path can only be used if the locale changes the case of ASCII letters the way the C locale does,
+// which e.g. Turkish locales don't.
+bool HasAsciiCaseMapping(const Locale& locale) {
+  std::wstring ascii(128, L'\0');
+  for (wchar_t ch = 0; ch < 128; ++ch) {
+    ascii[ch] = ch;
+  }
+
+  for (const auto caseaction : {StringNormalizer::LOWER, StringNormalizer::UPPER}) {
+    std::wstring changed = ascii;
+    locale.ChangeCase(caseaction, changed);
+    const wchar_t first = caseaction == StringNormalizer::LOWER ? L'A' : L'a';
+    for (wchar_t ch = 0; ch < 128; ++ch) {
+      const wchar_t expected = (ch >= first && ch < first + 26) ? (ch ^ 0x20) : ch;
+      if (changed[ch] != expected) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
 }  // namespace string_normalizer
 
 using namespace string_normalizer;
@@ -477,6 +521,11 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info) {
       wstopwords_.insert(std::move(wstr));
     }
   }
+
+  if (case_change_action_ != NONE || !is_case_sensitive_) {
+    Locale locale(locale_name_);
+    ascii_case_mapping_ = HasAsciiCaseMapping(locale);
+  }
 }
 
 Status StringNormalizer::Compute(OpKernelContext* ctx) const {
@@ -526,9 +575,14 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   Locale locale(locale_name_);
   Utf8Converter converter;
 
-  // Compute the largest widestring buffer needed.
+  // Compute the largest widestring buffer needed. ASCII strings don't need it if the locale maps their case the
+  // way the C locale does.
   size_t max_wide_buffer_len = 0;
   for (const auto& s : input_span) {
+    if (ascii_case_mapping_ && IsAscii(s)) {
+      max_wide_buffer_len = std::max(max_wide_buffer_len, s.size());
+      continue;
+    }
     size_t wchars = 0;
     // Checks for invalid UTF-8 characters on Windows
     ORT_RETURN_IF_ERROR(converter.ComputeRequiredSizeToWideChar(s, wchars));
@@ -539,20 +593,27 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   std::wstring wchar_buffer;
   wchar_buffer.reserve(max_wide_buffer_len);
 
+  auto change_case = [&](const std::string& s, std::string& dest) {
+    if (ascii_case_mapping_ && IsAscii(s)) {
+      ChangeCaseAscii(case_change_action_, s, dest);
+      return Status::OK();
+    }
+
+    wchar_buffer.resize(max_wide_buffer_len);
+    ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
+    locale.ChangeCase(case_change_action_, wchar_buffer);
+
+    size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
+    dest.resize(utf8_buffer_len);
+    return converter.ConvertToUtf8(wchar_buffer, dest);
+  };
+
   // Output everything and change case as required
   auto output_no_filtering = [&](const TensorShape& output_shape) {
     auto output_tensor = ctx->Output(0, output_shape);
     auto const output_data = output_tensor->MutableData<std::string>();
     for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
-      const std::string& s = input_span[i];
-      wchar_buffer.resize(max_wide_buffer_len);
-      ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-      locale.ChangeCase(case_change_action_, wchar_buffer);
-
-      auto& dest = output_data[i];
-      size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
-      dest.resize(utf8_buffer_len);
-      ORT_RETURN_IF_ERROR(converter.ConvertToUtf8(wchar_buffer, dest));
+      ORT_RETURN_IF_ERROR(change_case(input_span[i], output_data[i]));
     }
     return Status::OK();
   };
@@ -563,14 +624,7 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
     for (size_t i : filtered_indices) {
       const std::string& s = input_span[i];
       if (case_change_action_ != NONE) {
-        wchar_buffer.resize(max_wide_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-        locale.ChangeCase(case_change_action_, wchar_buffer);
-
-        auto& dest = *output_data++;
-        size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
-        dest.resize(utf8_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToUtf8(wchar_buffer, dest));
+        ORT_RETURN_IF_ERROR(change_case(s, *output_data++));
       } else {
         *output_data++ = s;
       }
@@ -614,11 +668,18 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
       // Otherwise, we need to pull ICU library on all platforms.
       InlinedVector<size_t> filtered_strings_indices;
       filtered_strings_indices.reserve(input_span.size());
+      std::string ascii_buffer;
       for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
         const std::string& s = input_span[i];
-        wchar_buffer.resize(max_wide_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-        locale.ChangeCase(compare_caseaction_, wchar_buffer);
+        if (ascii_case_mapping_ && IsAscii(s)) {
+          // ASCII chars widen to the same code points
+          ChangeCaseAscii(compare_caseaction_, s, ascii_buffer);
+          wchar_buffer.assign(ascii_buffer.begin(), ascii_buffer.end());
+        } else {
+          wchar_buffer.resize(max_wide_buffer_len);
+          ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
+          locale.ChangeCase(compare_caseaction_, wchar_buffer);
+        }
         if (wstopwords_.count(wchar_buffer) == 0) {
           filtered_strings_indices.push_back(i);
         }
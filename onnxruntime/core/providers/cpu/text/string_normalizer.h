@@ -31,6 +31,8 @@ class StringNormalizer : public OpKernel {
   // used for case-insensitive compare
   CaseAction compare_caseaction_{LOWER};
   std::string locale_name_;
+  // the locale changes the case of ASCII letters as the C locale does, ASCII strings skip the wide char conversion
+  bool ascii_case_mapping_{false};
   // Either if these are populated but not both
   InlinedHashSet<std::string> stopwords_;
   InlinedHashSet<std::wstring> wstopwords_;
@@ -69,14 +69,15 @@ Status StringSplit::Compute(OpKernelContext* context) const {
   auto num_tokens_data = context->Output(1, input->Shape())->template MutableDataAsSpan<int64_t>();
   auto num_tokens_iter = num_tokens_data.begin();
 
-  InlinedVector<InlinedVector<std::string_view>> input_slices;
-  input_slices.reserve(input_data.size());
+  // the substrings of all the inputs in one buffer, the token counts delimit the ones of each input
+  InlinedVector<std::string_view> substrs;
+  substrs.reserve(input_data.size());
   size_t last_dim = 0;
 
   for (const auto& s : input_data) {
-    auto& substrs = input_slices.emplace_back();
+    const size_t begin = substrs.size();
     ComputeSubstrings(s, delimiter_, maxsplit_, substrs);
-    auto substr_count = substrs.size();
+    auto substr_count = substrs.size() - begin;
     last_dim = std::max(last_dim, substr_count);
     *num_tokens_iter = static_cast<int64_t>(substr_count);
     ++num_tokens_iter;
@@ -87,9 +88,13 @@ Status StringSplit::Compute(OpKernelContext* context) const {
   splits_shape.push_back(last_dim);
 
   auto splits_data = context->Output(0, splits_shape)->template MutableDataAsSpan<std::string>();
-  auto slices_iter = input_slices.begin();
-  for (auto output_splits_iter = splits_data.begin(); output_splits_iter != splits_data.end(); output_splits_iter += last_dim, ++slices_iter) {
-    std::copy(slices_iter->begin(), slices_iter->end(), output_splits_iter);
+  auto substrs_iter = substrs.cbegin();
+  auto output_splits_iter = splits_data.begin();
+  for (const int64_t substr_count : num_tokens_data) {
+    for (int64_t i = 0; i < substr_count; ++i, ++substrs_iter) {
+      output_splits_iter[i].assign(substrs_iter->data(), substrs_iter->size());
+    }
+    output_splits_iter += last_dim;
   }
 
   return Status::OK();
@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/math/sgemm.h"
+
+#include <algorithm>
+
+#include "core/common/inlined_containers.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+SgemmParams::SgemmParams(CpuTuningContext* tuning_ctx, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, size_t m,
+                         size_t n, size_t k, const MLAS_SGEMM_DATA_PARAMS* data, size_t batch_size,
+                         concurrency::ThreadPool* thread_pool)
+    : OpParams(tuning_ctx, nullptr),
+      trans_a_(trans_a),
+      trans_b_(trans_b),
+      m_(m),
+      n_(n),
+      k_(k),
+      data_(data),
+      batch_size_(batch_size),
+      thread_pool_(thread_pool),
+      num_threads_(concurrency::ThreadPool::DegreeOfParallelism(thread_pool)) {}
+
+namespace {
+
+// MLAS computes C in panels of 16 columns
+constexpr size_t kColumnAlignment = 16;
+
+// MLAS partitions the work of the batch across the threads itself.
+Status DefaultSgemmOp(const SgemmParams* params) {
+  MlasGemmBatch(params->trans_a_, params->trans_b_, params->m_, params->n_, params->k_, params->data_,
+                params->batch_size_, params->thread_pool_);
+  return Status::OK();
+}
+
+// Splits each product into blocks of rows of C, computed by single threaded MLAS calls. B is read by every thread.
+Status PartitionMSgemmOp(const SgemmParams* params) {
+  const size_t blocks_per_product =
+      std::min(params->m_, static_cast<size_t>(params->num_threads_) / params->batch_size_);
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(blocks_per_product < 2, "Not enough rows or threads to partition M");
+  const size_t rows_per_block = (params->m_ + blocks_per_product - 1) / blocks_per_product;
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      params->thread_pool_, static_cast<std::ptrdiff_t>(params->batch_size_ * blocks_per_product),
+      [&](std::ptrdiff_t task) {
+        const size_t i = static_cast<size_t>(task) / blocks_per_product;
+        const size_t m_start = (static_cast<size_t>(task) % blocks_per_product) * rows_per_block;
+        if (m_start >= params->m_) {
+          return;
+        }
+
+        MLAS_SGEMM_DATA_PARAMS data = params->data_[i];
+        data.A += params->trans_a_ == CblasNoTrans ? m_start * data.lda : m_start;
+        data.C += m_start * data.ldc;
+        MlasGemmBatch(params->trans_a_, params->trans_b_, std::min(rows_per_block, params->m_ - m_start),
+                      params->n_, params->k_, &data, 1, nullptr);
+      });
+  return Status::OK();
+}
+
+// Splits each product into blocks of columns of C, computed by single threaded MLAS calls. A is read by every thread.
+Status PartitionNSgemmOp(const SgemmParams* params) {
+  const size_t column_panels = (params->n_ + kColumnAlignment - 1) / kColumnAlignment;
+  const size_t blocks_per_product =
+      std::min(column_panels, static_cast<size_t>(params->num_threads_) / params->batch_size_);
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(blocks_per_product < 2, "Not enough columns or threads to partition N");
+  const size_t columns_per_block =
+      (column_panels + blocks_per_product - 1) / blocks_per_product * kColumnAlignment;
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      params->thread_pool_, static_cast<std::ptrdiff_t>(params->batch_size_ * blocks_per_product),
+      [&](std::ptrdiff_t task) {
+        const size_t i = static_cast<size_t>(task) / blocks_per_product;
+        const size_t n_start = (static_cast<size_t>(task) % blocks_per_product) * columns_per_block;
+        if (n_start >= params->n_) {
+          return;
+        }
+
+        MLAS_SGEMM_DATA_PARAMS data = params->data_[i];
+        data.B += params->trans_b_ == CblasNoTrans ? n_start : n_start * data.ldb;
+        data.C += n_start;
+        MlasGemmBatch(params->trans_a_, params->trans_b_, params->m_,
+                      std::min(columns_per_block, params->n_ - n_start), params->k_, &data, 1, nullptr);
+      });
+  return Status::OK();
+}
+
+// Packs B before the multiplication, like the MatMul kernel does for constant weights. Packing costs a pass over B,
+// which pays off when B is reused for many rows of A, or by every product of the batch when it is broadcast.
+Status PackBSgemmOp(const SgemmParams* params) {
+  const size_t packed_b_size = MlasGemmPackBSize(params->n_, params->k_);
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(packed_b_size == 0, "Packing B is not supported on this platform");
+
+  // pack each distinct B once
+  const bool shared_b = std::all_of(params->data_, params->data_ + params->batch_size_,
+                                    [&](const MLAS_SGEMM_DATA_PARAMS& data) {
+                                      return data.B == params->data_[0].B && data.ldb == params->data_[0].ldb;
+                                    });
+  const size_t num_packed = shared_b ? 1 : params->batch_size_;
+  constexpr size_t kAlignment = 64;
+  const size_t packed_b_stride = (packed_b_size + kAlignment - 1) / kAlignment * kAlignment;
+  auto packed_b = params->TuningContext()->GetScratchBuffer(packed_b_stride * num_packed);
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(packed_b == nullptr, "No allocator for the packed B");
+
+  auto* packed_b_data = static_cast<uint8_t*>(packed_b.get());
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      params->thread_pool_, static_cast<std::ptrdiff_t>(num_packed), [&](std::ptrdiff_t task) {
+        const size_t i = static_cast<size_t>(task);
+        MlasGemmPackB(params->trans_b_, params->n_, params->k_, params->data_[i].B, params->data_[i].ldb,
+                      packed_b_data + i * packed_b_stride);
+      });
+
+  InlinedVector<MLAS_SGEMM_DATA_PARAMS> data(params->data_, params->data_ + params->batch_size_);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i].B = reinterpret_cast<const float*>(packed_b_data + (shared_b ? 0 : i * packed_b_stride));
+    data[i].BIsPacked = true;
+  }
+  MlasGemmBatch(params->trans_a_, params->trans_b_, params->m_, params->n_, params->k_, data.data(), data.size(),
+                params->thread_pool_);
+  return Status::OK();
+}
+
+class SgemmTunableOp : public TunableOp<SgemmParams> {
+ public:
+  SgemmTunableOp() {
+    this->RegisterOp(DefaultSgemmOp);
+    this->RegisterOp(PartitionMSgemmOp);
+    this->RegisterOp(PartitionNSgemmOp);
+    this->RegisterOp(PackBSgemmOp);
+  }
+};
+
+}  // namespace
+
+Status TunableSgemmBatch(CpuTuningContext* tuning_ctx, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+                         size_t m, size_t n, size_t k, const MLAS_SGEMM_DATA_PARAMS* data, size_t batch_size,
+                         concurrency::ThreadPool* thread_pool) {
+  SgemmParams params(tuning_ctx, trans_a, trans_b, m, n, k, data, batch_size, thread_pool);
+  const bool tunable = tuning_ctx != nullptr && tuning_ctx->IsTunableOpEnabled() &&
+                       std::all_of(data, data + batch_size, [](const MLAS_SGEMM_DATA_PARAMS& d) {
+                         return d.beta == 0.0f && !d.BIsPacked;
+                       });
+  if (tunable) {
+    static SgemmTunableOp sgemm{};
+    return sgemm(&params);
+  }
+
+  return DefaultSgemmOp(&params);
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
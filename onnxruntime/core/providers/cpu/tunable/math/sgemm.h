@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/common/status.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+struct SgemmParams : OpParams {
+  SgemmParams(CpuTuningContext* tuning_ctx, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, size_t m, size_t n,
+              size_t k, const MLAS_SGEMM_DATA_PARAMS* data, size_t batch_size, concurrency::ThreadPool* thread_pool);
+
+  std::string Signature() const override {
+    // the partitioning depends on the number of threads, so results are not reused across thread counts
+    return MakeString((trans_a_ == CblasTrans ? "T" : "N"), (trans_b_ == CblasTrans ? "T" : "N"), "_", m_, "_", n_,
+                      "_", k_, "_", batch_size_, "_", num_threads_);
+  }
+
+  CBLAS_TRANSPOSE trans_a_;
+  CBLAS_TRANSPOSE trans_b_;
+  size_t m_;
+  size_t n_;
+  size_t k_;
+  const MLAS_SGEMM_DATA_PARAMS* data_;
+  size_t batch_size_;
+  concurrency::ThreadPool* thread_pool_;
+  int num_threads_;
+};
+
+// Runs MlasGemmBatch, or the fastest of a few partitioning and packing strategies for the shape when the TunableOp
+// of the tuning context is enabled. The strategies are benchmarked on the actual inputs when tuning is enabled and no
+// result exists for the shape yet, which overwrites C several times, so every beta must be 0 and B must not be
+// packed. Otherwise MlasGemmBatch runs.
+Status TunableSgemmBatch(CpuTuningContext* tuning_ctx, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+                         size_t m, size_t n, size_t k, const MLAS_SGEMM_DATA_PARAMS* data, size_t batch_size,
+                         concurrency::ThreadPool* thread_pool);
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
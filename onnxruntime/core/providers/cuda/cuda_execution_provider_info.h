@@ -51,6 +51,9 @@ struct CUDAExecutionProviderInfo {
   ArenaExtendStrategy arena_extend_strategy{ArenaExtendStrategy::kNextPowerOfTwo};  // Will be over-ridden by contents of `default_memory_arena_cfg` (if specified)
   OrtCudnnConvAlgoSearch cudnn_conv_algo_search{OrtCudnnConvAlgoSearchExhaustive};
   bool do_copy_in_default_stream{true};
+  // Size in bytes of the pinned host buffers that copies between pageable host memory and the device are staged
+  // through, in chunks, so that copying a chunk on the host overlaps the DMA of the previous one. 0 means disabled.
+  size_t copy_staging_buffer_size{0};
   bool has_user_compute_stream{false};
   void* user_compute_stream{nullptr};
   // The following OrtArenaCfg instance only characterizes the behavior of the default memory
@@ -65,6 +68,9 @@ struct CUDAExecutionProviderInfo {
   bool cudnn_conv_use_max_workspace{true};
 
   bool enable_cuda_graph{false};
+  // Maximum number of captured CUDA graphs per thread, the least recently used graph is destroyed to capture a new
+  // one. 0 means unlimited.
+  size_t cuda_graph_max_num_graphs{0};
 
   // By default, for Conv1D, will pad [N,C,D] to [N,C,D,1], if turn on, will pad to [N,C,1,D].
   bool cudnn_conv1d_pad_to_nc1d{false};
@@ -115,6 +121,8 @@ struct std::hash<::onnxruntime::CUDAExecutionProviderInfo> {
     onnxruntime::HashCombine(info.gpu_mem_limit, value);
     onnxruntime::HashCombine(info.tunable_op.max_tuning_duration_ms, value);
     onnxruntime::HashCombine(info.sdpa_kernel, value);
+    onnxruntime::HashCombine(info.cuda_graph_max_num_graphs, value);
+    onnxruntime::HashCombine(info.copy_staging_buffer_size, value);
 
     // Memory pointers
     onnxruntime::HashCombine(reinterpret_cast<size_t>(info.user_compute_stream), value);
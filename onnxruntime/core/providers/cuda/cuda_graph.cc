@@ -15,9 +15,10 @@ CudaGraphSet::~CudaGraphSet() {
 
 void CudaGraphSet::Clear() {
   for (auto& it : cuda_graphs_) {
-    CUDA_CALL_THROW(cudaGraphExecDestroy(it.second));
+    CUDA_CALL_THROW(cudaGraphExecDestroy(it.second.graph_exec));
   }
   cuda_graphs_.clear();
+  lru_.clear();
 }
 
 bool CudaGraphSet::Contains(CudaGraphAnnotation_t cuda_graph_annotation_id) const {
@@ -26,12 +27,24 @@ bool CudaGraphSet::Contains(CudaGraphAnnotation_t cuda_graph_annotation_id) cons
 
 void CudaGraphSet::Put(CudaGraphAnnotation_t cuda_graph_annotation_id, cudaGraphExec_t graph_exec) {
   ORT_ENFORCE(!Contains(cuda_graph_annotation_id));
-  cuda_graphs_.emplace(cuda_graph_annotation_id, graph_exec);
+
+  if (max_num_graphs_ != 0 && cuda_graphs_.size() >= max_num_graphs_) {
+    const CudaGraphAnnotation_t evicted_id = lru_.back();
+    LOGS_DEFAULT(INFO) << "Evicting the least recently used CUDA graph with cuda_graph_annotation_id " << evicted_id;
+    CUDA_CALL_THROW(cudaGraphExecDestroy(cuda_graphs_.at(evicted_id).graph_exec));
+    cuda_graphs_.erase(evicted_id);
+    lru_.pop_back();
+  }
+
+  lru_.push_front(cuda_graph_annotation_id);
+  cuda_graphs_.emplace(cuda_graph_annotation_id, Entry{graph_exec, lru_.begin()});
 }
 
-cudaGraphExec_t CudaGraphSet::Get(CudaGraphAnnotation_t cuda_graph_annotation_id) const {
-  ORT_ENFORCE(Contains(cuda_graph_annotation_id));
-  return cuda_graphs_.at(cuda_graph_annotation_id);
+cudaGraphExec_t CudaGraphSet::Get(CudaGraphAnnotation_t cuda_graph_annotation_id) {
+  auto it = cuda_graphs_.find(cuda_graph_annotation_id);
+  ORT_ENFORCE(it != cuda_graphs_.end());
+  lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+  return it->second.graph_exec;
 }
 
 CUDAGraphManager::CUDAGraphManager(cudaStream_t stream) : stream_(stream) {
@@ -41,6 +54,10 @@ void CUDAGraphManager::SetStream(cudaStream_t stream) {
   stream_ = stream;
 }
 
+void CUDAGraphManager::SetMaxNumGraphs(size_t max_num_graphs) {
+  cuda_graph_set_.SetMaxNumGraphs(max_num_graphs);
+}
+
 void CUDAGraphManager::CaptureBegin(CudaGraphAnnotation_t cuda_graph_annotation_id) {
   ORT_ENFORCE(IsGraphCaptureAllowedOnRun(cuda_graph_annotation_id));
 
@@ -67,8 +84,7 @@ void CUDAGraphManager::CaptureEnd(CudaGraphAnnotation_t cuda_graph_annotation_id
   CUDA_CALL_THROW(cudaGraphInstantiate(&graph_exec, graph, NULL, NULL, 0));
   CUDA_CALL_THROW(cudaGraphDestroy(graph));
 
-  // Currently all the captured graphs will be tied to the session's lifecycle
-  // TODO(wy): Addd an interface to free captured graphs
+  // The captured graphs are tied to the session's lifecycle unless the number of graphs is bounded
   cuda_graph_set_.Put(cuda_graph_annotation_id, graph_exec);
 }
 
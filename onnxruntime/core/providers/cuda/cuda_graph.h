@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <list>
 #include <unordered_map>
 
 #include "core/common/common.h"
@@ -12,11 +13,12 @@
 namespace onnxruntime {
 
 using CudaGraphAnnotation_t = int;
-using CudaGraphSet_t = std::unordered_map<CudaGraphAnnotation_t, cudaGraphExec_t>;
 
 constexpr CudaGraphAnnotation_t kCudaGraphAnnotationSkip = -1;
 constexpr CudaGraphAnnotation_t kCudaGraphAnnotationDefault = 0;
 
+// The captured graphs, kept in least recently used order.
+// If max_num_graphs is not 0, adding a graph to a full set destroys the least recently used one.
 struct CudaGraphSet {
   CudaGraphSet() {};
   ~CudaGraphSet();
@@ -24,10 +26,22 @@ struct CudaGraphSet {
   void Clear();
   bool Contains(CudaGraphAnnotation_t cuda_graph_annotation_id) const;
   void Put(CudaGraphAnnotation_t cuda_graph_annotation_id, cudaGraphExec_t graph_exec);
-  cudaGraphExec_t Get(CudaGraphAnnotation_t cuda_graph_annotation_id) const;
+  // Marks the graph as the most recently used one.
+  cudaGraphExec_t Get(CudaGraphAnnotation_t cuda_graph_annotation_id);
+
+  void SetMaxNumGraphs(size_t max_num_graphs) { max_num_graphs_ = max_num_graphs; }
+  size_t Size() const { return cuda_graphs_.size(); }
 
  private:
-  CudaGraphSet_t cuda_graphs_;
+  struct Entry {
+    cudaGraphExec_t graph_exec;
+    std::list<CudaGraphAnnotation_t>::iterator lru_it;
+  };
+
+  std::unordered_map<CudaGraphAnnotation_t, Entry> cuda_graphs_;
+  // most recently used first
+  std::list<CudaGraphAnnotation_t> lru_;
+  size_t max_num_graphs_ = 0;
 };
 
 struct CUDAGraphManager {
@@ -36,6 +50,8 @@ struct CUDAGraphManager {
   ~CUDAGraphManager();
 
   void SetStream(cudaStream_t stream);
+  // 0 means that the captured graphs are kept until Reset()
+  void SetMaxNumGraphs(size_t max_num_graphs);
   void CaptureBegin(CudaGraphAnnotation_t cuda_graph_annotation_id);
   void CaptureEnd(CudaGraphAnnotation_t cuda_graph_annotation_id);
   Status Replay(CudaGraphAnnotation_t cuda_graph_annotation_id);
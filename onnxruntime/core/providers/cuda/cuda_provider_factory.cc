@@ -218,6 +218,8 @@ struct CUDA_Provider : Provider {
     info.default_memory_arena_cfg = params->default_memory_arena_cfg;
     info.cudnn_conv_use_max_workspace = params->cudnn_conv_use_max_workspace != 0;
     info.enable_cuda_graph = params->enable_cuda_graph != 0;
+    info.cuda_graph_max_num_graphs = gsl::narrow<size_t>(params->cuda_graph_max_num_graphs);
+    info.copy_staging_buffer_size = gsl::narrow<size_t>(params->copy_staging_buffer_size);
     info.prefer_nhwc = params->prefer_nhwc;
     info.fuse_conv_bias = params->fuse_conv_bias;
     info.cudnn_conv1d_pad_to_nc1d = params->cudnn_conv1d_pad_to_nc1d != 0;
@@ -257,6 +259,8 @@ struct CUDA_Provider : Provider {
     cuda_options.default_memory_arena_cfg = internal_options.default_memory_arena_cfg;
     cuda_options.cudnn_conv_use_max_workspace = internal_options.cudnn_conv_use_max_workspace;
     cuda_options.enable_cuda_graph = internal_options.enable_cuda_graph;
+    cuda_options.cuda_graph_max_num_graphs = gsl::narrow<int>(internal_options.cuda_graph_max_num_graphs);
+    cuda_options.copy_staging_buffer_size = gsl::narrow<int>(internal_options.copy_staging_buffer_size);
     cuda_options.cudnn_conv1d_pad_to_nc1d = internal_options.cudnn_conv1d_pad_to_nc1d;
     cuda_options.enable_skip_layer_norm_strict_mode = internal_options.enable_skip_layer_norm_strict_mode;
     cuda_options.prefer_nhwc = internal_options.prefer_nhwc;
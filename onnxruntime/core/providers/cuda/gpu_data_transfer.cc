@@ -4,9 +4,26 @@
 #include "core/providers/shared_library/provider_api.h"
 
 #include "core/providers/cuda/gpu_data_transfer.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
 #include "cuda_common.h"
 
 namespace onnxruntime {
+GPUDataTransfer::~GPUDataTransfer() {
+  for (auto& buffer : staging_buffers_) {
+    if (buffer.copied) {
+      CUDA_CALL_THROW(cudaEventSynchronize(buffer.copied));
+      CUDA_CALL_THROW(cudaEventDestroy(buffer.copied));
+    }
+    if (buffer.data) {
+      CUDA_CALL_THROW(cudaFreeHost(buffer.data));
+    }
+  }
+}
+
 bool GPUDataTransfer::CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const {
   return src_device.Type() == OrtDevice::GPU || src_device.MemType() == OrtDevice::MemType::CUDA_PINNED ||
          dst_device.Type() == OrtDevice::GPU || dst_device.MemType() == OrtDevice::MemType::CUDA_PINNED;
@@ -30,6 +47,9 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst) const
         // see https://docs.nvidia.com/cuda/cuda-runtime-api/api-sync-behavior.html
         CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(nullptr));
       }
+    } else if (src_device.MemType() != OrtDevice::MemType::CUDA_PINNED && UseStaging(bytes)) {
+      ORT_RETURN_IF_ERROR(StagedCopyHostToDevice(dst_data, src_data, bytes, nullptr));
+      CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(nullptr));
     } else {
       // copy from other CPU memory to GPU, this is blocking
       CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyHostToDevice));
@@ -40,6 +60,10 @@ common::Status GPUDataTransfer::CopyTensor(const Tensor& src, Tensor& dst) const
       }
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
+    if (dst_device.MemType() != OrtDevice::MemType::CUDA_PINNED && UseStaging(bytes)) {
+      return StagedCopyDeviceToHost(dst_data, src_data, bytes, nullptr);
+    }
+
     // copying from GPU to CPU memory, this is blocking
     CUDA_RETURN_IF_ERROR(cudaMemcpy(dst_data, src_data, bytes, cudaMemcpyDeviceToHost));
   } else {
@@ -61,6 +85,10 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
 
   if (dst_device.Type() == OrtDevice::GPU) {
     if (src_device.Type() == OrtDevice::CPU) {
+      if (src_device.MemType() != OrtDevice::MemType::CUDA_PINNED && UseStaging(bytes)) {
+        return StagedCopyHostToDevice(dst_data, src_data, bytes, static_cast<cudaStream_t>(stream.GetHandle()));
+      }
+
       // copy from pinned or non-pinned CPU memory to GPU
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, static_cast<cudaStream_t>(stream.GetHandle())));
     } else if (src_device.Type() == OrtDevice::GPU) {
@@ -71,6 +99,10 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
     }
   } else if (src_device.Type() == OrtDevice::GPU) {
     if (dst_device.Type() == OrtDevice::CPU) {
+      if (dst_device.MemType() != OrtDevice::MemType::CUDA_PINNED && UseStaging(bytes)) {
+        return StagedCopyDeviceToHost(dst_data, src_data, bytes, static_cast<cudaStream_t>(stream.GetHandle()));
+      }
+
       // copy from GPU to pinned or non-pinned CPU memory.
       CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, static_cast<cudaStream_t>(stream.GetHandle())));
     }
@@ -87,4 +119,143 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
   return Status::OK();
 }
 
+common::Status GPUDataTransfer::CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const {
+  bool synchronize = false;
+  for (size_t i = 0; i < src_dst_pairs.size();) {
+    const auto& pair = src_dst_pairs[i];
+    const Tensor& src = pair.src.get();
+    Tensor& dst = pair.dst.get();
+    const auto& src_device = src.Location().device;
+    const auto& dst_device = dst.Location().device;
+
+    if (pair.src_stream) {
+      ORT_RETURN_IF_ERROR(CopyTensorAsync(src, dst, *pair.src_stream));
+      ++i;
+      continue;
+    }
+
+    if (src_device.Type() != OrtDevice::GPU && dst_device.Type() != OrtDevice::GPU) {
+      ORT_RETURN_IF_ERROR(CopyTensor(src, dst));
+      ++i;
+      continue;
+    }
+
+    const char* src_data = static_cast<const char*>(src.DataRaw());
+    char* dst_data = static_cast<char*>(dst.MutableDataRaw());
+    size_t bytes = src.SizeInBytes();
+    for (++i; i < src_dst_pairs.size(); ++i) {
+      const auto& next = src_dst_pairs[i];
+      if (next.src_stream != nullptr ||
+          next.src.get().Location().device != src_device || next.dst.get().Location().device != dst_device ||
+          next.src.get().DataRaw() != src_data + bytes || next.dst.get().MutableDataRaw() != dst_data + bytes) {
+        break;
+      }
+      bytes += next.src.get().SizeInBytes();
+    }
+
+    if (dst_device.Type() == OrtDevice::GPU && src_device.Type() == OrtDevice::GPU) {
+      if (dst_data != src_data) {
+        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToDevice, nullptr));
+      }
+    } else if (dst_device.Type() == OrtDevice::GPU) {
+      if (src_device.MemType() != OrtDevice::MemType::CUDA_PINNED && UseStaging(bytes)) {
+        ORT_RETURN_IF_ERROR(StagedCopyHostToDevice(dst_data, src_data, bytes, nullptr));
+      } else {
+        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, nullptr));
+      }
+    } else {
+      if (dst_device.MemType() != OrtDevice::MemType::CUDA_PINNED && UseStaging(bytes)) {
+        ORT_RETURN_IF_ERROR(StagedCopyDeviceToHost(dst_data, src_data, bytes, nullptr));
+      } else {
+        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyDeviceToHost, nullptr));
+      }
+    }
+
+    synchronize = true;
+  }
+
+  // a single synchronization for all the copies queued on the default stream
+  if (synchronize) {
+    CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(nullptr));
+  }
+
+  return Status::OK();
+}
+
+common::Status GPUDataTransfer::EnsureStagingBuffers() const {
+  for (auto& buffer : staging_buffers_) {
+    if (buffer.data == nullptr) {
+      CUDA_RETURN_IF_ERROR(cudaMallocHost(&buffer.data, staging_buffer_size_ / staging_buffers_.size()));
+    }
+    if (buffer.copied == nullptr) {
+      CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&buffer.copied, cudaEventDisableTiming));
+    }
+  }
+
+  return Status::OK();
+}
+
+common::Status GPUDataTransfer::StagedCopyHostToDevice(void* dst, const void* src, size_t bytes,
+                                                       cudaStream_t stream) const {
+  std::lock_guard<std::mutex> lock(staging_mutex_);
+  ORT_RETURN_IF_ERROR(EnsureStagingBuffers());
+
+  const size_t chunk_size = staging_buffer_size_ / staging_buffers_.size();
+  size_t i = 0;
+  for (size_t offset = 0; offset < bytes; offset += chunk_size, ++i) {
+    auto& buffer = staging_buffers_[i % staging_buffers_.size()];
+    const size_t chunk_bytes = std::min(chunk_size, bytes - offset);
+
+    // the previous DMA from the buffer, possibly of an earlier copy, must be done before it is overwritten
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(buffer.copied));
+    memcpy(buffer.data, static_cast<const char*>(src) + offset, chunk_bytes);
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(static_cast<char*>(dst) + offset, buffer.data, chunk_bytes,
+                                         cudaMemcpyHostToDevice, stream));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(buffer.copied, stream));
+  }
+
+  return Status::OK();
+}
+
+common::Status GPUDataTransfer::StagedCopyDeviceToHost(void* dst, const void* src, size_t bytes,
+                                                       cudaStream_t stream) const {
+  std::lock_guard<std::mutex> lock(staging_mutex_);
+  ORT_RETURN_IF_ERROR(EnsureStagingBuffers());
+
+  const size_t chunk_size = staging_buffer_size_ / staging_buffers_.size();
+  // offset and size in dst of the chunk each buffer holds once its DMA completes
+  std::array<std::pair<size_t, size_t>, std::tuple_size_v<decltype(staging_buffers_)>> pending{};
+  auto copy_out = [&](size_t buffer_index) -> Status {
+    auto& [chunk_offset, chunk_bytes] = pending[buffer_index];
+    if (chunk_bytes > 0) {
+      CUDA_RETURN_IF_ERROR(cudaEventSynchronize(staging_buffers_[buffer_index].copied));
+      memcpy(static_cast<char*>(dst) + chunk_offset, staging_buffers_[buffer_index].data, chunk_bytes);
+      chunk_bytes = 0;
+    }
+    return Status::OK();
+  };
+
+  size_t i = 0;
+  for (size_t offset = 0; offset < bytes; offset += chunk_size, ++i) {
+    const size_t buffer_index = i % staging_buffers_.size();
+    auto& buffer = staging_buffers_[buffer_index];
+    const size_t chunk_bytes = std::min(chunk_size, bytes - offset);
+
+    // the chunk the buffer holds is copied out while the DMA of the other buffer is in flight
+    ORT_RETURN_IF_ERROR(copy_out(buffer_index));
+    // a host to device copy may still be reading from the buffer
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(buffer.copied));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(buffer.data, static_cast<const char*>(src) + offset, chunk_bytes,
+                                         cudaMemcpyDeviceToHost, stream));
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(buffer.copied, stream));
+    pending[buffer_index] = {offset, chunk_bytes};
+  }
+
+  for (size_t j = 0; j < staging_buffers_.size(); ++j) {
+    ORT_RETURN_IF_ERROR(copy_out((i + j) % staging_buffers_.size()));
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <array>
+#include <mutex>
+
 #include "cuda_pch.h"
 #include "core/framework/data_transfer.h"
 
@@ -10,8 +13,10 @@ namespace onnxruntime {
 
 class GPUDataTransfer : public IDataTransfer {
  public:
-  GPUDataTransfer() = default;
-  ~GPUDataTransfer() = default;
+  // staging_buffer_size is the total size of the pinned buffers that copies between pageable host memory and the
+  // device are staged through. 0 copies directly from and to pageable memory.
+  explicit GPUDataTransfer(size_t staging_buffer_size = 0) : staging_buffer_size_(staging_buffer_size) {}
+  ~GPUDataTransfer();
 
   bool CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const override;
 
@@ -19,6 +24,29 @@ class GPUDataTransfer : public IDataTransfer {
   using IDataTransfer::CopyTensor;
   common::Status CopyTensor(const Tensor& src, Tensor& dst) const override;
   common::Status CopyTensorAsync(const Tensor& src, Tensor& dst, Stream& stream) const override;
+
+  // Copies without a producer stream are queued on the default stream, copies of tensors that are adjacent in both
+  // the source and the destination memory as a single one, and synchronized once after the last one.
+  common::Status CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const override;
+
+ private:
+  // Copies between pageable host memory and the device in chunks through two pinned buffers, so that the host copy
+  // of a chunk overlaps the DMA of the previous one on the stream. Host to device copies return once the last chunk
+  // is queued, device to host copies once the data is in dst.
+  common::Status StagedCopyHostToDevice(void* dst, const void* src, size_t bytes, cudaStream_t stream) const;
+  common::Status StagedCopyDeviceToHost(void* dst, const void* src, size_t bytes, cudaStream_t stream) const;
+  common::Status EnsureStagingBuffers() const;
+  bool UseStaging(size_t bytes) const { return staging_buffer_size_ > 0 && bytes > staging_buffer_size_ / 2; }
+
+  struct StagingBuffer {
+    void* data{nullptr};
+    // recorded after the DMA from or to data is queued, the buffer is free once it completes
+    cudaEvent_t copied{nullptr};
+  };
+
+  const size_t staging_buffer_size_;
+  mutable std::mutex staging_mutex_;
+  mutable std::array<StagingBuffer, 2> staging_buffers_{};
 };
 
 }  // namespace onnxruntime
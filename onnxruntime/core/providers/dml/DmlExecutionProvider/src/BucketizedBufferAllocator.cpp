@@ -116,8 +116,15 @@ namespace Dml
             else
             {
                 // Retrieve a resource from the bucket
-                resourceWrapper = std::move(bucket->resources.back().resource);
-                resourceId = bucket->resources.back().resourceId;
+                Resource& resource = bucket->resources.back();
+                if (resource.evicted)
+                {
+                    ID3D12Pageable* pageable = resource.resource->GetD3D12Resource();
+                    ORT_THROW_IF_FAILED(m_device->MakeResident(1, &pageable));
+                }
+
+                resourceWrapper = std::move(resource.resource);
+                resourceId = resource.resourceId;
                 bucket->resources.pop_back();
             }
         }
@@ -219,4 +226,51 @@ namespace Dml
     {
         m_defaultRoundingMode = roundingMode;
     }
+
+    uint64_t BucketizedBufferAllocator::Trim()
+    {
+        uint64_t releasedBytes = 0;
+        for (gsl::index bucketIndex = 0; bucketIndex < gsl::narrow_cast<gsl::index>(m_pool.size()); ++bucketIndex)
+        {
+            Bucket& bucket = m_pool[bucketIndex];
+            for (Resource& resource : bucket.resources)
+            {
+                if (!m_context->IsClosed())
+                {
+                    // Free the underlying allocation once queued work has completed.
+    #ifdef _GAMING_XBOX
+                    m_context->QueueReference(WRAP_GRAPHICS_UNKNOWN(resource.resource->GetD3D12Resource()).Get());
+    #else
+                    m_context->QueueReference(resource.resource->GetD3D12Resource());
+    #endif
+                }
+            }
+
+            releasedBytes += GetBucketSizeFromIndex(bucketIndex) * bucket.resources.size();
+            bucket.resources.clear();
+        }
+
+        return releasedBytes;
+    }
+
+    void BucketizedBufferAllocator::EvictPooledResources()
+    {
+        std::vector<ID3D12Pageable*> pageables;
+        for (Bucket& bucket : m_pool)
+        {
+            for (Resource& resource : bucket.resources)
+            {
+                if (!resource.evicted)
+                {
+                    pageables.push_back(resource.resource->GetD3D12Resource());
+                    resource.evicted = true;
+                }
+            }
+        }
+
+        if (!pageables.empty())
+        {
+            ORT_THROW_IF_FAILED(m_device->Evict(gsl::narrow_cast<uint32_t>(pageables.size()), pageables.data()));
+        }
+    }
 } // namespace Dml
@@ -46,6 +46,14 @@ namespace Dml
 
         void SetDefaultRoundingMode(AllocatorRoundingMode roundingMode);
 
+        // Releases the pooled resources which aren't currently allocated, once the work queued on them has completed.
+        // Returns the number of bytes released.
+        uint64_t Trim();
+
+        // Evicts the pooled resources which aren't currently allocated. The GPU must not be using them anymore.
+        // Evicted resources are made resident again when they are handed out by Alloc.
+        void EvictPooledResources();
+
     public: // onnxruntime::IAllocator
         void* Alloc(size_t size, AllocatorRoundingMode roundingMode);
         void* Alloc(size_t size) final;
@@ -61,6 +69,7 @@ namespace Dml
         {
             ComPtr<DmlResourceWrapper> resource;
             uint64_t resourceId;
+            bool evicted = false;
         };
 
         struct Bucket
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include "DmlGraphFusionHelper.h"
 #include "DmlRuntimeFusedGraphKernel.h"
 
@@ -517,6 +518,129 @@ namespace DmlGraphFusionHelper
         return partitionNodePropsMap;
     }
 
+    namespace
+    {
+        // Compiled operators of the fused graphs compiled by this process. Compiling a graph is the most expensive
+        // part of creating a session with DML graph fusion, and sessions of the same model, or a runtime fused graph
+        // seeing the same input shapes again, compile identical graphs. The key holds the DML device, the execution
+        // flags and the serialized graph description, so an entry is only reused for an identical graph on the same
+        // device. The cache keeps a reference to the device of each entry so that its address can't be reused.
+        class CompiledOperatorCache
+        {
+        public:
+            static CompiledOperatorCache& Instance()
+            {
+                static CompiledOperatorCache cache;
+                return cache;
+            }
+
+            ComPtr<IDMLCompiledOperator> Find(const std::string& key)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = std::find_if(m_entries.begin(), m_entries.end(), [&key](const Entry& entry) { return entry.key == key; });
+                if (it == m_entries.end())
+                {
+                    return nullptr;
+                }
+
+                // Keep the most recently used entries at the front
+                m_entries.splice(m_entries.begin(), m_entries, it);
+                return m_entries.front().compiledOperator;
+            }
+
+            void Insert(std::string key, ComPtr<IDMLDevice> device, ComPtr<IDMLCompiledOperator> compiledOperator)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_entries.push_front(Entry{std::move(key), std::move(device), std::move(compiledOperator)});
+                if (m_entries.size() > c_maxEntries)
+                {
+                    m_entries.pop_back();
+                }
+            }
+
+        private:
+            struct Entry
+            {
+                std::string key;
+                ComPtr<IDMLDevice> device;
+                ComPtr<IDMLCompiledOperator> compiledOperator;
+            };
+
+            static constexpr size_t c_maxEntries = 64;
+            std::mutex m_mutex;
+            std::list<Entry> m_entries;
+        };
+
+        template <typename T>
+        void AppendToKey(std::string& key, const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        // Returns an empty key if the graph description can't be serialized, in which case it isn't cached.
+        std::string GetCompiledOperatorCacheKey(
+            const GraphDescBuilder::GraphDesc& graphDesc,
+            IDMLDevice* device,
+            DML_EXECUTION_FLAGS executionFlags,
+            uint32_t fusedNodeInputCount,
+            uint32_t fusedNodeOutputCount,
+            const std::unordered_map<uint32_t, uint32_t>* serializedGraphInputIndexToSubgraphInputIndex,
+            const std::unordered_map<std::string_view, uint32_t>* serializedGraphLargeConstantNameToSubgraphInputIndex)
+        {
+            std::string key;
+            try
+            {
+                auto buffer = SerializeDmlGraph(graphDesc);
+                if (buffer.size() == 0)
+                {
+                    return {};
+                }
+
+                AppendToKey(key, device);
+                AppendToKey(key, executionFlags);
+                AppendToKey(key, fusedNodeInputCount);
+                AppendToKey(key, fusedNodeOutputCount);
+
+                // These maps decide which graph inputs and constants ConvertGraphDesc binds to the fused node inputs
+                if (serializedGraphInputIndexToSubgraphInputIndex)
+                {
+                    std::map<uint32_t, uint32_t> sortedInputIndices(
+                        serializedGraphInputIndexToSubgraphInputIndex->begin(),
+                        serializedGraphInputIndexToSubgraphInputIndex->end());
+                    for (const auto& [graphInputIndex, subgraphInputIndex] : sortedInputIndices)
+                    {
+                        AppendToKey(key, graphInputIndex);
+                        AppendToKey(key, subgraphInputIndex);
+                    }
+                }
+                AppendToKey(key, '\0');
+
+                if (serializedGraphLargeConstantNameToSubgraphInputIndex)
+                {
+                    std::map<std::string_view, uint32_t> sortedConstantIndices(
+                        serializedGraphLargeConstantNameToSubgraphInputIndex->begin(),
+                        serializedGraphLargeConstantNameToSubgraphInputIndex->end());
+                    for (const auto& [constantName, subgraphInputIndex] : sortedConstantIndices)
+                    {
+                        key.append(constantName);
+                        AppendToKey(key, '\0');
+                        AppendToKey(key, subgraphInputIndex);
+                    }
+                }
+                AppendToKey(key, '\0');
+
+                key.append(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+            }
+            catch (...)
+            {
+                return {};
+            }
+
+            return key;
+        }
+    }
+
     Microsoft::WRL::ComPtr<IDMLCompiledOperator> TryCreateCompiledOperator(
         const GraphDescBuilder::GraphDesc& graphDesc,
         const onnxruntime::IndexedSubGraph& indexedSubGraph,
@@ -531,6 +655,36 @@ namespace DmlGraphFusionHelper
         ComPtr<IDMLDevice> device;
         ORT_THROW_IF_FAILED(providerImpl->GetDmlDevice(device.GetAddressOf()));
 
+        DML_EXECUTION_FLAGS executionFlags = DML_EXECUTION_FLAG_NONE;
+        if (graphDesc.reuseCommandList)
+        {
+            executionFlags |= DML_EXECUTION_FLAG_DESCRIPTORS_VOLATILE;
+        }
+
+        // Query DML execution provider to see if metacommands is enabled
+        if (!providerImpl->MetacommandsEnabled())
+        {
+            executionFlags |= DML_EXECUTION_FLAG_DISABLE_META_COMMANDS;
+        }
+
+        std::string cacheKey = GetCompiledOperatorCacheKey(
+            graphDesc,
+            device.Get(),
+            executionFlags,
+            fusedNodeInputCount,
+            fusedNodeOutputCount,
+            serializedGraphInputIndexToSubgraphInputIndex,
+            serializedGraphLargeConstantNameToSubgraphInputIndex);
+
+        if (!cacheKey.empty())
+        {
+            ComPtr<IDMLCompiledOperator> cachedOperator = CompiledOperatorCache::Instance().Find(cacheKey);
+            if (cachedOperator)
+            {
+                return cachedOperator;
+            }
+        }
+
         StackAllocator<1024> allocator;
         DML_GRAPH_DESC dmlGraphDesc = {};
         std::vector<ComPtr<IDMLOperator>> dmlOperators;
@@ -553,19 +707,6 @@ namespace DmlGraphFusionHelper
             dmlOutputEdges,
             dmlIntermediateEdges);
 
-        DML_EXECUTION_FLAGS executionFlags = DML_EXECUTION_FLAG_NONE;
-        if (graphDesc.reuseCommandList)
-        {
-            executionFlags |= DML_EXECUTION_FLAG_DESCRIPTORS_VOLATILE;
-        }
-
-        // Query DML execution provider to see if metacommands is enabled
-        if (!providerImpl->MetacommandsEnabled())
-        {
-            executionFlags |= DML_EXECUTION_FLAG_DISABLE_META_COMMANDS;
-        }
-
-
         ComPtr<IDMLDevice1> device1;
         ORT_THROW_IF_FAILED(device.As(&device1));
 
@@ -581,6 +722,11 @@ namespace DmlGraphFusionHelper
             return nullptr;
         }
 
+        if (!cacheKey.empty())
+        {
+            CompiledOperatorCache::Instance().Insert(std::move(cacheKey), device, compiledExecutionPlanOperator);
+        }
+
         return compiledExecutionPlanOperator;
     }
 
@@ -1233,7 +1233,7 @@ namespace Dml
         return onnxruntime::common::Status::OK();
     }
 
-    Status ExecutionProviderImpl::OnRunEnd()
+    Status ExecutionProviderImpl::OnRunEnd(const onnxruntime::RunOptions& run_options)
     {
         if (GraphCaptureEnabled() && m_currentGraphAnnotationId != -1)
         {
@@ -1243,6 +1243,27 @@ namespace Dml
         // Flush any pending work to the GPU, but don't block for completion, permitting it
         // to overlap other work.
         Flush();
+
+        const bool trimMemory = run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigDmlTrimMemory, "0") == "1";
+        const bool evictCachedMemory = run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigDmlEvictCachedMemory, "0") == "1";
+        if (trimMemory || evictCachedMemory)
+        {
+            // The cached resources can only be released or evicted once the GPU is done with them
+            m_context->GetCurrentCompletionEvent().WaitForSignal(m_cpuSyncSpinningEnabled);
+
+            if (trimMemory)
+            {
+                m_allocator->Trim();
+            }
+            else
+            {
+                m_allocator->EvictPooledResources();
+            }
+
+            m_context->ReleaseCompletedReferences();
+            m_uploadHeap->Trim();
+        }
+
         return onnxruntime::common::Status::OK();
     }
 
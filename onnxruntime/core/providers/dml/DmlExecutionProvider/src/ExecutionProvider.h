@@ -160,7 +160,7 @@ namespace Dml
         bool GraphCaptured(int graph_annotation_id) const;
         Status ReplayGraph(int graph_annotation_id);
         Status OnRunStart(const onnxruntime::RunOptions& run_options);
-        Status OnRunEnd();
+        Status OnRunEnd(const onnxruntime::RunOptions& run_options);
         int GetCurrentGraphAnnotationId() const { return m_currentGraphAnnotationId; }
         void AppendCapturedGraph(int annotationId, std::unique_ptr<DmlReusedCommandListState> capturedGraph);
         bool CpuSyncSpinningEnabled() const noexcept;
@@ -303,9 +303,9 @@ namespace Dml
             return m_impl->OnRunStart(run_options);
         }
 
-        Status OnRunEnd(bool /*sync_stream*/, const onnxruntime::RunOptions& /*run_options*/) final
+        Status OnRunEnd(bool /*sync_stream*/, const onnxruntime::RunOptions& run_options) final
         {
-            return m_impl->OnRunEnd();
+            return m_impl->OnRunEnd(run_options);
         }
 
         void Flush()
@@ -22,6 +22,9 @@ namespace nnapi {
 Model::Model(const NnApi& nnapi_handle) : nnapi_(nnapi_handle) {}
 
 Model::~Model() {
+  if (burst_) {
+    nnapi_.ANeuralNetworksBurst_free(burst_);
+  }
   nnapi_.ANeuralNetworksCompilation_free(compilation_);
   nnapi_.ANeuralNetworksModel_free(model_);
 }
@@ -97,11 +100,25 @@ Status Model::PrepareForExecution(std::unique_ptr<Execution>& execution) {
   ORT_RETURN_IF_NOT(nullptr != compilation_,
                     "Error in PrepareForExecution, compilation_ is null");
 
+  // Bursts are available from Android API level 29 (ANEURALNETWORKS_FEATURE_LEVEL_3). They are meant for models run
+  // repeatedly, like on every camera frame, and cut the per run overhead of the driver. The caller holds the model
+  // mutex, so the burst is never used by two executions at the same time.
+  if (!burst_created_) {
+    burst_created_ = true;
+    if (nnapi_effective_feature_level_ >= ANEURALNETWORKS_FEATURE_LEVEL_3 &&
+        nnapi_.ANeuralNetworksBurst_create && nnapi_.ANeuralNetworksBurst_free &&
+        nnapi_.ANeuralNetworksExecution_burstCompute &&
+        nnapi_.ANeuralNetworksBurst_create(compilation_, &burst_) != ANEURALNETWORKS_NO_ERROR) {
+      LOGS_DEFAULT(WARNING) << "Failed to create NNAPI burst, falling back to asynchronous execution";
+      burst_ = nullptr;
+    }
+  }
+
   ANeuralNetworksExecution* nnapi_execution;
   RETURN_STATUS_ON_ERROR(
       nnapi_.ANeuralNetworksExecution_create(compilation_, &nnapi_execution));
 
-  execution = std::make_unique<Execution>(*nnapi_execution /*, shaper_*/, nnapi_);
+  execution = std::make_unique<Execution>(*nnapi_execution /*, shaper_*/, nnapi_, burst_);
   return Status::OK();
 }
 
@@ -144,9 +161,10 @@ Model::NNMemory::NNMemory(const NnApi& /*nnapi_handle*/, const char* name, size_
 #pragma region Execution
 
 Execution::Execution(ANeuralNetworksExecution& execution /*, const Shaper& shaper */,
-                     const NnApi& nnapi_handle)
+                     const NnApi& nnapi_handle, ANeuralNetworksBurst* burst)
     : nnapi_(nnapi_handle),
-      execution_(&execution) {
+      execution_(&execution),
+      burst_(burst) {
 }
 
 Execution::~Execution() {
@@ -188,7 +206,9 @@ Status Execution::SetOutputBuffer(const int32_t index, const OutputBuffer& outpu
 }
 
 Status Execution::Predict(const std::vector<int32_t>& dynamic_outputs, std::vector<Shaper::Shape>& dynamic_output_shapes) {
-  {
+  if (burst_) {
+    RETURN_STATUS_ON_ERROR(nnapi_.ANeuralNetworksExecution_burstCompute(execution_, burst_));
+  } else {
     ANeuralNetworksEvent* event = nullptr;
     RETURN_STATUS_ON_ERROR(nnapi_.ANeuralNetworksExecution_startCompute(execution_, &event));
     auto free_event = gsl::finally([&]() { nnapi_.ANeuralNetworksEvent_free(event); });
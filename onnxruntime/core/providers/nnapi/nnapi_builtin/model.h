@@ -113,6 +113,11 @@ class Model {
   ANeuralNetworksModel* model_{nullptr};
   ANeuralNetworksCompilation* compilation_{nullptr};
 
+  // Burst object reused by the executions of the compilation, which lets the driver keep the resources of a run
+  // alive for the next one. Created by the first PrepareForExecution(), null if NNAPI does not support bursts.
+  ANeuralNetworksBurst* burst_{nullptr};
+  bool burst_created_{false};
+
   size_t dynamic_output_buffer_size_{1024};
 
   std::unique_ptr<NNMemory> mem_initializers_;
@@ -158,7 +163,9 @@ class Execution {
   };
 
  public:
-  explicit Execution(ANeuralNetworksExecution& execution /* , const Shaper& shaper */, const NnApi& nnapi_handle);
+  // If burst is not null, Predict() runs the execution on it. The burst is owned by the Model.
+  explicit Execution(ANeuralNetworksExecution& execution /* , const Shaper& shaper */, const NnApi& nnapi_handle,
+                     ANeuralNetworksBurst* burst = nullptr);
   ~Execution();
   Execution(const Execution&) = delete;
   Execution& operator=(const Execution&) = delete;
@@ -182,6 +189,7 @@ class Execution {
 
   const NnApi& nnapi_;
   ANeuralNetworksExecution* execution_;
+  ANeuralNetworksBurst* burst_;
   /* Shaper shaper_; */
 };
 
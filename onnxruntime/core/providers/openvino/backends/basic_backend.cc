@@ -1,6 +1,7 @@
 // Copyright (C) Intel Corporation
 // Licensed under the MIT License
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <memory>
@@ -130,6 +131,14 @@ BasicBackend::BasicBackend(std::unique_ptr<ONNX_NAMESPACE::ModelProto>& model_pr
     ORT_THROW(msg);
   }
   int num_infer_req = (global_context_.num_of_threads > 0) ? global_context_.num_of_threads : 1;
+  // Size the pool so that concurrent Run calls can keep all the streams of the device busy
+  try {
+    uint32_t optimal_num_infer_req = exe_network_.Get().get_property(ov::optimal_number_of_infer_requests);
+    num_infer_req = std::max(num_infer_req, static_cast<int>(optimal_num_infer_req));
+  } catch (const ov::Exception&) {
+    LOGS_DEFAULT(INFO) << log_tag << "The device doesn't report its optimal number of infer requests";
+  }
+  LOGS_DEFAULT(INFO) << log_tag << "Number of infer requests: " << num_infer_req;
   inferRequestsQueue_ = std::unique_ptr<InferRequestsQueue>(new InferRequestsQueue(exe_network_, num_infer_req));
 }
 
@@ -401,8 +410,7 @@ void BasicBackend::StartAsyncInference(Ort::KernelContext& context, OVInferReque
           ORT_THROW(msg);
         }
       } else {
-        if ((global_context_.device_type.find("CPU") != std::string::npos ||
-             global_context_.device_type.find("GPU") != std::string::npos)) {
+        if (global_context_.device_type.find("GPU") != std::string::npos) {
           OVTensorPtr graph_input_blob;
           try {
             graph_input_blob = infer_request->GetTensor(input_name);
@@ -411,8 +419,10 @@ void BasicBackend::StartAsyncInference(Ort::KernelContext& context, OVInferReque
           }
           FillInputBlob(std::move(graph_input_blob), batch_slice_idx, std::move(input_name), context, subgraph_context_);
         } else {
+          // Let the infer request read the ORT input directly instead of copying it
           auto tensor = context.GetInput(subgraph_context_.input_names.at(input_name));
-          ort_tensor_key_t ort_tensor_key{input_name};
+          ort_tensor_key_t ort_tensor_key{infer_request.get(), input_name};
+          std::unique_lock<std::mutex> lock(ort_ov_tensor_map_mutex_);
           auto it = ort_ov_tensor_map.find(ort_tensor_key);
           if ((it == ort_ov_tensor_map.end()) ||
               (it != ort_ov_tensor_map.end() && (it->second.ort_ptr != tensor.GetTensorRawData()))) {
@@ -423,6 +433,7 @@ void BasicBackend::StartAsyncInference(Ort::KernelContext& context, OVInferReque
 
             ov_tensor_data.ort_ptr = tensor.GetTensorRawData();
             ort_ov_tensor_map[ort_tensor_key] = ov_tensor_data;
+            lock.unlock();
 
             try {
               infer_request->SetTensor(std::move(input_name), ov_tensor_data.tensor_ptr);
@@ -458,7 +469,8 @@ void BasicBackend::StartAsyncInference(Ort::KernelContext& context, OVInferReque
                                                    infer_request,
                                                    output_name,
                                                    subgraph_context_.output_names);
-        ort_tensor_key_t ort_tensor_key{output_name};
+        ort_tensor_key_t ort_tensor_key{infer_request.get(), output_name};
+        std::unique_lock<std::mutex> lock(ort_ov_tensor_map_mutex_);
         const auto& it = ort_ov_tensor_map.find(ort_tensor_key);
         if ((it == ort_ov_tensor_map.end()) ||
             (it != ort_ov_tensor_map.end() && (it->second.ort_ptr != tensor.GetTensorRawData()))) {
@@ -468,6 +480,7 @@ void BasicBackend::StartAsyncInference(Ort::KernelContext& context, OVInferReque
           ov_tensor_data.tensor_ptr = std::make_shared<ov::Tensor>(output.get_element_type(), output.get_shape(),
                                                                    const_cast<void*>(tensor.GetTensorRawData()));
           ort_ov_tensor_map[ort_tensor_key] = ov_tensor_data;
+          lock.unlock();
 
           try {
             infer_request->SetTensor(std::move(output_name), ov_tensor_data.tensor_ptr);
@@ -702,32 +715,38 @@ void BasicBackend::Infer(OrtKernelContext* ctx) {
     // Requesting for an idle infer_request from a pool of infer_requests_
     OVInferRequestPtr infer_request;
     infer_request = inferRequestsQueue_->getIdleRequest();
+    // The request goes back to the pool even if the inference fails, so other runs don't wait for it forever
+    try {
 #ifdef IO_BUFFER_ENABLED
-    if ((global_context_.device_type.find("GPU") != std::string::npos) &&
-        (global_context_.context != nullptr) && global_context_.is_wholly_supported_graph) {
-      try {
-        StartRemoteAsyncInference(context, infer_request);
-      } catch (std::string const& msg) {
-        ORT_THROW(msg);
+      if ((global_context_.device_type.find("GPU") != std::string::npos) &&
+          (global_context_.context != nullptr) && global_context_.is_wholly_supported_graph) {
+        try {
+          StartRemoteAsyncInference(context, infer_request);
+        } catch (std::string const& msg) {
+          ORT_THROW(msg);
+        }
+      } else {
+        try {
+          StartAsyncInference(context, infer_request);
+        } catch (std::string const& msg) {
+          ORT_THROW(msg);
+        }
       }
-    } else {
+#else
       try {
         StartAsyncInference(context, infer_request);
-      } catch (std::string const& msg) {
-        ORT_THROW(msg);
+      } catch (const std::runtime_error& e) {
+        ORT_THROW(log_tag + " Exception at StartAsyncInference: " + e.what());
       }
-    }
-#else
-    try {
-      StartAsyncInference(context, infer_request);
-    } catch (const std::runtime_error& e) {
-      ORT_THROW(log_tag + " Exception at StartAsyncInference: " + e.what());
-    }
 #endif
-    try {
-      CompleteAsyncInference(context, infer_request);
-    } catch (const std::runtime_error& e) {
-      ORT_THROW(log_tag + " Exception at CompleteAsyncInference: " + e.what());
+      try {
+        CompleteAsyncInference(context, infer_request);
+      } catch (const std::runtime_error& e) {
+        ORT_THROW(log_tag + " Exception at CompleteAsyncInference: " + e.what());
+      }
+    } catch (...) {
+      inferRequestsQueue_->putIdleRequest(std::move(infer_request));
+      throw;
     }
 
     // Get Output tensors
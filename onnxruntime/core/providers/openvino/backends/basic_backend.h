@@ -12,6 +12,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <map>
+#include <utility>
 
 #include "core/session/onnxruntime_cxx_api.h"
 #include "core/providers/openvino/contexts.h"
@@ -66,8 +67,10 @@ class BasicBackend : public IBackend {
   OVRemoteContextPtr remote_context_;
 #endif
 
-  using ort_tensor_key_t = const std::string;
+  // The ORT tensors are bound to each infer request of the pool separately
+  using ort_tensor_key_t = std::pair<const OVInferRequest*, std::string>;
   std::map<ort_tensor_key_t, ov_tensor_data_t> ort_ov_tensor_map;
+  std::mutex ort_ov_tensor_map_mutex_;
 };
 
 class InferRequestsQueue {
@@ -3,6 +3,7 @@
 
 #include "qnn_model.h"
 
+#include <condition_variable>
 #include <iostream>
 #include "QnnOpDef.h"
 
@@ -185,7 +186,34 @@ Status QnnModel::SetupQnnInputOutput(const logging::Logger& logger) {
   return Status::OK();
 }
 
-Status QnnModel::ExecuteGraph(const Ort::KernelContext& context, const logging::Logger& logger) {
+namespace {
+// Completion of a graph submitted with QnnGraph_executeAsync, signaled by the notify callback of QNN.
+struct AsyncExecution {
+  std::mutex mutex;
+  std::condition_variable completed_cv;
+  bool completed = false;
+  Qnn_ErrorHandle_t status = QNN_GRAPH_NO_ERROR;
+
+  static void Notify(void* notify_param, Qnn_NotifyStatus_t notify_status) {
+    auto* execution = static_cast<AsyncExecution*>(notify_param);
+    {
+      std::lock_guard<std::mutex> lock(execution->mutex);
+      execution->status = notify_status.error;
+      execution->completed = true;
+    }
+    execution->completed_cv.notify_one();
+  }
+
+  Qnn_ErrorHandle_t Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    completed_cv.wait(lock, [this]() { return completed; });
+    return status;
+  }
+};
+}  // namespace
+
+Status QnnModel::ExecuteGraph(const Ort::KernelContext& context, const logging::Logger& logger,
+                              bool async_execution) {
   LOGS(logger, VERBOSE) << "QnnModel::ExecuteGraphs";
   const size_t num_inputs = context.GetInputCount();
   const size_t num_outputs = context.GetOutputCount();
@@ -244,7 +272,39 @@ Status QnnModel::ExecuteGraph(const Ort::KernelContext& context, const logging::
   auto profile_backend_handle = qnn_backend_manager_->GetQnnProfileHandle();
   Qnn_ErrorHandle_t execute_status = QNN_GRAPH_NO_ERROR;
 
-  {
+  bool executed = false;
+  if (async_execution && profile_backend_handle == nullptr && qnn_interface.graphExecuteAsync != nullptr &&
+      !async_execution_unsupported_) {
+    AsyncExecution execution;
+    {
+      // Only the submission is serialized. QNN queues the executions of the graph.
+      std::lock_guard<std::mutex> lock(graph_exec_mutex_);
+      execute_status = qnn_interface.graphExecuteAsync(graph_info_->Graph(),
+                                                       qnn_inputs.data(),
+                                                       static_cast<uint32_t>(qnn_inputs.size()),
+                                                       qnn_outputs.data(),
+                                                       static_cast<uint32_t>(qnn_outputs.size()),
+                                                       nullptr,
+                                                       nullptr,
+                                                       AsyncExecution::Notify,
+                                                       &execution);
+    }
+
+    if (QNN_GRAPH_ERROR_UNSUPPORTED_FEATURE == execute_status) {
+      LOGS(logger, WARNING) << "QNN backend does not support asynchronous execution of graph: "
+                            << graph_info_->Name() << ". Executing it synchronously.";
+      async_execution_unsupported_ = true;
+      execute_status = QNN_GRAPH_NO_ERROR;
+    } else {
+      // the input and output tensors must stay valid until the execution completes
+      if (QNN_GRAPH_NO_ERROR == execute_status) {
+        execute_status = execution.Wait();
+      }
+      executed = true;
+    }
+  }
+
+  if (!executed) {
     // Acquire mutex before calling graphExecute and profiling APIs to support calling session.Run()
     // from multiple threads.
     std::lock_guard<std::mutex> lock(graph_exec_mutex_);
@@ -8,6 +8,7 @@
 #include "core/common/status.h"
 #include "core/framework/node_unit.h"
 #include "core/graph/graph_viewer.h"
+#include <atomic>
 #include <mutex>
 #include "core/providers/qnn/builder/qnn_def.h"
 #include "core/providers/qnn/builder/qnn_model_wrapper.h"
@@ -43,7 +44,11 @@ class QnnModel {
 
   Status SetupQnnInputOutput(const logging::Logger& logger);
 
-  Status ExecuteGraph(const Ort::KernelContext& context, const logging::Logger& logger);
+  // Executes the graph on the inputs and outputs of the kernel context. With async_execution the graph is submitted
+  // with QnnGraph_executeAsync and only the submission holds the execution lock, so that concurrent runs prepare
+  // their inputs and process their outputs while the device executes the graph. It still returns once the outputs
+  // are written. Falls back to QnnGraph_execute if the backend does not support it or profiling is enabled.
+  Status ExecuteGraph(const Ort::KernelContext& context, const logging::Logger& logger, bool async_execution = false);
 
   const OnnxTensorInfo* GetOutputInfo(const std::string& name) const {
     auto it = outputs_info_.find(name);
@@ -144,6 +149,8 @@ class QnnModel {
 
   // Mutex acquired during graph execution to support multi-threaded inference of a single session.
   std::mutex graph_exec_mutex_;
+  // set if the backend rejected QnnGraph_executeAsync for this graph
+  std::atomic<bool> async_execution_unsupported_{false};
 };
 
 }  // namespace qnn
@@ -384,13 +384,17 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
   model_settings_.offload_graph_io_quantization = ParseBoolOption("offload_graph_io_quantization", false,
                                                                   provider_options_map);
 
+  // Submit the graphs with QnnGraph_executeAsync, so that concurrent runs only serialize the submission and overlap
+  // their CPU work with the execution of the graph on the device.
+  enable_async_execution_ = ParseBoolOption("enable_async_execution", false, provider_options_map);
+
   if (disable_cpu_ep_fallback_ && model_settings_.offload_graph_io_quantization) {
     LOGS_DEFAULT(WARNING) << "Fallback to CPU EP is disabled, but user configured QNN EP to offload graph I/O "
                           << "quantization/dequantization to another EP. Session creation will fail if the CPU EP "
                           << "handles the graph I/O quantization/dequantization.";
   }
 
-  qnn_backend_manager_ = std::make_unique<qnn::QnnBackendManager>(
+  qnn_backend_manager_ = std::make_shared<qnn::QnnBackendManager>(
       std::move(backend_path),
       profiling_level_etw,
       profiling_level,
@@ -819,10 +823,12 @@ Status QNNExecutionProvider::CreateComputeFunc(std::vector<NodeComputeInfo>& nod
     ORT_UNUSED_PARAMETER(state);
   };
 
-  compute_info.compute_func = [&logger](FunctionState state, const OrtApi*, OrtKernelContext* context) {
+  compute_info.compute_func = [&logger, async_execution = enable_async_execution_](FunctionState state,
+                                                                                    const OrtApi*,
+                                                                                    OrtKernelContext* context) {
     Ort::KernelContext ctx(context);
     qnn::QnnModel* model = reinterpret_cast<qnn::QnnModel*>(state);
-    Status result = model->ExecuteGraph(ctx, logger);
+    Status result = model->ExecuteGraph(ctx, logger, async_execution);
     return result;
   };
 
@@ -922,13 +928,21 @@ Status QNNExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused
           const Node& fused_node = fused_node_and_graph.fused_node;
           const std::string& graph_meta_id = fused_node.Name();
           std::string key = ep_context_node->Name();
-          auto qnn_model_shared = SharedContext::GetInstance().GetSharedQnnModel(key);
+          std::shared_ptr<qnn::QnnBackendManager> shared_qnn_backend_manager;
+          auto qnn_model_shared = SharedContext::GetInstance().GetSharedQnnModel(key, shared_qnn_backend_manager);
           ORT_RETURN_IF(nullptr == qnn_model_shared, "Graph: " + key + " not found from shared EP contexts.");
+          // keep the context of the graph alive after the session that created it is released
+          if (std::find(shared_qnn_backend_managers_.begin(), shared_qnn_backend_managers_.end(),
+                        shared_qnn_backend_manager) == shared_qnn_backend_managers_.end()) {
+            shared_qnn_backend_managers_.push_back(std::move(shared_qnn_backend_manager));
+          }
           ORT_RETURN_IF_ERROR(qnn_model_shared->SetGraphInputOutputInfo(graph_viewer, fused_node, logger));
           ORT_RETURN_IF_ERROR(qnn_model_shared->SetupQnnInputOutput(logger));
           qnn_models_.emplace(graph_meta_id, std::move(qnn_model_shared));
           ORT_RETURN_IF_ERROR(CreateComputeFunc(node_compute_funcs, logger));
         }
+        // apply the HTP performance settings of this session to the backend that executes its graphs
+        qnn_backend_manager_ = shared_qnn_backend_managers_.front();
         return Status::OK();
       }
     }
@@ -987,6 +1001,7 @@ Status QNNExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused
       }
       std::string duplicate_graph_names;
       bool has_duplicate_graph = SharedContext::GetInstance().SetSharedQnnModel(std::move(shared_qnn_models),
+                                                                                qnn_backend_manager_,
                                                                                 duplicate_graph_names);
       ORT_RETURN_IF(has_duplicate_graph, "Duplicate graph names detect across sessions: " + duplicate_graph_names);
     }
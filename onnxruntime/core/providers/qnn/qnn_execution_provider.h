@@ -36,33 +36,40 @@ class SharedContext {
   }
 
   bool HasQnnModel(const std::string& model_name) {
+    const std::lock_guard<std::mutex> lock(mtx_);
     auto it = find_if(shared_qnn_models_.begin(), shared_qnn_models_.end(),
-                      [&model_name](const std::unique_ptr<qnn::QnnModel>& qnn_model) { return qnn_model->Name() == model_name; });
+                      [&model_name](const SharedQnnModel& shared) { return shared.qnn_model->Name() == model_name; });
     return it != shared_qnn_models_.end();
   }
 
-  std::unique_ptr<qnn::QnnModel> GetSharedQnnModel(const std::string& model_name) {
+  // Returns the shared QnnModel with the given name, and the backend manager owning the QNN context of its graph.
+  // The caller must keep a reference to the backend manager for as long as it uses the QnnModel, so that the context
+  // outlives the session that created it.
+  std::unique_ptr<qnn::QnnModel> GetSharedQnnModel(const std::string& model_name,
+                                                   std::shared_ptr<qnn::QnnBackendManager>& qnn_backend_manager) {
     const std::lock_guard<std::mutex> lock(mtx_);
     auto it = find_if(shared_qnn_models_.begin(), shared_qnn_models_.end(),
-                      [&model_name](const std::unique_ptr<qnn::QnnModel>& qnn_model) { return qnn_model->Name() == model_name; });
+                      [&model_name](const SharedQnnModel& shared) { return shared.qnn_model->Name() == model_name; });
     if (it == shared_qnn_models_.end()) {
       return nullptr;
     }
-    auto qnn_model = std::move(*it);
+    auto qnn_model = std::move(it->qnn_model);
+    qnn_backend_manager = std::move(it->qnn_backend_manager);
     shared_qnn_models_.erase(it);
     return qnn_model;
   }
 
   bool SetSharedQnnModel(std::vector<std::unique_ptr<qnn::QnnModel>>&& shared_qnn_models,
+                         const std::shared_ptr<qnn::QnnBackendManager>& qnn_backend_manager,
                          std::string& duplicate_graph_names) {
     const std::lock_guard<std::mutex> lock(mtx_);
     bool graph_exist = false;
     for (auto& shared_qnn_model : shared_qnn_models) {
       auto& model_name = shared_qnn_model->Name();
       auto it = find_if(shared_qnn_models_.begin(), shared_qnn_models_.end(),
-                        [&model_name](const std::unique_ptr<qnn::QnnModel>& qnn_model) { return qnn_model->Name() == model_name; });
+                        [&model_name](const SharedQnnModel& shared) { return shared.qnn_model->Name() == model_name; });
       if (it == shared_qnn_models_.end()) {
-        shared_qnn_models_.push_back(std::move(shared_qnn_model));
+        shared_qnn_models_.push_back(SharedQnnModel{std::move(shared_qnn_model), qnn_backend_manager});
       } else {
         duplicate_graph_names.append(model_name + " ");
         graph_exist = true;
@@ -78,7 +85,13 @@ class SharedContext {
   SharedContext(const SharedContext&) = delete;
   SharedContext& operator=(const SharedContext&) = delete;
 
-  std::vector<std::unique_ptr<qnn::QnnModel>> shared_qnn_models_;
+  struct SharedQnnModel {
+    std::unique_ptr<qnn::QnnModel> qnn_model;
+    // owns the QNN context that contains the graph of qnn_model
+    std::shared_ptr<qnn::QnnBackendManager> qnn_backend_manager;
+  };
+
+  std::vector<SharedQnnModel> shared_qnn_models_;
   // Producer sessions can be in parallel
   // Consumer sessions have to be after producer sessions initialized
   std::mutex mtx_;
@@ -134,7 +147,10 @@ class QNNExecutionProvider : public IExecutionProvider {
 
  private:
   qnn::HtpGraphFinalizationOptimizationMode htp_graph_finalization_opt_mode_ = qnn::HtpGraphFinalizationOptimizationMode::kDefault;
-  std::unique_ptr<qnn::QnnBackendManager> qnn_backend_manager_;
+  // shared with the sessions that use the QNN graphs of its contexts when ep.share_ep_contexts is enabled
+  std::shared_ptr<qnn::QnnBackendManager> qnn_backend_manager_;
+  // backend managers of other sessions owning the contexts of graphs this session takes from the shared EP contexts
+  std::vector<std::shared_ptr<qnn::QnnBackendManager>> shared_qnn_backend_managers_;
   std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> qnn_models_;
   bool context_cache_enabled_ = false;
   std::string context_cache_path_cfg_ = "";
@@ -149,6 +165,7 @@ class QNNExecutionProvider : public IExecutionProvider {
   uint32_t default_rpc_control_latency_ = 0;
   bool enable_HTP_FP16_precision_ = true;
   bool share_ep_contexts_ = false;
+  bool enable_async_execution_ = false;
   bool enable_spill_fill_buffer_ = false;
 #ifdef _WIN32
   onnxruntime::logging::EtwRegistrationManager::EtwInternalCallback callback_ETWSink_provider_ = nullptr;
@@ -3263,8 +3263,14 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
 
         // Build engine
         std::chrono::steady_clock::time_point engine_build_start;
+#if NV_TENSORRT_MAJOR >= 10
+        TensorrtProgressMonitor progress_monitor(trt_node_name_with_precision);
+#endif
         if (detailed_build_log_) {
           engine_build_start = std::chrono::steady_clock::now();
+#if NV_TENSORRT_MAJOR >= 10
+          trt_config->setProgressMonitor(&progress_monitor);
+#endif
         }
         std::unique_ptr<nvinfer1::IHostMemory> serialized_engine{trt_builder->buildSerializedNetwork(*trt_network, *trt_config)};
         if (serialized_engine == nullptr) {
@@ -3753,8 +3759,14 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       {
         auto lock = GetApiLock();
         std::chrono::steady_clock::time_point engine_build_start;
+#if NV_TENSORRT_MAJOR >= 10
+        TensorrtProgressMonitor progress_monitor(trt_state->trt_node_name_with_precision);
+#endif
         if (detailed_build_log_) {
           engine_build_start = std::chrono::steady_clock::now();
+#if NV_TENSORRT_MAJOR >= 10
+          trt_config->setProgressMonitor(&progress_monitor);
+#endif
         }
         serialized_engine = std::unique_ptr<nvinfer1::IHostMemory>(
             trt_builder->buildSerializedNetwork(*trt_state->network->get(), *trt_config));
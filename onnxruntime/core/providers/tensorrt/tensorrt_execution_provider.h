@@ -12,7 +12,10 @@ typedef void* cudnnStatus_t;
 #endif
 #include "core/providers/tensorrt/nv_includes.h"
 
+#include <chrono>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 #include "core/providers/cuda/cuda_graph.h"
 #include "tensorrt_execution_provider_info.h"
 
@@ -99,6 +102,56 @@ class TensorrtLogger : public nvinfer1::ILogger {
   }
 };
 
+#if NV_TENSORRT_MAJOR >= 10
+// Logs the progress of an engine build, with the time spent in each phase, when trt_detailed_build_log is enabled.
+// An engine build can take minutes for a large model, and TensorRT reports the phase it is in and how many of the
+// phase's steps (e.g. the layers being timed) are complete.
+class TensorrtProgressMonitor : public nvinfer1::IProgressMonitor {
+ public:
+  explicit TensorrtProgressMonitor(const std::string& node_name) : node_name_(node_name) {}
+
+  void phaseStart(const char* phase_name, const char* parent_phase, int32_t num_steps) noexcept override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    phases_[phase_name] = {std::chrono::steady_clock::now(), num_steps};
+    LOGS_DEFAULT(INFO) << "[TensorRT EP] Engine build for " << node_name_ << ": " << phase_name << " started"
+                       << (parent_phase ? std::string(" (in ") + parent_phase + ")" : std::string())
+                       << ", " << num_steps << " steps";
+  }
+
+  bool stepComplete(const char* phase_name, int32_t step) noexcept override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = phases_.find(phase_name);
+    if (it != phases_.end() && it->second.num_steps > 0) {
+      LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Engine build for " << node_name_ << ": " << phase_name << " step "
+                            << step + 1 << "/" << it->second.num_steps;
+    }
+    // returning false would cancel the build
+    return true;
+  }
+
+  void phaseFinish(const char* phase_name) noexcept override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = phases_.find(phase_name);
+    if (it != phases_.end()) {
+      auto elapsed = std::chrono::steady_clock::now() - it->second.start;
+      LOGS_DEFAULT(INFO) << "[TensorRT EP] Engine build for " << node_name_ << ": " << phase_name << " finished in "
+                         << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms";
+      phases_.erase(it);
+    }
+  }
+
+ private:
+  struct Phase {
+    std::chrono::steady_clock::time_point start;
+    int32_t num_steps;
+  };
+
+  std::string node_name_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, Phase> phases_;
+};
+#endif  // NV_TENSORRT_MAJOR >= 10
+
 namespace tensorrt_ptr {
 
 struct TensorrtInferDeleter {
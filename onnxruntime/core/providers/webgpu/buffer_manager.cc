@@ -126,6 +126,21 @@ constexpr std::initializer_list<std::pair<const size_t, size_t>> BUCKET_DEFAULT_
     {167772160, 6},
 };
 
+// Requests larger than the largest bucket are rounded up to one of 4 size classes per power of two, so that tensors
+// with dynamic shapes can reuse each other's buffers while wasting at most 25% of the buffer.
+constexpr size_t SIZE_CLASS_STEPS_PER_POWER_OF_TWO = 4;
+// Maximum number of cached buffers for each size class above the bucket table.
+constexpr size_t SIZE_CLASS_LIMIT = 2;
+
+constexpr size_t CalculateSizeClass(size_t size) {
+  size_t power_of_two = 1;
+  while (power_of_two <= size / 2) {
+    power_of_two *= 2;
+  }
+  const size_t step = std::max<size_t>(power_of_two / SIZE_CLASS_STEPS_PER_POWER_OF_TWO, 16);
+  return (size + step - 1) / step * step;
+}
+
 class BucketCacheManager : public IBufferCacheManager {
  public:
   BucketCacheManager() : buckets_limit_{BUCKET_DEFAULT_LIMIT_TABLE} {
@@ -139,7 +154,7 @@ class BucketCacheManager : public IBufferCacheManager {
     // binary serch size
     auto it = std::lower_bound(buckets_keys_.begin(), buckets_keys_.end(), request_size);
     if (it == buckets_keys_.end()) {
-      return NormalizeBufferSize(request_size);
+      return CalculateSizeClass(NormalizeBufferSize(request_size));
     } else {
       return *it;
     }
@@ -170,7 +185,14 @@ class BucketCacheManager : public IBufferCacheManager {
       auto buffer_size = wgpuBufferGetSize(buffer);
 
       auto it = buckets_.find(buffer_size);
-      if (it != buckets_.end() && it->second.size() < buckets_limit_[buffer_size]) {
+      const bool is_size_class = IsSizeClass(buffer_size);
+      if (it == buckets_.end() && is_size_class) {
+        // the first buffer of a size class above the bucket table
+        it = buckets_.emplace(buffer_size, std::vector<WGPUBuffer>()).first;
+      }
+
+      const size_t limit = is_size_class ? SIZE_CLASS_LIMIT : buckets_limit_[buffer_size];
+      if (it != buckets_.end() && it->second.size() < limit) {
         it->second.push_back(buffer);
       } else {
         wgpuBufferRelease(buffer);
@@ -181,6 +203,10 @@ class BucketCacheManager : public IBufferCacheManager {
   }
 
  protected:
+  bool IsSizeClass(size_t buffer_size) const {
+    return buckets_keys_.empty() || buffer_size > buckets_keys_.back();
+  }
+
   void Initialize() {
     buckets_keys_.reserve(buckets_limit_.size());
     buckets_.reserve(buckets_limit_.size());
@@ -278,6 +304,10 @@ void BufferManager::MemCpy(WGPUBuffer src, WGPUBuffer dst, size_t size) {
   auto& command_encoder = context_.GetCommandEncoder();
   context_.EndComputePass();
   command_encoder.CopyBufferToBuffer(src, 0, dst, 0, buffer_size);
+
+  if (context_.IsCapturingGraph()) {
+    context_.CaptureBufferCopy(src, dst, buffer_size);
+  }
 }
 
 WGPUBuffer BufferManager::Create(size_t size, wgpu::BufferUsage usage) {
@@ -286,6 +316,9 @@ WGPUBuffer BufferManager::Create(size_t size, wgpu::BufferUsage usage) {
 
   auto buffer = cache.TryAcquireCachedBuffer(buffer_size);
   if (buffer) {
+    if (context_.IsCapturingGraph()) {
+      graph_buffers_.insert(buffer);
+    }
     return buffer;
   }
 
@@ -299,10 +332,18 @@ WGPUBuffer BufferManager::Create(size_t size, wgpu::BufferUsage usage) {
   ORT_ENFORCE(buffer, "Failed to create GPU buffer: size=", buffer_size, ", usage=", uint64_t(usage), ".");
 
   cache.RegisterBuffer(buffer, size);
+  if (context_.IsCapturingGraph()) {
+    graph_buffers_.insert(buffer);
+  }
   return buffer;
 }
 
 void BufferManager::Release(WGPUBuffer buffer) {
+  if (graph_buffers_.erase(buffer) > 0) {
+    // keep the buffer alive for replaying the captured graph
+    released_graph_buffers_.push_back(buffer);
+    return;
+  }
   GetCacheManager(buffer).ReleaseBuffer(buffer);
 }
 
@@ -337,6 +378,15 @@ void BufferManager::RefreshPendingBuffers() {
   default_cache_->OnRefresh();
 }
 
+void BufferManager::ReleaseGraphBuffers() {
+  // buffers still in use are released to the caches by their owners as usual
+  graph_buffers_.clear();
+  for (auto& buffer : released_graph_buffers_) {
+    GetCacheManager(buffer).ReleaseBuffer(buffer);
+  }
+  released_graph_buffers_.clear();
+}
+
 IBufferCacheManager& BufferManager::GetCacheManager(WGPUBufferUsage usage) const {
   if (usage & WGPUBufferUsage_Storage) {
     return *storage_cache_;
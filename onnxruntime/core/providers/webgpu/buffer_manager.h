@@ -4,6 +4,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <unordered_set>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
@@ -35,6 +36,7 @@ std::ostream& operator<<(std::ostream& os, BufferCacheMode mode);
 // - LazyRelease: no cache. the difference from Disabled is that it delays the release of buffers until the next refresh.
 // - Simple: a simple cache that always keeps buffers. when a buffer is requested, it tries to find a buffer in the cache.
 // - Bucket: a cache that keeps buffers in different buckets based on the buffer size, with a maximum number of buffers in each bucket.
+//   Sizes above the largest bucket are rounded up to size classes (4 per power of two) which are cached as well.
 //
 class IBufferCacheManager {
  public:
@@ -70,6 +72,9 @@ class BufferManager {
   void Download(WGPUBuffer src, void* dst, size_t size);
   void RefreshPendingBuffers();
 
+  // Return the buffers owned by the captured graph to the caches. Should be called when the graph is discarded.
+  void ReleaseGraphBuffers();
+
  private:
   IBufferCacheManager& GetCacheManager(WGPUBufferUsage usage) const;
   IBufferCacheManager& GetCacheManager(WGPUBuffer buffer) const;
@@ -81,6 +86,11 @@ class BufferManager {
   std::unique_ptr<IBufferCacheManager> default_cache_;
 
   std::vector<wgpu::Buffer> pending_staging_buffers_;
+
+  // Buffers created while a graph is being captured are referenced by the recorded bind groups, so they are owned
+  // by the captured graph and not returned to the caches when released.
+  std::unordered_set<WGPUBuffer> graph_buffers_;
+  std::vector<WGPUBuffer> released_graph_buffers_;
 };
 
 class BufferManagerFactory {
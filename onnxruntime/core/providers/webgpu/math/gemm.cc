@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/gemm_helper.h"
+#include "core/providers/webgpu/math/gemm.h"
+#include "core/providers/webgpu/math/matmul_utils.h"
+#include "core/providers/webgpu/shader_helper.h"
+#include "core/providers/webgpu/webgpu_supported_types.h"
+
+namespace onnxruntime {
+namespace webgpu {
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(
+    Gemm,
+    kOnnxDomain,
+    7, 8,
+    kWebGpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", WebGpuSupportedFloatTypes()),
+    Gemm);
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(
+    Gemm,
+    kOnnxDomain,
+    9, 10,
+    kWebGpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", WebGpuSupportedFloatTypes()),
+    Gemm);
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(
+    Gemm,
+    kOnnxDomain,
+    11, 12,
+    kWebGpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", WebGpuSupportedFloatTypes()),
+    Gemm);
+
+ONNX_OPERATOR_KERNEL_EX(
+    Gemm,
+    kOnnxDomain,
+    13,
+    kWebGpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", WebGpuSupportedFloatTypes()),
+    Gemm);
+
+Status GemmProgram::GenerateShaderCode(ShaderHelper& shader) const {
+  const auto& a = shader.AddInput("a", ShaderUsage::UseUniform);
+  const auto& b = shader.AddInput("b", ShaderUsage::UseUniform);
+  if (has_c_) {
+    shader.AddInput("c", ShaderUsage::UseUniform);
+  }
+  const auto& output = shader.AddOutput("output", ShaderUsage::UseUniform | ShaderUsage::UseElementTypeAlias);
+
+  auto& impl = shader.AdditionalImplementation();
+  impl << "fn mm_init(batch: u32) {}\n"
+          "fn mm_read_a(row: u32, col: u32) -> mm_value_t {\n"
+          "  var value = mm_value_t(0);\n"
+          "  if (row < uniforms.dim_m) {\n";
+  if (trans_a_) {
+    impl << "    for (var i = 0u; i < 4u; i++) { if (col + i < uniforms.dim_k) { value[i] = "
+         << a.GetByOffset("(col + i) * uniforms.dim_m + row") << "; } }\n";
+  } else {
+    impl << "    let offset = row * uniforms.dim_k + col;\n"
+         << "    " << ReadRowVec4(a, "offset", "col", "uniforms.dim_k");
+  }
+  impl << "  }\n"
+          "  return value;\n"
+          "}\n"
+          "fn mm_read_b(row: u32, col: u32) -> mm_value_t {\n"
+          "  var value = mm_value_t(0);\n"
+          "  if (row < uniforms.dim_k) {\n";
+  if (trans_b_) {
+    impl << "    for (var i = 0u; i < 4u; i++) { if (col + i < uniforms.dim_n) { value[i] = "
+         << b.GetByOffset("(col + i) * uniforms.dim_k + row") << "; } }\n";
+  } else {
+    impl << "    let offset = row * uniforms.dim_n + col;\n"
+         << "    " << ReadRowVec4(b, "offset", "col", "uniforms.dim_n");
+  }
+  impl << "  }\n"
+          "  return value;\n"
+          "}\n"
+          "fn mm_write(row: u32, col: u32, value: mm_value_t) {\n"
+          "  if (row < uniforms.dim_m) {\n"
+          "    var result = value * output_element_t(uniforms.alpha);\n";
+  if (has_c_) {
+    // C is broadcast from (c_rows, c_cols), where c_rows is 1 or M and c_cols is 1 or N.
+    impl << "    let c_row_offset = (row % uniforms.c_rows) * uniforms.c_cols;\n"
+            "    for (var i = 0u; i < 4u; i++) {\n"
+            "      let c_col = min(col + i, uniforms.dim_n - 1u) % uniforms.c_cols;\n"
+            "      result[i] += output_element_t(uniforms.beta) * c[c_row_offset + c_col];\n"
+            "    }\n";
+  }
+  impl << "    let offset = row * uniforms.dim_n + col;\n"
+       << "    " << WriteRowVec4(output, "offset", "col", "uniforms.dim_n", "result")
+       << "  }\n"
+          "}\n";
+
+  GenerateTiledMatMulShaderCode(shader, "output_element_t");
+  return Status::OK();
+}
+
+Status Gemm::ComputeInternal(ComputeContext& context) const {
+  const auto* a = context.Input(0);
+  const auto* b = context.Input(1);
+  const auto* c = context.Input(2);
+
+  const bool trans_a = trans_A_ != CblasNoTrans;
+  const bool trans_b = trans_B_ != CblasNoTrans;
+  GemmHelper helper(a->Shape(), trans_a, b->Shape(), trans_b, c != nullptr ? c->Shape() : TensorShape({}));
+  ORT_RETURN_IF_ERROR(helper.State());
+
+  const uint32_t dim_m = gsl::narrow<uint32_t>(helper.M());
+  const uint32_t dim_n = gsl::narrow<uint32_t>(helper.N());
+  const uint32_t dim_k = gsl::narrow<uint32_t>(helper.K());
+
+  auto* output = context.Output(0, TensorShape({helper.M(), helper.N()}));
+  if (output->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const bool has_c = c != nullptr && beta_ != 0.0f;
+  uint32_t c_rows = 1;
+  uint32_t c_cols = 1;
+  if (has_c && c->Shape().Size() != 1) {
+    const auto& c_shape = c->Shape();
+    c_rows = c_shape.NumDimensions() == 2 ? gsl::narrow<uint32_t>(c_shape[0]) : 1;
+    c_cols = gsl::narrow<uint32_t>(c_shape[c_shape.NumDimensions() - 1]);
+  }
+
+  // Only row-major operands are contiguous along the K or N dimension read by one invocation.
+  const int a_components = !trans_a && dim_k % 4 == 0 ? 4 : 1;
+  const int b_components = !trans_b && dim_n % 4 == 0 ? 4 : 1;
+  const int output_components = dim_n % 4 == 0 ? 4 : 1;
+
+  GemmProgram program{trans_a, trans_b, has_c};
+  program
+      .CacheHint(trans_a, trans_b, has_c)
+      .AddInputs({{a, ProgramTensorMetadataDependency::Type, a_components},
+                  {b, ProgramTensorMetadataDependency::Type, b_components}})
+      .AddOutputs({{output, ProgramTensorMetadataDependency::Type, output_components}})
+      .SetWorkgroupSize(MATMUL_WORKGROUP_SIZE_X, MATMUL_WORKGROUP_SIZE_Y, 1)
+      .SetDispatchGroupSize((dim_n + MATMUL_TILE_N - 1) / MATMUL_TILE_N,
+                            (dim_m + MATMUL_TILE_M - 1) / MATMUL_TILE_M,
+                            1)
+      .AddUniformVariables({{dim_m}, {dim_n}, {dim_k}, {c_rows}, {c_cols}, {alpha_}, {beta_}});
+
+  if (has_c) {
+    program.AddInput({c, ProgramTensorMetadataDependency::Type});
+  }
+
+  return context.RunProgram(program);
+}
+
+}  // namespace webgpu
+}  // namespace onnxruntime
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cpu/math/gemm_base.h"
+#include "core/providers/webgpu/program.h"
+#include "core/providers/webgpu/webgpu_kernel.h"
+
+namespace onnxruntime {
+namespace webgpu {
+
+class GemmProgram final : public Program<GemmProgram> {
+ public:
+  GemmProgram(bool trans_a, bool trans_b, bool has_c) : Program{"Gemm"},
+                                                        trans_a_{trans_a},
+                                                        trans_b_{trans_b},
+                                                        has_c_{has_c} {}
+
+  Status GenerateShaderCode(ShaderHelper& sh) const override;
+
+  WEBGPU_PROGRAM_DEFINE_UNIFORM_VARIABLES(
+      {"dim_m", ProgramUniformVariableDataType::Uint32},
+      {"dim_n", ProgramUniformVariableDataType::Uint32},
+      {"dim_k", ProgramUniformVariableDataType::Uint32},
+      {"c_rows", ProgramUniformVariableDataType::Uint32},
+      {"c_cols", ProgramUniformVariableDataType::Uint32},
+      {"alpha", ProgramUniformVariableDataType::Float32},
+      {"beta", ProgramUniformVariableDataType::Float32});
+
+ private:
+  bool trans_a_;
+  bool trans_b_;
+  bool has_c_;
+};
+
+class Gemm final : public WebGpuKernel, public GemmBase {
+ public:
+  Gemm(const OpKernelInfo& info) : WebGpuKernel{info}, GemmBase{info} {}
+
+  Status ComputeInternal(ComputeContext& context) const override;
+};
+
+}  // namespace webgpu
+}  // namespace onnxruntime
@@ -0,0 +1,140 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/webgpu/math/matmul.h"
+#include "core/providers/webgpu/math/matmul_utils.h"
+#include "core/providers/webgpu/shader_helper.h"
+#include "core/providers/webgpu/webgpu_supported_types.h"
+
+namespace onnxruntime {
+namespace webgpu {
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(
+    MatMul,
+    kOnnxDomain,
+    1, 12,
+    kWebGpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", WebGpuSupportedFloatTypes()),
+    MatMul);
+
+ONNX_OPERATOR_KERNEL_EX(
+    MatMul,
+    kOnnxDomain,
+    13,
+    kWebGpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", WebGpuSupportedFloatTypes()),
+    MatMul);
+
+Status MatMulProgram::GenerateShaderCode(ShaderHelper& shader) const {
+  const auto& a = shader.AddInput("a", ShaderUsage::UseUniform);
+  const auto& b = shader.AddInput("b", ShaderUsage::UseUniform);
+  const auto& output = shader.AddOutput("output", ShaderUsage::UseUniform | ShaderUsage::UseElementTypeAlias);
+  const auto& batch_dims = shader.AddIndices("batch_dims");
+  const auto& a_batch_dims = shader.AddIndices("a_batch_dims");
+  const auto& b_batch_dims = shader.AddIndices("b_batch_dims");
+
+  // The batch offsets of the matrices only depend on the workgroup, so they are computed once in mm_init().
+  shader.AdditionalImplementation() << "var<private> a_offset: u32;\n"
+                                       "var<private> b_offset: u32;\n"
+                                       "var<private> output_offset: u32;\n"
+                                       "fn mm_init(batch: u32) {\n"
+                                    << "  let batch_indices = " << batch_dims.OffsetToIndices("batch") << ";\n"
+                                    << "  a_offset = " << a_batch_dims.BroadcastedIndicesToOffset("batch_indices", batch_dims) << " * uniforms.dim_m * uniforms.dim_k;\n"
+                                    << "  b_offset = " << b_batch_dims.BroadcastedIndicesToOffset("batch_indices", batch_dims) << " * uniforms.dim_k * uniforms.dim_n;\n"
+                                    << "  output_offset = batch * uniforms.dim_m * uniforms.dim_n;\n"
+                                       "}\n"
+                                       "fn mm_read_a(row: u32, col: u32) -> mm_value_t {\n"
+                                       "  var value = mm_value_t(0);\n"
+                                       "  if (row < uniforms.dim_m) {\n"
+                                       "    let offset = a_offset + row * uniforms.dim_k + col;\n"
+                                    << "    " << ReadRowVec4(a, "offset", "col", "uniforms.dim_k")
+                                    << "  }\n"
+                                       "  return value;\n"
+                                       "}\n"
+                                       "fn mm_read_b(row: u32, col: u32) -> mm_value_t {\n"
+                                       "  var value = mm_value_t(0);\n"
+                                       "  if (row < uniforms.dim_k) {\n"
+                                       "    let offset = b_offset + row * uniforms.dim_n + col;\n"
+                                    << "    " << ReadRowVec4(b, "offset", "col", "uniforms.dim_n")
+                                    << "  }\n"
+                                       "  return value;\n"
+                                       "}\n"
+                                       "fn mm_write(row: u32, col: u32, value: mm_value_t) {\n"
+                                       "  if (row < uniforms.dim_m) {\n"
+                                       "    let offset = output_offset + row * uniforms.dim_n + col;\n"
+                                    << "    " << WriteRowVec4(output, "offset", "col", "uniforms.dim_n", "value")
+                                    << "  }\n"
+                                       "}\n";
+
+  GenerateTiledMatMulShaderCode(shader, "output_element_t");
+  return Status::OK();
+}
+
+// Get the batch dimensions of a MatMul operand, which are {1} if the operand is a single matrix or vector.
+static TensorShape GetBatchShape(const TensorShape& shape) {
+  const size_t rank = shape.NumDimensions();
+  return rank > 2 ? shape.Slice(0, rank - 2) : TensorShape({1});
+}
+
+Status MatMul::ComputeInternal(ComputeContext& context) const {
+  const auto* a = context.Input(0);
+  const auto* b = context.Input(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  auto* output = context.Output(0, helper.OutputShape());
+
+  const int64_t output_size = helper.OutputShape().Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  const uint32_t dim_m = gsl::narrow<uint32_t>(helper.M());
+  const uint32_t dim_n = gsl::narrow<uint32_t>(helper.N());
+  const uint32_t dim_k = gsl::narrow<uint32_t>(helper.K());
+  const uint32_t batch_count = gsl::narrow<uint32_t>(output_size / (int64_t{dim_m} * dim_n));
+
+  // The helper folds the batch of A into M when B is a single matrix, in which case there is one batch.
+  TensorShape a_batch_shape{1};
+  TensorShape b_batch_shape{1};
+  TensorShape batch_shape{1};
+  if (batch_count > 1) {
+    a_batch_shape = GetBatchShape(a->Shape());
+    b_batch_shape = GetBatchShape(b->Shape());
+    const size_t rank = std::max(a_batch_shape.NumDimensions(), b_batch_shape.NumDimensions());
+    TensorShapeVector batch_dims(rank, 1);
+    for (size_t i = 0; i < rank; ++i) {
+      const int64_t a_dim = i < a_batch_shape.NumDimensions() ? a_batch_shape[a_batch_shape.NumDimensions() - 1 - i] : 1;
+      const int64_t b_dim = i < b_batch_shape.NumDimensions() ? b_batch_shape[b_batch_shape.NumDimensions() - 1 - i] : 1;
+      batch_dims[rank - 1 - i] = std::max(a_dim, b_dim);
+    }
+    batch_shape = TensorShape(batch_dims);
+  }
+
+  // Rows of A are read as vec4 when K is a multiple of 4 and rows of B and the output when N is.
+  const int a_components = dim_k % 4 == 0 ? 4 : 1;
+  const int b_components = dim_n % 4 == 0 ? 4 : 1;
+
+  MatMulProgram program{};
+  program
+      .CacheHint(absl::StrJoin({batch_shape.NumDimensions(), a_batch_shape.NumDimensions(), b_batch_shape.NumDimensions()}, ";"))
+      .AddInputs({{a, ProgramTensorMetadataDependency::Type, a_components},
+                  {b, ProgramTensorMetadataDependency::Type, b_components}})
+      .AddOutputs({{output, ProgramTensorMetadataDependency::Type, b_components}})
+      .AddIndices(batch_shape)
+      .AddIndices(a_batch_shape)
+      .AddIndices(b_batch_shape)
+      .SetWorkgroupSize(MATMUL_WORKGROUP_SIZE_X, MATMUL_WORKGROUP_SIZE_Y, 1)
+      .SetDispatchGroupSize((dim_n + MATMUL_TILE_N - 1) / MATMUL_TILE_N,
+                            (dim_m + MATMUL_TILE_M - 1) / MATMUL_TILE_M,
+                            batch_count)
+      .AddUniformVariables({{dim_m}, {dim_n}, {dim_k}});
+
+  return context.RunProgram(program);
+}
+
+}  // namespace webgpu
+}  // namespace onnxruntime
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/webgpu/math/matmul_utils.h"
+
+namespace onnxruntime {
+namespace webgpu {
+
+void GenerateTiledMatMulShaderCode(ShaderHelper& shader, std::string_view element_type) {
+  shader.AdditionalImplementation() << "alias mm_value_t = vec4<" << element_type << ">;\n"
+                                    << "const mm_tile_m: u32 = " << MATMUL_TILE_M << ";\n"
+                                    << "const mm_tile_n: u32 = " << MATMUL_TILE_N << ";\n"
+                                    << "const mm_tile_k: u32 = " << MATMUL_TILE_K << ";\n"
+                                    << "var<workgroup> tile_a: array<array<mm_value_t, mm_tile_k / 4>, mm_tile_m>;\n"
+                                       "var<workgroup> tile_b: array<array<mm_value_t, mm_tile_n / 4>, mm_tile_k>;\n";
+
+  // Each K step loads one slice of A and B into workgroup memory with every invocation of the workgroup, then
+  // every invocation accumulates its 4 rows x 4 columns from the shared slices.
+  shader.MainFunctionBody() << "  let batch = workgroup_id.z;\n"
+                               "  let row_base = workgroup_id.y * mm_tile_m;\n"
+                               "  let col_base = workgroup_id.x * mm_tile_n;\n"
+                               "  let thread_row = local_id.y * 4u;\n"
+                               "  let thread_col = local_id.x;\n"
+                               "  mm_init(batch);\n"
+                               "  var acc: array<mm_value_t, 4>;\n"
+                               "  let num_tiles = (uniforms.dim_k + mm_tile_k - 1u) / mm_tile_k;\n"
+                               "  for (var t = 0u; t < num_tiles; t++) {\n"
+                               "    let k_base = t * mm_tile_k;\n"
+                               "    for (var i = local_idx; i < mm_tile_m * mm_tile_k / 4u; i += workgroup_size_x * workgroup_size_y) {\n"
+                               "      let r = i / (mm_tile_k / 4u);\n"
+                               "      let c = i % (mm_tile_k / 4u);\n"
+                               "      tile_a[r][c] = mm_read_a(row_base + r, k_base + c * 4u);\n"
+                               "    }\n"
+                               "    for (var i = local_idx; i < mm_tile_k * mm_tile_n / 4u; i += workgroup_size_x * workgroup_size_y) {\n"
+                               "      let r = i / (mm_tile_n / 4u);\n"
+                               "      let c = i % (mm_tile_n / 4u);\n"
+                               "      tile_b[r][c] = mm_read_b(k_base + r, col_base + c * 4u);\n"
+                               "    }\n"
+                               "    workgroupBarrier();\n"
+                               "    for (var k = 0u; k < mm_tile_k / 4u; k++) {\n"
+                               "      let b0 = tile_b[k * 4u][thread_col];\n"
+                               "      let b1 = tile_b[k * 4u + 1u][thread_col];\n"
+                               "      let b2 = tile_b[k * 4u + 2u][thread_col];\n"
+                               "      let b3 = tile_b[k * 4u + 3u][thread_col];\n"
+                               "      for (var i = 0u; i < 4u; i++) {\n"
+                               "        let a = tile_a[thread_row + i][k];\n"
+                               "        acc[i] += b0 * a.x + b1 * a.y + b2 * a.z + b3 * a.w;\n"
+                               "      }\n"
+                               "    }\n"
+                               "    workgroupBarrier();\n"
+                               "  }\n"
+                               "  for (var i = 0u; i < 4u; i++) {\n"
+                               "    mm_write(row_base + thread_row + i, col_base + thread_col * 4u, acc[i]);\n"
+                               "  }\n";
+}
+
+std::string ReadRowVec4(const ShaderVariableHelper& var, std::string_view offset, std::string_view col, std::string_view cols) {
+  if (var.NumComponents() == 4) {
+    return MakeStringWithClassicLocale("if (", col, " < ", cols, ") { value = ",
+                                       var.GetByOffset(MakeStringWithClassicLocale("(", offset, ") / 4u")), "; }\n");
+  }
+  return MakeStringWithClassicLocale("for (var i = 0u; i < 4u; i++) { if (", col, " + i < ", cols, ") { value[i] = ",
+                                     var.GetByOffset(MakeStringWithClassicLocale(offset, " + i")), "; } }\n");
+}
+
+std::string WriteRowVec4(const ShaderVariableHelper& var, std::string_view offset, std::string_view col, std::string_view cols,
+                         std::string_view value) {
+  if (var.NumComponents() == 4) {
+    return MakeStringWithClassicLocale("if (", col, " < ", cols, ") { ",
+                                       var.SetByOffset(MakeStringWithClassicLocale("(", offset, ") / 4u"), value), " }\n");
+  }
+  return MakeStringWithClassicLocale("for (var i = 0u; i < 4u; i++) { if (", col, " + i < ", cols, ") { ",
+                                     var.SetByOffset(MakeStringWithClassicLocale(offset, " + i"),
+                                                     MakeStringWithClassicLocale("(", value, ")[i]")),
+                                     " } }\n");
+}
+
+}  // namespace webgpu
+}  // namespace onnxruntime
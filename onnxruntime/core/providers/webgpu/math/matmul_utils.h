@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/webgpu/shader_helper.h"
+
+namespace onnxruntime {
+namespace webgpu {
+
+// Tile sizes of the shared memory tiled matrix multiplication.
+//
+// A workgroup of MATMUL_WORKGROUP_SIZE_X x MATMUL_WORKGROUP_SIZE_Y invocations computes one MATMUL_TILE_M x
+// MATMUL_TILE_N block of the output. Each invocation computes a 4x4 block of it, so all tiles hold vec4 values.
+constexpr uint32_t MATMUL_TILE_M = 32;
+constexpr uint32_t MATMUL_TILE_N = 32;
+constexpr uint32_t MATMUL_TILE_K = 32;
+constexpr uint32_t MATMUL_WORKGROUP_SIZE_X = MATMUL_TILE_N / 4;
+constexpr uint32_t MATMUL_WORKGROUP_SIZE_Y = MATMUL_TILE_M / 4;
+
+// Generate the main function of C[M, N] = A[M, K] * B[K, N] for a batch of matrices.
+//
+// The program is dispatched with (ceil(N / MATMUL_TILE_N), ceil(M / MATMUL_TILE_M), batch_count) workgroups of
+// (MATMUL_WORKGROUP_SIZE_X, MATMUL_WORKGROUP_SIZE_Y, 1) invocations, and must define the uniforms "dim_m", "dim_n"
+// and "dim_k". The element type of the matrices is `element_type` and mm_value_t is a vec4 of it.
+//
+// The operands are accessed through the following functions, which the program implements in its additional
+// implementation. This lets the same loop serve MatMul, Gemm and the implicit GEMM of Conv.
+//
+//   fn mm_init(batch: u32)                                          // called once before any other function
+//   fn mm_read_a(row: u32, col: u32) -> mm_value_t                  // A[row, col..col+3], 0 out of bounds
+//   fn mm_read_b(row: u32, col: u32) -> mm_value_t                  // B[row, col..col+3], 0 out of bounds
+//   fn mm_write(row: u32, col: u32, value: mm_value_t)              // C[row, col..col+3], skip out of bounds
+//
+void GenerateTiledMatMulShaderCode(ShaderHelper& shader, std::string_view element_type);
+
+// Generate the WGSL statements reading the 4 consecutive elements at `offset` of `var` into the mm_value_t variable
+// "value", skipping the elements for which `col` + i is not below `cols`. If `var` has 4 components, `offset` and
+// `cols` must be multiples of 4 so that the elements are read as one vec4.
+std::string ReadRowVec4(const ShaderVariableHelper& var, std::string_view offset, std::string_view col, std::string_view cols);
+
+// Generate the WGSL statements writing the mm_value_t `value` to the 4 consecutive elements at `offset` of `var`, with
+// the same bounds and alignment requirements as ReadRowVec4().
+std::string WriteRowVec4(const ShaderVariableHelper& var, std::string_view offset, std::string_view col, std::string_view cols,
+                         std::string_view value);
+
+}  // namespace webgpu
+}  // namespace onnxruntime
@@ -0,0 +1,297 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/webgpu/nn/conv.h"
+#include "core/providers/webgpu/math/matmul_utils.h"
+#include "core/providers/webgpu/shader_helper.h"
+#include "core/providers/webgpu/webgpu_supported_types.h"
+
+namespace onnxruntime {
+namespace webgpu {
+
+Status ConvProgram::GenerateShaderCode(ShaderHelper& shader) const {
+  const auto& x = shader.AddInput("x", ShaderUsage::UseUniform);
+  const auto& w = shader.AddInput("w", ShaderUsage::UseUniform);
+  if (has_bias_) {
+    shader.AddInput("bias", ShaderUsage::UseUniform);
+  }
+  const auto& output = shader.AddOutput("output", ShaderUsage::UseUniform | ShaderUsage::UseElementTypeAlias);
+
+  auto& impl = shader.AdditionalImplementation();
+
+  // conv_input_pixel() returns the offset of the input pixel read by the output pixel at the kernel position, or -1
+  // if the input pixel is in the padding.
+  impl << "var<private> x_offset: u32;\n"
+          "var<private> w_offset: u32;\n"
+          "var<private> output_offset: u32;\n"
+          "var<private> filter_base: u32;\n"
+          "fn conv_input_pixel(pixel: u32, kernel_y: u32, kernel_x: u32) -> i32 {\n"
+          "  let output_y = pixel / uniforms.output_width;\n"
+          "  let output_x = pixel % uniforms.output_width;\n"
+          "  let input_y = i32(output_y * uniforms.strides[0] + kernel_y * uniforms.dilations[0]) - i32(uniforms.pads[0]);\n"
+          "  let input_x = i32(output_x * uniforms.strides[1] + kernel_x * uniforms.dilations[1]) - i32(uniforms.pads[1]);\n"
+          "  if (input_y < 0 || input_y >= i32(uniforms.input_shape[1]) || input_x < 0 || input_x >= i32(uniforms.input_shape[2])) {\n"
+          "    return -1;\n"
+          "  }\n"
+          "  return input_y * i32(uniforms.input_shape[2]) + input_x;\n"
+          "}\n"
+          "fn mm_init(batch: u32) {\n"
+          "  let n = batch / uniforms.group_shape[0];\n"
+          "  let g = batch % uniforms.group_shape[0];\n"
+          "  let input_size = uniforms.input_shape[1] * uniforms.input_shape[2];\n"
+          "  filter_base = g * uniforms.group_shape[2];\n"
+          "  w_offset = filter_base * uniforms.dim_k;\n";
+  if (is_channels_last_) {
+    impl << "  x_offset = n * input_size * uniforms.input_shape[0] + g * uniforms.group_shape[1];\n"
+            "  output_offset = n * uniforms.dim_m * uniforms.filter_shape[0] + filter_base;\n"
+            "}\n"
+            // A is the im2col matrix, with K ordered as (kernel_y, kernel_x, channel) to follow the input layout.
+            "fn mm_read_a(row: u32, col: u32) -> mm_value_t {\n"
+            "  var value = mm_value_t(0);\n"
+            "  if (row < uniforms.dim_m) {\n"
+            "    for (var i = 0u; i < 4u; i++) {\n"
+            "      let k = col + i;\n"
+            "      if (k < uniforms.dim_k) {\n"
+            "        let channel = k % uniforms.group_shape[1];\n"
+            "        let kernel_offset = k / uniforms.group_shape[1];\n"
+            "        let pixel = conv_input_pixel(row, kernel_offset / uniforms.filter_shape[2], kernel_offset % uniforms.filter_shape[2]);\n"
+            "        if (pixel >= 0) {\n"
+         << "          value[i] = " << x.GetByOffset("x_offset + u32(pixel) * uniforms.input_shape[0] + channel") << ";\n"
+         << "        }\n"
+            "      }\n"
+            "    }\n"
+            "  }\n"
+            "  return value;\n"
+            "}\n"
+            // B is the transposed filter, read with the K order of A.
+            "fn mm_read_b(row: u32, col: u32) -> mm_value_t {\n"
+            "  var value = mm_value_t(0);\n"
+            "  if (row < uniforms.dim_k) {\n"
+            "    let kernel_size = uniforms.filter_shape[1] * uniforms.filter_shape[2];\n"
+            "    let k = (row % uniforms.group_shape[1]) * kernel_size + row / uniforms.group_shape[1];\n"
+            "    for (var i = 0u; i < 4u; i++) {\n"
+            "      if (col + i < uniforms.dim_n) {\n"
+         << "        value[i] = " << w.GetByOffset("w_offset + (col + i) * uniforms.dim_k + k") << ";\n"
+         << "      }\n"
+            "    }\n"
+            "  }\n"
+            "  return value;\n"
+            "}\n"
+            "fn mm_write(row: u32, col: u32, value: mm_value_t) {\n"
+            "  if (row < uniforms.dim_m) {\n"
+            "    var result = value;\n";
+    if (has_bias_) {
+      impl << "    for (var i = 0u; i < 4u; i++) {\n"
+              "      result[i] += bias[filter_base + min(col + i, uniforms.dim_n - 1u)];\n"
+              "    }\n";
+    }
+    impl << "    let offset = output_offset + row * uniforms.filter_shape[0] + col;\n"
+         << "    " << WriteRowVec4(output, "offset", "col", "uniforms.dim_n", "result")
+         << "  }\n"
+            "}\n";
+  } else {
+    impl << "  x_offset = (n * uniforms.input_shape[0] + g * uniforms.group_shape[1]) * input_size;\n"
+            "  output_offset = (n * uniforms.filter_shape[0] + filter_base) * uniforms.dim_n;\n"
+            "}\n"
+            // A is the filter of the group.
+            "fn mm_read_a(row: u32, col: u32) -> mm_value_t {\n"
+            "  var value = mm_value_t(0);\n"
+            "  if (row < uniforms.dim_m) {\n"
+            "    let offset = w_offset + row * uniforms.dim_k + col;\n"
+         << "    " << ReadRowVec4(w, "offset", "col", "uniforms.dim_k")
+         << "  }\n"
+            "  return value;\n"
+            "}\n"
+            // B is the im2col matrix, with K ordered as (channel, kernel_y, kernel_x) to follow the filter layout.
+            "fn mm_read_b(row: u32, col: u32) -> mm_value_t {\n"
+            "  var value = mm_value_t(0);\n"
+            "  if (row < uniforms.dim_k) {\n"
+            "    let kernel_size = uniforms.filter_shape[1] * uniforms.filter_shape[2];\n"
+            "    let channel_offset = x_offset + (row / kernel_size) * uniforms.input_shape[1] * uniforms.input_shape[2];\n"
+            "    let kernel_offset = row % kernel_size;\n"
+            "    let kernel_y = kernel_offset / uniforms.filter_shape[2];\n"
+            "    let kernel_x = kernel_offset % uniforms.filter_shape[2];\n"
+            "    for (var i = 0u; i < 4u; i++) {\n"
+            "      if (col + i < uniforms.dim_n) {\n"
+            "        let pixel = conv_input_pixel(col + i, kernel_y, kernel_x);\n"
+            "        if (pixel >= 0) {\n"
+         << "          value[i] = " << x.GetByOffset("channel_offset + u32(pixel)") << ";\n"
+         << "        }\n"
+            "      }\n"
+            "    }\n"
+            "  }\n"
+            "  return value;\n"
+            "}\n"
+            "fn mm_write(row: u32, col: u32, value: mm_value_t) {\n"
+            "  if (row < uniforms.dim_m) {\n";
+    if (has_bias_) {
+      impl << "    let result = value + mm_value_t(bias[filter_base + row]);\n";
+    } else {
+      impl << "    let result = value;\n";
+    }
+    impl << "    let offset = output_offset + row * uniforms.dim_n + col;\n"
+         << "    " << WriteRowVec4(output, "offset", "col", "uniforms.dim_n", "result")
+         << "  }\n"
+            "}\n";
+  }
+
+  GenerateTiledMatMulShaderCode(shader, "output_element_t");
+  return Status::OK();
+}
+
+template <bool is_channels_last>
+Status Conv<is_channels_last>::ComputeInternal(ComputeContext& context) const {
+  const auto* input = context.Input(0);
+  const auto* weight = context.Input(1);
+  const auto* bias = context.InputCount() > 2 ? context.Input(2) : nullptr;
+
+  const auto& input_shape = input->Shape();
+  const auto& weight_shape = weight->Shape();
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(input_shape, weight_shape, is_channels_last));
+
+  TensorShapeVector kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(weight_shape, kernel_shape));
+  const size_t spatial_rank = kernel_shape.size();
+  if (spatial_rank == 0 || spatial_rank > 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Conv only supports 1D and 2D inputs. Kernel rank: ", spatial_rank);
+  }
+
+  ConvAttributes::ConvPadVector pads(conv_attrs_.pads);
+  if (pads.empty()) {
+    pads.resize(spatial_rank * 2, 0);
+  }
+  TensorShapeVector dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(spatial_rank, 1);
+  }
+  TensorShapeVector strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(spatial_rank, 1);
+  }
+
+  const size_t rank = input_shape.NumDimensions();
+  const int64_t batch_size = input_shape[0];
+  const int64_t channels = is_channels_last ? input_shape[rank - 1] : input_shape[1];
+  const int64_t filters = weight_shape[0];
+  const TensorShape input_spatial_shape = is_channels_last ? input_shape.Slice(1, rank - 1) : input_shape.Slice(2);
+
+  TensorShapeVector output_spatial_dims;
+  ORT_RETURN_IF_ERROR(conv_attrs_.InferPadsAndOutputShape(input_spatial_shape, kernel_shape, strides, dilations, pads,
+                                                          output_spatial_dims));
+
+  TensorShapeVector output_dims{batch_size};
+  if (!is_channels_last) {
+    output_dims.push_back(filters);
+  }
+  output_dims.insert(output_dims.end(), output_spatial_dims.begin(), output_spatial_dims.end());
+  if (is_channels_last) {
+    output_dims.push_back(filters);
+  }
+  auto* output = context.Output(0, TensorShape(output_dims));
+  if (output->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  if (bias != nullptr && bias->Shape().Size() != filters) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Conv bias size ", bias->Shape().Size(),
+                           " does not match the number of filters ", filters);
+  }
+
+  // A 1D convolution is a 2D convolution with an input height of 1.
+  const size_t x_dim = spatial_rank - 1;
+  auto height_of = [&](gsl::span<const int64_t> dims, int64_t default_value) {
+    return gsl::narrow<uint32_t>(spatial_rank == 2 ? dims[0] : default_value);
+  };
+
+  const uint32_t group = gsl::narrow<uint32_t>(conv_attrs_.group);
+  const uint32_t channels_per_group = gsl::narrow<uint32_t>(channels / conv_attrs_.group);
+  const uint32_t filters_per_group = gsl::narrow<uint32_t>(filters / conv_attrs_.group);
+  const uint32_t kernel_height = height_of(kernel_shape, 1);
+  const uint32_t kernel_width = gsl::narrow<uint32_t>(kernel_shape[x_dim]);
+  const uint32_t output_width = gsl::narrow<uint32_t>(output_spatial_dims[x_dim]);
+  const uint32_t output_size = gsl::narrow<uint32_t>(TensorShape(output_spatial_dims).Size());
+  const uint32_t dim_k = channels_per_group * kernel_height * kernel_width;
+
+  const std::vector<uint32_t> input_uniform{gsl::narrow<uint32_t>(channels),
+                                            height_of(input_spatial_shape.GetDims(), 1),
+                                            gsl::narrow<uint32_t>(input_spatial_shape[x_dim])};
+  const std::vector<uint32_t> filter_uniform{gsl::narrow<uint32_t>(filters), kernel_height, kernel_width};
+  const std::vector<uint32_t> group_uniform{group, channels_per_group, filters_per_group};
+  const std::vector<uint32_t> strides_uniform{height_of(strides, 1), gsl::narrow<uint32_t>(strides[x_dim])};
+  const std::vector<uint32_t> dilations_uniform{height_of(dilations, 1), gsl::narrow<uint32_t>(dilations[x_dim])};
+  const std::vector<uint32_t> pads_uniform{height_of(pads, 0), gsl::narrow<uint32_t>(pads[x_dim])};
+
+  // NCHW computes [filters_per_group, output_size] and NHWC [output_size, filters_per_group] for each batch.
+  const uint32_t dim_m = is_channels_last ? output_size : filters_per_group;
+  const uint32_t dim_n = is_channels_last ? filters_per_group : output_size;
+
+  // The filter rows are read as vec4 for NCHW when K is a multiple of 4, and the output rows when N is.
+  const int w_components = !is_channels_last && dim_k % 4 == 0 ? 4 : 1;
+  const int output_components = dim_n % 4 == 0 ? 4 : 1;
+
+  ConvProgram program{is_channels_last, bias != nullptr};
+  program
+      .CacheHint(is_channels_last)
+      .AddInputs({{input, ProgramTensorMetadataDependency::Type},
+                  {weight, ProgramTensorMetadataDependency::Type, w_components}})
+      .AddOutputs({{output, ProgramTensorMetadataDependency::Type, output_components}})
+      .SetWorkgroupSize(MATMUL_WORKGROUP_SIZE_X, MATMUL_WORKGROUP_SIZE_Y, 1)
+      .SetDispatchGroupSize((dim_n + MATMUL_TILE_N - 1) / MATMUL_TILE_N,
+                            (dim_m + MATMUL_TILE_M - 1) / MATMUL_TILE_M,
+                            gsl::narrow<uint32_t>(batch_size) * group)
+      .AddUniformVariables({{dim_m},
+                            {dim_n},
+                            {dim_k},
+                            {gsl::make_span(input_uniform)},
+                            {gsl::make_span(filter_uniform)},
+                            {gsl::make_span(group_uniform)},
+                            {gsl::make_span(strides_uniform)},
+                            {gsl::make_span(dilations_uniform)},
+                            {gsl::make_span(pads_uniform)},
+                            {output_width}});
+
+  if (bias != nullptr) {
+    program.AddInput({bias, ProgramTensorMetadataDependency::Type});
+  }
+
+  return context.RunProgram(program);
+}
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(
+    Conv,
+    kOnnxDomain,
+    1, 10,
+    kWebGpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", WebGpuSupportedFloatTypes()),
+    Conv<false>);
+
+ONNX_OPERATOR_KERNEL_EX(
+    Conv,
+    kOnnxDomain,
+    11,
+    kWebGpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", WebGpuSupportedFloatTypes()),
+    Conv<false>);
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(
+    Conv,
+    kMSInternalNHWCDomain,
+    1, 10,
+    kWebGpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", WebGpuSupportedFloatTypes()),
+    Conv<true>);
+
+ONNX_OPERATOR_KERNEL_EX(
+    Conv,
+    kMSInternalNHWCDomain,
+    11,
+    kWebGpuExecutionProvider,
+    (*KernelDefBuilder::Create())
+        .TypeConstraint("T", WebGpuSupportedFloatTypes()),
+    Conv<true>);
+
+}  // namespace webgpu
+}  // namespace onnxruntime
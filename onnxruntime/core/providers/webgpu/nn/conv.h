@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cpu/nn/conv_attributes.h"
+#include "core/providers/webgpu/program.h"
+#include "core/providers/webgpu/webgpu_kernel.h"
+
+namespace onnxruntime {
+namespace webgpu {
+
+// Computes a 2D convolution as an implicit GEMM for each image and group, without materializing the im2col matrix.
+//
+// For NCHW, A is the [filters_per_group, K] filter and B is the [K, output_size] im2col matrix of the input, where
+// K is channels_per_group * kernel_size. For NHWC, A is the [output_size, K] im2col matrix and B is the transposed
+// filter, so that the output channels are contiguous in both layouts.
+class ConvProgram final : public Program<ConvProgram> {
+ public:
+  ConvProgram(bool is_channels_last, bool has_bias) : Program{"Conv"},
+                                                      is_channels_last_{is_channels_last},
+                                                      has_bias_{has_bias} {}
+
+  Status GenerateShaderCode(ShaderHelper& sh) const override;
+
+  WEBGPU_PROGRAM_DEFINE_UNIFORM_VARIABLES(
+      {"dim_m", ProgramUniformVariableDataType::Uint32},
+      {"dim_n", ProgramUniformVariableDataType::Uint32},
+      {"dim_k", ProgramUniformVariableDataType::Uint32},
+      {"input_shape", ProgramUniformVariableDataType::Uint32},   // channels, height, width
+      {"filter_shape", ProgramUniformVariableDataType::Uint32},  // filters, kernel height, kernel width
+      {"group_shape", ProgramUniformVariableDataType::Uint32},   // group, channels per group, filters per group
+      {"strides", ProgramUniformVariableDataType::Uint32},
+      {"dilations", ProgramUniformVariableDataType::Uint32},
+      {"pads", ProgramUniformVariableDataType::Uint32},
+      {"output_width", ProgramUniformVariableDataType::Uint32});
+
+ private:
+  bool is_channels_last_;
+  bool has_bias_;
+};
+
+template <bool is_channels_last>
+class Conv final : public WebGpuKernel {
+ public:
+  Conv(const OpKernelInfo& info) : WebGpuKernel{info}, conv_attrs_{info} {}
+
+  Status ComputeInternal(ComputeContext& context) const override;
+
+ private:
+  ConvAttributes conv_attrs_;
+};
+
+}  // namespace webgpu
+}  // namespace onnxruntime
@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "core/common/binary_io.h"
+#include "core/common/logging/logging.h"
+#include "core/session/onnxruntime_c_api.h"
+
+#include "core/providers/webgpu/pipeline_cache.h"
+
+namespace onnxruntime {
+namespace webgpu {
+
+namespace {
+
+// File layout, after the header of core/common/binary_io.h with the adapter identity:
+//   uint64 number of entries
+//   per entry: string key, string value
+constexpr uint32_t kPipelineCacheFileMagic = 0x43505757;  // "WWPC"
+constexpr uint32_t kPipelineCacheFileVersion = 1;
+
+// how long the background thread waits for more blobs before writing the file
+constexpr auto kWriteBackDelay = std::chrono::seconds(2);
+
+std::string GetAdapterIdentity(const wgpu::AdapterInfo& adapter_info) {
+  std::ostringstream ss;
+  ss << "onnxruntime-" << ORT_API_VERSION
+     << "|" << static_cast<uint32_t>(adapter_info.backendType)
+     << "|" << std::string_view{adapter_info.vendor} << "|" << adapter_info.vendorID
+     << "|" << std::string_view{adapter_info.architecture}
+     << "|" << std::string_view{adapter_info.device} << "|" << adapter_info.deviceID
+     << "|" << std::string_view{adapter_info.description};
+  return ss.str();
+}
+
+// The file name must be stable across builds, so std::hash can't be used.
+uint64_t Fnv1aHash(std::string_view data) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (char c : data) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+PathString GetCacheFilePath(const PathString& directory, const std::string& identity) {
+  std::ostringstream file_name;
+  file_name << "webgpu_pipeline_cache_" << std::hex << std::setw(16) << std::setfill('0') << Fnv1aHash(identity)
+            << ".bin";
+  return (std::filesystem::path{directory} / file_name.str()).native();
+}
+
+}  // namespace
+
+PipelineCache::PipelineCache(const PathString& directory, const wgpu::AdapterInfo& adapter_info)
+    : identity_{GetAdapterIdentity(adapter_info)},
+      file_path_{GetCacheFilePath(directory, identity_)} {
+  std::error_code ec;
+  std::filesystem::create_directories(std::filesystem::path{directory}, ec);
+
+  auto status = LoadFile();
+  if (!status.IsOK()) {
+    // a missing or stale file is expected, and the cache starts empty
+    LOGS_DEFAULT(INFO) << "WebGPU pipeline cache not loaded: " << status.ErrorMessage();
+    entries_.clear();
+  } else {
+    LOGS_DEFAULT(VERBOSE) << "WebGPU pipeline cache loaded " << entries_.size() << " entries from "
+                          << PathToUTF8String(file_path_);
+  }
+
+  write_back_thread_ = std::thread(&PipelineCache::WriteBackThreadMain, this);
+}
+
+PipelineCache::~PipelineCache() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  write_back_cv_.notify_all();
+  write_back_thread_.join();
+
+  auto status = Flush();
+  if (!status.IsOK()) {
+    LOGS_DEFAULT(WARNING) << "Failed to save the WebGPU pipeline cache: " << status.ErrorMessage();
+  }
+}
+
+#if !defined(__EMSCRIPTEN__)
+void PipelineCache::Attach(wgpu::DawnCacheDeviceDescriptor& descriptor) {
+  descriptor.isolationKey = identity_.c_str();
+  descriptor.loadDataFunction = &PipelineCache::LoadData;
+  descriptor.storeDataFunction = &PipelineCache::StoreData;
+  descriptor.functionUserdata = this;
+}
+#endif
+
+size_t PipelineCache::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+// static
+size_t PipelineCache::LoadData(const void* key, size_t key_size, void* value, size_t value_size, void* userdata) {
+  auto* cache = static_cast<PipelineCache*>(userdata);
+  std::shared_ptr<const std::string> blob;
+  {
+    std::lock_guard<std::mutex> lock(cache->mutex_);
+    auto it = cache->entries_.find(std::string{static_cast<const char*>(key), key_size});
+    if (it == cache->entries_.end()) {
+      return 0;
+    }
+    blob = it->second;
+  }
+
+  // Dawn queries the size first, then calls again with a buffer of that size
+  if (value != nullptr && value_size >= blob->size()) {
+    std::memcpy(value, blob->data(), blob->size());
+  }
+  return blob->size();
+}
+
+// static
+void PipelineCache::StoreData(const void* key, size_t key_size, const void* value, size_t value_size,
+                              void* userdata) {
+  auto* cache = static_cast<PipelineCache*>(userdata);
+  auto blob = std::make_shared<const std::string>(static_cast<const char*>(value), value_size);
+  {
+    std::lock_guard<std::mutex> lock(cache->mutex_);
+    cache->entries_[std::string{static_cast<const char*>(key), key_size}] = std::move(blob);
+    cache->dirty_ = true;
+  }
+  cache->write_back_cv_.notify_all();
+}
+
+Status PipelineCache::Flush() {
+  Entries snapshot;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!dirty_) {
+      return Status::OK();
+    }
+    snapshot = entries_;
+    dirty_ = false;
+  }
+
+  auto status = SaveFile(snapshot);
+  if (!status.IsOK()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    dirty_ = true;
+  }
+  return status;
+}
+
+void PipelineCache::WriteBackThreadMain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    write_back_cv_.wait(lock, [this]() { return stop_ || dirty_; });
+    if (stop_) {
+      break;
+    }
+
+    // wait for the burst of pipelines created by the first runs of a session to finish
+    write_back_cv_.wait_for(lock, kWriteBackDelay, [this]() { return stop_; });
+    if (stop_) {
+      // the destructor flushes
+      break;
+    }
+
+    lock.unlock();
+    auto status = Flush();
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Failed to save the WebGPU pipeline cache: " << status.ErrorMessage();
+      lock.lock();
+      // don't retry until something changes
+      dirty_ = false;
+      continue;
+    }
+    lock.lock();
+  }
+}
+
+Status PipelineCache::LoadFile() {
+  std::ifstream in(std::filesystem::path{file_path_}, std::ios::binary);
+  ORT_RETURN_IF_NOT(in, "Failed to open ", PathToUTF8String(file_path_));
+
+  binary_io::StreamReader reader(in);
+  const auto header = binary_io::ReadHeader(reader, kPipelineCacheFileMagic, kPipelineCacheFileVersion, identity_);
+  ORT_RETURN_IF(header == binary_io::HeaderStatus::kInvalid,
+                "Invalid pipeline cache file: ", PathToUTF8String(file_path_));
+  ORT_RETURN_IF(header == binary_io::HeaderStatus::kIdentityMismatch,
+                "The pipeline cache file was created for a different adapter or driver.");
+
+  uint64_t num_entries = 0;
+  ORT_RETURN_IF_NOT(reader.ReadPod(num_entries), "Truncated pipeline cache file.");
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string key, value;
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    ORT_RETURN_IF_NOT(reader.ReadString(key) && reader.ReadString(value),
+                      "Truncated pipeline cache file.");
+    entries_[key] = std::make_shared<const std::string>(std::move(value));
+  }
+
+  return Status::OK();
+}
+
+Status PipelineCache::SaveFile(const Entries& entries) const {
+  std::lock_guard<std::mutex> lock(file_mutex_);
+
+  // write to a temporary file first so other processes never load a partially written cache
+  std::filesystem::path file_path{file_path_};
+  std::filesystem::path temp_path{file_path};
+  temp_path += ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(out, "Failed to open ", PathToUTF8String(temp_path.native()), " for writing.");
+
+    using namespace binary_io;
+    WriteHeader(out, kPipelineCacheFileMagic, kPipelineCacheFileVersion, identity_);
+    WritePod(out, static_cast<uint64_t>(entries.size()));
+    for (const auto& [key, value] : entries) {
+      WriteString(out, key);
+      WriteString(out, *value);
+    }
+
+    ORT_RETURN_IF_NOT(out.good(), "Failed to write ", PathToUTF8String(temp_path.native()));
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(temp_path, file_path, ec);
+  ORT_RETURN_IF(ec, "Failed to replace ", PathToUTF8String(file_path_), ": ", ec.message());
+  return Status::OK();
+}
+
+}  // namespace webgpu
+}  // namespace onnxruntime
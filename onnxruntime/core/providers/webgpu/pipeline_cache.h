@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+
+namespace onnxruntime {
+namespace webgpu {
+
+//
+// PipelineCache is a persistent store for the shader and pipeline blobs compiled by Dawn.
+//
+// WebGPU has no API to serialize a ComputePipeline, but Dawn caches the result of compiling a shader module and
+// creating a pipeline (including the driver pipeline cache) in a blob cache provided by the application. The blob
+// keys are derived from the shader code and pipeline state, which are determined by the program cache key, so
+// ProgramManager::Build in a new process gets the pipelines of the programs seen by earlier processes without
+// compiling them again.
+//
+// The blobs of one adapter are kept in a file in the cache directory. The file is named after, and validated against,
+// the adapter identity (backend, vendor, architecture, device and driver description) so a driver update or a
+// different GPU starts with an empty cache. The file is loaded on construction. New blobs are written back by a
+// background thread shortly after a burst of stores, and on destruction.
+//
+class PipelineCache {
+ public:
+  PipelineCache(const PathString& directory, const wgpu::AdapterInfo& adapter_info);
+  ~PipelineCache();
+
+#if !defined(__EMSCRIPTEN__)
+  // Registers the cache in `descriptor`, which must be chained into the device descriptor.
+  // The cache must outlive the device.
+  void Attach(wgpu::DawnCacheDeviceDescriptor& descriptor);
+#endif
+
+  // Writes the cache file if there are blobs that are not saved yet.
+  Status Flush();
+
+  size_t Size() const;
+  const PathString& FilePath() const { return file_path_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PipelineCache);
+
+  using Entries = std::unordered_map<std::string, std::shared_ptr<const std::string>>;
+
+  static size_t LoadData(const void* key, size_t key_size, void* value, size_t value_size, void* userdata);
+  static void StoreData(const void* key, size_t key_size, const void* value, size_t value_size, void* userdata);
+
+  Status LoadFile();
+  Status SaveFile(const Entries& entries) const;
+  void WriteBackThreadMain();
+
+  const std::string identity_;
+  const PathString file_path_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable write_back_cv_;
+  // the values are shared with the snapshot being written by the background thread
+  Entries entries_;
+  bool dirty_ = false;
+  bool stop_ = false;
+
+  // serializes writing the file
+  mutable std::mutex file_mutex_;
+  std::thread write_back_thread_;
+};
+
+}  // namespace webgpu
+}  // namespace onnxruntime
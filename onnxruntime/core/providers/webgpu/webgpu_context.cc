@@ -25,8 +25,9 @@
 namespace onnxruntime {
 namespace webgpu {
 
-void WebGpuContext::Initialize(const WebGpuBufferCacheConfig& buffer_cache_config, int backend_type) {
-  std::call_once(init_flag_, [this, &buffer_cache_config, backend_type]() {
+void WebGpuContext::Initialize(const WebGpuBufferCacheConfig& buffer_cache_config, int backend_type,
+                               const PathString& pipeline_cache_dir) {
+  std::call_once(init_flag_, [this, &buffer_cache_config, backend_type, &pipeline_cache_dir]() {
     // Create wgpu::Adapter
     if (adapter_ == nullptr) {
 #if !defined(__EMSCRIPTEN__) && defined(_MSC_VER) && defined(DAWN_ENABLE_D3D12) && !defined(USE_EXTERNAL_DAWN)
@@ -75,12 +76,29 @@ void WebGpuContext::Initialize(const WebGpuBufferCacheConfig& buffer_cache_confi
       ORT_ENFORCE(adapter_ != nullptr, "Failed to get a WebGPU adapter.");
     }
 
+    // cache adapter info
+    ORT_ENFORCE(Adapter().GetInfo(&adapter_info_));
+
     // Create wgpu::Device
     if (device_ == nullptr) {
       wgpu::DeviceDescriptor device_desc = {};
       wgpu::DawnTogglesDescriptor device_toggles_desc = {};
       device_desc.nextInChain = &device_toggles_desc;
 
+#if !defined(__EMSCRIPTEN__)
+      // Dawn looks up the compiled shaders and pipelines in the persistent cache before compiling them
+      wgpu::DawnCacheDeviceDescriptor cache_desc = {};
+      if (!pipeline_cache_dir.empty()) {
+        pipeline_cache_ = std::make_unique<PipelineCache>(pipeline_cache_dir, adapter_info_);
+        pipeline_cache_->Attach(cache_desc);
+        device_toggles_desc.nextInChain = &cache_desc;
+      }
+#else
+      if (!pipeline_cache_dir.empty()) {
+        LOGS_DEFAULT(WARNING) << "The WebGPU pipeline cache is not supported in the browser.";
+      }
+#endif
+
       auto enabled_device_toggles = GetEnabledDeviceToggles();
       device_toggles_desc.enabledToggleCount = enabled_device_toggles.size();
       device_toggles_desc.enabledToggles = enabled_device_toggles.data();
@@ -117,10 +135,9 @@ void WebGpuContext::Initialize(const WebGpuBufferCacheConfig& buffer_cache_confi
                                                                      &device_),
                                                                  UINT64_MAX));
       ORT_ENFORCE(device_ != nullptr, "Failed to get a WebGPU device.");
+    } else if (!pipeline_cache_dir.empty()) {
+      LOGS_DEFAULT(WARNING) << "The WebGPU pipeline cache is ignored because the device is provided by the application.";
     }
-
-    // cache adapter info
-    ORT_ENFORCE(Adapter().GetInfo(&adapter_info_));
     // cache device limits
     wgpu::SupportedLimits device_supported_limits;
     ORT_ENFORCE(Device().GetLimits(&device_supported_limits));
@@ -394,12 +411,14 @@ Status WebGpuContext::Run(ComputeContext& context, const ProgramBase& program) {
 
   auto bind_group = Device().CreateBindGroup(&bind_group_desc);
 
-  // TODO support graph capture
-
   compute_pass_encoder.SetPipeline(program_artifact->compute_pipeline);
   compute_pass_encoder.SetBindGroup(0, bind_group);
   compute_pass_encoder.DispatchWorkgroups(x, y, z);
 
+  if (is_capturing_graph_) {
+    captured_commands_.push_back({program_artifact->compute_pipeline, bind_group, {x, y, z}, nullptr, nullptr, 0});
+  }
+
   if (uniform_buffer) {
     buffer_mgr_->Release(uniform_buffer);
   }
@@ -408,11 +427,14 @@ Status WebGpuContext::Run(ComputeContext& context, const ProgramBase& program) {
 
   ++num_pending_dispatches_;
 
-  if (num_pending_dispatches_ >= max_num_pending_dispatches_ ||
-      (is_profiling_ && query_type_ == TimestampQueryType::AtPasses)) {
+  // Batch up to max_num_pending_dispatches_ dispatches while the GPU is busy with earlier submissions, but submit
+  // early when it has run out of work, so that CPU-side recording overlaps with GPU execution.
+  const bool flush = num_pending_dispatches_ >= max_num_pending_dispatches_ ||
+                     (num_pending_dispatches_ >= min_num_pending_dispatches_ && num_inflight_submissions_->load() == 0);
+  if (flush || (is_profiling_ && query_type_ == TimestampQueryType::AtPasses)) {
     EndComputePass();
   }
-  if (num_pending_dispatches_ >= max_num_pending_dispatches_) {
+  if (flush) {
     Flush();
     num_pending_dispatches_ = 0;
   }
@@ -637,11 +659,54 @@ void WebGpuContext::Flush() {
 
   auto command_buffer = current_command_encoder_.Finish();
   Device().GetQueue().Submit(1, &command_buffer);
+  num_inflight_submissions_->fetch_add(1);
+  Device().GetQueue().OnSubmittedWorkDone(wgpu::CallbackMode::AllowSpontaneous,
+                                          [num_inflight_submissions = num_inflight_submissions_](wgpu::QueueWorkDoneStatus /*status*/) {
+                                            num_inflight_submissions->fetch_sub(1);
+                                          });
   BufferManager().RefreshPendingBuffers();
   current_command_encoder_ = nullptr;
   num_pending_dispatches_ = 0;
 }
 
+void WebGpuContext::CaptureBegin() {
+  // submit the work recorded so far, which does not belong to the captured graph
+  Flush();
+  ReleaseGraphResources();
+  is_capturing_graph_ = true;
+}
+
+void WebGpuContext::CaptureEnd() {
+  is_capturing_graph_ = false;
+}
+
+void WebGpuContext::Replay() {
+  for (const auto& command : captured_commands_) {
+    if (command.compute_pipeline) {
+      const auto& compute_pass_encoder = GetComputePassEncoder();
+      compute_pass_encoder.SetPipeline(command.compute_pipeline);
+      compute_pass_encoder.SetBindGroup(0, command.bind_group);
+      compute_pass_encoder.DispatchWorkgroups(command.dispatch_group_size[0],
+                                              command.dispatch_group_size[1],
+                                              command.dispatch_group_size[2]);
+    } else {
+      auto& command_encoder = GetCommandEncoder();
+      EndComputePass();
+      command_encoder.CopyBufferToBuffer(command.copy_src, 0, command.copy_dst, 0, command.copy_size);
+    }
+  }
+  Flush();
+}
+
+void WebGpuContext::ReleaseGraphResources() {
+  captured_commands_.clear();
+  buffer_mgr_->ReleaseGraphBuffers();
+}
+
+void WebGpuContext::CaptureBufferCopy(WGPUBuffer src, WGPUBuffer dst, size_t size) {
+  captured_commands_.push_back({nullptr, nullptr, {0, 0, 0}, wgpu::Buffer{src}, wgpu::Buffer{dst}, size});
+}
+
 std::unordered_map<int32_t, WebGpuContextFactory::WebGpuContextInfo> WebGpuContextFactory::contexts_;
 std::mutex WebGpuContextFactory::mutex_;
 std::once_flag WebGpuContextFactory::init_default_flag_;
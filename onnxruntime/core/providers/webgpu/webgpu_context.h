@@ -7,15 +7,18 @@
 #include <emscripten/emscripten.h>
 #endif
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 
 #include <webgpu/webgpu_cpp.h>
 
 #include "core/common/common.h"
+#include "core/common/path_string.h"
 #include "core/framework/library_handles.h"
 #include "core/providers/webgpu/webgpu_execution_provider.h"
 #include "core/providers/webgpu/buffer_manager.h"
+#include "core/providers/webgpu/pipeline_cache.h"
 #include "core/providers/webgpu/program_manager.h"
 
 namespace onnxruntime {
@@ -72,7 +75,10 @@ class WebGpuContextFactory {
 // Class WebGpuContext includes all necessary resources for the context.
 class WebGpuContext final {
  public:
-  void Initialize(const WebGpuBufferCacheConfig& buffer_cache_config, int backend_type);
+  // `pipeline_cache_dir` enables the persistent pipeline cache if not empty. It only applies if the context creates
+  // the device.
+  void Initialize(const WebGpuBufferCacheConfig& buffer_cache_config, int backend_type,
+                  const PathString& pipeline_cache_dir);
 
   Status Wait(wgpu::Future f);
 
@@ -127,6 +133,17 @@ class WebGpuContext final {
 
   Status Run(ComputeContext& context, const ProgramBase& program);
 
+  // Graph capture: while capturing, the dispatches and buffer copies of a run are recorded in addition to being
+  // executed, so that the run can be replayed without re-encoding it. The captured graph keeps its bind groups,
+  // uniform buffers and intermediate buffers alive, so replay requires the inputs and outputs to be bound to the
+  // same buffers as in the captured run.
+  void CaptureBegin();
+  void CaptureEnd();
+  void Replay();
+  void ReleaseGraphResources();
+  bool IsCapturingGraph() const { return is_capturing_graph_; }
+  void CaptureBufferCopy(WGPUBuffer src, WGPUBuffer dst, size_t size);
+
  private:
   enum class TimestampQueryType {
     None = 0,
@@ -176,12 +193,25 @@ class WebGpuContext final {
     wgpu::Buffer query_buffer;
   };
 
+  // a dispatch or, if compute_pipeline is null, a buffer copy recorded by graph capture
+  struct CapturedCommand {
+    wgpu::ComputePipeline compute_pipeline;
+    wgpu::BindGroup bind_group;
+    uint32_t dispatch_group_size[3];
+    wgpu::Buffer copy_src;
+    wgpu::Buffer copy_dst;
+    uint64_t copy_size;
+  };
+
   friend class WebGpuContextFactory;
 
   std::once_flag init_flag_;
 
   LibraryHandles modules_;
 
+  // declared before the device so that it outlives it
+  std::unique_ptr<PipelineCache> pipeline_cache_;
+
   wgpu::Instance instance_;
   wgpu::Adapter adapter_;
   wgpu::Device device_;
@@ -199,6 +229,11 @@ class WebGpuContext final {
 
   uint32_t num_pending_dispatches_ = 0;
   const uint32_t max_num_pending_dispatches_ = 16;
+  // when the GPU has completed all submitted work, a smaller batch is flushed so that the GPU does not stay idle.
+  const uint32_t min_num_pending_dispatches_ = 4;
+  // number of submitted command buffers not completed by the GPU yet. It is shared with the work done callbacks,
+  // which may be called spontaneously after the context is destroyed.
+  std::shared_ptr<std::atomic<uint32_t>> num_inflight_submissions_ = std::make_shared<std::atomic<uint32_t>>(0);
 
   // profiling
   TimestampQueryType query_type_;
@@ -212,6 +247,10 @@ class WebGpuContext final {
 
   uint64_t gpu_timestamp_offset_ = 0;
   bool is_profiling_ = false;
+
+  // graph capture
+  bool is_capturing_graph_ = false;
+  std::vector<CapturedCommand> captured_commands_;
 };
 
 }  // namespace webgpu
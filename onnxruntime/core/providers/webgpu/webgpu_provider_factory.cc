@@ -219,6 +219,13 @@ std::shared_ptr<IExecutionProviderFactory> WebGpuProviderFactoryCreator::Create(
   buffer_cache_config.default_entry.mode = parse_buffer_cache_mode(kDefaultBufferCacheMode, webgpu::BufferCacheMode::Disabled);
   LOGS_DEFAULT(VERBOSE) << "WebGPU EP default buffer cache mode: " << buffer_cache_config.default_entry.mode;
 
+  PathString pipeline_cache_dir;
+  std::string pipeline_cache_dir_str;
+  if (config_options.TryGetConfigEntry(kPipelineCacheDirectory, pipeline_cache_dir_str)) {
+    pipeline_cache_dir = ToPathString(pipeline_cache_dir_str);
+  }
+  LOGS_DEFAULT(VERBOSE) << "WebGPU EP pipeline cache directory: \"" << pipeline_cache_dir_str << "\"";
+
   //
   // STEP.4 - start initialization.
   //
@@ -227,7 +234,7 @@ std::shared_ptr<IExecutionProviderFactory> WebGpuProviderFactoryCreator::Create(
   auto& context = webgpu::WebGpuContextFactory::CreateContext(context_config);
 
   // Create WebGPU device and initialize the context.
-  context.Initialize(buffer_cache_config, backend_type);
+  context.Initialize(buffer_cache_config, backend_type, pipeline_cache_dir);
 
   // Create WebGPU EP factory.
   return std::make_shared<WebGpuProviderFactory>(context_id, context, std::move(webgpu_ep_config));
@@ -30,6 +30,9 @@ constexpr const char* kValidationMode = "WebGPU:validationMode";
 
 constexpr const char* kForceCpuNodeNames = "WebGPU:forceCpuNodeNames";
 
+// Directory of the persistent pipeline cache. The cache is disabled if not set.
+constexpr const char* kPipelineCacheDirectory = "WebGPU:pipelineCacheDirectory";
+
 // The following are the possible values for the provider options.
 
 constexpr const char* kDawnBackendType_D3D12 = "D3D12";
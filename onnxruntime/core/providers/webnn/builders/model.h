@@ -6,6 +6,7 @@
 
 #include "core/common/inlined_containers.h"
 #include "core/common/status.h"
+#include <memory>
 #include <mutex>
 
 #include <emscripten.h>
@@ -24,6 +25,16 @@ struct OnnxTensorData {
   void* buffer{nullptr};
 };
 
+// A built WebNN graph with its input and output information. Sessions whose partitions have the same signature on the
+// same MLContext share one, see ModelBuilder::Compile().
+struct CompiledGraph {
+  emscripten::val context = emscripten::val::undefined();
+  emscripten::val graph = emscripten::val::undefined();
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+  InlinedHashMap<std::string, OnnxTensorInfo> input_output_info;
+};
+
 class Model {
   friend class ModelBuilder;
 
@@ -81,6 +92,9 @@ class Model {
 
   bool use_dispatch_;
 
+  // Keeps the shared graph cached while the model is alive.
+  std::shared_ptr<const CompiledGraph> compiled_graph_;
+
   Model(const emscripten::val& context, const emscripten::val& path, const logging::Logger& logger, bool use_dispatch);
 
   void SetInputOutputInfo(InlinedHashMap<std::string, OnnxTensorInfo>&& input_output_info) {
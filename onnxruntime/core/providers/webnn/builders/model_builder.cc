@@ -2,7 +2,10 @@
 // Copyright (c) Intel Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <fstream>
+#include <memory>
+#include <mutex>
 
 #include "model_builder.h"
 #include "model.h"
@@ -10,6 +13,7 @@
 #include "op_builder_factory.h"
 
 #include "core/common/safeint.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/providers/common.h"
 #include "core/providers/shared/utils/utils.h"
@@ -19,6 +23,61 @@
 namespace onnxruntime {
 namespace webnn {
 
+namespace {
+
+void HashString(const std::string& str, uint32_t (&hash)[4]) {
+  MurmurHash3::x86_128_append(str.data(), str.size(), hash);
+}
+
+// The graphs built by all the sessions of the process. An entry lives as long as one of the models using it, so
+// creating a second session for a model, e.g. on a page that reloads its pipeline, reuses the graph instead of
+// building it again. The entries are compared by MLContext too, a graph can only be dispatched on its own context.
+class CompiledGraphCache {
+ public:
+  static CompiledGraphCache& Instance() {
+    static CompiledGraphCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<const CompiledGraph> Find(const std::string& key, const emscripten::val& context) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return nullptr;
+    }
+
+    std::shared_ptr<const CompiledGraph> result;
+    auto& graphs = it->second;
+    graphs.erase(std::remove_if(graphs.begin(), graphs.end(),
+                                [&](const std::weak_ptr<const CompiledGraph>& entry) {
+                                  auto graph = entry.lock();
+                                  if (!graph) {
+                                    return true;
+                                  }
+                                  if (!result && graph->context.strictlyEquals(context)) {
+                                    result = std::move(graph);
+                                  }
+                                  return false;
+                                }),
+                 graphs.end());
+    if (graphs.empty()) {
+      entries_.erase(it);
+    }
+    return result;
+  }
+
+  void Add(const std::string& key, const std::shared_ptr<const CompiledGraph>& graph) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[key].push_back(graph);
+  }
+
+ private:
+  std::mutex mutex_;
+  InlinedHashMap<std::string, std::vector<std::weak_ptr<const CompiledGraph>>> entries_;
+};
+
+}  // namespace
+
 ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logger& logger,
                            const emscripten::val& context, const DataLayout preferred_layout,
                            const WebnnDeviceType wnn_device_type, const emscripten::val& wnn_limits)
@@ -356,23 +415,115 @@ Status ModelBuilder::RegisterModelOutputs() {
   return Status::OK();
 }
 
-Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
-  ORT_RETURN_IF_ERROR(Initialize());
-  emscripten::val named_operands = emscripten::val::object();
-  for (auto& name : output_names_) {
-    named_operands.set(name, wnn_operands_.at(name));
+std::string ModelBuilder::GetCompiledGraphKey() {
+  uint32_t hash[4] = {0, 0, 0, 0};
+
+  const auto device_type = static_cast<uint32_t>(wnn_device_type_);
+  MurmurHash3::x86_128_append(&device_type, sizeof(device_type), hash);
+  const auto layout = static_cast<uint32_t>(preferred_layout_);
+  MurmurHash3::x86_128_append(&layout, sizeof(layout), hash);
+
+  const auto hash_node_args = [&hash](const ConstPointerContainer<std::vector<NodeArg*>>& node_args) {
+    const uint64_t count = node_args.size();
+    MurmurHash3::x86_128_append(&count, sizeof(count), hash);
+    for (const auto* node_arg : node_args) {
+      HashString(node_arg->Exists() ? node_arg->Name() : std::string{}, hash);
+    }
+  };
+
+  for (const auto node_index : graph_viewer_.GetNodesInTopologicalOrder()) {
+    const auto* node = graph_viewer_.GetNode(node_index);
+    HashString(node->Domain(), hash);
+    HashString(node->OpType(), hash);
+    const int since_version = node->SinceVersion();
+    MurmurHash3::x86_128_append(&since_version, sizeof(since_version), hash);
+    hash_node_args(node->InputDefs());
+    hash_node_args(node->OutputDefs());
+
+    // the attributes are unordered
+    std::vector<std::string> attribute_names;
+    for (const auto& attribute : node->GetAttributes()) {
+      attribute_names.push_back(attribute.first);
+    }
+    std::sort(attribute_names.begin(), attribute_names.end());
+    for (const auto& name : attribute_names) {
+      HashString(node->GetAttributes().at(name).SerializeAsString(), hash);
+    }
+  }
+
+  for (const auto* inputs : {&graph_viewer_.GetInputs(), &graph_viewer_.GetOutputs()}) {
+    const uint64_t count = inputs->size();
+    MurmurHash3::x86_128_append(&count, sizeof(count), hash);
+    for (const auto* node_arg : *inputs) {
+      HashString(node_arg->Name(), hash);
+      const auto* type = node_arg->TypeAsProto();
+      HashString(type ? type->SerializeAsString() : std::string{}, hash);
+    }
+  }
+
+  // Initializers with external or in-memory data are keyed by their location, like the model references them.
+  const auto initializers = GetInitializerTensors();
+  std::vector<std::string> initializer_names;
+  initializer_names.reserve(initializers.size());
+  for (const auto& initializer : initializers) {
+    initializer_names.push_back(initializer.first);
+  }
+  std::sort(initializer_names.begin(), initializer_names.end());
+  for (const auto& name : initializer_names) {
+    HashString(name, hash);
+    const auto& tensor = *initializers.at(name);
+    if (tensor.has_raw_data()) {
+      // avoid serializing a copy of the weights
+      ONNX_NAMESPACE::TensorProto header = tensor;
+      header.clear_raw_data();
+      HashString(header.SerializeAsString(), hash);
+      HashString(tensor.raw_data(), hash);
+    } else {
+      HashString(tensor.SerializeAsString(), hash);
+    }
   }
 
-  emscripten::val wnn_graph = wnn_builder_.call<emscripten::val>("build", named_operands).await();
-  if (!wnn_graph.as<bool>()) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to build WebNN graph.");
+  std::ostringstream key;
+  key << std::hex << hash[0] << "_" << hash[1] << "_" << hash[2] << "_" << hash[3];
+  return key.str();
+}
+
+Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
+  // Identical partitions, e.g. of sessions created again for the same model, build identical graphs. Building a
+  // graph compiles it for the device, which for large models costs much more than hashing the weights.
+  const std::string cache_key = GetCompiledGraphKey();
+  std::shared_ptr<const CompiledGraph> compiled_graph = CompiledGraphCache::Instance().Find(cache_key, wnn_context_);
+  if (compiled_graph) {
+    LOGS(logger_, VERBOSE) << "Reusing the WebNN graph built for an identical partition";
+  } else {
+    ORT_RETURN_IF_ERROR(Initialize());
+    emscripten::val named_operands = emscripten::val::object();
+    for (auto& name : output_names_) {
+      named_operands.set(name, wnn_operands_.at(name));
+    }
+
+    emscripten::val wnn_graph = wnn_builder_.call<emscripten::val>("build", named_operands).await();
+    if (!wnn_graph.as<bool>()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to build WebNN graph.");
+    }
+
+    auto new_graph = std::make_shared<CompiledGraph>();
+    new_graph->context = wnn_context_;
+    new_graph->graph = std::move(wnn_graph);
+    new_graph->inputs = std::move(input_names_);
+    new_graph->outputs = std::move(output_names_);
+    new_graph->input_output_info = std::move(input_output_info_);
+    compiled_graph = std::move(new_graph);
+    CompiledGraphCache::Instance().Add(cache_key, compiled_graph);
   }
+
   // Explicitly release the WebNN builder to free memory.
   wnn_builder_ = emscripten::val::undefined();
-  model.reset(new Model(std::move(wnn_context_), std::move(wnn_graph), logger_, IsMLTensorSupported()));
-  model->SetInputs(std::move(input_names_));
-  model->SetOutputs(std::move(output_names_));
-  model->SetInputOutputInfo(std::move(input_output_info_));
+  model.reset(new Model(std::move(wnn_context_), compiled_graph->graph, logger_, IsMLTensorSupported()));
+  model->SetInputs(std::vector<std::string>(compiled_graph->inputs));
+  model->SetOutputs(std::vector<std::string>(compiled_graph->outputs));
+  model->SetInputOutputInfo(InlinedHashMap<std::string, OnnxTensorInfo>(compiled_graph->input_output_info));
+  model->compiled_graph_ = std::move(compiled_graph);
   // Wasm heap is not transferrable, we have to pre-allocate the MLNamedArrayBufferViews
   // for inputs and outputs because they will be transferred after compute() done.
   // https://webmachinelearning.github.io/webnn/#api-mlcontext-async-execution
@@ -100,6 +100,10 @@ class ModelBuilder {
   Status RegisterModelOutputs() ORT_MUST_USE_RESULT;
   Status RegisterModelInputOutput(const NodeArg& node_arg, bool is_input) ORT_MUST_USE_RESULT;
 
+  // The key of the graph in the compiled graph cache. It covers everything the built graph depends on: the device
+  // type and layout, the nodes and their attributes, the input and output types, and the initializer contents.
+  std::string GetCompiledGraphKey();
+
   static const IOpBuilder* GetOpBuilder(const Node& node);
 };
 
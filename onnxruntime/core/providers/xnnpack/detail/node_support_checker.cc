@@ -15,6 +15,7 @@
 #include "core/providers/xnnpack/detail/utils.h"
 
 // each operator provides a helper to check if supported
+#include "core/providers/xnnpack/math/binary_elementwise.h"
 #include "core/providers/xnnpack/math/gemm.h"
 #include "core/providers/xnnpack/math/matmul.h"
 #include "core/providers/xnnpack/math/softmax.h"
@@ -111,6 +112,10 @@ bool NodeSupportChecker::IsNodeSupported(const NodeUnit& nodeunit) {
       {"Resize", Resize::IsOnnxNodeSupported},
       {"Gemm", Gemm::IsOnnxNodeSupported},
       {"MatMul", MatMul::IsOnnxNodeSupported},
+      {"Add", BinaryElementwise::IsOnnxNodeSupported},
+      {"Sub", BinaryElementwise::IsOnnxNodeSupported},
+      {"Mul", BinaryElementwise::IsOnnxNodeSupported},
+      {"Div", BinaryElementwise::IsOnnxNodeSupported},
   };
 
   bool supported = false;
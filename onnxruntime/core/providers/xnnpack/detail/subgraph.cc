@@ -0,0 +1,242 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/xnnpack/detail/subgraph.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/framework/node_unit.h"
+#include "core/framework/op_node_proto_helper.h"
+#include "core/graph/constants.h"
+#include "core/graph/graph_viewer.h"
+#include "core/optimizer/initializer.h"
+#include "core/providers/xnnpack/detail/utils.h"
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace xnnpack {
+
+namespace {
+// the subgraph is planned once when it is compiled, so every dim must be known.
+bool IsStaticFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  const auto* shape = arg.Shape();
+  if (shape == nullptr || shape->dim_size() > XNN_MAX_TENSOR_DIMS) {
+    return false;
+  }
+
+  for (const auto& dim : shape->dim()) {
+    if (!dim.has_dim_value() || dim.dim_value() <= 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::vector<int64_t> GetStaticShape(const NodeArg& arg) {
+  std::vector<int64_t> dims;
+  for (const auto& dim : arg.Shape()->dim()) {
+    dims.push_back(dim.dim_value());
+  }
+  return dims;
+}
+}  // namespace
+
+bool IsSubgraphNodeSupported(const NodeUnit& node_unit, const GraphViewer& /*graph*/) {
+  bool supported = false;
+
+  // use do {} while(false) so it's easier to set a breakpoint on the return
+  do {
+    if (node_unit.UnitType() != NodeUnit::Type::SingleNode || node_unit.Domain() != kOnnxDomain) {
+      break;
+    }
+
+    const auto& inputs = node_unit.Inputs();
+    const auto& outputs = node_unit.Outputs();
+    if (outputs.size() != 1) {
+      break;
+    }
+
+    if (BinaryOperators().count(node_unit.OpType()) > 0) {
+      if (inputs.size() != 2) {
+        break;
+      }
+    } else if (node_unit.OpType() == "Softmax") {
+      // xnnpack normalizes the innermost dim, which only matches the opset 13 semantics of the axis
+      if (node_unit.SinceVersion() < 13 || inputs.size() != 1) {
+        break;
+      }
+
+      ProtoHelperNodeContext nc(node_unit.GetNode());
+      OpNodeProtoHelper info(&nc);
+      int64_t axis = -1;
+      info.GetAttrOrDefault<int64_t>("axis", &axis, -1);
+      const auto* x_shape = inputs[0].node_arg.Shape();
+      if (x_shape == nullptr || x_shape->dim_size() == 0 ||
+          (axis != -1 && axis != x_shape->dim_size() - 1)) {
+        break;
+      }
+    } else {
+      break;
+    }
+
+    bool all_static = IsStaticFloatTensor(outputs[0].node_arg);
+    for (const auto& input : inputs) {
+      all_static = all_static && IsStaticFloatTensor(input.node_arg);
+    }
+
+    if (!all_static) {
+      break;
+    }
+
+    supported = true;
+  } while (false);
+
+  return supported;
+}
+
+Status Subgraph::Create(const GraphViewer& graph_viewer, const Node& fused_node, pthreadpool* threadpool,
+                        std::unique_ptr<Subgraph>& subgraph) {
+  const auto& input_defs = fused_node.InputDefs();
+  const auto& output_defs = fused_node.OutputDefs();
+  const uint32_t num_inputs = gsl::narrow<uint32_t>(input_defs.size());
+  const uint32_t num_external_values = gsl::narrow<uint32_t>(input_defs.size() + output_defs.size());
+
+  xnn_subgraph_t xsubgraph = nullptr;
+  xnn_status xstatus = xnn_create_subgraph(num_external_values, 0, &xsubgraph);
+  ORT_RETURN_IF_NOT(xstatus == xnn_status_success, "xnn_create_subgraph failed. Status:", xstatus);
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> auto_subgraph(xsubgraph, xnn_delete_subgraph);
+
+  auto result = std::unique_ptr<Subgraph>(new Subgraph());
+  std::unordered_map<std::string, uint32_t> value_ids;
+
+  auto define_value = [&](const NodeArg& arg, const void* data, uint32_t external_id, uint32_t flags) -> Status {
+    std::vector<size_t> dims;
+    for (int64_t dim : GetStaticShape(arg)) {
+      dims.push_back(gsl::narrow<size_t>(dim));
+    }
+
+    uint32_t id = XNN_INVALID_VALUE_ID;
+    xstatus = xnn_define_tensor_value(xsubgraph, xnn_datatype_fp32, dims.size(), dims.data(), data,
+                                      external_id, flags, &id);
+    ORT_RETURN_IF_NOT(xstatus == xnn_status_success, "xnn_define_tensor_value for ", arg.Name(),
+                      " failed. Status:", xstatus);
+    value_ids[arg.Name()] = id;
+    return Status::OK();
+  };
+
+  // inputs that are not external are constant initializers, or values produced by an earlier node of the partition
+  auto get_value_id = [&](const NodeArg& arg, uint32_t& id) -> Status {
+    auto it = value_ids.find(arg.Name());
+    if (it == value_ids.end()) {
+      const auto* tensor = graph_viewer.GetConstantInitializer(arg.Name(), true);
+      ORT_RETURN_IF(tensor == nullptr, "Value ", arg.Name(), " is not produced in the subgraph.");
+
+      Initializer initializer(*tensor, graph_viewer.ModelPath());
+      auto values = initializer.DataAsSpan<float>();
+      result->static_data_.emplace_back(values.begin(), values.end());
+      ORT_RETURN_IF_ERROR(define_value(arg, result->static_data_.back().data(), XNN_INVALID_VALUE_ID, 0));
+      it = value_ids.find(arg.Name());
+    }
+
+    id = it->second;
+    return Status::OK();
+  };
+
+  for (uint32_t i = 0; i < num_inputs; ++i) {
+    ORT_RETURN_IF_ERROR(define_value(*input_defs[i], nullptr, i, XNN_VALUE_FLAG_EXTERNAL_INPUT));
+  }
+
+  for (size_t i = 0; i < output_defs.size(); ++i) {
+    result->output_shapes_.push_back(GetStaticShape(*output_defs[i]));
+    ORT_RETURN_IF_ERROR(define_value(*output_defs[i], nullptr, gsl::narrow<uint32_t>(num_inputs + i),
+                                     XNN_VALUE_FLAG_EXTERNAL_OUTPUT));
+  }
+
+  for (NodeIndex index : graph_viewer.GetNodesInTopologicalOrder()) {
+    const Node& node = *graph_viewer.GetNode(index);
+
+    std::vector<uint32_t> input_ids(node.InputDefs().size());
+    for (size_t i = 0; i < input_ids.size(); ++i) {
+      ORT_RETURN_IF_ERROR(get_value_id(*node.InputDefs()[i], input_ids[i]));
+    }
+
+    const NodeArg& output = *node.OutputDefs()[0];
+    if (value_ids.count(output.Name()) == 0) {
+      ORT_RETURN_IF_ERROR(define_value(output, nullptr, XNN_INVALID_VALUE_ID, 0));
+    }
+    const uint32_t output_id = value_ids[output.Name()];
+
+    if (const auto binary_operator = BinaryOperators().find(node.OpType());
+        binary_operator != BinaryOperators().end()) {
+      xstatus = xnn_define_binary(xsubgraph, binary_operator->second, /*params*/ nullptr,
+                                  input_ids[0], input_ids[1], output_id, 0);
+    } else if (node.OpType() == "Softmax") {
+      xstatus = xnn_define_softmax(xsubgraph, input_ids[0], output_id, 0);
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unsupported operator in xnnpack subgraph: ", node.OpType());
+    }
+
+    ORT_RETURN_IF_NOT(xstatus == xnn_status_success, "Defining ", node.OpType(), " node ", node.Name(),
+                      " in xnnpack subgraph failed. Status:", xstatus);
+  }
+
+  xnn_runtime_t runtime = nullptr;
+  xstatus = xnn_create_runtime_v3(xsubgraph, /*weights_cache*/ nullptr, threadpool, 0, &runtime);
+  ORT_RETURN_IF_NOT(xstatus == xnn_status_success, "xnn_create_runtime_v3 failed. Status:", xstatus);
+  result->runtime_.reset(runtime);
+
+  // the shapes are static, so the runtime only needs to plan its memory once
+  xstatus = xnn_reshape_runtime(runtime);
+  ORT_RETURN_IF_NOT(xstatus == xnn_status_success, "xnn_reshape_runtime failed. Status:", xstatus);
+
+  result->num_inputs_ = num_inputs;
+
+  subgraph = std::move(result);
+  return Status::OK();
+}
+
+Status Subgraph::Compute(OrtKernelContext* context) {
+  Ort::KernelContext ctx(context);
+  ORT_RETURN_IF_NOT(ctx.GetInputCount() == num_inputs_ && ctx.GetOutputCount() == output_shapes_.size(),
+                    "Inconsistent number of inputs or outputs for xnnpack subgraph");
+
+  std::vector<xnn_external_value> external_values(num_inputs_ + output_shapes_.size());
+  for (size_t i = 0; i < num_inputs_; ++i) {
+    external_values[i].id = gsl::narrow<uint32_t>(i);
+    external_values[i].data = const_cast<void*>(ctx.GetInput(i).GetTensorRawData());
+  }
+
+  for (size_t i = 0; i < output_shapes_.size(); ++i) {
+    const auto& shape = output_shapes_[i];
+    auto output = ctx.GetOutput(i, shape.data(), shape.size());
+    external_values[num_inputs_ + i].id = gsl::narrow<uint32_t>(num_inputs_ + i);
+    external_values[num_inputs_ + i].data = output.GetTensorMutableRawData();
+  }
+
+  // the runtime keeps the buffers from the setup until the next one, and owns the intermediate values,
+  // so concurrent runs of the session must take turns on it.
+  std::lock_guard<std::mutex> lock(runtime_mutex_);
+
+  xnn_status xstatus = xnn_setup_runtime_v2(runtime_.get(), external_values.size(), external_values.data());
+  ORT_RETURN_IF_NOT(xstatus == xnn_status_success, "xnn_setup_runtime_v2 failed. Status:", xstatus);
+
+  xstatus = xnn_invoke_runtime(runtime_.get());
+  ORT_RETURN_IF_NOT(xstatus == xnn_status_success, "xnn_invoke_runtime failed. Status:", xstatus);
+
+  return Status::OK();
+}
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/common/status.h"
+#include "core/session/onnxruntime_c_api.h"
+
+#include "xnnpack.h"
+
+struct pthreadpool;
+
+namespace onnxruntime {
+class GraphViewer;
+class Node;
+class NodeUnit;
+
+namespace xnnpack {
+
+// Returns true if the node unit can be defined in an XNNPACK subgraph.
+// Only fp32 nodes with fully known shapes are supported, as the subgraph is planned when the partition is compiled.
+bool IsSubgraphNodeSupported(const NodeUnit& node_unit, const GraphViewer& graph);
+
+// An XNNPACK runtime for a fused partition of the graph, created by XnnpackExecutionProvider::Compile.
+// XNNPACK owns the intermediate values of the partition and does its own memory planning for them, so ORT only
+// provides the buffers of the fused node's inputs and outputs on each run.
+class Subgraph {
+ public:
+  static Status Create(const GraphViewer& graph_viewer, const Node& fused_node, pthreadpool* threadpool,
+                       std::unique_ptr<Subgraph>& subgraph);
+
+  // Thread safe. Concurrent calls run the runtime one at a time.
+  Status Compute(OrtKernelContext* context);
+
+ private:
+  struct RuntimeDeleter {
+    void operator()(xnn_runtime_t p) const {
+      if (p != nullptr) {
+        xnn_delete_runtime(p);
+      }
+    }
+  };
+
+  std::unique_ptr<xnn_runtime, RuntimeDeleter> runtime_;
+  // external value ids are the index of the fused node's input, followed by the index of its output
+  size_t num_inputs_{0};
+  std::vector<std::vector<int64_t>> output_shapes_;
+  // the data of constant initializers must outlive the runtime
+  std::vector<std::vector<float>> static_data_;
+  // serializes the setup and invocation of runtime_ by concurrent runs
+  std::mutex runtime_mutex_;
+};
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
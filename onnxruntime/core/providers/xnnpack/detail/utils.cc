@@ -59,6 +59,16 @@ const char* TensorQtypeToString(enum TensorQuantType type) {
   }
 }
 
+const std::unordered_map<std::string, xnn_binary_operator>& BinaryOperators() {
+  static const std::unordered_map<std::string, xnn_binary_operator> operators{
+      {"Add", xnn_binary_add},
+      {"Sub", xnn_binary_subtract},
+      {"Mul", xnn_binary_multiply},
+      {"Div", xnn_binary_divide},
+  };
+  return operators;
+}
+
 bool GetType(const NodeArg& node_arg, int32_t& type) {
   type = ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED;
   const auto* type_proto = node_arg.TypeAsProto();
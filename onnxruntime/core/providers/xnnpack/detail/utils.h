@@ -107,6 +107,9 @@ OpQuantParam ParseQuantParamForOp(const OpKernelInfo& info, int32_t x_dtype, siz
 const char* TensorQtypeToString(enum TensorQuantType type);
 const char* OpTypeToString(OpComputeType opCtype);
 
+// The ONNX binary elementwise operators that map to an xnn_binary_operator, by op type.
+const std::unordered_map<std::string, xnn_binary_operator>& BinaryOperators();
+
 template <typename T>
 auto xnn_u8s8_quantize(float val, float scale, T zero_point) {
   auto typed_min = static_cast<float>(std::numeric_limits<T>::min());
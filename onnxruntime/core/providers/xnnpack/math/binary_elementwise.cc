@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/xnnpack/math/binary_elementwise.h"
+
+#include <vector>
+
+#include "core/framework/op_kernel.h"
+#include "core/providers/common.h"
+#include "core/providers/xnnpack/xnnpack_init.h"
+
+namespace onnxruntime {
+namespace xnnpack {
+
+namespace {
+bool IsShapeSupported(const ONNX_NAMESPACE::TensorShapeProto* shape) {
+  // the rank must be known so that the broadcast is handled by xnnpack; the dims may be symbolic.
+  return shape != nullptr && shape->dim_size() <= XNN_MAX_TENSOR_DIMS;
+}
+
+std::vector<size_t> ToXnnShape(const TensorShape& shape) {
+  std::vector<size_t> dims(shape.NumDimensions());
+  for (size_t i = 0; i < dims.size(); ++i) {
+    dims[i] = gsl::narrow<size_t>(shape[i]);
+  }
+  return dims;
+}
+}  // namespace
+
+bool BinaryElementwise::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& /*graph*/) {
+  bool supported = false;
+
+  // use do {} while(false) so it's easier to set a breakpoint on the return
+  do {
+    // QDQ node units are left to the CPU EP
+    if (node_unit.UnitType() != NodeUnit::Type::SingleNode) {
+      break;
+    }
+
+    const auto& inputs = node_unit.Inputs();
+    if (inputs.size() != 2) {
+      break;
+    }
+
+    const auto* a_type = inputs[0].node_arg.TypeAsProto();
+    const auto* b_type = inputs[1].node_arg.TypeAsProto();
+    if (a_type == nullptr || b_type == nullptr ||
+        (a_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+         a_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT16) ||
+        b_type->tensor_type().elem_type() != a_type->tensor_type().elem_type()) {
+      break;
+    }
+
+    if (!IsShapeSupported(inputs[0].node_arg.Shape()) || !IsShapeSupported(inputs[1].node_arg.Shape())) {
+      break;
+    }
+
+    supported = true;
+  } while (false);
+
+  return supported;
+}
+
+BinaryElementwise::BinaryElementwise(const OpKernelInfo& info) : XnnpackKernel{info} {
+  const auto& node = info.node();
+  int x_dtype = 0;
+  ORT_ENFORCE(GetType(*node.InputDefs()[0], x_dtype));
+
+  xnn_datatype datatype = xnn_datatype_invalid;
+  if (x_dtype == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    op_type_ = OpComputeType::op_compute_type_fp32;
+    datatype = xnn_datatype_fp32;
+  } else if (x_dtype == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16) {
+    op_type_ = OpComputeType::op_compute_type_fp16;
+    datatype = xnn_datatype_fp16;
+  } else {
+    auto stype = DataTypeImpl::ToString(DataTypeImpl::TypeFromProto(*node.InputDefs()[0]->TypeAsProto()));
+    ORT_THROW("unsupported compute type in ", node.OpType(), ", we have FLOAT|FLOAT16, but got ", stype);
+  }
+
+  const auto binary_operator = BinaryOperators().find(node.OpType());
+  ORT_ENFORCE(binary_operator != BinaryOperators().end(), "unsupported binary operator ", node.OpType());
+
+  struct xnn_operator* p = nullptr;
+  xnn_status xstatus = xnn_create_binary_elementwise_nd(binary_operator->second, datatype,
+                                                        nullptr,  // input1 quantization
+                                                        nullptr,  // input2 quantization
+                                                        nullptr,  // output quantization
+                                                        0,        // flags
+                                                        &p);
+  ORT_ENFORCE(xstatus == xnn_status_success, "xnn_create_binary_elementwise_nd for ", node.OpType(), " ",
+              OpTypeToString(op_type_), " failed. Status:", xstatus);
+  op0_.reset(p);
+}
+
+Status BinaryElementwise::Compute(OpKernelContext* ctx) const {
+  const auto* A = ctx->Input<Tensor>(0);
+  const auto* B = ctx->Input<Tensor>(1);
+
+  TensorShape output_shape;
+  ORT_RETURN_IF_ERROR(ComputeBroadcastOutputShape(Node().Name(), A->Shape(), B->Shape(), output_shape));
+  auto* Y = ctx->Output(0, output_shape);
+
+  // edge case. one or more dims with value of 0. nothing to do
+  if (output_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  pthreadpool_t threadpool = GetThreadPool();
+  const auto a_dims = ToXnnShape(A->Shape());
+  const auto b_dims = ToXnnShape(B->Shape());
+
+  xnn_status status = xnn_reshape_binary_elementwise_nd(op0_.get(), a_dims.size(), a_dims.data(),
+                                                        b_dims.size(), b_dims.data(), threadpool);
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_binary_elementwise_nd returned ", status);
+  }
+
+  status = xnn_setup_binary_elementwise_nd(op0_.get(), A->DataRaw(), B->DataRaw(), Y->MutableDataRaw());
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_binary_elementwise_nd returned ", status);
+  }
+
+  status = xnn_run_operator(op0_.get(), threadpool);
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
+  }
+
+  return Status::OK();
+}
+
+#define REGISTER_BINARY_ELEMENTWISE_KERNELS(Op)                                                                         \
+  ONNX_OPERATOR_VERSIONED_KERNEL_EX(Op, kOnnxDomain, 7, 12, kXnnpackExecutionProvider,                                  \
+                                    KernelDefBuilder().TypeConstraint("T", {DataTypeImpl::GetTensorType<float>(),       \
+                                                                            DataTypeImpl::GetTensorType<MLFloat16>()}), \
+                                    BinaryElementwise);                                                                 \
+  ONNX_OPERATOR_VERSIONED_KERNEL_EX(Op, kOnnxDomain, 13, 13, kXnnpackExecutionProvider,                                 \
+                                    KernelDefBuilder().TypeConstraint("T", {DataTypeImpl::GetTensorType<float>(),       \
+                                                                            DataTypeImpl::GetTensorType<MLFloat16>()}), \
+                                    BinaryElementwise);                                                                 \
+  ONNX_OPERATOR_KERNEL_EX(Op, kOnnxDomain, 14, kXnnpackExecutionProvider,                                               \
+                          KernelDefBuilder().TypeConstraint("T", {DataTypeImpl::GetTensorType<float>(),                 \
+                                                                  DataTypeImpl::GetTensorType<MLFloat16>()}),           \
+                          BinaryElementwise);
+
+REGISTER_BINARY_ELEMENTWISE_KERNELS(Add)
+REGISTER_BINARY_ELEMENTWISE_KERNELS(Sub)
+REGISTER_BINARY_ELEMENTWISE_KERNELS(Mul)
+REGISTER_BINARY_ELEMENTWISE_KERNELS(Div)
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/xnnpack/xnnpack_kernel.h"
+#include "core/framework/allocator.h"
+#include "core/providers/xnnpack/detail/utils.h"
+
+namespace onnxruntime {
+class GraphViewer;
+namespace xnnpack {
+
+// Add, Sub, Mul and Div with multidirectional broadcasting.
+class BinaryElementwise final : public XnnpackKernel {
+ public:
+  BinaryElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* ctx) const override;
+  static bool IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& graph);
+
+ private:
+  OpComputeType op_type_ = OpComputeType::op_compute_type_invalid;
+  XnnpackOperator op0_;
+};
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
@@ -13,9 +13,11 @@
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/qdq_selectors.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/shared/utils.h"
+#include "core/providers/partitioning_utils.h"
 #include "core/providers/xnnpack/xnnpack_execution_provider.h"
 #include "core/providers/xnnpack/detail/utils.h"
 #include "core/providers/xnnpack/detail/node_support_checker.h"
+#include "core/providers/xnnpack/detail/subgraph.h"
 #include "core/providers/xnnpack/xnnpack_init.h"
 
 namespace onnxruntime {
@@ -83,6 +85,22 @@ class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnx
 class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 11, 12, Softmax);
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, Softmax);
 
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 7, 12, Add);
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, 13, Add);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 14, Add);
+
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 7, 12, Sub);
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, 13, Sub);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 14, Sub);
+
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 7, 12, Mul);
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, 13, Mul);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 14, Mul);
+
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 7, 12, Div);
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, 13, Div);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 14, Div);
+
 // Internal domain
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kDynamicDomainByCreate, 1, QLinearSoftmax);
 
@@ -131,6 +149,22 @@ std::unique_ptr<KernelRegistry> RegisterKernels() {
       KERNEL_CREATE_INFO_VERSIONED(9, 12, MatMul, kOnnxDomain),
       KERNEL_CREATE_INFO(13, MatMul, kOnnxDomain),
 
+      KERNEL_CREATE_INFO_VERSIONED(7, 12, Add, kOnnxDomain),
+      KERNEL_CREATE_INFO_VERSIONED(13, 13, Add, kOnnxDomain),
+      KERNEL_CREATE_INFO(14, Add, kOnnxDomain),
+
+      KERNEL_CREATE_INFO_VERSIONED(7, 12, Sub, kOnnxDomain),
+      KERNEL_CREATE_INFO_VERSIONED(13, 13, Sub, kOnnxDomain),
+      KERNEL_CREATE_INFO(14, Sub, kOnnxDomain),
+
+      KERNEL_CREATE_INFO_VERSIONED(7, 12, Mul, kOnnxDomain),
+      KERNEL_CREATE_INFO_VERSIONED(13, 13, Mul, kOnnxDomain),
+      KERNEL_CREATE_INFO(14, Mul, kOnnxDomain),
+
+      KERNEL_CREATE_INFO_VERSIONED(7, 12, Div, kOnnxDomain),
+      KERNEL_CREATE_INFO_VERSIONED(13, 13, Div, kOnnxDomain),
+      KERNEL_CREATE_INFO(14, Div, kOnnxDomain),
+
       //  quantization op
       KERNEL_CREATE_INFO(1, QLinearAveragePool, kMSInternalNHWCDomain),
 
@@ -155,7 +189,7 @@ std::unique_ptr<KernelRegistry> RegisterKernels() {
 using namespace xnnpack;
 
 XnnpackExecutionProvider::XnnpackExecutionProvider(const XnnpackExecutionProviderInfo& info)
-    : IExecutionProvider{kXnnpackExecutionProvider} {
+    : IExecutionProvider{kXnnpackExecutionProvider}, enable_subgraph_{info.enable_subgraph} {
   int xnn_thread_pool_size = info.xnn_thread_pool_size;
   int ort_thread_pool_size = info.session_options ? info.session_options->intra_op_param.thread_pool_size : 1;
   bool allow_intra_op_spinning = (info.session_options == nullptr) ||
@@ -275,6 +309,50 @@ std::vector<std::unique_ptr<ComputeCapability>> XnnpackExecutionProvider::GetCap
   // to prevent nodes in a NodeUnit being checked for multiple times
   std::unordered_map<const NodeUnit*, bool> node_unit_supported_result;
   node_unit_supported_result.reserve(node_unit_holder.size());
+
+  // In the second call, runs of consecutive nodes (in topological order) that can be defined in an xnnpack subgraph
+  // are compiled into a single partition instead of using the static kernels. As the nodes are consecutive, no node
+  // outside of the partition can consume one of its outputs and produce one of its inputs, so fusing can't create a
+  // cycle.
+  std::vector<const NodeUnit*> subgraph_node_units;
+  auto add_subgraph_capability = [&]() {
+    if (subgraph_node_units.empty()) {
+      return;
+    }
+
+    auto add_capability = [&](std::unique_ptr<IndexedSubGraph> sub_graph) {
+      capabilities.push_back(std::make_unique<ComputeCapability>(std::move(sub_graph)));
+    };
+
+    if (subgraph_node_units.size() == 1) {
+      // not worth compiling, use the static kernel
+      AddComputeCapabilityForNodeUnit(*subgraph_node_units[0], add_capability, supported_node_unit_map);
+    } else {
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+      std::vector<const Node*> nodes;
+      for (const auto* subgraph_node_unit : subgraph_node_units) {
+        nodes.push_back(&subgraph_node_unit->GetNode());
+      }
+
+      const auto gen_metadef_name = [&]() {
+        HashValue model_hash;
+        int metadef_id = metadef_id_generator_.GenerateId(graph, model_hash);
+        return MakeString("XNNPACK_", model_hash, "_", metadef_id);
+      };
+
+      // constant initializers are copied into the xnnpack subgraph
+      capabilities.push_back(utils::MakeComputeCapability(graph, nodes, gen_metadef_name, "XNNPACK",
+                                                          /*drop_constant_initializers*/ true));
+#else
+      for (const auto* subgraph_node_unit : subgraph_node_units) {
+        AddComputeCapabilityForNodeUnit(*subgraph_node_unit, add_capability, supported_node_unit_map);
+      }
+#endif
+    }
+
+    subgraph_node_units.clear();
+  };
+
   for (NodeIndex idx : graph.GetNodesInTopologicalOrder()) {
     const Node* n = graph.GetNode(idx);
     if (n == nullptr) {
@@ -284,6 +362,15 @@ std::vector<std::unique_ptr<ComputeCapability>> XnnpackExecutionProvider::GetCap
     // we will mark it compatible in the first call as long as we support the target node.
     const NodeUnit& node_unit = *node_unit_map[n];
 
+    if (enable_subgraph_ && node_unit.GetNode().GetExecutionProviderType() == Type() &&
+        node_unit_supported_result.count(&node_unit) == 0 && xnnpack::IsSubgraphNodeSupported(node_unit, graph)) {
+      subgraph_node_units.push_back(&node_unit);
+      node_unit_supported_result[&node_unit] = true;
+      continue;
+    }
+
+    add_subgraph_capability();
+
     bool request_node = false;
     // any node in NodeUnit will trigger IsNodeSupported, so we just check once.
     if (node_unit_supported_result.count(&node_unit) > 0) {
@@ -343,18 +430,49 @@ std::vector<std::unique_ptr<ComputeCapability>> XnnpackExecutionProvider::GetCap
     }
   }
 
-  // FUTURE: finding nodes to compile can be inserted here and added to the ComputeCapability instances returned.
-  // GraphPartitioner can handle a mix of static and compiled kernels.
+  add_subgraph_capability();
 
   return capabilities;
 }
 
+common::Status XnnpackExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused_nodes_and_graphs,
+                                                 std::vector<NodeComputeInfo>& node_compute_funcs) {
+  for (const auto& fused_node_and_graph : fused_nodes_and_graphs) {
+    const Node& fused_node = fused_node_and_graph.fused_node;
+    std::unique_ptr<xnnpack::Subgraph> subgraph;
+    ORT_RETURN_IF_ERROR(xnnpack::Subgraph::Create(fused_node_and_graph.filtered_graph, fused_node,
+                                                  xnnpack_thread_pool_, subgraph));
+    subgraphs_.emplace(fused_node.Name(), std::move(subgraph));
+
+    NodeComputeInfo compute_info;
+    compute_info.create_state_func = [this](ComputeContext* context, FunctionState* state) {
+      *state = subgraphs_[context->node_name].get();
+      return 0;
+    };
+
+    compute_info.release_state_func = [](FunctionState state) {
+      // the `state` is a xnnpack::Subgraph managed by unique_ptr
+      ORT_UNUSED_PARAMETER(state);
+    };
+
+    compute_info.compute_func = [](FunctionState state, const OrtApi* /* api */, OrtKernelContext* context) {
+      return static_cast<xnnpack::Subgraph*>(state)->Compute(context);
+    };
+
+    node_compute_funcs.push_back(std::move(compute_info));
+  }
+
+  return Status::OK();
+}
+
 std::shared_ptr<KernelRegistry> XnnpackExecutionProvider::GetKernelRegistry() const {
   static std::shared_ptr<KernelRegistry> registry = xnnpack::RegisterKernels();
   return registry;
 }
 
 XnnpackExecutionProvider::~XnnpackExecutionProvider() {
+  // the runtimes must be deleted before xnnpack is deinitialized
+  subgraphs_.clear();
   xnn_deinitialize();
   pthreadpool_destroy(xnnpack_thread_pool_);
 }
@@ -4,16 +4,27 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "core/framework/execution_provider.h"
+#include "core/framework/model_metadef_id_generator.h"
 #include "core/graph/constants.h"
 #include "core/providers/providers.h"
 #include "core/framework/session_options.h"
 
 struct pthreadpool;
 namespace onnxruntime {
-// placeholder for future use. no options currently
+namespace xnnpack {
+class Subgraph;
+}
+
 struct XnnpackExecutionProviderInfo {
   int xnn_thread_pool_size{0};
+  // compile connected fp32 nodes into a single xnnpack subgraph instead of running one operator per node
+  bool enable_subgraph{false};
   const SessionOptions* session_options{nullptr};
   XnnpackExecutionProviderInfo() = default;
 
@@ -22,6 +33,9 @@ struct XnnpackExecutionProviderInfo {
     if (auto it = po.find("intra_op_num_threads"); it != po.end()) {
       xnn_thread_pool_size = std::stoi(it->second);
     }
+    if (auto it = po.find("enable_subgraph"); it != po.end()) {
+      enable_subgraph = it->second == "1";
+    }
   }
 };
 
@@ -34,6 +48,9 @@ class XnnpackExecutionProvider : public IExecutionProvider {
       const onnxruntime::GraphViewer& graph_viewer,
       const IKernelLookup& /*kernel_lookup*/) const override;
 
+  common::Status Compile(const std::vector<FusedNodeAndGraph>& fused_nodes_and_graphs,
+                         std::vector<NodeComputeInfo>& node_compute_funcs) override;
+
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
 
   DataLayout GetPreferredLayout() const override { return DataLayout::NHWC; }
@@ -51,6 +68,10 @@ class XnnpackExecutionProvider : public IExecutionProvider {
 
  private:
   pthreadpool* xnnpack_thread_pool_{nullptr};
+  bool enable_subgraph_{false};
+  ModelMetadefIdGenerator metadef_id_generator_;
+  // xnnpack runtimes of the compiled partitions, keyed by the name of the fused node
+  std::unordered_map<std::string, std::unique_ptr<xnnpack::Subgraph>> subgraphs_;
 };
 
 }  // namespace onnxruntime
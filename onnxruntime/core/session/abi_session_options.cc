@@ -84,6 +84,7 @@ ORT_API_STATUS_IMPL(OrtApis::SetSessionExecutionMode, _In_ OrtSessionOptions* op
   switch (execution_mode) {
     case ORT_SEQUENTIAL:
     case ORT_PARALLEL:
+    case ORT_PARALLEL_WORK_STEALING:
       options->value.execution_mode = execution_mode;
       break;
     default:
@@ -0,0 +1,267 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/dynamic_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/narrow.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+DynamicBatcher::DynamicBatcher(const Options& options, RunFn run_fn, AllocatorPtr cpu_allocator)
+    : options_(options), run_fn_(std::move(run_fn)), cpu_allocator_(std::move(cpu_allocator)) {
+  ORT_ENFORCE(options_.max_batch_size > 1, "Dynamic batching requires a max batch size greater than 1.");
+  ORT_ENFORCE(run_fn_ != nullptr && cpu_allocator_ != nullptr);
+}
+
+// static
+int64_t DynamicBatcher::GetBatchSize(gsl::span<const OrtValue> feeds) {
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return -1;
+    }
+
+    const auto& tensor = feed.Get<Tensor>();
+    // strings can't be concatenated with memcpy
+    if (tensor.IsDataTypeString() || tensor.Location().device.Type() != OrtDevice::CPU ||
+        tensor.Shape().NumDimensions() == 0) {
+      return -1;
+    }
+
+    const int64_t dim0 = tensor.Shape()[0];
+    if (dim0 <= 0 || (batch_size != -1 && dim0 != batch_size)) {
+      return -1;
+    }
+    batch_size = dim0;
+  }
+
+  return batch_size;
+}
+
+// static
+bool DynamicBatcher::HaveSameRunOptions(const RunOptions& a, const RunOptions& b) {
+  if (&a == &b) {
+    return true;
+  }
+
+#ifdef ENABLE_TRAINING
+  if (a.training_mode != b.training_mode) {
+    return false;
+  }
+#endif
+
+  return a.terminate == b.terminate && a.only_execute_path_to_fetches == b.only_execute_path_to_fetches &&
+         a.config_options.configurations == b.config_options.configurations &&
+         std::equal(a.active_adapters.begin(), a.active_adapters.end(),
+                    b.active_adapters.begin(), b.active_adapters.end());
+}
+
+// static
+bool DynamicBatcher::IsCompatible(const Request& a, const Request& b) {
+  if (!HaveSameRunOptions(*a.run_options, *b.run_options) ||
+      !std::equal(a.feed_names.begin(), a.feed_names.end(), b.feed_names.begin(), b.feed_names.end()) ||
+      !std::equal(a.output_names.begin(), a.output_names.end(), b.output_names.begin(), b.output_names.end())) {
+    return false;
+  }
+
+  for (size_t i = 0; i < a.feeds.size(); ++i) {
+    const auto& tensor_a = a.feeds[i].Get<Tensor>();
+    const auto& tensor_b = b.feeds[i].Get<Tensor>();
+    if (tensor_a.DataType() != tensor_b.DataType()) {
+      return false;
+    }
+
+    const auto dims_a = tensor_a.Shape().GetDims();
+    const auto dims_b = tensor_b.Shape().GetDims();
+    if (!std::equal(dims_a.begin() + 1, dims_a.end(), dims_b.begin() + 1, dims_b.end())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int64_t DynamicBatcher::CompatibleBatchSizeLocked(const Request& leader) const {
+  int64_t total = 0;
+  for (const Request* request : pending_) {
+    if (request == &leader || IsCompatible(leader, *request)) {
+      total += request->batch_size;
+    }
+  }
+  return total;
+}
+
+InlinedVector<DynamicBatcher::Request*> DynamicBatcher::TakeBatchLocked(Request& leader) {
+  InlinedVector<Request*> batch;
+  pending_.erase(std::find(pending_.begin(), pending_.end(), &leader));
+  leader.taken = true;
+  batch.push_back(&leader);
+
+  // the remaining requests are taken in arrival order
+  int64_t total = leader.batch_size;
+  for (auto it = pending_.begin(); it != pending_.end() && total < options_.max_batch_size;) {
+    Request* request = *it;
+    if (total + request->batch_size <= options_.max_batch_size && IsCompatible(leader, *request)) {
+      request->taken = true;
+      total += request->batch_size;
+      batch.push_back(request);
+      it = pending_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  if (options_.record_queue_wait) {
+    const auto now = std::chrono::steady_clock::now();
+    for (const Request* request : batch) {
+      options_.record_queue_wait(
+          std::chrono::duration_cast<std::chrono::microseconds>(now - request->enqueue_time));
+    }
+  }
+
+  return batch;
+}
+
+Status DynamicBatcher::ExecuteBatch(gsl::span<Request* const> batch) {
+  const Request& leader = *batch[0];
+  if (batch.size() == 1) {
+    return run_fn_(*leader.run_options, leader.feed_names, leader.feeds, leader.output_names, leader.fetches);
+  }
+
+  int64_t total = 0;
+  for (const Request* request : batch) {
+    total += request->batch_size;
+  }
+
+  // concatenate the inputs
+  std::vector<OrtValue> batched_feeds(leader.feeds.size());
+  for (size_t i = 0; i < leader.feeds.size(); ++i) {
+    const auto& first = leader.feeds[i].Get<Tensor>();
+    TensorShapeVector dims = first.Shape().AsShapeVector();
+    dims[0] = total;
+    Tensor::InitOrtValue(first.DataType(), TensorShape(dims), cpu_allocator_, batched_feeds[i]);
+
+    auto* dst = static_cast<uint8_t*>(batched_feeds[i].GetMutable<Tensor>()->MutableDataRaw());
+    for (const Request* request : batch) {
+      const auto& src = request->feeds[i].Get<Tensor>();
+      std::memcpy(dst, src.DataRaw(), src.SizeInBytes());
+      dst += src.SizeInBytes();
+    }
+  }
+
+  std::vector<OrtValue> batched_fetches;
+  ORT_RETURN_IF_ERROR(run_fn_(*leader.run_options, leader.feed_names, batched_feeds, leader.output_names,
+                              &batched_fetches));
+
+  for (size_t j = 0; j < batched_fetches.size(); ++j) {
+    const auto& output = batched_fetches[j];
+    ORT_RETURN_IF_NOT(output.IsTensor() && output.Get<Tensor>().Shape().NumDimensions() > 0 &&
+                          output.Get<Tensor>().Shape()[0] == total,
+                      "Output '", leader.output_names[j], "' doesn't have the batch dimension. ",
+                      "The model can't be used with dynamic batching.");
+  }
+
+  // hand out slices of the outputs. the slices hold a reference to the batched output so it outlives them.
+  int64_t offset = 0;
+  for (Request* request : batch) {
+    auto& fetches = *request->fetches;
+    if (fetches.empty()) {
+      fetches.resize(batched_fetches.size());
+    }
+
+    for (size_t j = 0; j < batched_fetches.size(); ++j) {
+      const auto& output = batched_fetches[j].Get<Tensor>();
+      const size_t row_bytes = output.SizeInBytes() / narrow<size_t>(total);
+      const auto* src = static_cast<const uint8_t*>(output.DataRaw()) + narrow<size_t>(offset) * row_bytes;
+      TensorShapeVector dims = output.Shape().AsShapeVector();
+      dims[0] = request->batch_size;
+      const TensorShape shape(dims);
+
+      OrtValue& fetch = fetches[j];
+      if (fetch.IsAllocated()) {
+        // the caller provided the buffer so we have to copy
+        auto& dst = *fetch.GetMutable<Tensor>();
+        ORT_RETURN_IF_NOT(dst.DataType() == output.DataType() && dst.Shape() == shape,
+                          "Pre-allocated output '", leader.output_names[j], "' doesn't match the expected shape ",
+                          shape, ".");
+        ORT_RETURN_IF_NOT(!output.IsDataTypeString() && dst.Location().device.Type() == OrtDevice::CPU &&
+                              output.Location().device.Type() == OrtDevice::CPU,
+                          "Pre-allocated output '", leader.output_names[j], "' must be a non-string CPU tensor ",
+                          "when using dynamic batching.");
+        std::memcpy(dst.MutableDataRaw(), src, dst.SizeInBytes());
+      } else {
+        auto slice = std::make_unique<Tensor>(output.DataType(), shape, const_cast<uint8_t*>(src),
+                                              output.Location());
+        OrtValue batched_output = batched_fetches[j];
+        fetch.Init(slice.release(), DataTypeImpl::GetType<Tensor>(),
+                   [batched_output](void* p) { delete static_cast<Tensor*>(p); });
+      }
+    }
+
+    offset += request->batch_size;
+  }
+
+  return Status::OK();
+}
+
+Status DynamicBatcher::Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                           gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                           std::vector<OrtValue>* p_fetches) {
+  const int64_t batch_size = GetBatchSize(feeds);
+  if (batch_size < 0 || batch_size >= options_.max_batch_size || p_fetches == nullptr ||
+      (!p_fetches->empty() && p_fetches->size() != output_names.size())) {
+    // nothing to gain from batching, or invalid and the regular Run will tell the caller why
+    return run_fn_(run_options, feed_names, feeds, output_names, p_fetches);
+  }
+
+  Request request{&run_options, feed_names, feeds, output_names, p_fetches, batch_size};
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  pending_.push_back(&request);
+  // wake up the leader in case this request completes its batch
+  cv_.notify_all();
+
+  while (!request.done) {
+    if (!request.taken && !assembling_) {
+      // lead the next batch
+      assembling_ = true;
+      const auto deadline = std::chrono::steady_clock::now() + options_.timeout;
+      cv_.wait_until(lock, deadline, [this, &request]() {
+        return CompatibleBatchSizeLocked(request) >= options_.max_batch_size;
+      });
+
+      auto batch = TakeBatchLocked(request);
+      // the remaining requests can start assembling the next batch while this one runs
+      assembling_ = false;
+      cv_.notify_all();
+      lock.unlock();
+
+      Status status;
+      ORT_TRY {
+        status = ExecuteBatch(batch);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        });
+      }
+
+      lock.lock();
+      for (Request* batched_request : batch) {
+        batched_request->status = status;
+        batched_request->done = true;
+      }
+      cv_.notify_all();
+    } else {
+      cv_.wait(lock);
+    }
+  }
+
+  return request.status;
+}
+
+}  // namespace onnxruntime
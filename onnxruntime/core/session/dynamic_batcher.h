@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+
+namespace onnxruntime {
+
+// Session config keys of dynamic batching. They are not part of the public API: dynamic batching is only reachable
+// through InferenceSession::RunBatched.
+//
+// Enables dynamic batching for InferenceSession::RunBatched: concurrent requests are coalesced along dimension 0 of
+// their inputs and outputs until the sum of their batch sizes reaches this value or the timeout below expires.
+// All inputs and outputs of the model must have the batch as dimension 0.
+// "0" or "1": RunBatched behaves like Run. [DEFAULT]
+static const char* const kOrtSessionOptionsDynamicBatchingMaxBatchSize = "session.dynamic_batching_max_batch_size";
+
+// Maximum time in microseconds a request waits for other requests to join its batch. Default is "1000".
+static const char* const kOrtSessionOptionsDynamicBatchingTimeoutMicroseconds = "session.dynamic_batching_timeout_us";
+
+/**
+Coalesces concurrent Run requests along the batch dimension (dimension 0 of every input and output) and executes
+them as a single Run.
+
+There is no background thread. The first thread that finds no batch being assembled becomes the leader: it waits
+until the compatible pending requests add up to max_batch_size or the timeout expires, takes them off the queue and
+runs the batch. Meanwhile the next arriving request starts assembling the following batch, so batches can execute
+concurrently.
+
+Requests are compatible if they use the same input and output names, their inputs have the same element types
+and the same shapes apart from dimension 0, and their run options agree on everything but logging: the terminate
+flag, only_execute_path_to_fetches, the run config entries and the active LoRA adapters. The log severity, verbosity
+and tag of the leading request apply to the whole batch. The inputs of a batch are copied into one buffer per input. The outputs
+are handed back as views into the batched outputs, so they don't need copying unless the caller pre-allocated them.
+
+Requests whose inputs can't be batched (non-tensor, string or non-CPU inputs, scalars, or a mismatch in dimension 0
+between inputs) or that already fill a batch on their own are run directly. This class is thread-safe.
+*/
+class DynamicBatcher {
+ public:
+  struct Options {
+    // maximum sum of dimension 0 across the requests in a batch
+    int64_t max_batch_size = 1;
+    // how long the leader waits for the batch to fill up
+    std::chrono::microseconds timeout{1000};
+    // called for each request that is taken into a batch, with the time it waited in the queue. optional.
+    std::function<void(std::chrono::microseconds)> record_queue_wait;
+  };
+
+  using RunFn = std::function<Status(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                     gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                     std::vector<OrtValue>* p_fetches)>;
+
+  // `run_fn` executes one (possibly batched) request. `cpu_allocator` is used for the batched inputs.
+  DynamicBatcher(const Options& options, RunFn run_fn, AllocatorPtr cpu_allocator);
+
+  // Blocks until the request, possibly as part of a batch, has completed. Same semantics as InferenceSession::Run.
+  // The batch is run with the run options of the leading request, which only differ from the others in logging.
+  Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+             gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+             std::vector<OrtValue>* p_fetches);
+
+  const Options& GetOptions() const { return options_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DynamicBatcher);
+
+  struct Request {
+    const RunOptions* run_options;
+    gsl::span<const std::string> feed_names;
+    gsl::span<const OrtValue> feeds;
+    gsl::span<const std::string> output_names;
+    std::vector<OrtValue>* fetches;
+    int64_t batch_size;
+    std::chrono::steady_clock::time_point enqueue_time{std::chrono::steady_clock::now()};
+
+    // set once the request is part of a batch
+    bool taken{false};
+    bool done{false};
+    Status status;
+  };
+
+  // returns the size of dimension 0 shared by all the feeds, or -1 if they can't be batched
+  static int64_t GetBatchSize(gsl::span<const OrtValue> feeds);
+  static bool IsCompatible(const Request& a, const Request& b);
+  static bool HaveSameRunOptions(const RunOptions& a, const RunOptions& b);
+
+  // must be called with mutex_ held
+  int64_t CompatibleBatchSizeLocked(const Request& leader) const;
+  InlinedVector<Request*> TakeBatchLocked(Request& leader);
+
+  Status ExecuteBatch(gsl::span<Request* const> batch);
+
+  const Options options_;
+  const RunFn run_fn_;
+  const AllocatorPtr cpu_allocator_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request*> pending_;
+  // true while a leader is assembling a batch
+  bool assembling_{false};
+};
+
+}  // namespace onnxruntime
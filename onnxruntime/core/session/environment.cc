@@ -3,7 +3,9 @@
 
 #include "core/session/environment.h"
 #include "core/session/allocator_adapters.h"
+#include "core/session/thread_pool_scheduler.h"
 #include "core/framework/allocator_utils.h"
+#include "core/framework/huge_page_allocator.h"
 #include "core/graph/constants.h"
 #include "core/graph/op.h"
 
@@ -131,6 +133,9 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
     int max_dead_bytes_per_chunk = -1;
     int initial_growth_chunk_size_bytes = -1;
     int64_t max_power_of_two_extend_bytes = -1L;
+    int64_t thread_cache_max_bytes = -1L;
+    int64_t idle_shrink_interval_ms = -1L;
+    int use_huge_pages = -1;
 
     // override with values from the user supplied arena_cfg object
     if (arena_cfg) {
@@ -148,12 +153,21 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
       max_dead_bytes_per_chunk = arena_cfg->max_dead_bytes_per_chunk;
       initial_growth_chunk_size_bytes = arena_cfg->initial_growth_chunk_size_bytes;
       max_power_of_two_extend_bytes = arena_cfg->max_power_of_two_extend_bytes;
+      thread_cache_max_bytes = arena_cfg->thread_cache_max_bytes;
+      idle_shrink_interval_ms = arena_cfg->idle_shrink_interval_ms;
+      use_huge_pages = arena_cfg->use_huge_pages;
     }
 
     OrtArenaCfg l_arena_cfg{max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk,
-                            initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes};
+                            initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes, thread_cache_max_bytes,
+                            idle_shrink_interval_ms, use_huge_pages};
     AllocatorCreationInfo alloc_creation_info{
-        [mem_info](int) { return std::make_unique<CPUAllocator>(mem_info); },
+        [mem_info, use_huge_pages](int) -> std::unique_ptr<IAllocator> {
+          if (use_huge_pages == 1) {
+            return std::make_unique<HugePageCPUAllocator>(mem_info);
+          }
+          return std::make_unique<CPUAllocator>(mem_info);
+        },
         0,
         create_arena,
         l_arena_cfg};
@@ -186,6 +200,8 @@ Status Environment::UnregisterAllocator(const OrtMemoryInfo& mem_info) {
   return Status::OK();
 }
 
+Environment::~Environment() = default;
+
 Status Environment::Initialize(std::unique_ptr<logging::LoggingManager> logging_manager,
                                const OrtThreadingOptions* tp_options,
                                bool create_global_thread_pools) {
@@ -206,6 +222,7 @@ Status Environment::Initialize(std::unique_ptr<logging::LoggingManager> logging_
       to.name = ORT_TSTR("inter-op");
     }
     inter_op_thread_pool_ = concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTER_OP);
+    intra_op_scheduler_ = std::make_unique<ThreadPoolScheduler>(intra_op_thread_pool_.get());
   }
 
   ORT_TRY {
@@ -0,0 +1,285 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/session/ep_selection.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+#include "core/common/platform_identity.h"
+#include "core/framework/allocator.h"
+#include "core/framework/data_types.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/run_options.h"
+#include "core/framework/tensor.h"
+#include "core/platform/env.h"
+#include "core/providers/get_execution_providers.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+namespace ep_selection {
+
+namespace {
+
+void HashString(const std::string& str, uint32_t (&hash)[4]) {
+  MurmurHash3::x86_128_append(str.data(), str.size(), hash);
+}
+
+// Generates the inputs of the benchmark runs from the inputs of the model.
+Status CreateFeeds(const InferenceSession& session, std::vector<std::string>& feed_names,
+                   std::vector<OrtValue>& feeds) {
+  const auto [inputs_status, model_inputs] = session.GetModelInputs();
+  ORT_RETURN_IF_ERROR(inputs_status);
+
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  uint32_t state = 12345;  // the same inputs for every selection of a model
+
+  for (const auto* input : *model_inputs) {
+    const auto* type = input->TypeAsProto();
+    ORT_RETURN_IF_NOT(type != nullptr && type->has_tensor_type(),
+                      "Execution provider selection only supports tensor inputs. Input ", input->Name(),
+                      " is not a tensor.");
+
+    TensorShapeVector dims;
+    if (const auto* shape = input->Shape(); shape != nullptr) {
+      for (const auto& dim : shape->dim()) {
+        dims.push_back(dim.has_dim_value() ? dim.dim_value() : 1);
+      }
+    }
+
+    const auto* element_type = DataTypeImpl::TensorTypeFromONNXEnum(type->tensor_type().elem_type())->GetElementType();
+    OrtValue& feed = feeds.emplace_back();
+    Tensor::InitOrtValue(element_type, TensorShape(dims), allocator, feed);
+    Tensor& tensor = *feed.GetMutable<Tensor>();
+    feed_names.push_back(input->Name());
+
+    auto next_value = [&state]() {
+      state = state * 1664525u + 1013904223u;
+      return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+    };
+
+    if (tensor.IsDataType<float>()) {
+      for (auto& value : tensor.MutableDataAsSpan<float>()) value = next_value();
+    } else if (tensor.IsDataType<double>()) {
+      for (auto& value : tensor.MutableDataAsSpan<double>()) value = next_value();
+    } else if (tensor.IsDataType<MLFloat16>()) {
+      for (auto& value : tensor.MutableDataAsSpan<MLFloat16>()) value = MLFloat16(next_value());
+    } else if (tensor.IsDataType<BFloat16>()) {
+      for (auto& value : tensor.MutableDataAsSpan<BFloat16>()) value = BFloat16(next_value());
+    } else if (!tensor.IsDataTypeString()) {
+      memset(tensor.MutableDataRaw(), 0, tensor.SizeInBytes());
+    }
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+bool FloatsMatch(const Tensor& value, const Tensor& reference, float tolerance) {
+  const auto values = value.DataAsSpan<T>();
+  const auto references = reference.DataAsSpan<T>();
+  for (size_t i = 0; i < values.size(); ++i) {
+    const double a = static_cast<double>(static_cast<float>(values[i]));
+    const double b = static_cast<double>(static_cast<float>(references[i]));
+    if (std::isnan(a) != std::isnan(b) || (!std::isnan(b) && std::abs(a - b) > tolerance * (1.0 + std::abs(b)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool OutputsMatch(const OrtValue& value, const OrtValue& reference, float tolerance) {
+  // only tensors are compared
+  if (!value.IsTensor() || !reference.IsTensor()) {
+    return value.Type() == reference.Type();
+  }
+
+  const Tensor& a = value.Get<Tensor>();
+  const Tensor& b = reference.Get<Tensor>();
+  if (a.DataType() != b.DataType() || a.Shape() != b.Shape() ||
+      a.Location().device.Type() != OrtDevice::CPU || b.Location().device.Type() != OrtDevice::CPU) {
+    return false;
+  }
+
+  if (a.IsDataType<float>()) return FloatsMatch<float>(a, b, tolerance);
+  if (a.IsDataType<double>()) return FloatsMatch<double>(a, b, tolerance);
+  if (a.IsDataType<MLFloat16>()) return FloatsMatch<MLFloat16>(a, b, tolerance);
+  if (a.IsDataType<BFloat16>()) return FloatsMatch<BFloat16>(a, b, tolerance);
+  if (a.IsDataTypeString()) {
+    const auto strs_a = a.DataAsSpan<std::string>();
+    const auto strs_b = b.DataAsSpan<std::string>();
+    return std::equal(strs_a.begin(), strs_a.end(), strs_b.begin(), strs_b.end());
+  }
+  return a.SizeInBytes() == b.SizeInBytes() && memcmp(a.DataRaw(), b.DataRaw(), a.SizeInBytes()) == 0;
+}
+
+std::optional<size_t> LookUpDecision(const std::filesystem::path& cache_file, const std::string& key) {
+  std::ifstream file(cache_file);
+  std::optional<size_t> decision;
+  std::string line_key;
+  size_t index = 0;
+  // the last decision for the key wins
+  while (file >> line_key >> index) {
+    if (line_key == key) {
+      decision = index;
+    }
+  }
+  return decision;
+}
+
+}  // namespace
+
+Status GetDecisionKey(const PathString& model_path, gsl::span<const std::string> candidate_fingerprints,
+                      std::string& key) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+
+  size_t model_length = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_path.c_str(), model_length));
+  Env::MappedMemoryPtr model_bytes;
+  if (model_length > 0) {
+    ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(model_path.c_str(), 0, model_length, model_bytes));
+  }
+  MurmurHash3::x86_128_append(model_bytes.get(), model_length, hash);
+
+  HashString(GetPlatformIdentity(), hash);
+  const uint64_t num_cores = static_cast<uint64_t>(Env::Default().GetNumPhysicalCpuCores());
+  MurmurHash3::x86_128_append(&num_cores, sizeof(num_cores), hash);
+  for (const auto& provider : GetAvailableExecutionProviderNames()) {
+    HashString(provider, hash);
+  }
+
+  for (const auto& fingerprint : candidate_fingerprints) {
+    HashString(fingerprint, hash);
+  }
+
+  std::ostringstream ss;
+  ss << std::hex << std::setfill('0');
+  for (const auto h : hash) {
+    ss << std::setw(8) << h;
+  }
+  key = ss.str();
+  return Status::OK();
+}
+
+Status SelectFastestCandidate(const std::string& key, size_t num_candidates, const CreateSessionFn& create_session,
+                              const SelectionOptions& options, const logging::Logger& logger,
+                              size_t& selected_index) {
+  ORT_RETURN_IF(num_candidates == 0, "There are no candidates to select from.");
+  ORT_RETURN_IF(options.num_runs < 1, "The number of benchmark runs must be positive.");
+  ORT_RETURN_IF(options.accuracy_tolerance < 0.0f, "The accuracy tolerance must not be negative.");
+
+  if (!options.cache_file.empty()) {
+    if (auto decision = LookUpDecision(options.cache_file, key); decision.has_value() && *decision < num_candidates) {
+      LOGS(logger, INFO) << "Execution provider selection: using the cached candidate " << *decision;
+      selected_index = *decision;
+      return Status::OK();
+    }
+  }
+
+  const RunOptions run_options;
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  std::vector<OrtValue> reference_fetches;
+
+  std::optional<size_t> best_index;
+  std::chrono::nanoseconds best_time{};
+
+  for (size_t index = 0; index < num_candidates; ++index) {
+    // a session is created at a time, so the candidates do not compete for the device memory
+    std::unique_ptr<InferenceSession> session;
+    Status status = create_session(index, session);
+
+    if (status.IsOK() && index == 0) {
+      status = CreateFeeds(*session, feed_names, feeds);
+      if (status.IsOK()) {
+        const auto [outputs_status, model_outputs] = session->GetModelOutputs();
+        status = outputs_status;
+        for (size_t i = 0; status.IsOK() && i < model_outputs->size(); ++i) {
+          output_names.push_back((*model_outputs)[i]->Name());
+        }
+      }
+    }
+
+    // the warmup run, which is also checked against the reference
+    std::vector<OrtValue> fetches;
+    if (status.IsOK()) {
+      status = session->Run(run_options, feed_names, feeds, output_names, &fetches);
+    }
+
+    if (!status.IsOK()) {
+      ORT_RETURN_IF(index == 0, "Execution provider selection: the reference candidate failed: ",
+                    status.ErrorMessage());
+      LOGS(logger, WARNING) << "Execution provider selection: skipping candidate " << index
+                            << " which failed: " << status.ErrorMessage();
+      continue;
+    }
+
+    if (index == 0) {
+      reference_fetches = std::move(fetches);
+    } else {
+      bool match = fetches.size() == reference_fetches.size();
+      for (size_t i = 0; match && i < fetches.size(); ++i) {
+        match = OutputsMatch(fetches[i], reference_fetches[i], options.accuracy_tolerance);
+      }
+      if (!match) {
+        LOGS(logger, WARNING) << "Execution provider selection: skipping candidate " << index
+                              << " whose outputs do not match the reference within " << options.accuracy_tolerance;
+        continue;
+      }
+    }
+
+    std::vector<std::chrono::nanoseconds> times;
+    times.reserve(options.num_runs);
+    for (int run = 0; status.IsOK() && run < options.num_runs; ++run) {
+      fetches.clear();
+      const auto start = std::chrono::steady_clock::now();
+      status = session->Run(run_options, feed_names, feeds, output_names, &fetches);
+      times.push_back(std::chrono::steady_clock::now() - start);
+    }
+    if (!status.IsOK()) {
+      LOGS(logger, WARNING) << "Execution provider selection: skipping candidate " << index
+                            << " which failed: " << status.ErrorMessage();
+      continue;
+    }
+
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    const auto median = times[times.size() / 2];
+    LOGS(logger, INFO) << "Execution provider selection: candidate " << index << " median run time "
+                       << std::chrono::duration_cast<std::chrono::microseconds>(median).count() << "us";
+
+    if (!best_index.has_value() || median < best_time) {
+      best_index = index;
+      best_time = median;
+    }
+  }
+
+  selected_index = *best_index;  // the reference candidate succeeded
+  LOGS(logger, INFO) << "Execution provider selection: selected candidate " << selected_index;
+
+  if (!options.cache_file.empty()) {
+    std::ofstream file(options.cache_file, std::ios::app);
+    if (file) {
+      file << key << ' ' << selected_index << '\n';
+    }
+    if (!file) {
+      LOGS(logger, WARNING) << "Execution provider selection: failed to write the decision to "
+                            << options.cache_file.string();
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace ep_selection
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
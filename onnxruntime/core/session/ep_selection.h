@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/common/path_string.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+namespace ep_selection {
+
+struct SelectionOptions {
+  // timed runs of each candidate, after one warmup run. The median is compared.
+  int num_runs = 10;
+  // a float output element of a candidate matches the reference if |value - reference| <= tolerance * (1 + |reference|)
+  float accuracy_tolerance = 1e-3f;
+  // text file the decisions are persisted in. Not used if empty.
+  std::filesystem::path cache_file;
+};
+
+// Creates and initializes the session of the candidate at the given index.
+using CreateSessionFn = std::function<Status(size_t index, std::unique_ptr<InferenceSession>& session)>;
+
+// Computes the key of a decision in the cache file. It is a hash of:
+//   - the bytes of the model file. External data files are not read.
+//   - the platform and the execution providers available in this build.
+//   - the fingerprints of the candidates, in order, which identify their execution providers and options.
+Status GetDecisionKey(const PathString& model_path, gsl::span<const std::string> candidate_fingerprints,
+                      std::string& key);
+
+// Selects the fastest of the candidate sessions of a model whose outputs match the outputs of the first candidate.
+//
+// If the cache file has a decision for the key, it is returned without creating any session. Otherwise each
+// candidate is created and run on the same generated inputs: dynamic dimensions are 1, floating point inputs have
+// deterministic values in [0, 1) and the other inputs are 0. A candidate which fails to be created or run, or whose
+// outputs do not match, is skipped. The first candidate is the reference and must succeed. The decision is then
+// appended to the cache file.
+Status SelectFastestCandidate(const std::string& key, size_t num_candidates, const CreateSessionFn& create_session,
+                              const SelectionOptions& options, const logging::Logger& logger,
+                              size_t& selected_index);
+
+}  // namespace ep_selection
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
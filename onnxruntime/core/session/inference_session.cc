@@ -4,6 +4,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <list>
@@ -12,10 +13,13 @@
 #include <queue>
 
 #include "core/common/denormal.h"
+#include "core/common/hardware_counter_profiler.h"
 #include "core/common/logging/isink.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parallel_for_cost_calibration.h"
 #include "core/common/parse_string.h"
 #include "core/common/path_string.h"
+#include "core/common/platform_identity.h"
 #include "core/common/string_utils.h"
 #include "core/flatbuffers/flatbuffers_utils.h"
 #include "core/flatbuffers/ort_format_version.h"
@@ -28,6 +32,7 @@
 #include "core/framework/kernel_registry.h"
 #include "core/framework/kernel_type_str_resolver.h"
 #include "core/framework/kernel_type_str_resolver_utils.h"
+#include "core/framework/memory_timeline.h"
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/tensorprotoutils.h"
@@ -42,7 +47,9 @@
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/layout_transformation/layout_transformation.h"
+#include "core/optimizer/auto_mixed_precision.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/optimizer/memory_budget_recompute.h"
 #include "core/optimizer/qdq_transformer/ensure_unique_dq_for_node_unit.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/selectors_actions/selector_action_transformer_apply_contexts.h"
@@ -66,12 +73,14 @@
 #include "core/providers/dml/DmlExecutionProvider/src/ExecutionProvider.h"
 #include "core/optimizer/stft_decomposition.h"
 #endif
+#include "core/session/dynamic_batcher.h"
 #include "core/session/environment.h"
 #include "core/session/user_logging_sink.h"
 #include "core/session/IOBinding.h"
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/optimized_model_cache.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/util/thread_utils.h"
 
@@ -162,6 +171,7 @@ static bool AreAllComputeNodesAssignedToCudaOrJsOrDmlEp(const Graph& graph) {
         !(node_provider == kCudaExecutionProvider ||
           node_provider == kRocmExecutionProvider ||
           node_provider == kJsExecutionProvider ||
+          node_provider == kWebGpuExecutionProvider ||
           node_provider == kDmlExecutionProvider) &&
         node_provider != kCpuExecutionProvider) {
       nodes_on_cpu_and_cuda_and_js_and_dml_eps_only = false;
@@ -381,6 +391,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 #if !defined(ORT_MINIMAL_BUILD)
   // Update the number of steps for the graph transformer manager using the "finalized" session options
   ORT_THROW_IF_ERROR(graph_transformer_mgr_.SetSteps(session_options_.max_num_graph_transformation_steps));
+  graph_transformer_mgr_.SetProfiler(session_profiler_);
 #endif
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -413,6 +424,10 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 
   use_per_session_threads_ = session_options.use_per_session_threads;
   force_spinning_stop_between_runs_ = session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigForceSpinningStop, "0") == "1";
+  intra_op_spin_during_run_ = session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpSpinDuringRun, "0") == "1";
+  const bool create_threads_lazily =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigThreadPoolsCreateThreadsLazily,
+                                                         "0") == "1";
 
   if (use_per_session_threads_) {
     LOGS(*session_logger_, INFO) << "Creating and using per session threadpools since use_per_session_threads_ is true";
@@ -432,6 +447,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         // If the thread pool can use all the processors, then
         // we set affinity of each thread to each processor.
         to.allow_spinning = allow_intra_op_spinning;
+        to.create_threads_lazily = create_threads_lazily;
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
 
@@ -442,6 +458,11 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, to.affinity_str)) {
           ORT_ENFORCE(!to.affinity_str.empty(), "Affinity string must not be empty");
         }
+        to.numa_aware =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaAware, "0") == "1";
+        to.performance_cores_only =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpPerformanceCoresOnly,
+                                                               "0") == "1";
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_str.empty();
@@ -452,9 +473,28 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 
         thread_pool_ =
             concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+
+        const std::string cost_calibration_file =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsIntraOpCostCalibrationFile, "");
+        const bool cost_calibration =
+            !cost_calibration_file.empty() ||
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsIntraOpCostCalibration, "0") == "1";
+        if (thread_pool_ && cost_calibration) {
+          cost_calibration_ = std::make_shared<concurrency::ParallelForCostCalibration>();
+          if (!cost_calibration_file.empty() && std::filesystem::exists(ToPathString(cost_calibration_file))) {
+            auto load_status = cost_calibration_->Load(ToPathString(cost_calibration_file),
+                                                       GetPlatformIdentity());
+            if (!load_status.IsOK()) {
+              // the costs will be calibrated again so this is not fatal
+              LOGS(*session_logger_, WARNING) << "Ignoring thread pool cost calibration file " << cost_calibration_file
+                                              << ". " << load_status.ErrorMessage();
+            }
+          }
+          thread_pool_->SetCostCalibration(cost_calibration_);
+        }
       }
     }
-    if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
+    if (session_options_.execution_mode != ExecutionMode::ORT_SEQUENTIAL) {
       if (!external_inter_op_thread_pool_) {
         bool allow_inter_op_spinning =
             session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAllowInterOpSpinning, "1") == "1";
@@ -469,6 +509,7 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.name = inter_thread_pool_name_.c_str();
         to.set_denormal_as_zero = set_denormal_as_zero;
         to.allow_spinning = allow_inter_op_spinning;
+        to.create_threads_lazily = create_threads_lazily;
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
 
         // Set custom threading functions
@@ -494,13 +535,42 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     ORT_ENFORCE(session_env.EnvCreatedWithGlobalThreadPools(),
                 "When the session is not configured to use per session"
                 " threadpools, the env must be created with the the CreateEnvWithGlobalThreadPools API.");
+
+    auto get_scheduling_option = [this](const char* key) {
+      const std::string value = session_options_.config_options.GetConfigOrDefault(key, "0");
+      int parsed = 0;
+      ORT_ENFORCE(TryParseStringWithClassicLocale<int>(value, parsed) && parsed >= 0,
+                  "Invalid value for ", key, ": ", value, ". Expected a non-negative integer.");
+      return parsed;
+    };
+    ThreadPoolScheduler::ClientOptions scheduling_options;
+    scheduling_options.weight = get_scheduling_option(kOrtSessionOptionsGlobalThreadPoolWeight);
+    scheduling_options.max_threads = get_scheduling_option(kOrtSessionOptionsGlobalThreadPoolMaxThreads);
+    scheduling_options.max_concurrent_runs = get_scheduling_option(kOrtSessionOptionsGlobalThreadPoolMaxConcurrentRuns);
+    // without any option, the session is neither balanced nor limited, and its runs skip the scheduler entirely
+    if (scheduling_options.weight > 0 || scheduling_options.max_threads > 0 ||
+        scheduling_options.max_concurrent_runs > 0) {
+      thread_pool_scheduler_client_ = session_env.GetIntraOpThreadPoolScheduler()->Register(scheduling_options);
+    }
   }
 
   session_profiler_.Initialize(session_logger_);
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsProfilingHardwareCounters, "0") == "1") {
+    session_profiler_.AddEpProfilers(profiling::CreateHardwareCounterProfiler(*session_logger_));
+  }
+  session_profiler_.SetRoofline(
+      ParseStringWithClassicLocale<double>(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsProfilingRooflinePeakGflops, "0")),
+      ParseStringWithClassicLocale<double>(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsProfilingRooflinePeakGbps, "0")));
   if (session_options_.enable_profiling) {
     StartProfiling(session_options_.profile_file_prefix);
   }
 
+  const uint32_t profiling_sampling_interval = ParseStringWithClassicLocale<uint32_t>(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsProfilingSamplingInterval, "0"));
+  session_profiler_.EnableSampling(profiling_sampling_interval);
+
   telemetry_ = {};
 
 #ifdef _WIN32
@@ -733,6 +803,56 @@ InferenceSession::~InferenceSession() {
     }
   }
 
+  if (cost_calibration_ && cost_calibration_->IsDirty()) {
+    const std::string cost_calibration_file =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsIntraOpCostCalibrationFile, "");
+    if (!cost_calibration_file.empty()) {
+      auto save_status = cost_calibration_->Save(ToPathString(cost_calibration_file),
+                                                 GetPlatformIdentity());
+      if (!save_status.IsOK()) {
+        LOGS(*session_logger_, WARNING) << "Failed to save thread pool cost calibration: "
+                                        << save_status.ErrorMessage();
+      }
+    }
+  }
+
+#if !defined(ORT_MINIMAL_BUILD)
+  if (is_inited_) {
+    const std::string tuning_results_cache_file =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsTuningResultsCacheFile, "");
+    const bool read_only =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsTuningResultsCacheReadOnly, "0") == "1";
+    if (!tuning_results_cache_file.empty() && !read_only) {
+      // merge with the current content of the file, which may have been updated by other sessions since it was loaded
+      const auto file_path = ToPathString(tuning_results_cache_file);
+      std::vector<TuningResults> cached_tuning_results;
+      if (std::filesystem::exists(file_path) &&
+          !inference_session_utils::LoadTuningResultsFromFile(file_path, cached_tuning_results).IsOK()) {
+        cached_tuning_results.clear();
+      }
+
+      inference_session_utils::MergeTuningResults(cached_tuning_results, GetTuningResults());
+      if (!cached_tuning_results.empty()) {
+        auto save_status = inference_session_utils::SaveTuningResultsToFile(file_path, cached_tuning_results);
+        if (!save_status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << "Failed to save tuning results cache: " << save_status.ErrorMessage();
+        }
+      }
+    }
+  }
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+  if (is_inited_ && session_state_ && session_state_->HasNewMemoryPatterns()) {
+    const std::string mem_pattern_cache_file =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryPatternCacheFile, "");
+    if (!mem_pattern_cache_file.empty()) {
+      auto save_status = session_state_->SaveMemoryPatternCache(ToPathString(mem_pattern_cache_file));
+      if (!save_status.IsOK()) {
+        LOGS(*session_logger_, WARNING) << "Failed to save memory pattern cache: " << save_status.ErrorMessage();
+      }
+    }
+  }
+
   // Unregister the session and ETW callbacks
 #ifdef _WIN32
   std::lock_guard<std::mutex> lock(active_sessions_mutex_);
@@ -1004,9 +1124,15 @@ common::Status InferenceSession::LoadOnnxModel(const PathString& model_uri) {
 #endif
     const bool strict_shape_type_inference = session_options_.config_options.GetConfigOrDefault(
                                                  kOrtSessionOptionsConfigStrictShapeTypeInference, "0") == "1";
+    ModelOptions model_opts(true, strict_shape_type_inference);
+    const std::string lazy_raw_data_threshold = session_options_.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsLazyLoadRawDataThreshold, "0");
+    if (!TryParseStringWithClassicLocale(lazy_raw_data_threshold, model_opts.lazy_raw_data_threshold)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                             kOrtSessionOptionsLazyLoadRawDataThreshold, ": ", lazy_raw_data_threshold);
+    }
     return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
-                                    *session_logger_,
-                                    ModelOptions(true, strict_shape_type_inference));
+                                    *session_logger_, model_opts);
   };
 
   common::Status st = LoadWithLoader(loader, "model_loading_uri");
@@ -1207,7 +1333,8 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
   // 7. insert copy nodes (required transformer).
 
   // Run Ahead Of time function inlining
-  GraphPartitioner partitioner(kernel_registry_manager_, execution_providers_);
+  GraphPartitioner partitioner(kernel_registry_manager_, execution_providers_, GetIntraOpThreadPoolToUse(),
+                               &session_profiler_);
   if (const bool disable_aot_function_inlining =
           session_options_.config_options.GetConfigOrDefault(
               kOrtSessionOptionsDisableAheadOfTimeFunctionInlining, "0") == "1";
@@ -1304,9 +1431,48 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
   }
 
   // Do partitioning based on execution providers' capabilities.
+  TimePoint partitioning_start;
+  if (session_profiler_.IsEnabled()) {
+    partitioning_start = session_profiler_.Start();
+  }
   ORT_RETURN_IF_ERROR_SESSIONID_(partitioner.Partition(graph, session_state_->GetMutableFuncMgr(), transform_layout_fn,
                                                        session_options_.config_options, *session_logger_,
                                                        mode, debug_graph_fn));
+  if (session_profiler_.IsEnabled()) {
+    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_partitioning", partitioning_start,
+                                            {{"phase", "graph_partitioning"}});
+  }
+
+  // Convert float nodes to the lower precision supported by their assigned EPs, before the Level2 fusions so that
+  // those see the converted nodes.
+  if (const std::string auto_mixed_precision =
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsAutoMixedPrecision, "");
+      !auto_mixed_precision.empty()) {
+    ONNX_NAMESPACE::TensorProto_DataType target_type;
+    if (auto_mixed_precision == "fp16") {
+      target_type = ONNX_NAMESPACE::TensorProto_DataType_FLOAT16;
+    } else if (auto_mixed_precision == "bf16") {
+      target_type = ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16;
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                             kOrtSessionOptionsAutoMixedPrecision, ": ", auto_mixed_precision,
+                             ". Expected fp16 or bf16.");
+    }
+
+    auto parse_op_types = [this](const char* config_key) {
+      InlinedHashSet<std::string> op_types;
+      const std::string op_types_str = session_options_.config_options.GetConfigOrDefault(config_key, "");
+      for (const auto& op_type : utils::SplitString(op_types_str, ";")) {
+        op_types.insert(std::string(op_type));
+      }
+      return op_types;
+    };
+
+    AutoMixedPrecision auto_mixed_precision_transformer{target_type, kernel_registry_manager_,
+                                                        parse_op_types(kOrtSessionOptionsAutoMixedPrecisionAllowOps),
+                                                        parse_op_types(kOrtSessionOptionsAutoMixedPrecisionDenyOps)};
+    ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(auto_mixed_precision_transformer, *session_logger_, graph));
+  }
 
   // apply Level2 and higher transformers.
   // we do not run Level 1 again as those transformers assume partitioning will run later to do node assignment.
@@ -1338,6 +1504,17 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
     ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(copy_transformer, *session_logger_, graph));
   }
 
+  // Recompute activations to keep the estimated peak memory under the budget.
+  // It runs last so the estimate covers the copies inserted above.
+  {
+    const size_t activation_memory_budget = ParseStringWithClassicLocale<size_t>(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsActivationMemoryBudgetInBytes, "0"));
+    if (activation_memory_budget > 0) {
+      MemoryBudgetRecompute memory_budget_transformer{activation_memory_budget};
+      ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(memory_budget_transformer, *session_logger_, graph));
+    }
+  }
+
 #ifdef ENABLE_TRAINING
   // Enable memory optimizations.
   // Only applicable for training scenarios.
@@ -1357,11 +1534,29 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 static Status LoadOrtModelBytes(const PathString& model_uri,
+                                bool map_file,
                                 gsl::span<const uint8_t>& bytes,
-                                std::vector<uint8_t>& bytes_data_holder) {
+                                std::vector<uint8_t>& bytes_data_holder,
+                                Env::MappedMemoryPtr& mapped_bytes) {
   size_t num_bytes = 0;
   ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_uri.c_str(), num_bytes));
 
+  if (map_file && num_bytes > 0) {
+    // the pages are read when they are first accessed and are shared with other processes mapping the file
+    Env::MappedMemoryPtr mapped_memory;
+    const auto status = Env::Default().MapFileIntoMemory(model_uri.c_str(), 0, num_bytes, mapped_memory);
+    if (status.IsOK()) {
+      mapped_bytes = std::move(mapped_memory);
+      bytes_data_holder.clear();
+      bytes = gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), num_bytes);
+      return Status::OK();
+    }
+
+    LOGS_DEFAULT(INFO) << "Failed to map " << ToUTF8String(model_uri) << ", it will be read instead. "
+                       << status.ErrorMessage();
+  }
+
+  mapped_bytes.reset();
   bytes_data_holder.resize(num_bytes);
 
   std::ifstream bytes_stream(model_uri, std::ifstream::in | std::ifstream::binary);
@@ -1378,12 +1573,16 @@ static Status LoadOrtModelBytes(const PathString& model_uri,
   return Status::OK();
 }
 
+bool InferenceSession::MapOrtModelFile() const {
+  return session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMapORTModelFile, "1") == "1";
+}
+
 Status InferenceSession::LoadOrtModel(const PathString& model_uri) {
   return LoadOrtModelWithLoader(
       [&]() {
         model_location_ = model_uri;
-        ORT_RETURN_IF_ERROR(
-            LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
+        ORT_RETURN_IF_ERROR(LoadOrtModelBytes(model_location_, MapOrtModelFile(), ort_format_model_bytes_,
+                                              ort_format_model_bytes_data_holder_, ort_format_model_mapped_bytes_));
         return Status::OK();
       });
 }
@@ -1486,14 +1685,17 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   ORT_RETURN_IF(nullptr == fbs_model, "Missing Model. Invalid ORT format model.");
 
   // if we're using the bytes directly because kOrtSessionOptionsConfigUseORTModelBytesDirectly was set and the user
-  // provided an existing buffer of bytes when creating the InferenceSession, ort_format_model_bytes_data_holder_
-  // will be empty.
-  // if that is the case we also allow creating initializers that directly use those bytes.
+  // provided an existing buffer of bytes when creating the InferenceSession, or because the model file is mapped,
+  // ort_format_model_bytes_data_holder_ will be empty.
+  // if that is the case we also allow creating initializers that directly use those bytes. the session owns the
+  // mapping of a model file, so its initializers use it unless the user disabled it.
   const auto& config_options = session_options_.config_options;
+  const char* use_bytes_for_initializers_default = ort_format_model_mapped_bytes_ ? "1" : "0";
   using_ort_model_bytes_for_initializers_ =
       load_options.can_use_flatbuffer_for_initializers =
           ort_format_model_bytes_data_holder_.empty() &&
-          config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1";
+          config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers,
+                                            use_bytes_for_initializers_default) == "1";
 
   // need to go from unique_ptr to shared_ptr when moving into model_
   std::unique_ptr<Model> tmp_model;
@@ -1533,6 +1735,105 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   return Status::OK();
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+Status InferenceSession::LoadFromOptimizedModelCache(std::filesystem::path& cache_path) {
+  cache_path.clear();
+
+  const std::string cache_dir =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsOptimizedModelCacheDir, "");
+  if (cache_dir.empty()) {
+    return Status::OK();
+  }
+
+  // the key is computed from the ONNX model, and the model saved to optimized_model_filepath must be optimized
+  // by this session.
+  bool use_cache = ort_format_model_bytes_.empty() && session_options_.optimized_model_filepath.empty() &&
+                   !HasLocalSchema();
+#if !defined(DISABLE_EXTERNAL_INITIALIZERS)
+  // the data of initializers supplied by the user is not part of the key
+  use_cache = use_cache && session_options_.external_initializers.empty() &&
+              session_options_.external_initializer_files_mmap.empty();
+#endif
+  if (!use_cache) {
+    LOGS(*session_logger_, INFO) << "The optimized model cache is not used by this session.";
+    return Status::OK();
+  }
+
+  std::filesystem::path file_name;
+  ORT_RETURN_IF_ERROR(optimized_model_cache::GetCacheFileName(*model_, execution_providers_, session_options_,
+                                                              optimizers_to_disable_, file_name));
+  const std::filesystem::path path = std::filesystem::path(ToPathString(cache_dir)) / file_name;
+
+  std::error_code ec;
+  if (!std::filesystem::exists(path, ec)) {
+    LOGS(*session_logger_, INFO) << "The model is not in the optimized model cache. It will be saved to "
+                                 << ToUTF8String(path.native()) << " once optimized.";
+    cache_path = path;
+    return Status::OK();
+  }
+
+  // the ORT format model replaces the ONNX model. model_location_ keeps the path of the ONNX model.
+  const std::shared_ptr<onnxruntime::Model> onnx_model = model_;
+  {
+    std::lock_guard<std::mutex> l(session_mutex_);
+    is_model_loaded_ = false;
+  }
+  auto status = LoadOrtModelWithLoader([&]() {
+    return LoadOrtModelBytes(path.native(), MapOrtModelFile(), ort_format_model_bytes_,
+                             ort_format_model_bytes_data_holder_, ort_format_model_mapped_bytes_);
+  });
+
+  if (!status.IsOK()) {
+    // e.g. the file was written by another build of ONNX Runtime. it is replaced once the model is optimized again.
+    LOGS(*session_logger_, WARNING) << "Failed to load the optimized model cache file " << ToUTF8String(path.native())
+                                    << ". The model will be optimized. " << status.ErrorMessage();
+    std::lock_guard<std::mutex> l(session_mutex_);
+    model_ = onnx_model;
+    ORT_RETURN_IF_ERROR(SaveModelMetadata(*model_));
+    ort_format_model_bytes_ = gsl::span<const uint8_t>();
+    ort_format_model_bytes_data_holder_.clear();
+    ort_format_model_mapped_bytes_.reset();
+    is_model_loaded_ = true;
+    cache_path = path;
+  } else {
+    LOGS(*session_logger_, INFO) << "Loaded the optimized model from " << ToUTF8String(path.native());
+  }
+
+  return Status::OK();
+}
+
+void InferenceSession::SaveToOptimizedModelCache(const std::filesystem::path& cache_path) const {
+  if (session_state_->GetFuncMgr().NumFuncs() > 0) {
+    LOGS(*session_logger_, INFO) << "The optimized model is not cached as it contains compiled nodes.";
+    return;
+  }
+
+  // other sessions, possibly in other processes, may load the file at any time, so it is written to a temporary file
+  // that is then renamed.
+  std::filesystem::path temp_path = cache_path;
+  temp_path += ToPathString("." + std::to_string(Env::Default().GetSelfPid()) + "." +
+                            std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp");
+
+  auto status = SaveToOrtFormat(temp_path);
+  std::error_code ec;
+  if (status.IsOK()) {
+    std::filesystem::rename(temp_path, cache_path, ec);
+    if (ec) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to rename ", ToUTF8String(temp_path.native()), ": ",
+                               ec.message());
+    }
+  }
+
+  if (!status.IsOK()) {
+    std::filesystem::remove(temp_path, ec);
+    LOGS(*session_logger_, WARNING) << "Failed to save the optimized model to the cache. " << status.ErrorMessage();
+    return;
+  }
+
+  LOGS(*session_logger_, INFO) << "Saved the optimized model to " << ToUTF8String(cache_path.native());
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 bool InferenceSession::IsInitialized() const {
   std::lock_guard<std::mutex> l(session_mutex_);
   return is_inited_;
@@ -1617,7 +1918,8 @@ Status PartitionOrtFormatModel(onnxruntime::Graph& graph,
   }
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
-  GraphPartitioner partitioner(kernel_registry_manager, providers);
+  GraphPartitioner partitioner(kernel_registry_manager, providers, session_state.GetThreadPool(),
+                               &session_state.Profiler());
   ORT_RETURN_IF_ERROR(partitioner.Partition(graph,
                                             session_state.GetMutableFuncMgr(),
                                             transform_layout_fn,
@@ -1720,9 +2022,8 @@ common::Status InferenceSession::Initialize() {
     }
 
     // Verify that there are no external initializers in the graph if external data is disabled.
-    onnxruntime::Graph& graph = model_->MainGraph();
 #ifdef DISABLE_EXTERNAL_INITIALIZERS
-    const InitializedTensorSet& initializers = graph.GetAllInitializedTensors();
+    const InitializedTensorSet& initializers = model_->MainGraph().GetAllInitializedTensors();
     for (const auto& it : initializers) {
       if (utils::HasExternalData(*it.second)) {
         return common::Status(common::ONNXRUNTIME, common::FAIL,
@@ -1735,7 +2036,16 @@ common::Status InferenceSession::Initialize() {
     // RegisterExecutionProvider locks the session_mutex_ so we can't be holding it when we call that
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
-      CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      CPUExecutionProviderInfo epi{
+          session_options_.enable_cpu_mem_arena,
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseHugePages, "0") == "1"};
+      epi.tunable_op.enable =
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpEnable, "0") == "1";
+      epi.tunable_op.tuning_enable =
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpTuningEnable, "0") == "1";
+      ORT_RETURN_IF_ERROR_SESSIONID_(ParseStringWithClassicLocale(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, "0"),
+          epi.tunable_op.max_tuning_duration_ms));
       auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
       execution_providers_.SetCpuProviderWasImplicitlyAdded(true);
@@ -1746,6 +2056,15 @@ common::Status InferenceSession::Initialize() {
     // This check is placed here because it serves as a common place for all language bindings.
     ORT_RETURN_IF_ERROR_SESSIONID_(HasInvalidCombinationOfExecutionProviders());
 
+    // the key of the optimized model cache includes the execution providers, so this is done once they are all
+    // registered. LoadOrtModelWithLoader locks the session_mutex_ so we can't be holding it when we call this.
+    std::filesystem::path optimized_model_cache_path;
+#if !defined(ORT_MINIMAL_BUILD)
+    ORT_RETURN_IF_ERROR_SESSIONID_(LoadFromOptimizedModelCache(optimized_model_cache_path));
+#endif
+
+    onnxruntime::Graph& graph = model_->MainGraph();
+
     // re-acquire mutex
     std::lock_guard<std::mutex> l(session_mutex_);
 
@@ -1812,6 +2131,7 @@ common::Status InferenceSession::Initialize() {
 
     const bool loading_ort_format = !ort_format_model_bytes_.empty();
     const bool saving_model = !session_options_.optimized_model_filepath.empty();
+    const bool saving_to_cache = !optimized_model_cache_path.empty();
     const bool saving_ort_format = [&]() {
       if (saving_model) {
         const std::string model_type = session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSaveModelFormat, "");
@@ -1931,11 +2251,18 @@ common::Status InferenceSession::Initialize() {
       // All the "compute" graph nodes have been assigned to the ROCM EP,
       // Then the ROCM EP is cached for triggering a ReplayGraph() in Run().
       //
+      // Check for WebGPU EP:
+      // If the WebGPU EP is part of the providers list for this session AND
+      // The WebGPU EP is configured to do a graph capture AND
+      // All the "compute" graph nodes have been assigned to the WebGPU EP,
+      // Then the WebGPU EP is cached for triggering a ReplayGraph() in Run().
+      //
       std::vector<const char*> graph_support_ep_list = {
           onnxruntime::kTensorrtExecutionProvider,
           onnxruntime::kCudaExecutionProvider,
           onnxruntime::kRocmExecutionProvider,
           onnxruntime::kJsExecutionProvider,
+          onnxruntime::kWebGpuExecutionProvider,
           onnxruntime::kDmlExecutionProvider};
 
       for (auto& it : graph_support_ep_list) {
@@ -1958,6 +2285,7 @@ common::Status InferenceSession::Initialize() {
           if (strcmp(target_ep->Type().c_str(), onnxruntime::kCudaExecutionProvider) == 0 ||
               strcmp(target_ep->Type().c_str(), onnxruntime::kRocmExecutionProvider) == 0 ||
               strcmp(target_ep->Type().c_str(), onnxruntime::kJsExecutionProvider) == 0 ||
+              strcmp(target_ep->Type().c_str(), onnxruntime::kWebGpuExecutionProvider) == 0 ||
               strcmp(target_ep->Type().c_str(), onnxruntime::kDmlExecutionProvider) == 0) {
             // Ensure that all nodes have been partitioned to CUDA/JS or CPU EP && there are no memcpy nodes
             // The reasoning behind this logic is that certain shape nodes will be forced onto CPU
@@ -2004,6 +2332,8 @@ common::Status InferenceSession::Initialize() {
 
           LOGS(*session_logger_, INFO) << "This session will use the CUDA/HIP Graph feature as requested by the user.";
           cached_execution_provider_for_graph_replay_.SetExecutionProvider(target_ep);
+          graph_capture_by_input_shapes_ = session_options_.config_options.GetConfigOrDefault(
+                                               kOrtSessionOptionsGraphCaptureByInputShapes, "0") == "1";
           break;  // Make sure only one ep can run CUDA graph.
         }
       }
@@ -2067,10 +2397,14 @@ common::Status InferenceSession::Initialize() {
     ORT_RETURN_IF_ERROR_SESSIONID_(
         session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
                                              // need to keep the initializers if saving the optimized model
-                                             !saving_model,
-                                             saving_ort_format));
+                                             !saving_model && !saving_to_cache,
+                                             saving_ort_format || saving_to_cache));
 
 #if !defined(ORT_MINIMAL_BUILD)
+    if (saving_to_cache) {
+      SaveToOptimizedModelCache(optimized_model_cache_path);
+    }
+
     if (saving_model) {
       if (session_state_->GetFuncMgr().NumFuncs() > 0) {
         ORT_RETURN_IF_ERROR_SESSIONID_(
@@ -2117,16 +2451,106 @@ common::Status InferenceSession::Initialize() {
     if (found_tuning_results) {
       ORT_RETURN_IF_ERROR_SESSIONID_(SetTuningResults(tuning_results, /*error_on_invalid*/ false, /*auto_enable*/ true));
     }
+
+    const std::string tuning_results_cache_file =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsTuningResultsCacheFile, "");
+    if (!tuning_results_cache_file.empty() && std::filesystem::exists(ToPathString(tuning_results_cache_file))) {
+      std::vector<TuningResults> cached_tuning_results;
+      auto load_status = inference_session_utils::LoadTuningResultsFromFile(ToPathString(tuning_results_cache_file),
+                                                                           cached_tuning_results);
+      if (load_status.IsOK()) {
+        // the file may hold results for other devices or versions, which are skipped without a warning
+        std::vector<TuningResults> valid_tuning_results;
+        for (auto& tr : cached_tuning_results) {
+          const auto* provider = execution_providers_.Get(tr.ep);
+          const auto* tuning_ctx = provider != nullptr ? provider->GetTuningContext() : nullptr;
+          if (tuning_ctx != nullptr && tuning_ctx->GetTuningResultsValidator().ValidateAll(tr.validators).IsOK()) {
+            valid_tuning_results.push_back(std::move(tr));
+          }
+        }
+        ORT_RETURN_IF_ERROR_SESSIONID_(SetTuningResults(valid_tuning_results, /*error_on_invalid*/ false,
+                                                        /*auto_enable*/ true));
+      } else {
+        LOGS(*session_logger_, WARNING) << "Ignoring tuning results cache file " << tuning_results_cache_file << ". "
+                                        << load_status.ErrorMessage();
+      }
+    }
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    // Preload memory patterns learned by a previous session
+    const std::string mem_pattern_cache_file =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsMemoryPatternCacheFile, "");
+    if (!mem_pattern_cache_file.empty() && session_state_->GetEnableMemoryPattern() &&
+        std::filesystem::exists(ToPathString(mem_pattern_cache_file))) {
+      auto load_status = session_state_->LoadMemoryPatternCache(ToPathString(mem_pattern_cache_file));
+      if (!load_status.IsOK()) {
+        // the patterns will be learned again so this is not fatal
+        LOGS(*session_logger_, WARNING) << "Ignoring memory pattern cache file " << mem_pattern_cache_file << ". "
+                                        << load_status.ErrorMessage();
+      }
+    }
+
+    const int64_t dynamic_batching_max_batch_size = ParseStringWithClassicLocale<int64_t>(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsDynamicBatchingMaxBatchSize, "0"));
+    if (dynamic_batching_max_batch_size > 1) {
+      DynamicBatcher::Options batcher_options;
+      batcher_options.max_batch_size = dynamic_batching_max_batch_size;
+      batcher_options.timeout = std::chrono::microseconds(ParseStringWithClassicLocale<int64_t>(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsDynamicBatchingTimeoutMicroseconds,
+                                                             "1000")));
+      ORT_RETURN_IF(batcher_options.timeout.count() < 0,
+                    kOrtSessionOptionsDynamicBatchingTimeoutMicroseconds, " must not be negative.");
+      batcher_options.record_queue_wait = [this](std::chrono::microseconds wait) {
+        session_metrics_.RecordQueueWait(wait.count());
+      };
+      dynamic_batcher_ = std::make_unique<DynamicBatcher>(
+          batcher_options,
+          [this](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                 gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                 std::vector<OrtValue>* p_fetches) {
+            return Run(run_options, feed_names, feeds, output_names, p_fetches);
+          },
+          session_state_->GetAllocator(OrtDevice()));
+    }
+
+    const std::string streaming_states =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsStreamingStates, "");
+    if (!streaming_states.empty()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(InitStreamingStates(streaming_states));
+    }
+
+#if !defined(ORT_MINIMAL_BUILD)
+    const int64_t shape_specialization_max_sessions = ParseStringWithClassicLocale<int64_t>(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsShapeSpecializationMaxSessions, "0"));
+    if (shape_specialization_max_sessions > 0) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(InitShapeSpecialization(static_cast<size_t>(shape_specialization_max_sessions)));
+    }
+#endif
+
+    {
+      std::map<std::string, size_t> nodes_per_provider;
+      for (const auto& node : session_state_->GetGraphViewer().Nodes()) {
+        ++nodes_per_provider[node.GetExecutionProviderType()];
+      }
+
+      const bool has_non_cpu_provider = std::any_of(
+          execution_providers_.begin(), execution_providers_.end(),
+          [](const auto& xp) { return xp->Type() != onnxruntime::kCpuExecutionProvider; });
+      const auto cpu_nodes = nodes_per_provider.find(onnxruntime::kCpuExecutionProvider);
+      const size_t num_fallback_nodes =
+          has_non_cpu_provider && cpu_nodes != nodes_per_provider.end() ? cpu_nodes->second : 0;
+      session_metrics_.SetNodeAssignment({nodes_per_provider.begin(), nodes_per_provider.end()}, num_fallback_nodes);
+    }
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
       ort_format_model_bytes_ = gsl::span<const uint8_t>();
       std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+      ort_format_model_mapped_bytes_.reset();
     }
 
     // once the model is saved, we may remove unnecessary attributes for inference
@@ -2159,6 +2583,19 @@ common::Status InferenceSession::Initialize() {
   }
 
   if (session_profiler_.IsEnabled()) {
+    MemoryTimeline timeline;
+    if (status.IsOK() && CreateMemoryTimeline(*session_state_, timeline).IsOK()) {
+      for (const auto& peak : timeline.device_peaks) {
+        session_profiler_.EndTimeAndRecordEvent(
+            profiling::SESSION_EVENT, "memory_plan_peak", session_profiler_.Start(),
+            {{"device", peak.device.ToString()},
+             {"peak_bytes", std::to_string(peak.peak_bytes)},
+             {"peak_node", timeline.steps[peak.peak_step].node_name},
+             {"initializer_bytes", std::to_string(timeline.initializer_bytes)},
+             {"unknown_size_values", std::to_string(timeline.num_unknown_size_values)}});
+      }
+    }
+
     session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "session_initialization", tp);
   }
 
@@ -2177,10 +2614,86 @@ common::Status InferenceSession::Initialize() {
 #pragma warning(pop)
 #endif
 
+common::Status InferenceSession::Clone(const SessionOptions& session_options,
+                                       std::unique_ptr<InferenceSession>& clone) const {
+  std::lock_guard<std::mutex> l(session_mutex_);
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  auto session = std::make_unique<InferenceSession>(session_options, environment_);
+  LOGS(*session->session_logger_, INFO) << "Initializing session as a clone of session " << session_id_ << ".";
+
+  session->model_ = model_;
+  session->model_location_ = model_location_;
+  session->is_model_loaded_ = true;
+
+  // keep the custom kernel registries the kernel lookups point into alive
+  session->custom_registries_ = custom_registries_;
+
+  // the execution providers keep the logger of this session, as the kernels use them
+  for (const auto& ep : execution_providers_) {
+    auto p_data_xfr = ep->GetDataTransfer();
+    if (p_data_xfr) {
+      ORT_RETURN_IF_ERROR(session->data_transfer_mgr_.RegisterDataTransfer(std::move(p_data_xfr)));
+    }
+
+    auto p_external_data_loader = ep->GetExternalDataLoader();
+    if (p_external_data_loader) {
+      ORT_RETURN_IF_ERROR(
+          session->external_data_loader_mgr_.RegisterExternalDataLoader(std::move(p_external_data_loader)));
+    }
+
+    session->session_profiler_.AddEpProfilers(ep->GetProfiler());
+    ORT_RETURN_IF_ERROR(session->execution_providers_.Add(ep->Type(), ep));
+  }
+
+  session->execution_providers_.SetCpuProviderWasImplicitlyAdded(
+      execution_providers_.GetCpuProviderWasImplicitlyAdded());
+  session->is_concurrent_run_supported_ = is_concurrent_run_supported_;
+
+  session->session_state_ = std::make_unique<SessionState>(
+      model_->MainGraph(),
+      session->execution_providers_,
+      session->GetIntraOpThreadPoolToUse(),
+      session->GetInterOpThreadPoolToUse(),
+      session->data_transfer_mgr_,
+      session->external_data_loader_mgr_,
+      *session->session_logger_,
+      session->session_profiler_,
+      session->session_options_,
+      prepacked_weights_container_);
+
+  if (session->session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseEnvAllocators,
+                                                                  "0") == "1") {
+    session->session_state_->UpdateAllocatorsWithEnvAllocators(environment_.GetRegisteredSharedAllocators());
+  }
+
+  ORT_RETURN_IF_ERROR(session->kernel_registry_manager_.RegisterKernels(session->execution_providers_));
+  ORT_RETURN_IF_ERROR(session->session_state_->FinalizeSessionStateFromSource(*session_state_,
+                                                                              session->kernel_registry_manager_));
+  ORT_RETURN_IF_ERROR(session->SaveModelMetadata(*model_));
+  ResolveMemoryPatternFlags(*session->session_state_);
+  session->is_inited_ = true;
+
+  LOGS(*session->session_logger_, INFO) << "Session successfully initialized.";
+  clone = std::move(session);
+  return Status::OK();
+}
+
 int InferenceSession::GetCurrentNumRuns() const {
   return current_num_runs_.load();
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+size_t InferenceSession::GetNumShapeSpecializedSessions() const {
+  std::lock_guard<std::mutex> lock(shape_specializations_mutex_);
+  return static_cast<size_t>(std::count_if(shape_specializations_.begin(), shape_specializations_.end(),
+                                           [](const auto& entry) { return entry.second.session != nullptr; }));
+}
+#endif
+
 const std::vector<std::string>& InferenceSession::GetRegisteredProviderTypes() const {
   return execution_providers_.GetIds();
 }
@@ -2246,140 +2759,150 @@ static common::Status CheckTypes(MLDataType actual, MLDataType expected, const s
                          DataTypeImpl::ToString(expected), "))");
 }
 
-common::Status InferenceSession::ValidateInputsOutputs(gsl::span<const std::string> names,
-                                                       gsl::span<const OrtValue> feeds_fetches,
-                                                       const InputOutputDefMetaMap& input_output_meta_map,
-                                                       ArgType arg_type) const {
-  ORT_ENFORCE(arg_type == ArgType::kInput || arg_type == ArgType::kOutput, "Valid values kInput, kOutput");
-
+common::Status InferenceSession::ValidateInputOutput(const std::string& name, const OrtValue& input_output_ml_value,
+                                                     const InputOutputDefMetaData& metadata,
+                                                     ArgType arg_type) const {
   const bool is_inputs = arg_type == ArgType::kInput;
 
   const char* const input_output_moniker = is_inputs ? "input" : "output";
-  const char* const feed_fetches_moniker = is_inputs ? "feed" : "fetch";
 
 #if !defined(DISABLE_SPARSE_TENSORS)
-  auto is_sparse_initializer = [this](const std::string& name) -> bool {
+  auto is_sparse_initializer = [this](const std::string& initializer_name) -> bool {
     int idx = -1;
-    if (session_state_->GetOrtValueNameIdxMap().GetIdx(name, idx).IsOK()) {
+    if (session_state_->GetOrtValueNameIdxMap().GetIdx(initializer_name, idx).IsOK()) {
       return session_state_->IsSparseInitializer(idx);
     }
     return false;
   };
 #endif
 
-  if (names.size() != feeds_fetches.size()) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, feed_fetches_moniker, " names has ", names.size(),
-                           " elements, but ", feed_fetches_moniker, " has ", feeds_fetches.size(), " elements.");
+  // For outputs the user may supply an unallocated placeholder.
+  if (!is_inputs && !input_output_ml_value.IsAllocated()) {
+    return Status::OK();
   }
 
-  for (size_t i = 0; i < feeds_fetches.size(); ++i) {
-    const auto& name = names[i];
-
-    auto iter = input_output_meta_map.find(name);
-    if (input_output_meta_map.end() == iter) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid ", input_output_moniker, " name: ", name);
-    }
-
-    const auto& input_output_ml_value = feeds_fetches[i];
-
-    // For outputs the user may supply an unallocated placeholder.
-    if (!is_inputs && !input_output_ml_value.IsAllocated()) {
-      continue;
-    }
-
-    auto expected_type = iter->second.ml_data_type;
+  auto expected_type = metadata.ml_data_type;
 
-    if (input_output_ml_value.IsTensor()) {
-      if (!expected_type->IsTensorType()
+  if (input_output_ml_value.IsTensor()) {
+    if (!expected_type->IsTensorType()
 #if !defined(DISABLE_OPTIONAL_TYPE)
-          && !utils::IsOptionalTensor(expected_type)
+        && !utils::IsOptionalTensor(expected_type)
 #endif
-      ) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, input_output_moniker, " with name: '", name,
-                               "' expected to be of type: ", static_cast<int>(expected_type->type_), " but received a tensor");
-      }
+    ) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, input_output_moniker, " with name: '", name,
+                             "' expected to be of type: ", static_cast<int>(expected_type->type_), " but received a tensor");
+    }
 
-      // check for type
+    // check for type
 #if !defined(DISABLE_OPTIONAL_TYPE)
-      auto expected_element_type = expected_type->IsTensorType()
-                                       ? expected_type
-                                             ->AsTensorType()
-                                             ->GetElementType()
-                                       : utils::GetElementTypeFromOptionalTensor(expected_type);
+    auto expected_element_type = expected_type->IsTensorType()
+                                     ? expected_type
+                                           ->AsTensorType()
+                                           ->GetElementType()
+                                     : utils::GetElementTypeFromOptionalTensor(expected_type);
 #else
-      auto expected_element_type = expected_type->AsTensorType()->GetElementType();
+    auto expected_element_type = expected_type->AsTensorType()->GetElementType();
 #endif
 
-      const auto& input_output_tensor = input_output_ml_value.Get<Tensor>();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_output_tensor.DataType(),
-                                                expected_element_type, "tensor", input_output_moniker));
+    const auto& input_output_tensor = input_output_ml_value.Get<Tensor>();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_output_tensor.DataType(),
+                                              expected_element_type, "tensor", input_output_moniker));
+
+    // check for shape
+    const auto& opt_shape = metadata.tensor_shape;
+    if (opt_shape.has_value() && !opt_shape->GetDims().empty()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(name, input_output_tensor.Shape(),
+                                                 *opt_shape, input_output_moniker));
+    }
+  } else if (input_output_ml_value.IsSparseTensor()) {
+#if !defined(DISABLE_SPARSE_TENSORS)
 
-      // check for shape
-      const auto& opt_shape = iter->second.tensor_shape;
+    const SparseTensor& sparse_tensor = input_output_ml_value.Get<SparseTensor>();
+    if (expected_type->IsSparseTensorType()) {
+      auto expected_element_type = expected_type->AsSparseTensorType()->GetElementType();
+      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(sparse_tensor.DataType(), expected_element_type,
+                                                "sparse_tensor", input_output_moniker));
+      // Check shape
+      const auto& opt_shape = metadata.tensor_shape;
       if (opt_shape.has_value() && !opt_shape->GetDims().empty()) {
-        ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(name, input_output_tensor.Shape(),
+        ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(name, sparse_tensor.DenseShape(),
                                                    *opt_shape, input_output_moniker));
       }
-    } else if (input_output_ml_value.IsSparseTensor()) {
-#if !defined(DISABLE_SPARSE_TENSORS)
-
-      const SparseTensor& sparse_tensor = input_output_ml_value.Get<SparseTensor>();
-      if (expected_type->IsSparseTensorType()) {
-        auto expected_element_type = expected_type->AsSparseTensorType()->GetElementType();
-        ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(sparse_tensor.DataType(), expected_element_type,
-                                                  "sparse_tensor", input_output_moniker));
-        // Check shape
-        const auto& opt_shape = iter->second.tensor_shape;
-        if (opt_shape.has_value() && !opt_shape->GetDims().empty()) {
-          ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(name, sparse_tensor.DenseShape(),
-                                                     *opt_shape, input_output_moniker));
-        }
-      } else if (is_sparse_initializer(name) &&
-                 expected_type->IsTensorType()) {
-        // If this metadata came from a sparse initializer converted to dense, then still validate it.
-        auto expected_element_type = expected_type->AsTensorType()->GetElementType();
-        ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(sparse_tensor.DataType(), expected_element_type,
-                                                  "sparse_tensor", input_output_moniker));
-        // Check shape
-        const auto& opt_shape = iter->second.tensor_shape;
-        if (opt_shape.has_value() && !opt_shape->GetDims().empty()) {
-          ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(name, sparse_tensor.DenseShape(),
-                                                     *opt_shape, input_output_moniker));
-        }
-      } else {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, input_output_moniker, " with name: '", name,
-                               "' expected to be of type: ", static_cast<int>(expected_type->type_), " but received a sparse tensor");
+    } else if (is_sparse_initializer(name) &&
+               expected_type->IsTensorType()) {
+      // If this metadata came from a sparse initializer converted to dense, then still validate it.
+      auto expected_element_type = expected_type->AsTensorType()->GetElementType();
+      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(sparse_tensor.DataType(), expected_element_type,
+                                                "sparse_tensor", input_output_moniker));
+      // Check shape
+      const auto& opt_shape = metadata.tensor_shape;
+      if (opt_shape.has_value() && !opt_shape->GetDims().empty()) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(name, sparse_tensor.DenseShape(),
+                                                   *opt_shape, input_output_moniker));
       }
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, input_output_moniker, " with name: '", name,
+                             "' expected to be of type: ", static_cast<int>(expected_type->type_), " but received a sparse tensor");
+    }
 #else
-      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, input_output_moniker, " with name ", name,
-                             " is a sparse tensor, which is not supported in this build.");
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, input_output_moniker, " with name ", name,
+                           " is a sparse tensor, which is not supported in this build.");
 #endif
-    } else if (input_output_ml_value.IsTensorSequence()) {
-      if (!expected_type->IsTensorSequenceType()
+  } else if (input_output_ml_value.IsTensorSequence()) {
+    if (!expected_type->IsTensorSequenceType()
 #if !defined(DISABLE_OPTIONAL_TYPE)
-          && !utils::IsOptionalSeqTensor(expected_type)
+        && !utils::IsOptionalSeqTensor(expected_type)
 #endif
-      ) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, input_output_moniker, " with name: '", name,
-                               "' expected to be of type: ", static_cast<int>(expected_type->type_), " but received a tensor sequence");
-      }
+    ) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, input_output_moniker, " with name: '", name,
+                             "' expected to be of type: ", static_cast<int>(expected_type->type_), " but received a tensor sequence");
+    }
 
 #if !defined(DISABLE_OPTIONAL_TYPE)
-      auto expected_element_type = expected_type->IsTensorSequenceType()
-                                       ? expected_type
-                                             ->AsSequenceTensorType()
-                                             ->GetElementType()
-                                       : utils::GetElementTypeFromOptionalSeqTensor(expected_type);
+    auto expected_element_type = expected_type->IsTensorSequenceType()
+                                     ? expected_type
+                                           ->AsSequenceTensorType()
+                                           ->GetElementType()
+                                     : utils::GetElementTypeFromOptionalSeqTensor(expected_type);
 #else
-      auto expected_element_type = expected_type->AsSequenceTensorType()->GetElementType();
+    auto expected_element_type = expected_type->AsSequenceTensorType()->GetElementType();
 #endif
 
-      auto input_output_element_type = input_output_ml_value.Get<TensorSeq>().DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_output_element_type, expected_element_type, "seq", input_output_moniker));
-    } else {
-      auto input_output_type = input_output_ml_value.Type();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_output_type, expected_type, "", input_output_moniker));
+    auto input_output_element_type = input_output_ml_value.Get<TensorSeq>().DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_output_element_type, expected_element_type, "seq", input_output_moniker));
+  } else {
+    auto input_output_type = input_output_ml_value.Type();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_output_type, expected_type, "", input_output_moniker));
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::ValidateInputsOutputs(gsl::span<const std::string> names,
+                                                       gsl::span<const OrtValue> feeds_fetches,
+                                                       const InputOutputDefMetaMap& input_output_meta_map,
+                                                       ArgType arg_type) const {
+  ORT_ENFORCE(arg_type == ArgType::kInput || arg_type == ArgType::kOutput, "Valid values kInput, kOutput");
+
+  const bool is_inputs = arg_type == ArgType::kInput;
+
+  const char* const input_output_moniker = is_inputs ? "input" : "output";
+  const char* const feed_fetches_moniker = is_inputs ? "feed" : "fetch";
+
+  if (names.size() != feeds_fetches.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, feed_fetches_moniker, " names has ", names.size(),
+                           " elements, but ", feed_fetches_moniker, " has ", feeds_fetches.size(), " elements.");
+  }
+
+  for (size_t i = 0; i < feeds_fetches.size(); ++i) {
+    const auto& name = names[i];
+
+    auto iter = input_output_meta_map.find(name);
+    if (input_output_meta_map.end() == iter) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid ", input_output_moniker, " name: ", name);
     }
+
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputOutput(name, feeds_fetches[i], iter->second, arg_type));
   }
 
   return Status::OK();
@@ -2390,45 +2913,157 @@ common::Status InferenceSession::ValidateInputs(gsl::span<const std::string> fee
   return ValidateInputsOutputs(feed_names, feeds, input_def_map_, ArgType::kInput);
 }
 
-common::Status InferenceSession::ValidateOutputs(gsl::span<const std::string> output_names,
-                                                 const std::vector<OrtValue>* p_fetches) const {
-  if (output_names.empty()) {
-    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "At least one output should be requested.");
-  }
-
-  const auto fetches = (p_fetches == nullptr) ? EmptySpan<const OrtValue>() : gsl::make_span(*p_fetches);
-
-  if (fetches.empty()) {
-    for (const auto& name : output_names) {
-      if (output_def_map_.count(name) == 0) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid output name:", name);
+common::Status InferenceSession::GetFeedsFetchesManagerForRun(gsl::span<const std::string> feed_names,
+                                                              gsl::span<const std::string> output_names,
+                                                              FeedsFetchesManager*& manager,
+                                                              std::unique_ptr<FeedsFetchesManager>& run_manager) {
+  auto find_cached = [this, feed_names, output_names](size_t begin, size_t end) -> FeedsFetchesManager* {
+    for (size_t i = begin; i < end; ++i) {
+      const auto& info = cached_feeds_fetches_managers_[i]->GetFeedsFetchesInfo();
+      if (std::equal(feed_names.begin(), feed_names.end(), info.feed_names.begin(), info.feed_names.end()) &&
+          std::equal(output_names.begin(), output_names.end(), info.output_names.begin(), info.output_names.end())) {
+        return cached_feeds_fetches_managers_[i].get();
       }
     }
+    return nullptr;
+  };
+
+  // the cached managers below num_cached are published and never change, so they are looked up without a lock
+  const size_t num_cached = num_cached_feeds_fetches_managers_.load(std::memory_order_acquire);
+  manager = find_cached(0, num_cached);
+  if (manager != nullptr) {
     return Status::OK();
   }
 
-  return ValidateInputsOutputs(output_names, fetches, output_def_map_, ArgType::kOutput);
-}
-
-#ifdef ENABLE_TRAINING
-Status InferenceSession::PartialRun(onnxruntime::RunOptions& run_options,
-                                    std::vector<OrtValue>& feeds,
-                                    std::vector<OrtValue>& fetches,
-                                    PartialGraphExecutionState& state,
-                                    FeedsFetchesManager& feeds_fetches_manager,
-                                    const OrtValueCachePtr& cache,
-                                    int32_t partial_graph_index) {
-  Status retval = Status::OK();
-  std::vector<IExecutionProvider*> exec_providers_to_stop;
-  exec_providers_to_stop.reserve(execution_providers_.NumProviders());
+  FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+  auto new_manager = std::make_unique<FeedsFetchesManager>(std::move(info));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(*session_state_, *new_manager));
 
-  ORT_TRY {
-    if (!is_inited_) {
-      LOGS(*session_logger_, ERROR) << "Session was not initialized";
-      return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  if (num_cached < kMaxCachedFeedsFetchesManagers) {
+    std::lock_guard<std::mutex> lock(cached_feeds_fetches_managers_mutex_);
+    const size_t num_cached_now = num_cached_feeds_fetches_managers_.load(std::memory_order_relaxed);
+    // another run may have cached the same names in the meantime
+    manager = find_cached(num_cached, num_cached_now);
+    if (manager != nullptr) {
+      return Status::OK();
     }
 
-    if (!run_options.run_tag.empty()) {
+    if (num_cached_now < kMaxCachedFeedsFetchesManagers) {
+      manager = new_manager.get();
+      cached_feeds_fetches_managers_[num_cached_now] = std::move(new_manager);
+      num_cached_feeds_fetches_managers_.store(num_cached_now + 1, std::memory_order_release);
+      return Status::OK();
+    }
+  }
+
+  // the cache is full, so the run keeps the manager to itself
+  manager = new_manager.get();
+  run_manager = std::move(new_manager);
+  return Status::OK();
+}
+
+common::Status InferenceSession::PrepareRun(gsl::span<const std::string> feed_names,
+                                            gsl::span<const std::string> output_names,
+                                            std::unique_ptr<PreparedRun>& prepared_run) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  if (output_names.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "At least one output should be requested.");
+  }
+
+  auto prepared = std::make_unique<PreparedRun>();
+  prepared->session_ = this;
+  prepared->feed_names_.assign(feed_names.begin(), feed_names.end());
+  prepared->output_names_.assign(output_names.begin(), output_names.end());
+
+  prepared->feed_metadata_.reserve(feed_names.size());
+  for (const auto& name : feed_names) {
+    auto iter = input_def_map_.find(name);
+    if (iter == input_def_map_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid input name: ", name);
+    }
+    prepared->feed_metadata_.push_back(&iter->second);
+  }
+
+  prepared->output_metadata_.reserve(output_names.size());
+  for (const auto& name : output_names) {
+    auto iter = output_def_map_.find(name);
+    if (iter == output_def_map_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid output name: ", name);
+    }
+    prepared->output_metadata_.push_back(&iter->second);
+  }
+
+  FeedsFetchesInfo info(prepared->feed_names_, prepared->output_names_, session_state_->GetOrtValueNameIdxMap());
+  auto feeds_fetches_manager = std::make_unique<FeedsFetchesManager>(std::move(info));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(*session_state_, *feeds_fetches_manager));
+  prepared->feeds_fetches_manager_ = std::move(feeds_fetches_manager);
+
+  prepared_run = std::move(prepared);
+  return Status::OK();
+}
+
+common::Status InferenceSession::ValidatePreparedRun(const PreparedRun& prepared_run, gsl::span<const OrtValue> feeds,
+                                                     const std::vector<OrtValue>& fetches) const {
+  if (prepared_run.session_ != this) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The prepared run was created by another session.");
+  }
+
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    ORT_RETURN_IF_ERROR(ValidateInputOutput(prepared_run.feed_names_[i], feeds[i], *prepared_run.feed_metadata_[i],
+                                            ArgType::kInput));
+  }
+
+  for (size_t i = 0, end = fetches.size(); i < end; ++i) {
+    ORT_RETURN_IF_ERROR(ValidateInputOutput(prepared_run.output_names_[i], fetches[i],
+                                            *prepared_run.output_metadata_[i], ArgType::kOutput));
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::ValidateOutputs(gsl::span<const std::string> output_names,
+                                                 const std::vector<OrtValue>* p_fetches) const {
+  if (output_names.empty()) {
+    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "At least one output should be requested.");
+  }
+
+  const auto fetches = (p_fetches == nullptr) ? EmptySpan<const OrtValue>() : gsl::make_span(*p_fetches);
+
+  if (fetches.empty()) {
+    for (const auto& name : output_names) {
+      if (output_def_map_.count(name) == 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid output name:", name);
+      }
+    }
+    return Status::OK();
+  }
+
+  return ValidateInputsOutputs(output_names, fetches, output_def_map_, ArgType::kOutput);
+}
+
+#ifdef ENABLE_TRAINING
+Status InferenceSession::PartialRun(onnxruntime::RunOptions& run_options,
+                                    std::vector<OrtValue>& feeds,
+                                    std::vector<OrtValue>& fetches,
+                                    PartialGraphExecutionState& state,
+                                    FeedsFetchesManager& feeds_fetches_manager,
+                                    const OrtValueCachePtr& cache,
+                                    int32_t partial_graph_index) {
+  Status retval = Status::OK();
+  std::vector<IExecutionProvider*> exec_providers_to_stop;
+  exec_providers_to_stop.reserve(execution_providers_.NumProviders());
+
+  ORT_TRY {
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+
+    if (!run_options.run_tag.empty()) {
       LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
     }
 
@@ -2509,6 +3144,17 @@ struct ThreadPoolSpinningSwitch {
     }
   }
 };
+
+// Intra-op threads spinning without blocking for the duration of a run
+struct IntraOpSpinDuringRun {
+  concurrency::ThreadPool* intra_tp_;
+  explicit IntraOpSpinDuringRun(concurrency::ThreadPool* intra_tp) noexcept : intra_tp_(intra_tp) {
+    if (intra_tp_) intra_tp_->StartSpinningWithoutBlocking();
+  }
+  ~IntraOpSpinDuringRun() {
+    if (intra_tp_) intra_tp_->StopSpinningWithoutBlocking();
+  }
+};
 }  // namespace
 
 Status InferenceSession::SetEpDynamicOptions(gsl::span<const char* const> keys,
@@ -2533,17 +3179,57 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info, nullptr);
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info,
+                                 const PreparedRun* prepared_run) {
+  if (!streaming_states_.empty() &&
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigUseStreamingStates, "1") == "1") {
+    return RunWithStreamingStates(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info);
+  }
+
+  if (graph_capture_by_input_shapes_ &&
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigCudaGraphAnnotation, "").empty()) {
+    return RunWithGraphCaptureByInputShapes(run_options, feed_names, feeds, output_names, p_fetches,
+                                            p_fetches_device_info);
+  }
+
+#if !defined(ORT_MINIMAL_BUILD)
+  if (!shape_specialization_dims_.empty() && feed_names.size() == feeds.size()) {
+    InferenceSession* specialized_session = GetShapeSpecializedSession(feed_names, feeds);
+    if (specialized_session != nullptr) {
+      return specialized_session->Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info);
+    }
+  }
+#endif
+
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
   }
 
+  // the runs of Warmup are left out of the metrics and the telemetry
+  const bool is_warmup_run = is_warming_up_.load(std::memory_order_relaxed);
+
+  // runs that return before executing, e.g. on invalid inputs, are reported as failed
+  const TimePoint run_start = std::chrono::high_resolution_clock::now();
+  bool run_completed = false;
+  Status retval = Status::OK();
+  auto record_run_metrics = gsl::finally([this, &run_start, &run_completed, &retval, is_warmup_run]() {
+    if (!is_warmup_run) {
+      session_metrics_.RecordRun(TimeDiffMicroSeconds(run_start), !run_completed || !retval.IsOK());
+    }
+  });
+
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
   TraceLoggingActivity<telemetry_provider_handle> ortrun_activity;
   ortrun_activity.SetRelatedActivity(session_activity);
   TraceLoggingWriteStart(ortrun_activity, "OrtRun");
 #endif
-  Status retval = Status::OK();
   const Env& env = Env::Default();
 
   int graph_annotation_id = 0;
@@ -2556,6 +3242,42 @@ Status InferenceSession::Run(const RunOptions& run_options,
     }
   }
 
+  int intra_op_num_threads = 0;
+  const std::string& intra_op_num_threads_str =
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigIntraOpNumThreads, "");
+  if (!intra_op_num_threads_str.empty()) {
+    if (!TryParseStringWithClassicLocale<int>(intra_op_num_threads_str, intra_op_num_threads) ||
+        intra_op_num_threads < 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                             kOrtRunOptionsConfigIntraOpNumThreads, ": ", intra_op_num_threads_str);
+    }
+  }
+
+  const std::string intra_op_priority_str =
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigIntraOpPriority, "normal");
+  if (intra_op_priority_str != "normal" && intra_op_priority_str != "high") {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid value for ",
+                           kOrtRunOptionsConfigIntraOpPriority, ": ", intra_op_priority_str,
+                           ". Expected \"normal\" or \"high\".");
+  }
+
+  // admission and share of the global thread pool, if the session uses it
+  std::optional<ThreadPoolScheduler::Run> scheduled_run;
+  if (thread_pool_scheduler_client_) {
+    const TimePoint wait_start = std::chrono::high_resolution_clock::now();
+    scheduled_run.emplace(*thread_pool_scheduler_client_);
+    if (thread_pool_scheduler_client_->Options().max_concurrent_runs > 0 && !is_warmup_run) {
+      session_metrics_.RecordQueueWait(TimeDiffMicroSeconds(wait_start));
+    }
+  }
+
+  // limits the parallel sections of the nodes run by this thread
+  concurrency::ThreadPool::RunScope intra_op_run_scope(
+      GetIntraOpThreadPoolToUse(), intra_op_num_threads,
+      intra_op_priority_str == "high" ? concurrency::ThreadPool::RunPriority::kHigh
+                                      : concurrency::ThreadPool::RunPriority::kNormal,
+      scheduled_run ? &scheduled_run->MaxDegreeOfParallelism() : nullptr);
+
   // Increment/decrement concurrent_num_runs_ and control
   // session threads spinning as configured. Do nothing for graph replay except the counter.
   const bool control_spinning = use_per_session_threads_ &&
@@ -2565,6 +3287,9 @@ Status InferenceSession::Run(const RunOptions& run_options,
   auto* inter_tp = (control_spinning) ? inter_op_thread_pool_.get() : nullptr;
   ThreadPoolSpinningSwitch runs_refcounter_and_tp_spin_control(intra_tp, inter_tp, current_num_runs_);
 
+  // Keep the intra-op threads spinning for the whole run in the low latency mode
+  IntraOpSpinDuringRun intra_op_spin_during_run(intra_op_spin_during_run_ ? GetIntraOpThreadPoolToUse() : nullptr);
+
   // Check if this Run() is simply going to be a CUDA Graph replay.
   if (cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation_id)) {
     LOGS(*session_logger_, INFO) << "Replaying the captured "
@@ -2572,6 +3297,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
                                  << " CUDA Graph for this model with tag: " << run_options.run_tag
                                  << " with graph annotation id: " << graph_annotation_id;
     ORT_RETURN_IF_ERROR_SESSIONID_(cached_execution_provider_for_graph_replay_.ReplayGraph(graph_annotation_id));
+    run_completed = true;
   } else {
     InlinedVector<IExecutionProvider*> exec_providers_to_stop;
     exec_providers_to_stop.reserve(execution_providers_.NumProviders());
@@ -2587,8 +3313,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
       // log evaluation start to trace logging provider
       env.GetTelemetryProvider().LogEvaluationStart();
 
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      if (prepared_run != nullptr) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidatePreparedRun(*prepared_run, feeds, *p_fetches));
+      } else {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      }
 
       // shrink certain default memory arenas if the user has requested for it
       const std::string& shrink_memory_arenas =
@@ -2598,13 +3328,29 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
       }
 
-      FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-      FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+      FeedsFetchesManager* feeds_fetches_manager = nullptr;
+      std::unique_ptr<FeedsFetchesManager> run_feeds_fetches_manager;
+      if (prepared_run != nullptr) {
+        feeds_fetches_manager = prepared_run->feeds_fetches_manager_.get();
+      } else {
+        ORT_RETURN_IF_ERROR_SESSIONID_(GetFeedsFetchesManagerForRun(feed_names, output_names, feeds_fetches_manager,
+                                                                    run_feeds_fetches_manager));
+      }
+
+      // a manager shared by the runs is only changed by a run that may copy its feeds or fetches across devices,
+      // so such a run works on a copy of it
+      if (run_feeds_fetches_manager == nullptr &&
+          (feeds_fetches_manager->GetDeviceCopyChecks().status != DeviceCopyCheck::NoCopy || p_fetches_device_info)) {
+        run_feeds_fetches_manager = std::make_unique<FeedsFetchesManager>(
+            FeedsFetchesInfo(feeds_fetches_manager->GetFeedsFetchesInfo()));
+        run_feeds_fetches_manager->CopyStaticCopyInfoFrom(*feeds_fetches_manager);
+        feeds_fetches_manager = run_feeds_fetches_manager.get();
+      }
 
       if (p_fetches_device_info) {
         // populate the target device info. ignored if pre-allocated fetches are provided
         const auto& fetch_device_info = *p_fetches_device_info;
-        auto& fetch_info = feeds_fetches_manager.GetMutableFetchesDeviceCopyInfo();
+        auto& fetch_info = feeds_fetches_manager->GetMutableFetchesDeviceCopyInfo();
 
         for (size_t i = 0, end = output_names.size(); i < end; ++i) {
           fetch_info[i].target_device = fetch_device_info[i];
@@ -2622,7 +3368,11 @@ Status InferenceSession::Run(const RunOptions& run_options,
 
       std::optional<std::lock_guard<std::mutex>> sequential_run_lock;
       if (is_concurrent_run_supported_ == false) {
+        const TimePoint wait_start = std::chrono::high_resolution_clock::now();
         sequential_run_lock.emplace(session_mutex_);
+        if (!is_warmup_run) {
+          session_metrics_.RecordQueueWait(TimeDiffMicroSeconds(wait_start));
+        }
       }
 
       // info all execution providers InferenceSession:Run started
@@ -2645,7 +3395,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
         // TODO: this method is not thread safe, if multiple Run happened in parallel we might hit race condition issue.
         // currently it only used in training, there is no parallel run execution in training so it is ok.
         // but it is better we can fix it with a better solution.
-        session_state_->UpdateToBeExecutedRange(feeds_fetches_manager.GetFeedsFetchesInfo().fetches_mlvalue_idxs);
+        session_state_->UpdateToBeExecutedRange(feeds_fetches_manager->GetFeedsFetchesInfo().fetches_mlvalue_idxs);
       }
 #endif
 
@@ -2659,7 +3409,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
 #endif
 
       if (retval.IsOK()) {
-        retval = utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
+        retval = utils::ExecuteGraph(*session_state_, *feeds_fetches_manager, feeds, *p_fetches,
                                      session_options_.execution_mode,
                                      run_options,
 #ifdef ORT_ENABLE_STREAM
@@ -2667,6 +3417,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
 #endif
                                      run_logger);
       }
+      run_completed = true;
 
       // info all execution providers InferenceSession:Run ended
       for (auto* xp : exec_providers_to_stop) {
@@ -2701,8 +3452,10 @@ Status InferenceSession::Run(const RunOptions& run_options,
   }
 
   // keep track of telemetry
-  ++telemetry_.total_runs_since_last_;
-  telemetry_.total_run_duration_since_last_ += TimeDiffMicroSeconds(tp);
+  if (!is_warmup_run) {
+    ++telemetry_.total_runs_since_last_;
+    telemetry_.total_run_duration_since_last_ += TimeDiffMicroSeconds(tp);
+  }
 
   // time to send telemetry?
   if (TimeDiffMicroSeconds(telemetry_.time_sent_last_) > Telemetry::kDurationBetweenSending) {
@@ -2736,11 +3489,393 @@ Status InferenceSession::Run(const RunOptions& run_options,
       cached_execution_provider_for_graph_replay_.AllowGraphCaptureOnRun(graph_annotation_id) &&
       !cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation_id)) {
     LOGS(*session_logger_, INFO) << "Start another run for necessary memory allocation or graph capture.";
-    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info));
+    ORT_RETURN_IF_ERROR(RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                                prepared_run));
   }
   return retval;
 }
 
+Status InferenceSession::RunWithGraphCaptureByInputShapes(const RunOptions& run_options,
+                                                          gsl::span<const std::string> feed_names,
+                                                          gsl::span<const OrtValue> feeds,
+                                                          gsl::span<const std::string> output_names,
+                                                          std::vector<OrtValue>* p_fetches,
+                                                          const std::vector<OrtDevice>* p_fetches_device_info) {
+  ORT_RETURN_IF_NOT(is_inited_, "Session not initialized.");
+  ORT_RETURN_IF_NOT(feed_names.size() == feeds.size(), "The number of feed names and feeds don't match.");
+  ORT_RETURN_IF(p_fetches == nullptr, "Output vector pointer is NULL");
+
+  RunOptions bucket_run_options = run_options;
+
+  std::ostringstream key;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!feeds[i].IsTensor()) {
+      // only tensors can be copied to the buffers of a bucket
+      const auto skip = std::to_string(CachedExecutionProviderForGraphReplay::kGraphAnnotationSkip);
+      ORT_RETURN_IF_ERROR(bucket_run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation,
+                                                                           skip.c_str()));
+      return Run(bucket_run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info);
+    }
+    const auto& tensor = feeds[i].Get<Tensor>();
+    key << feed_names[i] << ':' << tensor.GetElementType() << ':' << tensor.Shape().ToString() << ';';
+  }
+  for (const auto& output_name : output_names) {
+    key << output_name << ';';
+  }
+
+  std::lock_guard<std::mutex> lock(graph_capture_buckets_mutex_);
+
+  const OrtDevice device = cached_execution_provider_for_graph_replay_.cached_execution_provider_for_graph_replay_
+                               ->GetOrtDeviceByMemType(OrtMemTypeDefault);
+  const DataTransferManager& data_transfer_mgr = session_state_->GetDataTransferMgr();
+  auto bucket_it = graph_capture_buckets_.find(key.str());
+  if (bucket_it == graph_capture_buckets_.end()) {
+    AllocatorPtr allocator = session_state_->GetAllocator(device);
+    ORT_RETURN_IF(allocator == nullptr, "No allocator for the device of the graph capture buffers: ",
+                  device.ToString());
+
+    GraphCaptureShapeBucket bucket{next_graph_capture_annotation_id_++, {}, {}};
+    bucket.feeds.resize(feeds.size());
+    for (size_t i = 0; i < feeds.size(); ++i) {
+      const auto& tensor = feeds[i].Get<Tensor>();
+      Tensor::InitOrtValue(tensor.DataType(), tensor.Shape(), allocator, bucket.feeds[i]);
+    }
+
+    LOGS(*session_logger_, INFO) << "Using graph annotation id " << bucket.graph_annotation_id
+                                 << " for the input shapes " << key.str();
+    bucket_it = graph_capture_buckets_.emplace(key.str(), std::move(bucket)).first;
+  }
+
+  auto& bucket = bucket_it->second;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    ORT_RETURN_IF_ERROR(data_transfer_mgr.CopyTensor(feeds[i].Get<Tensor>(), *bucket.feeds[i].GetMutable<Tensor>()));
+  }
+
+  ORT_RETURN_IF_ERROR(bucket_run_options.config_options.AddConfigEntry(
+      kOrtRunOptionsConfigCudaGraphAnnotation, std::to_string(bucket.graph_annotation_id).c_str()));
+
+  // The outputs of the first run are allocated on the device of the EP and reused by the later runs of the bucket,
+  // so the captured graph writes to them.
+  const std::vector<OrtDevice> bucket_fetch_devices(output_names.size(), device);
+  ORT_RETURN_IF_ERROR(Run(bucket_run_options, feed_names, bucket.feeds, output_names, &bucket.fetches,
+                          &bucket_fetch_devices));
+
+  if (!bucket.is_captured && cached_execution_provider_for_graph_replay_.IsGraphCaptured(bucket.graph_annotation_id)) {
+    bucket.is_captured = true;
+
+    // the EP may have destroyed the least recently used graph to keep this one
+    for (auto it = graph_capture_buckets_.begin(); it != graph_capture_buckets_.end();) {
+      if (it->second.is_captured &&
+          !cached_execution_provider_for_graph_replay_.IsGraphCaptured(it->second.graph_annotation_id)) {
+        LOGS(*session_logger_, INFO) << "Releasing the buffers of the evicted graph with annotation id "
+                                     << it->second.graph_annotation_id;
+        it = graph_capture_buckets_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  auto& fetches = *p_fetches;
+  if (fetches.empty()) {
+    fetches.resize(output_names.size());
+  }
+  ORT_RETURN_IF_NOT(fetches.size() == output_names.size(), "Output vector incorrectly sized: ", fetches.size(),
+                    " expected: ", output_names.size());
+
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    ORT_RETURN_IF_NOT(bucket.fetches[i].IsTensor(), "Output ", output_names[i],
+                      " is not a tensor, which is required to capture a graph per set of input shapes.");
+    const auto& src = bucket.fetches[i].Get<Tensor>();
+    if (!fetches[i].IsAllocated()) {
+      const OrtDevice fetch_device = p_fetches_device_info ? (*p_fetches_device_info)[i] : OrtDevice();
+      AllocatorPtr allocator = session_state_->GetAllocator(fetch_device);
+      ORT_RETURN_IF(allocator == nullptr, "No allocator for the device of output ", output_names[i], ": ",
+                    fetch_device.ToString());
+      Tensor::InitOrtValue(src.DataType(), src.Shape(), allocator, fetches[i]);
+    }
+    ORT_RETURN_IF_ERROR(data_transfer_mgr.CopyTensor(src, *fetches[i].GetMutable<Tensor>()));
+  }
+
+  return Status::OK();
+}
+
+Status InferenceSession::InitStreamingStates(const std::string& streaming_states) {
+  const auto& graph = model_->MainGraph();
+  for (const auto& pair : utils::SplitString(streaming_states, ";")) {
+    const auto names = utils::SplitString(pair, ":");
+    ORT_RETURN_IF_NOT(names.size() == 2, "Invalid streaming state '", pair, "' in ", kOrtSessionOptionsStreamingStates,
+                      ". Expected 'input_name:output_name'.");
+
+    StreamingState state{std::string{names[0]}, std::string{names[1]}, OrtDevice(), OrtValue()};
+    const auto& inputs = graph.GetInputsIncludingInitializers();
+    const auto& outputs = graph.GetOutputs();
+    const auto input = std::find_if(inputs.begin(), inputs.end(), [&state](const NodeArg* arg) {
+      return arg->Name() == state.input_name;
+    });
+    const auto output = std::find_if(outputs.begin(), outputs.end(), [&state](const NodeArg* arg) {
+      return arg->Name() == state.output_name;
+    });
+    ORT_RETURN_IF(input == inputs.end(), "The streaming state input ", state.input_name, " is not an input of the model.");
+    ORT_RETURN_IF(output == outputs.end(), "The streaming state output ", state.output_name,
+                  " is not an output of the model.");
+
+    // keep the state where it is consumed so feeding it to the next run doesn't copy it
+    InlinedVector<SessionState::NodeInfo> node_info_vec;
+    if (session_state_->GetInputNodeInfo(state.input_name, node_info_vec).IsOK() && !node_info_vec.empty() &&
+        node_info_vec.front().p_node != nullptr) {
+      state.device = *node_info_vec.front().device;
+    }
+
+    LOGS(*session_logger_, INFO) << "Streaming state " << state.input_name << " <- " << state.output_name
+                                 << " is kept on " << state.device.ToString();
+    streaming_states_.push_back(std::move(state));
+  }
+
+  return Status::OK();
+}
+
+void InferenceSession::ResetStreamingStates() {
+  std::lock_guard<std::mutex> lock(streaming_states_mutex_);
+  for (auto& state : streaming_states_) {
+    state.value = OrtValue();
+  }
+}
+
+Status InferenceSession::RunWithStreamingStates(const RunOptions& run_options,
+                                                gsl::span<const std::string> feed_names,
+                                                gsl::span<const OrtValue> feeds,
+                                                gsl::span<const std::string> output_names,
+                                                std::vector<OrtValue>* p_fetches,
+                                                const std::vector<OrtDevice>* p_fetches_device_info) {
+  ORT_RETURN_IF_NOT(feed_names.size() == feeds.size(), "The number of feed names and feeds don't match.");
+  ORT_RETURN_IF(p_fetches == nullptr, "Output vector pointer is NULL");
+
+  RunOptions state_run_options = run_options;
+  ORT_RETURN_IF_ERROR(state_run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigUseStreamingStates, "0"));
+
+  std::vector<std::string> state_feed_names(feed_names.begin(), feed_names.end());
+  std::vector<OrtValue> state_feeds(feeds.begin(), feeds.end());
+  std::vector<std::string> state_output_names(output_names.begin(), output_names.end());
+  std::vector<OrtValue> state_fetches = *p_fetches;
+  state_fetches.resize(output_names.size());
+  std::vector<OrtDevice> state_fetches_device_info =
+      p_fetches_device_info ? *p_fetches_device_info : std::vector<OrtDevice>(output_names.size());
+
+  std::lock_guard<std::mutex> lock(streaming_states_mutex_);
+
+  InlinedVector<size_t> state_fetch_indices;
+  state_fetch_indices.reserve(streaming_states_.size());
+  for (const auto& state : streaming_states_) {
+    // a state fed by the caller replaces the kept value, e.g. to start a sequence from a given state
+    if (state.value.IsAllocated() &&
+        std::find(feed_names.begin(), feed_names.end(), state.input_name) == feed_names.end()) {
+      state_feed_names.push_back(state.input_name);
+      state_feeds.push_back(state.value);
+    }
+
+    const auto output = std::find(output_names.begin(), output_names.end(), state.output_name);
+    if (output != output_names.end()) {
+      state_fetch_indices.push_back(static_cast<size_t>(output - output_names.begin()));
+    } else {
+      state_fetch_indices.push_back(state_output_names.size());
+      state_output_names.push_back(state.output_name);
+      state_fetches.emplace_back();
+      state_fetches_device_info.push_back(state.device);
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(Run(state_run_options, state_feed_names, state_feeds, state_output_names, &state_fetches,
+                          &state_fetches_device_info));
+
+  // the outputs are new values, the next run reads them as inputs without copying
+  for (size_t i = 0; i < streaming_states_.size(); ++i) {
+    streaming_states_[i].value = state_fetches[state_fetch_indices[i]];
+  }
+
+  state_fetches.resize(output_names.size());
+  *p_fetches = std::move(state_fetches);
+  return Status::OK();
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+Status InferenceSession::InitShapeSpecialization(size_t max_sessions) {
+  const std::string model_type =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigLoadModelFormat, "");
+  if (model_location_.empty() || model_type == "ORT" ||
+      (model_type.empty() && fbs::utils::IsOrtFormatModel(model_location_))) {
+    LOGS(*session_logger_, WARNING) << "Shape specialization is disabled as it requires an ONNX model loaded from a "
+                                       "path.";
+    return Status::OK();
+  }
+
+  for (const auto& ep : execution_providers_) {
+    if (ep->Type() != kCpuExecutionProvider) {
+      LOGS(*session_logger_, WARNING) << "Shape specialization is disabled as it is only supported with the CPU EP. "
+                                      << "The session uses " << ep->Type() << ".";
+      return Status::OK();
+    }
+  }
+
+  shape_specialization_min_runs_ = ParseStringWithClassicLocale<int64_t>(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsShapeSpecializationMinRuns, "10"));
+  ORT_RETURN_IF(shape_specialization_min_runs_ < 1, kOrtSessionOptionsShapeSpecializationMinRuns,
+                " must be at least 1.");
+
+  for (const NodeArg* input : model_->MainGraph().GetInputs()) {
+    const auto* shape = input->Shape();
+    if (shape == nullptr) {
+      continue;
+    }
+
+    InlinedVector<std::pair<size_t, std::string>> dims;
+    for (int i = 0; i < shape->dim_size(); ++i) {
+      if (utils::HasDimParam(shape->dim(i))) {
+        dims.emplace_back(static_cast<size_t>(i), shape->dim(i).dim_param());
+      }
+    }
+
+    if (!dims.empty()) {
+      shape_specialization_dims_.emplace(input->Name(), std::move(dims));
+    }
+  }
+
+  if (shape_specialization_dims_.empty()) {
+    LOGS(*session_logger_, INFO) << "Shape specialization has no effect as the inputs have no symbolic dimensions.";
+  }
+
+  shape_specialization_max_sessions_ = max_sessions;
+  return Status::OK();
+}
+
+InferenceSession* InferenceSession::GetShapeSpecializedSession(gsl::span<const std::string> feed_names,
+                                                               gsl::span<const OrtValue> feeds) {
+  // sorted by name so the key doesn't depend on the order of the feeds
+  std::map<std::string, int64_t> dim_values;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    const auto dims_it = shape_specialization_dims_.find(feed_names[i]);
+    if (dims_it == shape_specialization_dims_.end()) {
+      continue;
+    }
+
+    if (!feeds[i].IsTensor()) {
+      return nullptr;
+    }
+
+    const auto& shape = feeds[i].Get<Tensor>().Shape();
+    for (const auto& [axis, dim_param] : dims_it->second) {
+      // leave invalid feeds to the validation of the inputs
+      if (axis >= shape.NumDimensions()) {
+        return nullptr;
+      }
+
+      const auto [value_it, inserted] = dim_values.emplace(dim_param, shape[axis]);
+      if (!inserted && value_it->second != shape[axis]) {
+        return nullptr;
+      }
+    }
+  }
+
+  if (dim_values.empty()) {
+    return nullptr;
+  }
+
+  std::ostringstream key;
+  for (const auto& [dim_param, value] : dim_values) {
+    key << dim_param << '=' << value << ';';
+  }
+
+  // bounds the memory used to count the runs of shapes that are never specialized
+  constexpr size_t kMaxShapeSpecializationCandidates = 64;
+
+  ShapeSpecialization* specialization = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(shape_specializations_mutex_);
+    auto it = shape_specializations_.find(key.str());
+    if (it == shape_specializations_.end()) {
+      if (shape_specializations_.size() >= kMaxShapeSpecializationCandidates) {
+        return nullptr;
+      }
+      it = shape_specializations_.emplace(key.str(), ShapeSpecialization{}).first;
+    }
+
+    specialization = &it->second;
+    if (specialization->session) {
+      return specialization->session.get();
+    }
+
+    if (specialization->building || specialization->failed ||
+        ++specialization->num_runs < shape_specialization_min_runs_ ||
+        num_shape_specialized_sessions_ >= shape_specialization_max_sessions_) {
+      return nullptr;
+    }
+
+    specialization->building = true;
+    ++num_shape_specialized_sessions_;
+  }
+
+  // built by the run that reaches the number of runs. the concurrent runs with these shapes use this session.
+  std::vector<FreeDimensionOverride> dim_overrides;
+  dim_overrides.reserve(dim_values.size());
+  for (const auto& [dim_param, value] : dim_values) {
+    dim_overrides.push_back(FreeDimensionOverride{dim_param, FreeDimensionOverrideType::Name, value});
+  }
+
+  std::unique_ptr<InferenceSession> session;
+  const Status status = CreateShapeSpecializedSession(dim_overrides, session);
+
+  std::lock_guard<std::mutex> lock(shape_specializations_mutex_);
+  specialization->building = false;
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to build the shape-specialized session for " << key.str()
+                                    << ". The runs with these shapes use the session. " << status.ErrorMessage();
+    specialization->failed = true;
+    --num_shape_specialized_sessions_;
+    return nullptr;
+  }
+
+  LOGS(*session_logger_, INFO) << "Built the shape-specialized session for " << key.str();
+  specialization->session = std::move(session);
+  return specialization->session.get();
+}
+
+Status InferenceSession::CreateShapeSpecializedSession(const std::vector<FreeDimensionOverride>& dim_overrides,
+                                                       std::unique_ptr<InferenceSession>& session) const {
+  SessionOptions options = session_options_;
+  options.free_dimension_overrides.insert(options.free_dimension_overrides.end(), dim_overrides.begin(),
+                                          dim_overrides.end());
+  // the files written by the session are not written again by the specialized session
+  options.optimized_model_filepath.clear();
+  options.enable_profiling = false;
+  for (const char* key : {kOrtSessionOptionsShapeSpecializationMaxSessions,
+                          kOrtSessionOptionsDynamicBatchingMaxBatchSize,
+                          kOrtSessionOptionsOptimizedModelCacheDir,
+                          kOrtSessionOptionsMemoryPatternCacheFile,
+                          kOrtSessionOptionsIntraOpCostCalibrationFile}) {
+    options.config_options.configurations.erase(key);
+  }
+
+  Status status;
+  ORT_TRY {
+    session = std::make_unique<InferenceSession>(options, environment_, GetIntraOpThreadPoolToUse(),
+                                                 GetInterOpThreadPoolToUse());
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create the shape-specialized session: ", e.what());
+    });
+  }
+  ORT_RETURN_IF_ERROR(status);
+
+  for (const auto& custom_registry : custom_registries_) {
+    ORT_RETURN_IF_ERROR(session->RegisterCustomRegistry(custom_registry));
+  }
+
+  ORT_RETURN_IF_ERROR(session->Load(model_location_));
+  return session->Initialize();
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const char* const> feed_names,
                              gsl::span<const OrtValue* const> feeds,
@@ -2812,6 +3947,58 @@ Status InferenceSession::Run(const RunOptions& run_options,
   return Status::OK();
 }
 
+Status InferenceSession::Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                             gsl::span<const OrtValue* const> feeds, gsl::span<OrtValue*> fetches) {
+  const size_t num_feeds = prepared_run.feed_names_.size();
+  const size_t num_fetches = prepared_run.output_names_.size();
+  if (feeds.size() != num_feeds || fetches.size() != num_fetches) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The prepared run has ", num_feeds, " feeds and ",
+                           num_fetches, " fetches, but ", feeds.size(), " feeds and ", fetches.size(),
+                           " fetches were supplied.");
+  }
+
+  InlinedVector<OrtValue> feed_vec;
+  feed_vec.reserve(num_feeds);
+  for (size_t i = 0; i != num_feeds; ++i) {
+    if (!feeds[i]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NULL input supplied for input ",
+                             prepared_run.feed_names_[i]);
+    }
+    feed_vec.emplace_back(*feeds[i]);
+  }
+
+  std::vector<OrtValue> fetch_vec;
+  fetch_vec.reserve(num_fetches);
+  for (size_t i = 0; i != num_fetches; ++i) {
+    if (fetches[i] != nullptr) {
+      fetch_vec.emplace_back(*fetches[i]);
+    } else {
+      fetch_vec.emplace_back();
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(RunImpl(run_options, prepared_run.feed_names_, feed_vec, prepared_run.output_names_,
+                              &fetch_vec, nullptr, &prepared_run));
+
+  // We do it in two loops to make sure copy __ctors does not throw
+  InlinedVector<std::unique_ptr<OrtValue>> fetch_unique_ptrs;
+  fetch_unique_ptrs.reserve(num_fetches);
+  for (size_t i = 0; i != num_fetches; ++i) {
+    if (fetches[i] == nullptr) {
+      fetch_unique_ptrs.emplace_back(std::make_unique<OrtValue>(fetch_vec[i]));
+    } else {
+      fetch_unique_ptrs.emplace_back();
+    }
+  }
+
+  for (size_t i = 0; i != num_fetches; ++i) {
+    if (fetches[i] == nullptr) {
+      fetches[i] = fetch_unique_ptrs[i].release();
+    }
+  }
+  return Status::OK();
+}
+
 common::Status InferenceSession::RunAsync(const RunOptions* run_options,
                                           gsl::span<const char* const> feed_names,
                                           gsl::span<const OrtValue* const> feeds,
@@ -2946,6 +4133,112 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+common::Status InferenceSession::RunBatched(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                            gsl::span<const OrtValue> feeds,
+                                            gsl::span<const std::string> output_names,
+                                            std::vector<OrtValue>* p_fetches) {
+  if (!dynamic_batcher_) {
+    return Run(run_options, feed_names, feeds, output_names, p_fetches);
+  }
+
+  return dynamic_batcher_->Run(run_options, feed_names, feeds, output_names, p_fetches);
+}
+
+common::Status InferenceSession::RunBatched(const RunOptions& run_options, IOBinding& io_binding) {
+  if (!dynamic_batcher_) {
+    return Run(run_options, io_binding);
+  }
+
+  // outputs bound to a device without a pre-allocated OrtValue are returned on the device the model produced them on
+  return dynamic_batcher_->Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(),
+                               io_binding.GetOutputNames(), &io_binding.GetOutputs());
+}
+
+common::Status InferenceSession::Warmup(gsl::span<const std::unordered_map<std::string, TensorShape>> input_shapes,
+                                        const RunOptions& run_options) {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  const auto [inputs_status, model_inputs] = GetModelInputs();
+  ORT_RETURN_IF_ERROR(inputs_status);
+  const auto [outputs_status, model_outputs] = GetModelOutputs();
+  ORT_RETURN_IF_ERROR(outputs_status);
+
+  std::vector<std::string> feed_names;
+  feed_names.reserve(model_inputs->size());
+  for (const auto* input : *model_inputs) {
+    feed_names.push_back(input->Name());
+  }
+
+  std::vector<std::string> output_names;
+  output_names.reserve(model_outputs->size());
+  for (const auto* output : *model_outputs) {
+    output_names.push_back(output->Name());
+  }
+
+  // the warmup runs feed every state explicitly, so the streaming states are neither read nor updated
+  RunOptions warmup_run_options = run_options;
+  if (!streaming_states_.empty()) {
+    ORT_RETURN_IF_ERROR(warmup_run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigUseStreamingStates,
+                                                                         "0"));
+  }
+
+  AllocatorPtr allocator = session_state_->GetAllocator(OrtDevice());
+
+  ORT_ENFORCE(!is_warming_up_.exchange(true), "Warmup must not be called concurrently.");
+  session_profiler_.Pause();
+  auto end_warmup = gsl::finally([this]() {
+    session_profiler_.Resume();
+    is_warming_up_ = false;
+  });
+
+  for (size_t run = 0; run < input_shapes.size(); ++run) {
+    const auto& shapes = input_shapes[run];
+    for (const auto& [name, shape] : shapes) {
+      if (std::find(feed_names.begin(), feed_names.end(), name) == feed_names.end()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid input name for Warmup: ", name);
+      }
+    }
+
+    std::vector<OrtValue> feeds(feed_names.size());
+    for (size_t i = 0, end = feed_names.size(); i < end; ++i) {
+      const auto& name = feed_names[i];
+      const auto& metadata = input_def_map_.at(name);
+      if (!metadata.ml_data_type->IsTensorType()) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Warmup only supports tensor inputs. Input ", name,
+                               " is not a tensor.");
+      }
+
+      const TensorShape* shape = nullptr;
+      if (auto iter = shapes.find(name); iter != shapes.end()) {
+        shape = &iter->second;
+      } else if (metadata.tensor_shape.has_value()) {
+        shape = &*metadata.tensor_shape;
+      }
+
+      if (shape == nullptr || shape->Size() < 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Warmup requires a shape for input ", name,
+                               " as it does not have a static shape in the model.");
+      }
+
+      Tensor::InitOrtValue(metadata.ml_data_type->AsTensorType()->GetElementType(), *shape, allocator, feeds[i]);
+      Tensor& tensor = *feeds[i].GetMutable<Tensor>();
+      if (!tensor.IsDataTypeString()) {
+        memset(tensor.MutableDataRaw(), 0, tensor.SizeInBytes());
+      }
+    }
+
+    LOGS(*session_logger_, INFO) << "Warmup run " << run << " of " << input_shapes.size();
+
+    std::vector<OrtValue> fetches;
+    ORT_RETURN_IF_ERROR(Run(warmup_run_options, feed_names, feeds, output_names, &fetches));
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
@@ -2980,6 +4273,59 @@ std::string InferenceSession::EndProfiling() {
   return std::string();
 }
 
+common::Status InferenceSession::GetMemoryTimeline(std::string& timeline_json) const {
+  {
+    std::lock_guard<std::mutex> l(session_mutex_);
+    if (!is_inited_) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session not initialized.");
+    }
+  }
+
+  MemoryTimeline timeline;
+  ORT_RETURN_IF_ERROR(CreateMemoryTimeline(*session_state_, timeline));
+  timeline_json = timeline.ToJson();
+  return Status::OK();
+}
+
+std::string InferenceSession::GetMetrics() const {
+  SessionMetrics::Snapshot snapshot;
+  {
+    std::lock_guard<std::mutex> l(session_mutex_);
+    if (is_inited_) {
+      for (const auto& allocator : session_state_->GetAllocators()) {
+        AllocatorStats stats;
+        allocator.second->GetStats(&stats);
+        snapshot.allocator_stats.emplace_back(allocator.first.ToString(), stats);
+      }
+    }
+  }
+
+  const auto* intra_op_thread_pool = GetIntraOpThreadPoolToUse();
+  const auto* inter_op_thread_pool = GetInterOpThreadPoolToUse();
+  snapshot.intra_op_busy_ns = concurrency::ThreadPool::GetBusyNanoseconds(intra_op_thread_pool);
+  snapshot.intra_op_threads = concurrency::ThreadPool::NumThreads(intra_op_thread_pool);
+  snapshot.inter_op_busy_ns = concurrency::ThreadPool::GetBusyNanoseconds(inter_op_thread_pool);
+  snapshot.inter_op_threads = concurrency::ThreadPool::NumThreads(inter_op_thread_pool);
+  snapshot.intra_op_parallelism = concurrency::ThreadPool::GetParallelismStats(intra_op_thread_pool);
+  snapshot.inter_op_parallelism = concurrency::ThreadPool::GetParallelismStats(inter_op_thread_pool);
+  if (thread_pool_scheduler_client_) {
+    snapshot.scheduler_stats = thread_pool_scheduler_client_->GetStats();
+  }
+
+  return session_metrics_.ToPrometheusText(session_options_.session_logid.empty()
+                                               ? std::to_string(session_id_)
+                                               : session_options_.session_logid,
+                                           snapshot);
+}
+
+std::string InferenceSession::GetProfilingStatistics(bool reset) {
+  if (!session_profiler_.IsSamplingEnabled()) {
+    LOGS(*session_logger_, VERBOSE) << "Profiler sampling is disabled.";
+    return std::string();
+  }
+  return session_profiler_.GetSamplingStatistics(reset);
+}
+
 const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
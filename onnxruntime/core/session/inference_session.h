@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <map>
 #include <optional>
 #include <string>
@@ -29,6 +31,9 @@
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/platform/env.h"
+#include "core/session/session_metrics.h"
+#include "core/session/thread_pool_scheduler.h"
 #include <mutex>
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
@@ -48,6 +53,7 @@ class ModelProto;
 
 namespace onnxruntime {  // forward declarations
 class CustomRegistry;
+class DynamicBatcher;
 class Environment;
 class GraphTransformer;
 class IExecutionProvider;
@@ -127,6 +133,32 @@ class InferenceSession {
   };
 
   using InputOutputDefMetaMap = InlinedHashMap<std::string_view, InputOutputDefMetaData>;
+
+ public:
+  /**
+   * Feed and output names resolved once by PrepareRun, so that the runs using it pass the values by position.
+   * The names are mapped to value indices and to the metadata of the model inputs and outputs, and the static device
+   * copy info is initialized when it is created. It can be used concurrently by multiple runs of the session that
+   * created it, and must not outlive that session.
+   */
+  class PreparedRun {
+   public:
+    gsl::span<const std::string> FeedNames() const noexcept { return feed_names_; }
+    gsl::span<const std::string> OutputNames() const noexcept { return output_names_; }
+
+   private:
+    friend class InferenceSession;
+
+    const InferenceSession* session_ = nullptr;
+    std::vector<std::string> feed_names_;
+    std::vector<std::string> output_names_;
+    InlinedVector<const InputOutputDefMetaData*> feed_metadata_;
+    InlinedVector<const InputOutputDefMetaData*> output_metadata_;
+    // shared by the runs. see GetFeedsFetchesManagerForRun for when a run copies it.
+    std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+  };
+
+ private:
   static std::map<uint32_t, InferenceSession*> active_sessions_;
 #ifdef _WIN32
   static std::mutex active_sessions_mutex_;  // Protects access to active_sessions_
@@ -330,6 +362,22 @@ class InferenceSession {
    */
   [[nodiscard]] common::Status Initialize();
 
+  /**
+   * Creates an initialized session that shares the optimized graph, the execution providers, the kernels along with
+   * their pre-packed weights, and the initializers of this session, so no model loading, graph optimization,
+   * partitioning or kernel creation is done.
+   * The clone gets its own thread pools, logger, profiler, allocators and execution plan from session_options.
+   * Options that determine the graph or the kernels, such as the graph optimization level, are ignored as these
+   * are taken from this session.
+   * This session must be initialized and must outlive the clone.
+   * This API is thread-safe.
+   * @param session_options the options of the clone.
+   * @param clone the new session.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status Clone(const SessionOptions& session_options,
+                                     std::unique_ptr<InferenceSession>& clone) const;
+
   [[nodiscard]] common::Status SetEpDynamicOptions(gsl::span<const char* const> keys,
                                                    gsl::span<const char* const> values);
 
@@ -344,6 +392,29 @@ class InferenceSession {
                                    gsl::span<const char* const> fetch_names,
                                    gsl::span<OrtValue*> fetches);
 
+  /**
+   * Resolve the feed and output names of the runs to come once. See PreparedRun.
+   * @param feed_names names of the inputs the runs will feed, in the order of their values.
+   * @param output_names names of the outputs the runs will fetch, in the order of their values.
+   * @param prepared_run the prepared names.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status PrepareRun(gsl::span<const std::string> feed_names,
+                                          gsl::span<const std::string> output_names,
+                                          std::unique_ptr<PreparedRun>& prepared_run);
+
+  /**
+   * Run with the feed and output names of a PreparedRun. The values are passed by position and are checked against
+   * the model metadata resolved by PrepareRun without looking up any name.
+   * Multiple threads are allowed to run this function with the same PreparedRun.
+   * @param feeds values in the order of PreparedRun::FeedNames.
+   * @param fetches values in the order of PreparedRun::OutputNames. A nullptr entry is set to a new value owned by
+   *        the caller, the other entries are pre-allocated outputs.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status Run(const RunOptions& run_options, const PreparedRun& prepared_run,
+                                   gsl::span<const OrtValue* const> feeds, gsl::span<OrtValue*> fetches);
+
   [[nodiscard]] common::Status RunAsync(const RunOptions* run_options,
                                         gsl::span<const char* const> feed_names,
                                         gsl::span<const OrtValue* const> feeds,
@@ -384,6 +455,40 @@ class InferenceSession {
   [[nodiscard]] virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   [[nodiscard]] common::Status Run(IOBinding& io_binding);
 
+  /**
+   * Same as Run, but if dynamic batching is enabled with kOrtSessionOptionsDynamicBatchingMaxBatchSize the request
+   * may be coalesced with concurrent RunBatched calls along dimension 0 and executed as part of a single Run.
+   * The outputs are returned as slices of the batched outputs without copying, unless they were pre-allocated.
+   * Only requests whose run options agree on everything but logging are coalesced, and the log settings and tag of
+   * the first request in a batch apply to the whole batch.
+   * Multiple threads are expected to call this function concurrently.
+   */
+  [[nodiscard]] common::Status RunBatched(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                          gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                          std::vector<OrtValue>* p_fetches);
+  [[nodiscard]] common::Status RunBatched(const RunOptions& run_options, IOBinding& io_binding);
+
+  /**
+   * Run the model once per set of input shapes with zero filled inputs and discard the outputs, so that the lazy work
+   * of the first runs with these shapes is done before serving: the arenas grow to the peak of the runs, the memory
+   * patterns are recorded, the kernels are compiled and tuned, and the graphs are captured by the execution providers
+   * that do so.
+   * The runs are left out of the profiler, the session metrics and the telemetry. Warmup must not be called
+   * concurrently with other runs of the session.
+   * @param input_shapes per warmup run, the shapes of the model inputs. Inputs with a static shape in the model
+   *        may be omitted. Only tensor inputs are supported.
+   * @param run_options options of the warmup runs.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status Warmup(gsl::span<const std::unordered_map<std::string, TensorShape>> input_shapes,
+                                      const RunOptions& run_options = {});
+
+  /**
+   * Drops the values of the recurrent states kept by a session in the streaming mode enabled with
+   * kOrtSessionOptionsStreamingStates, so the next Run starts a new sequence.
+   */
+  void ResetStreamingStates();
+
 #ifdef ENABLE_TRAINING
   /**
    * Partially run a pre-loaded and pre-intialized model.
@@ -442,6 +547,13 @@ class InferenceSession {
    */
   int GetCurrentNumRuns() const;
 
+#if !defined(ORT_MINIMAL_BUILD)
+  /**
+   * Get the number of shape-specialized sessions built for kOrtSessionOptionsShapeSpecializationMaxSessions.
+   */
+  size_t GetNumShapeSpecializedSessions() const;
+#endif
+
   /**
    * Get the names of registered Execution Providers. The returned vector is ordered by Execution Provider
    * priority. The first provider in the vector has the highest priority.
@@ -489,6 +601,30 @@ class InferenceSession {
     @return the name of the profile file.
     */
   std::string EndProfiling();
+
+  /**
+    * Get the per node kernel time statistics of the sampled runs, as json.
+    * Sampling is enabled with the kOrtSessionOptionsProfilingSamplingInterval session config entry.
+    @param reset clears the statistics, so the next call reports the runs sampled after this one.
+    @return the statistics, or an empty string if sampling is not enabled.
+    */
+  std::string GetProfilingStatistics(bool reset);
+
+  /**
+    * Get the memory timeline of the main graph, simulated from the allocation plan without executing the model.
+    * The timeline lists the values that are live at each step of the execution order, and the peak of each device.
+    * Free dimension overrides can be used to simulate the timeline for a given batch size.
+    @param timeline_json the timeline as json. See MemoryTimeline::ToJson.
+    @return OK if the session was initialized.
+    */
+  common::Status GetMemoryTimeline(std::string& timeline_json) const;
+
+  /**
+    * Get the metrics of the session in the Prometheus text exposition format: run latency and queue wait
+    * histograms, allocator stats, thread pool busy time and the nodes assigned to each execution provider.
+    @return the metrics. Only the run metrics are set if the session is not initialized.
+    */
+  std::string GetMetrics() const;
   /**
     * Return the profiler to access its attributes
     @return the profiler object
@@ -632,6 +768,14 @@ class InferenceSession {
   }
 
   common::Status SaveToOrtFormat(const std::filesystem::path& filepath) const;
+
+  // Replaces the model with the optimized model in the kOrtSessionOptionsOptimizedModelCacheDir directory, if it is
+  // there. Otherwise sets cache_path to the file the optimized model should be saved to.
+  // cache_path is left empty if the session doesn't use the cache.
+  [[nodiscard]] common::Status LoadFromOptimizedModelCache(std::filesystem::path& cache_path);
+
+  // Saves the optimized model to the cache. The session is usable even if that fails, so errors are only logged.
+  void SaveToOptimizedModelCache(const std::filesystem::path& cache_path) const;
 #endif
 
   /**
@@ -653,6 +797,9 @@ class InferenceSession {
 
   [[nodiscard]] common::Status LoadOrtModelWithLoader(std::function<Status()> load_ort_format_model_bytes);
 
+  // whether an ORT format model file is mapped into memory instead of read
+  bool MapOrtModelFile() const;
+
   // Create a Logger for a single execution if possible. Otherwise use the default logger.
   // If a new logger is created, it will also be stored in new_run_logger,
   // which must remain valid for the duration of the execution.
@@ -679,8 +826,30 @@ class InferenceSession {
                                                      const InputOutputDefMetaMap& input_output_meta_map,
                                                      ArgType arg_type) const;
 
+  [[nodiscard]] common::Status ValidateInputOutput(const std::string& name, const OrtValue& input_output_ml_value,
+                                                   const InputOutputDefMetaData& metadata, ArgType arg_type) const;
+
+  // Validates the values of a run by position against the metadata resolved by PrepareRun.
+  [[nodiscard]] common::Status ValidatePreparedRun(const PreparedRun& prepared_run, gsl::span<const OrtValue> feeds,
+                                                   const std::vector<OrtValue>& fetches) const;
+
+  [[nodiscard]] common::Status RunImpl(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                       gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                       std::vector<OrtValue>* p_fetches,
+                                       const std::vector<OrtDevice>* p_fetches_device_info,
+                                       const PreparedRun* prepared_run);
+
   [[nodiscard]] common::Status WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms);
 
+  // Returns a feeds and fetches manager for the feed and output names with the static device copy info initialized.
+  // The managers of the first kMaxCachedFeedsFetchesManagers distinct names are cached and shared by the runs, so
+  // these skip mapping the names and locating the values. Once the cache is full, the manager of other names is
+  // created for the run and owned by `run_manager`.
+  [[nodiscard]] common::Status GetFeedsFetchesManagerForRun(gsl::span<const std::string> feed_names,
+                                                            gsl::span<const std::string> output_names,
+                                                            FeedsFetchesManager*& manager,
+                                                            std::unique_ptr<FeedsFetchesManager>& run_manager);
+
   template <typename T>
   void StartProfiling(const std::basic_string<T>& file_prefix);
 
@@ -746,6 +915,12 @@ class InferenceSession {
   // It has a dependency on execution_providers_.
   std::unique_ptr<SessionState> session_state_;
 
+  // Coalesces concurrent RunBatched requests. nullptr if dynamic batching is not enabled.
+  std::unique_ptr<DynamicBatcher> dynamic_batcher_;
+
+  // Run statistics exported by GetMetrics.
+  SessionMetrics session_metrics_;
+
   // Threadpools per session. These are initialized and used for the entire duration of the session
   // when use_per_session_threads is true.
   std::basic_string<ORTCHAR_T> thread_pool_name_;
@@ -757,13 +932,23 @@ class InferenceSession {
   // Spinning is restarted on the next Run()
   bool force_spinning_stop_between_runs_ = false;
 
+  // The intra-op threads spin without blocking while a Run() is in progress, see
+  // kOrtSessionOptionsConfigIntraOpSpinDuringRun.
+  bool intra_op_spin_during_run_ = false;
+
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // Measured costs of the parallel loops of thread_pool_. nullptr if cost calibration is not enabled.
+  std::shared_ptr<onnxruntime::concurrency::ParallelForCostCalibration> cost_calibration_;
+
   // Global threadpools. These are intialized and used when use_per_session_threads is false *and*
   // the environment is created with create_global_thread_pools = true.
   onnxruntime::concurrency::ThreadPool* intra_op_thread_pool_from_env_{};
   onnxruntime::concurrency::ThreadPool* inter_op_thread_pool_from_env_{};
+  // Share of the global intra-op thread pool given to the session. nullptr with per session threadpools, or when
+  // none of the session.global_thread_pool.* options is set.
+  std::unique_ptr<ThreadPoolScheduler::Client> thread_pool_scheduler_client_;
 
   // External threadpools.
   onnxruntime::concurrency::ThreadPool* external_intra_op_thread_pool_{};
@@ -801,11 +986,21 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_ = 0;
 
+  // Set while Warmup runs the model, to leave these runs out of the metrics and the telemetry
+  std::atomic<bool> is_warming_up_ = false;
+
   mutable std::mutex session_mutex_;         // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;             // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                   // GUARDED_BY(session_mutex_)
   bool is_concurrent_run_supported_ = true;  // Graph execution in Run is GUARDED_BY(session_mutex_) if false
 
+  // Feeds and fetches managers of the names the session has been run with, never finalized with the feeds and
+  // fetches of a run. The first num_cached_feeds_fetches_managers_ entries are published and are read without a lock.
+  static constexpr size_t kMaxCachedFeedsFetchesManagers = 8;
+  std::array<std::unique_ptr<FeedsFetchesManager>, kMaxCachedFeedsFetchesManagers> cached_feeds_fetches_managers_;
+  std::atomic<size_t> num_cached_feeds_fetches_managers_{0};
+  std::mutex cached_feeds_fetches_managers_mutex_;  // serializes adding a manager
+
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
   InterOpDomains interop_domains_;
 #endif
@@ -862,6 +1057,10 @@ class InferenceSession {
   // "session.use_ort_model_bytes_directly" to "1", this will be empty
   std::vector<uint8_t> ort_format_model_bytes_data_holder_;
 
+  // The mapping of the model file, when the session is started with the path of an ORT format model and
+  // "session.map_ort_model_file" isn't "0". ort_format_model_bytes_data_holder_ is empty in that case.
+  Env::MappedMemoryPtr ort_format_model_mapped_bytes_;
+
   bool using_ort_model_bytes_for_initializers_{false};
 
   // Container to store pre-packed weights to share between sessions.
@@ -911,6 +1110,86 @@ class InferenceSession {
   };
 
   CachedExecutionProviderForGraphReplay cached_execution_provider_for_graph_replay_;
+
+  // Runs with a graph annotation id per set of input shapes. See kOrtSessionOptionsGraphCaptureByInputShapes.
+  [[nodiscard]] common::Status RunWithGraphCaptureByInputShapes(const RunOptions& run_options,
+                                                                gsl::span<const std::string> feed_names,
+                                                                gsl::span<const OrtValue> feeds,
+                                                                gsl::span<const std::string> output_names,
+                                                                std::vector<OrtValue>* p_fetches,
+                                                                const std::vector<OrtDevice>* p_fetches_device_info);
+
+  // The inputs and outputs of the graph captured for a set of input shapes.
+  // Their addresses are recorded in the graph, so they live as long as the graph does.
+  struct GraphCaptureShapeBucket {
+    int graph_annotation_id;
+    std::vector<OrtValue> feeds;
+    std::vector<OrtValue> fetches;
+    bool is_captured = false;
+  };
+
+  // Parses kOrtSessionOptionsStreamingStates once the session state is finalized.
+  [[nodiscard]] common::Status InitStreamingStates(const std::string& streaming_states);
+
+  // Run of a session in the streaming mode: feeds the kept values of the states the caller doesn't feed and keeps
+  // the values of the state outputs for the next run.
+  [[nodiscard]] common::Status RunWithStreamingStates(const RunOptions& run_options,
+                                                      gsl::span<const std::string> feed_names,
+                                                      gsl::span<const OrtValue> feeds,
+                                                      gsl::span<const std::string> output_names,
+                                                      std::vector<OrtValue>* p_fetches,
+                                                      const std::vector<OrtDevice>* p_fetches_device_info);
+
+  // A recurrent state of the streaming mode, the output value of a run is the input value of the next one.
+  struct StreamingState {
+    std::string input_name;
+    std::string output_name;
+    // the device the state is kept on, the one of the nodes consuming the input
+    OrtDevice device;
+    OrtValue value;
+  };
+
+  std::vector<StreamingState> streaming_states_;
+  // held for the whole run as each run uses the states of the previous one
+  std::mutex streaming_states_mutex_;
+
+  bool graph_capture_by_input_shapes_ = false;
+  // held for the whole run as the runs of a bucket share its buffers
+  std::mutex graph_capture_buckets_mutex_;
+  // keyed by the names, types and shapes of the feeds
+  std::unordered_map<std::string, GraphCaptureShapeBucket> graph_capture_buckets_;
+  int next_graph_capture_annotation_id_ = 1;
+
+#if !defined(ORT_MINIMAL_BUILD)
+  // Sets up the shape specialization requested with kOrtSessionOptionsShapeSpecializationMaxSessions.
+  [[nodiscard]] common::Status InitShapeSpecialization(size_t max_sessions);
+
+  // Returns the shape-specialized session for the values of the symbolic dimensions of the feeds, building it if
+  // they have been seen often enough. Returns nullptr if the run should use this session.
+  InferenceSession* GetShapeSpecializedSession(gsl::span<const std::string> feed_names,
+                                               gsl::span<const OrtValue> feeds);
+
+  [[nodiscard]] common::Status CreateShapeSpecializedSession(
+      const std::vector<FreeDimensionOverride>& dim_overrides, std::unique_ptr<InferenceSession>& session) const;
+
+  struct ShapeSpecialization {
+    int64_t num_runs = 0;
+    std::unique_ptr<InferenceSession> session;
+    // set while the session is built, and if building it failed
+    bool building = false;
+    bool failed = false;
+  };
+
+  size_t shape_specialization_max_sessions_ = 0;
+  int64_t shape_specialization_min_runs_ = 0;
+  // the symbolic dimensions of each graph input, as pairs of axis and dim_param
+  InlinedHashMap<std::string, InlinedVector<std::pair<size_t, std::string>>> shape_specialization_dims_;
+  mutable std::mutex shape_specializations_mutex_;
+  // keyed by the values of the symbolic dimensions. entries are never erased, so the sessions can be used without
+  // holding the mutex.
+  std::unordered_map<std::string, ShapeSpecialization> shape_specializations_;
+  size_t num_shape_specialized_sessions_ = 0;
+#endif
 };
 
 struct SessionIOBinding {
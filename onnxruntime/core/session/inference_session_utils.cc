@@ -5,6 +5,10 @@
 
 #include "core/session/inference_session_utils.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
 namespace onnxruntime {
 
 //---------------------
@@ -45,13 +49,14 @@ static Status SetInterOpNumThreads(SessionOptions& session_options,
 static Status SetExecutionMode(SessionOptions& session_options,
                                int value,
                                const logging::Logger& logger) {
-  if (value != 0 && value != 1) {
+  static constexpr const char* kModeNames[] = {"Sequential mode", "Parallel mode", "Parallel work stealing mode"};
+  if (value < 0 || value > static_cast<int>(ExecutionMode::ORT_PARALLEL_WORK_STEALING)) {
     LOGS(logger, ERROR) << "Unsupported execution_mode value in ORT config: " << value;
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported execution_mode value in ORT config: ", value);
   }
 
-  LOGS(logger, INFO) << "Setting execution_mode to " << (value == 0 ? "Sequential mode" : "Parallel mode");
-  session_options.execution_mode = (value == 0 ? ExecutionMode::ORT_SEQUENTIAL : ExecutionMode::ORT_PARALLEL);
+  LOGS(logger, INFO) << "Setting execution_mode to " << kModeNames[value];
+  session_options.execution_mode = static_cast<ExecutionMode>(value);
   return Status::OK();
 }
 
@@ -110,6 +115,11 @@ void from_json(const json& j, TuningResults& trs) {
   j.at("validators").get_to(trs.validators);
 }
 
+// This function is called by nlohmann/json
+void to_json(json& j, const TuningResults& trs) {
+  j = json{{"ep", trs.ep}, {"results", trs.results}, {"validators", trs.validators}};
+}
+
 //---------------------------------------------------
 //--- end of session options related helpers ---
 //---------------------------------------------------
@@ -265,6 +275,64 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
   return Status::OK();
 }
 
+Status LoadTuningResultsFromFile(const PathString& file_path, std::vector<TuningResults>& results) {
+  results.clear();
+  std::ifstream in(file_path);
+  ORT_RETURN_IF(!in, "Failed to open tuning results cache file ", PathToUTF8String(file_path));
+
+  Status status;
+  ORT_TRY {
+    results = json::parse(in).get<std::vector<TuningResults>>();
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Tuning results cache file ", PathToUTF8String(file_path),
+                               " cannot be parsed. Error message: ", e.what());
+    });
+  }
+
+  return status;
+}
+
+Status SaveTuningResultsToFile(const PathString& file_path, const std::vector<TuningResults>& results) {
+  // write to a temporary file first so that a reader never sees a partially written cache
+  PathString temp_path = file_path + ORT_TSTR(".tmp");
+  {
+    std::ofstream out(temp_path, std::ios::trunc);
+    ORT_RETURN_IF(!out, "Failed to open tuning results cache file ", PathToUTF8String(temp_path));
+    out << json(results).dump();
+    ORT_RETURN_IF(!out, "Failed to write tuning results cache file ", PathToUTF8String(temp_path));
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(temp_path, file_path, ec);
+  ORT_RETURN_IF(ec, "Failed to replace tuning results cache file ", PathToUTF8String(file_path), ": ", ec.message());
+  return Status::OK();
+}
+
+void MergeTuningResults(std::vector<TuningResults>& cached_results, const std::vector<TuningResults>& results) {
+  for (const auto& tr : results) {
+    if (tr.results.empty()) {
+      continue;
+    }
+
+    auto it = std::find_if(cached_results.begin(), cached_results.end(), [&tr](const TuningResults& cached) {
+      return cached.ep == tr.ep && cached.validators == tr.validators;
+    });
+    if (it == cached_results.end()) {
+      cached_results.push_back(tr);
+      continue;
+    }
+
+    for (const auto& [op_signature, kernel_map] : tr.results) {
+      auto& cached_kernel_map = it->results[op_signature];
+      for (const auto& [params_signature, kernel_id] : kernel_map) {
+        cached_kernel_map[params_signature] = kernel_id;
+      }
+    }
+  }
+}
+
 }  // namespace inference_session_utils
 }  // namespace onnxruntime
 
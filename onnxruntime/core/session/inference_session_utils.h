@@ -65,6 +65,19 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
                                            /*out*/ bool& key_found,
                                            const logging::Logger& logger);
 
+// Reads the TuningResults persisted in a tuning results cache file.
+// The file can hold the results of several execution providers, devices or library versions.
+Status LoadTuningResultsFromFile(const PathString& file_path,
+                                 /*out*/ std::vector<TuningResults>& results);
+
+// Writes TuningResults to a tuning results cache file, replacing its content.
+Status SaveTuningResultsToFile(const PathString& file_path, const std::vector<TuningResults>& results);
+
+// Merges `results` into `cached_results`. The results of an entry with the same EP and validators as an entry of
+// `cached_results` are added to it, replacing the kernel selected for any params signature both contain. Other
+// entries are appended.
+void MergeTuningResults(std::vector<TuningResults>& cached_results, const std::vector<TuningResults>& results);
+
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 }  // namespace inference_session_utils
@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/lora_adapter_cache.h"
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace lora {
+
+LoraAdapterCache::LoraAdapterCache(AllocatorPtr device_allocator, std::unique_ptr<IDataTransfer> data_transfer,
+                                   size_t budget_bytes)
+    : device_allocator_(std::move(device_allocator)),
+      data_transfer_(std::move(data_transfer)),
+      budget_bytes_(budget_bytes) {
+  ORT_ENFORCE(device_allocator_ != nullptr && data_transfer_ != nullptr,
+              "LoraAdapterCache requires a device allocator and a data transfer");
+  stats_.budget_bytes = budget_bytes_;
+  prefetch_thread_ = std::thread([this]() { RunPrefetches(); });
+}
+
+LoraAdapterCache::~LoraAdapterCache() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+
+  // the queued prefetches are completed, as their adapters are marked as being paged in
+  prefetch_requested_.notify_one();
+  prefetch_thread_.join();
+}
+
+size_t LoraAdapterCache::Add(const std::filesystem::path& file_path) {
+  LoraAdapter adapter;
+  adapter.MemoryMap(file_path);
+  return Add(std::move(adapter));
+}
+
+size_t LoraAdapterCache::Add(LoraAdapter adapter) {
+  size_t size_in_bytes = 0;
+  for (auto [it, end] = adapter.GetParamIterators(); it != end; ++it) {
+    size_in_bytes += it->second.GetMapped().Get<Tensor>().SizeInBytes();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& entry = entries_.emplace_back();
+  entry.adapter = std::move(adapter);
+  entry.size_in_bytes = size_in_bytes;
+  entry.lru_position = lru_.end();
+  stats_.num_adapters = entries_.size();
+  return entries_.size() - 1;
+}
+
+Status LoraAdapterCache::Acquire(size_t adapter, std::shared_ptr<const ResidentAdapter>& resident) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  ORT_RETURN_IF_NOT(adapter < entries_.size(), "Invalid LoRA adapter index ", adapter, " for ", entries_.size(),
+                    " adapters");
+
+  Entry& entry = entries_[adapter];
+  if (entry.state == State::kMapped) {
+    ++stats_.misses;
+    ORT_RETURN_IF_ERROR(BeginPageIn(adapter, lock));
+    lock.unlock();
+    const Status status = PageIn(adapter);
+    lock.lock();
+    ORT_RETURN_IF_ERROR(status);
+  } else {
+    ++stats_.hits;
+    // a prefetch may be paging it in, and fail
+    page_in_done_.wait(lock, [&entry]() { return entry.state != State::kPagingIn; });
+    if (entry.state == State::kMapped) {
+      ORT_RETURN_IF_ERROR(BeginPageIn(adapter, lock));
+      lock.unlock();
+      const Status status = PageIn(adapter);
+      lock.lock();
+      ORT_RETURN_IF_ERROR(status);
+    }
+  }
+
+  lru_.splice(lru_.begin(), lru_, entry.lru_position);
+  resident = entry.resident;
+  return Status::OK();
+}
+
+void LoraAdapterCache::Prefetch(size_t adapter) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // if the budget is held by the adapters in use, Acquire reports it
+    if (adapter >= entries_.size() || entries_[adapter].state != State::kMapped ||
+        !BeginPageIn(adapter, lock).IsOK()) {
+      return;
+    }
+
+    ++stats_.prefetches;
+    prefetch_queue_.push_back(adapter);
+  }
+
+  prefetch_requested_.notify_one();
+}
+
+LoraAdapterCache::Stats LoraAdapterCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.resident_bytes = resident_bytes_;
+  stats.num_resident = lru_.size();
+  return stats;
+}
+
+Status LoraAdapterCache::BeginPageIn(size_t adapter, std::unique_lock<std::mutex>& /*lock*/) {
+  Entry& entry = entries_[adapter];
+  ORT_RETURN_IF_NOT(entry.size_in_bytes <= budget_bytes_, "LoRA adapter ", adapter, " of ", entry.size_in_bytes,
+                    " bytes exceeds the cache budget of ", budget_bytes_, " bytes");
+
+  // evict the least recently used adapters that nobody holds
+  for (auto it = lru_.end(); resident_bytes_ + entry.size_in_bytes > budget_bytes_ && it != lru_.begin();) {
+    --it;
+    Entry& candidate = entries_[*it];
+    if (candidate.resident.use_count() > 1) {
+      continue;
+    }
+
+    resident_bytes_ -= candidate.size_in_bytes;
+    candidate.resident.reset();
+    candidate.state = State::kMapped;
+    candidate.lru_position = lru_.end();
+    it = lru_.erase(it);
+    ++stats_.evictions;
+  }
+
+  ORT_RETURN_IF_NOT(resident_bytes_ + entry.size_in_bytes <= budget_bytes_, "LoRA adapter ", adapter,
+                    " does not fit in the cache budget of ", budget_bytes_, " bytes with the adapters in use");
+
+  resident_bytes_ += entry.size_in_bytes;
+  entry.state = State::kPagingIn;
+  return Status::OK();
+}
+
+Status LoraAdapterCache::PageIn(size_t adapter) {
+  // the entry is not modified by other threads while it is being paged in
+  Entry& entry = entries_[adapter];
+  auto resident = std::make_shared<ResidentAdapter>();
+  resident->size_in_bytes = entry.size_in_bytes;
+
+  Status status;
+  ORT_TRY {
+    for (auto [it, end] = entry.adapter.GetParamIterators(); it != end && status.IsOK(); ++it) {
+      const auto& mapped = it->second.GetMapped().Get<Tensor>();
+      Tensor on_device(mapped.DataType(), mapped.Shape(), device_allocator_);
+      status = data_transfer_->CopyTensor(mapped, on_device);
+      OrtValue value;
+      Tensor::InitOrtValue(std::move(on_device), value);
+      resident->params.emplace_back(it->first, std::move(value));
+    }
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to page in LoRA adapter ", adapter, ": ", ex.what());
+    });
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (status.IsOK()) {
+      entry.resident = std::move(resident);
+      entry.state = State::kResident;
+      lru_.push_front(adapter);
+      entry.lru_position = lru_.begin();
+    } else {
+      resident_bytes_ -= entry.size_in_bytes;
+      entry.state = State::kMapped;
+    }
+  }
+
+  page_in_done_.notify_all();
+  return status;
+}
+
+void LoraAdapterCache::RunPrefetches() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    prefetch_requested_.wait(lock, [this]() { return stop_ || !prefetch_queue_.empty(); });
+    if (prefetch_queue_.empty()) {
+      return;
+    }
+
+    const size_t adapter = prefetch_queue_.front();
+    prefetch_queue_.pop_front();
+    lock.unlock();
+    // a failed prefetch leaves the adapter mapped, so Acquire pages it in again and reports the error
+    ORT_IGNORE_RETURN_VALUE(PageIn(adapter));
+    lock.lock();
+  }
+}
+
+}  // namespace lora
+}  // namespace onnxruntime
@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/data_transfer.h"
+#include "core/framework/ort_value.h"
+#include "core/session/lora_adapters.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace onnxruntime {
+namespace lora {
+
+/// <summary>
+/// Keeps the device copies of the most recently used of many LoRA adapters within a memory budget.
+/// The adapters are memory mapped when they are added, and their parameters are copied to the device when they are
+/// acquired, evicting the least recently used adapters that are not in use to stay within the budget.
+/// Adapters can be prefetched: a background thread pages them in so a later Acquire finds them resident.
+/// </summary>
+class LoraAdapterCache {
+ public:
+  /// <summary>
+  /// The device copies of the parameters of an adapter. The adapter is not evicted while a reference to it is held.
+  /// </summary>
+  struct ResidentAdapter {
+    std::vector<std::pair<std::string, OrtValue>> params;
+    size_t size_in_bytes{0};
+  };
+
+  struct Stats {
+    size_t num_adapters{0};
+    size_t num_resident{0};
+    // bytes of the resident adapters and of those being paged in
+    size_t resident_bytes{0};
+    size_t budget_bytes{0};
+    // acquisitions that found the adapter resident or being paged in by a prefetch, and those that paged it in
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t prefetches{0};
+    uint64_t evictions{0};
+  };
+
+  /// <summary>
+  /// Creates an empty cache.
+  /// </summary>
+  /// <param name="device_allocator">allocator of the device copies</param>
+  /// <param name="data_transfer">copies the mapped parameters to the memory of device_allocator</param>
+  /// <param name="budget_bytes">maximum size of the device copies</param>
+  LoraAdapterCache(AllocatorPtr device_allocator, std::unique_ptr<IDataTransfer> data_transfer, size_t budget_bytes);
+
+  /// <summary>
+  /// Waits for the requested prefetches. The device copies are released once they are no longer referenced.
+  /// </summary>
+  ~LoraAdapterCache();
+
+  /// <summary>
+  /// Memory maps an adapter file and returns the index of the adapter in the cache.
+  /// </summary>
+  size_t Add(const std::filesystem::path& file_path);
+
+  /// <summary>
+  /// Adds a loaded adapter that has no device copies and returns its index in the cache.
+  /// </summary>
+  size_t Add(LoraAdapter adapter);
+
+  /// <summary>
+  /// Gets the device copies of an adapter, copying them if the adapter is not resident.
+  /// Fails if the adapter doesn't fit in the budget with the adapters in use.
+  /// </summary>
+  Status Acquire(size_t adapter, std::shared_ptr<const ResidentAdapter>& resident);
+
+  /// <summary>
+  /// Starts paging in an adapter in the background, if it isn't resident and fits in the budget.
+  /// </summary>
+  void Prefetch(size_t adapter);
+
+  Stats GetStats() const;
+
+ private:
+  enum class State {
+    kMapped,
+    kPagingIn,
+    kResident,
+  };
+
+  struct Entry {
+    LoraAdapter adapter;
+    size_t size_in_bytes{0};
+    State state{State::kMapped};
+    std::shared_ptr<const ResidentAdapter> resident;
+    std::list<size_t>::iterator lru_position;
+  };
+
+  // Reserves the budget for the adapter, evicting others as needed, and marks it as being paged in.
+  // Called with mutex_ held.
+  Status BeginPageIn(size_t adapter, std::unique_lock<std::mutex>& lock);
+
+  // Copies the parameters of an adapter for which BeginPageIn succeeded.
+  Status PageIn(size_t adapter);
+
+  void RunPrefetches();
+
+  AllocatorPtr device_allocator_;
+  std::unique_ptr<IDataTransfer> data_transfer_;
+  const size_t budget_bytes_;
+
+  mutable std::mutex mutex_;
+  // signaled when a page in ends and when a prefetch is requested
+  std::condition_variable page_in_done_;
+  std::condition_variable prefetch_requested_;
+  // entries are not moved once added, so they can be read without the lock while being paged in
+  std::deque<Entry> entries_;                 // GUARDED_BY(mutex_)
+  std::list<size_t> lru_;                     // GUARDED_BY(mutex_), most recently used first
+  std::deque<size_t> prefetch_queue_;         // GUARDED_BY(mutex_)
+  size_t resident_bytes_{0};                  // GUARDED_BY(mutex_)
+  Stats stats_;                               // GUARDED_BY(mutex_)
+  bool stop_{false};                          // GUARDED_BY(mutex_)
+
+  std::thread prefetch_thread_;
+};
+
+}  // namespace lora
+}  // namespace onnxruntime
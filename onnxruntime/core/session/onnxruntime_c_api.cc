@@ -13,6 +13,7 @@
 #include <cassert>
 #include <cstring>
 #include <functional>
+#include <map>
 #include <sstream>
 
 #include "core/common/common.h"
@@ -27,6 +28,7 @@
 #include "core/framework/ort_value.h"
 #include "core/providers/get_execution_providers.h"
 #include "core/session/environment.h"
+#include "core/session/ep_selection.h"
 #include "core/framework/callback.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
@@ -792,6 +794,81 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSession, _In_ const OrtEnv* env, _In_ const O
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SelectFastestSessionOptions, _In_ const OrtEnv* env, _In_ const ORTCHAR_T* model_path,
+                    _In_reads_(num_candidates) const OrtSessionOptions* const* candidates, size_t num_candidates,
+                    _In_opt_z_ const ORTCHAR_T* cache_path, float accuracy_tolerance, int num_runs,
+                    _Out_ size_t* selected_index) {
+  API_IMPL_BEGIN
+#if !defined(ORT_MINIMAL_BUILD)
+  // the fingerprint of a candidate identifies its execution providers with their options and its configuration
+  std::vector<std::string> fingerprints;
+  fingerprints.reserve(num_candidates);
+  for (size_t i = 0; i < num_candidates; ++i) {
+    if (candidates[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "candidate session options cannot be null");
+    }
+
+    std::ostringstream fingerprint;
+    for (const auto& factory : candidates[i]->provider_factories) {
+      auto provider = factory->CreateProvider();
+      if (provider) {
+        fingerprint << provider->Type() << '{';
+        std::map<std::string, std::string> provider_options(provider->GetProviderOptions().begin(),
+                                                            provider->GetProviderOptions().end());
+        for (const auto& [key, value] : provider_options) {
+          fingerprint << key << '=' << value << ';';
+        }
+        fingerprint << '}';
+      }
+    }
+    fingerprint << static_cast<int>(candidates[i]->value.graph_optimization_level) << '{';
+    std::map<std::string, std::string> config_entries(candidates[i]->value.config_options.configurations.begin(),
+                                                      candidates[i]->value.config_options.configurations.end());
+    for (const auto& [key, value] : config_entries) {
+      fingerprint << key << '=' << value << ';';
+    }
+    fingerprint << '}';
+    fingerprints.push_back(fingerprint.str());
+  }
+
+  std::string key;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(ep_selection::GetDecisionKey(model_path, fingerprints, key));
+
+  ep_selection::SelectionOptions selection_options;
+  selection_options.num_runs = num_runs;
+  selection_options.accuracy_tolerance = accuracy_tolerance;
+  if (cache_path != nullptr) {
+    selection_options.cache_file = cache_path;
+  }
+
+  auto create_session = [&](size_t index, std::unique_ptr<InferenceSession>& sess) -> Status {
+    std::unique_ptr<OrtStatus, decltype(&OrtApis::ReleaseStatus)> status(nullptr, OrtApis::ReleaseStatus);
+    status.reset(CreateSessionAndLoadModel(candidates[index], env, model_path, nullptr, 0, sess));
+    if (!status) {
+      status.reset(InitializeSession(candidates[index], sess));
+    }
+    return status ? ToStatus(status.get()) : Status::OK();
+  };
+
+  ORT_API_RETURN_IF_STATUS_NOT_OK(ep_selection::SelectFastestCandidate(key, num_candidates, create_session,
+                                                                       selection_options,
+                                                                       logging::LoggingManager::DefaultLogger(),
+                                                                       *selected_index));
+  return nullptr;
+#else
+  ORT_UNUSED_PARAMETER(env);
+  ORT_UNUSED_PARAMETER(model_path);
+  ORT_UNUSED_PARAMETER(candidates);
+  ORT_UNUSED_PARAMETER(num_candidates);
+  ORT_UNUSED_PARAMETER(cache_path);
+  ORT_UNUSED_PARAMETER(accuracy_tolerance);
+  ORT_UNUSED_PARAMETER(num_runs);
+  ORT_UNUSED_PARAMETER(selected_index);
+  return OrtApis::CreateStatus(ORT_NOT_IMPLEMENTED, "SelectFastestSessionOptions is not supported in a minimal build.");
+#endif
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromArray, _In_ const OrtEnv* env, _In_ const void* model_data,
                     size_t model_data_length, _In_ const OrtSessionOptions* options, _Outptr_ OrtSession** out) {
   API_IMPL_BEGIN
@@ -938,6 +1015,63 @@ ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _Inout_ OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  InlinedVector<std::string> input_name_vec;
+  input_name_vec.reserve(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    input_name_vec.emplace_back(input_names[i]);
+  }
+
+  InlinedVector<std::string> output_name_vec;
+  output_name_vec.reserve(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names[i] == nullptr || output_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_name_vec.emplace_back(output_names[i]);
+  }
+
+  std::unique_ptr<::onnxruntime::InferenceSession::PreparedRun> prepared_run;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->PrepareRun(input_name_vec, output_name_vec, prepared_run));
+  *out = reinterpret_cast<OrtPreparedRun*>(prepared_run.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const OrtPreparedRun* prepared_run,
+                    _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                    _Inout_updates_all_(output_len) OrtValue** outputs, size_t output_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  const auto& prepared = *reinterpret_cast<const ::onnxruntime::InferenceSession::PreparedRun*>(prepared_run);
+
+  auto input_span = gsl::make_span(inputs, input_len);
+  auto output_span = gsl::make_span(outputs, output_len);
+
+  Status status;
+  if (run_options != nullptr) {
+    if (!run_options->active_adapters.empty()) {
+      LOGS(*session->GetLogger(), WARNING) << "RunPrepared() active adapters specified, but won't have an effect";
+    }
+    status = session->Run(*run_options, prepared, input_span, output_span);
+  } else {
+    const RunOptions default_run_options;
+    status = session->Run(default_run_options, prepared, input_span, output_span);
+  }
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
 struct OrtIoBinding {
   std::unique_ptr<::onnxruntime::IOBinding> binding_;
   explicit OrtIoBinding(std::unique_ptr<::onnxruntime::IOBinding>&& binding) : binding_(std::move(binding)) {}
@@ -1436,6 +1570,36 @@ ORT_API_STATUS_IMPL(OrtApis::SessionEndProfiling, _In_ OrtSession* sess, _Inout_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetProfilingStatistics, _Inout_ OrtSession* sess, _In_ bool reset,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto statistics = session->GetProfilingStatistics(reset);
+  *out = StrDup(statistics, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetMemoryTimeline, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string timeline;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetMemoryTimeline(timeline));
+  *out = StrDup(timeline, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetMetrics, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  *out = StrDup(session->GetMetrics(), allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SessionGetModelMetadata, _In_ const OrtSession* sess,
                     _Outptr_ OrtModelMetadata** out) {
   API_IMPL_BEGIN
@@ -2302,6 +2466,14 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "max_power_of_two_extend_bytes") == 0) {
       cfg->max_power_of_two_extend_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_cache_max_bytes") == 0) {
+      cfg->thread_cache_max_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "idle_shrink_interval_ms") == 0) {
+      cfg->idle_shrink_interval_ms = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "use_huge_pages") == 0) {
+      cfg->use_huge_pages = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "cross_stream_reuse") == 0) {
+      cfg->cross_stream_reuse = static_cast<int>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2812,6 +2984,14 @@ static constexpr OrtApi ort_api_1_to_21 = {
 
     &OrtApis::SetEpDynamicOptions,
     // End of Version 20 - DO NOT MODIFY ABOVE (see above text for more information)
+
+    &OrtApis::SessionGetProfilingStatistics,
+    &OrtApis::SessionGetMemoryTimeline,
+    &OrtApis::SessionGetMetrics,
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::ReleasePreparedRun,
+    &OrtApis::RunPrepared,
+    &OrtApis::SelectFastestSessionOptions,
 };
 
 // OrtApiBase can never change as there is no way to know what version of OrtApiBase is returned by OrtGetApiBase.
@@ -2885,4 +3065,5 @@ ORT_API(void, OrtApis::ReleaseEnv, OrtEnv* value) {
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, OrtValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(PreparedRun, ::onnxruntime::InferenceSession::PreparedRun)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(ModelMetadata, ::onnxruntime::ModelMetadata)
@@ -0,0 +1,178 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/session/optimized_model_cache.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "core/common/platform_identity.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/session_options.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/model.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+namespace optimized_model_cache {
+
+namespace {
+class KeyHasher {
+ public:
+  void AddBytes(const void* data, size_t length) { MurmurHash3::x86_128_append(data, length, hash_); }
+
+  void AddString(const std::string& str) { AddBytes(str.data(), str.size()); }
+
+  template <typename T>
+  void AddPod(const T& value) {
+    MurmurHash3::x86_128(&value, static_cast<int>(sizeof(T)), hash_[0], &hash_);
+  }
+
+  std::string ToString() const {
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (const auto h : hash_) {
+      ss << std::setw(8) << h;
+    }
+    return ss.str();
+  }
+
+ private:
+  uint32_t hash_[4] = {0, 0, 0, 0};
+};
+
+template <typename Map>
+std::vector<std::pair<std::string, typename Map::mapped_type>> SortedEntries(const Map& map) {
+  std::vector<std::pair<std::string, typename Map::mapped_type>> entries(map.begin(), map.end());
+  std::sort(entries.begin(), entries.end());
+  return entries;
+}
+
+Status AddInitializer(KeyHasher& hasher, const ONNX_NAMESPACE::TensorProto& initializer,
+                      const std::filesystem::path& model_dir) {
+  hasher.AddString(initializer.name());
+  hasher.AddPod(initializer.data_type());
+  for (const auto dim : initializer.dims()) {
+    hasher.AddPod(dim);
+  }
+
+  if (utils::HasExternalData(initializer)) {
+    std::basic_string<ORTCHAR_T> external_file_path;
+    FileOffsetType file_offset = 0;
+    SafeInt<size_t> tensor_byte_size = 0;
+    ORT_RETURN_IF_ERROR(utils::GetExternalDataInfo(initializer, model_dir, external_file_path, file_offset,
+                                                   tensor_byte_size));
+
+    if (external_file_path == utils::kTensorProtoMemoryAddressTag) {
+      // the data is in memory, and the offset is its address
+      hasher.AddBytes(reinterpret_cast<const void*>(static_cast<uintptr_t>(file_offset)), tensor_byte_size);
+    } else {
+      // reading every weight file would make the lookup as slow as loading the model, so the file is identified by
+      // its size and modification time instead.
+      std::error_code ec;
+      const auto file_size = std::filesystem::file_size(external_file_path, ec);
+      ORT_RETURN_IF(ec, "Failed to get the size of external data file ", ToUTF8String(external_file_path), ": ",
+                    ec.message());
+      const auto write_time = std::filesystem::last_write_time(external_file_path, ec);
+      ORT_RETURN_IF(ec, "Failed to get the modification time of external data file ",
+                    ToUTF8String(external_file_path), ": ", ec.message());
+
+      hasher.AddString(ToUTF8String(external_file_path));
+      hasher.AddPod(static_cast<int64_t>(file_offset));
+      hasher.AddPod(static_cast<uint64_t>(tensor_byte_size));
+      hasher.AddPod(static_cast<uint64_t>(file_size));
+      hasher.AddPod(static_cast<int64_t>(write_time.time_since_epoch().count()));
+    }
+  } else if (utils::HasRawData(initializer)) {
+    hasher.AddString(initializer.raw_data());
+  } else {
+    hasher.AddString(initializer.SerializeAsString());
+  }
+
+  return Status::OK();
+}
+}  // namespace
+
+Status GetCacheFileName(const Model& model, const ExecutionProviders& execution_providers,
+                        const SessionOptions& session_options,
+                        const InlinedHashSet<std::string>& optimizers_to_disable,
+                        std::filesystem::path& file_name) {
+  KeyHasher hasher;
+  const Graph& graph = model.MainGraph();
+
+  hasher.AddString(GetPlatformIdentity());
+  hasher.AddPod(model.IrVersion());
+  for (const auto& [domain, version] : SortedEntries(graph.DomainToVersionMap())) {
+    hasher.AddString(domain);
+    hasher.AddPod(version);
+  }
+
+  for (const auto* input : graph.GetInputsIncludingInitializers()) {
+    hasher.AddString(input->ToProto().SerializeAsString());
+  }
+  for (const auto* output : graph.GetOutputs()) {
+    hasher.AddString(output->ToProto().SerializeAsString());
+  }
+
+  ONNX_NAMESPACE::NodeProto node_proto;
+  for (const auto& node : graph.Nodes()) {
+    node.ToProto(node_proto, /*update_subgraphs*/ true);
+    hasher.AddString(node_proto.SerializeAsString());
+  }
+
+  // the initializers are unordered
+  std::vector<const ONNX_NAMESPACE::TensorProto*> initializers;
+  for (const auto& [name, initializer] : graph.GetAllInitializedTensors()) {
+    initializers.push_back(initializer);
+  }
+  std::sort(initializers.begin(), initializers.end(),
+            [](const auto* a, const auto* b) { return a->name() < b->name(); });
+  const auto model_dir = graph.ModelPath().parent_path();
+  for (const auto* initializer : initializers) {
+    ORT_RETURN_IF_ERROR(AddInitializer(hasher, *initializer, model_dir));
+  }
+
+  for (const auto& ep : execution_providers) {
+    hasher.AddString(ep->Type());
+    for (const auto& [key, value] : SortedEntries(ep->GetProviderOptions())) {
+      hasher.AddString(key);
+      hasher.AddString(value);
+    }
+  }
+
+  hasher.AddPod(static_cast<int>(session_options.graph_optimization_level));
+  std::vector<std::string> disabled(optimizers_to_disable.begin(), optimizers_to_disable.end());
+  std::sort(disabled.begin(), disabled.end());
+  for (const auto& optimizer : disabled) {
+    hasher.AddString(optimizer);
+  }
+
+  for (const auto& dim_override : session_options.free_dimension_overrides) {
+    hasher.AddString(dim_override.dim_identifier);
+    hasher.AddPod(static_cast<int>(dim_override.dim_identifier_type));
+    hasher.AddPod(dim_override.dim_value);
+  }
+
+  for (const auto& [key, value] : SortedEntries(session_options.config_options.configurations)) {
+    // the location of the cache doesn't change the optimized model
+    if (key != kOrtSessionOptionsOptimizedModelCacheDir) {
+      hasher.AddString(key);
+      hasher.AddString(value);
+    }
+  }
+
+  file_name = hasher.ToString() + ".ort";
+  return Status::OK();
+}
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
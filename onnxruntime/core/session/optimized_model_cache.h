@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <filesystem>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+
+namespace onnxruntime {
+class ExecutionProviders;
+class Model;
+struct SessionOptions;
+
+namespace optimized_model_cache {
+
+// Computes the name of the file in the optimized model cache directory that holds the model after it was optimized
+// for this session. The name is a hash of everything that determines the optimized graph:
+//   - the nodes, initializers, inputs, outputs and opsets of the model. External initializers are identified by
+//     their file, offset, length and the size and modification time of the file instead of being read.
+//   - the type and provider options of the execution providers, in priority order.
+//   - the graph optimization level, the disabled optimizers, the free dimension overrides and the session config
+//     entries.
+//   - the version of ONNX Runtime and the instruction set extensions of the CPU, as level 3 optimizations are
+//     hardware specific.
+Status GetCacheFileName(const Model& model, const ExecutionProviders& execution_providers,
+                        const SessionOptions& session_options,
+                        const InlinedHashSet<std::string>& optimizers_to_disable,
+                        std::filesystem::path& file_name);
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
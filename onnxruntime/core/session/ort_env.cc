@@ -11,7 +11,9 @@
 #include "core/session/allocator_adapters.h"
 #include "core/session/user_logging_sink.h"
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_sink.h"
 #include "core/framework/provider_shutdown.h"
+#include "core/platform/env_var_utils.h"
 #include "core/platform/logging/make_platform_default_log_sink.h"
 
 using namespace onnxruntime;
@@ -25,6 +27,11 @@ void CleanupWebGpuContexts();
 }  // namespace onnxruntime
 #endif
 
+namespace {
+// set to 1 to send the messages of the default log sink from a background thread
+constexpr const char* kAsyncLoggingEnvVar = "ORT_ASYNC_LOGGING";
+}  // namespace
+
 std::unique_ptr<OrtEnv> OrtEnv::p_instance_;
 int OrtEnv::ref_count_ = 0;
 std::mutex OrtEnv::m_;
@@ -58,6 +65,10 @@ OrtEnv* OrtEnv::GetInstance(const OrtEnv::LoggingManagerConstructionInfo& lm_inf
 
     } else {
       sink = MakePlatformDefaultLogSink();
+      // write the log from a background thread, e.g. to keep verbose logging from slowing down the inference
+      if (ParseEnvironmentVariableWithDefault<bool>(kAsyncLoggingEnvVar, false)) {
+        sink = std::make_unique<AsyncSink>(std::move(sink));
+      }
     }
     auto etwOverrideSeverity = logging::OverrideLevelWithEtw(static_cast<Severity>(lm_info.default_warning_level));
     sink = EnhanceSinkWithEtw(std::move(sink), static_cast<Severity>(lm_info.default_warning_level),
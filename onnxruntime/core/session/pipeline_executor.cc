@@ -0,0 +1,388 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/pipeline_executor.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "core/common/narrow.h"
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+
+#if !defined(ORT_MINIMAL_BUILD)
+#include "core/graph/function_template.h"
+#include "core/graph/graph_viewer.h"
+#include "core/graph/model.h"
+#endif
+
+namespace onnxruntime {
+
+// static
+Status PipelineExecutor::CreateStage(InferenceSession& session, Stage& stage) {
+  const auto [inputs_status, model_inputs] = session.GetModelInputs();
+  ORT_RETURN_IF_ERROR(inputs_status);
+  const auto [outputs_status, model_outputs] = session.GetModelOutputs();
+  ORT_RETURN_IF_ERROR(outputs_status);
+
+  stage.input_names.clear();
+  for (const auto* input : *model_inputs) {
+    stage.input_names.push_back(input->Name());
+  }
+  stage.output_names.clear();
+  for (const auto* output : *model_outputs) {
+    stage.output_names.push_back(output->Name());
+  }
+
+  stage.run = [&session](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                         gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                         std::vector<OrtValue>* p_fetches) {
+    return session.Run(run_options, feed_names, feeds, output_names, p_fetches);
+  };
+  return Status::OK();
+}
+
+PipelineExecutor::PipelineExecutor(const Options& options, std::vector<Stage> stages, AllocatorPtr cpu_allocator)
+    : options_(options), stages_(std::move(stages)), cpu_allocator_(std::move(cpu_allocator)) {
+  ORT_ENFORCE(options_.num_micro_batches > 0, "The number of micro-batches must be positive.");
+  ORT_ENFORCE(!stages_.empty() && cpu_allocator_ != nullptr);
+  for (const auto& stage : stages_) {
+    ORT_ENFORCE(stage.run != nullptr, "Each pipeline stage requires a run function.");
+  }
+}
+
+Status PipelineExecutor::RunStage(const RunOptions& run_options, const Stage& stage, Values& values) const {
+  std::vector<OrtValue> feeds;
+  feeds.reserve(stage.input_names.size());
+  for (const auto& name : stage.input_names) {
+    auto it = values.find(name);
+    ORT_RETURN_IF(it == values.end(), "Pipeline stage input '", name,
+                  "' is neither fed nor produced by a previous stage.");
+    feeds.push_back(it->second);
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(stage.run(run_options, stage.input_names, feeds, stage.output_names, &fetches));
+  ORT_RETURN_IF_NOT(fetches.size() == stage.output_names.size(), "Pipeline stage returned ", fetches.size(),
+                    " outputs instead of ", stage.output_names.size(), ".");
+
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    values.insert_or_assign(stage.output_names[i], std::move(fetches[i]));
+  }
+  return Status::OK();
+}
+
+Status PipelineExecutor::Concatenate(gsl::span<const OrtValue> slices, const std::string& name,
+                                     OrtValue& output) const {
+  if (slices.size() == 1) {
+    output = slices[0];
+    return Status::OK();
+  }
+
+  int64_t total = 0;
+  const Tensor* first = nullptr;
+  for (const auto& slice : slices) {
+    ORT_RETURN_IF_NOT(slice.IsTensor(), "Pipeline output '", name, "' is not a tensor.");
+    const auto& tensor = slice.Get<Tensor>();
+    ORT_RETURN_IF_NOT(tensor.Location().device.Type() == OrtDevice::CPU && tensor.Shape().NumDimensions() > 0,
+                      "Pipeline output '", name, "' must be a CPU tensor with the batch dimension.");
+    if (first == nullptr) {
+      first = &tensor;
+    } else {
+      const auto dims = tensor.Shape().GetDims();
+      const auto first_dims = first->Shape().GetDims();
+      ORT_RETURN_IF_NOT(tensor.DataType() == first->DataType() &&
+                            std::equal(dims.begin() + 1, dims.end(), first_dims.begin() + 1, first_dims.end()),
+                        "The micro-batches of pipeline output '", name, "' have different types or shapes.");
+    }
+    total += tensor.Shape()[0];
+  }
+
+  TensorShapeVector dims = first->Shape().AsShapeVector();
+  dims[0] = total;
+  Tensor::InitOrtValue(first->DataType(), TensorShape(dims), cpu_allocator_, output);
+  Tensor& result = *output.GetMutable<Tensor>();
+
+  if (result.IsDataTypeString()) {
+    auto dst = result.MutableDataAsSpan<std::string>().begin();
+    for (const auto& slice : slices) {
+      const auto src = slice.Get<Tensor>().DataAsSpan<std::string>();
+      dst = std::copy(src.begin(), src.end(), dst);
+    }
+  } else {
+    auto* dst = static_cast<uint8_t*>(result.MutableDataRaw());
+    for (const auto& slice : slices) {
+      const auto& src = slice.Get<Tensor>();
+      std::memcpy(dst, src.DataRaw(), src.SizeInBytes());
+      dst += src.SizeInBytes();
+    }
+  }
+
+  return Status::OK();
+}
+
+Status PipelineExecutor::Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                             gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                             std::vector<OrtValue>* p_fetches) const {
+  ORT_RETURN_IF_NOT(p_fetches != nullptr, "Output vector pointer is NULL");
+  ORT_RETURN_IF_NOT(p_fetches->empty() || p_fetches->size() == output_names.size(),
+                    "Output vector incorrectly sized: output_names.size(): ", output_names.size(),
+                    "p_fetches->size(): ", p_fetches->size());
+  ORT_RETURN_IF_NOT(feed_names.size() == feeds.size(), "The number of feed names and feeds must match.");
+
+  int64_t batch_size = -1;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    ORT_RETURN_IF_NOT(feeds[i].IsTensor(), "Pipeline input '", feed_names[i], "' is not a tensor.");
+    const auto& tensor = feeds[i].Get<Tensor>();
+    ORT_RETURN_IF_NOT(tensor.Location().device.Type() == OrtDevice::CPU && tensor.Shape().NumDimensions() > 0 &&
+                          (batch_size == -1 || tensor.Shape()[0] == batch_size),
+                      "Pipeline input '", feed_names[i], "' must be a CPU tensor with the batch dimension.");
+    batch_size = tensor.Shape()[0];
+  }
+
+  const int64_t num_micro_batches = batch_size > 0 ? std::min(options_.num_micro_batches, batch_size) : 1;
+
+  // split the inputs into views of consecutive rows. the views hold a reference to the input.
+  std::vector<Values> values(narrow<size_t>(num_micro_batches));
+  int64_t offset = 0;
+  for (int64_t m = 0; m < num_micro_batches; ++m) {
+    const int64_t size = batch_size <= 0
+                             ? 0
+                             : batch_size / num_micro_batches + (m < batch_size % num_micro_batches ? 1 : 0);
+    for (size_t i = 0; i < feeds.size(); ++i) {
+      const auto& input = feeds[i].Get<Tensor>();
+      if (num_micro_batches == 1) {
+        values[narrow<size_t>(m)].insert_or_assign(feed_names[i], feeds[i]);
+        continue;
+      }
+
+      const size_t row_bytes = input.SizeInBytes() / narrow<size_t>(batch_size);
+      auto* src = static_cast<uint8_t*>(const_cast<void*>(input.DataRaw())) + narrow<size_t>(offset) * row_bytes;
+      TensorShapeVector dims = input.Shape().AsShapeVector();
+      dims[0] = size;
+      auto slice = std::make_unique<Tensor>(input.DataType(), TensorShape(dims), src, input.Location());
+      OrtValue view;
+      OrtValue whole_input = feeds[i];
+      view.Init(slice.release(), DataTypeImpl::GetType<Tensor>(),
+                [whole_input](void* p) { delete static_cast<Tensor*>(p); });
+      values[narrow<size_t>(m)].insert_or_assign(feed_names[i], std::move(view));
+    }
+    offset += size;
+  }
+
+  // stage s runs micro-batch m once stage s - 1 has completed it
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<int64_t> completed(stages_.size(), 0);
+  Status status;
+
+  auto run_stage = [&](size_t s) {
+    for (int64_t m = 0; m < num_micro_batches; ++m) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return !status.IsOK() || s == 0 || completed[s - 1] > m; });
+        if (!status.IsOK()) {
+          return;
+        }
+      }
+
+      Status stage_status;
+      ORT_TRY {
+        stage_status = RunStage(run_options, stages_[s], values[narrow<size_t>(m)]);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          stage_status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        });
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!stage_status.IsOK()) {
+          if (status.IsOK()) {
+            status = stage_status;
+          }
+        } else {
+          ++completed[s];
+        }
+      }
+      cv.notify_all();
+
+      if (!stage_status.IsOK()) {
+        return;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(stages_.size() - 1);
+  for (size_t s = 1; s < stages_.size(); ++s) {
+    threads.emplace_back(run_stage, s);
+  }
+  run_stage(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ORT_RETURN_IF_ERROR(status);
+
+  if (p_fetches->empty()) {
+    p_fetches->resize(output_names.size());
+  }
+
+  std::vector<OrtValue> slices(values.size());
+  for (size_t j = 0; j < output_names.size(); ++j) {
+    for (size_t m = 0; m < values.size(); ++m) {
+      auto it = values[m].find(output_names[j]);
+      ORT_RETURN_IF(it == values[m].end(), "Pipeline output '", output_names[j], "' is not produced by any stage.");
+      slices[m] = it->second;
+    }
+
+    OrtValue output;
+    ORT_RETURN_IF_ERROR(Concatenate(slices, output_names[j], output));
+
+    OrtValue& fetch = (*p_fetches)[j];
+    if (fetch.IsAllocated()) {
+      // the caller provided the buffer so we have to copy
+      auto& dst = *fetch.GetMutable<Tensor>();
+      const auto& src = output.Get<Tensor>();
+      ORT_RETURN_IF_NOT(dst.DataType() == src.DataType() && dst.Shape() == src.Shape() &&
+                            !src.IsDataTypeString() && dst.Location().device.Type() == OrtDevice::CPU,
+                        "Pre-allocated output '", output_names[j], "' must be a non-string CPU tensor of shape ",
+                        src.Shape(), ".");
+      std::memcpy(dst.MutableDataRaw(), src.DataRaw(), dst.SizeInBytes());
+    } else {
+      fetch = std::move(output);
+    }
+  }
+
+  return Status::OK();
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+Status SplitModelIntoStages(const Model& model, gsl::span<const std::vector<std::string>> cut_points,
+                            std::vector<ONNX_NAMESPACE::ModelProto>& stage_models) {
+  const Graph& graph = model.MainGraph();
+  const size_t num_stages = cut_points.size() + 1;
+
+  // the first stage each value of a cut point can be consumed in
+  InlinedHashMap<std::string, size_t> cut_stages;
+  for (size_t i = 0; i < cut_points.size(); ++i) {
+    for (const auto& name : cut_points[i]) {
+      ORT_RETURN_IF(graph.GetProducerNode(name) == nullptr, "Cut point value '", name,
+                    "' is not produced by a node.");
+      ORT_RETURN_IF_NOT(cut_stages.emplace(name, i + 1).second, "Cut point value '", name, "' is listed twice.");
+    }
+  }
+
+  auto for_each_input = [](const Node& node, const std::function<void(const NodeArg&)>& fn) {
+    for (const auto* arg : node.InputDefs()) {
+      if (arg->Exists()) fn(*arg);
+    }
+    for (const auto* arg : node.ImplicitInputDefs()) {
+      fn(*arg);
+    }
+  };
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_order = graph_viewer.GetNodesInTopologicalOrder();
+  std::vector<size_t> node_stages(graph.MaxNodeIndex(), 0);
+  InlinedHashMap<std::string, size_t> producer_stages;
+  InlinedHashMap<std::string, size_t> last_consumer_stages;
+
+  for (const auto node_index : node_order) {
+    const Node& node = *graph.GetNode(node_index);
+    size_t stage = 0;
+    for_each_input(node, [&](const NodeArg& arg) {
+      if (auto it = producer_stages.find(arg.Name()); it != producer_stages.end()) {
+        stage = std::max(stage, it->second);
+      }
+      if (auto it = cut_stages.find(arg.Name()); it != cut_stages.end()) {
+        stage = std::max(stage, it->second);
+      }
+    });
+    node_stages[node_index] = stage;
+
+    for_each_input(node, [&](const NodeArg& arg) {
+      auto& last_stage = last_consumer_stages[arg.Name()];
+      last_stage = std::max(last_stage, stage);
+    });
+
+    for (const auto* output : node.OutputDefs()) {
+      if (!output->Exists()) continue;
+      producer_stages[output->Name()] = stage;
+      if (auto it = cut_stages.find(output->Name()); it != cut_stages.end()) {
+        ORT_RETURN_IF(stage >= it->second, "Cut point value '", output->Name(), "' is produced in stage ", stage,
+                      ", which is after the cut point.");
+      }
+    }
+  }
+
+  InlinedHashSet<std::string> graph_outputs;
+  for (const auto* output : graph.GetOutputs()) {
+    ORT_RETURN_IF(producer_stages.find(output->Name()) == producer_stages.end(), "Model output '",
+                  output->Name(), "' is not produced by a node and can't be assigned to a stage.");
+    graph_outputs.insert(output->Name());
+  }
+
+  stage_models.clear();
+  stage_models.resize(num_stages);
+  for (size_t s = 0; s < num_stages; ++s) {
+    auto& stage_model = stage_models[s];
+    stage_model.set_ir_version(model.IrVersion());
+    stage_model.set_producer_name(model.ProducerName());
+    for (const auto& [domain, version] : graph.DomainToVersionMap()) {
+      auto* opset_import = stage_model.add_opset_import();
+      opset_import->set_domain(domain);
+      opset_import->set_version(version);
+    }
+    for (const auto& [name, function_template] : model.GetModelLocalFunctionTemplates()) {
+      *stage_model.add_functions() = *function_template->onnx_func_proto_;
+    }
+
+    auto& stage_graph = *stage_model.mutable_graph();
+    stage_graph.set_name(MakeString(graph.Name(), "_stage", s));
+
+    InlinedHashSet<std::string> added_inputs;
+    for (const auto node_index : node_order) {
+      if (node_stages[node_index] != s) continue;
+
+      const Node& node = *graph.GetNode(node_index);
+      node.ToProto(*stage_graph.add_node(), /*update_subgraphs*/ true);
+
+      for_each_input(node, [&](const NodeArg& arg) {
+        auto producer = producer_stages.find(arg.Name());
+        if ((producer != producer_stages.end() && producer->second == s) || !added_inputs.insert(arg.Name()).second) {
+          return;
+        }
+
+        const ONNX_NAMESPACE::TensorProto* initializer = nullptr;
+        if (producer == producer_stages.end() && graph.GetInitializedTensor(arg.Name(), initializer)) {
+          *stage_graph.add_initializer() = *initializer;
+        } else {
+          *stage_graph.add_input() = arg.ToProto();
+        }
+      });
+    }
+
+    for (const auto node_index : node_order) {
+      if (node_stages[node_index] != s) continue;
+
+      for (const auto* output : graph.GetNode(node_index)->OutputDefs()) {
+        if (!output->Exists()) continue;
+        auto consumer = last_consumer_stages.find(output->Name());
+        if (graph_outputs.count(output->Name()) > 0 ||
+            (consumer != last_consumer_stages.end() && consumer->second > s)) {
+          *stage_graph.add_output() = output->ToProto();
+        }
+      }
+    }
+  }
+
+  return Status::OK();
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+}  // namespace onnxruntime
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+class InferenceSession;
+class Model;
+
+/**
+Runs a model split into consecutive stages, usually sessions of the stage models on different devices or execution
+providers, as a pipeline.
+
+The inputs are split along dimension 0 into micro-batches. Each stage has its own thread and runs the micro-batches
+in order, starting a micro-batch as soon as the previous stages have produced it. So while stage 1 works on
+micro-batch 0, stage 0 already works on micro-batch 1 and the devices are busy at the same time. The values are
+handed from one stage to the next as the fetches and feeds of the stage runs, which copy them between the devices.
+
+A stage reads its inputs from the model inputs and the outputs of the previous stages, by name. The requested outputs
+are concatenated along dimension 0 from the micro-batches. The inputs and outputs must be CPU tensors sharing
+dimension 0, and the stages must be able to run the micro-batches independently, like a model with a batch
+dimension. This class is thread-safe if the stages are.
+*/
+class PipelineExecutor {
+ public:
+  using RunFn = std::function<Status(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                     gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                     std::vector<OrtValue>* p_fetches)>;
+
+  struct Stage {
+    RunFn run;
+    std::vector<std::string> input_names;
+    std::vector<std::string> output_names;
+  };
+
+  struct Options {
+    // the inputs are split in this many micro-batches, or fewer if dimension 0 is smaller
+    int64_t num_micro_batches = 1;
+  };
+
+  // Creates a stage which runs an initialized session, with all its inputs and outputs.
+  static Status CreateStage(InferenceSession& session, Stage& stage);
+
+  // `cpu_allocator` is used for the concatenated outputs.
+  PipelineExecutor(const Options& options, std::vector<Stage> stages, AllocatorPtr cpu_allocator);
+
+  // Same semantics as InferenceSession::Run. The run options are passed to every stage run.
+  Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+             gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+             std::vector<OrtValue>* p_fetches) const;
+
+  const Options& GetOptions() const { return options_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PipelineExecutor);
+
+  using Values = InlinedHashMap<std::string, OrtValue>;
+
+  Status RunStage(const RunOptions& run_options, const Stage& stage, Values& values) const;
+  Status Concatenate(gsl::span<const OrtValue> slices, const std::string& name, OrtValue& output) const;
+
+  const Options options_;
+  const std::vector<Stage> stages_;
+  const AllocatorPtr cpu_allocator_;
+};
+
+#if !defined(ORT_MINIMAL_BUILD)
+/**
+Splits a model into the models of the stages of a pipeline.
+
+`cut_points[i]` lists the values passed from stage i and the stages before it to stage i + 1, so there are
+cut_points.size() + 1 stages. A node runs in the first stage in which all its inputs are available: the model inputs
+and initializers in any stage, the output of a node in the stage of the node, and a value of cut_points[i] from stage
+i + 1 on. The nodes producing the values of cut_points[i] must run in stage i or before.
+
+The inputs of a stage model are the model inputs and the values of the previous stages its nodes consume. Its outputs
+are the model outputs and the values consumed by the following stages which its nodes produce. Initializers are copied
+to every stage using them. External data stays where it is, so the stage models must be loaded from the directory of
+the model.
+*/
+Status SplitModelIntoStages(const Model& model, gsl::span<const std::vector<std::string>> cut_points,
+                            std::vector<ONNX_NAMESPACE::ModelProto>& stage_models);
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+}  // namespace onnxruntime
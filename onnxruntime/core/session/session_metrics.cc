@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/session_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+
+namespace onnxruntime {
+
+namespace {
+
+void WriteHeader(std::ostream& os, const std::string& name, const char* type, const char* help) {
+  os << "# HELP " << name << " " << help << "\n";
+  os << "# TYPE " << name << " " << type << "\n";
+}
+
+template <typename T>
+void WriteSample(std::ostream& os, const std::string& name, const std::string& labels, T value) {
+  os << name << "{" << labels << "} " << value << "\n";
+}
+
+}  // namespace
+
+void SessionMetrics::Histogram::Record(long long duration_us) {
+  const auto bucket = static_cast<size_t>(
+      std::lower_bound(kBucketBoundsUs.begin(), kBucketBoundsUs.end(), duration_us) - kBucketBoundsUs.begin());
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_us_.fetch_add(static_cast<uint64_t>(std::max(duration_us, 0LL)), std::memory_order_relaxed);
+}
+
+void SessionMetrics::Histogram::Write(std::ostream& os, const std::string& name, const std::string& labels) const {
+  // the buckets of the Prometheus format are cumulative
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    cumulative += buckets_[i].load(std::memory_order_relaxed);
+    os << name << "_bucket{" << labels << ",le=\"";
+    if (i < kBucketBoundsUs.size()) {
+      os << static_cast<double>(kBucketBoundsUs[i]) / 1e6;
+    } else {
+      os << "+Inf";
+    }
+    os << "\"} " << cumulative << "\n";
+  }
+
+  WriteSample(os, name + "_sum", labels, static_cast<double>(sum_us_.load(std::memory_order_relaxed)) / 1e6);
+  WriteSample(os, name + "_count", labels, count_.load(std::memory_order_relaxed));
+}
+
+void SessionMetrics::SetNodeAssignment(std::vector<std::pair<std::string, size_t>> nodes_per_provider,
+                                       size_t num_fallback_nodes) {
+  nodes_per_provider_ = std::move(nodes_per_provider);
+  num_fallback_nodes_ = num_fallback_nodes;
+}
+
+std::string SessionMetrics::ToPrometheusText(const std::string& session_id, const Snapshot& snapshot) const {
+  std::ostringstream os;
+  const std::string session_label = MakeString("session_id=\"", session_id, "\"");
+
+  WriteHeader(os, "onnxruntime_session_run_duration_seconds", "histogram", "Duration of the session runs.");
+  run_duration_.Write(os, "onnxruntime_session_run_duration_seconds", session_label);
+
+  // quantiles of the last runs. the durations of the runs in progress may be those of older runs.
+  const size_t num_recent_runs = static_cast<size_t>(
+      std::min<uint64_t>(num_runs_.load(std::memory_order_relaxed), kNumRecentRuns));
+  std::vector<long long> recent_run_durations_us(num_recent_runs);
+  for (size_t i = 0; i < num_recent_runs; ++i) {
+    recent_run_durations_us[i] = recent_run_durations_us_[i].load(std::memory_order_relaxed);
+  }
+
+  std::sort(recent_run_durations_us.begin(), recent_run_durations_us.end());
+  WriteHeader(os, "onnxruntime_session_run_duration_recent_seconds", "summary",
+              "Quantiles of the duration of the last runs. The spread of the quantiles is the jitter of the runs.");
+  if (num_recent_runs > 0) {
+    for (const double quantile : {0.5, 0.9, 0.99, 0.999, 1.0}) {
+      // nearest rank
+      const auto rank = static_cast<size_t>(std::ceil(quantile * static_cast<double>(num_recent_runs)));
+      WriteSample(os, "onnxruntime_session_run_duration_recent_seconds",
+                  MakeString(session_label, ",quantile=\"", quantile, "\""),
+                  static_cast<double>(recent_run_durations_us[std::max<size_t>(rank, 1) - 1]) / 1e6);
+    }
+  }
+
+  const long long recent_runs_sum_us = std::accumulate(recent_run_durations_us.begin(),
+                                                       recent_run_durations_us.end(), 0LL);
+  WriteSample(os, "onnxruntime_session_run_duration_recent_seconds_sum", session_label,
+              static_cast<double>(recent_runs_sum_us) / 1e6);
+  WriteSample(os, "onnxruntime_session_run_duration_recent_seconds_count", session_label, num_recent_runs);
+
+  WriteHeader(os, "onnxruntime_session_run_failures_total", "counter", "Number of runs that returned an error.");
+  WriteSample(os, "onnxruntime_session_run_failures_total", session_label,
+              num_failed_runs_.load(std::memory_order_relaxed));
+
+  WriteHeader(os, "onnxruntime_session_queue_wait_seconds", "histogram",
+              "Time the runs waited before they started executing.");
+  queue_wait_.Write(os, "onnxruntime_session_queue_wait_seconds", session_label);
+
+  if (!snapshot.allocator_stats.empty()) {
+    WriteHeader(os, "onnxruntime_session_allocator_in_use_bytes", "gauge", "Bytes in use in the allocator.");
+    for (const auto& allocator : snapshot.allocator_stats) {
+      WriteSample(os, "onnxruntime_session_allocator_in_use_bytes",
+                  MakeString(session_label, ",device=\"", allocator.first, "\""), allocator.second.bytes_in_use);
+    }
+
+    WriteHeader(os, "onnxruntime_session_allocator_reserved_bytes", "gauge",
+                "Bytes reserved by the allocator. The arena utilization is in_use / reserved.");
+    for (const auto& allocator : snapshot.allocator_stats) {
+      WriteSample(os, "onnxruntime_session_allocator_reserved_bytes",
+                  MakeString(session_label, ",device=\"", allocator.first, "\""), allocator.second.total_allocated_bytes);
+    }
+
+    WriteHeader(os, "onnxruntime_session_allocator_max_in_use_bytes", "gauge", "Peak of the bytes in use.");
+    for (const auto& allocator : snapshot.allocator_stats) {
+      WriteSample(os, "onnxruntime_session_allocator_max_in_use_bytes",
+                  MakeString(session_label, ",device=\"", allocator.first, "\""), allocator.second.max_bytes_in_use);
+    }
+
+    WriteHeader(os, "onnxruntime_session_allocator_allocations_total", "counter", "Number of allocations.");
+    for (const auto& allocator : snapshot.allocator_stats) {
+      WriteSample(os, "onnxruntime_session_allocator_allocations_total",
+                  MakeString(session_label, ",device=\"", allocator.first, "\""), allocator.second.num_allocs);
+    }
+  }
+
+  const std::string intra_op_label = MakeString(session_label, ",pool=\"intra_op\"");
+  const std::string inter_op_label = MakeString(session_label, ",pool=\"inter_op\"");
+
+  WriteHeader(os, "onnxruntime_session_thread_pool_busy_seconds_total", "counter",
+              "Time the threads of the pool spent running work. The busy ratio is its rate divided by the threads.");
+  WriteSample(os, "onnxruntime_session_thread_pool_busy_seconds_total", intra_op_label,
+              static_cast<double>(snapshot.intra_op_busy_ns) / 1e9);
+  WriteSample(os, "onnxruntime_session_thread_pool_busy_seconds_total", inter_op_label,
+              static_cast<double>(snapshot.inter_op_busy_ns) / 1e9);
+
+  WriteHeader(os, "onnxruntime_session_thread_pool_threads", "gauge", "Number of threads of the pool.");
+  WriteSample(os, "onnxruntime_session_thread_pool_threads", intra_op_label, snapshot.intra_op_threads);
+  WriteSample(os, "onnxruntime_session_thread_pool_threads", inter_op_label, snapshot.inter_op_threads);
+
+  WriteHeader(os, "onnxruntime_session_thread_pool_created_threads", "gauge",
+              "Number of threads of the pool created so far. Lazily created threads are created by the first parallel "
+              "loop.");
+  WriteSample(os, "onnxruntime_session_thread_pool_created_threads", intra_op_label,
+              snapshot.intra_op_parallelism.created_threads);
+  WriteSample(os, "onnxruntime_session_thread_pool_created_threads", inter_op_label,
+              snapshot.inter_op_parallelism.created_threads);
+
+  WriteHeader(os, "onnxruntime_session_thread_pool_parallel_loops_total", "counter",
+              "Number of loops divided between more than one thread of the pool.");
+  WriteSample(os, "onnxruntime_session_thread_pool_parallel_loops_total", intra_op_label,
+              snapshot.intra_op_parallelism.num_loops);
+  WriteSample(os, "onnxruntime_session_thread_pool_parallel_loops_total", inter_op_label,
+              snapshot.inter_op_parallelism.num_loops);
+
+  WriteHeader(os, "onnxruntime_session_thread_pool_loop_threads_total", "counter",
+              "Sum over the parallel loops of the threads, including the caller, each loop was divided between. "
+              "Divided by the parallel loops it is the effective parallelism of the pool.");
+  WriteSample(os, "onnxruntime_session_thread_pool_loop_threads_total", intra_op_label,
+              snapshot.intra_op_parallelism.sum_loop_threads);
+  WriteSample(os, "onnxruntime_session_thread_pool_loop_threads_total", inter_op_label,
+              snapshot.inter_op_parallelism.sum_loop_threads);
+
+  WriteHeader(os, "onnxruntime_session_thread_pool_loop_threads_max", "gauge",
+              "Largest number of threads, including the caller, a parallel loop was divided between.");
+  WriteSample(os, "onnxruntime_session_thread_pool_loop_threads_max", intra_op_label,
+              snapshot.intra_op_parallelism.max_loop_threads);
+  WriteSample(os, "onnxruntime_session_thread_pool_loop_threads_max", inter_op_label,
+              snapshot.inter_op_parallelism.max_loop_threads);
+
+  if (snapshot.scheduler_stats) {
+    const auto& scheduler_stats = *snapshot.scheduler_stats;
+    WriteHeader(os, "onnxruntime_session_global_thread_pool_share_threads", "gauge",
+                "Threads of the global intra-op thread pool each run of the session may currently use.");
+    WriteSample(os, "onnxruntime_session_global_thread_pool_share_threads", session_label,
+                scheduler_stats.max_degree_of_parallelism);
+
+    WriteHeader(os, "onnxruntime_session_global_thread_pool_allotted_seconds_total", "counter",
+                "Thread time of the global intra-op thread pool allotted to the runs of the session. "
+                "Its rate divided by the threads of the pool is the utilization of the pool by the session.");
+    WriteSample(os, "onnxruntime_session_global_thread_pool_allotted_seconds_total", session_label,
+                static_cast<double>(scheduler_stats.allotted_thread_ns) / 1e9);
+
+    WriteHeader(os, "onnxruntime_session_active_runs", "gauge", "Number of runs of the session in progress.");
+    WriteSample(os, "onnxruntime_session_active_runs", session_label, scheduler_stats.active_runs);
+
+    WriteHeader(os, "onnxruntime_session_waiting_runs", "gauge",
+                "Number of runs of the session waiting to be admitted.");
+    WriteSample(os, "onnxruntime_session_waiting_runs", session_label, scheduler_stats.waiting_runs);
+  }
+
+  WriteHeader(os, "onnxruntime_session_nodes", "gauge", "Number of nodes assigned to each execution provider.");
+  for (const auto& provider : nodes_per_provider_) {
+    WriteSample(os, "onnxruntime_session_nodes",
+                MakeString(session_label, ",provider=\"", provider.first, "\""), provider.second);
+  }
+
+  WriteHeader(os, "onnxruntime_session_fallback_nodes", "gauge",
+              "Number of nodes that fell back to the CPU execution provider.");
+  WriteSample(os, "onnxruntime_session_fallback_nodes", session_label, num_fallback_nodes_);
+
+  return os.str();
+}
+
+}  // namespace onnxruntime
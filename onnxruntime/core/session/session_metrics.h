@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator_stats.h"
+#include "core/platform/threadpool.h"
+#include "core/session/thread_pool_scheduler.h"
+
+namespace onnxruntime {
+
+/**
+Run statistics of an InferenceSession, for monitoring in production.
+
+The counters are updated with relaxed atomics on every run and are always enabled. The values that are owned by
+other components (arena stats and thread pool busy time) are read when the metrics are exported, in the Prometheus
+text exposition format, which can be scraped by Prometheus and by OpenTelemetry collectors.
+*/
+class SessionMetrics {
+ public:
+  // Cumulative histogram of durations, with the buckets of kBucketBoundsUs.
+  class Histogram {
+   public:
+    // upper bounds of the buckets in microseconds, a last bucket counts the larger durations
+    static constexpr std::array<long long, 16> kBucketBoundsUs = {
+        50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000,
+        100000, 250000, 500000, 1000000, 2500000, 10000000};
+
+    void Record(long long duration_us);
+
+    // Writes the histogram in seconds, the base unit of Prometheus.
+    void Write(std::ostream& os, const std::string& name, const std::string& labels) const;
+
+   private:
+    std::array<std::atomic<uint64_t>, kBucketBoundsUs.size() + 1> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_us_{0};
+  };
+
+  // The values read from other components when the metrics are exported.
+  struct Snapshot {
+    // stats of the session allocators, by device name
+    std::vector<std::pair<std::string, AllocatorStats>> allocator_stats;
+    // busy time and number of threads of the intra-op and inter-op thread pools
+    uint64_t intra_op_busy_ns{0};
+    int intra_op_threads{0};
+    uint64_t inter_op_busy_ns{0};
+    int inter_op_threads{0};
+    // threads created so far and parallelism of the loops of the intra-op and inter-op thread pools
+    concurrency::ThreadPool::ParallelismStats intra_op_parallelism;
+    concurrency::ThreadPool::ParallelismStats inter_op_parallelism;
+    // share of the global intra-op thread pool, if the session uses it
+    std::optional<ThreadPoolScheduler::ClientStats> scheduler_stats;
+  };
+
+  // Number of the last runs whose durations are exported as quantiles, which show the jitter of the runs at a finer
+  // resolution than the buckets of the histogram.
+  static constexpr size_t kNumRecentRuns = 1024;
+
+  void RecordRun(long long duration_us, bool failed) {
+    run_duration_.Record(duration_us);
+    const uint64_t run = num_runs_.fetch_add(1, std::memory_order_relaxed);
+    recent_run_durations_us_[run % kNumRecentRuns].store(duration_us, std::memory_order_relaxed);
+    if (failed) {
+      num_failed_runs_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // Time a run waited before it started executing: for the session lock when concurrent runs are not supported,
+  // or in the queue of the dynamic batcher.
+  void RecordQueueWait(long long duration_us) {
+    queue_wait_.Record(duration_us);
+  }
+
+  // Called once the graph is partitioned. Fallback nodes are the ones assigned to the CPU execution provider
+  // while another execution provider is registered.
+  void SetNodeAssignment(std::vector<std::pair<std::string, size_t>> nodes_per_provider, size_t num_fallback_nodes);
+
+  std::string ToPrometheusText(const std::string& session_id, const Snapshot& snapshot) const;
+
+ private:
+  Histogram run_duration_;
+  // ring buffer of the durations of the last runs, indexed by num_runs_
+  std::array<std::atomic<long long>, kNumRecentRuns> recent_run_durations_us_{};
+  std::atomic<uint64_t> num_runs_{0};
+  Histogram queue_wait_;
+  std::atomic<uint64_t> num_failed_runs_{0};
+
+  // written once by Initialize before any run
+  std::vector<std::pair<std::string, size_t>> nodes_per_provider_;
+  size_t num_fallback_nodes_{0};
+};
+
+}  // namespace onnxruntime
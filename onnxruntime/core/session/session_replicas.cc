@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/session_replicas.h"
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+#include "core/common/inlined_containers.h"
+#include "core/framework/tensor.h"
+#include "core/platform/env.h"
+#include "core/session/IOBinding.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+
+class SessionReplicas::RunScope {
+ public:
+  explicit RunScope(Replica& replica) : replica_(replica) {
+    replica_.runs_in_progress.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  ~RunScope() {
+    replica_.runs_in_progress.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunScope);
+  Replica& replica_;
+};
+
+struct SessionReplicas::AsyncRun {
+  Replica* replica;
+  RunAsyncCallbackFn callback;
+  void* user_data;
+};
+
+namespace {
+
+#if !defined(ORT_MINIMAL_BUILD)
+Status ReadFile(const std::filesystem::path& path, std::vector<uint8_t>& bytes) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  ORT_RETURN_IF_NOT(file, "Failed to open ", ToUTF8String(path.native()));
+  const auto size = static_cast<size_t>(file.tellg());
+  bytes.resize(size);
+  file.seekg(0);
+  file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(size));
+  ORT_RETURN_IF_NOT(file, "Failed to read ", ToUTF8String(path.native()));
+  return Status::OK();
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+Status CreateSession(const SessionOptions& session_options, const Environment& env, int device_id,
+                     const SessionReplicas::RegisterProvidersFn& register_providers,
+                     const std::function<Status(InferenceSession&)>& load,
+                     std::unique_ptr<InferenceSession>& session) {
+  session = std::make_unique<InferenceSession>(session_options, env);
+  ORT_RETURN_IF_ERROR(register_providers(device_id, *session));
+  ORT_RETURN_IF_ERROR(load(*session));
+  return session->Initialize();
+}
+
+}  // namespace
+
+// static
+Status SessionReplicas::Create(const SessionOptions& session_options, const Environment& env,
+                               const PathString& model_uri, const Options& options,
+                               const RegisterProvidersFn& register_providers,
+                               std::unique_ptr<SessionReplicas>& replicas) {
+  ORT_RETURN_IF(options.device_ids.empty(), "At least one device is required for the session replicas.");
+  ORT_RETURN_IF_NOT(register_providers, "A function registering the execution providers is required.");
+
+  auto new_replicas = std::unique_ptr<SessionReplicas>(new SessionReplicas(options.device_ids.size()));
+  for (size_t i = 0; i < options.device_ids.size(); ++i) {
+    new_replicas->replicas_[i].device_id = options.device_ids[i];
+  }
+
+  const auto load_model = [&model_uri](InferenceSession& session) { return session.Load(model_uri); };
+
+#if !defined(ORT_MINIMAL_BUILD)
+  if (options.share_optimized_model && options.device_ids.size() > 1) {
+    ORT_RETURN_IF_NOT(session_options.optimized_model_filepath.empty(),
+                      "optimized_model_filepath can't be set when the replicas share the optimized model.");
+
+    // the first replica saves the optimized model in the ORT format, which keeps its initializers
+    const std::filesystem::path ort_model_path =
+        std::filesystem::temp_directory_path() /
+        ToPathString("ort_session_replicas." + std::to_string(Env::Default().GetSelfPid()) + "." +
+                     std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".ort");
+    SessionOptions first_options = session_options;
+    first_options.optimized_model_filepath = ort_model_path.native();
+    ORT_RETURN_IF_ERROR(first_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigSaveModelFormat, "ORT"));
+
+    auto& first = new_replicas->replicas_[0];
+    auto status = CreateSession(first_options, env, first.device_id, register_providers, load_model, first.session);
+    if (status.IsOK()) {
+      status = ReadFile(ort_model_path, new_replicas->ort_model_bytes_);
+    }
+    std::error_code ec;
+    std::filesystem::remove(ort_model_path, ec);
+    ORT_RETURN_IF_ERROR(status);
+
+    // the sessions use the bytes of the model for their graph and CPU initializers instead of copying them
+    SessionOptions replica_options = session_options;
+    ORT_RETURN_IF_ERROR(
+        replica_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseORTModelBytesDirectly, "1"));
+    ORT_RETURN_IF_ERROR(
+        replica_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "1"));
+
+    const auto& ort_model_bytes = new_replicas->ort_model_bytes_;
+    const auto load_ort_model = [&ort_model_bytes](InferenceSession& session) {
+      return session.Load(ort_model_bytes.data(), static_cast<int>(ort_model_bytes.size()));
+    };
+    for (size_t i = 1; i < new_replicas->replicas_.size(); ++i) {
+      auto& replica = new_replicas->replicas_[i];
+      ORT_RETURN_IF_ERROR(CreateSession(replica_options, env, replica.device_id, register_providers, load_ort_model,
+                                        replica.session));
+    }
+
+    replicas = std::move(new_replicas);
+    return Status::OK();
+  }
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+  // otherwise every replica loads the model. a minimal build can't save the optimized model.
+  for (auto& replica : new_replicas->replicas_) {
+    ORT_RETURN_IF_ERROR(CreateSession(session_options, env, replica.device_id, register_providers, load_model,
+                                      replica.session));
+  }
+  replicas = std::move(new_replicas);
+  return Status::OK();
+}
+
+SessionReplicas::~SessionReplicas() = default;
+
+size_t SessionReplicas::SelectReplica(gsl::span<const OrtValue* const> values) const {
+  // a run with values on a device goes to the replica of that device
+  for (const OrtValue* value : values) {
+    if (value == nullptr || !value->IsAllocated() || !value->IsTensor()) {
+      continue;
+    }
+    const OrtDevice& device = value->Get<Tensor>().Location().device;
+    if (device.Type() == OrtDevice::CPU) {
+      continue;
+    }
+    for (size_t i = 0; i < replicas_.size(); ++i) {
+      if (replicas_[i].device_id == device.Id()) {
+        return i;
+      }
+    }
+  }
+
+  const size_t start = next_replica_.fetch_add(1, std::memory_order_relaxed);
+  size_t selected = 0;
+  size_t fewest_runs = std::numeric_limits<size_t>::max();
+  for (size_t i = 0; i < replicas_.size(); ++i) {
+    const size_t replica = (start + i) % replicas_.size();
+    const size_t runs = replicas_[replica].runs_in_progress.load(std::memory_order_relaxed);
+    if (runs < fewest_runs) {
+      selected = replica;
+      fewest_runs = runs;
+    }
+  }
+  return selected;
+}
+
+Status SessionReplicas::Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                            gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                            std::vector<OrtValue>* p_fetches, const std::vector<OrtDevice>* p_fetches_device_info) {
+  InlinedVector<const OrtValue*> values;
+  values.reserve(feeds.size() + (p_fetches != nullptr ? p_fetches->size() : 0));
+  for (const auto& feed : feeds) {
+    values.push_back(&feed);
+  }
+  if (p_fetches != nullptr) {
+    for (const auto& fetch : *p_fetches) {
+      values.push_back(&fetch);
+    }
+  }
+
+  auto& replica = replicas_[SelectReplica(values)];
+  RunScope run_scope(replica);
+  return replica.session->Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info);
+}
+
+Status SessionReplicas::Run(const RunOptions& run_options, IOBinding& io_binding) {
+  return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
+             &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo());
+}
+
+Status SessionReplicas::RunAsync(const RunOptions* run_options, gsl::span<const char* const> feed_names,
+                                 gsl::span<const OrtValue* const> feeds, gsl::span<const char* const> fetch_names,
+                                 gsl::span<OrtValue*> fetches, RunAsyncCallbackFn callback, void* user_data) {
+  InlinedVector<const OrtValue*> values(feeds.begin(), feeds.end());
+  values.insert(values.end(), fetches.begin(), fetches.end());
+
+  auto& replica = replicas_[SelectReplica(values)];
+  replica.runs_in_progress.fetch_add(1, std::memory_order_relaxed);
+  // deleted by OnAsyncRunDone, which may run before RunAsync returns
+  auto* async_run = new AsyncRun{&replica, callback, user_data};
+  auto status = replica.session->RunAsync(run_options, feed_names, feeds, fetch_names, fetches, OnAsyncRunDone,
+                                          async_run);
+  if (!status.IsOK()) {
+    delete async_run;
+    replica.runs_in_progress.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return status;
+}
+
+// static
+void SessionReplicas::OnAsyncRunDone(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status) {
+  std::unique_ptr<AsyncRun> async_run(static_cast<AsyncRun*>(user_data));
+  async_run->replica->runs_in_progress.fetch_sub(1, std::memory_order_relaxed);
+  async_run->callback(async_run->user_data, outputs, num_outputs, status);
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/session/onnxruntime_c_api.h"
+
+namespace onnxruntime {
+class Environment;
+class InferenceSession;
+class IOBinding;
+struct SessionOptions;
+
+/**
+Data parallel replicas of a model, one session per device, that are run like a single session.
+
+The first replica optimizes the model and its optimized graph is kept in memory in the ORT format. The other replicas
+load that graph instead of the model, so the model is parsed and optimized once, and their CPU initializers point into
+the one buffer instead of every replica loading its own copy. Their device initializers are copied from it.
+
+Every run goes to one replica: the replica of the device the inputs (or the pre-allocated outputs) are on, so values
+already on a GPU are not copied to another one, otherwise the replica with the fewest runs in progress.
+This class is thread-safe.
+*/
+class SessionReplicas {
+ public:
+  // Registers the execution providers of the replica for the device with the session. The session is not loaded yet.
+  using RegisterProvidersFn = std::function<Status(int device_id, InferenceSession& session)>;
+
+  struct Options {
+    // one replica is created for each device, e.g. the device_id of the CUDA EP
+    std::vector<int> device_ids;
+    // Loads the other replicas from the graph optimized by the first one. This requires the optimized graph to be
+    // serializable, so it must be disabled for execution providers which compile nodes, e.g. TensorRT.
+    bool share_optimized_model = true;
+  };
+
+  // Creates and initializes the replicas of the model.
+  static Status Create(const SessionOptions& session_options, const Environment& env, const PathString& model_uri,
+                       const Options& options, const RegisterProvidersFn& register_providers,
+                       std::unique_ptr<SessionReplicas>& replicas);
+
+  ~SessionReplicas();
+
+  // Same semantics as InferenceSession::Run, on the selected replica.
+  Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+             gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+             std::vector<OrtValue>* p_fetches, const std::vector<OrtDevice>* p_fetches_device_info = nullptr);
+
+  // Runs the values bound by the binding, which can be created by any replica.
+  Status Run(const RunOptions& run_options, IOBinding& io_binding);
+
+  // Same semantics as InferenceSession::RunAsync, on the selected replica. The callback is called once the run
+  // completed, on a thread of the replica.
+  Status RunAsync(const RunOptions* run_options, gsl::span<const char* const> feed_names,
+                  gsl::span<const OrtValue* const> feeds, gsl::span<const char* const> fetch_names,
+                  gsl::span<OrtValue*> fetches, RunAsyncCallbackFn callback, void* user_data = nullptr);
+
+  size_t NumReplicas() const { return replicas_.size(); }
+
+  int GetDeviceId(size_t replica) const { return replicas_[replica].device_id; }
+
+  // The session of a replica, e.g. to create an IOBinding with the allocators of its device.
+  InferenceSession& GetSession(size_t replica) { return *replicas_[replica].session; }
+
+  // Returns the replica a run with these values goes to.
+  size_t SelectReplica(gsl::span<const OrtValue* const> values) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionReplicas);
+
+  struct Replica {
+    int device_id{0};
+    std::unique_ptr<InferenceSession> session;
+    std::atomic<size_t> runs_in_progress{0};
+  };
+
+  // Counts the run as in progress on the replica while it exists.
+  class RunScope;
+  struct AsyncRun;
+  static void OnAsyncRunDone(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status);
+
+  explicit SessionReplicas(size_t num_replicas) : replicas_(num_replicas) {}
+
+  // The optimized model in the ORT format, used by the sessions of the replicas after the first one.
+  // Declared before the replicas so it is destroyed after their sessions.
+  std::vector<uint8_t> ort_model_bytes_;
+  std::vector<Replica> replicas_;
+  // where the search for the least loaded replica starts, so replicas with the same load are used in turn
+  mutable std::atomic<size_t> next_replica_{0};
+};
+
+}  // namespace onnxruntime
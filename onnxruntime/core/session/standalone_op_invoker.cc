@@ -6,6 +6,8 @@
 #include "core/framework/error_code_helper.h"
 #include "core/framework/TensorSeq.h"
 #include "core/session/ort_apis.h"
+#include <algorithm>
+#include <sstream>
 #include <unordered_map>
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -86,7 +88,15 @@ using NodePtr = std::unique_ptr<onnxruntime::Node>;
 using ArgPtr = std::unique_ptr<onnxruntime::NodeArg>;
 using ArgPtrs = onnxruntime::InlinedVector<ArgPtr>;
 
-using NodeResource = std::pair<NodePtr, ArgPtrs>;
+// The node a kernel was created from. Kernels created with the same arguments are shared by the OrtOps handed out,
+// ref_count counts them.
+struct NodeResource {
+  NodePtr node;
+  ArgPtrs args;
+  std::string cache_key;
+  size_t ref_count{1};
+};
+
 using NodeResourceMap = InlinedHashMap<const onnxruntime::OpKernel*, NodeResource>;
 
 class NodeRepo {
@@ -104,13 +114,30 @@ class NodeRepo {
     return kernel_create_info.kernel_create_func(func_mgr_, kernel_info, op_kernel);
   }
 
-  onnxruntime::Status AddNode(const onnxruntime::OpKernel* kernel, NodePtr&& node_ptr, ArgPtrs&& args) {
+  // Returns a kernel created before with the same cache key and takes a reference to it, or nullptr.
+  const onnxruntime::OpKernel* FindKernel(const std::string& cache_key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto iter = kernel_cache_.find(cache_key);
+    if (iter == kernel_cache_.end()) {
+      return nullptr;
+    }
+    ++resource_map_.at(iter->second).ref_count;
+    return iter->second;
+  }
+
+  onnxruntime::Status AddNode(const onnxruntime::OpKernel* kernel, NodePtr&& node_ptr, ArgPtrs&& args,
+                              const std::string& cache_key) {
     std::lock_guard<std::mutex> guard(mutex_);
     auto ret = resource_map_.try_emplace(kernel, NodeResource{std::move(node_ptr), std::move(args)});
     if (!ret.second) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "kernel already mapped to existing node");
     }
 
+    // another thread may have cached a kernel for the key meanwhile, this one is then not shared
+    if (kernel_cache_.try_emplace(cache_key, kernel).second) {
+      ret.first->second.cache_key = cache_key;
+    }
+
     return Status::OK();
   }
 
@@ -123,7 +150,7 @@ class NodeRepo {
       // in a minimal build.
       // The opset version will not necessarily match the model, so we need to call GetSchema directly to plug that in.
       // In theory this should never fail if the kernel lookup earlier was successful.
-      const Node& node = *cur->second.first;
+      const Node& node = *cur->second.node;
       auto* schema = graph.GetSchemaRegistry()->GetSchema(node.OpType(), node.SinceVersion(), node.Domain());
 
       ORT_RETURN_IF_NOT(schema, "Unable to find schema for node. Domain:'", node.Domain(),
@@ -146,7 +173,7 @@ class NodeRepo {
       if (iter == resource_map_.end()) {
         return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "matching node is missing");
       }
-      auto* node = iter->second.first.get();
+      auto* node = iter->second.node.get();
       expect_input_count = node->InputDefs().size();
       expect_output_count = node->OutputDefs().size();
     }
@@ -163,9 +190,21 @@ class NodeRepo {
     return Status::OK();
   }
 
-  void RemoveNode(const onnxruntime::OpKernel* kernel) {
+  // Drops a reference to the kernel. Returns true if it was the last one, the caller then deletes the kernel.
+  bool ReleaseNode(const onnxruntime::OpKernel* kernel) {
     std::lock_guard<std::mutex> guard(mutex_);
-    resource_map_.erase(kernel);
+    auto iter = resource_map_.find(kernel);
+    if (iter == resource_map_.end()) {
+      return true;
+    }
+    if (--iter->second.ref_count > 0) {
+      return false;
+    }
+    if (!iter->second.cache_key.empty()) {
+      kernel_cache_.erase(iter->second.cache_key);
+    }
+    resource_map_.erase(iter);
+    return true;
   }
 
  private:
@@ -174,6 +213,7 @@ class NodeRepo {
 
   std::mutex mutex_;
   NodeResourceMap resource_map_;
+  InlinedHashMap<std::string, const onnxruntime::OpKernel*> kernel_cache_;
   FuncManager func_mgr_;
 };
 
@@ -362,6 +402,42 @@ onnxruntime::Status CreateOpAttr(const char* name, const void* data, int len, Or
   return status;
 }
 
+// The key of the kernels shared by CreateOp. The kernels are created for an execution provider instance, whose
+// address identifies the session too.
+std::string GetKernelCacheKey(const IExecutionProvider* ep, const char* op_name, const char* domain, int version,
+                              const char** type_constraint_names,
+                              const ONNXTensorElementDataType* type_constraint_values, int type_constraint_count,
+                              const OrtOpAttr* const* attr_values, int attr_count, int input_count,
+                              int output_count) {
+  std::ostringstream key;
+  key << static_cast<const void*>(ep) << ':' << domain << ':' << op_name << ':' << version << ':' << input_count
+      << ':' << output_count;
+
+  std::vector<std::pair<std::string, int>> type_constraints;
+  for (int i = 0; i < type_constraint_count; ++i) {
+    type_constraints.emplace_back(type_constraint_names[i], static_cast<int>(type_constraint_values[i]));
+  }
+  std::sort(type_constraints.begin(), type_constraints.end());
+  for (const auto& [name, type] : type_constraints) {
+    key << ':' << name << '=' << type;
+  }
+
+  std::vector<const ONNX_NAMESPACE::AttributeProto*> attrs;
+  for (int i = 0; i < attr_count; ++i) {
+    attrs.push_back(reinterpret_cast<const ONNX_NAMESPACE::AttributeProto*>(attr_values[i]));
+  }
+  std::sort(attrs.begin(), attrs.end(), [](const ONNX_NAMESPACE::AttributeProto* a,
+                                           const ONNX_NAMESPACE::AttributeProto* b) {
+    return a->name() < b->name();
+  });
+  for (const auto* attr : attrs) {
+    const std::string value = attr->SerializeAsString();
+    key << ':' << value.size() << ':' << value;
+  }
+
+  return key.str();
+}
+
 onnxruntime::Status CreateOp(_In_ const OrtKernelInfo* info,
                              _In_z_ const char* op_name,
                              _In_z_ const char* domain,
@@ -377,6 +453,18 @@ onnxruntime::Status CreateOp(_In_ const OrtKernelInfo* info,
   *op = nullptr;
   auto kernel_info = reinterpret_cast<const OpKernelInfo*>(info);
   auto ep = reinterpret_cast<const IExecutionProvider*>(kernel_info->GetExecutionProvider());
+
+  // Custom ops typically create their OrtOps once per kernel instance, and the same op with the same attributes
+  // and types many times across a session. Kernels are stateless across Compute calls, so share them.
+  auto& node_repo = NodeRepo::GetInstance();
+  const std::string cache_key = GetKernelCacheKey(ep, op_name, domain, version, type_constraint_names,
+                                                  type_constraint_values, type_constraint_count, attr_values,
+                                                  attr_count, input_count, output_count);
+  if (const auto* cached_kernel = node_repo.FindKernel(cache_key); cached_kernel != nullptr) {
+    *op = reinterpret_cast<OrtOp*>(const_cast<OpKernel*>(cached_kernel));
+    return Status::OK();
+  }
+
   auto kernel_registry = ep->GetKernelRegistry();
   const KernelCreateInfo* kernel_create_info{};
   InlinedHashMap<std::string, MLDataType> type_constraint_map;
@@ -430,9 +518,8 @@ onnxruntime::Status CreateOp(_In_ const OrtKernelInfo* info,
 
   std::unique_ptr<onnxruntime::OpKernel> op_kernel;
 
-  auto& node_repo = NodeRepo::GetInstance();
   ORT_RETURN_IF_ERROR(node_repo.CreateKernel(*kernel_create_info, tmp_kernel_info, op_kernel));
-  ORT_RETURN_IF_ERROR(node_repo.AddNode(op_kernel.get(), std::move(node_ptr), std::move(arg_ptrs)));
+  ORT_RETURN_IF_ERROR(node_repo.AddNode(op_kernel.get(), std::move(node_ptr), std::move(arg_ptrs), cache_key));
 
   *op = reinterpret_cast<OrtOp*>(op_kernel.release());
   return status;
@@ -539,8 +626,9 @@ ORT_API_STATUS_IMPL(OrtApis::InvokeOp,
 ORT_API(void, OrtApis::ReleaseOp, _Frees_ptr_opt_ OrtOp* op) {
   if (op) {
     auto kernel = reinterpret_cast<onnxruntime::OpKernel*>(op);
-    onnxruntime::standalone::NodeRepo::GetInstance().RemoveNode(kernel);
-    delete kernel;
+    if (onnxruntime::standalone::NodeRepo::GetInstance().ReleaseNode(kernel)) {
+      delete kernel;
+    }
   }
 }
 
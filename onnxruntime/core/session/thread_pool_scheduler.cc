@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/thread_pool_scheduler.h"
+
+#include <algorithm>
+
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+ThreadPoolScheduler::ThreadPoolScheduler(concurrency::ThreadPool* thread_pool)
+    : num_threads_(concurrency::ThreadPool::NumThreads(thread_pool) + 1),
+      last_update_(std::chrono::steady_clock::now()) {
+}
+
+std::unique_ptr<ThreadPoolScheduler::Client> ThreadPoolScheduler::Register(const ClientOptions& options) {
+  ORT_ENFORCE(options.weight >= 0 && options.max_threads >= 0 && options.max_concurrent_runs >= 0,
+              "The thread pool scheduling options must not be negative.");
+  auto client = std::unique_ptr<Client>(new Client(*this, options));
+  std::lock_guard<std::mutex> lock(mutex_);
+  clients_.push_back(client.get());
+  UpdateSharesLocked();
+  return client;
+}
+
+void ThreadPoolScheduler::AccountAllottedTimeLocked() {
+  const auto now = std::chrono::steady_clock::now();
+  const auto elapsed_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_update_).count());
+  last_update_ = now;
+
+  for (Client* client : clients_) {
+    if (client->active_runs_ > 0) {
+      const int threads = std::min(num_threads_, client->active_runs_ *
+                                                     client->max_degree_of_parallelism_.load(std::memory_order_relaxed));
+      client->allotted_thread_ns_ += elapsed_ns * static_cast<uint64_t>(threads);
+    }
+  }
+}
+
+void ThreadPoolScheduler::UpdateSharesLocked() {
+  int64_t total_weight = 0;
+  for (const Client* client : clients_) {
+    if (client->active_runs_ > 0) {
+      total_weight += client->options_.weight;
+    }
+  }
+
+  for (Client* client : clients_) {
+    int share = num_threads_;
+    // a client that is not running yet gets the share it would have if it started, for the stats
+    const int64_t weight = client->options_.weight;
+    const int64_t weights = total_weight + (client->active_runs_ > 0 ? 0 : weight);
+    if (weight > 0 && weights > 0) {
+      share = std::max(1, static_cast<int>(num_threads_ * weight / weights));
+    }
+    if (client->options_.max_threads > 0) {
+      share = std::min(share, client->options_.max_threads);
+    }
+    client->max_degree_of_parallelism_.store(share, std::memory_order_relaxed);
+  }
+}
+
+ThreadPoolScheduler::Client::Client(ThreadPoolScheduler& scheduler, const ClientOptions& options)
+    : scheduler_(scheduler), options_(options), max_degree_of_parallelism_(scheduler.num_threads_) {
+}
+
+ThreadPoolScheduler::Client::~Client() {
+  std::lock_guard<std::mutex> lock(scheduler_.mutex_);
+  auto& clients = scheduler_.clients_;
+  clients.erase(std::remove(clients.begin(), clients.end(), this), clients.end());
+  scheduler_.UpdateSharesLocked();
+}
+
+ThreadPoolScheduler::ClientStats ThreadPoolScheduler::Client::GetStats() const {
+  std::lock_guard<std::mutex> lock(scheduler_.mutex_);
+  scheduler_.AccountAllottedTimeLocked();
+  ClientStats stats;
+  stats.active_runs = active_runs_;
+  stats.waiting_runs = waiting_runs_;
+  stats.max_degree_of_parallelism = max_degree_of_parallelism_.load(std::memory_order_relaxed);
+  stats.allotted_thread_ns = allotted_thread_ns_;
+  return stats;
+}
+
+ThreadPoolScheduler::Run::Run(Client& client) : client_(client) {
+  auto& scheduler = client_.scheduler_;
+  std::unique_lock<std::mutex> lock(scheduler.mutex_);
+  const int max_concurrent_runs = client_.options_.max_concurrent_runs;
+  if (max_concurrent_runs > 0 && client_.active_runs_ >= max_concurrent_runs) {
+    ++client_.waiting_runs_;
+    client_.admission_.wait(lock, [&]() { return client_.active_runs_ < max_concurrent_runs; });
+    --client_.waiting_runs_;
+  }
+
+  scheduler.AccountAllottedTimeLocked();
+  ++client_.active_runs_;
+  scheduler.UpdateSharesLocked();
+}
+
+ThreadPoolScheduler::Run::~Run() {
+  auto& scheduler = client_.scheduler_;
+  {
+    std::lock_guard<std::mutex> lock(scheduler.mutex_);
+    scheduler.AccountAllottedTimeLocked();
+    --client_.active_runs_;
+    scheduler.UpdateSharesLocked();
+  }
+  client_.admission_.notify_one();
+}
+
+const std::atomic<int>& ThreadPoolScheduler::Run::MaxDegreeOfParallelism() const {
+  return client_.max_degree_of_parallelism_;
+}
+
+}  // namespace onnxruntime
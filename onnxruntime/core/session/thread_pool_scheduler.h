@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+
+/**
+Arbitrates the threads of the global intra-op thread pool between the sessions sharing it.
+
+Each session using the global thread pools with any scheduling option registers as a client with a weight, an optional
+quota of threads and an optional limit on its concurrent runs. While runs of several weighted clients are in progress,
+the threads of the pool, including the threads calling Run, are divided between those clients in proportion to their
+weights. Each run is limited to its client's share through ThreadPool::RunScope. The shares are updated whenever a run
+starts or finishes, and apply from the next parallel loop of the runs in progress.
+
+Clients with a weight of 0 are not balanced with the others, only their quota and concurrent run limit apply.
+This class is thread-safe.
+*/
+class ThreadPoolScheduler {
+ public:
+  struct ClientOptions {
+    // share of the thread pool relative to the other clients, 0 to not balance the client
+    int weight{0};
+    // maximum number of threads working on each parallel loop of the client's runs, 0 for no quota
+    int max_threads{0};
+    // maximum number of runs of the client in progress, the others wait until one finishes. 0 for no limit.
+    int max_concurrent_runs{0};
+  };
+
+  struct ClientStats {
+    int active_runs{0};
+    int waiting_runs{0};
+    // threads each run of the client may currently use
+    int max_degree_of_parallelism{0};
+    // sum over time of the threads allotted to the runs of the client in progress, in thread nanoseconds.
+    // its rate divided by the threads of the pool is the client's share of the pool.
+    uint64_t allotted_thread_ns{0};
+  };
+
+  class Client;
+
+  // A run of a client. The constructor blocks until the run is admitted, the destructor ends it.
+  class Run {
+   public:
+    explicit Run(Client& client);
+    ~Run();
+
+    // the threads the run may currently use, for ThreadPool::RunScope
+    const std::atomic<int>& MaxDegreeOfParallelism() const;
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Run);
+    Client& client_;
+  };
+
+  explicit ThreadPoolScheduler(concurrency::ThreadPool* thread_pool);
+
+  // The client is unregistered when it is destroyed, which must happen before the scheduler is destroyed.
+  std::unique_ptr<Client> Register(const ClientOptions& options);
+
+  int NumThreads() const { return num_threads_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadPoolScheduler);
+
+  // adds the threads allotted to the runs in progress since the last update to the clients' stats
+  void AccountAllottedTimeLocked();
+  void UpdateSharesLocked();
+
+  // threads of the pool and the thread calling Run
+  const int num_threads_;
+
+  mutable std::mutex mutex_;
+  std::vector<Client*> clients_;
+  std::chrono::steady_clock::time_point last_update_;
+};
+
+class ThreadPoolScheduler::Client {
+ public:
+  ~Client();
+
+  ClientStats GetStats() const;
+
+  const ClientOptions& Options() const { return options_; }
+
+ private:
+  friend class ThreadPoolScheduler;
+  Client(ThreadPoolScheduler& scheduler, const ClientOptions& options);
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Client);
+
+  ThreadPoolScheduler& scheduler_;
+  const ClientOptions options_;
+
+  // guarded by the mutex of the scheduler
+  int active_runs_{0};
+  int waiting_runs_{0};
+  uint64_t allotted_thread_ns_{0};
+  std::condition_variable admission_;
+
+  // read by the runs in progress on every parallel loop
+  std::atomic<int> max_degree_of_parallelism_;
+};
+
+}  // namespace onnxruntime
@@ -260,6 +260,39 @@ ParQuantizeLinearStd(const MLFloat16* Input,
 
 #if !defined(DISABLE_FLOAT8_TYPES)
 
+// the MLAS format of an ORT float 8 type
+template <typename Float8Type>
+constexpr MLAS_FLOAT8_TYPE GetMlasFloat8Type() {
+  static_assert(boost::mp11::mp_contains<element_type_lists::AllFloat8, Float8Type>::value);
+  if constexpr (std::is_same_v<Float8Type, Float8E4M3FN>) {
+    return MlasFloat8E4M3FN;
+  } else if constexpr (std::is_same_v<Float8Type, Float8E4M3FNUZ>) {
+    return MlasFloat8E4M3FNUZ;
+  } else if constexpr (std::is_same_v<Float8Type, Float8E5M2>) {
+    return MlasFloat8E5M2;
+  } else {
+    return MlasFloat8E5M2FNUZ;
+  }
+}
+
+// Y = X * Scale for float 8 X, in blocks of N split across the thread pool
+template <typename InputFloat8Type>
+typename std::enable_if<boost::mp11::mp_contains<element_type_lists::AllFloat8, InputFloat8Type>::value, void>::type
+ParDequantizeLinear(const InputFloat8Type* Input, float* Output, size_t N, float Scale,
+                    concurrency::ThreadPool* thread_pool) {
+  constexpr std::ptrdiff_t block_size = 4096;
+  const std::ptrdiff_t num_blocks = (N + block_size - 1) / block_size;
+  const TensorOpCost unit_cost{static_cast<double>(block_size * sizeof(uint8_t)),
+                               static_cast<double>(block_size * sizeof(float)), static_cast<double>(block_size)};
+  concurrency::ThreadPool::TryParallelFor(thread_pool, num_blocks, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    auto begin_idx = begin * block_size;
+    auto end_idx = std::min(static_cast<std::ptrdiff_t>(N), end * block_size);
+    MlasConvertFloat8ToFloatBuffer(reinterpret_cast<const uint8_t*>(Input + begin_idx), Output + begin_idx,
+                                   static_cast<size_t>(end_idx - begin_idx), GetMlasFloat8Type<InputFloat8Type>(),
+                                   Scale);
+  });
+}
+
 template <typename OutputFloat8Type>
 typename std::enable_if<boost::mp11::mp_contains<element_type_lists::AllFloat8, OutputFloat8Type>::value, void>::type
 ParQuantizeLinearSat(const float* Input,
@@ -22,6 +22,9 @@ std::ostream& operator<<(std::ostream& os, const OrtThreadPoolParams& params) {
   os << " dynamic_block_base_: " << params.dynamic_block_base_;
   os << " stack_size: " << params.stack_size;
   os << " affinity_str: " << params.affinity_str;
+  os << " numa_aware: " << params.numa_aware;
+  os << " performance_cores_only: " << params.performance_cores_only;
+  os << " create_threads_lazily: " << params.create_threads_lazily;
   // os << " name: " << (params.name ? params.name : L"nullptr");
   os << " set_denormal_as_zero: " << params.set_denormal_as_zero;
   // os << " custom_create_thread_fn: " << (params.custom_create_thread_fn ? "set" : "nullptr");
@@ -89,9 +92,57 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
 }
 #endif
 
+// Divides the threads between the NUMA nodes in proportion to their number of logical processors, keeping the
+// threads of a node next to each other, and attaches each thread to the processors of its node.
+// The first thread is the one entering the parallel loops, it is counted in the first node but left unattached.
+static void SetNumaAffinities(const std::vector<LogicalProcessors>& numa_nodes, int thread_pool_size,
+                              ThreadOptions& to) {
+  size_t num_processors = 0;
+  for (const auto& node : numa_nodes) {
+    num_processors += node.size();
+  }
+
+  to.affinities.clear();
+  to.numa_nodes.clear();
+  size_t node = 0;
+  size_t node_processors_end = numa_nodes[0].size();
+  for (int i = 0; i < thread_pool_size; ++i) {
+    // the thread is in the node whose range of processors contains the middle of its share of processors
+    const size_t position =
+        (2 * static_cast<size_t>(i) + 1) * num_processors / (2 * static_cast<size_t>(thread_pool_size));
+    while (position >= node_processors_end && node + 1 < numa_nodes.size()) {
+      ++node;
+      node_processors_end += numa_nodes[node].size();
+    }
+    to.affinities.push_back(i == 0 ? LogicalProcessors{} : numa_nodes[node]);
+    to.numa_nodes.push_back(static_cast<int>(node));
+  }
+}
+
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
+  if (options.performance_cores_only) {
+    ORT_ENFORCE(options.affinity_str.empty() && !options.numa_aware,
+                "Restricting a thread pool to performance cores cannot be combined with an affinity string or "
+                "with NUMA awareness");
+    auto performance_cores = env->GetPerformanceCoreAffinities();
+    if (performance_cores.empty()) {
+      LOGS_DEFAULT(INFO) << "All the cores are of the same performance class, the thread pool uses all of them";
+    } else if (options.thread_pool_size <= 0) {
+      // one thread per performance core, the first one being the thread entering the parallel loops
+      options.thread_pool_size = static_cast<int>(performance_cores.size());
+      to.affinities = std::move(performance_cores);
+    } else {
+      LogicalProcessors performance_processors;
+      for (const auto& core : performance_cores) {
+        performance_processors.insert(performance_processors.end(), core.begin(), core.end());
+      }
+      to.affinities.assign(static_cast<size_t>(options.thread_pool_size), performance_processors);
+      to.affinities[0].clear();
+    }
+  }
+
   if (options.thread_pool_size <= 0) {  // default
     if (options.auto_set_affinity) {
 #ifdef _WIN32
@@ -145,12 +196,23 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
 #endif
   }
 
+  if (options.numa_aware) {
+    ORT_ENFORCE(options.affinity_str.empty(), "NUMA aware thread pools cannot be combined with an affinity string");
+    auto numa_nodes = env->GetNumaNodeProcessors();
+    if (numa_nodes.size() > 1) {
+      SetNumaAffinities(numa_nodes, options.thread_pool_size, to);
+    } else {
+      LOGS_DEFAULT(INFO) << "A single NUMA node was found, the thread pool is not partitioned by NUMA node";
+    }
+  }
+
   to.set_denormal_as_zero = options.set_denormal_as_zero;
   // set custom thread management members
   to.custom_create_thread_fn = options.custom_create_thread_fn;
   to.custom_thread_creation_options = options.custom_thread_creation_options;
   to.custom_join_thread_fn = options.custom_join_thread_fn;
   to.dynamic_block_base_ = options.dynamic_block_base_;
+  to.create_threads_lazily = options.create_threads_lazily;
   if (to.custom_create_thread_fn) {
     ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set");
   }
@@ -37,6 +37,21 @@ struct OrtThreadPoolParams {
   // meaning ith thread will be attached to first 8 logical processors
   std::string affinity_str;
 
+  // If it is true and the system has more than one NUMA node, the threads are divided between the nodes in
+  // proportion to their number of logical processors, each thread is attached to the processors of its node,
+  // and parallel loops give the threads of a node a contiguous part of the iteration space.
+  // It cannot be combined with affinity_str.
+  bool numa_aware = false;
+
+  // If it is true and the system has cores of different performance classes, e.g. P-cores and E-cores, the threads
+  // are attached to the cores of the highest performance class only. If thread_pool_size = 0, there is one thread
+  // per performance core. It cannot be combined with affinity_str or numa_aware.
+  bool performance_cores_only = false;
+
+  // If it is true, the threads are created by the first parallel loop, parallel section or scheduled task instead
+  // of with the thread pool.
+  bool create_threads_lazily = false;
+
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
@@ -6,11 +6,14 @@ from __future__ import annotations
 
 import collections
 import collections.abc
+import concurrent.futures
 import os
 import typing
 import warnings
 from typing import Any, Sequence
 
+import numpy as np
+
 from onnxruntime.capi import _pybind_state as C
 
 if typing.TYPE_CHECKING:
@@ -306,6 +309,53 @@ class Session:
             output_names = [output.name for output in self._outputs_meta]
         return self._sess.run_async(output_names, input_feed, callback, user_data, run_options)
 
+    def run_batch(self, output_names, input_feeds, run_options=None):
+        """
+        Compute the predictions of several requests at once. The GIL is released while the requests run,
+        concurrently on the ort intra-op threadpool if it has more than one thread.
+
+        :param output_names: name of the outputs
+        :param input_feeds: list of dictionaries ``{ input_name: input_value }``, one per request
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: list of the results of each request, in the order of the requests
+
+        ::
+
+            sess.run_batch([output_name], [{input_name: x}, {input_name: y}])
+        """
+        for input_feed in input_feeds:
+            self._validate_input(list(input_feed.keys()))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.run_batch(output_names, input_feeds, run_options)
+
+    def run_future(self, output_names, input_feed, run_options=None):
+        """
+        Compute the predictions asynchronously like :meth:`run_async`, and return a future
+        that resolves to the results.
+
+        :param output_names: name of the outputs
+        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: a :class:`concurrent.futures.Future`
+
+        ::
+
+            futures = [sess.run_future([output_name], {input_name: x}) for x in inputs]
+            results = [future.result() for future in futures]
+        """
+        future = concurrent.futures.Future()
+        future.set_running_or_notify_cancel()
+
+        def callback(results, user_data, err):
+            if err:
+                future.set_exception(RuntimeError(err))
+            else:
+                future.set_result(results)
+
+        self.run_async(output_names, input_feed, callback, None, run_options)
+        return future
+
     def run_with_ort_values(self, output_names, input_dict_ort_values, run_options=None):
         """
         Compute the predictions.
@@ -586,6 +636,7 @@ class IOBinding:
     def __init__(self, session: Session):
         self._iobinding = C.SessionIOBinding(session._sess)
         self._numpy_obj_references = {}
+        self._output_obj_references = {}
 
     def bind_cpu_input(self, name, arr_on_cpu):
         """
@@ -620,6 +671,22 @@ class IOBinding:
             buffer_ptr,
         )
 
+    def bind_input_buffer(self, name, buffer, device_id=0):
+        """
+        Binds an input to the memory of an existing buffer without copying it. The buffer is kept alive until
+        the input is bound again or the input bindings are cleared.
+        :param name: input name
+        :param buffer: a C-contiguous numpy array, an object implementing ``__cuda_array_interface__``
+            or an object implementing the ``__dlpack__`` protocol
+        :param device_id: CUDA device id of a ``__cuda_array_interface__`` buffer, which doesn't record it
+        """
+        binding = self._buffer_binding(buffer, device_id, writeable=False)
+        if isinstance(binding, C.OrtValue):
+            self._iobinding.bind_ortvalue_input(name, binding)
+        else:
+            self._iobinding.bind_input(name, *binding)
+        self._numpy_obj_references[name] = buffer
+
     def bind_ortvalue_input(self, name, ortvalue):
         """
         :param name: input name
@@ -678,6 +745,67 @@ class IOBinding:
                 buffer_ptr,
             )
 
+    def bind_output_buffer(self, name, buffer, device_id=0):
+        """
+        Binds an output to the memory of an existing buffer, which the run writes to directly. The buffer must have
+        the shape and the element type of the output, and is kept alive until the output is bound again or the
+        output bindings are cleared.
+        :param name: output name
+        :param buffer: a writeable C-contiguous numpy array, an object implementing ``__cuda_array_interface__``
+            or an object implementing the ``__dlpack__`` protocol
+        :param device_id: CUDA device id of a ``__cuda_array_interface__`` buffer, which doesn't record it
+        """
+        binding = self._buffer_binding(buffer, device_id, writeable=True)
+        if isinstance(binding, C.OrtValue):
+            self._iobinding.bind_ortvalue_output(name, binding)
+        else:
+            self._iobinding.bind_output(name, *binding)
+        self._output_obj_references[name] = buffer
+
+    @staticmethod
+    def _buffer_binding(buffer, device_id, writeable):
+        """
+        Returns the arguments binding the memory of a buffer: (device, element type, shape, pointer),
+        or an OrtValue over it for a DLPack buffer.
+        """
+        if isinstance(buffer, np.ndarray):
+            if not buffer.flags["C_CONTIGUOUS"]:
+                raise ValueError("Only C-contiguous numpy arrays can be bound without a copy.")
+            if writeable and not buffer.flags["WRITEABLE"]:
+                raise ValueError("An output can only be bound to a writeable numpy array.")
+            device = C.OrtDevice(C.OrtDevice.cpu(), C.OrtDevice.default_memory(), 0)
+            return device, buffer.dtype.type, list(buffer.shape), buffer.ctypes.data
+
+        interface = getattr(buffer, "__cuda_array_interface__", None)
+        if interface is not None:
+            shape = list(interface["shape"])
+            element_type = np.dtype(interface["typestr"])
+            strides = interface.get("strides")
+            if strides is not None:
+                contiguous_strides = []
+                stride = element_type.itemsize
+                for dim in reversed(shape):
+                    contiguous_strides.insert(0, stride)
+                    stride *= dim
+                if list(strides) != contiguous_strides:
+                    raise ValueError("Only C-contiguous buffers can be bound without a copy.")
+            ptr, readonly = interface["data"]
+            if writeable and readonly:
+                raise ValueError("An output can only be bound to a writeable buffer.")
+            device = C.OrtDevice(C.OrtDevice.cuda(), C.OrtDevice.default_memory(), device_id)
+            return device, element_type.type, shape, ptr
+
+        if hasattr(buffer, "__dlpack__"):
+            if not hasattr(C.OrtValue, "from_dlpack"):
+                raise RuntimeError("This build of onnxruntime doesn't support DLPack.")
+            is_bool_tensor = str(getattr(buffer, "dtype", "")).endswith("bool")
+            return C.OrtValue.from_dlpack(buffer.__dlpack__(), is_bool_tensor)
+
+        raise TypeError(
+            "The buffer must be a numpy array or implement __cuda_array_interface__ or __dlpack__, got "
+            + str(type(buffer))
+        )
+
     def bind_ortvalue_output(self, name, ortvalue):
         """
         :param name: output name
@@ -705,11 +833,20 @@ class IOBinding:
         """Copy output contents to CPU."""
         return self._iobinding.copy_outputs_to_cpu()
 
+    def get_outputs_as_numpy(self):
+        """
+        Returns the outputs as numpy arrays. The arrays of outputs on CPU are views over the output memory
+        which keep it alive, without copying it. Outputs on other devices are copied to CPU.
+        """
+        return self._iobinding.get_outputs_as_numpy()
+
     def clear_binding_inputs(self):
         self._iobinding.clear_binding_inputs()
+        self._numpy_obj_references.clear()
 
     def clear_binding_outputs(self):
         self._iobinding.clear_binding_outputs()
+        self._output_obj_references.clear()
 
 
 class OrtValue:
@@ -200,7 +200,28 @@ void addIoBindingMethods(pybind11::module& m) {
           }
           ++pos;
         }
-        return result; });
+        return result; })
+      // Returns the outputs without copying the CPU tensors. The numpy arrays of CPU tensors are views over the
+      // output memory which keep their OrtValue alive, tensors on other devices are copied to CPU.
+      .def("get_outputs_as_numpy", [](const SessionIOBinding* io_binding) -> py::list {
+        const std::vector<OrtValue>& outputs = io_binding->Get()->GetOutputs();
+
+        size_t pos = 0;
+        const auto& dtm = io_binding->GetInferenceSession()->GetDataTransferManager();
+
+        py::list result;
+        for (const auto& ort_value : outputs) {
+          if (ort_value.IsTensor()) {
+            result.append(GetPyObjFromTensor(ort_value, &dtm));
+          } else if (ort_value.IsSparseTensor()) {
+            result.append(GetPyObjectFromSparseTensor(pos, ort_value, &dtm));
+          } else {
+            result.append(AddNonTensorAsPyObj(ort_value, &dtm, nullptr));
+          }
+          ++pos;
+        }
+        return result;
+      });
 }
 
 }  // namespace python
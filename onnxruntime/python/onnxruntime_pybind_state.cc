@@ -61,6 +61,8 @@ const OrtDevice::DeviceType OrtDevice::GPU;
 
 #include <iterator>
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
 namespace onnxruntime {
 namespace python {
@@ -166,6 +168,43 @@ void AsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtS
   }
 }
 
+// One request of run_batch. The requests are converted with the GIL held and run without it.
+struct BatchRequest {
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<const char*> feed_names_raw;
+  std::vector<const OrtValue*> feeds_raw;
+  std::vector<OrtValue*> fetches_raw;  // allocated by the run, released by the destructor
+  std::string error;
+
+  // counts the requests that haven't completed
+  struct Completion {
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t num_pending{0};
+  }* completion{nullptr};
+
+  ~BatchRequest() {
+    for (OrtValue* fetch : fetches_raw) {
+      delete fetch;
+    }
+  }
+};
+
+void BatchRequestCallback(void* user_data, OrtValue** /*outputs*/, size_t /*num_outputs*/, OrtStatusPtr ort_status) {
+  auto* request = reinterpret_cast<BatchRequest*>(user_data);
+  Ort::Status status(ort_status);
+  if (!status.IsOK()) {
+    request->error = status.GetErrorMessage();
+  }
+
+  auto* completion = request->completion;
+  std::lock_guard<std::mutex> lock(completion->mutex);
+  if (--completion->num_pending == 0) {
+    completion->done.notify_all();
+  }
+}
+
 void AppendLoraParametersAsInputs(const RunOptions& run_options,
                                   size_t total_entries,
                                   NameMLValMap& feeds) {
@@ -1547,7 +1586,8 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
 
   py::enum_<ExecutionMode>(m, "ExecutionMode")
       .value("ORT_SEQUENTIAL", ExecutionMode::ORT_SEQUENTIAL)
-      .value("ORT_PARALLEL", ExecutionMode::ORT_PARALLEL);
+      .value("ORT_PARALLEL", ExecutionMode::ORT_PARALLEL)
+      .value("ORT_PARALLEL_WORK_STEALING", ExecutionMode::ORT_PARALLEL_WORK_STEALING);
 
   py::enum_<ExecutionOrder>(m, "ExecutionOrder")
       .value("DEFAULT", ExecutionOrder::DEFAULT)
@@ -1608,6 +1648,14 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
             ort_arena_cfg->initial_growth_chunk_size_bytes = kvp.second.cast<int>();
           } else if (key == "max_power_of_two_extend_bytes") {
             ort_arena_cfg->max_power_of_two_extend_bytes = kvp.second.cast<int>();
+          } else if (key == "thread_cache_max_bytes") {
+            ort_arena_cfg->thread_cache_max_bytes = kvp.second.cast<int64_t>();
+          } else if (key == "idle_shrink_interval_ms") {
+            ort_arena_cfg->idle_shrink_interval_ms = kvp.second.cast<int64_t>();
+          } else if (key == "use_huge_pages") {
+            ort_arena_cfg->use_huge_pages = kvp.second.cast<int>();
+          } else if (key == "cross_stream_reuse") {
+            ort_arena_cfg->cross_stream_reuse = kvp.second.cast<int>();
           } else {
             ORT_THROW("Invalid OrtArenaCfg option: ", key);
           }
@@ -1619,7 +1667,11 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
       .def_readwrite("initial_chunk_size_bytes", &OrtArenaCfg::initial_chunk_size_bytes)
       .def_readwrite("max_dead_bytes_per_chunk", &OrtArenaCfg::max_dead_bytes_per_chunk)
       .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes)
-      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes);
+      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes)
+      .def_readwrite("thread_cache_max_bytes", &OrtArenaCfg::thread_cache_max_bytes)
+      .def_readwrite("idle_shrink_interval_ms", &OrtArenaCfg::idle_shrink_interval_ms)
+      .def_readwrite("use_huge_pages", &OrtArenaCfg::use_huge_pages)
+      .def_readwrite("cross_stream_reuse", &OrtArenaCfg::cross_stream_reuse);
 
   py::class_<OrtMemoryInfo> ort_memory_info_binding(m, "OrtMemoryInfo");
   ort_memory_info_binding.def(py::init([](const char* name, OrtAllocatorType type, int id, OrtMemType mem_type) {
@@ -2151,6 +2203,120 @@ including arg name, arg type (contains both type and shape).)pbdoc")
              }
              OrtPybindThrowIfError(status);
            })
+      // Runs a list of requests, each a dictionary of feeds, and returns the list of their outputs.
+      // The GIL is only held to wrap the feeds, without copying numeric numpy arrays, and to wrap the outputs.
+      // The requests run concurrently on the intra-op thread pool, or one after the other if it has a single thread.
+      .def("run_batch",
+           [](PyInferenceSession* sess, const std::vector<std::string>& output_names,
+              const std::vector<std::map<std::string, py::object>>& pyfeeds_list, RunOptions* run_options = nullptr)
+               -> py::list {
+             if (run_options != nullptr && !run_options->active_adapters.empty()) {
+               LOGS(*sess->GetSessionHandle()->GetLogger(), WARNING)
+                   << "run_batch has active adapters specified, but won't have an effect";
+             }
+
+             auto px = sess->GetSessionHandle()->GetModelInputs();
+             if (!px.first.IsOK() || !px.second) {
+               throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+             }
+
+             std::vector<const char*> fetch_names_raw;
+             fetch_names_raw.reserve(output_names.size());
+             for (const auto& output_name : output_names) {
+               fetch_names_raw.push_back(output_name.c_str());
+             }
+
+             BatchRequest::Completion completion;
+             std::vector<BatchRequest> requests(pyfeeds_list.size());
+             for (size_t i = 0; i < pyfeeds_list.size(); ++i) {
+               auto& request = requests[i];
+               request.completion = &completion;
+               request.feed_names.reserve(pyfeeds_list[i].size());
+               request.feeds.reserve(pyfeeds_list[i].size());
+               for (const auto& feed : pyfeeds_list[i]) {
+                 if (!feed.second.is(py::none())) {
+                   OrtValue ml_value;
+                   CreateGenericMLValue(px.second, GetAllocator(), feed.first, feed.second, &ml_value);
+                   ThrowIfPyErrOccured();
+                   request.feed_names.push_back(feed.first);
+                   request.feeds.push_back(std::move(ml_value));
+                 }
+               }
+
+               for (size_t j = 0; j < request.feeds.size(); ++j) {
+                 request.feed_names_raw.push_back(request.feed_names[j].c_str());
+                 request.feeds_raw.push_back(&request.feeds[j]);
+               }
+               request.fetches_raw.resize(output_names.size(), nullptr);
+             }
+
+             {
+               // release GIL while the requests run
+               py::gil_scoped_release release;
+               RunOptions default_run_options;
+               const RunOptions* options = run_options != nullptr ? run_options : &default_run_options;
+               InferenceSession* session = sess->GetSessionHandle();
+
+               size_t num_scheduled = 0;
+               for (auto& request : requests) {
+                 {
+                   std::lock_guard<std::mutex> lock(completion.mutex);
+                   ++completion.num_pending;
+                 }
+
+                 common::Status status = session->RunAsync(options, request.feed_names_raw, request.feeds_raw,
+                                                           fetch_names_raw, request.fetches_raw,
+                                                           BatchRequestCallback, &request);
+                 if (!status.IsOK()) {
+                   // not enough threads to run asynchronously, run the remaining requests on this thread
+                   {
+                     std::lock_guard<std::mutex> lock(completion.mutex);
+                     --completion.num_pending;
+                   }
+                   break;
+                 }
+                 ++num_scheduled;
+               }
+
+               for (size_t i = num_scheduled; i < requests.size(); ++i) {
+                 auto& request = requests[i];
+                 common::Status status = session->Run(*options, request.feed_names_raw, request.feeds_raw,
+                                                       fetch_names_raw, request.fetches_raw);
+                 if (!status.IsOK()) {
+                   request.error = status.ErrorMessage();
+                 }
+               }
+
+               std::unique_lock<std::mutex> lock(completion.mutex);
+               completion.done.wait(lock, [&completion]() { return completion.num_pending == 0; });
+             }
+
+             py::list results;
+             for (const auto& request : requests) {
+               if (!request.error.empty()) {
+                 throw std::runtime_error("Error in run_batch: " + request.error);
+               }
+
+               py::list result;
+               size_t pos = 0;
+               for (const OrtValue* fet : request.fetches_raw) {
+                 if (fet != nullptr && fet->IsAllocated()) {
+                   if (fet->IsTensor()) {
+                     result.append(AddTensorAsPyObj(*fet, nullptr, nullptr));
+                   } else if (fet->IsSparseTensor()) {
+                     result.append(GetPyObjectFromSparseTensor(pos, *fet, nullptr));
+                   } else {
+                     result.append(AddNonTensorAsPyObj(*fet, nullptr, nullptr));
+                   }
+                 } else {  // Send back None because the corresponding OrtValue was empty
+                   result.append(py::none());
+                 }
+                 ++pos;
+               }
+               results.append(result);
+             }
+             return results;
+           })
       /// This method accepts a dictionary of feeds (name -> OrtValue) and the list of output_names
       /// and returns a list of python objects representing OrtValues. Each name may represent either
       /// a Tensor, SparseTensor or a TensorSequence.
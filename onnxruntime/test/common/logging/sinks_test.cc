@@ -3,6 +3,7 @@
 #include "core/common/common.h"
 #include "core/common/logging/capture.h"
 #include "core/common/logging/logging.h"
+#include "core/common/logging/sinks/async_sink.h"
 #include "core/common/logging/sinks/cerr_sink.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/logging/sinks/composite_sink.h"
@@ -222,3 +223,40 @@ TEST(LoggingTests, TestGetRemoveSingleSink) {
   EXPECT_EQ(removed_sink.get(), single_mock_sink);  // Check it's the same sink
   EXPECT_FALSE(sink.HasOnlyOneSink());              // Should be empty now
 }
+
+/// <summary>
+/// Tests that the async sink sends the messages of all the threads, and sends errors right away.
+/// </summary>
+TEST(LoggingTests, TestAsyncSink) {
+  const std::string logid{"TestAsyncSink"};
+  const Severity min_log_level = Severity::kINFO;
+  constexpr int num_threads = 4;
+  constexpr int num_messages = 100;
+
+  MockSink* mock_sink = new MockSink();
+  auto* sink = new AsyncSink(std::unique_ptr<ISink>{mock_sink});
+  LoggingManager manager{std::unique_ptr<ISink>(sink), min_log_level, false, InstanceType::Temporal};
+  auto logger = manager.CreateLogger(logid);
+
+  EXPECT_CALL(*mock_sink, SendImpl(testing::_, testing::_, testing::_)).Times(num_threads * num_messages + 1);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&logger]() {
+      for (int j = 0; j < num_messages; ++j) {
+        LOGS(*logger, INFO) << "Info " << j;
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  LOGS(*logger, ERROR) << "Error";
+  testing::Mock::VerifyAndClearExpectations(mock_sink);
+
+  // the rest is sent when the sink is destroyed
+  EXPECT_CALL(*mock_sink, SendImpl(testing::_, testing::_, testing::_)).Times(1);
+  LOGS(*logger, INFO) << "Info";
+}
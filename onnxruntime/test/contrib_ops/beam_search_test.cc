@@ -1,14 +1,20 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <fstream>
 #include <memory>
+#include <string>
 #include <vector>
 #include "gtest/gtest.h"
 #include <gsl/gsl>
+#include "core/graph/onnx_protobuf.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/contrib_ops/tiny_gpt_test_helper.h"
 #include "test/providers/model_tester.h"
+#include "test/providers/provider_test_utils.h"
 #include "test/util/include/current_test_name.h"
+#include "test/util/include/default_providers.h"
 
 #ifdef USE_CUDA
 #include "core/providers/cuda/cuda_provider_options.h"
@@ -107,6 +113,76 @@ TEST(BeamSearchTest, GptBeamSearchFp32) {
   ASSERT_TRUE(std::equal(expected_output.cbegin(), expected_output.cend(), result_span.begin(), result_span.end()));
 }
 
+// The prompt is run in chunks of 5 tokens on CPU, and the generated sequences are the same as in one run.
+TEST(BeamSearchTest, GptBeamSearchFp32WithPrefillChunks) {
+  std::vector<int64_t> input_ids_shape{3, 12};
+  std::vector<int32_t> input_ids{
+      0, 0, 0, 0, 0, 52, 195, 731, 321, 301, 734, 620,
+      41, 554, 74, 622, 206, 222, 75, 223, 221, 198, 224, 572,
+      0, 0, 0, 52, 328, 219, 328, 206, 288, 227, 896, 328};
+
+  std::vector<int64_t> parameter_shape{1};
+  std::vector<int32_t> max_length{20};
+  std::vector<int32_t> min_length{1};
+  std::vector<int32_t> num_beams{4};
+  std::vector<int32_t> num_return_sequences{1};
+  std::vector<float> length_penalty{1.0f};
+  std::vector<float> repetition_penalty{1.0f};
+
+  std::vector<int64_t> expected_output_shape{input_ids_shape[0], num_return_sequences[0], max_length[0]};
+  std::vector<int32_t> expected_output{
+      0, 0, 0, 0, 0, 52, 195, 731, 321, 301, 734, 620, 131, 131, 131, 181, 638, 638, 638, 638,
+      41, 554, 74, 622, 206, 222, 75, 223, 221, 198, 224, 572, 292, 292, 292, 292, 292, 292, 292, 292,
+      0, 0, 0, 52, 328, 219, 328, 206, 288, 227, 896, 328, 328, 669, 669, 669, 669, 669, 669, 669};
+
+  ONNX_NAMESPACE::ModelProto model_proto;
+  {
+    std::ifstream model_file("testdata/transformers/tiny_gpt2_beamsearch.onnx", std::ios::binary);
+    ASSERT_TRUE(model_proto.ParseFromIstream(&model_file));
+  }
+  for (auto& node : *model_proto.mutable_graph()->mutable_node()) {
+    if (node.op_type() == "BeamSearch") {
+      auto* attribute = node.add_attribute();
+      attribute->set_name("prefill_chunk_size");
+      attribute->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_INT);
+      attribute->set_i(5);
+    }
+  }
+  std::string model_data;
+  ASSERT_TRUE(model_proto.SerializeToString(&model_data));
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  std::vector<Ort::Value> ort_inputs;
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, input_ids.data(), input_ids.size(), input_ids_shape.data(), input_ids_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, max_length.data(), max_length.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, min_length.data(), min_length.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, num_beams.data(), num_beams.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, num_return_sequences.data(), num_return_sequences.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, length_penalty.data(), length_penalty.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, repetition_penalty.data(), repetition_penalty.size(), parameter_shape.data(), parameter_shape.size()));
+  const char* input_names[] = {"input_ids", "max_length", "min_length", "num_beams", "num_return_sequences",
+                               "length_penalty", "repetition_penalty"};
+  const char* const output_names[] = {"sequences"};
+
+  Ort::SessionOptions session_options;
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), session_options);
+  auto ort_outputs = session.Run(Ort::RunOptions{}, input_names, ort_inputs.data(), ort_inputs.size(),
+                                 output_names, 1);
+
+  ASSERT_EQ(ort_outputs.size(), 1U);
+  const auto& sequences = ort_outputs[0];
+  ASSERT_EQ(expected_output_shape, sequences.GetTensorTypeAndShapeInfo().GetShape());
+  auto result_span = gsl::make_span(sequences.GetTensorData<int32_t>(), expected_output.size());
+  ASSERT_TRUE(std::equal(expected_output.cbegin(), expected_output.cend(), result_span.begin(), result_span.end()));
+}
+
 TEST(BeamSearchTest, GptBeamSearchFp16) {
   std::vector<int64_t> input_ids_shape{3, 12};
   std::vector<int32_t> input_ids{
@@ -390,6 +466,54 @@ TEST(BeamSearchTest, GptBeamSearchFp16_VocabPadded) {
   }
 }
 
+// Runs BeamSearch with the tiny GPT decoder on CPU, with left padded prompts of several batch entries. The prompt
+// is run once per batch entry and its past state is expanded to the beams. Afterwards the beams are reordered in some
+// steps, and keep their order in others, where the past state is not copied.
+TEST(BeamSearchTest, GptBeamSearchTinyGptLeftPadded) {
+  constexpr int batch_size = 3;
+  constexpr int sequence_length = 4;
+  constexpr int num_beams = 2;
+  constexpr int max_length = 12;
+  // eos_token_id 30 is never among the best tokens
+  constexpr int eos_token_id = 30;
+  constexpr int pad_token_id = 0;
+  const TinyGptOptions options;
+  const std::vector<int32_t> input_ids{
+      0, 0, 3, 5,
+      0, 7, 1, 2,
+      4, 9, 6, 1};
+  const std::vector<int32_t> attention_mask{
+      0, 0, 1, 1,
+      0, 1, 1, 1,
+      1, 1, 1, 1};
+
+  std::vector<int32_t> expected_sequences;
+  std::vector<float> expected_scores;
+  TinyGptBeamSearch(options, input_ids, batch_size, num_beams, max_length, expected_sequences, expected_scores);
+
+  OpTester test("BeamSearch", 1, kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", eos_token_id);
+  test.AddAttribute<int64_t>("pad_token_id", pad_token_id);
+  test.AddAttribute("decoder", CreateTinyGptSubgraph(options));
+  test.AddInput<int32_t>("input_ids", {batch_size, sequence_length}, input_ids);
+  test.AddInput<int32_t>("max_length", {1}, {max_length});
+  test.AddInput<int32_t>("min_length", {1}, {1});
+  test.AddInput<int32_t>("num_beams", {1}, {num_beams});
+  test.AddInput<int32_t>("num_return_sequences", {1}, {num_beams});
+  test.AddInput<float>("length_penalty", {1}, {1.0f});
+  test.AddInput<float>("repetition_penalty", {1}, {1.0f});
+  test.AddOptionalInputEdge<int32_t>();  // vocab_mask
+  test.AddOptionalInputEdge<int32_t>();  // prefix_vocab_mask
+  test.AddInput<int32_t>("attention_mask", {batch_size, sequence_length}, attention_mask);
+  test.AddOutput<int32_t>("sequences", {batch_size, num_beams, max_length}, expected_sequences);
+  test.AddOutput<float>("sequences_scores", {batch_size, num_beams}, expected_scores);
+  test.SetOutputTolerance(1e-4f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 TEST(BeamSearchTest, DummyT5) {
 #if defined(USE_CUDA) && defined(USE_DML)
   SKIP_CUDA_TEST_WITH_DML;
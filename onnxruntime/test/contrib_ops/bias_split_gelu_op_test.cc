@@ -74,9 +74,7 @@ std::vector<float> GetExpectedResult(const std::vector<float>& input_data,
 }
 }  // namespace bias_split_gelu_test
 
-#if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DML)
-
-static void RunBiasSplitGeluGpuTest(const std::vector<float>& input_data,
+static void RunBiasSplitGeluOpTest(const std::vector<float>& input_data,
                                     const std::vector<float>& bias_data,
                                     const std::vector<float>& output_data,
                                     const std::vector<int64_t>& input_dims,
@@ -87,8 +85,9 @@ static void RunBiasSplitGeluGpuTest(const std::vector<float>& input_data,
   bool enable_cuda = HasCudaEnvironment(min_cuda_architecture);
   bool enable_rocm = (nullptr != DefaultRocmExecutionProvider().get());
   bool enable_dml = (nullptr != DefaultDmlExecutionProvider().get());
+  bool enable_cpu = !use_float16;
 
-  if (!enable_cuda && !enable_rocm && !enable_dml) {
+  if (!enable_cuda && !enable_rocm && !enable_dml && !enable_cpu) {
     return;
   }
 
@@ -114,6 +113,9 @@ static void RunBiasSplitGeluGpuTest(const std::vector<float>& input_data,
   if (enable_dml) {
     execution_providers.push_back(DefaultDmlExecutionProvider());
   }
+  if (enable_cpu) {
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+  }
 
   tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
 }
@@ -128,7 +130,7 @@ static void RunBiasSplitGeluTest(int64_t batch_size, int64_t sequence_length, in
   std::vector<float> bias_data = random.Gaussian<float>(bias_dims, 0.0f, 0.3f);
   std::vector<float> output_data = bias_split_gelu_test::GetExpectedResult(input_data, input_dims, bias_data);
 
-  RunBiasSplitGeluGpuTest(input_data, bias_data, output_data, input_dims, bias_dims, output_dims);
+  RunBiasSplitGeluOpTest(input_data, bias_data, output_data, input_dims, bias_dims, output_dims);
 }
 
 TEST(BiasSplitGeluTest, BiasSplitGeluTest_HiddenSize_2560) {
@@ -166,7 +168,5 @@ TEST(BiasSplitGeluTest, BiasSplitGeluTest_HiddenSize_12288) {
   RunBiasSplitGeluTest(batch_size, sequence_length, hidden_size);
 }
 
-#endif
-
 }  // namespace test
 }  // namespace onnxruntime
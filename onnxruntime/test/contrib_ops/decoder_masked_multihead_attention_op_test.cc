@@ -928,6 +928,75 @@ TEST(DecoderMaskedMultiHeadAttentionTest, cpu_cross_attn_fp32) {
   TestDecoderMaskedMultiHeadAttention<float>(/* is_cross_attn = */ true, /* use_cuda = */ false);
 }
 
+// Cross-attention key and value of shape (B, N, L, H) shared by the beams of each batch entry, as fed by beam search
+TEST(DecoderMaskedMultiHeadAttentionTest, cpu_cross_attn_kv_shared_by_beams_fp32) {
+  int batch_size = 2;
+  int beam_width = 3;
+  int batch_beam_size = batch_size * beam_width;
+  int kv_sequence_length = 5;
+  int head_size = 4;
+  int num_heads = 3;
+  int hidden_size = head_size * num_heads;
+  int max_sequence_length = 8;
+
+  OpTester tester("DecoderMaskedMultiHeadAttention", 1, onnxruntime::kMSDomain);
+  FixedPatternValueGenerator generator{};
+  RandomValueGenerator random{321};
+
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(num_heads));
+  tester.AddAttribute<int64_t>("output_qk", 1);
+
+  const std::vector<int64_t> kv_dims = {batch_size, num_heads, kv_sequence_length, head_size};
+  auto query = random.Gaussian<float>(std::vector<int64_t>{batch_beam_size, 1, hidden_size}, 0.0f, 1.0f);
+  auto key = random.Gaussian<float>(kv_dims, 0.0f, 1.0f);
+  auto value = random.Gaussian<float>(kv_dims, 0.0f, 1.0f);
+  auto entry_mask = generator.Discrete<int32_t>(std::vector<int64_t>{batch_size, kv_sequence_length},
+                                                AsSpan({0, 1}));
+
+  // the reference reads the key, value and mask expanded to the beams
+  const size_t kv_entry_size = static_cast<size_t>(num_heads) * kv_sequence_length * head_size;
+  std::vector<float> expanded_key, expanded_value;
+  std::vector<int32_t> mask_index;
+  for (int b = 0; b < batch_size; ++b) {
+    for (int beam = 0; beam < beam_width; ++beam) {
+      expanded_key.insert(expanded_key.end(), key.begin() + b * kv_entry_size, key.begin() + (b + 1) * kv_entry_size);
+      expanded_value.insert(expanded_value.end(), value.begin() + b * kv_entry_size,
+                            value.begin() + (b + 1) * kv_entry_size);
+      mask_index.insert(mask_index.end(), entry_mask.begin() + b * kv_sequence_length,
+                        entry_mask.begin() + (b + 1) * kv_sequence_length);
+    }
+  }
+
+  tester.AddInput<float>("query", {batch_beam_size, 1, hidden_size}, query);
+  tester.AddInput<float>("key", kv_dims, key);
+  tester.AddInput<float>("value", kv_dims, value);
+  tester.AddInput<int32_t>("mask_index", {batch_beam_size, kv_sequence_length}, mask_index);
+  tester.AddOptionalInputEdge<float>();    // attention_bias
+  tester.AddOptionalInputEdge<float>();    // past_key
+  tester.AddOptionalInputEdge<float>();    // past_value
+  tester.AddOptionalInputEdge<int32_t>();  // past_sequence_length
+  tester.AddInput<int32_t>("beam_width", {1}, {beam_width});
+  tester.AddInput<int32_t>("cache_indirection", {batch_size, beam_width, max_sequence_length},
+                           std::vector<int32_t>(static_cast<size_t>(batch_beam_size) * max_sequence_length, 0));
+
+  std::vector<float> empty_attention_bias;
+  auto output_qk = CalculateOutputQK(query, expanded_key, mask_index, empty_attention_bias, batch_beam_size, num_heads,
+                                     kv_sequence_length, kv_sequence_length, head_size);
+  auto softmax = Softmax_QK_Transpose<float>(output_qk.data(), batch_beam_size, num_heads, 1, kv_sequence_length);
+  auto output = CalculateOutput<float>(softmax, expanded_value, batch_beam_size, num_heads,
+                                       kv_sequence_length, kv_sequence_length, head_size);
+
+  tester.AddOutput<float>("output", {batch_beam_size, 1, hidden_size}, output);
+  tester.AddOptionalOutputEdge<float>();  // optional present_key
+  tester.AddOptionalOutputEdge<float>();  // optional present_value
+  tester.AddOutput<float>("qk", {batch_beam_size, num_heads, 1, kv_sequence_length}, output_qk);
+  tester.SetOutputTolerance(0.0001f, 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 TEST(DecoderMaskedMultiHeadAttentionTest, cpu_self_attn_fp32) {
   TestDecoderMaskedMultiHeadAttention<float>(/* is_cross_attn = */ false, /* use_cuda = */ false);
 }
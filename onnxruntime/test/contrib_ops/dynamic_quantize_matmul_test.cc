@@ -4,6 +4,7 @@
 #include "core/common/span_utils.h"
 #include "core/framework/tensor.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/framework/test_utils.h"
 #include "test/optimizer/graph_transform_test_builder.h"
@@ -280,5 +281,74 @@ TEST(DynamicQuantizeMatMul, B_PerColumn_ND) {
   test_case({15, 14, 13}, {15, 13, 27}, {15, 1, 27});
 }
 
+static void TestDynamicQuantizeMatMulPerRow(bool is_matrix_b_constant, bool per_column, bool has_bias) {
+  RandomValueGenerator random{1668426375};
+
+  constexpr int64_t M = 6;
+  constexpr int64_t N = 37;
+  constexpr int64_t K = 67;
+  std::vector<int64_t> A_dims{2, M / 2, K};
+  std::vector<int64_t> B_dims{K, N};
+  std::vector<int64_t> Y_dims{2, M / 2, N};
+
+  // give every row a different range so that a single scale for the tensor would lose precision
+  std::vector<float> A_data = random.Uniform<float>(A_dims, -1.0f, 1.0f);
+  for (int64_t m = 0; m < M; m++) {
+    const float row_range = std::pow(4.0f, static_cast<float>(m - 3));
+    std::for_each(A_data.begin() + m * K, A_data.begin() + (m + 1) * K, [row_range](float& v) { v *= row_range; });
+  }
+
+  std::vector<int8_t> B_data = random.Uniform<int8_t>(B_dims, -64, 63);
+  const int64_t b_scale_size = per_column ? N : 1;
+  std::vector<float> B_scale = random.Uniform<float>(AsSpan({b_scale_size}), 0.01f, 0.1f);
+  std::vector<float> Bias = random.Uniform<float>(AsSpan({N}), -0.1f, 0.1f);
+
+  // reference: quantize each row of A symmetrically to [-127, 127]
+  std::vector<float> Y_data(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    float abs_max = 0.0f;
+    for (int64_t k = 0; k < K; k++) {
+      abs_max = std::max(abs_max, std::fabs(A_data[m * K + k]));
+    }
+    const float a_scale = abs_max / 127.0f;
+
+    for (int64_t n = 0; n < N; n++) {
+      int32_t sum = 0;
+      for (int64_t k = 0; k < K; k++) {
+        const int32_t a_quant = static_cast<int32_t>(std::nearbyint(A_data[m * K + k] / a_scale));
+        sum += a_quant * static_cast<int32_t>(B_data[k * N + n]);
+      }
+      Y_data[m * N + n] = static_cast<float>(sum) * a_scale * B_scale[per_column ? n : 0] + (has_bias ? Bias[n] : 0.0f);
+    }
+  }
+
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", A_dims, A_data);
+  test.AddInput<int8_t>("B", B_dims, B_data, is_matrix_b_constant);
+  test.AddInput<float>("b_scale", {b_scale_size}, B_scale);
+  test.AddOptionalInputEdge<int8_t>();
+  if (has_bias) {
+    test.AddInput<float>("bias", {N}, Bias);
+  } else {
+    test.AddOptionalInputEdge<float>();
+  }
+  test.AddOutput<float>("Y", Y_dims, Y_data);
+  test.SetOutputAbsErr("Y", 1e-3f);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsDynamicQuantizeMatMulPerRow, "1"));
+
+  test.Config(so)
+      .ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+}
+
+TEST(DynamicQuantizeMatMul, PerRow_test_S8) {
+  TestDynamicQuantizeMatMulPerRow(false /*is_matrix_b_constant*/, false /*per_column*/, false /*has_bias*/);
+  TestDynamicQuantizeMatMulPerRow(true /*is_matrix_b_constant*/, false /*per_column*/, true /*has_bias*/);
+  TestDynamicQuantizeMatMulPerRow(false /*is_matrix_b_constant*/, true /*per_column*/, true /*has_bias*/);
+  TestDynamicQuantizeMatMulPerRow(true /*is_matrix_b_constant*/, true /*per_column*/, false /*has_bias*/);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(FusedElementwiseTest, BroadcastChain) {
+  // Relu((x + b) * y) with b broadcast along the rows and y broadcast along the columns.
+  const std::vector<float> x = {1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f};
+  const std::vector<float> b = {0.5f, 1.0f, -1.5f};
+  const std::vector<float> y = {2.0f, -1.0f};
+
+  std::vector<float> expected;
+  for (size_t r = 0; r < 2; ++r) {
+    for (size_t c = 0; c < 3; ++c) {
+      expected.push_back(std::max((x[r * 3 + c] + b[c]) * y[r], 0.0f));
+    }
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Add", "Mul", "Relu"});
+  test.AddAttribute<std::vector<int64_t>>("lhs", {0, 3, 4});
+  test.AddAttribute<std::vector<int64_t>>("rhs", {1, 2, -1});
+  test.AddInput<float>("x", {2, 3}, x);
+  test.AddInput<float>("b", {3}, b);
+  test.AddInput<float>("y", {2, 1}, y);
+  test.AddOutput<float>("out", {2, 3}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(FusedElementwiseTest, ReusedRegisters) {
+  // x * Sigmoid(x) - s, reading the input register twice and a scalar operand.
+  const std::vector<float> x = {-3.0f, -1.0f, 0.0f, 0.5f, 2.0f, 4.0f};
+  const float s = 0.25f;
+
+  std::vector<float> expected;
+  for (float value : x) {
+    expected.push_back(value / (1.0f + std::exp(-value)) - s);
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Sigmoid", "Mul", "Sub"});
+  test.AddAttribute<std::vector<int64_t>>("lhs", {0, 0, 3});
+  test.AddAttribute<std::vector<int64_t>>("rhs", {-1, 2, 1});
+  test.AddInput<float>("x", {2, 3}, x);
+  test.AddInput<float>("s", {}, {s});
+  test.AddOutput<float>("out", {2, 3}, expected);
+  test.SetOutputTolerance(1e-5f);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(FusedElementwiseTest, MultipleBlocks) {
+  // Sqrt(Abs(x - b)) / c over several blocks, with b repeating along the flattened output.
+  constexpr int64_t rows = 5;
+  constexpr int64_t cols = 777;
+
+  std::vector<float> x(rows * cols);
+  std::vector<float> b(cols);
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(static_cast<int>(i % 23) - 11) * 0.75f;
+  }
+  for (size_t i = 0; i < b.size(); ++i) {
+    b[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+  const float c = 2.0f;
+
+  std::vector<float> expected(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    expected[i] = std::sqrt(std::fabs(x[i] - b[i % cols])) / c;
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Sub", "Abs", "Sqrt", "Div"});
+  test.AddAttribute<std::vector<int64_t>>("lhs", {0, 3, 4, 5});
+  test.AddAttribute<std::vector<int64_t>>("rhs", {1, -1, -1, 2});
+  test.AddInput<float>("x", {rows, cols}, x);
+  test.AddInput<float>("b", {1, cols}, b);
+  test.AddInput<float>("c", {1}, {c});
+  test.AddOutput<float>("out", {rows, cols}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(FusedFeatureTransformTest, ImputeScaleL2) {
+  // Imputer(-1 -> per feature values), Scaler(per feature), Normalizer(L2) on two rows of three features.
+  const std::vector<float> x = {-1.0f, 2.0f, 3.0f, 4.0f, -1.0f, -1.0f};
+  const std::vector<float> imputed = {10.0f, 20.0f, 30.0f};
+  const std::vector<float> offset = {1.0f, 0.0f, -1.0f};
+  const std::vector<float> scale = {0.5f, -1.0f, 2.0f};
+
+  std::vector<float> expected(x.size());
+  for (size_t r = 0; r < 2; ++r) {
+    float sum = 0.0f;
+    for (size_t c = 0; c < 3; ++c) {
+      float value = x[r * 3 + c] == -1.0f ? imputed[c] : x[r * 3 + c];
+      value = (value - offset[c]) * scale[c];
+      expected[r * 3 + c] = value;
+      sum += value * value;
+    }
+    for (size_t c = 0; c < 3; ++c) {
+      const float value = expected[r * 3 + c];
+      expected[r * 3 + c] = value < 0 ? -std::sqrt(value * value / sum) : std::sqrt(value * value / sum);
+    }
+  }
+
+  OpTester test("FusedFeatureTransform", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("imputed_values", imputed);
+  test.AddAttribute("replaced_value", -1.0f);
+  test.AddAttribute("offset", offset);
+  test.AddAttribute("scale", scale);
+  test.AddAttribute("norm", std::string("L2"));
+  test.AddInput<float>("X", {2, 3}, x);
+  test.AddOutput<float>("Y", {2, 3}, expected);
+  test.Run();
+}
+
+TEST(FusedFeatureTransformTest, ImputeNaNMax) {
+  // A single imputed value for NaN, no scaling, then each row divided by its maximum.
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+
+  OpTester test("FusedFeatureTransform", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("imputed_values", std::vector<float>{4.0f});
+  test.AddAttribute("replaced_value", nan);
+  test.AddAttribute("norm", std::string("MAX"));
+  test.AddInput<float>("X", {2, 4}, {nan, 2.0f, 1.0f, -8.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  test.AddOutput<float>("Y", {2, 4}, {1.0f, 0.5f, 0.25f, -2.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run();
+}
+
+TEST(FusedFeatureTransformTest, ScaleL1Vector) {
+  // A 1D input is a single row, scaled by one offset and scale and divided by its L1 norm.
+  OpTester test("FusedFeatureTransform", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("offset", std::vector<float>{1.0f});
+  test.AddAttribute("scale", std::vector<float>{2.0f});
+  test.AddAttribute("norm", std::string("L1"));
+  test.AddInput<float>("X", {4}, {2.0f, 0.0f, 3.0f, 1.0f});
+  test.AddOutput<float>("Y", {4}, {0.25f, -0.25f, 0.5f, 0.0f});
+  test.Run();
+}
+
+TEST(FusedFeatureTransformTest, InvalidScaleSize) {
+  OpTester test("FusedFeatureTransform", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("offset", std::vector<float>{1.0f, 2.0f});
+  test.AddAttribute("scale", std::vector<float>{2.0f, 3.0f});
+  test.AddInput<float>("X", {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  test.AddOutput<float>("Y", {2, 3}, {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Either both scale and offset can be of feature size (3) or 1");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -464,5 +464,70 @@ TEST(GatherBlockQuantizedOpTest, GatherAxis2) {
   Test_GatherAxis2_WithZeroPoints<Int4x2, MLFloat16, int64_t>();
 }
 
+// uint8 data packs the values along the last axis like MatMulNBits, with zero points packed the same way.
+template <typename T2, typename Tind>
+void Test_GatherPackedUInt8(int64_t bits, bool has_zero_points) {
+  constexpr int64_t rows = 3, K = 48, block_size = 16;
+  constexpr int64_t num_blocks = K / block_size;
+  const int64_t values_per_byte = 8 / bits;
+  const int64_t zero_points_per_row = (num_blocks * bits + 7) / 8;
+  const int32_t max_value = (1 << bits) - 1;
+
+  std::vector<uint8_t> data(rows * K / values_per_byte, 0);
+  std::vector<float> scales;
+  std::vector<uint8_t> zero_points(rows * zero_points_per_row, 0);
+  std::vector<std::vector<float>> dequantized(rows);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      scales.push_back(0.5f * static_cast<float>(r + b + 1));
+      const int32_t zp = has_zero_points ? static_cast<int32_t>((r * 5 + b * 3) % (max_value + 1)) : 1 << (bits - 1);
+      if (has_zero_points) {
+        const int64_t i = r * zero_points_per_row * values_per_byte + b;
+        zero_points[i / values_per_byte] |= static_cast<uint8_t>(zp << ((i % values_per_byte) * bits));
+      }
+
+      for (int64_t k = b * block_size; k < (b + 1) * block_size; ++k) {
+        const int32_t q = static_cast<int32_t>((r * 7 + k * 13) % (max_value + 1));
+        const int64_t i = r * K + k;
+        data[i / values_per_byte] |= static_cast<uint8_t>(q << ((i % values_per_byte) * bits));
+        dequantized[r].push_back(static_cast<float>(q - zp) * scales.back());
+      }
+    }
+  }
+
+  std::vector<int> indices = {2, 0, -1};
+  std::vector<float> output;
+  for (int index : indices) {
+    const auto& row = dequantized[index < 0 ? index + rows : index];
+    output.insert(output.end(), row.begin(), row.end());
+  }
+
+  OpTester test("GatherBlockQuantized", 1, kMSDomain);
+  test.AddAttribute<int64_t>("gather_axis", 0);
+  test.AddAttribute<int64_t>("quantize_axis", 1);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddAttribute<int64_t>("bits", bits);
+  test.AddInput<uint8_t>("data", {rows, K / values_per_byte}, data, true);
+  test.AddInput<Tind>("indices", {3}, ToType<Tind>(indices));
+  test.AddInput<T2>("scales", {rows, num_blocks}, ToType<T2>(scales), true);
+  if (has_zero_points) {
+    test.AddInput<uint8_t>("zero_points", {rows, zero_points_per_row}, zero_points, true);
+  }
+  test.AddOutput<T2>("output", {3, K}, ToType<T2>(output));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> eps;
+  eps.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &eps);
+}
+
+TEST(GatherBlockQuantizedOpTest, GatherPackedUInt8) {
+  for (int64_t bits : {4, 8}) {
+    for (bool has_zero_points : {false, true}) {
+      Test_GatherPackedUInt8<float, int32_t>(bits, has_zero_points);
+      Test_GatherPackedUInt8<MLFloat16, int64_t>(bits, has_zero_points);
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -7,6 +7,9 @@
 #include <gsl/gsl>
 #include "core/session/onnxruntime_cxx_api.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/contrib_ops/tiny_gpt_test_helper.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 
 #ifdef USE_CUDA
 #include "core/providers/cuda/cuda_provider_options.h"
@@ -17,6 +20,38 @@ extern std::unique_ptr<Ort::Env> ort_env;
 namespace onnxruntime {
 namespace test {
 
+namespace {
+
+// Runs GreedySearch with the tiny GPT decoder on CPU, and checks that the sequences are those of the decoder.
+// With a draft decoder, the tokens are generated with speculative decoding, which shall not change the sequences.
+void RunTinyGptGreedySearch(const std::vector<int32_t>& input_ids, int batch_size, int max_length, int eos_token_id,
+                            const TinyGptOptions* draft_options = nullptr, int num_speculative_tokens = 0) {
+  constexpr int pad_token_id = 0;
+  const TinyGptOptions options;
+  const int sequence_length = static_cast<int>(input_ids.size()) / batch_size;
+
+  OpTester test("GreedySearch", 1, kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", eos_token_id);
+  test.AddAttribute<int64_t>("pad_token_id", pad_token_id);
+  test.AddAttribute("decoder", CreateTinyGptSubgraph(options));
+  if (draft_options != nullptr) {
+    test.AddAttribute("draft_decoder", CreateTinyGptSubgraph(*draft_options));
+    test.AddAttribute<int64_t>("num_speculative_tokens", num_speculative_tokens);
+  }
+  test.AddInput<int32_t>("input_ids", {batch_size, sequence_length}, input_ids);
+  test.AddInput<int32_t>("max_length", {1}, {max_length});
+  test.AddInput<int32_t>("min_length", {1}, {1});
+  test.AddInput<float>("repetition_penalty", {1}, {1.0f});
+  test.AddOutput<int32_t>("sequences", {batch_size, max_length},
+                          TinyGptGreedySearch(options, input_ids, batch_size, max_length, eos_token_id, pad_token_id));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace
+
 TEST(GreedySearchTest, GptGreedySearchFp16_VocabPadded) {
   std::vector<int64_t> input_ids_shape{2, 4};
   std::vector<int32_t> input_ids{
@@ -183,5 +218,58 @@ TEST(GreedySearchTest, GptGreedySearchFp32) {
   }
 }
 
+TEST(GreedySearchTest, GptGreedySearchSequencesFinishAtDifferentSteps) {
+  // With eos 16, the first sequence finishes after 2 tokens and the last one after 4, while the others run
+  // to max_length. The decoder runs on fewer rows after each of them finishes.
+  const std::vector<int32_t> input_ids{
+      0, 0, 3, 5,
+      0, 7, 1, 2,
+      4, 9, 6, 1,
+      0, 0, 0, 2};
+  RunTinyGptGreedySearch(input_ids, 4, 12, 16);
+}
+
+// The tokens of these prompts are the sums of the tokens before them modulo 31, and eos_token_id 30 never comes up.
+const std::vector<int32_t> kSpeculativeInputIds{
+    0, 0, 3, 5,
+    0, 7, 1, 2,
+    4, 9, 6, 1};
+
+TEST(GreedySearchTest, GptSpeculativeDecodingSameDraftDecoder) {
+  // every draft token is accepted
+  const TinyGptOptions draft_options;
+  RunTinyGptGreedySearch(kSpeculativeInputIds, 3, 14, 30, &draft_options, 3);
+  RunTinyGptGreedySearch(kSpeculativeInputIds, 3, 14, 30, &draft_options, 1);
+}
+
+TEST(GreedySearchTest, GptSpeculativeDecodingRejectedDraftTokens) {
+  // The draft decoder agrees with the decoder until the sum of the tokens passes 80, after 5 tokens for the
+  // last prompt, and then some of its tokens are rejected and its past state is rolled back.
+  TinyGptOptions draft_options;
+  draft_options.sum_limit = 80;
+  RunTinyGptGreedySearch(kSpeculativeInputIds, 3, 14, 30, &draft_options, 4);
+  RunTinyGptGreedySearch(kSpeculativeInputIds, 3, 14, 30, &draft_options, 2);
+  RunTinyGptGreedySearch({4, 9, 6, 1}, 1, 14, 30, &draft_options, 3);
+}
+
+TEST(GreedySearchTest, GptSpeculativeDecodingMaxLength) {
+  // After the prompt run, the first round generates 4 tokens and the second one is cut to 1 draft token by
+  // max_length.
+  const TinyGptOptions same_draft_options;
+  RunTinyGptGreedySearch(kSpeculativeInputIds, 3, 11, 30, &same_draft_options, 3);
+  TinyGptOptions draft_options;
+  draft_options.sum_limit = 80;
+  RunTinyGptGreedySearch(kSpeculativeInputIds, 3, 11, 30, &draft_options, 3);
+  // the speculative window is longer than the tokens to generate
+  RunTinyGptGreedySearch(kSpeculativeInputIds, 3, 7, 30, &draft_options, 8);
+}
+
+TEST(GreedySearchTest, GptSpeculativeDecodingSequencesFinishAtDifferentSteps) {
+  // the first sequence meets eos_token_id 16 after 2 tokens, and is ignored when the draft tokens are verified
+  TinyGptOptions draft_options;
+  draft_options.sum_limit = 80;
+  RunTinyGptGreedySearch(kSpeculativeInputIds, 3, 14, 16, &draft_options, 3);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,474 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "contrib_ops/cpu/bert/attention_common.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/scoped_env_vars.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+constexpr int kNumHeads = 4;
+constexpr int kKvNumHeads = 2;
+constexpr int kHeadSize = 8;
+constexpr int kBlockSize = 4;
+constexpr int kNumBlocks = 8;
+
+std::vector<float> CreateData(size_t size, float seed) {
+  std::vector<float> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = std::sin(seed + 0.37f * static_cast<float>(i));
+  }
+  return data;
+}
+
+// Runs GroupQueryAttention with a paged kv cache and checks it against a naive attention over the logical cache.
+// `past_lengths` holds the number of cached tokens of each sequence before the new ones.
+void RunPagedKVCacheTest(const std::vector<int32_t>& past_lengths, int sequence_length,
+                         const std::vector<int32_t>& block_table, int max_blocks_per_sequence,
+                         const std::string& expected_failure = "") {
+  const int batch_size = static_cast<int>(past_lengths.size());
+  const int hidden_size = kNumHeads * kHeadSize;
+  const int kv_hidden_size = kKvNumHeads * kHeadSize;
+  const size_t block_stride = static_cast<size_t>(kKvNumHeads) * kBlockSize * kHeadSize;
+
+  const auto query = CreateData(static_cast<size_t>(batch_size) * sequence_length * hidden_size, 0.1f);
+  const auto key = CreateData(static_cast<size_t>(batch_size) * sequence_length * kv_hidden_size, 1.3f);
+  const auto value = CreateData(static_cast<size_t>(batch_size) * sequence_length * kv_hidden_size, 2.9f);
+  const auto past_key = CreateData(kNumBlocks * block_stride, 4.1f);
+  const auto past_value = CreateData(kNumBlocks * block_stride, 5.7f);
+
+  auto pool_offset = [&](int b, int kv_head, int position) {
+    const int block = block_table[b * max_blocks_per_sequence + position / kBlockSize];
+    return block * block_stride + (static_cast<size_t>(kv_head) * kBlockSize + position % kBlockSize) * kHeadSize;
+  };
+
+  std::vector<int32_t> seqlens_k(batch_size);
+  int32_t total_sequence_length = 0;
+  for (int b = 0; b < batch_size; ++b) {
+    seqlens_k[b] = past_lengths[b] + sequence_length - 1;
+    total_sequence_length = std::max(total_sequence_length, seqlens_k[b] + 1);
+  }
+
+  std::vector<float> present_key = past_key;
+  std::vector<float> present_value = past_value;
+  std::vector<float> output(query.size());
+  if (expected_failure.empty()) {
+    for (int b = 0; b < batch_size; ++b) {
+      for (int s = 0; s < sequence_length; ++s) {
+        for (int kv_head = 0; kv_head < kKvNumHeads; ++kv_head) {
+          const size_t src = (static_cast<size_t>(b) * sequence_length + s) * kv_hidden_size + kv_head * kHeadSize;
+          const size_t dst = pool_offset(b, kv_head, past_lengths[b] + s);
+          std::copy_n(key.begin() + src, kHeadSize, present_key.begin() + dst);
+          std::copy_n(value.begin() + src, kHeadSize, present_value.begin() + dst);
+        }
+      }
+    }
+
+    const float scale = 1.0f / std::sqrt(static_cast<float>(kHeadSize));
+    for (int b = 0; b < batch_size; ++b) {
+      for (int s = 0; s < sequence_length; ++s) {
+        const int causal_length = past_lengths[b] + s + 1;
+        for (int head = 0; head < kNumHeads; ++head) {
+          const int kv_head = head / (kNumHeads / kKvNumHeads);
+          const float* q = query.data() + (static_cast<size_t>(b) * sequence_length + s) * hidden_size +
+                           head * kHeadSize;
+
+          std::vector<float> scores(causal_length);
+          float max_score = -INFINITY;
+          for (int t = 0; t < causal_length; ++t) {
+            const float* k = present_key.data() + pool_offset(b, kv_head, t);
+            float dot = 0.0f;
+            for (int d = 0; d < kHeadSize; ++d) {
+              dot += q[d] * k[d];
+            }
+            scores[t] = dot * scale;
+            max_score = std::max(max_score, scores[t]);
+          }
+
+          float sum = 0.0f;
+          for (auto& score : scores) {
+            score = std::exp(score - max_score);
+            sum += score;
+          }
+
+          float* out = output.data() + (static_cast<size_t>(b) * sequence_length + s) * hidden_size +
+                       head * kHeadSize;
+          for (int t = 0; t < causal_length; ++t) {
+            const float* v = present_value.data() + pool_offset(b, kv_head, t);
+            for (int d = 0; d < kHeadSize; ++d) {
+              out[d] += scores[t] / sum * v[d];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  const std::vector<int64_t> pool_dims{kNumBlocks, kKvNumHeads, kBlockSize, kHeadSize};
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", kNumHeads);
+  tester.AddAttribute<int64_t>("kv_num_heads", kKvNumHeads);
+  tester.AddInput<float>("query", {batch_size, sequence_length, hidden_size}, query);
+  tester.AddInput<float>("key", {batch_size, sequence_length, kv_hidden_size}, key);
+  tester.AddInput<float>("value", {batch_size, sequence_length, kv_hidden_size}, value);
+  tester.AddInput<float>("past_key", pool_dims, past_key);
+  tester.AddInput<float>("past_value", pool_dims, past_value);
+  tester.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<int32_t>("block_table", {batch_size, max_blocks_per_sequence}, block_table);
+  tester.AddOutput<float>("output", {batch_size, sequence_length, hidden_size}, output, false, 0, 1e-5f);
+  tester.AddOutput<float>("present_key", pool_dims, present_key);
+  tester.AddOutput<float>("present_value", pool_dims, present_value);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(expected_failure.empty() ? OpTester::ExpectResult::kExpectSuccess
+                                      : OpTester::ExpectResult::kExpectFailure,
+             expected_failure, {}, nullptr, &execution_providers);
+}
+
+// Runs GroupQueryAttention with a float kv cache, with the tiled MLAS kernel and with the attention probs, and checks
+// both against a naive attention. `past_lengths` holds the number of cached tokens of each sequence in a past buffer
+// of past_buffer_length tokens, which makes the present buffer longer than the total sequence when it is the
+// longest. With packed_qkv, Q, K and V are packed in the query input.
+void RunFloatKVCacheTest(const std::vector<int32_t>& past_lengths, int sequence_length, int past_buffer_length,
+                         bool packed_qkv, int local_window_size) {
+  const int batch_size = static_cast<int>(past_lengths.size());
+  const int hidden_size = kNumHeads * kHeadSize;
+  const int kv_hidden_size = kKvNumHeads * kHeadSize;
+  const int packed_hidden_size = hidden_size + 2 * kv_hidden_size;
+  const size_t token_count = static_cast<size_t>(batch_size) * sequence_length;
+
+  const auto packed_qkv_data = CreateData(token_count * packed_hidden_size, 0.1f);
+  std::vector<float> query(token_count * hidden_size);
+  std::vector<float> key(token_count * kv_hidden_size);
+  std::vector<float> value(token_count * kv_hidden_size);
+  for (size_t t = 0; t < token_count; ++t) {
+    const auto token = packed_qkv_data.begin() + t * packed_hidden_size;
+    std::copy_n(token, hidden_size, query.begin() + t * hidden_size);
+    std::copy_n(token + hidden_size, kv_hidden_size, key.begin() + t * kv_hidden_size);
+    std::copy_n(token + hidden_size + kv_hidden_size, kv_hidden_size, value.begin() + t * kv_hidden_size);
+  }
+
+  std::vector<int32_t> seqlens_k(batch_size);
+  int32_t total_sequence_length = 0;
+  for (int b = 0; b < batch_size; ++b) {
+    seqlens_k[b] = past_lengths[b] + sequence_length - 1;
+    total_sequence_length = std::max(total_sequence_length, seqlens_k[b] + 1);
+  }
+  const int present_length = std::max(total_sequence_length, past_buffer_length);
+
+  const size_t past_size = static_cast<size_t>(batch_size) * kKvNumHeads * past_buffer_length * kHeadSize;
+  const auto past_key = CreateData(past_size, 4.1f);
+  const auto past_value = CreateData(past_size, 5.7f);
+
+  // the present buffers hold the past tokens followed by the new ones, the rest is zero
+  const size_t present_size = static_cast<size_t>(batch_size) * kKvNumHeads * present_length * kHeadSize;
+  std::vector<float> present_key(present_size, 0.0f);
+  std::vector<float> present_value(present_size, 0.0f);
+  auto present_offset = [&](int b, int kv_head, int position) {
+    return ((static_cast<size_t>(b) * kKvNumHeads + kv_head) * present_length + position) * kHeadSize;
+  };
+  for (int b = 0; b < batch_size; ++b) {
+    for (int kv_head = 0; kv_head < kKvNumHeads; ++kv_head) {
+      const size_t past_offset = (static_cast<size_t>(b) * kKvNumHeads + kv_head) * past_buffer_length * kHeadSize;
+      std::copy_n(past_key.begin() + past_offset, past_lengths[b] * kHeadSize,
+                  present_key.begin() + present_offset(b, kv_head, 0));
+      std::copy_n(past_value.begin() + past_offset, past_lengths[b] * kHeadSize,
+                  present_value.begin() + present_offset(b, kv_head, 0));
+      for (int s = 0; s < sequence_length; ++s) {
+        const size_t src = (static_cast<size_t>(b) * sequence_length + s) * kv_hidden_size + kv_head * kHeadSize;
+        const size_t dst = present_offset(b, kv_head, past_lengths[b] + s);
+        std::copy_n(key.begin() + src, kHeadSize, present_key.begin() + dst);
+        std::copy_n(value.begin() + src, kHeadSize, present_value.begin() + dst);
+      }
+    }
+  }
+
+  // query head `head` attends to kv head head / (kNumHeads / kKvNumHeads), at the positions up to its own within
+  // the local window
+  std::vector<float> output(query.size(), 0.0f);
+  const float scale = 1.0f / std::sqrt(static_cast<float>(kHeadSize));
+  for (int b = 0; b < batch_size; ++b) {
+    for (int s = 0; s < sequence_length; ++s) {
+      const int position = past_lengths[b] + s;
+      const int window_start = local_window_size > 0 ? std::max(0, position - local_window_size) : 0;
+      for (int head = 0; head < kNumHeads; ++head) {
+        const int kv_head = head / (kNumHeads / kKvNumHeads);
+        const float* q = query.data() + (static_cast<size_t>(b) * sequence_length + s) * hidden_size +
+                         head * kHeadSize;
+
+        std::vector<float> scores(position + 1 - window_start);
+        float max_score = -INFINITY;
+        for (int t = window_start; t <= position; ++t) {
+          const float* k = present_key.data() + present_offset(b, kv_head, t);
+          float dot = 0.0f;
+          for (int d = 0; d < kHeadSize; ++d) {
+            dot += q[d] * k[d];
+          }
+          scores[t - window_start] = dot * scale;
+          max_score = std::max(max_score, scores[t - window_start]);
+        }
+
+        float sum = 0.0f;
+        for (auto& score : scores) {
+          score = std::exp(score - max_score);
+          sum += score;
+        }
+
+        float* out = output.data() + (static_cast<size_t>(b) * sequence_length + s) * hidden_size +
+                     head * kHeadSize;
+        for (int t = window_start; t <= position; ++t) {
+          const float* v = present_value.data() + present_offset(b, kv_head, t);
+          for (int d = 0; d < kHeadSize; ++d) {
+            out[d] += scores[t - window_start] / sum * v[d];
+          }
+        }
+      }
+    }
+  }
+
+  // the tiled kernel is used unless it is disabled or the size of the L2 cache is unknown
+  for (const char* disable_flash_attention : {"0", "1"}) {
+    SCOPED_TRACE(MakeString(contrib::attention::kDisableFlashAttention, "=", disable_flash_attention));
+    ScopedEnvironmentVariables scoped_env_vars{
+        EnvVarMap{{contrib::attention::kDisableFlashAttention, disable_flash_attention}}};
+
+    const std::vector<int64_t> past_dims{batch_size, kKvNumHeads, past_buffer_length, kHeadSize};
+    const std::vector<int64_t> present_dims{batch_size, kKvNumHeads, present_length, kHeadSize};
+    OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute<int64_t>("num_heads", kNumHeads);
+    tester.AddAttribute<int64_t>("kv_num_heads", kKvNumHeads);
+    tester.AddAttribute<int64_t>("local_window_size", local_window_size);
+    if (packed_qkv) {
+      tester.AddInput<float>("query", {batch_size, sequence_length, packed_hidden_size}, packed_qkv_data);
+      tester.AddOptionalInputEdge<float>();
+      tester.AddOptionalInputEdge<float>();
+    } else {
+      tester.AddInput<float>("query", {batch_size, sequence_length, hidden_size}, query);
+      tester.AddInput<float>("key", {batch_size, sequence_length, kv_hidden_size}, key);
+      tester.AddInput<float>("value", {batch_size, sequence_length, kv_hidden_size}, value);
+    }
+    if (past_buffer_length > 0) {
+      tester.AddInput<float>("past_key", past_dims, past_key);
+      tester.AddInput<float>("past_value", past_dims, past_value);
+    } else {
+      tester.AddOptionalInputEdge<float>();
+      tester.AddOptionalInputEdge<float>();
+    }
+    tester.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+    tester.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+    tester.AddOutput<float>("output", {batch_size, sequence_length, hidden_size}, output, false, 0, 1e-5f);
+    tester.AddOutput<float>("present_key", present_dims, present_key);
+    tester.AddOutput<float>("present_value", present_dims, present_value);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
+int8_t QuantizeKV(float value, float scale) {
+  return static_cast<int8_t>(std::clamp(std::nearbyint(value / scale), -128.0f, 127.0f));
+}
+
+// Runs GroupQueryAttention with an int8 kv cache and checks it against a naive attention over the dequantized cache.
+// `past_lengths` holds the number of cached tokens of each sequence in a past buffer of past_buffer_length tokens.
+void RunInt8KVCacheTest(const std::vector<int32_t>& past_lengths, int sequence_length, int past_buffer_length,
+                        const std::vector<float>& k_scale, const std::vector<float>& v_scale) {
+  const int batch_size = static_cast<int>(past_lengths.size());
+  const int hidden_size = kNumHeads * kHeadSize;
+  const int kv_hidden_size = kKvNumHeads * kHeadSize;
+
+  const auto query = CreateData(static_cast<size_t>(batch_size) * sequence_length * hidden_size, 0.1f);
+  const auto key = CreateData(static_cast<size_t>(batch_size) * sequence_length * kv_hidden_size, 1.3f);
+  const auto value = CreateData(static_cast<size_t>(batch_size) * sequence_length * kv_hidden_size, 2.9f);
+
+  std::vector<int32_t> seqlens_k(batch_size);
+  int32_t total_sequence_length = 0;
+  for (int b = 0; b < batch_size; ++b) {
+    seqlens_k[b] = past_lengths[b] + sequence_length - 1;
+    total_sequence_length = std::max(total_sequence_length, seqlens_k[b] + 1);
+  }
+  const int present_length = std::max(total_sequence_length, past_buffer_length);
+
+  auto scale_of = [](const std::vector<float>& scales, int kv_head) {
+    return scales.size() == 1 ? scales[0] : scales[kv_head];
+  };
+
+  // the past tokens are int8 values, the rest of the past buffer is ignored
+  const size_t past_size = static_cast<size_t>(batch_size) * kKvNumHeads * past_buffer_length * kHeadSize;
+  std::vector<int8_t> past_key(past_size);
+  std::vector<int8_t> past_value(past_size);
+  for (size_t i = 0; i < past_size; ++i) {
+    past_key[i] = static_cast<int8_t>(static_cast<int>(i * 37 % 201) - 100);
+    past_value[i] = static_cast<int8_t>(static_cast<int>(i * 53 % 201) - 100);
+  }
+
+  const size_t present_size = static_cast<size_t>(batch_size) * kKvNumHeads * present_length * kHeadSize;
+  std::vector<int8_t> present_key(present_size, 0);
+  std::vector<int8_t> present_value(present_size, 0);
+  auto present_offset = [&](int b, int kv_head, int position) {
+    return ((static_cast<size_t>(b) * kKvNumHeads + kv_head) * present_length + position) * kHeadSize;
+  };
+  for (int b = 0; b < batch_size; ++b) {
+    for (int kv_head = 0; kv_head < kKvNumHeads; ++kv_head) {
+      const size_t past_offset = (static_cast<size_t>(b) * kKvNumHeads + kv_head) * past_buffer_length * kHeadSize;
+      std::copy_n(past_key.begin() + past_offset, past_lengths[b] * kHeadSize,
+                  present_key.begin() + present_offset(b, kv_head, 0));
+      std::copy_n(past_value.begin() + past_offset, past_lengths[b] * kHeadSize,
+                  present_value.begin() + present_offset(b, kv_head, 0));
+      for (int s = 0; s < sequence_length; ++s) {
+        const size_t src = (static_cast<size_t>(b) * sequence_length + s) * kv_hidden_size + kv_head * kHeadSize;
+        const size_t dst = present_offset(b, kv_head, past_lengths[b] + s);
+        for (int d = 0; d < kHeadSize; ++d) {
+          present_key[dst + d] = QuantizeKV(key[src + d], scale_of(k_scale, kv_head));
+          present_value[dst + d] = QuantizeKV(value[src + d], scale_of(v_scale, kv_head));
+        }
+      }
+    }
+  }
+
+  std::vector<float> output(query.size());
+  const float scale = 1.0f / std::sqrt(static_cast<float>(kHeadSize));
+  for (int b = 0; b < batch_size; ++b) {
+    for (int s = 0; s < sequence_length; ++s) {
+      const int causal_length = past_lengths[b] + s + 1;
+      for (int head = 0; head < kNumHeads; ++head) {
+        const int kv_head = head / (kNumHeads / kKvNumHeads);
+        const float* q = query.data() + (static_cast<size_t>(b) * sequence_length + s) * hidden_size +
+                         head * kHeadSize;
+
+        std::vector<float> scores(causal_length);
+        float max_score = -INFINITY;
+        for (int t = 0; t < causal_length; ++t) {
+          const int8_t* k = present_key.data() + present_offset(b, kv_head, t);
+          float dot = 0.0f;
+          for (int d = 0; d < kHeadSize; ++d) {
+            dot += q[d] * static_cast<float>(k[d]) * scale_of(k_scale, kv_head);
+          }
+          scores[t] = dot * scale;
+          max_score = std::max(max_score, scores[t]);
+        }
+
+        float sum = 0.0f;
+        for (auto& score : scores) {
+          score = std::exp(score - max_score);
+          sum += score;
+        }
+
+        float* out = output.data() + (static_cast<size_t>(b) * sequence_length + s) * hidden_size +
+                     head * kHeadSize;
+        for (int t = 0; t < causal_length; ++t) {
+          const int8_t* v = present_value.data() + present_offset(b, kv_head, t);
+          for (int d = 0; d < kHeadSize; ++d) {
+            out[d] += scores[t] / sum * static_cast<float>(v[d]) * scale_of(v_scale, kv_head);
+          }
+        }
+      }
+    }
+  }
+
+  const std::vector<int64_t> past_dims{batch_size, kKvNumHeads, past_buffer_length, kHeadSize};
+  const std::vector<int64_t> present_dims{batch_size, kKvNumHeads, present_length, kHeadSize};
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", kNumHeads);
+  tester.AddAttribute<int64_t>("kv_num_heads", kKvNumHeads);
+  tester.AddInput<float>("query", {batch_size, sequence_length, hidden_size}, query);
+  tester.AddInput<float>("key", {batch_size, sequence_length, kv_hidden_size}, key);
+  tester.AddInput<float>("value", {batch_size, sequence_length, kv_hidden_size}, value);
+  if (past_buffer_length > 0) {
+    tester.AddInput<int8_t>("past_key", past_dims, past_key);
+    tester.AddInput<int8_t>("past_value", past_dims, past_value);
+  } else {
+    tester.AddOptionalInputEdge<int8_t>();
+    tester.AddOptionalInputEdge<int8_t>();
+  }
+  tester.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<int32_t>();
+  tester.AddInput<float>("k_scale", {static_cast<int64_t>(k_scale.size())}, k_scale);
+  tester.AddInput<float>("v_scale", {static_cast<int64_t>(v_scale.size())}, v_scale);
+  tester.AddOutput<float>("output", {batch_size, sequence_length, hidden_size}, output, false, 0, 1e-5f);
+  tester.AddOutput<int8_t>("present_key", present_dims, present_key);
+  tester.AddOutput<int8_t>("present_value", present_dims, present_value);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+}  // namespace
+
+TEST(GroupQueryAttentionTest, PagedKVCacheTokenGeneration) {
+  // the sequences use blocks scattered over the pool, and the new token of the first one starts a block
+  RunPagedKVCacheTest({8, 2}, 1, {5, 0, 3, -1, 6, -1, -1, -1}, 4);
+}
+
+TEST(GroupQueryAttentionTest, PagedKVCachePrompt) {
+  // the prompt spans two blocks, the second one is partially filled
+  RunPagedKVCacheTest({0}, 6, {7, 2, -1}, 3);
+}
+
+TEST(GroupQueryAttentionTest, PagedKVCacheInvalidBlock) {
+  RunPagedKVCacheTest({5}, 1, {1, kNumBlocks}, 2, "is not a valid block of the kv cache");
+}
+
+TEST(GroupQueryAttentionTest, PagedKVCacheExceedsBlockTable) {
+  RunPagedKVCacheTest({8}, 1, {1, 2}, 2, "exceeds the capacity of the block table");
+}
+
+TEST(GroupQueryAttentionTest, FloatKVCachePrompt) {
+  RunFloatKVCacheTest({0, 0}, 7, 0, false, -1);
+}
+
+TEST(GroupQueryAttentionTest, FloatKVCachePromptPackedQKV) {
+  // the present buffer is the past buffer of 12 tokens, longer than the prompt
+  RunFloatKVCacheTest({0, 0, 0}, 5, 12, true, -1);
+}
+
+TEST(GroupQueryAttentionTest, FloatKVCachePromptLocalWindow) {
+  RunFloatKVCacheTest({0, 0}, 9, 0, false, 3);
+  RunFloatKVCacheTest({0}, 6, 10, true, 1);
+}
+
+TEST(GroupQueryAttentionTest, FloatKVCacheTokenGeneration) {
+  // the sequences have different lengths in past buffers longer than the total sequence
+  RunFloatKVCacheTest({8, 3, 0}, 1, 12, false, -1);
+  RunFloatKVCacheTest({5, 1}, 1, 11, true, -1);
+}
+
+TEST(GroupQueryAttentionTest, FloatKVCacheTokenGenerationLocalWindow) {
+  RunFloatKVCacheTest({8, 3, 0}, 1, 9, false, 2);
+  RunFloatKVCacheTest({7, 2}, 1, 12, true, 4);
+}
+
+TEST(GroupQueryAttentionTest, FloatKVCacheSubsequentPrompt) {
+  // a prompt after 4 cached tokens, with a present buffer of 16 tokens
+  RunFloatKVCacheTest({4}, 5, 16, false, -1);
+  RunFloatKVCacheTest({4}, 5, 16, true, 3);
+}
+
+TEST(GroupQueryAttentionTest, Int8KVCachePrompt) {
+  RunInt8KVCacheTest({0}, 5, 0, {0.02f, 0.03f}, {0.025f});
+}
+
+TEST(GroupQueryAttentionTest, Int8KVCacheTokenGeneration) {
+  // the sequences have different lengths in a past buffer of 6 tokens
+  RunInt8KVCacheTest({5, 3}, 1, 6, {0.02f, 0.03f}, {0.025f, 0.015f});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -3,6 +3,8 @@
 
 #ifndef ORT_MINIMAL_BUILD
 
+#include <algorithm>
+#include <cmath>
 #include <optional>
 
 #include "gtest/gtest.h"
@@ -392,6 +394,121 @@ TEST(MatMulNBits, Float32_Accuracy4) {
   TestMatMulNBitsTyped<float, 100, 288, 1234, 16, 4>();
 }
 
+namespace {
+
+// quantizes B with fewer than 4 bits into the little endian bit streams of MatMulNBits, and runs the CPU EP
+void RunLowBitTest(int64_t bits, int64_t M, int64_t N, int64_t K, int64_t block_size, int64_t accuracy_level,
+                   bool has_zero_point) {
+  SCOPED_TRACE(::testing::Message() << "bits:" << bits << ", M:" << M << ", N:" << N << ", K:" << K
+                                    << ", block_size:" << block_size << ", accuracy_level:" << accuracy_level
+                                    << ", has_zero_point:" << has_zero_point);
+
+  const int64_t blocks_per_col = (K + block_size - 1) / block_size;
+  const int64_t blob_size = block_size * bits / 8;
+  const int64_t zp_bytes_per_col = (blocks_per_col * bits + 7) / 8;
+  const int max_q = (1 << bits) - 1;
+
+  RandomValueGenerator random{1234};
+  std::vector<float> a_vals(random.Gaussian<float>(AsSpan({M, K}), 0.0f, 0.25f));
+  std::vector<float> b_vals(random.Gaussian<float>(AsSpan({N, K}), 0.0f, 0.25f));
+
+  std::vector<uint8_t> b_data(N * blocks_per_col * blob_size, 0);
+  std::vector<float> scales(N * blocks_per_col);
+  std::vector<uint8_t> zero_points(N * zp_bytes_per_col, 0);
+  std::vector<float> b_dequant(N * K);
+  auto set_bits = [bits](uint8_t* data, int64_t index, int value) {
+    for (int64_t bit = 0; bit < bits; ++bit) {
+      if ((value >> bit) & 1) {
+        const int64_t offset = index * bits + bit;
+        data[offset / 8] |= static_cast<uint8_t>(1 << (offset % 8));
+      }
+    }
+  };
+
+  for (int64_t n = 0; n < N; ++n) {
+    for (int64_t blk = 0; blk < blocks_per_col; ++blk) {
+      const int64_t k_begin = blk * block_size, k_end = std::min(K, k_begin + block_size);
+      const auto b_blk = b_vals.begin() + n * K;
+      const auto [min_it, max_it] = std::minmax_element(b_blk + k_begin, b_blk + k_end);
+      int zp = 1 << (bits - 1);
+      float scale = 0.0f;
+      if (has_zero_point) {
+        const float min_v = std::min(*min_it, 0.0f), max_v = std::max(*max_it, 0.0f);
+        scale = (max_v - min_v) / max_q;
+        zp = scale == 0.0f ? 0 : std::clamp(static_cast<int>(std::nearbyint(-min_v / scale)), 0, max_q);
+        set_bits(zero_points.data() + n * zp_bytes_per_col, blk, zp);
+      } else {
+        scale = std::max(std::fabs(*min_it), std::fabs(*max_it)) / zp;
+      }
+      scales[n * blocks_per_col + blk] = scale;
+
+      for (int64_t k = k_begin; k < k_end; ++k) {
+        const int q = scale == 0.0f ? zp : std::clamp(static_cast<int>(std::nearbyint(b_vals[n * K + k] / scale)) + zp,
+                                                      0, max_q);
+        set_bits(b_data.data() + (n * blocks_per_col + blk) * blob_size, k - k_begin, q);
+        b_dequant[n * K + k] = (q - zp) * scale;
+      }
+    }
+  }
+
+  std::vector<float> expected_vals(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += a_vals[m * K + k] * b_dequant[n * K + k];
+      }
+      expected_vals[m * N + n] = sum;
+    }
+  }
+
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddAttribute<int64_t>("bits", bits);
+  test.AddAttribute<int64_t>("accuracy_level", accuracy_level);
+  test.AddInput<float>("A", {M, K}, a_vals, false);
+  test.AddInput<uint8_t>("B", {N, blocks_per_col, blob_size}, b_data, true);
+  test.AddInput<float>("scales", {N * blocks_per_col}, scales, true);
+  if (has_zero_point) {
+    test.AddInput<uint8_t>("zero_points", {N * zp_bytes_per_col}, zero_points, true);
+  } else {
+    test.AddOptionalInputEdge<uint8_t>();
+  }
+  test.AddOptionalInputEdge<int32_t>();
+  test.AddOptionalInputEdge<float>();
+  test.AddOutput<float>("Y", {M, N}, expected_vals);
+
+  if (accuracy_level == 4) {
+    test.SetOutputAbsErr("Y", 0.1f);
+    test.SetOutputRelErr("Y", 0.02f);
+  } else {
+    test.SetOutputAbsErr("Y", 0.0005f);
+  }
+
+  std::vector<std::unique_ptr<IExecutionProvider>> explicit_eps;
+  explicit_eps.emplace_back(DefaultCpuExecutionProvider());
+  test.ConfigEps(std::move(explicit_eps));
+  test.RunWithConfig();
+}
+
+}  // namespace
+
+TEST(MatMulNBits, Float32_LowBits) {
+  for (int64_t bits : {2, 3}) {
+    for (int64_t accuracy_level : {0, 4}) {
+      for (bool has_zero_point : {false, true}) {
+        RunLowBitTest(bits, 1, 1, 16, 16, accuracy_level, has_zero_point);
+        RunLowBitTest(bits, 1, 288, 1024, 128, accuracy_level, has_zero_point);
+        RunLowBitTest(bits, 1, 288, 93, 32, accuracy_level, has_zero_point);
+        RunLowBitTest(bits, 100, 32, 1234, 16, accuracy_level, has_zero_point);
+        RunLowBitTest(bits, 100, 288, 1024, 64, accuracy_level, has_zero_point);
+      }
+    }
+  }
+}
+
 #if defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_ARM64)
 #if !defined(USE_DML)
 // Actual and expected difference is over 0.01 with DmlExecutionProvider.
@@ -45,5 +45,43 @@ TEST(MatmulInteger16OpTest, MatMulInteger16_3) {
   test.Run();
 }
 
+// Larger batched products, with B as a constant initializer (prepacked as transposed B) and as a graph input.
+TEST(MatmulInteger16OpTest, MatMulInteger16_Batched) {
+  constexpr int64_t batch = 3;
+  constexpr int64_t M = 9;
+  constexpr int64_t K = 37;
+  constexpr int64_t N = 21;
+
+  std::vector<int16_t> A(batch * M * K);
+  std::vector<int16_t> B(batch * K * N);
+  for (size_t i = 0; i < A.size(); i++) {
+    A[i] = static_cast<int16_t>((static_cast<int>(i) * 7919) % 2001 - 1000);
+  }
+  for (size_t i = 0; i < B.size(); i++) {
+    B[i] = static_cast<int16_t>((static_cast<int>(i) * 104729) % 1201 - 600);
+  }
+
+  std::vector<int32_t> Y(batch * M * N);
+  for (int64_t b = 0; b < batch; b++) {
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t n = 0; n < N; n++) {
+        int32_t sum = 0;
+        for (int64_t k = 0; k < K; k++) {
+          sum += static_cast<int32_t>(A[(b * M + m) * K + k]) * static_cast<int32_t>(B[(b * K + k) * N + n]);
+        }
+        Y[(b * M + m) * N + n] = sum;
+      }
+    }
+  }
+
+  for (bool b_is_initializer : {false, true}) {
+    OpTester test("MatMulInteger16", 1, onnxruntime::kMSDomain);
+    test.AddInput<int16_t>("T1", {batch, M, K}, A);
+    test.AddInput<int16_t>("T2", {batch, K, N}, B, b_is_initializer);
+    test.AddOutput<int32_t>("T3", {batch, M, N}, Y);
+    test.Run();
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -34,8 +34,9 @@ void TestNhwcConvOp(const NhwcConvOpAndTestAttributes& attributes,
   bool enable_cuda = HasCudaEnvironment(min_cuda_architecture) && weight_is_initializer;
   bool enable_rocm = (nullptr != DefaultRocmExecutionProvider().get());
   bool enable_dml = (nullptr != DefaultDmlExecutionProvider().get());
+  bool enable_cpu = !use_float16;
 
-  if (enable_cuda || enable_rocm || enable_dml) {
+  if (enable_cuda || enable_rocm || enable_dml || enable_cpu) {
     OpTester test("NhwcConv", 1, onnxruntime::kMSDomain);
     test.AddAttribute("group", attributes.group);
     test.AddAttribute("kernel_shape", attributes.kernel_shape);
@@ -88,6 +89,10 @@ void TestNhwcConvOp(const NhwcConvOpAndTestAttributes& attributes,
       execution_providers.push_back(DefaultDmlExecutionProvider());
     }
 
+    if (enable_cpu) {
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+    }
+
     test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
   }
 }
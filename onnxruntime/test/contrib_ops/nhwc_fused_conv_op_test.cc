@@ -0,0 +1,278 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "core/util/math.h"
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+class NhwcFusedConvFloatOpTester {
+ private:
+  std::default_random_engine generator_{1234};
+  std::vector<float> X_data_;
+  std::vector<int64_t> X_shape_;
+  std::vector<float> W_data_;
+  std::vector<int64_t> W_shape_;
+  std::vector<float> B_data_;
+  std::vector<float> Z_data_;
+  std::vector<int64_t> pads_;
+  std::vector<int64_t> strides_;
+  std::vector<int64_t> dilations_;
+  int64_t groups_{1};
+  bool use_z_{false};
+  bool relu_{false};
+
+  static size_t ShapeSize(const std::vector<int64_t>& shape) {
+    return static_cast<size_t>(std::accumulate(shape.cbegin(), shape.cend(), 1LL, std::multiplies<int64_t>()));
+  }
+
+  static bool NextPosition(int64_t N, const int64_t* shape, int64_t* dims) {
+    // Loop over spatial axes in reverse order to choose an index, like counting.
+    bool incremented = false;
+    for (int64_t d_i = N - 1; d_i >= 0; --d_i) {
+      int64_t d_max = shape[d_i];
+      ORT_ENFORCE(dims[d_i] < d_max);
+      if (dims[d_i] == d_max - 1) {
+        dims[d_i] = 0;
+      } else {  // dims[d_i] < d_max - 1
+        ++dims[d_i];
+        incremented = true;
+        break;
+      }
+    }
+    return incremented;
+  }
+
+  void GenerateRandom(std::vector<float>& data, size_t size) {
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    data.resize(size);
+    for (auto& value : data) {
+      value = distribution(generator_);
+    }
+  }
+
+  void ComputeOutputShape(std::vector<int64_t>& Y_shape) {
+    const size_t kernel_rank = W_shape_.size() - 2;
+    const int64_t* input_shape = X_shape_.data() + 1;
+    const int64_t* kernel_shape = W_shape_.data() + 2;
+
+    Y_shape.clear();
+    Y_shape.push_back(X_shape_[0]);
+    for (size_t n = 0; n < kernel_rank; n++) {
+      Y_shape.push_back(((input_shape[n] + pads_[n] + pads_[kernel_rank + n]) -
+                         (dilations_[n] * (kernel_shape[n] - 1) + 1)) /
+                            strides_[n] +
+                        1);
+    }
+    Y_shape.push_back(W_shape_[0]);
+  }
+
+  void ComputeExpectedOutput(std::vector<float>& Y_data, const std::vector<int64_t>& Y_shape) {
+    const size_t kernel_rank = W_shape_.size() - 2;
+
+    const int64_t batch_count = X_shape_[0];
+    const int64_t input_channels = X_shape_[X_shape_.size() - 1];
+    const int64_t output_channels = W_shape_[0];
+    const int64_t group_input_channels = W_shape_[1];
+    const int64_t group_output_channels = output_channels / groups_;
+
+    const int64_t* input_shape = X_shape_.data() + 1;
+    const int64_t* kernel_shape = W_shape_.data() + 2;
+    const int64_t* output_shape = Y_shape.data() + 1;
+
+    const int64_t input_image_size = std::accumulate(
+        input_shape, input_shape + kernel_rank, 1LL, std::multiplies<int64_t>());
+    const int64_t kernel_size = std::accumulate(
+        kernel_shape, kernel_shape + kernel_rank, 1LL, std::multiplies<int64_t>());
+
+    Y_data.resize(ShapeSize(Y_shape));
+
+    const float* Xdata = X_data_.data();
+    float* Ydata = Y_data.data();
+    const float* Zdata = use_z_ ? Z_data_.data() : nullptr;
+
+    for (int64_t batch = 0; batch < batch_count; batch++) {
+      std::vector<int64_t> d_output(kernel_rank, 0);
+      do {
+        for (int64_t oc = 0; oc < output_channels; oc++) {
+          const int64_t group = oc / group_output_channels;
+          float sum = B_data_.empty() ? 0.0f : B_data_[oc];
+          std::vector<int64_t> d_kernel(kernel_rank, 0);
+          int64_t kernel_index = 0;
+          do {
+            int64_t input_offset = 0;
+            bool is_padding = false;
+            for (size_t axis = 0; axis < kernel_rank; ++axis) {
+              int64_t input_dim = d_kernel[axis] * dilations_[axis] + d_output[axis] * strides_[axis] - pads_[axis];
+              is_padding |= !math::is_a_ge_zero_and_a_lt_b(input_dim, input_shape[axis]);
+              input_offset *= input_shape[axis];
+              input_offset += input_dim;
+            }
+            if (!is_padding) {
+              const float* data_ptr = Xdata + input_offset * input_channels + group * group_input_channels;
+              for (int64_t ic = 0; ic < group_input_channels; ic++) {
+                sum += data_ptr[ic] * W_data_[(oc * group_input_channels + ic) * kernel_size + kernel_index];
+              }
+            }
+            kernel_index++;
+          } while (NextPosition(kernel_rank, kernel_shape, d_kernel.data()));
+          if (Zdata != nullptr) {
+            sum += Zdata[oc];
+          }
+          Ydata[oc] = relu_ ? std::max(sum, 0.0f) : sum;
+        }
+        Ydata += output_channels;
+        if (Zdata != nullptr) {
+          Zdata += output_channels;
+        }
+      } while (NextPosition(kernel_rank, output_shape, d_output.data()));
+      Xdata += input_channels * input_image_size;
+    }
+  }
+
+ public:
+  void GenerateRandomInput(const std::vector<int64_t>& X_shape, const std::vector<int64_t>& W_shape,
+                           int64_t groups = 1, bool has_bias = true) {
+    const size_t kernel_rank = W_shape.size() - 2;
+    X_shape_ = X_shape;
+    W_shape_ = W_shape;
+    groups_ = groups;
+    GenerateRandom(X_data_, ShapeSize(X_shape));
+    GenerateRandom(W_data_, ShapeSize(W_shape));
+    B_data_.clear();
+    if (has_bias) {
+      GenerateRandom(B_data_, static_cast<size_t>(W_shape[0]));
+    }
+    pads_.assign(kernel_rank * 2, 0);
+    strides_.assign(kernel_rank, 1);
+    dilations_.assign(kernel_rank, 1);
+  }
+
+  void SetPads(const std::vector<int64_t>& pads) {
+    pads_ = pads;
+  }
+
+  void SetStrides(const std::vector<int64_t>& strides) {
+    strides_ = strides;
+  }
+
+  void SetDilations(const std::vector<int64_t>& dilations) {
+    dilations_ = dilations;
+  }
+
+  void SetSumAndRelu() {
+    use_z_ = true;
+    relu_ = true;
+  }
+
+  void Run(bool weight_is_initializer = true) {
+    std::vector<int64_t> Y_shape;
+    ComputeOutputShape(Y_shape);
+    if (use_z_) {
+      GenerateRandom(Z_data_, ShapeSize(Y_shape));
+    }
+    std::vector<float> Y_data;
+    ComputeExpectedOutput(Y_data, Y_shape);
+
+    OpTester test("NhwcFusedConv", 1, onnxruntime::kMSDomain);
+    test.AddInput<float>("X", X_shape_, X_data_);
+    test.AddInput<float>("W", W_shape_, W_data_, weight_is_initializer);
+    if (!B_data_.empty()) {
+      test.AddInput<float>("B", {W_shape_[0]}, B_data_, true);
+    } else if (use_z_) {
+      test.AddOptionalInputEdge<float>();
+    }
+    if (use_z_) {
+      test.AddInput<float>("Z", Y_shape, Z_data_);
+    }
+    test.AddOutput<float>("Y", Y_shape, Y_data);
+    test.AddAttribute("group", groups_);
+    test.AddAttribute("pads", pads_);
+    test.AddAttribute("strides", strides_);
+    test.AddAttribute("dilations", dilations_);
+    if (relu_) {
+      test.AddAttribute("activation", std::string("Relu"));
+    }
+    test.SetOutputAbsErr("Y", 1e-4f);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "");
+  }
+};
+
+TEST(NhwcFusedConvFloatContribOpTest, Pointwise) {
+  for (int64_t channels : {1, 7, 16, 33}) {
+    NhwcFusedConvFloatOpTester test;
+    test.GenerateRandomInput({2, 9, 11, channels}, {24, channels, 1, 1});
+    test.Run();
+  }
+}
+
+TEST(NhwcFusedConvFloatContribOpTest, Conv1D) {
+  NhwcFusedConvFloatOpTester test;
+  test.GenerateRandomInput({1, 23, 12}, {20, 12, 5});
+  test.SetPads({2, 2});
+  test.Run();
+}
+
+TEST(NhwcFusedConvFloatContribOpTest, Conv2D) {
+  NhwcFusedConvFloatOpTester test;
+  test.GenerateRandomInput({1, 15, 19, 8}, {16, 8, 3, 3});
+  test.SetPads({1, 1, 1, 1});
+  test.Run();
+}
+
+TEST(NhwcFusedConvFloatContribOpTest, Conv2DStridesDilations) {
+  NhwcFusedConvFloatOpTester test;
+  test.GenerateRandomInput({2, 23, 19, 5}, {12, 5, 3, 3});
+  test.SetPads({0, 1, 1, 0});
+  test.SetStrides({2, 2});
+  test.SetDilations({1, 2});
+  test.Run();
+}
+
+TEST(NhwcFusedConvFloatContribOpTest, Conv3D) {
+  NhwcFusedConvFloatOpTester test;
+  test.GenerateRandomInput({1, 5, 7, 9, 4}, {6, 4, 2, 3, 3});
+  test.SetPads({0, 1, 1, 1, 1, 1});
+  test.Run();
+}
+
+TEST(NhwcFusedConvFloatContribOpTest, Grouped) {
+  NhwcFusedConvFloatOpTester test;
+  test.GenerateRandomInput({1, 13, 11, 12}, {18, 4, 3, 3}, 3);
+  test.SetPads({1, 1, 1, 1});
+  test.Run();
+}
+
+TEST(NhwcFusedConvFloatContribOpTest, Depthwise) {
+  for (int64_t channels : {1, 8, 19}) {
+    NhwcFusedConvFloatOpTester test;
+    test.GenerateRandomInput({2, 14, 17, channels}, {channels, 1, 3, 3}, channels);
+    test.SetPads({1, 1, 1, 1});
+    test.SetStrides({1, 2});
+    test.Run();
+  }
+}
+
+TEST(NhwcFusedConvFloatContribOpTest, SumAndRelu) {
+  NhwcFusedConvFloatOpTester test;
+  test.GenerateRandomInput({1, 10, 12, 6}, {16, 6, 3, 3}, 1, false);
+  test.SetPads({1, 1, 1, 1});
+  test.SetSumAndRelu();
+  test.Run();
+}
+
+TEST(NhwcFusedConvFloatContribOpTest, DynamicWeights) {
+  NhwcFusedConvFloatOpTester test;
+  test.GenerateRandomInput({1, 9, 9, 6}, {10, 6, 3, 3});
+  test.SetSumAndRelu();
+  test.Run(false);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -258,5 +258,23 @@ TEST(NhwcMaxPoolContribOpTest, MaxPoolDilations_S8) {
   test.Run();
 }
 
+TEST(NhwcMaxPoolContribOpTest, MaxPool2D_Float) {
+  for (int64_t channels = 1; channels < 94; channels++) {
+    NhwcMaxPoolOpTester<float> test;
+    test.GenerateRandomInput({1, 15, 19, channels});
+    test.SetKernelShape({3, 5});
+    test.SetPads({1, 1, 1, 1});
+    test.Run();
+  }
+}
+
+TEST(NhwcMaxPoolContribOpTest, MaxPoolStrides_Float) {
+  NhwcMaxPoolOpTester<float> test;
+  test.GenerateRandomInput({4, 23, 19, 32});
+  test.SetKernelShape({3, 3});
+  test.SetStrides({2, 2});
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -121,6 +121,51 @@ TEST(QLinearLookupTableBasedOperatorTests, QLinearSigmoid_UInt8_0_Y_ZP) {
   run_test(true);
 }
 
+TEST(QLinearLookupTableBasedOperatorTests, QLinearGelu_Int8) {
+  auto run_test = [](const std::string& approximate) {
+    OpTester test("QLinearGelu", 1, onnxruntime::kMSDomain);
+    test.AddAttribute("approximate", approximate);
+    float X_scale = 0.05f;
+    float Y_scale = 0.025f;
+    int8_t Y_zero_point = -20;
+
+    std::vector<int64_t> dims = {16};
+    test.AddInput<int8_t>("X", dims, {0, 5, 10, 20, 40, 60, 100, 127, -128, -100, -60, -40, -20, -10, -5, -1});
+    test.AddInput<float>("X_scale", {}, {X_scale}, true);
+    test.AddOptionalInputEdge<int8_t>();  // optional "X_zero_point" using default value here
+    test.AddInput<float>("Y_scale", {}, {Y_scale}, true);
+    test.AddInput<int8_t>("Y_zero_point", {}, {Y_zero_point}, true);
+    test.AddOutput<int8_t>("Y", dims, {-20, -14, -6, 14, 58, 100, 127, 127, -20, -20, -20, -22, -26, -26, -24, -21});
+    auto origin_round_mode = std::fegetround();
+    std::fesetround(FE_TONEAREST);
+    test.Run();
+    std::fesetround(origin_round_mode);
+  };
+
+  run_test("none");
+  run_test("tanh");
+}
+
+TEST(QLinearLookupTableBasedOperatorTests, QLinearGelu_UInt8) {
+  OpTester test("QLinearGelu", 1, onnxruntime::kMSDomain);
+  float X_scale = 0.05f;
+  uint8_t X_zero_point = 128;
+  float Y_scale = 0.025f;
+  uint8_t Y_zero_point = 10;
+
+  std::vector<int64_t> dims = {16};
+  test.AddInput<uint8_t>("X", dims, {0, 5, 10, 20, 40, 60, 100, 127, 128, 138, 148, 168, 188, 208, 228, 255});
+  test.AddInput<float>("X_scale", {}, {X_scale});
+  test.AddInput<uint8_t>("X_zero_point", {}, {X_zero_point});
+  test.AddInput<float>("Y_scale", {}, {Y_scale});
+  test.AddInput<uint8_t>("Y_zero_point", {}, {Y_zero_point});
+  test.AddOutput<uint8_t>("Y", dims, {10, 10, 10, 10, 10, 10, 5, 9, 10, 24, 44, 88, 130, 170, 210, 255});
+  auto origin_round_mode = std::fegetround();
+  std::fesetround(FE_TONEAREST);
+  test.Run();
+  std::fesetround(origin_round_mode);
+}
+
 /*
 \brief data is generated by pytorch script
 \details model defines
@@ -0,0 +1,232 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "core/util/qmath.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/util/include/default_providers.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// quantizes and dequantizes the data, per channel_count consecutive parts
+template <typename QType>
+std::vector<float> ApplyQDQ(const std::vector<float>& data, size_t channel_count) {
+  std::vector<float> result(data.size());
+  const size_t size_per_channel = data.size() / channel_count;
+
+  for (size_t channel = 0; channel < channel_count; channel++) {
+    QType zp = 0;
+    float scale = 1.0f;
+    const float* data_buf = data.data() + size_per_channel * channel;
+    GetQuantizationParameter<QType, true, false>(data_buf, size_per_channel, scale, zp, nullptr);
+
+    std::vector<QType> quant_data(size_per_channel);
+    MlasQuantizeLinear(data_buf, quant_data.data(), size_per_channel, scale, zp);
+
+    std::transform(quant_data.begin(), quant_data.end(), result.begin() + size_per_channel * channel,
+                   [&zp, &scale](QType q) { return (static_cast<int32_t>(q) - zp) * scale; });
+  }
+
+  return result;
+}
+
+// quantizes the [num_directions, row, col] weights and transposes them to [num_directions, col, row]
+template <typename QType>
+void QuantizeWeight(std::vector<QType>& w_quant, std::vector<float>& scale, std::vector<QType>& zp,
+                    const std::vector<float>& w, size_t num_directions, size_t row, size_t col, bool per_channel) {
+  std::vector<QType> w_quant_tmp(w.size());
+
+  const size_t quant_param_size = per_channel ? num_directions * row : num_directions;
+  const size_t quant_span = per_channel ? col : row * col;
+  scale.resize(quant_param_size);
+  zp.resize(quant_param_size);
+
+  for (size_t i = 0; i < quant_param_size; i++) {
+    GetQuantizationParameter<QType, true, false>(w.data() + i * quant_span, quant_span, scale[i], zp[i], nullptr);
+    MlasQuantizeLinear(w.data() + i * quant_span, w_quant_tmp.data() + i * quant_span, quant_span, scale[i], zp[i]);
+  }
+
+  w_quant.resize(w.size());
+  for (size_t dir = 0; dir < num_directions; dir++) {
+    const QType* src = w_quant_tmp.data() + dir * row * col;
+    QType* dst = w_quant.data() + dir * row * col;
+    for (size_t c = 0; c < col; c++) {
+      for (size_t r = 0; r < row; r++) {
+        *dst++ = src[r * col + c];
+      }
+    }
+  }
+}
+
+// runs the GRU with the weights, the input and the initial hidden that the quantized GRU sees
+template <typename QType>
+void ComputeRefOutput(std::vector<float>& Y_data, std::vector<float>& Y_h_data,
+                      int64_t input_size, int64_t batch_size, int64_t hidden_size,
+                      const std::vector<float>& X_data, const std::vector<float>& W_data,
+                      const std::vector<float>& R_data, const std::vector<float>* B_data,
+                      const std::vector<float>& initial_h_data, const std::string& direction,
+                      int64_t linear_before_reset, bool per_channel) {
+  OpTester test("GRU", 7 /*opset_version*/, onnxruntime::kOnnxDomain /*domain*/, false /*verify_output*/);
+
+  test.AddAttribute("direction", direction);
+  test.AddAttribute("hidden_size", hidden_size);
+  test.AddAttribute("linear_before_reset", linear_before_reset);
+
+  const int64_t seq_length = 1;
+  const int64_t num_directions = (direction == "bidirectional") ? 2 : 1;
+  const size_t weight_channels = per_channel ? num_directions * 3 * hidden_size : num_directions;
+  test.AddInput<float>("X", {seq_length, batch_size, input_size}, ApplyQDQ<uint8_t>(X_data, 1));
+  test.AddInput<float>("W", {num_directions, 3 * hidden_size, input_size}, ApplyQDQ<QType>(W_data, weight_channels));
+  test.AddInput<float>("R", {num_directions, 3 * hidden_size, hidden_size}, ApplyQDQ<QType>(R_data, weight_channels));
+
+  if (B_data) {
+    test.AddInput<float>("B", {num_directions, 6 * hidden_size}, *B_data);
+  } else {
+    test.AddOptionalInputEdge<float>();
+  }
+
+  // sequence_lens
+  test.AddOptionalInputEdge<int>();
+
+  test.AddInput<float>("initial_h", {num_directions, batch_size, hidden_size},
+                       ApplyQDQ<uint8_t>(initial_h_data, num_directions));
+
+  const size_t y_data_size = static_cast<size_t>(seq_length * num_directions * batch_size * hidden_size);
+  Y_data.resize(y_data_size);
+  test.AddOutput<float>("Y", {seq_length, num_directions, batch_size, hidden_size}, Y_data);
+
+  const size_t y_h_data_size = static_cast<size_t>(num_directions * batch_size * hidden_size);
+  Y_h_data.resize(y_h_data_size);
+  test.AddOutput<float>("Y_h", {num_directions, batch_size, hidden_size}, Y_h_data);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+
+  std::vector<OrtValue> outputs = test.GetFetches();
+
+  const float* y_buffer = outputs[0].Get<Tensor>().Data<float>();
+  std::copy(y_buffer, y_buffer + y_data_size, Y_data.begin());
+
+  const float* y_h_buffer = outputs[1].Get<Tensor>().Data<float>();
+  std::copy(y_h_buffer, y_h_buffer + y_h_data_size, Y_h_data.begin());
+}
+
+template <typename QType>
+void RunQuantGRU(int64_t input_size, int64_t batch_size, int64_t hidden_size, bool has_bias,
+                 bool is_initializer_W, bool is_initializer_R, bool per_channel, int64_t linear_before_reset,
+                 const std::string& direction) {
+  OpTester test("DynamicQuantizeGRU", 1 /*opset_version*/, onnxruntime::kMSDomain /*domain*/);
+
+  const int64_t num_directions = (direction == "bidirectional") ? 2 : 1;
+  test.AddAttribute("direction", direction);
+  test.AddAttribute("hidden_size", hidden_size);
+  test.AddAttribute("linear_before_reset", linear_before_reset);
+
+  RandomValueGenerator rand_gen;
+
+  // X
+  const int64_t seq_len = 1;  // only use seq length 1 so that the quantized inputs of the reference are exact
+  std::vector<int64_t> X_dims = {seq_len, batch_size, input_size};
+  std::vector<float> X_data = rand_gen.Gaussian<float>(X_dims, 0.0f, 0.25f);
+  test.AddInput<float>("X", X_dims, X_data);
+
+  // W
+  std::vector<float> W_data = rand_gen.Gaussian<float>(
+      std::vector<int64_t>{num_directions, 3 * hidden_size, input_size}, 0.0f, 0.25f);
+  std::vector<float> w_scale;
+  std::vector<QType> w_zp;
+  std::vector<QType> w_quant;
+  QuantizeWeight(w_quant, w_scale, w_zp, W_data, num_directions, 3 * hidden_size, input_size, per_channel);
+  test.AddInput<QType>("W", {num_directions, input_size, 3 * hidden_size}, w_quant, is_initializer_W);
+
+  // R
+  std::vector<float> R_data = rand_gen.Gaussian<float>(
+      std::vector<int64_t>{num_directions, 3 * hidden_size, hidden_size}, 0.0f, 0.25f);
+  std::vector<float> r_scale;
+  std::vector<QType> r_zp;
+  std::vector<QType> r_quant;
+  QuantizeWeight(r_quant, r_scale, r_zp, R_data, num_directions, 3 * hidden_size, hidden_size, per_channel);
+  test.AddInput<QType>("R", {num_directions, hidden_size, 3 * hidden_size}, r_quant, is_initializer_R);
+
+  std::vector<float> B_data;
+  if (has_bias) {
+    std::vector<int64_t> B_dims = {num_directions, 6 * hidden_size};
+    B_data = rand_gen.Gaussian<float>(B_dims, 0.0f, 0.25f);
+    test.AddInput<float>("B", B_dims, B_data);
+  } else {
+    test.AddOptionalInputEdge<float>();
+  }
+
+  // sequence_lens
+  test.AddOptionalInputEdge<int>();
+
+  // initial_h
+  std::vector<int64_t> initial_h_dims = {num_directions, batch_size, hidden_size};
+  std::vector<float> initial_h_data = rand_gen.Gaussian<float>(initial_h_dims, 0.0f, 0.25f);
+  test.AddInput<float>("initial_h", initial_h_dims, initial_h_data);
+
+  std::vector<int64_t> per_tensor_dims = {num_directions};
+  std::vector<int64_t> per_channel_dims = {num_directions, 3 * hidden_size};
+  test.AddInput<float>("W_scale", per_channel ? per_channel_dims : per_tensor_dims, w_scale);
+  test.AddInput<QType>("W_zero_point", per_channel ? per_channel_dims : per_tensor_dims, w_zp);
+  test.AddInput<float>("R_scale", per_channel ? per_channel_dims : per_tensor_dims, r_scale);
+  test.AddInput<QType>("R_zero_point", per_channel ? per_channel_dims : per_tensor_dims, r_zp);
+
+  std::vector<float> Y_data;
+  std::vector<float> Y_h_data;
+  ComputeRefOutput<QType>(Y_data, Y_h_data, input_size, batch_size, hidden_size, X_data, W_data, R_data,
+                          has_bias ? &B_data : nullptr, initial_h_data, direction, linear_before_reset, per_channel);
+
+  test.AddOutput<float>("Y", {seq_len, num_directions, batch_size, hidden_size}, Y_data);
+  test.AddOutput<float>("Y_h", {num_directions, batch_size, hidden_size}, Y_h_data);
+
+  if (linear_before_reset == 0) {
+    // the reset gate is applied before the GEMM of the hidden gate, whose input is quantized again
+    test.SetOutputAbsErr("Y", 0.02f);
+    test.SetOutputAbsErr("Y_h", 0.02f);
+  }
+
+  test.Run();
+}
+
+template <typename QType>
+void RunQuantGRU(int64_t input_size, int64_t batch_size, int64_t hidden_size, bool per_channel = false) {
+  for (int64_t linear_before_reset : {0, 1}) {
+    for (const char* direction : {"forward", "bidirectional"}) {
+      // no bias, no prepacking
+      RunQuantGRU<QType>(input_size, batch_size, hidden_size, false /*has_bias*/,
+                         false /*is_initializer_W*/, false /*is_initializer_R*/,
+                         per_channel, linear_before_reset, direction);
+      // bias, prepacking
+      RunQuantGRU<QType>(input_size, batch_size, hidden_size, true /*has_bias*/,
+                         true /*is_initializer_W*/, true /*is_initializer_R*/,
+                         per_channel, linear_before_reset, direction);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(DynamicQuantGRUTest, SmallSize) {
+  RunQuantGRU<int8_t>(2, 1, 16);
+  RunQuantGRU<int8_t>(2, 1, 16, true /*per_channel*/);
+  RunQuantGRU<uint8_t>(2, 1, 16);
+}
+
+TEST(DynamicQuantGRUTest, LargeSize) {
+  RunQuantGRU<int8_t>(12, 3, 278);
+  RunQuantGRU<int8_t>(12, 3, 278, true /*per_channel*/);
+  RunQuantGRU<uint8_t>(12, 3, 278);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,12 +1,20 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <memory>
+#include <random>
 #include <vector>
 #include "gtest/gtest.h"
 #include <gsl/gsl>
+#include "contrib_ops/cpu/transformers/sampling_cpu_helper.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/contrib_ops/tiny_gpt_test_helper.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 
 #ifdef USE_CUDA
 #include "core/providers/cuda/cuda_provider_options.h"
@@ -163,5 +171,137 @@ TEST(SamplingTest, Gpt2Sampling_CPU) {
   ASSERT_TRUE(std::equal(expected_output.cbegin(), expected_output.cend(), result_span.begin(), result_span.end()));
 }
 #endif
+
+TEST(SamplingTest, GptSamplingSequencesFinishAtDifferentSteps) {
+  // The default top_p keeps only the most likely token, so the sequences are those of greedy search.
+  // With eos 16, the first sequence finishes after 2 tokens and the last one after 4, while the others run
+  // to max_length. The logits of the finished sequences are still sampled after the decoder stops running them.
+  const TinyGptOptions options;
+  constexpr int batch_size = 4;
+  constexpr int max_length = 12;
+  constexpr int eos_token_id = 16;
+  constexpr int pad_token_id = 0;
+  const std::vector<int32_t> input_ids{
+      0, 0, 3, 5,
+      0, 7, 1, 2,
+      4, 9, 6, 1,
+      0, 0, 0, 2};
+
+  OpTester test("Sampling", 1, kMSDomain);
+  test.AddAttribute<int64_t>("eos_token_id", eos_token_id);
+  test.AddAttribute<int64_t>("pad_token_id", pad_token_id);
+  test.AddAttribute("decoder", CreateTinyGptSubgraph(options));
+  test.AddInput<int32_t>("input_ids", {batch_size, 4}, input_ids);
+  test.AddInput<int32_t>("max_length", {1}, {max_length});
+  test.AddInput<int32_t>("min_length", {1}, {1});
+  test.AddInput<float>("repetition_penalty", {1}, {1.0f});
+  test.AddOutput<int32_t>("sequences", {batch_size, max_length},
+                          TinyGptGreedySearch(options, input_ids, batch_size, max_length, eos_token_id, pad_token_id));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// Number of tokens kept by top-p, from the probabilities sorted in full.
+static size_t TopPCountFromFullSort(std::vector<float> probs, float top_p, bool custom_sampling,
+                                    size_t min_tokens_to_keep) {
+  std::sort(probs.begin(), probs.end(), std::greater<float>());
+  const size_t num_keep = custom_sampling ? 1 : std::max<size_t>(min_tokens_to_keep, 1);
+  float cumulative_prob = 0.0f;
+  for (size_t k = 0; k < probs.size(); k++) {
+    if (k >= num_keep && (custom_sampling ? cumulative_prob > top_p : cumulative_prob >= top_p)) {
+      return k;
+    }
+    cumulative_prob += probs[k];
+  }
+  return probs.size();
+}
+
+static void TestSelectTopP(const std::vector<float>& probs, float top_p, bool custom_sampling,
+                           size_t min_tokens_to_keep) {
+  SCOPED_TRACE(testing::Message() << "vocab_size: " << probs.size() << ", top_p: " << top_p
+                                  << ", custom_sampling: " << custom_sampling
+                                  << ", min_tokens_to_keep: " << min_tokens_to_keep);
+  std::vector<int32_t> token_indices(probs.size(), -1);
+  const size_t num_kept = contrib::SamplingCpuHelper::select_top_p<float>(
+      probs, token_indices, top_p, custom_sampling, min_tokens_to_keep);
+  ASSERT_EQ(num_kept, TopPCountFromFullSort(probs, top_p, custom_sampling, min_tokens_to_keep));
+
+  // token_indices is a permutation of the tokens. The kept ones come first in descending order of probability, and
+  // no other token is more likely. Which of tied tokens are kept is not specified.
+  std::vector<int32_t> sorted_indices = token_indices;
+  std::sort(sorted_indices.begin(), sorted_indices.end());
+  for (size_t i = 0; i < sorted_indices.size(); i++) {
+    ASSERT_EQ(sorted_indices[i], static_cast<int32_t>(i));
+  }
+  for (size_t k = 1; k < num_kept; k++) {
+    ASSERT_GE(probs[token_indices[k - 1]], probs[token_indices[k]]);
+  }
+  if (num_kept > 0 && num_kept < probs.size()) {
+    const float least_kept = probs[token_indices[num_kept - 1]];
+    for (size_t k = num_kept; k < probs.size(); k++) {
+      ASSERT_LE(probs[token_indices[k]], least_kept);
+    }
+  }
+}
+
+// select_top_p sorts a growing prefix of the most likely tokens. It must keep the tokens that a full sort keeps,
+// whether the kept tokens fit the first prefix or not, and with tied probabilities.
+TEST(SamplingTest, SelectTopPMatchesFullSort) {
+  std::default_random_engine generator(1234);
+  std::normal_distribution<float> logit_distribution(0.0f, 3.0f);
+  std::uniform_int_distribution<int> tied_logit_distribution(0, 3);
+
+  auto softmax = [](std::vector<float> logits) {
+    const float max_logit = *std::max_element(logits.begin(), logits.end());
+    float sum = 0.0f;
+    for (float& logit : logits) {
+      logit = std::exp(logit - max_logit);
+      sum += logit;
+    }
+    for (float& logit : logits) {
+      logit /= sum;
+    }
+    return logits;
+  };
+
+  // vocabulary sizes below, at and past the first prefix of 64 tokens, and past several doublings of it
+  for (size_t vocab_size : {1, 10, 64, 65, 300, 1000}) {
+    std::vector<std::vector<float>> distributions;
+
+    std::vector<float> logits(vocab_size);
+    for (float& logit : logits) {
+      logit = logit_distribution(generator);
+    }
+    distributions.push_back(softmax(logits));
+
+    // few distinct values, so that the top_p boundary falls among tied tokens
+    for (float& logit : logits) {
+      logit = static_cast<float>(tied_logit_distribution(generator));
+    }
+    distributions.push_back(softmax(logits));
+
+    // all tokens tied
+    distributions.push_back(std::vector<float>(vocab_size, 1.0f / static_cast<float>(vocab_size)));
+
+    // one token holding most of the mass
+    std::fill(logits.begin(), logits.end(), 0.0f);
+    logits[vocab_size / 2] = 10.0f;
+    distributions.push_back(softmax(logits));
+
+    for (const auto& probs : distributions) {
+      // top_p of 1 and more covers every token
+      for (float top_p : {0.0f, 0.3f, 0.9f, 0.999f, 1.0f, 2.0f}) {
+        for (bool custom_sampling : {false, true}) {
+          for (size_t min_tokens_to_keep : {size_t{0}, size_t{1}, size_t{5}, size_t{100}}) {
+            TestSelectTopP(probs, top_p, custom_sampling, min_tokens_to_keep);
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
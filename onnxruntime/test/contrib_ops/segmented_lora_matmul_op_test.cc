@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// base + scale * X * A[i] * B[i] for each batch entry, with its rows_per_batch rows of K values
+std::vector<float> ReferenceLora(const std::vector<float>& x, const std::vector<float>& a, const std::vector<float>& b,
+                                 const std::vector<int64_t>& adapter_indices, const std::vector<float>& base,
+                                 size_t rows_per_batch, size_t K, size_t rank, size_t N, float scale) {
+  std::vector<float> y = base;
+  for (size_t batch = 0; batch < adapter_indices.size(); ++batch) {
+    if (adapter_indices[batch] < 0) {
+      continue;
+    }
+
+    const size_t adapter = static_cast<size_t>(adapter_indices[batch]);
+    for (size_t row = batch * rows_per_batch; row < (batch + 1) * rows_per_batch; ++row) {
+      std::vector<float> t(rank, 0.0f);
+      for (size_t r = 0; r < rank; ++r) {
+        for (size_t k = 0; k < K; ++k) {
+          t[r] += x[row * K + k] * a[(adapter * K + k) * rank + r];
+        }
+      }
+      for (size_t n = 0; n < N; ++n) {
+        float sum = 0.0f;
+        for (size_t r = 0; r < rank; ++r) {
+          sum += t[r] * b[(adapter * rank + r) * N + n];
+        }
+        y[row * N + n] += scale * sum;
+      }
+    }
+  }
+
+  return y;
+}
+
+std::vector<float> Sequence(size_t size, float step, float offset) {
+  std::vector<float> values(size);
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = offset + step * static_cast<float>(i % 7) - step * static_cast<float>(i % 3);
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(SegmentedLoraMatMulTest, MixedAdapters) {
+  constexpr size_t batch_size = 5, sequence_length = 2, K = 4, rank = 2, N = 3, num_adapters = 3;
+  constexpr float scale = 0.5f;
+  // two segments of adapter 2, one entry without an adapter and one of adapter 0
+  const std::vector<int64_t> adapter_indices = {2, 2, -1, 0, 2};
+
+  const auto x = Sequence(batch_size * sequence_length * K, 0.25f, -0.5f);
+  const auto a = Sequence(num_adapters * K * rank, 0.5f, 0.125f);
+  const auto b = Sequence(num_adapters * rank * N, -0.25f, 1.0f);
+  const auto base = Sequence(batch_size * sequence_length * N, 1.0f, 0.0f);
+
+  OpTester test("SegmentedLoraMatMul", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<float>("scale", scale);
+  test.AddInput<float>("X", {batch_size, sequence_length, K}, x);
+  test.AddInput<float>("lora_a", {num_adapters, K, rank}, a);
+  test.AddInput<float>("lora_b", {num_adapters, rank, N}, b);
+  test.AddInput<int64_t>("adapter_indices", {batch_size}, adapter_indices);
+  test.AddInput<float>("base", {batch_size, sequence_length, N}, base);
+  test.AddOutput<float>("Y", {batch_size, sequence_length, N},
+                        ReferenceLora(x, a, b, adapter_indices, base, sequence_length, K, rank, N, scale));
+  test.Run();
+}
+
+TEST(SegmentedLoraMatMulTest, NoBase) {
+  constexpr size_t batch_size = 3, K = 3, rank = 1, N = 2, num_adapters = 2;
+  const std::vector<int32_t> adapter_indices = {1, -1, 0};
+
+  const auto x = Sequence(batch_size * K, 0.5f, 1.0f);
+  const auto a = Sequence(num_adapters * K * rank, 0.25f, -1.0f);
+  const auto b = Sequence(num_adapters * rank * N, 1.0f, 0.5f);
+
+  OpTester test("SegmentedLoraMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {batch_size, K}, x);
+  test.AddInput<float>("lora_a", {num_adapters, K, rank}, a);
+  test.AddInput<float>("lora_b", {num_adapters, rank, N}, b);
+  test.AddInput<int32_t>("adapter_indices", {batch_size}, adapter_indices);
+  test.AddOutput<float>("Y", {batch_size, N},
+                        ReferenceLora(x, a, b, {1, -1, 0}, std::vector<float>(batch_size * N, 0.0f), 1, K, rank, N,
+                                      1.0f));
+  test.Run();
+}
+
+TEST(SegmentedLoraMatMulTest, AdapterIndexOutOfRange) {
+  OpTester test("SegmentedLoraMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("X", {1, 2}, {1.0f, 2.0f});
+  test.AddInput<float>("lora_a", {1, 2, 1}, {1.0f, 1.0f});
+  test.AddInput<float>("lora_b", {1, 1, 1}, {1.0f});
+  test.AddInput<int64_t>("adapter_indices", {1}, {1});
+  test.AddOutput<float>("Y", {1, 1}, {0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "out of range for 1 adapters");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,253 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test/contrib_ops/tiny_gpt_test_helper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "gtest/gtest.h"
+#include "core/graph/model.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/test_environment.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+float Ramp(const TinyGptOptions& options, int token) {
+  return static_cast<float>((token * 11) % options.vocab_size) * 2.0f / static_cast<float>(options.vocab_size);
+}
+
+TensorProto MakeInt64Tensor(const std::string& name, const std::vector<int64_t>& values) {
+  TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(TensorProto_DataType_INT64);
+  tensor.add_dims(static_cast<int64_t>(values.size()));
+  for (int64_t value : values) {
+    tensor.add_int64_data(value);
+  }
+  return tensor;
+}
+
+TensorProto MakeInt32Scalar(const std::string& name, int32_t value) {
+  TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(TensorProto_DataType_INT32);
+  tensor.add_int32_data(value);
+  return tensor;
+}
+
+TensorProto MakeFloatTensor(const std::string& name, const std::vector<float>& values) {
+  TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(TensorProto_DataType_FLOAT);
+  tensor.add_dims(static_cast<int64_t>(values.size()));
+  for (float value : values) {
+    tensor.add_float_data(value);
+  }
+  return tensor;
+}
+
+TypeProto MakeTensorType(TensorProto_DataType elem_type, const std::vector<int64_t>& dims) {
+  // a negative dimension is a symbolic one
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (int64_t dim : dims) {
+    auto* shape_dim = shape->add_dim();
+    if (dim >= 0) {
+      shape_dim->set_dim_value(dim);
+    }
+  }
+  return type;
+}
+
+}  // namespace
+
+GraphProto CreateTinyGptSubgraph(const TinyGptOptions& options) {
+  Model model("tiny gpt", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), {{"", 17}},
+              {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  const TypeProto int32_2d = MakeTensorType(TensorProto_DataType_INT32, {-1, -1});
+  const TypeProto state_type = MakeTensorType(TensorProto_DataType_FLOAT, {2, -1, 1, -1, 1});
+  const TypeProto logits_type = MakeTensorType(TensorProto_DataType_FLOAT, {-1, -1, options.vocab_size});
+
+  // past_0 and present_0 have a shape of (2, batch_size, 1, sequence_length, 1)
+  auto& input_ids = graph.GetOrCreateNodeArg("input_ids", &int32_2d);
+  auto& position_ids = graph.GetOrCreateNodeArg("position_ids", &int32_2d);
+  auto& attention_mask = graph.GetOrCreateNodeArg("attention_mask", &int32_2d);
+  auto& past = graph.GetOrCreateNodeArg("past_0", &state_type);
+  auto& logits = graph.GetOrCreateNodeArg("logits", &logits_type);
+  auto& present = graph.GetOrCreateNodeArg("present_0", &state_type);
+
+  graph.AddInitializedTensor(MakeInt64Tensor("key_axes", {0, 2, 4}));
+  graph.AddInitializedTensor(MakeInt64Tensor("sum_axes", {0, 2, 3}));
+  graph.AddInitializedTensor(MakeInt64Tensor("key_index", {0}));
+  graph.AddInitializedTensor(MakeInt32Scalar("sequence_axis", 1));
+  graph.AddInitializedTensor(MakeInt32Scalar("vocab_size", options.vocab_size));
+  graph.AddInitializedTensor(MakeFloatTensor("one_hot_values", {0.0f, options.scale}));
+  std::vector<float> ramp(options.vocab_size);
+  for (int i = 0; i < options.vocab_size; i++) {
+    ramp[i] = Ramp(options, i);
+  }
+  graph.AddInitializedTensor(MakeFloatTensor("ramp", ramp));
+
+  auto* key_axes = graph.GetNodeArg("key_axes");
+  auto* sum_axes = graph.GetNodeArg("sum_axes");
+  auto* key_index = graph.GetNodeArg("key_index");
+  auto* sequence_axis = graph.GetNodeArg("sequence_axis");
+  auto* vocab_size = graph.GetNodeArg("vocab_size");
+  auto* one_hot_values = graph.GetNodeArg("one_hot_values");
+  auto* ramp_arg = graph.GetNodeArg("ramp");
+
+  // present_0 = past_0 followed by the tokens, as both the key and the value
+  auto& tokens = graph.GetOrCreateNodeArg("tokens", nullptr);
+  graph.AddNode("cast_tokens", "Cast", "", {&input_ids}, {&tokens})
+      .AddAttribute("to", int64_t{TensorProto_DataType_FLOAT});
+  auto& key = graph.GetOrCreateNodeArg("key", nullptr);
+  graph.AddNode("unsqueeze_key", "Unsqueeze", "", {&tokens, key_axes}, {&key});
+  auto& key_value = graph.GetOrCreateNodeArg("key_value", nullptr);
+  graph.AddNode("concat_key_value", "Concat", "", {&key, &key}, {&key_value}).AddAttribute("axis", int64_t{0});
+  graph.AddNode("concat_present", "Concat", "", {&past, &key_value}, {&present}).AddAttribute("axis", int64_t{3});
+
+  // sum of the past tokens, of shape (batch_size, 1)
+  auto& past_key = graph.GetOrCreateNodeArg("past_key", nullptr);
+  graph.AddNode("gather_past_key", "Gather", "", {&past, key_index}, {&past_key}).AddAttribute("axis", int64_t{0});
+  auto& past_sum = graph.GetOrCreateNodeArg("past_sum", nullptr);
+  graph.AddNode("reduce_past_key", "ReduceSum", "", {&past_key, sum_axes}, {&past_sum})
+      .AddAttribute("keepdims", int64_t{0});
+  auto& past_sum_int = graph.GetOrCreateNodeArg("past_sum_int", nullptr);
+  graph.AddNode("cast_past_sum", "Cast", "", {&past_sum}, {&past_sum_int})
+      .AddAttribute("to", int64_t{TensorProto_DataType_INT32});
+
+  // sum of the tokens up to each position, of shape (batch_size, sequence_length)
+  auto& prefix_sum = graph.GetOrCreateNodeArg("prefix_sum", nullptr);
+  graph.AddNode("cumsum_tokens", "CumSum", "", {&input_ids, sequence_axis}, {&prefix_sum});
+  auto& sum = graph.GetOrCreateNodeArg("sum", nullptr);
+  graph.AddNode("add_past_sum", "Add", "", {&prefix_sum, &past_sum_int}, {&sum});
+  NodeArg* sum_to_reduce = &sum;
+  if (options.sum_limit > 0) {
+    graph.AddInitializedTensor(MakeInt32Scalar("sum_limit", options.sum_limit));
+    auto& clipped_sum = graph.GetOrCreateNodeArg("clipped_sum", nullptr);
+    graph.AddNode("clip_sum", "Min", "", {&sum, graph.GetNodeArg("sum_limit")}, {&clipped_sum});
+    sum_to_reduce = &clipped_sum;
+  }
+
+  auto& next_token = graph.GetOrCreateNodeArg("next_token", nullptr);
+  graph.AddNode("mod_sum", "Mod", "", {sum_to_reduce, vocab_size}, {&next_token});
+  auto& one_hot = graph.GetOrCreateNodeArg("one_hot", nullptr);
+  graph.AddNode("one_hot_next_token", "OneHot", "", {&next_token, vocab_size, one_hot_values}, {&one_hot});
+  graph.AddNode("add_ramp", "Add", "", {&one_hot, ramp_arg}, {&logits});
+
+  graph.SetInputs({&input_ids, &position_ids, &attention_mask, &past});
+  graph.SetOutputs({&logits, &present});
+
+  EXPECT_STATUS_OK(graph.Resolve());
+  return graph.ToGraphProto();
+}
+
+std::vector<float> TinyGptLogits(const TinyGptOptions& options, gsl::span<const int32_t> tokens) {
+  int sum = std::accumulate(tokens.begin(), tokens.end(), 0);
+  if (options.sum_limit > 0) {
+    sum = std::min(sum, options.sum_limit);
+  }
+
+  std::vector<float> logits(options.vocab_size);
+  for (int i = 0; i < options.vocab_size; i++) {
+    logits[i] = (i == sum % options.vocab_size ? options.scale : 0.0f) + Ramp(options, i);
+  }
+  return logits;
+}
+
+std::vector<int32_t> TinyGptGreedySearch(const TinyGptOptions& options,
+                                         const std::vector<int32_t>& input_ids,
+                                         int batch_size,
+                                         int max_length,
+                                         int eos_token_id,
+                                         int pad_token_id) {
+  const size_t sequence_length = input_ids.size() / batch_size;
+  std::vector<int32_t> sequences;
+  for (int i = 0; i < batch_size; i++) {
+    std::vector<int32_t> sequence(input_ids.begin() + i * sequence_length,
+                                  input_ids.begin() + (i + 1) * sequence_length);
+    bool finished = false;
+    while (sequence.size() < static_cast<size_t>(max_length)) {
+      const auto logits = TinyGptLogits(options, sequence);
+      const auto next_token = static_cast<int32_t>(std::max_element(logits.begin(), logits.end()) - logits.begin());
+      finished = finished || next_token == eos_token_id;
+      sequence.push_back(finished ? pad_token_id : next_token);
+    }
+    sequences.insert(sequences.end(), sequence.begin(), sequence.end());
+  }
+  return sequences;
+}
+
+void TinyGptBeamSearch(const TinyGptOptions& options,
+                       const std::vector<int32_t>& input_ids,
+                       int batch_size,
+                       int num_beams,
+                       int max_length,
+                       std::vector<int32_t>& sequences,
+                       std::vector<float>& scores) {
+  const size_t sequence_length = input_ids.size() / batch_size;
+  const int vocab_size = options.vocab_size;
+
+  struct Beam {
+    std::vector<int32_t> sequence;
+    double score;
+  };
+
+  sequences.clear();
+  scores.clear();
+  for (int i = 0; i < batch_size; i++) {
+    // the beams start from the same prompt, and only the first one is selected in the first step
+    std::vector<Beam> beams(num_beams);
+    for (int j = 0; j < num_beams; j++) {
+      beams[j].sequence.assign(input_ids.begin() + i * sequence_length,
+                               input_ids.begin() + (i + 1) * sequence_length);
+      beams[j].score = j == 0 ? 0.0 : -1e9;
+    }
+
+    while (beams[0].sequence.size() < static_cast<size_t>(max_length)) {
+      // the score of a candidate is the log softmax of its logit plus the score of its beam
+      std::vector<std::pair<double, int>> candidates;
+      for (int j = 0; j < num_beams; j++) {
+        const auto logits = TinyGptLogits(options, beams[j].sequence);
+        const double max_logit = *std::max_element(logits.begin(), logits.end());
+        double sum = 0.0;
+        for (float logit : logits) {
+          sum += std::exp(logit - max_logit);
+        }
+        for (int token = 0; token < vocab_size; token++) {
+          candidates.emplace_back(beams[j].score + logits[token] - max_logit - std::log(sum),
+                                  j * vocab_size + token);
+        }
+      }
+      std::stable_sort(candidates.begin(), candidates.end(),
+                       [](const auto& a, const auto& b) { return a.first > b.first; });
+
+      std::vector<Beam> next_beams(num_beams);
+      for (int j = 0; j < num_beams; j++) {
+        next_beams[j].sequence = beams[candidates[j].second / vocab_size].sequence;
+        next_beams[j].sequence.push_back(candidates[j].second % vocab_size);
+        next_beams[j].score = candidates[j].first;
+      }
+      beams = std::move(next_beams);
+    }
+
+    // the final score is divided by the sequence length
+    std::stable_sort(beams.begin(), beams.end(), [](const Beam& a, const Beam& b) { return a.score > b.score; });
+    for (const auto& beam : beams) {
+      sequences.insert(sequences.end(), beam.sequence.begin(), beam.sequence.end());
+      scores.push_back(static_cast<float>(beam.score / max_length));
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+#pragma once
+
+#include <vector>
+#include <gsl/gsl>
+#include "core/graph/onnx_protobuf.h"
+
+namespace onnxruntime {
+namespace test {
+
+// A GPT-2 decoder subgraph for the GreedySearch, Sampling and BeamSearch tests, simple enough that the expected
+// sequences can be computed in the test. It has one layer with one head of size 1, and its past state holds
+// the tokens seen so far. The logits of a position are `scale` at the sum of the tokens up to that position
+// modulo the vocabulary size, plus a fixed ramp over the vocabulary so that no two tokens have the same logit.
+// So the next token depends on the whole past state, and a wrong past state changes the generated sequences.
+struct TinyGptOptions {
+  int vocab_size = 31;
+  float scale = 3.0f;
+  // When positive, the sum is clipped to it first. A decoder with a limit agrees with one without it
+  // as long as the sums stay below the limit, which makes a draft decoder for speculative decoding.
+  int sum_limit = 0;
+};
+
+ONNX_NAMESPACE::GraphProto CreateTinyGptSubgraph(const TinyGptOptions& options);
+
+// Logits of the subgraph at the last of the tokens.
+std::vector<float> TinyGptLogits(const TinyGptOptions& options, gsl::span<const int32_t> tokens);
+
+// Sequences generated by GreedySearch with the subgraph, with a shape of (batch_size, max_length).
+// input_ids has a shape of (batch_size, sequence_length).
+std::vector<int32_t> TinyGptGreedySearch(const TinyGptOptions& options,
+                                         const std::vector<int32_t>& input_ids,
+                                         int batch_size,
+                                         int max_length,
+                                         int eos_token_id,
+                                         int pad_token_id);
+
+// Sequences generated by BeamSearch with the subgraph and a length penalty of 1, with a shape of
+// (batch_size, num_beams, max_length), and their scores with a shape of (batch_size, num_beams). The beams of a batch
+// entry are ordered by score. Finished hypotheses are not modelled, so eos_token_id shall never be among the best
+// tokens.
+void TinyGptBeamSearch(const TinyGptOptions& options,
+                       const std::vector<int32_t>& input_ids,
+                       int batch_size,
+                       int num_beams,
+                       int max_length,
+                       std::vector<int32_t>& sequences,
+                       std::vector<float>& scores);
+
+}  // namespace test
+}  // namespace onnxruntime
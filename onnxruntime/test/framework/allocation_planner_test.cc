@@ -4,6 +4,8 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <cstdio>
+#include <fstream>
 #include <sstream>
 #include "gtest/gtest.h"
 
@@ -16,6 +18,7 @@ using json = nlohmann::json;
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
 #include "test/framework/model_builder_utils.h"
+#include "test/framework/test_utils.h"
 #include "core/framework/allocation_planner.h"
 #include "core/session/inference_session.h"
 #include "core/graph/model.h"
@@ -113,15 +116,25 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, bool enable_memory_aware_order = false,
+                               bool allow_inplace_on_graph_inputs = false)
+      : shape_map_(shape_map),
+        enable_memory_aware_order_(enable_memory_aware_order),
+        allow_inplace_on_graph_inputs_(allow_inplace_on_graph_inputs) {}
 
   TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  bool GetEnableMemoryAwareOrder() const override { return enable_memory_aware_order_; }
+
+  bool GetAllowInplaceOnGraphInputs() const override { return allow_inplace_on_graph_inputs_; }
+
  private:
   ShapeMap* shape_map_;
+  bool enable_memory_aware_order_;
+  bool allow_inplace_on_graph_inputs_;
 };
 
 class ParallelPlannerTestContext : public SequentialPlannerTestContext {
@@ -165,6 +178,8 @@ class PlannerTest : public ::testing::Test {
   std::unique_ptr<SessionOptions> sess_options_;
   std::unique_ptr<SessionState> state_;
   ShapeMap shape_map_;
+  bool enable_memory_aware_order_ = false;
+  bool allow_inplace_on_graph_inputs_ = false;
   std::optional<SequentialExecutionPlan> plan_;
 
  public:
@@ -308,7 +323,7 @@ class PlannerTest : public ::testing::Test {
     status = state_->FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager, {}, remove_initializers);
 
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, enable_memory_aware_order_, allow_inplace_on_graph_inputs_);
     plan_.emplace();
 
     class MockStreamHandleRegsitry : public IStreamCommandHandleRegistry {
@@ -385,6 +400,9 @@ class PlannerTest : public ::testing::Test {
   const SequentialExecutionPlan& GetPlan() const { return *plan_; }
   const SessionState& GetState() const { return *state_; }
   ExecutionProviders& GetExecutionProviders() { return execution_providers_; }
+  void EnableMemoryAwareOrder() { enable_memory_aware_order_ = true; }
+
+  void AllowInplaceOnGraphInputs() { allow_inplace_on_graph_inputs_ = true; }
   void SetNodePartitionConfigFilePath(const char* config_file_path) {
     ORT_THROW_IF_ERROR(sess_options_->config_options.AddConfigEntry(kNodePartitionConfigFile, config_file_path));
   }
@@ -489,6 +507,49 @@ TEST_F(PlannerTest, InputOutputTest) {
 
 // InPlaceTest: Check that we reuse when Inplace allows us to.
 
+// MemoryAwareOrderTest: the default order computes C before the branch that reduces A, so A and C are live at the
+// same time. With the memory aware order the branch runs first and A is freed before C is produced.
+TEST_F(PlannerTest, MemoryAwareOrderTest) {
+  std::string X("X"), A("A"), Ab("Ab"), C("C"), Y("Y");
+  std::string a("a"), b("b"), c("c"), r("r");
+  auto add_kernel = KernelDefBuilder().SetName("Add").Provider(kCpuExecutionProvider).SinceVersion(7, 12).Build();
+
+  std::vector<onnxruntime::NodeArg*> a_inputs{Arg(X)}, a_outputs{Arg(A)};
+  std::vector<onnxruntime::NodeArg*> b_inputs{Arg(A)}, b_outputs{Arg(Ab)};
+  std::vector<onnxruntime::NodeArg*> c_inputs{Arg(X)}, c_outputs{Arg(C)};
+  std::vector<onnxruntime::NodeArg*> r_inputs{Arg(C), Arg(Ab)}, r_outputs{Arg(Y)};
+  auto* node_a = AddNode(*GetStdKernel(), a, a_inputs, a_outputs);
+  auto* node_b = AddNode(*GetStdKernel(), b, b_inputs, b_outputs);
+  auto* node_c = AddNode(*GetStdKernel(), c, c_inputs, c_outputs);
+  auto* node_r = AddNode(*add_kernel, r, r_inputs, r_outputs);
+
+  Shape large_shape{50, 100};
+  Shape small_shape{1};
+  SetShape({{A, &large_shape.value}, {C, &large_shape.value}, {Ab, &small_shape.value}, {Y, &small_shape.value}});
+
+  auto get_order = [this]() {
+    std::vector<NodeIndex> order;
+    EXPECT_EQ(GetPlan().execution_plan.size(), 1U);
+    for (const auto& step : GetPlan().execution_plan[0]->steps_) {
+      if (std::find(order.begin(), order.end(), step->GetNodeIndex()) == order.end()) {
+        order.push_back(step->GetNodeIndex());
+      }
+    }
+    return order;
+  };
+
+  CreatePlan();
+  EXPECT_EQ(get_order(), (std::vector<NodeIndex>{node_c->Index(), node_a->Index(), node_b->Index(), node_r->Index()}));
+
+  EnableMemoryAwareOrder();
+  CreatePlan();
+  EXPECT_EQ(get_order(), (std::vector<NodeIndex>{node_a->Index(), node_b->Index(), node_c->Index(), node_r->Index()}));
+
+  // A is freed once b has run, C then reuses its buffer
+  CheckFreed(static_cast<int>(node_b->Index()), {A});
+  CheckAllocKind(C, AllocKind::kReuse);
+}
+
 TEST_F(PlannerTest, InPlaceTest) {
   // tensor variables:
   std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
@@ -517,6 +578,28 @@ TEST_F(PlannerTest, InPlaceTest) {
   CheckFreed(2, {X2});
 }
 
+TEST_F(PlannerTest, InPlaceOnGraphInputTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3");
+
+  // graph structure:
+  AddInplaceNode(X1, X2);  // may-in-place operator; X1: input; X2: temporary
+  AddNormalNode(X2, X3);   // no in-place operator; X3: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}});
+
+  AllowInplaceOnGraphInputs();
+  CreatePlan();
+
+  // X2 overwrites the graph input
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kReuse);
+  CheckAllocKind(X3, AllocKind::kAllocateOutput);
+}
+
 TEST_F(PlannerTest, ExternalOutputsTest) {
   // tensor variables:
   std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
@@ -1911,6 +1994,33 @@ TEST_F(PlannerTest, TestMultiStreamConfig) {
               graph_partitioner_cpu_gpu->Streams() == 2);
 }
 
+TEST_F(PlannerTest, TestBranchBasedPartitionerConfig) {
+  const char* config_file_path = "./branch_based_partitioner.json";
+  {
+    std::ofstream of_stream(config_file_path);
+    of_stream << R"({"type":"BranchBasedPartitioner","max_streams_per_device":2,"collective_stream":true})";
+  }
+
+  auto graph_partitioner = IGraphPartitioner::CreateGraphPartitioner(DefaultLoggingManager().DefaultLogger(),
+                                                                     ORT_TSTR("./branch_based_partitioner.json"));
+  ASSERT_TRUE(graph_partitioner);
+  EXPECT_STREQ(graph_partitioner->Type(), "BranchBasedPartitioner");
+
+  // cpu nodes stay on a single stream, and the session output must not change
+  SessionOptions sess_opt;
+  sess_opt.graph_optimization_level = TransformerLevel::Default;
+  ASSERT_STATUS_OK(sess_opt.config_options.AddConfigEntry(kNodePartitionConfigFile, config_file_path));
+
+  InferenceSession sess(sess_opt, GetEnvironment(), ORT_TSTR("./testdata/multi_stream_models/conv_add_relu.onnx"));
+  ASSERT_STATUS_OK(sess.RegisterExecutionProvider(DefaultCpuExecutionProvider()));
+  ASSERT_STATUS_OK(sess.Load());
+  ASSERT_STATUS_OK(sess.Initialize());
+
+  const auto* exe_plan = sess.GetSessionState().GetExecutionPlan();
+  EXPECT_EQ(exe_plan->execution_plan.size(), 1u);
+  std::remove(config_file_path);
+}
+
 // Save partition config to a file and check its completeness
 TEST_F(PlannerTest, TestMultiStreamSaveConfig) {
   const char* config_file_path = "./testdata/multi_stream_models/conv_add_relu_single_stream.json";
@@ -2095,6 +2205,82 @@ TEST(AllocationPlannerTest, ReusedInputCrossDifferentStreams) {
 }
 #endif
 
+// SequenceInsert and SequenceErase may reuse their input sequence. Check that the planner hands the sequence built by
+// SequenceConstruct through both of them, and that the kernels update it in place correctly.
+TEST(AllocationPlannerTest, SequenceInsertAndEraseReuseInputSequence) {
+  onnxruntime::Model model("sequence_in_place", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 17}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  TensorProto position;
+  position.set_name("position");
+  position.set_data_type(TensorProto_DataType_INT64);
+  position.add_int64_data(0);
+  graph.AddInitializedTensor(position);
+
+  auto& a = graph.GetOrCreateNodeArg("a", &float_tensor);
+  auto& b = graph.GetOrCreateNodeArg("b", &float_tensor);
+  auto& c = graph.GetOrCreateNodeArg("c", &float_tensor);
+  auto& constructed = graph.GetOrCreateNodeArg("constructed", nullptr);
+  auto& inserted = graph.GetOrCreateNodeArg("inserted", nullptr);
+  auto& erased = graph.GetOrCreateNodeArg("erased", nullptr);
+  auto& concat = graph.GetOrCreateNodeArg("concat", nullptr);
+
+  // [a, b] -> [a, b, c] -> [b, c]
+  graph.AddNode("construct", "SequenceConstruct", "", {&a, &b}, {&constructed});
+  graph.AddNode("insert", "SequenceInsert", "", {&constructed, &c}, {&inserted});
+  graph.AddNode("erase", "SequenceErase", "", {&inserted, graph.GetNodeArg("position")}, {&erased});
+  graph.AddNode("concat", "ConcatFromSequence", "", {&erased}, {&concat}).AddAttribute("axis", int64_t{0});
+  graph.SetInputs({&a, &b, &c});
+  graph.SetOutputs({&concat});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+  std::stringstream model_stream(model_data);
+
+  SessionOptions so;
+  InferenceSession sess{so, GetEnvironment()};
+  ASSERT_STATUS_OK(sess.Load(model_stream));
+  ASSERT_STATUS_OK(sess.Initialize());
+
+  const auto& session_state = sess.GetSessionState();
+  const auto& ort_value_index_map = session_state.GetOrtValueNameIdxMap();
+  const SequentialExecutionPlan* plan = session_state.GetExecutionPlan();
+
+  OrtValueIndex constructed_index, inserted_index, erased_index;
+  ASSERT_STATUS_OK(ort_value_index_map.GetIdx("constructed", constructed_index));
+  ASSERT_STATUS_OK(ort_value_index_map.GetIdx("inserted", inserted_index));
+  ASSERT_STATUS_OK(ort_value_index_map.GetIdx("erased", erased_index));
+  EXPECT_EQ(plan->allocation_plan[constructed_index].alloc_kind, AllocKind::kAllocate);
+  EXPECT_EQ(plan->allocation_plan[inserted_index].alloc_kind, AllocKind::kReuse);
+  EXPECT_EQ(plan->allocation_plan[inserted_index].reused_buffer, constructed_index);
+  EXPECT_EQ(plan->allocation_plan[erased_index].alloc_kind, AllocKind::kReuse);
+  EXPECT_EQ(plan->allocation_plan[erased_index].reused_buffer, constructed_index);
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  NameMLValMap feeds;
+  CreateMLValue<float>(allocator, {2}, {1.0f, 2.0f}, &feeds["a"]);
+  CreateMLValue<float>(allocator, {2}, {3.0f, 4.0f}, &feeds["b"]);
+  CreateMLValue<float>(allocator, {2}, {5.0f, 6.0f}, &feeds["c"]);
+
+  // run twice, the second run must not see the sequence updated by the first one
+  for (int run = 0; run < 2; ++run) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(sess.Run(RunOptions{}, feeds, {"concat"}, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    const auto& output = fetches[0].Get<Tensor>();
+    EXPECT_EQ(output.Shape(), TensorShape({4}));
+    const auto values = output.DataAsSpan<float>();
+    EXPECT_EQ(std::vector<float>(values.begin(), values.end()), (std::vector<float>{3.0f, 4.0f, 5.0f, 6.0f}));
+  }
+}
+
 #ifdef ENABLE_TRAINING_OPS
 // use a carefully constructed model to re-produce a customer reported issue where a model produced invalid output.
 // this issue required:
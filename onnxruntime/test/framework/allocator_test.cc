@@ -4,6 +4,8 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/allocator_utils.h"
+#include "core/framework/huge_page_allocator.h"
+#include "core/mlas/inc/mlas.h"
 
 #include "test_utils.h"
 #include "gtest/gtest.h"
@@ -31,6 +33,28 @@ TEST(AllocatorTest, CPUAllocatorTest) {
   cpu_arena->Free(bytes);
   // todo: test the used / max api.
 }
+TEST(AllocatorTest, HugePageCPUAllocatorTest) {
+  HugePageCPUAllocator allocator;
+
+  // small allocations use the default allocator, large ones are backed by huge pages if possible
+  for (size_t size : {size_t{1024}, HugePageCPUAllocator::kMinHugePageAllocationSize, size_t{5 * 1024 * 1024 + 7}}) {
+    auto* bytes = static_cast<uint8_t*>(allocator.Alloc(size));
+    ASSERT_NE(bytes, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(bytes) % MlasGetPreferredBufferAlignment(), 0u);
+    memset(bytes, -1, size);
+    EXPECT_EQ(bytes[size - 1], 0xFF);
+    allocator.Free(bytes);
+  }
+
+  // a CPU execution provider using huge pages
+  CPUExecutionProviderInfo info{/*use_arena*/ true, /*use_huge_pages*/ true};
+  auto allocator_ptr = CPUExecutionProvider(info).CreatePreferredAllocators()[0];
+  void* p = allocator_ptr->Alloc(4 * 1024 * 1024);
+  ASSERT_NE(p, nullptr);
+  memset(p, 0, 4 * 1024 * 1024);
+  allocator_ptr->Free(p);
+}
+
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(disable : 26400)
 #endif
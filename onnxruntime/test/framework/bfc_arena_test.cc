@@ -7,6 +7,7 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -307,6 +308,98 @@ TEST(BFCArenaTest, TestShrink) {
   EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "Expect 10M bytes but actually " << stats.total_allocated_bytes << " bytes";
 }
 
+TEST(BFCArenaTest, TestThreadCache) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             /*thread_cache_max_bytes*/ 4096);
+
+  void* p1 = a.Alloc(1000);
+  a.Free(p1);
+  // same size class is serviced from the cache
+  void* p2 = a.Alloc(1024);
+  EXPECT_EQ(p1, p2);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_hits, 1);
+  EXPECT_EQ(stats.num_thread_cache_misses, 1);
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(stats.bytes_in_use, 1024);
+
+  // chunks larger than the maximum cached size bypass the cache
+  void* large = a.Alloc(1024 * 1024);
+  a.Free(large);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_misses, 1);
+
+  // a chunk that doesn't fit in the cache goes back to the arena
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 5; ++i) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+  a.Free(p2);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 4096) << "cached chunks are still in use from the arena's point of view";
+
+  // Shrink returns cached chunks to the arena
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+
+  // buffers can be freed on a different thread than the one that allocated them
+  void* p3 = a.Alloc(512);
+  std::thread t([&a, p3]() { a.Free(p3); });
+  t.join();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 512);
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, TestShrinkIdleRegions) {
+  AllocatorStats stats;
+  // a long interval so the background thread doesn't run during the test and the regions are shrunk explicitly
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             BFCArena::DEFAULT_THREAD_CACHE_MAX_BYTES, /*idle_shrink_interval_ms*/ 3600 * 1000);
+
+  void* p10M = a.Alloc(10 * 1024 * 1024);
+  void* p1M = a.Alloc(1024 * 1024);
+  a.Free(p1M);
+
+  a.ShrinkIdleRegions();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_shrinkages, 0) << "p1M was allocated in the interval that just ended";
+
+  a.ShrinkIdleRegions();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_shrinkages, 1) << "the region of p1M was idle for a whole interval";
+  EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024);
+
+  a.Free(p10M);
+  a.ShrinkIdleRegions();
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "the memory of the recent peak is kept";
+
+  // the recent peak halves every interval so the idle region is eventually freed
+  for (int i = 0; i < 32 && stats.total_allocated_bytes != 0; ++i) {
+    a.ShrinkIdleRegions();
+    a.GetStats(&stats);
+  }
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+  EXPECT_EQ(stats.num_arena_shrinkages, 2);
+
+  // the arena can still be extended
+  void* p = a.Alloc(1024);
+  EXPECT_NE(p, nullptr);
+  a.Free(p);
+}
+
 class BadAllocator : public IAllocator {
  public:
   BadAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
@@ -414,6 +507,39 @@ TEST(StreamAwareArenaTest, TestSecureTheChunk) {
   EXPECT_TRUE(waitFunctionInvoked) << "wait function should be invoked";
   a.Free(p2);
 }
+
+TEST(StreamAwareArenaTest, CrossStreamReuse) {
+  StreamAwareArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, true);
+  OrtDevice tmp;
+  StreamMock stream1(tmp), stream2(tmp);
+
+  void* p1 = a.AllocOnStream(BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, &stream1, nullptr);
+  a.Free(p1);
+
+  // stream2 reuses part of the chunk freed on stream1
+  int num_waits = 0;
+  auto wait_fn = [&num_waits](Stream&, synchronize::Notification&) { ++num_waits; };
+  void* p2 = a.AllocOnStream(4096, &stream2, wait_fn);
+  EXPECT_EQ(p2, p1);
+  EXPECT_EQ(num_waits, 1);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 4096);
+
+  // the rest of the chunk stays available to stream1
+  void* p3 = a.AllocOnStream(4096, &stream1, wait_fn);
+  EXPECT_EQ(p3, static_cast<char*>(p1) + 4096);
+  EXPECT_EQ(num_waits, 1);
+
+  // the chunk of p2 is now on stream2, so stream1 doesn't reuse it while it has memory of its own
+  a.Free(p2);
+  void* p4 = a.AllocOnStream(4096, &stream1, wait_fn);
+  EXPECT_EQ(p4, static_cast<char*>(p1) + 8192);
+  EXPECT_EQ(num_waits, 1);
+
+  a.Free(p3);
+  a.Free(p4);
+}
 #endif
 
 TEST(BFCArenaTest, TestExtendStrategy) {
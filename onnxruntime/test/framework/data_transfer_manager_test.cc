@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/data_transfer_manager.h"
+
+#include <cstring>
+
+#include "core/framework/tensor.h"
+#include "gtest/gtest.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// copies between CPU buffers labelled with the given devices, and records the size of each batch
+class RecordingDataTransfer : public IDataTransfer {
+ public:
+  RecordingDataTransfer(OrtDevice::DeviceType src_type, OrtDevice::DeviceType dst_type,
+                        std::vector<size_t>& batch_sizes)
+      : src_type_(src_type), dst_type_(dst_type), batch_sizes_(batch_sizes) {}
+
+  bool CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const override {
+    return src_device.Type() == src_type_ && dst_device.Type() == dst_type_;
+  }
+
+  using IDataTransfer::CopyTensor;
+  Status CopyTensor(const Tensor& src, Tensor& dst) const override {
+    memcpy(dst.MutableDataRaw(), src.DataRaw(), src.SizeInBytes());
+    return Status::OK();
+  }
+
+  Status CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const override {
+    batch_sizes_.push_back(src_dst_pairs.size());
+    return IDataTransfer::CopyTensors(src_dst_pairs);
+  }
+
+ private:
+  const OrtDevice::DeviceType src_type_;
+  const OrtDevice::DeviceType dst_type_;
+  std::vector<size_t>& batch_sizes_;
+};
+
+}  // namespace
+
+TEST(DataTransferManagerTest, CopyTensorsBatchesPerDataTransfer) {
+  std::vector<size_t> to_gpu_batches;
+  std::vector<size_t> to_cpu_batches;
+  DataTransferManager data_transfer_manager;
+  ASSERT_STATUS_OK(data_transfer_manager.RegisterDataTransfer(
+      std::make_unique<RecordingDataTransfer>(OrtDevice::CPU, OrtDevice::GPU, to_gpu_batches)));
+  ASSERT_STATUS_OK(data_transfer_manager.RegisterDataTransfer(
+      std::make_unique<RecordingDataTransfer>(OrtDevice::GPU, OrtDevice::CPU, to_cpu_batches)));
+
+  const OrtMemoryInfo cpu_location(CPU, OrtDeviceAllocator);
+  const OrtMemoryInfo gpu_location("FakeGpu", OrtDeviceAllocator,
+                                   OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0));
+  const auto float_type = DataTypeImpl::GetType<float>();
+  const TensorShape shape({2});
+
+  // copies alternate between the two directions
+  std::vector<float> src_values{1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f};
+  std::vector<float> dst_values(src_values.size(), 0.f);
+  std::vector<Tensor> src_tensors;
+  std::vector<Tensor> dst_tensors;
+  src_tensors.reserve(4);
+  dst_tensors.reserve(4);
+  for (size_t i = 0; i < 4; ++i) {
+    const bool to_gpu = i % 2 == 0;
+    src_tensors.emplace_back(float_type, shape, src_values.data() + i * 2, to_gpu ? cpu_location : gpu_location);
+    dst_tensors.emplace_back(float_type, shape, dst_values.data() + i * 2, to_gpu ? gpu_location : cpu_location);
+  }
+
+  std::vector<IDataTransfer::SrcDstPair> src_dst_pairs;
+  for (size_t i = 0; i < 4; ++i) {
+    src_dst_pairs.push_back({src_tensors[i], dst_tensors[i], nullptr});
+  }
+
+  ASSERT_STATUS_OK(data_transfer_manager.CopyTensors(src_dst_pairs));
+
+  EXPECT_EQ(to_gpu_batches, std::vector<size_t>{2});
+  EXPECT_EQ(to_cpu_batches, std::vector<size_t>{2});
+  EXPECT_EQ(dst_values, src_values);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
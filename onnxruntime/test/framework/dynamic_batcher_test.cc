@@ -0,0 +1,183 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <thread>
+
+#include "core/framework/tensor.h"
+#include "core/session/dynamic_batcher.h"
+#include "gtest/gtest.h"
+#include "test/util/include/affine_model.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+void ExpectDoubled(const OrtValue& x, const OrtValue& y) {
+  ASSERT_EQ(x.Get<Tensor>().Shape(), y.Get<Tensor>().Shape());
+  auto x_data = x.Get<Tensor>().DataAsSpan<float>();
+  auto y_data = y.Get<Tensor>().DataAsSpan<float>();
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    EXPECT_EQ(y_data[i], 2 * x_data[i]);
+  }
+}
+}  // namespace
+
+TEST(DynamicBatcherTest, CoalescesConcurrentRequests) {
+  AffineModel model{2.f, 0.f};
+  DynamicBatcher::Options options;
+  options.max_batch_size = 4;
+  // long enough for all the requests to arrive. the batch is executed as soon as it is full.
+  options.timeout = std::chrono::seconds(10);
+  DynamicBatcher batcher(options, model.GetRunFn(), GetTestCpuAllocator());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  constexpr int kNumRequests = 4;
+  std::vector<OrtValue> feeds;
+  std::vector<std::vector<OrtValue>> fetches(kNumRequests);
+  std::vector<Status> statuses(kNumRequests);
+  for (int i = 0; i < kNumRequests; ++i) {
+    feeds.push_back(CreateRampTensor({1, 3}, 10.0f * i));
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumRequests; ++i) {
+    threads.emplace_back([&, i]() {
+      statuses[i] = batcher.Run(RunOptions{}, feed_names, gsl::make_span(&feeds[i], 1), output_names, &fetches[i]);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(model.batch_sizes, std::vector<int64_t>{kNumRequests});
+  for (int i = 0; i < kNumRequests; ++i) {
+    ASSERT_STATUS_OK(statuses[i]);
+    ASSERT_EQ(fetches[i].size(), 1u);
+    ExpectDoubled(feeds[i], fetches[i][0]);
+  }
+}
+
+TEST(DynamicBatcherTest, TimeoutAndIncompatibleRequests) {
+  AffineModel model{2.f, 0.f};
+  DynamicBatcher::Options options;
+  options.max_batch_size = 8;
+  options.timeout = std::chrono::milliseconds(1);
+  DynamicBatcher batcher(options, model.GetRunFn(), GetTestCpuAllocator());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+
+  // a single request is executed once the timeout expires
+  auto x = CreateRampTensor({2, 3}, 1.0f);
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(batcher.Run(RunOptions{}, feed_names, gsl::make_span(&x, 1), output_names, &fetches));
+  ExpectDoubled(x, fetches[0]);
+
+  // requests with different inner dimensions are never batched together
+  auto x_a = CreateRampTensor({1, 3}, 0.0f);
+  auto x_b = CreateRampTensor({1, 4}, 0.0f);
+  std::vector<OrtValue> fetches_a, fetches_b;
+  Status status_a, status_b;
+  std::thread thread_a([&]() {
+    status_a = batcher.Run(RunOptions{}, feed_names, gsl::make_span(&x_a, 1), output_names, &fetches_a);
+  });
+  std::thread thread_b([&]() {
+    status_b = batcher.Run(RunOptions{}, feed_names, gsl::make_span(&x_b, 1), output_names, &fetches_b);
+  });
+  thread_a.join();
+  thread_b.join();
+  ASSERT_STATUS_OK(status_a);
+  ASSERT_STATUS_OK(status_b);
+  ExpectDoubled(x_a, fetches_a[0]);
+  ExpectDoubled(x_b, fetches_b[0]);
+
+  // a request that fills a batch on its own bypasses the queue
+  auto x_full = CreateRampTensor({8, 3}, 0.0f);
+  ASSERT_STATUS_OK(batcher.Run(RunOptions{}, feed_names, gsl::make_span(&x_full, 1), output_names, &fetches));
+  ExpectDoubled(x_full, fetches[0]);
+
+  EXPECT_EQ(model.batch_sizes, (std::vector<int64_t>{2, 1, 1, 8}));
+}
+
+TEST(DynamicBatcherTest, RequestsWithDifferentRunOptions) {
+  AffineModel model{2.f, 0.f};
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  auto x_a = CreateRampTensor({1, 3}, 0.0f);
+  auto x_b = CreateRampTensor({1, 3}, 5.0f);
+
+  auto run_pair = [&](std::chrono::microseconds timeout, const RunOptions& run_options_a,
+                      const RunOptions& run_options_b) {
+    DynamicBatcher::Options options;
+    options.max_batch_size = 2;
+    options.timeout = timeout;
+    DynamicBatcher batcher(options, model.GetRunFn(), GetTestCpuAllocator());
+
+    std::vector<OrtValue> fetches_a, fetches_b;
+    Status status_a, status_b;
+    std::thread thread_a([&]() {
+      status_a = batcher.Run(run_options_a, feed_names, gsl::make_span(&x_a, 1), output_names, &fetches_a);
+    });
+    std::thread thread_b([&]() {
+      status_b = batcher.Run(run_options_b, feed_names, gsl::make_span(&x_b, 1), output_names, &fetches_b);
+    });
+    thread_a.join();
+    thread_b.join();
+    ASSERT_STATUS_OK(status_a);
+    ASSERT_STATUS_OK(status_b);
+    ExpectDoubled(x_a, fetches_a[0]);
+    ExpectDoubled(x_b, fetches_b[0]);
+  };
+
+  // the tag only names the run in the logs, so the requests are batched. the batch runs as soon as it is full.
+  RunOptions tagged_a, tagged_b;
+  tagged_a.run_tag = "a";
+  tagged_b.run_tag = "b";
+  run_pair(std::chrono::seconds(10), tagged_a, tagged_b);
+  EXPECT_EQ(model.batch_sizes, std::vector<int64_t>{2});
+
+  // a run config entry may change how the model runs, so the requests are run separately
+  RunOptions configured;
+  ASSERT_STATUS_OK(configured.config_options.AddConfigEntry("test.key", "1"));
+  model.batch_sizes.clear();
+  run_pair(std::chrono::milliseconds(100), RunOptions{}, configured);
+  EXPECT_EQ(model.batch_sizes, (std::vector<int64_t>{1, 1}));
+}
+
+TEST(DynamicBatcherTest, PreallocatedOutputs) {
+  AffineModel model{2.f, 0.f};
+  DynamicBatcher::Options options;
+  options.max_batch_size = 2;
+  options.timeout = std::chrono::seconds(10);
+  DynamicBatcher batcher(options, model.GetRunFn(), GetTestCpuAllocator());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  auto x_a = CreateRampTensor({1, 2}, 1.0f);
+  auto x_b = CreateRampTensor({1, 2}, 5.0f);
+  std::vector<OrtValue> fetches_a{CreateRampTensor({1, 2}, 0.0f)};
+  std::vector<OrtValue> fetches_b;
+  const void* preallocated_buffer = fetches_a[0].Get<Tensor>().DataRaw();
+
+  Status status_a, status_b;
+  std::thread thread_a([&]() {
+    status_a = batcher.Run(RunOptions{}, feed_names, gsl::make_span(&x_a, 1), output_names, &fetches_a);
+  });
+  std::thread thread_b([&]() {
+    status_b = batcher.Run(RunOptions{}, feed_names, gsl::make_span(&x_b, 1), output_names, &fetches_b);
+  });
+  thread_a.join();
+  thread_b.join();
+
+  ASSERT_STATUS_OK(status_a);
+  ASSERT_STATUS_OK(status_b);
+  EXPECT_EQ(model.batch_sizes, std::vector<int64_t>{2});
+  EXPECT_EQ(fetches_a[0].Get<Tensor>().DataRaw(), preallocated_buffer);
+  ExpectDoubled(x_a, fetches_a[0]);
+  ExpectDoubled(x_b, fetches_b[0]);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -119,6 +119,85 @@ TEST_F(ExecutionFrameTest, TensorAllocationTest) {
   ASSERT_EQ(tensor2->Data<float>(), p_tensor->Data<float>());
 }
 
+TEST_F(ExecutionFrameTest, ObjectArenaReuseTest) {
+  onnxruntime::Model model("test", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), output_def("Y", &tensor_float);
+
+  onnxruntime::Node* node = &graph.AddNode("node1", "Relu", "Relu operator", ArgMap{&input_def}, ArgMap{&output_def});
+  node->SetExecutionProviderType(kCpuExecutionProvider);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_typ = cpu_xp->Type();
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_typ, std::move(cpu_xp)));
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  ExternalDataLoaderManager edlm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = false;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm, edlm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+
+  const auto& memory_info = execution_providers.Get(xp_typ)->GetOrtDeviceByMemType(OrtMemTypeDefault);
+
+  // allocates the Tensor of the node input, which isn't a graph output, in a new frame
+  auto run_frame = [&](OrtValue* value_to_keep) {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({}, {}, {}, outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                         {},
+#endif
+                         state);
+
+    int start_index = frame.GetNodeOffset(node->Index());
+    OrtValue& ort_value = *frame.GetMutableNodeInputOrOutputMLValue(start_index);
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(ort_value, start_index, DataTypeImpl::GetType<float>(),
+                                                              memory_info, TensorShape({2, 3})));
+    if (value_to_keep != nullptr) {
+      *value_to_keep = ort_value;
+    }
+  };
+
+  run_frame(nullptr);
+  auto arena = state.AcquireFrameObjectArena();
+  const size_t num_block_allocations = arena->NumBlockAllocations();
+  ASSERT_EQ(num_block_allocations, 1u);
+  FrameObjectArena* first_arena = arena.get();
+  state.ReleaseFrameObjectArena(std::move(arena));
+
+  // the steady state reuses the arena without allocating
+  for (int i = 0; i < 3; ++i) {
+    run_frame(nullptr);
+  }
+
+  arena = state.AcquireFrameObjectArena();
+  ASSERT_EQ(arena.get(), first_arena);
+  ASSERT_EQ(arena->NumBlockAllocations(), num_block_allocations);
+  state.ReleaseFrameObjectArena(std::move(arena));
+
+  // an arena can't be reused while a value allocated from it is alive
+  OrtValue kept_value;
+  run_frame(&kept_value);
+  arena = state.AcquireFrameObjectArena();
+  ASSERT_NE(arena.get(), first_arena);
+  ASSERT_EQ(kept_value.Get<Tensor>().Shape(), TensorShape({2, 3}));
+}
+
 TEST_F(ExecutionFrameTest, OutputShapeValidationTest) {
   onnxruntime::Model model("test", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
                            {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
@@ -0,0 +1,149 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cctype>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/framework/fallback_cpu_capability.h"
+#include "core/framework/kernel_def_builder.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test/test_environment.h"
+#include "asserts.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+
+namespace {
+constexpr const char* kTestProvider = "FallbackCpuCapabilityTestProvider";
+
+// Looks up a kernel of the target EP for every op type, with the shape input of Reshape on CPU like the device EPs.
+class TestKernelLookup : public IExecutionProvider::IKernelLookup {
+ public:
+  TestKernelLookup() {
+    for (const char* op_type : {"Gather", "Concat", "Reshape"}) {
+      KernelDefBuilder builder;
+      builder.SetName(op_type).SetDomain(kOnnxDomain).SinceVersion(1).Provider(kTestProvider);
+      if (std::string(op_type) == "Reshape") {
+        builder.InputMemoryType(OrtMemTypeCPUInput, 1);
+      }
+      kernels_.emplace(op_type, KernelCreateInfo(builder.Build(), nullptr));
+    }
+  }
+
+  const KernelCreateInfo* LookUpKernel(const Node& node) const override {
+    auto it = kernels_.find(node.OpType());
+    return it != kernels_.end() ? &it->second : nullptr;
+  }
+
+ private:
+  std::unordered_map<std::string, KernelCreateInfo> kernels_;
+};
+
+TensorProto MakeInt64Initializer(const std::string& name, const std::vector<int64_t>& values) {
+  TensorProto tensor;
+  tensor.set_name(name);
+  tensor.set_data_type(TensorProto_DataType_INT64);
+  tensor.add_dims(static_cast<int64_t>(values.size()));
+  for (int64_t value : values) {
+    tensor.add_int64_data(value);
+  }
+  return tensor;
+}
+
+TypeProto MakeTensorType(TensorProto_DataType elem_type, const std::vector<std::string>& dims) {
+  // a dim that is not a number is a symbolic one
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  auto* shape = type.mutable_tensor_type()->mutable_shape();
+  for (const auto& dim : dims) {
+    if (!dim.empty() && std::isdigit(static_cast<unsigned char>(dim[0]))) {
+      shape->add_dim()->set_dim_value(std::stoll(dim));
+    } else {
+      shape->add_dim()->set_dim_param(dim);
+    }
+  }
+  return type;
+}
+
+// Builds Y = Reshape(X, Concat(Gather(data, [0, 1]), [-1])), where the shape of Reshape is consumed on CPU by the
+// target EP, and returns the names of the nodes placed on CPU when all the nodes are tentatively on the target EP.
+// data is an initializer if data_dims is empty, or a graph input of the given dims otherwise.
+std::unordered_set<std::string> GetCpuPreferredNodeNames(const std::vector<std::string>& data_dims) {
+  Model model("fallback_cpu_capability", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 17}}, {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  const TypeProto x_type = MakeTensorType(TensorProto_DataType_FLOAT, {"2", "3", "4"});
+  auto& x = graph.GetOrCreateNodeArg("X", &x_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", nullptr);
+
+  NodeArg* data = nullptr;
+  std::vector<const NodeArg*> inputs{&x};
+  if (data_dims.empty()) {
+    graph.AddInitializedTensor(MakeInt64Initializer("data", {2, 3, 4}));
+    data = &graph.GetOrCreateNodeArg("data", nullptr);
+  } else {
+    const TypeProto data_type = MakeTensorType(TensorProto_DataType_INT64, data_dims);
+    data = &graph.GetOrCreateNodeArg("data", &data_type);
+    inputs.push_back(data);
+  }
+
+  graph.AddInitializedTensor(MakeInt64Initializer("indices", {0, 1}));
+  graph.AddInitializedTensor(MakeInt64Initializer("minus_one", {-1}));
+  auto& gathered = graph.GetOrCreateNodeArg("gathered", nullptr);
+  auto& shape = graph.GetOrCreateNodeArg("shape", nullptr);
+
+  graph.AddNode("gather", "Gather", "", {data, graph.GetNodeArg("indices")}, {&gathered});
+  graph.AddNode("concat", "Concat", "", {&gathered, graph.GetNodeArg("minus_one")}, {&shape})
+      .AddAttribute("axis", int64_t{0});
+  graph.AddNode("reshape", "Reshape", "", {&x, &shape}, {&y});
+
+  graph.SetInputs(inputs);
+  graph.SetOutputs({&y});
+  EXPECT_STATUS_OK(graph.Resolve());
+
+  GraphViewer graph_viewer(graph);
+  std::vector<NodeIndex> tentative_nodes;
+  for (const auto& node : graph.Nodes()) {
+    tentative_nodes.push_back(node.Index());
+  }
+
+  TestKernelLookup kernel_lookup;
+  std::unordered_set<std::string> cpu_node_names;
+  for (NodeIndex index : GetCpuPreferredNodes(graph_viewer, kernel_lookup, tentative_nodes,
+                                              DefaultLoggingManager().DefaultLogger())) {
+    cpu_node_names.insert(graph.GetNode(index)->Name());
+  }
+  return cpu_node_names;
+}
+}  // namespace
+
+// a shape computation from small initializers feeding the shape of Reshape is placed on CPU
+TEST(FallbackCpuCapabilityTest, ShapeChainFromInitializersMovesToCpu) {
+  const auto cpu_nodes = GetCpuPreferredNodeNames({});
+  EXPECT_EQ(cpu_nodes, (std::unordered_set<std::string>{"gather", "concat"}));
+}
+
+// the same for a small int64 graph input of a known shape
+TEST(FallbackCpuCapabilityTest, ShapeChainFromSmallGraphInputMovesToCpu) {
+  const auto cpu_nodes = GetCpuPreferredNodeNames({"3"});
+  EXPECT_EQ(cpu_nodes, (std::unordered_set<std::string>{"gather", "concat"}));
+}
+
+// a large int64 graph input, like token ids, is headed for the device, so its consumers stay there as well
+TEST(FallbackCpuCapabilityTest, LargeGraphInputStaysOnDevice) {
+  EXPECT_TRUE(GetCpuPreferredNodeNames({"512"}).empty());
+}
+
+// as does one whose size is not known
+TEST(FallbackCpuCapabilityTest, DynamicGraphInputStaysOnDevice) {
+  EXPECT_TRUE(GetCpuPreferredNodeNames({"sequence_length"}).empty());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,313 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/profiler.h"
+#include "core/framework/allocator.h"
+#include "core/framework/config_options.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/graph_partitioner.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/graph/model.h"
+#include "core/optimizer/layout_transformation/layout_transformation.h"
+#include "core/platform/env.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/util/thread_utils.h"
+#include "gtest/gtest.h"
+#include "test/test_environment.h"
+#include "asserts.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+
+namespace {
+constexpr const char* kPartitionTestProvider = "PartitionTestExecutionProvider";
+
+// Claims the nodes with the given names, each in its own partition to compile. The compiled function state of a
+// partition is the name of its fused node. With concurrent_compile, the partitions are compiled concurrently and
+// the later claimed nodes take less time, so that they finish first. Compiling the partition of failing_node fails.
+class PartitionTestExecutionProvider : public IExecutionProvider {
+ public:
+  PartitionTestExecutionProvider(OrtDevice device, std::vector<std::string> claimed_nodes,
+                                 bool concurrent_compile = false, std::string failing_node = {})
+      : IExecutionProvider{kPartitionTestProvider, device},
+        claimed_nodes_{std::move(claimed_nodes)},
+        concurrent_compile_{concurrent_compile},
+        failing_node_{std::move(failing_node)} {}
+
+  std::vector<std::unique_ptr<ComputeCapability>>
+  GetCapability(const GraphViewer& graph_viewer, const IKernelLookup& /*kernel_lookup*/) const override {
+    std::vector<std::unique_ptr<ComputeCapability>> result;
+    for (NodeIndex index : graph_viewer.GetNodesInTopologicalOrder()) {
+      const Node& node = *graph_viewer.GetNode(index);
+      if (std::find(claimed_nodes_.begin(), claimed_nodes_.end(), node.Name()) == claimed_nodes_.end()) {
+        continue;
+      }
+
+      auto meta_def = std::make_unique<IndexedSubGraph::MetaDef>();
+      meta_def->name = "PartitionTest_" + node.Name();
+      meta_def->domain = kMSDomain;
+      meta_def->since_version = 1;
+      meta_def->status = ONNX_NAMESPACE::EXPERIMENTAL;
+      for (const auto* input : node.InputDefs()) {
+        meta_def->inputs.push_back(input->Name());
+      }
+      for (const auto* output : node.OutputDefs()) {
+        meta_def->outputs.push_back(output->Name());
+      }
+
+      auto sub_graph = std::make_unique<IndexedSubGraph>();
+      sub_graph->nodes.push_back(index);
+      sub_graph->SetMetaDef(std::move(meta_def));
+      result.push_back(std::make_unique<ComputeCapability>(std::move(sub_graph)));
+    }
+    return result;
+  }
+
+  common::Status Compile(const std::vector<FusedNodeAndGraph>& fused_nodes_and_graphs,
+                         std::vector<NodeComputeInfo>& node_compute_funcs) override {
+    for (const auto& fused_node_and_graph : fused_nodes_and_graphs) {
+      const GraphViewer& graph_viewer = fused_node_and_graph.filtered_graph;
+      const std::string& node_name = graph_viewer.GetNode(graph_viewer.GetNodesInTopologicalOrder()[0])->Name();
+      ORT_RETURN_IF(node_name == failing_node_, "Failed to compile ", node_name);
+
+      if (concurrent_compile_) {
+        const auto position = std::find(claimed_nodes_.begin(), claimed_nodes_.end(), node_name) -
+                              claimed_nodes_.begin();
+        const auto remaining_nodes = static_cast<int64_t>(claimed_nodes_.size()) - position;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10 * remaining_nodes));
+      }
+
+      NodeComputeInfo compute_info;
+      compute_info.create_state_func = [fused_node_name = fused_node_and_graph.fused_node.get().Name()](
+                                           ComputeContext*, FunctionState* state) {
+        *state = new std::string(fused_node_name);
+        return 0;
+      };
+      compute_info.compute_func = [](FunctionState, const OrtApi*, OrtKernelContext*) { return Status::OK(); };
+      compute_info.release_state_func = [](FunctionState state) { delete static_cast<std::string*>(state); };
+      node_compute_funcs.push_back(std::move(compute_info));
+    }
+    return Status::OK();
+  }
+
+  bool ConcurrentCompileSupported() const override { return concurrent_compile_; }
+
+ private:
+  std::vector<std::string> claimed_nodes_;
+  bool concurrent_compile_;
+  std::string failing_node_;
+};
+
+// Partitions the graph for the test EP followed by the CPU EP.
+Status PartitionGraph(Graph& graph, std::unique_ptr<IExecutionProvider> test_ep, const ConfigOptions& config_options,
+                      FuncManager& func_mgr, concurrency::ThreadPool* compile_thread_pool = nullptr,
+                      profiling::Profiler* profiler = nullptr) {
+  ExecutionProviders execution_providers;
+  ORT_RETURN_IF_ERROR(execution_providers.Add(kPartitionTestProvider, std::move(test_ep)));
+  ORT_RETURN_IF_ERROR(execution_providers.Add(kCpuExecutionProvider,
+                                              std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo{})));
+
+  KernelRegistryManager krm;
+  ORT_RETURN_IF_ERROR(krm.RegisterKernels(execution_providers));
+
+  GraphPartitioner partitioner(krm, execution_providers, compile_thread_pool, profiler);
+  return partitioner.Partition(
+      graph, func_mgr,
+      [](Graph& graph, bool& modified, const IExecutionProvider& execution_provider,
+         const layout_transformation::DebugGraphFn& debug_graph_fn) -> Status {
+        AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+        return layout_transformation::TransformLayoutForEP(
+            graph, modified, execution_provider, std::move(cpu_allocator), debug_graph_fn);
+      },
+      config_options, DefaultLoggingManager().DefaultLogger());
+}
+
+TypeProto MakeFloatTensorType(int64_t size) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(size);
+  return type;
+}
+
+// Builds Y = Relu(Add(Relu(X), C)) of float tensors of kSize elements, where C is an initializer.
+// The Add node, named "island", computes kSize elements from one input and to one output copied from and to the
+// host if it runs on a device, so it has 1 / 8 operations per copied byte.
+constexpr int64_t kSize = 1024;
+
+std::unique_ptr<Model> CreateIslandModel() {
+  auto model = std::make_unique<Model>("graph_partitioner", false, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model->MainGraph();
+
+  const TypeProto type = MakeFloatTensorType(kSize);
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& relu_in_output = graph.GetOrCreateNodeArg("relu_in_output", &type);
+  auto& island_output = graph.GetOrCreateNodeArg("island_output", &type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &type);
+
+  TensorProto c;
+  c.set_name("C");
+  c.set_data_type(TensorProto_DataType_FLOAT);
+  c.add_dims(kSize);
+  for (int64_t i = 0; i < kSize; ++i) {
+    c.add_float_data(static_cast<float>(i));
+  }
+  graph.AddInitializedTensor(c);
+
+  graph.AddNode("relu_in", "Relu", "", {&x}, {&relu_in_output});
+  graph.AddNode("island", "Add", "", {&relu_in_output, graph.GetNodeArg("C")}, {&island_output});
+  graph.AddNode("relu_out", "Relu", "", {&island_output}, {&y});
+  EXPECT_STATUS_OK(graph.Resolve());
+  return model;
+}
+
+// Partitions the island model with the island claimed by an EP on a GPU device, and returns whether it was kept.
+bool IsIslandOffloaded(const std::string& min_ops_per_byte) {
+  auto model = CreateIslandModel();
+  Graph& graph = model->MainGraph();
+
+  ConfigOptions config_options;
+  if (!min_ops_per_byte.empty()) {
+    EXPECT_STATUS_OK(config_options.AddConfigEntry(kOrtSessionOptionsPartitioningCostModelMinOpsPerByte,
+                                                   min_ops_per_byte.c_str()));
+  }
+
+  FuncManager func_mgr;
+  auto test_ep = std::make_unique<PartitionTestExecutionProvider>(
+      OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0), std::vector<std::string>{"island"});
+  EXPECT_STATUS_OK(PartitionGraph(graph, std::move(test_ep), config_options, func_mgr));
+
+  bool offloaded = false;
+  for (const auto& node : graph.Nodes()) {
+    if (node.Name() == "island") {
+      EXPECT_EQ(node.GetExecutionProviderType(), kCpuExecutionProvider);
+    } else if (node.GetExecutionProviderType() == kPartitionTestProvider) {
+      offloaded = true;
+    }
+  }
+  return offloaded;
+}
+
+// Builds a chain of kNumChainNodes Relu nodes named relu_0, relu_1, ... on a float tensor.
+constexpr int kNumChainNodes = 6;
+
+std::unique_ptr<Model> CreateChainModel(std::vector<std::string>& node_names) {
+  auto model = std::make_unique<Model>("graph_partitioner", false, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model->MainGraph();
+
+  const TypeProto type = MakeFloatTensorType(4);
+  NodeArg* input = &graph.GetOrCreateNodeArg("X", &type);
+  node_names.clear();
+  for (int i = 0; i < kNumChainNodes; ++i) {
+    node_names.push_back("relu_" + std::to_string(i));
+    NodeArg* output = &graph.GetOrCreateNodeArg(i + 1 < kNumChainNodes ? node_names.back() + "_output" : "Y", &type);
+    graph.AddNode(node_names.back(), "Relu", "", {input}, {output});
+    input = output;
+  }
+  EXPECT_STATUS_OK(graph.Resolve());
+  return model;
+}
+
+std::unique_ptr<concurrency::ThreadPool> CreateCompileThreadPool() {
+  OrtThreadPoolParams thread_pool_params;
+  thread_pool_params.thread_pool_size = 4;
+  return concurrency::CreateThreadPool(&Env::Default(), thread_pool_params, concurrency::ThreadPoolType::INTRA_OP);
+}
+}  // namespace
+
+TEST(GraphPartitionerTest, CostModelDisabledByDefault) {
+  EXPECT_TRUE(IsIslandOffloaded(""));
+}
+
+TEST(GraphPartitionerTest, CostModelKeepsSubGraphAboveMinOpsPerByte) {
+  EXPECT_TRUE(IsIslandOffloaded("0.1"));
+}
+
+TEST(GraphPartitionerTest, CostModelDropsSubGraphBelowMinOpsPerByte) {
+  EXPECT_FALSE(IsIslandOffloaded("1"));
+}
+
+// each partition compiled concurrently gets its own compiled functions, whatever the order the compilations finish
+TEST(GraphPartitionerTest, ConcurrentCompileKeepsPartitionOrder) {
+  std::vector<std::string> node_names;
+  auto model = CreateChainModel(node_names);
+  Graph& graph = model->MainGraph();
+  auto thread_pool = CreateCompileThreadPool();
+
+  FuncManager func_mgr;
+  auto test_ep = std::make_unique<PartitionTestExecutionProvider>(OrtDevice(), node_names, true);
+  ASSERT_STATUS_OK(PartitionGraph(graph, std::move(test_ep), ConfigOptions{}, func_mgr, thread_pool.get()));
+
+  int num_fused_nodes = 0;
+  for (const auto& node : graph.Nodes()) {
+    ASSERT_EQ(node.GetExecutionProviderType(), kPartitionTestProvider) << node.Name();
+    ++num_fused_nodes;
+
+    const NodeComputeInfo* compute_info = nullptr;
+    ASSERT_STATUS_OK(func_mgr.GetFuncs(node.Name(), compute_info));
+    FunctionState state = nullptr;
+    ASSERT_EQ(compute_info->create_state_func(nullptr, &state), 0);
+    EXPECT_EQ(*static_cast<std::string*>(state), node.Name());
+    compute_info->release_state_func(state);
+  }
+  EXPECT_EQ(num_fused_nodes, kNumChainNodes);
+}
+
+TEST(GraphPartitionerTest, ConcurrentCompileReturnsPartitionError) {
+  std::vector<std::string> node_names;
+  auto model = CreateChainModel(node_names);
+  auto thread_pool = CreateCompileThreadPool();
+
+  FuncManager func_mgr;
+  auto test_ep = std::make_unique<PartitionTestExecutionProvider>(OrtDevice(), node_names, true, "relu_3");
+  const auto status = PartitionGraph(model->MainGraph(), std::move(test_ep), ConfigOptions{}, func_mgr,
+                                     thread_pool.get());
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_NE(status.ErrorMessage().find("Failed to compile relu_3"), std::string::npos) << status.ErrorMessage();
+}
+
+TEST(GraphPartitionerTest, ConcurrentCompileProfilesEachPartition) {
+  std::vector<std::string> node_names;
+  auto model = CreateChainModel(node_names);
+  Graph& graph = model->MainGraph();
+  auto thread_pool = CreateCompileThreadPool();
+
+  profiling::Profiler profiler;
+  profiler.StartProfiling(std::string("graph_partitioner_test_concurrent_compile.json"));
+
+  FuncManager func_mgr;
+  auto test_ep = std::make_unique<PartitionTestExecutionProvider>(OrtDevice(), node_names, true);
+  ASSERT_STATUS_OK(PartitionGraph(graph, std::move(test_ep), ConfigOptions{}, func_mgr, thread_pool.get(),
+                                  &profiler));
+
+  const std::string profile_file = profiler.EndProfiling();
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile.good());
+  const std::string events{std::istreambuf_iterator<char>(profile), std::istreambuf_iterator<char>()};
+  profile.close();
+  std::remove(profile_file.c_str());
+
+  int num_fused_nodes = 0;
+  for (const auto& node : graph.Nodes()) {
+    ++num_fused_nodes;
+    const std::string event_name = "\"name\" :\"" + node.Name() + "_compile\"";
+    const auto first = events.find(event_name);
+    ASSERT_NE(first, std::string::npos) << node.Name() << " in " << events;
+    EXPECT_EQ(events.find(event_name, first + 1), std::string::npos) << node.Name() << " in " << events;
+  }
+  EXPECT_EQ(num_fused_nodes, kNumChainNodes);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
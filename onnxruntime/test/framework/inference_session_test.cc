@@ -6,8 +6,11 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <cstring>
+#include <filesystem>
 #include <functional>
 #include <iterator>
+#include <set>
 #include <thread>
 #include <fstream>
 
@@ -43,6 +46,7 @@
 #include "core/providers/rocm/gpu_data_transfer.h"
 #endif
 #include "core/session/environment.h"
+#include "core/session/ep_selection.h"
 #include "core/session/IOBinding.h"
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -55,6 +59,7 @@
 #include "test/optimizer/dummy_graph_transformer.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/inference_session_wrapper.h"
+#include "test/util/include/temp_dir.h"
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -419,6 +424,127 @@ TEST(InferenceSessionTests, OnlyExecutePathToFetches) {
   RunModel(session_object, run_options);
 }
 
+// the runs with the same feed and output names reuse the feeds and fetches info of the previous run
+TEST(InferenceSessionTests, RepeatedRunsWithSameNames) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.RepeatedRunsWithSameNames";
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options, true);
+  RunModel(session_object, run_options);
+}
+
+TEST(InferenceSessionTests, PreparedRun) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.PreparedRun";
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::unique_ptr<InferenceSession::PreparedRun> prepared_run;
+  ASSERT_STATUS_NOT_OK(session_object.PrepareRun(std::vector<std::string>{"X"}, std::vector<std::string>{"Z"},
+                                                 prepared_run));
+  ASSERT_STATUS_OK(session_object.PrepareRun(std::vector<std::string>{"X"}, std::vector<std::string>{"Y"},
+                                             prepared_run));
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_mul_x, values_mul_x,
+                       &ml_value);
+
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  RunOptions run_options;
+  const OrtValue* feeds[] = {&ml_value};
+  for (int i = 0; i < 3; ++i) {
+    OrtValue* fetches[] = {nullptr};
+    ASSERT_STATUS_OK(session_object.Run(run_options, *prepared_run, feeds, fetches));
+    std::unique_ptr<OrtValue> fetch{fetches[0]};
+    VerifyOutputs(fetch->Get<Tensor>(), expected_dims_mul_y, expected_values_mul_y);
+  }
+
+  // the values are still checked by position
+  std::vector<int64_t> values_int = {1, 2, 3, 4, 5, 6};
+  OrtValue int_value;
+  CreateMLValue<int64_t>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_mul_x, values_int,
+                         &int_value);
+  const OrtValue* wrong_feeds[] = {&int_value};
+  OrtValue* fetches[] = {nullptr};
+  ASSERT_STATUS_NOT_OK(session_object.Run(run_options, *prepared_run, wrong_feeds, fetches));
+  ASSERT_STATUS_NOT_OK(session_object.Run(run_options, *prepared_run, {}, fetches));
+
+  // a prepared run is bound to the session that created it
+  InferenceSession other_session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(other_session.Load(MODEL_URI));
+  ASSERT_STATUS_OK(other_session.Initialize());
+  ASSERT_STATUS_NOT_OK(other_session.Run(run_options, *prepared_run, feeds, fetches));
+}
+
+// the runs alternating between output names, from several threads, each get the outputs they asked for
+TEST(InferenceSessionTests, ConcurrentRunsWithAlternatingNames) {
+  std::unordered_map<std::string, int> domain_to_version{{onnxruntime::kOnnxDomain, 13}};
+  Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version,
+              {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &tensor_float);
+  auto& y = graph.GetOrCreateNodeArg("Y", &tensor_float);
+  auto& z = graph.GetOrCreateNodeArg("Z", &tensor_float);
+  graph.AddNode("abs", "Abs", "", {&x}, {&y});
+  graph.AddNode("neg", "Neg", "", {&x}, {&z});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  std::stringstream model_stream(model_data);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ConcurrentRunsWithAlternatingNames";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const std::vector<float> x_values{-1.0f, 2.0f, -3.0f};
+  const std::unordered_map<std::string, std::vector<float>> expected_values{{"Y", {1.0f, 2.0f, 3.0f}},
+                                                                            {"Z", {1.0f, -2.0f, 3.0f}}};
+  const std::vector<std::vector<std::string>> output_names_per_run{{"Y"}, {"Z"}, {"Y", "Z"}, {"Z", "Y"}};
+
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3}, x_values, &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+
+  std::vector<std::thread> threads;
+  for (size_t thread_index = 0; thread_index < 4; ++thread_index) {
+    threads.emplace_back([&, thread_index]() {
+      for (size_t run = 0; run < 20; ++run) {
+        const auto& output_names = output_names_per_run[(thread_index + run) % output_names_per_run.size()];
+        std::vector<OrtValue> fetches;
+        ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+        ASSERT_EQ(fetches.size(), output_names.size());
+        for (size_t i = 0; i < output_names.size(); ++i) {
+          auto values = fetches[i].Get<Tensor>().DataAsSpan<float>();
+          EXPECT_EQ(std::vector<float>(values.begin(), values.end()), expected_values.at(output_names[i]));
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 TEST(InferenceSessionTests, DisableCPUArena) {
   SessionOptions so;
 
@@ -434,6 +560,151 @@ TEST(InferenceSessionTests, DisableCPUArena) {
   RunModel(session_object, run_options);
 }
 
+TEST(InferenceSessionTests, RunWithIntraOpLimits) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.RunWithIntraOpLimits";
+  so.intra_op_param.thread_pool_size = 4;
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigIntraOpNumThreads, "2"));
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigIntraOpPriority, "high"));
+  RunModel(session_object, run_options);
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_mul_x, values_mul_x,
+                       &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+
+  RunOptions invalid_priority;
+  ASSERT_STATUS_OK(invalid_priority.config_options.AddConfigEntry(kOrtRunOptionsConfigIntraOpPriority, "urgent"));
+  auto status = session_object.Run(invalid_priority, feeds, output_names, &fetches);
+  ASSERT_FALSE(status.IsOK());
+  ASSERT_THAT(status.ErrorMessage(), testing::HasSubstr(kOrtRunOptionsConfigIntraOpPriority));
+
+  RunOptions invalid_num_threads;
+  ASSERT_STATUS_OK(invalid_num_threads.config_options.AddConfigEntry(kOrtRunOptionsConfigIntraOpNumThreads, "-1"));
+  status = session_object.Run(invalid_num_threads, feeds, output_names, &fetches);
+  ASSERT_FALSE(status.IsOK());
+  ASSERT_THAT(status.ErrorMessage(), testing::HasSubstr(kOrtRunOptionsConfigIntraOpNumThreads));
+}
+
+TEST(InferenceSessionTests, Clone) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.Clone";
+
+  InferenceSession session_object{so, GetEnvironment()};
+  std::unique_ptr<InferenceSession> clone;
+  ASSERT_FALSE(session_object.Clone(so, clone).IsOK());
+
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  SessionOptions clone_so;
+  clone_so.session_logid = "InferenceSessionTests.Clone.Clone";
+  clone_so.intra_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(session_object.Clone(clone_so, clone));
+  ASSERT_TRUE(clone->IsInitialized());
+
+  // the kernels and initializers are shared, the thread pools are not
+  const auto& session_state = session_object.GetSessionState();
+  const auto& clone_session_state = clone->GetSessionState();
+  ASSERT_NE(session_state.GetThreadPool(), clone_session_state.GetThreadPool());
+  for (const auto& node : session_state.GetGraphViewer().Nodes()) {
+    ASSERT_NE(session_state.GetKernel(node.Index()), nullptr);
+    ASSERT_EQ(session_state.GetKernel(node.Index()), clone_session_state.GetKernel(node.Index()));
+  }
+
+  ASSERT_EQ(session_state.GetInitializedTensors().size(), clone_session_state.GetInitializedTensors().size());
+  for (const auto& [idx, value] : session_state.GetInitializedTensors()) {
+    auto entry = clone_session_state.GetInitializedTensors().find(idx);
+    ASSERT_NE(entry, clone_session_state.GetInitializedTensors().end());
+    ASSERT_EQ(value.Get<Tensor>().DataRaw(), entry->second.Get<Tensor>().DataRaw());
+  }
+
+  RunOptions run_options;
+  RunModel(*clone, run_options);
+
+  // the source keeps working once the clone is gone
+  clone.reset();
+  RunModel(session_object, run_options);
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+TEST(InferenceSessionTests, ShapeSpecialization) {
+  TemporaryDirectory model_dir(ORT_TSTR("shape_specialization_test"));
+  const PathString model_file_name = model_dir.Path() + ORT_TSTR("/abs_symbolic_batch.onnx");
+  {
+    onnxruntime::Model model("abs_symbolic_batch", false, ModelMetaData(), PathString(),
+                             IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {},
+                             DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    ONNX_NAMESPACE::TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+    auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+    auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+    std::vector<onnxruntime::NodeArg*> inputs = {&input_arg};
+    std::vector<onnxruntime::NodeArg*> outputs = {&output_arg};
+    graph.AddNode("abs", "Abs", "abs", inputs, outputs);
+    ASSERT_STATUS_OK(graph.Resolve());
+    ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+  }
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ShapeSpecialization";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsShapeSpecializationMaxSessions, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsShapeSpecializationMinRuns, "2"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto run = [&session_object](int64_t batch) {
+    std::vector<int64_t> dims = {batch, 2};
+    std::vector<float> values(static_cast<size_t>(batch * 2));
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = -static_cast<float>(i);
+    }
+
+    OrtValue value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &value);
+    NameMLValMap feeds{{"X", value}};
+    const std::vector<std::string> output_names = {"Y"};
+    std::vector<OrtValue> fetches;
+    RunOptions run_options;
+    ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+
+    ASSERT_EQ(fetches.size(), 1u);
+    const auto& output = fetches[0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), TensorShape(dims));
+    for (size_t i = 0; i < values.size(); ++i) {
+      ASSERT_EQ(output.Data<float>()[i], static_cast<float>(i));
+    }
+  };
+
+  // the copy for a batch of 3 is built by its second run and used from then on
+  run(3);
+  ASSERT_EQ(session_object.GetNumShapeSpecializedSessions(), 0u);
+  run(3);
+  ASSERT_EQ(session_object.GetNumShapeSpecializedSessions(), 1u);
+  run(3);
+
+  // other batch sizes keep using the session once the maximum number of copies is reached
+  run(5);
+  run(5);
+  ASSERT_EQ(session_object.GetNumShapeSpecializedSessions(), 1u);
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 TEST(InferenceSessionTests, TestModelSerialization) {
   // Load model with level 0 transform level
   // and assert that the model has Identity nodes.
@@ -496,6 +767,73 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  TemporaryDirectory cache_dir(ORT_TSTR("optimized_model_cache_test"));
+  const std::string test_model = "testdata/transform/abs-id-max.onnx";
+
+  auto get_cached_files = [&cache_dir]() {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir.Path())) {
+      files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+  };
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCache";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsOptimizedModelCacheDir,
+                                                    ToUTF8String(cache_dir.Path()).c_str()));
+
+  // the first session optimizes the model and saves it
+  {
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(test_model));
+    ASSERT_STATUS_OK(session_object.Initialize());
+  }
+  auto cached_files = get_cached_files();
+  ASSERT_EQ(cached_files.size(), 1u);
+  ASSERT_EQ(cached_files[0].extension(), ".ort");
+  const auto cached_file_time = std::filesystem::last_write_time(cached_files[0]);
+
+  // the next session loads the optimized model, without the Identity nodes the optimizers removed
+  {
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(test_model));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    ASSERT_EQ(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+  }
+  ASSERT_EQ(get_cached_files(), cached_files);
+  ASSERT_EQ(std::filesystem::last_write_time(cached_files[0]), cached_file_time);
+
+  // other options produce another optimized model
+  {
+    SessionOptions so_noopt = so;
+    so_noopt.graph_optimization_level = TransformerLevel::Default;
+    InferenceSessionWrapper session_object{so_noopt, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(test_model));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    ASSERT_GT(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+  }
+  ASSERT_EQ(get_cached_files().size(), 2u);
+
+  // a file that can't be loaded is replaced
+  {
+    std::ofstream corrupted(cached_files[0], std::ios::binary | std::ios::trunc);
+    corrupted << "not an ORT format model";
+  }
+  {
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(test_model));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    ASSERT_EQ(CountOpsInGraph(session_object.GetGraph())["Identity"], 0);
+  }
+  ASSERT_GT(std::filesystem::file_size(cached_files[0]), std::strlen("not an ORT format model"));
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -852,6 +1190,286 @@ TEST(InferenceSessionTests, CheckRunProfilerWithOptionalValues) {
   VerifyOutputs<int>(fetches.at(0).Get<Tensor>(), expected_dims_y, expected_values_y);
 }
 
+TEST(InferenceSessionTests, CheckRunProfilerWithHardwareCounters) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerWithHardwareCounters";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_hardware_counters_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsProfilingHardwareCounters, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+  bool has_kernel_event = false;
+  while (std::getline(profile, line)) {
+    if (line.find("_kernel_time") == std::string::npos) {
+      continue;
+    }
+    has_kernel_event = true;
+    // the counters are not available on every machine (e.g. in VMs), but they are added together
+    if (line.find("cpu_cycles") != std::string::npos) {
+      ASSERT_NE(line.find("instructions"), std::string::npos);
+      ASSERT_NE(line.find("llc_misses"), std::string::npos);
+      ASSERT_NE(line.find("llc_miss_bytes"), std::string::npos);
+    }
+  }
+  ASSERT_TRUE(has_kernel_event);
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerWithRoofline) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerWithRoofline";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_roofline_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsProfilingRooflinePeakGflops, "100"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsProfilingRooflinePeakGbps, "10"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+  bool has_kernel_event = false;
+  while (std::getline(profile, line)) {
+    if (line.find("_kernel_time") == std::string::npos) {
+      continue;
+    }
+    has_kernel_event = true;
+    // the Mul of the model has 6 output elements
+    ASSERT_NE(line.find(R"("flops" : "6")"), std::string::npos);
+    ASSERT_NE(line.find(R"("bytes" : ")"), std::string::npos);
+    ASSERT_NE(line.find(R"("gflops_per_s" : ")"), std::string::npos);
+    ASSERT_NE(line.find(R"("gb_per_s" : ")"), std::string::npos);
+  }
+  ASSERT_TRUE(has_kernel_event);
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerSessionCreationPhases) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerSessionCreationPhases";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_session_creation_test");
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+  std::set<std::string> phases;
+  const std::vector<std::string> expected = {"graph_transformation", "graph_partitioning", "initializer_loading",
+                                             "kernel_creation", "prepacking"};
+  while (std::getline(profile, line)) {
+    for (const auto& phase : expected) {
+      if (line.find("\"phase\" : \"" + phase + "\"") != std::string::npos) {
+        phases.insert(phase);
+      }
+    }
+  }
+
+  ASSERT_EQ(phases.size(), expected.size());
+}
+
+TEST(InferenceSessionTests, CheckRunProfilerSampling) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerSampling";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsProfilingSamplingInterval, "2"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_FALSE(session_object.GetProfiling().IsEnabled());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  for (int i = 0; i < 4; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  // runs 0 and 2 are sampled
+  std::string statistics = session_object.GetProfilingStatistics(/*reset*/ true);
+  ASSERT_NE(statistics.find("\"sampled_runs\" : 2"), std::string::npos) << statistics;
+  ASSERT_NE(statistics.find(R"("op_type" : "Mul", "count" : 2)"), std::string::npos) << statistics;
+  ASSERT_NE(statistics.find("\"histogram\" : ["), std::string::npos) << statistics;
+
+  // the statistics were reset, so only the runs after the previous call are reported
+  RunModel(session_object, run_options);
+  statistics = session_object.GetProfilingStatistics(/*reset*/ false);
+  ASSERT_NE(statistics.find("\"sampled_runs\" : 1"), std::string::npos) << statistics;
+  ASSERT_NE(statistics.find(R"("op_type" : "Mul", "count" : 1)"), std::string::npos) << statistics;
+}
+
+TEST(InferenceSessionTests, GetMemoryTimeline) {
+  SessionOptions so;
+  so.session_logid = "GetMemoryTimeline";
+
+  InferenceSession session_object(so, GetEnvironment());
+  std::string timeline;
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_FALSE(session_object.GetMemoryTimeline(timeline).IsOK());
+
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_STATUS_OK(session_object.GetMemoryTimeline(timeline));
+
+  // mul_1 has a single Mul node that produces the graph output
+  ASSERT_NE(timeline.find(R"("op_type" : "Mul")"), std::string::npos) << timeline;
+  ASSERT_NE(timeline.find(R"("name" : "Y")"), std::string::npos) << timeline;
+  ASSERT_NE(timeline.find(R"("source" : "output")"), std::string::npos) << timeline;
+  ASSERT_NE(timeline.find("\"peaks\" : ["), std::string::npos) << timeline;
+}
+
+TEST(InferenceSessionTests, GetMetrics) {
+  SessionOptions so;
+  so.session_logid = "GetMetrics";
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  const std::string metrics = session_object.GetMetrics();
+  ASSERT_NE(metrics.find("# TYPE onnxruntime_session_run_duration_seconds histogram"), std::string::npos) << metrics;
+  ASSERT_NE(metrics.find(R"(onnxruntime_session_run_duration_seconds_bucket{session_id="GetMetrics",le="+Inf"} 2)"),
+            std::string::npos)
+      << metrics;
+  ASSERT_NE(metrics.find(R"(onnxruntime_session_run_duration_seconds_count{session_id="GetMetrics"} 2)"),
+            std::string::npos)
+      << metrics;
+  ASSERT_NE(metrics.find(R"(onnxruntime_session_run_failures_total{session_id="GetMetrics"} 0)"), std::string::npos)
+      << metrics;
+  ASSERT_NE(metrics.find(R"(onnxruntime_session_nodes{session_id="GetMetrics",provider="CPUExecutionProvider"} 1)"),
+            std::string::npos)
+      << metrics;
+  ASSERT_NE(metrics.find(R"(onnxruntime_session_fallback_nodes{session_id="GetMetrics"} 0)"), std::string::npos)
+      << metrics;
+  ASSERT_NE(metrics.find("onnxruntime_session_allocator_in_use_bytes"), std::string::npos) << metrics;
+}
+
+TEST(InferenceSessionTests, Warmup) {
+  SessionOptions so;
+  so.session_logid = "Warmup";
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const std::vector<std::unordered_map<std::string, TensorShape>> input_shapes = {{{"X", TensorShape({3, 2})}},
+                                                                                  {{"X", TensorShape({3, 2})}}};
+  ASSERT_STATUS_OK(session_object.Warmup(input_shapes));
+
+  const std::vector<std::unordered_map<std::string, TensorShape>> invalid_shapes = {{{"Z", TensorShape({3, 2})}}};
+  ASSERT_STATUS_NOT_OK(session_object.Warmup(invalid_shapes));
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  // the warmup runs are not counted
+  const std::string metrics = session_object.GetMetrics();
+  ASSERT_NE(metrics.find(R"(onnxruntime_session_run_duration_seconds_count{session_id="Warmup"} 1)"),
+            std::string::npos)
+      << metrics;
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+TEST(InferenceSessionTests, SelectFastestCandidate) {
+  TemporaryDirectory cache_dir(ORT_TSTR("ep_selection_test"));
+
+  std::vector<std::string> fingerprints = {"cpu", "cpu_no_arena", "failing"};
+  std::string key;
+  ASSERT_STATUS_OK(ep_selection::GetDecisionKey(MODEL_URI, fingerprints, key));
+
+  std::vector<size_t> created;
+  auto create_session = [&created](size_t index, std::unique_ptr<InferenceSession>& session) -> Status {
+    created.push_back(index);
+    if (index == 2) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "candidate 2 fails");
+    }
+
+    SessionOptions so;
+    so.enable_cpu_mem_arena = index == 0;
+    session = std::make_unique<InferenceSession>(so, GetEnvironment());
+    ORT_RETURN_IF_ERROR(session->Load(MODEL_URI));
+    return session->Initialize();
+  };
+
+  ep_selection::SelectionOptions options;
+  options.num_runs = 3;
+  options.cache_file = cache_dir.Path() / ORT_TSTR("decisions.txt");
+
+  size_t selected_index = 0;
+  ASSERT_STATUS_OK(ep_selection::SelectFastestCandidate(key, fingerprints.size(), create_session, options,
+                                                        DefaultLoggingManager().DefaultLogger(), selected_index));
+  ASSERT_THAT(created, testing::ElementsAre(0, 1, 2));
+  ASSERT_LT(selected_index, 2u);
+
+  // the decision is read from the cache without creating any session
+  created.clear();
+  size_t cached_index = 3;
+  ASSERT_STATUS_OK(ep_selection::SelectFastestCandidate(key, fingerprints.size(), create_session, options,
+                                                        DefaultLoggingManager().DefaultLogger(), cached_index));
+  ASSERT_TRUE(created.empty());
+  ASSERT_EQ(cached_index, selected_index);
+
+  // other candidates have another key
+  fingerprints.pop_back();
+  std::string other_key;
+  ASSERT_STATUS_OK(ep_selection::GetDecisionKey(MODEL_URI, fingerprints, other_key));
+  ASSERT_NE(other_key, key);
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+TEST(InferenceSessionTests, IntraOpSpinDuringRun) {
+  SessionOptions so;
+  so.session_logid = "IntraOpSpinDuringRun";
+  so.intra_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigIntraOpSpinDuringRun, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+
+  // the jitter of the runs
+  const std::string metrics = session_object.GetMetrics();
+  ASSERT_NE(metrics.find("# TYPE onnxruntime_session_run_duration_recent_seconds summary"), std::string::npos)
+      << metrics;
+  ASSERT_NE(metrics.find(R"(onnxruntime_session_run_duration_recent_seconds{session_id="IntraOpSpinDuringRun",)"
+                         R"(quantile="0.99"})"),
+            std::string::npos)
+      << metrics;
+  ASSERT_NE(metrics.find(R"(onnxruntime_session_run_duration_recent_seconds_count{session_id="IntraOpSpinDuringRun"} 2)"),
+            std::string::npos)
+      << metrics;
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
@@ -1985,6 +2603,53 @@ TEST(InferenceSessionTests, TestTruncatedSequence) {
   }
 }
 
+// Y = X * W, with Y fed back to X by the next run
+TEST(InferenceSessionTests, StreamingStates) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.StreamingStates";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsStreamingStates, "X:Y"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const std::vector<int64_t> dims = {3, 2};
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims,
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &x);
+  const NameMLValMap feeds{{"X", x}};
+  const std::vector<std::string> output_names{"Y"};
+  RunOptions run_options;
+
+  // the first run feeds the state
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, dims, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(run_options, NameMLValMap{}, output_names, &fetches));
+  VerifyOutputs(fetches, dims, {1.0f, 8.0f, 27.0f, 64.0f, 125.0f, 216.0f});
+
+  // a run without the states neither reads nor updates them
+  RunOptions stateless_run_options;
+  ASSERT_STATUS_OK(stateless_run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigUseStreamingStates, "0"));
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(stateless_run_options, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, dims, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+
+  // the state output doesn't have to be requested
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(run_options, NameMLValMap{}, std::vector<std::string>{}, &fetches));
+  EXPECT_TRUE(fetches.empty());
+  ASSERT_STATUS_OK(session_object.Run(run_options, NameMLValMap{}, output_names, &fetches));
+  VerifyOutputs(fetches, dims, {1.0f, 32.0f, 243.0f, 1024.0f, 3125.0f, 7776.0f});
+
+  // a new sequence must feed the state again
+  session_object.ResetStreamingStates();
+  fetches.clear();
+  EXPECT_FALSE(session_object.Run(run_options, NameMLValMap{}, output_names, &fetches).IsOK());
+}
+
 // create the feeds and fetches using the dummy allocator so that we have to copy to CPU to execute, and from
 // CPU to return in utils::ExecuteGraph. Call InferenceSession::Run twice to test the caching of the copy logic.
 TEST(InferenceSessionTests, TestCopyToFromDevices) {
@@ -2,9 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/framework/allocator.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/optimizer/auto_mixed_precision.h"
 #include "core/optimizer/insert_cast_transformer.h"
 #include "core/graph/model.h"
 #include "core/graph/node_attr_utils.h"
+#include "core/mlas/inc/mlas.h"
 #include "gtest/gtest.h"
 #include "test_utils.h"
 #include "test/test_environment.h"
@@ -306,6 +309,13 @@ TEST(TransformerTest, Fp16NodeWithSubgraph) {
   std::map<std::string, int> new_subgraph_ops = CountOpsInGraph(subgraph, recurse_into_subgraphs);
 
   EXPECT_EQ(new_graph_ops.find("Cast"), new_graph_ops.cend()) << "Main graph should not have been altered.";
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+  // the CPU EP has an fp16 Add kernel when the CPU has fp16 arithmetic
+  if (MlasFp16AccelerationSupported()) {
+    EXPECT_EQ(new_subgraph_ops.find("Cast"), new_subgraph_ops.cend()) << "'Add' node in subgraph runs in fp16";
+    return;
+  }
+#endif
   EXPECT_EQ(new_subgraph_ops.find("Cast")->second, 3) << "'Add' node in subgraph should have had Casts added";
 }
 
@@ -371,5 +381,72 @@ TEST(TransformerTest, IsIsolatedFp16NodeOnCpuTest) {
   EXPECT_EQ(ops["Cast"], 4);
 }
 
+TEST(TransformerTest, AutoMixedPrecisionTest) {
+  auto model = std::make_shared<onnxruntime::Model>("test", false, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model->MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg x_def("X", &tensor_float),
+      r1_def("R1", &tensor_float),
+      y_def("Y", &tensor_float),
+      z_def("Z", &tensor_float);
+
+  // X -> Relu -> Relu -> Y
+  //          |
+  //          -> Abs -> Z
+  // Only Relu has a float16 kernel, and Abs is not in the list of ops to convert.
+  auto& node1 = graph.AddNode("node1", "Relu", "fp16", ArgMap{&x_def}, ArgMap{&r1_def});
+  auto& node2 = graph.AddNode("node2", "Relu", "fp16", ArgMap{&r1_def}, ArgMap{&y_def});
+  auto& node3 = graph.AddNode("node3", "Abs", "fp32", ArgMap{&r1_def}, ArgMap{&z_def});
+  for (auto* node : {&node1, &node2, &node3}) {
+    node->SetExecutionProviderType(kCudaExecutionProvider);
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  auto kernel_registry = std::make_shared<KernelRegistry>();
+  KernelDefBuilder relu_def;
+  relu_def.SetName("Relu")
+      .SetDomain(kOnnxDomain)
+      .SinceVersion(14)
+      .Provider(kCudaExecutionProvider)
+      .TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>());
+  ASSERT_STATUS_OK(kernel_registry->Register(
+      relu_def, [](FuncManager&, const OpKernelInfo&, std::unique_ptr<OpKernel>&) { return Status::OK(); }));
+  KernelRegistryManager kernel_registry_manager;
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+
+  AutoMixedPrecision transformer(TensorProto_DataType_FLOAT16, kernel_registry_manager);
+  bool modified = false;
+  ASSERT_STATUS_OK(transformer.Apply(graph, modified, DefaultLoggingManager().DefaultLogger()));
+  EXPECT_TRUE(modified);
+
+  auto is_type = [](const NodeArg& node_arg, const MLDataType type) {
+    return node_arg.Type() != nullptr &&
+           DataTypeImpl::TypeFromProto(*node_arg.TypeAsProto()) == type;
+  };
+
+  // X -> Cast -> Relu -> Relu -> Cast -> Y
+  //                   |
+  //                   -> Cast -> Abs -> Z
+  EXPECT_TRUE(is_type(*node1.InputDefs()[0], DataTypeImpl::GetTensorType<MLFloat16>()));
+  EXPECT_TRUE(is_type(*node1.OutputDefs()[0], DataTypeImpl::GetTensorType<MLFloat16>()));
+  EXPECT_EQ(node2.InputDefs()[0], node1.OutputDefs()[0]);
+  EXPECT_TRUE(is_type(*node2.OutputDefs()[0], DataTypeImpl::GetTensorType<MLFloat16>()));
+  EXPECT_TRUE(is_type(*node3.InputDefs()[0], DataTypeImpl::GetTensorType<float>()));
+  for (const auto* output : graph.GetOutputs()) {
+    EXPECT_TRUE(is_type(*output, DataTypeImpl::GetTensorType<float>()));
+  }
+
+  auto ops = CountOpsInGraph(graph);
+  EXPECT_EQ(ops["Cast"], 3);
+  for (const auto& node : graph.Nodes()) {
+    if (node.OpType() == "Cast") {
+      // there is no float16 Cast kernel for the EP in the registry
+      EXPECT_EQ(node.GetExecutionProviderType(), kCpuExecutionProvider);
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
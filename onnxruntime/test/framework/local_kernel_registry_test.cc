@@ -7,7 +7,9 @@
 #include <algorithm>
 #include <functional>
 #include <iterator>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "core/common/logging/logging.h"
 #include "core/framework/customregistry.h"
@@ -101,6 +103,44 @@ Status CreateFooKernel(FuncManager&, const OpKernelInfo& kernel_info, std::uniqu
   return Status::OK();
 }
 
+// Foo kernel which computes on its own thread and completes asynchronously
+template <typename T>
+class AsyncFooKernel : public OpKernel {
+ public:
+  AsyncFooKernel(const OpKernelInfo& info) : OpKernel(info) {}
+
+  ~AsyncFooKernel() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  bool IsAsync() const override { return true; }
+
+  Status Compute(OpKernelContext*) const override {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Compute must not be called for an async kernel");
+  }
+
+  Status ComputeAsync(OpKernelContext* context, DoneCallback done) const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    threads_.emplace_back([this, context, done = std::move(done)]() {
+      done(foo_.Compute(context));
+    });
+    return Status::OK();
+  }
+
+ private:
+  FooKernel<T> foo_{Info()};
+  mutable std::mutex mutex_;
+  mutable std::vector<std::thread> threads_;
+};
+
+Status CreateAsyncFooKernel(FuncManager&, const OpKernelInfo& kernel_info, std::unique_ptr<OpKernel>& out) {
+  out = std::make_unique<AsyncFooKernel<float>>(kernel_info);
+  return Status::OK();
+}
+
 // kernel with optional outputs
 KernelDefBuilder OptionalKernelDef() {
   KernelDefBuilder def;
@@ -255,6 +295,39 @@ TEST(CustomKernelTests, CustomKernelWithBuiltInSchema) {
   RunSession(session_object, dims_x, values_x, expected_dims_y, expected_values_y);
 }
 
+// Test that the executor waits for a kernel completing on another thread, in both execution modes.
+TEST(CustomKernelTests, AsyncKernel) {
+  for (const auto execution_mode : {ExecutionMode::ORT_SEQUENTIAL, ExecutionMode::ORT_PARALLEL}) {
+    SessionOptions so;
+    so.session_logid = "AsyncKernel";
+    so.execution_mode = execution_mode;
+
+    KernelDefBuilder def;
+    def.SetName("Mul")
+        .SetDomain(onnxruntime::kOnnxDomain)
+        .SinceVersion(7)
+        .Provider(onnxruntime::kCpuExecutionProvider)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>());
+
+    std::shared_ptr<CustomRegistry> registry = std::make_shared<CustomRegistry>();
+    EXPECT_STATUS_OK(registry->RegisterCustomKernel(def, CreateAsyncFooKernel));
+
+    InferenceSession session_object{so, GetEnvironment()};
+    EXPECT_STATUS_OK(session_object.RegisterCustomRegistry(registry));
+    EXPECT_STATUS_OK(session_object.Load(MUL_MODEL_URI));
+    EXPECT_STATUS_OK(session_object.Initialize());
+
+    std::vector<int64_t> dims_x = {3, 2};
+    std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    std::vector<int64_t> expected_dims_y = {3, 2};
+    std::vector<float> expected_values_y = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+
+    for (int run = 0; run < 3; ++run) {
+      RunSession(session_object, dims_x, values_x, expected_dims_y, expected_values_y);
+    }
+  }
+}
+
 // Test registering a custom kernel with custom schema
 TEST(CustomKernelTests, CustomKernelWithCustomSchema) {
   SessionOptions so;
@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <filesystem>
+
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "core/framework/tensor.h"
+#include "gtest/gtest.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+std::vector<OrtValue> CreateFeeds(const std::vector<std::vector<int64_t>>& shapes) {
+  static AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+  std::vector<OrtValue> feeds(shapes.size());
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape(shapes[i]), cpu_allocator, feeds[i]);
+  }
+  return feeds;
+}
+
+MemoryPatternGroup CreatePatternGroup(size_t size) {
+  MemPatternPlanner planner{/*using_counters*/ false};
+  planner.TraceAllocation(0, size);
+  planner.TraceAllocation(1, size);
+
+  MemoryPatternGroup group;
+  group.locations.push_back(OrtDevice());
+  group.patterns.push_back(planner.GenerateMemPattern());
+  return group;
+}
+}  // namespace
+
+TEST(MemoryPatternCacheTest, ExactShapes) {
+  MemoryPatternCache cache;
+  auto feeds = CreateFeeds({{1, 64}});
+  MemoryPatternCache::Entry entry;
+  EXPECT_FALSE(cache.Find(feeds, entry));
+
+  cache.Insert(feeds, CreatePatternGroup(256));
+  ASSERT_TRUE(cache.Find(feeds, entry));
+  EXPECT_EQ(entry.patterns->patterns[0].PeakSize(), 512u);
+
+  // transposed shape must not collide
+  EXPECT_FALSE(cache.Find(CreateFeeds({{64, 1}}), entry));
+  EXPECT_FALSE(cache.Find(CreateFeeds({{1, 65}}), entry));
+}
+
+TEST(MemoryPatternCacheTest, IndexedBlocks) {
+  MemoryPatternCache cache;
+  auto feeds = CreateFeeds({{1, 64}});
+  cache.Insert(feeds, CreatePatternGroup(256));
+
+  MemoryPatternCache::Entry entry;
+  ASSERT_TRUE(cache.Find(feeds, entry));
+  const MemoryPatternGroup& group = *entry.patterns;
+  ASSERT_EQ(group.value_blocks.size(), 2u);
+
+  for (int ort_value_idx = 0; ort_value_idx < 2; ++ort_value_idx) {
+    const MemoryBlock* block = group.GetBlock(OrtDevice(), ort_value_idx);
+    const MemoryBlock* expected_block = group.patterns[0].GetBlock(ort_value_idx);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(block->offset_, expected_block->offset_);
+    EXPECT_EQ(block->size_, expected_block->size_);
+  }
+
+  EXPECT_EQ(group.GetBlock(OrtDevice(), 2), nullptr);
+  EXPECT_EQ(group.GetBlock(OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0), 0), nullptr);
+}
+
+TEST(MemoryPatternCacheTest, ShapeBucketing) {
+  MemoryPatternCache::Options options;
+  options.shape_bucket_size = 64;
+  MemoryPatternCache cache(options);
+  ASSERT_TRUE(cache.IsShapeBucketingEnabled());
+
+  auto feeds_70 = CreateFeeds({{1, 70}});
+  auto feeds_100 = CreateFeeds({{1, 100}});
+  auto feeds_128 = CreateFeeds({{1, 128}});
+  EXPECT_EQ(cache.ComputeKey(feeds_70), cache.ComputeKey(feeds_128));
+  EXPECT_NE(cache.ComputeKey(feeds_70), cache.ComputeKey(CreateFeeds({{1, 129}})));
+
+  cache.Insert(feeds_100, CreatePatternGroup(100));
+
+  MemoryPatternCache::Entry entry;
+  // smaller feeds in the same bucket can use the pattern
+  ASSERT_TRUE(cache.Find(feeds_70, entry));
+  auto pattern_100 = entry.patterns;
+  // larger feeds need a new pattern to be learned
+  EXPECT_FALSE(cache.Find(feeds_128, entry));
+
+  // a pattern from smaller feeds doesn't replace the existing one
+  cache.Insert(feeds_70, CreatePatternGroup(70));
+  ASSERT_TRUE(cache.Find(feeds_100, entry));
+  EXPECT_EQ(entry.patterns, pattern_100);
+
+  // a pattern from larger feeds does, and the old one stays valid for its current users
+  cache.Insert(feeds_128, CreatePatternGroup(128));
+  ASSERT_TRUE(cache.Find(feeds_128, entry));
+  EXPECT_NE(entry.patterns, pattern_100);
+  EXPECT_EQ(pattern_100->patterns[0].PeakSize(), 200u);
+  EXPECT_EQ(cache.Size(), 1u);
+}
+
+TEST(MemoryPatternCacheTest, LruEviction) {
+  MemoryPatternCache::Options options;
+  options.max_entries = 2;
+  MemoryPatternCache cache(options);
+
+  auto feeds_1 = CreateFeeds({{1}});
+  auto feeds_2 = CreateFeeds({{2}});
+  auto feeds_3 = CreateFeeds({{3}});
+  cache.Insert(feeds_1, CreatePatternGroup(1));
+  cache.Insert(feeds_2, CreatePatternGroup(2));
+
+  MemoryPatternCache::Entry entry;
+  // make feeds_2 the least recently used entry
+  ASSERT_TRUE(cache.Find(feeds_1, entry));
+  cache.Insert(feeds_3, CreatePatternGroup(3));
+
+  EXPECT_EQ(cache.Size(), 2u);
+  EXPECT_TRUE(cache.Find(feeds_1, entry));
+  EXPECT_FALSE(cache.Find(feeds_2, entry));
+  EXPECT_TRUE(cache.Find(feeds_3, entry));
+}
+
+TEST(MemoryPatternCacheTest, SaveAndLoad) {
+  OrtValueNameIdxMap name_idx_map;
+  name_idx_map.Add("a");
+  name_idx_map.Add("b");
+
+  const PathString file_path = ORT_TSTR("mem_pattern_cache_test.bin");
+  MemoryPatternCache::Options options;
+  options.shape_bucket_size = 8;
+
+  auto feeds = CreateFeeds({{2, 5}, {3}});
+  {
+    MemoryPatternCache cache(options);
+    cache.Insert(feeds, CreatePatternGroup(512));
+    EXPECT_TRUE(cache.IsDirty());
+    ASSERT_STATUS_OK(cache.Save(file_path, name_idx_map));
+    EXPECT_FALSE(cache.IsDirty());
+  }
+
+  {
+    MemoryPatternCache cache(options);
+    ASSERT_STATUS_OK(cache.Load(file_path, name_idx_map));
+    MemoryPatternCache::Entry entry;
+    ASSERT_TRUE(cache.Find(feeds, entry));
+    const MemoryPattern* pattern = entry.patterns->GetPatterns(OrtDevice());
+    ASSERT_NE(pattern, nullptr);
+    EXPECT_EQ(pattern->PeakSize(), 1024u);
+    ASSERT_NE(pattern->GetBlock(1), nullptr);
+    EXPECT_EQ(pattern->GetBlock(1)->offset_, 512u);
+    EXPECT_EQ(pattern->GetBlock(1)->size_, 512u);
+    EXPECT_FALSE(cache.IsDirty());
+  }
+
+  {
+    // the file is rejected if the bucket size doesn't match
+    MemoryPatternCache cache;
+    EXPECT_FALSE(cache.Load(file_path, name_idx_map).IsOK());
+    EXPECT_EQ(cache.Size(), 0u);
+  }
+
+  {
+    // or if it refers to values that don't exist in the graph
+    OrtValueNameIdxMap other_name_idx_map;
+    other_name_idx_map.Add("a");
+    MemoryPatternCache cache(options);
+    EXPECT_FALSE(cache.Load(file_path, other_name_idx_map).IsOK());
+    EXPECT_EQ(cache.Size(), 0u);
+  }
+
+  std::filesystem::remove(file_path);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -533,6 +533,20 @@ TEST(OrtModelOnlyTests, LoadOrtFormatModel) {
   RunOrtModel(test_info);
 }
 
+// the file is mapped by default, read it into a buffer instead
+TEST(OrtModelOnlyTests, LoadOrtFormatModelWithoutMapping) {
+  OrtModelTestInfo test_info = GetTestInfoForLoadOrtFormatModel();
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigMapORTModelFile, "0"));
+  RunOrtModel(test_info);
+}
+
+// the file is mapped but the initializers are copied out of it
+TEST(OrtModelOnlyTests, LoadOrtFormatModelMappedInitializersCopied) {
+  OrtModelTestInfo test_info = GetTestInfoForLoadOrtFormatModel();
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0"));
+  RunOrtModel(test_info);
+}
+
 // Load the model from a buffer instead of a file path
 TEST(OrtModelOnlyTests, LoadOrtFormatModelFromBuffer) {
   OrtModelTestInfo test_info = GetTestInfoForLoadOrtFormatModel();
@@ -3,9 +3,13 @@
 
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
 #include "test/providers/provider_test_utils.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
 
 #include "gtest/gtest.h"
 
@@ -86,34 +90,36 @@ TEST(ParallelExecutor, TestStatusPropagation) {
   auto kernel_def = TestOp::KernelDef();
   ASSERT_TRUE((status = registry->RegisterCustomKernel(kernel_def, kernel_create_fn)).IsOK()) << status;
 
-  {  // test success
-    OpTester tester{"TestOp", 10, TestOp::OpDomain};
-    tester.AddCustomOpRegistry(registry);
+  for (ExecutionMode execution_mode : {ExecutionMode::ORT_PARALLEL, ExecutionMode::ORT_PARALLEL_WORK_STEALING}) {
+    {  // test success
+      OpTester tester{"TestOp", 10, TestOp::OpDomain};
+      tester.AddCustomOpRegistry(registry);
 
-    tester.AddInput<int64_t>("action", {1}, {/*success*/ 0});
-    tester.AddOutput<int64_t>("action_out", {1}, {0});
-    // TensorRT doesn't handle a custom op. Possibly it should, but that would be a separate PR
-    tester.Run(OpTester::ExpectResult::kExpectSuccess, {}, {kTensorrtExecutionProvider}, nullptr, nullptr,
-               ExecutionMode::ORT_PARALLEL);
-  }
+      tester.AddInput<int64_t>("action", {1}, {/*success*/ 0});
+      tester.AddOutput<int64_t>("action_out", {1}, {0});
+      // TensorRT doesn't handle a custom op. Possibly it should, but that would be a separate PR
+      tester.Run(OpTester::ExpectResult::kExpectSuccess, {}, {kTensorrtExecutionProvider}, nullptr, nullptr,
+                 execution_mode);
+    }
 
-  {  // test failure
-    OpTester tester{"TestOp", 10, TestOp::OpDomain};
-    tester.AddCustomOpRegistry(registry);
+    {  // test failure
+      OpTester tester{"TestOp", 10, TestOp::OpDomain};
+      tester.AddCustomOpRegistry(registry);
 
-    tester.AddInput<int64_t>("action", {1}, {/*failure*/ 1});
-    tester.AddOutput<int64_t>("action_out", {1}, {0});
-    tester.Run(OpTester::ExpectResult::kExpectFailure, "Action was 1", {kTensorrtExecutionProvider}, nullptr, nullptr,
-               ExecutionMode::ORT_PARALLEL);
-  }
+      tester.AddInput<int64_t>("action", {1}, {/*failure*/ 1});
+      tester.AddOutput<int64_t>("action_out", {1}, {0});
+      tester.Run(OpTester::ExpectResult::kExpectFailure, "Action was 1", {kTensorrtExecutionProvider}, nullptr, nullptr,
+                 execution_mode);
+    }
 
-  {  // test exception
-    OpTester tester{"TestOp", 10, TestOp::OpDomain};
-    tester.AddCustomOpRegistry(registry);
+    {  // test exception
+      OpTester tester{"TestOp", 10, TestOp::OpDomain};
+      tester.AddCustomOpRegistry(registry);
 
-    tester.AddInput<int64_t>("action", {1}, {/*exception*/ 2});
-    tester.AddOutput<int64_t>("action_out", {1}, {0});
-    tester.Run(OpTester::ExpectResult::kExpectFailure, "Throwing as action was 2", {kTensorrtExecutionProvider}, nullptr, nullptr, ExecutionMode::ORT_PARALLEL);
+      tester.AddInput<int64_t>("action", {1}, {/*exception*/ 2});
+      tester.AddOutput<int64_t>("action_out", {1}, {0});
+      tester.Run(OpTester::ExpectResult::kExpectFailure, "Throwing as action was 2", {kTensorrtExecutionProvider}, nullptr, nullptr, execution_mode);
+    }
   }
 }
 
@@ -145,5 +151,74 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
 
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                          testing::Values(1, 0));
+
+// X -> num_branches x (Add(X, X) -> Mul(., X)) -> Sum -> Y, so Y = num_branches * 2 * X * X
+static std::string CreateWideModel(int num_branches) {
+  onnxruntime::Model model("wide_graph", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  std::vector<onnxruntime::NodeArg*> branch_outputs;
+  for (int i = 0; i < num_branches; ++i) {
+    const std::string suffix = std::to_string(i);
+    auto& add_out = graph.GetOrCreateNodeArg("add_" + suffix, &float_tensor);
+    auto& mul_out = graph.GetOrCreateNodeArg("mul_" + suffix, &float_tensor);
+    graph.AddNode("add_node_" + suffix, "Add", "", {&x, &x}, {&add_out});
+    graph.AddNode("mul_node_" + suffix, "Mul", "", {&add_out, &x}, {&mul_out});
+    branch_outputs.push_back(&mul_out);
+  }
+
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("sum_node", "Sum", "", branch_outputs, {&y});
+  EXPECT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  return model_data;
+}
+
+TEST(ParallelExecutor, WorkStealingWideGraph) {
+  constexpr int kNumBranches = 8;
+  const std::string model_data = CreateWideModel(kNumBranches);
+
+  SessionOptions so;
+  so.session_logid = "ParallelExecutor.WorkStealingWideGraph";
+  so.execution_mode = ExecutionMode::ORT_PARALLEL_WORK_STEALING;
+  so.inter_op_param.thread_pool_size = 4;
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  const auto* schedule = session.GetSessionState().GetWorkStealingSchedule();
+  ASSERT_NE(schedule, nullptr);
+  EXPECT_EQ(schedule->roots.size(), static_cast<size_t>(kNumBranches));
+
+  std::vector<float> x_values = {1.0f, 2.0f, -3.0f, 0.5f};
+  std::vector<float> expected_y;
+  for (float x : x_values) {
+    expected_y.push_back(kNumBranches * 2.0f * x * x);
+  }
+
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {4}, x_values, &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+
+  // nodes complete in a different order on each run
+  for (int run = 0; run < 20; ++run) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, {"Y"}, &fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    auto y = fetches[0].Get<Tensor>().DataAsSpan<float>();
+    ASSERT_EQ(y.size(), expected_y.size());
+    for (size_t i = 0; i < y.size(); ++i) {
+      EXPECT_FLOAT_EQ(y[i], expected_y[i]);
+    }
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <string>
+
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/pipeline_executor.h"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "test/test_environment.h"
+#include "test/util/include/affine_model.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+PipelineExecutor::Stage CreateStage(AffineModel& model, const std::string& input_name,
+                                    const std::string& output_name) {
+  PipelineExecutor::Stage stage;
+  stage.input_names = {input_name};
+  stage.output_names = {output_name};
+  stage.run = model.GetRunFn();
+  return stage;
+}
+}  // namespace
+
+TEST(PipelineExecutorTest, RunsMicroBatchesThroughStages) {
+  AffineModel doubling{2.f, 0.f};
+  AffineModel increment{1.f, 1.f};
+
+  std::vector<PipelineExecutor::Stage> stages;
+  stages.push_back(CreateStage(doubling, "X", "H"));
+  stages.push_back(CreateStage(increment, "H", "Y"));
+
+  PipelineExecutor::Options options;
+  options.num_micro_batches = 3;
+  PipelineExecutor pipeline(options, std::move(stages), GetTestCpuAllocator());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y", "H"};
+  const std::vector<OrtValue> feeds{CreateRampTensor({5, 2}, 0.f)};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(pipeline.Run(RunOptions{}, feed_names, feeds, output_names, &fetches));
+
+  // 5 rows in 3 micro-batches
+  EXPECT_THAT(doubling.batch_sizes, testing::ElementsAre(2, 2, 1));
+  EXPECT_THAT(increment.batch_sizes, testing::ElementsAre(2, 2, 1));
+
+  ASSERT_EQ(fetches.size(), 2u);
+  const auto& x = feeds[0].Get<Tensor>();
+  const auto& y = fetches[0].Get<Tensor>();
+  const auto& h = fetches[1].Get<Tensor>();
+  ASSERT_EQ(y.Shape(), x.Shape());
+  ASSERT_EQ(h.Shape(), x.Shape());
+  auto x_data = x.DataAsSpan<float>();
+  auto y_data = y.DataAsSpan<float>();
+  auto h_data = h.DataAsSpan<float>();
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    EXPECT_EQ(h_data[i], 2 * x_data[i]);
+    EXPECT_EQ(y_data[i], 2 * x_data[i] + 1);
+  }
+}
+
+TEST(PipelineExecutorTest, PropagatesStageFailure) {
+  AffineModel doubling{2.f, 0.f};
+  PipelineExecutor::Stage failing;
+  failing.input_names = {"H"};
+  failing.output_names = {"Y"};
+  failing.run = [](const RunOptions&, gsl::span<const std::string>, gsl::span<const OrtValue>,
+                   gsl::span<const std::string>, std::vector<OrtValue>*) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "stage failed");
+  };
+
+  std::vector<PipelineExecutor::Stage> stages;
+  stages.push_back(CreateStage(doubling, "X", "H"));
+  stages.push_back(std::move(failing));
+
+  PipelineExecutor::Options options;
+  options.num_micro_batches = 4;
+  PipelineExecutor pipeline(options, std::move(stages), GetTestCpuAllocator());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  const std::vector<OrtValue> feeds{CreateRampTensor({4, 3}, 0.f)};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_NOT_OK_AND_HAS_SUBSTR(pipeline.Run(RunOptions{}, feed_names, feeds, output_names, &fetches),
+                                      "stage failed");
+}
+
+TEST(PipelineExecutorTest, SplitModelIntoStages) {
+  // Y = Abs(Neg(Relu(X))), cut after Relu
+  onnxruntime::Model model("pipeline", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 13}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& a = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("relu", "Relu", "", {&x}, {&a});
+  graph.AddNode("neg", "Neg", "", {&a}, {&b});
+  graph.AddNode("abs", "Abs", "", {&b}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  const std::vector<std::vector<std::string>> cut_points{{"A"}};
+  std::vector<ONNX_NAMESPACE::ModelProto> stage_models;
+  ASSERT_STATUS_OK(SplitModelIntoStages(model, cut_points, stage_models));
+  ASSERT_EQ(stage_models.size(), 2u);
+
+  const auto& stage0 = stage_models[0].graph();
+  ASSERT_EQ(stage0.node_size(), 1);
+  EXPECT_EQ(stage0.node(0).op_type(), "Relu");
+  ASSERT_EQ(stage0.input_size(), 1);
+  EXPECT_EQ(stage0.input(0).name(), "X");
+  ASSERT_EQ(stage0.output_size(), 1);
+  EXPECT_EQ(stage0.output(0).name(), "A");
+
+  const auto& stage1 = stage_models[1].graph();
+  ASSERT_EQ(stage1.node_size(), 2);
+  ASSERT_EQ(stage1.input_size(), 1);
+  EXPECT_EQ(stage1.input(0).name(), "A");
+  ASSERT_EQ(stage1.output_size(), 1);
+  EXPECT_EQ(stage1.output(0).name(), "Y");
+
+  // run the stage models as a pipeline
+  std::vector<std::unique_ptr<InferenceSession>> sessions;
+  std::vector<PipelineExecutor::Stage> stages(stage_models.size());
+  for (size_t s = 0; s < stage_models.size(); ++s) {
+    const std::string model_data = stage_models[s].SerializeAsString();
+    auto& session = sessions.emplace_back(std::make_unique<InferenceSession>(SessionOptions{}, GetEnvironment()));
+    ASSERT_STATUS_OK(session->Load(model_data.data(), static_cast<int>(model_data.size())));
+    ASSERT_STATUS_OK(session->Initialize());
+    ASSERT_STATUS_OK(PipelineExecutor::CreateStage(*session, stages[s]));
+  }
+
+  PipelineExecutor::Options options;
+  options.num_micro_batches = 2;
+  PipelineExecutor pipeline(options, std::move(stages), GetTestCpuAllocator());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  const std::vector<OrtValue> feeds{CreateRampTensor({4, 3}, -5.f)};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(pipeline.Run(RunOptions{}, feed_names, feeds, output_names, &fetches));
+
+  auto x_data = feeds[0].Get<Tensor>().DataAsSpan<float>();
+  auto y_data = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  ASSERT_EQ(y_data.size(), x_data.size());
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    EXPECT_EQ(y_data[i], std::max(x_data[i], 0.f));
+  }
+
+  // a cut point value must be produced before the cut
+  const std::vector<std::vector<std::string>> invalid_cut_points{{"Y"}, {"A"}};
+  ASSERT_STATUS_NOT_OK(SplitModelIntoStages(model, invalid_cut_points, stage_models));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,6 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <vector>
+
+#include "core/framework/philox_engine.h"
 #include "core/framework/random_seed.h"
 #include "core/framework/random_generator.h"
 #include "gtest/gtest.h"
@@ -54,5 +58,57 @@ TEST(RandomTest, PhiloxGeneratorTest) {
   ASSERT_EQ(seeds.second, 0u);
 }
 
+TEST(RandomTest, PhiloxEngineKnownAnswerTest) {
+  // Known answers of Philox4x32-10 from the Random123 library.
+  const uint32_t counters[3][4] = {{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+                                   {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                                   {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}};
+  const uint32_t keys[3][2] = {{0x00000000, 0x00000000},
+                               {0xffffffff, 0xffffffff},
+                               {0xa4093822, 0x299f31d0}};
+  const uint32_t expected[3][4] = {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+                                   {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+                                   {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+
+  for (int i = 0; i < 3; i++) {
+    uint32_t result[4];
+    philox::Philox4x32(counters[i], keys[i], result);
+    for (int j = 0; j < 4; j++) {
+      ASSERT_EQ(result[j], expected[i][j]) << "vector " << i << ", word " << j;
+    }
+  }
+}
+
+TEST(RandomTest, PhiloxEngineRangeTest) {
+  // Generating a stream by ranges, as the threads do, gives the same values as generating it at once.
+  constexpr size_t count = 1001;
+  const size_t cuts[] = {0, 1, 4, 37, 38, 300, 301, 1000, count};
+
+  std::vector<uint32_t> words(count), words_by_range(count);
+  std::vector<float> uniform(count), uniform_by_range(count);
+  std::vector<double> normal(count), normal_by_range(count);
+
+  philox::Generate(17, 5, 0, count, words.data());
+  philox::GenerateUniform<float>(17, 5, 0, count, -1.0f, 1.0f, uniform.data());
+  philox::GenerateNormal<double>(17, 5, 0, count, 2.0, 3.0, normal.data());
+
+  for (size_t i = 0; i + 1 < sizeof(cuts) / sizeof(cuts[0]); i++) {
+    const size_t first = cuts[i];
+    const size_t n = cuts[i + 1] - first;
+    philox::Generate(17, 5, first, n, words_by_range.data() + first);
+    philox::GenerateUniform<float>(17, 5, first, n, -1.0f, 1.0f, uniform_by_range.data() + first);
+    philox::GenerateNormal<double>(17, 5, first, n, 2.0, 3.0, normal_by_range.data() + first);
+  }
+
+  ASSERT_EQ(words, words_by_range);
+  ASSERT_EQ(uniform, uniform_by_range);
+  ASSERT_EQ(normal, normal_by_range);
+
+  // The offset is counted in blocks of 4 values.
+  std::vector<uint32_t> words_at_offset(count - 8);
+  philox::Generate(17, 7, 0, count - 8, words_at_offset.data());
+  ASSERT_TRUE(std::equal(words_at_offset.begin(), words_at_offset.end(), words.begin() + 8));
+}
+
 }  // namespace test
 }  // namespace onnxruntime
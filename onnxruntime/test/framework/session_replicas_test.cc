@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+#include "core/session/session_replicas.h"
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "test/test_environment.h"
+#include "test/util/include/affine_model.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+constexpr const ORTCHAR_T* kMulModel = ORT_TSTR("testdata/mul_1.onnx");
+
+// the model computes Y = X * X
+void RunAndCheck(SessionReplicas& replicas) {
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<OrtValue> feeds{CreateRampTensor({3, 2}, 1.f)};
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(replicas.Run(RunOptions(), feed_names, feeds, output_names, &fetches));
+  ASSERT_EQ(fetches.size(), 1u);
+  auto y = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  EXPECT_THAT(std::vector<float>(y.begin(), y.end()), ::testing::ElementsAre(1.f, 4.f, 9.f, 16.f, 25.f, 36.f));
+}
+
+// registers a CPU EP with every replica and records the devices
+struct Providers {
+  std::mutex mutex;
+  std::vector<int> device_ids;
+
+  SessionReplicas::RegisterProvidersFn GetRegisterFn() {
+    return [this](int device_id, InferenceSession& session) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        device_ids.push_back(device_id);
+      }
+      return session.RegisterExecutionProvider(DefaultCpuExecutionProvider());
+    };
+  }
+};
+}  // namespace
+
+TEST(SessionReplicasTest, ReplicasShareOptimizedModel) {
+  Providers providers;
+  SessionReplicas::Options options;
+  options.device_ids = {0, 1, 2};
+
+  std::unique_ptr<SessionReplicas> replicas;
+  ASSERT_STATUS_OK(SessionReplicas::Create(SessionOptions(), GetEnvironment(), kMulModel, options,
+                                           providers.GetRegisterFn(), replicas));
+  ASSERT_EQ(replicas->NumReplicas(), 3u);
+  EXPECT_THAT(providers.device_ids, ::testing::ElementsAre(0, 1, 2));
+  for (size_t i = 0; i < replicas->NumReplicas(); ++i) {
+    EXPECT_EQ(replicas->GetDeviceId(i), options.device_ids[i]);
+    EXPECT_TRUE(replicas->GetSession(i).IsInitialized());
+  }
+
+  // the runs go to every replica in turn
+  for (size_t i = 0; i < 2 * replicas->NumReplicas(); ++i) {
+    RunAndCheck(*replicas);
+  }
+}
+
+TEST(SessionReplicasTest, ReplicasLoadModel) {
+  Providers providers;
+  SessionReplicas::Options options;
+  options.device_ids = {0, 1};
+  options.share_optimized_model = false;
+
+  std::unique_ptr<SessionReplicas> replicas;
+  ASSERT_STATUS_OK(SessionReplicas::Create(SessionOptions(), GetEnvironment(), kMulModel, options,
+                                           providers.GetRegisterFn(), replicas));
+  ASSERT_EQ(replicas->NumReplicas(), 2u);
+  RunAndCheck(*replicas);
+}
+
+TEST(SessionReplicasTest, SelectsReplicaOfInputDevice) {
+  Providers providers;
+  SessionReplicas::Options options;
+  options.device_ids = {3, 5};
+  options.share_optimized_model = false;
+
+  std::unique_ptr<SessionReplicas> replicas;
+  ASSERT_STATUS_OK(SessionReplicas::Create(SessionOptions(), GetEnvironment(), kMulModel, options,
+                                           providers.GetRegisterFn(), replicas));
+
+  // the data is never read, only the device of the tensor matters
+  float data[6] = {};
+  const OrtMemoryInfo gpu_memory_info("Cuda", OrtDeviceAllocator,
+                                      OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 5));
+  OrtValue gpu_value;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({3, 2}), data, gpu_memory_info, gpu_value);
+  OrtValue cpu_value;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({3, 2}), data, GetTestCpuAllocator()->Info(),
+                       cpu_value);
+
+  for (int i = 0; i < 4; ++i) {
+    const OrtValue* values[] = {&cpu_value, &gpu_value};
+    EXPECT_EQ(replicas->SelectReplica(values), 1u);
+  }
+
+  // without a device, idle replicas are used in turn
+  const OrtValue* cpu_values[] = {&cpu_value};
+  const size_t first = replicas->SelectReplica(cpu_values);
+  EXPECT_NE(replicas->SelectReplica(cpu_values), first);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1091,6 +1091,125 @@ TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test4) {
   ASSERT_EQ(if_node_branches_shared_prepack_counter_2, static_cast<size_t>(2));
 }
 
+// The kernels of the subgraphs are created and their weights pre-packed on the first execution of each subgraph
+// unless the node is in the warmup list.
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, LazySubgraphInitialization) {
+  for (const bool warmup : {false, true}) {
+    SCOPED_TRACE(warmup ? "warmup" : "lazy");
+
+    SessionOptions sess_options;
+    sess_options.enable_mem_pattern = true;
+    sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+    sess_options.use_deterministic_compute = false;
+    sess_options.enable_mem_reuse = true;
+    sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+    sess_options.config_options.configurations[kOrtSessionOptionsLazySubgraphInitialization] = "1";
+    if (warmup) {
+      sess_options.config_options.configurations[kOrtSessionOptionsLazySubgraphWarmupNodes] = "some_node,if";
+    }
+
+    Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+
+    CreateGraphWithSubgraph(model.MainGraph());
+    PlaceAllNodesToCPUEP(model.MainGraph());
+    SessionState session_state(model.MainGraph(),
+                               execution_providers,
+                               tp.get(),
+                               nullptr, /*inter_op_thread_pool*/
+                               dtm,
+                               edlm,
+                               DefaultLoggingManager().DefaultLogger(),
+                               profiler,
+                               sess_options);
+
+    ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                        kernel_registry_manager));
+
+    auto if_index = 1;
+    if (session_state.GetKernel(0)->Node().OpType() == "If") {
+      if_index = 0;
+    }
+
+    const auto& if_node_session_states = session_state.GetSubgraphSessionStateMap().at(if_index);
+    const auto& then_branch_session_state = *if_node_session_states.at("then_branch");
+    const auto& else_branch_session_state = *if_node_session_states.at("else_branch");
+
+    const size_t expected_prepacks_at_initialization = warmup ? 1 : 0;
+    ASSERT_EQ(then_branch_session_state.GetNumberOfPrepacksCounter(), expected_prepacks_at_initialization);
+    ASSERT_EQ(else_branch_session_state.GetNumberOfPrepacksCounter(), expected_prepacks_at_initialization);
+    ASSERT_EQ(then_branch_session_state.GetKernel(0) != nullptr, warmup);
+
+    // this is what the If kernel does before executing a branch
+    ASSERT_STATUS_OK(then_branch_session_state.FinalizeDeferredInitialization());
+    ASSERT_STATUS_OK(then_branch_session_state.FinalizeDeferredInitialization());
+
+    ASSERT_NE(then_branch_session_state.GetKernel(0), nullptr);
+    ASSERT_EQ(then_branch_session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+    ASSERT_EQ(else_branch_session_state.GetNumberOfPrepacksCounter(), expected_prepacks_at_initialization);
+  }
+}
+
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, ReuseSubgraphMemoryPatternBuffers) {
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+
+  Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+              DefaultLoggingManager().DefaultLogger());
+
+  CreateGraphWithSubgraph(model.MainGraph());
+  PlaceAllNodesToCPUEP(model.MainGraph());
+  SessionState session_state(model.MainGraph(),
+                             execution_providers,
+                             tp.get(),
+                             nullptr, /*inter_op_thread_pool*/
+                             dtm,
+                             edlm,
+                             DefaultLoggingManager().DefaultLogger(),
+                             profiler,
+                             sess_options);
+
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                      kernel_registry_manager));
+
+  auto if_index = 1;
+  if (session_state.GetKernel(0)->Node().OpType() == "If") {
+    if_index = 0;
+  }
+
+  const auto& subgraph_session_state =
+      *session_state.GetSubgraphSessionStateMap().at(if_index).at("then_branch");
+
+  auto cpu_allocator = session_state.GetAllocator(OrtDevice());
+  auto create_buffers = [&cpu_allocator](void*& buffer) {
+    buffer = cpu_allocator->Alloc(64);
+    InlinedHashMap<OrtDevice, BufferUniquePtr> buffers;
+    buffers.emplace(OrtDevice(), BufferUniquePtr(buffer, BufferDeleter(cpu_allocator)));
+    return buffers;
+  };
+
+  auto mem_patterns = std::make_shared<const MemoryPatternGroup>();
+  const MemoryPatternGroup other_mem_patterns;
+  void* buffer = nullptr;
+  InlinedHashMap<OrtDevice, BufferUniquePtr> acquired;
+
+  // the buffers of a subgraph are kept for the same patterns
+  subgraph_session_state.ReleaseMemoryPatternBuffers(mem_patterns, create_buffers(buffer));
+  ASSERT_FALSE(subgraph_session_state.AcquireMemoryPatternBuffers(other_mem_patterns, acquired));
+  ASSERT_TRUE(subgraph_session_state.AcquireMemoryPatternBuffers(*mem_patterns, acquired));
+  ASSERT_EQ(acquired.at(OrtDevice()).get(), buffer);
+  ASSERT_FALSE(subgraph_session_state.AcquireMemoryPatternBuffers(*mem_patterns, acquired));
+
+  // the main graph doesn't keep them
+  session_state.ReleaseMemoryPatternBuffers(mem_patterns, create_buffers(buffer));
+  ASSERT_FALSE(session_state.AcquireMemoryPatternBuffers(*mem_patterns, acquired));
+}
+
 #ifndef __wasm__
 // sharing is on
 TEST_F(SessionStateTestSharedInitalizersWithPrePacking, TestPrepackedSerialization) {
@@ -1278,6 +1397,41 @@ TEST_F(SessionStateTestSharedInitalizersWithPrePacking, TestPrepackedSerializati
     ASSERT_FALSE(prepacked_for_main_graph.IsSaveModeOn());
     ASSERT_EQ(1U, prepacked_for_main_graph.GetKeyToBlob().size());
   }
+  // Load again, the external initializers are loaded in parallel
+  {
+    SessionOptions sess_options;
+    sess_options.enable_mem_pattern = true;
+    sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+    sess_options.use_deterministic_compute = false;
+    sess_options.enable_mem_reuse = true;
+
+    // Enable pre-packing
+    sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+    sess_options.config_options.configurations[kOrtSessionOptionsLoadInitializersInParallel] = "1";
+
+    std::shared_ptr<Model> model;
+    ASSERT_STATUS_OK(Model::Load(model_with_external_initializers, model, nullptr,
+                                 DefaultLoggingManager().DefaultLogger()));
+
+    PlaceAllNodesToCPUEP(model->MainGraph());
+    SessionState session_state(model->MainGraph(),
+                               execution_providers,
+                               tp.get(),
+                               nullptr, /*inter_op_thread_pool*/
+                               dtm,
+                               edlm,
+                               DefaultLoggingManager().DefaultLogger(),
+                               profiler,
+                               sess_options,
+                               nullptr);
+
+    ASSERT_STATUS_OK(session_state.FinalizeSessionState(model_with_external_initializers,
+                                                        kernel_registry_manager,
+                                                        false));
+
+    // the pre-packed blobs read by the loading tasks are merged into the graph's container
+    TestLoadedSharedNoUserSupplied(*model);
+  }
 }
 #endif  // __wasm__
 
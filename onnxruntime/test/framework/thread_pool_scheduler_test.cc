@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "core/platform/env.h"
+#include "core/platform/threadpool.h"
+#include "core/session/thread_pool_scheduler.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+std::unique_ptr<concurrency::ThreadPool> CreateThreadPool(int degree_of_parallelism) {
+  return std::make_unique<concurrency::ThreadPool>(&Env::Default(), ThreadOptions{}, nullptr,
+                                                   degree_of_parallelism, true);
+}
+}  // namespace
+
+TEST(ThreadPoolSchedulerTest, DividesThreadsByWeight) {
+  auto tp = CreateThreadPool(8);
+  ThreadPoolScheduler scheduler(tp.get());
+  ASSERT_EQ(scheduler.NumThreads(), 8);
+
+  auto large = scheduler.Register({3, 0, 0});
+  auto small = scheduler.Register({1, 0, 0});
+  auto unweighted = scheduler.Register({0, 0, 0});
+
+  {
+    // a client running alone may use every thread
+    ThreadPoolScheduler::Run large_run(*large);
+    ASSERT_EQ(large_run.MaxDegreeOfParallelism().load(), 8);
+
+    {
+      ThreadPoolScheduler::Run small_run(*small);
+      ThreadPoolScheduler::Run unweighted_run(*unweighted);
+      ASSERT_EQ(large_run.MaxDegreeOfParallelism().load(), 6);
+      ASSERT_EQ(small_run.MaxDegreeOfParallelism().load(), 2);
+      ASSERT_EQ(unweighted_run.MaxDegreeOfParallelism().load(), 8);
+
+      ASSERT_EQ(large->GetStats().active_runs, 1);
+      ASSERT_EQ(small->GetStats().max_degree_of_parallelism, 2);
+    }
+
+    ASSERT_EQ(large_run.MaxDegreeOfParallelism().load(), 8);
+    ASSERT_EQ(small->GetStats().active_runs, 0);
+  }
+  ASSERT_GT(large->GetStats().allotted_thread_ns, 0u);
+}
+
+TEST(ThreadPoolSchedulerTest, QuotaLimitsTheShare) {
+  auto tp = CreateThreadPool(8);
+  ThreadPoolScheduler scheduler(tp.get());
+
+  const int uncapped = concurrency::ThreadPool::DegreeOfParallelism(tp.get());
+
+  auto client = scheduler.Register({0, 3, 0});
+  ThreadPoolScheduler::Run run(*client);
+  ASSERT_EQ(run.MaxDegreeOfParallelism().load(), 3);
+
+  // the share is applied to the loops of a run through its RunScope
+  concurrency::ThreadPool::RunScope scope(tp.get(), 0, concurrency::ThreadPool::RunPriority::kNormal,
+                                          &run.MaxDegreeOfParallelism());
+  ASSERT_EQ(concurrency::ThreadPool::DegreeOfParallelism(tp.get()), uncapped / 8 * 3);
+}
+
+TEST(ThreadPoolSchedulerTest, AdmissionControl) {
+  ThreadPoolScheduler scheduler(nullptr);
+  auto client = scheduler.Register({1, 0, 1});
+
+  std::atomic<bool> second_run_started{false};
+  std::thread second;
+  {
+    ThreadPoolScheduler::Run first_run(*client);
+    second = std::thread([&]() {
+      ThreadPoolScheduler::Run second_run(*client);
+      second_run_started = true;
+    });
+
+    while (client->GetStats().waiting_runs == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_FALSE(second_run_started);
+    EXPECT_EQ(client->GetStats().active_runs, 1);
+  }
+  second.join();
+  ASSERT_TRUE(second_run_started);
+  ASSERT_EQ(client->GetStats().waiting_runs, 0);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -7,9 +7,12 @@
 
 #include "core/common/common.h"
 #include "core/framework/tunable.h"
-#define TUNING_CONTEXT_IMPL
-#include "core/framework/tuning_context_impl.h"
-#undef TUNING_CONTEXT_IMPL
+#include "core/framework/tuning_context.h"
+#if !defined(ORT_MINIMAL_BUILD)
+#include "core/session/inference_session_utils.h"
+#endif
+#include "test/util/include/asserts.h"
+#include "test/util/include/temp_dir.h"
 
 using namespace std::chrono_literals;
 
@@ -734,6 +737,42 @@ TEST(TuningContext, GetAndLoadTuningResults) {
 #endif
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+TEST(TuningContext, MergeAndPersistTuningResults) {
+  TuningResults device_a;
+  device_a.ep = "TestEP";
+  device_a.validators = {{kTestKey, "DEVICE_A"}};
+  device_a.results = {{"op", {{"params_0", 0}, {"params_1", 1}}}};
+
+  TuningResults device_b = device_a;
+  device_b.validators = {{kTestKey, "DEVICE_B"}};
+
+  std::vector<TuningResults> cached{device_a};
+
+  // same validators are merged, newer kernel ids win. other validators are kept as separate entries.
+  TuningResults device_a_update = device_a;
+  device_a_update.results = {{"op", {{"params_1", 2}, {"params_2", 3}}}};
+  inference_session_utils::MergeTuningResults(cached, {device_a_update, device_b});
+
+  ASSERT_EQ(cached.size(), 2u);
+  EXPECT_EQ(cached[0].results["op"], (KernelMap{{"params_0", 0}, {"params_1", 2}, {"params_2", 3}}));
+  EXPECT_EQ(cached[1].validators, device_b.validators);
+
+  TemporaryDirectory tmp_dir{ORT_TSTR("tuning_results_cache_test")};
+  const PathString file_path = tmp_dir.Path() + ORT_TSTR("/tuning_results.json");
+  ASSERT_STATUS_OK(inference_session_utils::SaveTuningResultsToFile(file_path, cached));
+
+  std::vector<TuningResults> loaded;
+  ASSERT_STATUS_OK(inference_session_utils::LoadTuningResultsFromFile(file_path, loaded));
+  ASSERT_EQ(loaded.size(), 2u);
+  for (size_t i = 0; i < loaded.size(); ++i) {
+    EXPECT_EQ(loaded[i].ep, cached[i].ep);
+    EXPECT_EQ(loaded[i].validators, cached[i].validators);
+    EXPECT_EQ(loaded[i].results, cached[i].results);
+  }
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 }  // namespace tuning_context
 
 }  // namespace test
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cctype>
 #include <iostream>
 #include "core/common/inlined_containers.h"
 #include "core/common/span_utils.h"
@@ -27,6 +28,8 @@ using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 namespace test {
 
+static int num_counted_shape_inference_calls = 0;
+
 static bool RegisterCustomSchemas() {
   OPERATOR_SCHEMA(Variable_DFS)
       .SetDoc("Input variable.")
@@ -104,6 +107,17 @@ static bool RegisterCustomSchemas() {
         fail_shape_inference("try harder");
       });
 
+  OPERATOR_SCHEMA(CountedShapeInference_Fake)
+      .SetDoc("Counts the calls to its type and shape inference function.")
+      .Input(0, "input_1", "docstr for input_1.", "T")
+      .Output(0, "output_1", "docstr for output_1.", "T")
+      .Attr("unused", "Attribute that doesn't change the output.", AttributeProto::INT, OPTIONAL_VALUE)
+      .TypeConstraint("T", {"tensor(float)"}, "input/output types")
+      .TypeAndShapeInferenceFunction([](InferenceContext& ctx) {
+        ++num_counted_shape_inference_calls;
+        propagateShapeAndTypeFromFirstInput(ctx);
+      });
+
   OPERATOR_SCHEMA(Fake_Sub)
       .SinceVersion(1)
       .SetDomain(kMSNchwcDomain)
@@ -1490,6 +1504,102 @@ TEST_F(GraphTest, GraphConstruction_TypeInference) {
   EXPECT_EQ("node_4_out_1", graph_proto.output(0).name());
 }
 
+TEST_F(GraphTest, IncrementalTypeInference) {
+  Model model("graph", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  // x -> node_0 -> y_0 -> node_1 -> y_1 -> node_2 -> y_2 -> node_3 -> y_3
+  NodeArg* x = &graph.GetOrCreateNodeArg("x", &float_tensor);
+  std::vector<Node*> nodes;
+  NodeArg* input = x;
+  for (int i = 0; i < 4; ++i) {
+    NodeArg* output = &graph.GetOrCreateNodeArg("y_" + std::to_string(i), nullptr);
+    nodes.push_back(&graph.AddNode("node_" + std::to_string(i), "CountedShapeInference_Fake", "", {input}, {output}));
+    input = output;
+  }
+  const NodeArg* y_3 = input;
+
+  num_counted_shape_inference_calls = 0;
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(num_counted_shape_inference_calls, 4);
+
+  // nothing changed
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(num_counted_shape_inference_calls, 4);
+
+  // the change of the input shape propagates to all the nodes downstream
+  TensorShapeProto new_shape;
+  new_shape.add_dim()->set_dim_value(5);
+  new_shape.add_dim()->set_dim_value(3);
+  x->SetShape(new_shape);
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(num_counted_shape_inference_calls, 8);
+  ASSERT_NE(y_3->Shape(), nullptr);
+  EXPECT_EQ(utils::GetTensorShapeFromTensorShapeProto(*y_3->Shape()), TensorShape({5, 3}));
+
+  // a modified node is inferred again, but its output didn't change so the nodes downstream are not
+  nodes[1]->AddAttribute("unused", static_cast<int64_t>(1));
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(num_counted_shape_inference_calls, 9);
+
+  // a node with a new input is inferred again
+  NodeArg& y_1_copy = graph.GetOrCreateNodeArg("y_1_copy", nullptr);
+  graph.AddNode("copy", "CountedShapeInference_Fake", "", {nodes[1]->MutableOutputDefs()[0]}, {&y_1_copy});
+  nodes[3]->MutableInputDefs()[0] = &y_1_copy;
+  ASSERT_STATUS_OK(graph.Resolve());
+  EXPECT_EQ(num_counted_shape_inference_calls, 11);
+}
+
+// the type version of a NodeArg only changes when merging a type changes its element type or shape
+TEST_F(GraphTest, UpdateTypeAndShapeTypeVersion) {
+  Model model("graph", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  auto make_type = [](const std::string& dim_0) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    auto* shape = type.mutable_tensor_type()->mutable_shape();
+    if (std::isdigit(static_cast<unsigned char>(dim_0[0]))) {
+      shape->add_dim()->set_dim_value(std::stoll(dim_0));
+    } else {
+      shape->add_dim()->set_dim_param(dim_0);
+    }
+    shape->add_dim()->set_dim_value(3);
+    return type;
+  };
+
+  const TypeProto x_type = make_type("batch");
+  NodeArg& x = graph.GetOrCreateNodeArg("x", &x_type);
+  uint64_t version = x.TypeVersion();
+
+  // the same shape
+  ASSERT_STATUS_OK(x.UpdateTypeAndShape(make_type("batch"), true, false, *logger_));
+  EXPECT_EQ(x.TypeVersion(), version);
+
+  // a different symbol doesn't replace the current one
+  ASSERT_STATUS_OK(x.UpdateTypeAndShape(make_type("N"), true, false, *logger_));
+  EXPECT_EQ(x.TypeVersion(), version);
+  EXPECT_EQ(x.Shape()->dim(0).dim_param(), "batch");
+
+  // a value replaces the symbol
+  ASSERT_STATUS_OK(x.UpdateTypeAndShape(make_type("5"), true, false, *logger_));
+  EXPECT_NE(x.TypeVersion(), version);
+  EXPECT_EQ(x.Shape()->dim(0).dim_value(), 5);
+  version = x.TypeVersion();
+
+  // and is kept when merging a symbol
+  ASSERT_STATUS_OK(x.UpdateTypeAndShape(make_type("batch"), true, false, *logger_));
+  EXPECT_EQ(x.TypeVersion(), version);
+  EXPECT_EQ(x.Shape()->dim(0).dim_value(), 5);
+}
+
 TEST_F(GraphTest, ShapeInferenceErrorHandling) {
   Model model("graph", false, *logger_);
   auto& graph = model.MainGraph();
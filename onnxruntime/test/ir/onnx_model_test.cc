@@ -2,7 +2,12 @@
 // Licensed under the MIT License.
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <numeric>
+#include "core/framework/tensorprotoutils.h"
 #include "core/platform/env.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
@@ -80,6 +85,66 @@ TEST_F(ONNXModelsTest, future_opset) {
   ASSERT_FALSE(st.IsOK());
 }
 
+TEST_F(ONNXModelsTest, LazyRawDataLoad) {
+  const char* code = R"ONNX(
+<
+  ir_version: 8,
+  opset_import: [ "" : 13]
+>
+agraph (float[256] x) => (float[256] y)
+{
+    z = Add(x, w)
+    y = Mul(z, b)
+}
+)ONNX";
+
+  ModelProto model_proto;
+  ONNX_NAMESPACE::OnnxParser parser(code);
+  ASSERT_TRUE(parser.Parse(model_proto).IsOK());
+
+  std::vector<float> w_values(256);
+  std::iota(w_values.begin(), w_values.end(), 0.f);
+  auto* w = model_proto.mutable_graph()->add_initializer();
+  w->set_name("w");
+  w->set_data_type(TensorProto_DataType_FLOAT);
+  w->add_dims(256);
+  w->set_raw_data(w_values.data(), w_values.size() * sizeof(float));
+  auto* b = model_proto.mutable_graph()->add_initializer();
+  b->set_name("b");
+  b->set_data_type(TensorProto_DataType_FLOAT);
+  b->add_dims(1);
+  const float b_value = 2.f;
+  b->set_raw_data(&b_value, sizeof(float));
+
+  const std::filesystem::path model_path = ORT_TSTR("lazy_raw_data_model.onnx");
+  {
+    std::ofstream model_file(model_path, std::ios::binary);
+    ASSERT_TRUE(model_proto.SerializeToOstream(&model_file));
+  }
+
+  ModelOptions options;
+  options.lazy_raw_data_threshold = 64;
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_path.native(), model, nullptr, *logger_, options));
+
+  // only w is over the threshold, and refers to its raw_data in the model file
+  const Graph& graph = model->MainGraph();
+  const TensorProto* loaded_w = nullptr;
+  const TensorProto* loaded_b = nullptr;
+  ASSERT_TRUE(graph.GetInitializedTensor("w", loaded_w));
+  ASSERT_TRUE(graph.GetInitializedTensor("b", loaded_b));
+  ASSERT_TRUE(utils::HasExternalData(*loaded_w));
+  ASSERT_FALSE(utils::HasExternalData(*loaded_b));
+
+  std::vector<uint8_t> unpacked;
+  ASSERT_STATUS_OK(utils::UnpackInitializerData(*loaded_w, model_path, unpacked));
+  ASSERT_EQ(unpacked.size(), w_values.size() * sizeof(float));
+  EXPECT_EQ(std::memcmp(unpacked.data(), w_values.data(), unpacked.size()), 0);
+
+  model.reset();
+  std::filesystem::remove(model_path);
+}
+
 class ONNXModelsTest1 : public ::testing::TestWithParam<const ORTCHAR_T*> {
   // You can implement all the usual fixture class members here.
   // To access the test parameter, call GetParam() from class
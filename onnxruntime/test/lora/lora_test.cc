@@ -7,6 +7,8 @@
 
 #include "test/util/include/default_providers.h"
 
+#include "core/framework/data_transfer.h"
+#include "core/session/lora_adapter_cache.h"
 #include "core/session/lora_adapters.h"
 #include "lora/adapter_format_version.h"
 #include "lora/adapter_format_utils.h"
@@ -199,6 +201,55 @@ TEST(LoraAdapterTest, Load) {
   }
 }
 
+TEST(LoraAdapterTest, AdapterCache) {
+  // each adapter has two 8x4 float parameters, the budget holds two adapters
+  constexpr size_t adapter_bytes = 2 * 32 * sizeof(float);
+  lora::LoraAdapterCache cache(std::make_shared<CPUAllocator>(), std::make_unique<CPUDataTransfer>(),
+                               2 * adapter_bytes);
+  for (size_t i = 0; i < 3; ++i) {
+    lora::LoraAdapter adapter;
+    adapter.Load(GenerateTestParameters<float>()());
+    ASSERT_EQ(i, cache.Add(std::move(adapter)));
+  }
+
+  std::shared_ptr<const lora::LoraAdapterCache::ResidentAdapter> resident;
+  ASSERT_STATUS_OK(cache.Acquire(0, resident));
+  ASSERT_EQ(2U, resident->params.size());
+  for (const auto& [name, value] : resident->params) {
+    const auto& tensor = value.Get<Tensor>();
+    ASSERT_EQ(TensorShape(param_shape), tensor.Shape());
+    ASSERT_EQ(name == "param_1" ? 0.f : 32.f, tensor.Data<float>()[0]);
+  }
+
+  ASSERT_STATUS_OK(cache.Acquire(1, resident));
+  ASSERT_STATUS_OK(cache.Acquire(0, resident));
+  resident.reset();
+
+  // adapter 1 is the least recently used
+  ASSERT_STATUS_OK(cache.Acquire(2, resident));
+  auto stats = cache.GetStats();
+  ASSERT_EQ(3U, stats.num_adapters);
+  ASSERT_EQ(2U, stats.num_resident);
+  ASSERT_EQ(2 * adapter_bytes, stats.resident_bytes);
+  ASSERT_EQ(1U, stats.hits);
+  ASSERT_EQ(3U, stats.misses);
+  ASSERT_EQ(1U, stats.evictions);
+
+  // adapters in use are not evicted
+  std::shared_ptr<const lora::LoraAdapterCache::ResidentAdapter> other;
+  ASSERT_STATUS_OK(cache.Acquire(0, other));
+  ASSERT_STATUS_NOT_OK(cache.Acquire(1, resident));
+  other.reset();
+  resident.reset();
+
+  cache.Prefetch(1);
+  ASSERT_STATUS_OK(cache.Acquire(1, resident));
+  stats = cache.GetStats();
+  ASSERT_EQ(3U, stats.hits);
+  ASSERT_EQ(1U, stats.prefetches);
+  ASSERT_EQ(2U, stats.evictions);
+}
+
 #ifdef USE_CUDA
 TEST(LoraAdapterTest, VerifyDeviceCopy) {
   auto cpu_ep = DefaultCpuExecutionProvider();
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/platform/env.h"
+#include "core/util/thread_utils.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Q, K and V are BNSH tensors of batch size 1, so sequence length 1 is a decoding step and q == kv is a prompt.
+void FLASHATTENTION(benchmark::State& state) {
+  const int num_heads = static_cast<int>(state.range(0));
+  const int q_sequence_length = static_cast<int>(state.range(1));
+  const int kv_sequence_length = static_cast<int>(state.range(2));
+  const int head_size = static_cast<int>(state.range(3));
+  const int threads = static_cast<int>(state.range(4));
+
+  if (num_heads <= 0 || q_sequence_length <= 0 || kv_sequence_length <= 0 || head_size <= 0 || threads <= 0) {
+    throw std::invalid_argument("NumHeads, SeqQ, SeqKV, HeadSize and Threads must be greater than 0!");
+  }
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = threads;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  auto query = RandomVectorUniform(static_cast<size_t>(num_heads) * q_sequence_length * head_size, -1.0f, 1.0f);
+  auto key = RandomVectorUniform(static_cast<size_t>(num_heads) * kv_sequence_length * head_size, -1.0f, 1.0f);
+  auto value = RandomVectorUniform(static_cast<size_t>(num_heads) * kv_sequence_length * head_size, -1.0f, 1.0f);
+  std::vector<float> output(query.size());
+
+  // the block sizes are chosen the same way as MultiHeadAttention does
+  const int l2_cache_size = onnxruntime::Env::Default().GetL2CacheSize();
+  if (l2_cache_size <= 0) {
+    state.SkipWithMessage("The L2 cache size of the current machine is unknown.");
+    return;
+  }
+
+  MlasFlashAttentionThreadedArgs args;
+  args.batch_size = 1;
+  args.num_heads = num_heads;
+  args.q_sequence_length = q_sequence_length;
+  args.kv_sequence_length = kv_sequence_length;
+  args.qk_head_size = head_size;
+  args.v_head_size = head_size;
+  args.scale = 1.0f / sqrt(static_cast<float>(head_size));
+  args.kv_block_size = std::max(l2_cache_size / (static_cast<int>(sizeof(float)) * 4 * (head_size * 2)), 1);
+  args.q_block_size = std::min(std::min(args.kv_block_size, head_size * 2), q_sequence_length);
+  args.kv_block_size = std::min(args.kv_block_size, kv_sequence_length);
+  args.thread_count = onnxruntime::concurrency::ThreadPool::DegreeOfParallelism(tp.get());
+  args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                 static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
+                                 static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.v_head_size)) *
+                                sizeof(float);
+  std::vector<float> buffer(args.buffer_size_per_thread / sizeof(float) * args.thread_count);
+  args.buffer = buffer.data();
+  args.query = query.data();
+  args.key = key.data();
+  args.value = value.data();
+  args.output = output.data();
+
+  // warming up run
+  MlasFlashAttention(&args, tp.get());
+
+  for (auto _ : state) {
+    MlasFlashAttention(&args, tp.get());
+  }
+}
+
+static void FlashAttentionArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"NumHeads", "SeqQ", "SeqKV", "HeadSize", "Threads"});
+  for (int threads : {1, 8}) {
+    for (int head_size : {64, 128}) {
+      // prompt processing
+      for (int sequence_length : {128, 512, 2048}) {
+        b->Args({32, sequence_length, sequence_length, head_size, threads});
+      }
+      // token generation against a growing past
+      for (int kv_sequence_length : {512, 2048, 8192}) {
+        b->Args({32, 1, kv_sequence_length, head_size, threads});
+      }
+    }
+  }
+}
+
+BENCHMARK(FLASHATTENTION)->Apply(FlashAttentionArgs)->UseRealTime();
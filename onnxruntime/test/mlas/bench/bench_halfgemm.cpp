@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <cstddef>
+#include <stdexcept>
+
+static std::unique_ptr<onnxruntime::concurrency::ThreadPool> CreateGemmThreadPool(int threads) {
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = threads;
+  tpo.auto_set_affinity = true;
+  return std::unique_ptr<onnxruntime::concurrency::ThreadPool>(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+}
+
+// C = A * B with fp16 A and B, where B is the fp16 or fp32 weight of a linear layer.
+void HALFGEMM(benchmark::State& state, bool b_is_fp32) {
+  if (!MlasFp16AccelerationSupported()) {
+    state.SkipWithMessage("Half precision GEMM is not accelerated on the current machine.");
+    return;
+  }
+
+  const auto M = static_cast<size_t>(state.range(0));
+  const auto N = static_cast<size_t>(state.range(1));
+  const auto K = static_cast<size_t>(state.range(2));
+  const auto threads = static_cast<int>(state.range(3));
+
+  if (M == 0 || N == 0 || K == 0 || threads <= 0) {
+    throw std::invalid_argument("M, N, K, and Threads must be greater than 0!");
+  }
+
+  auto tp = CreateGemmThreadPool(threads);
+
+  auto A = RandomVectorUniform<MLAS_FP16>(M * K, MLAS_FP16(-1.0f), MLAS_FP16(1.0f));
+  auto B = RandomVectorUniform<MLAS_FP16>(K * N, MLAS_FP16(-1.0f), MLAS_FP16(1.0f));
+  auto B_fp32 = RandomVectorUniform<float>(K * N, -1.0f, 1.0f);
+  std::vector<MLAS_FP16> C(M * N);
+
+  MLAS_HALF_GEMM_DATA_PARAMS params;
+  params.A = A.data();
+  params.B = b_is_fp32 ? static_cast<const void*>(B_fp32.data()) : static_cast<const void*>(B.data());
+  params.C = C.data();
+  params.lda = K;
+  params.ldb = N;
+  params.ldc = N;
+  params.BIsfp32 = b_is_fp32;
+
+  // warming up run
+  MlasHalfGemmBatch(M, N, K, 1, &params, tp.get());
+
+  for (auto _ : state) {
+    MlasHalfGemmBatch(M, N, K, 1, &params, tp.get());
+  }
+}
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+
+// C = A * B computed in bfloat16 from fp32 A and B, as MatMul does with the bf16 fastmath option.
+void SBGEMM(benchmark::State& state, bool pack_b) {
+  if (!MlasBf16AccelerationSupported()) {
+    state.SkipWithMessage("Bfloat16 GEMM is not accelerated on the current machine.");
+    return;
+  }
+
+  const auto M = static_cast<size_t>(state.range(0));
+  const auto N = static_cast<size_t>(state.range(1));
+  const auto K = static_cast<size_t>(state.range(2));
+  const auto threads = static_cast<int>(state.range(3));
+
+  if (M == 0 || N == 0 || K == 0 || threads <= 0) {
+    throw std::invalid_argument("M, N, K, and Threads must be greater than 0!");
+  }
+
+  auto tp = CreateGemmThreadPool(threads);
+
+  auto A = RandomVectorUniform<float>(M * K, -1.0f, 1.0f);
+  auto B = RandomVectorUniform<float>(K * N, -1.0f, 1.0f);
+  std::vector<float> C(M * N);
+  std::vector<std::byte> B_packed;
+
+  MLAS_SBGEMM_DATA_PARAMS params;
+  params.A = A.data();
+  params.C = C.data();
+  params.lda = K;
+  params.ldc = N;
+  params.AIsfp32 = true;
+  params.BIsfp32 = true;
+  if (pack_b) {
+    B_packed.resize(MlasSBGemmPackBSize(N, K));
+    MlasSBGemmConvertPackB(N, K, B.data(), N, B_packed.data());
+    params.B = B_packed.data();
+    params.ldb = 0;
+    params.BIsfp32 = false;
+  } else {
+    params.B = B.data();
+    params.ldb = N;
+  }
+
+  // warming up run
+  MlasSBGemmBatch(M, N, K, 1, &params, tp.get());
+
+  for (auto _ : state) {
+    MlasSBGemmBatch(M, N, K, 1, &params, tp.get());
+  }
+}
+
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
+
+// the projections of a 4096 hidden size decoder, for a single token and for a prompt
+static void LlmGemmArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "K", "Threads"});
+  b->ArgsProduct({
+      {1, 128, 1024},  // M
+      {4096, 11008},   // N
+      {4096},          // K
+      {8},             // Threads
+  });
+}
+
+BENCHMARK_CAPTURE(HALFGEMM, fp16_b, false)->Apply(LlmGemmArgs)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, fp32_b, true)->Apply(LlmGemmArgs)->UseRealTime();
+
+#if defined(MLAS_SBGEMM_SUPPORTED)
+BENCHMARK_CAPTURE(SBGEMM, unpacked_b, false)->Apply(LlmGemmArgs)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, packed_b, true)->Apply(LlmGemmArgs)->UseRealTime();
+#endif  // defined(MLAS_SBGEMM_SUPPORTED)
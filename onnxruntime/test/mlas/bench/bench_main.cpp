@@ -3,4 +3,20 @@
 
 #include <benchmark/benchmark.h>
 
-BENCHMARK_MAIN();
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  // MLAS_MAXIMUM_ISA limits the kernels MLAS dispatches to, e.g. "avx2" on an AVX-512 machine, so record it with the
+  // results to tell apart the runs of the different kernels.
+  const char* maximum_isa = std::getenv("MLAS_MAXIMUM_ISA");
+  benchmark::AddCustomContext("mlas_maximum_isa", maximum_isa != nullptr ? maximum_isa : "all");
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <stdexcept>
+
+template <typename T>
+void NORM(benchmark::State& state, bool rms) {
+  const auto N = static_cast<size_t>(state.range(0));
+  const auto D = static_cast<size_t>(state.range(1));
+  const auto threads = static_cast<int>(state.range(2));
+
+  if (N == 0 || D == 0 || threads <= 0) {
+    throw std::invalid_argument("N, D, and Threads must be greater than 0!");
+  }
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = threads;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  auto input = RandomVectorUniform<T>(N * D, T(-1.0f), T(1.0f));
+  auto scale = RandomVectorUniform<float>(D, 0.5f, 1.5f);
+  auto bias = RandomVectorUniform<float>(D, -0.5f, 0.5f);
+  std::vector<T> output(input.size());
+
+  auto run = [&]() {
+    if (rms) {
+      MlasRmsNorm<T>(input.data(), scale.data(), output.data(), nullptr, N, D, 1e-6f, tp.get());
+    } else {
+      MlasLayerNormalization<T>(input.data(), scale.data(), bias.data(), output.data(), nullptr, nullptr,
+                                N, D, 1e-5f, tp.get());
+    }
+  };
+
+  // warming up run
+  run();
+
+  for (auto _ : state) {
+    run();
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * N * D * 2 * sizeof(T)));
+}
+
+static void NormArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "D", "Threads"});
+  b->ArgsProduct({
+      {1, 128, 2048},      // N, i.e. tokens
+      {2048, 4096, 8192},  // D, i.e. hidden size
+      {1, 8},              // Threads
+  });
+}
+
+BENCHMARK_CAPTURE(NORM<float>, layer_norm_fp32, false)->Apply(NormArgs)->UseRealTime();
+BENCHMARK_CAPTURE(NORM<float>, rms_norm_fp32, true)->Apply(NormArgs)->UseRealTime();
+BENCHMARK_CAPTURE(NORM<MLAS_FP16>, layer_norm_fp16, false)->Apply(NormArgs)->UseRealTime();
+BENCHMARK_CAPTURE(NORM<MLAS_FP16>, rms_norm_fp16, true)->Apply(NormArgs)->UseRealTime();
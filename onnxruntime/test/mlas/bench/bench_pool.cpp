@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+
+// Pools an NHWC fp16 tensor of batch size 1 with a square kernel, stride 1 and no padding. The indirect buffer
+// holds, for every output pixel, the address of each of the input pixels under the kernel.
+void NHWCPOOLFP16(benchmark::State& state, bool max_pool) {
+  const auto H = static_cast<size_t>(state.range(0));
+  const auto W = static_cast<size_t>(state.range(0));
+  const auto C = static_cast<size_t>(state.range(1));
+  const auto kernel = static_cast<size_t>(state.range(2));
+
+  if (C == 0 || kernel == 0 || H < kernel) {
+    throw std::invalid_argument("Channels and Kernel must be greater than 0 and Kernel must not exceed HW!");
+  }
+
+  const size_t out_h = H - kernel + 1;
+  const size_t out_w = W - kernel + 1;
+  const size_t output_count = out_h * out_w;
+  const size_t kernel_size = kernel * kernel;
+
+  auto input = RandomVectorUniform<MLAS_FP16>(H * W * C, MLAS_FP16(-1.0f), MLAS_FP16(1.0f));
+  std::vector<MLAS_FP16> output(output_count * C);
+
+  std::vector<const MLAS_FP16*> indirect(output_count * kernel_size);
+  for (size_t oh = 0; oh < out_h; ++oh) {
+    for (size_t ow = 0; ow < out_w; ++ow) {
+      const MLAS_FP16** pixel = indirect.data() + (oh * out_w + ow) * kernel_size;
+      for (size_t kh = 0; kh < kernel; ++kh) {
+        for (size_t kw = 0; kw < kernel; ++kw) {
+          *pixel++ = input.data() + ((oh + kh) * W + ow + kw) * C;
+        }
+      }
+    }
+  }
+
+  auto run = [&]() {
+    if (max_pool) {
+      MlasNhwcMaxPool(indirect.data(), output.data(), C, output_count, kernel_size);
+    } else {
+      MlasNhwcAvgPool(indirect.data(), output.data(), C, output_count, kernel_size);
+    }
+  };
+
+  // warming up run
+  run();
+
+  for (auto _ : state) {
+    run();
+  }
+}
+
+static void NhwcPoolArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"HW", "Channels", "Kernel"});
+  b->ArgsProduct({
+      {14, 56},         // HW
+      {64, 256, 1024},  // Channels
+      {2, 3},           // Kernel
+  });
+}
+
+BENCHMARK_CAPTURE(NHWCPOOLFP16, max, true)->Apply(NhwcPoolArgs)->UseRealTime();
+BENCHMARK_CAPTURE(NHWCPOOLFP16, avg, false)->Apply(NhwcPoolArgs)->UseRealTime();
+
+#endif  // MLAS_F16VEC_INTRINSICS_SUPPORTED
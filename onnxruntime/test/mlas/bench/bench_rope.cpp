@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+// Rotates the rows of one token of all the heads, as RotaryEmbedding does for each position.
+template <typename T>
+void ROPE(benchmark::State& state, bool interleaved) {
+  const auto rows = static_cast<size_t>(state.range(0));
+  const auto dim = static_cast<size_t>(state.range(1));
+
+  if (rows == 0 || dim == 0 || dim % 2 != 0) {
+    throw std::invalid_argument("Rows must be greater than 0 and Dim must be a positive even number!");
+  }
+
+  auto input = RandomVectorUniform<T>(rows * dim, T(-1.0f), T(1.0f));
+  auto sin_data = RandomVectorUniform<T>(dim / 2, T(-1.0f), T(1.0f));
+  auto cos_data = RandomVectorUniform<T>(dim / 2, T(-1.0f), T(1.0f));
+  std::vector<T> output(input.size());
+
+  for (auto _ : state) {
+    for (size_t r = 0; r < rows; ++r) {
+      MlasRotaryEmbedOneRow<T>(input.data() + r * dim, sin_data.data(), cos_data.data(), dim, interleaved,
+                               output.data() + r * dim);
+    }
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * rows * dim * 2 * sizeof(T)));
+}
+
+static void RopeArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"Rows", "Dim"});
+  b->ArgsProduct({
+      {1, 32, 256},       // Rows, i.e. heads times tokens
+      {64, 80, 96, 128},  // Dim
+  });
+}
+
+BENCHMARK_CAPTURE(ROPE<float>, fp32_non_interleaved, false)->Apply(RopeArgs)->UseRealTime();
+BENCHMARK_CAPTURE(ROPE<float>, fp32_interleaved, true)->Apply(RopeArgs)->UseRealTime();
+BENCHMARK_CAPTURE(ROPE<MLAS_FP16>, fp16_non_interleaved, false)->Apply(RopeArgs)->UseRealTime();
+BENCHMARK_CAPTURE(ROPE<MLAS_FP16>, fp16_interleaved, true)->Apply(RopeArgs)->UseRealTime();
@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasFloat8ToFloatTest : public MlasTestBase {
+ private:
+  struct Case {
+    uint8_t bits;
+    float value;
+  };
+
+  static void Test(MLAS_FLOAT8_TYPE Type, std::initializer_list<Case> Cases, std::initializer_list<uint8_t> NaNs) {
+    for (const auto& c : Cases) {
+      float Output[2];
+      const uint8_t Input[2] = {c.bits, c.bits};
+      MlasConvertFloat8ToFloatBuffer(Input, Output, 1, Type);
+      MlasConvertFloat8ToFloatBuffer(Input + 1, Output + 1, 1, Type, -0.5f);
+      ASSERT_EQ(Output[0], c.value) << "type " << int(Type) << ", bits " << int(c.bits);
+      ASSERT_EQ(Output[1], c.value * -0.5f) << "type " << int(Type) << ", bits " << int(c.bits);
+    }
+
+    for (uint8_t bits : NaNs) {
+      float Output;
+      MlasConvertFloat8ToFloatBuffer(&bits, &Output, 1, Type);
+      ASSERT_TRUE(std::isnan(Output)) << "type " << int(Type) << ", bits " << int(bits);
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Float8ToFloat");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    // zero, one, the largest normal and the smallest subnormal of each format
+    Test(MlasFloat8E4M3FN, {{0x00, 0.0f}, {0x38, 1.0f}, {0xB8, -1.0f}, {0x7E, 448.0f}, {0x01, 0.001953125f}},
+         {0x7F, 0xFF});
+    Test(MlasFloat8E4M3FNUZ, {{0x00, 0.0f}, {0x40, 1.0f}, {0xC0, -1.0f}, {0x7F, 240.0f}, {0x01, 0.0009765625f}},
+         {0x80});
+    Test(MlasFloat8E5M2, {{0x00, 0.0f}, {0x3C, 1.0f}, {0xBC, -1.0f}, {0x7B, 57344.0f}, {0x01, 1.52587890625e-5f},
+                          {0x7C, std::numeric_limits<float>::infinity()}},
+         {0x7D, 0xFF});
+    Test(MlasFloat8E5M2FNUZ, {{0x00, 0.0f}, {0x40, 1.0f}, {0xC0, -1.0f}, {0x7F, 57344.0f}, {0x01, 7.62939453125e-6f}},
+         {0x80});
+
+    // the finite values of a buffer of every encoding are symmetric and grow with the bits
+    std::vector<uint8_t> Input(256);
+    std::vector<float> Output(256);
+    for (size_t i = 0; i < Input.size(); ++i) {
+      Input[i] = static_cast<uint8_t>(i);
+    }
+    MlasConvertFloat8ToFloatBuffer(Input.data(), Output.data(), Input.size(), MlasFloat8E4M3FN, 2.0f);
+    for (size_t i = 1; i < 0x7F; ++i) {
+      ASSERT_LT(Output[i - 1], Output[i]) << "bits " << i;
+      ASSERT_EQ(Output[i | 0x80], -Output[i]) << "bits " << i;
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasFloat8ToFloatTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasConv2DWinogradTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferFilter;
+  MatrixGuardBuffer<float> BufferPackedFilter;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferWorking;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void ReferenceConv2D(size_t BatchCount,
+                              size_t InputChannels,
+                              size_t InputHeight,
+                              size_t InputWidth,
+                              size_t FilterCount,
+                              size_t PaddingTop,
+                              size_t PaddingLeft,
+                              size_t OutputHeight,
+                              size_t OutputWidth,
+                              const float* Input,
+                              const float* Filter,
+                              const float* Bias,
+                              float Beta,
+                              float* Output) {
+    for (size_t n = 0; n < BatchCount; n++) {
+      for (size_t f = 0; f < FilterCount; f++) {
+        for (size_t oh = 0; oh < OutputHeight; oh++) {
+          for (size_t ow = 0; ow < OutputWidth; ow++) {
+            double Accumulator = Bias[f];
+
+            for (size_t c = 0; c < InputChannels; c++) {
+              for (size_t kh = 0; kh < 3; kh++) {
+                for (size_t kw = 0; kw < 3; kw++) {
+                  size_t ih = oh + kh - PaddingTop;
+                  size_t iw = ow + kw - PaddingLeft;
+                  if (ih < InputHeight && iw < InputWidth) {
+                    Accumulator += double(Input[((n * InputChannels + c) * InputHeight + ih) * InputWidth + iw]) *
+                                   double(Filter[((f * InputChannels + c) * 3 + kh) * 3 + kw]);
+                  }
+                }
+              }
+            }
+
+            float& Value = Output[((n * FilterCount + f) * OutputHeight + oh) * OutputWidth + ow];
+            Value = std::max(float(Accumulator + Beta * Value), 0.0f);
+          }
+        }
+      }
+    }
+  }
+
+  void Test(size_t BatchCount,
+            size_t InputChannels,
+            size_t InputHeight,
+            size_t InputWidth,
+            size_t FilterCount,
+            size_t PaddingTop,
+            size_t PaddingLeft,
+            size_t PaddingBottom,
+            size_t PaddingRight,
+            float Beta) {
+    const size_t OutputHeight = InputHeight + PaddingTop + PaddingBottom - 2;
+    const size_t OutputWidth = InputWidth + PaddingLeft + PaddingRight - 2;
+
+    const size_t InputElements = BatchCount * InputChannels * InputHeight * InputWidth;
+    const size_t FilterElements = FilterCount * InputChannels * 9;
+    const size_t OutputElements = BatchCount * FilterCount * OutputHeight * OutputWidth;
+
+    float* Input = BufferInput.GetBuffer(InputElements);
+    float* Filter = BufferFilter.GetBuffer(FilterElements);
+    float* Bias = BufferBias.GetBuffer(FilterCount);
+    float* Output = BufferOutput.GetBuffer(OutputElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+    std::default_random_engine generator(static_cast<unsigned>(InputElements + FilterElements));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    auto fill = [&](float* Buffer, size_t Count) {
+      for (size_t i = 0; i < Count; i++) {
+        Buffer[i] = distribution(generator);
+      }
+    };
+
+    fill(Input, InputElements);
+    fill(Filter, FilterElements);
+    fill(Bias, FilterCount);
+    fill(Output, OutputElements);
+    std::copy_n(Output, OutputElements, OutputReference);
+
+    int64_t InputShape[] = {int64_t(InputHeight), int64_t(InputWidth)};
+    int64_t KernelShape[] = {3, 3};
+    int64_t DilationShape[] = {1, 1};
+    int64_t Padding[] = {int64_t(PaddingTop), int64_t(PaddingLeft), int64_t(PaddingBottom), int64_t(PaddingRight)};
+    int64_t StrideShape[] = {1, 1};
+    int64_t OutputShape[] = {int64_t(OutputHeight), int64_t(OutputWidth)};
+
+    ASSERT_TRUE(MlasConvWinogradIsSupported(1, InputChannels, FilterCount, KernelShape, DilationShape, StrideShape));
+
+    const size_t PackedFilterSize = MlasConvWinogradPackFilterSize(FilterCount, InputChannels);
+    float* PackedFilter = BufferPackedFilter.GetBuffer(PackedFilterSize / sizeof(float), true);
+    MlasConvWinogradPackFilter(FilterCount, InputChannels, Filter, PackedFilter);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasReluActivation;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters,
+                    2,
+                    BatchCount,
+                    1,
+                    InputChannels,
+                    InputShape,
+                    KernelShape,
+                    DilationShape,
+                    Padding,
+                    StrideShape,
+                    OutputShape,
+                    FilterCount,
+                    &Activation,
+                    &WorkingBufferSize,
+                    Beta,
+                    threadpool_);
+
+    MlasConvWinogradPrepare(&Parameters, &WorkingBufferSize, threadpool_);
+
+    MlasConv(&Parameters,
+             Input,
+             PackedFilter,
+             Bias,
+             BufferWorking.GetBuffer(WorkingBufferSize),
+             Output,
+             threadpool_);
+
+    ReferenceConv2D(BatchCount, InputChannels, InputHeight, InputWidth, FilterCount, PaddingTop, PaddingLeft,
+                    OutputHeight, OutputWidth, Input, Filter, Bias, Beta, OutputReference);
+
+    //
+    // The Winograd transforms reassociate the accumulation, so compare with
+    // a tolerance that grows with the reduction length.
+    //
+
+    const float Tolerance = 2e-5f * float(InputChannels * 9);
+
+    for (size_t i = 0; i < OutputElements; i++) {
+      ASSERT_LE(std::fabs(Output[i] - OutputReference[i]), Tolerance)
+          << "mismatch at " << i << ", got: " << Output[i] << ", expecting: " << OutputReference[i]
+          << " B" << BatchCount << "/C" << InputChannels << "/H" << InputHeight << "/W" << InputWidth
+          << "/F" << FilterCount << "/Beta" << Beta;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "Conv2dWinograd_Threaded" : "Conv2dWinograd_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasConv2DWinogradTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    int64_t KernelShape[] = {3, 3};
+    int64_t Ones[] = {1, 1};
+    int64_t Twos[] = {2, 2};
+
+    EXPECT_FALSE(MlasConvWinogradIsSupported(2, 16, 16, KernelShape, Ones, Ones));
+    EXPECT_FALSE(MlasConvWinogradIsSupported(1, 16, 16, KernelShape, Ones, Twos));
+    EXPECT_FALSE(MlasConvWinogradIsSupported(1, 16, 16, KernelShape, Twos, Ones));
+    EXPECT_FALSE(MlasConvWinogradIsSupported(1, 3, 16, KernelShape, Ones, Ones));
+
+    Test(1, 16, 8, 8, 16, 1, 1, 1, 1, 0.0f);
+    Test(1, 16, 3, 3, 16, 1, 1, 1, 1, 0.0f);
+    Test(2, 17, 13, 11, 19, 1, 1, 1, 1, 0.0f);
+    Test(1, 16, 7, 150, 20, 0, 0, 0, 0, 0.0f);
+    Test(3, 32, 5, 5, 16, 2, 1, 0, 2, 1.0f);
+    Test(1, 64, 28, 28, 64, 1, 1, 1, 1, 0.0f);
+    Test(2, 24, 14, 19, 40, 1, 1, 1, 1, 1.0f);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasConv2DWinogradTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasConv2DWinogradTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
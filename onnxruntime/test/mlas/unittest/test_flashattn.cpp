@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Tests MlasFlashAttention with the layouts used by GroupQueryAttention: query heads sharing kv heads,
+// K and V buffers longer than the valid tokens, strided Q batches, per batch kv lengths, and the causal
+// and local window masks.
+//
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferThreads;
+  MLAS_THREADPOOL* threadpool_;
+
+  static constexpr int ThreadCount = 4;
+
+  struct Shape {
+    int BatchSize;
+    int NumHeads;
+    int KvNumHeads;
+    int QSequenceLength;
+    int KvBufferSequenceLength;
+    int HeadSize;
+    int QBlockSize;
+    int KvBlockSize;
+    // Extra elements between the Q batches, as with packed QKV.
+    size_t QBatchPadding;
+  };
+
+  void Test(const Shape& shape, const std::vector<int>& KvSequenceLengths, bool IsCausal, int LocalWindowSize) {
+    const size_t QBatchStride =
+        size_t(shape.NumHeads) * shape.QSequenceLength * shape.HeadSize + shape.QBatchPadding;
+    const size_t KvSize = size_t(shape.BatchSize) * shape.KvNumHeads * shape.KvBufferSequenceLength * shape.HeadSize;
+    const size_t OutputSize = size_t(shape.BatchSize) * shape.QSequenceLength * shape.NumHeads * shape.HeadSize;
+
+    float* Query = BufferQuery.GetBuffer(QBatchStride * shape.BatchSize);
+    float* Key = BufferKey.GetBuffer(KvSize);
+    float* Value = BufferValue.GetBuffer(KvSize);
+    float* Output = BufferOutput.GetBuffer(OutputSize);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputSize);
+
+    std::default_random_engine generator(static_cast<unsigned>(QBatchStride + KvSize));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < QBatchStride * shape.BatchSize; i++) {
+      Query[i] = distribution(generator);
+    }
+    // The tokens of K and V past the valid ones are garbage that must not be read.
+    for (size_t i = 0; i < KvSize; i++) {
+      Key[i] = distribution(generator);
+      Value[i] = distribution(generator);
+    }
+    for (int b = 0; b < shape.BatchSize; b++) {
+      for (int h = 0; h < shape.KvNumHeads; h++) {
+        for (int s = KvSequenceLengths[b]; s < shape.KvBufferSequenceLength; s++) {
+          size_t offset = ((size_t(b) * shape.KvNumHeads + h) * shape.KvBufferSequenceLength + s) * shape.HeadSize;
+          std::fill_n(Key + offset, shape.HeadSize, 1e30f);
+          std::fill_n(Value + offset, shape.HeadSize, std::numeric_limits<float>::quiet_NaN());
+        }
+      }
+    }
+
+    const int MaxKvSequenceLength = *std::max_element(KvSequenceLengths.begin(), KvSequenceLengths.end());
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = shape.BatchSize;
+    args.num_heads = shape.NumHeads;
+    args.q_sequence_length = shape.QSequenceLength;
+    args.kv_sequence_length = MaxKvSequenceLength;
+    args.qk_head_size = shape.HeadSize;
+    args.v_head_size = shape.HeadSize;
+    args.q_block_size = shape.QBlockSize;
+    args.kv_block_size = shape.KvBlockSize;
+    args.scale = 1.0f / std::sqrt(static_cast<float>(shape.HeadSize));
+    args.thread_count = ThreadCount;
+    args.buffer_size_per_thread = (size_t(shape.QBlockSize) * 2 +
+                                   size_t(shape.QBlockSize) * shape.KvBlockSize +
+                                   size_t(shape.QBlockSize) * shape.HeadSize) *
+                                  sizeof(float);
+    args.buffer = BufferThreads.GetBuffer(args.buffer_size_per_thread / sizeof(float) * ThreadCount);
+    args.query = Query;
+    args.key = Key;
+    args.value = Value;
+    args.output = Output;
+    args.kv_num_heads = shape.KvNumHeads;
+    args.kv_buffer_sequence_length = shape.KvBufferSequenceLength;
+    args.q_batch_stride = QBatchStride;
+    args.kv_sequence_lengths = KvSequenceLengths.data();
+    args.is_causal = IsCausal;
+    args.local_window_size = LocalWindowSize;
+
+    MlasFlashAttention(&args, threadpool_);
+
+    ReferenceAttention(shape, Query, QBatchStride, Key, Value, OutputReference, KvSequenceLengths, args.scale,
+                       IsCausal, LocalWindowSize);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-5f;
+
+    for (size_t i = 0; i < OutputSize; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+          << "@" << i << " of B" << shape.BatchSize << "/N" << shape.NumHeads << "/KvN" << shape.KvNumHeads
+          << "/S" << shape.QSequenceLength << "/KvS" << shape.KvBufferSequenceLength << "/H" << shape.HeadSize
+          << " causal:" << IsCausal << " window:" << LocalWindowSize
+          << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+  static void ReferenceAttention(const Shape& shape,
+                                 const float* Query,
+                                 size_t QBatchStride,
+                                 const float* Key,
+                                 const float* Value,
+                                 float* Output,
+                                 const std::vector<int>& KvSequenceLengths,
+                                 float Scale,
+                                 bool IsCausal,
+                                 int LocalWindowSize) {
+    const int HeadsPerKvHead = shape.NumHeads / shape.KvNumHeads;
+    std::vector<double> Scores;
+
+    for (int b = 0; b < shape.BatchSize; b++) {
+      const int KvLength = KvSequenceLengths[b];
+      for (int h = 0; h < shape.NumHeads; h++) {
+        const size_t KvOffset = (size_t(b) * shape.KvNumHeads + h / HeadsPerKvHead) * shape.KvBufferSequenceLength;
+        for (int i = 0; i < shape.QSequenceLength; i++) {
+          const float* q = Query + b * QBatchStride + (size_t(h) * shape.QSequenceLength + i) * shape.HeadSize;
+          float* o = Output + ((size_t(b) * shape.QSequenceLength + i) * shape.NumHeads + h) * shape.HeadSize;
+
+          int Start = 0;
+          int End = KvLength;
+          if (IsCausal) {
+            const int Position = (std::max)(0, KvLength - shape.QSequenceLength) + i;
+            End = (std::min)(KvLength, Position + 1);
+            if (LocalWindowSize > 0) {
+              Start = (std::max)(0, Position - LocalWindowSize);
+            }
+          }
+
+          std::fill_n(o, shape.HeadSize, 0.0f);
+          if (Start >= End) {
+            continue;
+          }
+
+          Scores.assign(End - Start, 0.0);
+          double MaximumScore = std::numeric_limits<double>::lowest();
+          for (int j = Start; j < End; j++) {
+            const float* k = Key + (KvOffset + j) * shape.HeadSize;
+            double Dot = 0.0;
+            for (int d = 0; d < shape.HeadSize; d++) {
+              Dot += double(q[d]) * double(k[d]);
+            }
+            Scores[j - Start] = Dot * Scale;
+            MaximumScore = (std::max)(MaximumScore, Scores[j - Start]);
+          }
+
+          double Sum = 0.0;
+          for (double& Score : Scores) {
+            Score = std::exp(Score - MaximumScore);
+            Sum += Score;
+          }
+
+          for (int d = 0; d < shape.HeadSize; d++) {
+            double Accumulator = 0.0;
+            for (int j = Start; j < End; j++) {
+              Accumulator += Scores[j - Start] * Value[(KvOffset + j) * shape.HeadSize + d];
+            }
+            o[d] = float(Accumulator / Sum);
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "FlashAttention_Threaded" : "FlashAttention_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    // BatchSize, NumHeads, KvNumHeads, QSequenceLength, KvBufferSequenceLength, HeadSize,
+    // QBlockSize, KvBlockSize, QBatchPadding
+    const Shape Prompt{2, 4, 2, 7, 12, 8, 3, 4, 0};
+    const Shape PackedQkv{3, 6, 2, 5, 9, 16, 2, 3, 2 * 2 * 5 * 16};
+    const Shape Decoding{3, 8, 1, 1, 20, 8, 1, 6, 2 * 1 * 1 * 8};
+    const Shape MultiHeadAttention{2, 3, 3, 9, 9, 4, 4, 4, 0};
+
+    for (bool IsCausal : {false, true}) {
+      Test(MultiHeadAttention, {9, 9}, IsCausal, -1);
+      // the first prompt fills the buffer, the second one is padded
+      Test(Prompt, {7, 5}, IsCausal, -1);
+      // continuing prompts after past tokens
+      Test(PackedQkv, {5, 9, 7}, IsCausal, -1);
+      Test(Decoding, {1, 20, 13}, IsCausal, -1);
+    }
+
+    for (int LocalWindowSize : {1, 2, 5, 30}) {
+      Test(Prompt, {7, 5}, true, LocalWindowSize);
+      Test(PackedQkv, {5, 9, 7}, true, LocalWindowSize);
+      Test(Decoding, {1, 20, 13}, true, LocalWindowSize);
+      Test(MultiHeadAttention, {9, 9}, true, LocalWindowSize);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,230 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_fp16.h"
+
+template <bool Threaded>
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferSkip;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferScaleBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferSum;
+  MatrixGuardBuffer<float> BufferSumReference;
+  MatrixGuardBuffer<float> BufferMean;
+  MatrixGuardBuffer<float> BufferMeanReference;
+  MatrixGuardBuffer<float> BufferInvStdDev;
+  MatrixGuardBuffer<float> BufferInvStdDevReference;
+  MatrixGuardBuffer<MLFp16> BufferInputFp16;
+  MatrixGuardBuffer<MLFp16> BufferOutputFp16;
+  MatrixGuardBuffer<MLFp16> BufferSumFp16;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void ReferenceNorm(const float* Input,
+                            const float* Skip,
+                            size_t SkipSize,
+                            const float* Bias,
+                            const float* Scale,
+                            const float* ScaleBias,
+                            float* Output,
+                            float* Sum,
+                            float* Mean,
+                            float* InvStdDev,
+                            size_t N,
+                            size_t D,
+                            float Epsilon,
+                            bool Simplified) {
+    std::vector<double> Row(D);
+
+    for (size_t n = 0; n < N; n++) {
+      double RowSum = 0.0;
+      double RowSumSquare = 0.0;
+
+      for (size_t d = 0; d < D; d++) {
+        double Value = Input[n * D + d];
+        if (Skip != nullptr) {
+          Value += Skip[(n * D) % SkipSize + d];
+        }
+        if (Bias != nullptr) {
+          Value += Bias[d];
+        }
+        if (Sum != nullptr) {
+          Sum[n * D + d] = float(Value);
+        }
+        Row[d] = Value;
+        RowSum += Value;
+        RowSumSquare += Value * Value;
+      }
+
+      double RowMean = Simplified ? 0.0 : RowSum / D;
+      double RowInvStdDev = 1.0 / std::sqrt(RowSumSquare / D - RowMean * RowMean + Epsilon);
+
+      for (size_t d = 0; d < D; d++) {
+        double Value = (Row[d] - RowMean) * RowInvStdDev * Scale[d];
+        if (ScaleBias != nullptr) {
+          Value += ScaleBias[d];
+        }
+        Output[n * D + d] = float(Value);
+      }
+
+      Mean[n] = float(RowMean);
+      InvStdDev[n] = float(RowInvStdDev);
+    }
+  }
+
+  static void Check(const float* Output, const float* OutputReference, size_t Count, float Tolerance, const char* Name) {
+    for (size_t i = 0; i < Count; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= Tolerance || diff <= std::fabs(OutputReference[i]) * Tolerance)
+          << Name << " mismatch at " << i << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+  void Test(size_t N, size_t D, size_t SkipRows, bool HasBias, bool HasScaleBias, bool Simplified) {
+    const size_t SkipSize = SkipRows * D;
+
+    float* Input = BufferInput.GetBuffer(N * D);
+    float* Skip = SkipRows > 0 ? BufferSkip.GetBuffer(SkipSize) : nullptr;
+    float* Bias = HasBias ? BufferBias.GetBuffer(D) : nullptr;
+    float* Scale = BufferScale.GetBuffer(D);
+    float* ScaleBias = (HasScaleBias && !Simplified) ? BufferScaleBias.GetBuffer(D) : nullptr;
+    float* Output = BufferOutput.GetBuffer(N * D);
+    float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+    float* Sum = BufferSum.GetBuffer(N * D);
+    float* SumReference = BufferSumReference.GetBuffer(N * D);
+    float* Mean = BufferMean.GetBuffer(N);
+    float* MeanReference = BufferMeanReference.GetBuffer(N);
+    float* InvStdDev = BufferInvStdDev.GetBuffer(N);
+    float* InvStdDevReference = BufferInvStdDevReference.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N * D + SkipRows));
+    std::uniform_real_distribution<float> distribution(-2.0f, 3.0f);
+
+    auto fill = [&](float* Buffer, size_t Count) {
+      for (size_t i = 0; i < Count; i++) {
+        Buffer[i] = distribution(generator);
+      }
+    };
+
+    fill(Input, N * D);
+    fill(Scale, D);
+    if (Skip != nullptr) fill(Skip, SkipSize);
+    if (Bias != nullptr) fill(Bias, D);
+    if (ScaleBias != nullptr) fill(ScaleBias, D);
+
+    constexpr float Epsilon = 1e-5f;
+    constexpr float Tolerance = 1e-4f;
+
+    ReferenceNorm(Input, Skip, SkipSize, Bias, Scale, ScaleBias, OutputReference, SumReference,
+                  MeanReference, InvStdDevReference, N, D, Epsilon, Simplified);
+
+    if (Skip != nullptr) {
+      MlasSkipLayerNorm(Input, Skip, SkipSize, Bias, Scale, ScaleBias, Output, Sum, N, D, Epsilon, Simplified,
+                        threadpool_);
+      Check(Output, OutputReference, N * D, Tolerance, "SkipLayerNorm");
+      Check(Sum, SumReference, N * D, Tolerance, "SkipLayerNorm sum");
+
+      // The sum output is optional.
+      MlasSkipLayerNorm(Input, Skip, SkipSize, Bias, Scale, ScaleBias, Output, static_cast<float*>(nullptr), N, D,
+                        Epsilon, Simplified, threadpool_);
+      Check(Output, OutputReference, N * D, Tolerance, "SkipLayerNorm without sum");
+
+    } else if (Simplified) {
+      MlasRmsNorm(Input, Scale, Output, InvStdDev, N, D, Epsilon, threadpool_);
+      Check(Output, OutputReference, N * D, Tolerance, "RmsNorm");
+      Check(InvStdDev, InvStdDevReference, N, Tolerance, "RmsNorm inverse root mean square");
+
+    } else {
+      MlasLayerNormalization(Input, Scale, ScaleBias, Output, Mean, InvStdDev, N, D, Epsilon, threadpool_);
+      Check(Output, OutputReference, N * D, Tolerance, "LayerNorm");
+      Check(Mean, MeanReference, N, Tolerance, "LayerNorm mean");
+      Check(InvStdDev, InvStdDevReference, N, Tolerance, "LayerNorm inverse standard deviation");
+
+      // The operation supports in place updates.
+      std::copy_n(Input, N * D, Output);
+      MlasLayerNormalization(Output, Scale, ScaleBias, Output, nullptr, nullptr, N, D, Epsilon, threadpool_);
+      Check(Output, OutputReference, N * D, Tolerance, "LayerNorm in place");
+    }
+
+    //
+    // Repeat the operation with half precision input and outputs, comparing
+    // against the reference computed from the rounded input.
+    //
+
+    MLFp16* InputFp16 = BufferInputFp16.GetBuffer(N * D);
+    MLFp16* OutputFp16 = BufferOutputFp16.GetBuffer(N * D);
+    MLFp16* SumFp16 = BufferSumFp16.GetBuffer(N * D);
+
+    for (size_t i = 0; i < N * D; i++) {
+      InputFp16[i] = MLFp16(Input[i]);
+      Input[i] = InputFp16[i].ToFloat();
+    }
+
+    ReferenceNorm(Input, Skip, SkipSize, Bias, Scale, ScaleBias, OutputReference, SumReference,
+                  MeanReference, InvStdDevReference, N, D, Epsilon, Simplified);
+
+    const auto* InputHalf = reinterpret_cast<const MLAS_FP16*>(InputFp16);
+    auto* OutputHalf = reinterpret_cast<MLAS_FP16*>(OutputFp16);
+
+    if (Skip != nullptr) {
+      MlasSkipLayerNorm(InputHalf, Skip, SkipSize, Bias, Scale, ScaleBias, OutputHalf,
+                        reinterpret_cast<MLAS_FP16*>(SumFp16), N, D, Epsilon, Simplified, threadpool_);
+    } else if (Simplified) {
+      MlasRmsNorm(InputHalf, Scale, OutputHalf, InvStdDev, N, D, Epsilon, threadpool_);
+    } else {
+      MlasLayerNormalization(InputHalf, Scale, ScaleBias, OutputHalf, Mean, InvStdDev, N, D, Epsilon, threadpool_);
+    }
+
+    for (size_t i = 0; i < N * D; i++) {
+      Output[i] = OutputFp16[i].ToFloat();
+      Sum[i] = SumFp16[i].ToFloat();
+    }
+
+    constexpr float ToleranceFp16 = 4e-3f;
+
+    Check(Output, OutputReference, N * D, ToleranceFp16, "Fp16 output");
+    if (Skip != nullptr) {
+      Check(Sum, SumReference, N * D, ToleranceFp16, "Fp16 sum");
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "LayerNorm_Threaded" : "LayerNorm_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasLayerNormTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (size_t d = 1; d < 80; d++) {
+      Test(3, d, 0, false, true, false);
+      Test(3, d, 0, false, false, true);
+      Test(3, d, 3, true, true, false);
+      Test(3, d, 1, false, false, true);
+    }
+
+    Test(64, 768, 0, false, true, false);
+    Test(64, 768, 0, false, false, false);
+    Test(33, 1024, 0, false, false, true);
+    Test(16, 4096, 16, true, true, false);
+    Test(17, 4095, 1, true, false, false);
+    Test(40, 1023, 40, false, false, true);
+    Test(40, 1023, 8, true, false, true);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasLayerNormTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
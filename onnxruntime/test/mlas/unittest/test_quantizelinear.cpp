@@ -181,6 +181,71 @@ class MlasQuantizeLinear4BitTest : public MlasTestBase {
   }
 };
 
+template <bool Threaded>
+class MlasDynamicQuantizeLinearPerRowTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<uint8_t> BufferOutput;
+  MatrixGuardBuffer<float> BufferScale;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t M, size_t K) {
+    const size_t lda = K + 3;
+    float* Input = BufferInput.GetBuffer(M * lda);
+    uint8_t* Output = BufferOutput.GetBuffer(M * K);
+    float* Scale = BufferScale.GetBuffer(M);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t m = 0; m < M; m++) {
+      // Vary the range of each row, leaving the last row as all zeros.
+      const float RowRange = (m + 1 < M || M == 1) ? std::ldexp(1.0f, int(m % 16) - 8) : 0.0f;
+      for (size_t k = 0; k < lda; k++) {
+        Input[m * lda + k] = distribution(generator) * RowRange;
+      }
+    }
+
+    MlasDynamicQuantizeLinearPerRow(Input, lda, Output, K, Scale, M, K, threadpool_);
+
+    for (size_t m = 0; m < M; m++) {
+      float AbsMaximum = 0.0f;
+      for (size_t k = 0; k < K; k++) {
+        AbsMaximum = std::max(AbsMaximum, std::fabs(Input[m * lda + k]));
+      }
+
+      const float ScaleReference = (AbsMaximum > 0.0f) ? AbsMaximum / 127.0f : 1.0f;
+      ASSERT_EQ(Scale[m], ScaleReference) << ", size=[" << M << "," << K << "], row=" << m;
+
+      for (size_t k = 0; k < K; k++) {
+        float FloatValue = std::nearbyintf(Input[m * lda + k] / ScaleReference);
+        FloatValue = std::clamp(FloatValue, -127.0f, 127.0f) + float(MLAS_DYNAMIC_QUANTIZE_ROW_ZERO_POINT);
+        ASSERT_EQ(Output[m * K + k], static_cast<uint8_t>(FloatValue))
+            << ", size=[" << M << "," << K << "], index=[" << m << "," << k << "]";
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "DynamicQuantizeLinearPerRow_Threaded"
+                                                 : "DynamicQuantizeLinearPerRow_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasDynamicQuantizeLinearPerRowTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (size_t k = 1; k <= 72; k++) {
+      Test(3, k);
+    }
+
+    Test(1, 4096);
+    Test(64, 768);
+    Test(17, 4095);
+  }
+};
+
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
   size_t count = 0;
   if (is_short_execute) {
@@ -190,6 +255,10 @@ static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_exe
     count += MlasDirectShortExecuteTests<MlasQuantizeLinearTest<uint16_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasQuantizeLinear4BitTest<false>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasQuantizeLinear4BitTest<true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasDynamicQuantizeLinearPerRowTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasDynamicQuantizeLinearPerRowTest<true>>::RegisterShortExecute();
+    }
   }
   return count;
 });
@@ -9,12 +9,14 @@ class MlasScaleOutputTest : public MlasTestBase {
   MatrixGuardBuffer<float> BufferOutput;
   MatrixGuardBuffer<float> BufferOutputRef;
   MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferRowScale;
 
-  void Test(size_t M, size_t N, bool PerColumn, bool AccumulateMode) {
+  void Test(size_t M, size_t N, bool PerColumn, bool AccumulateMode, bool HasRowScale = false) {
     int32_t* Input = BufferInput.GetBuffer(M * N);
     float* Output = BufferOutput.GetBuffer(M * N);
     float* OutputRef = BufferOutputRef.GetBuffer(M * N);
     float* Scale = BufferScale.GetBuffer(PerColumn ? N : 1);
+    float* RowScale = HasRowScale ? BufferRowScale.GetBuffer(M) : nullptr;
 
     std::default_random_engine generator(static_cast<unsigned>(M * N));
     std::uniform_real_distribution<float> real_distribution(-1.0f, 1.0f);
@@ -30,10 +32,19 @@ class MlasScaleOutputTest : public MlasTestBase {
       Scale[s] = real_distribution(generator);
     }
 
+    if (RowScale != nullptr) {
+      for (size_t s = 0; s < M; s++) {
+        RowScale[s] = real_distribution(generator);
+      }
+    }
+
     // Compute Reference Value
     for (size_t m = 0; m < M; m++) {
       for (size_t n = 0; n < N; n++) {
         float current_scale = PerColumn ? Scale[n] : Scale[0];
+        if (RowScale != nullptr) {
+          current_scale *= RowScale[m];
+        }
         if (AccumulateMode) {
           OutputRef[m * N + n] += Input[m * N + n] * current_scale;
         } else {
@@ -46,8 +57,13 @@ class MlasScaleOutputTest : public MlasTestBase {
     MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR OutputProcessor(
         Output, N, Scale, nullptr,
         AccumulateMode ? MLAS_QGEMM_OUTPUT_MODE::AccumulateMode : MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
-        PerColumn ? MLAS_QUANTIZATION_GRANULARITY::PerColumn : MLAS_QUANTIZATION_GRANULARITY::PerMatrix);
-    OutputProcessor.Process(Input, 0, 0, M, N, N);
+        PerColumn ? MLAS_QUANTIZATION_GRANULARITY::PerColumn : MLAS_QUANTIZATION_GRANULARITY::PerMatrix,
+        RowScale);
+
+    // Process the rows in two blocks to check the row offsets.
+    const size_t CountM = M / 2;
+    OutputProcessor.Process(Input, 0, 0, CountM, N, N);
+    OutputProcessor.Process(Input, CountM, 0, M - CountM, N, N);
 
     constexpr float epsilon = 1e-6f;
 
@@ -72,6 +88,8 @@ class MlasScaleOutputTest : public MlasTestBase {
         Test(m, n, true, false);
         Test(m, n, false, true);
         Test(m, n, false, false);
+        Test(m, n, true, false, true);
+        Test(m, n, false, true, true);
       }
     }
   }
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasBlockSparseSgemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<uint8_t> BufferPackedB;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void ReferenceSgemm(CBLAS_TRANSPOSE TransB,
+                             size_t M,
+                             size_t N,
+                             size_t K,
+                             float alpha,
+                             const float* A,
+                             const float* B,
+                             size_t ldb,
+                             float beta,
+                             float* C) {
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          const float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+          sum += double(A[m * K + k]) * double(b);
+        }
+        C[m * N + n] = float(alpha * sum + (beta == 0.0f ? 0.0 : beta * C[m * N + n]));
+      }
+    }
+  }
+
+  // ZeroBlockPercent of the blocks of B are zero, the others are dense.
+  void Test(CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K, size_t ZeroBlockPercent, float alpha, float beta) {
+    float* A = BufferA.GetBuffer(M * K + 1);
+    float* B = BufferB.GetBuffer(N * K + 1);
+    float* C = BufferC.GetBuffer(M * N + 1);
+    float* CReference = BufferCReference.GetBuffer(M * N + 1);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * 7 + N * 3 + K + ZeroBlockPercent));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::uniform_int_distribution<size_t> percent(0, 99);
+
+    for (size_t i = 0; i < M * K; i++) {
+      A[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < M * N; i++) {
+      C[i] = distribution(generator);
+      CReference[i] = C[i];
+    }
+
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+    for (size_t k0 = 0; k0 < K; k0 += MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K) {
+      for (size_t n0 = 0; n0 < N; n0 += MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N) {
+        const bool zero = percent(generator) < ZeroBlockPercent;
+        for (size_t k = k0; k < std::min(K, k0 + MLAS_BLOCK_SPARSE_SGEMM_BLOCK_K); k++) {
+          for (size_t n = n0; n < std::min(N, n0 + MLAS_BLOCK_SPARSE_SGEMM_BLOCK_N); n++) {
+            float& b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+            b = zero ? 0.0f : distribution(generator);
+          }
+        }
+      }
+    }
+
+    ReferenceSgemm(TransB, M, N, K, alpha, A, B, ldb, beta, CReference);
+
+    const size_t PackedBSize = MlasBlockSparseGemmPackBSize(TransB, N, K, B, ldb, 0.0f);
+    ASSERT_GT(PackedBSize, size_t(0)) << "M=" << M << " N=" << N << " K=" << K;
+    void* PackedB = BufferPackedB.GetBuffer(PackedBSize, true);
+    MlasBlockSparseGemmPackB(TransB, N, K, B, ldb, PackedB);
+
+    MlasBlockSparseGemm(M, A, K, PackedB, C, N, alpha, beta, threadpool_);
+
+    const float Tolerance = 1e-5f * float(K + 1);
+    for (size_t i = 0; i < M * N; i++) {
+      ASSERT_LE(std::fabs(C[i] - CReference[i]), Tolerance)
+          << "mismatch at " << i << ", got: " << C[i] << ", expecting: " << CReference[i]
+          << " M=" << M << " N=" << N << " K=" << K << " zero blocks=" << ZeroBlockPercent << "%";
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "BlockSparseSgemm_Threaded" : "BlockSparseSgemm_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasBlockSparseSgemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (size_t ZeroBlockPercent : {0, 50, 80, 100}) {
+      Test(CblasNoTrans, 1, 16, 4, ZeroBlockPercent, 1.0f, 0.0f);
+      Test(CblasNoTrans, 33, 64, 128, ZeroBlockPercent, 1.0f, 0.0f);
+      Test(CblasTrans, 33, 64, 128, ZeroBlockPercent, 1.0f, 0.0f);
+      // N and K that aren't multiples of the block size
+      Test(CblasNoTrans, 7, 50, 37, ZeroBlockPercent, 0.5f, 1.0f);
+      Test(CblasTrans, 128, 129, 65, ZeroBlockPercent, 1.0f, -1.0f);
+    }
+
+    // the size is 0 if B isn't sparse enough
+    std::vector<float> Dense(64 * 64, 1.0f);
+    ASSERT_EQ(MlasBlockSparseGemmPackBSize(CblasNoTrans, 64, 64, Dense.data(), 64, 0.5f), size_t(0));
+    std::fill(Dense.begin(), Dense.begin() + 64 * 32, 0.0f);
+    ASSERT_GT(MlasBlockSparseGemmPackBSize(CblasNoTrans, 64, 64, Dense.data(), 64, 0.5f), size_t(0));
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasBlockSparseSgemmTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasBlockSparseSgemmTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Threaded>
+class MlasSgemmGroupedTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void ReferenceSgemm(CBLAS_TRANSPOSE TransA,
+                             CBLAS_TRANSPOSE TransB,
+                             size_t M,
+                             size_t N,
+                             size_t K,
+                             float alpha,
+                             const float* A,
+                             size_t lda,
+                             const float* B,
+                             size_t ldb,
+                             float beta,
+                             float* C,
+                             size_t ldc) {
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double sum = 0.0;
+        for (size_t k = 0; k < K; k++) {
+          const float a = (TransA == CblasNoTrans) ? A[m * lda + k] : A[k * lda + m];
+          const float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+          sum += double(a) * double(b);
+        }
+        C[m * ldc + n] = float(alpha * sum + beta * C[m * ldc + n]);
+      }
+    }
+  }
+
+  void Test(CBLAS_TRANSPOSE TransA,
+            CBLAS_TRANSPOSE TransB,
+            const std::vector<MLAS_SGEMM_GROUP_SHAPE>& Shapes,
+            float alpha,
+            float beta) {
+    const size_t GroupCount = Shapes.size();
+
+    std::vector<size_t> OffsetA(GroupCount + 1, 0);
+    std::vector<size_t> OffsetB(GroupCount + 1, 0);
+    std::vector<size_t> OffsetC(GroupCount + 1, 0);
+
+    for (size_t g = 0; g < GroupCount; g++) {
+      OffsetA[g + 1] = OffsetA[g] + Shapes[g].M * Shapes[g].K;
+      OffsetB[g + 1] = OffsetB[g] + Shapes[g].K * Shapes[g].N;
+      OffsetC[g + 1] = OffsetC[g] + Shapes[g].M * Shapes[g].N;
+    }
+
+    float* A = BufferA.GetBuffer(OffsetA[GroupCount] + 1);
+    float* B = BufferB.GetBuffer(OffsetB[GroupCount] + 1);
+    float* C = BufferC.GetBuffer(OffsetC[GroupCount] + 1);
+    float* CReference = BufferCReference.GetBuffer(OffsetC[GroupCount] + 1);
+
+    std::default_random_engine generator(static_cast<unsigned>(GroupCount + OffsetC[GroupCount]));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    auto fill = [&](float* Buffer, size_t Count) {
+      for (size_t i = 0; i < Count; i++) {
+        Buffer[i] = distribution(generator);
+      }
+    };
+
+    fill(A, OffsetA[GroupCount]);
+    fill(B, OffsetB[GroupCount]);
+    fill(C, OffsetC[GroupCount]);
+    std::copy_n(C, OffsetC[GroupCount], CReference);
+
+    std::vector<MLAS_SGEMM_DATA_PARAMS> Data(GroupCount);
+
+    for (size_t g = 0; g < GroupCount; g++) {
+      const size_t M = Shapes[g].M;
+      const size_t N = Shapes[g].N;
+      const size_t K = Shapes[g].K;
+
+      Data[g].A = A + OffsetA[g];
+      Data[g].lda = (TransA == CblasNoTrans) ? K : M;
+      Data[g].B = B + OffsetB[g];
+      Data[g].ldb = (TransB == CblasNoTrans) ? N : K;
+      Data[g].C = C + OffsetC[g];
+      Data[g].ldc = N;
+      Data[g].alpha = alpha;
+      Data[g].beta = beta;
+
+      ReferenceSgemm(TransA, TransB, M, N, K, alpha, Data[g].A, Data[g].lda, Data[g].B, Data[g].ldb, beta,
+                     CReference + OffsetC[g], N);
+    }
+
+    MlasGemmGrouped(TransA, TransB, Shapes.data(), Data.data(), GroupCount, threadpool_);
+
+    for (size_t g = 0; g < GroupCount; g++) {
+      const float Tolerance = 1e-5f * float(Shapes[g].K + 1);
+      for (size_t i = OffsetC[g]; i < OffsetC[g + 1]; i++) {
+        ASSERT_LE(std::fabs(C[i] - CReference[i]), Tolerance)
+            << "mismatch in problem " << g << " at " << (i - OffsetC[g])
+            << ", got: " << C[i] << ", expecting: " << CReference[i]
+            << " M=" << Shapes[g].M << " N=" << Shapes[g].N << " K=" << Shapes[g].K;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "SgemmGrouped_Threaded" : "SgemmGrouped_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSgemmGroupedTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    // Expert FFN shapes: a ragged number of tokens routed to each expert.
+    const std::vector<MLAS_SGEMM_GROUP_SHAPE> Experts = {
+        {37, 96, 64}, {0, 96, 64}, {1, 96, 64}, {200, 96, 64}, {5, 96, 64}, {64, 96, 64}, {0, 96, 64}};
+
+    Test(CblasNoTrans, CblasNoTrans, Experts, 1.0f, 0.0f);
+    Test(CblasNoTrans, CblasTrans, Experts, 1.0f, 0.0f);
+    Test(CblasTrans, CblasNoTrans, Experts, 0.5f, 1.0f);
+
+    // Variable length attention: per sequence shapes in all dimensions.
+    const std::vector<MLAS_SGEMM_GROUP_SHAPE> Sequences = {
+        {17, 17, 32}, {128, 128, 32}, {3, 3, 32}, {65, 65, 32}, {1, 300, 7}, {300, 1, 7}};
+
+    Test(CblasNoTrans, CblasTrans, Sequences, 0.125f, 0.0f);
+    Test(CblasTrans, CblasTrans, Sequences, 1.0f, -1.0f);
+
+    // One large problem among small ones must still be split across threads.
+    const std::vector<MLAS_SGEMM_GROUP_SHAPE> Skewed = {{2, 16, 16}, {512, 257, 129}, {2, 16, 16}, {0, 0, 0}};
+
+    Test(CblasNoTrans, CblasNoTrans, Skewed, 1.0f, 0.0f);
+    Test(CblasNoTrans, CblasNoTrans, {}, 1.0f, 0.0f);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmGroupedTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmGroupedTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -107,10 +107,167 @@ class MlasSoftmaxTest : public MlasTestBase {
   }
 };
 
+class MlasLogSumExpTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  void Test(size_t N, size_t D, float MinimumValue, float MaximumValue) {
+    float* Input = BufferInput.GetBuffer(N * D);
+    float* Output = BufferOutput.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N * D));
+    std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+    for (size_t nd = 0; nd < N * D; nd++) {
+      Input[nd] = distribution(generator);
+    }
+
+    Test(Input, Output, N, D);
+
+    // Rows holding infinities take the slow path.
+    Input[0] = -std::numeric_limits<float>::infinity();
+    Input[N * D - 1] = std::numeric_limits<float>::infinity();
+
+    Test(Input, Output, N, D);
+  }
+
+  void Test(const float* Input, float* Output, size_t N, size_t D) {
+    MlasComputeLogSumExp(Input, Output, N, D);
+
+    constexpr float AbsoluteTolerance = 1e-6f;
+    constexpr float RelativeTolerance = 1e-6f;
+
+    for (size_t n = 0; n < N; n++) {
+      const float* Row = Input + n * D;
+
+      double Maximum = 0.0;
+      bool HasFinite = false;
+      for (size_t d = 0; d < D; d++) {
+        if (std::isfinite(Row[d]) && (!HasFinite || Row[d] > Maximum)) {
+          Maximum = Row[d];
+          HasFinite = true;
+        }
+      }
+
+      double Sum = 0.0;
+      for (size_t d = 0; d < D; d++) {
+        Sum += std::exp(double(Row[d]) - Maximum);
+      }
+
+      float Reference = float(std::log(Sum) + Maximum);
+
+      if (std::isinf(Reference)) {
+        ASSERT_EQ(Output[n], Reference) << ", row=" << n << ", D=" << D;
+      } else {
+        float diff = std::fabs(Output[n] - Reference);
+        ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(Reference) * RelativeTolerance)
+            << ", row=" << n << ", D=" << D << ", got: " << Output[n] << ", expecting: " << Reference;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("LogSumExp");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t d = 1; d < 128; d++) {
+      Test(1, d, -10.f, 10.f);
+    }
+
+    Test(3, 128, 20.f, 30.f);
+    Test(63, 95, -150.f, 190.f);
+    Test(16, 211, 20.f, 30.f);
+  }
+};
+
+class MlasAttentionSoftmaxTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferScores;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferReference;
+
+  void Test(size_t N, size_t D, float Scale, bool UseBias, ptrdiff_t CausalOffset) {
+    // The rows of the scores are padded to check that only D columns are written.
+    const size_t Ld = D + 3;
+    float* Scores = BufferScores.GetBuffer(N * Ld);
+    float* Bias = BufferBias.GetBuffer(N * D);
+    float* Reference = BufferReference.GetBuffer(N * Ld);
+
+    std::default_random_engine generator(static_cast<unsigned>(N * D));
+    std::uniform_real_distribution<float> distribution(-10.f, 10.f);
+
+    for (size_t i = 0; i < N * Ld; i++) {
+      Scores[i] = distribution(generator);
+      Reference[i] = Scores[i];
+    }
+    for (size_t i = 0; i < N * D; i++) {
+      Bias[i] = distribution(generator);
+    }
+
+    for (size_t n = 0; n < N; n++) {
+      float* Row = Reference + n * Ld;
+      size_t Length = CausalOffset >= 0 ? std::min(D, size_t(CausalOffset) + n + 1) : D;
+
+      double Maximum = -std::numeric_limits<double>::infinity();
+      for (size_t d = 0; d < Length; d++) {
+        Row[d] = Row[d] * Scale + (UseBias ? Bias[n * D + d] : 0.0f);
+        Maximum = std::max(Maximum, double(Row[d]));
+      }
+
+      double Sum = 0.0;
+      for (size_t d = 0; d < Length; d++) {
+        Sum += std::exp(double(Row[d]) - Maximum);
+      }
+
+      for (size_t d = 0; d < D; d++) {
+        Row[d] = d < Length ? float(std::exp(double(Row[d]) - Maximum) / Sum) : 0.0f;
+      }
+    }
+
+    MlasComputeAttentionSoftmax(Scores, Ld, UseBias ? Bias : nullptr, D, N, D, Scale, CausalOffset, GetMlasThreadPool());
+
+    constexpr float AbsoluteTolerance = 1e-6f;
+    // The scale and bias may be fused into one rounding.
+    constexpr float RelativeTolerance = 1e-5f;
+
+    for (size_t i = 0; i < N * Ld; i++) {
+      float diff = std::fabs(Scores[i] - Reference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(Reference[i]) * RelativeTolerance)
+          << " @" << i << " of N=" << N << ", D=" << D << ", CausalOffset=" << CausalOffset
+          << ", got: " << Scores[i] << ", expecting: " << Reference[i];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("AttentionSoftmax");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t d = 1; d < 40; d++) {
+      Test(3, d, 1.0f, false, -1);
+      Test(3, d, 0.125f, true, -1);
+      Test(d, d, 0.125f, true, 0);
+      Test(5, d + 4, 0.5f, false, 4);
+    }
+
+    Test(63, 95, 0.125f, true, 32);
+    Test(128, 128, 0.088f, true, 0);
+    Test(16, 211, 1.0f, true, -1);
+  }
+};
+
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
   size_t count = 0;
   if (is_short_execute) {
     count += MlasDirectShortExecuteTests<MlasSoftmaxTest<false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasLogSumExpTest>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasAttentionSoftmaxTest>::RegisterShortExecute();
     if (GetMlasThreadPool() != nullptr) {
       count += MlasDirectShortExecuteTests<MlasSoftmaxTest<true>>::RegisterShortExecute();
     }
@@ -42,6 +42,7 @@ class MlasSQNBitGemmTest : public MlasTestBase {
   MatrixGuardBuffer<float> BufferB;
   MatrixGuardBuffer<uint8_t> BufferQuantBData;
   MatrixGuardBuffer<std::byte> BufferPackedQuantBData;
+  MatrixGuardBuffer<std::byte> BufferCopiedPackedQuantBData;
   MatrixGuardBuffer<uint8_t> BufferQuantBZeroPoint;
   MatrixGuardBuffer<float> BufferQuantBScale;
   MatrixGuardBuffer<float> BufferDequantizedB;
@@ -278,6 +279,14 @@ class MlasSQNBitGemmTest : public MlasTestBase {
       MlasQNBitGemmPackQuantBData(N, K, BlkBitWidth, BlkLen, ComputeType, QuantBData, PackedQuantBDataWorkspace,
                                   QuantBScale, has_zp_input, QuantBZeroPoint,
                                   GetMlasThreadPool());
+
+      // Run with a copy of the packed data, like MatMulNBits does with a thread pool partitioned by NUMA node.
+      if (WithThreadpool) {
+        void* CopiedPackedQuantBDataWorkspace = BufferCopiedPackedQuantBData.GetBuffer(PackedQuantBDataSize, true);
+        MlasQNBitGemmCopyPackedQuantBData(N, K, BlkBitWidth, BlkLen, ComputeType, PackedQuantBDataWorkspace,
+                                          CopiedPackedQuantBDataWorkspace, Threadpool);
+        PackedQuantBDataWorkspace = CopiedPackedQuantBDataWorkspace;
+      }
     }
 
     CallGemm(M, N, K,
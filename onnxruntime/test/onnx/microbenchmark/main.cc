@@ -18,9 +18,13 @@
 #include <core/session/ort_env.h>
 #include <core/util/thread_utils.h>
 
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <unordered_map>
 
+#include "model_ops.h"
+
 const OrtApi* g_ort = OrtGetApiBase()->GetApi(ORT_API_VERSION);
 OrtEnv* env = nullptr;
 
@@ -76,10 +80,31 @@ BENCHMARK(BM_ResolveGraph);
 
 int main(int argc, char** argv) {
   ::benchmark::Initialize(&argc, argv);
+
+  // --model_ops=<model.onnx> benchmarks every unique node of the model in isolation, see model_ops.h
+  constexpr const char* kModelOpsFlag = "--model_ops=";
+  std::string model_ops_path;
+  int num_args = 0;
+  for (int i = 0; i < argc; ++i) {
+    if (i > 0 && strncmp(argv[i], kModelOpsFlag, strlen(kModelOpsFlag)) == 0) {
+      model_ops_path = argv[i] + strlen(kModelOpsFlag);
+    } else {
+      argv[num_args++] = argv[i];
+    }
+  }
+  argc = num_args;
+
   if (::benchmark::ReportUnrecognizedArguments(argc, argv))
     return -1;
   ORT_ABORT_ON_ERROR(g_ort->CreateEnv(ORT_LOGGING_LEVEL_ERROR, "test", &env));
-  ::benchmark::RunSpecifiedBenchmarks();
+  if (model_ops_path.empty()) {
+    ::benchmark::RunSpecifiedBenchmarks();
+  } else {
+    RegisterModelOpBenchmarks(model_ops_path);
+    // only the model's ops run in this mode
+    ModelOpsReporter reporter;
+    ::benchmark::RunSpecifiedBenchmarks(&reporter, "BM_ModelOp/");
+  }
   g_ort->ReleaseEnv(env);
   return 0;
 }
@@ -0,0 +1,419 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "model_ops.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+#include <core/common/logging/logging.h>
+#include <core/framework/data_types.h>
+#include <core/graph/constants.h>
+#include <core/graph/model.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/platform/path_lib.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include <core/session/onnxruntime_session_options_config_keys.h>
+#include <core/session/ort_env.h>
+
+extern OrtEnv* env;
+
+namespace {
+
+// A unique (op, input types and shapes, attributes) of the model, saved as a model with just that node.
+struct ModelOp {
+  std::string op_type;
+  std::string signature;  // input types and shapes, e.g. "float[1,64,56,56] float[64,64,3,3] float[64]"
+  size_t count{0};        // number of nodes of the model with this signature
+  std::string model_bytes;
+  std::vector<std::string> input_names;
+  std::vector<ONNXTensorElementDataType> input_types;
+  std::vector<std::vector<int64_t>> input_shapes;
+  std::vector<std::string> output_names;
+};
+
+struct BenchmarkInfo {
+  size_t op_index;
+  std::string provider;
+};
+
+std::vector<ModelOp> model_ops;
+std::vector<std::string> providers;
+// registered benchmark name to the op and execution provider it runs
+std::map<std::string, BenchmarkInfo> benchmarks;
+// benchmarks that could not run, e.g. because the execution provider does not support the node
+std::map<std::string, std::string> failed_benchmarks;
+// microseconds per call of every benchmark that ran
+std::map<std::string, double> benchmark_times;
+
+void AppendExecutionProvider(Ort::SessionOptions& session_options, const std::string& provider) {
+  if (provider == onnxruntime::kCpuExecutionProvider) {
+    return;
+  }
+
+  // the node must not silently fall back to the CPU EP, or the CPU EP would be measured instead
+  session_options.AddConfigEntry(kOrtSessionOptionsDisableCPUEPFallback, "1");
+
+  if (provider == onnxruntime::kCudaExecutionProvider) {
+    OrtCUDAProviderOptions cuda_options{};
+    session_options.AppendExecutionProvider_CUDA(cuda_options);
+    return;
+  }
+
+  // providers that can be added by name with their default options
+  static const std::unordered_map<std::string, std::string> provider_names = {
+      {onnxruntime::kDmlExecutionProvider, "DML"},
+      {onnxruntime::kQnnExecutionProvider, "QNN"},
+      {onnxruntime::kOpenVINOExecutionProvider, "OpenVINO"},
+      {onnxruntime::kSnpeExecutionProvider, "SNPE"},
+      {onnxruntime::kXnnpackExecutionProvider, "XNNPACK"},
+      {onnxruntime::kWebGpuExecutionProvider, "WebGPU"},
+      {onnxruntime::kCoreMLExecutionProvider, "CoreML"},
+  };
+  auto it = provider_names.find(provider);
+  if (it == provider_names.end()) {
+    ORT_CXX_API_THROW("Benchmarking " + provider + " is not supported", ORT_NOT_IMPLEMENTED);
+  }
+  session_options.AppendExecutionProvider(it->second, {});
+}
+
+// The session of the benchmark that ran last. Google benchmark calls a benchmark function several times to find the
+// number of iterations, and runs the benchmarks one after the other, so this avoids creating the session every time.
+struct CachedSession {
+  std::string benchmark_name;
+  Ort::Session session{nullptr};
+  std::vector<Ort::Value> inputs;
+};
+
+void CreateSession(const std::string& name, const ModelOp& op, const std::string& provider, CachedSession& cached) {
+  cached.session = Ort::Session{nullptr};
+  cached.inputs.clear();
+  cached.benchmark_name.clear();
+
+  Ort::SessionOptions session_options;
+  session_options.SetGraphOptimizationLevel(ORT_DISABLE_ALL);
+  AppendExecutionProvider(session_options, provider);
+
+  // main owns the environment. the wrapper is never destroyed so that it does not release it.
+  static Ort::Env* ort_env = new Ort::Env(env);
+  cached.session = Ort::Session(*ort_env, op.model_bytes.data(), op.model_bytes.size(), session_options);
+
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  Ort::AllocatorWithDefaultOptions allocator;
+  for (size_t i = 0; i < op.input_names.size(); ++i) {
+    const auto& shape = op.input_shapes[i];
+    auto value = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), op.input_types[i]);
+    const size_t num_elements = value.GetTensorTypeAndShapeInfo().GetElementCount();
+    // integer inputs are usually indices or sizes, for which zero is always valid
+    if (op.input_types[i] == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) {
+      float* data = value.GetTensorMutableData<float>();
+      std::generate(data, data + num_elements, [&]() { return distribution(generator); });
+    } else {
+      const size_t element_size = onnxruntime::DataTypeImpl::TensorTypeFromONNXEnum(op.input_types[i])
+                                      ->GetElementType()
+                                      ->Size();
+      std::memset(value.GetTensorMutableRawData(), 0, num_elements * element_size);
+    }
+    cached.inputs.push_back(std::move(value));
+  }
+
+  cached.benchmark_name = name;
+}
+
+void BM_ModelOp(benchmark::State& state, const std::string& name) {
+  static CachedSession cached;
+  const BenchmarkInfo& info = benchmarks.at(name);
+  const ModelOp& op = model_ops[info.op_index];
+
+  if (cached.benchmark_name != name) {
+    try {
+      CreateSession(name, op, info.provider, cached);
+    } catch (const std::exception& ex) {
+      failed_benchmarks[name] = ex.what();
+      state.SkipWithError(ex.what());
+      return;
+    }
+  }
+
+  std::vector<const char*> input_names;
+  for (const auto& input_name : op.input_names) {
+    input_names.push_back(input_name.c_str());
+  }
+  std::vector<const char*> output_names;
+  for (const auto& output_name : op.output_names) {
+    output_names.push_back(output_name.c_str());
+  }
+
+  Ort::RunOptions run_options;
+  for (auto _ : state) {
+    try {
+      auto outputs = cached.session.Run(run_options, input_names.data(), cached.inputs.data(), input_names.size(),
+                                        output_names.data(), output_names.size());
+      benchmark::DoNotOptimize(outputs);
+    } catch (const std::exception& ex) {
+      failed_benchmarks[name] = ex.what();
+      state.SkipWithError(ex.what());
+      break;
+    }
+  }
+}
+
+std::string TypeName(int32_t elem_type) {
+  return ONNX_NAMESPACE::TensorProto_DataType_Name(static_cast<ONNX_NAMESPACE::TensorProto_DataType>(elem_type));
+}
+
+// Adds the node to model_ops, or increments the count of the op with the same signature. Returns false if the node
+// cannot be benchmarked in isolation.
+bool AddModelOp(const onnxruntime::Model& model, const onnxruntime::Graph& graph, const onnxruntime::Node& node,
+                std::unordered_map<std::string, size_t>& op_indices) {
+  if (node.ContainsSubgraph()) {
+    return false;
+  }
+
+  ModelOp op;
+  op.op_type = node.OpType();
+
+  std::ostringstream key;
+  std::ostringstream signature;
+  key << node.Domain() << ":" << node.OpType() << ":" << node.SinceVersion();
+
+  ONNX_NAMESPACE::ModelProto model_proto;
+  model_proto.set_ir_version(model.IrVersion());
+  for (const auto& domain_version : graph.DomainToVersionMap()) {
+    auto* opset = model_proto.add_opset_import();
+    opset->set_domain(domain_version.first);
+    opset->set_version(domain_version.second);
+  }
+
+  auto* graph_proto = model_proto.mutable_graph();
+  graph_proto->set_name(node.OpType());
+  node.ToProto(*graph_proto->add_node());
+
+  std::set<std::string> added_inputs;
+  for (const auto* input : node.InputDefs()) {
+    key << "|";
+    if (!input->Exists()) {
+      continue;
+    }
+
+    const auto* type = input->TypeAsProto();
+    const auto* shape = input->Shape();
+    if (type == nullptr || !type->has_tensor_type() || shape == nullptr ||
+        type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+      return false;
+    }
+
+    std::vector<int64_t> dims;
+    for (const auto& dim : shape->dim()) {
+      if (!dim.has_dim_value()) {
+        return false;
+      }
+      dims.push_back(dim.dim_value());
+    }
+
+    const int32_t elem_type = type->tensor_type().elem_type();
+    std::ostringstream input_signature;
+    input_signature << TypeName(elem_type) << "[";
+    for (size_t i = 0; i < dims.size(); ++i) {
+      input_signature << (i > 0 ? "," : "") << dims[i];
+    }
+    input_signature << "]";
+    key << input_signature.str();
+
+    const auto* initializer = graph.GetConstantInitializer(input->Name(), true);
+    if (initializer != nullptr) {
+      // the values of small constants (axes, shapes, ...) can change what the kernel does, those of weights do not
+      constexpr int64_t kMaxKeyedElements = 64;
+      int64_t num_elements = 1;
+      for (int64_t dim : dims) {
+        num_elements *= dim;
+      }
+      ONNX_NAMESPACE::TensorProto unnamed = *initializer;
+      unnamed.clear_name();
+      key << "=" << (num_elements <= kMaxKeyedElements ? unnamed.SerializeAsString() : std::string("const"));
+      input_signature << "(const)";
+    }
+    signature << (signature.tellp() > 0 ? " " : "") << input_signature.str();
+
+    if (!added_inputs.insert(input->Name()).second) {
+      continue;
+    }
+
+    if (initializer != nullptr) {
+      *graph_proto->add_initializer() = *initializer;
+    } else {
+      auto* graph_input = graph_proto->add_input();
+      graph_input->set_name(input->Name());
+      *graph_input->mutable_type() = *type;
+      op.input_names.push_back(input->Name());
+      op.input_types.push_back(static_cast<ONNXTensorElementDataType>(elem_type));
+      op.input_shapes.push_back(std::move(dims));
+    }
+  }
+
+  // order the attributes so the key does not depend on how they were stored
+  std::map<std::string, std::string> attributes;
+  for (const auto& attribute : node.GetAttributes()) {
+    attributes[attribute.first] = attribute.second.SerializeAsString();
+  }
+  for (const auto& attribute : attributes) {
+    key << "|" << attribute.first << "=" << attribute.second;
+  }
+
+  auto it = op_indices.find(key.str());
+  if (it != op_indices.end()) {
+    ++model_ops[it->second].count;
+    return true;
+  }
+
+  for (const auto* output : node.OutputDefs()) {
+    if (!output->Exists()) {
+      continue;
+    }
+    if (output->TypeAsProto() == nullptr) {
+      return false;
+    }
+    auto* graph_output = graph_proto->add_output();
+    graph_output->set_name(output->Name());
+    *graph_output->mutable_type() = *output->TypeAsProto();
+    op.output_names.push_back(output->Name());
+  }
+
+  op.signature = signature.str();
+  op.count = 1;
+  model_proto.SerializeToString(&op.model_bytes);
+  op_indices[key.str()] = model_ops.size();
+  model_ops.push_back(std::move(op));
+  return true;
+}
+
+}  // namespace
+
+void RegisterModelOpBenchmarks(const std::string& model_path) {
+  auto logger = env->GetLoggingManager()->CreateLogger("model_ops");
+  std::shared_ptr<onnxruntime::Model> model;
+  auto status = onnxruntime::Model::Load(onnxruntime::ToPathString(model_path), model, nullptr, *logger);
+  if (!status.IsOK()) {
+    std::cerr << "Failed to load " << model_path << ": " << status.ErrorMessage() << std::endl;
+    abort();
+  }
+
+  const auto& graph = model->MainGraph();
+  std::unordered_map<std::string, size_t> op_indices;
+  size_t skipped = 0;
+  for (const auto& node : graph.Nodes()) {
+    if (!AddModelOp(*model, graph, node, op_indices)) {
+      ++skipped;
+    }
+  }
+  std::cout << model_path << ": " << graph.NumberOfNodes() << " nodes, " << model_ops.size()
+            << " unique ops, " << skipped << " nodes skipped" << std::endl;
+
+  providers = Ort::GetAvailableProviders();
+  // run the CPU EP first, it is the baseline of every op
+  std::stable_partition(providers.begin(), providers.end(),
+                        [](const std::string& provider) { return provider == onnxruntime::kCpuExecutionProvider; });
+
+  for (size_t i = 0; i < model_ops.size(); ++i) {
+    for (const auto& provider : providers) {
+      std::string name = "BM_ModelOp/" + std::to_string(i) + ":" + model_ops[i].op_type + "/" + provider;
+      benchmarks[name] = BenchmarkInfo{i, provider};
+      benchmark::RegisterBenchmark(name.c_str(), BM_ModelOp, name)->Unit(benchmark::kMicrosecond);
+    }
+  }
+}
+
+void ModelOpsReporter::ReportRuns(const std::vector<Run>& reports) {
+  ConsoleReporter::ReportRuns(reports);
+  for (const auto& run : reports) {
+    const std::string& name = run.run_name.function_name;
+    // with repetitions, the mean of them is reported as an aggregate
+    if (benchmarks.count(name) == 0 || failed_benchmarks.count(name) != 0 ||
+        (run.run_type == Run::RT_Aggregate && run.aggregate_name != "mean")) {
+      continue;
+    }
+    if (run.run_type == Run::RT_Aggregate || benchmark_times.count(name) == 0) {
+      benchmark_times[name] = run.GetAdjustedRealTime();
+    }
+  }
+}
+
+void ModelOpsReporter::Finalize() {
+  ConsoleReporter::Finalize();
+  if (model_ops.empty()) {
+    return;
+  }
+
+  struct Row {
+    size_t op_index;
+    double total_us;
+    std::string fastest;
+  };
+
+  std::vector<Row> rows;
+  double model_total_us = 0.0;
+  for (size_t i = 0; i < model_ops.size(); ++i) {
+    Row row{i, 0.0, "-"};
+    double fastest_us = 0.0;
+    double baseline_us = 0.0;
+    for (const auto& provider : providers) {
+      auto it = benchmark_times.find("BM_ModelOp/" + std::to_string(i) + ":" + model_ops[i].op_type + "/" + provider);
+      if (it == benchmark_times.end()) {
+        continue;
+      }
+      if (row.fastest == "-" || it->second < fastest_us) {
+        row.fastest = provider;
+        fastest_us = it->second;
+      }
+      if (provider == onnxruntime::kCpuExecutionProvider) {
+        baseline_us = it->second;
+      }
+    }
+    // rank the ops the CPU EP cannot run by their fastest time
+    row.total_us = (baseline_us > 0.0 ? baseline_us : fastest_us) * model_ops[i].count;
+    model_total_us += row.total_us;
+    rows.push_back(row);
+  }
+
+  std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.total_us > b.total_us; });
+
+  auto& os = GetOutputStream();
+  os << "\nModel ops ranked by total time (us per call on every execution provider, '-' if it could not run)\n";
+  os << std::left << std::setw(6) << "rank" << std::setw(24) << "op" << std::setw(8) << "nodes"
+     << std::setw(14) << "total us" << std::setw(9) << "share";
+  for (const auto& provider : providers) {
+    os << std::setw(std::max<int>(14, static_cast<int>(provider.size()) + 2)) << provider;
+  }
+  os << std::setw(28) << "fastest" << "inputs\n";
+
+  for (size_t rank = 0; rank < rows.size(); ++rank) {
+    const auto& row = rows[rank];
+    const auto& op = model_ops[row.op_index];
+    std::ostringstream share;
+    share << std::fixed << std::setprecision(1)
+          << (model_total_us > 0.0 ? 100.0 * row.total_us / model_total_us : 0.0) << "%";
+    os << std::left << std::setw(6) << rank + 1 << std::setw(24) << op.op_type << std::setw(8) << op.count
+       << std::setw(14) << std::fixed << std::setprecision(2) << row.total_us << std::setw(9) << share.str();
+    for (const auto& provider : providers) {
+      const int width = std::max<int>(14, static_cast<int>(provider.size()) + 2);
+      auto it = benchmark_times.find("BM_ModelOp/" + std::to_string(row.op_index) + ":" + op.op_type + "/" +
+                                     provider);
+      if (it == benchmark_times.end()) {
+        os << std::setw(width) << "-";
+      } else {
+        os << std::setw(width) << it->second;
+      }
+    }
+    os << std::setw(28) << row.fastest << op.signature << "\n";
+  }
+  os << std::flush;
+}
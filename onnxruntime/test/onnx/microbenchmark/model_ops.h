@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+// Registers a benchmark for every unique (op, input types and shapes, attributes) of the nodes in the model's main
+// graph, on every available execution provider. Each node is benchmarked in isolation, as a model that contains just
+// that node, with graph optimizations disabled so the node is not fused or folded away.
+// Nodes with subgraphs, string inputs or inputs without a static shape are skipped.
+void RegisterModelOpBenchmarks(const std::string& model_path);
+
+// Console reporter that also prints, once all benchmarks ran, the model's ops ranked by the time the model spends in
+// them on the CPU EP (time per call times the number of nodes with that signature), with the time on every other
+// execution provider and the fastest of them.
+class ModelOpsReporter : public benchmark::ConsoleReporter {
+ public:
+  void ReportRuns(const std::vector<Run>& reports) override;
+  void Finalize() override;
+};
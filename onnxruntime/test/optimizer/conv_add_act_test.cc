@@ -14,25 +14,39 @@ namespace test {
 #ifndef DISABLE_CONTRIB_OPS
 
 void TestConvPath(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape,
-                  const std::vector<int64_t>& output_shape, int64_t group) {
+                  const std::vector<int64_t>& output_shape, int64_t group,
+                  bool has_bias = true, const char* activation = nullptr) {
   auto build_test_case = [&](ModelTestBuilder& builder) {
     auto* input_arg = builder.MakeInput<float>(input_shape, -31, 31);
     auto* output_arg = builder.MakeOutput();
-    auto* bias_arg = builder.MakeInitializer<float>({weights_shape[0]}, -20.f, 20.f);
     auto* add_arg = builder.MakeInput<float>(output_shape, -20.f, 20.f);
     auto* weight_arg = builder.MakeInitializer<float>(weights_shape, -2.f, 2.f);
     auto* conv_out_arg = builder.MakeIntermediate();
 
-    auto& conv_node = builder.AddNode("Conv", {input_arg, weight_arg, bias_arg}, {conv_out_arg});
+    std::vector<NodeArg*> conv_inputs{input_arg, weight_arg};
+    if (has_bias) {
+      conv_inputs.push_back(builder.MakeInitializer<float>({weights_shape[0]}, -20.f, 20.f));
+    }
+    auto& conv_node = builder.AddNode("Conv", conv_inputs, {conv_out_arg});
     conv_node.AddAttribute("group", group);
-    builder.AddNode("Add", {conv_out_arg, add_arg}, {output_arg});
+    if (activation == nullptr) {
+      builder.AddNode("Add", {conv_out_arg, add_arg}, {output_arg});
+    } else {
+      auto* add_out_arg = builder.MakeIntermediate();
+      builder.AddNode("Add", {add_arg, conv_out_arg}, {add_out_arg});
+      builder.AddNode(activation, {add_out_arg}, {output_arg});
+    }
   };
 
   auto check_graph = [&](InferenceSessionWrapper& session) {
     auto op_to_count = CountOpsInGraph(session.GetGraph());
     EXPECT_EQ(op_to_count["com.microsoft.FusedConv"], 1);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    if (activation != nullptr) {
+      EXPECT_EQ(op_to_count[activation], 0);
+    }
   };
-  InlinedHashSet<std::string> disabled_optimizers = {"NchwcTransformer"};
+  InlinedHashSet<std::string> disabled_optimizers = {"NchwcTransformer", "NhwcTransformer"};
   TransformerTester(build_test_case,
                     check_graph,
                     TransformerLevel::Default,
@@ -57,6 +71,21 @@ TEST(ConvAddActivationFusionTests, ConvGemmDirect) {
   TestConvPath({1, 16, 5, 5}, {16, 1, 5, 5}, {1, 16, 1, 1}, 16);
 }
 
+TEST(ConvAddActivationFusionTests, ConvNoBias) {
+  TestConvPath({1, 16, 5, 5}, {16, 16, 3, 3}, {1, 16, 3, 3}, 1, false);
+  TestConvPath({1, 16, 5, 5}, {16, 1, 3, 3}, {1, 16, 3, 3}, 16, false, "Relu");
+}
+
+TEST(ConvAddActivationFusionTests, Conv1DAnd3D) {
+  TestConvPath({1, 8, 17}, {16, 8, 3}, {1, 16, 15}, 1, true, "Relu");
+  TestConvPath({1, 4, 5, 6, 7}, {8, 4, 3, 3, 3}, {1, 8, 3, 4, 5}, 1, false, "Sigmoid");
+}
+
+TEST(ConvAddActivationFusionTests, ConvAddActivation) {
+  TestConvPath({1, 16, 5, 5}, {16, 16, 1, 1}, {1, 16, 5, 5}, 1, true, "Relu");
+  TestConvPath({1, 16, 5, 5}, {16, 16, 3, 3}, {1, 16, 3, 3}, 1, true, "Tanh");
+}
+
 #endif  // DISABLE_CONTRIB_OPS
 
 }  // namespace test
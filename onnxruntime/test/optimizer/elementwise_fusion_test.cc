@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "graph_transform_test_builder.h"
+
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+namespace test {
+
+#ifndef DISABLE_CONTRIB_OPS
+
+TEST(ElementwiseFusionTests, BroadcastChain) {
+  // Sigmoid(x + bias) * gate * scale, with bias broadcast along the rows and gate along the middle axis.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 3, 64}, -4.f, 4.f);
+    auto* gate_arg = builder.MakeInput<float>({2, 1, 64}, -2.f, 2.f);
+    auto* bias_arg = builder.MakeInitializer<float>({64}, -1.f, 1.f);
+    auto* scale_arg = builder.MakeScalarInitializer<float>(0.5f);
+    auto* add_out = builder.MakeIntermediate();
+    auto* sigmoid_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {input_arg, bias_arg}, {add_out});
+    builder.AddNode("Sigmoid", {add_out}, {sigmoid_out});
+    builder.AddNode("Mul", {sigmoid_out, gate_arg}, {mul_out});
+    builder.AddNode("Mul", {mul_out, scale_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Sigmoid"], 0);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level2, TransformerLevel::Level3, 13,
+                    1e-5, 1e-5);
+}
+
+TEST(ElementwiseFusionTests, SharedIntermediate) {
+  // (x - y) * Tanh(x - y): the Sub output feeds two nodes of the chain.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* x_arg = builder.MakeInput<float>({4, 33}, -3.f, 3.f);
+    auto* y_arg = builder.MakeInput<float>({4, 33}, -3.f, 3.f);
+    auto* sub_out = builder.MakeIntermediate();
+    auto* tanh_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Sub", {x_arg, y_arg}, {sub_out});
+    builder.AddNode("Tanh", {sub_out}, {tanh_out});
+    builder.AddNode("Mul", {sub_out, tanh_out}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Sub"], 0);
+    EXPECT_EQ(op_to_count["Tanh"], 0);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level2, TransformerLevel::Level3, 13,
+                    1e-5, 1e-5);
+}
+
+TEST(ElementwiseFusionTests, IntermediateGraphOutput) {
+  // The Add output is also a graph output, so only the Relu -> Neg tail can be fused.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* x_arg = builder.MakeInput<float>({3, 16}, -3.f, 3.f);
+    auto* y_arg = builder.MakeInput<float>({16}, -3.f, 3.f);
+    auto* add_out = builder.MakeOutput();
+    auto* relu_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {x_arg, y_arg}, {add_out});
+    builder.AddNode("Relu", {add_out}, {relu_out});
+    builder.AddNode("Neg", {relu_out}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Add"], 1);
+    EXPECT_EQ(op_to_count["Relu"], 0);
+    EXPECT_EQ(op_to_count["Neg"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level2, TransformerLevel::Level3, 13);
+}
+
+TEST(ElementwiseFusionTests, SingleNodeNotFused) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* x_arg = builder.MakeInput<float>({3, 16}, -3.f, 3.f);
+    auto* y_arg = builder.MakeInput<float>({3, 16}, -3.f, 3.f);
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {x_arg, y_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 0);
+    EXPECT_EQ(op_to_count["Add"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level2, TransformerLevel::Level3, 13);
+}
+
+#endif  // DISABLE_CONTRIB_OPS
+
+}  // namespace test
+}  // namespace onnxruntime
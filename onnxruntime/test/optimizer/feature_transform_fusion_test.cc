@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "graph_transform_test_builder.h"
+
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+namespace test {
+
+#if !defined(DISABLE_CONTRIB_OPS) && !defined(DISABLE_ML_OPS)
+
+TEST(FeatureTransformFusionTests, ImputerScalerNormalizer) {
+  constexpr float nan = std::numeric_limits<float>::quiet_NaN();
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({3, 4}, {1.f, nan, -2.f, 4.f,
+                                                        nan, nan, 0.5f, -1.f,
+                                                        3.f, 2.f, nan, 0.f});
+    auto* imputer_out = builder.MakeIntermediate();
+    auto* scaler_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    Node& imputer = builder.AddNode("Imputer", {input_arg}, {imputer_out}, kMLDomain);
+    imputer.AddAttribute("imputed_value_floats", std::vector<float>{0.5f, 1.5f, -0.5f, 2.f});
+    imputer.AddAttribute("replaced_value_float", nan);
+    Node& scaler = builder.AddNode("Scaler", {imputer_out}, {scaler_out}, kMLDomain);
+    scaler.AddAttribute("offset", std::vector<float>{1.f, -1.f, 0.f, 0.5f});
+    scaler.AddAttribute("scale", std::vector<float>{2.f, 0.5f, -1.f, 1.f});
+    Node& normalizer = builder.AddNode("Normalizer", {scaler_out}, {output_arg}, kMLDomain);
+    normalizer.AddAttribute("norm", std::string("L2"));
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedFeatureTransform"], 1);
+    EXPECT_EQ(op_to_count["ai.onnx.ml.Imputer"], 0);
+    EXPECT_EQ(op_to_count["ai.onnx.ml.Scaler"], 0);
+    EXPECT_EQ(op_to_count["ai.onnx.ml.Normalizer"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    1e-6, 1e-6);
+}
+
+TEST(FeatureTransformFusionTests, ScalerNormalizer) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({8, 16}, -4.f, 4.f);
+    auto* scaler_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    Node& scaler = builder.AddNode("Scaler", {input_arg}, {scaler_out}, kMLDomain);
+    scaler.AddAttribute("offset", std::vector<float>{0.25f});
+    scaler.AddAttribute("scale", std::vector<float>{1.5f});
+    Node& normalizer = builder.AddNode("Normalizer", {scaler_out}, {output_arg}, kMLDomain);
+    normalizer.AddAttribute("norm", std::string("MAX"));
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedFeatureTransform"], 1);
+    EXPECT_EQ(op_to_count["ai.onnx.ml.Scaler"], 0);
+    EXPECT_EQ(op_to_count["ai.onnx.ml.Normalizer"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    1e-6, 1e-6);
+}
+
+TEST(FeatureTransformFusionTests, IntermediateGraphOutput) {
+  // The Imputer output is also a graph output, so only Scaler -> Normalizer can be fused.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({4, 8}, -2.f, 2.f);
+    auto* imputer_out = builder.MakeOutput();
+    auto* scaler_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    Node& imputer = builder.AddNode("Imputer", {input_arg}, {imputer_out}, kMLDomain);
+    imputer.AddAttribute("imputed_value_floats", std::vector<float>{1.f});
+    imputer.AddAttribute("replaced_value_float", 0.f);
+    Node& scaler = builder.AddNode("Scaler", {imputer_out}, {scaler_out}, kMLDomain);
+    scaler.AddAttribute("offset", std::vector<float>{0.5f});
+    scaler.AddAttribute("scale", std::vector<float>{2.f});
+    Node& normalizer = builder.AddNode("Normalizer", {scaler_out}, {output_arg}, kMLDomain);
+    normalizer.AddAttribute("norm", std::string("L1"));
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedFeatureTransform"], 1);
+    EXPECT_EQ(op_to_count["ai.onnx.ml.Imputer"], 1);
+    EXPECT_EQ(op_to_count["ai.onnx.ml.Scaler"], 0);
+    EXPECT_EQ(op_to_count["ai.onnx.ml.Normalizer"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    1e-6, 1e-6);
+}
+
+#endif  // !defined(DISABLE_CONTRIB_OPS) && !defined(DISABLE_ML_OPS)
+
+}  // namespace test
+}  // namespace onnxruntime
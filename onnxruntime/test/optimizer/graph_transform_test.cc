@@ -5,6 +5,7 @@
 #pragma warning(disable : 4244)
 #endif
 
+#include <numeric>
 #include <random>
 
 #include "gtest/gtest.h"
@@ -29,6 +30,7 @@
 #include "core/optimizer/concat_slice_elimination.h"
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/constant_sharing.h"
+#include "core/optimizer/duplicate_initializer_elimination.h"
 #include "core/optimizer/conv_activation_fusion.h"
 #include "core/optimizer/conv_add_act_fusion.h"
 #include "core/optimizer/conv_add_fusion.h"
@@ -44,12 +46,14 @@
 #include "core/optimizer/gelu_approximation.h"
 #include "core/optimizer/gelu_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
+#include "core/optimizer/gemm_float8_fusion.h"
 #include "core/optimizer/gemm_sum_fusion.h"
 #include "core/optimizer/gemm_transpose_fusion.h"
 #include "core/optimizer/graph_transformer_config.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/optimizer/graph_transformer.h"
+#include "core/optimizer/group_query_attention_fusion.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/isinf_reducesum_fusion.h"
@@ -57,9 +61,12 @@
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_bn_fusion.h"
 #include "core/optimizer/matmul_nbits_fusion.h"
+#include "core/optimizer/matmul_nbits_qkv_fusion.h"
+#include "core/optimizer/quantized_embedding_sharing.h"
 #include "core/optimizer/matmul_integer_to_float.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/memory_budget_recompute.h"
 #include "core/optimizer/noop_elimination.h"
 #include "core/optimizer/not_where_fusion.h"
 #include "core/optimizer/pad_fusion.h"
@@ -77,6 +84,7 @@
 #include "core/session/inference_session.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/util/math.h"
+#include "core/util/thread_utils.h"
 #include "test/capturing_sink.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/compare_ortvalue.h"
@@ -733,6 +741,191 @@ TEST_F(GraphTransformationTests, ConstantFoldingSubgraph) {
       << "Constant folding should have been able to remove the Add node in both subgraphs";
 }
 
+// Build a graph with independent foldable nodes as well as chains of them, which are folded in several rounds.
+TEST_F(GraphTransformationTests, ConstantFoldingWithThreadPool) {
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  Model model("ConstantFoldingWithThreadPool", false, ModelMetaData(), PathString(),
+              IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+  auto& graph_input = graph.GetOrCreateNodeArg("graph_input", &float_tensor_type);
+
+  constexpr int num_chains = 16;
+  for (int i = 0; i < num_chains; ++i) {
+    const std::string suffix = std::to_string(i);
+    TensorProto constant;
+    constant.set_name("constant_" + suffix);
+    constant.set_data_type(TensorProto_DataType_FLOAT);
+    constant.add_dims(1);
+    constant.add_float_data(static_cast<float>(i));
+    graph.AddInitializedTensor(constant);
+    auto& constant_arg = graph.GetOrCreateNodeArg(constant.name(), &float_tensor_type);
+
+    // (c + c) * c is folded in two steps as the Mul depends on the Add
+    auto& add_out = graph.GetOrCreateNodeArg("add_out_" + suffix, &float_tensor_type);
+    graph.AddNode("add_" + suffix, "Add", "", {&constant_arg, &constant_arg}, {&add_out});
+    auto& mul_out = graph.GetOrCreateNodeArg("mul_out_" + suffix, &float_tensor_type);
+    graph.AddNode("mul_" + suffix, "Mul", "", {&add_out, &constant_arg}, {&mul_out});
+
+    auto& graph_output = graph.GetOrCreateNodeArg("graph_output_" + suffix, &float_tensor_type);
+    graph.AddNode("sub_" + suffix, "Sub", "", {&graph_input, &mul_out}, {&graph_output});
+  }
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 4;
+  auto tp = concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+
+  std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  const ConfigOptions empty_config_options;
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(
+      std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/, empty_config_options,
+                                        InlinedHashSet<std::string_view>{}, InlinedHashSet<std::string>{},
+                                        tp.get()),
+      TransformerLevel::Level1));
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Add"], 0);
+  EXPECT_EQ(op_to_count["Mul"], 0);
+  EXPECT_EQ(op_to_count["Sub"], num_chains);
+
+  for (int i = 0; i < num_chains; ++i) {
+    const ONNX_NAMESPACE::TensorProto* folded = nullptr;
+    ASSERT_TRUE(graph.GetInitializedTensor("mul_out_" + std::to_string(i), folded));
+    Initializer folded_value{*folded, graph.ModelPath()};
+    ASSERT_EQ(folded_value.size(), 1U);
+    EXPECT_EQ(*folded_value.data<float>(), 2.f * i * i);
+  }
+}
+
+TEST_F(GraphTransformationTests, ConstantFoldingMaxOutputSize) {
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  Model model("ConstantFoldingMaxOutputSize", false, ModelMetaData(), PathString(),
+              IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TensorProto value;
+  value.set_name("value");
+  value.set_data_type(TensorProto_DataType_FLOAT);
+  value.add_dims(1);
+  value.add_float_data(1.f);
+  graph.AddInitializedTensor(value);
+  auto& value_arg = graph.GetOrCreateNodeArg("value", &float_tensor_type);
+  auto& graph_input = graph.GetOrCreateNodeArg("graph_input", &float_tensor_type);
+
+  // 4x4 floats are below the limit and 64x64 floats are above it
+  for (const int64_t dim : {4, 64}) {
+    const std::string suffix = std::to_string(dim);
+    TensorProto shape;
+    shape.set_name("shape_" + suffix);
+    shape.set_data_type(TensorProto_DataType_INT64);
+    shape.add_dims(2);
+    shape.add_int64_data(dim);
+    shape.add_int64_data(dim);
+    graph.AddInitializedTensor(shape);
+    auto& shape_arg = graph.GetOrCreateNodeArg(shape.name(), nullptr);
+
+    auto& expand_out = graph.GetOrCreateNodeArg("expand_out_" + suffix, &float_tensor_type);
+    graph.AddNode("expand_" + suffix, "Expand", "", {&value_arg, &shape_arg}, {&expand_out});
+    auto& graph_output = graph.GetOrCreateNodeArg("graph_output_" + suffix, &float_tensor_type);
+    graph.AddNode("add_" + suffix, "Add", "", {&graph_input, &expand_out}, {&graph_output});
+  }
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  ConfigOptions config_options;
+  ASSERT_STATUS_OK(config_options.AddConfigEntry(kOrtSessionOptionsConstantFoldingMaxOutputSizeInBytes, "1024"));
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(
+      std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/, config_options),
+      TransformerLevel::Level1));
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Expand"], 1);
+  EXPECT_EQ(op_to_count["Add"], 2);
+
+  const ONNX_NAMESPACE::TensorProto* folded = nullptr;
+  EXPECT_TRUE(graph.GetInitializedTensor("expand_out_4", folded));
+  EXPECT_FALSE(graph.GetInitializedTensor("expand_out_64", folded));
+}
+
+// a mask computed from the graph input is used before and after a large intermediate value
+TEST_F(GraphTransformationTests, MemoryBudgetRecompute) {
+  auto float_tensor_type = [](std::initializer_list<int64_t> dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (const int64_t dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return type;
+  };
+
+  Model model("MemoryBudgetRecompute", false, ModelMetaData(), PathString(),
+              IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TensorProto one;
+  one.set_name("one");
+  one.set_data_type(TensorProto_DataType_FLOAT);
+  one.add_dims(1);
+  one.add_float_data(1.f);
+  graph.AddInitializedTensor(one);
+
+  TensorProto repeats;
+  repeats.set_name("repeats");
+  repeats.set_data_type(TensorProto_DataType_INT64);
+  repeats.add_dims(2);
+  repeats.add_int64_data(4);
+  repeats.add_int64_data(1);
+  graph.AddInitializedTensor(repeats);
+
+  const TypeProto type_1 = float_tensor_type({1});
+  const TypeProto type_64x64 = float_tensor_type({64, 64});
+  const TypeProto type_256x64 = float_tensor_type({256, 64});
+  const TypeProto type_1x64 = float_tensor_type({1, 64});
+  auto& one_arg = graph.GetOrCreateNodeArg("one", &type_1);
+  auto& repeats_arg = graph.GetOrCreateNodeArg("repeats", nullptr);
+  auto& x = graph.GetOrCreateNodeArg("x", &type_64x64);
+  auto& mask = graph.GetOrCreateNodeArg("mask", &type_64x64);
+  auto& relu_out = graph.GetOrCreateNodeArg("relu_out", &type_64x64);
+  auto& tile_out = graph.GetOrCreateNodeArg("tile_out", &type_256x64);
+  auto& reduce_out = graph.GetOrCreateNodeArg("reduce_out", &type_1x64);
+  auto& y = graph.GetOrCreateNodeArg("y", &type_64x64);
+
+  graph.AddNode("mask", "Add", "", {&x, &one_arg}, {&mask});
+  graph.AddNode("relu", "Relu", "", {&mask}, {&relu_out});
+  graph.AddNode("tile", "Tile", "", {&relu_out, &repeats_arg}, {&tile_out});
+  auto& reduce = graph.AddNode("reduce", "ReduceMax", "", {&tile_out}, {&reduce_out});
+  reduce.AddAttribute("axes", std::vector<int64_t>{0});
+  graph.AddNode("y", "Add", "", {&reduce_out, &mask}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  // the estimated peak is 96KB while the tile runs, 80KB once the mask is recomputed for the last Add
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::make_unique<MemoryBudgetRecompute>(90000),
+                                                     TransformerLevel::Level1));
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  EXPECT_EQ(op_to_count["Add"], 3);
+
+  const Node* last_add = graph.GetProducerNode("y");
+  ASSERT_NE(last_add, nullptr);
+  EXPECT_NE(last_add->InputDefs()[1], &mask);
+  EXPECT_EQ(graph.GetConsumerNodes("mask").size(), 1U);
+}
+
 TEST_F(GraphTransformationTests, ConstantFoldingWithShapeToInitializer) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/constant_folding_with_shape_to_initializer.onnx";
   std::shared_ptr<Model> model;
@@ -7317,6 +7510,49 @@ TEST_F(GraphTransformationTests, ConstantSharing_ShouldNotShareForGraphOutput) {
   }
 }
 
+TEST_F(GraphTransformationTests, DuplicateInitializerElimination) {
+  std::vector<float> weight(32 * 32);
+  std::iota(weight.begin(), weight.end(), 0.f);
+  std::vector<float> other_weight(weight);
+  other_weight.back() = -1.f;
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({{4, 32}});
+    // three MatMuls use the same values, the last one differs by a single element
+    for (size_t i = 0; i < 4; ++i) {
+      auto* weight_arg = builder.MakeInitializer<float>({32, 32}, i < 3 ? weight : other_weight);
+      builder.AddNode("MatMul", {input_arg, weight_arg}, {builder.MakeOutput()});
+    }
+  };
+
+  auto pre_graph_checker = [](Graph& graph) -> Status {
+    TEST_RETURN_IF_NOT(graph.GetAllInitializedTensors().size() == 4U);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) -> Status {
+    TEST_RETURN_IF_NOT(graph.GetAllInitializedTensors().size() == 2U);
+    std::map<const NodeArg*, int> weight_use_count;
+    for (const auto& node : graph.Nodes()) {
+      ++weight_use_count[node.InputDefs()[1]];
+    }
+    TEST_RETURN_IF_NOT(weight_use_count.size() == 2U);
+    for (const auto& [weight_arg, use_count] : weight_use_count) {
+      const ONNX_NAMESPACE::TensorProto* tensor_proto = graph.GetConstantInitializer(weight_arg->Name(), true);
+      TEST_RETURN_IF(tensor_proto == nullptr);
+      Initializer value{*tensor_proto, graph.ModelPath()};
+      TEST_RETURN_IF_NOT(SpanEq(value.DataAsSpan<float>(),
+                                gsl::make_span(use_count == 3 ? weight : other_weight)));
+      TEST_RETURN_IF_NOT(graph.GetConsumerNodes(weight_arg->Name()).size() == static_cast<size_t>(use_count));
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<DuplicateInitializerElimination>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                        TransformerLevel::Level1, 1, pre_graph_checker, post_graph_checker));
+}
+
 TEST_F(GraphTransformationTests, GatherSliceToSplitFusion_AllGather) {
   auto build_test_case = [&](ModelTestBuilder& builder) {
     auto* data_arg = builder.MakeInput<float>({{54}});
@@ -7876,6 +8112,389 @@ TEST_F(GraphTransformationTests, MatMulNBitsBiasFusion) {
   }
 }
 
+TEST_F(GraphTransformationTests, MatMulNBitsQkvFusion) {
+  constexpr int64_t num_heads = 2, kv_num_heads = 1, head_size = 8, K = 32, block_size = 32, blob_size = 16;
+
+  auto run_test = [&logger = *logger_](bool has_bias, bool same_input) {
+    SCOPED_TRACE(MakeString("has_bias:", has_bias, ", same_input:", same_input));
+
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* A = builder.MakeInput<float>(std::vector<int64_t>{1, 1, K}, -1.0f, 1.0f);
+      auto* other_A = same_input ? A : builder.MakeInput<float>(std::vector<int64_t>{1, 1, K}, -1.0f, 1.0f);
+
+      auto add_projection = [&](NodeArg* input, int64_t N) {
+        auto* B = builder.MakeInitializer<uint8_t>({N, K / block_size, blob_size}, uint8_t{0}, uint8_t{255});
+        auto* scales = builder.MakeInitializer<float>({N * (K / block_size)}, 1.0f, 2.0f);
+        std::vector<NodeArg*> inputs{input, B, scales};
+        if (has_bias) {
+          inputs.push_back(builder.MakeEmptyInput());
+          inputs.push_back(builder.MakeEmptyInput());
+          inputs.push_back(builder.MakeInitializer<float>({N}, -1.0f, 1.0f));
+        }
+        auto* output = builder.MakeIntermediate();
+        auto& matmul = builder.AddNode("MatMulNBits", inputs, {output}, kMSDomain);
+        matmul.AddAttribute("N", N);
+        matmul.AddAttribute("K", K);
+        matmul.AddAttribute("block_size", block_size);
+        matmul.AddAttribute("bits", int64_t{4});
+        return output;
+      };
+
+      auto* query = add_projection(A, num_heads * head_size);
+      auto* key = add_projection(A, kv_num_heads * head_size);
+      auto* value = add_projection(other_A, kv_num_heads * head_size);
+
+      auto* past_key = builder.MakeInput<float>(std::vector<int64_t>{1, kv_num_heads, 4, head_size}, -1.0f, 1.0f);
+      auto* past_value = builder.MakeInput<float>(std::vector<int64_t>{1, kv_num_heads, 4, head_size}, -1.0f, 1.0f);
+      auto* seqlens_k = builder.MakeInput<int32_t>(std::vector<int64_t>{1}, std::vector<int32_t>{4});
+      auto* total_sequence_length = builder.MakeInput<int32_t>(std::vector<int64_t>{}, std::vector<int32_t>{5});
+
+      auto& gqa = builder.AddNode("GroupQueryAttention",
+                                  {query, key, value, past_key, past_value, seqlens_k, total_sequence_length},
+                                  {builder.MakeOutput(), builder.MakeOutput(), builder.MakeOutput()}, kMSDomain);
+      gqa.AddAttribute("num_heads", num_heads);
+      gqa.AddAttribute("kv_num_heads", kv_num_heads);
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_count["com.microsoft.MatMulNBits"] == (same_input ? 1 : 3));
+      for (const Node& node : graph.Nodes()) {
+        if (node.OpType() == "GroupQueryAttention") {
+          TEST_RETURN_IF_NOT(node.InputDefs()[1]->Exists() == !same_input);
+          TEST_RETURN_IF_NOT(node.InputDefs()[2]->Exists() == !same_input);
+        } else if (same_input) {
+          constexpr int64_t qkv_N = (num_heads + 2 * kv_num_heads) * head_size;
+          TEST_RETURN_IF_NOT(graph_utils::GetNodeAttribute(node, "N")->i() == qkv_N);
+          TEST_RETURN_IF_NOT((node.InputDefs().size() > 5 && node.InputDefs()[5]->Exists()) == has_bias);
+          const auto* B = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+          TEST_RETURN_IF_NOT(B != nullptr && B->dims(0) == qkv_N);
+        }
+      }
+      return Status::OK();
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 21, logger, std::make_unique<MatMulNBitsQkvFusion>(),
+                                          TransformerLevel::Level2, 1, nullptr, post_graph_checker));
+  };
+
+  for (bool has_bias : {false, true}) {
+    for (bool same_input : {true, false}) {
+      run_test(has_bias, same_input);
+    }
+  }
+}
+
+TEST_F(GraphTransformationTests, QuantizedEmbeddingSharing) {
+  constexpr int64_t N = 16, K = 32, block_size = 16, num_blocks = K / block_size;
+
+  auto run_test = [&logger = *logger_](bool tied) {
+    SCOPED_TRACE(MakeString("tied:", tied));
+
+    // the same 4-bit weight, with 2 blocks per row, so the zero points of a row are one byte in both layouts
+    std::vector<uint8_t> data(N * K / 2);
+    std::vector<uint8_t> zero_points(N);
+    std::vector<float> scales(N * num_blocks);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<uint8_t>(i * 37 % 256);
+    }
+    for (size_t i = 0; i < zero_points.size(); ++i) {
+      zero_points[i] = static_cast<uint8_t>(i * 19 % 256);
+    }
+    for (size_t i = 0; i < scales.size(); ++i) {
+      scales[i] = 0.25f * static_cast<float>(i % 5 + 1);
+    }
+    std::vector<float> matmul_scales = scales;
+    if (!tied) {
+      matmul_scales[3] *= 2.0f;
+    }
+
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_ids = builder.MakeInput<int64_t>(std::vector<int64_t>{1, 4}, std::vector<int64_t>{1, 5, 9, 15});
+      auto* embeddings = builder.MakeIntermediate();
+      auto& gather = builder.AddNode(
+          "GatherBlockQuantized",
+          {builder.MakeInitializer(std::vector<int64_t>{N, K}, TensorProto_DataType_UINT4,
+                                   AsByteSpan(data.data(), data.size())),
+           input_ids,
+           builder.MakeInitializer<float>({N, num_blocks}, scales),
+           builder.MakeInitializer(std::vector<int64_t>{N, num_blocks}, TensorProto_DataType_UINT4,
+                                   AsByteSpan(zero_points.data(), zero_points.size()))},
+          {embeddings}, kMSDomain);
+      gather.AddAttribute("block_size", block_size);
+
+      auto& matmul = builder.AddNode("MatMulNBits",
+                                     {embeddings,
+                                      builder.MakeInitializer<uint8_t>({N, num_blocks, block_size / 2}, data),
+                                      builder.MakeInitializer<float>({N * num_blocks}, matmul_scales),
+                                      builder.MakeInitializer<uint8_t>({N}, zero_points)},
+                                     {builder.MakeOutput()}, kMSDomain);
+      matmul.AddAttribute("N", N);
+      matmul.AddAttribute("K", K);
+      matmul.AddAttribute("block_size", block_size);
+      matmul.AddAttribute("bits", int64_t{4});
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      const Node* gather = nullptr;
+      const Node* matmul = nullptr;
+      for (const Node& node : graph.Nodes()) {
+        (node.OpType() == "GatherBlockQuantized" ? gather : matmul) = &node;
+      }
+      TEST_RETURN_IF_NOT(gather != nullptr && matmul != nullptr);
+
+      const bool shared = gather->InputDefs()[0] == matmul->InputDefs()[1];
+      TEST_RETURN_IF_NOT(shared == tied);
+      TEST_RETURN_IF_NOT((graph_utils::GetNodeAttribute(*gather, "bits") != nullptr) == tied);
+      if (tied) {
+        TEST_RETURN_IF_NOT(gather->InputDefs()[2] == matmul->InputDefs()[2]);
+        TEST_RETURN_IF_NOT(gather->InputDefs()[3] == matmul->InputDefs()[3]);
+        const auto* shared_data = graph_utils::GetConstantInitializer(graph, gather->InputDefs()[0]->Name());
+        TEST_RETURN_IF_NOT(shared_data != nullptr && shared_data->data_type() == TensorProto_DataType_UINT8);
+        TEST_RETURN_IF_NOT(shared_data->dims_size() == 2 && shared_data->dims(0) == N && shared_data->dims(1) == K / 2);
+      }
+      return Status::OK();
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 21, logger, std::make_unique<QuantizedEmbeddingSharing>(),
+                                          TransformerLevel::Level2, 1, nullptr, post_graph_checker));
+  };
+
+  run_test(true);
+  run_test(false);
+}
+
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion) {
+  constexpr int64_t num_heads = 4, kv_num_heads = 2, head_size = 8, half = head_size / 2;
+  constexpr int64_t sequence_length = 3, past_sequence_length = 2, max_position = 16;
+  constexpr int64_t total_sequence_length = sequence_length + past_sequence_length;
+
+  // the mask is causal with Trilu, a sliding window of 2 keys, or only the padding
+  enum class Mask { kCausal, kSlidingWindow, kPaddingOnly };
+  auto run_test = [&logger = *logger_](Mask mask_kind) {
+    SCOPED_TRACE(MakeString("mask:", static_cast<int>(mask_kind)));
+
+    // cos and sin repeat the frequencies in both halves of a head
+    std::vector<float> cos_table(max_position * head_size);
+    std::vector<float> sin_table(max_position * head_size);
+    for (int64_t p = 0; p < max_position; ++p) {
+      for (int64_t i = 0; i < head_size; ++i) {
+        const float angle = static_cast<float>(p) / std::pow(10000.0f, static_cast<float>(i % half) / half);
+        cos_table[p * head_size + i] = std::cos(angle);
+        sin_table[p * head_size + i] = std::sin(angle);
+      }
+    }
+
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* query = builder.MakeInput<float>(std::vector<int64_t>{1, sequence_length, num_heads, head_size},
+                                             -1.0f, 1.0f);
+      auto* key = builder.MakeInput<float>(std::vector<int64_t>{1, sequence_length, kv_num_heads, head_size},
+                                           -1.0f, 1.0f);
+      auto* value = builder.MakeInput<float>(std::vector<int64_t>{1, sequence_length, kv_num_heads, head_size},
+                                             -1.0f, 1.0f);
+      auto* past_key = builder.MakeInput<float>(
+          std::vector<int64_t>{1, kv_num_heads, past_sequence_length, head_size}, -1.0f, 1.0f);
+      auto* past_value = builder.MakeInput<float>(
+          std::vector<int64_t>{1, kv_num_heads, past_sequence_length, head_size}, -1.0f, 1.0f);
+      auto* position_ids = builder.MakeInput<int64_t>(std::vector<int64_t>{1, sequence_length},
+                                                      std::vector<int64_t>{2, 3, 4});
+      auto* attention_mask = builder.MakeInput<int64_t>(
+          std::optional<std::vector<int64_t>>{{1, total_sequence_length}}, std::string("attention_mask"));
+
+      auto add_node = [&](const std::string& op_type, const std::vector<NodeArg*>& inputs) {
+        auto* output = builder.MakeIntermediate();
+        builder.AddNode(op_type, inputs, {output});
+        return output;
+      };
+      auto add_transpose = [&](NodeArg* input, const std::vector<int64_t>& perm) {
+        auto* output = builder.MakeIntermediate();
+        builder.AddNode("Transpose", {input}, {output}).AddAttribute("perm", perm);
+        return output;
+      };
+      auto add_concat = [&](NodeArg* first, NodeArg* second, int64_t axis, NodeArg* output) {
+        builder.AddNode("Concat", {first, second}, {output}).AddAttribute("axis", axis);
+        return output;
+      };
+      auto add_unsqueeze = [&](NodeArg* input, const std::vector<int64_t>& axes) {
+        return add_node("Unsqueeze", {input, builder.Make1DInitializer<int64_t>(axes)});
+      };
+
+      auto* cos = add_unsqueeze(add_node("Gather", {builder.MakeInitializer<float>({max_position, head_size},
+                                                                                    cos_table),
+                                                    position_ids}),
+                                {1});
+      auto* sin = add_unsqueeze(add_node("Gather", {builder.MakeInitializer<float>({max_position, head_size},
+                                                                                    sin_table),
+                                                    position_ids}),
+                                {1});
+      auto add_rotary = [&](NodeArg* x) {
+        auto add_slice = [&](int64_t start, int64_t end) {
+          return add_node("Slice", {x, builder.Make1DInitializer<int64_t>({start}),
+                                    builder.Make1DInitializer<int64_t>({end}),
+                                    builder.Make1DInitializer<int64_t>({3})});
+        };
+        auto* low = add_slice(0, half);
+        auto* high = add_slice(half, std::numeric_limits<int64_t>::max());
+        auto* rotated = add_concat(add_node("Neg", {high}), low, 3, builder.MakeIntermediate());
+        return add_node("Add", {add_node("Mul", {x, cos}), add_node("Mul", {rotated, sin})});
+      };
+      auto add_repeat_kv = [&](NodeArg* x) {
+        constexpr int64_t groups = num_heads / kv_num_heads;
+        auto* expanded = add_node(
+            "Expand", {add_unsqueeze(x, {2}), builder.Make1DInitializer<int64_t>(
+                                                  {1, kv_num_heads, groups, total_sequence_length, head_size})});
+        return add_node("Reshape", {expanded, builder.Make1DInitializer<int64_t>(
+                                                  {1, num_heads, total_sequence_length, head_size})});
+      };
+
+      auto* q = add_rotary(add_transpose(query, {0, 2, 1, 3}));
+      auto* k = add_repeat_kv(add_concat(past_key, add_rotary(add_transpose(key, {0, 2, 1, 3})), 2,
+                                         builder.MakeOutput()));
+      auto* v = add_repeat_kv(add_concat(past_value, add_transpose(value, {0, 2, 1, 3}), 2, builder.MakeOutput()));
+
+      auto* padding = builder.MakeIntermediate();
+      builder.AddNode("Cast", {attention_mask}, {padding})
+          .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+      NodeArg* mask = add_unsqueeze(padding, {1, 2});
+      auto add_trilu = [&](int64_t upper, int64_t k) {
+        auto* output = builder.MakeIntermediate();
+        std::vector<float> masked(sequence_length * total_sequence_length, -10000.0f);
+        builder.AddNode("Trilu", {builder.MakeInitializer<float>({sequence_length, total_sequence_length}, masked),
+                                  builder.MakeScalarInitializer<int64_t>(k)},
+                        {output})
+            .AddAttribute("upper", upper);
+        return output;
+      };
+      if (mask_kind != Mask::kPaddingOnly) {
+        mask = add_node("Add", {mask, add_trilu(1, past_sequence_length + 1)});
+      }
+      if (mask_kind == Mask::kSlidingWindow) {
+        mask = add_node("Add", {mask, add_trilu(0, -2)});
+      }
+
+      auto* scores = add_node("Mul", {add_node("MatMul", {q, add_transpose(k, {0, 1, 3, 2})}),
+                                      builder.MakeScalarInitializer<float>(0.5f)});
+      auto* probs = builder.MakeIntermediate();
+      builder.AddNode("Softmax", {add_node("Add", {scores, mask})}, {probs}).AddAttribute("axis", int64_t{-1});
+      auto* context = add_transpose(add_node("MatMul", {probs, v}), {0, 2, 1, 3});
+      builder.AddNode("Reshape",
+                      {context, builder.Make1DInitializer<int64_t>({1, sequence_length, num_heads * head_size})},
+                      {builder.MakeOutput()});
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_count = CountOpsInGraph(graph);
+      if (mask_kind == Mask::kPaddingOnly) {
+        TEST_RETURN_IF_NOT(op_count["com.microsoft.GroupQueryAttention"] == 0);
+        TEST_RETURN_IF_NOT(op_count["Softmax"] == 1);
+        return Status::OK();
+      }
+
+      TEST_RETURN_IF_NOT(op_count["com.microsoft.GroupQueryAttention"] == 1);
+      TEST_RETURN_IF_NOT(op_count["Softmax"] == 0);
+      TEST_RETURN_IF_NOT(op_count["Trilu"] == 0);
+      TEST_RETURN_IF_NOT(op_count["Expand"] == 0);
+      for (const Node& node : graph.Nodes()) {
+        if (node.OpType() == "GroupQueryAttention") {
+          TEST_RETURN_IF_NOT(graph_utils::GetNodeAttribute(node, "num_heads")->i() == num_heads);
+          TEST_RETURN_IF_NOT(graph_utils::GetNodeAttribute(node, "kv_num_heads")->i() == kv_num_heads);
+          TEST_RETURN_IF_NOT(graph_utils::GetNodeAttribute(node, "do_rotary")->i() == 1);
+          TEST_RETURN_IF_NOT(graph_utils::GetNodeAttribute(node, "scale")->f() == 0.5f);
+          // the window of 2 keys lets each query attend to itself and the previous key
+          TEST_RETURN_IF_NOT(graph_utils::GetNodeAttribute(node, "local_window_size")->i() ==
+                             (mask_kind == Mask::kSlidingWindow ? 1 : -1));
+          TEST_RETURN_IF_NOT(node.InputDefs().size() == 9);
+          const auto* cos_cache = graph_utils::GetConstantInitializer(graph, node.InputDefs()[7]->Name());
+          TEST_RETURN_IF_NOT(cos_cache != nullptr && cos_cache->dims(0) == max_position && cos_cache->dims(1) == half);
+        }
+      }
+      return Status::OK();
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 18, logger, std::make_unique<GroupQueryAttentionFusion>(),
+                                          TransformerLevel::Level2, 1, nullptr, post_graph_checker));
+  };
+
+  run_test(Mask::kCausal);
+  run_test(Mask::kSlidingWindow);
+  run_test(Mask::kPaddingOnly);
+}
+
+#if !defined(DISABLE_FLOAT8_TYPES)
+TEST_F(GraphTransformationTests, GemmFloat8Fusion) {
+  constexpr int64_t M = 2, K = 3, N = 4;
+  const auto run_test = [&](bool quantize_output) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* a = builder.MakeInput<Float8E4M3FN>(std::vector<int64_t>{M, K});
+      std::vector<std::byte> b_data(K * N);
+      for (size_t i = 0; i < b_data.size(); ++i) {
+        b_data[i] = static_cast<std::byte>(i);
+      }
+      auto* b = builder.MakeInitializer(std::vector<int64_t>{K, N}, ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E4M3FN,
+                                        b_data);
+      auto* dq_a_output = builder.MakeIntermediate();
+      auto* dq_b_output = builder.MakeIntermediate();
+      builder.AddDequantizeLinearNode(a, 0.5f, dq_a_output);
+      builder.AddDequantizeLinearNode(b, 0.25f, dq_b_output);
+      if (!quantize_output) {
+        builder.AddNode("MatMul", {dq_a_output, dq_b_output}, {builder.MakeOutput()});
+        return;
+      }
+      auto* matmul_output = builder.MakeIntermediate();
+      builder.AddNode("MatMul", {dq_a_output, dq_b_output}, {matmul_output});
+      const std::vector<std::byte> zero_point{std::byte{0}};
+      builder.AddNode("QuantizeLinear",
+                      {matmul_output, builder.MakeScalarInitializer<float>(2.0f),
+                       builder.MakeInitializer({}, ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E4M3FN, zero_point)},
+                      {builder.MakeOutput()});
+    };
+
+    auto pre_graph_checker = [](Graph& graph) {
+      for (auto& node : graph.Nodes()) {
+        node.SetExecutionProviderType(kCudaExecutionProvider);
+      }
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GemmFloat8"] == 1);
+      TEST_RETURN_IF_NOT(op_to_count["DequantizeLinear"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["QuantizeLinear"] == 0);
+      for (const Node& node : graph.Nodes()) {
+        TEST_RETURN_IF_NOT(graph_utils::GetNodeAttribute(node, "transB")->i() == 1);
+        TEST_RETURN_IF_NOT(graph_utils::GetNodeAttribute(node, "dtype")->i() ==
+                           (quantize_output ? ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E4M3FN
+                                            : ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == (quantize_output ? 6u : 5u));
+
+        // B is transposed to [N, K]
+        const auto* b = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+        TEST_RETURN_IF_NOT(b != nullptr && b->dims(0) == N && b->dims(1) == K);
+        Initializer b_value{*b, graph.ModelPath()};
+        const auto b_bytes = b_value.DataAsByteSpan();
+        TEST_RETURN_IF_NOT(static_cast<int64_t>(b_bytes[1]) == N);
+        if (quantize_output) {
+          const auto* scale_y = graph_utils::GetConstantInitializer(graph, node.InputDefs()[5]->Name());
+          TEST_RETURN_IF_NOT(scale_y != nullptr);
+          TEST_RETURN_IF_NOT(*Initializer{*scale_y, graph.ModelPath()}.data<float>() == 0.5f);
+        }
+      }
+      return Status::OK();
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(
+        build_test_case, 21, *logger_,
+        std::make_unique<GemmFloat8Fusion>(InlinedHashSet<std::string_view>{kCudaExecutionProvider}),
+        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  };
+
+  run_test(false);
+  run_test(true);
+}
+#endif  // !defined(DISABLE_FLOAT8_TYPES)
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
 
 }  // namespace test
@@ -147,6 +147,7 @@ void TransformerTester(const std::function<void(ModelTestBuilder& helper)>& buil
   std::unordered_map<std::string, int> domain_to_version;
   domain_to_version[kOnnxDomain] = opset_version;
   domain_to_version[kMSDomain] = 1;
+  domain_to_version[kMLDomain] = 1;
   Model model("TransformerTester", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
               domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
   Graph& graph = model.MainGraph();
@@ -241,6 +242,7 @@ Status TestGraphTransformer(const std::function<void(ModelTestBuilder& helper)>&
     std::unordered_map<std::string, int> domain_to_version;
     domain_to_version[kOnnxDomain] = opset;
     domain_to_version[kMSDomain] = 1;
+    domain_to_version[kMLDomain] = 1;
     Model model("TransformerTester", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
                 domain_to_version, {}, logger);
     Graph& graph = model.MainGraph();
@@ -701,6 +701,47 @@ TEST_F(GraphTransformationTests, SkipLayerNormFusion_NoBeta) {
   TestSkipLayerNormFusionNoBeta(MODEL_FOLDER "fusion/skip_layer_norm_no_beta_with_cast.onnx", true, logger_.get());
 }
 
+// Two decoder blocks, where the residual sum of the first block is also the skip input of the second one, and the
+// residual sum of the second block is a graph output.
+TEST_F(GraphTransformationTests, SkipSimplifiedLayerNormFusion_Residual) {
+  constexpr int64_t hidden_size = 16;
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input = builder.MakeInput<float>(std::vector<int64_t>{2, 3, hidden_size}, -1.0f, 1.0f);
+    auto* attention = builder.MakeInput<float>(std::vector<int64_t>{2, 3, hidden_size}, -1.0f, 1.0f);
+    auto* residual1 = builder.MakeIntermediate();
+    auto* norm1 = builder.MakeIntermediate();
+    auto* mlp = builder.MakeIntermediate();
+    auto* residual2 = builder.MakeOutput();
+    builder.AddNode("Add", {input, attention}, {residual1});
+    builder.AddNode("SimplifiedLayerNormalization",
+                    {residual1, builder.MakeInitializer<float>({hidden_size}, 0.5f, 1.5f)}, {norm1})
+        .AddAttribute("epsilon", 1e-6f);
+    builder.AddNode("Mul", {norm1, builder.MakeInitializer<float>({hidden_size}, -1.0f, 1.0f)}, {mlp});
+    builder.AddNode("Add", {residual1, mlp}, {residual2});
+    builder.AddNode("SimplifiedLayerNormalization",
+                    {residual2, builder.MakeInitializer<float>({hidden_size}, 0.5f, 1.5f)}, {builder.MakeOutput()});
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["SimplifiedLayerNormalization"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.SkipSimplifiedLayerNormalization"] == 2);
+    for (const Node& node : graph.Nodes()) {
+      if (node.OpType() == "SkipSimplifiedLayerNormalization") {
+        // the residual sum is output by both nodes
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 3);
+        TEST_RETURN_IF_NOT(node.OutputDefs().size() == 4 && node.OutputDefs()[3]->Exists());
+        TEST_RETURN_IF_NOT(!node.OutputDefs()[1]->Exists() && !node.OutputDefs()[2]->Exists());
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 18, *logger_, std::make_unique<SkipLayerNormFusion>(),
+                                        TransformerLevel::Level2, 1, nullptr, post_graph_checker));
+}
+
 TEST_F(GraphTransformationTests, EmbedLayerNormFusionFormat1) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/embed_layer_norm_format1.onnx";
   std::shared_ptr<Model> p_model;
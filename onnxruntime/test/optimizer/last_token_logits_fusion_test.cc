@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "graph_transform_test_builder.h"
+
+#include "core/graph/graph.h"
+#include "core/optimizer/last_token_logits_fusion.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// hidden (2, 5, 8) -> LayerNormalization -> MatMul (8, 16) -> [Add] -> logits
+void BuildDecoderHead(ModelTestBuilder& builder, bool with_bias, bool logits_consumed) {
+  auto* hidden_arg = builder.MakeInput<float>({2, 5, 8}, -1.f, 1.f);
+  auto* scale_arg = builder.MakeInitializer<float>({8}, 0.5f, 1.5f);
+  auto* bias_arg = builder.MakeInitializer<float>({8}, -0.5f, 0.5f);
+  auto* weight_arg = builder.MakeInitializer<float>({8, 16}, -1.f, 1.f);
+  auto* norm_out = builder.MakeIntermediate();
+  builder.AddNode("LayerNormalization", {hidden_arg, scale_arg, bias_arg}, {norm_out})
+      .AddAttribute("axis", static_cast<int64_t>(-1));
+
+  auto* logits_arg = logits_consumed ? builder.MakeIntermediate() : builder.MakeOutput();
+  if (with_bias) {
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* logits_bias_arg = builder.MakeInitializer<float>({16}, -1.f, 1.f);
+    builder.AddNode("MatMul", {norm_out, weight_arg}, {matmul_out});
+    builder.AddNode("Add", {matmul_out, logits_bias_arg}, {logits_arg});
+  } else {
+    builder.AddNode("MatMul", {norm_out, weight_arg}, {logits_arg});
+  }
+
+  if (logits_consumed) {
+    builder.AddNode("Softmax", {logits_arg}, {builder.MakeOutput()});
+  }
+}
+
+}  // namespace
+
+TEST(LastTokenLogitsFusionTests, SliceLastPosition) {
+  for (bool with_bias : {false, true}) {
+    auto pre_graph_checker = [](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Slice"] == 0);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [with_bias](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count["Slice"] == 1);
+      for (const auto& node : graph.Nodes()) {
+        if (node.OpType() == "LayerNormalization") {
+          const Node* producer = graph.GetProducerNode(node.InputDefs()[0]->Name());
+          TEST_RETURN_IF_NOT(producer != nullptr && producer->OpType() == "Slice");
+        }
+      }
+
+      const auto* logits_shape = graph.GetOutputs()[0]->Shape();
+      TEST_RETURN_IF_NOT(logits_shape != nullptr && logits_shape->dim_size() == 3);
+      TEST_RETURN_IF_NOT(logits_shape->dim(1).dim_value() == 1);
+      TEST_RETURN_IF_NOT(logits_shape->dim(2).dim_value() == 16);
+      TEST_RETURN_IF_NOT(op_to_count["Add"] == (with_bias ? 1 : 0));
+      return Status::OK();
+    };
+
+    auto build_test_case = [with_bias](ModelTestBuilder& builder) {
+      BuildDecoderHead(builder, with_bias, false);
+    };
+
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 17, DefaultLoggingManager().DefaultLogger(),
+                                          std::make_unique<LastTokenLogitsFusion>(), TransformerLevel::Level1, 1,
+                                          pre_graph_checker, post_graph_checker));
+  }
+}
+
+TEST(LastTokenLogitsFusionTests, LogitsConsumedInGraph) {
+  // The logits of all positions are read by another node, so the graph is unchanged.
+  auto graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Slice"] == 0);
+    return Status::OK();
+  };
+
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    BuildDecoderHead(builder, false, true);
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 17, DefaultLoggingManager().DefaultLogger(),
+                                        std::make_unique<LastTokenLogitsFusion>(), TransformerLevel::Level1, 1,
+                                        graph_checker, graph_checker));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -13,6 +13,7 @@
 #include "test/util/include/asserts.h"
 #include "test/util/include/inference_session_wrapper.h"
 #include <cmath>
+#include <limits>
 
 #include "gtest/gtest.h"
 
@@ -193,6 +194,8 @@ void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& bu
     session_options.session_logid = "NchwcOptimizerTests";
     InferenceSessionWrapper session{session_options, GetEnvironment()};
     ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+    // The tests count the element-wise operators left behind by the NCHWc transformer, so keep them unfused.
+    ASSERT_STATUS_OK(session.FilterEnabledOptimizers({"ElementwiseFusion"}));
     ASSERT_STATUS_OK(session.Initialize());
 
     RunOptions run_options;
@@ -706,6 +709,44 @@ TEST(NchwcOptimizerTests, ConvBinaryBroadcast) {
   }
 }
 
+TEST(NchwcOptimizerTests, SqueezeExcite) {
+  auto build_test_case = [&](NchwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput<float>({1, 32, 21, 21});
+    auto* conv1_output_arg = helper.MakeIntermediate();
+    auto* pool_output_arg = helper.MakeIntermediate();
+    auto* conv2_output_arg = helper.MakeIntermediate();
+    auto* relu_output_arg = helper.MakeIntermediate();
+    auto* conv3_output_arg = helper.MakeIntermediate();
+    auto* sigmoid_output_arg = helper.MakeIntermediate();
+    auto* mul_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    helper.AddConvNode(input_arg, conv1_output_arg, {32, 32, 3, 3});
+    helper.AddNode("GlobalAveragePool", {conv1_output_arg}, {pool_output_arg});
+    helper.AddConvNode(pool_output_arg, conv2_output_arg, {16, 32, 1, 1});
+    helper.AddNode("Relu", {conv2_output_arg}, {relu_output_arg});
+    helper.AddConvNode(relu_output_arg, conv3_output_arg, {32, 16, 1, 1});
+    helper.AddNode("Sigmoid", {conv3_output_arg}, {sigmoid_output_arg});
+    helper.AddNode("Mul", {conv1_output_arg, sigmoid_output_arg}, {mul_output_arg});
+    helper.AddConvNode(mul_output_arg, output_arg, {32, 32, 1, 1});
+  };
+
+  auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 4);
+    EXPECT_EQ(op_to_count["com.microsoft.nchwc.GlobalAveragePool"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.nchwc.Mul"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], 1);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+    EXPECT_EQ(op_to_count["Reshape"], 0);
+  };
+
+  // Verify that the channel scaling of a squeeze-and-excitation block stays
+  // in NCHWc format.
+  NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+}
+
 TEST(NchwcOptimizerTests, ConvConcat) {
   auto test_case = [&](int axis, int channel_count, int reorder_output_count) {
     auto build_test_case = [&](NchwcTestHelper& helper) {
@@ -1365,17 +1406,159 @@ TEST(NchwcOptimizerTests, Activation) {
       EXPECT_EQ(op_to_count["Add"], 1);
     };
 
-    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph, 14);
   };
 
   // Verify that the optimizer doesn't add reorders for these activations that
   // cannot be fused with a convolution.
-  std::vector<std::string> activation_op_types{"Relu", "Sigmoid", "Tanh"};
+  std::vector<std::string> activation_op_types{"Relu", "Sigmoid", "Tanh", "LeakyRelu", "HardSigmoid", "HardSwish"};
   for (auto& activation_op_type : activation_op_types) {
     test_case(activation_op_type);
   }
 }
 
+TEST(NchwcOptimizerTests, ConvAddActivationFusion) {
+  auto test_case = [&](const std::string& activation_op_type, int activation_count) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>({1, 32, 19, 19});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* conv2_output_arg = helper.MakeIntermediate();
+      auto* add_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv1_output_arg, {32, 32, 3, 3});
+      helper.AddConvNode(input_arg, conv2_output_arg, {32, 32, 3, 3});
+      helper.AddNode("Add", {conv1_output_arg, conv2_output_arg}, {add_output_arg});
+      auto& activation_node = helper.AddNode(activation_op_type, {add_output_arg}, {output_arg});
+      if (activation_op_type != "HardSwish") {
+        activation_node.AddAttribute("alpha", 0.25f);
+      }
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], 1);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], 1);
+      EXPECT_EQ(op_to_count["Add"], 0);
+      EXPECT_EQ(op_to_count[activation_op_type], activation_count);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph, 14);
+  };
+
+  // Verify that the activation parameters are passed to the fused convolution
+  // and that HardSwish runs on the NCHWc output of the convolution.
+  test_case("LeakyRelu", 0);
+  test_case("HardSigmoid", 0);
+  test_case("HardSwish", 1);
+}
+
+TEST(NchwcOptimizerTests, ConvSplit) {
+  auto test_case = [&](const std::vector<int64_t>& split, int reorder_input_count, int reorder_output_count) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>({1, 32, 15, 17});
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* split1_output_arg = helper.MakeIntermediate();
+      auto* split2_output_arg = helper.MakeIntermediate();
+
+      helper.AddConvNode(input_arg, conv_output_arg, {64, 32, 3, 3});
+      auto& split_node = helper.AddNode("Split", {conv_output_arg, helper.Make1DInitializer<int64_t>(split)},
+                                        {split1_output_arg, split2_output_arg});
+      split_node.AddAttribute("axis", static_cast<int64_t>(1));
+      helper.AddConvNode(split1_output_arg, helper.MakeOutput(), {32, split[0], 1, 1});
+      helper.AddConvNode(split2_output_arg, helper.MakeOutput(), {32, split[1], 1, 1});
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 3);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], reorder_input_count);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], reorder_output_count);
+      EXPECT_EQ(op_to_count["Split"], 1);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Split along the channel axis with aligned channel counts (stays in NCHWc format).
+  test_case({32, 32}, 1, 2);
+
+  // Split along the channel axis with unaligned channel counts (reorders back to NCHW).
+  test_case({36, 28}, 3, 3);
+}
+
+TEST(NchwcOptimizerTests, ConvSlice) {
+  auto test_case = [&](int64_t start, int64_t end, int reorder_count) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>({1, 32, 15, 17});
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* slice_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv_output_arg, {64, 32, 3, 3});
+      helper.AddNode("Slice",
+                     {conv_output_arg, helper.Make1DInitializer<int64_t>({start}),
+                      helper.Make1DInitializer<int64_t>({end}), helper.Make1DInitializer<int64_t>({1})},
+                     {slice_output_arg});
+      helper.AddConvNode(slice_output_arg, output_arg, {32, 32, 1, 1});
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], reorder_count);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], reorder_count);
+      EXPECT_EQ(op_to_count["Slice"], 1);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Slice along the channel axis with aligned bounds (stays in NCHWc format).
+  test_case(32, 64, 1);
+  test_case(-32, std::numeric_limits<int64_t>::max(), 1);
+
+  // Slice along the channel axis with unaligned bounds (reorders back to NCHW).
+  test_case(4, 36, 2);
+}
+
+TEST(NchwcOptimizerTests, ConvPad) {
+  auto test_case = [&](const std::string& mode, const std::vector<int64_t>& pads, int reorder_count) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>({1, 32, 15, 17});
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* pad_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddConvNode(input_arg, conv_output_arg, {32, 32, 3, 3});
+      auto& pad_node = helper.AddNode("Pad", {conv_output_arg, helper.Make1DInitializer<int64_t>(pads)},
+                                      {pad_output_arg});
+      pad_node.AddAttribute("mode", mode);
+      helper.AddConvNode(pad_output_arg, output_arg, {32, 32 + pads[1] + pads[5], 3, 3});
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 2);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], reorder_count);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], reorder_count);
+      EXPECT_EQ(op_to_count["Pad"], 1);
+      EXPECT_EQ(op_to_count["Reshape"], reorder_count == 1 ? 2 : 0);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph);
+  };
+
+  // Pad the spatial dimensions (stays in NCHWc format). Constant padding would
+  // be fused into the following convolution.
+  test_case("reflect", {0, 0, 1, 2, 0, 0, 2, 1}, 1);
+  test_case("edge", {0, 0, 3, 0, 0, 0, 0, 3}, 1);
+
+  // Pad the channel dimension (reorders back to NCHW).
+  test_case("edge", {0, 4, 1, 1, 0, 4, 1, 1}, 2);
+}
+
 TEST(NchwcOptimizerTests, MaxPoolTypeCheck) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto add_pool_node = [&](NchwcTestHelper& helper, NodeArg* input_arg) {
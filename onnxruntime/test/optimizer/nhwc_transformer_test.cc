@@ -516,6 +516,49 @@ TEST(NhwcTransformerTests, ConvMixTensorRanks) {
                     TransformerLevel::Level3);
 }
 
+TEST(NhwcTransformerTests, ConvMaxPoolFloat) {
+  if (MlasNchwcGetBlockSize() > 1) {
+    GTEST_SKIP() << "Skipping test because the NCHWc transformer handles fp32 convolutions.";
+  }
+
+  auto test_case = [&](const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      const int64_t output_channels = weights_shape[0];
+      std::vector<int64_t> weights2_shape(weights_shape.size(), 1);
+      weights2_shape[0] = 16;
+      weights2_shape[1] = output_channels;
+
+      auto* input_arg = builder.MakeInput<float>(input_shape, -1.5f, 1.5f);
+      auto* conv1_output_arg = builder.MakeIntermediate();
+      auto* pool_output_arg = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+      auto* conv1_weight_arg = builder.MakeInitializer<float>(weights_shape, -0.5f, 0.5f);
+      auto* conv2_weight_arg = builder.MakeInitializer<float>(weights2_shape, -0.5f, 0.5f);
+
+      builder.AddConvNode(input_arg, conv1_weight_arg, conv1_output_arg);
+      Node& pool_node = builder.AddNode("MaxPool", {conv1_output_arg}, {pool_output_arg});
+      pool_node.AddAttribute("pads", std::vector<int64_t>((weights_shape.size() - 2) * 2, 1));
+      pool_node.AddAttribute("kernel_shape", std::vector<int64_t>(weights_shape.size() - 2, 3));
+      builder.AddConvNode(pool_output_arg, conv2_weight_arg, output_arg);
+    };
+
+    auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 2);
+      EXPECT_EQ(op_to_count["com.microsoft.NhwcMaxPool"], 1);
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+    };
+
+    TransformerTester(build_test_case,
+                      check_nhwc_graph,
+                      TransformerLevel::Level2,
+                      TransformerLevel::Level3);
+  };
+
+  test_case({1, 12, 37}, {32, 12, 5});
+  test_case({1, 23, 13, 13}, {30, 23, 3, 3});
+}
+
 #ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
 
 static std::vector<MLFloat16> ARangeOfFP16Values(const std::vector<int64_t>& shape, MLFloat16 min, MLFloat16 max) {
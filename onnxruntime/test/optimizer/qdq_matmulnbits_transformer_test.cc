@@ -511,6 +511,76 @@ TEST(QDQTransformerTests, DQMatMulConvertedToMatMulNBits_Cuda) {
   RunDQMatMulConverted<UInt4x2, false>({12, 12}, {12, 37}, {37, 12}, 0, 16, 1, DefaultCudaExecutionProvider());
 }
 
+//  Input1
+//    |      DQ   (bias)
+//     \    /    /
+//       Gemm
+//        |
+//      output
+template <typename T, bool use_zp>
+typename std::enable_if<std::is_same_v<T, Int4x2> || std::is_same_v<T, UInt4x2>, void>::type
+RunDQGemm(const std::vector<int64_t>& input1_shape,
+          const std::vector<int64_t>& weight_shape,
+          const int64_t block_size,
+          bool use_bias,
+          int64_t trans_b,
+          bool expect_converted) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput(input1_shape, -100.0f, 100.0f);
+    auto* output_arg = builder.MakeOutput();
+
+    // the blocks of a transposed B along axis 0 run along N, so transB must keep the Gemm as it is
+    const int64_t axis = 0;
+    NodeAttributes dq_attrs;
+    utils::SetNodeAttribute(utils::MakeAttribute("axis", axis), dq_attrs);
+    utils::SetNodeAttribute(utils::MakeAttribute("block_size", block_size), dq_attrs);
+    auto scale_shape = std::vector<int64_t>{weight_shape};
+    scale_shape[axis] = (scale_shape[axis] + block_size - 1) / block_size;
+
+    auto* weight_arg = builder.MakeInitializer(weight_shape, T(T::min_val, 0), T(T::max_val, 0));
+    auto* scales_arg = builder.MakeInitializer(scale_shape, 8.0f, 12.0f);
+    auto* dq_output = builder.MakeIntermediate();
+    if constexpr (use_zp) {
+      auto* zp_arg = builder.MakeInitializer(scale_shape, T(0, 0), T(2, 0));
+      builder.AddNode("DequantizeLinear", {weight_arg, scales_arg, zp_arg}, {dq_output}, "", &dq_attrs);
+    } else {
+      builder.AddNode("DequantizeLinear", {weight_arg, scales_arg}, {dq_output}, "", &dq_attrs);
+    }
+
+    std::vector<NodeArg*> gemm_inputs{input_arg, dq_output};
+    if (use_bias) {
+      gemm_inputs.push_back(builder.MakeInitializer<float>({weight_shape[trans_b ? 0 : 1]}, -1.0f, 1.0f));
+    }
+    auto& gemm = builder.AddNode("Gemm", gemm_inputs, {output_arg});
+    gemm.AddAttribute("transB", trans_b);
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    const QDQOpKeys qdq_keys = GetQDQOpKeys(false);
+    EXPECT_EQ(op_to_count["Gemm"], expect_converted ? 0 : 1);
+    EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], expect_converted ? 1 : 0);
+    EXPECT_EQ(op_to_count[qdq_keys.dequantize_linear], expect_converted ? 0 : 1);
+  };
+
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level1,
+                    TransformerLevel::Level2,
+                    21 /*opset_version*/,
+                    1e-5 /*per_sample_tolerance*/,
+                    2e-5 /*relative_per_sample_tolerance*/);
+}
+
+TEST(QDQTransformerTests, DQGemmConvertedToMatMulNBits) {
+  RunDQGemm<Int4x2, true>({12, 37}, {37, 12}, 16, false, 0, true);
+  RunDQGemm<Int4x2, false>({12, 37}, {37, 12}, 16, true, 0, true);
+  RunDQGemm<UInt4x2, true>({12, 37}, {37, 12}, 16, true, 0, true);
+  RunDQGemm<UInt4x2, false>({12, 37}, {37, 12}, 32, false, 0, true);
+  // MatMulNBits has no transposed B
+  RunDQGemm<Int4x2, true>({12, 37}, {12, 37}, 16, false, 1, false);
+}
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
 
 }  // namespace test
@@ -2707,6 +2707,60 @@ TEST(QDQTransformerTests, Sigmoid_U8S8) {
   QDQTransformerSigmoidTests<uint8_t, int8_t>();
 }
 
+template <typename QuantType>
+void QDQTransformerGeluTests() {
+  auto test_case = [&](const std::vector<int64_t>& input_shape, bool use_contrib_gelu, const std::string& approximate) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>(input_shape, -3.f, 3.f);
+      auto* output_arg = builder.MakeOutput();
+      // add QDQ + Gelu
+      auto* dq_output = AddQDQNodePair<QuantType>(builder, input_arg, .025f, std::numeric_limits<QuantType>::max() / 2);
+      auto* gelu_output = builder.MakeIntermediate();
+      if (use_contrib_gelu) {
+        builder.AddNode("Gelu", {dq_output}, {gelu_output}, kMSDomain);
+      } else {
+        builder.AddNode("Gelu", {dq_output}, {gelu_output}).AddAttribute("approximate", approximate);
+      }
+
+      // add QDQ output
+      auto* q_output = builder.MakeIntermediate();
+      builder.AddQuantizeLinearNode<QuantType>(gelu_output, .02f, std::numeric_limits<QuantType>::min() / 4, q_output);
+      builder.AddDequantizeLinearNode<QuantType>(q_output, .02f, std::numeric_limits<QuantType>::min() / 4,
+                                                 output_arg);
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.QLinearGelu"], 1);
+      EXPECT_EQ(op_to_count["Gelu"], 0);
+      EXPECT_EQ(op_to_count["com.microsoft.Gelu"], 0);
+      EXPECT_EQ(op_to_count["QuantizeLinear"], 1);
+      EXPECT_EQ(op_to_count["DequantizeLinear"], 1);
+    };
+
+    TransformerTester(build_test_case,
+                      check_graph,
+                      TransformerLevel::Level1,
+                      TransformerLevel::Level2,
+                      20 /*opset_version*/,
+                      0.02 /*per_sample_tolerance*/,
+                      0.02 /*relative_per_sample_tolerance*/,
+                      std::make_unique<QDQSelectorActionTransformer>(QDQIsInt8Allowed()));
+  };
+
+  test_case({1, 12, 37}, false, "none");
+  test_case({1, 12, 37}, false, "tanh");
+  test_case({1, 23, 13, 13}, true, "none");
+}
+
+TEST(QDQTransformerTests, Gelu_S8S8) {
+  QDQTransformerGeluTests<int8_t>();
+}
+
+TEST(QDQTransformerTests, Gelu_U8U8) {
+  QDQTransformerGeluTests<uint8_t>();
+}
+
 TEST(QDQTransformerTests, ConvTranspose_QBackward) {
   auto test_case = [&](const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape,
                        const std::vector<int64_t>& perms, bool use_contrib_qdq) {
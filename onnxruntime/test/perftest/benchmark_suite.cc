@@ -0,0 +1,308 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "benchmark_suite.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <utility>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "nlohmann/json.hpp"
+
+#include "command_args_parser.h"
+#include "performance_runner.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+namespace {
+
+double Median(std::vector<double> values) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  const size_t n = values.size();
+  return n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+double Percentile(const std::vector<double>& sorted_values, double fraction) {
+  if (sorted_values.empty()) {
+    return 0.0;
+  }
+  const size_t n = std::min(static_cast<size_t>(sorted_values.size() * fraction), sorted_values.size() - 1);
+  return sorted_values[n];
+}
+
+// Two sided p-value of the Mann-Whitney U test that the samples come from the same distribution, with the normal
+// approximation corrected for ties. Unlike a t-test it makes no assumption on the distribution, which for latencies
+// is skewed and often multimodal. The approximation needs about 20 values in each sample.
+double MannWhitneyPValue(const std::vector<double>& a, const std::vector<double>& b) {
+  const double n1 = static_cast<double>(a.size());
+  const double n2 = static_cast<double>(b.size());
+  if (a.empty() || b.empty()) {
+    return 1.0;
+  }
+
+  std::vector<std::pair<double, bool>> values;  // value, is from a
+  values.reserve(a.size() + b.size());
+  for (double v : a) values.emplace_back(v, true);
+  for (double v : b) values.emplace_back(v, false);
+  std::sort(values.begin(), values.end());
+
+  // equal values share the average of their ranks
+  double rank_sum_a = 0.0;
+  double ties = 0.0;
+  for (size_t i = 0; i < values.size();) {
+    size_t j = i;
+    while (j < values.size() && values[j].first == values[i].first) {
+      ++j;
+    }
+    const double rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2;
+    for (size_t k = i; k < j; ++k) {
+      if (values[k].second) {
+        rank_sum_a += rank;
+      }
+    }
+    const double t = static_cast<double>(j - i);
+    ties += t * t * t - t;
+    i = j;
+  }
+
+  const double n = n1 + n2;
+  const double u = rank_sum_a - n1 * (n1 + 1) / 2;
+  const double mean = n1 * n2 / 2;
+  const double variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+  if (variance <= 0) {
+    return 1.0;
+  }
+
+  // continuity correction
+  const double z = std::max(std::abs(u - mean) - 0.5, 0.0) / std::sqrt(variance);
+  return std::erfc(z / std::sqrt(2.0));
+}
+
+std::vector<double> GetLatencies(const nlohmann::json& benchmark) {
+  std::vector<double> latencies;
+  auto it = benchmark.find("latencies_ms");
+  if (it != benchmark.end() && it->is_array()) {
+    for (const auto& latency : *it) {
+      latencies.push_back(latency.get<double>());
+    }
+  }
+  return latencies;
+}
+
+}  // namespace
+
+Status BenchmarkSuite::Load(const std::basic_string<ORTCHAR_T>& manifest_path,
+                            const PerformanceTestConfig& default_config) {
+  std::ifstream manifest_file(manifest_path);
+  ORT_RETURN_IF_NOT(manifest_file, "Failed to open the suite manifest ", PathToUTF8String(manifest_path));
+  nlohmann::json manifest = nlohmann::json::parse(manifest_file, nullptr, /*allow_exceptions*/ false);
+  ORT_RETURN_IF(manifest.is_discarded() || !manifest.is_object(), "The suite manifest is not a json object");
+  ORT_RETURN_IF_NOT(manifest.contains("benchmarks") && manifest["benchmarks"].is_array(),
+                    "The suite manifest has no benchmarks array");
+
+  const std::filesystem::path manifest_dir = std::filesystem::path(manifest_path).parent_path();
+  Status status;
+  ORT_TRY {
+    significance_level_ = manifest.value("significance_level", significance_level_);
+    regression_threshold_ = manifest.value("regression_threshold", regression_threshold_);
+    const size_t default_warmup_runs = manifest.value("warmup_runs", size_t{10});
+    const size_t default_repetitions = manifest.value("repetitions", default_config.run_config.repeated_times);
+
+    for (const auto& entry : manifest["benchmarks"]) {
+      Benchmark benchmark;
+      benchmark.config = default_config;
+      auto& model_info = benchmark.config.model_info;
+      auto& run_config = benchmark.config.run_config;
+
+      const std::string model = entry.at("model").get<std::string>();
+      benchmark.name = entry.value("name", model);
+      model_info.model_file_path = (manifest_dir / std::filesystem::path(ToPathString(model))).native();
+      model_info.result_file_path.clear();
+
+      std::string provider = entry.value("provider", std::string("cpu"));
+      ORT_RETURN_IF_NOT(
+          CommandLineParser::ParseExecutionProvider(provider, benchmark.config.machine_config.provider_type_name),
+          "Unknown provider '", provider, "' in benchmark ", benchmark.name);
+      if (entry.contains("provider_options")) {
+        run_config.ep_runtime_config_string = ToPathString(entry["provider_options"].get<std::string>());
+      }
+
+      run_config.intra_op_num_threads = entry.value("intra_op_num_threads", run_config.intra_op_num_threads);
+      run_config.inter_op_num_threads = entry.value("inter_op_num_threads", run_config.inter_op_num_threads);
+      run_config.concurrent_session_runs = entry.value("concurrent_runs", run_config.concurrent_session_runs);
+      run_config.generate_model_input_binding =
+          entry.value("generate_inputs", run_config.generate_model_input_binding);
+      if (entry.contains("session_config")) {
+        for (const auto& config : entry["session_config"].items()) {
+          run_config.session_config_entries[config.key()] = config.value().get<std::string>();
+        }
+      }
+      if (entry.contains("free_dimension_overrides")) {
+        for (const auto& dim : entry["free_dimension_overrides"].items()) {
+          run_config.free_dim_name_overrides[ToPathString(dim.key())] = dim.value().get<int64_t>();
+        }
+      }
+
+      run_config.warmup_runs = entry.value("warmup_runs", default_warmup_runs);
+      run_config.test_mode = TestMode::KFixRepeatedTimesMode;
+      run_config.repeated_times = entry.value("repetitions", default_repetitions);
+      run_config.target_qps = 0;
+      run_config.f_dump_statistics = false;
+      ORT_RETURN_IF(run_config.repeated_times == 0, "Benchmark ", benchmark.name, " has no repetitions");
+
+      benchmarks_.push_back(std::move(benchmark));
+    }
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid suite manifest: ", ex.what());
+    });
+  }
+  return status;
+}
+
+Status BenchmarkSuite::Run(Ort::Env& env) {
+  for (const auto& benchmark : benchmarks_) {
+    std::cout << "\nBenchmark: " << benchmark.name << std::endl;
+
+    std::random_device rd;
+    PerformanceRunner perf_runner(env, benchmark.config, rd);
+    auto status = perf_runner.Run();
+    if (!status.IsOK()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Benchmark ", benchmark.name, " failed: ", status.ErrorMessage());
+    }
+
+    const auto& performance_result = perf_runner.GetResult();
+    Result result;
+    result.name = benchmark.name;
+    result.provider = benchmark.config.machine_config.provider_type_name;
+    result.intra_op_num_threads = benchmark.config.run_config.intra_op_num_threads;
+    result.concurrent_session_runs = benchmark.config.run_config.concurrent_session_runs;
+    result.session_creation_ms = perf_runner.GetSessionCreationTime() * 1000;
+    result.first_inference_ms = perf_runner.GetFirstInferenceTime() * 1000;
+    result.peak_working_set_bytes = performance_result.peak_workingset_size;
+    result.latencies_ms.reserve(performance_result.time_costs.size());
+    for (double time_cost : performance_result.time_costs) {
+      result.latencies_ms.push_back(time_cost * 1000);
+    }
+    results_.push_back(std::move(result));
+  }
+  return Status::OK();
+}
+
+Status BenchmarkSuite::WriteResults(const std::basic_string<ORTCHAR_T>& path, std::ostream& os) const {
+  nlohmann::json benchmarks = nlohmann::json::array();
+  for (const auto& result : results_) {
+    std::vector<double> sorted = result.latencies_ms;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0;
+    for (double latency : sorted) {
+      total += latency;
+    }
+
+    nlohmann::json benchmark;
+    benchmark["name"] = result.name;
+    benchmark["provider"] = result.provider;
+    benchmark["intra_op_num_threads"] = result.intra_op_num_threads;
+    benchmark["concurrent_runs"] = result.concurrent_session_runs;
+    benchmark["session_creation_ms"] = result.session_creation_ms;
+    benchmark["first_inference_ms"] = result.first_inference_ms;
+    // the peak of the process, so it includes the benchmarks that ran before
+    benchmark["peak_working_set_bytes"] = result.peak_working_set_bytes;
+    benchmark["runs"] = sorted.size();
+    benchmark["mean_ms"] = sorted.empty() ? 0.0 : total / static_cast<double>(sorted.size());
+    benchmark["min_ms"] = sorted.empty() ? 0.0 : sorted.front();
+    benchmark["max_ms"] = sorted.empty() ? 0.0 : sorted.back();
+    benchmark["p50_ms"] = Percentile(sorted, 0.5);
+    benchmark["p90_ms"] = Percentile(sorted, 0.9);
+    benchmark["p95_ms"] = Percentile(sorted, 0.95);
+    benchmark["p99_ms"] = Percentile(sorted, 0.99);
+    // kept so later runs can test the significance of the differences
+    benchmark["latencies_ms"] = result.latencies_ms;
+    benchmarks.push_back(std::move(benchmark));
+  }
+
+  nlohmann::json results;
+  results["ort_version"] = OrtGetApiBase()->GetVersionString();
+  results["benchmarks"] = std::move(benchmarks);
+
+  if (path.empty()) {
+    os << results.dump(2) << std::endl;
+    return Status::OK();
+  }
+
+  std::ofstream file(path);
+  ORT_RETURN_IF_NOT(file, "Failed to open the results file ", PathToUTF8String(path));
+  file << results.dump(2) << std::endl;
+  return Status::OK();
+}
+
+Status BenchmarkSuite::CompareWithBaseline(const std::basic_string<ORTCHAR_T>& baseline_path, std::ostream& os,
+                                           bool& regressed) const {
+  regressed = false;
+  std::ifstream baseline_file(baseline_path);
+  ORT_RETURN_IF_NOT(baseline_file, "Failed to open the baseline ", PathToUTF8String(baseline_path));
+  nlohmann::json baseline = nlohmann::json::parse(baseline_file, nullptr, /*allow_exceptions*/ false);
+  ORT_RETURN_IF(baseline.is_discarded() || !baseline.contains("benchmarks") || !baseline["benchmarks"].is_array(),
+                "The baseline is not the results of a suite run");
+
+  std::map<std::string, const nlohmann::json*> baseline_benchmarks;
+  for (const auto& benchmark : baseline["benchmarks"]) {
+    if (benchmark.contains("name") && benchmark["name"].is_string()) {
+      baseline_benchmarks[benchmark["name"].get<std::string>()] = &benchmark;
+    }
+  }
+
+  os << "\nComparison with " << PathToUTF8String(baseline_path);
+  if (baseline.contains("ort_version") && baseline["ort_version"].is_string()) {
+    os << " (ORT " << baseline["ort_version"].get<std::string>() << ")";
+  }
+  os << ", significance level " << significance_level_ << ", regression threshold "
+     << regression_threshold_ * 100 << "%:\n"
+     << "name,baseline_p50_ms,p50_ms,change,p_value,baseline_session_creation_ms,session_creation_ms,verdict\n";
+
+  os << std::fixed << std::setprecision(3);
+  for (const auto& result : results_) {
+    auto it = baseline_benchmarks.find(result.name);
+    if (it == baseline_benchmarks.end()) {
+      os << result.name << ",,,,,,,new\n";
+      continue;
+    }
+
+    const auto& baseline_benchmark = *it->second;
+    const std::vector<double> baseline_latencies = GetLatencies(baseline_benchmark);
+    const double baseline_median = Median(baseline_latencies);
+    const double median = Median(result.latencies_ms);
+    const double change = baseline_median > 0 ? (median - baseline_median) / baseline_median : 0.0;
+    const double p_value = MannWhitneyPValue(baseline_latencies, result.latencies_ms);
+
+    const char* verdict = "unchanged";
+    if (p_value < significance_level_ && change > regression_threshold_) {
+      verdict = "regression";
+      regressed = true;
+    } else if (p_value < significance_level_ && change < -regression_threshold_) {
+      verdict = "improvement";
+    }
+
+    os << result.name << "," << baseline_median << "," << median << "," << change * 100 << "%," << p_value << ","
+       << baseline_benchmark.value("session_creation_ms", 0.0) << "," << result.session_creation_ms << ","
+       << verdict << "\n";
+  }
+  os << std::flush;
+  return Status::OK();
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <core/common/status.h>
+#include <core/session/onnxruntime_cxx_api.h>
+
+#include "test_configuration.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+// Runs the benchmarks listed in a json manifest, each a model with its own execution provider, threads and session
+// configuration, and writes their latencies, session creation time and memory as json. The results can be compared
+// with those of an earlier run, e.g. with the previous ORT release, to catch performance regressions.
+class BenchmarkSuite {
+ public:
+  // Reads the manifest. The options of the command line are the defaults of every benchmark, and model paths are
+  // relative to the directory of the manifest.
+  Status Load(const std::basic_string<ORTCHAR_T>& manifest_path, const PerformanceTestConfig& default_config);
+
+  // Runs every benchmark in turn, each with a new session.
+  Status Run(Ort::Env& env);
+
+  // Writes the results as json to the file, or to the stream if the path is empty.
+  Status WriteResults(const std::basic_string<ORTCHAR_T>& path, std::ostream& os) const;
+
+  // Compares the latencies of every benchmark with the ones of the same name in the results of an earlier run, and
+  // prints one line per benchmark. A benchmark regressed if its latencies are significantly different (two sided
+  // Mann-Whitney U test) and its median is slower by more than the regression threshold of the manifest.
+  Status CompareWithBaseline(const std::basic_string<ORTCHAR_T>& baseline_path, std::ostream& os,
+                             bool& regressed) const;
+
+ private:
+  struct Benchmark {
+    std::string name;
+    PerformanceTestConfig config;
+  };
+
+  struct Result {
+    std::string name;
+    std::string provider;
+    int intra_op_num_threads{0};
+    size_t concurrent_session_runs{1};
+    double session_creation_ms{0};
+    double first_inference_ms{0};
+    size_t peak_working_set_bytes{0};
+    std::vector<double> latencies_ms;
+  };
+
+  std::vector<Benchmark> benchmarks_;
+  std::vector<Result> results_;
+  double significance_level_{0.01};
+  double regression_threshold_{0.05};
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -8,8 +8,10 @@
 #include <string.h>
 #include <iostream>
 #include <sstream>
+#include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 // Windows Specific
 #ifdef _WIN32
@@ -32,6 +34,7 @@ namespace perftest {
 /*static*/ void CommandLineParser::ShowUsage() {
   printf(
       "perf_test [options...] model_path [result_file]\n"
+      "perf_test [options...] -J suite_manifest [-H baseline_results] [result_file]\n"
       "Options:\n"
       "\t-m [test_mode]: Specifies the test mode. Value could be 'duration' or 'times'.\n"
       "\t\tProvide 'duration' to run the test for a fix duration, and 'times' to repeated for a certain times. \n"
@@ -102,6 +105,7 @@ namespace perftest {
       "\t    [QNN only] [offload_graph_io_quantization]: Offload graph input quantization and graph output dequantization to another EP (typically CPU EP). \n"
       "\t    Defaults to '0' (QNN EP handles the graph I/O quantization and dequantization). \n"
       "\t    [QNN only] [enable_htp_spill_fill_buffer]: Enable HTP spill file buffer, used while generating QNN context binary."
+      "\t    [QNN only] [enable_async_execution]: Execute the QNN graphs asynchronously so that concurrent runs overlap. Defaults to '0'. \n"
       "\t    [Example] [For QNN EP] -e qnn -i \"backend_path|/folderpath/libQnnCpu.so\" \n"
       "\n"
       "\t    [TensorRT only] [trt_max_partition_iterations]: Maximum iterations for TensorRT parser to get capability.\n"
@@ -157,6 +161,26 @@ namespace perftest {
       "\t-n [Exit after session creation]: allow user to measure session creation time to measure impact of enabling any initialization optimizations.\n"
       "\t-l Provide file as binary in memory by using fopen before session creation.\n"
       "\t-R [Register custom op]: allow user to register custom op by .so or .dll file.\n"
+      "\t-Q [target_qps]: Generate an open-loop load of target_qps requests per second instead of running requests back to back.\n"
+      "\t\t Requests are issued on schedule regardless of when earlier requests complete, and at most [parallel runs] (-c) of them\n"
+      "\t\t run at once. Latency is measured from the scheduled arrival, so it includes queueing delay. The test runs for\n"
+      "\t\t [seconds_to_run] (-t) in 'duration' mode, or issues [repeated_times] (-r) requests in 'times' mode.\n"
+      "\t-W [poisson|constant]: Arrival process used with -Q. 'poisson' draws exponential inter-arrival times, 'constant' issues\n"
+      "\t\t requests at a fixed interval. Default:'poisson'.\n"
+      "\t-X [intra_op_num_threads list]: Sweep intra_op_num_threads over a comma separated list of values, e.g. -X 1,2,4.\n"
+      "\t-K [parallel runs list]: Sweep the number of parallel runs over a comma separated list of values, e.g. -K 1,4,16.\n"
+      "\t\t A new session is tested for every combination of the -X and -K values, and a summary table is printed at the end.\n"
+      "\t-B [cold_start_runs]: Create and run a new session cold_start_runs times, and report the time spent in each phase of\n"
+      "\t\t session creation (model parse, every graph transformer, partitioning, initializer loading, kernel creation,\n"
+      "\t\t prepacking) and in the first run. The phases are read from the session profile, which is kept if -p is given.\n"
+      "\t\t The sessions share one environment; start the tool repeatedly to include process start up.\n"
+      "\t-G: Drop the page cache of the model before every session is created. Evicts every clean page when run as root on\n"
+      "\t\t Linux, otherwise only the pages of the model file.\n"
+      "\t-J [suite_manifest]: Run the benchmarks listed in a json manifest instead of a single model, and write the results as\n"
+      "\t\t json to result_file (or print them). Every benchmark names a model and its provider, threads, session\n"
+      "\t\t configuration, warmup runs and repetitions. See README.md for the format.\n"
+      "\t-H [baseline_results]: With -J, compare the latencies with the results of an earlier suite run using a Mann-Whitney\n"
+      "\t\t U test, and exit with an error if a benchmark is significantly slower than the regression threshold.\n"
       "\t-h: help\n");
 }
 #ifdef _WIN32
@@ -184,9 +208,58 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
   return true;
 }
 
+/*static*/ bool CommandLineParser::ParseExecutionProvider(const std::string& name, std::string& provider_type_name) {
+  static const std::unordered_map<std::string_view, const char*> providers = {
+      {"cpu", onnxruntime::kCpuExecutionProvider},
+      {"cuda", onnxruntime::kCudaExecutionProvider},
+      {"dnnl", onnxruntime::kDnnlExecutionProvider},
+      {"openvino", onnxruntime::kOpenVINOExecutionProvider},
+      {"tensorrt", onnxruntime::kTensorrtExecutionProvider},
+      {"qnn", onnxruntime::kQnnExecutionProvider},
+      {"snpe", onnxruntime::kSnpeExecutionProvider},
+      {"nnapi", onnxruntime::kNnapiExecutionProvider},
+      {"vsinpu", onnxruntime::kVSINPUExecutionProvider},
+      {"coreml", onnxruntime::kCoreMLExecutionProvider},
+      {"dml", onnxruntime::kDmlExecutionProvider},
+      {"acl", onnxruntime::kAclExecutionProvider},
+      {"armnn", onnxruntime::kArmNNExecutionProvider},
+      {"rocm", onnxruntime::kRocmExecutionProvider},
+      {"migraphx", onnxruntime::kMIGraphXExecutionProvider},
+      {"xnnpack", onnxruntime::kXnnpackExecutionProvider},
+      {"vitisai", onnxruntime::kVitisAIExecutionProvider},
+      {"webgpu", onnxruntime::kWebGpuExecutionProvider},
+  };
+
+  auto it = providers.find(name);
+  if (it == providers.end()) {
+    return false;
+  }
+  provider_type_name = it->second;
+  return true;
+}
+
+template <typename T>
+static bool ParseSweepValues(const ORTCHAR_T* str, T min_value, std::vector<T>& values) {
+  std::stringstream ss(ToUTF8String(str));
+  std::string token;
+  while (std::getline(ss, token, ',')) {
+    ORT_TRY {
+      long long value = std::stoll(token);
+      if (value < static_cast<long long>(min_value)) {
+        return false;
+      }
+      values.push_back(static_cast<T>(value));
+    }
+    ORT_CATCH(...) {
+      return false;
+    }
+  }
+  return !values.empty();
+}
+
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPIDZvhsqznlR:"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:Q:W:X:K:B:J:H:AMPIDZGvhsqznlR:"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -225,43 +298,7 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
         test_config.run_config.enable_cpu_mem_arena = false;
         break;
       case 'e':
-        if (!CompareCString(optarg, ORT_TSTR("cpu"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kCpuExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("cuda"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kCudaExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("dnnl"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kDnnlExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("openvino"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kOpenVINOExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("tensorrt"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kTensorrtExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("qnn"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kQnnExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("snpe"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kSnpeExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("nnapi"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kNnapiExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("vsinpu"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kVSINPUExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("coreml"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kCoreMLExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("dml"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kDmlExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("acl"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kAclExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("armnn"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kArmNNExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("rocm"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kRocmExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("migraphx"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kMIGraphXExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("xnnpack"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kXnnpackExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("vitisai"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kVitisAIExecutionProvider;
-        } else if (!CompareCString(optarg, ORT_TSTR("webgpu"))) {
-          test_config.machine_config.provider_type_name = onnxruntime::kWebGpuExecutionProvider;
-        } else {
+        if (!ParseExecutionProvider(ToUTF8String(optarg), test_config.machine_config.provider_type_name)) {
           return false;
         }
         break;
@@ -384,6 +421,51 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
       case 'R':
         test_config.run_config.register_custom_op_path = optarg;
         break;
+      case 'Q':
+        ORT_TRY {
+          test_config.run_config.target_qps = std::stod(ToUTF8String(optarg));
+        }
+        ORT_CATCH(...) {
+          return false;
+        }
+        if (test_config.run_config.target_qps <= 0) {
+          return false;
+        }
+        break;
+      case 'W':
+        if (!CompareCString(optarg, ORT_TSTR("poisson"))) {
+          test_config.run_config.poisson_arrivals = true;
+        } else if (!CompareCString(optarg, ORT_TSTR("constant"))) {
+          test_config.run_config.poisson_arrivals = false;
+        } else {
+          return false;
+        }
+        break;
+      case 'X':
+        if (!ParseSweepValues<int>(optarg, 0, test_config.run_config.sweep_intra_op_num_threads)) {
+          return false;
+        }
+        break;
+      case 'B':
+        test_config.run_config.cold_start_runs = static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
+        if (test_config.run_config.cold_start_runs <= 0) {
+          return false;
+        }
+        break;
+      case 'G':
+        test_config.run_config.drop_page_cache = true;
+        break;
+      case 'K':
+        if (!ParseSweepValues<size_t>(optarg, 1, test_config.run_config.sweep_concurrent_session_runs)) {
+          return false;
+        }
+        break;
+      case 'J':
+        test_config.run_config.suite_manifest_path = optarg;
+        break;
+      case 'H':
+        test_config.run_config.suite_baseline_path = optarg;
+        break;
       case '?':
       case 'h':
       default:
@@ -395,6 +477,20 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
   argc -= optind;
   argv += optind;
 
+  // the suite mode takes the models from the manifest, and writes its results to the optional result_file
+  if (!test_config.run_config.suite_manifest_path.empty()) {
+    if (argc > 1) {
+      return false;
+    }
+    if (argc == 1) {
+      test_config.model_info.result_file_path = argv[0];
+    }
+    return true;
+  }
+  if (!test_config.run_config.suite_baseline_path.empty()) {
+    return false;
+  }
+
   switch (argc) {
     case 2:
       test_config.model_info.result_file_path = argv[1];
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <string>
+
 #include <core/session/onnxruntime_c_api.h>
 
 namespace onnxruntime {
@@ -13,6 +15,9 @@ class CommandLineParser {
  public:
   static void ShowUsage();
   static bool ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]);
+
+  // Maps the name of an execution provider given to -e, e.g. "cuda", to its provider type.
+  static bool ParseExecutionProvider(const std::string& name, std::string& provider_type_name);
 };
 
 }  // namespace perftest
@@ -3,14 +3,147 @@
 
 // onnxruntime dependencies
 #include <core/session/onnxruntime_c_api.h>
+#include <cstdio>
+#include <iostream>
 #include <random>
+#include <sstream>
+#include <vector>
+#include "benchmark_suite.h"
 #include "command_args_parser.h"
 #include "performance_runner.h"
+#include "session_creation_breakdown.h"
 #include <google/protobuf/stubs/common.h>
 
 using namespace onnxruntime;
 const OrtApi* g_ort = NULL;
 
+// Creates and runs a new session cold_start_runs times, and reports how long each phase of the session creation took
+// from the session events of the profiler.
+static int RunColdStarts(Ort::Env& env, const perftest::PerformanceTestConfig& test_config) {
+  const auto& run_config = test_config.run_config;
+  // the profiles are only kept if the user asked for them
+  const bool keep_profiles = !run_config.profile_file.empty();
+  perftest::SessionCreationBreakdown breakdown;
+
+  for (size_t i = 0; i < run_config.cold_start_runs; ++i) {
+    perftest::PerformanceTestConfig config = test_config;
+    if (!keep_profiles) {
+      config.run_config.profile_file = ORT_TSTR("onnxruntime_perf_test_cold_start");
+    }
+
+    std::random_device rd;
+    perftest::PerformanceRunner perf_runner(env, config, rd);
+    auto status = perf_runner.RunFirstInference();
+    if (!status.IsOK()) {
+      printf("Run failed:%s\n", status.ErrorMessage().c_str());
+      return -1;
+    }
+
+    std::string profile_file = perf_runner.EndProfiling();
+    status = breakdown.AddRun(profile_file, perf_runner.GetSessionCreationTime(), perf_runner.GetFirstInferenceTime());
+    if (!keep_profiles) {
+      std::remove(profile_file.c_str());
+    }
+    if (!status.IsOK()) {
+      printf("Run failed:%s\n", status.ErrorMessage().c_str());
+      return -1;
+    }
+
+    std::cout << "cold start:" << i << ","
+              << "session_creation_time_cost:" << perf_runner.GetSessionCreationTime() << ","
+              << "first_inference_time_cost:" << perf_runner.GetFirstInferenceTime() << std::endl;
+  }
+
+  breakdown.Print(std::cout);
+  return 0;
+}
+
+// Tests a new session for every combination of the sweep values, and prints a CSV summary with one line per
+// combination once all of them have run.
+static int RunSweep(Ort::Env& env, const perftest::PerformanceTestConfig& test_config) {
+  const auto& run_config = test_config.run_config;
+  std::vector<int> intra_op_values = run_config.sweep_intra_op_num_threads;
+  if (intra_op_values.empty()) {
+    intra_op_values.push_back(run_config.intra_op_num_threads);
+  }
+  std::vector<size_t> concurrency_values = run_config.sweep_concurrent_session_runs;
+  if (concurrency_values.empty()) {
+    concurrency_values.push_back(run_config.concurrent_session_runs);
+  }
+
+  std::ostringstream summary;
+  summary << "intra_op_num_threads,concurrent_session_runs,requests,requests_per_second,"
+          << "p50_ms,p90_ms,p99_ms,p999_ms,avg_cpu_usage\n";
+
+  for (int intra_op_num_threads : intra_op_values) {
+    for (size_t concurrent_session_runs : concurrency_values) {
+      perftest::PerformanceTestConfig config = test_config;
+      config.run_config.intra_op_num_threads = intra_op_num_threads;
+      config.run_config.concurrent_session_runs = concurrent_session_runs;
+
+      std::cout << "\nintra_op_num_threads:" << intra_op_num_threads
+                << " concurrent_session_runs:" << concurrent_session_runs << std::endl;
+
+      std::random_device rd;
+      perftest::PerformanceRunner perf_runner(env, config, rd);
+      if (run_config.exit_after_session_creation) {
+        perf_runner.LogSessionCreationTime();
+        continue;
+      }
+
+      auto status = perf_runner.Run();
+      if (!status.IsOK()) {
+        printf("Run failed:%s\n", status.ErrorMessage().c_str());
+        return -1;
+      }
+
+      perf_runner.SerializeResult();
+
+      const auto& result = perf_runner.GetResult();
+      std::chrono::duration<double> run_time = result.end - result.start;
+      summary << intra_op_num_threads << "," << concurrent_session_runs << "," << result.time_costs.size() << ","
+              << result.time_costs.size() / run_time.count() << ","
+              << result.GetLatencyPercentile(0.5) * 1000 << "," << result.GetLatencyPercentile(0.9) * 1000 << ","
+              << result.GetLatencyPercentile(0.99) * 1000 << "," << result.GetLatencyPercentile(0.999) * 1000 << ","
+              << result.average_CPU_usage << "\n";
+    }
+  }
+
+  if (!run_config.exit_after_session_creation) {
+    std::cout << "\nSweep summary:\n"
+              << summary.str() << std::flush;
+  }
+
+  return 0;
+}
+
+// Runs the benchmarks of the suite manifest, writes their results and compares them with the baseline if one is given.
+// Fails if a benchmark failed or regressed.
+static int RunSuite(Ort::Env& env, const perftest::PerformanceTestConfig& test_config) {
+  const auto& run_config = test_config.run_config;
+  perftest::BenchmarkSuite suite;
+  auto status = suite.Load(run_config.suite_manifest_path, test_config);
+  if (status.IsOK()) {
+    status = suite.Run(env);
+  }
+  if (status.IsOK()) {
+    status = suite.WriteResults(test_config.model_info.result_file_path, std::cout);
+  }
+  bool regressed = false;
+  if (status.IsOK() && !run_config.suite_baseline_path.empty()) {
+    status = suite.CompareWithBaseline(run_config.suite_baseline_path, std::cout, regressed);
+  }
+  if (!status.IsOK()) {
+    printf("Run failed:%s\n", status.ErrorMessage().c_str());
+    return -1;
+  }
+  if (regressed) {
+    printf("Performance regression detected\n");
+    return 1;
+  }
+  return 0;
+}
+
 #ifdef _WIN32
 int real_main(int argc, wchar_t* argv[]) {
 #else
@@ -41,6 +174,19 @@ int real_main(int argc, char* argv[]) {
     if (failed)
       return -1;
   }
+  if (!test_config.run_config.suite_manifest_path.empty()) {
+    return RunSuite(env, test_config);
+  }
+
+  if (test_config.run_config.cold_start_runs > 0) {
+    return RunColdStarts(env, test_config);
+  }
+
+  if (!test_config.run_config.sweep_intra_op_num_threads.empty() ||
+      !test_config.run_config.sweep_concurrent_session_runs.empty()) {
+    return RunSweep(env, test_config);
+  }
+
   std::random_device rd;
   perftest::PerformanceRunner perf_runner(env, test_config, rd);
 
@@ -27,6 +27,11 @@ class OnnxRuntimeTestSession : public TestSession {
 
   bool PopulateGeneratedInputTestData(int32_t seed);
 
+  // Stops profiling and returns the name of the profile file.
+  std::string EndProfiling() {
+    return session_.EndProfilingAllocated(allocator_).get();
+  }
+
   ~OnnxRuntimeTestSession() = default;
 
   std::chrono::duration<double> Run() override;
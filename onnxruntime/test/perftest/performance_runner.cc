@@ -8,6 +8,7 @@
 
 #include "performance_runner.h"
 #include <iostream>
+#include <thread>
 
 #include "TestCase.h"
 #include "utils.h"
@@ -111,35 +112,62 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
   }
 }
 
+double PerformanceResult::GetLatencyPercentile(double fraction) const {
+  if (time_costs.empty()) {
+    return 0.0;
+  }
+
+  std::vector<double> sorted_time = time_costs;
+  std::sort(sorted_time.begin(), sorted_time.end());
+  size_t n = std::min(static_cast<size_t>(sorted_time.size() * fraction), sorted_time.size() - 1);
+  return sorted_time[n];
+}
+
 void PerformanceRunner::LogSessionCreationTime() {
   std::chrono::duration<double> session_create_duration = session_create_end_ - session_create_start_;
   std::cout << "\nSession creation time cost: " << session_create_duration.count() << " s\n";
 }
 
-Status PerformanceRunner::Run() {
+Status PerformanceRunner::RunFirstInference() {
   if (!Initialize()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
   }
 
-  // warm up
   initial_inference_result_.start = std::chrono::high_resolution_clock::now();
   ORT_RETURN_IF_ERROR(RunOneIteration<true>());
   initial_inference_result_.end = std::chrono::high_resolution_clock::now();
+  return Status::OK();
+}
+
+std::string PerformanceRunner::EndProfiling() {
+  return static_cast<OnnxRuntimeTestSession*>(session_.get())->EndProfiling();
+}
+
+Status PerformanceRunner::Run() {
+  // warm up
+  ORT_RETURN_IF_ERROR(RunFirstInference());
+  for (size_t i = 0; i < performance_test_config_.run_config.warmup_runs; ++i) {
+    ORT_RETURN_IF_ERROR(RunOneIteration<true>());
+  }
 
   // TODO: start profiling
   // if (!performance_test_config_.run_config.profile_file.empty())
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
@@ -165,6 +193,25 @@ Status PerformanceRunner::Run() {
             << "Peak working set size: " << performance_result_.peak_workingset_size << " bytes"
             << std::endl;
 
+  if (performance_test_config_.run_config.target_qps > 0) {
+    std::cout << "Target arrival rate: " << performance_test_config_.run_config.target_qps << " requests/s ("
+              << (performance_test_config_.run_config.poisson_arrivals ? "poisson" : "constant") << ")\n"
+              << "Latency including queueing (P50/P90/P99/P999): "
+              << performance_result_.GetLatencyPercentile(0.5) * 1000 << " / "
+              << performance_result_.GetLatencyPercentile(0.9) * 1000 << " / "
+              << performance_result_.GetLatencyPercentile(0.99) * 1000 << " / "
+              << performance_result_.GetLatencyPercentile(0.999) * 1000 << " ms\n"
+              << "Completed requests per second:";
+    for (size_t completed : performance_result_.completed_per_second) {
+      std::cout << " " << completed;
+    }
+    std::cout << "\nCPU usage per second (%):";
+    for (short usage : performance_result_.cpu_usage_per_second) {
+      std::cout << " " << usage;
+    }
+    std::cout << std::endl;
+  }
+
   return Status::OK();
 }
 
@@ -255,6 +302,101 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunScheduledIteration(std::chrono::steady_clock::time_point arrival,
+                                                std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> duration_seconds(std::chrono::seconds(0));
+
+  auto status = Status::OK();
+  ORT_TRY {
+    duration_seconds = session_->Run();
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "PerformanceRunner::RunScheduledIteration caught exception: ",
+                               ex.what());
+    });
+  }
+  ORT_RETURN_IF_ERROR(status);
+
+  auto now = std::chrono::steady_clock::now();
+  std::chrono::duration<double> latency_seconds = now - arrival;
+  size_t second = static_cast<size_t>(std::chrono::duration_cast<std::chrono::seconds>(now - start).count());
+
+  std::lock_guard<std::mutex> guard(results_mutex_);
+  // the latency seen by the client includes the time the request waited for a free worker
+  performance_result_.time_costs.emplace_back(latency_seconds.count());
+  performance_result_.total_time_cost += duration_seconds.count();
+  if (performance_result_.completed_per_second.size() <= second) {
+    performance_result_.completed_per_second.resize(second + 1, 0);
+  }
+  ++performance_result_.completed_per_second[second];
+  if (performance_test_config_.run_config.f_verbose) {
+    std::cout << "iteration:" << performance_result_.time_costs.size() << ","
+              << "latency:" << latency_seconds.count() << ","
+              << "time_cost:" << duration_seconds.count() << std::endl;
+  }
+  return Status::OK();
+}
+
+Status PerformanceRunner::RunOpenLoop() {
+  using clock = std::chrono::steady_clock;
+  const auto& run_config = performance_test_config_.run_config;
+  const bool fixed_duration = run_config.test_mode == TestMode::kFixDurationMode;
+  const auto test_duration = std::chrono::seconds(run_config.duration_in_seconds);
+  const auto constant_interval = std::chrono::duration_cast<clock::duration>(
+      std::chrono::duration<double>(1.0 / run_config.target_qps));
+
+  std::mt19937 generator(run_config.random_seed_for_input_data >= 0
+                             ? static_cast<uint32_t>(run_config.random_seed_for_input_data)
+                             : std::random_device{}());
+  std::exponential_distribution<double> inter_arrival_seconds(run_config.target_qps);
+
+  // requests that arrive while every worker is busy wait in the pool's queue, as they would in a server
+  auto tpool = std::make_unique<DefaultThreadPoolType>(static_cast<int>(run_config.concurrent_session_runs));
+  std::atomic<int> counter{0};
+  std::mutex m;
+  std::condition_variable cv;
+
+  std::unique_ptr<utils::ICPUUsage> interval_cpu_usage = utils::CreateICPUUsage();
+  const auto start = clock::now();
+  auto next_arrival = start;
+  auto next_sample = start + std::chrono::seconds(1);
+  size_t issued = 0;
+
+  while (fixed_duration ? next_arrival - start < test_duration : issued < run_config.repeated_times) {
+    while (next_sample <= next_arrival) {
+      std::this_thread::sleep_until(next_sample);
+      performance_result_.cpu_usage_per_second.push_back(interval_cpu_usage->GetUsage());
+      interval_cpu_usage->Reset();
+      next_sample += std::chrono::seconds(1);
+    }
+
+    std::this_thread::sleep_until(next_arrival);
+    counter++;
+    tpool->Schedule([this, arrival = next_arrival, start, &counter, &m, &cv]() {
+      auto status = RunScheduledIteration(arrival, start);
+      if (!status.IsOK())
+        std::cerr << status.ErrorMessage();
+      // Simplified version of Eigen::Barrier
+      std::lock_guard<std::mutex> lg(m);
+      counter--;
+      cv.notify_all();
+    });
+    ++issued;
+
+    next_arrival += run_config.poisson_arrivals
+                        ? std::chrono::duration_cast<clock::duration>(
+                              std::chrono::duration<double>(inter_arrival_seconds(generator)))
+                        : constant_interval;
+  }
+
+  // Join
+  std::unique_lock<std::mutex> lock(m);
+  cv.wait(lock, [&counter]() { return counter == 0; });
+
+  return Status::OK();
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   const auto& file_path = performance_test_config_.model_info.model_file_path;
 #if !defined(ORT_MINIMAL_BUILD)
@@ -273,6 +415,12 @@ static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfi
 PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd)
     : performance_test_config_(test_config),
       test_model_info_(CreateModelInfo(test_config)) {
+  if (performance_test_config_.run_config.drop_page_cache &&
+      !utils::DropPageCache(performance_test_config_.model_info.model_file_path)) {
+    // the model was just read to create the test model info, so without this the session reads it from memory
+    std::cerr << "failed to drop the page cache of the model, session creation will not read it from storage.\n";
+  }
+
   session_create_start_ = std::chrono::high_resolution_clock::now();
   session_ = std::make_unique<OnnxRuntimeTestSession>(env, rd, performance_test_config_, *test_model_info_);
   session_create_end_ = std::chrono::high_resolution_clock::now();
@@ -35,8 +35,14 @@ struct PerformanceResult {
   double total_time_cost{0};
   std::vector<double> time_costs;
   std::string model_name;
+  // open-loop mode only: requests completed and average CPU usage in each one second interval of the run
+  std::vector<size_t> completed_per_second;
+  std::vector<short> cpu_usage_per_second;
 
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
+
+  // Returns the latency in seconds below which the given fraction of the requests completed.
+  double GetLatencyPercentile(double fraction) const;
 };
 
 class PerformanceRunner {
@@ -46,6 +52,20 @@ class PerformanceRunner {
   ~PerformanceRunner();
   Status Run();
 
+  // Prepares the test data and runs the model once, without running the test itself.
+  Status RunFirstInference();
+
+  // Stops profiling and returns the name of the profile file. Requires profiling to be enabled with -p.
+  std::string EndProfiling();
+
+  inline double GetSessionCreationTime() const {
+    return std::chrono::duration<double>(session_create_end_ - session_create_start_).count();
+  }
+
+  inline double GetFirstInferenceTime() const {
+    return std::chrono::duration<double>(initial_inference_result_.end - initial_inference_result_.start).count();
+  }
+
   void LogSessionCreationTime();
 
   inline const PerformanceResult& GetResult() const { return performance_result_; }
@@ -90,6 +110,9 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunOpenLoop();
+  Status RunScheduledIteration(std::chrono::steady_clock::time_point arrival,
+                               std::chrono::steady_clock::time_point start);
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -4,9 +4,12 @@
 #include "test/perftest/utils.h"
 
 #include <cstddef>
+#include <fstream>
 
+#include <fcntl.h>
 #include <sys/times.h>
 #include <sys/resource.h>
+#include <unistd.h>
 
 #include "core/platform/env.h"
 
@@ -20,6 +23,32 @@ std::size_t GetPeakWorkingSetSize() {
   return static_cast<size_t>(rusage.ru_maxrss * 1024L);
 }
 
+bool DropPageCache(const std::string& path) {
+#if defined(__linux__)
+  // dropping every clean page of the system requires root. otherwise ask the kernel to evict the pages of the file,
+  // which works for any file that is not dirty or mapped by another process.
+  sync();
+  {
+    std::ofstream drop_caches("/proc/sys/vm/drop_caches");
+    if (drop_caches.good() && (drop_caches << "1" << std::flush).good()) {
+      return true;
+    }
+  }
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  int ret = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+  return ret == 0;
+#else
+  (void)path;
+  return false;
+#endif
+}
+
 class CPUUsage : public ICPUUsage {
  public:
   CPUUsage() {
@@ -0,0 +1,129 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "session_creation_breakdown.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <numeric>
+#include <utility>
+
+#include "core/common/common.h"
+#include "nlohmann/json.hpp"
+
+namespace onnxruntime {
+namespace perftest {
+
+namespace {
+
+// phases in the order they happen. the indented ones are part of the phase above them.
+const std::pair<const char*, const char*> kPhases[] = {
+    {"session_creation", "session_creation"},
+    {"model_parse", "  model_parse"},
+    {"session_initialization", "  session_initialization"},
+    {"graph_transformation", "    graph_transformation"},
+    {"graph_partitioning", "    graph_partitioning"},
+    {"initializer_loading", "    initializer_loading"},
+    {"kernel_creation", "    kernel_creation"},
+    {"prepacking", "    prepacking"},
+    {"first_run", "first_run"},
+};
+
+void PrintRow(std::ostream& os, const std::string& name, const std::vector<double>& values) {
+  double mean = values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+  double min = values.empty() ? 0.0 : *std::min_element(values.begin(), values.end());
+  double max = values.empty() ? 0.0 : *std::max_element(values.begin(), values.end());
+  os << std::left << std::setw(48) << name << std::right << std::fixed << std::setprecision(3)
+     << std::setw(12) << mean << std::setw(12) << min << std::setw(12) << max << "\n";
+}
+
+}  // namespace
+
+Status SessionCreationBreakdown::AddRun(const std::string& profile_file, double session_creation_seconds,
+                                        double first_run_seconds) {
+  std::ifstream profile(profile_file);
+  ORT_RETURN_IF_NOT(profile.good(), "Failed to open profile file ", profile_file);
+
+  nlohmann::json events = nlohmann::json::parse(profile, nullptr, /*allow_exceptions*/ false);
+  ORT_RETURN_IF(events.is_discarded() || !events.is_array(), "Failed to parse profile file ", profile_file);
+
+  std::map<std::string, double> phases;
+  std::map<std::string, double> transformers;
+  phases["session_creation"] = session_creation_seconds * 1000;
+  phases["first_run"] = first_run_seconds * 1000;
+
+  for (const auto& event : events) {
+    if (event.value("cat", "") != "Session") {
+      continue;
+    }
+
+    const std::string name = event.value("name", "");
+    const double ms = event.value("dur", 0.0) / 1000;
+    std::string phase;
+    if (event.contains("args") && event["args"].is_object()) {
+      phase = event["args"].value("phase", "");
+    }
+
+    if (phase == "graph_transformation") {
+      // a transformer is applied once per level it is registered for and per graph transformation step
+      transformers[name] += ms;
+      phases[phase] += ms;
+    } else if (!phase.empty()) {
+      phases[phase] += ms;
+    } else if (name.rfind("model_loading", 0) == 0) {
+      phases["model_parse"] += ms;
+    } else if (name == "session_initialization") {
+      phases[name] += ms;
+    }
+  }
+
+  // keep one value per run for every name, so a phase that did not happen in a run counts as zero
+  for (const auto& phase : kPhases) {
+    phases_[phase.first].push_back(phases[phase.first]);
+  }
+  for (const auto& transformer : transformers) {
+    transformers_[transformer.first].resize(num_runs_, 0.0);
+  }
+  ++num_runs_;
+  for (auto& transformer : transformers_) {
+    transformer.second.push_back(transformers[transformer.first]);
+  }
+
+  return Status::OK();
+}
+
+void SessionCreationBreakdown::Print(std::ostream& os) const {
+  os << "\nSession creation breakdown over " << num_runs_ << " cold start(s)\n";
+  os << std::left << std::setw(48) << "phase (ms)" << std::right << std::setw(12) << "mean" << std::setw(12) << "min"
+     << std::setw(12) << "max" << "\n";
+  for (const auto& phase : kPhases) {
+    auto it = phases_.find(phase.first);
+    PrintRow(os, phase.second, it != phases_.end() ? it->second : std::vector<double>{});
+  }
+
+  if (transformers_.empty()) {
+    os << std::flush;
+    return;
+  }
+
+  // slowest transformers first
+  std::vector<std::pair<double, std::string>> by_time;
+  for (const auto& transformer : transformers_) {
+    const auto& values = transformer.second;
+    by_time.emplace_back(std::accumulate(values.begin(), values.end(), 0.0), transformer.first);
+  }
+  std::sort(by_time.begin(), by_time.end(), std::greater<>());
+
+  os << "\n"
+     << std::left << std::setw(48) << "graph transformer (ms)" << std::right << std::setw(12) << "mean"
+     << std::setw(12) << "min" << std::setw(12) << "max" << "\n";
+  for (const auto& entry : by_time) {
+    PrintRow(os, entry.second, transformers_.at(entry.second));
+  }
+  os << std::flush;
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
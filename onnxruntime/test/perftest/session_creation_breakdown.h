@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <core/common/status.h>
+
+namespace onnxruntime {
+namespace perftest {
+
+// Aggregates the session events in the profiles of repeated cold session creations into a per phase breakdown:
+// model parsing, every graph transformer, partitioning, initializer loading, kernel creation, prepacking and the
+// first run.
+class SessionCreationBreakdown {
+ public:
+  // Adds one cold start, with the session events of its profile file and the wall clock time the session creation
+  // and the first run took as measured by the caller.
+  Status AddRun(const std::string& profile_file, double session_creation_seconds, double first_run_seconds);
+
+  void Print(std::ostream& os) const;
+
+ private:
+  size_t num_runs_{0};
+  // milliseconds spent in each phase and each graph transformer, one entry per run
+  std::map<std::string, std::vector<double>> phases_;
+  std::map<std::string, std::vector<double>> transformers_;
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "core/graph/constants.h"
 #include "core/framework/session_options.h"
@@ -66,6 +67,25 @@ struct RunConfig {
   bool disable_spinning_between_run = false;
   bool exit_after_session_creation = false;
   std::basic_string<ORTCHAR_T> register_custom_op_path;
+  // Open-loop load generation. When target_qps > 0 requests are issued at that rate regardless of when earlier
+  // requests complete, and up to concurrent_session_runs of them run at once. The latency of a request is measured
+  // from its scheduled arrival, so it includes the time spent queued behind other requests.
+  double target_qps{0.0};
+  bool poisson_arrivals{true};
+  // Sweep mode. A session is created and tested for every combination of the listed values, which override
+  // intra_op_num_threads and concurrent_session_runs.
+  std::vector<int> sweep_intra_op_num_threads;
+  std::vector<size_t> sweep_concurrent_session_runs;
+  // Cold start mode. A session is created and run once this many times, and the session creation phases recorded
+  // by the profiler are reported instead of the usual latency statistics.
+  size_t cold_start_runs{0};
+  bool drop_page_cache{false};
+  // Runs of the model after the first inference whose times are not recorded.
+  size_t warmup_runs{0};
+  // Suite mode. The benchmarks listed in the manifest are run in turn and their results are written as json, and
+  // compared with the results of an earlier run when a baseline is given.
+  std::basic_string<ORTCHAR_T> suite_manifest_path;
+  std::basic_string<ORTCHAR_T> suite_baseline_path;
 };
 
 struct PerformanceTestConfig {
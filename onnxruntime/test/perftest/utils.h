@@ -4,6 +4,9 @@
 #pragma once
 
 #include <memory>
+#include <string>
+
+#include <core/session/onnxruntime_c_api.h>
 
 namespace onnxruntime {
 namespace perftest {
@@ -11,6 +14,10 @@ namespace utils {
 
 size_t GetPeakWorkingSetSize();
 
+// Evicts the file from the OS page cache so the next read of it comes from storage. Returns false if that is not
+// supported by the platform or not permitted.
+bool DropPageCache(const std::basic_string<ORTCHAR_T>& path);
+
 class ICPUUsage {
  public:
   virtual ~ICPUUsage() = default;
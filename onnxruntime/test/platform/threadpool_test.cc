@@ -3,6 +3,7 @@
 
 #include "core/platform/threadpool.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
+#include "core/common/parallel_for_cost_calibration.h"
 #include <mutex>
 #include "core/util/thread_utils.h"
 #ifdef _WIN32
@@ -12,8 +13,11 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <cstdio>
 #include <memory>
 #include <functional>
+#include <future>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -510,6 +514,224 @@ TEST(ThreadPoolTest, TestStagedMultiLoopSections_4Thread_100Loop) {
   TestStagedMultiLoopSections("TestStagedMultiLoopSections_4Thread_100Loop", 4, 100);
 }
 
+// The loops of a pool partitioned by NUMA node must still run every iteration exactly once,
+// including when the number of shards does not divide evenly between the nodes.
+TEST(ThreadPoolTest, TestParallelFor_NumaNodes) {
+  for (int dynamic_block_base : {0, 4}) {
+    onnxruntime::ThreadOptions to;
+    to.dynamic_block_base_ = dynamic_block_base;
+    to.numa_nodes = {0, 0, 1, 1, 2};
+    auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 5, true);
+    for (int num_tasks : {2, 3, 7, 50, 1000}) {
+      auto test_data = CreateTestData(num_tasks);
+      ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+      ValidateTestData(*test_data);
+    }
+  }
+}
+
+TEST(ThreadPoolTest, TestParallelForCostCalibration) {
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4, true);
+  auto calibration = std::make_shared<ParallelForCostCalibration>();
+  tp->SetCostCalibration(calibration);
+
+  // two costs at a call site identified by the location of the caller, and one of them at another call site
+  const onnxruntime::TensorOpCost cheap{4, 4, 1};
+  const onnxruntime::TensorOpCost expensive{0, 0, 1e7};
+  const ParallelForCallSite call_site{"parallel_for_cost_calibration_test.cc", 42};
+  for (size_t i = 0; i < ParallelForCostCalibration::kNumSamples + 2; ++i) {
+    for (const auto& cost : {cheap, expensive}) {
+      auto test_data = CreateTestData(1000);
+      ThreadPool::TryParallelFor(tp.get(), 1000, cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t j = first; j < last; ++j) {
+          IncrementElement(*test_data, j);
+        }
+      });
+      ValidateTestData(*test_data);
+    }
+
+    auto test_data = CreateTestData(1000);
+    ThreadPool::TryParallelFor(
+        tp.get(), 1000, cheap, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t j = first; j < last; ++j) {
+            IncrementElement(*test_data, j);
+          }
+        },
+        call_site.file, call_site.line);
+    ValidateTestData(*test_data);
+  }
+  ASSERT_EQ(calibration->NumCalibratedEntries(), 3u);
+  ASSERT_TRUE(calibration->IsDirty());
+
+  // a cost that was not declared at a call site is not calibrated there
+  onnxruntime::TensorOpCost cost{};
+  ASSERT_TRUE(calibration->GetCost(call_site, expensive, cost));
+  ASSERT_EQ(cost.compute_cycles, expensive.compute_cycles);
+
+  const onnxruntime::PathString file_path = ORT_TSTR("parallel_for_cost_calibration_test.bin");
+  ASSERT_TRUE(calibration->Save(file_path, "identity").IsOK());
+  ASSERT_FALSE(calibration->IsDirty());
+
+  ParallelForCostCalibration loaded;
+  ASSERT_FALSE(loaded.Load(file_path, "another identity").IsOK());
+  ASSERT_TRUE(loaded.Load(file_path, "identity").IsOK());
+  ASSERT_EQ(loaded.NumCalibratedEntries(), 3u);
+
+  // the call sites are compared by the contents of their file names
+  const std::string file = call_site.file;
+  onnxruntime::TensorOpCost calibrated{}, expected{};
+  ASSERT_FALSE(loaded.GetCost({file.c_str(), call_site.line}, cheap, calibrated));
+  ASSERT_FALSE(calibration->GetCost(call_site, cheap, expected));
+  ASSERT_EQ(calibrated.compute_cycles, expected.compute_cycles);
+  std::remove("parallel_for_cost_calibration_test.bin");
+}
+
+TEST(ThreadPoolTest, TestRunScope) {
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4, true);
+  const int uncapped = ThreadPool::DegreeOfParallelism(tp.get());
+
+  auto run_loop = [&]() {
+    auto test_data = CreateTestData(100);
+    ThreadPool::TrySimpleParallelFor(tp.get(), 100, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    ValidateTestData(*test_data);
+  };
+
+  {
+    ThreadPool::RunScope scope(tp.get(), 2, ThreadPool::RunPriority::kNormal);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), uncapped / 2);
+    run_loop();
+
+    {
+      ThreadPool::RunScope single_thread(tp.get(), 1, ThreadPool::RunPriority::kNormal);
+      ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 1);
+      ASSERT_FALSE(ThreadPool::ShouldParallelize(tp.get()));
+    }
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), uncapped / 2);
+  }
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), uncapped);
+
+  // while a high priority run is in progress the normal priority runs only use their calling thread
+  {
+    ThreadPool::RunScope high_priority(tp.get(), 0, ThreadPool::RunPriority::kHigh);
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), uncapped);
+    {
+      ThreadPool::RunScope normal_priority(tp.get(), 0, ThreadPool::RunPriority::kNormal);
+      ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), 1);
+      const auto caller = std::this_thread::get_id();
+      std::atomic<bool> ran_elsewhere{false};
+      ThreadPool::TrySimpleParallelFor(tp.get(), 100, [&](std::ptrdiff_t) {
+        if (std::this_thread::get_id() != caller) {
+          ran_elsewhere = true;
+        }
+      });
+      ASSERT_FALSE(ran_elsewhere);
+    }
+    run_loop();
+  }
+
+  // loops outside of any run are not limited
+  ThreadPool::RunScope high_priority(tp.get(), 0, ThreadPool::RunPriority::kHigh);
+  std::thread([&]() { ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), uncapped); }).join();
+}
+
+TEST(ThreadPoolTest, TestSpinningWithoutBlocking) {
+  // without spinning the threads block as soon as they run out of work
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4,
+                                         false);
+  auto run_loop = [&]() {
+    auto test_data = CreateTestData(100);
+    ThreadPool::TrySimpleParallelFor(tp.get(), 100, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    ValidateTestData(*test_data);
+  };
+
+  run_loop();
+  tp->StartSpinningWithoutBlocking();
+  run_loop();
+  {
+    // nested, e.g. by concurrent runs
+    tp->StartSpinningWithoutBlocking();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    run_loop();
+    tp->StopSpinningWithoutBlocking();
+  }
+  run_loop();
+  tp->StopSpinningWithoutBlocking();
+  run_loop();
+
+  std::promise<void> scheduled;
+  ThreadPool::Schedule(tp.get(), [&scheduled]() { scheduled.set_value(); });
+  scheduled.get_future().wait();
+}
+
+TEST(ThreadPoolTest, TestCreateThreadsLazily) {
+  onnxruntime::ThreadOptions thread_options;
+  thread_options.create_threads_lazily = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, 4, true);
+
+  // the loops are partitioned for all the threads before they exist
+  auto created_tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4,
+                                                 true);
+  ASSERT_EQ(ThreadPool::NumThreads(tp.get()), 3);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), ThreadPool::DegreeOfParallelism(created_tp.get()));
+  ASSERT_EQ(ThreadPool::GetParallelismStats(created_tp.get()).created_threads, 3);
+  ASSERT_EQ(ThreadPool::GetParallelismStats(tp.get()).created_threads, 0);
+
+  // a loop run by the caller alone does not create them, and neither does the spinning state
+  tp->DisableSpinning();
+  tp->StartSpinningWithoutBlocking();
+  ThreadPool::TrySimpleParallelFor(tp.get(), 1, [](std::ptrdiff_t) {});
+  ASSERT_EQ(ThreadPool::GetParallelismStats(tp.get()).created_threads, 0);
+
+  auto test_data = CreateTestData(100);
+  ThreadPool::TrySimpleParallelFor(tp.get(), 100, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+  tp->StopSpinningWithoutBlocking();
+  tp->EnableSpinning();
+
+  const auto stats = ThreadPool::GetParallelismStats(tp.get());
+  ASSERT_EQ(stats.created_threads, 3);
+  ASSERT_EQ(stats.num_loops, 1u);
+  ASSERT_EQ(stats.sum_loop_threads, 4u);
+  ASSERT_EQ(stats.max_loop_threads, 4);
+}
+
+// Each thread counts its loops separately, so check that the counts of all of them are summed, with threads running
+// loops on more pools than they cache the counters of.
+TEST(ThreadPoolTest, TestParallelismStatsOfConcurrentLoops) {
+  constexpr int kNumPools = 6;
+  constexpr int kNumThreads = 3;
+  constexpr int kLoopsPerPool = 10;
+
+  std::vector<std::unique_ptr<ThreadPool>> pools;
+  for (int i = 0; i < kNumPools; ++i) {
+    pools.push_back(std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr,
+                                                 4, true));
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&pools]() {
+      for (int loop = 0; loop < kLoopsPerPool; ++loop) {
+        for (auto& pool : pools) {
+          auto test_data = CreateTestData(100);
+          ThreadPool::TrySimpleParallelFor(pool.get(), 100, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+          ValidateTestData(*test_data);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& pool : pools) {
+    const auto stats = ThreadPool::GetParallelismStats(pool.get());
+    ASSERT_EQ(stats.num_loops, static_cast<uint64_t>(kNumThreads * kLoopsPerPool));
+    ASSERT_EQ(stats.sum_loop_threads, 4u * kNumThreads * kLoopsPerPool);
+    ASSERT_EQ(stats.max_loop_threads, 4);
+  }
+}
+
 #ifdef _WIN32
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
 #pragma warning(push)
@@ -613,6 +835,29 @@ TEST(ThreadPoolTest, TestAffinityStringWellShaped) {
   }
 }
 
+TEST(ThreadPoolTest, TestPerformanceCoresOnly) {
+  OrtThreadPoolParams tp_params;
+  tp_params.thread_pool_size = 3;
+  tp_params.performance_cores_only = true;
+  // on systems with a single class of cores, all the cores are used
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                          tp_params,
+                                          concurrency::ThreadPoolType::INTRA_OP);
+  auto DOP = concurrency::ThreadPool::DegreeOfParallelism(tp.get());
+  ASSERT_TRUE(DOP >= 3 && DOP % 3 == 0);
+  auto test_data = CreateTestData(100);
+  ThreadPool::TrySimpleParallelFor(tp.get(), 100, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+
+#ifndef ORT_NO_EXCEPTIONS
+  tp_params.affinity_str = "1;2";
+  ASSERT_THROW(concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                             tp_params,
+                                             concurrency::ThreadPoolType::INTRA_OP),
+               std::exception);
+#endif
+}
+
 #ifdef _WIN32
 TEST(ThreadPoolTest, TestDefaultAffinity) {
   test::CpuGroup cpu_group = {{0, 1},
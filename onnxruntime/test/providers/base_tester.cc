@@ -744,6 +744,9 @@ void BaseTester::RunWithConfig(size_t* number_of_pre_packed_weights_counter,
           std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
           if (provider_type == onnxruntime::kRocmExecutionProvider) {
             execution_providers.emplace_back(DefaultRocmExecutionProvider(/*test_tunable_op=*/true));
+          } else if (provider_type == onnxruntime::kCpuExecutionProvider) {
+            execution_providers.emplace_back(DefaultCpuExecutionProvider(/*enable_arena=*/true,
+                                                                         /*test_tunable_op=*/true));
           }
 
           if (!execution_providers.empty()) {
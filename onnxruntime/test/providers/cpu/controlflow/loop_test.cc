@@ -1042,6 +1042,50 @@ TEST(Loop, IterationCountAsOutput) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// the condition is returned as is, so the number of iterations is known and the loop outputs are written to
+// slices of the Loop outputs. one of them is the iteration number subgraph input, which is not produced by a node.
+TEST(Loop, KnownTripCountLoopOutputs) {
+  auto create_subgraph = []() {
+    Model model("Known trip count", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& doubled_out = graph.GetOrCreateNodeArg("doubled_out", &int64_scalar);
+
+    // iter_num_in + iter_num_in -> doubled_out
+    graph.AddNode("double", "Add", "Double the iteration number", {&iter_num_in, &iter_num_in}, {&doubled_out});
+
+    graph.SetInputs({&iter_num_in, &cond_in});
+    graph.SetOutputs({&cond_in, &doubled_out, &iter_num_in});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  OpTester test("Loop", 11);
+  auto body = create_subgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {4});
+  test.AddOptionalInputEdge<bool>();
+
+  test.AddOutput<int64_t>("doubled_final", {4, 1}, {0, 2, 4, 6});
+  test.AddOutput<int64_t>("iter_num_final", {4, 1}, {0, 1, 2, 3});
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM)
 // test that when part of the subgraph run on CUDA/ROCm it executes successfully
 TEST(Loop, MixedExecutionProviders) {
@@ -257,5 +257,40 @@ TEST(CumSumTest, _1DTestLong) {
   test.AddOutput<int32_t>("y", {N}, output_value);
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
+TEST(CumSumTest, _2DTestLongAxisExclusiveReverse) {
+  // a long axis over few slices is scanned in blocks of rows, which is checked against a serial scan.
+  constexpr int64_t N = 70000;
+  constexpr int64_t C = 3;
+  std::vector<int64_t> input_value(N * C);
+  for (int64_t i = 0; i < N * C; i++) {
+    input_value[i] = (i * 7919) % 13 - 6;
+  }
+  for (int64_t exclusive = 0; exclusive < 2; exclusive++) {
+    for (int64_t reverse = 0; reverse < 2; reverse++) {
+      std::vector<int64_t> output_value(N * C);
+      for (int64_t c = 0; c < C; c++) {
+        int64_t sum = 0;
+        for (int64_t k = 0; k < N; k++) {
+          const int64_t i = (reverse ? N - 1 - k : k) * C + c;
+          if (exclusive) {
+            output_value[i] = sum;
+            sum += input_value[i];
+          } else {
+            sum += input_value[i];
+            output_value[i] = sum;
+          }
+        }
+      }
+
+      OpTester test("CumSum", 14, onnxruntime::kOnnxDomain);
+      test.AddAttribute<int64_t>("exclusive", exclusive);
+      test.AddAttribute<int64_t>("reverse", reverse);
+      test.AddInput<int64_t>("x", {N, C}, input_value);
+      test.AddInput<int32_t>("axis", {}, {0});
+      test.AddOutput<int64_t>("y", {N, C}, output_value);
+      test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+    }
+  }
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -237,6 +237,29 @@ TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
 }
 
+// The contraction order is picked by cost: jk,k is contracted before ij
+TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input_ContractionPath) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ij,jk,k->i");
+  test.AddInput<float>("x", {2, 3}, {0.f, 1.f, 2.f, 3.f, 4.f, 5.f});
+  test.AddInput<float>("y", {3, 4}, {-5.f, -4.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddInput<float>("z", {4}, {1.f, -1.f, 2.f, 0.5f});
+  test.AddOutput<float>("o", {2}, {26.f, 44.f});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
+}
+
+TEST(Einsum, ExplicitEinsumAsBatchedMatmul_Multi_Input_ContractionPath) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "bij,bjk,bkl,bl->bi");
+  test.AddInput<float>("x", {2, 2, 3}, {0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f});
+  test.AddInput<float>("y", {2, 3, 4}, {-2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f,
+                                        0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f, 2.f, -2.f, -1.f, 0.f, 1.f});
+  test.AddInput<float>("z", {2, 4, 2}, {0.f, 1.f, 2.f, 0.f, 1.f, 2.f, 0.f, 1.f, 2.f, 0.f, 1.f, 2.f, 0.f, 1.f, 2.f, 0.f});
+  test.AddInput<float>("w", {2, 2}, {1.f, 2.f, -1.f, 3.f});
+  test.AddOutput<float>("o", {2, 2}, {-17.f, -62.f, 73.f, 112.f});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
+}
+
 TEST(Einsum, ExplicitEinsumAsBatchedMatmul) {
   OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
   test.AddAttribute<std::string>("equation", "bij,bjk->bik");
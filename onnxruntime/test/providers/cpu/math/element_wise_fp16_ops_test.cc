@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/mlas/inc/mlas.h"
+
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// values exactly representable in fp16, so the expected results only round once
+std::vector<float> Fp16Values(size_t count, float scale) {
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = MLFloat16(scale * (static_cast<float>((i * 7) % 19) - 9.0f) / 8.0f + 0.125f).ToFloat();
+  }
+  return values;
+}
+
+void RunOnCpu(OpTester& test) {
+  test.ConfigEp(DefaultCpuExecutionProvider()).RunWithConfig();
+}
+
+void TestBinaryFp16(const char* op, int opset, const std::vector<int64_t>& a_dims, const std::vector<int64_t>& b_dims,
+                    const std::vector<int64_t>& c_dims, const std::function<float(float, float)>& expected_fn) {
+  const auto size = [](const std::vector<int64_t>& dims) {
+    return static_cast<size_t>(std::accumulate(dims.begin(), dims.end(), int64_t{1}, std::multiplies<int64_t>()));
+  };
+  const auto a = Fp16Values(size(a_dims), 1.0f);
+  const auto b = Fp16Values(size(b_dims), 2.0f);
+
+  // b is a scalar, or has the same shape as a
+  std::vector<float> c(size(c_dims));
+  for (size_t i = 0; i < c.size(); ++i) {
+    c[i] = expected_fn(a.size() == 1 ? a[0] : a[i], b.size() == 1 ? b[0] : b[i]);
+  }
+
+  OpTester test(op, opset);
+  test.AddInput<MLFloat16>("A", a_dims, FloatsToMLFloat16s(a));
+  test.AddInput<MLFloat16>("B", b_dims, FloatsToMLFloat16s(b));
+  test.AddOutput<MLFloat16>("C", c_dims, FloatsToMLFloat16s(c));
+  RunOnCpu(test);
+}
+
+}  // namespace
+
+TEST(ElementWiseFp16Test, Add) {
+  // 39 elements cover the unrolled loop, the vector loop and the partial vector
+  TestBinaryFp16("Add", 14, {3, 13}, {3, 13}, {3, 13}, [](float a, float b) { return a + b; });
+  TestBinaryFp16("Add", 13, {3, 13}, {}, {3, 13}, [](float a, float b) { return a + b; });
+  TestBinaryFp16("Add", 7, {}, {3, 13}, {3, 13}, [](float a, float b) { return a + b; });
+}
+
+TEST(ElementWiseFp16Test, SubMulDiv) {
+  TestBinaryFp16("Sub", 14, {5, 7}, {5, 7}, {5, 7}, [](float a, float b) { return a - b; });
+  TestBinaryFp16("Mul", 14, {5, 7}, {}, {5, 7}, [](float a, float b) { return a * b; });
+  TestBinaryFp16("Div", 14, {}, {5, 7}, {5, 7}, [](float a, float b) { return a / b; });
+}
+
+TEST(ElementWiseFp16Test, AddBroadcast) {
+  const std::vector<float> a = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const std::vector<float> b = {0.5f, -1.0f, 2.0f};
+
+  OpTester test("Add", 14);
+  test.AddInput<MLFloat16>("A", {2, 3}, FloatsToMLFloat16s(a));
+  test.AddInput<MLFloat16>("B", {3}, FloatsToMLFloat16s(b));
+  test.AddOutput<MLFloat16>("C", {2, 3}, FloatsToMLFloat16s({1.5f, 1.0f, 5.0f, 4.5f, 4.0f, 8.0f}));
+  RunOnCpu(test);
+}
+
+TEST(ElementWiseFp16Test, Softmax) {
+  const std::vector<float> x = {0.0f, 1.0f, 2.0f, 3.0f, -1.0f, 0.5f, 1.5f, -2.0f};
+
+  for (const bool log : {false, true}) {
+    // opset 13 with axis 0 transposes the axis to the innermost dim
+    std::vector<float> y(x.size());
+    for (size_t col = 0; col < 4; ++col) {
+      const float max = std::max(x[col], x[4 + col]);
+      const float sum = std::exp(x[col] - max) + std::exp(x[4 + col] - max);
+      for (size_t row = 0; row < 2; ++row) {
+        const float v = x[row * 4 + col] - max;
+        y[row * 4 + col] = log ? v - std::log(sum) : std::exp(v) / sum;
+      }
+    }
+
+    OpTester test(log ? "LogSoftmax" : "Softmax", 13);
+    test.AddAttribute<int64_t>("axis", 0);
+    test.AddInput<MLFloat16>("X", {2, 4}, FloatsToMLFloat16s(x));
+    test.AddOutput<MLFloat16>("Y", {2, 4}, FloatsToMLFloat16s(y));
+    RunOnCpu(test);
+  }
+}
+
+TEST(ElementWiseFp16Test, Gelu) {
+  const auto x = Fp16Values(37, 2.0f);
+
+  for (const char* approximate : {"none", "tanh"}) {
+    std::vector<float> y(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+      const float v = x[i];
+      y[i] = std::string(approximate) == "tanh"
+                 ? 0.5f * v * (1.0f + std::tanh(0.7978845608028654f * (v + 0.044715f * v * v * v)))
+                 : 0.5f * v * (1.0f + std::erf(v * static_cast<float>(M_SQRT1_2)));
+    }
+
+    OpTester test("Gelu", 20);
+    test.AddAttribute<std::string>("approximate", approximate);
+    test.AddInput<MLFloat16>("X", {37}, FloatsToMLFloat16s(x));
+    test.AddOutput<MLFloat16>("Y", {37}, FloatsToMLFloat16s(y));
+    RunOnCpu(test);
+  }
+}
+
+TEST(ReductionFp16Test, ReduceMeanLastAxis) {
+  // the sum of the row in fp16 would lose the small values
+  std::vector<float> x(2 * 2048, 1.0f / 1024.0f);
+  x[0] = 16.0f;
+  x[2048] = -16.0f;
+
+  OpTester test("ReduceMean", 18);
+  test.AddAttribute<int64_t>("keepdims", 1);
+  test.AddInput<MLFloat16>("data", {2, 2048}, FloatsToMLFloat16s(x));
+  test.AddInput<int64_t>("axes", {1}, {1});
+  test.AddOutput<MLFloat16>("reduced", {2, 1},
+                            FloatsToMLFloat16s({(16.0f + 2047.0f / 1024.0f) / 2048.0f,
+                                                (-16.0f + 2047.0f / 1024.0f) / 2048.0f}));
+  RunOnCpu(test);
+}
+
+TEST(ReductionFp16Test, ReduceSumFirstAndMiddleAxes) {
+  const auto x = Fp16Values(2 * 3 * 4, 1.0f);
+
+  // RK: reduce axis 0
+  std::vector<float> rk(12, 0.0f);
+  // KRK: reduce axis 1
+  std::vector<float> krk(8, 0.0f);
+  for (size_t i = 0; i < 2; ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      for (size_t k = 0; k < 4; ++k) {
+        rk[j * 4 + k] += x[(i * 3 + j) * 4 + k];
+        krk[i * 4 + k] += x[(i * 3 + j) * 4 + k];
+      }
+    }
+  }
+
+  OpTester test_rk("ReduceSum", 13);
+  test_rk.AddAttribute<int64_t>("keepdims", 0);
+  test_rk.AddInput<MLFloat16>("data", {2, 3, 4}, FloatsToMLFloat16s(x));
+  test_rk.AddInput<int64_t>("axes", {1}, {0});
+  test_rk.AddOutput<MLFloat16>("reduced", {3, 4}, FloatsToMLFloat16s(rk));
+  RunOnCpu(test_rk);
+
+  OpTester test_krk("ReduceSum", 13);
+  test_krk.AddAttribute<int64_t>("keepdims", 1);
+  test_krk.AddInput<MLFloat16>("data", {2, 3, 4}, FloatsToMLFloat16s(x));
+  test_krk.AddInput<int64_t>("axes", {1}, {1});
+  test_krk.AddOutput<MLFloat16>("reduced", {2, 1, 4}, FloatsToMLFloat16s(krk));
+  RunOnCpu(test_krk);
+}
+
+TEST(ReductionFp16Test, ReduceMaxOuterAxes) {
+  // RKR is reduced after moving the kept axis first
+  const auto x = Fp16Values(2 * 3 * 4, 1.0f);
+  std::vector<float> y(3, -INFINITY);
+  for (size_t i = 0; i < 2; ++i) {
+    for (size_t j = 0; j < 3; ++j) {
+      for (size_t k = 0; k < 4; ++k) {
+        y[j] = std::max(y[j], x[(i * 3 + j) * 4 + k]);
+      }
+    }
+  }
+
+  OpTester test("ReduceMax", 13);
+  test.AddAttribute("axes", std::vector<int64_t>{0, 2});
+  test.AddAttribute<int64_t>("keepdims", 0);
+  test.AddInput<MLFloat16>("data", {2, 3, 4}, FloatsToMLFloat16s(x));
+  test.AddOutput<MLFloat16>("reduced", {3}, FloatsToMLFloat16s(y));
+  RunOnCpu(test);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
+
+#endif  // MLAS_F16VEC_INTRINSICS_SUPPORTED
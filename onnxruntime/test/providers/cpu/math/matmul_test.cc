@@ -1,15 +1,23 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
+
 #include "gtest/gtest.h"
 
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/run_options_config_keys.h"
 #include "test/common/dnnl_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
+#include "test/util/include/file_util.h"
 #include "default_providers.h"
 
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
+
 namespace onnxruntime {
 namespace test {
 
@@ -430,6 +438,191 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights) {
   }
 }
 
+// B has one non-zero block of 4x16 out of four, so it is packed as a block sparse matrix
+TEST(MathOpTest, MatMulBlockSparsePrepackedWeights) {
+  constexpr int64_t M = 3, K = 8, N = 32;
+  std::vector<float> a_values(M * K);
+  std::vector<float> b_values(K * N, 0.0f);
+  for (size_t i = 0; i < a_values.size(); ++i) {
+    a_values[i] = static_cast<float>(i % 5) - 2.0f;
+  }
+  for (int64_t k = 4; k < 8; ++k) {
+    for (int64_t n = 0; n < 16; ++n) {
+      b_values[k * N + n] = static_cast<float>((k + n) % 3) - 1.0f;
+    }
+  }
+
+  std::vector<float> y_values(M * N, 0.0f);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        y_values[m * N + n] += a_values[m * K + k] * b_values[k * N + n];
+      }
+    }
+  }
+
+  OpTester test("MatMul", 13);
+  test.AddInput<float>("A", {M, K}, a_values);
+  test.AddInput<float>("B", {K, N}, b_values, true);
+  test.AddOutput<float>("Y", {M, N}, y_values);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasBlockSparseGemmMinSparsity, "0.7"));
+
+  auto cpu_ep = []() -> std::vector<std::unique_ptr<IExecutionProvider>> {
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    return execution_providers;
+  };
+
+  size_t number_of_pre_packed_weights = 0;
+  size_t number_of_shared_pre_packed_weights = 0;
+  test.Config(so)
+      .ConfigEps(cpu_ep())
+      .RunWithConfig(&number_of_pre_packed_weights, &number_of_shared_pre_packed_weights);
+  ASSERT_EQ(number_of_pre_packed_weights, static_cast<size_t>(1));
+}
+
+TEST(MathOpTest, MatMulPrePackedWeightsCacheFile) {
+  const std::filesystem::path cache_file = "matmul_prepacked_weights_cache.bin";
+  std::filesystem::remove(cache_file);
+  ScopedFileDeleter cache_file_deleter(cache_file.native());
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsPrePackedWeightsCacheFile,
+                                                    cache_file.string().c_str()));
+
+  auto run = [&so](size_t& number_of_pre_packed_weights_counter) {
+    OpTester test("MatMul");
+    test.AddInput<float>("A", {2, 4},
+                         {1.0f, 2.0f, 3.0f, 4.0f,
+                          -1.0f, -2.0f, -3.0f, -4.0f});
+    // B is to be an initializer for triggering pre-packing
+    test.AddInput<float>("B", {4, 3},
+                         {1.0f, 2.0f, 3.0f,
+                          4.0f, 5.0f, 6.0f,
+                          7.0f, 8.0f, 9.0f,
+                          10.0f, 11.0f, 12.0f},
+                         true);
+    test.AddOutput<float>("Y", {2, 3},
+                          {70.0f, 80.0f, 90.0f,
+                           -70.0f, -80.0f, -90.0f});
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Config(so)
+        .ConfigEps(std::move(execution_providers))
+        .RunWithConfig(&number_of_pre_packed_weights_counter);
+  };
+
+  // Session 1 packs B and writes the cache file
+  size_t number_of_pre_packed_weights_counter = 0;
+  run(number_of_pre_packed_weights_counter);
+
+  // On some platforms/architectures MLAS may choose to not do any pre-packing
+  if (number_of_pre_packed_weights_counter == 0) {
+    return;
+  }
+
+  ASSERT_TRUE(std::filesystem::exists(cache_file));
+  const auto last_write_time = std::filesystem::last_write_time(cache_file);
+
+  // Session 2 uses the packed B from the file, which is not written again as nothing was added
+  number_of_pre_packed_weights_counter = 0;
+  run(number_of_pre_packed_weights_counter);
+  ASSERT_EQ(number_of_pre_packed_weights_counter, static_cast<size_t>(1));
+  ASSERT_EQ(last_write_time, std::filesystem::last_write_time(cache_file));
+}
+
+TEST(MathOpTest, MatMulSharedPrepackedWeightsCacheFile) {
+  const std::filesystem::path cache_file = "matmul_shared_prepacked_weights_cache.bin";
+  std::filesystem::remove(cache_file);
+  ScopedFileDeleter cache_file_deleter(cache_file.native());
+
+  std::vector<float> b_init_values(12, 1.0f);
+  OrtValue b;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({4, 3}),
+                       b_init_values.data(), OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator), b);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.AddInitializer("B", &b));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsPrePackedWeightsCacheFile,
+                                                    cache_file.string().c_str()));
+
+  // each OpTester has its own container of shared pre-packed weights, like a separate process would
+  auto run = [&](size_t& number_of_pre_packed_weights_counter, size_t& number_of_elements_in_container) {
+    OpTester test("MatMul");
+    test.AddInput<float>("A", {2, 4},
+                         {1.0f, 2.0f, 3.0f, 4.0f,
+                          -1.0f, -2.0f, -3.0f, -4.0f});
+    test.AddInput<float>("B", {4, 3}, b_init_values, true);
+    test.AddOutput<float>("Y", {2, 3},
+                          {10.0f, 10.0f, 10.0f,
+                           -10.0f, -10.0f, -10.0f});
+    test.EnableSharingOfPrePackedWeightsAcrossSessions();
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    size_t number_of_shared_pre_packed_weights_counter = 0;
+    test.Config(so)
+        .ConfigEps(std::move(execution_providers))
+        .RunWithConfig(&number_of_pre_packed_weights_counter, &number_of_shared_pre_packed_weights_counter);
+    number_of_elements_in_container = test.GetNumPrePackedWeightsShared();
+  };
+
+  // The first "process" packs B into its shared container and writes the cache file
+  size_t number_of_pre_packed_weights_counter = 0;
+  size_t number_of_elements_in_container = 0;
+  run(number_of_pre_packed_weights_counter, number_of_elements_in_container);
+
+  // On some platforms/architectures MLAS may choose to not do any pre-packing
+  if (number_of_pre_packed_weights_counter == 0) {
+    return;
+  }
+
+  ASSERT_EQ(number_of_elements_in_container, static_cast<size_t>(1));
+  ASSERT_TRUE(std::filesystem::exists(cache_file));
+  const auto last_write_time = std::filesystem::last_write_time(cache_file);
+
+  // The second one uses the mapped buffers of the file and doesn't pack B into its container
+  number_of_pre_packed_weights_counter = 0;
+  run(number_of_pre_packed_weights_counter, number_of_elements_in_container);
+  ASSERT_EQ(number_of_pre_packed_weights_counter, static_cast<size_t>(1));
+  ASSERT_EQ(number_of_elements_in_container, static_cast<size_t>(0));
+  ASSERT_EQ(last_write_time, std::filesystem::last_write_time(cache_file));
+}
+
+#endif
+
+#ifdef ENABLE_STRIDED_TENSORS
+TEST(MathOpTest, MatMulStridedInputs) {
+  // A is the transpose of a 3x2 matrix, read in place with the transpose flag.
+  {
+    KernelComputeTester test("MatMul");
+    test.AddInput<float>("A", {2, 3}, {1.f, 4.f, 2.f, 5.f, 3.f, 6.f}, {1, 2});
+    test.AddInput<float>("B", {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    test.AddOutput<float>("Y", {2, 2}, {22.f, 28.f, 49.f, 64.f});
+    test.Run();
+  }
+
+  // B is the leading columns of a 3x4 matrix, read in place with the leading dimension.
+  {
+    KernelComputeTester test("MatMul");
+    test.AddInput<float>("A", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    test.AddInput<float>("B", {3, 2}, {1.f, 2.f, 0.f, 0.f, 3.f, 4.f, 0.f, 0.f, 5.f, 6.f}, {4, 1});
+    test.AddOutput<float>("Y", {2, 2}, {22.f, 28.f, 49.f, 64.f});
+    test.Run();
+  }
+
+  // A batched view of A is copied before the multiplication.
+  {
+    KernelComputeTester test("MatMul");
+    test.AddInput<float>("A", {2, 1, 3}, {1.f, 4.f, 2.f, 5.f, 3.f, 6.f}, {1, 3, 2});
+    test.AddInput<float>("B", {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    test.AddOutput<float>("Y", {2, 1, 2}, {22.f, 28.f, 49.f, 64.f});
+    test.Run();
+  }
+}
 #endif
 
 }  // namespace test
@@ -861,5 +861,28 @@ TEST(TopKOperator, SelectTopKThreaded) {
   TestThreaded<double>(k, n, batch_size);
 }
 
+// create input of 1x200000 so that the single row is split across the threads (if there are any),
+// as there are fewer rows than threads and each part has at least 16K elements
+TEST(TopKOperator, LongRowThreaded) {
+  constexpr int64_t n = 1;
+  constexpr int64_t batch_size = 200000;
+  TestThreaded<float>(1, n, batch_size);
+  TestThreaded<float>(10, n, batch_size);
+  TestThreaded<float>(3000, n, batch_size);
+  TestThreaded<double>(10, n, batch_size);
+}
+
+// the first instances of a value are selected when a long row is split across the threads
+TEST(TopKOperator, LongRowThreadedAllSame) {
+  constexpr int64_t k = 10;
+  constexpr int64_t batch_size = 200000;
+  std::vector<float> input_vals(batch_size, 0.1f);
+  std::vector<float> expected_vals(k, 0.1f);
+  std::vector<int64_t> expected_indices(k, 0);
+  std::iota(expected_indices.begin(), expected_indices.end(), 0);
+  RunTest(11, k, input_vals, {batch_size}, expected_vals, expected_indices, {k}, false);
+  RunTest(11, k, input_vals, {batch_size}, expected_vals, expected_indices, {k}, false, -1, 0);  // smallest
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -43,5 +43,25 @@ TEST(CategoryMapper, IntToString) {
 
   RunTest(dims, input, output);
 }
+
+TEST(CategoryMapper, LargeInput) {
+  // enough elements for the lookups to be split across threads
+  std::vector<int64_t> dims{4, 4096};
+
+  const std::vector<std::string> strings{"One", "Two", "Three", "Four"};
+  const std::vector<int64_t> indexes{1, 2, 3, 99};
+  const std::vector<std::string> mapped_strings{"One", "Two", "Three", "default"};
+  std::vector<std::string> string_input;
+  std::vector<int64_t> int_output;
+  std::vector<std::string> string_output;
+  for (size_t i = 0; i < 4 * 4096; ++i) {
+    string_input.push_back(strings[i % strings.size()]);
+    int_output.push_back(indexes[i % indexes.size()]);
+    string_output.push_back(mapped_strings[i % mapped_strings.size()]);
+  }
+
+  RunTest(dims, string_input, int_output);
+  RunTest(dims, int_output, string_output);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -72,6 +72,31 @@ TEST_P(LinearRegressorTest, LinearRegressorUniTarget) {
   test.Run();
 }
 
+// The coefficients are packed for the number of features they have. An input with fewer features falls back to the
+// unpacked GEMM, which scores it with the leading coefficients of each target.
+TEST(MLOpTest, LinearRegressorFeatureCountDifferentFromCoefficients) {
+  const std::vector<float> coefficients = {2.f, -1.f, 0.5f, 4.f};
+  const std::vector<float> intercepts = {1.f};
+
+  {
+    OpTester test("LinearRegressor", 1, onnxruntime::kMLDomain);
+    test.AddAttribute("intercepts", intercepts);
+    test.AddAttribute("coefficients", coefficients);
+    test.AddInput<float>("X", {2, 4}, {1.f, 2.f, 4.f, 0.5f, -3.f, 0.f, 2.f, 1.f});
+    test.AddOutput<float>("Y", {2, 1}, {5.f, 0.f});
+    test.Run();
+  }
+
+  {
+    OpTester test("LinearRegressor", 1, onnxruntime::kMLDomain);
+    test.AddAttribute("intercepts", intercepts);
+    test.AddAttribute("coefficients", coefficients);
+    test.AddInput<float>("X", {2, 3}, {1.f, 2.f, 4.f, -3.f, 0.f, 2.f});
+    test.AddOutput<float>("Y", {2, 1}, {3.f, -4.f});
+    test.Run();
+  }
+}
+
 // For PROBIT, all the output values are NaN.
 INSTANTIATE_TEST_SUITE_P(
     LinearRegressorTest, LinearRegressorTest,
@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -263,5 +266,72 @@ TEST(MLOpTest, SVMClassifierLinear) {
   test.Run();
 }
 
+// The features are far from the origin and close to the support vectors. The RBF kernels must come from the
+// distances, as the expansion |x|^2 + |sv|^2 - 2 x.sv of these in float loses the distances to rounding.
+TEST(MLOpTest, SVMClassifierRBFFeaturesFarFromOrigin) {
+  OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
+
+  constexpr int64_t num_features = 3;
+  constexpr float gamma = 0.5f;
+  // one support vector per class, in the order of the classes
+  std::vector<float> support_vectors = {4096.f, 4096.5f, 4097.f,
+                                        4097.f, 4096.f, 4096.25f,
+                                        4095.5f, 4096.75f, 4096.f};
+  // [class_count - 1, vector_count]
+  std::vector<float> coefficients = {1.f, -0.75f, 0.5f,
+                                     0.25f, 1.f, -1.25f};
+  std::vector<float> rho = {0.1f, -0.2f, 0.05f};
+  std::vector<float> kernel_params = {gamma, 0.f, 3.f};  // gamma, coef0, degree
+  std::vector<int64_t> classes = {0, 1, 2};
+  std::vector<int64_t> vectors_per_class = {1, 1, 1};
+
+  std::vector<float> X = {4096.25f, 4096.5f, 4096.75f,
+                          4097.f, 4096.25f, 4096.f,
+                          4095.5f, 4096.5f, 4096.25f,
+                          4096.75f, 4096.75f, 4096.5f};
+  const int64_t num_batches = static_cast<int64_t>(X.size()) / num_features;
+
+  // the scores of the class pairs (0, 1), (0, 2) and (1, 2), and the class with the most votes
+  std::vector<float> scores;
+  std::vector<int64_t> predictions;
+  for (int64_t n = 0; n < num_batches; ++n) {
+    double kernels[3];
+    for (int64_t v = 0; v < 3; ++v) {
+      double distance = 0.0;
+      for (int64_t f = 0; f < num_features; ++f) {
+        const double diff = double(X[n * num_features + f]) - double(support_vectors[v * num_features + f]);
+        distance += diff * diff;
+      }
+      kernels[v] = std::exp(-gamma * distance);
+    }
+
+    int64_t votes[3] = {0, 0, 0};
+    size_t classifier = 0;
+    for (int64_t i = 0; i < 2; ++i) {
+      for (int64_t j = i + 1; j < 3; ++j) {
+        const double score = coefficients[(j - 1) * 3 + i] * kernels[i] + coefficients[i * 3 + j] * kernels[j] +
+                             rho[classifier++];
+        scores.push_back(static_cast<float>(score));
+        ++votes[score > 0 ? i : j];
+      }
+    }
+    predictions.push_back(std::max_element(votes, votes + 3) - votes);
+  }
+
+  test.AddAttribute("kernel_type", std::string("RBF"));
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("vectors_per_class", vectors_per_class);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("classlabels_ints", classes);
+
+  test.AddInput<float>("X", {num_batches, num_features}, X);
+  test.AddOutput<int64_t>("Y", {num_batches}, predictions);
+  test.AddOutput<float>("Z", {num_batches, 3}, scores);
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
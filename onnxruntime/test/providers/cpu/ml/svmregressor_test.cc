@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -136,5 +138,53 @@ TEST(MLOpTest, SVMRegressorLinear) {
   test.Run();
 }
 
+// The features are far from the origin and close to the support vectors. The RBF kernels must come from the
+// distances, as the expansion |x|^2 + |sv|^2 - 2 x.sv of these in float loses the distances to rounding.
+TEST(MLOpTest, SVMRegressorRBFFeaturesFarFromOrigin) {
+  OpTester test("SVMRegressor", 1, onnxruntime::kMLDomain);
+
+  constexpr int64_t num_features = 3;
+  constexpr float gamma = 0.5f;
+  std::vector<float> dual_coefficients = {1.f, -0.5f, 2.f};
+  std::vector<float> support_vectors = {4096.f, 4096.5f, 4097.f,
+                                        4097.f, 4096.f, 4096.25f,
+                                        4095.5f, 4096.75f, 4096.f};
+  std::vector<float> rho = {0.25f};
+  std::vector<float> kernel_params = {gamma, 0.f, 3.f};  // gamma, coef0, degree
+
+  std::vector<float> X = {4096.25f, 4096.5f, 4096.75f,
+                          4097.f, 4096.25f, 4096.f,
+                          4095.5f, 4096.5f, 4096.25f,
+                          4096.75f, 4096.75f, 4096.5f,
+                          4096.f, 4096.5f, 4097.f};
+  const int64_t num_batches = static_cast<int64_t>(X.size()) / num_features;
+
+  std::vector<float> predictions;
+  for (int64_t n = 0; n < num_batches; ++n) {
+    double prediction = rho[0];
+    for (size_t v = 0; v < dual_coefficients.size(); ++v) {
+      double distance = 0.0;
+      for (int64_t f = 0; f < num_features; ++f) {
+        const double diff = double(X[n * num_features + f]) - double(support_vectors[v * num_features + f]);
+        distance += diff * diff;
+      }
+      prediction += dual_coefficients[v] * std::exp(-gamma * distance);
+    }
+    predictions.push_back(static_cast<float>(prediction));
+  }
+
+  test.AddAttribute("kernel_type", std::string("RBF"));
+  test.AddAttribute("coefficients", dual_coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("n_supports", static_cast<int64_t>(dual_coefficients.size()));
+
+  test.AddInput<float>("X", {num_batches, num_features}, X);
+  test.AddOutput<float>("Y", {num_batches, 1}, predictions);
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
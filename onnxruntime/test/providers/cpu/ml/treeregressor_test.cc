@@ -844,5 +844,42 @@ TEST(MLOpTest, TreeRegressorTrueNodeBeforeNode) {
   test.Run();
 }
 
+TEST(MLOpTest, TreeRegressorUnbalancedTreeManyRows) {
+  // The leaves are at different depths and there are enough rows to fill a few blocks of rows and a remainder
+  // when the trees are evaluated with a complete tree layout.
+  OpTester test("TreeEnsembleRegressor", 3, onnxruntime::kMLDomain);
+
+  test.AddAttribute("nodes_treeids", std::vector<int64_t>{0, 0, 0, 0, 0, 0, 0, 1, 1, 1});
+  test.AddAttribute("nodes_nodeids", std::vector<int64_t>{0, 1, 2, 3, 4, 5, 6, 0, 1, 2});
+  test.AddAttribute("nodes_featureids", std::vector<int64_t>{0, 0, 1, 0, 0, 0, 0, 1, 0, 0});
+  test.AddAttribute("nodes_values", std::vector<float>{0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.5f, 0.f, 0.f});
+  test.AddAttribute("nodes_modes", std::vector<std::string>{"BRANCH_LEQ", "LEAF", "BRANCH_LEQ", "LEAF",
+                                                            "BRANCH_LEQ", "LEAF", "LEAF",
+                                                            "BRANCH_LEQ", "LEAF", "LEAF"});
+  test.AddAttribute("nodes_truenodeids", std::vector<int64_t>{1, 0, 3, 0, 5, 0, 0, 1, 0, 0});
+  test.AddAttribute("nodes_falsenodeids", std::vector<int64_t>{2, 0, 4, 0, 6, 0, 0, 2, 0, 0});
+  test.AddAttribute("target_treeids", std::vector<int64_t>{0, 0, 0, 0, 1, 1});
+  test.AddAttribute("target_nodeids", std::vector<int64_t>{1, 3, 5, 6, 1, 2});
+  test.AddAttribute("target_ids", std::vector<int64_t>{0, 0, 0, 0, 0, 0});
+  test.AddAttribute("target_weights", std::vector<float>{1.f, 2.f, 3.f, 4.f, 10.f, 20.f});
+  test.AddAttribute("n_targets", static_cast<int64_t>(1));
+
+  constexpr int64_t n_rows = 37;
+  std::vector<float> X;
+  std::vector<float> Y;
+  for (int64_t i = 0; i < n_rows; ++i) {
+    const float x0 = static_cast<float>(i % 5) * 0.5f - 0.5f;
+    const float x1 = static_cast<float>(i % 3) * 0.5f - 0.25f;
+    X.push_back(x0);
+    X.push_back(x1);
+    const float y0 = x0 <= 0.f ? 1.f : (x1 <= 0.f ? 2.f : (x0 <= 1.f ? 3.f : 4.f));
+    const float y1 = x1 <= 0.5f ? 10.f : 20.f;
+    Y.push_back(y0 + y1);
+  }
+  test.AddInput<float>("X", {n_rows, 2}, X);
+  test.AddOutput<float>("Y", {n_rows, 1}, Y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
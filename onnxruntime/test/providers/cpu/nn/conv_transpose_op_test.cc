@@ -1190,6 +1190,132 @@ TEST(ConvTransposeTest, ConvTranspose_AutoPad_with_non_default_strides) {
                        kDmlExecutionProvider});     // TODO: Unskip when fixed #41968513
 }
 
+namespace {
+
+// Naive ConvTranspose of a {N, C, D1, ...} input with a {C, M/group, k1, ...} filter, scattering every product into
+// the padded output, to check the stride-decomposed kernels against.
+vector<float> ReferenceConvTranspose(const vector<float>& X, const vector<int64_t>& X_shape,
+                                     const vector<float>& W, const vector<int64_t>& W_shape,
+                                     const vector<float>& B, int64_t group,
+                                     const vector<int64_t>& strides, const vector<int64_t>& pads,
+                                     const vector<int64_t>& Y_shape) {
+  const size_t rank = X_shape.size() - 2;
+  const int64_t N = X_shape[0], C = X_shape[1], M = Y_shape[1];
+  const int64_t group_input_channels = C / group, group_output_channels = M / group;
+  int64_t input_size = 1, output_size = 1, kernel_size = 1;
+  for (size_t d = 0; d < rank; d++) {
+    input_size *= X_shape[2 + d];
+    output_size *= Y_shape[2 + d];
+    kernel_size *= W_shape[2 + d];
+  }
+
+  vector<float> Y(static_cast<size_t>(N * M * output_size));
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t m = 0; m < M; m++) {
+      std::fill_n(Y.begin() + (n * M + m) * output_size, output_size, B.empty() ? 0.0f : B[m]);
+    }
+    for (int64_t c = 0; c < C; c++) {
+      const int64_t g = c / group_input_channels;
+      for (int64_t i = 0; i < input_size; i++) {
+        const float x = X[(n * C + c) * input_size + i];
+        for (int64_t k = 0; k < kernel_size; k++) {
+          int64_t output_offset = 0;
+          bool is_valid = true;
+          int64_t i_rem = i, k_rem = k;
+          int64_t input_stride = input_size, kernel_stride = kernel_size;
+          for (size_t d = 0; d < rank; d++) {
+            input_stride /= X_shape[2 + d];
+            kernel_stride /= W_shape[2 + d];
+            const int64_t input_index = i_rem / input_stride;
+            const int64_t kernel_index = k_rem / kernel_stride;
+            i_rem %= input_stride;
+            k_rem %= kernel_stride;
+            const int64_t output_index = input_index * strides[d] + kernel_index - pads[d];
+            is_valid = is_valid && output_index >= 0 && output_index < Y_shape[2 + d];
+            output_offset = output_offset * Y_shape[2 + d] + output_index;
+          }
+          if (!is_valid) {
+            continue;
+          }
+          for (int64_t m = 0; m < group_output_channels; m++) {
+            Y[(n * M + g * group_output_channels + m) * output_size + output_offset] +=
+                x * W[(c * group_output_channels + m) * kernel_size + k];
+          }
+        }
+      }
+    }
+  }
+  return Y;
+}
+
+void TestConvTransposeAgainstReference(const vector<int64_t>& X_shape, const vector<int64_t>& W_shape,
+                                       int64_t group, const vector<int64_t>& strides, const vector<int64_t>& pads,
+                                       const vector<int64_t>& output_padding, bool has_bias) {
+  const size_t rank = X_shape.size() - 2;
+  vector<int64_t> Y_shape{X_shape[0], W_shape[1] * group};
+  for (size_t d = 0; d < rank; d++) {
+    Y_shape.push_back(strides[d] * (X_shape[2 + d] - 1) + output_padding[d] + W_shape[2 + d] -
+                      pads[d] - pads[rank + d]);
+  }
+
+  RandomValueGenerator random{};
+  const vector<float> X = random.Uniform<float>(X_shape, -1.0f, 1.0f);
+  const vector<float> W = random.Uniform<float>(W_shape, -1.0f, 1.0f);
+  const vector<int64_t> B_shape{Y_shape[1]};
+  const vector<float> B = has_bias ? random.Uniform<float>(B_shape, -1.0f, 1.0f) : vector<float>{};
+  const vector<float> Y = ReferenceConvTranspose(X, X_shape, W, W_shape, B, group, strides, pads, Y_shape);
+
+  ConvTransposeOpAttributes attrs{
+      vector<int64_t>(W_shape.begin() + 2, W_shape.end()),  // kernel_shape
+      output_padding,                                       // output_padding
+      {},                                                   // output_shape
+      pads,                                                 // pads
+      strides,                                              // strides
+      vector<int64_t>(rank, 1),                             // dilations
+      group,                                                // group
+      "NOTSET"                                              // auto_pad
+  };
+
+  vector<vector<float>> inputs{X, W};
+  vector<vector<int64_t>> input_shapes{X_shape, W_shape};
+  if (has_bias) {
+    inputs.push_back(B);
+    input_shapes.push_back(B_shape);
+  }
+  TestConvTransposeOp(attrs, inputs, input_shapes, Y, Y_shape,
+                      OpTester::ExpectResult::kExpectSuccess, "",
+                      {kCudaNHWCExecutionProvider, kTensorrtExecutionProvider, kQnnExecutionProvider},
+                      1e-4f, 1e-4f);
+}
+
+}  // namespace
+
+// The float CPU kernel computes each stride phase as a convolution with a sub-kernel of the filter.
+TEST(ConvTransposeTest, ConvTranspose_2D_StridePhases) {
+  // Decoder upsampling: kernel 4, stride 2, pad 1.
+  TestConvTransposeAgainstReference({2, 6, 7, 5}, {6, 4, 4, 4}, 1, {2, 2}, {1, 1, 1, 1}, {0, 0}, true);
+  // Kernel 3, stride 2 with output padding.
+  TestConvTransposeAgainstReference({1, 5, 6, 6}, {5, 3, 3, 3}, 1, {2, 2}, {1, 1, 1, 1}, {1, 1}, true);
+  // Kernel smaller than the stride, so some phases have no taps.
+  TestConvTransposeAgainstReference({1, 4, 5, 4}, {4, 3, 2, 1}, 1, {3, 2}, {0, 0, 0, 0}, {2, 1}, true);
+  // Padding larger than the sub-kernels.
+  TestConvTransposeAgainstReference({1, 3, 9, 8}, {3, 2, 5, 3}, 1, {2, 3}, {4, 2, 3, 1}, {0, 0}, false);
+  // Stride 1 is a single convolution.
+  TestConvTransposeAgainstReference({1, 4, 6, 7}, {4, 5, 3, 3}, 1, {1, 1}, {1, 0, 1, 2}, {0, 0}, true);
+}
+
+TEST(ConvTransposeTest, ConvTranspose_StridePhases_Group) {
+  TestConvTransposeAgainstReference({1, 6, 5, 5}, {6, 2, 4, 4}, 3, {2, 2}, {1, 1, 1, 1}, {0, 0}, true);
+  // Depthwise.
+  TestConvTransposeAgainstReference({2, 8, 6, 5}, {8, 1, 3, 3}, 8, {2, 2}, {1, 1, 1, 1}, {1, 0}, false);
+}
+
+TEST(ConvTransposeTest, ConvTranspose_StridePhases_1D_3D) {
+  TestConvTransposeAgainstReference({2, 3, 11}, {3, 4, 5}, 1, {3}, {2, 1}, {1}, true);
+  TestConvTransposeAgainstReference({1, 2, 3, 4, 3}, {2, 3, 2, 4, 3}, 1, {2, 2, 2}, {0, 1, 1, 0, 1, 0}, {1, 0, 0},
+                                    true);
+}
+
 #ifndef ENABLE_TRAINING
 // Prepacking is disabled in full training build so no need to test the feature in a training build.
 TEST(ConvTransposeTest, SharedPrepackedWeights) {
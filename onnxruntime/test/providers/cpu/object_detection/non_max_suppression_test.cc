@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <numeric>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -383,5 +386,53 @@ TEST(NonMaxSuppressionOpTest, WithIOUThresholdOpset11) {
   test.Run();
 }
 
+TEST(NonMaxSuppressionOpTest, ManyBatchesAndClasses) {
+  // Every batch holds kDistinct disjoint boxes, each followed by a copy with a slightly lower score that must be
+  // suppressed. The scores are a different permutation for every (batch, class) pair, so the expected selection is
+  // the top max_output_boxes_per_class distinct boxes of each pair, reported in (batch, class) order.
+  constexpr int64_t kBatches = 3;
+  constexpr int64_t kClasses = 5;
+  constexpr int64_t kDistinct = 100;
+  constexpr int64_t kBoxes = 2 * kDistinct;
+  constexpr int64_t kMaxOutput = 4;
+
+  std::vector<float> boxes;
+  for (int64_t b = 0; b < kBatches; b++) {
+    for (int64_t i = 0; i < kBoxes; i++) {
+      const float x = static_cast<float>(2 * (i / 2));
+      boxes.insert(boxes.end(), {0.0f, x, 1.0f, x + 1.0f});
+    }
+  }
+
+  std::vector<float> scores;
+  std::vector<int64_t> expected;
+  for (int64_t b = 0; b < kBatches; b++) {
+    for (int64_t c = 0; c < kClasses; c++) {
+      std::vector<float> distinct_scores(kDistinct);
+      for (int64_t i = 0; i < kDistinct; i++) {
+        distinct_scores[i] = static_cast<float>((i * 7 + c * 13 + b * 29) % kDistinct + 1) / kDistinct;
+        scores.push_back(distinct_scores[i]);
+        scores.push_back(distinct_scores[i] - 0.001f);
+      }
+      std::vector<int64_t> order(kDistinct);
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(),
+                [&](int64_t lhs, int64_t rhs) { return distinct_scores[lhs] > distinct_scores[rhs]; });
+      for (int64_t k = 0; k < kMaxOutput; k++) {
+        expected.insert(expected.end(), {b, c, 2 * order[k]});
+      }
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {kBatches, kBoxes, 4}, boxes);
+  test.AddInput<float>("scores", {kBatches, kClasses, kBoxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {kMaxOutput});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {kBatches * kClasses * kMaxOutput, 3}, expected);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
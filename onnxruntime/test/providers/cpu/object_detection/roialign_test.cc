@@ -812,5 +812,38 @@ TEST(RoiAlignTest, MismatchNumRois) {
 
   test.Run(OpTester::ExpectResult::kExpectFailure, "[ShapeInferenceError] Dimension mismatch in unification between 4 and 5");
 }
+
+TEST(RoiAlignTest, AvgModeManyChannels) {
+  // Few rois with many channels, whose channels may be split between threads.
+  OpTester test("RoiAlign", 16);
+  test.AddAttribute<int64_t>("output_height", 2);
+  test.AddAttribute<int64_t>("output_width", 3);
+  test.AddAttribute<int64_t>("sampling_ratio", 2);
+  test.AddAttribute<float>("spatial_scale", 1.0f);
+
+  constexpr int64_t N = 2;
+  constexpr int64_t C = 37;
+  constexpr int64_t H = 8;
+  constexpr int64_t W = 8;
+  constexpr int64_t num_rois = 2;
+
+  // Every channel of an image is constant, so that the average of any roi is that constant.
+  std::vector<float> X(N * C * H * W);
+  for (int64_t i = 0; i < N * C; i++) {
+    std::fill_n(X.begin() + i * H * W, H * W, static_cast<float>(i) + 0.5f);
+  }
+  std::vector<float> Y;
+  for (int64_t n : {1, 0}) {
+    for (int64_t c = 0; c < C; c++) {
+      Y.insert(Y.end(), 2 * 3, static_cast<float>(n * C + c) + 0.5f);
+    }
+  }
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("rois", {num_rois, 4}, {1., 1., 6., 5., 0.5, 2., 7., 7.5});
+  test.AddInput<int64_t>("batch_indices", {num_rois}, {1, 0});
+  test.AddOutput<float>("Y", {num_rois, C, 2, 3}, Y);
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
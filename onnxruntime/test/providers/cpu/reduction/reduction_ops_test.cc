@@ -6014,6 +6014,118 @@ TEST(ReductionOpTest, ReduceSum_RKRK_keepdims) {
   test.Run();
 }
 
+// Compares the reduction of a random input to a reference computed in double precision, for the shapes that map
+// to each of the fast reduction kinds and to the strided implementation.
+static void TestReduceFastKinds(const std::string& op, bool positive_input) {
+  struct Case {
+    std::vector<int64_t> shape;
+    std::vector<int64_t> axes;
+  };
+  const std::vector<Case> cases = {
+      {{64, 33}, {1}},               // KR
+      {{2048, 32}, {0}},             // RK
+      {{8, 17, 9}, {1}},             // KRK
+      {{5, 8, 7}, {0, 2}},           // RKR
+      {{3, 5, 4, 30}, {1, 3}},       // KRKR
+      {{4, 3, 5, 40}, {0, 2}},       // RKRK
+      {{2, 3, 4, 5, 6}, {0, 2, 4}},  // RKRKR
+  };
+
+  std::default_random_engine generator(17);
+  std::uniform_real_distribution<float> distribution(positive_input ? 0.5f : -2.f, 2.f);
+
+  for (const auto& c : cases) {
+    const size_t rank = c.shape.size();
+    int64_t input_size = std::accumulate(c.shape.begin(), c.shape.end(), static_cast<int64_t>(1), std::multiplies<int64_t>());
+    std::vector<float> data(static_cast<size_t>(input_size));
+    for (auto& v : data) {
+      v = distribution(generator);
+    }
+
+    std::vector<int64_t> output_shape;
+    for (size_t i = 0; i < rank; ++i) {
+      if (std::find(c.axes.begin(), c.axes.end(), static_cast<int64_t>(i)) == c.axes.end()) {
+        output_shape.push_back(c.shape[i]);
+      }
+    }
+    int64_t output_size = std::accumulate(output_shape.begin(), output_shape.end(), static_cast<int64_t>(1), std::multiplies<int64_t>());
+
+    // Gathers the elements reduced into every output.
+    std::vector<std::vector<double>> groups(static_cast<size_t>(output_size));
+    std::vector<int64_t> index(rank, 0);
+    for (int64_t i = 0; i < input_size; ++i) {
+      int64_t o = 0;
+      for (size_t a = 0; a < rank; ++a) {
+        if (std::find(c.axes.begin(), c.axes.end(), static_cast<int64_t>(a)) == c.axes.end()) {
+          o = o * c.shape[a] + index[a];
+        }
+      }
+      groups[static_cast<size_t>(o)].push_back(data[static_cast<size_t>(i)]);
+      for (size_t a = rank; a-- > 0;) {
+        if (++index[a] < c.shape[a]) break;
+        index[a] = 0;
+      }
+    }
+
+    std::vector<float> expected;
+    for (const auto& g : groups) {
+      double value = 0;
+      if (op == "ReduceLogSumExp") {
+        double shift = *std::max_element(g.begin(), g.end());
+        for (double v : g) value += std::exp(v - shift);
+        value = std::log(value) + shift;
+      } else {
+        for (double v : g) {
+          value += op == "ReduceL1" ? std::abs(v) : (op == "ReduceLogSum" ? v : v * v);
+        }
+        if (op == "ReduceL2") value = std::sqrt(value);
+        if (op == "ReduceLogSum") value = std::log(value);
+      }
+      expected.push_back(static_cast<float>(value));
+    }
+
+    OpTester test(op.c_str());
+    test.AddAttribute("axes", c.axes);
+    test.AddAttribute("keepdims", (int64_t)0);
+    test.AddInput<float>("data", c.shape, data);
+    test.AddOutput<float>("reduced", output_shape, expected);
+    test.SetOutputRelErr("reduced", 1e-4f);
+    test.Run();
+  }
+}
+
+TEST(ReductionOpTest, ReduceL1_FastKinds) {
+  TestReduceFastKinds("ReduceL1", false);
+}
+
+TEST(ReductionOpTest, ReduceL2_FastKinds) {
+  TestReduceFastKinds("ReduceL2", false);
+}
+
+TEST(ReductionOpTest, ReduceSumSquare_FastKinds) {
+  TestReduceFastKinds("ReduceSumSquare", false);
+}
+
+TEST(ReductionOpTest, ReduceLogSum_FastKinds) {
+  TestReduceFastKinds("ReduceLogSum", true);
+}
+
+TEST(ReductionOpTest, ReduceLogSumExp_FastKinds) {
+  TestReduceFastKinds("ReduceLogSumExp", false);
+}
+
+TEST(ReductionOpTest, ReduceLogSumExp_KR_Infinity) {
+  OpTester test("ReduceLogSumExp");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<float>("data", {3, 3},
+                       {FLOAT_NINF, FLOAT_NINF, FLOAT_NINF,
+                        1.0f, FLOAT_INF, 2.0f,
+                        FLOAT_NINF, 0.0f, 0.0f});
+  test.AddOutput<float>("reduced", {3}, {FLOAT_NINF, FLOAT_INF, std::log(2.0f)});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
 void test_empty_set(const std::string& op, int opset, bool axes_as_input, float empty_value) {
   OpTester test(op, opset);
   std::vector<int64_t> input_shape = {2, 0, 4};
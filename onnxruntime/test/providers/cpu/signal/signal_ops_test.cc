@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <functional>
 #include <vector>
 
@@ -116,6 +117,62 @@ TEST(SignalOpsTest, DFT20_Float_inverse) {
   TestInverseFloat(kOpsetVersion20);
 }
 
+// Computes the DFT of the frame of x that starts at begin by the definition, with the samples multiplied by window.
+static vector<float> NaiveDFT(const vector<float>& x, size_t begin, size_t length, const vector<float>& window,
+                              size_t output_size) {
+  vector<float> output;
+  for (size_t k = 0; k < output_size; k++) {
+    double real = 0, imaginary = 0;
+    for (size_t n = 0; n < length; n++) {
+      const double angle = -2. * M_PI * static_cast<double>(k * n % length) / static_cast<double>(length);
+      const double sample = static_cast<double>(x[begin + n]) * (window.empty() ? 1. : window[n]);
+      real += sample * std::cos(angle);
+      imaginary += sample * std::sin(angle);
+    }
+    output.push_back(static_cast<float>(real));
+    output.push_back(static_cast<float>(imaginary));
+  }
+  return output;
+}
+
+// Lengths with prime factors 2, 3 and 5 run the mixed radix FFT, the others fall back to Bluestein's algorithm.
+static void TestDFTFloatOfLength(int64_t length, bool onesided) {
+  OpTester test("DFT", kOpsetVersion20);
+
+  RandomValueGenerator random(GetTestRandomSeed());
+  constexpr int64_t num_batches = 3;
+  vector<float> input = random.Uniform<float>({num_batches, length}, -1.f, 1.f);
+  const int64_t output_size = onesided ? (length >> 1) + 1 : length;
+  vector<float> expected_output;
+  for (int64_t b = 0; b < num_batches; b++) {
+    vector<float> batch_output = NaiveDFT(input, static_cast<size_t>(b * length), static_cast<size_t>(length), {},
+                                          static_cast<size_t>(output_size));
+    expected_output.insert(expected_output.end(), batch_output.begin(), batch_output.end());
+  }
+
+  test.AddInput<float>("input", {num_batches, length, 1}, input);
+  test.AddInput<int64_t>("dft_length", {}, {length});
+  test.AddInput<int64_t>("axis", {}, {1});
+  test.AddAttribute<int64_t>("onesided", static_cast<int64_t>(onesided));
+  test.AddOutput<float>("output", {num_batches, output_size, 2}, expected_output);
+  test.SetOutputAbsErr("output", 0.001f);
+  test.Run();
+}
+
+TEST(SignalOpsTest, DFT20_Float_mixed_radix) {
+  for (int64_t length : {6, 12, 15, 60, 400}) {
+    TestDFTFloatOfLength(length, false);
+    TestDFTFloatOfLength(length, true);
+  }
+}
+
+TEST(SignalOpsTest, DFT20_Float_bluestein) {
+  for (int64_t length : {7, 22}) {
+    TestDFTFloatOfLength(length, false);
+    TestDFTFloatOfLength(length, true);
+  }
+}
+
 // Tests that FFT(FFT(x), inverse=true) == x
 static void TestDFTInvertible(bool complex, int since_version) {
   // TODO: test dft_length
@@ -233,6 +290,39 @@ TEST(SignalOpsTest, STFTFloat) {
   test.Run();
 }
 
+// n_fft = 400 as in the audio front ends, which runs the mixed radix FFT.
+TEST(SignalOpsTest, STFTFloat_mixed_radix) {
+  OpTester test("STFT", kMinOpsetVersion);
+
+  RandomValueGenerator random(GetTestRandomSeed());
+  constexpr int64_t batch_size = 2;
+  constexpr int64_t signal_length = 1200;
+  constexpr int64_t frame_length = 400;
+  constexpr int64_t frame_step = 160;
+  constexpr int64_t n_dfts = (signal_length - frame_length) / frame_step + 1;
+  constexpr int64_t output_size = (frame_length >> 1) + 1;
+  vector<float> signal = random.Uniform<float>({batch_size, signal_length}, -1.f, 1.f);
+  vector<float> window = random.Uniform<float>({frame_length}, 0.f, 1.f);
+
+  vector<float> expected_output;
+  for (int64_t b = 0; b < batch_size; b++) {
+    for (int64_t i = 0; i < n_dfts; i++) {
+      vector<float> frame_output = NaiveDFT(signal, static_cast<size_t>(b * signal_length + i * frame_step),
+                                            static_cast<size_t>(frame_length), window,
+                                            static_cast<size_t>(output_size));
+      expected_output.insert(expected_output.end(), frame_output.begin(), frame_output.end());
+    }
+  }
+
+  test.AddInput<float>("signal", {batch_size, signal_length, 1}, signal);
+  test.AddInput<int64_t>("frame_step", {}, {frame_step});
+  test.AddInput<float>("window", {frame_length}, window);
+  test.AddInput<int64_t>("frame_length", {}, {frame_length});
+  test.AddOutput<float>("output", {batch_size, n_dfts, output_size, 2}, expected_output);
+  test.SetOutputAbsErr("output", 0.001f);
+  test.Run();
+}
+
 TEST(SignalOpsTest, HannWindowFloat) {
   OpTester test("HannWindow", kMinOpsetVersion);
 
@@ -148,5 +148,53 @@ TEST(CompressTest, Compress_3dims_neg_axis) {
   test.Run();
 }
 
+// Large enough to be counted and copied in several blocks, in parallel.
+TEST(CompressTest, Compress_default_axis_large) {
+  OpTester test("Compress", 11);
+
+  constexpr size_t elements = 100003;
+  std::vector<int32_t> input(elements);
+  std::unique_ptr<bool[]> condition = std::make_unique<bool[]>(elements);
+  std::vector<int32_t> output;
+  for (size_t i = 0; i < elements; ++i) {
+    input[i] = static_cast<int32_t>(i);
+    condition[i] = (i % 3 == 0) || (i % 1000 < 10);
+    if (condition[i]) {
+      output.push_back(static_cast<int32_t>(i));
+    }
+  }
+
+  test.AddInput<int32_t>("input", {static_cast<int64_t>(elements)}, input);
+  test.AddInput<bool>("condition", {static_cast<int64_t>(elements)}, condition.get(), elements);
+  test.AddOutput<int32_t>("output", {static_cast<int64_t>(output.size())}, output);
+  test.Run();
+}
+
+TEST(CompressTest, Compress_axis_many_outer_slices) {
+  OpTester test("Compress", 11);
+  test.AddAttribute("axis", int64_t(1));
+
+  constexpr int64_t outer = 64;
+  constexpr int64_t inner = 3;
+  std::vector<float> input;
+  std::vector<float> output;
+  for (int64_t i = 0; i < outer; ++i) {
+    for (int64_t j = 0; j < 4; ++j) {
+      for (int64_t k = 0; k < inner; ++k) {
+        const float value = static_cast<float>((i * 4 + j) * inner + k);
+        input.push_back(value);
+        if (j == 0 || j == 2) {
+          output.push_back(value);
+        }
+      }
+    }
+  }
+
+  test.AddInput<float>("input", {outer, 4, inner}, input);
+  test.AddInput<bool>("condition", {4}, {1, 0, 1, 0});
+  test.AddOutput<float>("output", {outer, 2, inner}, output);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -430,6 +430,36 @@ TEST(GatherOpTest, Gather_axis1_scalar_indices) {
   run_test(false);
   run_test(true);
 }
+
+TEST(GatherOpTest, Gather_axis1_scalar_elements_large) {
+  // Each index gathers a single element, with negative indices mixed in.
+  constexpr int64_t kRows = 7;
+  constexpr int64_t kColumns = 50;
+  constexpr int64_t kIndices = 3000;
+  std::vector<int32_t> data(kRows * kColumns);
+  for (int64_t i = 0; i < kRows * kColumns; i++) {
+    data[i] = static_cast<int32_t>(i * 3 + 1);
+  }
+  std::vector<int64_t> indices(kIndices);
+  std::vector<int32_t> expected(kRows * kIndices);
+  for (int64_t i = 0; i < kIndices; i++) {
+    indices[i] = (i % 2 == 0) ? (i * 7) % kColumns : -1 - (i * 11) % kColumns;
+  }
+  for (int64_t r = 0; r < kRows; r++) {
+    for (int64_t i = 0; i < kIndices; i++) {
+      const int64_t column = indices[i] < 0 ? indices[i] + kColumns : indices[i];
+      expected[r * kIndices + i] = data[r * kColumns + column];
+    }
+  }
+
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 1LL);
+  test.AddInput<int32_t>("data", {kRows, kColumns}, data);
+  test.AddInput<int64_t>("indices", {kIndices}, indices);
+  test.AddOutput<int32_t>("output", {kRows, kIndices}, expected);
+  test.Run();
+}
+
 #ifdef ENABLE_TRAINING_OPS
 // Should remove the shrunken_gather include from ENABLE_TRAINING_OPS once 1). compute optimizer is enabled for inference or
 // 2). this is needed by inference for other purpose.
@@ -1007,5 +1007,70 @@ TYPED_TEST(GridSampleTest, test_grid_sample_20_4D_bicubic_reflection_no_align_co
   RunTests(test, GetExecutionProviders(20));
 }
 
+// Samples an image of several rows and channels at its pixels and one pixel outside of its left border, which covers
+// the sampling points that are shared by the channels of a row and the padding modes.
+static void RunGridSamplePixelTest(const std::string& mode, const std::string& padding_mode) {
+  constexpr int64_t N = 2;
+  constexpr int64_t C = 3;
+  constexpr int64_t H = 17;
+  constexpr int64_t W = 23;
+  constexpr int64_t W_out = W + 1;
+
+  std::vector<float> X_data(N * C * H * W);
+  for (size_t i = 0; i < X_data.size(); i++) {
+    X_data[i] = static_cast<float>(i % 97) * 0.25f - 7.0f;
+  }
+
+  std::vector<float> Grid_data;
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t y = 0; y < H; y++) {
+      for (int64_t x = -1; x < W; x++) {
+        Grid_data.push_back(2.0f * static_cast<float>(x) / (W - 1) - 1.0f);
+        Grid_data.push_back(2.0f * static_cast<float>(y) / (H - 1) - 1.0f);
+      }
+    }
+  }
+
+  std::vector<float> Y_data;
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t c = 0; c < C; c++) {
+      const float* X_image = X_data.data() + (n * C + c) * H * W;
+      for (int64_t y = 0; y < H; y++) {
+        // The column left of the image is padding: zeros, the first column or the reflected second column.
+        if (padding_mode == "zeros") {
+          Y_data.push_back(0.0f);
+        } else if (padding_mode == "border") {
+          Y_data.push_back(X_image[y * W]);
+        } else {
+          Y_data.push_back(X_image[y * W + 1]);
+        }
+        Y_data.insert(Y_data.end(), X_image + y * W, X_image + (y + 1) * W);
+      }
+    }
+  }
+
+  OpTester test("GridSample", 20);
+  test.AddAttribute("mode", mode);
+  test.AddAttribute("padding_mode", padding_mode);
+  test.AddAttribute("align_corners", int64_t{1});
+  test.AddInput<float>("X", {N, C, H, W}, X_data);
+  test.AddInput<float>("Grid", {N, H, W_out, 2}, Grid_data);
+  test.AddOutput<float>("Y", {N, C, H, W_out}, Y_data);
+  test.SetOutputAbsErr("Y", 1e-4f);
+  test.ConfigEp(DefaultCpuExecutionProvider()).RunWithConfig();
+}
+
+TEST(GridSampleCpuTest, LinearPixels) {
+  for (const char* padding_mode : {"zeros", "border", "reflection"}) {
+    RunGridSamplePixelTest("linear", padding_mode);
+  }
+}
+
+TEST(GridSampleCpuTest, NearestPixels) {
+  for (const char* padding_mode : {"zeros", "border", "reflection"}) {
+    RunGridSamplePixelTest("nearest", padding_mode);
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
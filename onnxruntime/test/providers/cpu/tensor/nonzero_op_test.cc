@@ -99,5 +99,30 @@ TEST(NonZeroOpTest, EmptyInput) {
   test.Run();
 }
 
+// Large enough to be counted and written in several blocks, in parallel.
+TEST(NonZeroOpTest, LargeInput) {
+  constexpr int64_t rows = 301;
+  constexpr int64_t cols = 257;
+  std::vector<float> X(rows * cols);
+  std::vector<int64_t> row_indices;
+  std::vector<int64_t> col_indices;
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      if ((r * 31 + c * 17) % 7 == 0) {
+        X[r * cols + c] = static_cast<float>(c + 1);
+        row_indices.push_back(r);
+        col_indices.push_back(c);
+      }
+    }
+  }
+  std::vector<int64_t> Y(row_indices);
+  Y.insert(Y.end(), col_indices.begin(), col_indices.end());
+
+  OpTester test{kOpName, kOpVersion};
+  test.AddInput<float>("X", {rows, cols}, X);
+  test.AddOutput<int64_t>("Y", {2, static_cast<int64_t>(row_indices.size())}, Y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1565,6 +1565,69 @@ TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_MultiChannel) {
   test.AddOutput<float>("Y", {N, C, sizes[2], sizes[3]}, Y);
   test.Run();
 }
+
+// The output is larger than the resizes run on the calling thread, so the per-axis tables of the bicubic
+// resize are used by the operator thread pool, with the first and last rows and the last columns extrapolated.
+TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_MultiChannel_exclude_outside_extrapolation) {
+  OpTester test("Resize", 13);
+  std::vector<float> scales{};
+  std::vector<int64_t> sizes{1, 2, 10, 12};
+  std::vector<float> roi{0.0f, 0.0f, -0.1f, 0.2f, 1.0f, 1.0f, 1.05f, 1.1f};
+
+  test.AddAttribute("mode", "cubic");
+  test.AddAttribute("coordinate_transformation_mode", "tf_crop_and_resize");
+  test.AddAttribute("exclude_outside", static_cast<int64_t>(1));
+  test.AddAttribute("cubic_coeff_a", -0.5f);
+  test.AddAttribute("extrapolation_value", 10.0f);
+
+  constexpr int64_t N = 1, C = 2, H = 6, W = 8;
+  std::vector<float> X = {
+      -5.0f, 0.0f, 5.0f, -1.0f, 4.0f, -2.0f, 3.0f, -3.0f,
+      -2.0f, 3.0f, -3.0f, 2.0f, -4.0f, 1.0f, -5.0f, 0.0f,
+      1.0f, -5.0f, 0.0f, 5.0f, -1.0f, 4.0f, -2.0f, 3.0f,
+      4.0f, -2.0f, 3.0f, -3.0f, 2.0f, -4.0f, 1.0f, -5.0f,
+      -4.0f, 1.0f, -5.0f, 0.0f, 5.0f, -1.0f, 4.0f, -2.0f,
+      -1.0f, 4.0f, -2.0f, 3.0f, -3.0f, 2.0f, -4.0f, 1.0f,
+
+      2.0f, -4.0f, 1.0f, -5.0f, 0.0f, 5.0f, -1.0f, 4.0f,
+      5.0f, -1.0f, 4.0f, -2.0f, 3.0f, -3.0f, 2.0f, -4.0f,
+      -3.0f, 2.0f, -4.0f, 1.0f, -5.0f, 0.0f, 5.0f, -1.0f,
+      0.0f, 5.0f, -1.0f, 4.0f, -2.0f, 3.0f, -3.0f, 2.0f,
+      3.0f, -3.0f, 2.0f, -4.0f, 1.0f, -5.0f, 0.0f, 5.0f,
+      -5.0f, 0.0f, 5.0f, -1.0f, 4.0f, -2.0f, 3.0f, -3.0f};
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("roi", {8}, roi);
+  test.AddInput<float>("", {0}, scales);
+  test.AddInput<int64_t>("sizes", {4}, sizes);
+
+  std::vector<float> Y = {
+      10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f,
+      2.41333f, 4.2569f, 1.41525f, -0.636092f, 2.37902f, 2.34318f, -1.34687f, -0.312495f, 2.25288f, -0.523764f, 10.0f, 10.0f,
+      1.48684f, -1.64686f, -0.0549926f, 1.04203f, -1.74861f, -2.225f, 0.0704336f, -1.21775f, -3.66724f, -2.14612f, 10.0f, 10.0f,
+      -1.2783f, -2.57569f, 1.35783f, 3.48401f, -1.81953f, -2.48662f, 2.39953f, 0.106073f, -4.51401f, -1.13269f, 10.0f, 10.0f,
+      -3.79236f, 0.0427823f, 3.43972f, 4.55363f, 0.491531f, -0.0808378f, 3.52565f, 1.72874f, -1.8192f, 0.643289f, 10.0f, 10.0f,
+      -1.28313f, 2.8507f, 0.92678f, -1.00566f, 0.621146f, 0.505914f, -1.74204f, -1.26724f, 0.0898841f, -1.65129f, 10.0f, 10.0f,
+      -0.372148f, 0.759981f, -1.56137f, -2.44595f, 2.15331f, 2.12028f, -3.25191f, -1.56481f, 2.40991f, -1.57455f, 10.0f, 10.0f,
+      -1.16096f, -4.89268f, -2.90566f, 0.575964f, 4.29264f, 3.95847f, -0.601391f, 0.770495f, 4.06463f, 0.663437f, 10.0f, 10.0f,
+      0.812605f, -3.33176f, -0.521478f, 2.1801f, 0.531302f, 0.00734047f, 1.06966f, 0.259965f, -1.15638f, -0.520674f, 10.0f, 10.0f,
+      10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f,
+
+      10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f,
+      -1.98407f, 1.33763f, -2.10981f, -4.65567f, -1.51818f, 1.67957f, 4.1312f, 2.39474f, -0.73717f, 1.3741f, 10.0f, 10.0f,
+      0.224194f, 3.95827f, 0.149539f, -2.59881f, 1.54221f, 2.28306f, -1.23682f, -0.689992f, 1.23847f, -0.947916f, 10.0f, 10.0f,
+      0.451093f, 0.900608f, -0.0304704f, -0.760306f, -0.157747f, -0.753783f, -2.6008f, 0.113255f, 3.81019f, -0.237314f, 10.0f, 10.0f,
+      -0.0548813f, -4.07956f, -1.09073f, 0.900171f, -3.63413f, -4.52224f, -0.774614f, 2.63166f, 4.81805f, 1.68742f, 10.0f, 10.0f,
+      2.34698f, -2.24502f, 1.24085f, 3.57735f, -1.60162f, -2.34278f, 2.31166f, 1.71979f, -0.989352f, 0.0362753f, 10.0f, 10.0f,
+      1.72267f, 0.0183981f, 1.0f, 1.59516f, -0.335569f, -0.725863f, 0.708829f, -0.819004f, -2.83499f, 0.708745f, 10.0f, 10.0f,
+      -1.25063f, 1.91856f, -1.38615f, -3.77123f, -0.142717f, -0.131897f, -4.45421f, -3.71936f, -0.179805f, 3.22832f, 10.0f, 10.0f,
+      1.06868f, 4.1186f, 0.44955f, -2.18699f, 1.91059f, 1.9569f, -2.84913f, -1.58897f, 2.08193f, 1.03749f, 10.0f, 10.0f,
+      10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f, 10.0f};
+
+  test.AddOutput<float>("Y", {N, C, sizes[2], sizes[3]}, Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
+}
+
 TEST(ResizeOpTest, ResizeOpCubicUpSampleTest_tf_half_pixel_for_nn) {
   // tf_half_pixel_for_nn has been deprecated since opset 13
   OpTester test("Resize", 12);
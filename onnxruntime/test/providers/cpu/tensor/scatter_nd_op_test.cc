@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -235,5 +237,30 @@ TEST(ScatterNDOpTest, ScatterND_18_max) {
   test1.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
 }
 
+TEST(ScatterNDOpTest, ScatterND_18_add_many_duplicates) {
+  // Many updates accumulate into the same few slices, which must be applied without racing each other.
+  constexpr int64_t kSlices = 8;
+  constexpr int64_t kUpdates = 4000;
+  constexpr int64_t kSliceSize = 3;
+  std::vector<int64_t> indices(kUpdates);
+  std::vector<float> updates(kUpdates * kSliceSize);
+  std::vector<float> expected(kSlices * kSliceSize, 1.0f);
+  for (int64_t i = 0; i < kUpdates; i++) {
+    indices[i] = (i * 5) % kSlices;
+    for (int64_t j = 0; j < kSliceSize; j++) {
+      updates[i * kSliceSize + j] = static_cast<float>(i % 16 + j);
+      expected[indices[i] * kSliceSize + j] += updates[i * kSliceSize + j];
+    }
+  }
+
+  OpTester test1("ScatterND", 18);
+  test1.AddAttribute("reduction", "add");
+  test1.AddInput<float>("data", {kSlices, kSliceSize}, std::vector<float>(kSlices * kSliceSize, 1.0f));
+  test1.AddInput<int64_t>("indices", {kUpdates, 1}, indices);
+  test1.AddInput<float>("updates", {kUpdates, kSliceSize}, updates);
+  test1.AddOutput<float>("output", {kSlices, kSliceSize}, expected);
+  test1.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -7,6 +7,10 @@
 #include "test/util/include/default_providers.h"
 #include "test/common/tensor_op_test_utils.h"
 
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
+
 namespace onnxruntime {
 namespace test {
 
@@ -782,5 +786,45 @@ TEST(SliceTest, CoalesceDims) {
   RunSliceTest<float>({1, 1, 1}, {1.f}, {0}, {std::numeric_limits<int64_t>::max()}, {1}, {}, {1, 1, 1}, {1.f}, true);
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+TEST(SliceTest, StridedOutput) {
+  // Generate contiguous output.
+  {
+    KernelComputeTester test("Slice");
+    test.AddInput<float>("data", {2, 4}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f});
+    test.AddInput<int64_t>("starts", {1}, {0});
+    test.AddInput<int64_t>("ends", {1}, {4});
+    test.AddInput<int64_t>("axes", {1}, {1});
+    test.AddInput<int64_t>("steps", {1}, {2});
+    test.AddOutput<float>("output", {2, 2}, {1.f, 3.f, 5.f, 7.f});
+    test.Run();
+  }
+
+  // Every other column.
+  {
+    KernelComputeTester test("Slice");
+    test.AddInput<float>("data", {2, 4}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f});
+    test.AddInput<int64_t>("starts", {1}, {0});
+    test.AddInput<int64_t>("ends", {1}, {4});
+    test.AddInput<int64_t>("axes", {1}, {1});
+    test.AddInput<int64_t>("steps", {1}, {2});
+    test.AddOutput<float>("output", {2, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f}, {4, 2});
+    test.Run({0});
+  }
+
+  // Leading columns of a 3D tensor, the outer dims are coalesced.
+  {
+    KernelComputeTester test("Slice");
+    test.AddInput<float>("data", {2, 2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f});
+    test.AddInput<int64_t>("starts", {1}, {0});
+    test.AddInput<int64_t>("ends", {1}, {2});
+    test.AddInput<int64_t>("axes", {1}, {2});
+    test.AddOutput<float>("output", {2, 2, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f},
+                          {6, 3, 1});
+    test.Run({0});
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
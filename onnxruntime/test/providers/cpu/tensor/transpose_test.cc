@@ -9,6 +9,10 @@
 #include "test/util/include/default_providers.h"
 #include "test/util/include/asserts.h"
 
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
+
 namespace onnxruntime {
 namespace test {
 
@@ -769,6 +773,64 @@ TEST(TransposeOpTest, DoTransposeEltWise) {
   }
 }
 
+template <typename T>
+static void TiledTransposeTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+  const int64_t size = TensorShape(input_shape).Size();
+
+  std::vector<T> input_vals(static_cast<size_t>(size));
+  for (size_t i = 0; i < input_vals.size(); ++i) {
+    input_vals[i] = static_cast<T>(i % 127);
+  }
+
+  std::vector<int64_t> expected_shape(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    expected_shape[i] = input_shape[perm[i]];
+  }
+
+  std::vector<int64_t> input_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    input_strides[i - 1] = input_strides[i] * input_shape[i];
+  }
+
+  std::vector<T> expected_vals(input_vals.size());
+  for (size_t o = 0; o < expected_vals.size(); ++o) {
+    int64_t remaining = static_cast<int64_t>(o);
+    int64_t offset = 0;
+    for (size_t i = rank; i-- > 0;) {
+      offset += (remaining % expected_shape[i]) * input_strides[perm[i]];
+      remaining /= expected_shape[i];
+    }
+    expected_vals[o] = input_vals[static_cast<size_t>(offset)];
+  }
+
+  TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals,
+                {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
+// Permutations that move more than one axis use the tiled transpose.
+TEST(TransposeOpTest, TiledTranspose) {
+  // merged to a 2D transpose of {6, 35}
+  TiledTransposeTest<float>({2, 3, 5, 7}, {2, 3, 0, 1});
+  TiledTransposeTest<float>({3, 70, 67}, {2, 1, 0});
+  TiledTransposeTest<float>({70, 3, 67}, {2, 1, 0});
+  // NCDHW to NHWCD, merged to a 3D transpose of {2, 15, 99}
+  TiledTransposeTest<float>({2, 5, 3, 9, 11}, {0, 3, 4, 1, 2});
+  TiledTransposeTest<float>({4, 65, 3, 66}, {3, 2, 1, 0});
+  TiledTransposeTest<float>({2, 3, 4, 5, 6}, {4, 1, 3, 0, 2});
+  // axes of size one are dropped
+  TiledTransposeTest<float>({1, 17, 1, 130, 3}, {4, 3, 2, 0, 1});
+
+  // the innermost axis stays in place and is folded into the element
+  TiledTransposeTest<uint8_t>({9, 5, 7, 2}, {2, 1, 0, 3});
+  TiledTransposeTest<int16_t>({9, 5, 7, 2}, {2, 1, 0, 3});
+  TiledTransposeTest<float>({9, 5, 7, 2}, {2, 1, 0, 3});
+
+  TiledTransposeTest<uint8_t>({3, 70, 67, 2}, {2, 0, 3, 1});
+  TiledTransposeTest<int16_t>({3, 70, 67, 2}, {3, 1, 2, 0});
+  TiledTransposeTest<double>({3, 70, 67, 2}, {2, 3, 0, 1});
+}
+
 #if USE_CUDA
 constexpr const char* kGpuExecutionProvider = kCudaExecutionProvider;
 #elif USE_ROCM
@@ -869,5 +931,28 @@ TEST(TransposeOpTest, TransposeBigMLFloat16) {  // Exercises CanUse_cublasTransp
 }
 #endif  // defined(USE_CUDA) || defined(USE_ROCM)
 
+#ifdef ENABLE_STRIDED_TENSORS
+TEST(TransposeOpTest, StridedOutput) {
+  // Generate contiguous output.
+  {
+    KernelComputeTester test("Transpose");
+    test.AddAttribute("perm", std::vector<int64_t>{1, 0});
+    test.AddInput<float>("X", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    test.AddOutput<float>("Y", {3, 2}, {1.f, 4.f, 2.f, 5.f, 3.f, 6.f});
+    test.Run();
+  }
+
+  // Strided 3D.
+  {
+    KernelComputeTester test("Transpose");
+    test.AddAttribute("perm", std::vector<int64_t>{0, 2, 1});
+    test.AddInput<float>("X", {2, 2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f});
+    test.AddOutput<float>("Y", {2, 3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f},
+                          {6, 1, 3});
+    test.Run({0});
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -211,6 +211,21 @@ TEST(ContribOpTest, StringNormalizerSensitiveFilterOutUpperEmptyCase) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(ContribOpTest, StringNormalizerInsensitiveFilterOutLowerAscii) {
+  // - case-INSENSITIVE approach, ASCII and non ASCII strings mixed
+  // - filter out monday in any case
+  // - the chars next to the letters in the ASCII table keep their case
+  OpTester test("StringNormalizer", opset_ver, domain);
+  InitTestAttr(test, "LOWER", false, {"MonDay"}, test_locale);
+  std::vector<int64_t> dims{5};
+  std::vector<std::string> input = {"MONDAY", "@AZ[`az{", "Tuesday 42", "École", "monday"};
+  test.AddInput<std::string>("T", dims, input);
+
+  std::vector<std::string> output = {"@az[`az{", "tuesday 42", "école"};
+  test.AddOutput<std::string>("Y", {3}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 // Fails on iOS because necessary locales are not installed
 // MacOS runs fine.
 #ifndef ORT_IOS
@@ -13,6 +13,16 @@ TEST(StringSplit, BasicSplitTest) {
   test.Run();
 }
 
+TEST(StringSplit, LongTokensTest) {
+  // tokens that don't fit in the small string buffer
+  OpTester test("StringSplit", 20);
+  test.AddInput<std::string>("X", {2}, {"a rather long first token,b", "c,another rather long token,d"});
+  test.AddAttribute<std::string>("delimiter", ",");
+  test.AddOutput<std::string>("Y", {2, 3}, {"a rather long first token", "b", "", "c", "another rather long token", "d"});
+  test.AddOutput<int64_t>("Z", {2}, {2, 3});
+  test.Run();
+}
+
 TEST(StringSplit, MaxSplitTest) {
   OpTester test("StringSplit", 20);
   test.AddInput<std::string>("X", {2, 2}, {"eggs;milk;chesse", "pepper;salt", "chicken;fish;pork", "spinach"});
@@ -215,6 +215,43 @@ TEST(AttentionKernelOptionsTest, DefaultMinSeqLens) {
             onnxruntime::contrib::attention::kDefaultMinSeqLenForEfficientAttentionFp32);
 }
 
+#if USE_LEAN_ATTENTION
+// Lean attention is selected for decoding by shape unless it is explicitly enabled or disabled.
+TEST(AttentionKernelOptionsTest, LeanAttentionForDecoding) {
+  constexpr int num_sms = 132;
+  {
+    ScopedEnvironmentVariables scoped_env_vars{
+        EnvVarMap{
+            {onnxruntime::contrib::attention::kEnableLeanAttention, nullopt},
+            {onnxruntime::contrib::attention::kMinSeqLenForLeanAttention, nullopt}}};
+    AttentionKernelOptions options;
+    options.InitializeOnce(0, false);
+    ASSERT_TRUE(options.UseLeanAttention());
+    EXPECT_EQ(options.MinSeqLenForLeanAttention(), onnxruntime::contrib::attention::kDefaultMinSeqLenForLeanAttention);
+    EXPECT_TRUE(options.UseLeanAttentionForDecoding(1, 32, 8192, num_sms));
+    EXPECT_FALSE(options.UseLeanAttentionForDecoding(1, 32, 512, num_sms));   // short sequence
+    EXPECT_FALSE(options.UseLeanAttentionForDecoding(8, 32, 8192, num_sms));  // batch x heads fill the SMs
+  }
+
+  {
+    ScopedEnvironmentVariables scoped_env_vars{
+        EnvVarMap{{onnxruntime::contrib::attention::kEnableLeanAttention, "1"}}};
+    AttentionKernelOptions options;
+    options.InitializeOnce(0, false);
+    EXPECT_EQ(options.MinSeqLenForLeanAttention(), 0);
+    EXPECT_TRUE(options.UseLeanAttentionForDecoding(8, 32, 512, num_sms));
+  }
+
+  {
+    ScopedEnvironmentVariables scoped_env_vars{
+        EnvVarMap{{onnxruntime::contrib::attention::kEnableLeanAttention, "0"}}};
+    AttentionKernelOptions options;
+    options.InitializeOnce(0, false);
+    EXPECT_FALSE(options.UseLeanAttentionForDecoding(1, 32, 8192, num_sms));
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
 
@@ -1,14 +1,19 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
 #include <random>
 #include <string>
+#include <thread>
 
 #include "core/common/logging/logging.h"
 #include "core/common/span_utils.h"
 #include "core/framework/utils.h"
 #include "core/graph/graph.h"
 #include "core/providers/xnnpack/xnnpack_execution_provider.h"
+#include "core/providers/xnnpack/xnnpack_init.h"
+#include "core/providers/xnnpack/xnnpack_provider_factory_creator.h"
 #include "core/session/inference_session.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -379,6 +384,260 @@ TEST(XnnpackEP, TestSoftMax_axisLast) {  // error: Expected equality of these va
                {ExpectedEPNodeAssignment::All});
 }
 
+// the Add, Mul and Softmax nodes should be compiled into a single xnnpack subgraph
+TEST(XnnpackEP, TestSubgraph) {
+  const std::vector<int64_t> input_shape = {1, 2, 3, 8};
+  auto build_test_case = [&input_shape](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>(input_shape, -1.f, 1.f);
+    auto* bias_arg = builder.MakeInitializer<float>({8}, -1.f, 1.f);
+    auto* add_output = builder.MakeIntermediate();
+    auto* mul_output = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {input_arg, bias_arg}, {add_output});
+    builder.AddNode("Mul", {add_output, input_arg}, {mul_output});
+    builder.AddNode("Softmax", {mul_output}, {output_arg}).AddAttribute("axis", static_cast<int64_t>(-1));
+  };
+
+  onnxruntime::Model model("xnnpack_test_graph_subgraph", false, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  ModelTestBuilder helper(graph);
+  build_test_case(helper);
+  helper.SetGraphOutputs();
+  ASSERT_STATUS_OK(model.MainGraph().Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  const auto model_data_span = AsByteSpan(model_data.data(), model_data.size());
+
+  std::function<void(const Graph&)> verify = [](const Graph& graph) -> void {
+    ASSERT_EQ(graph.NumberOfNodes(), 1);
+    const auto& node = *graph.Nodes().begin();
+    EXPECT_EQ(node.GetExecutionProviderType(), kXnnpackExecutionProvider);
+    EXPECT_EQ(node.OpType().rfind("XNNPACK_", 0), size_t{0}) << node.OpType();
+  };
+
+  EPVerificationParams params;
+  params.ep_node_assignment = ExpectedEPNodeAssignment::All;
+  params.graph_verifier = &verify;
+
+  ProviderOptions provider_options{{"enable_subgraph", "1"}};
+  RunAndVerifyOutputsWithEP(model_data_span, "XnnpackEP.TestSubgraph",
+                            XnnpackProviderFactoryCreator::Create(provider_options, nullptr)->CreateProvider(),
+                            helper.feeds_, params);
+}
+
+// the xnnpack runtime of a subgraph is shared by the runs of the session, which must not see each other's
+// inputs and outputs.
+TEST(XnnpackEP, TestSubgraphConcurrentRuns) {
+  const std::vector<int64_t> input_shape = {1, 2, 3, 8};
+  const std::vector<float> bias = {-0.5f, -0.25f, 0.f, 0.25f, 0.5f, 0.75f, 1.f, 1.25f};
+
+  onnxruntime::Model model("xnnpack_test_graph_subgraph_concurrent_runs", false,
+                           DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  ModelTestBuilder builder(graph);
+  auto* input_arg = builder.MakeInput<float>(std::optional<std::vector<int64_t>>{input_shape}, "X");
+  auto* bias_arg = builder.MakeInitializer<float>({8}, bias);
+  auto* add_output = builder.MakeIntermediate();
+  auto* mul_output = builder.MakeIntermediate();
+  auto* output_arg = builder.MakeOutput();
+  builder.AddNode("Add", {input_arg, bias_arg}, {add_output});
+  builder.AddNode("Mul", {add_output, input_arg}, {mul_output});
+  builder.AddNode("Softmax", {mul_output}, {output_arg}).AddAttribute("axis", static_cast<int64_t>(-1));
+  builder.SetGraphOutputs();
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  SessionOptions so;
+  InferenceSessionWrapper session(so, GetEnvironment());
+  ProviderOptions provider_options{{"enable_subgraph", "1"}};
+  ASSERT_STATUS_OK(session.RegisterExecutionProvider(
+      XnnpackProviderFactoryCreator::Create(provider_options, nullptr)->CreateProvider()));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  ASSERT_EQ(session.GetGraph().NumberOfNodes(), 1);
+  ASSERT_EQ(session.GetGraph().Nodes().begin()->GetExecutionProviderType(), kXnnpackExecutionProvider);
+
+  constexpr int kThreads = 8;
+  constexpr int kRunsPerThread = 50;
+  const std::vector<std::string> output_names{builder.output_names_[0]};
+
+  auto run = [&](int thread_index) {
+    std::default_random_engine generator(static_cast<unsigned>(thread_index));
+    std::uniform_real_distribution<float> distribution(-2.f, 2.f);
+
+    for (int r = 0; r < kRunsPerThread; ++r) {
+      std::vector<float> x(48);
+      for (auto& value : x) {
+        value = distribution(generator);
+      }
+
+      // softmax((x + bias) * x) over the last axis
+      std::vector<float> expected(x.size());
+      for (size_t row = 0; row < x.size(); row += 8) {
+        float sum = 0.f;
+        for (size_t i = 0; i < 8; ++i) {
+          expected[row + i] = std::exp((x[row + i] + bias[i]) * x[row + i]);
+          sum += expected[row + i];
+        }
+        for (size_t i = 0; i < 8; ++i) {
+          expected[row + i] /= sum;
+        }
+      }
+
+      OrtValue input;
+      CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], input_shape, x, &input);
+      NameMLValMap feeds{{"X", input}};
+      std::vector<OrtValue> fetches;
+      ASSERT_STATUS_OK(session.Run(feeds, output_names, &fetches));
+
+      auto output = fetches[0].Get<Tensor>().DataAsSpan<float>();
+      ASSERT_EQ(output.size(), expected.size());
+      for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_NEAR(output[i], expected[i], 1e-5f) << "thread " << thread_index << " run " << r << " at " << i;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back(run, t);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+static float ComputeBinaryElementwise(const std::string& op_type, float a, float b) {
+  if (op_type == "Add") return a + b;
+  if (op_type == "Sub") return a - b;
+  if (op_type == "Mul") return a * b;
+  return a / b;
+}
+
+// Runs op_type(A, B) with the xnnpack EP and checks that the node is assigned to it, and that the output matches
+// the numpy style broadcast of the op computed in float on the host. CPU has no fp16 kernels for these ops, so the
+// expected values don't come from a CPU EP session.
+template <typename T>
+static void RunBinaryElementwiseTest(const std::string& op_type, const std::vector<int64_t>& a_shape,
+                                     const std::vector<int64_t>& b_shape, float abs_error = 1e-5f) {
+  const size_t rank = std::max(a_shape.size(), b_shape.size());
+  // the shapes left padded with 1s to the rank of the output
+  auto pad_shape = [rank](const std::vector<int64_t>& shape) {
+    std::vector<int64_t> padded(rank - shape.size(), 1);
+    padded.insert(padded.end(), shape.begin(), shape.end());
+    return padded;
+  };
+  const auto a_dims = pad_shape(a_shape);
+  const auto b_dims = pad_shape(b_shape);
+  std::vector<int64_t> y_dims(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    y_dims[i] = std::max(a_dims[i], b_dims[i]);
+  }
+
+  // B stays away from 0 so that Div is well conditioned
+  RandomValueGenerator random{RandomValueGenerator::RandomSeedType{2345}};
+  const auto a_values = random.Uniform<float>(a_shape, -2.f, 2.f);
+  const auto b_values = random.Uniform<float>(b_shape, 0.5f, 2.f);
+  std::vector<T> a_data(a_values.begin(), a_values.end());
+  std::vector<T> b_data(b_values.begin(), b_values.end());
+
+  onnxruntime::Model model("xnnpack_test_graph_" + op_type, false, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  ModelTestBuilder builder(graph);
+  auto* a_arg = builder.MakeInput<T>(a_shape, a_data);
+  auto* b_arg = builder.MakeInput<T>(b_shape, b_data);
+  auto* output_arg = builder.MakeOutput();
+  builder.AddNode(op_type, {a_arg, b_arg}, {output_arg});
+  builder.SetGraphOutputs();
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  SessionOptions so;
+  InferenceSessionWrapper session(so, GetEnvironment());
+  ASSERT_STATUS_OK(session.RegisterExecutionProvider(DefaultXnnpackExecutionProvider()));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+  VerifyEPNodeAssignment(session.GetGraph(), kXnnpackExecutionProvider, ExpectedEPNodeAssignment::All);
+
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(builder.feeds_, builder.output_names_, &fetches));
+  const auto& y = fetches[0].Get<Tensor>();
+  ASSERT_EQ(y.Shape(), TensorShape(y_dims));
+  const auto y_data = y.DataAsSpan<T>();
+
+  // walk the output in row major order, keeping the offsets of the elements of A and B it's computed from
+  std::vector<int64_t> index(rank, 0);
+  for (size_t i = 0; i < y_data.size(); ++i) {
+    int64_t a_offset = 0;
+    int64_t b_offset = 0;
+    for (size_t d = 0; d < rank; ++d) {
+      a_offset = a_offset * a_dims[d] + (a_dims[d] == 1 ? 0 : index[d]);
+      b_offset = b_offset * b_dims[d] + (b_dims[d] == 1 ? 0 : index[d]);
+    }
+
+    const float expected = ComputeBinaryElementwise(op_type, static_cast<float>(a_data[a_offset]),
+                                                    static_cast<float>(b_data[b_offset]));
+    ASSERT_NEAR(static_cast<float>(y_data[i]), expected, abs_error * std::max(1.f, std::abs(expected)))
+        << op_type << " at " << i;
+
+    for (size_t d = rank; d-- > 0;) {
+      if (++index[d] < y_dims[d]) {
+        break;
+      }
+      index[d] = 0;
+    }
+  }
+}
+
+static const std::vector<std::string> kBinaryElementwiseOps{"Add", "Sub", "Mul", "Div"};
+
+TEST(XnnpackEP, TestBinaryElementwiseSameShape) {
+  for (const auto& op_type : kBinaryElementwiseOps) {
+    RunBinaryElementwiseTest<float>(op_type, {1, 2, 3, 8}, {1, 2, 3, 8});
+  }
+}
+
+TEST(XnnpackEP, TestBinaryElementwiseBroadcast) {
+  for (const auto& op_type : kBinaryElementwiseOps) {
+    // B is broadcast to A
+    RunBinaryElementwiseTest<float>(op_type, {2, 3, 8}, {8});
+    RunBinaryElementwiseTest<float>(op_type, {2, 3, 8}, {3, 1});
+    // A is broadcast to B
+    RunBinaryElementwiseTest<float>(op_type, {8}, {2, 3, 8});
+    RunBinaryElementwiseTest<float>(op_type, {2, 1, 8}, {2, 3, 8});
+    // both are broadcast
+    RunBinaryElementwiseTest<float>(op_type, {2, 1, 8}, {3, 1});
+  }
+}
+
+TEST(XnnpackEP, TestBinaryElementwiseScalar) {
+  for (const auto& op_type : kBinaryElementwiseOps) {
+    RunBinaryElementwiseTest<float>(op_type, {2, 3, 8}, {});
+    RunBinaryElementwiseTest<float>(op_type, {}, {2, 3, 8});
+    RunBinaryElementwiseTest<float>(op_type, {}, {});
+  }
+}
+
+#ifdef XNNPACK_FP16_SUPPORTED
+TEST(XnnpackEP, TestBinaryElementwiseFp16) {
+  // the inputs are rounded to fp16 before the expected values are computed, so only the output is rounded
+  constexpr float fp16_error = 1e-2f;
+  for (const auto& op_type : kBinaryElementwiseOps) {
+    RunBinaryElementwiseTest<MLFloat16>(op_type, {1, 2, 3, 8}, {1, 2, 3, 8}, fp16_error);
+    RunBinaryElementwiseTest<MLFloat16>(op_type, {2, 3, 8}, {3, 1}, fp16_error);
+    RunBinaryElementwiseTest<MLFloat16>(op_type, {8}, {2, 3, 8}, fp16_error);
+    RunBinaryElementwiseTest<MLFloat16>(op_type, {2, 3, 8}, {}, fp16_error);
+  }
+}
+#endif
+
 TEST(XnnpackEP, TestQDQSoftMax_axisLast) {  // error: Expected equality of these values
   RunModelTest(BuildQDQSoftMaxTestCase<uint8_t, uint8_t>(
                    {1, 2, 3, 5} /* input_shape */,
@@ -0,0 +1,99 @@
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License.
+
+# -*- coding: UTF-8 -*-
+import unittest
+
+import numpy as np
+from onnx import TensorProto, helper
+
+import onnxruntime as onnxrt
+
+
+def create_mul_model():
+    # Y = X * X and Z = X + X for X of shape [3, 2]
+    graph = helper.make_graph(
+        [
+            helper.make_node("Mul", ["X", "X"], ["Y"]),
+            helper.make_node("Add", ["X", "X"], ["Z"]),
+        ],
+        "mul_add",
+        [helper.make_tensor_value_info("X", TensorProto.FLOAT, [3, 2])],
+        [
+            helper.make_tensor_value_info("Y", TensorProto.FLOAT, [3, 2]),
+            helper.make_tensor_value_info("Z", TensorProto.FLOAT, [3, 2]),
+        ],
+    )
+    model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)])
+    return model.SerializeToString()
+
+
+class TestInferenceSessionBatch(unittest.TestCase):
+    def create_session(self, intra_op_num_threads):
+        so = onnxrt.SessionOptions()
+        so.intra_op_num_threads = intra_op_num_threads
+        return onnxrt.InferenceSession(create_mul_model(), so, providers=["CPUExecutionProvider"])
+
+    def inputs(self, count):
+        return [np.arange(6, dtype=np.float32).reshape(3, 2) + i for i in range(count)]
+
+    def check_run_batch_order(self, intra_op_num_threads):
+        sess = self.create_session(intra_op_num_threads)
+        xs = self.inputs(16)
+        results = sess.run_batch(["Y", "Z"], [{"X": x} for x in xs])
+        self.assertEqual(len(results), len(xs))
+        for x, (y, z) in zip(xs, results, strict=True):
+            np.testing.assert_allclose(y, x * x)
+            np.testing.assert_allclose(z, x + x)
+
+    def test_run_batch_keeps_request_order(self):
+        self.check_run_batch_order(intra_op_num_threads=4)
+
+    def test_run_batch_single_thread(self):
+        # RunAsync needs a thread pool, so the requests run one after the other on the calling thread
+        self.check_run_batch_order(intra_op_num_threads=1)
+
+    def test_run_batch_all_outputs_by_default(self):
+        sess = self.create_session(intra_op_num_threads=2)
+        xs = self.inputs(3)
+        results = sess.run_batch(None, [{"X": x} for x in xs])
+        for x, result in zip(xs, results, strict=True):
+            expected = sess.run(None, {"X": x})
+            self.assertEqual(len(result), len(expected))
+            for actual, value in zip(result, expected, strict=True):
+                np.testing.assert_allclose(actual, value)
+
+    def test_run_batch_propagates_error(self):
+        for intra_op_num_threads in [1, 4]:
+            with self.subTest(intra_op_num_threads=intra_op_num_threads):
+                sess = self.create_session(intra_op_num_threads)
+                feeds = [{"X": x} for x in self.inputs(4)]
+                # a shape that doesn't match the model input fails the run of that request only
+                feeds[2] = {"X": np.zeros((2, 2), dtype=np.float32)}
+                with self.assertRaisesRegex(RuntimeError, "Error in run_batch"):
+                    sess.run_batch(["Y"], feeds)
+
+                # the session is still usable afterwards
+                results = sess.run_batch(["Y"], [{"X": x} for x in self.inputs(2)])
+                self.assertEqual(len(results), 2)
+
+    def test_run_future_matches_run(self):
+        sess = self.create_session(intra_op_num_threads=2)
+        xs = self.inputs(8)
+        futures = [sess.run_future(["Y", "Z"], {"X": x}) for x in xs]
+        for x, future in zip(xs, futures, strict=True):
+            expected = sess.run(["Y", "Z"], {"X": x})
+            actual = future.result(timeout=60)
+            self.assertEqual(len(actual), len(expected))
+            for a, e in zip(actual, expected, strict=True):
+                np.testing.assert_allclose(a, e)
+
+    def test_run_future_propagates_error(self):
+        sess = self.create_session(intra_op_num_threads=2)
+        future = sess.run_future(["Y"], {"X": np.zeros((2, 2), dtype=np.float32)})
+        with self.assertRaises(RuntimeError):
+            future.result(timeout=60)
+
+
+if __name__ == "__main__":
+    unittest.main(verbosity=1)
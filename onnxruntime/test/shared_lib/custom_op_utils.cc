@@ -615,6 +615,49 @@ void StandaloneCustomKernel::InitInvokeConv(OrtKernelContext* context) {
   }
 }
 
+void StandaloneCustomKernel::InvokeSharedAdd(OrtKernelContext* context) {
+  auto mem_info = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeCPU);
+
+  const char* type_constraint_names[1] = {"T"};
+  ONNXTensorElementDataType float_type_constraint_values[1] = {ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT};
+  ONNXTensorElementDataType double_type_constraint_values[1] = {ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE};
+
+  // ops created with the same arguments share a kernel, other type constraints need another one
+  auto op_add_a = Ort::Op::Create(info_copy_, "Add", "", 14, type_constraint_names, float_type_constraint_values,
+                                  1, nullptr, 0, 2, 1);
+  auto op_add_b = Ort::Op::Create(info_copy_, "Add", "", 14, type_constraint_names, float_type_constraint_values,
+                                  1, nullptr, 0, 2, 1);
+  auto op_add_double = Ort::Op::Create(info_copy_, "Add", "", 14, type_constraint_names,
+                                       double_type_constraint_values, 1, nullptr, 0, 2, 1);
+  if (static_cast<OrtOp*>(op_add_a) != static_cast<OrtOp*>(op_add_) ||
+      static_cast<OrtOp*>(op_add_b) != static_cast<OrtOp*>(op_add_)) {
+    ORT_THROW("Add ops created with the same arguments do not share a kernel.");
+  }
+  if (static_cast<OrtOp*>(op_add_double) == static_cast<OrtOp*>(op_add_)) {
+    ORT_THROW("Add ops created with different type constraints share a kernel.");
+  }
+
+  auto invoke_add = [&](Ort::Op& op) {
+    float raw_x[3] = {1.0f, 2.0f, 3.0f};
+    float raw_y[3] = {10.0f, 20.0f, 30.0f};
+    float raw_z[3] = {};
+    int64_t raw_shape[1] = {3};
+    const Ort::Value inputs[2] = {Ort::Value::CreateTensor(mem_info, raw_x, 3, raw_shape, 1),
+                                  Ort::Value::CreateTensor(mem_info, raw_y, 3, raw_shape, 1)};
+    Ort::Value outputs[1] = {Ort::Value::CreateTensor(mem_info, raw_z, 3, raw_shape, 1)};
+    op.Invoke(context, inputs, 2, outputs, 1);
+    if (raw_z[0] != 11.0f || raw_z[1] != 22.0f || raw_z[2] != 33.0f) {
+      ORT_THROW("shared Add op gives unexpected output.");
+    }
+  };
+
+  // releasing an op keeps the shared kernel for the ops still holding it
+  op_add_a = Ort::Op{nullptr};
+  invoke_add(op_add_b);
+  op_add_b = Ort::Op{nullptr};
+  invoke_add(op_add_);
+}
+
 #endif  // !defined(REDUCED_OPS_BUILD)
 
 void StandaloneCustomKernel::Compute(OrtKernelContext* context) {
@@ -634,6 +677,7 @@ void StandaloneCustomKernel::Compute(OrtKernelContext* context) {
   InvokeTopK(context);
   InvokeGru(context);
   InitInvokeConv(context);
+  InvokeSharedAdd(context);
 #endif
 }
 
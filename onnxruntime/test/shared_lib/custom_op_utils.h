@@ -351,6 +351,8 @@ struct StandaloneCustomKernel {
 
   void InitInvokeConv(OrtKernelContext* context);  // create Conv and invoke in Compute(...)
 
+  void InvokeSharedAdd(OrtKernelContext* context);  // create more Add ops sharing the kernel of op_add_
+
   Ort::Op op_topk_{nullptr};
   Ort::Op op_gru_{nullptr};
 #endif
@@ -2569,6 +2569,89 @@ TEST(CApiTest, basic_cuda_graph_with_annotation) {
   RunWithCudaGraphAnnotation(cg_data_2, session, info_mem, input_data, output_data, "2");
 #endif
 }
+
+#if defined(USE_CUDA)
+template <typename T>
+static void RunWithCudaGraphByInputShapes(T& cg_data, Ort::Session& session, bool use_new_values) {
+  const auto& x_values = use_new_values ? cg_data.new_x_values : cg_data.x_values;
+  const size_t x_size = static_cast<size_t>(cg_data.x_shape[0] * cg_data.x_shape[1]);
+
+  // The inputs are on CPU and the outputs are not bound, the session copies them to and from the graph's buffers
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value x = Ort::Value::CreateTensor(info_cpu, const_cast<float*>(x_values.data()), x_size,
+                                          cg_data.x_shape.data(), cg_data.x_shape.size());
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  auto outputs = session.Run(Ort::RunOptions{}, input_names, &x, 1, output_names, 1);
+  ASSERT_EQ(outputs.size(), 1u);
+
+  const float* y = outputs[0].GetTensorData<float>();
+  std::copy(y, y + cg_data.y_values.size(), cg_data.y_values.begin());
+  ASSERT_THAT(cg_data.y_values, ::testing::ContainerEq(use_new_values ? cg_data.new_expected_y : cg_data.expected_y));
+}
+
+TEST(CApiTest, cuda_graph_by_input_shapes) {
+  const auto& api = Ort::GetApi();
+
+  // Keep two graphs so the third shape evicts the least recently used one.
+  OrtCUDAProviderOptionsV2* cuda_options = nullptr;
+  ASSERT_TRUE(api.CreateCUDAProviderOptions(&cuda_options) == nullptr);
+  std::unique_ptr<OrtCUDAProviderOptionsV2, decltype(api.ReleaseCUDAProviderOptions)>
+      rel_cuda_options(cuda_options, api.ReleaseCUDAProviderOptions);
+  std::vector<const char*> keys{"enable_cuda_graph", "cuda_graph_max_num_graphs"};
+  std::vector<const char*> values{"1", "2"};
+  ASSERT_TRUE(api.UpdateCUDAProviderOptions(rel_cuda_options.get(), keys.data(), values.data(), 2) == nullptr);
+
+  Ort::SessionOptions session_options;
+  session_options.AddConfigEntry(kOrtSessionOptionsGraphCaptureByInputShapes, "1");
+  ASSERT_TRUE(api.SessionOptionsAppendExecutionProvider_CUDA_V2(
+                  static_cast<OrtSessionOptions*>(session_options),
+                  rel_cuda_options.get()) == nullptr);
+
+  Ort::Session session(*ort_env, CUDA_GRAPH_ANNOTATION_MODEL_URI, session_options);
+
+  for (bool use_new_values : {false, true, false}) {
+    RunWithCudaGraphByInputShapes(cg_data_0, session, use_new_values);
+    RunWithCudaGraphByInputShapes(cg_data_1, session, use_new_values);
+    RunWithCudaGraphByInputShapes(cg_data_2, session, use_new_values);
+  }
+}
+
+TEST(CApiTest, cuda_copy_staging_buffer) {
+  const auto& api = Ort::GetApi();
+
+  // 8 byte chunks, so the 24 bytes of the feed and of the fetch are staged in 3 chunks
+  OrtCUDAProviderOptionsV2* cuda_options = nullptr;
+  ASSERT_TRUE(api.CreateCUDAProviderOptions(&cuda_options) == nullptr);
+  std::unique_ptr<OrtCUDAProviderOptionsV2, decltype(api.ReleaseCUDAProviderOptions)>
+      rel_cuda_options(cuda_options, api.ReleaseCUDAProviderOptions);
+  std::vector<const char*> keys{"copy_staging_buffer_size"};
+  std::vector<const char*> values{"16"};
+  ASSERT_TRUE(api.UpdateCUDAProviderOptions(rel_cuda_options.get(), keys.data(), values.data(), 1) == nullptr);
+
+  Ort::SessionOptions session_options;
+  ASSERT_TRUE(api.SessionOptionsAppendExecutionProvider_CUDA_V2(
+                  static_cast<OrtSessionOptions*>(session_options),
+                  rel_cuda_options.get()) == nullptr);
+
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  std::vector<Input> inputs(1);
+  Input& input = inputs.back();
+  input.name = "X";
+  input.dims = {3, 2};
+  input.values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+  std::vector<int64_t> expected_dims_y = {3, 2};
+  std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  for (int i = 0; i < 2; ++i) {
+    RunSession<float>(allocator, session, inputs, "Y", expected_dims_y, expected_values_y, nullptr);
+  }
+}
+#endif  // defined(USE_CUDA)
 #endif
 
 // The following test uses some ops not supported in the reduced ops build
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test/util/include/affine_model.h"
+
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace test {
+
+AllocatorPtr GetTestCpuAllocator() {
+  static AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+  return cpu_allocator;
+}
+
+OrtValue CreateRampTensor(const std::vector<int64_t>& shape, float start) {
+  OrtValue value;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape(shape), GetTestCpuAllocator(), value);
+  auto data = value.GetMutable<Tensor>()->MutableDataAsSpan<float>();
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = start + static_cast<float>(i);
+  }
+  return value;
+}
+
+AffineModel::RunFn AffineModel::GetRunFn() {
+  return [this](const RunOptions&, gsl::span<const std::string>, gsl::span<const OrtValue> feeds,
+                gsl::span<const std::string>, std::vector<OrtValue>* p_fetches) {
+    const auto& x = feeds[0].Get<Tensor>();
+    OrtValue y;
+    Tensor::InitOrtValue(x.DataType(), x.Shape(), GetTestCpuAllocator(), y);
+    auto x_data = x.DataAsSpan<float>();
+    auto y_data = y.GetMutable<Tensor>()->MutableDataAsSpan<float>();
+    for (size_t i = 0; i < x_data.size(); ++i) {
+      y_data[i] = scale * x_data[i] + bias;
+    }
+    p_fetches->assign({y});
+
+    std::lock_guard<std::mutex> lock(mutex);
+    batch_sizes.push_back(x.Shape()[0]);
+    return Status::OK();
+  };
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 #include <memory>
 #include "default_providers.h"
 #include "providers.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/cpu_provider_factory_creator.h"
 #ifdef USE_COREML
 #include "core/providers/coreml/coreml_provider_factory.h"
@@ -19,7 +20,13 @@ namespace onnxruntime {
 
 namespace test {
 
-std::unique_ptr<IExecutionProvider> DefaultCpuExecutionProvider(bool enable_arena) {
+std::unique_ptr<IExecutionProvider> DefaultCpuExecutionProvider(bool enable_arena, bool test_tunable_op) {
+  if (test_tunable_op) {
+    CPUExecutionProviderInfo info{enable_arena};
+    info.tunable_op.enable = true;
+    info.tunable_op.tuning_enable = true;
+    return std::make_unique<CPUExecutionProvider>(info);
+  }
   return CPUProviderFactoryCreator::Create(enable_arena)->CreateProvider();
 }
 
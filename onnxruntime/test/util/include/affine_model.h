@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gsl/gsl>
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+
+namespace onnxruntime {
+namespace test {
+
+// CPU allocator of the tensors created by the helpers below.
+AllocatorPtr GetTestCpuAllocator();
+
+// Float tensor on CPU holding start, start + 1, start + 2, ...
+OrtValue CreateRampTensor(const std::vector<int64_t>& shape, float start);
+
+// Fake model for the tests of the components that run a model through a callback, like DynamicBatcher and
+// PipelineExecutor. Its output is scale * input + bias, and it records the batch size of each call.
+struct AffineModel {
+  using RunFn = std::function<Status(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                     gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                     std::vector<OrtValue>* p_fetches)>;
+
+  float scale;
+  float bias;
+  std::mutex mutex;
+  std::vector<int64_t> batch_sizes;
+
+  RunFn GetRunFn();
+};
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -34,7 +34,8 @@ std::shared_ptr<IExecutionProviderFactory> CreateExecutionProviderFactory_Intern
 namespace test {
 
 // unique_ptr providers with default values for session registration
-std::unique_ptr<IExecutionProvider> DefaultCpuExecutionProvider(bool enable_arena = true);
+std::unique_ptr<IExecutionProvider> DefaultCpuExecutionProvider(bool enable_arena = true,
+                                                                bool test_tunable_op = false);
 std::unique_ptr<IExecutionProvider> DefaultCudaExecutionProvider();
 #ifdef ENABLE_CUDA_NHWC_OPS
 std::unique_ptr<IExecutionProvider> DefaultCudaNHWCExecutionProvider();
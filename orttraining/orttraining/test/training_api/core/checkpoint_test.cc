@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <future>
+#include <numeric>
 #include <unordered_map>
 #include <vector>
 
@@ -581,4 +583,61 @@ TEST(CheckpointApiTest, SaveOnnxModelAsCheckpoint_ThenLoad_WithExternalData) {
   }
 }
 
+/**
+ * Save a checkpoint state with external data, update a trainable parameter and save it again in the background.
+ * Check that only the updated parameter is appended to the external data, and that loading restores the state.
+ */
+TEST(CheckpointApiTest, SaveCheckpointIncrementally_ThenLoad_WithExternalData) {
+  const std::vector<int64_t> dims{1024};
+  std::vector<float> trainable_values(1024);
+  std::vector<float> frozen_values(1024);
+  GenerateRandomData(trainable_values);
+  std::iota(frozen_values.begin(), frozen_values.end(), 0.0f);
+
+  CheckpointState state;
+  state.has_external_data = true;
+  auto& named_parameters = state.module_checkpoint_state.named_parameters;
+  named_parameters.insert(
+      {"trainable", std::make_shared<Parameter>(
+                        "trainable", onnxruntime::test::CreateInputOrtValueOnCPU<float>(dims, trainable_values), true)});
+  named_parameters.insert(
+      {"frozen", std::make_shared<Parameter>(
+                     "frozen", onnxruntime::test::CreateInputOrtValueOnCPU<float>(dims, frozen_values), false)});
+
+  // Remove the temporary directory if it already exists.
+  auto ckpt_test_root_dir = ORT_TSTR("checkpointing_api_test_dir");
+  TemporaryDirectory tmp_dir{ckpt_test_root_dir};
+  PathString checkpoint_path{
+      ConcatPathComponent(tmp_dir.Path(), ORT_TSTR("incremental_checkpoint"))};
+  const PathString data_path = ExternalCheckpointDataPath(checkpoint_path);
+
+  ASSERT_STATUS_OK(SaveCheckpoint(state, checkpoint_path, false));
+  const auto data_size = std::filesystem::file_size(data_path);
+  ASSERT_EQ(data_size, 2 * 1024 * sizeof(float));
+
+  // update the trainable parameter in place, like the optimizer does
+  float* trainable_data = named_parameters.at("trainable")->Data().GetMutable<Tensor>()->MutableData<float>();
+  trainable_data[0] += 1.0f;
+  trainable_values[0] = trainable_data[0];
+
+  std::future<Status> saved;
+  ASSERT_STATUS_OK(SaveCheckpointAsync(state, checkpoint_path, false, saved));
+  // not in the snapshot
+  trainable_data[1] += 1.0f;
+  ASSERT_STATUS_OK(saved.get());
+  ASSERT_EQ(std::filesystem::file_size(data_path), data_size + 1024 * sizeof(float));
+
+  CheckpointState loaded_state;
+  ASSERT_STATUS_OK(LoadCheckpoint(checkpoint_path, loaded_state));
+  std::vector<float> loaded_values;
+  CpuOrtValueToVec(loaded_state.module_checkpoint_state.named_parameters.at("trainable")->Data(), loaded_values);
+  ASSERT_EQ(loaded_values, trainable_values);
+  CpuOrtValueToVec(loaded_state.module_checkpoint_state.named_parameters.at("frozen")->Data(), loaded_values);
+  ASSERT_EQ(loaded_values, frozen_values);
+
+  // nothing changed since the load
+  ASSERT_STATUS_OK(SaveCheckpoint(loaded_state, checkpoint_path, false));
+  ASSERT_EQ(std::filesystem::file_size(data_path), data_size + 1024 * sizeof(float));
+}
+
 }  // namespace onnxruntime::training::test
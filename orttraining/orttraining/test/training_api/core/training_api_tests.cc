@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <thread>
 
 #include "gtest/gtest.h"
@@ -547,6 +548,20 @@ TEST(TrainingApiTest, OptimStep) {
       group0_states->param_named_optimizer_states.at(param_name);
   OrtValue& moment_1 = param_state.at("momentum0");
 
+  // the moments of all the parameters are views of one buffer per momentum
+  size_t moments_size_in_bytes = 0;
+  const uint8_t* moments_begin = nullptr;
+  const uint8_t* moments_end = nullptr;
+  for (const auto& [name, moments] : group0_states->param_named_optimizer_states) {
+    const auto& moment = moments.at("momentum0").Get<Tensor>();
+    const auto* data = static_cast<const uint8_t*>(moment.DataRaw());
+    moments_begin = moments_begin == nullptr ? data : std::min(moments_begin, data);
+    moments_end = std::max(moments_end, data + moment.SizeInBytes());
+    moments_size_in_bytes += moment.SizeInBytes();
+  }
+  ASSERT_LT(static_cast<size_t>(moments_end - moments_begin),
+            moments_size_in_bytes + 64 * group0_states->param_named_optimizer_states.size());
+
   std::vector<float> param_vec_before_optimizer_step;
   std::vector<float> moment_1_vec;
 #if defined(USE_CUDA)
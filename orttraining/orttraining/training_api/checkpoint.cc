@@ -3,11 +3,18 @@
 
 #include "orttraining/training_api/checkpoint.h"
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+#include "core/common/safeint.h"
 #include "core/flatbuffers/checkpoint_version.h"
 #include "core/flatbuffers/schema/ort_training_checkpoint.fbs.h"
 #include "core/framework/framework_common.h"
 #include "core/graph/graph_flatbuffers_utils.h"
 #include "core/framework/tensor_external_data_info.h"
+#include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime::training::api {
 
@@ -15,8 +22,106 @@ PathString ExternalCheckpointDataPath(const PathString& checkpoint_path) {
   return checkpoint_path + ORT_TSTR(".data");
 }
 
+struct CheckpointExternalData {
+  struct TensorData {
+    uint64_t offset;
+    uint64_t size_in_bytes;
+    uint64_t hash;
+  };
+
+  // held while the state is saved
+  std::mutex mutex;
+  PathString data_path;
+  uint64_t file_size{0};
+  // bytes of the tensors referenced by the checkpoint, the rest of the file holds tensors of previous saves
+  uint64_t live_bytes{0};
+  // keyed by the module or optimizer state the tensor belongs to
+  InlinedHashMap<std::string, TensorData> tensors;
+};
+
 namespace {
 
+// States larger than this are saved with external data, so that the flatbuffer doesn't hold a copy of the tensors
+// and stays below the 2GB flatbuffer limit.
+constexpr size_t kExternalDataThreshold = 1800 * 1024 * 1024;
+
+#if defined(_WIN32)
+// file mappings are read only on Windows, so the tensors are copied out of the mapping
+constexpr bool kMappedExternalDataIsWritable = false;
+#else
+// file mappings are private and writable, so the tensors use the mapped data in place
+constexpr bool kMappedExternalDataIsWritable = true;
+#endif
+
+/**
+ * @brief The external data file of a checkpoint mapped into memory.
+ */
+struct MappedExternalData {
+  Env::MappedMemoryPtr memory;
+  size_t length{0};
+
+  gsl::span<const uint8_t> Bytes(uint64_t offset, size_t size_in_bytes) const {
+    return gsl::make_span(reinterpret_cast<const uint8_t*>(memory.get()) + offset, size_in_bytes);
+  }
+};
+
+/**
+ * @brief Gets the data of a flatbuffer tensor in the mapped external data file.
+ * @param fbs_tensor Flatbuffer tensor with external data that is not a string tensor.
+ * @param mapped_external_data External data file mapped into memory.
+ * @param element_type Element type of the tensor.
+ * @param shape Shape of the tensor.
+ * @param data Data of the tensor in the mapping.
+ * @return Status of the operation.
+ */
+Status GetMappedTensorData(const fbs::Tensor& fbs_tensor, const MappedExternalData& mapped_external_data,
+                           const DataTypeImpl*& element_type, TensorShape& shape, gsl::span<const uint8_t>& data) {
+  ORT_RETURN_IF_NOT(fbs_tensor.name() && fbs_tensor.dims(),
+                    "Flatbuffer tensor is invalid. Expected: A valid tensor name and dims. Actual: nullptr.");
+  element_type =
+      DataTypeImpl::TensorTypeFromONNXEnum(static_cast<int32_t>(fbs_tensor.data_type()))->GetElementType();
+  shape = TensorShape(fbs_tensor.dims()->data(), fbs_tensor.dims()->size());
+
+  const uint64_t offset = static_cast<uint64_t>(fbs_tensor.external_data_offset());
+  const size_t size_in_bytes = SafeInt<size_t>(shape.Size()) * element_type->Size();
+  ORT_RETURN_IF(offset > mapped_external_data.length || size_in_bytes > mapped_external_data.length - offset,
+                "Tensor ", fbs_tensor.name()->str(), " is out of the bounds of the external checkpoint data.");
+
+  data = mapped_external_data.Bytes(offset, size_in_bytes);
+  return Status::OK();
+}
+
+/**
+ * @brief Hashes tensor data, to find the tensors that did not change since the last save.
+ * @param bytes Tensor data.
+ * @return 64-bit hash of the data.
+ */
+uint64_t HashBytes(gsl::span<const uint8_t> bytes) {
+  constexpr uint64_t kMultiplier = 0x9E3779B97F4A7C15ull;
+  const auto mix = [](uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    return value;
+  };
+
+  uint64_t hash = bytes.size() * kMultiplier;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes.data() + i, sizeof(word));
+    hash = (hash ^ mix(word)) * kMultiplier;
+  }
+
+  if (i < bytes.size()) {
+    uint64_t word = 0;
+    std::memcpy(&word, bytes.data() + i, bytes.size() - i);
+    hash = (hash ^ mix(word)) * kMultiplier;
+  }
+
+  return mix(hash);
+}
+
 /**
  * @brief Helper method to read data from an external file.
  * @param external_data_stream Stream that data will be read from.
@@ -75,6 +180,103 @@ Status WriteToExternalFileHelper(std::ofstream& external_data_stream,
   return Status::OK();
 }
 
+/**
+ * @brief Writes the tensor data of a checkpoint state to the external data file of the checkpoint.
+ *
+ * If the file holds the tensors of the last save of the state to the same checkpoint, and most of it is still in
+ * use, the tensors that did not change are not written again and the others are appended. Otherwise a new file is
+ * written, and replaces the existing one once complete. Either way, the data referenced by the existing checkpoint
+ * file, or mapped by the tensors loaded from it, is not modified.
+ */
+class ExternalDataFileWriter {
+ public:
+  explicit ExternalDataFileWriter(CheckpointExternalData& external_data)
+      : external_data_(external_data), lock_(external_data.mutex) {}
+
+  Status Open(const PathString& checkpoint_path) {
+    data_path_ = ExternalCheckpointDataPath(checkpoint_path);
+
+    size_t file_size = 0;
+    append_ = external_data_.data_path == data_path_ &&
+              Env::Default().GetFileLength(data_path_.c_str(), file_size).IsOK() &&
+              file_size >= external_data_.file_size &&
+              file_size - external_data_.live_bytes <= external_data_.live_bytes;
+
+    write_path_ = append_ ? data_path_ : data_path_ + ORT_TSTR(".tmp");
+    stream_.open(write_path_, append_ ? std::ios::binary | std::ios::in | std::ios::out : std::ios::binary);
+    ORT_RETURN_IF(stream_.fail(), "Failed to create checkpoint's external data file: ", ToUTF8String(write_path_));
+
+    if (append_) {
+      stream_.seekp(0, std::ios::end);
+    }
+
+    return Status::OK();
+  }
+
+  /**
+   * @brief Creates a delegate writing the data of a tensor.
+   * @param key Identifies the tensor across saves of the state.
+   */
+  fbs::utils::ExternalDataWriter WriterFor(std::string key) {
+    return [this, key = std::move(key)](int32_t data_type, gsl::span<const uint8_t> bytes, uint64_t& offset) {
+      return Write(key, data_type, bytes, offset);
+    };
+  }
+
+  /**
+   * @brief Completes the external data file, and records its tensors for the next save.
+   */
+  Status Commit() {
+    const uint64_t file_size = static_cast<uint64_t>(stream_.tellp());
+    stream_.close();
+    ORT_RETURN_IF(stream_.fail(), "Failed writing external checkpoint data to ", ToUTF8String(write_path_));
+
+    if (!append_) {
+      std::error_code error;
+      std::filesystem::rename(write_path_, data_path_, error);
+      ORT_RETURN_IF(error, "Failed to replace checkpoint's external data file: ", ToUTF8String(data_path_),
+                    ". error:", error.message());
+    }
+
+    external_data_.data_path = data_path_;
+    external_data_.file_size = file_size;
+    external_data_.live_bytes = 0;
+    for (const auto& [key, tensor] : tensors_) {
+      external_data_.live_bytes += tensor.size_in_bytes;
+    }
+    external_data_.tensors = std::move(tensors_);
+
+    return Status::OK();
+  }
+
+ private:
+  Status Write(const std::string& key, int32_t data_type, gsl::span<const uint8_t> bytes, uint64_t& offset) {
+    const uint64_t hash = HashBytes(bytes);
+    if (append_) {
+      const auto it = external_data_.tensors.find(key);
+      if (it != external_data_.tensors.end() && it->second.size_in_bytes == bytes.size() &&
+          it->second.hash == hash) {
+        offset = it->second.offset;
+        tensors_.insert_or_assign(key, it->second);
+        return Status::OK();
+      }
+    }
+
+    ORT_RETURN_IF_ERROR(WriteToExternalFileHelper(stream_, data_type, bytes, offset));
+    tensors_.insert_or_assign(key, CheckpointExternalData::TensorData{offset, bytes.size(), hash});
+
+    return Status::OK();
+  }
+
+  CheckpointExternalData& external_data_;
+  std::unique_lock<std::mutex> lock_;
+  PathString data_path_;
+  PathString write_path_;
+  bool append_{false};
+  std::ofstream stream_;
+  InlinedHashMap<std::string, CheckpointExternalData::TensorData> tensors_;
+};
+
 /**
  * @brief Sort keys of a hash map.
  * @param hash_map Hash map to sort.
@@ -136,11 +338,31 @@ Status FlatbufferTensorFromOrtValue(
  * @param tensor_name Name of the tensor.
  * @param ort_value OrtValue object to be populated.
  * @param external_data_reader delegate to read initializer data from an external file or buffer
+ * @param mapped_external_data Optional external data file mapped into memory, used in place when it is writable.
  * @return Status of the operation.
  */
 Status OrtValueFromFlatbufferTensor(const fbs::Tensor& fbs_tensor,
                                     std::string& tensor_name, OrtValue& ort_value,
-                                    const fbs::utils::ExternalDataReader& external_data_reader) {
+                                    const fbs::utils::ExternalDataReader& external_data_reader,
+                                    const std::shared_ptr<const MappedExternalData>& mapped_external_data) {
+  if (kMappedExternalDataIsWritable && mapped_external_data && fbs_tensor.external_data_offset() >= 0 &&
+      fbs_tensor.data_type() != fbs::TensorDataType::STRING) {
+    const DataTypeImpl* element_type = nullptr;
+    TensorShape shape;
+    gsl::span<const uint8_t> data;
+    ORT_RETURN_IF_ERROR(GetMappedTensorData(fbs_tensor, *mapped_external_data, element_type, shape, data));
+
+    // the tensor refers to the private mapping, so the file is not modified when training updates it
+    if (reinterpret_cast<uintptr_t>(data.data()) % element_type->Size() == 0) {
+      tensor_name = fbs_tensor.name()->str();
+      auto ort_tensor = std::make_unique<Tensor>(element_type, shape, const_cast<uint8_t*>(data.data()),
+                                                 OrtMemoryInfo(onnxruntime::CPU, OrtDeviceAllocator));
+      ort_value.Init(ort_tensor.release(), DataTypeImpl::GetType<onnxruntime::Tensor>(),
+                     [mapped_external_data](void* tensor) { delete static_cast<Tensor*>(tensor); });
+      return Status::OK();
+    }
+  }
+
   // The assumption is that the flatbuffer buffer will be destructed once the checkpoint has been loaded.
   // And so, we must allocate a buffer where the tensor data can be copied using the cpu allocator.
   // This buffer is owned by the OrtValue.
@@ -164,7 +386,8 @@ Status OrtValueFromFlatbufferTensor(const fbs::Tensor& fbs_tensor,
  * @param data_transfer_manager Data transfer manager to copy the OrtValue tensor to a cpu buffer.
  * @param builder Builder to create flatbuffer tensors.
  * @param flatbuffer_tensors Flatbuffer tensors to be populated.
- * @param external_data_writer Optional delegate to write the tensor data to an external file.
+ * @param external_data_file Optional writer of the tensor data to the external data file.
+ * @param key_prefix Prefix of the names of the tensors identifying them in the external data file.
  * @return Status of the operation.
  */
 Status FlatbufferTensorsFromOrtValues(
@@ -172,7 +395,8 @@ Status FlatbufferTensorsFromOrtValues(
     const DataTransferManager* data_transfer_manager,
     flatbuffers::FlatBufferBuilder& builder,
     std::vector<flatbuffers::Offset<fbs::Tensor>>& flatbuffer_tensors,
-    fbs::utils::ExternalDataWriter external_data_writer = nullptr) {
+    ExternalDataFileWriter* external_data_file = nullptr,
+    const std::string& key_prefix = {}) {
   for (const auto& name : SortedKeys(name_to_ort_value)) {
     const OrtValue& ort_value = name_to_ort_value.at(name);
     flatbuffers::Offset<fbs::Tensor> fbs_tensor;
@@ -183,7 +407,7 @@ Status FlatbufferTensorsFromOrtValues(
                             "Actual: nullptr.");
           return data_transfer_manager->CopyTensor(src_tensor, dst_tensor);
         },
-        builder, fbs_tensor, external_data_writer));
+        builder, fbs_tensor, external_data_file ? external_data_file->WriterFor(key_prefix + name) : nullptr));
     flatbuffer_tensors.push_back(fbs_tensor);
   }
 
@@ -196,17 +420,20 @@ Status FlatbufferTensorsFromOrtValues(
  * @param flatbuffer_tensors Flatbuffer tensors.
  * @param name_to_ort_value Name to OrtValue map to be populated.
  * @param external_data_reader delegate to read initializer data from an external file or buffer
+ * @param mapped_external_data Optional external data file mapped into memory.
  * @return Status of the operation.
  */
 Status OrtValuesFromFlatbufferTensors(
     const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::Tensor>>& flatbuffer_tensors,
-    InlinedHashMap<std::string, OrtValue>& name_to_ort_value, const fbs::utils::ExternalDataReader& external_data_reader) {
+    InlinedHashMap<std::string, OrtValue>& name_to_ort_value, const fbs::utils::ExternalDataReader& external_data_reader,
+    const std::shared_ptr<const MappedExternalData>& mapped_external_data) {
   for (const auto* fbs_tensor : flatbuffer_tensors) {
     ORT_RETURN_IF_NOT(fbs_tensor, "Encountered a nullptr flatbuffer tensor. Checkpoint file is invalid.");
 
     std::string tensor_name;
     OrtValue ort_value;
-    ORT_RETURN_IF_ERROR(OrtValueFromFlatbufferTensor(*fbs_tensor, tensor_name, ort_value, external_data_reader));
+    ORT_RETURN_IF_ERROR(OrtValueFromFlatbufferTensor(*fbs_tensor, tensor_name, ort_value, external_data_reader,
+                                                     mapped_external_data));
     name_to_ort_value.emplace(std::move(tensor_name), std::move(ort_value));
   }
 
@@ -223,13 +450,23 @@ namespace save {
  *
  */
 Status ToFile(const PathString& checkpoint_path, flatbuffers::FlatBufferBuilder& builder) {
-  std::ofstream file(checkpoint_path, std::ios::binary);
-  const uint8_t* buf = builder.GetBufferPointer();
-  int size = builder.GetSize();
-  file.write(reinterpret_cast<const char*>(buf), size);
-  const auto [err, msg] = GetErrnoInfo();
-  ORT_RETURN_IF_NOT(file, "Failed to save checkpoint to file: ", ToUTF8String(checkpoint_path), ". error:", msg,
-                    " errno:", errno);
+  // the checkpoint is replaced once the new one is complete
+  const PathString temp_path = checkpoint_path + ORT_TSTR(".tmp");
+  {
+    std::ofstream file(temp_path, std::ios::binary);
+    const uint8_t* buf = builder.GetBufferPointer();
+    int size = builder.GetSize();
+    file.write(reinterpret_cast<const char*>(buf), size);
+    file.close();
+    const auto [err, msg] = GetErrnoInfo();
+    ORT_RETURN_IF_NOT(file, "Failed to save checkpoint to file: ", ToUTF8String(checkpoint_path), ". error:", msg,
+                      " errno:", errno);
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temp_path, checkpoint_path, error);
+  ORT_RETURN_IF(error, "Failed to save checkpoint to file: ", ToUTF8String(checkpoint_path), ". error:",
+                error.message());
 
   return Status::OK();
 }
@@ -374,13 +611,13 @@ Status FromTensorProtos(gsl::span<const ONNX_NAMESPACE::TensorProto> trainable_t
  * @param module_state module state containing the model's trainable and non-trainable parameters.
  * @param builder Flatbuffer builder.
  * @param fbs_module_state Flatbuffer module state to be populated.
- * @param external_data_writer Optional delegate to write tensor data to an external file.
+ * @param external_data_file Optional writer of the tensor data to the external data file.
  * @return Status of the operation.
  */
 Status FromModuleState(const ModuleCheckpointState& module_state,
                        flatbuffers::FlatBufferBuilder& builder,
                        flatbuffers::Offset<fbs::ModuleState>& fbs_module_state,
-                       fbs::utils::ExternalDataWriter external_data_writer = nullptr) {
+                       ExternalDataFileWriter* external_data_file = nullptr) {
   if (module_state.named_parameters.empty()) {
     return Status::OK();
   }
@@ -407,14 +644,14 @@ Status FromModuleState(const ModuleCheckpointState& module_state,
   ORT_RETURN_IF_ERROR(FlatbufferTensorsFromOrtValues(
       requires_grad_params,
       module_state.train_session_data_transfer_mgr,
-      builder, trainable_tensors, external_data_writer));
+      builder, trainable_tensors, external_data_file, "module/"));
 
   std::vector<flatbuffers::Offset<fbs::Tensor>> non_trainable_tensors;
   non_trainable_tensors.reserve(frozen_params.size());
   ORT_RETURN_IF_ERROR(FlatbufferTensorsFromOrtValues(
       frozen_params,
       module_state.train_session_data_transfer_mgr,
-      builder, non_trainable_tensors, external_data_writer));
+      builder, non_trainable_tensors, external_data_file, "module/"));
 
   const auto fbs_trainable_tensors = builder.CreateVector(trainable_tensors);
   const auto fbs_non_trainable_tensors = builder.CreateVector(non_trainable_tensors);
@@ -423,7 +660,7 @@ Status FromModuleState(const ModuleCheckpointState& module_state,
   module_state_builder.add_requires_grad_params(fbs_trainable_tensors);
   module_state_builder.add_frozen_params(fbs_non_trainable_tensors);
   module_state_builder.add_is_nominal_state(module_state.is_nominal_state);
-  if (external_data_writer) {
+  if (external_data_file) {
     module_state_builder.add_has_external_data(true);
   }
   fbs_module_state = module_state_builder.Finish();
@@ -438,11 +675,13 @@ Status FromModuleState(const ModuleCheckpointState& module_state,
  *                        and second order momentums ...).
  * @param builder Flatbuffer builder.
  * @param fbs_optimizer_groups Flatbuffer optimizer groups to be populated.
+ * @param external_data_file Optional writer of the tensor data to the external data file.
  * @return Status of the operation.
  */
 Status FromOptimizerState(const OptimizerCheckpointState& optimizer_state,
                           flatbuffers::FlatBufferBuilder& builder,
-                          std::vector<flatbuffers::Offset<fbs::OptimizerGroup>>& fbs_optimizer_groups) {
+                          std::vector<flatbuffers::Offset<fbs::OptimizerGroup>>& fbs_optimizer_groups,
+                          ExternalDataFileWriter* external_data_file = nullptr) {
   if (optimizer_state.group_named_optimizer_states.empty()) {
     return Status::OK();
   }
@@ -462,7 +701,7 @@ Status FromOptimizerState(const OptimizerCheckpointState& optimizer_state,
       ORT_RETURN_IF_ERROR(FlatbufferTensorsFromOrtValues(
           param_optimizer_state,
           optimizer_state.optimizer_session_data_transfer_mgr,
-          builder, momentums));
+          builder, momentums, external_data_file, "optimizer/" + group_name + "/" + param_name + "/"));
 
       const auto fbs_param_name = builder.CreateString(param_name);
       const auto fbs_momentums = builder.CreateVector(momentums);
@@ -558,22 +797,36 @@ Status FromCheckpointState(
     const CheckpointState& state, const PathString& checkpoint_path, const bool include_optimizer_state) {
   flatbuffers::FlatBufferBuilder builder(1024);
 
-  fbs::utils::ExternalDataWriter external_data_writer = nullptr;
-  std::optional<std::ofstream> external_data_stream;
-  if (state.has_external_data) {
-    auto data_path = ExternalCheckpointDataPath(checkpoint_path);
-    external_data_stream = std::ofstream(data_path, std::ios::binary);
+  size_t state_size_in_bytes = 0;
+  for (const auto& [name, param] : state.module_checkpoint_state.named_parameters) {
+    if (param->Data().IsTensor()) {
+      state_size_in_bytes += param->Data().Get<Tensor>().SizeInBytes();
+    }
+  }
 
-    ORT_RETURN_IF(external_data_stream->fail(), "Failed to create checkpoint's external data file: ",
-                  ToUTF8String(data_path));
+  if (include_optimizer_state) {
+    for (const auto& [group_name, group] : state.optimizer_checkpoint_state.group_named_optimizer_states) {
+      for (const auto& [param_name, param_optimizer_state] : group->param_named_optimizer_states) {
+        for (const auto& [momentum_name, momentum] : param_optimizer_state) {
+          if (momentum.IsTensor()) {
+            state_size_in_bytes += momentum.Get<Tensor>().SizeInBytes();
+          }
+        }
+      }
+    }
+  }
 
-    // setup the data writer to write aligned data to external_data_stream
-    external_data_writer = [&external_data_stream](int32_t data_type, gsl::span<const uint8_t> bytes,
-                                                   uint64_t& offset) {
-      return WriteToExternalFileHelper(external_data_stream.value(), data_type, bytes, offset);
-    };
+  std::optional<ExternalDataFileWriter> external_data_file;
+  if (state.has_external_data || state_size_in_bytes >= kExternalDataThreshold) {
+    if (!state.external_data) {
+      state.external_data = std::make_shared<CheckpointExternalData>();
+    }
+
+    ORT_RETURN_IF_ERROR(external_data_file.emplace(*state.external_data).Open(checkpoint_path));
   }
 
+  ExternalDataFileWriter* external_data_writer = external_data_file ? &*external_data_file : nullptr;
+
   // Write weight tensors files.
   flatbuffers::Offset<fbs::ModuleState> module_state;
   ORT_RETURN_IF_ERROR(FromModuleState(state.module_checkpoint_state, builder, module_state, external_data_writer));
@@ -581,7 +834,8 @@ Status FromCheckpointState(
   // Write optimizer state tensors files.
   std::vector<flatbuffers::Offset<fbs::OptimizerGroup>> optimizer_groups;
   if (include_optimizer_state) {
-    ORT_RETURN_IF_ERROR(FromOptimizerState(state.optimizer_checkpoint_state, builder, optimizer_groups));
+    ORT_RETURN_IF_ERROR(FromOptimizerState(state.optimizer_checkpoint_state, builder, optimizer_groups,
+                                           external_data_writer));
   }
 
   flatbuffers::Offset<fbs::PropertyBag> property_bag;
@@ -597,9 +851,96 @@ Status FromCheckpointState(
   const auto checkpoint = checkpoint_builder.Finish();
   builder.Finish(checkpoint, fbs::CheckpointIdentifier());
 
+  if (external_data_file) {
+    ORT_RETURN_IF_ERROR(external_data_file->Commit());
+  }
+
   return save::ToFile(checkpoint_path, builder);
 }
 
+/**
+ * @brief Copies a tensor to CPU memory that training does not update.
+ *
+ * @param ort_value OrtValue of the tensor.
+ * @param data_transfer_manager Data transfer manager to copy a tensor that is not on CPU.
+ * @param snapshot OrtValue of the copy to be populated.
+ * @return Status of the operation.
+ */
+Status ToSnapshot(const OrtValue& ort_value, const DataTransferManager* data_transfer_manager, OrtValue& snapshot) {
+  ORT_RETURN_IF_NOT(ort_value.IsTensor(), "Only tensor OrtValues can be saved to a checkpoint.");
+  const Tensor& src_tensor = ort_value.Get<Tensor>();
+
+  static const AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
+  Tensor::InitOrtValue(src_tensor.DataType(), src_tensor.Shape(), cpu_allocator, snapshot);
+  Tensor& dst_tensor = *snapshot.GetMutable<Tensor>();
+  if (src_tensor.Location().device.Type() == OrtDevice::CPU) {
+    CopyCpuTensor(&src_tensor, &dst_tensor);
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_NOT(data_transfer_manager,
+                    "Cannot save OrtValue to a checkpoint. Expected: A valid data transfer manager. Actual: nullptr.");
+  return data_transfer_manager->CopyTensor(src_tensor, dst_tensor);
+}
+
+/**
+ * @brief Takes a snapshot of a checkpoint state that can be saved while training continues.
+ *
+ * @param state parameter/optimizer and other user defined training states.
+ * @param include_optimizer_state Whether to include optimizer state in the snapshot.
+ * @param snapshot Checkpoint state to be populated. Its tensors are on CPU.
+ * @return Status of the operation.
+ */
+Status ToCheckpointStateSnapshot(const CheckpointState& state, const bool include_optimizer_state,
+                                 CheckpointState& snapshot) {
+  const ModuleCheckpointState& module_state = state.module_checkpoint_state;
+  for (const auto& [name, param] : module_state.named_parameters) {
+    OrtValue value = param->Data();
+    // frozen parameters on CPU are not updated by training, so they are shared
+    if (param->RequiresGrad() || !value.IsTensor() || value.Get<Tensor>().Location().device.Type() != OrtDevice::CPU) {
+      ORT_RETURN_IF_ERROR(ToSnapshot(param->Data(), module_state.train_session_data_transfer_mgr, value));
+    }
+
+    snapshot.module_checkpoint_state.named_parameters.insert(
+        {name, std::make_shared<Parameter>(name, value, param->RequiresGrad())});
+  }
+
+  snapshot.module_checkpoint_state.train_session_data_transfer_mgr = nullptr;
+  snapshot.module_checkpoint_state.is_nominal_state = module_state.is_nominal_state;
+
+  const OptimizerCheckpointState& optimizer_state = state.optimizer_checkpoint_state;
+  if (include_optimizer_state) {
+    for (const auto& [group_name, group] : optimizer_state.group_named_optimizer_states) {
+      auto group_snapshot = std::make_shared<GroupOptimizerState>();
+      group_snapshot->step = group->step;
+      group_snapshot->initial_lr = group->initial_lr;
+      group_snapshot->learning_rate = group->learning_rate;
+      for (const auto& [param_name, param_optimizer_state] : group->param_named_optimizer_states) {
+        auto& param_optimizer_state_snapshot = group_snapshot->param_named_optimizer_states[param_name];
+        for (const auto& [momentum_name, momentum] : param_optimizer_state) {
+          ORT_RETURN_IF_ERROR(ToSnapshot(momentum, optimizer_state.optimizer_session_data_transfer_mgr,
+                                         param_optimizer_state_snapshot[momentum_name]));
+        }
+      }
+
+      snapshot.optimizer_checkpoint_state.group_named_optimizer_states.insert({group_name, std::move(group_snapshot)});
+    }
+  }
+
+  snapshot.optimizer_checkpoint_state.optimizer_session_data_transfer_mgr = nullptr;
+  snapshot.property_bag = state.property_bag;
+  snapshot.has_external_data = state.has_external_data;
+
+  // saves of the snapshot update the external data of the state
+  if (!state.external_data) {
+    state.external_data = std::make_shared<CheckpointExternalData>();
+  }
+
+  snapshot.external_data = state.external_data;
+
+  return Status::OK();
+}
+
 }  // namespace save
 
 namespace load {
@@ -632,18 +973,21 @@ Status FromFile(const PathString& checkpoint_path, InlinedVector<uint8_t>& check
  * @param fbs_module_state Flatbuffer module state.
  * @param module_state Module state to be populated.
  * @param external_data_reader delegate to read initializer data from an external file or buffer
+ * @param mapped_external_data Optional external data file mapped into memory.
  * @return Status of the operation.
  */
 Status ToModuleState(
     const onnxruntime::fbs::ModuleState& fbs_module_state, ModuleCheckpointState& module_state,
-    const fbs::utils::ExternalDataReader& external_data_reader) {
+    const fbs::utils::ExternalDataReader& external_data_reader,
+    const std::shared_ptr<const MappedExternalData>& mapped_external_data) {
   const auto* requires_grad_params = fbs_module_state.requires_grad_params();
   ORT_RETURN_IF_NOT(requires_grad_params, "Expected: Valid trainable tensors flatbuffer.",
                     " Actual: Encountered a nullptr. Checkpoint file is invalid");
   flatbuffers::uoffset_t trainable_params_size = requires_grad_params->size();
   InlinedHashMap<std::string, OrtValue> trainable_params;
   trainable_params.reserve(trainable_params_size);
-  ORT_RETURN_IF_ERROR(OrtValuesFromFlatbufferTensors(*requires_grad_params, trainable_params, external_data_reader));
+  ORT_RETURN_IF_ERROR(OrtValuesFromFlatbufferTensors(*requires_grad_params, trainable_params, external_data_reader,
+                                                     mapped_external_data));
 
   for (auto& [name, value] : trainable_params) {
     auto param = std::make_shared<Parameter>(name, value, true);
@@ -656,7 +1000,8 @@ Status ToModuleState(
   flatbuffers::uoffset_t non_trainable_params_size = frozen_params->size();
   InlinedHashMap<std::string, OrtValue> non_trainable_params;
   non_trainable_params.reserve(non_trainable_params_size);
-  ORT_RETURN_IF_ERROR(OrtValuesFromFlatbufferTensors(*frozen_params, non_trainable_params, external_data_reader));
+  ORT_RETURN_IF_ERROR(OrtValuesFromFlatbufferTensors(*frozen_params, non_trainable_params, external_data_reader,
+                                                     mapped_external_data));
 
   for (auto& [name, value] : non_trainable_params) {
     auto param = std::make_shared<Parameter>(name, value, false);
@@ -674,11 +1019,13 @@ Status ToModuleState(
  * @param optimizer_groups Flatbuffer optimizer groups.
  * @param optimizer_state Optimizer state to be populated.
  * @param external_data_reader delegate to read initializer data from an external file or buffer
+ * @param mapped_external_data Optional external data file mapped into memory.
  * @return Status of the operation.
  */
 Status ToOptimizerState(
     const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::OptimizerGroup>>& optimizer_groups,
-    OptimizerCheckpointState& optimizer_state, const fbs::utils::ExternalDataReader& external_data_reader) {
+    OptimizerCheckpointState& optimizer_state, const fbs::utils::ExternalDataReader& external_data_reader,
+    const std::shared_ptr<const MappedExternalData>& mapped_external_data) {
   for (const auto* optimizer_group : optimizer_groups) {
     ORT_RETURN_IF_NOT(optimizer_group, "Expected: Valid optimizer groups flatbuffer.",
                       " Actual: Encountered a nullptr. Checkpoint file is invalid");
@@ -706,7 +1053,8 @@ Status ToOptimizerState(
       ORT_RETURN_IF_NOT(momentums, "Expected: Valid optimizer momentum tensors flatbuffer.",
                         " Actual: Encountered a nullptr. Checkpoint file is invalid");
       ORT_RETURN_IF_ERROR(OrtValuesFromFlatbufferTensors(
-          *momentums, optimizer_state_it->second->param_named_optimizer_states[param_name], external_data_reader));
+          *momentums, optimizer_state_it->second->param_named_optimizer_states[param_name], external_data_reader,
+          mapped_external_data));
     }
   }
 
@@ -766,6 +1114,68 @@ Status ToPropertyBag(const onnxruntime::fbs::PropertyBag& fbs_property_bag,
   return Status::OK();
 }
 
+/**
+ * @brief Record the tensors in the external data file of a checkpoint, so that saving the loaded state to the
+ * checkpoint again only writes the tensors that changed.
+ *
+ * @param fbs_checkpoint Flatbuffer checkpoint.
+ * @param data_path Path to the external data file.
+ * @param mapped_external_data External data file mapped into memory.
+ * @param external_data External data to be populated.
+ * @return Status of the operation.
+ */
+Status ToExternalData(const onnxruntime::fbs::Checkpoint& fbs_checkpoint, const PathString& data_path,
+                      const MappedExternalData& mapped_external_data, CheckpointExternalData& external_data) {
+  const auto record_tensors = [&](const auto* flatbuffer_tensors, const std::string& key_prefix) {
+    if (nullptr == flatbuffer_tensors) {
+      return Status::OK();
+    }
+
+    for (const auto* fbs_tensor : *flatbuffer_tensors) {
+      if (nullptr == fbs_tensor || fbs_tensor->external_data_offset() < 0 ||
+          fbs_tensor->data_type() == fbs::TensorDataType::STRING) {
+        continue;
+      }
+
+      const DataTypeImpl* element_type = nullptr;
+      TensorShape shape;
+      gsl::span<const uint8_t> data;
+      ORT_RETURN_IF_ERROR(GetMappedTensorData(*fbs_tensor, mapped_external_data, element_type, shape, data));
+      external_data.tensors.insert_or_assign(
+          key_prefix + fbs_tensor->name()->str(),
+          CheckpointExternalData::TensorData{static_cast<uint64_t>(fbs_tensor->external_data_offset()), data.size(),
+                                             HashBytes(data)});
+      external_data.live_bytes += data.size();
+    }
+
+    return Status::OK();
+  };
+
+  if (const auto* fbs_module_state = fbs_checkpoint.module_state(); nullptr != fbs_module_state) {
+    ORT_RETURN_IF_ERROR(record_tensors(fbs_module_state->requires_grad_params(), "module/"));
+    ORT_RETURN_IF_ERROR(record_tensors(fbs_module_state->frozen_params(), "module/"));
+  }
+
+  if (const auto* fbs_optimizer_groups = fbs_checkpoint.optimizer_groups(); nullptr != fbs_optimizer_groups) {
+    for (const auto* optimizer_group : *fbs_optimizer_groups) {
+      if (nullptr == optimizer_group->optimizer_states()) {
+        continue;
+      }
+
+      for (const auto* parameter_optimizer_state : *optimizer_group->optimizer_states()) {
+        ORT_RETURN_IF_ERROR(record_tensors(parameter_optimizer_state->momentums(),
+                                           "optimizer/" + optimizer_group->group_name()->str() + "/" +
+                                               parameter_optimizer_state->param_name()->str() + "/"));
+      }
+    }
+  }
+
+  external_data.data_path = data_path;
+  external_data.file_size = mapped_external_data.length;
+
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 /**
  * @brief Load checkpoint from a checkpoint file to initializers in a model proto.
@@ -876,7 +1286,7 @@ Status ToCheckpointState(gsl::span<const uint8_t> checkpoint_bytes, CheckpointSt
   const auto* fbs_module_state = fbs_checkpoint->module_state();
 
   fbs::utils::ExternalDataReader external_data_reader = nullptr;
-  std::optional<std::ifstream> external_data_stream;
+  std::shared_ptr<MappedExternalData> mapped_external_data;
 
   state.has_external_data = false;
   if (nullptr != fbs_module_state && fbs_module_state->has_external_data()) {
@@ -884,27 +1294,44 @@ Status ToCheckpointState(gsl::span<const uint8_t> checkpoint_bytes, CheckpointSt
     ORT_RETURN_IF_NOT(checkpoint_path.has_value(),
                       "External data is present in the checkpoint but the checkpoint path is not provided. External data with loading from buffer is not supported yet.");
     auto data_path = ExternalCheckpointDataPath(*checkpoint_path);
-    external_data_stream = std::ifstream(data_path, std::ios::binary);
 
-    if (external_data_stream.value().fail()) {
-      const auto [err, errmsg] = GetErrnoInfo();
+    // the tensors are read from the mapping, or use it in place where it is writable
+    mapped_external_data = std::make_shared<MappedExternalData>();
+    Status status = Env::Default().GetFileLength(data_path.c_str(), mapped_external_data->length);
+    if (status.IsOK()) {
+      status = Env::Default().MapFileIntoMemory(data_path.c_str(), 0, mapped_external_data->length,
+                                                mapped_external_data->memory);
+    }
+
+    if (!status.IsOK()) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Failed to open checkpoint's external data file: ", ToUTF8String(data_path),
-                             " error:", errmsg, " errno:", err);
+                             " error:", status.ErrorMessage());
     }
 
-    external_data_reader = [&external_data_stream](uint64_t offset, gsl::span<uint8_t> output_buffer) {
-      return ReadFromExternalFileHelper(external_data_stream.value(), offset, output_buffer);
+    external_data_reader = [mapped = mapped_external_data.get()](uint64_t offset, gsl::span<uint8_t> output_buffer) {
+      ORT_RETURN_IF(offset > mapped->length || output_buffer.size() > mapped->length - offset,
+                    "Failed reading external checkpoint data. Offset ", offset, " is out of bounds.");
+      std::memcpy(output_buffer.data(), mapped->Bytes(offset, output_buffer.size()).data(), output_buffer.size());
+      return Status::OK();
     };
   }
 
   if (nullptr != fbs_module_state) {
-    ORT_RETURN_IF_ERROR(ToModuleState(*fbs_module_state, state.module_checkpoint_state, external_data_reader));
+    ORT_RETURN_IF_ERROR(ToModuleState(*fbs_module_state, state.module_checkpoint_state, external_data_reader,
+                                      mapped_external_data));
   }
 
   const auto* fbs_optimizer_groups = fbs_checkpoint->optimizer_groups();
   if (nullptr != fbs_optimizer_groups) {
-    ORT_RETURN_IF_ERROR(ToOptimizerState(*fbs_optimizer_groups, state.optimizer_checkpoint_state, external_data_reader));
+    ORT_RETURN_IF_ERROR(ToOptimizerState(*fbs_optimizer_groups, state.optimizer_checkpoint_state, external_data_reader,
+                                         mapped_external_data));
+  }
+
+  if (mapped_external_data) {
+    state.external_data = std::make_shared<CheckpointExternalData>();
+    ORT_RETURN_IF_ERROR(ToExternalData(*fbs_checkpoint, ExternalCheckpointDataPath(*checkpoint_path),
+                                       *mapped_external_data, *state.external_data));
   }
 
   const auto* fbs_property_bag = fbs_checkpoint->property_bag();
@@ -954,6 +1381,19 @@ Status SaveCheckpoint(const CheckpointState& states, const PathString& checkpoin
   return save::FromCheckpointState(states, checkpoint_path, include_optimizer_state);
 }
 
+Status SaveCheckpointAsync(const CheckpointState& state, const PathString& checkpoint_path,
+                           const bool include_optimizer_state, std::future<Status>& saved) {
+  ORT_RETURN_IF_NOT(FLATBUFFERS_LITTLEENDIAN, "ORT training checkpoint format only supports little-endian machines");
+
+  auto snapshot = std::make_shared<CheckpointState>();
+  ORT_RETURN_IF_ERROR(save::ToCheckpointStateSnapshot(state, include_optimizer_state, *snapshot));
+  saved = std::async(std::launch::async, [snapshot, checkpoint_path, include_optimizer_state]() {
+    return save::FromCheckpointState(*snapshot, checkpoint_path, include_optimizer_state);
+  });
+
+  return Status::OK();
+}
+
 Status LoadCheckpoint(const PathString& checkpoint_path, CheckpointState& checkpoint_states) {
   ORT_RETURN_IF_NOT(FLATBUFFERS_LITTLEENDIAN, "ORT training checkpoint format only supports little-endian machines");
 
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <future>
+#include <memory>
+
 #include "core/platform/path_lib.h"
 #include "orttraining/training_api/checkpoint_property.h"
 #include "orttraining/training_api/module.h"
@@ -21,16 +24,26 @@
  * The checkpoint file is a single flatbuffer file containing all the states highlighted above.
  * The flatbuffer schema is defined in onnxruntime/core/flatbuffers/schema/ort_training_checkpoint.fbs
  *
+ * Large states keep their tensor data in an external data file next to the checkpoint file. Saving a state again
+ * to the same checkpoint only appends the tensors that changed to that file, and loading maps it into memory.
+ *
  */
 
 namespace onnxruntime::training::api {
 
+// The tensors in the external data file of a checkpoint, defined in checkpoint.cc.
+struct CheckpointExternalData;
+
 struct CheckpointState {
  public:
   ModuleCheckpointState module_checkpoint_state;
   OptimizerCheckpointState optimizer_checkpoint_state;
   PropertyBag property_bag;
   bool has_external_data = false;
+
+  // The external data file this state was last saved to or loaded from. Saves update it, even though they don't
+  // modify the state otherwise.
+  mutable std::shared_ptr<CheckpointExternalData> external_data;
 };
 
 /**
@@ -50,6 +63,20 @@ PathString ExternalCheckpointDataPath(const PathString& checkpoint_path);
 Status SaveCheckpoint(const CheckpointState& state, const PathString& checkpoint_path,
                       const bool include_optimizer_state);
 
+/**
+ * @brief Save training states as ORT checkpoint on a background thread.
+ *
+ * The trainable parameters and the optimizer states are copied to a snapshot on CPU before returning, so training
+ * can continue while the checkpoint is written. Frozen parameters on CPU are shared with the snapshot as training
+ * does not update them.
+ *
+ * @param state parameter/optimizer and other user defined training states.
+ * @param checkpoint_path file where checkpoint is saved.
+ * @return Status of taking the snapshot, and a future of the Status of the save.
+ */
+Status SaveCheckpointAsync(const CheckpointState& state, const PathString& checkpoint_path,
+                           const bool include_optimizer_state, std::future<Status>& saved);
+
 #if !defined(ORT_MINIMAL_BUILD)
 /**
  * @brief Save ONNX initializers as ORT checkpoint.
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "orttraining/training_api/optimizer.h"
+
+#include <algorithm>
+
 #include "core/flatbuffers/flatbuffers_utils.h"
 #include "core/framework/execution_provider.h"
 #include "core/framework/TensorSeq.h"
@@ -102,15 +105,55 @@ Status Optimizer::GenerateMomentumNamedStates(OptimizerCheckpointState& optimize
 
   auto& param_named_optimizer_states = optimizer_state_->param_named_optimizer_states;
   auto& optim_sess_state = optim_sess_->GetSessionState();
-  for (auto& pair : state_->module_checkpoint_state.named_parameters) {
-    if (pair.second->RequiresGrad()) {
-      param_named_optimizer_states.insert({pair.first, ParameterOptimizerState()});
-      ParameterOptimizerState& cur_param_optimizer_states = param_named_optimizer_states[pair.first];
-      for (auto& state_name : optimizer_algo_ptr_->momentum_keys) {
+
+  // The moments of the parameters on a device are views of one buffer per momentum key, so the optimizer kernels
+  // update contiguous memory and the states are not separate allocations.
+  struct DeviceParameters {
+    OrtMemoryInfo location;
+    InlinedVector<std::pair<const std::string*, const Tensor*>> parameters;
+    InlinedVector<size_t> offsets;
+    size_t size_in_bytes{0};
+  };
+  InlinedVector<DeviceParameters> devices;
+
+  for (auto& [parameter_name, parameter] : state_->module_checkpoint_state.named_parameters) {
+    if (!parameter->RequiresGrad()) {
+      continue;
+    }
+
+    const Tensor& param_tensor = parameter->Data().Get<Tensor>();
+    auto device = std::find_if(devices.begin(), devices.end(), [&param_tensor](const DeviceParameters& d) {
+      return d.location == param_tensor.Location();
+    });
+    if (device == devices.end()) {
+      devices.push_back(DeviceParameters{param_tensor.Location(), {}, {}, 0});
+      device = devices.end() - 1;
+    }
+
+    constexpr size_t kAlignment = 64;
+    device->size_in_bytes = (device->size_in_bytes + kAlignment - 1) / kAlignment * kAlignment;
+    device->parameters.emplace_back(&parameter_name, &param_tensor);
+    device->offsets.push_back(device->size_in_bytes);
+    device->size_in_bytes += param_tensor.SizeInBytes();
+  }
+
+  for (const auto& device : devices) {
+    for (const auto& state_name : optimizer_algo_ptr_->momentum_keys) {
+      OrtValue buffer;
+      ORT_RETURN_IF_ERROR(utils::CreateZeroValuedOrtValue(
+          optim_sess_state, DataTypeImpl::GetType<uint8_t>(),
+          TensorShape({static_cast<int64_t>(device.size_in_bytes)}), device.location, buffer));
+      auto* buffer_data = buffer.GetMutable<Tensor>()->MutableData<uint8_t>();
+
+      for (size_t i = 0; i < device.parameters.size(); ++i) {
+        const auto& [parameter_name, param_tensor] = device.parameters[i];
+        auto moment = std::make_unique<Tensor>(param_tensor->DataType(), param_tensor->Shape(),
+                                               buffer_data + device.offsets[i], device.location);
         OrtValue param_state;
-        ORT_ENFORCE(utils::CreateZeroValuedOrtValueLike(optim_sess_state, pair.second->Data(), param_state).IsOK(),
-                    "Error generating moment state for ", pair.first);
-        cur_param_optimizer_states.insert({state_name, std::move(param_state)});
+        // each view keeps the buffer alive, as the states may outlive the optimizer in the checkpoint state
+        param_state.Init(moment.release(), DataTypeImpl::GetType<Tensor>(),
+                         [buffer](void* tensor) { delete static_cast<Tensor*>(tensor); });
+        param_named_optimizer_states[*parameter_name].insert({state_name, std::move(param_state)});
       }
     }
   }
@@ -59,11 +59,14 @@ bool GetParamNameFromGradient(const std::string& grad_name, std::string& param_n
 
 Status CreateZeroValuedOrtValueLike(const SessionState& sess_state, const OrtValue& input_val, OrtValue& output_val) {
   const auto& param_tensor = input_val.template Get<Tensor>();
-  const TensorShape& shape = param_tensor.Shape();
-  auto& tensor_location = param_tensor.Location();
+  return CreateZeroValuedOrtValue(sess_state, param_tensor.DataType(), param_tensor.Shape(), param_tensor.Location(),
+                                  output_val);
+}
+
+Status CreateZeroValuedOrtValue(const SessionState& sess_state, MLDataType element_type, const TensorShape& shape,
+                                const OrtMemoryInfo& tensor_location, OrtValue& output_val) {
   AllocatorPtr allocator = sess_state.GetAllocator(tensor_location);
 
-  auto element_type = param_tensor.DataType();
   auto p_tensor = std::make_unique<Tensor>(element_type, shape, allocator);
 
   if (tensor_location.device.Type() == OrtDevice::CPU ||
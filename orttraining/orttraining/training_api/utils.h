@@ -61,6 +61,10 @@ bool GetParamNameFromGradient(const std::string& grad_name, std::string& param_n
 // Allocate OrtValue like the input ortvalue on the same device
 Status CreateZeroValuedOrtValueLike(const SessionState& sess_state, const OrtValue& input_val, OrtValue& output_val);
 
+// Allocate a zero valued tensor OrtValue on the device of tensor_location
+Status CreateZeroValuedOrtValue(const SessionState& sess_state, MLDataType element_type, const TensorShape& shape,
+                                const OrtMemoryInfo& tensor_location, OrtValue& output_val);
+
 // Create OrtValue from a single value of type T
 template <typename T>
 void WrapInOrtValue(T value,
@@ -5,7 +5,11 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include <algorithm>
 #include <cmath>
+#include <utility>
+#include <vector>
 
 namespace onnxruntime {
 namespace contrib {
@@ -19,6 +23,34 @@ TC compute_bias_correction_coefficient(const TC momentum_update_coefficient, con
   }
 }
 
+// Maximum number of elements of a tensor updated by one task of ForEachTensorChunk.
+constexpr int kOptimizerChunkSize = 16384;
+
+// Calls fn(tensor_index, begin, end) for chunks of at most kOptimizerChunkSize elements covering all the tensors of an
+// optimizer's sequences. The chunks are processed by one parallel loop, so small tensors share a thread and large
+// ones are split across threads, instead of updating one tensor after the other.
+template <typename Fn>
+void ForEachTensorChunk(concurrency::ThreadPool* tp, const std::vector<int>& tensor_sizes, Fn&& fn) {
+  std::vector<std::pair<size_t, int>> chunks;  // tensor index and first element
+  for (size_t i = 0; i < tensor_sizes.size(); ++i) {
+    for (int begin = 0; begin < tensor_sizes[i]; begin += kOptimizerChunkSize) {
+      chunks.emplace_back(i, begin);
+    }
+  }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(chunks.size()),
+      TensorOpCost{static_cast<double>(kOptimizerChunkSize) * 3 * sizeof(float),
+                   static_cast<double>(kOptimizerChunkSize) * 2 * sizeof(float),
+                   static_cast<double>(kOptimizerChunkSize) * 10},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t c = first; c < last; ++c) {
+          const auto [tensor_index, begin] = chunks[static_cast<size_t>(c)];
+          fn(tensor_index, begin, std::min(begin + kOptimizerChunkSize, tensor_sizes[tensor_index]));
+        }
+      });
+}
+
 Status CopyIfNotSameCPUBuffer(OpKernelContext* ctx, size_t number_of_values, const TensorSeq* src_values,
                               TensorSeq* dest_values);
 
@@ -64,14 +64,17 @@ Status SGDOptimizerV2<T>::Compute(OpKernelContext* ctx) const {
   if (update_signal == nullptr || *update_signal->template Data<bool>()) {
     const float lr = *p.learning_rate->template Data<float>();
 
-    for (size_t weight_index = 0; weight_index < p.num_of_weights; ++weight_index) {
-      Tensor& weight = const_cast<Tensor&>(p.weights->Get(weight_index));
-      Tensor& gradient = const_cast<Tensor&>(p.gradients->Get(weight_index));
-
-      // new_weight = weight - lr * gradient
-      const auto& delta = -lr * MakeEigenArrayMap<T>(gradient);
-      MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) + delta;
-    }
+    // All the tensors are updated by one parallel loop over chunks of their elements.
+    ForEachTensorChunk(ctx->GetOperatorThreadPool(), p.grouped_tensor_sizes,
+                       [&](size_t weight_index, int begin, int end) {
+                         const auto& pointers = p.grouped_tensor_pointers[weight_index];
+                         T* weight = static_cast<T*>(pointers[0]);
+                         const T* gradient = static_cast<const T*>(pointers[1]);
+                         for (int i = begin; i < end; ++i) {
+                           // new_weight = weight - lr * gradient
+                           weight[i] = weight[i] + -lr * gradient[i];
+                         }
+                       });
 
     *updated_flag_ptr = true;
   } else {